@@ -73,11 +73,14 @@ public:
             }
 
             if (m_next_byte.has_value()) {
-                const auto bit = (m_next_byte.value() >> m_bit_offset) & 1;
-                result |= bit << nread;
-                ++nread;
-
-                if (m_bit_offset++ == 7)
+                // Take as many of the bits that are left in this byte as we can at once.
+                const auto bits_from_byte = min(count - nread, 8 - m_bit_offset);
+                const auto bits = (m_next_byte.value() >> m_bit_offset) & ((1u << bits_from_byte) - 1);
+                result |= bits << nread;
+                nread += bits_from_byte;
+
+                m_bit_offset += bits_from_byte;
+                if (m_bit_offset == 8)
                     m_next_byte.clear();
             } else {
                 m_stream >> m_next_byte;
@@ -152,10 +155,13 @@ public:
             }
 
             if (m_next_byte.has_value()) {
-                m_next_byte.value() |= ((bits >> n_written) & 1) << m_bit_offset;
-                ++n_written;
+                // Fill up as much of the byte as we can at once.
+                const auto bits_to_byte = min(count - n_written, 8 - m_bit_offset);
+                m_next_byte.value() |= ((bits >> n_written) & ((1u << bits_to_byte) - 1)) << m_bit_offset;
+                n_written += bits_to_byte;
 
-                if (m_bit_offset++ == 7) {
+                m_bit_offset += bits_to_byte;
+                if (m_bit_offset == 8) {
                     m_stream << m_next_byte.value();
                     m_next_byte.clear();
                 }
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Checked.h>
+#include <AK/Noncopyable.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// A region allocator for objects that all die together, such as the nodes of a parse tree.
+// Allocation just bumps a pointer inside the current chunk; nothing is freed individually.
+// deallocate_all() runs the destructors of all non-trivially destructible objects created
+// through allocate<T>() (in reverse order of creation) and keeps the chunks around for reuse.
+class BumpAllocator {
+    AK_MAKE_NONCOPYABLE(BumpAllocator);
+    AK_MAKE_NONMOVABLE(BumpAllocator);
+
+public:
+    static constexpr size_t default_chunk_size = 16 * KiB;
+
+    explicit BumpAllocator(size_t chunk_size = default_chunk_size)
+        : m_chunk_size(chunk_size)
+    {
+        VERIFY(chunk_size > sizeof(ChunkHeader));
+    }
+
+    ~BumpAllocator()
+    {
+        deallocate_all();
+        free_chunks(m_free_chunks);
+    }
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment = 2 * sizeof(void*))
+    {
+        VERIFY(alignment && !(alignment & (alignment - 1)));
+        if (m_current_chunk) {
+            auto aligned = align_up(m_head, alignment);
+            if (aligned + size <= m_end && aligned + size >= aligned) {
+                m_head = aligned + size;
+                m_bytes_allocated += size;
+                return reinterpret_cast<void*>(aligned);
+            }
+        }
+        return allocate_slow(size, alignment);
+    }
+
+    template<typename T, typename... Args>
+    [[nodiscard]] T* allocate(Args&&... args)
+    {
+        if constexpr (IsTriviallyDestructible<T>) {
+            return new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+        } else {
+            // The destructor record goes in the same chunk, right in front of the object.
+            auto* record = new (allocate(sizeof(DestructorRecord), alignof(DestructorRecord))) DestructorRecord;
+            auto* object = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+            record->destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+            record->object = object;
+            record->next = m_destructors;
+            m_destructors = record;
+            return object;
+        }
+    }
+
+    template<typename T>
+    [[nodiscard]] Span<T> allocate_array(size_t count)
+    {
+        static_assert(IsTriviallyDestructible<T>, "BumpAllocator only hands out arrays of trivially destructible types");
+        VERIFY(!Checked<size_t>::multiplication_would_overflow(sizeof(T), count));
+        auto* elements = static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+        for (size_t i = 0; i < count; ++i)
+            new (&elements[i]) T();
+        return { elements, count };
+    }
+
+    // Copies the characters into the arena, so the returned view lives as long as the arena does.
+    [[nodiscard]] StringView copy_string(const StringView& string)
+    {
+        if (string.is_empty())
+            return string.is_null() ? StringView {} : StringView { "" };
+        auto* characters = static_cast<char*>(allocate(string.length(), 1));
+        __builtin_memcpy(characters, string.characters_without_null_termination(), string.length());
+        return { characters, string.length() };
+    }
+
+    void deallocate_all()
+    {
+        for (auto* record = m_destructors; record; record = record->next)
+            record->destroy(record->object);
+        m_destructors = nullptr;
+
+        // Keep the regular-sized chunks for the next round of allocations, oversized ones go back right away.
+        while (m_current_chunk) {
+            auto* chunk = m_current_chunk;
+            m_current_chunk = chunk->next;
+            if (chunk->size == m_chunk_size) {
+                chunk->next = m_free_chunks;
+                m_free_chunks = chunk;
+            } else {
+                kfree(chunk);
+            }
+        }
+        m_head = 0;
+        m_end = 0;
+        m_bytes_allocated = 0;
+        m_bytes_reserved = 0;
+    }
+
+    // Bytes handed out to callers, and bytes held in chunks currently in use.
+    size_t bytes_allocated() const { return m_bytes_allocated; }
+    size_t bytes_reserved() const { return m_bytes_reserved; }
+
+private:
+    struct ChunkHeader {
+        ChunkHeader* next;
+        size_t size;
+    };
+
+    struct DestructorRecord {
+        void (*destroy)(void*);
+        void* object;
+        DestructorRecord* next;
+    };
+
+    static FlatPtr align_up(FlatPtr address, size_t alignment)
+    {
+        return (address + alignment - 1) & ~(FlatPtr)(alignment - 1);
+    }
+
+    static void free_chunks(ChunkHeader* chunk)
+    {
+        while (chunk) {
+            auto* next = chunk->next;
+            kfree(chunk);
+            chunk = next;
+        }
+    }
+
+    void* allocate_slow(size_t size, size_t alignment)
+    {
+        auto needed = sizeof(ChunkHeader) + size + alignment;
+        VERIFY(needed > size);
+
+        ChunkHeader* chunk;
+        if (needed > m_chunk_size) {
+            // Too big for a regular chunk; give it one of its own and keep bumping in the current one.
+            chunk = static_cast<ChunkHeader*>(kmalloc(needed));
+            VERIFY(chunk);
+            chunk->size = needed;
+            if (m_current_chunk) {
+                chunk->next = m_current_chunk->next;
+                m_current_chunk->next = chunk;
+            } else {
+                chunk->next = nullptr;
+                m_current_chunk = chunk;
+            }
+            m_bytes_reserved += needed;
+            m_bytes_allocated += size;
+            auto aligned = align_up(reinterpret_cast<FlatPtr>(chunk + 1), alignment);
+            if (m_current_chunk == chunk)
+                m_head = m_end = aligned + size;
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        if (m_free_chunks) {
+            chunk = m_free_chunks;
+            m_free_chunks = chunk->next;
+        } else {
+            chunk = static_cast<ChunkHeader*>(kmalloc(m_chunk_size));
+            VERIFY(chunk);
+            chunk->size = m_chunk_size;
+        }
+        chunk->next = m_current_chunk;
+        m_current_chunk = chunk;
+        m_bytes_reserved += m_chunk_size;
+
+        m_head = reinterpret_cast<FlatPtr>(chunk + 1);
+        m_end = reinterpret_cast<FlatPtr>(chunk) + m_chunk_size;
+        return allocate(size, alignment);
+    }
+
+    size_t m_chunk_size { 0 };
+    ChunkHeader* m_current_chunk { nullptr };
+    ChunkHeader* m_free_chunks { nullptr };
+    FlatPtr m_head { 0 };
+    FlatPtr m_end { 0 };
+    DestructorRecord* m_destructors { nullptr };
+    size_t m_bytes_allocated { 0 };
+    size_t m_bytes_reserved { 0 };
+};
+
+}
+
+using AK::BumpAllocator;
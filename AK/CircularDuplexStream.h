@@ -46,8 +46,14 @@ public:
 
         const auto nread = min(bytes.size(), m_queue.size());
 
-        for (size_t idx = 0; idx < nread; ++idx)
-            bytes[idx] = m_queue.dequeue();
+        size_t ncopied = 0;
+        while (ncopied < nread) {
+            const auto count = min(nread - ncopied, Capacity - m_queue.m_head);
+            __builtin_memcpy(bytes.data() + ncopied, m_queue.m_storage + m_queue.m_head, count);
+            m_queue.m_head = (m_queue.m_head + count) % Capacity;
+            m_queue.m_size -= count;
+            ncopied += count;
+        }
 
         return nread;
     }
@@ -69,6 +75,29 @@ public:
         return nread;
     }
 
+    // Appends `count` bytes starting `seekback` bytes back, these may overlap with the ones being appended.
+    bool copy_from_seekback(size_t seekback, size_t count)
+    {
+        if (seekback == 0 || seekback > Capacity || seekback > m_total_written || Capacity - m_queue.size() < count) {
+            set_recoverable_error();
+            return false;
+        }
+
+        while (count > 0) {
+            const auto write_index = (m_queue.head_index() + m_queue.size()) % Capacity;
+            const auto read_index = (m_total_written - seekback) % Capacity;
+            // Longer runs than the seekback would copy what they just wrote themselves.
+            const auto nwritten = min(min(count, seekback), min(Capacity - write_index, Capacity - read_index));
+
+            __builtin_memmove(m_queue.m_storage + write_index, m_queue.m_storage + read_index, nwritten);
+            m_queue.m_size += nwritten;
+            m_total_written += nwritten;
+            count -= nwritten;
+        }
+
+        return true;
+    }
+
     bool read_or_error(Bytes bytes) override
     {
         if (m_queue.size() < bytes.size()) {
@@ -96,6 +125,8 @@ public:
     bool unreliable_eof() const override { return eof(); }
     bool eof() const { return m_queue.size() == 0; }
 
+    size_t remaining_space() const { return Capacity - m_queue.size(); }
+
     size_t remaining_contigous_space() const
     {
         return min(Capacity - m_queue.size(), m_queue.capacity() - (m_queue.head_index() + m_queue.size()) % Capacity);
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/Platform.h>
+#include <AK/Traits.h>
+
+namespace AK {
+
+// A HashMap that can be used from many threads at once. Keys are spread over a fixed number of
+// shards, each a regular HashMap behind its own spinlock, so threads working on different keys
+// rarely wait for each other. Values are handed out as copies, or to a callback while the shard
+// is locked; never hold on to a reference into the map.
+//
+// The locks spin, so this is meant for short critical sections and must not be used from IRQ handlers.
+template<typename K, typename V, typename KeyTraits = Traits<K>, size_t ShardCount = 16>
+class ConcurrentHashMap {
+    AK_MAKE_NONCOPYABLE(ConcurrentHashMap);
+    AK_MAKE_NONMOVABLE(ConcurrentHashMap);
+    static_assert(ShardCount && !(ShardCount & (ShardCount - 1)), "ConcurrentHashMap shard count must be a power of two");
+
+public:
+    ConcurrentHashMap() = default;
+
+    template<typename U = V>
+    HashSetResult set(const K& key, U&& value)
+    {
+        auto& shard = shard_for(key);
+        Locker locker(shard);
+        auto result = shard.map.set(key, forward<U>(value));
+        if (result == HashSetResult::InsertedNewEntry)
+            m_size.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        return result;
+    }
+
+    Optional<V> get(const K& key) const
+    {
+        auto& shard = shard_for(key);
+        Locker locker(shard);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end())
+            return {};
+        return it->value;
+    }
+
+    bool contains(const K& key) const
+    {
+        auto& shard = shard_for(key);
+        Locker locker(shard);
+        return shard.map.contains(key);
+    }
+
+    bool remove(const K& key)
+    {
+        auto& shard = shard_for(key);
+        Locker locker(shard);
+        if (!shard.map.remove(key))
+            return false;
+        m_size.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+        return true;
+    }
+
+    Optional<V> take(const K& key)
+    {
+        auto& shard = shard_for(key);
+        Locker locker(shard);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end())
+            return {};
+        Optional<V> value = move(it->value);
+        shard.map.remove(it);
+        m_size.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+        return value;
+    }
+
+    // Calls |callback| with the value for |key|, inserting a default-constructed one first if there is none.
+    // The shard stays locked for the duration of the callback, which makes read-modify-write updates atomic.
+    template<typename Callback>
+    decltype(auto) update(const K& key, Callback callback)
+    {
+        auto& shard = shard_for(key);
+        Locker locker(shard);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            shard.map.set(key, V());
+            m_size.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            it = shard.map.find(key);
+        }
+        return callback(it->value);
+    }
+
+    // Visits every entry, one shard at a time. Entries added or removed concurrently in other shards may or may not be seen.
+    template<typename Callback>
+    void for_each(Callback callback) const
+    {
+        for (auto& shard : m_shards) {
+            Locker locker(shard);
+            for (auto& it : shard.map)
+                callback(it.key, it.value);
+        }
+    }
+
+    void clear()
+    {
+        for (auto& shard : m_shards) {
+            Locker locker(shard);
+            m_size.fetch_sub(shard.map.size(), AK::MemoryOrder::memory_order_relaxed);
+            shard.map.clear();
+        }
+    }
+
+    size_t size() const { return m_size.load(AK::MemoryOrder::memory_order_relaxed); }
+    bool is_empty() const { return size() == 0; }
+
+private:
+    struct alignas(64) Shard {
+        mutable Atomic<bool> locked { false };
+        HashMap<K, V, KeyTraits> map;
+    };
+
+    class Locker {
+    public:
+        explicit Locker(const Shard& shard)
+            : m_shard(shard)
+        {
+            for (;;) {
+                if (!m_shard.locked.exchange(true, AK::MemoryOrder::memory_order_acquire))
+                    return;
+                while (m_shard.locked.load(AK::MemoryOrder::memory_order_relaxed)) {
+#if ARCH(I386) || ARCH(X86_64)
+                    asm volatile("pause");
+#endif
+                }
+            }
+        }
+
+        ~Locker() { m_shard.locked.store(false, AK::MemoryOrder::memory_order_release); }
+
+    private:
+        const Shard& m_shard;
+    };
+
+    Shard& shard_for(const K& key) { return m_shards[shard_index(key)]; }
+    const Shard& shard_for(const K& key) const { return m_shards[shard_index(key)]; }
+
+    static size_t shard_index(const K& key)
+    {
+        // The low bits select the bucket inside the shard's HashMap, so pick the shard from the high bits.
+        return (KeyTraits::hash(key) >> 24) & (ShardCount - 1);
+    }
+
+    Shard m_shards[ShardCount];
+    mutable Atomic<size_t> m_size { 0 };
+};
+
+}
+
+using AK::ConcurrentHashMap;
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Traits.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// A map that keeps its entries in a Vector sorted by key, for maps that only ever hold a handful of entries.
+// Compared to a HashMap it needs no buckets or hashing, copies cheaply, and with an inline capacity it doesn't
+// allocate at all until it outgrows it. Lookups are a binary search, so it needs keys with operator<.
+// Iteration is in key order. Any insertion or removal invalidates iterators and references into the map.
+template<typename K, typename V, size_t inline_capacity = 0>
+class FlatMap {
+public:
+    struct Entry {
+        K key;
+        V value;
+    };
+
+    using Iterator = Entry*;
+    using ConstIterator = const Entry*;
+
+    FlatMap() = default;
+
+#ifndef SERENITY_LIBC_BUILD
+    FlatMap(std::initializer_list<Entry> list)
+    {
+        ensure_capacity(list.size());
+        for (auto& item : list)
+            set(item.key, item.value);
+    }
+#endif
+
+    [[nodiscard]] bool is_empty() const { return m_entries.is_empty(); }
+    [[nodiscard]] size_t size() const { return m_entries.size(); }
+    [[nodiscard]] size_t capacity() const { return m_entries.capacity(); }
+    void clear() { m_entries.clear(); }
+    void ensure_capacity(size_t capacity) { m_entries.ensure_capacity(capacity); }
+
+    template<typename U = V>
+    HashSetResult set(const K& key, U&& value)
+    {
+        auto index = lower_bound(key);
+        if (index < m_entries.size() && !(key < m_entries[index].key)) {
+            m_entries[index].value = forward<U>(value);
+            return HashSetResult::ReplacedExistingEntry;
+        }
+        m_entries.insert(index, Entry { key, forward<U>(value) });
+        return HashSetResult::InsertedNewEntry;
+    }
+
+    bool remove(const K& key)
+    {
+        auto it = find(key);
+        if (it == end())
+            return false;
+        remove(it);
+        return true;
+    }
+
+    void remove(Iterator it) { m_entries.remove(it - begin()); }
+
+    Iterator begin() { return m_entries.data(); }
+    Iterator end() { return m_entries.data() + m_entries.size(); }
+    ConstIterator begin() const { return m_entries.data(); }
+    ConstIterator end() const { return m_entries.data() + m_entries.size(); }
+
+    Iterator find(const K& key)
+    {
+        auto index = lower_bound(key);
+        if (index < m_entries.size() && !(key < m_entries[index].key))
+            return begin() + index;
+        return end();
+    }
+
+    ConstIterator find(const K& key) const
+    {
+        return const_cast<FlatMap&>(*this).find(key);
+    }
+
+    Optional<typename Traits<V>::PeekType> get(const K& key) const
+    {
+        auto it = find(key);
+        if (it == end())
+            return {};
+        return it->value;
+    }
+
+    bool contains(const K& key) const { return find(key) != end(); }
+
+    V& ensure(const K& key)
+    {
+        auto index = lower_bound(key);
+        if (index == m_entries.size() || key < m_entries[index].key)
+            m_entries.insert(index, Entry { key, V() });
+        return m_entries[index].value;
+    }
+
+    Vector<K> keys() const
+    {
+        Vector<K> list;
+        list.ensure_capacity(size());
+        for (auto& it : *this)
+            list.unchecked_append(it.key);
+        return list;
+    }
+
+private:
+    // Index of the first entry whose key is not less than |key|.
+    size_t lower_bound(const K& key) const
+    {
+        size_t low = 0;
+        size_t high = m_entries.size();
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (m_entries[middle].key < key)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        return low;
+    }
+
+    Vector<Entry, inline_capacity> m_entries;
+};
+
+}
+
+using AK::FlatMap;
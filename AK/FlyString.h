@@ -89,6 +89,7 @@ private:
 
 template<>
 struct Traits<FlyString> : public GenericTraits<FlyString> {
+    static constexpr bool is_trivially_relocatable() { return true; }
     static unsigned hash(const FlyString& s) { return s.hash(); }
 };
 
@@ -30,54 +30,88 @@ static constexpr size_t use_next_index = NumericLimits<size_t>::max();
 
 // The worst case is that we have the largest 64-bit value formatted as binary number, this would take
 // 65 bytes. Choosing a larger power of two won't hurt and is a bit of mitigation against out-of-bounds accesses.
+// The digits are written to the end of |buffer|, so they come out in the right order without having to be reversed.
 static constexpr size_t convert_unsigned_to_string(u64 value, Array<u8, 128>& buffer, u8 base, bool upper_case)
 {
     VERIFY(base >= 2 && base <= 16);
 
     constexpr const char* lowercase_lookup = "0123456789abcdef";
     constexpr const char* uppercase_lookup = "0123456789ABCDEF";
-
-    if (value == 0) {
-        buffer[0] = '0';
-        return 1;
+    constexpr const char* decimal_pairs = "00010203040506070809"
+                                          "10111213141516171819"
+                                          "20212223242526272829"
+                                          "30313233343536373839"
+                                          "40414243444546474849"
+                                          "50515253545556575859"
+                                          "60616263646566676869"
+                                          "70717273747576777879"
+                                          "80818283848586878889"
+                                          "90919293949596979899";
+
+    size_t position = buffer.size();
+
+    if (base == 10) {
+        // Produce two digits per division, and switch to 32-bit divisions as soon as the value fits.
+        while (value > NumericLimits<u32>::max()) {
+            auto pair = value % 100;
+            value /= 100;
+            buffer[--position] = decimal_pairs[pair * 2 + 1];
+            buffer[--position] = decimal_pairs[pair * 2];
+        }
+        auto small_value = static_cast<u32>(value);
+        while (small_value >= 100) {
+            auto pair = small_value % 100;
+            small_value /= 100;
+            buffer[--position] = decimal_pairs[pair * 2 + 1];
+            buffer[--position] = decimal_pairs[pair * 2];
+        }
+        if (small_value >= 10) {
+            buffer[--position] = decimal_pairs[small_value * 2 + 1];
+            buffer[--position] = decimal_pairs[small_value * 2];
+        } else {
+            buffer[--position] = '0' + small_value;
+        }
+        return buffer.size() - position;
     }
 
-    size_t used = 0;
-    while (value > 0) {
-        if (upper_case)
-            buffer[used++] = uppercase_lookup[value % base];
-        else
-            buffer[used++] = lowercase_lookup[value % base];
+    const auto* lookup = upper_case ? uppercase_lookup : lowercase_lookup;
 
-        value /= base;
+    if ((base & (base - 1)) == 0) {
+        const u8 shift = base == 2 ? 1 : (base == 8 ? 3 : 4);
+        do {
+            buffer[--position] = lookup[value & (base - 1)];
+            value >>= shift;
+        } while (value > 0);
+        return buffer.size() - position;
     }
 
-    for (size_t i = 0; i < used / 2; ++i)
-        swap(buffer[i], buffer[used - i - 1]);
-
-    return used;
+    do {
+        buffer[--position] = lookup[value % base];
+        value /= base;
+    } while (value > 0);
+    return buffer.size() - position;
 }
 
 void vformat_impl(TypeErasedFormatParams& params, FormatBuilder& builder, FormatParser& parser)
 {
-    const auto literal = parser.consume_literal();
-    builder.put_literal(literal);
-
-    FormatParser::FormatSpecifier specifier;
-    if (!parser.consume_specifier(specifier)) {
-        VERIFY(parser.is_eof());
-        return;
-    }
-
-    if (specifier.index == use_next_index)
-        specifier.index = params.take_next_index();
+    for (;;) {
+        const auto literal = parser.consume_literal();
+        builder.put_literal(literal);
+
+        FormatParser::FormatSpecifier specifier;
+        if (!parser.consume_specifier(specifier)) {
+            VERIFY(parser.is_eof());
+            return;
+        }
 
-    auto& parameter = params.parameters().at(specifier.index);
+        if (specifier.index == use_next_index)
+            specifier.index = params.take_next_index();
 
-    FormatParser argparser { specifier.flags };
-    parameter.formatter(params, builder, argparser, parameter.value);
+        auto& parameter = params.parameters().at(specifier.index);
 
-    vformat_impl(params, builder, parser);
+        FormatParser argparser { specifier.flags };
+        parameter.formatter(params, builder, argparser, parameter.value);
+    }
 }
 
 } // namespace AK::{anonymous}
@@ -91,16 +125,19 @@ StringView FormatParser::consume_literal()
     const auto begin = tell();
 
     while (!is_eof()) {
-        if (consume_specific("{{"))
+        // Everything up to the next brace is literal text.
+        const auto ch = m_input[m_index];
+        if (ch != '{' && ch != '}') {
+            ++m_index;
             continue;
+        }
 
-        if (consume_specific("}}"))
+        if (peek(1) == ch) {
+            m_index += 2;
             continue;
+        }
 
-        if (next_is(is_any_of("{}")))
-            return m_input.substring_view(begin, tell() - begin);
-
-        consume();
+        return m_input.substring_view(begin, tell() - begin);
     }
 
     return m_input.substring_view(begin);
@@ -179,11 +216,16 @@ void FormatBuilder::put_padding(char fill, size_t amount)
 }
 void FormatBuilder::put_literal(StringView value)
 {
+    // Copy the text between escaped braces in one go, keeping one brace of each pair.
+    size_t run_start = 0;
     for (size_t i = 0; i < value.length(); ++i) {
-        m_builder.append(value[i]);
-        if (value[i] == '{' || value[i] == '}')
-            ++i;
+        if (value[i] == '{' || value[i] == '}') {
+            m_builder.append(value.substring_view(run_start, i + 1 - run_start));
+            run_start = ++i + 1;
+        }
     }
+    if (run_start < value.length())
+        m_builder.append(value.substring_view(run_start));
 }
 void FormatBuilder::put_string(
     StringView value,
@@ -279,8 +321,7 @@ void FormatBuilder::put_u64(
         }
     };
     const auto put_digits = [&]() {
-        for (size_t i = 0; i < used_by_digits; ++i)
-            m_builder.append(buffer[i]);
+        m_builder.append(reinterpret_cast<const char*>(buffer.data() + buffer.size() - used_by_digits), used_by_digits);
     };
 
     if (align == Align::Left) {
@@ -323,9 +364,10 @@ void FormatBuilder::put_i64(
     SignMode sign_mode)
 {
     const auto is_negative = value < 0;
-    value = is_negative ? -value : value;
+    // Negate in unsigned arithmetic, so that the smallest i64 doesn't overflow.
+    const auto magnitude = is_negative ? 0 - static_cast<u64>(value) : static_cast<u64>(value);
 
-    put_u64(static_cast<u64>(value), base, prefix, upper_case, zero_pad, align, min_width, fill, sign_mode, is_negative);
+    put_u64(magnitude, base, prefix, upper_case, zero_pad, align, min_width, fill, sign_mode, is_negative);
 }
 
 #ifndef KERNEL
@@ -339,40 +381,70 @@ void FormatBuilder::put_f64(
     char fill,
     SignMode sign_mode)
 {
-    StringBuilder string_builder;
-    FormatBuilder format_builder { string_builder };
+    // Sign, up to 64 integer digits, the point, and at most 53 fractional digits.
+    Array<u8, 128> buffer;
+    size_t length = 0;
 
     bool is_negative = value < 0.0;
     if (is_negative)
         value = -value;
 
-    format_builder.put_u64(static_cast<u64>(value), base, false, upper_case, false, Align::Right, 0, ' ', sign_mode, is_negative);
+    if (is_negative)
+        buffer[length++] = '-';
+    else if (sign_mode == SignMode::Always)
+        buffer[length++] = '+';
+    else if (sign_mode == SignMode::Reserved)
+        buffer[length++] = ' ';
+
+    const auto put_buffer = [&] {
+        put_string(StringView { reinterpret_cast<const char*>(buffer.data()), length }, align, min_width, NumericLimits<size_t>::max(), fill);
+    };
 
-    if (precision > 0) {
-        // FIXME: This is a terrible approximation but doing it properly would be a lot of work. If someone is up for that, a good
-        // place to start would be the following video from CppCon 2019:
-        // https://youtu.be/4P_kbF0EbZM (Stephan T. Lavavej “Floating-Point <charconv>: Making Your Code 10x Faster With C++17's Final Boss”)
-        value -= static_cast<i64>(value);
+    if (__builtin_isnan(value) || __builtin_isinf(value)) {
+        for (auto ch : StringView { __builtin_isnan(value) ? (upper_case ? "NAN" : "nan") : (upper_case ? "INF" : "inf") })
+            buffer[length++] = ch;
+        put_buffer();
+        return;
+    }
 
-        double epsilon = 0.5;
-        for (size_t i = 0; i < precision; ++i)
-            epsilon /= 10.0;
+    // Scale the fraction to an integer holding all the requested digits and round it once, instead of
+    // peeling off one digit at a time with floating-point arithmetic. Digits beyond the 53 bits of a
+    // double's mantissa carry no information, so the multiplier is never scaled past that.
+    u64 integer_part = static_cast<u64>(value);
+    const double fraction = value - static_cast<double>(integer_part);
+
+    u64 multiplier = 1;
+    size_t fraction_length = 0;
+    for (; fraction_length < precision && multiplier <= (1ull << 53) / base; ++fraction_length)
+        multiplier *= base;
+
+    u64 fraction_digits = static_cast<u64>(fraction * static_cast<double>(multiplier) + 0.5);
+    if (fraction_digits >= multiplier) {
+        fraction_digits -= multiplier;
+        ++integer_part;
+    }
 
-        size_t visible_precision = 0;
-        for (; visible_precision < precision; ++visible_precision) {
-            if (value - static_cast<i64>(value) < epsilon)
-                break;
-            value *= 10.0;
-            epsilon *= 10.0;
-        }
+    // Trailing zeros are not printed.
+    while (fraction_length > 0 && fraction_digits % base == 0) {
+        fraction_digits /= base;
+        --fraction_length;
+    }
 
-        if (visible_precision > 0) {
-            string_builder.append('.');
-            format_builder.put_u64(static_cast<u64>(value), base, false, upper_case, true, Align::Right, visible_precision);
-        }
+    Array<u8, 128> digits;
+    auto used_by_digits = convert_unsigned_to_string(integer_part, digits, base, upper_case);
+    __builtin_memcpy(buffer.data() + length, digits.data() + digits.size() - used_by_digits, used_by_digits);
+    length += used_by_digits;
+
+    if (fraction_length > 0) {
+        buffer[length++] = '.';
+        used_by_digits = convert_unsigned_to_string(fraction_digits, digits, base, upper_case);
+        for (size_t i = used_by_digits; i < fraction_length; ++i)
+            buffer[length++] = '0';
+        __builtin_memcpy(buffer.data() + length, digits.data() + digits.size() - used_by_digits, used_by_digits);
+        length += used_by_digits;
     }
 
-    put_string(string_builder.string_view(), align, min_width, NumericLimits<size_t>::max(), fill);
+    put_buffer();
 }
 #endif
 
@@ -386,6 +458,9 @@ void vformat(StringBuilder& builder, StringView fmtstr, TypeErasedFormatParams p
 
 void StandardFormatter::parse(TypeErasedFormatParams& params, FormatParser& parser)
 {
+    if (parser.is_eof())
+        return;
+
     if (StringView { "<^>" }.contains(parser.peek(1))) {
         VERIFY(!parser.next_is(is_any_of("{}")));
         m_fill = parser.consume();
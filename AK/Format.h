@@ -221,6 +221,23 @@ private:
 template<typename T>
 void __format_value(TypeErasedFormatParams& params, FormatBuilder& builder, FormatParser& parser, const void* value)
 {
+    // A plain "{}" is by far the most common replacement field. For integers and strings that means the
+    // default formatting, which we can do without setting up a Formatter and parsing (empty) flags.
+    if constexpr (IsIntegral<T> && !IsSame<T, char> && !IsSame<T, bool>) {
+        if (parser.is_eof()) {
+            if constexpr (IsUnsigned<T>)
+                builder.put_u64(*static_cast<const T*>(value));
+            else
+                builder.put_i64(*static_cast<const T*>(value));
+            return;
+        }
+    } else if constexpr (IsSame<T, StringView> || IsSame<T, String> || IsSame<T, FlyString>) {
+        if (parser.is_eof()) {
+            builder.put_string(StringView { *static_cast<const T*>(value) });
+            return;
+        }
+    }
+
     Formatter<T> formatter;
 
     formatter.parse(params, parser);
@@ -18,73 +18,113 @@ enum class HashSetResult {
     ReplacedExistingEntry
 };
 
-template<typename HashTableType, typename T, typename BucketType>
+// HashTable is an open-addressing "Swiss table": every slot has a control byte, kept in a separate array
+// in front of the slots. A full slot's control byte holds 7 bits of its hash, so a lookup can check a whole
+// group of control bytes at once and only compare the entries whose hash bits match.
+//
+// Groups are compared eight bytes at a time in a regular 64-bit register, which keeps this usable in the kernel.
+// Removing an entry leaves a tombstone behind unless no probe sequence could have passed over it, so other
+// entries never move and iterating over the table while removing the current entry is fine.
+struct HashTableControl {
+    static constexpr u8 Empty = 0x80;
+    static constexpr u8 Deleted = 0xfe;
+    static constexpr u8 Sentinel = 0xff;
+
+    static constexpr bool is_full(u8 control) { return control < 0x80; }
+};
+
+class HashTableGroup {
+public:
+    static constexpr size_t width = 8;
+
+    explicit HashTableGroup(const u8* control)
+    {
+        __builtin_memcpy(&m_control, control, width);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        m_control = __builtin_bswap64(m_control);
+#endif
+    }
+
+    // These return a mask with the top bit of every matching byte set.
+    // match() may rarely report a false positive, which is fine since every candidate is compared anyway.
+    u64 match(u8 hash_bits) const
+    {
+        auto bytes = m_control ^ (lsbs * hash_bits);
+        return (bytes - lsbs) & ~bytes & msbs;
+    }
+    u64 match_empty() const { return m_control & (~m_control << 6) & msbs; }
+    u64 match_empty_or_deleted() const { return m_control & (~m_control << 7) & msbs; }
+
+    static size_t lowest_match(u64 mask) { return __builtin_ctzll(mask) / 8; }
+    static size_t leading_non_matches(u64 mask) { return __builtin_clzll(mask) / 8; }
+
+private:
+    static constexpr u64 lsbs = 0x0101010101010101ull;
+    static constexpr u64 msbs = 0x8080808080808080ull;
+
+    u64 m_control { 0 };
+};
+
+template<typename HashTableType, typename T>
 class HashTableIterator {
     friend HashTableType;
 
 public:
-    bool operator==(const HashTableIterator& other) const { return m_bucket == other.m_bucket; }
-    bool operator!=(const HashTableIterator& other) const { return m_bucket != other.m_bucket; }
-    T& operator*() { return *m_bucket->slot(); }
-    T* operator->() { return m_bucket->slot(); }
+    bool operator==(const HashTableIterator& other) const { return m_slot == other.m_slot; }
+    bool operator!=(const HashTableIterator& other) const { return m_slot != other.m_slot; }
+    T& operator*() { return *m_slot; }
+    T* operator->() { return m_slot; }
     void operator++() { skip_to_next(); }
 
 private:
     void skip_to_next()
     {
-        if (!m_bucket)
+        if (!m_slot)
             return;
         do {
-            ++m_bucket;
-            if (m_bucket->used)
-                return;
-        } while (!m_bucket->end);
-        if (m_bucket->end)
-            m_bucket = nullptr;
+            ++m_control;
+            ++m_slot;
+        } while (!HashTableControl::is_full(*m_control) && *m_control != HashTableControl::Sentinel);
+        if (*m_control == HashTableControl::Sentinel)
+            m_slot = nullptr;
     }
 
-    explicit HashTableIterator(BucketType* bucket)
-        : m_bucket(bucket)
+    HashTableIterator(const u8* control, T* slot)
+        : m_control(control)
+        , m_slot(slot)
     {
     }
 
-    BucketType* m_bucket { nullptr };
+    const u8* m_control { nullptr };
+    T* m_slot { nullptr };
 };
 
 template<typename T, typename TraitsForT>
 class HashTable {
-    static constexpr size_t load_factor_in_percent = 60;
-
-    struct Bucket {
-        bool used;
-        bool deleted;
-        bool end;
-        alignas(T) u8 storage[sizeof(T)];
-
-        T* slot() { return reinterpret_cast<T*>(storage); }
-        const T* slot() const { return reinterpret_cast<const T*>(storage); }
-    };
+    static constexpr size_t group_width = HashTableGroup::width;
 
 public:
     HashTable() = default;
-    explicit HashTable(size_t capacity) { rehash(capacity); }
+    explicit HashTable(size_t capacity) { rehash(capacity_for_size(capacity)); }
 
     ~HashTable()
     {
-        if (!m_buckets)
+        if (!m_control)
             return;
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                m_buckets[i].slot()->~T();
+            if (HashTableControl::is_full(m_control[i]))
+                m_slots[i].~T();
         }
 
-        kfree(m_buckets);
+        kfree(m_control);
     }
 
     HashTable(const HashTable& other)
     {
-        rehash(other.capacity());
+        if (other.is_empty())
+            return;
+        rehash(capacity_for_size(other.size()));
         for (auto& it : other)
             set(it);
     }
@@ -97,15 +137,17 @@ public:
     }
 
     HashTable(HashTable&& other) noexcept
-        : m_buckets(other.m_buckets)
+        : m_control(other.m_control)
+        , m_slots(other.m_slots)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
-        , m_deleted_count(other.m_deleted_count)
+        , m_growth_left(other.m_growth_left)
     {
+        other.m_control = nullptr;
+        other.m_slots = nullptr;
         other.m_size = 0;
         other.m_capacity = 0;
-        other.m_deleted_count = 0;
-        other.m_buckets = nullptr;
+        other.m_growth_left = 0;
     }
 
     HashTable& operator=(HashTable&& other) noexcept
@@ -116,10 +158,11 @@ public:
 
     friend void swap(HashTable& a, HashTable& b) noexcept
     {
-        swap(a.m_buckets, b.m_buckets);
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
-        swap(a.m_deleted_count, b.m_deleted_count);
+        swap(a.m_growth_left, b.m_growth_left);
     }
 
     [[nodiscard]] bool is_empty() const { return !m_size; }
@@ -137,7 +180,8 @@ public:
     void ensure_capacity(size_t capacity)
     {
         VERIFY(capacity >= size());
-        rehash(capacity * 2);
+        if (m_growth_left < capacity - size())
+            rehash(capacity_for_size(capacity));
     }
 
     bool contains(const T& value) const
@@ -145,36 +189,36 @@ public:
         return find(value) != end();
     }
 
-    using Iterator = HashTableIterator<HashTable, T, Bucket>;
+    using Iterator = HashTableIterator<HashTable, T>;
 
     Iterator begin()
     {
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                return Iterator(&m_buckets[i]);
+            if (HashTableControl::is_full(m_control[i]))
+                return Iterator(&m_control[i], &m_slots[i]);
         }
         return end();
     }
 
     Iterator end()
     {
-        return Iterator(nullptr);
+        return Iterator(nullptr, nullptr);
     }
 
-    using ConstIterator = HashTableIterator<const HashTable, const T, const Bucket>;
+    using ConstIterator = HashTableIterator<const HashTable, const T>;
 
     ConstIterator begin() const
     {
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                return ConstIterator(&m_buckets[i]);
+            if (HashTableControl::is_full(m_control[i]))
+                return ConstIterator(&m_control[i], &m_slots[i]);
         }
         return end();
     }
 
     ConstIterator end() const
     {
-        return ConstIterator(nullptr);
+        return ConstIterator(nullptr, nullptr);
     }
 
     void clear()
@@ -185,18 +229,14 @@ public:
     template<typename U = T>
     HashSetResult set(U&& value)
     {
-        auto& bucket = lookup_for_writing(value);
-        if (bucket.used) {
-            (*bucket.slot()) = forward<U>(value);
+        auto hash = TraitsForT::hash(value);
+        if (auto* slot = lookup_with_hash(hash, [&](auto& entry) { return TraitsForT::equals(entry, value); })) {
+            *slot = forward<U>(value);
             return HashSetResult::ReplacedExistingEntry;
         }
 
-        new (bucket.slot()) T(forward<U>(value));
-        bucket.used = true;
-        if (bucket.deleted) {
-            bucket.deleted = false;
-            --m_deleted_count;
-        }
+        auto index = prepare_insert(hash);
+        new (&m_slots[index]) T(forward<U>(value));
         ++m_size;
         return HashSetResult::InsertedNewEntry;
     }
@@ -204,7 +244,10 @@ public:
     template<typename Finder>
     Iterator find(unsigned hash, Finder finder)
     {
-        return Iterator(lookup_with_hash(hash, move(finder)));
+        auto* slot = lookup_with_hash(hash, move(finder));
+        if (!slot)
+            return end();
+        return Iterator(&m_control[slot - m_slots], slot);
     }
 
     Iterator find(const T& value)
@@ -215,7 +258,10 @@ public:
     template<typename Finder>
     ConstIterator find(unsigned hash, Finder finder) const
     {
-        return ConstIterator(lookup_with_hash(hash, move(finder)));
+        auto* slot = lookup_with_hash(hash, move(finder));
+        if (!slot)
+            return end();
+        return ConstIterator(&m_control[slot - m_slots], slot);
     }
 
     ConstIterator find(const T& value) const
@@ -235,110 +281,143 @@ public:
 
     void remove(Iterator iterator)
     {
-        VERIFY(iterator.m_bucket);
-        auto& bucket = *iterator.m_bucket;
-        VERIFY(bucket.used);
-        VERIFY(!bucket.end);
-        VERIFY(!bucket.deleted);
-        bucket.slot()->~T();
-        bucket.used = false;
-        bucket.deleted = true;
+        VERIFY(iterator.m_slot);
+        size_t index = iterator.m_slot - m_slots;
+        VERIFY(index < m_capacity);
+        VERIFY(HashTableControl::is_full(m_control[index]));
+        m_slots[index].~T();
         --m_size;
-        ++m_deleted_count;
+
+        // If there's an empty slot within a group's width on both sides, no probe sequence ever had to step over
+        // this slot to find room, so it can go back to being empty rather than becoming a tombstone.
+        auto empty_after = HashTableGroup(&m_control[index]).match_empty();
+        auto empty_before = HashTableGroup(&m_control[(index - group_width) & m_capacity]).match_empty();
+        bool was_never_full = empty_before && empty_after
+            && HashTableGroup::lowest_match(empty_after) + HashTableGroup::leading_non_matches(empty_before) < group_width;
+        if (was_never_full) {
+            set_control(index, HashTableControl::Empty);
+            ++m_growth_left;
+        } else {
+            set_control(index, HashTableControl::Deleted);
+        }
     }
 
 private:
-    void insert_during_rehash(T&& value)
+    // The capacity is always one less than a power of two (or zero), so it doubles as the mask for slot indices.
+    // The control array has one sentinel byte after the last slot, followed by copies of the first group_width - 1
+    // control bytes, so a group can be loaded at any slot index without wrapping around.
+    static constexpr size_t control_bytes_for_capacity(size_t capacity) { return capacity + group_width; }
+    static constexpr size_t slots_offset_for_capacity(size_t capacity) { return (control_bytes_for_capacity(capacity) + alignof(T) - 1) & ~(alignof(T) - 1); }
+
+    // Keep at least one slot in eight empty, so every probe sequence ends.
+    static constexpr size_t max_size_for_capacity(size_t capacity) { return capacity == 7 ? 6 : capacity - capacity / 8; }
+
+    static constexpr size_t capacity_for_size(size_t size)
     {
-        auto& bucket = lookup_for_writing(value);
-        new (bucket.slot()) T(move(value));
-        bucket.used = true;
+        size_t capacity = 7;
+        while (max_size_for_capacity(capacity) < size)
+            capacity = capacity * 2 + 1;
+        return capacity;
     }
 
-    void rehash(size_t new_capacity)
+    static constexpr size_t probe_start(unsigned hash) { return hash >> 7; }
+    static constexpr u8 hash_bits(unsigned hash) { return hash & 0x7f; }
+
+    void set_control(size_t index, u8 control)
     {
-        new_capacity = max(new_capacity, static_cast<size_t>(4));
+        m_control[index] = control;
+        m_control[((index - (group_width - 1)) & m_capacity) + ((group_width - 1) & m_capacity)] = control;
+    }
 
-        auto* old_buckets = m_buckets;
+    void rehash(size_t new_capacity)
+    {
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
         auto old_capacity = m_capacity;
 
-        m_buckets = (Bucket*)kmalloc(sizeof(Bucket) * (new_capacity + 1));
-        __builtin_memset(m_buckets, 0, sizeof(Bucket) * (new_capacity + 1));
+        auto slots_offset = slots_offset_for_capacity(new_capacity);
+        m_control = (u8*)kmalloc(slots_offset + sizeof(T) * new_capacity);
+        m_slots = reinterpret_cast<T*>(m_control + slots_offset);
+        __builtin_memset(m_control, HashTableControl::Empty, control_bytes_for_capacity(new_capacity));
+        m_control[new_capacity] = HashTableControl::Sentinel;
         m_capacity = new_capacity;
-        m_deleted_count = 0;
-
-        m_buckets[m_capacity].end = true;
+        m_growth_left = max_size_for_capacity(new_capacity) - m_size;
 
-        if (!old_buckets)
+        if (!old_control)
             return;
 
         for (size_t i = 0; i < old_capacity; ++i) {
-            auto& old_bucket = old_buckets[i];
-            if (old_bucket.used) {
-                insert_during_rehash(move(*old_bucket.slot()));
-                old_bucket.slot()->~T();
-            }
+            if (!HashTableControl::is_full(old_control[i]))
+                continue;
+            auto& old_slot = old_slots[i];
+            auto hash = TraitsForT::hash(old_slot);
+            auto index = find_first_non_full(hash);
+            set_control(index, hash_bits(hash));
+            new (&m_slots[index]) T(move(old_slot));
+            old_slot.~T();
         }
 
-        kfree(old_buckets);
+        kfree(old_control);
     }
 
-    template<typename Finder>
-    Bucket* lookup_with_hash(unsigned hash, Finder finder) const
+    size_t find_first_non_full(unsigned hash) const
     {
-        if (is_empty())
-            return nullptr;
-
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (bucket.used && finder(*bucket.slot()))
-                return &bucket;
-
-            if (!bucket.used && !bucket.deleted)
-                return nullptr;
-
-            hash = double_hash(hash);
+        auto offset = probe_start(hash) & m_capacity;
+        for (size_t step = group_width;; step += group_width) {
+            HashTableGroup group { &m_control[offset] };
+            if (auto mask = group.match_empty_or_deleted())
+                return (offset + HashTableGroup::lowest_match(mask)) & m_capacity;
+            offset = (offset + step) & m_capacity;
         }
     }
 
-    const Bucket* lookup_for_reading(const T& value) const
+    size_t prepare_insert(unsigned hash)
     {
-        return lookup_with_hash(TraitsForT::hash(value), [&value](auto& entry) { return TraitsForT::equals(entry, value); });
+        if (!m_control)
+            rehash(capacity_for_size(1));
+
+        auto index = find_first_non_full(hash);
+        if (m_growth_left == 0 && m_control[index] != HashTableControl::Deleted) {
+            // Out of empty slots. If that's mostly due to tombstones, rebuilding at the same size clears them out.
+            if (m_size * 2 <= max_size_for_capacity(m_capacity))
+                rehash(m_capacity);
+            else
+                rehash(m_capacity * 2 + 1);
+            index = find_first_non_full(hash);
+        }
+
+        if (m_control[index] == HashTableControl::Empty)
+            --m_growth_left;
+        set_control(index, hash_bits(hash));
+        return index;
     }
 
-    Bucket& lookup_for_writing(const T& value)
+    template<typename Finder>
+    T* lookup_with_hash(unsigned hash, Finder finder) const
     {
-        if (should_grow())
-            rehash(capacity() * 2);
-
-        auto hash = TraitsForT::hash(value);
-        Bucket* first_empty_bucket = nullptr;
-        for (;;) {
-            auto& bucket = m_buckets[hash % m_capacity];
-
-            if (bucket.used && TraitsForT::equals(*bucket.slot(), value))
-                return bucket;
-
-            if (!bucket.used) {
-                if (!first_empty_bucket)
-                    first_empty_bucket = &bucket;
+        if (is_empty())
+            return nullptr;
 
-                if (!bucket.deleted)
-                    return *const_cast<Bucket*>(first_empty_bucket);
+        auto bits = hash_bits(hash);
+        auto offset = probe_start(hash) & m_capacity;
+        for (size_t step = group_width;; step += group_width) {
+            HashTableGroup group { &m_control[offset] };
+            for (auto mask = group.match(bits); mask; mask &= mask - 1) {
+                auto index = (offset + HashTableGroup::lowest_match(mask)) & m_capacity;
+                if (finder(m_slots[index]))
+                    return &m_slots[index];
             }
-
-            hash = double_hash(hash);
+            if (group.match_empty())
+                return nullptr;
+            offset = (offset + step) & m_capacity;
         }
     }
 
-    [[nodiscard]] size_t used_bucket_count() const { return m_size + m_deleted_count; }
-    [[nodiscard]] bool should_grow() const { return ((used_bucket_count() + 1) * 100) >= (m_capacity * load_factor_in_percent); }
-
-    Bucket* m_buckets { nullptr };
+    u8* m_control { nullptr };
+    T* m_slots { nullptr };
     size_t m_size { 0 };
     size_t m_capacity { 0 };
-    size_t m_deleted_count { 0 };
+    size_t m_growth_left { 0 };
 };
 
 }
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonParser.h>
+#include <AK/JsonReader.h>
+#include <ctype.h>
+
+namespace AK {
+
+JsonReader::Token JsonReader::next()
+{
+    if (m_failed)
+        return Token::Error;
+
+    ignore_while(isspace);
+
+    switch (m_expect) {
+    case Expect::Value:
+        return read_value();
+    case Expect::FirstKeyOrEnd:
+        if (consume_specific('}')) {
+            m_frames.take_last();
+            m_expect = Expect::CommaOrEnd;
+            return m_token = Token::EndObject;
+        }
+        return read_key();
+    case Expect::FirstValueOrEnd:
+        if (consume_specific(']')) {
+            m_frames.take_last();
+            m_expect = Expect::CommaOrEnd;
+            return m_token = Token::EndArray;
+        }
+        m_frames.last().index = 0;
+        return read_value();
+    case Expect::CommaOrEnd:
+        if (m_frames.is_empty()) {
+            if (!is_eof())
+                return fail();
+            return m_token = Token::EndOfInput;
+        }
+        auto& frame = m_frames.last();
+        if (consume_specific(',')) {
+            ignore_while(isspace);
+            if (frame.is_object)
+                return read_key();
+            ++frame.index;
+            return read_value();
+        }
+        if (consume_specific(frame.is_object ? '}' : ']')) {
+            auto was_object = frame.is_object;
+            m_frames.take_last();
+            return m_token = was_object ? Token::EndObject : Token::EndArray;
+        }
+        return fail();
+    }
+    VERIFY_NOT_REACHED();
+}
+
+bool JsonReader::read_string()
+{
+    if (!consume_specific('"'))
+        return false;
+    auto start = m_index;
+    m_text_has_escapes = false;
+    for (;;) {
+        if (is_eof())
+            return false;
+        char ch = consume();
+        if (ch == '"')
+            break;
+        if (ch == '\\') {
+            if (is_eof())
+                return false;
+            ignore();
+            m_text_has_escapes = true;
+        }
+    }
+    m_text = m_input.substring_view(start, m_index - start - 1);
+    return true;
+}
+
+JsonReader::Token JsonReader::read_key()
+{
+    if (!read_string())
+        return fail();
+    auto& frame = m_frames.last();
+    frame.key = m_text;
+    frame.key_has_escapes = m_text_has_escapes;
+    ignore_while(isspace);
+    if (!consume_specific(':'))
+        return fail();
+    m_expect = Expect::Value;
+    return m_token = Token::Key;
+}
+
+JsonReader::Token JsonReader::read_value()
+{
+    m_value_start = m_index;
+    m_expect = Expect::CommaOrEnd;
+
+    switch (peek()) {
+    case '{':
+        ignore();
+        m_frames.append({ true });
+        m_expect = Expect::FirstKeyOrEnd;
+        return m_token = Token::StartObject;
+    case '[':
+        ignore();
+        m_frames.append({ false });
+        m_expect = Expect::FirstValueOrEnd;
+        return m_token = Token::StartArray;
+    case '"':
+        if (!read_string())
+            return fail();
+        return m_token = Token::String;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        m_text = consume_while([](char ch) { return isdigit(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E'; });
+        m_text_has_escapes = false;
+        return m_token = Token::Number;
+    case 't':
+        if (!consume_specific("true"))
+            return fail();
+        return m_token = Token::True;
+    case 'f':
+        if (!consume_specific("false"))
+            return fail();
+        return m_token = Token::False;
+    case 'n':
+        if (!consume_specific("null"))
+            return fail();
+        return m_token = Token::Null;
+    default:
+        return fail();
+    }
+}
+
+String JsonReader::unescaped_text() const
+{
+    VERIFY(m_token == Token::Key || m_token == Token::String);
+    if (!m_text_has_escapes)
+        return m_text;
+    // Let JsonParser deal with the escape sequences; the quotes are right around m_text in the input.
+    StringView quoted { m_text.characters_without_null_termination() - 1, m_text.length() + 2 };
+    auto value = JsonParser(quoted).parse();
+    VERIFY(value.has_value() && value->is_string());
+    return value->as_string();
+}
+
+Optional<JsonValue> JsonReader::scalar_value() const
+{
+    switch (m_token) {
+    case Token::String:
+        return JsonValue(unescaped_text());
+    case Token::Number:
+        return JsonParser(m_text).parse();
+    case Token::True:
+        return JsonValue(true);
+    case Token::False:
+        return JsonValue(false);
+    case Token::Null:
+        return JsonValue(JsonValue::Type::Null);
+    default:
+        return {};
+    }
+}
+
+Optional<StringView> JsonReader::skip_value()
+{
+    VERIFY(is_value_start(m_token));
+    auto start = m_value_start;
+    if (m_token == Token::StartObject || m_token == Token::StartArray) {
+        auto depth = m_frames.size() - 1;
+        while (m_frames.size() != depth) {
+            if (next() == Token::Error)
+                return {};
+        }
+    }
+    return m_input.substring_view(start, m_index - start);
+}
+
+bool JsonReader::is_at(const JsonPath& path) const
+{
+    auto depth = m_frames.size();
+    if (m_token == Token::StartObject || m_token == Token::StartArray)
+        --depth;
+    if (path.size() != depth)
+        return false;
+
+    for (size_t i = 0; i < depth; ++i) {
+        auto& frame = m_frames[i];
+        auto& element = path[i];
+        switch (element.kind()) {
+        case JsonPathElement::Kind::AnyKey:
+            if (!frame.is_object)
+                return false;
+            break;
+        case JsonPathElement::Kind::AnyIndex:
+            if (frame.is_object)
+                return false;
+            break;
+        case JsonPathElement::Kind::Key:
+            if (!frame.is_object)
+                return false;
+            if (frame.key_has_escapes) {
+                StringView quoted { frame.key.characters_without_null_termination() - 1, frame.key.length() + 2 };
+                auto key = JsonParser(quoted).parse();
+                if (!key.has_value() || key->as_string() != element.key())
+                    return false;
+            } else if (frame.key != element.key()) {
+                return false;
+            }
+            break;
+        case JsonPathElement::Kind::Index:
+            if (frame.is_object || frame.index != element.index())
+                return false;
+            break;
+        }
+    }
+    return true;
+}
+
+}
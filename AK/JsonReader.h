@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/GenericLexer.h>
+#include <AK/JsonPath.h>
+#include <AK/JsonValue.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// A pull parser for JSON documents: every call to next() yields one token, and the text of
+// keys, strings and numbers is handed out as StringViews into the input without allocating.
+// Use this instead of JsonParser when only a few parts of a big document are needed.
+class JsonReader : private GenericLexer {
+public:
+    enum class Token : u8 {
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        EndOfInput,
+        Error,
+    };
+
+    explicit JsonReader(const StringView& input)
+        : GenericLexer(input)
+    {
+    }
+
+    Token next();
+    Token token() const { return m_token; }
+
+    // For Key and String tokens, this is the text between the quotes with escape sequences left as they are.
+    // For Number tokens, it's the number as written.
+    StringView text() const { return m_text; }
+    bool text_has_escapes() const { return m_text_has_escapes; }
+
+    // Allocates, but only when the current Key or String token actually contains escape sequences.
+    String unescaped_text() const;
+
+    // Converts the current String, Number, True, False or Null token to a JsonValue.
+    Optional<JsonValue> scalar_value() const;
+
+    // Skips over the value the current token starts (a whole object or array for StartObject and StartArray)
+    // and returns its raw JSON text, which can be handed to JsonParser if a JsonValue is needed after all.
+    Optional<StringView> skip_value();
+
+    // Whether the value the current token starts sits at |path| in the document.
+    bool is_at(const JsonPath& path) const;
+
+    size_t depth() const { return m_frames.size(); }
+
+    // Calls |callback| with the raw JSON text of every value at |path|, which may contain
+    // JsonPathElement::any_array_element and any_object_element. Returns false if the input is not valid JSON.
+    template<typename Callback>
+    static bool for_each_match(const StringView& input, const JsonPath& path, Callback callback)
+    {
+        JsonReader reader(input);
+        for (;;) {
+            auto token = reader.next();
+            if (token == Token::EndOfInput)
+                return true;
+            if (token == Token::Error)
+                return false;
+            if (!is_value_start(token) || !reader.is_at(path))
+                continue;
+            auto value = reader.skip_value();
+            if (!value.has_value())
+                return false;
+            callback(value.value());
+        }
+    }
+
+private:
+    enum class Expect : u8 {
+        Value,
+        FirstKeyOrEnd,
+        FirstValueOrEnd,
+        CommaOrEnd,
+    };
+
+    struct Frame {
+        bool is_object { false };
+        size_t index { 0 };
+        StringView key {};
+        bool key_has_escapes { false };
+    };
+
+    static bool is_value_start(Token token)
+    {
+        return token != Token::EndObject && token != Token::EndArray && token != Token::Key && token != Token::EndOfInput && token != Token::Error;
+    }
+
+    Token fail()
+    {
+        m_failed = true;
+        return m_token = Token::Error;
+    }
+    Token read_key();
+    Token read_value();
+    bool read_string();
+
+    Vector<Frame, 16> m_frames;
+    Expect m_expect { Expect::Value };
+    Token m_token { Token::Null };
+    StringView m_text;
+    bool m_text_has_escapes { false };
+    size_t m_value_start { 0 };
+    bool m_failed { false };
+};
+
+}
+
+using AK::JsonReader;
@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A bounded, lock-free queue for any number of producer threads and a single consumer thread.
+// Every slot carries a sequence number that tells producers and the consumer whose turn it is
+// (this is Dmitry Vyukov's bounded queue), so producers only contend on claiming a position.
+template<typename T, size_t Capacity>
+class MPSCQueue {
+    AK_MAKE_NONCOPYABLE(MPSCQueue);
+    AK_MAKE_NONMOVABLE(MPSCQueue);
+    static_assert(Capacity >= 2 && !(Capacity & (Capacity - 1)), "MPSCQueue capacity must be a power of two");
+
+public:
+    MPSCQueue()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            m_cells[i].sequence.store(i, AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    ~MPSCQueue()
+    {
+        while (try_dequeue().has_value())
+            ;
+    }
+
+    // Safe to call from any number of threads at once.
+    template<typename U = T>
+    [[nodiscard]] bool try_enqueue(U&& value)
+    {
+        auto position = m_head.load(AK::MemoryOrder::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[position & (Capacity - 1)];
+            auto sequence = cell->sequence.load(AK::MemoryOrder::memory_order_acquire);
+            auto difference = static_cast<ssize_t>(sequence - position);
+            if (difference == 0) {
+                if (m_head.compare_exchange_strong(position, position + 1, AK::MemoryOrder::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                // The consumer hasn't freed up this cell yet, so the queue is full.
+                return false;
+            } else {
+                position = m_head.load(AK::MemoryOrder::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(forward<U>(value));
+        cell->sequence.store(position + 1, AK::MemoryOrder::memory_order_release);
+        return true;
+    }
+
+    // Must only be called from the consumer thread.
+    [[nodiscard]] Optional<T> try_dequeue()
+    {
+        auto& cell = m_cells[m_tail & (Capacity - 1)];
+        auto sequence = cell.sequence.load(AK::MemoryOrder::memory_order_acquire);
+        if (sequence != m_tail + 1)
+            return {};
+        auto& element = *reinterpret_cast<T*>(cell.storage);
+        Optional<T> value = move(element);
+        element.~T();
+        cell.sequence.store(m_tail + Capacity, AK::MemoryOrder::memory_order_release);
+        ++m_tail;
+        return value;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Cell {
+        Atomic<size_t> sequence;
+        alignas(T) u8 storage[sizeof(T)];
+    };
+
+    alignas(64) Atomic<size_t> m_head { 0 };
+    alignas(64) size_t m_tail { 0 };
+    alignas(64) Cell m_cells[Capacity];
+};
+
+// An unbounded, lock-free queue for any number of producer threads and a single consumer thread.
+// Enqueueing is a single atomic exchange plus a node allocation. A dequeue that races with an enqueue
+// which has claimed its spot but not linked it in yet will see the queue as empty for a moment;
+// the element shows up as soon as that enqueue finishes.
+template<typename T>
+class UnboundedMPSCQueue {
+    AK_MAKE_NONCOPYABLE(UnboundedMPSCQueue);
+    AK_MAKE_NONMOVABLE(UnboundedMPSCQueue);
+
+public:
+    UnboundedMPSCQueue()
+        : m_head(&m_stub)
+        , m_tail(&m_stub)
+    {
+    }
+
+    ~UnboundedMPSCQueue()
+    {
+        while (try_dequeue().has_value())
+            ;
+    }
+
+    // Safe to call from any number of threads at once.
+    template<typename U = T>
+    void enqueue(U&& value)
+    {
+        auto* node = new Node { {}, T(forward<U>(value)) };
+        push(node);
+    }
+
+    // Must only be called from the consumer thread.
+    [[nodiscard]] Optional<T> try_dequeue()
+    {
+        auto* tail = m_tail;
+        auto* next = tail->next.load(AK::MemoryOrder::memory_order_acquire);
+        if (tail == &m_stub) {
+            // The stub marks the boundary between consumed and unconsumed nodes; step over it.
+            if (!next)
+                return {};
+            m_tail = next;
+            tail = next;
+            next = tail->next.load(AK::MemoryOrder::memory_order_acquire);
+        }
+        if (next) {
+            m_tail = next;
+            return take(tail);
+        }
+        if (tail != m_head.load(AK::MemoryOrder::memory_order_acquire)) {
+            // A producer is in the middle of linking in a new node.
+            return {};
+        }
+        // |tail| is the last node. Put the stub behind it so we can hand |tail| out.
+        push(&m_stub);
+        next = tail->next.load(AK::MemoryOrder::memory_order_acquire);
+        if (!next)
+            return {};
+        m_tail = next;
+        return take(tail);
+    }
+
+private:
+    struct Node {
+        Atomic<Node*> next;
+        Optional<T> value;
+    };
+
+    void push(Node* node)
+    {
+        node->next.store(nullptr, AK::MemoryOrder::memory_order_relaxed);
+        auto* previous = m_head.exchange(node, AK::MemoryOrder::memory_order_acq_rel);
+        previous->next.store(node, AK::MemoryOrder::memory_order_release);
+    }
+
+    static Optional<T> take(Node* node)
+    {
+        auto value = move(node->value);
+        delete node;
+        return value;
+    }
+
+    alignas(64) Atomic<Node*> m_head;
+    alignas(64) Node* m_tail;
+    Node m_stub;
+};
+
+}
+
+using AK::MPSCQueue;
+using AK::UnboundedMPSCQueue;
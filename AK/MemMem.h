@@ -8,12 +8,106 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/SIMD.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 
 namespace AK {
 
+// The byte scanning helpers below look at 16 bytes at a time with SSE2 where the compiler
+// lets us use it (never in the kernel, which is built without SSE), and 8 bytes at a time
+// with plain 64-bit arithmetic otherwise.
+namespace Detail {
+
+#ifdef __SSE2__
+ALWAYS_INLINE static SIMD::u8x16 load_unaligned_u8x16(const u8* data)
+{
+    SIMD::u8x16 vector;
+    __builtin_memcpy(&vector, data, sizeof(vector));
+    return vector;
+}
+
+ALWAYS_INLINE static SIMD::u8x16 splat_u8x16(u8 value)
+{
+    return SIMD::u8x16 { value, value, value, value, value, value, value, value, value, value, value, value, value, value, value, value };
+}
+
+// One bit per byte of |vector|, taken from the byte's high bit.
+ALWAYS_INLINE static u32 high_bits_mask(SIMD::u8x16 vector)
+{
+    using CharVector = char __attribute__((vector_size(16)));
+    return static_cast<u32>(__builtin_ia32_pmovmskb128(reinterpret_cast<CharVector>(vector)));
+}
+
+// One bit per byte of |data| that equals the corresponding byte of |needle|.
+ALWAYS_INLINE static u32 equal_bytes_mask(const u8* data, SIMD::u8x16 needle)
+{
+    return high_bits_mask(reinterpret_cast<SIMD::u8x16>(load_unaligned_u8x16(data) == needle));
+}
+#endif
+
+ALWAYS_INLINE static u64 load_unaligned_u64(const u8* data)
+{
+    u64 word;
+    __builtin_memcpy(&word, data, sizeof(word));
+    return word;
+}
+
+// Sets the high bit of exactly those bytes of |word| that are zero.
+ALWAYS_INLINE static u64 zero_bytes_mask(u64 word)
+{
+    constexpr u64 low_bits = 0x7f7f7f7f7f7f7f7full;
+    return ~(((word & low_bits) + low_bits) | word | low_bits);
+}
+
+}
+
+static inline Optional<size_t> find_byte(ReadonlyBytes bytes, u8 needle)
+{
+    auto* data = bytes.data();
+    size_t length = bytes.size();
+    size_t i = 0;
+#ifdef __SSE2__
+    auto needle_vector = Detail::splat_u8x16(needle);
+    for (; i + 16 <= length; i += 16) {
+        if (auto mask = Detail::equal_bytes_mask(data + i, needle_vector))
+            return i + __builtin_ctz(mask);
+    }
+#else
+    u64 needle_word = 0x0101010101010101ull * needle;
+    for (; i + 8 <= length; i += 8) {
+        if (auto mask = Detail::zero_bytes_mask(Detail::load_unaligned_u64(data + i) ^ needle_word))
+            return i + __builtin_ctzll(mask) / 8;
+    }
+#endif
+    for (; i < length; ++i) {
+        if (data[i] == needle)
+            return i;
+    }
+    return {};
+}
+
+static inline size_t count_byte(ReadonlyBytes bytes, u8 needle)
+{
+    auto* data = bytes.data();
+    size_t length = bytes.size();
+    size_t count = 0;
+    size_t i = 0;
+#ifdef __SSE2__
+    auto needle_vector = Detail::splat_u8x16(needle);
+    for (; i + 16 <= length; i += 16)
+        count += __builtin_popcount(Detail::equal_bytes_mask(data + i, needle_vector));
+#else
+    u64 needle_word = 0x0101010101010101ull * needle;
+    for (; i + 8 <= length; i += 8)
+        count += __builtin_popcountll(Detail::zero_bytes_mask(Detail::load_unaligned_u64(data + i) ^ needle_word));
+#endif
+    for (; i < length; ++i)
+        count += data[i] == needle;
+    return count;
+}
+
 namespace {
 const static void* bitap_bitwise(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
 {
@@ -28,13 +122,13 @@ const static void* bitap_bitwise(const void* haystack, size_t haystack_length, c
         needle_mask[i] = 0xffffffff;
 
     for (size_t i = 0; i < needle_length; ++i)
-        needle_mask[((const u8*)needle)[i]] &= ~(0x00000001 << i);
+        needle_mask[((const u8*)needle)[i]] &= ~(0x00000001ull << i);
 
     for (size_t i = 0; i < haystack_length; ++i) {
         lookup |= needle_mask[((const u8*)haystack)[i]];
         lookup <<= 1;
 
-        if (!(lookup & (0x00000001 << needle_length)))
+        if (!(lookup & (0x00000001ull << needle_length)))
             return ((const u8*)haystack) + i - needle_length + 1;
     }
 
@@ -100,6 +194,25 @@ static inline Optional<size_t> memmem(const HaystackIterT& haystack_begin, const
     return {};
 }
 
+namespace {
+Optional<size_t> memmem_scalar(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
+{
+    if (haystack_length < needle_length)
+        return {};
+
+    if (needle_length < 32) {
+        auto ptr = bitap_bitwise(haystack, haystack_length, needle, needle_length);
+        if (ptr)
+            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+        return {};
+    }
+
+    // Fallback to KMP.
+    Array<Span<const u8>, 1> spans { Span<const u8> { (const u8*)haystack, haystack_length } };
+    return memmem(spans.begin(), spans.end(), { (const u8*)needle, needle_length });
+}
+}
+
 static inline Optional<size_t> memmem_optional(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
 {
     if (needle_length == 0)
@@ -114,16 +227,40 @@ static inline Optional<size_t> memmem_optional(const void* haystack, size_t hays
         return {};
     }
 
-    if (needle_length < 32) {
-        auto ptr = bitap_bitwise(haystack, haystack_length, needle, needle_length);
-        if (ptr)
-            return static_cast<size_t>((FlatPtr)ptr - (FlatPtr)haystack);
+    if (needle_length == 1)
+        return find_byte({ haystack, haystack_length }, *(const u8*)needle);
+
+#ifdef __SSE2__
+    // Look for positions where both the first and the last byte of the needle match, 16 positions at a time,
+    // and only compare the bytes in between for those. If that keeps producing false candidates (think
+    // "aaaab" in "aaaaaaaa..."), we fall back to the linear-time search below for the rest of the haystack.
+    auto* haystack_bytes = (const u8*)haystack;
+    auto* needle_bytes = (const u8*)needle;
+    auto first = Detail::splat_u8x16(needle_bytes[0]);
+    auto last = Detail::splat_u8x16(needle_bytes[needle_length - 1]);
+    size_t false_candidates = 0;
+    size_t position = 0;
+    for (; position + needle_length - 1 + 16 <= haystack_length; position += 16) {
+        auto mask = Detail::equal_bytes_mask(haystack_bytes + position, first) & Detail::equal_bytes_mask(haystack_bytes + position + needle_length - 1, last);
+        while (mask) {
+            auto candidate = position + __builtin_ctz(mask);
+            if (__builtin_memcmp(haystack_bytes + candidate + 1, needle_bytes + 1, needle_length - 2) == 0)
+                return candidate;
+            mask &= mask - 1;
+            ++false_candidates;
+        }
+        if (false_candidates > 64 + position / 8)
+            break;
+    }
+    if (position) {
+        auto rest = memmem_scalar(haystack_bytes + position, haystack_length - position, needle, needle_length);
+        if (rest.has_value())
+            return position + rest.value();
         return {};
     }
+#endif
 
-    // Fallback to KMP.
-    Array<Span<const u8>, 1> spans { Span<const u8> { (const u8*)haystack, haystack_length } };
-    return memmem(spans.begin(), spans.end(), { (const u8*)needle, needle_length });
+    return memmem_scalar(haystack, haystack_length, needle, needle_length);
 }
 
 static inline const void* memmem(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
@@ -9,6 +9,7 @@
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
 #include <AK/Format.h>
+#include <AK/Traits.h>
 #include <AK/Types.h>
 #ifdef KERNEL
 #    include <Kernel/Arch/x86/CPU.h>
@@ -327,6 +328,11 @@ struct Formatter<NonnullRefPtr<T>> : Formatter<const T*> {
     }
 };
 
+template<typename T>
+struct Traits<NonnullRefPtr<T>> : public GenericTraits<NonnullRefPtr<T>> {
+    static constexpr bool is_trivially_relocatable() { return true; }
+};
+
 template<typename T, typename U>
 inline void swap(NonnullRefPtr<T>& a, NonnullRefPtr<U>& b)
 {
@@ -6,7 +6,9 @@
 
 #pragma once
 
+#include <AK/Assertions.h>
 #include <AK/StdLibExtras.h>
+#include <AK/kmalloc.h>
 
 namespace AK {
 
@@ -100,31 +102,391 @@ void single_pivot_quick_sort(Iterator start, Iterator end, LessThan less_than)
     }
 }
 
+namespace Detail {
+
+// Lets the index-based sorts below work on a pair of random access iterators.
+template<typename Iterator>
+class IteratorRange {
+public:
+    IteratorRange(Iterator start)
+        : m_start(start)
+    {
+    }
+
+    decltype(auto) operator[](size_t index) { return *(m_start + index); }
+
+private:
+    Iterator m_start;
+};
+
+// The quick sort only ever swaps elements (or moves them, when it gets real references), so it also works on collections
+// that hand out proxies.
+static constexpr size_t insertion_sort_threshold = 24;
+static constexpr size_t ninther_threshold = 128;
+static constexpr size_t partial_insertion_sort_limit = 8;
+
+template<typename Collection, typename LessThan>
+void stable_insertion_sort(Collection& col, size_t start, size_t end, LessThan& less_than)
+{
+    for (size_t i = start + 1; i < end; ++i) {
+        if (!less_than(col[i], col[i - 1]))
+            continue;
+        auto value = move(col[i]);
+        auto j = i;
+        do {
+            col[j] = move(col[j - 1]);
+            --j;
+        } while (j > start && less_than(value, col[j - 1]));
+        col[j] = move(value);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void insertion_sort(Collection& col, size_t start, size_t end, LessThan& less_than)
+{
+    // Shifting elements over is cheaper than swapping them into place, but proxy elements can only be swapped.
+    if constexpr (IsLvalueReference<decltype(col[0])>) {
+        stable_insertion_sort(col, start, end, less_than);
+    } else {
+        for (size_t i = start + 1; i < end; ++i) {
+            for (size_t j = i; j > start && less_than(col[j], col[j - 1]); --j)
+                swap(col[j], col[j - 1]);
+        }
+    }
+}
+
+// Like insertion_sort, but gives up once it has had to move elements too far.
+// Returns whether the range ended up sorted.
+template<typename Collection, typename LessThan>
+bool partial_insertion_sort(Collection& col, size_t start, size_t end, LessThan& less_than)
+{
+    size_t moves = 0;
+    for (size_t i = start + 1; i < end; ++i) {
+        for (size_t j = i; j > start && less_than(col[j], col[j - 1]); --j) {
+            swap(col[j], col[j - 1]);
+            if (++moves > partial_insertion_sort_limit)
+                return false;
+        }
+    }
+    return true;
+}
+
+template<typename Collection, typename LessThan>
+void sift_down(Collection& col, size_t start, size_t root, size_t size, LessThan& less_than)
+{
+    for (;;) {
+        auto child = 2 * root + 1;
+        if (child >= size)
+            return;
+        if (child + 1 < size && less_than(col[start + child], col[start + child + 1]))
+            ++child;
+        if (!less_than(col[start + root], col[start + child]))
+            return;
+        swap(col[start + root], col[start + child]);
+        root = child;
+    }
+}
+
+template<typename Collection, typename LessThan>
+void heap_sort(Collection& col, size_t start, size_t end, LessThan& less_than)
+{
+    auto size = end - start;
+    for (auto i = size / 2; i > 0; --i)
+        sift_down(col, start, i - 1, size, less_than);
+    for (auto i = size - 1; i > 0; --i) {
+        swap(col[start], col[start + i]);
+        sift_down(col, start, 0, i, less_than);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void sort3(Collection& col, size_t a, size_t b, size_t c, LessThan& less_than)
+{
+    if (less_than(col[b], col[a]))
+        swap(col[a], col[b]);
+    if (less_than(col[c], col[b]))
+        swap(col[b], col[c]);
+    if (less_than(col[b], col[a]))
+        swap(col[a], col[b]);
+}
+
+// Partitions [start, end) around the pivot in col[start], with elements equal to the pivot going right.
+// Returns the final pivot position, and whether the range was already partitioned.
+// The scans are bounds-checked even though a strict weak ordering would keep them in range, so that a sloppy
+// comparator only results in a bad order rather than in stepping outside the collection.
+template<typename Collection, typename LessThan>
+size_t partition_right(Collection& col, size_t start, size_t end, LessThan& less_than, bool& was_partitioned)
+{
+    auto&& pivot = col[start];
+    auto first = start;
+    auto last = end;
+
+    while (++first < end && less_than(col[first], pivot))
+        ;
+
+    if (first - 1 == start) {
+        while (first < last && !less_than(col[--last], pivot))
+            ;
+    } else {
+        while (--last > start && !less_than(col[last], pivot))
+            ;
+    }
+
+    was_partitioned = first >= last;
+    while (first < last) {
+        swap(col[first], col[last]);
+        while (++first < end && less_than(col[first], pivot))
+            ;
+        while (--last > start && !less_than(col[last], pivot))
+            ;
+    }
+
+    auto pivot_position = first - 1;
+    if (pivot_position != start)
+        swap(col[start], col[pivot_position]);
+    return pivot_position;
+}
+
+// Partitions [start, end) around the pivot in col[start], with elements equal to the pivot going left.
+// Used when the pivot equals the element just before the range, so the whole left side is the same value.
+template<typename Collection, typename LessThan>
+size_t partition_left(Collection& col, size_t start, size_t end, LessThan& less_than)
+{
+    auto&& pivot = col[start];
+    auto first = start;
+    auto last = end;
+
+    while (--last > start && less_than(pivot, col[last]))
+        ;
+
+    if (last + 1 == end) {
+        while (first < last && !less_than(pivot, col[++first]))
+            ;
+    } else {
+        while (++first < end && !less_than(pivot, col[first]))
+            ;
+    }
+
+    while (first < last) {
+        swap(col[first], col[last]);
+        while (--last > start && less_than(pivot, col[last]))
+            ;
+        while (++first < end && !less_than(pivot, col[first]))
+            ;
+    }
+
+    if (last != start)
+        swap(col[start], col[last]);
+    return last;
+}
+
+template<typename Collection>
+void break_patterns(Collection& col, size_t start, size_t end)
+{
+    auto size = end - start;
+    if (size < insertion_sort_threshold)
+        return;
+    auto quarter = size / 4;
+    swap(col[start], col[start + quarter]);
+    swap(col[end - 1], col[end - 1 - quarter]);
+    if (size > ninther_threshold) {
+        swap(col[start + 1], col[start + quarter + 1]);
+        swap(col[start + 2], col[start + quarter + 2]);
+        swap(col[end - 2], col[end - 1 - (quarter + 1)]);
+        swap(col[end - 3], col[end - 1 - (quarter + 2)]);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void pattern_defeating_quick_sort(Collection& col, size_t start, size_t end, LessThan& less_than, int bad_allowed, bool leftmost)
+{
+    for (;;) {
+        auto size = end - start;
+        if (size < insertion_sort_threshold) {
+            insertion_sort(col, start, end, less_than);
+            return;
+        }
+
+        // Move the median of three (or of three medians of three, for larger ranges) to the start to serve as the pivot.
+        auto middle = start + size / 2;
+        if (size > ninther_threshold) {
+            sort3(col, start, middle, end - 1, less_than);
+            sort3(col, start + 1, middle - 1, end - 2, less_than);
+            sort3(col, start + 2, middle + 1, end - 3, less_than);
+            sort3(col, middle - 1, middle, middle + 1, less_than);
+            swap(col[start], col[middle]);
+        } else {
+            sort3(col, middle, start, end - 1, less_than);
+        }
+
+        // The element before this range is never greater than anything in it. If it equals the pivot,
+        // there is nothing less than the pivot here, so get all copies of it out of the way at once.
+        if (!leftmost && !less_than(col[start - 1], col[start])) {
+            start = partition_left(col, start, end, less_than) + 1;
+            continue;
+        }
+
+        bool was_partitioned = false;
+        auto pivot_position = partition_right(col, start, end, less_than, was_partitioned);
+        auto left_size = pivot_position - start;
+        auto right_size = end - (pivot_position + 1);
+
+        if (left_size < size / 8 || right_size < size / 8) {
+            // Too many bad pivots mean we're being fed an adversarial pattern, so fall back to a guaranteed O(n log n).
+            if (--bad_allowed == 0) {
+                heap_sort(col, start, end, less_than);
+                return;
+            }
+            break_patterns(col, start, pivot_position);
+            break_patterns(col, pivot_position + 1, end);
+        } else if (was_partitioned
+            && partial_insertion_sort(col, start, pivot_position, less_than)
+            && partial_insertion_sort(col, pivot_position + 1, end, less_than)) {
+            // The range was already (nearly) sorted.
+            return;
+        }
+
+        // Recurse into the smaller part and loop on the larger one, to keep the stack depth at O(log n).
+        if (left_size < right_size) {
+            pattern_defeating_quick_sort(col, start, pivot_position, less_than, bad_allowed, leftmost);
+            start = pivot_position + 1;
+            leftmost = false;
+        } else {
+            pattern_defeating_quick_sort(col, pivot_position + 1, end, less_than, bad_allowed, false);
+            end = pivot_position;
+        }
+    }
+}
+
+// Merges the sorted ranges [start, middle) and [middle, end), moving the smaller of them out into |buffer|.
+template<typename Collection, typename T, typename LessThan>
+void merge_adjacent(Collection& col, size_t start, size_t middle, size_t end, T* buffer, LessThan& less_than)
+{
+    if (!less_than(col[middle], col[middle - 1]))
+        return;
+
+    auto left_size = middle - start;
+    auto right_size = end - middle;
+    if (left_size <= right_size) {
+        for (size_t i = 0; i < left_size; ++i)
+            new (&buffer[i]) T(move(col[start + i]));
+        size_t i = 0;
+        auto j = middle;
+        auto destination = start;
+        while (i < left_size) {
+            if (j < end && less_than(col[j], buffer[i]))
+                col[destination++] = move(col[j++]);
+            else
+                col[destination++] = move(buffer[i++]);
+        }
+        for (i = 0; i < left_size; ++i)
+            buffer[i].~T();
+    } else {
+        for (size_t i = 0; i < right_size; ++i)
+            new (&buffer[i]) T(move(col[middle + i]));
+        auto i = middle;
+        auto j = right_size;
+        auto destination = end;
+        while (j > 0) {
+            if (i > start && less_than(buffer[j - 1], col[i - 1]))
+                col[--destination] = move(col[--i]);
+            else
+                col[--destination] = move(buffer[--j]);
+        }
+        for (j = 0; j < right_size; ++j)
+            buffer[j].~T();
+    }
+}
+
+template<typename Collection, typename LessThan>
+void merge_sort(Collection& col, size_t size, LessThan& less_than)
+{
+    using T = RemoveCV<RemoveReference<decltype(col[0])>>;
+    static constexpr size_t run_size = 16;
+
+    if (size < 2)
+        return;
+
+    for (size_t start = 0; start < size; start += run_size)
+        stable_insertion_sort(col, start, min(start + run_size, size), less_than);
+    if (size <= run_size)
+        return;
+
+    // Neither side of a merge is ever larger than half the collection.
+    auto* buffer = static_cast<T*>(kmalloc(sizeof(T) * (size / 2)));
+    VERIFY(buffer);
+    for (size_t width = run_size; width < size; width *= 2) {
+        for (size_t start = 0; start + width < size; start += 2 * width)
+            merge_adjacent(col, start, start + width, min(start + 2 * width, size), buffer, less_than);
+    }
+    kfree(buffer);
+}
+
+}
+
+// A pattern-defeating quick sort (pdqsort) of [start, end): introsort with median-of-three pivots, insertion
+// sort for short ranges, special handling for runs of equal and already sorted elements, and a heap sort fallback
+// that bounds the worst case at O(n log n). Not stable; see merge_sort() for that.
+template<typename Collection, typename LessThan>
+void pattern_defeating_quick_sort(Collection& collection, size_t start, size_t end, LessThan less_than)
+{
+    if (end - start < 2)
+        return;
+    int bad_allowed = 0;
+    for (auto size = end - start; size > 1; size >>= 1)
+        ++bad_allowed;
+    Detail::pattern_defeating_quick_sort(collection, start, end, less_than, bad_allowed, true);
+}
+
 template<typename Iterator>
 void quick_sort(Iterator start, Iterator end)
 {
-    single_pivot_quick_sort(start, end, [](auto& a, auto& b) { return a < b; });
+    Detail::IteratorRange<Iterator> range { start };
+    pattern_defeating_quick_sort(range, 0, end - start, [](auto& a, auto& b) { return a < b; });
 }
 
 template<typename Iterator, typename LessThan>
 void quick_sort(Iterator start, Iterator end, LessThan less_than)
 {
-    single_pivot_quick_sort(start, end, move(less_than));
+    Detail::IteratorRange<Iterator> range { start };
+    pattern_defeating_quick_sort(range, 0, end - start, move(less_than));
 }
 
 template<typename Collection, typename LessThan>
 void quick_sort(Collection& collection, LessThan less_than)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1, move(less_than));
+    pattern_defeating_quick_sort(collection, 0, collection.size(), move(less_than));
 }
 
 template<typename Collection>
 void quick_sort(Collection& collection)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1,
+    pattern_defeating_quick_sort(collection, 0, collection.size(),
         [](auto& a, auto& b) { return a < b; });
 }
 
+// A stable merge sort: elements that compare equal keep their relative order.
+// Sorts short runs with insertion sort and merges them bottom-up, using a scratch buffer of half the input size.
+template<typename Iterator, typename LessThan>
+void merge_sort(Iterator start, Iterator end, LessThan less_than)
+{
+    Detail::IteratorRange<Iterator> range { start };
+    Detail::merge_sort(range, end - start, less_than);
+}
+
+template<typename Collection, typename LessThan>
+void merge_sort(Collection& collection, LessThan less_than)
+{
+    Detail::merge_sort(collection, collection.size(), less_than);
+}
+
+template<typename Collection>
+void merge_sort(Collection& collection)
+{
+    merge_sort(collection, [](auto& a, auto& b) { return a < b; });
+}
+
 }
 
+using AK::merge_sort;
 using AK::quick_sort;
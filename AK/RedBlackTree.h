@@ -40,6 +40,10 @@ protected:
     BaseRedBlackTree() = default; // These are protected to ensure no one instantiates the leaky base red black tree directly
     virtual ~BaseRedBlackTree() {};
 
+    // Trees that keep data about each node's subtree (like the largest value in it) can update it here.
+    // This is only called for the nodes of a rotation; after an insertion or removal, the path up to the root has to be updated too.
+    virtual void subtree_did_change(Node*) { }
+
     void rotate_left(Node* subtree_root)
     {
         VERIFY(subtree_root);
@@ -65,6 +69,9 @@ protected:
         } else { // we are the right child
             parent->right_child = pivot;
         }
+
+        subtree_did_change(subtree_root);
+        subtree_did_change(pivot);
     }
 
     void rotate_right(Node* subtree_root)
@@ -92,6 +99,9 @@ protected:
         } else { // we are the right child
             parent->right_child = pivot;
         }
+
+        subtree_did_change(subtree_root);
+        subtree_did_change(pivot);
     }
 
     static Node* find(Node* node, K key)
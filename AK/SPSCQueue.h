@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A bounded, lock-free queue for exactly one producer thread and one consumer thread.
+// Both sides only ever write their own index, so neither enqueue nor dequeue needs a read-modify-write.
+template<typename T, size_t Capacity>
+class SPSCQueue {
+    AK_MAKE_NONCOPYABLE(SPSCQueue);
+    AK_MAKE_NONMOVABLE(SPSCQueue);
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "SPSCQueue capacity must be a power of two");
+
+public:
+    SPSCQueue() = default;
+
+    ~SPSCQueue()
+    {
+        while (try_dequeue().has_value())
+            ;
+    }
+
+    // Producer side.
+    template<typename U = T>
+    [[nodiscard]] bool try_enqueue(U&& value)
+    {
+        auto head = m_head.load(AK::MemoryOrder::memory_order_relaxed);
+        if (head - m_cached_tail == Capacity) {
+            m_cached_tail = m_tail.load(AK::MemoryOrder::memory_order_acquire);
+            if (head - m_cached_tail == Capacity)
+                return false;
+        }
+        new (&slot(head)) T(forward<U>(value));
+        m_head.store(head + 1, AK::MemoryOrder::memory_order_release);
+        return true;
+    }
+
+    // Consumer side.
+    [[nodiscard]] Optional<T> try_dequeue()
+    {
+        auto tail = m_tail.load(AK::MemoryOrder::memory_order_relaxed);
+        if (tail == m_cached_head) {
+            m_cached_head = m_head.load(AK::MemoryOrder::memory_order_acquire);
+            if (tail == m_cached_head)
+                return {};
+        }
+        auto& element = slot(tail);
+        Optional<T> value = move(element);
+        element.~T();
+        m_tail.store(tail + 1, AK::MemoryOrder::memory_order_release);
+        return value;
+    }
+
+    // Only a snapshot when called while the other side is active.
+    size_t size() const { return m_head.load(AK::MemoryOrder::memory_order_acquire) - m_tail.load(AK::MemoryOrder::memory_order_acquire); }
+    bool is_empty() const { return size() == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    T& slot(size_t index) { return reinterpret_cast<T*>(m_storage)[index & (Capacity - 1)]; }
+
+    // Keep the producer's and the consumer's state on separate cache lines, so they don't keep stealing them from each other.
+    alignas(64) Atomic<size_t> m_head { 0 };
+    size_t m_cached_tail { 0 };
+    alignas(64) Atomic<size_t> m_tail { 0 };
+    size_t m_cached_head { 0 };
+    alignas(64) alignas(T) u8 m_storage[sizeof(T) * Capacity];
+};
+
+}
+
+using AK::SPSCQueue;
@@ -434,6 +434,9 @@ inline constexpr bool IsTrivial = __is_trivial(T);
 template<typename T>
 inline constexpr bool IsTriviallyCopyable = __is_trivially_copyable(T);
 
+template<typename T>
+inline constexpr bool IsTriviallyDestructible = __has_trivial_destructor(T);
+
 }
 using AK::Detail::AddConst;
 using AK::Detail::Conditional;
@@ -461,6 +464,7 @@ using AK::Detail::IsSame;
 using AK::Detail::IsSigned;
 using AK::Detail::IsTrivial;
 using AK::Detail::IsTriviallyCopyable;
+using AK::Detail::IsTriviallyDestructible;
 using AK::Detail::IsUnion;
 using AK::Detail::IsUnsigned;
 using AK::Detail::IsVoid;
@@ -280,6 +280,7 @@ private:
 
 template<>
 struct Traits<String> : public GenericTraits<String> {
+    static constexpr bool is_trivially_relocatable() { return true; }
     static unsigned hash(const String& s) { return s.impl() ? s.impl()->hash() : 0; }
 };
 
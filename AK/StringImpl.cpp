@@ -40,6 +40,27 @@ StringImpl& StringImpl::the_empty_stringimpl()
     return *s_the_empty_stringimpl;
 }
 
+// One-character strings are very common (lexer output, JSON array indices, single digits from String::number()),
+// so we keep one shared StringImpl per byte value around instead of allocating a new one every time.
+static StringImpl* s_single_character_stringimpls = nullptr;
+static constexpr size_t single_character_stringimpl_slot_size = (sizeof(StringImpl) + 2 * sizeof(char) + alignof(StringImpl) - 1) & ~(alignof(StringImpl) - 1);
+
+StringImpl& StringImpl::the_single_character_stringimpl(char ch)
+{
+    if (!s_single_character_stringimpls) {
+        auto* slots = static_cast<u8*>(kmalloc(single_character_stringimpl_slot_size * 256));
+        VERIFY(slots);
+        for (size_t i = 0; i < 256; ++i) {
+            auto* impl = new (slots + i * single_character_stringimpl_slot_size) StringImpl(ConstructWithInlineBuffer, 1);
+            impl->m_inline_buffer[0] = static_cast<char>(i);
+            impl->m_inline_buffer[1] = '\0';
+        }
+        s_single_character_stringimpls = reinterpret_cast<StringImpl*>(slots);
+    }
+    auto* slot = reinterpret_cast<u8*>(s_single_character_stringimpls) + static_cast<u8>(ch) * single_character_stringimpl_slot_size;
+    return *reinterpret_cast<StringImpl*>(slot);
+}
+
 StringImpl::StringImpl(ConstructWithInlineBufferTag, size_t length)
     : m_length(length)
 {
@@ -95,6 +116,9 @@ RefPtr<StringImpl> StringImpl::create(const char* cstring, size_t length, Should
     if (!length)
         return the_empty_stringimpl();
 
+    if (length == 1)
+        return the_single_character_stringimpl(cstring[0]);
+
     char* buffer;
     auto new_stringimpl = create_uninitialized(length, buffer);
     memcpy(buffer, cstring, length * sizeof(char));
@@ -35,6 +35,7 @@ public:
     }
 
     static StringImpl& the_empty_stringimpl();
+    static StringImpl& the_single_character_stringimpl(char);
 
     ~StringImpl();
 
@@ -52,6 +53,8 @@ public:
 
     bool operator==(const StringImpl& other) const
     {
+        if (this == &other)
+            return true;
         if (length() != other.length())
             return false;
         return !__builtin_memcmp(characters(), other.characters(), length());
@@ -8,6 +8,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Find.h>
 #include <AK/FlyString.h>
+#include <AK/MemMem.h>
 #include <AK/Memory.h>
 #include <AK/String.h>
 #include <AK/StringView.h>
@@ -155,11 +156,7 @@ bool StringView::matches(const StringView& mask, CaseSensitivity case_sensitivit
 
 bool StringView::contains(char needle) const
 {
-    for (char current : *this) {
-        if (current == needle)
-            return true;
-    }
-    return false;
+    return find(needle).has_value();
 }
 
 bool StringView::contains(const StringView& needle, CaseSensitivity case_sensitivity) const
@@ -236,10 +233,7 @@ bool StringView::operator==(const String& string) const
 
 Optional<size_t> StringView::find_first_of(char c) const
 {
-    if (const auto location = AK::find(begin(), end(), c); location != end()) {
-        return location.index();
-    }
-    return {};
+    return find_byte(bytes(), c);
 }
 
 Optional<size_t> StringView::find_first_of(const StringView& view) const
@@ -280,7 +274,7 @@ Optional<size_t> StringView::find_last_of(const StringView& view) const
 
 Optional<size_t> StringView::find(char c) const
 {
-    return find(StringView { &c, 1 });
+    return find_byte(bytes(), c);
 }
 
 Optional<size_t> StringView::find(const StringView& view) const
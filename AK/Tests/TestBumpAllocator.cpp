@@ -0,0 +1,147 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/BumpAllocator.h>
+#include <AK/OwnPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+TEST_CASE(allocations_are_aligned)
+{
+    BumpAllocator allocator;
+    for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+        auto* pointer = allocator.allocate(3, alignment);
+        EXPECT_EQ(reinterpret_cast<FlatPtr>(pointer) % alignment, 0u);
+    }
+    auto* value = allocator.allocate<u64>(42u);
+    EXPECT_EQ(reinterpret_cast<FlatPtr>(value) % alignof(u64), 0u);
+    EXPECT_EQ(*value, 42u);
+}
+
+TEST_CASE(spans_multiple_chunks)
+{
+    BumpAllocator allocator(256);
+    Vector<u32*> values;
+    for (u32 i = 0; i < 1000; ++i)
+        values.append(allocator.allocate<u32>(i));
+    for (u32 i = 0; i < 1000; ++i)
+        EXPECT_EQ(*values[i], i);
+    EXPECT_EQ(allocator.bytes_allocated(), 4000u);
+    EXPECT(allocator.bytes_reserved() >= 4000u);
+
+    auto huge = allocator.allocate_array<u8>(4096);
+    EXPECT_EQ(huge.size(), 4096u);
+    EXPECT_EQ(huge[4095], 0);
+    EXPECT_EQ(*values[999], 999u);
+}
+
+TEST_CASE(runs_destructors_in_reverse_order)
+{
+    static Vector<int> destroyed;
+    struct Tracker {
+        explicit Tracker(int id)
+            : id(id)
+        {
+        }
+        ~Tracker() { destroyed.append(id); }
+        int id;
+    };
+
+    BumpAllocator allocator;
+    for (int i = 0; i < 3; ++i)
+        (void)allocator.allocate<Tracker>(i);
+    auto* string = allocator.allocate<String>("not trivially destructible");
+    EXPECT_EQ(*string, "not trivially destructible");
+
+    allocator.deallocate_all();
+    EXPECT_EQ(destroyed.size(), 3u);
+    EXPECT_EQ(destroyed[0], 2);
+    EXPECT_EQ(destroyed[2], 0);
+    EXPECT_EQ(allocator.bytes_allocated(), 0u);
+
+    (void)allocator.allocate<Tracker>(7);
+    allocator.deallocate_all();
+    EXPECT_EQ(destroyed.size(), 4u);
+    EXPECT_EQ(destroyed[3], 7);
+}
+
+TEST_CASE(reuses_chunks)
+{
+    BumpAllocator allocator(1024);
+    auto* first = allocator.allocate(16);
+    allocator.deallocate_all();
+    auto* second = allocator.allocate(16);
+    EXPECT_EQ(first, second);
+}
+
+TEST_CASE(copy_string)
+{
+    BumpAllocator allocator;
+    String original = "hello friends";
+    auto copy = allocator.copy_string(original);
+    EXPECT_EQ(copy, "hello friends");
+    EXPECT(copy.characters_without_null_termination() != original.characters());
+    EXPECT(allocator.copy_string({}).is_null());
+    EXPECT(!allocator.copy_string("").is_null());
+}
+
+struct TreeNode {
+    TreeNode* left { nullptr };
+    TreeNode* right { nullptr };
+    int value { 0 };
+};
+
+struct OwnedTreeNode {
+    OwnPtr<OwnedTreeNode> left;
+    OwnPtr<OwnedTreeNode> right;
+    int value { 0 };
+};
+
+static constexpr int tree_depth = 18;
+
+static TreeNode* build_tree(BumpAllocator& allocator, int depth)
+{
+    auto* node = allocator.allocate<TreeNode>();
+    node->value = depth;
+    if (depth) {
+        node->left = build_tree(allocator, depth - 1);
+        node->right = build_tree(allocator, depth - 1);
+    }
+    return node;
+}
+
+static NonnullOwnPtr<OwnedTreeNode> build_owned_tree(int depth)
+{
+    auto node = make<OwnedTreeNode>();
+    node->value = depth;
+    if (depth) {
+        node->left = build_owned_tree(depth - 1);
+        node->right = build_owned_tree(depth - 1);
+    }
+    return node;
+}
+
+BENCHMARK_CASE(build_tree_with_bump_allocator)
+{
+    BumpAllocator allocator;
+    for (int i = 0; i < 10; ++i) {
+        auto* root = build_tree(allocator, tree_depth);
+        EXPECT_EQ(root->left->value, tree_depth - 1);
+        allocator.deallocate_all();
+    }
+}
+
+BENCHMARK_CASE(build_tree_with_make)
+{
+    for (int i = 0; i < 10; ++i) {
+        auto root = build_owned_tree(tree_depth);
+        EXPECT_EQ(root->left->value, tree_depth - 1);
+    }
+}
+
+TEST_MAIN(BumpAllocator)
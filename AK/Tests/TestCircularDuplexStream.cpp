@@ -62,4 +62,29 @@ TEST_CASE(overwritting_is_well_defined)
     EXPECT(stream.eof());
 }
 
+TEST_CASE(copy_from_seekback_repeats_overlapping_bytes)
+{
+    constexpr size_t capacity = 32;
+
+    CircularDuplexStream<capacity> stream;
+
+    // Move the start of the queue close to the end of the storage, so that the copy has to wrap around it.
+    for (size_t idx = 0; idx < capacity - 3; ++idx)
+        stream << static_cast<u8>(0);
+    EXPECT(stream.discard_or_error(capacity - 3));
+
+    stream << static_cast<u8>(1) << static_cast<u8>(2);
+    EXPECT(stream.copy_from_seekback(2, 7));
+
+    Array<u8, 9> buffer;
+    stream >> buffer;
+
+    for (size_t idx = 0; idx < buffer.size(); ++idx)
+        EXPECT_EQ(buffer[idx], idx % 2 + 1);
+
+    EXPECT(stream.eof());
+    EXPECT(!stream.copy_from_seekback(capacity + 1, 1));
+    EXPECT(stream.handle_any_error());
+}
+
 TEST_MAIN(CircularDuplexStream)
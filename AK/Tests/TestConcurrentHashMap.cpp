@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/ConcurrentHashMap.h>
+#include <AK/String.h>
+#include <pthread.h>
+
+TEST_CASE(basic)
+{
+    ConcurrentHashMap<String, int> map;
+    EXPECT(map.is_empty());
+    EXPECT(map.set("one", 1) == AK::HashSetResult::InsertedNewEntry);
+    EXPECT(map.set("two", 2) == AK::HashSetResult::InsertedNewEntry);
+    EXPECT(map.set("two", 22) == AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(map.size(), 2u);
+    EXPECT_EQ(map.get("two").value(), 22);
+    EXPECT(!map.get("three").has_value());
+    EXPECT(map.contains("one"));
+
+    EXPECT(map.remove("one"));
+    EXPECT(!map.remove("one"));
+    EXPECT_EQ(map.take("two").value(), 22);
+    EXPECT(map.is_empty());
+
+    EXPECT_EQ(map.update("counter", [](int& value) { return ++value; }), 1);
+    EXPECT_EQ(map.update("counter", [](int& value) { return ++value; }), 2);
+
+    map.set("other", 5);
+    int sum = 0;
+    map.for_each([&](auto&, int value) { sum += value; });
+    EXPECT_EQ(sum, 7);
+
+    map.clear();
+    EXPECT(map.is_empty());
+    EXPECT(!map.contains("counter"));
+}
+
+static constexpr size_t thread_count = 4;
+static constexpr int operations_per_thread = 100000;
+
+struct StressTest {
+    ConcurrentHashMap<int, int> map;
+    int next_thread { 0 };
+};
+
+static void* hammer(void* argument)
+{
+    auto& test = *static_cast<StressTest*>(argument);
+    int thread = __atomic_fetch_add(&test.next_thread, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < operations_per_thread; ++i) {
+        // Private keys: insert, read back, and remove every other one.
+        int key = thread * operations_per_thread + i;
+        (void)test.map.set(key, i);
+        if (test.map.get(key).value_or(-1) != i)
+            return (void*)1;
+        if (i % 2)
+            test.map.remove(key);
+        // A shared counter that every thread bumps.
+        test.map.update(-1, [](int& value) { ++value; });
+    }
+    return nullptr;
+}
+
+static void run_stress_test()
+{
+    StressTest test;
+    pthread_t threads[thread_count];
+    for (auto& thread : threads)
+        EXPECT_EQ(pthread_create(&thread, nullptr, hammer, &test), 0);
+    for (auto& thread : threads) {
+        void* result = nullptr;
+        pthread_join(thread, &result);
+        EXPECT(!result);
+    }
+    EXPECT_EQ(test.map.get(-1).value(), (int)thread_count * operations_per_thread);
+    EXPECT_EQ(test.map.size(), thread_count * operations_per_thread / 2 + 1);
+}
+
+TEST_CASE(many_threads)
+{
+    run_stress_test();
+}
+
+BENCHMARK_CASE(throughput)
+{
+    for (size_t i = 0; i < 3; ++i)
+        run_stress_test();
+}
+
+TEST_MAIN(ConcurrentHashMap)
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/FlatMap.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+
+TEST_CASE(construct)
+{
+    FlatMap<int, int> map;
+    EXPECT(map.is_empty());
+    EXPECT_EQ(map.size(), 0u);
+}
+
+TEST_CASE(populate)
+{
+    FlatMap<int, String> number_to_string;
+    number_to_string.set(3, "Three");
+    number_to_string.set(1, "One");
+    number_to_string.set(2, "Two");
+
+    EXPECT_EQ(number_to_string.is_empty(), false);
+    EXPECT_EQ(number_to_string.size(), 3u);
+    EXPECT_EQ(number_to_string.get(2).value(), "Two");
+    EXPECT(!number_to_string.get(4).has_value());
+}
+
+TEST_CASE(iterates_in_key_order)
+{
+    FlatMap<String, int> map { { "c", 3 }, { "a", 1 }, { "b", 2 } };
+    Vector<String> keys;
+    for (auto& entry : map)
+        keys.append(entry.key);
+    EXPECT_EQ(keys.size(), 3u);
+    EXPECT_EQ(keys[0], "a");
+    EXPECT_EQ(keys[1], "b");
+    EXPECT_EQ(keys[2], "c");
+    EXPECT_EQ(map.keys(), keys);
+}
+
+TEST_CASE(set_replaces_and_remove)
+{
+    FlatMap<int, int, 4> map;
+    EXPECT(map.set(1, 10) == AK::HashSetResult::InsertedNewEntry);
+    EXPECT(map.set(1, 11) == AK::HashSetResult::ReplacedExistingEntry);
+    EXPECT_EQ(map.size(), 1u);
+    EXPECT_EQ(map.get(1).value(), 11);
+
+    map.set(5, 50);
+    map.set(3, 30);
+    EXPECT(map.remove(3));
+    EXPECT(!map.remove(3));
+    EXPECT(!map.contains(3));
+    EXPECT(map.contains(5));
+
+    auto it = map.find(5);
+    EXPECT(it != map.end());
+    map.remove(it);
+    EXPECT_EQ(map.size(), 1u);
+
+    map.ensure(7) = 70;
+    map.ensure(7) += 1;
+    EXPECT_EQ(map.get(7).value(), 71);
+}
+
+TEST_CASE(move_only_values)
+{
+    FlatMap<String, NonnullOwnPtr<int>> map;
+    map.set("one", make<int>(1));
+    map.set("two", make<int>(2));
+    map.set("one", make<int>(11));
+    EXPECT_EQ(*map.find("one")->value, 11);
+    EXPECT_EQ(*map.find("two")->value, 2);
+}
+
+TEST_CASE(matches_hash_map)
+{
+    FlatMap<u32, u32> flat_map;
+    HashMap<u32, u32> hash_map;
+    u32 seed = 1;
+    for (size_t i = 0; i < 2000; ++i) {
+        seed = seed * 1103515245 + 12345;
+        u32 key = (seed >> 16) % 128;
+        if (seed & 1) {
+            flat_map.set(key, i);
+            hash_map.set(key, i);
+        } else {
+            EXPECT_EQ(flat_map.remove(key), hash_map.remove(key));
+        }
+        EXPECT_EQ(flat_map.size(), hash_map.size());
+    }
+    for (auto& entry : hash_map)
+        EXPECT_EQ(flat_map.get(entry.key).value(), entry.value);
+}
+
+BENCHMARK_CASE(small_map_lookups)
+{
+    FlatMap<u32, u32, 16> map;
+    for (u32 i = 0; i < 16; ++i)
+        map.set(i * 7, i);
+    u32 sum = 0;
+    for (size_t i = 0; i < 10000000; ++i)
+        sum += map.get((i % 16) * 7).value();
+    EXPECT(sum > 0);
+}
+
+BENCHMARK_CASE(small_hash_map_lookups)
+{
+    HashMap<u32, u32> map;
+    for (u32 i = 0; i < 16; ++i)
+        map.set(i * 7, i);
+    u32 sum = 0;
+    for (size_t i = 0; i < 10000000; ++i)
+        sum += map.get((i % 16) * 7).value();
+    EXPECT(sum > 0);
+}
+
+BENCHMARK_CASE(copy_small_map)
+{
+    FlatMap<u32, u32> map;
+    for (u32 i = 0; i < 32; ++i)
+        map.set(i, i);
+    size_t total = 0;
+    for (size_t i = 0; i < 200000; ++i) {
+        auto copy = map;
+        total += copy.size();
+    }
+    EXPECT_EQ(total, 32u * 200000);
+}
+
+BENCHMARK_CASE(copy_small_hash_map)
+{
+    HashMap<u32, u32> map;
+    for (u32 i = 0; i < 32; ++i)
+        map.set(i, i);
+    size_t total = 0;
+    for (size_t i = 0; i < 200000; ++i) {
+        auto copy = map;
+        total += copy.size();
+    }
+    EXPECT_EQ(total, 32u * 200000);
+}
+
+TEST_MAIN(FlatMap)
@@ -248,9 +248,22 @@ TEST_CASE(no_precision_no_trailing_number)
     EXPECT_EQ(String::formatted("{:.0}", 0.1), "0");
 }
 
-TEST_CASE(yay_this_implementation_sucks)
+TEST_CASE(floating_point_rounding)
 {
-    EXPECT_EQ(String::formatted("{:.0}", .99999999999), "0");
+    EXPECT_EQ(String::formatted("{:.0}", .99999999999), "1");
+    EXPECT_EQ(String::formatted("{:.2}", 1.006), "1.01");
+    EXPECT_EQ(String::formatted("{:.1}", 0.96), "1");
+    EXPECT_EQ(String::formatted("{:.3}", 1.05), "1.05");
+    EXPECT_EQ(String::formatted("{}", 0.0000002), "0");
+    EXPECT_EQ(String::formatted("{:.20}", 0.1), "0.1");
+}
+
+TEST_CASE(floating_point_special_values)
+{
+    EXPECT_EQ(String::formatted("{}", __builtin_nan("")), "nan");
+    EXPECT_EQ(String::formatted("{}", __builtin_huge_val()), "inf");
+    EXPECT_EQ(String::formatted("{}", -__builtin_huge_val()), "-inf");
+    EXPECT_EQ(String::formatted("{:>5}", __builtin_huge_val()), "  inf");
 }
 
 TEST_CASE(magnitude_less_than_zero)
@@ -259,6 +272,18 @@ TEST_CASE(magnitude_less_than_zero)
     EXPECT_EQ(String::formatted("{}", 0.654), "0.654");
 }
 
+TEST_CASE(format_integer_limits)
+{
+    EXPECT_EQ(String::formatted("{}", NumericLimits<i64>::min()), "-9223372036854775808");
+    EXPECT_EQ(String::formatted("{}", NumericLimits<i64>::max()), "9223372036854775807");
+    EXPECT_EQ(String::formatted("{}", NumericLimits<u64>::max()), "18446744073709551615");
+    EXPECT_EQ(String::formatted("{:x}", NumericLimits<u64>::max()), "ffffffffffffffff");
+    EXPECT_EQ(String::formatted("{:o}", 4294967296ull), "40000000000");
+    EXPECT_EQ(String::formatted("{}", 100u), "100");
+    EXPECT_EQ(String::formatted("{}", 9), "9");
+    EXPECT_EQ(String::formatted("{}", 0), "0");
+}
+
 TEST_CASE(format_nullptr)
 {
     EXPECT_EQ(String::formatted("{}", nullptr), String::formatted("{:p}", static_cast<FlatPtr>(0)));
@@ -291,4 +316,28 @@ TEST_CASE(long_long_regression)
     EXPECT_EQ(builder.string_view(), "81985529216486895");
 }
 
+BENCHMARK_CASE(format_integers_and_strings)
+{
+    size_t total = 0;
+    for (int i = 0; i < 1000000; ++i)
+        total += String::formatted("Process {} ({}) mapped {} bytes at {:p}", "WindowServer", i, static_cast<u64>(i) * 4096, reinterpret_cast<void*>(static_cast<FlatPtr>(i))).length();
+    EXPECT(total > 0);
+}
+
+BENCHMARK_CASE(format_doubles)
+{
+    size_t total = 0;
+    for (int i = 0; i < 1000000; ++i)
+        total += String::formatted("{} {:.2}", i / 7.0, i * 0.001).length();
+    EXPECT(total > 0);
+}
+
+BENCHMARK_CASE(format_literal_heavy)
+{
+    size_t total = 0;
+    for (int i = 0; i < 1000000; ++i)
+        total += String::formatted("This is a reasonably long log message with a single number {} in the middle of it.", i).length();
+    EXPECT(total > 0);
+}
+
 TEST_MAIN(Format)
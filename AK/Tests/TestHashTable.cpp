@@ -8,6 +8,7 @@
 
 #include <AK/HashTable.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(construct)
 {
@@ -174,4 +175,93 @@ TEST_CASE(basic_contains)
     EXPECT_EQ(table.contains(1), false);
 }
 
+TEST_CASE(remove_while_iterating)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 1000; ++i)
+        table.set(i);
+
+    for (auto it = table.begin(); it != table.end(); ++it) {
+        if (*it % 2)
+            table.remove(it);
+    }
+
+    EXPECT_EQ(table.size(), 500u);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(table.contains(i), i % 2 == 0);
+}
+
+TEST_CASE(removal_does_not_move_entries)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 100; ++i)
+        table.set(i);
+
+    auto* fifty = &*table.find(50);
+    for (int i = 0; i < 100; i += 3)
+        table.remove(i);
+
+    EXPECT_EQ(&*table.find(50), fifty);
+}
+
+BENCHMARK_CASE(benchmark_insert)
+{
+    for (int round = 0; round < 10; ++round) {
+        HashTable<int> table;
+        for (int i = 0; i < 100000; ++i)
+            table.set(i);
+        EXPECT_EQ(table.size(), 100000u);
+    }
+}
+
+BENCHMARK_CASE(benchmark_lookup)
+{
+    HashTable<int> table;
+    for (int i = 0; i < 100000; ++i)
+        table.set(i);
+
+    size_t found = 0;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 200000; ++i) {
+            if (table.contains(i))
+                ++found;
+        }
+    }
+    EXPECT_EQ(found, 1000000u);
+}
+
+BENCHMARK_CASE(benchmark_lookup_strings)
+{
+    HashTable<String> table;
+    Vector<String> keys;
+    for (int i = 0; i < 20000; ++i) {
+        keys.append(String::formatted("key-{}", i));
+        table.set(keys.last());
+    }
+
+    size_t found = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (auto& key : keys) {
+            if (table.contains(key))
+                ++found;
+        }
+    }
+    EXPECT_EQ(found, 400000u);
+}
+
+BENCHMARK_CASE(benchmark_erase_churn)
+{
+    // Keep the table at a steady size while entries come and go, which is where tombstones pile up.
+    HashTable<int> table;
+    for (int i = 0; i < 10000; ++i)
+        table.set(i);
+
+    for (int i = 10000; i < 1000000; ++i) {
+        table.set(i);
+        table.remove(i - 10000);
+        EXPECT(!table.contains(i - 10000));
+    }
+    EXPECT_EQ(table.size(), 10000u);
+}
+
 TEST_MAIN(HashTable)
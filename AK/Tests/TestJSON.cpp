@@ -9,6 +9,8 @@
 #include <AK/HashMap.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
+#include <AK/JsonReader.h>
 #include <AK/JsonValue.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -122,4 +124,137 @@ TEST_CASE(json_duplicate_keys)
     EXPECT_EQ(json.to_string(), "{\"test\":\"baz\"}");
 }
 
+TEST_CASE(json_reader_tokens)
+{
+    JsonReader reader(R"( {"a": [1, -2.5e3, "x\"y"], "b": {}, "c": [], "d": true, "e": false, "f": null} )");
+    using Token = JsonReader::Token;
+
+    EXPECT(reader.next() == Token::StartObject);
+    EXPECT(reader.next() == Token::Key);
+    EXPECT_EQ(reader.text(), "a");
+    EXPECT(reader.next() == Token::StartArray);
+    EXPECT(reader.next() == Token::Number);
+    EXPECT_EQ(reader.scalar_value()->to_i32(), 1);
+    EXPECT(reader.next() == Token::Number);
+    EXPECT_EQ(reader.text(), "-2.5e3");
+    EXPECT(reader.next() == Token::String);
+    EXPECT_EQ(reader.text(), "x\\\"y");
+    EXPECT(reader.text_has_escapes());
+    EXPECT_EQ(reader.unescaped_text(), "x\"y");
+    EXPECT(reader.next() == Token::EndArray);
+    EXPECT(reader.next() == Token::Key);
+    EXPECT(reader.next() == Token::StartObject);
+    EXPECT(reader.next() == Token::EndObject);
+    EXPECT(reader.next() == Token::Key);
+    EXPECT(reader.next() == Token::StartArray);
+    EXPECT(reader.next() == Token::EndArray);
+    EXPECT(reader.next() == Token::Key);
+    EXPECT(reader.next() == Token::True);
+    EXPECT(reader.next() == Token::Key);
+    EXPECT(reader.next() == Token::False);
+    EXPECT(reader.next() == Token::Key);
+    EXPECT(reader.next() == Token::Null);
+    EXPECT(reader.next() == Token::EndObject);
+    EXPECT(reader.next() == Token::EndOfInput);
+}
+
+TEST_CASE(json_reader_rejects_malformed_input)
+{
+    for (auto input : { "[1,]", "{\"a\":1,}", "{\"a\" 1}", "[1 2]", "[1", "{\"a", "tru", "[]]", "{} {}", "[\"abc]" }) {
+        JsonReader reader(input);
+        auto token = reader.next();
+        while (token != JsonReader::Token::EndOfInput && token != JsonReader::Token::Error)
+            token = reader.next();
+        EXPECT(token == JsonReader::Token::Error);
+        EXPECT(reader.next() == JsonReader::Token::Error);
+    }
+}
+
+TEST_CASE(json_reader_skip_value)
+{
+    StringView input = R"({"skip": {"deep": [1, {"x": [2]}]}, "keep": 3})";
+    JsonReader reader(input);
+    EXPECT(reader.next() == JsonReader::Token::StartObject);
+    EXPECT(reader.next() == JsonReader::Token::Key);
+    EXPECT(reader.next() == JsonReader::Token::StartObject);
+    EXPECT_EQ(reader.skip_value().value(), R"({"deep": [1, {"x": [2]}]})");
+    EXPECT(reader.next() == JsonReader::Token::Key);
+    EXPECT_EQ(reader.text(), "keep");
+    EXPECT(reader.next() == JsonReader::Token::Number);
+    EXPECT_EQ(reader.skip_value().value(), "3");
+    EXPECT(reader.next() == JsonReader::Token::EndObject);
+    EXPECT(reader.next() == JsonReader::Token::EndOfInput);
+}
+
+TEST_CASE(json_reader_for_each_match)
+{
+    StringView input = R"({"processes": [{"pid": 1, "name": "init"}, {"pid": 2, "name": "Window\u0053erver", "pid": 3}], "pid": 99, "n\u0061me": "top"})";
+
+    JsonPath pids;
+    pids.append(StringView { "processes" });
+    pids.append(JsonPathElement::any_array_element);
+    pids.append(StringView { "pid" });
+    Vector<String> matches;
+    EXPECT(JsonReader::for_each_match(input, pids, [&](auto& value) { matches.append(value); }));
+    EXPECT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0], "1");
+    EXPECT_EQ(matches[2], "3");
+
+    JsonPath second_name;
+    second_name.append(StringView { "processes" });
+    second_name.append(1);
+    second_name.append(StringView { "name" });
+    matches.clear();
+    EXPECT(JsonReader::for_each_match(input, second_name, [&](auto& value) { matches.append(value); }));
+    EXPECT_EQ(matches.size(), 1u);
+    EXPECT_EQ(JsonParser(matches[0]).parse()->as_string(), "WindowServer");
+
+    JsonPath escaped_key;
+    escaped_key.append(StringView { "name" });
+    matches.clear();
+    EXPECT(JsonReader::for_each_match(input, escaped_key, [&](auto& value) { matches.append(value); }));
+    EXPECT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0], "\"top\"");
+
+    JsonPath whole_process;
+    whole_process.append(StringView { "processes" });
+    whole_process.append(0);
+    matches.clear();
+    EXPECT(JsonReader::for_each_match(input, whole_process, [&](auto& value) { matches.append(value); }));
+    EXPECT_EQ(matches.size(), 1u);
+    EXPECT_EQ(matches[0], R"({"pid": 1, "name": "init"})");
+
+    EXPECT(!JsonReader::for_each_match("[1, 2", pids, [](auto&) {}));
+}
+
+BENCHMARK_CASE(stream_4chan_catalog)
+{
+    FILE* fp = fopen("4chan_catalog.json", "r");
+    VERIFY(fp);
+
+    StringBuilder builder;
+    for (;;) {
+        char buffer[1024];
+        if (!fgets(buffer, sizeof(buffer), fp))
+            break;
+        builder.append(buffer);
+    }
+
+    fclose(fp);
+
+    auto json_string = builder.to_string();
+
+    JsonPath thread_numbers;
+    thread_numbers.append(JsonPathElement::any_array_element);
+    thread_numbers.append(StringView { "threads" });
+    thread_numbers.append(JsonPathElement::any_array_element);
+    thread_numbers.append(StringView { "no" });
+
+    for (int i = 0; i < 10; ++i) {
+        size_t thread_count = 0;
+        EXPECT(JsonReader::for_each_match(json_string, thread_numbers, [&](auto&) { ++thread_count; }));
+        EXPECT(thread_count > 0);
+    }
+}
+
 TEST_MAIN(JSON)
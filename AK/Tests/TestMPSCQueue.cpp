@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/MPSCQueue.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <pthread.h>
+
+TEST_CASE(bounded_basic)
+{
+    MPSCQueue<int, 4> queue;
+    for (int i = 0; i < 4; ++i)
+        EXPECT(queue.try_enqueue(i));
+    EXPECT(!queue.try_enqueue(4));
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(queue.try_dequeue().value(), i);
+    EXPECT(!queue.try_dequeue().has_value());
+
+    // Wrap around a few times.
+    for (int i = 0; i < 10; ++i) {
+        EXPECT(queue.try_enqueue(i));
+        EXPECT_EQ(queue.try_dequeue().value(), i);
+    }
+}
+
+TEST_CASE(unbounded_basic)
+{
+    UnboundedMPSCQueue<String> queue;
+    EXPECT(!queue.try_dequeue().has_value());
+    queue.enqueue("one");
+    EXPECT_EQ(queue.try_dequeue().value(), "one");
+    EXPECT(!queue.try_dequeue().has_value());
+    for (int i = 0; i < 100; ++i)
+        queue.enqueue(String::number(i));
+    for (int i = 0; i < 50; ++i)
+        EXPECT_EQ(queue.try_dequeue().value(), String::number(i));
+    queue.enqueue("last");
+    for (int i = 50; i < 100; ++i)
+        EXPECT_EQ(queue.try_dequeue().value(), String::number(i));
+    EXPECT_EQ(queue.try_dequeue().value(), "last");
+    EXPECT(!queue.try_dequeue().has_value());
+}
+
+static constexpr size_t producer_count = 4;
+static constexpr size_t items_per_producer = 250000;
+
+// Each item carries its producer in the high bits, so the consumer can check per-producer FIFO order.
+template<typename Queue>
+struct StressTest {
+    Queue queue;
+    size_t next_producer { 0 };
+};
+
+template<typename Queue>
+static bool push(Queue& queue, size_t value)
+{
+    if constexpr (requires { queue.try_enqueue(value); }) {
+        return queue.try_enqueue(value);
+    } else {
+        queue.enqueue(value);
+        return true;
+    }
+}
+
+template<typename Queue>
+static void* produce(void* argument)
+{
+    auto& test = *static_cast<StressTest<Queue>*>(argument);
+    size_t producer = __atomic_fetch_add(&test.next_producer, 1, __ATOMIC_RELAXED);
+    for (size_t i = 0; i < items_per_producer;) {
+        if (push(test.queue, (producer << 32) | i))
+            ++i;
+        else
+            sched_yield();
+    }
+    return nullptr;
+}
+
+template<typename Queue>
+static void run_stress_test()
+{
+    auto* test = new StressTest<Queue>;
+    pthread_t producers[producer_count];
+    for (auto& producer : producers)
+        EXPECT_EQ(pthread_create(&producer, nullptr, produce<Queue>, test), 0);
+
+    size_t next_expected[producer_count] = {};
+    size_t received = 0;
+    while (received < producer_count * items_per_producer) {
+        auto value = test->queue.try_dequeue();
+        if (!value.has_value()) {
+            sched_yield();
+            continue;
+        }
+        auto producer = value.value() >> 32;
+        EXPECT(producer < producer_count);
+        EXPECT_EQ(value.value() & 0xffffffff, next_expected[producer]);
+        ++next_expected[producer];
+        ++received;
+    }
+    for (auto& producer : producers)
+        pthread_join(producer, nullptr);
+    EXPECT(!test->queue.try_dequeue().has_value());
+    delete test;
+}
+
+TEST_CASE(bounded_many_producers)
+{
+    run_stress_test<MPSCQueue<size_t, 256>>();
+}
+
+TEST_CASE(unbounded_many_producers)
+{
+    run_stress_test<UnboundedMPSCQueue<size_t>>();
+}
+
+BENCHMARK_CASE(bounded_throughput)
+{
+    for (size_t i = 0; i < 3; ++i)
+        run_stress_test<MPSCQueue<size_t, 1024>>();
+}
+
+BENCHMARK_CASE(unbounded_throughput)
+{
+    for (size_t i = 0; i < 3; ++i)
+        run_stress_test<UnboundedMPSCQueue<size_t>>();
+}
+
+TEST_MAIN(MPSCQueue)
@@ -7,6 +7,8 @@
 #include <AK/TestSuite.h>
 
 #include <AK/MemMem.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
 
 TEST_CASE(bitap)
 {
@@ -67,4 +69,100 @@ TEST_CASE(kmp_two_chunks)
     EXPECT(!result_3.has_value());
 }
 
+static Optional<size_t> naive_find(ReadonlyBytes haystack, ReadonlyBytes needle)
+{
+    for (size_t i = 0; i + needle.size() <= haystack.size(); ++i) {
+        if (!__builtin_memcmp(haystack.data() + i, needle.data(), needle.size()))
+            return i;
+    }
+    return {};
+}
+
+static Vector<u8> make_text(size_t size, u32 seed)
+{
+    Vector<u8> text;
+    for (size_t i = 0; i < size; ++i) {
+        seed = seed * 1103515245 + 12345;
+        text.append("abcd\n"[(seed >> 16) % 5]);
+    }
+    return text;
+}
+
+TEST_CASE(long_haystack_matches_naive_search)
+{
+    for (u32 seed = 0; seed < 20; ++seed) {
+        auto haystack = make_text(200 + seed * 13, seed);
+        for (size_t needle_length = 1; needle_length < 40; ++needle_length) {
+            for (size_t start : { (size_t)0, (size_t)7, haystack.size() / 2, haystack.size() - needle_length }) {
+                ReadonlyBytes needle { haystack.data() + start, needle_length };
+                auto expected = naive_find(haystack, needle);
+                auto result = AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size());
+                EXPECT_EQ(result, expected);
+            }
+            auto missing = make_text(needle_length, seed + 1000);
+            missing.last() = 'x';
+            EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), missing.data(), missing.size()).has_value());
+        }
+    }
+}
+
+TEST_CASE(repetitive_haystack)
+{
+    Vector<u8> haystack;
+    haystack.resize(100000);
+    __builtin_memset(haystack.data(), 'a', haystack.size());
+    Vector<u8> needle;
+    needle.resize(20);
+    __builtin_memset(needle.data(), 'a', needle.size());
+    needle.last() = 'b';
+
+    EXPECT(!AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()).has_value());
+    haystack.last() = 'b';
+    EXPECT_EQ(AK::memmem_optional(haystack.data(), haystack.size(), needle.data(), needle.size()).value_or(0), haystack.size() - needle.size());
+}
+
+TEST_CASE(find_and_count_byte)
+{
+    auto text = make_text(1000, 1);
+    for (size_t start = 0; start < 40; ++start) {
+        ReadonlyBytes bytes { text.data() + start, text.size() - start };
+        for (u8 byte : { (u8)'a', (u8)'\n', (u8)'x' }) {
+            Optional<size_t> expected_position;
+            size_t expected_count = 0;
+            for (size_t i = 0; i < bytes.size(); ++i) {
+                if (bytes[i] != byte)
+                    continue;
+                if (!expected_position.has_value())
+                    expected_position = i;
+                ++expected_count;
+            }
+            EXPECT_EQ(AK::find_byte(bytes, byte), expected_position);
+            EXPECT_EQ(AK::count_byte(bytes, byte), expected_count);
+        }
+    }
+
+    u8 high_bytes[] = { 0x80, 0xff, 0xfe, 0x7f, 0x80, 0x80, 0x80, 0x80, 0x80, 0xff };
+    EXPECT_EQ(AK::find_byte({ high_bytes, sizeof(high_bytes) }, 0xff).value_or(0), 1u);
+    EXPECT_EQ(AK::count_byte({ high_bytes, sizeof(high_bytes) }, 0x80), 6u);
+    EXPECT(!AK::find_byte({}, 0).has_value());
+}
+
+BENCHMARK_CASE(memmem_text)
+{
+    auto haystack = make_text(1 * MiB, 7);
+    StringView needle = "needle in the haystack";
+    __builtin_memcpy(haystack.data() + haystack.size() - needle.length(), needle.characters_without_null_termination(), needle.length());
+    for (size_t i = 0; i < 20; ++i)
+        EXPECT_EQ(AK::memmem_optional(haystack.data(), haystack.size(), needle.characters_without_null_termination(), needle.length()).value_or(0), haystack.size() - needle.length());
+}
+
+BENCHMARK_CASE(count_newlines)
+{
+    auto text = make_text(1 * MiB, 3);
+    size_t total = 0;
+    for (size_t i = 0; i < 50; ++i)
+        total += AK::count_byte(text, '\n');
+    EXPECT(total > 0);
+}
+
 TEST_MAIN(MemMem)
@@ -10,6 +10,8 @@
 #include <AK/Noncopyable.h>
 #include <AK/QuickSort.h>
 #include <AK/StdLibExtras.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
 
 TEST_CASE(sorts_without_copy)
 {
@@ -44,6 +46,148 @@ TEST_CASE(sorts_without_copy)
 
     for (size_t i = 0; i < 63; ++i)
         EXPECT(array[i].value <= array[i + 1].value);
+
+    // Test the pattern-defeating quick sort.
+    for (size_t i = 0; i < 64; ++i)
+        array[i].value = (64 - i) % 32 + 32;
+
+    quick_sort(array, [](auto& a, auto& b) { return a.value < b.value; });
+
+    for (size_t i = 0; i < 63; ++i)
+        EXPECT(array[i].value <= array[i + 1].value);
+
+    // Test the merge sort.
+    for (size_t i = 0; i < 64; ++i)
+        array[i].value = (64 - i) % 32 + 32;
+
+    merge_sort(array, [](auto& a, auto& b) { return a.value < b.value; });
+
+    for (size_t i = 0; i < 63; ++i)
+        EXPECT(array[i].value <= array[i + 1].value);
+}
+
+// A fixed pseudo-random sequence, so every run sorts the same data.
+static u32 pseudo_random(u32 limit)
+{
+    static u32 state = 1;
+    state = state * 1103515245 + 12345;
+    return (state >> 8) % limit;
+}
+
+static Vector<int> make_pattern(int pattern, int size)
+{
+    Vector<int> data;
+    for (int i = 0; i < size; ++i) {
+        switch (pattern) {
+        case 0: // Random
+            data.append(pseudo_random(1000000));
+            break;
+        case 1: // Ascending
+            data.append(i);
+            break;
+        case 2: // Descending
+            data.append(size - i);
+            break;
+        case 3: // All equal
+            data.append(42);
+            break;
+        case 4: // Organ pipe
+            data.append(i < size / 2 ? i : size - i);
+            break;
+        default: // Few unique values
+            data.append(pseudo_random(4));
+            break;
+        }
+    }
+    return data;
+}
+
+TEST_CASE(sorts_patterns)
+{
+    for (int pattern = 0; pattern < 6; ++pattern) {
+        for (int size : { 0, 1, 2, 23, 24, 25, 128, 129, 1000, 10000 }) {
+            auto data = make_pattern(pattern, size);
+            quick_sort(data);
+            for (int i = 1; i < size; ++i)
+                EXPECT(data[i - 1] <= data[i]);
+
+            data = make_pattern(pattern, size);
+            merge_sort(data);
+            for (int i = 1; i < size; ++i)
+                EXPECT(data[i - 1] <= data[i]);
+        }
+    }
+}
+
+TEST_CASE(adversarial_input_stays_fast)
+{
+    // Count comparisons on inputs that push a naive quick sort towards O(n^2).
+    for (int pattern = 1; pattern < 6; ++pattern) {
+        auto data = make_pattern(pattern, 100000);
+        size_t comparisons = 0;
+        quick_sort(data, [&](int a, int b) {
+            ++comparisons;
+            return a < b;
+        });
+        EXPECT(comparisons < 100000u * 40);
+    }
+}
+
+TEST_CASE(merge_sort_is_stable)
+{
+    struct Entry {
+        int key;
+        int original_position;
+    };
+
+    Vector<Entry> entries;
+    for (int i = 0; i < 5000; ++i)
+        entries.append({ static_cast<int>(pseudo_random(50)), i });
+
+    merge_sort(entries, [](auto& a, auto& b) { return a.key < b.key; });
+
+    for (size_t i = 1; i < entries.size(); ++i) {
+        EXPECT(entries[i - 1].key <= entries[i].key);
+        if (entries[i - 1].key == entries[i].key)
+            EXPECT(entries[i - 1].original_position < entries[i].original_position);
+    }
+}
+
+BENCHMARK_CASE(benchmark_quick_sort_random)
+{
+    auto data = make_pattern(0, 1000000);
+    quick_sort(data);
+    EXPECT(data.first() <= data.last());
+}
+
+BENCHMARK_CASE(benchmark_quick_sort_sorted)
+{
+    auto data = make_pattern(1, 1000000);
+    quick_sort(data);
+    EXPECT(data.first() <= data.last());
+}
+
+BENCHMARK_CASE(benchmark_dual_pivot_quick_sort_random)
+{
+    auto data = make_pattern(0, 1000000);
+    dual_pivot_quick_sort(data, 0, data.size() - 1, [](auto& a, auto& b) { return a < b; });
+    EXPECT(data.first() <= data.last());
+}
+
+BENCHMARK_CASE(benchmark_merge_sort_random)
+{
+    auto data = make_pattern(0, 1000000);
+    merge_sort(data);
+    EXPECT(data.first() <= data.last());
+}
+
+BENCHMARK_CASE(benchmark_quick_sort_strings)
+{
+    Vector<String> data;
+    for (int i = 0; i < 100000; ++i)
+        data.append(String::number(pseudo_random(1000000)));
+    quick_sort(data);
+    EXPECT(data.first() <= data.last());
 }
 
 // This test case may fail to construct a worst-case input if the pivot choice
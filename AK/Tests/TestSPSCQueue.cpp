@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/SPSCQueue.h>
+#include <AK/String.h>
+#include <pthread.h>
+
+TEST_CASE(basic)
+{
+    SPSCQueue<int, 4> queue;
+    EXPECT(queue.is_empty());
+    EXPECT(queue.try_enqueue(1));
+    EXPECT(queue.try_enqueue(2));
+    EXPECT(queue.try_enqueue(3));
+    EXPECT(queue.try_enqueue(4));
+    EXPECT(!queue.try_enqueue(5));
+    EXPECT_EQ(queue.size(), 4u);
+
+    EXPECT_EQ(queue.try_dequeue().value(), 1);
+    EXPECT(queue.try_enqueue(5));
+    EXPECT_EQ(queue.try_dequeue().value(), 2);
+    EXPECT_EQ(queue.try_dequeue().value(), 3);
+    EXPECT_EQ(queue.try_dequeue().value(), 4);
+    EXPECT_EQ(queue.try_dequeue().value(), 5);
+    EXPECT(!queue.try_dequeue().has_value());
+}
+
+TEST_CASE(complex_type)
+{
+    SPSCQueue<String, 2> queue;
+    EXPECT(queue.try_enqueue("hello"));
+    EXPECT(queue.try_enqueue(String("friends")));
+    EXPECT_EQ(queue.try_dequeue().value(), "hello");
+    // The remaining element is destroyed along with the queue.
+}
+
+static constexpr size_t item_count = 1000000;
+
+static void* produce(void* argument)
+{
+    auto& queue = *static_cast<SPSCQueue<size_t, 1024>*>(argument);
+    for (size_t i = 0; i < item_count;) {
+        if (queue.try_enqueue(i))
+            ++i;
+        else
+            sched_yield();
+    }
+    return nullptr;
+}
+
+static void transfer_items()
+{
+    SPSCQueue<size_t, 1024> queue;
+    pthread_t producer;
+    EXPECT_EQ(pthread_create(&producer, nullptr, produce, &queue), 0);
+
+    size_t expected = 0;
+    while (expected < item_count) {
+        auto value = queue.try_dequeue();
+        if (!value.has_value()) {
+            sched_yield();
+            continue;
+        }
+        EXPECT_EQ(value.value(), expected);
+        ++expected;
+    }
+    pthread_join(producer, nullptr);
+    EXPECT(queue.is_empty());
+}
+
+TEST_CASE(producer_and_consumer_threads)
+{
+    transfer_items();
+}
+
+BENCHMARK_CASE(throughput)
+{
+    for (size_t i = 0; i < 5; ++i)
+        transfer_items();
+}
+
+TEST_MAIN(SPSCQueue)
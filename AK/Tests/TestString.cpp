@@ -24,6 +24,24 @@ TEST_CASE(construct_empty)
     EXPECT(String("").impl() == String::empty().impl());
 }
 
+TEST_CASE(single_character_strings_are_shared)
+{
+    EXPECT(String("a").impl() == String("a").impl());
+    EXPECT(String("a").impl() != String("b").impl());
+    EXPECT(String::repeated('x', 1).impl() == String("x").impl());
+    EXPECT(String::number(7).impl() == String("7").impl());
+
+    String high_byte { "\xff" };
+    EXPECT_EQ(high_byte.length(), 1u);
+    EXPECT_EQ(high_byte[0], '\xff');
+    EXPECT_EQ(high_byte.characters()[1], '\0');
+
+    StringBuilder builder;
+    builder.append('q');
+    EXPECT_EQ(builder.to_string(), "q");
+    EXPECT(builder.to_string().impl() == String("q").impl());
+}
+
 TEST_CASE(construct_contents)
 {
     String test_string = "ABCDEF";
@@ -236,4 +254,15 @@ TEST_CASE(sprintf)
     EXPECT_EQ(String(buf2), String("-12"));
 }
 
+BENCHMARK_CASE(create_short_strings)
+{
+    static constexpr const char* words[] = { "a", "{", "0", "id", "key", "value", "length", "prototype" };
+    size_t total_length = 0;
+    for (size_t i = 0; i < 1000000; ++i) {
+        String string { words[i % (sizeof(words) / sizeof(words[0]))] };
+        total_length += string.length();
+    }
+    EXPECT_EQ(total_length, 3500000u);
+}
+
 TEST_MAIN(String)
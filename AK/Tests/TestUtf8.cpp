@@ -6,6 +6,8 @@
 
 #include <AK/TestSuite.h>
 
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
 #include <AK/Utf8View.h>
 
 TEST_CASE(decode_ascii)
@@ -68,4 +70,37 @@ TEST_CASE(validate_invalid_ut8)
     EXPECT(valid_bytes == 0);
 }
 
+TEST_CASE(validate_long_mixed_text)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 100; ++i) {
+        builder.append("The quick brown fox ");
+        builder.append("\xd0\x96\xe2\x82\xac\xf0\x9f\x98\x80");
+    }
+    auto valid_text = builder.to_string();
+    size_t valid_bytes;
+    EXPECT(Utf8View(valid_text).validate(valid_bytes));
+    EXPECT_EQ(valid_bytes, valid_text.length());
+
+    // A truncated sequence right after a long ASCII run.
+    builder.append("ASCII bytes that fill up more than a whole vector");
+    auto truncated_offset = builder.length();
+    builder.append("\xe2\x82");
+    auto truncated_text = builder.to_string();
+    EXPECT(!Utf8View(truncated_text).validate(valid_bytes));
+    EXPECT_EQ(valid_bytes, truncated_offset);
+
+    // A stray continuation byte in the middle of ASCII.
+    auto stray_text = String::formatted("{}\x80{}", String::repeated('a', 37), String::repeated('b', 40));
+    EXPECT(!Utf8View(stray_text).validate(valid_bytes));
+    EXPECT_EQ(valid_bytes, 37u);
+}
+
+BENCHMARK_CASE(validate_ascii_text)
+{
+    auto text = String::repeated('x', 1024 * 1024);
+    for (size_t i = 0; i < 20; ++i)
+        EXPECT(Utf8View(text).validate());
+}
+
 TEST_MAIN(UTF8)
@@ -400,4 +400,84 @@ TEST_CASE(should_find_index)
     EXPECT(!v.find_first_index(42).has_value());
 }
 
+TEST_CASE(should_relocate_non_trivial_elements)
+{
+    Vector<String> strings;
+    for (int i = 0; i < 100; ++i)
+        strings.append(String::number(i));
+    strings.insert(0, "first");
+    strings.insert(50, "middle");
+    strings.remove(10);
+    strings.remove(20, 5);
+    EXPECT_EQ(strings.size(), 96u);
+    EXPECT_EQ(strings[0], "first");
+    EXPECT_EQ(strings[1], "0");
+    EXPECT_EQ(strings[9], "8");
+    EXPECT_EQ(strings[10], "10");
+    EXPECT_EQ(strings[44], "middle");
+    EXPECT_EQ(strings.last(), "99");
+
+    Vector<String, 4> inline_strings;
+    inline_strings.append("a");
+    inline_strings.append("b");
+    auto moved = move(inline_strings);
+    EXPECT(inline_strings.is_empty());
+    EXPECT_EQ(moved.size(), 2u);
+    EXPECT_EQ(moved[1], "b");
+    for (int i = 0; i < 10; ++i)
+        moved.append(String::number(i));
+    EXPECT_EQ(moved[0], "a");
+    EXPECT_EQ(moved.last(), "9");
+}
+
+TEST_CASE(should_relocate_owning_pointers)
+{
+    Vector<NonnullOwnPtr<int>> pointers;
+    for (int i = 0; i < 100; ++i)
+        pointers.append(make<int>(i));
+    pointers.remove(0);
+    pointers.insert(0, make<int>(-1));
+    EXPECT_EQ(*pointers[0], -1);
+    EXPECT_EQ(*pointers[1], 1);
+    EXPECT_EQ(*pointers.last(), 99);
+}
+
+BENCHMARK_CASE(append_strings)
+{
+    for (int round = 0; round < 100; ++round) {
+        Vector<String> strings;
+        String string = "Well Hello Friends!";
+        for (int i = 0; i < 100000; ++i)
+            strings.append(string);
+        EXPECT_EQ(strings.size(), 100000u);
+    }
+}
+
+BENCHMARK_CASE(insert_and_remove_strings_at_front)
+{
+    Vector<String> strings;
+    String string = "Well Hello Friends!";
+    for (int i = 0; i < 1000; ++i)
+        strings.append(string);
+    for (int i = 0; i < 100000; ++i) {
+        strings.insert(0, string);
+        strings.remove(0);
+    }
+    EXPECT_EQ(strings.size(), 1000u);
+}
+
+BENCHMARK_CASE(append_trivially_copyable_structs)
+{
+    struct Point {
+        int x { 0 };
+        int y { 0 };
+    };
+    for (int round = 0; round < 100; ++round) {
+        Vector<Point> points;
+        for (int i = 0; i < 100000; ++i)
+            points.append({ i, i });
+        EXPECT_EQ(points.size(), 100000u);
+    }
+}
+
 TEST_MAIN(Vector)
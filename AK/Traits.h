@@ -8,6 +8,7 @@
 
 #include <AK/Forward.h>
 #include <AK/HashFunctions.h>
+#include <AK/StdLibExtraDetails.h>
 
 namespace AK {
 
@@ -15,6 +16,9 @@ template<typename T>
 struct GenericTraits {
     using PeekType = T;
     static constexpr bool is_trivial() { return false; }
+    // Whether a T can be moved to a new address by copying its bytes, without running the move constructor
+    // or destroying the original. Types that don't point into themselves can opt into this.
+    static constexpr bool is_trivially_relocatable() { return IsTriviallyCopyable<T>; }
     static constexpr bool equals(const T& a, const T& b) { return a == b; }
 };
 
@@ -6,6 +6,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/Format.h>
+#include <AK/MemMem.h>
 #include <AK/Utf8View.h>
 
 namespace AK {
@@ -91,10 +92,38 @@ static inline bool decode_first_byte(
     return false;
 }
 
+static size_t ascii_prefix_length(ReadonlyBytes bytes)
+{
+    auto* data = bytes.data();
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= bytes.size(); i += 16) {
+        if (auto mask = Detail::high_bits_mask(Detail::load_unaligned_u8x16(data + i)))
+            return i + __builtin_ctz(mask);
+    }
+#else
+    for (; i + 8 <= bytes.size(); i += 8) {
+        if (auto mask = Detail::load_unaligned_u64(data + i) & 0x8080808080808080ull)
+            return i + __builtin_ctzll(mask) / 8;
+    }
+#endif
+    while (i < bytes.size() && data[i] < 0x80)
+        ++i;
+    return i;
+}
+
 bool Utf8View::validate(size_t& valid_bytes) const
 {
     valid_bytes = 0;
     for (auto ptr = begin_ptr(); ptr < end_ptr(); ptr++) {
+        // Most text is ASCII, so skip over runs of it in bulk.
+        if (*ptr < 0x80) {
+            auto ascii_length = ascii_prefix_length({ ptr, static_cast<size_t>(end_ptr() - ptr) });
+            valid_bytes += ascii_length;
+            ptr += ascii_length - 1;
+            continue;
+        }
+
         size_t code_point_length_in_bytes;
         u32 value;
         bool first_byte_makes_sense = decode_first_byte(*ptr, code_point_length_in_bytes, value);
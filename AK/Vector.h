@@ -60,12 +60,8 @@ public:
         , m_outline_buffer(other.m_outline_buffer)
     {
         if constexpr (inline_capacity > 0) {
-            if (!m_outline_buffer) {
-                for (size_t i = 0; i < m_size; ++i) {
-                    new (&inline_buffer()[i]) T(move(other.inline_buffer()[i]));
-                    other.inline_buffer()[i].~T();
-                }
-            }
+            if (!m_outline_buffer)
+                relocate(inline_buffer(), other.inline_buffer(), m_size);
         }
         other.m_outline_buffer = nullptr;
         other.m_size = 0;
@@ -99,12 +95,8 @@ public:
             m_capacity = other.m_capacity;
             m_outline_buffer = other.m_outline_buffer;
             if constexpr (inline_capacity > 0) {
-                if (!m_outline_buffer) {
-                    for (size_t i = 0; i < m_size; ++i) {
-                        new (&inline_buffer()[i]) T(move(other.inline_buffer()[i]));
-                        other.inline_buffer()[i].~T();
-                    }
-                }
+                if (!m_outline_buffer)
+                    relocate(inline_buffer(), other.inline_buffer(), m_size);
             }
             other.m_outline_buffer = nullptr;
             other.m_size = 0;
@@ -226,6 +218,9 @@ public:
 
         if constexpr (Traits<T>::is_trivial()) {
             TypedTransfer<T>::copy(slot(index), slot(index + 1), m_size - index - 1);
+        } else if constexpr (is_relocatable()) {
+            at(index).~T();
+            __builtin_memmove(static_cast<void*>(slot(index)), slot(index + 1), (m_size - index - 1) * sizeof(T));
         } else {
             at(index).~T();
             for (size_t i = index + 1; i < m_size; ++i) {
@@ -246,6 +241,10 @@ public:
 
         if constexpr (Traits<T>::is_trivial()) {
             TypedTransfer<T>::copy(slot(index), slot(index + count), m_size - index - count);
+        } else if constexpr (is_relocatable()) {
+            for (size_t i = index; i < index + count; i++)
+                at(i).~T();
+            __builtin_memmove(static_cast<void*>(slot(index)), slot(index + count), (m_size - index - count) * sizeof(T));
         } else {
             for (size_t i = index; i < index + count; i++)
                 at(i).~T();
@@ -268,6 +267,8 @@ public:
         ++m_size;
         if constexpr (Traits<T>::is_trivial()) {
             TypedTransfer<T>::move(slot(index + 1), slot(index), m_size - index - 1);
+        } else if constexpr (is_relocatable()) {
+            __builtin_memmove(static_cast<void*>(slot(index + 1)), slot(index), (m_size - index - 1) * sizeof(T));
         } else {
             for (size_t i = size() - 1; i > index; --i) {
                 new (slot(i)) T(move(at(i - 1)));
@@ -468,16 +469,21 @@ public:
         if (m_capacity >= needed_capacity)
             return;
         size_t new_capacity = needed_capacity;
-        auto* new_buffer = (T*)kmalloc(new_capacity * sizeof(T));
 
-        if constexpr (Traits<T>::is_trivial()) {
-            TypedTransfer<T>::copy(new_buffer, data(), m_size);
-        } else {
-            for (size_t i = 0; i < m_size; ++i) {
-                new (&new_buffer[i]) T(move(at(i)));
-                at(i).~T();
+#ifndef KERNEL
+        if constexpr (is_relocatable()) {
+            // The elements don't care where they live, so let the allocator grow the buffer in place if it can.
+            // Without an inline buffer, there is nothing to move out of one either.
+            if (m_outline_buffer || inline_capacity == 0) {
+                m_outline_buffer = (T*)krealloc(static_cast<void*>(m_outline_buffer), new_capacity * sizeof(T));
+                m_capacity = new_capacity;
+                return;
             }
         }
+#endif
+
+        auto* new_buffer = (T*)kmalloc(new_capacity * sizeof(T));
+        relocate(new_buffer, data(), m_size);
         if (m_outline_buffer)
             kfree(m_outline_buffer);
         m_outline_buffer = new_buffer;
@@ -565,6 +571,22 @@ private:
         m_capacity = inline_capacity;
     }
 
+    static constexpr bool is_relocatable() { return Traits<T>::is_trivial() || Traits<T>::is_trivially_relocatable(); }
+
+    // Moves |count| elements to uninitialized memory at |destination|, leaving |source| uninitialized.
+    static void relocate(T* destination, T* source, size_t count)
+    {
+        if constexpr (is_relocatable()) {
+            if (count)
+                __builtin_memcpy(static_cast<void*>(destination), source, count * sizeof(T));
+        } else {
+            for (size_t i = 0; i < count; ++i) {
+                new (&destination[i]) T(move(source[i]));
+                source[i].~T();
+            }
+        }
+    }
+
     static size_t padded_capacity(size_t capacity)
     {
         return max(static_cast<size_t>(4), capacity + (capacity / 4) + 4);
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// A submission/completion ring living in memory shared by a process and the kernel.
+//
+// The process writes submissions at submission_tail and advances it, then calls
+// io_ring_enter(). The kernel runs the submissions in order, advancing submission_head
+// and appending a completion for each of them at completion_tail. The process consumes
+// completions by advancing completion_head. All indices are free-running and get
+// masked with entry_count - 1.
+//
+// The header is directly followed by entry_count submissions and then by entry_count
+// completions, see io_ring_size().
+
+// If a submission with this flag fails, the submissions following it are cancelled.
+#define IO_RING_SUBMISSION_LINK (1u << 0)
+
+struct IORingSubmission {
+    u32 function; // A Syscall::Function, its arguments are the same as for the syscall.
+    u32 flags;
+    FlatPtr arguments[3];
+    u64 user_data;
+};
+
+struct IORingCompletion {
+    u64 user_data;
+    i64 result; // What the syscall would have returned, or a negated errno.
+};
+
+struct IORing {
+    static constexpr u32 max_entry_count = 4096;
+
+    u32 entry_count; // Has to be a power of two.
+    u32 submission_head;
+    u32 submission_tail;
+    u32 completion_head;
+    u32 completion_tail;
+    u32 reserved;
+};
+
+constexpr size_t io_ring_size(u32 entry_count)
+{
+    return sizeof(IORing) + entry_count * (sizeof(IORingSubmission) + sizeof(IORingCompletion));
+}
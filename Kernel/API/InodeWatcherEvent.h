@@ -18,4 +18,7 @@ struct [[gnu::packed]] InodeWatcherEvent {
 
     Type type { Type::Invalid };
     unsigned inode_index { 0 };
+    // The watch this event is for. The watch set up by watch_file() is always 1, and
+    // add_inode_watch() hands out the others.
+    int watch_descriptor { 0 };
 };
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// Binary layout of /proc/processes, the same information as /proc/all but without the JSON.
+//
+// The file starts with a ProcessStatisticsHeader, followed by header.process_count process
+// records. Each process record is a ProcessStatisticsRecord (header.process_record_size bytes),
+// then the strings listed below, then record.thread_count thread records. Each thread record is
+// a ThreadStatisticsRecord (header.thread_record_size bytes) followed by its strings.
+// Strings are a u16 length followed by that many bytes, without a null terminator.
+//
+// New fields are only ever appended to the records, so readers should use the record sizes
+// from the header to skip over fields they don't know about, and treat a missing tail as zero.
+
+#define PROCESS_STATISTICS_MAGIC 0x50535441 // "PSTA"
+#define PROCESS_STATISTICS_VERSION 1
+
+struct [[gnu::packed]] ProcessStatisticsHeader {
+    u32 magic;
+    u16 version;
+    u16 process_record_size;
+    u16 thread_record_size;
+    u16 reserved;
+    u32 process_count;
+};
+
+// Followed by: name, executable, tty, pledge, veil.
+struct [[gnu::packed]] ProcessStatisticsRecord {
+    i32 pid;
+    i32 pgid;
+    i32 pgp;
+    i32 sid;
+    u32 uid;
+    u32 gid;
+    i32 ppid;
+    u32 nfds;
+    u8 kernel;
+    u8 dumpable;
+    u16 reserved;
+    u32 thread_count;
+    u64 amount_virtual;
+    u64 amount_resident;
+    u64 amount_shared;
+    u64 amount_dirty_private;
+    u64 amount_clean_inode;
+    u64 amount_purgeable_volatile;
+    u64 amount_purgeable_nonvolatile;
+};
+
+// Followed by: name, state.
+struct [[gnu::packed]] ThreadStatisticsRecord {
+    i32 tid;
+    u32 times_scheduled;
+    u32 ticks_user;
+    u32 ticks_kernel;
+    u32 cpu;
+    u32 priority;
+    u32 syscall_count;
+    u32 inode_faults;
+    u32 zero_faults;
+    u32 cow_faults;
+    u64 unix_socket_read_bytes;
+    u64 unix_socket_write_bytes;
+    u64 ipv4_socket_read_bytes;
+    u64 ipv4_socket_write_bytes;
+    u64 file_read_bytes;
+    u64 file_write_bytes;
+    u64 block_read_requests;
+    u64 block_read_bytes;
+    u64 block_write_requests;
+    u64 block_write_bytes;
+};
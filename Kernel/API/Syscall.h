@@ -17,9 +17,11 @@ constexpr int syscall_vector = 0x82;
 
 extern "C" {
 struct pollfd;
+struct epoll_event;
 struct timeval;
 struct timespec;
 struct sockaddr;
+struct IORing;
 struct siginfo;
 struct stat;
 typedef u32 socklen_t;
@@ -173,7 +175,19 @@ namespace Kernel {
     S(anon_create)            \
     S(msyscall)               \
     S(readv)                  \
-    S(emuctl)
+    S(emuctl)                 \
+    S(epoll_create)           \
+    S(epoll_ctl)              \
+    S(epoll_wait)             \
+    S(sendfile)               \
+    S(splice)                 \
+    S(io_ring_enter)          \
+    S(watch_memory_pressure)  \
+    S(map_time_page)          \
+    S(add_inode_watch)        \
+    S(remove_inode_watch)     \
+    S(ktrace_enable)          \
+    S(ktrace_disable)
 
 namespace Syscall {
 
@@ -258,6 +272,36 @@ struct SC_poll_params {
     const u32* sigmask;
 };
 
+struct SC_epoll_ctl_params {
+    int epfd;
+    int op;
+    int fd;
+    struct epoll_event* event;
+};
+
+struct SC_epoll_wait_params {
+    int epfd;
+    struct epoll_event* events;
+    int maxevents;
+    const struct timespec* timeout;
+};
+
+struct SC_sendfile_params {
+    int out_fd;
+    int in_fd;
+    i64* offset;
+    size_t count;
+};
+
+struct SC_splice_params {
+    int fd_in;
+    i64* off_in;
+    int fd_out;
+    i64* off_out;
+    size_t length;
+    unsigned flags;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -411,6 +455,7 @@ struct SC_waitid_params {
 };
 
 struct SC_stat_params {
+    int dirfd;
     StringArgument path;
     struct stat* statbuf;
     int follow_symlinks;
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+// A page the kernel keeps up to date with the current time, which processes can map read-only
+// with map_time_page() to read the clocks without making a syscall.
+//
+// The kernel increments update1 before changing anything, and sets update2 to the same value
+// once it's done. A reader has to retry until update2 after reading matches update1 before.
+//
+// The coarse clocks are as of the last timer tick. If tsc_multiplier is non-zero, the precise
+// clocks are the coarse ones plus the time since the tick, which is
+// ((rdtsc() - tsc_at_update) * tsc_multiplier) >> tsc_shift nanoseconds.
+
+// Only clock ids below this are published.
+#define TIME_PAGE_CLOCK_COUNT 8
+
+struct TimePageClock {
+    i64 seconds;
+    u32 nanoseconds;
+    u32 reserved;
+};
+
+struct TimePage {
+    u32 update1;
+    u32 tsc_multiplier;
+    u32 tsc_shift;
+    u32 reserved;
+    u64 tsc_at_update;
+    TimePageClock clocks[TIME_PAGE_CLOCK_COUNT];
+    u32 update2;
+};
+
+inline u64 time_page_tsc_delta_to_nanoseconds(u64 delta, u32 multiplier, u32 shift)
+{
+    // Split the multiplication up so it can't overflow, even if the timer tick stopped for a while.
+    u64 high = ((delta >> 32) * multiplier) << (32 - shift);
+    u64 low = ((delta & 0xffffffff) * multiplier) >> shift;
+    return high + low;
+}
@@ -14,6 +14,7 @@
 #include <Kernel/Arch/x86/ProcessorInfo.h>
 #include <Kernel/Arch/x86/SafeMem.h>
 #include <Kernel/Assertions.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/IO.h>
 #include <Kernel/Interrupts/APIC.h>
@@ -22,6 +23,7 @@
 #include <Kernel/Interrupts/SpuriousInterruptHandler.h>
 #include <Kernel/Interrupts/UnhandledInterruptHandler.h>
 #include <Kernel/KSyms.h>
+#include <Kernel/KTrace.h>
 #include <Kernel/Panic.h>
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
@@ -31,6 +33,10 @@
 #include <Kernel/VM/ProcessPagingScope.h>
 #include <LibC/mallocdefs.h>
 
+#define MSR_IA32_ENERGY_PERF_BIAS 0x1b0
+#define MSR_IA32_PM_ENABLE 0x770
+#define MSR_IA32_HWP_REQUEST 0x774
+
 extern FlatPtr start_of_unmap_after_init;
 extern FlatPtr end_of_unmap_after_init;
 extern FlatPtr start_of_ro_after_init;
@@ -265,6 +271,9 @@ void page_fault_handler(TrapFrame* trap)
         PANIC("Attempt to access UNMAP_AFTER_INIT section");
     }
 
+    if (KTrace::is_tracing(KTRACE_PAGE_FAULTS) && current_thread)
+        KTrace::page_fault(*current_thread, fault_address, regs.eip, regs.exception_code);
+
     PageFault fault { regs.exception_code, VirtualAddress { fault_address } };
     auto response = MM.handle_page_fault(fault);
 
@@ -976,6 +985,8 @@ UNMAP_AFTER_INIT void Processor::cpu_detect()
         set_feature(CPUFeature::SSE2);
     if (processor_info.ecx() & (1 << 0))
         set_feature(CPUFeature::SSE3);
+    if (processor_info.ecx() & (1 << 3))
+        set_feature(CPUFeature::MONITOR);
     if (processor_info.ecx() & (1 << 9))
         set_feature(CPUFeature::SSSE3);
     if (processor_info.ecx() & (1 << 19))
@@ -1037,6 +1048,10 @@ UNMAP_AFTER_INIT void Processor::cpu_detect()
         set_feature(CPUFeature::UMIP);
     if (extended_features.ebx() & (1 << 18))
         set_feature(CPUFeature::RDSEED);
+    if (extended_features.ebx() & (1 << 9))
+        set_feature(CPUFeature::ERMS);
+    if (extended_features.edx() & (1 << 4))
+        set_feature(CPUFeature::FSRM);
 }
 
 UNMAP_AFTER_INIT void Processor::cpu_setup()
@@ -1049,6 +1064,12 @@ UNMAP_AFTER_INIT void Processor::cpu_setup()
     if (has_feature(CPUFeature::SSE))
         sse_init();
 
+    if (m_cpu == 0 && has_feature(CPUFeature::ERMS)) {
+        // Without FSRM, rep movsb still takes a while to get going.
+        g_rep_movsb_threshold = has_feature(CPUFeature::FSRM) ? 0 : 128;
+        g_rep_stosb_threshold = 128;
+    }
+
     write_cr0(read_cr0() | 0x00010000);
 
     if (has_feature(CPUFeature::PGE)) {
@@ -1150,6 +1171,12 @@ String Processor::features_string() const
             return "xsave";
         case CPUFeature::AVX:
             return "avx";
+        case CPUFeature::MONITOR:
+            return "monitor";
+        case CPUFeature::ERMS:
+            return "erms";
+        case CPUFeature::FSRM:
+            return "fsrm";
             // no default statement here intentionally so that we get
             // a warning if a new feature is forgotten to be added here
         }
@@ -1437,8 +1464,11 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     tls_descriptor.set_base(to_thread->thread_specific_data());
     tls_descriptor.set_limit(to_thread->thread_specific_region_size());
 
-    if (from_tss.cr3 != to_tss.cr3)
+    if (from_tss.cr3 != to_tss.cr3) {
+        if (auto* page_directory = to_thread->active_page_directory())
+            page_directory->set_active_on_processor(processor.get_id());
         write_cr3(to_tss.cr3);
+    }
 
     to_thread->set_cpu(processor.get_id());
     processor.restore_in_critical(to_thread->saved_critical());
@@ -1747,6 +1777,8 @@ UNMAP_AFTER_INIT void Processor::initialize_context_switching(Thread& initial_th
 
     auto& tss = initial_thread.tss();
     m_tss = tss;
+    if (auto* page_directory = initial_thread.active_page_directory())
+        page_directory->set_active_on_processor(get_id());
     m_tss.esp0 = tss.esp0;
     m_tss.ss0 = GDT_SELECTOR_DATA0;
     // user mode needs to be able to switch to kernel mode:
@@ -1847,6 +1879,11 @@ void Processor::check_invoke_scheduler()
 
 void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 {
+    if (page_count > tlb_full_flush_threshold) {
+        // NOTE: We don't use global pages, so this drops every translation.
+        write_cr3(read_cr3());
+        return;
+    }
     auto ptr = vaddr.as_ptr();
     while (page_count > 0) {
         // clang-format off
@@ -1862,7 +1899,7 @@ void Processor::flush_tlb_local(VirtualAddress vaddr, size_t page_count)
 
 void Processor::flush_tlb(const PageDirectory* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!is_user_address(vaddr) || Process::current()->thread_count() > 1))
+    if (s_smp_enabled)
         smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
     else
         flush_tlb_local(vaddr, page_count);
@@ -1908,6 +1945,108 @@ ProcessorMessage& Processor::smp_get_from_pool()
 
 Atomic<u32> Processor::s_idle_cpu_mask { 0 };
 
+static bool s_idle_with_mwait;
+// The C-state idle() asks mwait for, as EAX bits 7:4 (C-state - 1) and 3:0 (sub-state).
+static Atomic<u32> s_mwait_hint { 0 };
+static u32 s_deepest_mwait_hint;
+static bool s_has_energy_perf_bias;
+static bool s_has_hwp_epp;
+
+UNMAP_AFTER_INIT void Processor::initialize_idle()
+{
+    auto& processor = Processor::current();
+    u32 max_leaf = CPUID(0).eax();
+
+    if (max_leaf >= 6) {
+        CPUID power_management(6);
+        // IA32_HWP_REQUEST only exists once the firmware has enabled HWP, which can't be undone.
+        if ((power_management.eax() & (1 << 7)) && (power_management.eax() & (1 << 10))) {
+            u32 low, high;
+            MSR(MSR_IA32_PM_ENABLE).get(low, high);
+            s_has_hwp_epp = low & 1;
+        }
+        s_has_energy_perf_bias = power_management.ecx() & (1 << 3);
+    }
+
+    if (kernel_command_line().idle_mode() != IdleMode::MWait || !processor.has_feature(CPUFeature::MONITOR) || max_leaf < 5) {
+        dmesgln("CPU[{}]: Idling with hlt", processor.get_id());
+        return;
+    }
+
+    // Deeper C-states can stop the local APIC timer, unless it is always running.
+    bool has_always_running_apic_timer = max_leaf >= 6 && (CPUID(6).eax() & (1 << 2));
+    CPUID monitor_info(5);
+    if (has_always_running_apic_timer && (monitor_info.ecx() & 1)) {
+        for (u32 c_state = 7; c_state > 0; c_state--) {
+            u32 sub_states = (monitor_info.edx() >> (c_state * 4)) & 0xf;
+            if (sub_states == 0)
+                continue;
+            s_deepest_mwait_hint = ((c_state - 1) << 4) | (sub_states - 1);
+            break;
+        }
+    }
+    s_idle_with_mwait = true;
+    dmesgln("CPU[{}]: Idling with mwait, deepest hint {:#02x}", processor.get_id(), s_deepest_mwait_hint);
+}
+
+void Processor::idle()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    if (!s_idle_with_mwait) {
+        // sti only takes effect after the following instruction,
+        // so an interrupt can't sneak in before we halt.
+        asm volatile("sti\n"
+                     "hlt");
+        return;
+    }
+
+    // smp_wake_n_idle_processors() clears our idle bit before writing to m_idle_wakeup.
+    // If the bit is still set now that the monitor is armed, that write will end the mwait.
+    asm volatile("monitor" ::"a"(&m_idle_wakeup), "c"(0), "d"(0));
+    if (!(s_idle_cpu_mask.load(AK::MemoryOrder::memory_order_acquire) & (1u << m_cpu))) {
+        sti();
+        return;
+    }
+    asm volatile("sti\n"
+                 "mwait" ::"a"(s_mwait_hint.load(AK::MemoryOrder::memory_order_relaxed)),
+                 "c"(0));
+}
+
+void Processor::apply_performance_policy(PerformancePolicy policy)
+{
+    if (s_has_energy_perf_bias) {
+        // 0 is maximum performance, 15 is maximum energy saving.
+        u32 bias = policy == PerformancePolicy::Performance ? 0 : (policy == PerformancePolicy::Balanced ? 6 : 15);
+        u32 low, high;
+        MSR msr(MSR_IA32_ENERGY_PERF_BIAS);
+        msr.get(low, high);
+        msr.set((low & ~0xfu) | bias, high);
+    }
+    if (s_has_hwp_epp) {
+        // Bits 31:24 are the energy/performance preference, from 0 (performance) to 255 (energy saving).
+        u32 preference = policy == PerformancePolicy::Performance ? 0 : (policy == PerformancePolicy::Balanced ? 0x80 : 0xff);
+        u32 low, high;
+        MSR msr(MSR_IA32_HWP_REQUEST);
+        msr.get(low, high);
+        msr.set((low & 0x00ffffff) | (preference << 24), high);
+    }
+}
+
+void Processor::set_performance_policy(PerformancePolicy policy)
+{
+    s_mwait_hint.store(policy == PerformancePolicy::PowerSave ? s_deepest_mwait_hint : 0, AK::MemoryOrder::memory_order_relaxed);
+    if (!s_has_energy_perf_bias && !s_has_hwp_epp)
+        return;
+    ScopedCritical critical;
+    Processor::current().apply_performance_policy(policy);
+    if (count() > 1) {
+        smp_broadcast([policy] {
+            Processor::current().apply_performance_policy(policy);
+        },
+            false);
+    }
+}
+
 u32 Processor::smp_wake_n_idle_processors(u32 wake_count)
 {
     VERIFY(Processor::current().in_critical());
@@ -1947,10 +2086,14 @@ u32 Processor::smp_wake_n_idle_processors(u32 wake_count)
             u32 cpu = __builtin_ffsl(idle_mask) - 1;
             idle_mask &= ~(1u << cpu);
 
-            // Send an IPI to that CPU to wake it up. There is a possibility
+            // Send an IPI to that CPU to wake it up, or just poke the address
+            // it is monitoring if it's in mwait. There is a possibility
             // someone else woke it up as well, or that it woke up due to
             // a timer interrupt. But we tried hard to avoid this...
-            apic.send_ipi(cpu);
+            if (s_idle_with_mwait)
+                processors()[cpu]->m_idle_wakeup.fetch_add(1, AK::MemoryOrder::memory_order_release);
+            else
+                apic.send_ipi(cpu);
             did_wake_count++;
         }
     }
@@ -2033,8 +2176,10 @@ bool Processor::smp_process_pending_messages()
                     // We assume that we don't cross into kernel land!
                     VERIFY(is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
                     if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
-                        // This processor isn't using this page directory right now, we can ignore this request
+                        // This processor isn't using this page directory right now, we can ignore this request.
+                        // Switching back to it will flush the TLB anyway, so stop getting bothered about it.
                         dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
+                        msg->flush_tlb.page_directory->clear_active_on_processor(id());
                         break;
                     }
                 }
@@ -2103,6 +2248,30 @@ void Processor::smp_broadcast_message(ProcessorMessage& msg)
         APIC::the().broadcast_ipi();
 }
 
+bool Processor::smp_multicast_message(u32 cpu_mask, ProcessorMessage& msg)
+{
+    auto& cur_proc = Processor::current();
+    cpu_mask &= ~(1u << cur_proc.get_id());
+    if (count() < 32)
+        cpu_mask &= (1u << count()) - 1;
+    if (cpu_mask == 0)
+        return false;
+
+    dbgln_if(SMP_DEBUG, "SMP[{}]: Multicast message {} to cpus: {:08x} proc: {}", cur_proc.get_id(), VirtualAddress(&msg), cpu_mask, VirtualAddress(&cur_proc));
+
+    atomic_store(&msg.refs, (u32)__builtin_popcount(cpu_mask), AK::MemoryOrder::memory_order_release);
+    for_each(
+        [&](Processor& proc) -> IterationDecision {
+            auto cpu = proc.get_id();
+            if (cpu < 32 && (cpu_mask & (1u << cpu))) {
+                if (proc.smp_queue_message(msg))
+                    APIC::the().send_ipi(cpu);
+            }
+            return IterationDecision::Continue;
+        });
+    return true;
+}
+
 void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
 {
     auto& cur_proc = Processor::current();
@@ -2203,7 +2372,22 @@ void Processor::smp_broadcast_flush_tlb(const PageDirectory* page_directory, Vir
     msg.flush_tlb.page_directory = page_directory;
     msg.flush_tlb.ptr = vaddr.as_ptr();
     msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
+
+    if (!is_user_address(vaddr) || count() > 32) {
+        // Kernel mappings are shared by every page directory.
+        smp_broadcast_message(msg);
+    } else {
+        // Only bother processors that may have the page directory loaded. Make sure
+        // our page table updates are visible before we look at who those are, so that
+        // anybody switching to it after this point is guaranteed to see them.
+        full_memory_barrier();
+        if (!smp_multicast_message(page_directory->active_processors(), msg)) {
+            flush_tlb_local(vaddr, page_count);
+            smp_cleanup_message(msg);
+            smp_return_to_pool(msg);
+            return;
+        }
+    }
     // While the other processors handle this request, we'll flush ours
     flush_tlb_local(vaddr, page_count);
     // Now wait until everybody is done as well
@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Optional.h>
+#include <Kernel/Arch/x86/CPU.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
+#include <Kernel/Interrupts/APIC.h>
+#include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+#define IA32_PMC0 0xc1
+#define IA32_PERFEVTSEL0 0x186
+#define IA32_PERF_GLOBAL_CTRL 0x38f
+#define IA32_PERF_GLOBAL_OVF_CTRL 0x390
+
+#define PERFEVTSEL_USR (1 << 16)
+#define PERFEVTSEL_OS (1 << 17)
+#define PERFEVTSEL_INT (1 << 20)
+#define PERFEVTSEL_EN (1 << 22)
+
+static Atomic<int> s_active_counter { PERF_COUNTER_TIMER };
+static Atomic<u32> s_sample_period { 0 };
+
+struct ArchitecturalEvent {
+    u8 event_select;
+    u8 unit_mask;
+    // Bit in CPUID.0AH:EBX that is *set* if the event is not available.
+    u8 unavailable_bit;
+};
+
+static Optional<ArchitecturalEvent> architectural_event_for(int counter)
+{
+    switch (counter) {
+    case PERF_COUNTER_CYCLES:
+        return ArchitecturalEvent { 0x3c, 0x00, 0 };
+    case PERF_COUNTER_INSTRUCTIONS:
+        return ArchitecturalEvent { 0xc0, 0x00, 1 };
+    case PERF_COUNTER_CACHE_MISSES:
+        return ArchitecturalEvent { 0x2e, 0x41, 4 };
+    case PERF_COUNTER_BRANCH_MISSES:
+        return ArchitecturalEvent { 0xc5, 0x00, 6 };
+    default:
+        return {};
+    }
+}
+
+static u8 detect_version()
+{
+    if (!MSR::have())
+        return 0;
+    CPUID max_leaf(0);
+    if (max_leaf.eax() < 0xa)
+        return 0;
+    CPUID leaf(0xa);
+    u8 general_purpose_counters = (leaf.eax() >> 8) & 0xff;
+    if (general_purpose_counters == 0)
+        return 0;
+    return leaf.eax() & 0xff;
+}
+
+static u8 version()
+{
+    // Doing CPUID is slow (especially in a VM), and we need this in the interrupt handler.
+    static Atomic<int> s_version { -1 };
+    auto version = s_version.load(AK::MemoryOrder::memory_order_relaxed);
+    if (version < 0) {
+        version = detect_version();
+        s_version.store(version, AK::MemoryOrder::memory_order_relaxed);
+    }
+    return version;
+}
+
+bool PerformanceCounters::is_supported()
+{
+    return version() > 0;
+}
+
+bool PerformanceCounters::is_available(int counter)
+{
+    auto event = architectural_event_for(counter);
+    if (!event.has_value() || !is_supported())
+        return false;
+    CPUID leaf(0xa);
+    u8 event_vector_length = (leaf.eax() >> 24) & 0xff;
+    if (event.value().unavailable_bit >= event_vector_length)
+        return false;
+    return !(leaf.ebx() & (1 << event.value().unavailable_bit));
+}
+
+u32 PerformanceCounters::default_sample_period(int counter)
+{
+    switch (counter) {
+    case PERF_COUNTER_CYCLES:
+    case PERF_COUNTER_INSTRUCTIONS:
+        return 1'000'000;
+    default:
+        return 10'000;
+    }
+}
+
+int PerformanceCounters::active_counter()
+{
+    return s_active_counter.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+u32 PerformanceCounters::sample_period()
+{
+    return s_sample_period.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+static void reload_counter()
+{
+    // Without full-width writes, bits 31:0 are written and sign-extended,
+    // so this counts up from -period and overflows after period events.
+    MSR pmc0(IA32_PMC0);
+    pmc0.set(-s_sample_period.load(AK::MemoryOrder::memory_order_relaxed), 0);
+}
+
+static void program_current_processor()
+{
+    MSR event_select(IA32_PERFEVTSEL0);
+    event_select.set(0, 0);
+
+    auto counter = s_active_counter.load();
+    auto event = architectural_event_for(counter);
+    if (!event.has_value()) {
+        APIC::the().setup_performance_counter_interrupt(false);
+        return;
+    }
+
+    reload_counter();
+    APIC::the().setup_performance_counter_interrupt(true);
+    if (version() >= 2) {
+        MSR(IA32_PERF_GLOBAL_OVF_CTRL).set(1, 0);
+        // The firmware might have left the counters globally disabled.
+        MSR(IA32_PERF_GLOBAL_CTRL).set(1, 0);
+    }
+    event_select.set(event.value().event_select | (event.value().unit_mask << 8) | PERFEVTSEL_USR | PERFEVTSEL_OS | PERFEVTSEL_INT | PERFEVTSEL_EN, 0);
+}
+
+static void program_all_processors()
+{
+    if (Processor::count() > 1)
+        Processor::smp_broadcast(program_current_processor, false);
+    InterruptDisabler disabler;
+    program_current_processor();
+}
+
+void PerformanceCounters::start(int counter, u32 sample_period)
+{
+    VERIFY(is_available(counter));
+    VERIFY(sample_period > 0 && sample_period <= 0x7fffffff);
+    s_sample_period = sample_period;
+    s_active_counter = counter;
+    program_all_processors();
+}
+
+void PerformanceCounters::stop()
+{
+    if (s_active_counter.exchange(PERF_COUNTER_TIMER) == PERF_COUNTER_TIMER)
+        return;
+    program_all_processors();
+}
+
+void PerformanceCounters::handle_overflow(const RegisterState& regs)
+{
+    auto counter = s_active_counter.load(AK::MemoryOrder::memory_order_relaxed);
+    if (counter == PERF_COUNTER_TIMER)
+        return;
+
+    PerformanceEventBuffer::take_sample(regs, counter, s_sample_period.load(AK::MemoryOrder::memory_order_relaxed));
+
+    reload_counter();
+    if (version() >= 2)
+        MSR(IA32_PERF_GLOBAL_OVF_CTRL).set(1, 0);
+    // The local APIC masks the performance counter interrupt whenever it delivers it.
+    APIC::the().setup_performance_counter_interrupt(true);
+}
+
+UNMAP_AFTER_INIT void PerformanceCounterInterruptHandler::initialize(u8 interrupt_number)
+{
+    auto* handler = new PerformanceCounterInterruptHandler(interrupt_number);
+    handler->register_interrupt_handler();
+}
+
+UNMAP_AFTER_INIT PerformanceCounterInterruptHandler::PerformanceCounterInterruptHandler(u8 interrupt_number)
+    : GenericInterruptHandler(interrupt_number, true)
+{
+}
+
+void PerformanceCounterInterruptHandler::handle_interrupt(const RegisterState& regs)
+{
+    PerformanceCounters::handle_overflow(regs);
+}
+
+bool PerformanceCounterInterruptHandler::eoi()
+{
+    APIC::the().eoi();
+    return true;
+}
+
+}
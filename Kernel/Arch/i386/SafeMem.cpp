@@ -16,6 +16,8 @@ extern "C" u8* safe_memcpy_ins_1;
 extern "C" u8* safe_memcpy_1_faulted;
 extern "C" u8* safe_memcpy_ins_2;
 extern "C" u8* safe_memcpy_2_faulted;
+extern "C" u8* safe_memcpy_ins_3;
+extern "C" u8* safe_memcpy_3_faulted;
 extern "C" u8* safe_strnlen_ins;
 extern "C" u8* safe_strnlen_faulted;
 extern "C" u8* safe_memset_ins_1;
@@ -46,8 +48,26 @@ bool safe_memcpy(void* dest_ptr, const void* src_ptr, size_t n, void*& fault_at)
     size_t dest = (size_t)dest_ptr;
     size_t src = (size_t)src_ptr;
     size_t remainder;
-    // FIXME: Support starting at an unaligned address.
-    if (!(dest & 0x3) && !(src & 0x3) && n >= 12) {
+    // With fast string operations, a single rep movsb beats splitting the copy up, like in memcpy().
+    if (n < g_rep_movsb_threshold && !((dest ^ src) & 0x3) && n >= 12) {
+        if (size_t head = (sizeof(size_t) - (dest & 0x3)) & 0x3; head != 0) {
+            // Copy a few bytes so that both addresses become aligned, rather than falling back to copying bytewise.
+            asm volatile(
+                "safe_memcpy_ins_3: \n"
+                "rep movsb \n"
+                "safe_memcpy_3_faulted: \n" // handle_safe_access_fault() set edx to the fault address!
+                : "=S"(src),
+                "=D"(dest),
+                "=c"(remainder),
+                [fault_at] "=d"(fault_at)
+                : "S"(src),
+                "D"(dest),
+                "c"(head)
+                : "memory");
+            if (remainder != 0)
+                return false; // fault_at is already set!
+            n -= head;
+        }
         size_t size_ts = n / sizeof(size_t);
         asm volatile(
             "safe_memcpy_ins_1: \n"
@@ -260,6 +280,8 @@ bool handle_safe_access_fault(RegisterState& regs, u32 fault_address)
             regs.eip = (FlatPtr)&safe_memcpy_1_faulted;
         else if (regs.eip == (FlatPtr)&safe_memcpy_ins_2)
             regs.eip = (FlatPtr)&safe_memcpy_2_faulted;
+        else if (regs.eip == (FlatPtr)&safe_memcpy_ins_3)
+            regs.eip = (FlatPtr)&safe_memcpy_3_faulted;
         else if (regs.eip == (FlatPtr)&safe_strnlen_ins)
             regs.eip = (FlatPtr)&safe_strnlen_faulted;
         else if (regs.eip == (FlatPtr)&safe_memset_ins_1)
@@ -119,6 +119,7 @@ public:
         UserSupervisor = 1 << 2,
         WriteThrough = 1 << 3,
         CacheDisabled = 1 << 4,
+        Accessed = 1 << 5,
         Global = 1 << 8,
         NoExecute = 0x8000000000000000ULL,
     };
@@ -138,6 +139,10 @@ public:
     bool is_cache_disabled() const { return raw() & CacheDisabled; }
     void set_cache_disabled(bool b) { set_bit(CacheDisabled, b); }
 
+    // Set by the CPU whenever the page is read from or written to.
+    bool is_accessed() const { return raw() & Accessed; }
+    void set_accessed(bool b) { set_bit(Accessed, b); }
+
     bool is_global() const { return raw() & Global; }
     void set_global(bool b) { set_bit(Global, b); }
 
@@ -546,6 +551,21 @@ enum class CPUFeature : u32 {
     SSE4_2 = (1 << 20),
     XSAVE = (1 << 21),
     AVX = (1 << 22),
+    MONITOR = (1 << 23),
+    ERMS = (1 << 24),
+    FSRM = (1 << 25),
+};
+
+// memcpy() and memset() use rep movsb / rep stosb for anything at least this long, since
+// they're the fastest way to copy or fill on processors with ERMS (and FSRM for short copies).
+// Set up from the boot processor's features in Processor::cpu_setup().
+extern size_t g_rep_movsb_threshold;
+extern size_t g_rep_stosb_threshold;
+
+enum class PerformancePolicy {
+    Performance,
+    Balanced,
+    PowerSave,
 };
 
 class Thread;
@@ -657,6 +677,9 @@ class Processor {
     bool m_scheduler_initialized;
     Atomic<bool> m_halt_requested;
 
+    // Other processors write to this to wake us up from mwait, see idle().
+    Atomic<u32> m_idle_wakeup;
+
     DeferredCallEntry* m_pending_deferred_calls; // in reverse order
     DeferredCallEntry* m_free_deferred_call_pool_entry;
     DeferredCallEntry m_deferred_call_pool[5];
@@ -672,6 +695,7 @@ class Processor {
     bool smp_queue_message(ProcessorMessage& msg);
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
+    static bool smp_multicast_message(u32 cpu_mask, ProcessorMessage& msg);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
 
@@ -684,6 +708,8 @@ class Processor {
     void cpu_detect();
     void cpu_setup();
 
+    void apply_performance_policy(PerformancePolicy);
+
     String features_string() const;
 
 public:
@@ -702,6 +728,19 @@ public:
         s_idle_cpu_mask.fetch_and(~(1u << m_cpu), AK::MemoryOrder::memory_order_relaxed);
     }
 
+    // Chooses between hlt and mwait for idle(), depending on the "idle" boot argument and what
+    // the processor supports. Must be called after the command line has been parsed.
+    static void initialize_idle();
+
+    // Waits until an interrupt arrives, or until another processor wants us to look for work.
+    // Must be called between idle_begin() and idle_end() with interrupts disabled, and returns
+    // with them enabled.
+    void idle();
+
+    // Trades performance for power use, both in the C-state idle() asks for, and the hints
+    // given to the processors' frequency scaling (if they support any).
+    static void set_performance_policy(PerformancePolicy);
+
     static u32 count()
     {
         // NOTE: because this value never changes once all APs are booted,
@@ -722,6 +761,9 @@ public:
         write_cr3(read_cr3());
     }
 
+    // Invalidating more pages than this at once is done by reloading CR3 instead.
+    static constexpr size_t tlb_full_flush_threshold = 32;
+
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(const PageDirectory*, VirtualAddress, size_t);
 
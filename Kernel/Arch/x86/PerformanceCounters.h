@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <Kernel/Interrupts/GenericInterruptHandler.h>
+
+namespace Kernel {
+
+// Drives the first general purpose counter of Intel's architectural performance
+// monitoring unit. While profiling with one of the PERF_COUNTER_* events (other than
+// PERF_COUNTER_TIMER), every processor counts that event, and the counter overflowing
+// after sample_period occurrences raises an interrupt that takes a profiling sample.
+class PerformanceCounters {
+public:
+    static bool is_supported();
+    static bool is_available(int counter);
+    static u32 default_sample_period(int counter);
+
+    // Returns PERF_COUNTER_TIMER while no hardware counter is in use.
+    static int active_counter();
+    static u32 sample_period();
+
+    static void start(int counter, u32 sample_period);
+    static void stop();
+
+    static void handle_overflow(const RegisterState&);
+};
+
+class PerformanceCounterInterruptHandler final : public GenericInterruptHandler {
+public:
+    static void initialize(u8 interrupt_number);
+
+    virtual void handle_interrupt(const RegisterState&) override;
+    virtual bool eoi() override;
+
+    virtual HandlerType type() const override { return HandlerType::IRQHandler; }
+    virtual const char* purpose() const override { return "Performance Counter Handler"; }
+    virtual const char* controller() const override { return nullptr; }
+
+    virtual size_t sharing_devices_count() const override { return 0; }
+    virtual bool is_shared_handler() const override { return false; }
+    virtual bool is_sharing_with_others() const override { return false; }
+
+private:
+    explicit PerformanceCounterInterruptHandler(u8 interrupt_number);
+};
+
+}
@@ -105,6 +105,21 @@ UNMAP_AFTER_INIT bool CommandLine::is_legacy_time_enabled() const
     return lookup("time").value_or("modern") == "legacy";
 }
 
+UNMAP_AFTER_INIT bool CommandLine::is_tickless_enabled() const
+{
+    return lookup("tickless").value_or("on") == "on";
+}
+
+UNMAP_AFTER_INIT bool CommandLine::is_page_compression_enabled() const
+{
+    return lookup("page_compression").value_or("on") == "on";
+}
+
+UNMAP_AFTER_INIT bool CommandLine::is_msi_enabled() const
+{
+    return lookup("msi").value_or("on") == "on";
+}
+
 UNMAP_AFTER_INIT bool CommandLine::is_force_pio() const
 {
     return contains("force_pio");
@@ -135,6 +150,16 @@ UNMAP_AFTER_INIT HPETMode CommandLine::hpet_mode() const
     PANIC("Unknown HPETMode: {}", hpet_mode);
 }
 
+UNMAP_AFTER_INIT IdleMode CommandLine::idle_mode() const
+{
+    auto idle_mode = lookup("idle").value_or("mwait");
+    if (idle_mode == "mwait")
+        return IdleMode::MWait;
+    if (idle_mode == "halt")
+        return IdleMode::Halt;
+    PANIC("Unknown IdleMode: {}", idle_mode);
+}
+
 UNMAP_AFTER_INIT bool CommandLine::disable_ps2_controller() const
 {
     return contains("disable_ps2_controller");
@@ -168,6 +193,52 @@ UNMAP_AFTER_INIT AHCIResetMode CommandLine::ahci_reset_mode() const
     PANIC("Unknown AHCIResetMode: {}", ahci_reset_mode);
 }
 
+Optional<size_t> CommandLine::disk_cache_size() const
+{
+    // NOTE: The cache size is given in KiB.
+    auto value = lookup("disk_cache_size");
+    if (!value.has_value())
+        return {};
+    auto kib = value->to_uint();
+    if (!kib.has_value())
+        PANIC("Invalid disk_cache_size: {}", *value);
+    return (size_t)kib.value() * KiB;
+}
+
+UNMAP_AFTER_INIT Optional<size_t> CommandLine::e1000_rx_ring_size() const
+{
+    auto value = lookup("e1000_rx_ring_size");
+    if (!value.has_value())
+        return {};
+    auto size = value->to_uint();
+    if (!size.has_value())
+        PANIC("Invalid e1000_rx_ring_size: {}", *value);
+    return size.value();
+}
+
+UNMAP_AFTER_INIT Optional<size_t> CommandLine::e1000_tx_ring_size() const
+{
+    auto value = lookup("e1000_tx_ring_size");
+    if (!value.has_value())
+        return {};
+    auto size = value->to_uint();
+    if (!size.has_value())
+        PANIC("Invalid e1000_tx_ring_size: {}", *value);
+    return size.value();
+}
+
+UNMAP_AFTER_INIT Optional<u32> CommandLine::e1000_interrupt_rate() const
+{
+    // NOTE: The rate is given in interrupts per second, 0 turns off throttling.
+    auto value = lookup("e1000_interrupt_rate");
+    if (!value.has_value())
+        return {};
+    auto rate = value->to_uint();
+    if (!rate.has_value())
+        PANIC("Invalid e1000_interrupt_rate: {}", *value);
+    return rate.value();
+}
+
 UNMAP_AFTER_INIT BootMode CommandLine::boot_mode() const
 {
     const auto boot_mode = lookup("boot_mode").value_or("graphical");
@@ -24,6 +24,11 @@ enum class HPETMode {
     NonPeriodic
 };
 
+enum class IdleMode {
+    Halt,
+    MWait,
+};
+
 enum class AcpiFeatureLevel {
     Enabled,
     Limited,
@@ -59,16 +64,24 @@ public:
     [[nodiscard]] bool is_vmmouse_enabled() const;
     [[nodiscard]] PCIAccessLevel pci_access_level() const;
     [[nodiscard]] bool is_legacy_time_enabled() const;
+    [[nodiscard]] bool is_tickless_enabled() const;
+    [[nodiscard]] bool is_page_compression_enabled() const;
+    [[nodiscard]] bool is_msi_enabled() const;
     [[nodiscard]] bool is_text_mode() const;
     [[nodiscard]] bool is_force_pio() const;
     [[nodiscard]] AcpiFeatureLevel acpi_feature_level() const;
     [[nodiscard]] BootMode boot_mode() const;
     [[nodiscard]] HPETMode hpet_mode() const;
+    [[nodiscard]] IdleMode idle_mode() const;
     [[nodiscard]] bool disable_physical_storage() const;
     [[nodiscard]] bool disable_ps2_controller() const;
     [[nodiscard]] bool disable_uhci_controller() const;
     [[nodiscard]] bool disable_virtio() const;
     [[nodiscard]] AHCIResetMode ahci_reset_mode() const;
+    [[nodiscard]] Optional<size_t> disk_cache_size() const;
+    [[nodiscard]] Optional<size_t> e1000_rx_ring_size() const;
+    [[nodiscard]] Optional<size_t> e1000_tx_ring_size() const;
+    [[nodiscard]] Optional<u32> e1000_interrupt_rate() const;
     [[nodiscard]] String userspace_init() const;
     [[nodiscard]] Vector<String> userspace_init_args() const;
     [[nodiscard]] String root_device() const;
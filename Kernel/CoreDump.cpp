@@ -16,6 +16,7 @@
 #include <Kernel/Process.h>
 #include <Kernel/RTC.h>
 #include <Kernel/SpinLock.h>
+#include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/ProcessPagingScope.h>
 #include <LibC/elf.h>
 #include <LibELF/CoreDump.h>
@@ -109,19 +110,62 @@ KResult CoreDump::write_elf_header()
     return KSuccess;
 }
 
+// Pages that were never written to are zero without us having to look at them, and reading them would only
+// make them be allocated.
+static bool is_page_backed(const PhysicalPage* page)
+{
+    return page && !page->is_shared_zero_page() && !page->is_lazy_committed_page();
+}
+
+// Pages we can't read, like those of regions that aren't readable, are assumed not to be zero.
+static bool is_page_zero(const Region& region, size_t page_index)
+{
+    if (!is_page_backed(region.physical_page(page_index)))
+        return true;
+    u32 page_data[PAGE_SIZE / sizeof(u32)];
+    if (!copy_from_user(page_data, region.vaddr().offset(page_index * PAGE_SIZE).as_ptr(), PAGE_SIZE))
+        return false;
+    for (auto word : page_data) {
+        if (word)
+            return false;
+    }
+    return true;
+}
+
+void CoreDump::find_dumped_pages()
+{
+    m_dumped_pages.ensure_capacity(m_process->space().region_count());
+    for (auto& region : m_process->space().regions()) {
+        if (region->is_kernel()) {
+            m_dumped_pages.unchecked_append({});
+            continue;
+        }
+
+        size_t first_page = 0;
+        size_t end_page = region->page_count();
+        while (first_page < end_page && is_page_zero(*region, first_page))
+            ++first_page;
+        while (end_page > first_page && is_page_zero(*region, end_page - 1))
+            --end_page;
+        m_dumped_pages.unchecked_append({ first_page, end_page - first_page });
+    }
+}
+
 KResult CoreDump::write_program_headers(size_t notes_size)
 {
     size_t offset = sizeof(Elf32_Ehdr) + m_num_program_headers * sizeof(Elf32_Phdr);
+    size_t region_index = 0;
     for (auto& region : m_process->space().regions()) {
+        auto& dumped_pages = m_dumped_pages[region_index++];
         Elf32_Phdr phdr {};
 
         phdr.p_type = PT_LOAD;
         phdr.p_offset = offset;
-        phdr.p_vaddr = region->vaddr().get();
+        phdr.p_vaddr = region->vaddr().offset(dumped_pages.first_page * PAGE_SIZE).get();
         phdr.p_paddr = 0;
 
-        phdr.p_filesz = region->page_count() * PAGE_SIZE;
-        phdr.p_memsz = region->page_count() * PAGE_SIZE;
+        phdr.p_filesz = dumped_pages.page_count * PAGE_SIZE;
+        phdr.p_memsz = (region->page_count() - dumped_pages.first_page) * PAGE_SIZE;
         phdr.p_align = 0;
 
         phdr.p_flags = region->is_readable() ? PF_R : 0;
@@ -153,30 +197,44 @@ KResult CoreDump::write_program_headers(size_t notes_size)
 
 KResult CoreDump::write_regions()
 {
+    static const u8 zero_page[PAGE_SIZE] {};
+
+    size_t region_index = 0;
     for (auto& region : m_process->space().regions()) {
-        if (region->is_kernel())
+        auto& dumped_pages = m_dumped_pages[region_index++];
+        if (!dumped_pages.page_count)
             continue;
 
         region->set_readable(true);
         region->remap();
 
-        for (size_t i = 0; i < region->page_count(); i++) {
-            auto* page = region->physical_page(i);
+        auto end_page = dumped_pages.first_page + dumped_pages.page_count;
 
-            uint8_t zero_buffer[PAGE_SIZE] = {};
-            Optional<UserOrKernelBuffer> src_buffer;
-
-            if (page) {
-                src_buffer = UserOrKernelBuffer::for_user_buffer(reinterpret_cast<uint8_t*>((region->vaddr().as_ptr() + (i * PAGE_SIZE))), PAGE_SIZE);
-            } else {
+        // Pages that are backed by memory are written in one go for as long as they come one after another.
+        size_t page_index = dumped_pages.first_page;
+        while (page_index < end_page) {
+            if (!is_page_backed(region->physical_page(page_index))) {
                 // If the current page is not backed by a physical page, we zero it in the coredump file.
                 // TODO: Do we want to include the contents of pages that have not been faulted-in in the coredump?
                 //       (A page may not be backed by a physical page because it has never been faulted in when the process ran).
-                src_buffer = UserOrKernelBuffer::for_kernel_buffer(zero_buffer);
+                auto result = m_fd->write(UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(zero_page)), PAGE_SIZE);
+                if (result.is_error())
+                    return result.error();
+                ++page_index;
+                continue;
             }
-            auto result = m_fd->write(src_buffer.value(), PAGE_SIZE);
+
+            auto run_end = page_index + 1;
+            while (run_end < end_page && is_page_backed(region->physical_page(run_end)))
+                ++run_end;
+            auto run_size = (run_end - page_index) * PAGE_SIZE;
+            auto src_buffer = UserOrKernelBuffer::for_user_buffer(region->vaddr().offset(page_index * PAGE_SIZE).as_ptr(), run_size);
+            if (!src_buffer.has_value())
+                return EFAULT;
+            auto result = m_fd->write(src_buffer.value(), run_size);
             if (result.is_error())
                 return result.error();
+            page_index = run_end;
         }
     }
     return KSuccess;
@@ -294,6 +352,7 @@ KResult CoreDump::write()
     ScopedSpinLock lock(m_process->space().get_lock());
     ProcessPagingScope scope(m_process);
 
+    find_dumped_pages();
     ByteBuffer notes_segment = create_notes_segment_data();
 
     auto result = write_elf_header();
@@ -10,6 +10,7 @@
 #include <AK/LexicalPath.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/OwnPtr.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
 
 namespace Kernel {
@@ -27,6 +28,14 @@ private:
     CoreDump(NonnullRefPtr<Process>, NonnullRefPtr<FileDescription>&&);
     static RefPtr<FileDescription> create_target_file(const Process&, const String& output_path);
 
+    // The pages of a region that make it into the dump. The zero pages before and after them are left out,
+    // as the program header says that the rest of the region is zero-filled.
+    struct DumpedPages {
+        size_t first_page { 0 };
+        size_t page_count { 0 };
+    };
+    void find_dumped_pages();
+
     [[nodiscard]] KResult write_elf_header();
     [[nodiscard]] KResult write_program_headers(size_t notes_size);
     [[nodiscard]] KResult write_regions();
@@ -41,6 +50,8 @@ private:
     NonnullRefPtr<Process> m_process;
     NonnullRefPtr<FileDescription> m_fd;
     const size_t m_num_program_headers;
+    // In the order of the process's regions.
+    Vector<DumpedPages> m_dumped_pages;
 };
 
 }
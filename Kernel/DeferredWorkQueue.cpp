@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <AK/Vector.h>
+#include <Kernel/Debug.h>
+#include <Kernel/DeferredWorkQueue.h>
+#include <Kernel/Process.h>
+#include <Kernel/Scheduler.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/WorkQueue.h>
+
+namespace Kernel {
+
+// Indexed by processor id, and never changed after initialize().
+static AK::Singleton<Vector<DeferredWorkQueue*>> s_queues;
+static Atomic<bool> s_initialized { false };
+
+UNMAP_AFTER_INIT void DeferredWorkQueue::initialize()
+{
+    VERIFY(!s_initialized);
+    auto processor_count = Processor::count();
+    s_queues->ensure_capacity(processor_count);
+    for (u32 cpu = 0; cpu < processor_count; cpu++)
+        s_queues->append(new DeferredWorkQueue(cpu));
+    s_initialized = true;
+}
+
+UNMAP_AFTER_INIT DeferredWorkQueue::DeferredWorkQueue(u32 cpu)
+    : m_cpu(cpu)
+{
+    RefPtr<Thread> thread;
+    Process::create_kernel_process(
+        thread, String::formatted("DeferredWork #{}", cpu), [this] {
+            run();
+        },
+        1u << cpu);
+    // If we can't create the thread we're in trouble...
+    m_thread = thread.release_nonnull();
+    m_thread->set_priority(THREAD_PRIORITY_HIGH);
+}
+
+void DeferredWorkQueue::run_item(WorkItem* item)
+{
+    item->function(item->data);
+    if (item->free_data)
+        item->free_data(item->data);
+    delete item;
+}
+
+void DeferredWorkQueue::do_queue(Priority priority, WorkItem* item)
+{
+    if (!s_initialized) {
+        g_io_work->queue([item] {
+            run_item(item);
+        });
+        return;
+    }
+
+    ScopedCritical critical;
+    auto& processor = Processor::current();
+    auto& queue = *s_queues->at(processor.id());
+    {
+        ScopedSpinLock lock(queue.m_lock);
+        queue.m_items[(size_t)priority].append(*item);
+    }
+    queue.m_wait_queue.wake_one();
+
+    // Let the worker run as soon as this interrupt returns, rather than at the next timer tick.
+    if (processor.in_irq())
+        processor.invoke_scheduler_async();
+}
+
+DeferredWorkQueue::WorkItem* DeferredWorkQueue::take_next()
+{
+    ScopedSpinLock lock(m_lock);
+    for (auto& items : m_items) {
+        if (auto* item = items.take_first())
+            return item;
+    }
+    return nullptr;
+}
+
+void DeferredWorkQueue::run()
+{
+    VERIFY(Processor::id() == m_cpu);
+    for (;;) {
+        size_t items_run = 0;
+        auto budget_end = TimeManagement::the().monotonic_time() + budget_time;
+        while (auto* item = take_next()) {
+            run_item(item);
+            if (++items_run < budget_items && TimeManagement::the().monotonic_time() < budget_end)
+                continue;
+
+            // We've used up our budget, so catch up on the rest alongside everyone else.
+            dbgln_if(DEFERRED_WORK_DEBUG, "DeferredWorkQueue #{}: Out of budget after {} items", m_cpu, items_run);
+            m_thread->set_priority(THREAD_PRIORITY_NORMAL);
+            Scheduler::yield();
+            items_run = 0;
+            budget_end = TimeManagement::the().monotonic_time() + budget_time;
+        }
+        m_thread->set_priority(THREAD_PRIORITY_HIGH);
+        [[maybe_unused]] auto result = m_wait_queue.wait_on({});
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/IntrusiveList.h>
+#include <AK/Time.h>
+#include <Kernel/Forward.h>
+#include <Kernel/SpinLock.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// Work that an interrupt handler wants done as soon as the interrupt returns, such as
+// completing disk requests or processing received packets.
+// Every processor has its own queue and worker thread, and work always runs on the processor
+// that queued it, which keeps the device's data warm in that processor's caches.
+// The worker runs at a high priority and is scheduled right after the interrupt returns, but
+// only for a limited budget: if there is still work left after that, it drops to a normal
+// priority until it catches up, so a flood of interrupts can't starve user threads.
+class DeferredWorkQueue {
+    AK_MAKE_NONCOPYABLE(DeferredWorkQueue);
+    AK_MAKE_NONMOVABLE(DeferredWorkQueue);
+
+public:
+    enum class Priority : u8 {
+        High,
+        Normal,
+        Low,
+    };
+    static constexpr size_t priority_count = 3;
+
+    // Must be called after all processors are up. Until then, work is handed to g_io_work.
+    static void initialize();
+
+    template<typename Function>
+    static void queue(Priority priority, Function function)
+    {
+        auto* item = new WorkItem; // TODO: use a pool
+        item->function = [](void* f) {
+            (*reinterpret_cast<Function*>(f))();
+        };
+        if constexpr (sizeof(Function) <= sizeof(item->inline_data)) {
+            item->data = new (item->inline_data) Function(move(function));
+            item->free_data = [](void* f) {
+                reinterpret_cast<Function*>(f)->~Function();
+            };
+        } else {
+            item->data = new Function(move(function));
+            item->free_data = [](void* f) {
+                delete reinterpret_cast<Function*>(f);
+            };
+        }
+        do_queue(priority, item);
+    }
+
+    template<typename Function>
+    static void queue(Function function)
+    {
+        queue(Priority::Normal, move(function));
+    }
+
+private:
+    // How much work the worker may do at the high priority before it has to let others run.
+    static constexpr size_t budget_items = 64;
+    static constexpr Time budget_time = Time::from_milliseconds(2);
+
+    struct WorkItem {
+        IntrusiveListNode<WorkItem> m_node;
+        void (*function)(void*);
+        void* data;
+        void (*free_data)(void*);
+        u8 inline_data[4 * sizeof(void*)];
+    };
+
+    explicit DeferredWorkQueue(u32 cpu);
+
+    static void do_queue(Priority, WorkItem*);
+    static void run_item(WorkItem*);
+
+    WorkItem* take_next();
+    void run();
+
+    using WorkItemList = IntrusiveList<WorkItem, RawPtr<WorkItem>, &WorkItem::m_node>;
+
+    u32 m_cpu { 0 };
+    RefPtr<Thread> m_thread;
+    WaitQueue m_wait_queue;
+    WorkItemList m_items[priority_count];
+    SpinLock<u8> m_lock;
+};
+
+}
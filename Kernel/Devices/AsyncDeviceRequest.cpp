@@ -12,6 +12,7 @@ namespace Kernel {
 AsyncDeviceRequest::AsyncDeviceRequest(Device& device)
     : m_device(device)
     , m_process(*Process::current())
+    , m_thread(Thread::current())
 {
 }
 
@@ -73,6 +74,7 @@ void AsyncDeviceRequest::add_sub_request(NonnullRefPtr<AsyncDeviceRequest> sub_r
     VERIFY(&m_device != &sub_request->m_device);
     VERIFY(sub_request->m_parent_request == nullptr);
     sub_request->m_parent_request = this;
+    sub_request->m_thread = m_thread;
 
     ScopedSpinLock lock(m_lock);
     VERIFY(!is_completed_result(m_result));
@@ -135,6 +137,7 @@ void AsyncDeviceRequest::complete(RequestResult result)
         VERIFY(m_result == Started);
         m_result = result;
     }
+    did_complete(result);
     if (Processor::current().in_irq()) {
         ref(); // Make sure we don't get freed
         Processor::deferred_call_queue([this]() {
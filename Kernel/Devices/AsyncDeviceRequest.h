@@ -73,6 +73,9 @@ public:
 
     void complete(RequestResult result);
 
+    // The thread that issued the request, or the one that issued its parent request.
+    Thread* requesting_thread() { return m_thread.ptr(); }
+
     void set_private(void* priv)
     {
         VERIFY(!m_private || !priv);
@@ -121,6 +124,9 @@ protected:
 
     RequestResult get_request_result() const;
 
+    // Called by complete() once the result is known, possibly in an interrupt handler.
+    virtual void did_complete(RequestResult) { }
+
 private:
     void sub_request_finished(AsyncDeviceRequest&);
     void request_finished();
@@ -149,6 +155,7 @@ private:
     AsyncDeviceSubRequestList m_sub_requests_complete;
     WaitQueue m_queue;
     NonnullRefPtr<Process> m_process;
+    RefPtr<Thread> m_thread;
     void* m_private { nullptr };
     mutable SpinLock<u8> m_lock;
 };
@@ -5,6 +5,8 @@
  */
 
 #include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/KTrace.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -16,6 +18,7 @@ AsyncBlockDeviceRequest::AsyncBlockDeviceRequest(Device& block_device, RequestTy
     , m_block_count(block_count)
     , m_buffer(buffer)
     , m_buffer_size(buffer_size)
+    , m_issue_time(TimeManagement::the().monotonic_time(TimePrecision::Precise))
 {
 }
 
@@ -24,6 +27,19 @@ void AsyncBlockDeviceRequest::start()
     m_block_device.start_request(*this);
 }
 
+void AsyncBlockDeviceRequest::did_complete(RequestResult result)
+{
+    if (KTrace::is_tracing(KTRACE_BLOCK_IO))
+        KTrace::block_io(*this, result);
+    if (auto* thread = requesting_thread()) {
+        if (m_request_type == Read)
+            thread->did_block_read(m_buffer_size);
+        else
+            thread->did_block_write(m_buffer_size);
+    }
+    m_block_device.did_complete_request(*this, result);
+}
+
 BlockDevice::~BlockDevice()
 {
 }
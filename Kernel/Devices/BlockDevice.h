@@ -21,6 +21,7 @@ public:
     AsyncBlockDeviceRequest(Device& block_device, RequestType request_type,
         u64 block_index, u32 block_count, const UserOrKernelBuffer& buffer, size_t buffer_size);
 
+    BlockDevice& block_device() { return m_block_device; }
     RequestType request_type() const { return m_request_type; }
     u64 block_index() const { return m_block_index; }
     u32 block_count() const { return m_block_count; }
@@ -28,6 +29,9 @@ public:
     const UserOrKernelBuffer& buffer() const { return m_buffer; }
     size_t buffer_size() const { return m_buffer_size; }
 
+    // When the request was issued, for measuring how long it spent queued and on the device.
+    Time issue_time() const { return m_issue_time; }
+
     virtual void start() override;
     virtual const char* name() const override
     {
@@ -42,12 +46,15 @@ public:
     }
 
 private:
+    virtual void did_complete(RequestResult) override;
+
     BlockDevice& m_block_device;
     const RequestType m_request_type;
     const u64 m_block_index;
     const u32 m_block_count;
     UserOrKernelBuffer m_buffer;
     const size_t m_buffer_size;
+    const Time m_issue_time;
 };
 
 class BlockDevice : public Device {
@@ -62,6 +69,9 @@ public:
 
     virtual void start_request(AsyncBlockDeviceRequest&) = 0;
 
+    // Called when the device has completed one of its requests, possibly in an interrupt handler.
+    virtual void did_complete_request(const AsyncBlockDeviceRequest&, AsyncDeviceRequest::RequestResult) { }
+
 protected:
     BlockDevice(unsigned major, unsigned minor, size_t block_size = PAGE_SIZE)
         : Device(major, minor)
@@ -63,11 +63,16 @@ String Device::absolute_path(const FileDescription&) const
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest& completed_request)
 {
     ScopedSpinLock lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
+    // Requests may complete in a different order than they were started in.
+    auto it = m_active_requests.find(const_cast<AsyncDeviceRequest*>(&completed_request));
+    VERIFY(it != m_active_requests.end());
+    m_active_requests.remove(it);
+    m_active_request_count--;
     if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
+        auto next_request = m_requests.first();
+        m_requests.remove(m_requests.begin());
+        m_active_requests.append(next_request);
+        m_active_request_count++;
         next_request->do_start(move(lock));
     }
 
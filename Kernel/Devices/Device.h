@@ -48,15 +48,22 @@ public:
 
     void process_next_queued_request(Badge<AsyncDeviceRequest>, const AsyncDeviceRequest&);
 
+    // How many requests may be started before any of them completes. Devices that
+    // can work on several requests at once (and complete them in any order) override this.
+    virtual size_t max_outstanding_requests() const { return 1; }
+
     template<typename AsyncRequestType, typename... Args>
     NonnullRefPtr<AsyncRequestType> make_request(Args&&... args)
     {
         auto request = adopt_ref(*new AsyncRequestType(*this, forward<Args>(args)...));
         ScopedSpinLock lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
-        m_requests.append(request);
-        if (was_empty)
+        if (m_active_request_count < max_outstanding_requests()) {
+            m_active_requests.append(request);
+            m_active_request_count++;
             request->do_start(move(lock));
+        } else {
+            m_requests.append(request);
+        }
         return request;
     }
 
@@ -74,7 +81,10 @@ private:
     gid_t m_gid { 0 };
 
     SpinLock<u8> m_requests_lock;
+    // Requests waiting to be started, and requests that have been started but haven't completed yet.
     DoublyLinkedList<RefPtr<AsyncDeviceRequest>> m_requests;
+    DoublyLinkedList<RefPtr<AsyncDeviceRequest>> m_active_requests;
+    size_t m_active_request_count { 0 };
 };
 
 }
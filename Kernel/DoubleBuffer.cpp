@@ -40,19 +40,53 @@ void DoubleBuffer::flip()
     compute_lockfree_metadata();
 }
 
+KResult DoubleBuffer::try_resize(size_t new_capacity)
+{
+    LOCKER(m_lock);
+    size_t unread_size = m_read_buffer->size - m_read_buffer_index;
+    size_t buffered_size = unread_size + m_write_buffer->size;
+    new_capacity = max(new_capacity, buffered_size);
+    if (new_capacity == m_capacity)
+        return KSuccess;
+
+    auto new_storage = KBuffer::try_create_with_size(new_capacity * 2, Region::Access::Read | Region::Access::Write, "DoubleBuffer");
+    if (!new_storage)
+        return ENOMEM;
+
+    // Everything that is still buffered ends up in the new read buffer, in order.
+    memcpy(new_storage->data(), m_read_buffer->data + m_read_buffer_index, unread_size);
+    memcpy(new_storage->data() + unread_size, m_write_buffer->data, m_write_buffer->size);
+
+    m_storage = move(*new_storage);
+    m_capacity = new_capacity;
+    m_buffer1.data = m_storage.data();
+    m_buffer1.size = buffered_size;
+    m_buffer2.data = m_storage.data() + new_capacity;
+    m_buffer2.size = 0;
+    m_read_buffer = &m_buffer1;
+    m_write_buffer = &m_buffer2;
+    m_read_buffer_index = 0;
+    compute_lockfree_metadata();
+    if (m_unblock_callback && m_space_for_writing > 0)
+        m_unblock_callback();
+    return KSuccess;
+}
+
 ssize_t DoubleBuffer::write(const UserOrKernelBuffer& data, size_t size)
 {
     if (!size || m_storage.is_null())
         return 0;
     VERIFY(size > 0);
     LOCKER(m_lock);
+    bool was_empty = m_empty;
     size_t bytes_to_write = min(size, m_space_for_writing);
     u8* write_ptr = m_write_buffer->data + m_write_buffer->size;
     m_write_buffer->size += bytes_to_write;
     compute_lockfree_metadata();
     if (!data.read(write_ptr, bytes_to_write))
         return -EFAULT;
-    if (m_unblock_callback && !m_empty)
+    // Readers only ever wait for the buffer to stop being empty, so there's nobody new to wake up otherwise.
+    if (m_unblock_callback && was_empty && !m_empty)
         m_unblock_callback();
     return (ssize_t)bytes_to_write;
 }
@@ -63,16 +97,31 @@ ssize_t DoubleBuffer::read(UserOrKernelBuffer& data, size_t size)
         return 0;
     VERIFY(size > 0);
     LOCKER(m_lock);
+    size_t space_for_writing_before = m_space_for_writing;
     if (m_read_buffer_index >= m_read_buffer->size && m_write_buffer->size != 0)
         flip();
     if (m_read_buffer_index >= m_read_buffer->size)
         return 0;
-    size_t nread = min(m_read_buffer->size - m_read_buffer_index, size);
-    if (!data.write(m_read_buffer->data + m_read_buffer_index, nread))
+    // Whatever fits of the write buffer goes along with the rest of the read buffer, so that a reader with a large
+    // enough buffer drains everything in one copy.
+    size_t from_read_buffer = min(m_read_buffer->size - m_read_buffer_index, size);
+    size_t from_write_buffer = min(m_write_buffer->size, size - from_read_buffer);
+    ReadonlyBytes sources[] = {
+        { m_read_buffer->data + m_read_buffer_index, from_read_buffer },
+        { m_write_buffer->data, from_write_buffer },
+    };
+    if (!data.write(Span<const ReadonlyBytes> { sources, from_write_buffer ? 2u : 1u }))
         return -EFAULT;
-    m_read_buffer_index += nread;
+    m_read_buffer_index += from_read_buffer;
+    if (from_write_buffer) {
+        flip();
+        m_read_buffer_index = from_write_buffer;
+    }
     compute_lockfree_metadata();
-    if (m_unblock_callback && m_space_for_writing > 0)
+    size_t nread = from_read_buffer + from_write_buffer;
+    // Space for writing only comes back when the buffers flip, so writers are woken up once per flip rather than
+    // once per read.
+    if (m_unblock_callback && m_space_for_writing > space_for_writing_before)
         m_unblock_callback();
     return (ssize_t)nread;
 }
@@ -32,6 +32,12 @@ public:
 
     bool is_empty() const { return m_empty; }
 
+    size_t capacity() const { return m_capacity; }
+
+    // Reallocates the storage, keeping any data that hasn't been read yet.
+    // The capacity never drops below the amount of data that is currently buffered.
+    KResult try_resize(size_t new_capacity);
+
     size_t space_for_writing() const { return m_space_for_writing; }
 
     void set_unblock_callback(Function<void()> callback)
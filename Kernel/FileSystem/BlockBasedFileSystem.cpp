@@ -5,87 +5,154 @@
  */
 
 #include <AK/IntrusiveList.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/Process.h>
+#include <Kernel/Tasks/SyncTask.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
+// The disk cache uses the "2Q" replacement policy (Johnson & Shasha, 1994).
+// Blocks that are seen for the first time go into a small FIFO ("A1in"),
+// and only blocks that are referenced again after falling out of it get
+// promoted to the main LRU queue ("Am"). This keeps a single large scan
+// (e.g `find /`) from pushing all the hot metadata out of the cache.
+// Blocks evicted from A1in are remembered in a ghost list ("A1out") without
+// their data, so we can recognize them when they come back.
+
+enum class CacheQueue : u8 {
+    Free,
+    Recent,
+    Frequent,
+};
+
 struct CacheEntry {
     IntrusiveListNode<CacheEntry> list_node;
     BlockBasedFS::BlockIndex block_index { 0 };
     u8* data { nullptr };
     bool has_data { false };
+    bool is_dirty { false };
+    CacheQueue queue { CacheQueue::Free };
+    u16 segment { 0 };
 };
 
 class DiskCache {
 public:
+    // The cache grows in segments of this many bytes, and gives them back
+    // one segment at a time when the system is running low on memory.
+    static constexpr size_t segment_size = 1 * MiB;
+
     explicit DiskCache(BlockBasedFS& fs)
         : m_fs(fs)
-        , m_cached_block_data(KBuffer::create_with_size(m_entry_count * m_fs.block_size()))
-        , m_entries(KBuffer::create_with_size(m_entry_count * sizeof(CacheEntry)))
+        , m_entries_per_segment(max(segment_size / m_fs.block_size(), (size_t)1))
     {
-        for (size_t i = 0; i < m_entry_count; ++i) {
-            entries()[i].data = m_cached_block_data.data() + i * m_fs.block_size();
-            m_clean_list.append(entries()[i]);
-        }
+        auto max_size = kernel_command_line().disk_cache_size().value_or(default_max_size());
+        m_max_segment_count = clamp(max_size / segment_size, (size_t)1, (size_t)NumericLimits<u16>::max());
+        m_ghost_ring.resize(m_max_segment_count * m_entries_per_segment / 2);
+        bool success = try_grow();
+        VERIFY(success);
     }
 
-    ~DiskCache() = default;
+    ~DiskCache()
+    {
+        mark_all_clean();
+        while (!m_segments.is_empty())
+            drop_last_segment();
+    }
 
-    bool is_dirty() const { return m_dirty; }
-    void set_dirty(bool b) { m_dirty = b; }
+    bool is_dirty() const { return m_dirty_count; }
+    size_t dirty_count() const { return m_dirty_count; }
+    size_t entry_count() const { return m_segments.size() * m_entries_per_segment; }
+
+    // The time at which the oldest currently dirty entry was dirtied.
+    Time dirty_since() const { return m_dirty_since; }
 
     void mark_all_clean()
     {
         while (auto* entry = m_dirty_list.first())
-            m_clean_list.prepend(*entry);
-        m_dirty = false;
+            mark_clean(*entry);
     }
 
     void mark_dirty(CacheEntry& entry)
     {
+        if (!entry.is_dirty) {
+            entry.is_dirty = true;
+            if (m_dirty_count++ == 0)
+                m_dirty_since = TimeManagement::the().monotonic_time();
+        }
         m_dirty_list.prepend(entry);
-        m_dirty = true;
     }
 
     void mark_clean(CacheEntry& entry)
     {
-        m_clean_list.prepend(entry);
+        if (entry.is_dirty) {
+            entry.is_dirty = false;
+            --m_dirty_count;
+        }
+        list_for(entry.queue).prepend(entry);
+    }
+
+    CacheEntry* find(BlockBasedFS::BlockIndex block_index)
+    {
+        auto it = m_hash.find(block_index);
+        if (it == m_hash.end())
+            return nullptr;
+        return it->value;
     }
 
-    CacheEntry& get(BlockBasedFS::BlockIndex block_index) const
+    CacheEntry& get(BlockBasedFS::BlockIndex block_index)
     {
         if (auto it = m_hash.find(block_index); it != m_hash.end()) {
-            auto& entry = const_cast<CacheEntry&>(*it->value);
+            auto& entry = *it->value;
             VERIFY(entry.block_index == block_index);
+            ++m_hits;
+            // NOTE: Recent entries stay in FIFO order; they only get promoted
+            //       if they are referenced again after being evicted.
+            if (entry.queue == CacheQueue::Frequent && !entry.is_dirty)
+                m_frequent_list.prepend(entry);
             return entry;
         }
 
-        if (m_clean_list.is_empty()) {
+        ++m_misses;
+
+        if (is_under_memory_pressure() && m_segments.size() > 1)
+            shrink();
+
+        auto* new_entry = m_free_list.first();
+        if (!new_entry && try_grow())
+            new_entry = m_free_list.first();
+        if (!new_entry)
+            new_entry = find_victim();
+        if (!new_entry) {
             // Not a single clean entry! Flush writes and try again.
             // NOTE: We want to make sure we only call FileBackedFS flush here,
             //       not some FileBackedFS subclass flush!
+            m_misses--;
             m_fs.flush_writes_impl();
             return get(block_index);
         }
 
-        VERIFY(m_clean_list.last());
-        auto& new_entry = *m_clean_list.last();
-        m_clean_list.prepend(new_entry);
-
-        m_hash.remove(new_entry.block_index);
-        m_hash.set(block_index, &new_entry);
+        auto queue = CacheQueue::Recent;
+        if (auto it = m_ghosts.find(block_index); it != m_ghosts.end()) {
+            m_ghosts.remove(it);
+            ++m_ghost_hits;
+            queue = CacheQueue::Frequent;
+        }
 
-        new_entry.block_index = block_index;
-        new_entry.has_data = false;
+        new_entry->block_index = block_index;
+        new_entry->has_data = false;
+        set_queue(*new_entry, queue);
+        list_for(queue).prepend(*new_entry);
+        m_hash.set(block_index, new_entry);
 
-        return new_entry;
+        return *new_entry;
     }
 
-    const CacheEntry* entries() const { return (const CacheEntry*)m_entries.data(); }
-    CacheEntry* entries() { return (CacheEntry*)m_entries.data(); }
-
     template<typename Callback>
     void for_each_dirty_entry(Callback callback)
     {
@@ -93,15 +160,201 @@ public:
             callback(entry);
     }
 
+    // A staging buffer for coalescing neighboring blocks into a single device transfer.
+    // Returns nullptr if we couldn't get one, in which case blocks are transferred one at a time.
+    u8* staging_buffer()
+    {
+        if (!m_staging_buffer)
+            m_staging_buffer = KBuffer::try_create_with_size(BlockBasedFS::max_coalesced_blocks * m_fs.block_size(), Region::Access::Read | Region::Access::Write, "DiskCache staging");
+        return m_staging_buffer ? m_staging_buffer->data() : nullptr;
+    }
+
+    BlockBasedFS::CacheStatistics statistics() const
+    {
+        BlockBasedFS::CacheStatistics statistics;
+        statistics.hits = m_hits;
+        statistics.misses = m_misses;
+        statistics.evictions = m_evictions;
+        statistics.ghost_hits = m_ghost_hits;
+        statistics.shrinks = m_shrinks;
+        statistics.entry_count = m_segments.size() * m_entries_per_segment;
+        statistics.max_entry_count = m_max_segment_count * m_entries_per_segment;
+        statistics.recent_count = m_recent_count;
+        statistics.frequent_count = m_frequent_count;
+        statistics.dirty_count = m_dirty_count;
+        statistics.ghost_count = m_ghosts.size();
+        return statistics;
+    }
+
 private:
+    struct Segment {
+        OwnPtr<KBuffer> block_data;
+        OwnPtr<KBuffer> entries;
+
+        CacheEntry* entry_array() { return reinterpret_cast<CacheEntry*>(entries->data()); }
+    };
+
+    struct Ghost {
+        BlockBasedFS::BlockIndex block_index { 0 };
+        u64 sequence { 0 };
+    };
+
+    using EntryList = IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node>;
+
+    static size_t default_max_size()
+    {
+        // By default, let each cache grow to 1/32 of physical memory (but at least 4 MiB).
+        return max((size_t)MM.user_physical_pages() * PAGE_SIZE / 32, (size_t)(4 * MiB));
+    }
+
+    static bool is_under_memory_pressure()
+    {
+        auto total = MM.user_physical_pages();
+        auto in_use = MM.user_physical_pages_used() + MM.user_physical_pages_committed();
+        return in_use >= total || (total - in_use) < total / 32;
+    }
+
+    EntryList& list_for(CacheQueue queue)
+    {
+        switch (queue) {
+        case CacheQueue::Free:
+            return m_free_list;
+        case CacheQueue::Recent:
+            return m_recent_list;
+        case CacheQueue::Frequent:
+            return m_frequent_list;
+        }
+        VERIFY_NOT_REACHED();
+    }
+
+    void set_queue(CacheEntry& entry, CacheQueue queue)
+    {
+        if (entry.queue == CacheQueue::Recent)
+            --m_recent_count;
+        else if (entry.queue == CacheQueue::Frequent)
+            --m_frequent_count;
+        entry.queue = queue;
+        if (queue == CacheQueue::Recent)
+            ++m_recent_count;
+        else if (queue == CacheQueue::Frequent)
+            ++m_frequent_count;
+    }
+
+    size_t recent_target() const
+    {
+        return max(m_segments.size() * m_entries_per_segment / 4, (size_t)1);
+    }
+
+    CacheEntry* find_victim()
+    {
+        // NOTE: Dirty entries live on the dirty list, so the tails of the
+        //       recent and frequent lists are always clean.
+        CacheEntry* victim = nullptr;
+        if (m_recent_count > recent_target() || m_frequent_list.is_empty())
+            victim = m_recent_list.last();
+        if (!victim)
+            victim = m_frequent_list.last();
+        if (!victim)
+            return nullptr;
+        VERIFY(!victim->is_dirty);
+        ++m_evictions;
+        evict(*victim);
+        return victim;
+    }
+
+    void evict(CacheEntry& entry)
+    {
+        VERIFY(!entry.is_dirty);
+        m_hash.remove(entry.block_index);
+        if (entry.queue == CacheQueue::Recent)
+            remember_ghost(entry.block_index);
+        set_queue(entry, CacheQueue::Free);
+        entry.has_data = false;
+        m_free_list.prepend(entry);
+    }
+
+    void remember_ghost(BlockBasedFS::BlockIndex block_index)
+    {
+        if (m_ghost_ring.is_empty())
+            return;
+        auto& slot = m_ghost_ring[m_ghost_sequence % m_ghost_ring.size()];
+        if (auto it = m_ghosts.find(slot.block_index); it != m_ghosts.end() && it->value == slot.sequence)
+            m_ghosts.remove(it);
+        slot = { block_index, m_ghost_sequence };
+        m_ghosts.set(block_index, m_ghost_sequence);
+        ++m_ghost_sequence;
+    }
+
+    bool try_grow()
+    {
+        if (m_segments.size() >= m_max_segment_count)
+            return false;
+        if (!m_segments.is_empty() && is_under_memory_pressure())
+            return false;
+        auto block_data = KBuffer::try_create_with_size(m_entries_per_segment * m_fs.block_size(), Region::Access::Read | Region::Access::Write, "DiskCache");
+        auto entries = KBuffer::try_create_with_size(m_entries_per_segment * sizeof(CacheEntry), Region::Access::Read | Region::Access::Write, "DiskCache entries");
+        if (!block_data || !entries)
+            return false;
+        Segment segment { block_data.release_nonnull(), entries.release_nonnull() };
+        auto segment_index = m_segments.size();
+        for (size_t i = 0; i < m_entries_per_segment; ++i) {
+            auto* entry = new (&segment.entry_array()[i]) CacheEntry;
+            entry->data = segment.block_data->data() + i * m_fs.block_size();
+            entry->segment = segment_index;
+            m_free_list.append(*entry);
+        }
+        m_segments.append(move(segment));
+        dbgln_if(BBFS_DEBUG, "DiskCache: Grew to {} segments", m_segments.size());
+        return true;
+    }
+
+    void drop_last_segment()
+    {
+        auto segment = m_segments.take_last();
+        for (size_t i = 0; i < m_entries_per_segment; ++i) {
+            auto& entry = segment.entry_array()[i];
+            VERIFY(!entry.is_dirty);
+            if (entry.queue != CacheQueue::Free)
+                evict(entry);
+            entry.list_node.remove();
+            entry.~CacheEntry();
+        }
+    }
+
+    void shrink()
+    {
+        if (is_dirty())
+            m_fs.flush_writes_impl();
+        drop_last_segment();
+        ++m_shrinks;
+        dbgln_if(BBFS_DEBUG, "DiskCache: Shrunk to {} segments due to memory pressure", m_segments.size());
+    }
+
     BlockBasedFS& m_fs;
-    size_t m_entry_count { 10000 };
-    mutable HashMap<BlockBasedFS::BlockIndex, CacheEntry*> m_hash;
-    mutable IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node> m_clean_list;
-    mutable IntrusiveList<CacheEntry, RawPtr<CacheEntry>, &CacheEntry::list_node> m_dirty_list;
-    KBuffer m_cached_block_data;
-    KBuffer m_entries;
-    bool m_dirty { false };
+    size_t m_entries_per_segment { 0 };
+    size_t m_max_segment_count { 0 };
+    Vector<Segment> m_segments;
+
+    HashMap<BlockBasedFS::BlockIndex, CacheEntry*> m_hash;
+    EntryList m_free_list;
+    EntryList m_recent_list;
+    EntryList m_frequent_list;
+    EntryList m_dirty_list;
+    size_t m_recent_count { 0 };
+    size_t m_frequent_count { 0 };
+    size_t m_dirty_count { 0 };
+    Time m_dirty_since;
+    OwnPtr<KBuffer> m_staging_buffer;
+
+    Vector<Ghost> m_ghost_ring;
+    HashMap<BlockBasedFS::BlockIndex, u64> m_ghosts;
+    u64 m_ghost_sequence { 0 };
+
+    u64 m_hits { 0 };
+    u64 m_misses { 0 };
+    u64 m_evictions { 0 };
+    u64 m_ghost_hits { 0 };
+    u64 m_shrinks { 0 };
 };
 
 BlockBasedFS::BlockBasedFS(FileDescription& file_description)
@@ -123,6 +376,9 @@ KResult BlockBasedFS::write_block(BlockIndex index, const UserOrKernelBuffer& da
 
     if (!allow_cache) {
         flush_specific_block_if_needed(index);
+        // Make sure we don't serve a stale copy of this block out of the cache later.
+        if (auto* entry = cache().find(index))
+            entry->has_data = false;
         u32 base_offset = index.value() * block_size() + offset;
         auto seek_result = file_description().seek(base_offset, SEEK_SET);
         if (seek_result.is_error())
@@ -146,6 +402,9 @@ KResult BlockBasedFS::write_block(BlockIndex index, const UserOrKernelBuffer& da
 
     cache().mark_dirty(entry);
     entry.has_data = true;
+
+    if (cache().dirty_count() * 100 >= cache().entry_count() * dirty_background_ratio)
+        SyncTask::wake();
     return KSuccess;
 }
 
@@ -267,46 +526,118 @@ KResult BlockBasedFS::read_blocks(BlockIndex index, unsigned count, UserOrKernel
     return KSuccess;
 }
 
+KResult BlockBasedFS::read_from_device(BlockIndex index, size_t count, u8* data) const
+{
+    auto seek_result = file_description().seek(index.value() * block_size(), SEEK_SET);
+    if (seek_result.is_error())
+        return seek_result.error();
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(data);
+    // NOTE: The device may split large reads, so keep going until everything is read.
+    size_t nread = 0;
+    while (nread < count * block_size()) {
+        auto chunk = buffer.offset(nread);
+        auto result = file_description().read(chunk, count * block_size() - nread);
+        if (result.is_error())
+            return result.error();
+        if (result.value() == 0)
+            return EIO;
+        nread += result.value();
+    }
+    return KSuccess;
+}
+
+KResult BlockBasedFS::write_to_device(BlockIndex index, size_t count, const u8* data)
+{
+    auto seek_result = file_description().seek(index.value() * block_size(), SEEK_SET);
+    if (seek_result.is_error())
+        return seek_result.error();
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(data));
+    // NOTE: The device may split large writes, so keep going until everything is written.
+    size_t nwritten = 0;
+    while (nwritten < count * block_size()) {
+        auto result = file_description().write(buffer.offset(nwritten), count * block_size() - nwritten);
+        if (result.is_error())
+            return result.error();
+        if (result.value() == 0)
+            return EIO;
+        nwritten += result.value();
+    }
+    return KSuccess;
+}
+
 void BlockBasedFS::flush_specific_block_if_needed(BlockIndex index)
 {
     LOCKER(m_lock);
     if (!cache().is_dirty())
         return;
-    Vector<CacheEntry*, 32> cleaned_entries;
+    auto* entry = cache().find(index);
+    if (!entry || !entry->is_dirty)
+        return;
+    // FIXME: Should this error path be surfaced somehow?
+    [[maybe_unused]] auto rc = write_to_device(index, 1, entry->data);
+    cache().mark_clean(*entry);
+}
+
+size_t BlockBasedFS::flush_dirty_batch()
+{
+    VERIFY(m_lock.is_locked());
+
+    Vector<CacheEntry*> entries;
     cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        if (entry.block_index != index) {
-            size_t base_offset = entry.block_index.value() * block_size();
-            auto seek_result = file_description().seek(base_offset, SEEK_SET);
-            VERIFY(!seek_result.is_error());
-            // FIXME: Should this error path be surfaced somehow?
-            auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-            [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
-            cleaned_entries.append(&entry);
-        }
+        entries.append(&entry);
     });
+    quick_sort(entries, [](auto* a, auto* b) { return a->block_index < b->block_index; });
+    if (entries.size() > max_writeback_batch)
+        entries.shrink(max_writeback_batch);
+
+    auto* staging = cache().staging_buffer();
+    for (size_t i = 0; i < entries.size();) {
+        size_t run = 1;
+        if (staging) {
+            while (i + run < entries.size() && run < max_coalesced_blocks && entries[i + run]->block_index.value() == entries[i]->block_index.value() + run)
+                ++run;
+        }
+        const u8* data = entries[i]->data;
+        if (run > 1) {
+            for (size_t j = 0; j < run; ++j)
+                memcpy(staging + j * block_size(), entries[i + j]->data, block_size());
+            data = staging;
+        }
+        // FIXME: Should this error path be surfaced somehow?
+        [[maybe_unused]] auto rc = write_to_device(entries[i]->block_index, run, data);
+        i += run;
+    }
+
     // NOTE: We make a separate pass to mark entries clean since marking them clean
     //       moves them out of the dirty list which would disturb the iteration above.
-    for (auto* entry : cleaned_entries)
+    for (auto* entry : entries)
         cache().mark_clean(*entry);
+    return entries.size();
 }
 
 void BlockBasedFS::flush_writes_impl()
+{
+    size_t count = 0;
+    // NOTE: We flush in batches and let go of the lock in between,
+    //       so that other threads can get some work done meanwhile.
+    for (;;) {
+        LOCKER(m_lock);
+        if (!cache().is_dirty())
+            break;
+        count += flush_dirty_batch();
+    }
+    if (count)
+        dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+}
+
+bool BlockBasedFS::needs_writeback() const
 {
     LOCKER(m_lock);
-    if (!cache().is_dirty())
-        return;
-    u32 count = 0;
-    cache().for_each_dirty_entry([&](CacheEntry& entry) {
-        u32 base_offset = entry.block_index.value() * block_size();
-        auto seek_result = file_description().seek(base_offset, SEEK_SET);
-        VERIFY(!seek_result.is_error());
-        // FIXME: Should this error path be surfaced somehow?
-        auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
-        [[maybe_unused]] auto rc = file_description().write(entry_data_buffer, block_size());
-        ++count;
-    });
-    cache().mark_all_clean();
-    dbgln("{}: Flushed {} blocks to disk", class_name(), count);
+    if (!m_cache || !m_cache->is_dirty())
+        return false;
+    if (m_cache->dirty_count() * 100 >= m_cache->entry_count() * dirty_background_ratio)
+        return true;
+    return TimeManagement::the().monotonic_time() - m_cache->dirty_since() >= Time::from_seconds(dirty_expire_seconds);
 }
 
 void BlockBasedFS::flush_writes()
@@ -314,6 +645,58 @@ void BlockBasedFS::flush_writes()
     flush_writes_impl();
 }
 
+void BlockBasedFS::writeback()
+{
+    if (needs_writeback())
+        flush_writes_impl();
+}
+
+void BlockBasedFS::prefetch_blocks(Span<const BlockIndex> blocks) const
+{
+    LOCKER(m_lock);
+    auto is_cached = [&](BlockIndex index) {
+        auto* entry = cache().find(index);
+        return entry && entry->has_data;
+    };
+
+    auto* staging = cache().staging_buffer();
+    for (size_t i = 0; i < blocks.size();) {
+        if (blocks[i].value() == 0 || is_cached(blocks[i])) {
+            ++i;
+            continue;
+        }
+        size_t run = 1;
+        if (staging) {
+            while (i + run < blocks.size() && run < max_coalesced_blocks && blocks[i + run].value() == blocks[i].value() + run && !is_cached(blocks[i + run]))
+                ++run;
+        }
+        u8* data = staging;
+        if (run == 1) {
+            auto& entry = cache().get(blocks[i]);
+            data = entry.data;
+        }
+        if (read_from_device(blocks[i], run, data).is_error()) {
+            dbgln("{}: Readahead of {} blocks at {} failed", class_name(), run, blocks[i]);
+            return;
+        }
+        for (size_t j = 0; j < run; ++j) {
+            auto& entry = cache().get(blocks[i + j]);
+            if (entry.has_data)
+                continue;
+            if (run > 1)
+                memcpy(entry.data, staging + j * block_size(), block_size());
+            entry.has_data = true;
+        }
+        i += run;
+    }
+}
+
+BlockBasedFS::CacheStatistics BlockBasedFS::cache_statistics() const
+{
+    LOCKER(m_lock);
+    return cache().statistics();
+}
+
 DiskCache& BlockBasedFS::cache() const
 {
     if (!m_cache)
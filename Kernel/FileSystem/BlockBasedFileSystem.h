@@ -14,11 +14,40 @@ class BlockBasedFS : public FileBackedFS {
 public:
     TYPEDEF_DISTINCT_ORDERED_ID(u64, BlockIndex);
 
+    struct CacheStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 evictions { 0 };
+        u64 ghost_hits { 0 };
+        u64 shrinks { 0 };
+        size_t entry_count { 0 };
+        size_t max_entry_count { 0 };
+        size_t recent_count { 0 };
+        size_t frequent_count { 0 };
+        size_t dirty_count { 0 };
+        size_t ghost_count { 0 };
+    };
+
     virtual ~BlockBasedFS() override;
 
+    virtual bool is_block_based() const override { return true; }
+
     size_t logical_block_size() const { return m_logical_block_size; };
 
+    CacheStatistics cache_statistics() const;
+
+    // Dirty blocks are written back in the background once they make up this
+    // percentage of the cache, or once they have been dirty for this long.
+    static constexpr size_t dirty_background_ratio = 10;
+    static constexpr i64 dirty_expire_seconds = 5;
+
+    // Upper bounds on how many neighboring blocks get coalesced into a single
+    // device transfer, and on how many blocks get written in one go with the lock held.
+    static constexpr size_t max_coalesced_blocks = 64;
+    static constexpr size_t max_writeback_batch = 256;
+
     virtual void flush_writes() override;
+    virtual void writeback() override;
     void flush_writes_impl();
 
 protected:
@@ -36,11 +65,19 @@ protected:
     KResult write_block(BlockIndex, const UserOrKernelBuffer&, size_t count, size_t offset = 0, bool allow_cache = true);
     KResult write_blocks(BlockIndex, unsigned count, const UserOrKernelBuffer&, bool allow_cache = true);
 
+    // Brings the given blocks into the cache, reading neighboring ones with a single request where possible.
+    // Block index 0 is taken to mean a hole and skipped.
+    void prefetch_blocks(Span<const BlockIndex>) const;
+
     size_t m_logical_block_size { 512 };
 
 private:
     DiskCache& cache() const;
     void flush_specific_block_if_needed(BlockIndex index);
+    KResult read_from_device(BlockIndex, size_t count, u8* data) const;
+    KResult write_to_device(BlockIndex, size_t count, const u8* data);
+    size_t flush_dirty_batch();
+    bool needs_writeback() const;
 
     mutable OwnPtr<DiskCache> m_cache;
 };
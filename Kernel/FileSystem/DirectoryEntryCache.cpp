@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
+#include <LibC/limits.h>
+
+namespace Kernel {
+
+static AK::Singleton<DirectoryEntryCache> s_the;
+
+DirectoryEntryCache& DirectoryEntryCache::the()
+{
+    return *s_the;
+}
+
+size_t DirectoryEntryCache::index_for(const Inode& directory, const StringView& name)
+{
+    return pair_int_hash(ptr_hash(&directory), name.hash()) % entry_count;
+}
+
+DirectoryEntryCache::LookupResult DirectoryEntryCache::lookup(Inode& directory, const StringView& name)
+{
+    auto index = index_for(directory, name);
+    auto& shard = shard_for(index);
+    ScopedSpinLock lock(shard.lock);
+    LookupResult result;
+    result.generation = shard.generation;
+
+    auto& entry = m_entries[index];
+    if (entry.directory.unsafe_ptr() == &directory && entry.name == name) {
+        if (entry.negative) {
+            result.hit = true;
+        } else if (auto child = entry.child.strong_ref()) {
+            result.hit = true;
+            result.inode = move(child);
+        }
+    }
+    return result;
+}
+
+void DirectoryEntryCache::add(Inode& directory, const StringView& name, Inode* child, u32 generation)
+{
+    if (name.length() > NAME_MAX)
+        return;
+
+    auto index = index_for(directory, name);
+    auto& shard = shard_for(index);
+    // Allocate the name before taking the lock.
+    String name_string = name;
+    ScopedSpinLock lock(shard.lock);
+    if (shard.generation != generation)
+        return;
+
+    auto& entry = m_entries[index];
+    entry.directory = directory;
+    entry.name = move(name_string);
+    entry.negative = !child;
+    if (child)
+        entry.child = *child;
+    else
+        entry.child.clear();
+}
+
+void DirectoryEntryCache::invalidate(Inode& directory, const StringView& name)
+{
+    auto index = index_for(directory, name);
+    auto& shard = shard_for(index);
+    ScopedSpinLock lock(shard.lock);
+    shard.generation++;
+
+    auto& entry = m_entries[index];
+    if (entry.directory.unsafe_ptr() != &directory || entry.name != name)
+        return;
+    entry.directory.clear();
+    entry.child.clear();
+    entry.name = {};
+}
+
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/String.h>
+#include <AK/StringView.h>
+#include <AK/WeakPtr.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/SpinLock.h>
+
+namespace Kernel {
+
+// Remembers the result of looking up a name in a directory, so that resolving the same
+// path components again doesn't have to go to the filesystem. Names that don't exist
+// are remembered too, which helps with things like searching $PATH.
+// The cache is shared between all filesystems that opt in via FS::supports_directory_entry_cache(),
+// which promise to call Inode::did_add_child() and Inode::did_remove_child() for every change.
+// Entries only hold weak pointers, so they never keep an inode alive; an entry whose
+// directory or child has gone away is simply treated as a miss.
+class DirectoryEntryCache {
+    AK_MAKE_NONCOPYABLE(DirectoryEntryCache);
+    AK_MAKE_NONMOVABLE(DirectoryEntryCache);
+
+public:
+    static DirectoryEntryCache& the();
+
+    DirectoryEntryCache() = default;
+
+    struct LookupResult {
+        bool hit { false };
+        // Null with hit == true means the name is known not to exist.
+        RefPtr<Inode> inode;
+        // Has to be passed to add(), so it can tell whether the directory changed in the meantime.
+        u32 generation { 0 };
+    };
+
+    LookupResult lookup(Inode& directory, const StringView& name);
+    void add(Inode& directory, const StringView& name, Inode* child, u32 generation);
+    void invalidate(Inode& directory, const StringView& name);
+
+private:
+    static constexpr size_t entry_count = 4096;
+    static constexpr size_t lock_count = 64;
+
+    struct Entry {
+        WeakPtr<Inode> directory;
+        String name;
+        WeakPtr<Inode> child;
+        bool negative { false };
+    };
+
+    struct Shard {
+        SpinLock<u8> lock;
+        // Bumped on every invalidation, so that a lookup that raced with a change of the
+        // directory doesn't put its (possibly stale) result into the cache.
+        u32 generation { 0 };
+    };
+
+    static size_t index_for(const Inode& directory, const StringView& name);
+    Shard& shard_for(size_t index) { return m_shards[index % lock_count]; }
+
+    Entry m_entries[entry_count];
+    Shard m_shards[lock_count];
+};
+
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// Which EPolls each description has entries in, so they can be dropped when
+// the description goes away. Always taken before EPoll::m_lock.
+static AK::Singleton<Lockable<HashMap<FileDescription*, Vector<EPoll*>>>> s_memberships;
+
+NonnullRefPtr<EPoll> EPoll::create()
+{
+    return adopt_ref(*new EPoll);
+}
+
+EPoll::EPoll()
+{
+}
+
+EPoll::~EPoll()
+{
+    Locker memberships_locker(s_memberships->lock());
+    LOCKER(m_lock);
+    while (!m_entries.is_empty())
+        remove_entry(*m_entries.begin()->value);
+}
+
+EPoll::Entry::Entry(EPoll& epoll, int fd, FileDescription& description, const epoll_event& event)
+    : m_epoll(epoll)
+    , m_fd(fd)
+    , m_description(&description)
+{
+    set_event(event);
+}
+
+EPoll::Entry::~Entry()
+{
+    // The Blocker destructor would do this as well, but by then the block
+    // condition may already be gone.
+    if (m_description)
+        unregister_blocker();
+}
+
+void EPoll::Entry::set_event(const epoll_event& event)
+{
+    m_events = event.events;
+    m_data = event.data;
+    m_disarmed = false;
+    m_block_flags = BlockFlags::None;
+    if (m_events & EPOLLIN)
+        m_block_flags |= BlockFlags::Read;
+    if (m_events & EPOLLOUT)
+        m_block_flags |= BlockFlags::Write;
+    if (m_events & EPOLLPRI)
+        m_block_flags |= BlockFlags::ReadPriority;
+}
+
+void EPoll::Entry::register_blocker()
+{
+    // Registering evaluates the current state right away, so a description
+    // that is already ready ends up on the ready list immediately.
+    [[maybe_unused]] bool was_added = set_block_condition(m_description->block_condition());
+    VERIFY(was_added);
+}
+
+void EPoll::Entry::unregister_blocker()
+{
+    ScopedSpinLock lock(m_lock);
+    m_description->block_condition().remove_blocker(*this, nullptr);
+    set_block_condition_raw_locked(nullptr);
+}
+
+bool EPoll::Entry::unblock(bool, void*)
+{
+    // NOTE: This is called with the description's block condition locked.
+    if (m_description->should_unblock(m_block_flags) != BlockFlags::None)
+        m_epoll.mark_ready(*this);
+    // Stay registered for as long as we're part of the interest set.
+    return false;
+}
+
+void EPoll::mark_ready(Entry& entry)
+{
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        if (entry.m_ready_list_node.is_in_list())
+            return;
+        m_ready_list.append(entry);
+    }
+    evaluate_block_conditions();
+}
+
+bool EPoll::can_read(const FileDescription&, size_t) const
+{
+    ScopedSpinLock lock(m_ready_lock);
+    return !m_ready_list.is_empty();
+}
+
+void EPoll::add_entry(int fd, FileDescription& description, const epoll_event& event)
+{
+    VERIFY(s_memberships->lock().is_locked());
+    VERIFY(m_lock.is_locked());
+
+    auto entry = adopt_ref(*new Entry(*this, fd, description, event));
+    m_entries.set(fd, entry);
+    s_memberships->resource().ensure(&description).append(this);
+    description.set_has_epoll_entries({});
+    entry->register_blocker();
+}
+
+void EPoll::remove_entry(Entry& entry)
+{
+    VERIFY(s_memberships->lock().is_locked());
+    VERIFY(m_lock.is_locked());
+    VERIFY(entry.m_description);
+
+    NonnullRefPtr<Entry> protect(entry);
+    m_entries.remove(entry.m_fd);
+
+    // Once the blocker is gone nobody can put the entry back on the ready list.
+    entry.unregister_blocker();
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        if (entry.m_ready_list_node.is_in_list())
+            m_ready_list.remove(entry);
+    }
+
+    auto& memberships = s_memberships->resource();
+    auto it = memberships.find(entry.m_description);
+    if (it != memberships.end()) {
+        it->value.remove_first_matching([&](auto* epoll) { return epoll == this; });
+        if (it->value.is_empty())
+            memberships.remove(it);
+    }
+    entry.m_description = nullptr;
+}
+
+KResult EPoll::add(int fd, FileDescription& description, const epoll_event& event)
+{
+    if (description.file().is_epoll())
+        return EINVAL;
+
+    Locker memberships_locker(s_memberships->lock());
+    LOCKER(m_lock);
+    if (auto it = m_entries.find(fd); it != m_entries.end()) {
+        if (it->value->m_description == &description)
+            return EEXIST;
+        // The fd was closed and reused while the old description is still
+        // alive elsewhere. The fd now means the new description.
+        remove_entry(*it->value);
+    }
+
+    add_entry(fd, description, event);
+    return KSuccess;
+}
+
+KResult EPoll::modify(int fd, FileDescription& description, const epoll_event& event)
+{
+    Locker memberships_locker(s_memberships->lock());
+    LOCKER(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+
+    auto& entry = *it->value;
+    if (entry.m_description != &description) {
+        // See add(), the fd refers to a different description by now.
+        remove_entry(entry);
+        add_entry(fd, description, event);
+        return KSuccess;
+    }
+
+    entry.unregister_blocker();
+    entry.set_event(event);
+    entry.register_blocker();
+    return KSuccess;
+}
+
+KResult EPoll::remove(int fd)
+{
+    Locker memberships_locker(s_memberships->lock());
+    LOCKER(m_lock);
+    auto it = m_entries.find(fd);
+    if (it == m_entries.end())
+        return ENOENT;
+    remove_entry(*it->value);
+    return KSuccess;
+}
+
+void EPoll::description_destroyed(Badge<FileDescription>, FileDescription& description)
+{
+    Locker memberships_locker(s_memberships->lock());
+    auto& memberships = s_memberships->resource();
+    while (true) {
+        auto it = memberships.find(&description);
+        if (it == memberships.end())
+            break;
+        // remove_entry() takes the EPoll out of the list (and eventually
+        // removes the list), so look it up again every time.
+        VERIFY(!it->value.is_empty());
+        auto& epoll = *it->value.first();
+        LOCKER(epoll.m_lock);
+        Entry* entry = nullptr;
+        for (auto& entry_it : epoll.m_entries) {
+            if (entry_it.value->m_description == &description) {
+                entry = entry_it.value.ptr();
+                break;
+            }
+        }
+        VERIFY(entry);
+        epoll.remove_entry(*entry);
+    }
+}
+
+size_t EPoll::collect_events(Process& process, Vector<epoll_event>& events, size_t max_events)
+{
+    LOCKER(m_lock);
+
+    Vector<NonnullRefPtr<Entry>> ready_entries;
+    {
+        ScopedSpinLock lock(m_ready_lock);
+        while (!m_ready_list.is_empty())
+            ready_entries.append(m_ready_list.take_first().release_nonnull());
+    }
+
+    Vector<Entry*> requeue;
+    for (auto& entry : ready_entries) {
+        if (events.size() >= max_events) {
+            requeue.append(entry.ptr());
+            continue;
+        }
+        if (entry->m_disarmed)
+            continue;
+        // The fd may have been closed (or reused) since it was added. Like on
+        // Linux, we keep watching the description until it's destroyed, but
+        // there's no meaningful fd to report it under anymore.
+        if (process.file_description(entry->m_fd) != entry->m_description)
+            continue;
+
+        auto unblock_flags = entry->m_description->should_unblock(entry->m_block_flags);
+        if (unblock_flags == BlockFlags::None)
+            continue;
+
+        epoll_event event {};
+        if (has_flag(unblock_flags, BlockFlags::Read))
+            event.events |= EPOLLIN;
+        if (has_flag(unblock_flags, BlockFlags::Write))
+            event.events |= EPOLLOUT;
+        if (has_flag(unblock_flags, BlockFlags::ReadPriority))
+            event.events |= EPOLLPRI;
+        event.data = entry->m_data;
+        events.append(event);
+
+        if (entry->m_events & EPOLLONESHOT) {
+            entry->m_disarmed = true;
+            continue;
+        }
+        // Edge-triggered entries only come back once the block condition is
+        // evaluated again; level-triggered ones stay until they're not ready.
+        if (!(entry->m_events & EPOLLET))
+            requeue.append(entry.ptr());
+    }
+
+    if (!requeue.is_empty()) {
+        ScopedSpinLock lock(m_ready_lock);
+        for (auto* entry : requeue) {
+            if (!entry->m_ready_list_node.is_in_list())
+                m_ready_list.append(*entry);
+        }
+    }
+    return events.size();
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/RefCounted.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Lock.h>
+#include <Kernel/Thread.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+// A persistent set of file descriptors to watch for readiness, see epoll(2).
+//
+// Every watched description gets a blocker registered on its block condition
+// for as long as it stays in the set. Whenever the underlying File re-evaluates
+// its block conditions and turns out to be ready, the entry is put on the ready
+// list, so collecting events only ever looks at descriptions that became ready
+// instead of walking the whole set.
+//
+// Like on Linux, an entry goes away once the description it was added for is
+// destroyed, even if the fd it was added under has been closed (or reused)
+// before that.
+class EPoll final : public File {
+public:
+    static NonnullRefPtr<EPoll> create();
+    virtual ~EPoll() override;
+
+    KResult add(int fd, FileDescription&, const epoll_event&);
+    KResult modify(int fd, FileDescription&, const epoll_event&);
+    KResult remove(int fd);
+
+    static void description_destroyed(Badge<FileDescription>, FileDescription&);
+
+    // Moves up to max_events ready events into `events`. `process` is used to
+    // skip over entries whose fd has since been closed or reused.
+    size_t collect_events(Process&, Vector<epoll_event>& events, size_t max_events);
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual String absolute_path(const FileDescription&) const override { return "epoll"; }
+    virtual const char* class_name() const override { return "EPoll"; }
+    virtual bool is_epoll() const override { return true; }
+
+private:
+    class Entry final
+        : public RefCounted<Entry>
+        , public Thread::FileBlocker {
+    public:
+        Entry(EPoll&, int fd, FileDescription&, const epoll_event&);
+        virtual ~Entry() override;
+
+        void register_blocker();
+        void unregister_blocker();
+        void set_event(const epoll_event&);
+
+        virtual bool unblock(bool, void*) override;
+        virtual void not_blocking(bool) override { }
+        virtual const char* state_string() const override { return "EPoll"; }
+
+        EPoll& m_epoll;
+        const int m_fd;
+        // Cleared when the description is destroyed, see description_destroyed().
+        FileDescription* m_description { nullptr };
+        u32 m_events { 0 };
+        epoll_data_t m_data {};
+        Thread::FileBlocker::BlockFlags m_block_flags { Thread::FileBlocker::BlockFlags::None };
+        // Set once an EPOLLONESHOT entry fired, until it gets re-armed by modify().
+        bool m_disarmed { false };
+        IntrusiveListNode<Entry, RefPtr<Entry>> m_ready_list_node;
+    };
+
+    EPoll();
+
+    void mark_ready(Entry&);
+    void add_entry(int fd, FileDescription&, const epoll_event&);
+    void remove_entry(Entry&);
+
+    Lock m_lock { "EPoll" };
+    HashMap<int, NonnullRefPtr<Entry>> m_entries;
+
+    mutable SpinLock<u8> m_ready_lock;
+    IntrusiveList<Entry, RefPtr<Entry>, &Entry::m_ready_list_node> m_ready_list;
+};
+
+}
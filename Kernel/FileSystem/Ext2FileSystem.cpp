@@ -22,6 +22,7 @@ namespace Kernel {
 static const size_t max_link_count = 65535;
 static const size_t max_block_size = 4096;
 static const ssize_t max_inline_symlink_length = 60;
+static const size_t max_goal_skip = 32;
 
 struct Ext2FSDirectoryEntry {
     String name;
@@ -404,7 +405,7 @@ KResult Ext2FSInode::flush_block_list()
 
     Vector<Ext2FS::BlockIndex> new_meta_blocks;
     if (new_shape.meta_blocks > old_shape.meta_blocks) {
-        auto blocks_or_error = fs().allocate_blocks(fs().group_index_from_inode(index()), new_shape.meta_blocks - old_shape.meta_blocks);
+        auto blocks_or_error = fs().allocate_blocks(fs().group_index_from_inode(index()), new_shape.meta_blocks - old_shape.meta_blocks, allocation_goal());
         if (blocks_or_error.is_error())
             return blocks_or_error.error();
         new_meta_blocks = blocks_or_error.release_value();
@@ -626,6 +627,178 @@ Vector<Ext2FS::BlockIndex> Ext2FSInode::compute_block_list_impl_internal(const e
     return list;
 }
 
+unsigned Ext2FSInode::data_block_count() const
+{
+    // See compute_block_list_impl_internal() for why inline symlinks have no blocks.
+    if (::is_symlink(m_raw_inode.i_mode) && m_raw_inode.i_blocks == 0)
+        return 0;
+    return ceil_div(size(), static_cast<u64>(fs().block_size()));
+}
+
+KResultOr<BlockBasedFS::BlockIndex> Ext2FSInode::block_at(size_t logical_index) const
+{
+    VERIFY(m_lock.is_locked());
+
+    if (!m_block_list.is_empty()) {
+        if (logical_index >= m_block_list.size())
+            return BlockBasedFS::BlockIndex {};
+        return m_block_list[logical_index];
+    }
+
+    if (logical_index >= data_block_count())
+        return BlockBasedFS::BlockIndex {};
+
+    auto find_extent = [&]() -> const BlockExtent* {
+        size_t low = 0;
+        size_t high = m_block_extents.size();
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            auto& extent = m_block_extents[middle];
+            if (logical_index < extent.logical_index)
+                high = middle;
+            else if (logical_index >= extent.logical_end())
+                low = middle + 1;
+            else
+                return &extent;
+        }
+        return nullptr;
+    };
+
+    auto* extent = find_extent();
+    if (!extent) {
+        if (auto result = map_block_array_containing(logical_index); result.is_error())
+            return result;
+        extent = find_extent();
+        VERIFY(extent);
+    }
+
+    if (extent->physical_index.value() == 0)
+        return BlockBasedFS::BlockIndex {};
+    return BlockBasedFS::BlockIndex { extent->physical_index.value() + (logical_index - extent->logical_index) };
+}
+
+KResult Ext2FSInode::collect_blocks(size_t first_logical_index, size_t count, Vector<BlockBasedFS::BlockIndex>& blocks) const
+{
+    blocks.ensure_capacity(blocks.size() + count);
+    for (size_t i = 0; i < count; ++i) {
+        auto block_or_error = block_at(first_logical_index + i);
+        if (block_or_error.is_error())
+            return block_or_error.error();
+        blocks.unchecked_append(block_or_error.value());
+    }
+    return KSuccess;
+}
+
+KResult Ext2FSInode::map_block_array_containing(size_t logical_index) const
+{
+    u64 entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
+    size_t block_count = data_block_count();
+    VERIFY(logical_index < block_count);
+
+    auto add_extents_for = [&](size_t first_logical_index, const u32* entries, size_t entry_count) {
+        entry_count = min(entry_count, block_count - first_logical_index);
+        for (size_t i = 0; i < entry_count;) {
+            size_t run = 1;
+            if (entries[i] == 0) {
+                while (i + run < entry_count && entries[i + run] == 0)
+                    ++run;
+            } else {
+                while (i + run < entry_count && entries[i + run] == entries[i] + run)
+                    ++run;
+            }
+            add_block_extent(first_logical_index + i, entries[i], run);
+            i += run;
+        }
+    };
+
+    if (logical_index < EXT2_NDIR_BLOCKS) {
+        add_extents_for(0, m_raw_inode.i_block, EXT2_NDIR_BLOCKS);
+        return KSuccess;
+    }
+
+    // Find out which tree the block is in, and how many levels of block pointer arrays it has.
+    u64 index = logical_index - EXT2_NDIR_BLOCKS;
+    size_t first_logical_index = EXT2_NDIR_BLOCKS;
+    u32 array_block = m_raw_inode.i_block[EXT2_IND_BLOCK];
+    u64 blocks_per_entry = 1;
+    if (index >= entries_per_block) {
+        index -= entries_per_block;
+        first_logical_index += entries_per_block;
+        array_block = m_raw_inode.i_block[EXT2_DIND_BLOCK];
+        blocks_per_entry = entries_per_block;
+        if (index >= entries_per_block * entries_per_block) {
+            index -= entries_per_block * entries_per_block;
+            first_logical_index += entries_per_block * entries_per_block;
+            array_block = m_raw_inode.i_block[EXT2_TIND_BLOCK];
+            blocks_per_entry = entries_per_block * entries_per_block;
+        }
+    }
+
+    // Walk down to the array that holds the pointers to the data blocks themselves.
+    // The upper levels only ever need the one entry we're following, and will usually be in the block cache.
+    for (; blocks_per_entry > 1; blocks_per_entry /= entries_per_block) {
+        auto slot = index / blocks_per_entry;
+        index %= blocks_per_entry;
+        first_logical_index += slot * blocks_per_entry;
+        if (array_block == 0)
+            continue;
+        u32 next_array_block = 0;
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer((u8*)&next_array_block);
+        if (auto result = fs().read_block(array_block, &buffer, sizeof(u32), slot * sizeof(u32)); result.is_error())
+            return result;
+        array_block = next_array_block;
+    }
+
+    // A missing block pointer array means that the whole range it would cover is a hole.
+    if (array_block == 0) {
+        add_block_extent(first_logical_index, 0, min((size_t)entries_per_block, block_count - first_logical_index));
+        return KSuccess;
+    }
+
+    auto array_storage = ByteBuffer::create_uninitialized(entries_per_block * sizeof(u32));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(array_storage.data());
+    if (auto result = fs().read_block(array_block, &buffer, array_storage.size(), 0); result.is_error())
+        return result;
+    add_extents_for(first_logical_index, (const u32*)array_storage.data(), entries_per_block);
+    return KSuccess;
+}
+
+void Ext2FSInode::add_block_extent(size_t logical_index, BlockBasedFS::BlockIndex physical_index, size_t count) const
+{
+    // The extents are kept sorted and never overlap, since a block pointer array is only mapped once.
+    size_t position = 0;
+    while (position < m_block_extents.size() && m_block_extents[position].logical_index < logical_index)
+        ++position;
+
+    auto continues = [](const BlockExtent& extent, size_t logical_index, BlockBasedFS::BlockIndex physical_index) {
+        if (extent.logical_end() != logical_index)
+            return false;
+        if (extent.physical_index.value() == 0)
+            return physical_index.value() == 0;
+        return physical_index.value() == extent.physical_index.value() + extent.count;
+    };
+
+    if (position > 0 && continues(m_block_extents[position - 1], logical_index, physical_index)) {
+        auto& previous = m_block_extents[position - 1];
+        previous.count += count;
+        if (position < m_block_extents.size() && continues(previous, m_block_extents[position].logical_index, m_block_extents[position].physical_index)) {
+            previous.count += m_block_extents[position].count;
+            m_block_extents.remove(position);
+        }
+        return;
+    }
+
+    BlockExtent extent { logical_index, physical_index, count };
+    if (position < m_block_extents.size() && continues(extent, m_block_extents[position].logical_index, m_block_extents[position].physical_index)) {
+        auto& next = m_block_extents[position];
+        next.logical_index = logical_index;
+        next.physical_index = physical_index;
+        next.count += count;
+        return;
+    }
+    m_block_extents.insert(position, extent);
+}
+
 void Ext2FS::free_inode(Ext2FSInode& inode)
 {
     LOCKER(m_lock);
@@ -670,7 +843,7 @@ void Ext2FS::flush_block_group_descriptor_table()
         dbgln("Ext2FS[{}]::flush_block_group_descriptor_table(): Failed to write blocks: {}", fsid(), result.error());
 }
 
-void Ext2FS::flush_writes()
+void Ext2FS::flush_metadata()
 {
     LOCKER(m_lock);
     if (m_super_block_dirty) {
@@ -685,15 +858,17 @@ void Ext2FS::flush_writes()
         if (cached_bitmap->dirty) {
             auto buffer = UserOrKernelBuffer::for_kernel_buffer(cached_bitmap->buffer.data());
             if (auto result = write_block(cached_bitmap->bitmap_block_index, buffer, block_size()); result.is_error()) {
-                dbgln("Ext2FS[{}]::flush_writes(): Failed to write blocks: {}", fsid(), result.error());
+                dbgln("Ext2FS[{}]::flush_metadata(): Failed to write blocks: {}", fsid(), result.error());
             }
             cached_bitmap->dirty = false;
-            dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::flush_writes(): Flushed bitmap block {}", fsid(), cached_bitmap->bitmap_block_index);
+            dbgln_if(EXT2_DEBUG, "Ext2FS[{}]::flush_metadata(): Flushed bitmap block {}", fsid(), cached_bitmap->bitmap_block_index);
         }
     }
+}
 
-    BlockBasedFS::flush_writes();
-
+void Ext2FS::uncache_unused_inodes()
+{
+    LOCKER(m_lock);
     // Uncache Inodes that are only kept alive by the index-to-inode lookup cache.
     // We don't uncache Inodes that are being watched by at least one InodeWatcher.
 
@@ -712,6 +887,20 @@ void Ext2FS::flush_writes()
         uncache_inode(index);
 }
 
+void Ext2FS::flush_writes()
+{
+    flush_metadata();
+    BlockBasedFS::flush_writes();
+    uncache_unused_inodes();
+}
+
+void Ext2FS::writeback()
+{
+    flush_metadata();
+    BlockBasedFS::writeback();
+    uncache_unused_inodes();
+}
+
 Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
     : Inode(fs, index)
 {
@@ -827,10 +1016,8 @@ ssize_t Ext2FSInode::read_bytes(off_t offset, ssize_t count, UserOrKernelBuffer&
         return nread;
     }
 
-    if (m_block_list.is_empty())
-        m_block_list = compute_block_list();
-
-    if (m_block_list.is_empty()) {
+    size_t block_count = m_block_list.is_empty() ? data_block_count() : m_block_list.size();
+    if (block_count == 0) {
         dmesgln("Ext2FSInode[{}]::read_bytes(): Empty block list", identifier());
         return -EIO;
     }
@@ -839,10 +1026,10 @@ ssize_t Ext2FSInode::read_bytes(off_t offset, ssize_t count, UserOrKernelBuffer&
 
     const int block_size = fs().block_size();
 
-    BlockBasedFS::BlockIndex first_block_logical_index = offset / block_size;
-    BlockBasedFS::BlockIndex last_block_logical_index = (offset + count) / block_size;
-    if (last_block_logical_index >= m_block_list.size())
-        last_block_logical_index = m_block_list.size() - 1;
+    size_t first_block_logical_index = offset / block_size;
+    size_t last_block_logical_index = (offset + count) / block_size;
+    if (last_block_logical_index >= block_count)
+        last_block_logical_index = block_count - 1;
 
     int offset_into_first_block = offset % block_size;
 
@@ -851,8 +1038,16 @@ ssize_t Ext2FSInode::read_bytes(off_t offset, ssize_t count, UserOrKernelBuffer&
 
     dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_bytes(): Reading up to {} bytes, {} bytes into inode to {}", identifier(), count, offset, buffer.user_or_kernel_ptr());
 
-    for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; bi = bi.value() + 1) {
-        auto block_index = m_block_list[bi.value()];
+    Vector<BlockBasedFS::BlockIndex> blocks;
+    if (auto result = collect_blocks(first_block_logical_index, last_block_logical_index - first_block_logical_index + 1, blocks); result.is_error())
+        return result;
+
+    // Bring all the blocks into the cache up front, so that runs of contiguous blocks are read with a single request.
+    if (allow_cache && last_block_logical_index > first_block_logical_index)
+        fs().prefetch_blocks(blocks.span());
+
+    for (auto bi = first_block_logical_index; remaining_count && bi <= last_block_logical_index; ++bi) {
+        auto block_index = blocks[bi - first_block_logical_index];
         size_t offset_into_block = (bi == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((off_t)block_size - offset_into_block, remaining_count);
         auto buffer_offset = buffer.offset(nread);
@@ -873,6 +1068,37 @@ ssize_t Ext2FSInode::read_bytes(off_t offset, ssize_t count, UserOrKernelBuffer&
     return nread;
 }
 
+BlockBasedFS::BlockIndex Ext2FSInode::allocation_goal() const
+{
+    // Aim for the block right after the last one we have, so the file stays contiguous on disk.
+    for (size_t i = m_block_list.size(); i > 0; --i) {
+        if (m_block_list[i - 1].value())
+            return m_block_list[i - 1].value() + 1;
+    }
+    return 0;
+}
+
+void Ext2FSInode::read_ahead(u64 offset, size_t count) const
+{
+    Locker inode_locker(m_lock);
+    if (is_symlink() || offset >= size())
+        return;
+
+    size_t block_count = m_block_list.is_empty() ? data_block_count() : m_block_list.size();
+    size_t block_size = fs().block_size();
+    size_t first_block_logical_index = offset / block_size;
+    size_t end_block_logical_index = min(ceil_div(min(offset + count, size()), (u64)block_size), (u64)block_count);
+    if (first_block_logical_index >= end_block_logical_index)
+        return;
+
+    Vector<BlockBasedFS::BlockIndex> blocks;
+    if (collect_blocks(first_block_logical_index, end_block_logical_index - first_block_logical_index, blocks).is_error())
+        return;
+
+    dbgln_if(EXT2_VERY_DEBUG, "Ext2FSInode[{}]::read_ahead(): Blocks {}-{}", identifier(), first_block_logical_index, end_block_logical_index);
+    fs().prefetch_blocks(blocks.span());
+}
+
 KResult Ext2FSInode::resize(u64 new_size)
 {
     auto old_size = size();
@@ -897,11 +1123,13 @@ KResult Ext2FSInode::resize(u64 new_size)
             return ENOSPC;
     }
 
-    if (m_block_list.is_empty())
+    if (m_block_list.is_empty()) {
         m_block_list = this->compute_block_list();
+        m_block_extents.clear();
+    }
 
     if (blocks_needed_after > blocks_needed_before) {
-        auto blocks_or_error = fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before);
+        auto blocks_or_error = fs().allocate_blocks(fs().group_index_from_inode(index()), blocks_needed_after - blocks_needed_before, allocation_goal());
         if (blocks_or_error.is_error())
             return blocks_or_error.error();
         m_block_list.append(blocks_or_error.release_value());
@@ -982,8 +1210,10 @@ ssize_t Ext2FSInode::write_bytes(off_t offset, ssize_t count, const UserOrKernel
     if (auto result = resize(new_size); result.is_error())
         return result;
 
-    if (m_block_list.is_empty())
+    if (m_block_list.is_empty()) {
         m_block_list = compute_block_list();
+        m_block_extents.clear();
+    }
 
     if (m_block_list.is_empty()) {
         dbgln("Ext2FSInode[{}]::write_bytes(): Empty block list", identifier());
@@ -1167,7 +1397,7 @@ KResult Ext2FSInode::add_child(Inode& child, const StringView& name, mode_t mode
         return result;
 
     m_lookup_cache.set(name, child.index());
-    did_add_child(child.identifier());
+    did_add_child(child.identifier(), name);
     return KSuccess;
 }
 
@@ -1198,14 +1428,10 @@ KResult Ext2FSInode::remove_child(const StringView& name)
         return result;
 
     m_lookup_cache.remove(name);
+    did_remove_child(child_id, name);
 
     auto child_inode = fs().get_inode(child_id);
-    result = child_inode->decrement_link_count();
-    if (result.is_error())
-        return result;
-
-    did_remove_child(child_id);
-    return KSuccess;
+    return child_inode->decrement_link_count();
 }
 
 unsigned Ext2FS::inodes_per_block() const
@@ -1237,10 +1463,10 @@ bool Ext2FS::write_ext2_inode(InodeIndex inode, const ext2_inode& e2inode)
     return write_block(block_index, buffer, inode_size(), offset) >= 0;
 }
 
-auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) -> KResultOr<Vector<BlockIndex>>
+auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal) -> KResultOr<Vector<BlockIndex>>
 {
     LOCKER(m_lock);
-    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {})", preferred_group_index, count);
+    dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks(preferred group: {}, count {}, goal {})", preferred_group_index, count, goal);
     if (count == 0)
         return Vector<BlockIndex> {};
 
@@ -1248,6 +1474,32 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
     dbgln_if(EXT2_DEBUG, "Ext2FS: allocate_blocks:");
     blocks.ensure_capacity(count);
 
+    // First try to continue right where the caller left off, so that files grow contiguously.
+    if (goal.value() && goal.value() < super_block().s_blocks_count) {
+        auto goal_group_index = group_index_from_block_index(goal);
+        if (goal_group_index.value() >= 1 && goal_group_index.value() <= m_block_group_count && group_descriptor(goal_group_index).bg_free_blocks_count) {
+            auto cached_bitmap_or_error = get_bitmap_block(group_descriptor(goal_group_index).bg_block_bitmap);
+            if (cached_bitmap_or_error.is_error())
+                return cached_bitmap_or_error.error();
+            size_t blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+            auto block_bitmap = cached_bitmap_or_error.value()->bitmap(blocks_in_group);
+            u64 first_block_in_group = (goal_group_index.value() - 1) * blocks_per_group() + first_block_index().value();
+            // NOTE: If the goal itself is taken (e.g by an indirect block), look a little further ahead.
+            auto bit = goal.value() - first_block_in_group;
+            for (size_t skipped = 0; bit < blocks_in_group && block_bitmap.get(bit) && skipped < max_goal_skip; ++skipped)
+                ++bit;
+            for (; blocks.size() < count && bit < blocks_in_group && !block_bitmap.get(bit); ++bit) {
+                BlockIndex block_index = first_block_in_group + bit;
+                if (auto result = set_block_allocation_state(block_index, true); result.is_error()) {
+                    dbgln("Ext2FS: Failed to allocate block {} in allocate_blocks()", block_index);
+                    return result;
+                }
+                blocks.unchecked_append(block_index);
+            }
+            dbgln_if(EXT2_DEBUG, "Ext2FS: allocated {} blocks at goal {}", blocks.size(), goal);
+        }
+    }
+
     auto group_index = preferred_group_index;
 
     if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
@@ -1689,13 +1941,13 @@ KResultOr<int> Ext2FSInode::get_block_address(int index)
 {
     LOCKER(m_lock);
 
-    if (m_block_list.is_empty())
-        m_block_list = compute_block_list();
-
-    if (index < 0 || (size_t)index >= m_block_list.size())
+    if (index < 0)
         return 0;
 
-    return m_block_list[index].value();
+    auto block_or_error = block_at(index);
+    if (block_or_error.is_error())
+        return block_or_error.error();
+    return block_or_error.value().value();
 }
 
 unsigned Ext2FS::total_block_count() const
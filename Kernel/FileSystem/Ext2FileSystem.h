@@ -39,6 +39,7 @@ public:
 private:
     // ^Inode
     virtual ssize_t read_bytes(off_t, ssize_t, UserOrKernelBuffer& buffer, FileDescription*) const override;
+    virtual void read_ahead(u64, size_t) const override;
     virtual InodeMetadata metadata() const override;
     virtual KResult traverse_as_directory(Function<bool(const FS::DirectoryEntryView&)>) const override;
     virtual RefPtr<Inode> lookup(StringView name) override;
@@ -68,15 +69,35 @@ private:
     KResult shrink_triply_indirect_block(BlockBasedFS::BlockIndex, size_t, size_t, unsigned&);
     KResult flush_block_list();
     Vector<BlockBasedFS::BlockIndex> compute_block_list() const;
+    BlockBasedFS::BlockIndex allocation_goal() const;
     Vector<BlockBasedFS::BlockIndex> compute_block_list_with_meta_blocks() const;
     Vector<BlockBasedFS::BlockIndex> compute_block_list_impl(bool include_block_list_blocks) const;
     Vector<BlockBasedFS::BlockIndex> compute_block_list_impl_internal(const ext2_inode& e2inode, bool include_block_list_blocks) const;
+    unsigned data_block_count() const;
+    KResultOr<BlockBasedFS::BlockIndex> block_at(size_t logical_index) const;
+    KResult collect_blocks(size_t first_logical_index, size_t count, Vector<BlockBasedFS::BlockIndex>&) const;
+    KResult map_block_array_containing(size_t logical_index) const;
+    void add_block_extent(size_t logical_index, BlockBasedFS::BlockIndex, size_t count) const;
 
     Ext2FS& fs();
     const Ext2FS& fs() const;
     Ext2FSInode(Ext2FS&, InodeIndex);
 
+    // A run of logically consecutive blocks that are also consecutive on disk,
+    // or a hole if physical_index is 0.
+    struct BlockExtent {
+        size_t logical_index { 0 };
+        BlockBasedFS::BlockIndex physical_index;
+        size_t count { 0 };
+
+        size_t logical_end() const { return logical_index + count; }
+    };
+
+    // The block list is only expanded in full once we have to modify it. Until then,
+    // reads resolve blocks through m_block_extents, which is filled in one block
+    // pointer array at a time, as the parts of the file are first accessed.
     mutable Vector<BlockBasedFS::BlockIndex> m_block_list;
+    mutable Vector<BlockExtent> m_block_extents;
     mutable HashMap<String, InodeIndex> m_lookup_cache;
     ext2_inode m_raw_inode;
 };
@@ -103,6 +124,7 @@ public:
     virtual KResult prepare_to_unmount() const override;
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_directory_entry_cache() const override { return true; }
 
     virtual u8 internal_file_type_to_directory_entry_type(const DirectoryEntryView& entry) const override;
 
@@ -134,10 +156,13 @@ private:
     KResultOr<NonnullRefPtr<Inode>> create_inode(Ext2FSInode& parent_inode, const String& name, mode_t, dev_t, uid_t, gid_t);
     KResult create_directory(Ext2FSInode& parent_inode, const String& name, mode_t, uid_t, gid_t);
     virtual void flush_writes() override;
+    virtual void writeback() override;
+    void flush_metadata();
+    void uncache_unused_inodes();
 
     BlockIndex first_block_index() const;
     KResultOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
-    KResultOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+    KResultOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count, BlockIndex goal = 0);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
 
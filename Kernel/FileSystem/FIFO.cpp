@@ -13,6 +13,7 @@
 #include <Kernel/Lock.h>
 #include <Kernel/Process.h>
 #include <Kernel/Thread.h>
+#include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
 
@@ -90,6 +91,15 @@ FIFO::~FIFO()
     all_fifos().resource().remove(this);
 }
 
+KResult FIFO::set_buffer_capacity(size_t capacity)
+{
+    if (capacity > max_buffer_capacity)
+        return EINVAL;
+    if (capacity > max_unprivileged_buffer_capacity && !Process::current()->is_superuser())
+        return EPERM;
+    return m_buffer.try_resize(max<size_t>(page_round_up(capacity), PAGE_SIZE));
+}
+
 void FIFO::attach(Direction direction)
 {
     if (direction == Direction::Reader) {
@@ -32,6 +32,10 @@ public:
     KResultOr<NonnullRefPtr<FileDescription>> open_direction(Direction);
     KResultOr<NonnullRefPtr<FileDescription>> open_direction_blocking(Direction);
 
+    // The capacity is rounded up to whole pages. Unprivileged users can't go beyond max_unprivileged_buffer_capacity.
+    size_t buffer_capacity() const { return m_buffer.capacity(); }
+    KResult set_buffer_capacity(size_t);
+
     void attach(Direction);
     void detach(Direction);
 
@@ -48,6 +52,9 @@ private:
 
     explicit FIFO(uid_t);
 
+    static constexpr size_t max_unprivileged_buffer_capacity = 1 * MiB;
+    static constexpr size_t max_buffer_capacity = 16 * MiB;
+
     unsigned m_writers { 0 };
     unsigned m_readers { 0 };
     DoubleBuffer m_buffer;
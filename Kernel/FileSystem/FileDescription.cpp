@@ -9,6 +9,7 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/CharacterDevice.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/FileSystem.h>
@@ -57,6 +58,8 @@ FileDescription::FileDescription(File& file)
 
 FileDescription::~FileDescription()
 {
+    if (m_has_epoll_entries)
+        EPoll::description_destroyed({}, *this);
     m_file->detach(*this);
     if (is_fifo())
         static_cast<FIFO*>(m_file.ptr())->detach(m_fifo_direction);
@@ -12,6 +12,7 @@
 #include <Kernel/FileSystem/FIFO.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/ReadaheadState.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/VirtualAddress.h>
@@ -111,6 +112,8 @@ public:
 
     void set_original_inode(Badge<VFS>, NonnullRefPtr<Inode>&& inode) { m_inode = move(inode); }
 
+    void set_has_epoll_entries(Badge<EPoll>) { m_has_epoll_entries = true; }
+
     KResult truncate(u64);
 
     off_t offset() const { return m_current_offset; }
@@ -119,6 +122,8 @@ public:
 
     FileBlockCondition& block_condition();
 
+    ReadaheadState& readahead_state() { return m_readahead_state; }
+
 private:
     friend class VFS;
     explicit FileDescription(File&);
@@ -136,6 +141,8 @@ private:
 
     off_t m_current_offset { 0 };
 
+    ReadaheadState m_readahead_state;
+
     OwnPtr<FileDescriptionData> m_data;
 
     u32 m_file_flags { 0 };
@@ -146,6 +153,8 @@ private:
     bool m_is_directory : 1 { false };
     bool m_should_append : 1 { false };
     bool m_direct : 1 { false };
+    // Not a bitfield, since EPoll sets it without holding m_lock.
+    bool m_has_epoll_entries { false };
     FIFO::Direction m_fifo_direction { FIFO::Direction::Neither };
 
     Lock m_lock { "FileDescription" };
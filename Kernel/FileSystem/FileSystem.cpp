@@ -66,6 +66,21 @@ void FS::sync()
         fs.flush_writes();
 }
 
+void FS::writeback_all()
+{
+    Inode::sync();
+
+    NonnullRefPtrVector<FS, 32> fses;
+    {
+        InterruptDisabler disabler;
+        for (auto& it : all_fses())
+            fses.append(*it.value);
+    }
+
+    for (auto& fs : fses)
+        fs.writeback();
+}
+
 void FS::lock_all()
 {
     for (auto& it : all_fses()) {
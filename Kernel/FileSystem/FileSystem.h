@@ -34,12 +34,14 @@ public:
     unsigned fsid() const { return m_fsid; }
     static FS* from_fsid(u32);
     static void sync();
+    static void writeback_all();
     static void lock_all();
 
     virtual bool initialize() = 0;
     virtual const char* class_name() const = 0;
     virtual NonnullRefPtr<Inode> root_inode() const = 0;
     virtual bool supports_watchers() const { return false; }
+    virtual bool supports_directory_entry_cache() const { return false; }
 
     bool is_readonly() const { return m_readonly; }
 
@@ -60,9 +62,14 @@ public:
 
     virtual void flush_writes() { }
 
+    // Called periodically by the SyncTask. Unlike flush_writes(), this may leave
+    // recently written data in memory for a while longer.
+    virtual void writeback() { flush_writes(); }
+
     size_t block_size() const { return m_block_size; }
 
     virtual bool is_file_backed() const { return false; }
+    virtual bool is_block_based() const { return false; }
 
     // Converts file types that are used internally by the filesystem to DT_* types
     virtual u8 internal_file_type_to_directory_entry_type(const DirectoryEntryView& entry) const { return entry.file_type; }
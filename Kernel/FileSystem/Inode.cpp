@@ -10,6 +10,7 @@
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
@@ -210,24 +211,28 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
         // FIXME: Maybe we should hook into modification events somewhere else, I'm not sure where.
         //        We don't always end up on this particular code path, for instance when writing to an ext2fs file.
         for (auto& watcher : m_watchers) {
-            watcher->notify_inode_event({}, InodeWatcherEvent::Type::Modified);
+            watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::Modified);
         }
     }
 }
 
-void Inode::did_add_child(const InodeIdentifier& child_id)
+void Inode::did_add_child(const InodeIdentifier& child_id, const StringView& name)
 {
+    if (fs().supports_directory_entry_cache())
+        DirectoryEntryCache::the().invalidate(*this, name);
     LOCKER(m_lock);
     for (auto& watcher : m_watchers) {
-        watcher->notify_child_added({}, child_id);
+        watcher->notify_child_added({}, identifier(), child_id);
     }
 }
 
-void Inode::did_remove_child(const InodeIdentifier& child_id)
+void Inode::did_remove_child(const InodeIdentifier& child_id, const StringView& name)
 {
+    if (fs().supports_directory_entry_cache())
+        DirectoryEntryCache::the().invalidate(*this, name);
     LOCKER(m_lock);
     for (auto& watcher : m_watchers) {
-        watcher->notify_child_removed({}, child_id);
+        watcher->notify_child_removed({}, identifier(), child_id);
     }
 }
 
@@ -53,6 +53,8 @@ public:
     virtual void detach(FileDescription&) { }
     virtual void did_seek(FileDescription&, off_t) { }
     virtual ssize_t read_bytes(off_t, ssize_t, UserOrKernelBuffer& buffer, FileDescription*) const = 0;
+    // A hint that the given range is about to be read, so the file system may start bringing it into memory.
+    virtual void read_ahead(u64, size_t) const { }
     virtual KResult traverse_as_directory(Function<bool(const FS::DirectoryEntryView&)>) const = 0;
     virtual RefPtr<Inode> lookup(StringView name) = 0;
     virtual ssize_t write_bytes(off_t, ssize_t, const UserOrKernelBuffer& data, FileDescription*) = 0;
@@ -66,6 +68,9 @@ public:
     virtual KResultOr<NonnullRefPtr<Custody>> resolve_as_link(Custody& base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level) const;
 
     virtual KResultOr<int> get_block_address(int) { return ENOTSUP; }
+    // Filesystems that keep file contents in memory can hand out the page that holds them,
+    // so that shared mappings of the file use it directly instead of a copy.
+    virtual RefPtr<PhysicalPage> page_for_shared_mapping(size_t) { return {}; }
 
     LocalSocket* socket() { return m_socket.ptr(); }
     const LocalSocket* socket() const { return m_socket.ptr(); }
@@ -111,8 +116,8 @@ protected:
     void set_metadata_dirty(bool);
     KResult prepare_to_write_data();
 
-    void did_add_child(const InodeIdentifier&);
-    void did_remove_child(const InodeIdentifier&);
+    void did_add_child(const InodeIdentifier& child_id, const StringView& name);
+    void did_remove_child(const InodeIdentifier& child_id, const StringView& name);
 
     mutable Lock m_lock { "Inode" };
 
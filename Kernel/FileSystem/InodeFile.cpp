@@ -31,6 +31,11 @@ KResultOr<size_t> InodeFile::read(FileDescription& description, u64 offset, User
     if (Checked<off_t>::addition_would_overflow(offset, count))
         return EOVERFLOW;
 
+    if (!description.is_direct()) {
+        if (auto request = description.readahead_state().will_read(offset, count); request.has_value())
+            m_inode->read_ahead(request->offset, request->size);
+    }
+
     ssize_t nread = m_inode->read_bytes(offset, count, buffer, &description);
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
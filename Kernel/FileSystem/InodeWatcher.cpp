@@ -10,26 +10,79 @@
 
 namespace Kernel {
 
-NonnullRefPtr<InodeWatcher> InodeWatcher::create(Inode& inode)
+KResultOr<NonnullRefPtr<InodeWatcher>> InodeWatcher::create(Inode& inode)
 {
-    return adopt_ref(*new InodeWatcher(inode));
+    auto watcher = adopt_ref(*new InodeWatcher);
+    auto watch_descriptor = watcher->add_watch(inode);
+    if (watch_descriptor.is_error())
+        return watch_descriptor.error();
+    return watcher;
 }
 
-InodeWatcher::InodeWatcher(Inode& inode)
-    : m_inode(inode)
+InodeWatcher::~InodeWatcher()
+{
+    for (auto& it : m_watches) {
+        if (auto inode = it.value.inode.strong_ref())
+            inode->unregister_watcher({}, *this);
+    }
+}
+
+KResultOr<int> InodeWatcher::add_watch(Inode& inode)
 {
+    int watch_descriptor;
+    {
+        LOCKER(m_lock);
+        if (auto existing_watch_descriptor = m_watch_descriptors.get(inode.identifier()); existing_watch_descriptor.has_value()) {
+            auto& watch = m_watches.find(existing_watch_descriptor.value())->value;
+            if (watch.inode.unsafe_ptr() == &inode)
+                return existing_watch_descriptor.value();
+            // The inode that was watched under this identifier has gone away, so its watch is dead.
+            m_watches.remove(existing_watch_descriptor.value());
+            m_watch_descriptors.remove(inode.identifier());
+        }
+        if (m_watches.size() >= max_watches)
+            return ENOSPC;
+        watch_descriptor = m_next_watch_descriptor++;
+        m_watches.set(watch_descriptor, { inode.identifier(), inode, false });
+        m_watch_descriptors.set(inode.identifier(), watch_descriptor);
+    }
+    // The inode calls back into us with its own lock held, so we must not hold ours while registering.
     inode.register_watcher({}, *this);
+    return watch_descriptor;
 }
 
-InodeWatcher::~InodeWatcher()
+KResult InodeWatcher::remove_watch(int watch_descriptor)
 {
-    if (auto inode = m_inode.strong_ref())
+    RefPtr<Inode> inode;
+    {
+        LOCKER(m_lock);
+        auto it = m_watches.find(watch_descriptor);
+        if (it == m_watches.end())
+            return EINVAL;
+        inode = it->value.inode.strong_ref();
+        m_watch_descriptors.remove(it->value.inode_id);
+        m_watches.remove(it);
+    }
+    if (inode)
         inode->unregister_watcher({}, *this);
+    evaluate_block_conditions();
+    return KSuccess;
+}
+
+bool InodeWatcher::has_only_dead_watches() const
+{
+    if (m_watches.is_empty())
+        return false;
+    for (auto& it : m_watches) {
+        if (it.value.inode)
+            return false;
+    }
+    return true;
 }
 
 bool InodeWatcher::can_read(const FileDescription&, size_t) const
 {
-    return !m_queue.is_empty() || !m_inode;
+    return !m_queue.is_empty() || has_only_dead_watches();
 }
 
 bool InodeWatcher::can_write(const FileDescription&, size_t) const
@@ -40,24 +93,28 @@ bool InodeWatcher::can_write(const FileDescription&, size_t) const
 KResultOr<size_t> InodeWatcher::read(FileDescription&, u64, UserOrKernelBuffer& buffer, size_t buffer_size)
 {
     LOCKER(m_lock);
-    VERIFY(!m_queue.is_empty() || !m_inode);
-
-    if (!m_inode)
+    if (m_queue.is_empty())
         return 0;
 
-    auto event = m_queue.dequeue();
-
-    if (buffer_size < sizeof(InodeWatcherEvent))
-        return buffer_size;
-
-    size_t bytes_to_write = min(buffer_size, sizeof(event));
-
-    ssize_t nwritten = buffer.write_buffered<sizeof(event)>(bytes_to_write, [&](u8* data, size_t data_bytes) {
-        memcpy(data, &event, bytes_to_write);
-        return (ssize_t)data_bytes;
-    });
-    if (nwritten < 0)
-        return KResult((ErrnoCode)-nwritten);
+    // Hand out as many whole events as fit, so a burst can be picked up with a single read.
+    size_t event_count = min(buffer_size / sizeof(InodeWatcherEvent), m_queue.size());
+    if (!event_count)
+        return EINVAL;
+
+    Vector<InodeWatcherEvent, 32> events;
+    events.ensure_capacity(event_count);
+    for (size_t i = 0; i < event_count; ++i) {
+        auto event = m_queue.dequeue();
+        if (event.type == InodeWatcherEvent::Type::Modified) {
+            if (auto it = m_watches.find(event.watch_descriptor); it != m_watches.end())
+                it->value.has_queued_modified_event = false;
+        }
+        events.unchecked_append(event);
+    }
+
+    size_t bytes_to_write = event_count * sizeof(InodeWatcherEvent);
+    if (!buffer.write(events.data(), bytes_to_write))
+        return EFAULT;
     evaluate_block_conditions();
     return bytes_to_write;
 }
@@ -69,30 +126,50 @@ KResultOr<size_t> InodeWatcher::write(FileDescription&, u64, const UserOrKernelB
 
 String InodeWatcher::absolute_path(const FileDescription&) const
 {
-    if (auto inode = m_inode.strong_ref())
-        return String::formatted("InodeWatcher:{}", inode->identifier().to_string());
-    return "InodeWatcher:(gone)";
+    if (m_watches.size() == 1) {
+        auto& watch = m_watches.begin()->value;
+        if (watch.inode)
+            return String::formatted("InodeWatcher:{}", watch.inode_id.to_string());
+        return "InodeWatcher:(gone)";
+    }
+    return String::formatted("InodeWatcher:({} watches)", m_watches.size());
 }
 
-void InodeWatcher::notify_inode_event(Badge<Inode>, InodeWatcherEvent::Type event_type)
+bool InodeWatcher::enqueue(const InodeWatcherEvent& event)
 {
-    LOCKER(m_lock);
-    m_queue.enqueue({ event_type });
+    VERIFY(m_lock.is_locked());
+    if (m_queue.size() >= max_queued_events)
+        return false;
+    m_queue.enqueue(event);
     evaluate_block_conditions();
+    return true;
 }
 
-void InodeWatcher::notify_child_added(Badge<Inode>, const InodeIdentifier& child_id)
+void InodeWatcher::notify_inode_event(Badge<Inode>, const InodeIdentifier& inode_id, InodeWatcherEvent::Type event_type)
 {
     LOCKER(m_lock);
-    m_queue.enqueue({ InodeWatcherEvent::Type::ChildAdded, child_id.index().value() });
-    evaluate_block_conditions();
+    auto watch_descriptor = m_watch_descriptors.get(inode_id);
+    if (!watch_descriptor.has_value())
+        return;
+    auto& watch = m_watches.find(watch_descriptor.value())->value;
+    if (event_type == InodeWatcherEvent::Type::Modified && watch.has_queued_modified_event)
+        return;
+    if (enqueue({ event_type, 0, watch_descriptor.value() }) && event_type == InodeWatcherEvent::Type::Modified)
+        watch.has_queued_modified_event = true;
 }
 
-void InodeWatcher::notify_child_removed(Badge<Inode>, const InodeIdentifier& child_id)
+void InodeWatcher::notify_child_added(Badge<Inode>, const InodeIdentifier& inode_id, const InodeIdentifier& child_id)
 {
     LOCKER(m_lock);
-    m_queue.enqueue({ InodeWatcherEvent::Type::ChildRemoved, child_id.index().value() });
-    evaluate_block_conditions();
+    if (auto watch_descriptor = m_watch_descriptors.get(inode_id); watch_descriptor.has_value())
+        enqueue({ InodeWatcherEvent::Type::ChildAdded, child_id.index().value(), watch_descriptor.value() });
+}
+
+void InodeWatcher::notify_child_removed(Badge<Inode>, const InodeIdentifier& inode_id, const InodeIdentifier& child_id)
+{
+    LOCKER(m_lock);
+    if (auto watch_descriptor = m_watch_descriptors.get(inode_id); watch_descriptor.has_value())
+        enqueue({ InodeWatcherEvent::Type::ChildRemoved, child_id.index().value(), watch_descriptor.value() });
 }
 
 }
@@ -7,10 +7,12 @@
 #pragma once
 
 #include <AK/Badge.h>
-#include <AK/CircularQueue.h>
+#include <AK/HashMap.h>
+#include <AK/Queue.h>
 #include <AK/WeakPtr.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/File.h>
+#include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/Lock.h>
 
 namespace Kernel {
@@ -19,7 +21,7 @@ class Inode;
 
 class InodeWatcher final : public File {
 public:
-    static NonnullRefPtr<InodeWatcher> create(Inode&);
+    static KResultOr<NonnullRefPtr<InodeWatcher>> create(Inode&);
     virtual ~InodeWatcher() override;
 
     virtual bool can_read(const FileDescription&, size_t) const override;
@@ -28,17 +30,38 @@ public:
     virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override;
     virtual String absolute_path(const FileDescription&) const override;
     virtual const char* class_name() const override { return "InodeWatcher"; };
+    virtual bool is_inode_watcher() const override { return true; }
 
-    void notify_inode_event(Badge<Inode>, InodeWatcherEvent::Type);
-    void notify_child_added(Badge<Inode>, const InodeIdentifier& child_id);
-    void notify_child_removed(Badge<Inode>, const InodeIdentifier& child_id);
+    // Watching an inode that is already being watched gives back its existing watch descriptor.
+    KResultOr<int> add_watch(Inode&);
+    KResult remove_watch(int watch_descriptor);
+
+    void notify_inode_event(Badge<Inode>, const InodeIdentifier&, InodeWatcherEvent::Type);
+    void notify_child_added(Badge<Inode>, const InodeIdentifier&, const InodeIdentifier& child_id);
+    void notify_child_removed(Badge<Inode>, const InodeIdentifier&, const InodeIdentifier& child_id);
 
 private:
-    explicit InodeWatcher(Inode&);
+    InodeWatcher() = default;
+
+    struct Watch {
+        InodeIdentifier inode_id;
+        WeakPtr<Inode> inode;
+        // Modifications are coalesced, so there's at most one Modified event queued per watch.
+        bool has_queued_modified_event { false };
+    };
+
+    bool enqueue(const InodeWatcherEvent&);
+    bool has_only_dead_watches() const;
+
+    static constexpr size_t max_watches = 8192;
+    // Events that don't fit are dropped, instead of pushing out ones that haven't been read yet.
+    static constexpr size_t max_queued_events = 1024;
 
     Lock m_lock;
-    WeakPtr<Inode> m_inode;
-    CircularQueue<InodeWatcherEvent, 32> m_queue;
+    HashMap<int, Watch> m_watches;
+    HashMap<InodeIdentifier, int> m_watch_descriptors;
+    int m_next_watch_descriptor { 1 };
+    Queue<InodeWatcherEvent, 64> m_queue;
 };
 
 }
@@ -9,6 +9,7 @@
 #include <AK/JsonObjectSerializer.h>
 #include <AK/JsonValue.h>
 #include <AK/ScopeGuard.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <Kernel/Arch/x86/CPU.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
 #include <Kernel/CommandLine.h>
@@ -17,6 +18,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/HID/HIDManagement.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileDescription.h>
@@ -27,6 +29,7 @@
 #include <Kernel/Interrupts/InterruptManagement.h>
 #include <Kernel/KBufferBuilder.h>
 #include <Kernel/KSyms.h>
+#include <Kernel/KTrace.h>
 #include <Kernel/Module.h>
 #include <Kernel/Net/LocalSocket.h>
 #include <Kernel/Net/NetworkAdapter.h>
@@ -38,9 +41,11 @@
 #include <Kernel/Process.h>
 #include <Kernel/Scheduler.h>
 #include <Kernel/StdLib.h>
+#include <Kernel/Storage/StorageManagement.h>
 #include <Kernel/TTY/TTY.h>
 #include <Kernel/UBSanitizer.h>
 #include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/VM/CompressedPage.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <LibC/errno_numbers.h>
 
@@ -51,6 +56,7 @@ enum ProcParentDirectory {
     PDI_Root,
     PDI_Root_sys,
     PDI_Root_net,
+    PDI_Root_fs,
     PDI_PID,
     PDI_PID_fd,
     PDI_PID_stacks,
@@ -65,6 +71,7 @@ enum ProcFileType {
     __FI_Root_Start,
     FI_Root_df,
     FI_Root_all,
+    FI_Root_processes,
     FI_Root_memstat,
     FI_Root_cpuinfo,
     FI_Root_dmesg,
@@ -78,9 +85,13 @@ enum ProcFileType {
     FI_Root_cmdline,
     FI_Root_modules,
     FI_Root_profile,
+    FI_Root_ktrace,
+    FI_Root_locks,
+    FI_Root_storage,
     FI_Root_self, // symlink
     FI_Root_sys,  // directory
     FI_Root_net,  // directory
+    FI_Root_fs,   // directory
     __FI_Root_End,
 
     FI_Root_sys_variable,
@@ -91,6 +102,8 @@ enum ProcFileType {
     FI_Root_net_udp,
     FI_Root_net_local,
 
+    FI_Root_fs_cache,
+
     FI_PID,
 
     __FI_PID_Start,
@@ -173,6 +186,8 @@ static inline InodeIdentifier to_parent_id(const InodeIdentifier& identifier)
         return { identifier.fsid(), FI_Root_sys };
     case PDI_Root_net:
         return { identifier.fsid(), FI_Root_net };
+    case PDI_Root_fs:
+        return { identifier.fsid(), FI_Root_fs };
     case PDI_PID:
         return to_identifier(identifier.fsid(), PDI_Root, to_pid(identifier), FI_PID);
     case PDI_PID_fd:
@@ -217,6 +232,7 @@ static inline bool is_directory(const InodeIdentifier& identifier)
     case FI_Root:
     case FI_Root_sys:
     case FI_Root_net:
+    case FI_Root_fs:
     case FI_PID:
     case FI_PID_fd:
     case FI_PID_stacks:
@@ -387,7 +403,7 @@ static bool procfs$interrupts(InodeIdentifier, KBufferBuilder& builder)
         obj.add("purpose", handler.purpose());
         obj.add("interrupt_line", handler.interrupt_number());
         obj.add("controller", handler.controller());
-        obj.add("cpu_handler", 0); // FIXME: Determine the responsible CPU for each interrupt handler.
+        obj.add("cpu_handler", handler.target_processor());
         obj.add("device_sharing", (unsigned)handler.sharing_devices_count());
         obj.add("call_count", (unsigned)handler.get_invoking_count());
     });
@@ -395,6 +411,46 @@ static bool procfs$interrupts(InodeIdentifier, KBufferBuilder& builder)
     return true;
 }
 
+static bool procfs$locks(InodeIdentifier, KBufferBuilder& builder)
+{
+    JsonArraySerializer array { builder };
+    Lock::for_each_statistics([&array](const LockStatistics& statistics) {
+        auto obj = array.add_object();
+        obj.add("name", statistics.name);
+        obj.add("contended_count", statistics.contended_count.load());
+        obj.add("spin_acquired_count", statistics.spin_acquired_count.load());
+        obj.add("block_count", statistics.block_count.load());
+    });
+    array.finish();
+    return true;
+}
+
+static bool procfs$storage(InodeIdentifier, KBufferBuilder& builder)
+{
+    JsonArraySerializer array { builder };
+    if (StorageManagement::initialized()) {
+        for (auto& device : StorageManagement::the().storage_devices()) {
+            auto obj = array.add_object();
+            obj.add("major", device.major());
+            obj.add("minor", device.minor());
+            auto add_statistics = [&](const char* name, const StorageDevice::RequestStatistics& statistics) {
+                auto statistics_object = obj.add_object(name);
+                statistics_object.add("requests", statistics.requests.load());
+                statistics_object.add("bytes", statistics.bytes.load());
+                statistics_object.add("errors", statistics.errors.load());
+                statistics_object.add("total_latency_us", statistics.total_latency_us.load());
+                auto buckets = statistics_object.add_array("latency_buckets");
+                for (auto& bucket : statistics.latency_buckets)
+                    buckets.add(bucket.load());
+            };
+            add_statistics("read", device.read_statistics());
+            add_statistics("write", device.write_statistics());
+        }
+    }
+    array.finish();
+    return true;
+}
+
 static bool procfs$keymap(InodeIdentifier, KBufferBuilder& builder)
 {
     JsonObjectSerializer<KBufferBuilder> json { builder };
@@ -464,6 +520,11 @@ static bool procfs$profile(InodeIdentifier, KBufferBuilder& builder)
     return g_global_perf_events->to_json(builder);
 }
 
+static bool procfs$ktrace(InodeIdentifier, KBufferBuilder& builder)
+{
+    return KTrace::to_json(builder);
+}
+
 static bool procfs$pid_perf_events(InodeIdentifier identifier, KBufferBuilder& builder)
 {
     auto process = Process::from_pid(to_pid(identifier));
@@ -493,6 +554,7 @@ static bool procfs$net_adapters(InodeIdentifier, KBufferBuilder& builder)
         obj.add("bytes_in", adapter.bytes_in());
         obj.add("packets_out", adapter.packets_out());
         obj.add("bytes_out", adapter.bytes_out());
+        obj.add("packets_dropped", adapter.packets_dropped());
         obj.add("link_up", adapter.link_up());
         obj.add("mtu", adapter.mtu());
     });
@@ -529,6 +591,17 @@ static bool procfs$net_tcp(InodeIdentifier, KBufferBuilder& builder)
         obj.add("bytes_in", socket.bytes_in());
         obj.add("packets_out", socket.packets_out());
         obj.add("bytes_out", socket.bytes_out());
+        obj.add("retransmissions", socket.retransmissions());
+        obj.add("mss", socket.mss());
+        obj.add("congestion_window", socket.congestion_window());
+        obj.add("slow_start_threshold", socket.slow_start_threshold());
+        obj.add("bytes_in_flight", socket.bytes_in_flight());
+        obj.add("fast_recovery", socket.is_in_fast_recovery());
+        obj.add("sack_permitted", socket.is_sack_permitted());
+        obj.add("no_delay", socket.no_delay());
+        obj.add("smoothed_rtt_us", socket.smoothed_rtt().to_microseconds());
+        obj.add("rtt_variance_us", socket.rtt_variance().to_microseconds());
+        obj.add("retransmission_timeout_ms", socket.retransmission_timeout().to_milliseconds());
     });
     array.finish();
     return true;
@@ -680,6 +753,35 @@ static bool procfs$df(InodeIdentifier, KBufferBuilder& builder)
     return true;
 }
 
+static bool procfs$fs_cache(InodeIdentifier, KBufferBuilder& builder)
+{
+    // FIXME: This is obviously racy against the VFS mounts changing.
+    JsonArraySerializer array { builder };
+    VFS::the().for_each_mount([&array](auto& mount) {
+        auto& fs = mount.guest_fs();
+        if (!fs.is_block_based())
+            return;
+        auto statistics = static_cast<const BlockBasedFS&>(fs).cache_statistics();
+        auto fs_object = array.add_object();
+        fs_object.add("class_name", fs.class_name());
+        fs_object.add("mount_point", mount.absolute_path());
+        fs_object.add("block_size", static_cast<u64>(fs.block_size()));
+        fs_object.add("hits", statistics.hits);
+        fs_object.add("misses", statistics.misses);
+        fs_object.add("evictions", statistics.evictions);
+        fs_object.add("ghost_hits", statistics.ghost_hits);
+        fs_object.add("shrinks", statistics.shrinks);
+        fs_object.add("entry_count", statistics.entry_count);
+        fs_object.add("max_entry_count", statistics.max_entry_count);
+        fs_object.add("recent_count", statistics.recent_count);
+        fs_object.add("frequent_count", statistics.frequent_count);
+        fs_object.add("dirty_count", statistics.dirty_count);
+        fs_object.add("ghost_count", statistics.ghost_count);
+    });
+    array.finish();
+    return true;
+}
+
 static bool procfs$cpuinfo(InodeIdentifier, KBufferBuilder& builder)
 {
     JsonArraySerializer array { builder };
@@ -729,55 +831,72 @@ static bool procfs$memstat(InodeIdentifier, KBufferBuilder& builder)
     json.add("user_physical_available", user_physical_pages_total - user_physical_pages_used);
     json.add("user_physical_committed", user_physical_pages_committed);
     json.add("user_physical_uncommitted", user_physical_pages_uncommitted);
+    json.add("user_physical_zeroed", MM.zeroed_page_cache_count());
+    json.add("compressed_pages", CompressedPage::stored_page_count());
+    json.add("compressed_bytes", CompressedPage::stored_byte_count());
+    json.add("compressed_page_compressions", CompressedPage::compression_count());
+    json.add("compressed_page_decompressions", CompressedPage::decompression_count());
+    json.add("compressed_page_rejections", CompressedPage::rejection_count());
     json.add("super_physical_allocated", super_physical_used);
     json.add("super_physical_available", super_physical_total - super_physical_used);
     json.add("kmalloc_call_count", stats.kmalloc_call_count);
     json.add("kfree_call_count", stats.kfree_call_count);
-    slab_alloc_stats([&json](size_t slab_size, size_t num_allocated, size_t num_free) {
-        auto prefix = String::formatted("slab_{}", slab_size);
-        json.add(String::formatted("{}_num_allocated", prefix), num_allocated);
-        json.add(String::formatted("{}_num_free", prefix), num_free);
+    json.add("kmalloc_cached", stats.bytes_cached);
+    json.add("kmalloc_cache_hits", stats.cache_hits);
+    json.add("kmalloc_cache_misses", stats.cache_misses);
+    slab_alloc_stats([&json](const SlabAllocatorStats& slab_stats) {
+        auto prefix = String::formatted("slab_{}", slab_stats.slab_size);
+        json.add(String::formatted("{}_num_allocated", prefix), slab_stats.num_allocated);
+        json.add(String::formatted("{}_num_free", prefix), slab_stats.num_free);
+        json.add(String::formatted("{}_num_cached", prefix), slab_stats.num_cached);
+        json.add(String::formatted("{}_magazine_hits", prefix), slab_stats.magazine_hits);
+        json.add(String::formatted("{}_magazine_misses", prefix), slab_stats.magazine_misses);
     });
     json.finish();
     return true;
 }
 
-static bool procfs$all(InodeIdentifier, KBufferBuilder& builder)
+static String pledge_string_for(const Process& process)
 {
-    JsonArraySerializer array { builder };
-
-    // Keep this in sync with CProcessStatistics.
-    auto build_process = [&](const Process& process) {
-        auto process_object = array.add_object();
-
-        if (process.is_user_process()) {
-            StringBuilder pledge_builder;
+    if (!process.is_user_process())
+        return {};
+    StringBuilder pledge_builder;
 
 #define __ENUMERATE_PLEDGE_PROMISE(promise)      \
     if (process.has_promised(Pledge::promise)) { \
         pledge_builder.append(#promise " ");     \
     }
-            ENUMERATE_PLEDGE_PROMISES
+    ENUMERATE_PLEDGE_PROMISES
 #undef __ENUMERATE_PLEDGE_PROMISE
 
-            process_object.add("pledge", pledge_builder.to_string());
+    return pledge_builder.to_string();
+}
 
-            switch (process.veil_state()) {
-            case VeilState::None:
-                process_object.add("veil", "None");
-                break;
-            case VeilState::Dropped:
-                process_object.add("veil", "Dropped");
-                break;
-            case VeilState::Locked:
-                process_object.add("veil", "Locked");
-                break;
-            }
-        } else {
-            process_object.add("pledge", String());
-            process_object.add("veil", String());
-        }
+static const char* veil_string_for(const Process& process)
+{
+    if (!process.is_user_process())
+        return "";
+    switch (process.veil_state()) {
+    case VeilState::None:
+        return "None";
+    case VeilState::Dropped:
+        return "Dropped";
+    case VeilState::Locked:
+        return "Locked";
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static bool procfs$all(InodeIdentifier, KBufferBuilder& builder)
+{
+    JsonArraySerializer array { builder };
+
+    // Keep this in sync with CProcessStatistics.
+    auto build_process = [&](const Process& process) {
+        auto process_object = array.add_object();
 
+        process_object.add("pledge", pledge_string_for(process));
+        process_object.add("veil", veil_string_for(process));
         process_object.add("pid", process.pid().value());
         process_object.add("pgid", process.tty() ? process.tty()->pgid().value() : 0);
         process_object.add("pgp", process.pgid().value());
@@ -815,6 +934,10 @@ static bool procfs$all(InodeIdentifier, KBufferBuilder& builder)
             thread_object.add("cow_faults", thread.cow_faults());
             thread_object.add("file_read_bytes", thread.file_read_bytes());
             thread_object.add("file_write_bytes", thread.file_write_bytes());
+            thread_object.add("block_read_requests", thread.block_read_requests());
+            thread_object.add("block_read_bytes", thread.block_read_bytes());
+            thread_object.add("block_write_requests", thread.block_write_requests());
+            thread_object.add("block_write_bytes", thread.block_write_bytes());
             thread_object.add("unix_socket_read_bytes", thread.unix_socket_read_bytes());
             thread_object.add("unix_socket_write_bytes", thread.unix_socket_write_bytes());
             thread_object.add("ipv4_socket_read_bytes", thread.ipv4_socket_read_bytes());
@@ -832,6 +955,92 @@ static bool procfs$all(InodeIdentifier, KBufferBuilder& builder)
     return true;
 }
 
+static bool procfs$processes(InodeIdentifier, KBufferBuilder& builder)
+{
+    auto append_string = [&](const StringView& string) {
+        u16 length = min(string.length(), (size_t)NumericLimits<u16>::max());
+        builder.append_bytes({ &length, sizeof(length) });
+        builder.append_bytes(string.bytes().trim(length));
+    };
+
+    // Keep this in sync with Kernel/API/ProcessStatistics.h.
+    auto build_process = [&](const Process& process) {
+        ProcessStatisticsRecord record {};
+        record.pid = process.pid().value();
+        record.pgid = process.tty() ? process.tty()->pgid().value() : 0;
+        record.pgp = process.pgid().value();
+        record.sid = process.sid().value();
+        record.uid = process.uid();
+        record.gid = process.gid();
+        record.ppid = process.ppid().value();
+        record.nfds = process.number_of_open_file_descriptors();
+        record.kernel = process.is_kernel_process();
+        record.dumpable = process.is_dumpable();
+        process.for_each_thread([&](const Thread&) {
+            ++record.thread_count;
+            return IterationDecision::Continue;
+        });
+        record.amount_virtual = process.space().amount_virtual();
+        record.amount_resident = process.space().amount_resident();
+        record.amount_shared = process.space().amount_shared();
+        record.amount_dirty_private = process.space().amount_dirty_private();
+        record.amount_clean_inode = process.space().amount_clean_inode();
+        record.amount_purgeable_volatile = process.space().amount_purgeable_volatile();
+        record.amount_purgeable_nonvolatile = process.space().amount_purgeable_nonvolatile();
+        builder.append_bytes({ &record, sizeof(record) });
+
+        append_string(process.name());
+        append_string(process.executable() ? process.executable()->absolute_path() : String());
+        append_string(process.tty() ? process.tty()->tty_name() : "notty");
+        append_string(pledge_string_for(process));
+        append_string(veil_string_for(process));
+
+        process.for_each_thread([&](const Thread& thread) {
+            ThreadStatisticsRecord thread_record {};
+            thread_record.tid = thread.tid().value();
+            thread_record.times_scheduled = thread.times_scheduled();
+            thread_record.ticks_user = thread.ticks_in_user();
+            thread_record.ticks_kernel = thread.ticks_in_kernel();
+            thread_record.cpu = thread.cpu();
+            thread_record.priority = thread.priority();
+            thread_record.syscall_count = thread.syscall_count();
+            thread_record.inode_faults = thread.inode_faults();
+            thread_record.zero_faults = thread.zero_faults();
+            thread_record.cow_faults = thread.cow_faults();
+            thread_record.unix_socket_read_bytes = thread.unix_socket_read_bytes();
+            thread_record.unix_socket_write_bytes = thread.unix_socket_write_bytes();
+            thread_record.ipv4_socket_read_bytes = thread.ipv4_socket_read_bytes();
+            thread_record.ipv4_socket_write_bytes = thread.ipv4_socket_write_bytes();
+            thread_record.file_read_bytes = thread.file_read_bytes();
+            thread_record.file_write_bytes = thread.file_write_bytes();
+            thread_record.block_read_requests = thread.block_read_requests();
+            thread_record.block_read_bytes = thread.block_read_bytes();
+            thread_record.block_write_requests = thread.block_write_requests();
+            thread_record.block_write_bytes = thread.block_write_bytes();
+            builder.append_bytes({ &thread_record, sizeof(thread_record) });
+            append_string(thread.name());
+            append_string(thread.state_string());
+            return IterationDecision::Continue;
+        });
+    };
+
+    ScopedSpinLock lock(g_scheduler_lock);
+    auto processes = Process::all_processes();
+
+    ProcessStatisticsHeader header {};
+    header.magic = PROCESS_STATISTICS_MAGIC;
+    header.version = PROCESS_STATISTICS_VERSION;
+    header.process_record_size = sizeof(ProcessStatisticsRecord);
+    header.thread_record_size = sizeof(ThreadStatisticsRecord);
+    header.process_count = processes.size() + 1;
+    builder.append_bytes({ &header, sizeof(header) });
+
+    build_process(*Scheduler::colonel());
+    for (auto& process : processes)
+        build_process(process);
+    return true;
+}
+
 struct SysVariable {
     String name;
     enum class Type : u8 {
@@ -977,6 +1186,8 @@ bool ProcFS::initialize()
 {
     static Lockable<bool>* kmalloc_stack_helper;
     static Lockable<bool>* ubsan_deadly_helper;
+    static Lockable<String>* interrupt_affinity_helper;
+    static Lockable<String>* performance_policy_helper;
 
     if (kmalloc_stack_helper == nullptr) {
         kmalloc_stack_helper = new Lockable<bool>();
@@ -989,6 +1200,47 @@ bool ProcFS::initialize()
         ProcFS::add_sys_bool("ubsan_is_deadly", *ubsan_deadly_helper, [] {
             UBSanitizer::g_ubsan_is_deadly = ubsan_deadly_helper->resource();
         });
+        interrupt_affinity_helper = new Lockable<String>();
+        ProcFS::add_sys_string("interrupt_affinity", *interrupt_affinity_helper, [] {
+            // Expects "<interrupt line> <cpu>", with the interrupt line as listed in /proc/interrupts.
+            String request;
+            {
+                LOCKER(interrupt_affinity_helper->lock(), Lock::Mode::Shared);
+                request = interrupt_affinity_helper->resource();
+            }
+            auto parts = StringView(request).trim_whitespace().split_view(' ');
+            if (parts.size() != 2)
+                return;
+            auto interrupt_line = parts[0].to_uint();
+            auto cpu = parts[1].to_uint();
+            if (!interrupt_line.has_value() || !cpu.has_value())
+                return;
+            InterruptManagement::the().enumerate_interrupt_handlers([&](GenericInterruptHandler& handler) {
+                if (handler.interrupt_number() != interrupt_line.value())
+                    return;
+                if (!handler.set_target_processor(cpu.value()))
+                    dbgln("ProcFS: Can't steer interrupt {} to CPU #{}", interrupt_line.value(), cpu.value());
+            });
+        });
+        performance_policy_helper = new Lockable<String>();
+        performance_policy_helper->resource() = "balanced";
+        ProcFS::add_sys_string("cpu_performance_policy", *performance_policy_helper, [] {
+            // One of "performance", "balanced" or "powersave".
+            String policy;
+            {
+                LOCKER(performance_policy_helper->lock(), Lock::Mode::Shared);
+                policy = performance_policy_helper->resource();
+            }
+            auto policy_view = StringView(policy).trim_whitespace();
+            if (policy_view == "performance")
+                Processor::set_performance_policy(PerformancePolicy::Performance);
+            else if (policy_view == "balanced")
+                Processor::set_performance_policy(PerformancePolicy::Balanced);
+            else if (policy_view == "powersave")
+                Processor::set_performance_policy(PerformancePolicy::PowerSave);
+            else
+                dbgln("ProcFS: Unknown CPU performance policy '{}'", policy_view);
+        });
     }
     return true;
 }
@@ -1189,6 +1441,7 @@ InodeMetadata ProcFSInode::metadata() const
     case FI_Root:
     case FI_Root_sys:
     case FI_Root_net:
+    case FI_Root_fs:
         metadata.mode = S_IFDIR | S_IRUSR | S_IXUSR | S_IRGRP | S_IXGRP | S_IROTH | S_IXOTH;
         break;
     case FI_PID:
@@ -1292,6 +1545,10 @@ KResult ProcFSInode::traverse_as_directory(Function<bool(const FS::DirectoryEntr
         callback({ "local", to_identifier(fsid(), PDI_Root_net, 0, FI_Root_net_local), 0 });
         break;
 
+    case FI_Root_fs:
+        callback({ "cache", to_identifier(fsid(), PDI_Root_fs, 0, FI_Root_fs_cache), 0 });
+        break;
+
     case FI_PID: {
         auto pid = to_pid(identifier());
         auto process = Process::from_pid(pid);
@@ -1395,6 +1652,12 @@ RefPtr<Inode> ProcFSInode::lookup(StringView name)
         return {};
     }
 
+    if (proc_file_type == FI_Root_fs) {
+        if (name == "cache")
+            return fs().get_inode(to_identifier(fsid(), PDI_Root_fs, 0, FI_Root_fs_cache));
+        return {};
+    }
+
     if (proc_file_type == FI_PID) {
         auto process = Process::from_pid(to_pid(identifier()));
         if (!process)
@@ -1681,6 +1944,7 @@ ProcFS::ProcFS()
     m_entries.resize(FI_MaxStaticFileIndex);
     m_entries[FI_Root_df] = { "df", FI_Root_df, false, procfs$df };
     m_entries[FI_Root_all] = { "all", FI_Root_all, false, procfs$all };
+    m_entries[FI_Root_processes] = { "processes", FI_Root_processes, false, procfs$processes };
     m_entries[FI_Root_memstat] = { "memstat", FI_Root_memstat, false, procfs$memstat };
     m_entries[FI_Root_cpuinfo] = { "cpuinfo", FI_Root_cpuinfo, false, procfs$cpuinfo };
     m_entries[FI_Root_dmesg] = { "dmesg", FI_Root_dmesg, true, procfs$dmesg };
@@ -1691,10 +1955,13 @@ ProcFS::ProcFS()
     m_entries[FI_Root_smbios_entry_point] = { "smbios_entry_point", FI_Root_smbios_entry_point, false, procfs$smbios_entry_point };
     m_entries[FI_Root_keymap] = { "keymap", FI_Root_keymap, false, procfs$keymap };
     m_entries[FI_Root_devices] = { "devices", FI_Root_devices, false, procfs$devices };
+    m_entries[FI_Root_storage] = { "storage", FI_Root_storage, false, procfs$storage };
     m_entries[FI_Root_uptime] = { "uptime", FI_Root_uptime, false, procfs$uptime };
     m_entries[FI_Root_cmdline] = { "cmdline", FI_Root_cmdline, true, procfs$cmdline };
     m_entries[FI_Root_modules] = { "modules", FI_Root_modules, true, procfs$modules };
     m_entries[FI_Root_profile] = { "profile", FI_Root_profile, true, procfs$profile };
+    m_entries[FI_Root_ktrace] = { "ktrace", FI_Root_ktrace, true, procfs$ktrace };
+    m_entries[FI_Root_locks] = { "locks", FI_Root_locks, true, procfs$locks };
     m_entries[FI_Root_sys] = { "sys", FI_Root_sys, true };
     m_entries[FI_Root_net] = { "net", FI_Root_net, false };
 
@@ -1704,6 +1971,9 @@ ProcFS::ProcFS()
     m_entries[FI_Root_net_udp] = { "udp", FI_Root_net_udp, false, procfs$net_udp };
     m_entries[FI_Root_net_local] = { "local", FI_Root_net_local, false, procfs$net_local };
 
+    m_entries[FI_Root_fs] = { "fs", FI_Root_fs, false };
+    m_entries[FI_Root_fs_cache] = { "cache", FI_Root_fs_cache, false, procfs$fs_cache };
+
     m_entries[FI_PID_vm] = { "vm", FI_PID_vm, false, procfs$pid_vm };
     m_entries[FI_PID_stacks] = { "stacks", FI_PID_stacks, false };
     m_entries[FI_PID_fds] = { "fds", FI_PID_fds, false, procfs$pid_fds };
@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// Detects sequential access to a file and decides when and how much to read ahead.
+// The window starts out small, doubles every time the reader catches up with it,
+// and gets reset as soon as the reader jumps somewhere else in the file.
+class ReadaheadState {
+public:
+    static constexpr size_t initial_window_size = 16 * KiB;
+    static constexpr size_t max_window_size = 256 * KiB;
+
+    struct Request {
+        u64 offset { 0 };
+        size_t size { 0 };
+    };
+
+    // Called before reading `size` bytes at `offset`. Returns the byte
+    // range that should be brought into memory ahead of time, if any.
+    Optional<Request> will_read(u64 offset, size_t size)
+    {
+        bool is_sequential = offset == m_next_offset;
+        m_next_offset = offset + size;
+
+        if (!is_sequential) {
+            m_window_size = 0;
+            return {};
+        }
+
+        if (m_window_size == 0) {
+            m_window_size = initial_window_size;
+            m_readahead_end = offset;
+        }
+
+        // Don't issue more readahead until the reader is within half a window of the end of the last one.
+        if (m_next_offset + m_window_size / 2 < m_readahead_end)
+            return {};
+
+        Request request;
+        request.offset = max(m_readahead_end, offset);
+        request.size = max(m_window_size, (size_t)(m_next_offset - request.offset));
+        m_readahead_end = request.offset + request.size;
+        m_window_size = min(m_window_size * 2, max_window_size);
+        return request;
+    }
+
+private:
+    u64 m_next_offset { 0 };
+    u64 m_readahead_end { 0 };
+    size_t m_window_size { 0 };
+};
+
+}
@@ -7,6 +7,7 @@
 #include <Kernel/FileSystem/TmpFS.h>
 #include <Kernel/Process.h>
 #include <Kernel/Thread.h>
+#include <Kernel/VM/MemoryManager.h>
 #include <LibC/limits.h>
 
 namespace Kernel {
@@ -126,6 +127,22 @@ KResult TmpFSInode::traverse_as_directory(Function<bool(const FS::DirectoryEntry
     return KSuccess;
 }
 
+void TmpFSInode::copy_from_page(const PhysicalPage& page, size_t offset_in_page, u8* destination, size_t size)
+{
+    InterruptDisabler disabler;
+    const u8* page_data = MM.quickmap_page(const_cast<PhysicalPage&>(page));
+    memcpy(destination, page_data + offset_in_page, size);
+    MM.unquickmap_page();
+}
+
+void TmpFSInode::copy_to_page(PhysicalPage& page, size_t offset_in_page, const u8* source, size_t size)
+{
+    InterruptDisabler disabler;
+    u8* page_data = MM.quickmap_page(page);
+    memcpy(page_data + offset_in_page, source, size);
+    MM.unquickmap_page();
+}
+
 ssize_t TmpFSInode::read_bytes(off_t offset, ssize_t size, UserOrKernelBuffer& buffer, FileDescription*) const
 {
     LOCKER(m_lock, Lock::Mode::Shared);
@@ -133,18 +150,44 @@ ssize_t TmpFSInode::read_bytes(off_t offset, ssize_t size, UserOrKernelBuffer& b
     VERIFY(size >= 0);
     VERIFY(offset >= 0);
 
-    if (!m_content)
-        return 0;
-
     if (offset >= m_metadata.size)
         return 0;
 
     if (static_cast<off_t>(size) > m_metadata.size - offset)
         size = m_metadata.size - offset;
 
-    if (!buffer.write(m_content->data() + offset, size))
-        return -EFAULT;
-    return size;
+    // The page can't stay mapped while we copy into the (possibly userspace) buffer, so bounce it through the stack.
+    u8 page_buffer[PAGE_SIZE];
+    ssize_t nread = 0;
+    while (nread < size) {
+        size_t page_index = (offset + nread) / PAGE_SIZE;
+        size_t offset_in_page = (offset + nread) % PAGE_SIZE;
+        size_t chunk_size = min((size_t)(size - nread), PAGE_SIZE - offset_in_page);
+        auto destination = buffer.offset(nread);
+        auto it = m_pages.find(page_index);
+        if (it == m_pages.end()) {
+            if (!destination.memset(0, chunk_size))
+                return -EFAULT;
+        } else {
+            copy_from_page(*it->value, offset_in_page, page_buffer, chunk_size);
+            if (!destination.write(page_buffer, chunk_size))
+                return -EFAULT;
+        }
+        nread += chunk_size;
+    }
+    return nread;
+}
+
+KResult TmpFSInode::ensure_page(size_t page_index)
+{
+    VERIFY(m_lock.is_locked());
+    if (m_pages.contains(page_index))
+        return KSuccess;
+    auto page = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::Yes);
+    if (!page)
+        return ENOMEM;
+    m_pages.set(page_index, page.release_nonnull());
+    return KSuccess;
 }
 
 ssize_t TmpFSInode::write_bytes(off_t offset, ssize_t size, const UserOrKernelBuffer& buffer, FileDescription*)
@@ -157,38 +200,42 @@ ssize_t TmpFSInode::write_bytes(off_t offset, ssize_t size, const UserOrKernelBu
     if (result.is_error())
         return result;
 
-    off_t old_size = m_metadata.size;
-    off_t new_size = m_metadata.size;
-    if ((offset + size) > new_size)
-        new_size = offset + size;
-
-    if (new_size > old_size) {
-        if (m_content && m_content->capacity() >= (size_t)new_size) {
-            m_content->set_size(new_size);
-        } else {
-            // Grow the content buffer 2x the new sizeto accommodate repeating write() calls.
-            // Note that we're not actually committing physical memory to the buffer
-            // until it's needed. We only grow VM here.
-
-            // FIXME: Fix this so that no memcpy() is necessary, and we can just grow the
-            //        KBuffer and it will add physical pages as needed while keeping the
-            //        existing ones.
-            auto tmp = KBuffer::try_create_with_size(new_size * 2);
-            if (!tmp)
-                return -ENOMEM;
-            tmp->set_size(new_size);
-            if (m_content)
-                memcpy(tmp->data(), m_content->data(), old_size);
-            m_content = move(tmp);
+    u8 page_buffer[PAGE_SIZE];
+    ssize_t nwritten = 0;
+    while (nwritten < size) {
+        size_t page_index = (offset + nwritten) / PAGE_SIZE;
+        size_t offset_in_page = (offset + nwritten) % PAGE_SIZE;
+        size_t chunk_size = min((size_t)(size - nwritten), PAGE_SIZE - offset_in_page);
+        if (auto result = ensure_page(page_index); result.is_error()) {
+            if (nwritten)
+                break;
+            return result;
         }
-        m_metadata.size = new_size;
+        if (!buffer.offset(nwritten).read(page_buffer, chunk_size)) {
+            if (nwritten)
+                break;
+            return -EFAULT;
+        }
+        copy_to_page(*m_pages.get(page_index).value(), offset_in_page, page_buffer, chunk_size);
+        nwritten += chunk_size;
+    }
+
+    if (offset + nwritten > m_metadata.size) {
+        m_metadata.size = offset + nwritten;
         set_metadata_dirty(true);
         set_metadata_dirty(false);
     }
+    return nwritten;
+}
 
-    if (!buffer.read(m_content->data() + offset, size)) // TODO: partial reads?
-        return -EFAULT;
-    return size;
+RefPtr<PhysicalPage> TmpFSInode::page_for_shared_mapping(size_t page_index)
+{
+    LOCKER(m_lock);
+    if (is_directory() || page_index >= ceil_div((size_t)m_metadata.size, PAGE_SIZE))
+        return {};
+    if (ensure_page(page_index).is_error())
+        return {};
+    return m_pages.get(page_index).value();
 }
 
 RefPtr<Inode> TmpFSInode::lookup(StringView name)
@@ -284,7 +331,7 @@ KResult TmpFSInode::add_child(Inode& child, const StringView& name, mode_t)
         return ENAMETOOLONG;
 
     m_children.set(name, { name, static_cast<TmpFSInode&>(child) });
-    did_add_child(child.identifier());
+    did_add_child(child.identifier(), name);
     return KSuccess;
 }
 
@@ -301,7 +348,7 @@ KResult TmpFSInode::remove_child(const StringView& name)
         return ENOENT;
     auto child_id = it->value.inode->identifier();
     m_children.remove(it);
-    did_remove_child(child_id);
+    did_remove_child(child_id, name);
     return KSuccess;
 }
 
@@ -310,24 +357,24 @@ KResult TmpFSInode::truncate(u64 size)
     LOCKER(m_lock);
     VERIFY(!is_directory());
 
-    if (size == 0)
-        m_content.clear();
-    else if (!m_content) {
-        m_content = KBuffer::try_create_with_size(size);
-        if (!m_content)
-            return ENOMEM;
-    } else if (static_cast<size_t>(size) < m_content->capacity()) {
-        size_t prev_size = m_metadata.size;
-        m_content->set_size(size);
-        if (prev_size < static_cast<size_t>(size))
-            memset(m_content->data() + prev_size, 0, size - prev_size);
-    } else {
-        size_t prev_size = m_metadata.size;
-        auto tmp = KBuffer::try_create_with_size(size);
-        if (!tmp)
-            return ENOMEM;
-        memcpy(tmp->data(), m_content->data(), prev_size);
-        m_content = move(tmp);
+    // Growing the file only creates a hole, but anything past the new end has to go, so that it
+    // reads back as zeroes if the file grows again.
+    if (size < static_cast<u64>(m_metadata.size)) {
+        size_t page_count = ceil_div(size, static_cast<u64>(PAGE_SIZE));
+        Vector<size_t> pages_to_remove;
+        for (auto& it : m_pages) {
+            if (it.key >= page_count)
+                pages_to_remove.append(it.key);
+        }
+        for (auto page_index : pages_to_remove)
+            m_pages.remove(page_index);
+        size_t offset_in_last_page = size % PAGE_SIZE;
+        if (offset_in_last_page) {
+            if (auto it = m_pages.find(page_count - 1); it != m_pages.end()) {
+                u8 zeroes[PAGE_SIZE] {};
+                copy_to_page(*it->value, offset_in_last_page, zeroes, PAGE_SIZE - offset_in_last_page);
+            }
+        }
     }
 
     m_metadata.size = size;
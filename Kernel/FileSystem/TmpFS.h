@@ -10,7 +10,7 @@
 #include <AK/Optional.h>
 #include <Kernel/FileSystem/FileSystem.h>
 #include <Kernel/FileSystem/Inode.h>
-#include <Kernel/KBuffer.h>
+#include <Kernel/VM/PhysicalPage.h>
 
 namespace Kernel {
 
@@ -27,6 +27,7 @@ public:
     virtual const char* class_name() const override { return "TmpFS"; }
 
     virtual bool supports_watchers() const override { return true; }
+    virtual bool supports_directory_entry_cache() const override { return true; }
 
     virtual NonnullRefPtr<Inode> root_inode() const override;
 
@@ -71,6 +72,7 @@ public:
     virtual int set_ctime(time_t) override;
     virtual int set_mtime(time_t) override;
     virtual void one_ref_left() override;
+    virtual RefPtr<PhysicalPage> page_for_shared_mapping(size_t page_index) override;
 
 private:
     TmpFSInode(TmpFS& fs, InodeMetadata metadata, InodeIdentifier parent);
@@ -78,11 +80,16 @@ private:
     static NonnullRefPtr<TmpFSInode> create_root(TmpFS&);
 
     void notify_watchers();
+    KResult ensure_page(size_t page_index);
+    static void copy_from_page(const PhysicalPage&, size_t offset_in_page, u8* destination, size_t);
+    static void copy_to_page(PhysicalPage&, size_t offset_in_page, const u8* source, size_t);
 
     InodeMetadata m_metadata;
     InodeIdentifier m_parent;
 
-    OwnPtr<KBuffer> m_content;
+    // File contents, one physical page at a time. Pages that were never written to are holes,
+    // which don't use any memory and read back as zeroes.
+    HashMap<size_t, NonnullRefPtr<PhysicalPage>> m_pages;
     struct Child {
         String name;
         NonnullRefPtr<TmpFSInode> inode;
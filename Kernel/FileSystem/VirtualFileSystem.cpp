@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DirectoryEntryCache.h>
 #include <Kernel/FileSystem/FileBackedFileSystem.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/FileSystem.h>
@@ -928,6 +929,21 @@ static bool safe_to_follow_symlink(const Inode& inode, const InodeMetadata& pare
     return false;
 }
 
+static RefPtr<Inode> lookup_with_cache(Inode& directory, const StringView& name)
+{
+    if (!directory.fs().supports_directory_entry_cache())
+        return directory.lookup(name);
+
+    auto& cache = DirectoryEntryCache::the();
+    auto cached = cache.lookup(directory, name);
+    if (cached.hit)
+        return move(cached.inode);
+
+    auto child = directory.lookup(name);
+    cache.add(directory, name, child.ptr(), cached.generation);
+    return child;
+}
+
 KResultOr<NonnullRefPtr<Custody>> VFS::resolve_path_without_veil(StringView path, Custody& base, RefPtr<Custody>* out_parent, int options, int symlink_recursion_level)
 {
     if (symlink_recursion_level >= symlink_recursion_limit)
@@ -964,7 +980,7 @@ KResultOr<NonnullRefPtr<Custody>> VFS::resolve_path_without_veil(StringView path
         }
 
         // Okay, let's look up this part.
-        auto child_inode = parent.inode().lookup(part);
+        auto child_inode = lookup_with_cache(parent.inode(), part);
         if (!child_inode) {
             if (out_parent) {
                 // ENOENT with a non-null parent custody signals to caller that
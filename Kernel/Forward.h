@@ -15,6 +15,7 @@ class Custody;
 class Device;
 class DiskCache;
 class DoubleBuffer;
+class EPoll;
 class File;
 class FileDescription;
 class FutexQueue;
@@ -51,6 +52,7 @@ class ScopedSpinLock;
 class TCPSocket;
 class TTY;
 class Thread;
+class TLBShootdownBatch;
 class UDPSocket;
 class UserOrKernelBuffer;
 class VFS;
@@ -16,11 +16,41 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void* data)
     VERIFY(m_lock.is_locked());
     VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
 
+    VERIFY(m_imminent_waits > 0);
+    m_imminent_waits--;
+    if (m_pending_wakes > 0) {
+        // Someone tried to wake us up before we got here.
+        m_pending_wakes--;
+        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: thread {} was woken before it blocked", this, *static_cast<Thread*>(data));
+        return false;
+    }
+
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should block thread {}", this, *static_cast<Thread*>(data));
 
     return true;
 }
 
+void FutexQueue::queue_imminent_wait()
+{
+    ScopedSpinLock lock(m_lock);
+    m_imminent_waits++;
+}
+
+bool FutexQueue::is_empty_and_no_imminent_waits() const
+{
+    ScopedSpinLock lock(m_lock);
+    return is_empty_locked() && m_imminent_waits == 0;
+}
+
+u32 FutexQueue::wake_imminent_waits(u32 count)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(m_pending_wakes <= m_imminent_waits);
+    auto did_wake = min(count, m_imminent_waits - m_pending_wakes);
+    m_pending_wakes += did_wake;
+    return did_wake;
+}
+
 u32 FutexQueue::wake_n_requeue(u32 wake_count, const Function<FutexQueue*()>& get_target_queue, u32 requeue_count, bool& is_empty, bool& is_empty_target)
 {
     is_empty_target = false;
@@ -29,21 +59,26 @@ u32 FutexQueue::wake_n_requeue(u32 wake_count, const Function<FutexQueue*()>& ge
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue({}, {})", this, wake_count, requeue_count);
 
     u32 did_wake = 0, did_requeue = 0;
-    do_unblock([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
-        VERIFY(data);
-        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
-        auto& blocker = static_cast<Thread::FutexBlocker&>(b);
-
-        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, *static_cast<Thread*>(data));
-        VERIFY(did_wake < wake_count);
-        if (blocker.unblock()) {
-            if (++did_wake >= wake_count)
-                stop_iterating = true;
-            return true;
-        }
-        return false;
-    });
-    is_empty = is_empty_locked();
+    if (wake_count > 0) {
+        do_unblock([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
+            VERIFY(data);
+            VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+            auto& blocker = static_cast<Thread::FutexBlocker&>(b);
+
+            dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, *static_cast<Thread*>(data));
+            VERIFY(did_wake < wake_count);
+            if (blocker.unblock()) {
+                if (++did_wake >= wake_count)
+                    stop_iterating = true;
+                return true;
+            }
+            return false;
+        });
+    }
+    // Threads that are about to block can't be moved to the other queue, so we wake them
+    // up instead. They'll find out that they have to wait for the target futex themselves.
+    did_wake += wake_imminent_waits(wake_count - did_wake + requeue_count);
+    is_empty = is_empty_locked() && m_imminent_waits == 0;
     if (requeue_count > 0) {
         auto blockers_to_requeue = do_take_blockers(requeue_count);
         if (!blockers_to_requeue.is_empty()) {
@@ -100,7 +135,9 @@ u32 FutexQueue::wake_n(u32 wake_count, const Optional<u32>& bitset, bool& is_emp
         }
         return false;
     });
-    is_empty = is_empty_locked();
+    if (did_wake < wake_count)
+        did_wake += wake_imminent_waits(wake_count - did_wake);
+    is_empty = is_empty_locked() && m_imminent_waits == 0;
     return did_wake;
 }
 
@@ -120,8 +157,47 @@ u32 FutexQueue::wake_all(bool& is_empty)
         }
         return false;
     });
+    did_wake += wake_imminent_waits(m_imminent_waits);
+    // The threads that were about to block won't do so anymore, so nobody will be left behind.
     is_empty = is_empty_locked();
     return did_wake;
 }
 
+RefPtr<Thread> FutexQueue::wake_highest_priority(u32& highest_remaining_priority, bool& is_empty)
+{
+    ScopedSpinLock lock(m_lock);
+    dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_highest_priority", this);
+
+    Thread* highest_priority_thread = nullptr;
+    highest_remaining_priority = 0;
+    do_unblock([&](Thread::Blocker&, void* data, bool&) {
+        VERIFY(data);
+        auto& thread = *static_cast<Thread*>(data);
+        if (!highest_priority_thread || thread.effective_priority() > highest_priority_thread->effective_priority()) {
+            if (highest_priority_thread)
+                highest_remaining_priority = max(highest_remaining_priority, highest_priority_thread->effective_priority());
+            highest_priority_thread = &thread;
+        } else {
+            highest_remaining_priority = max(highest_remaining_priority, thread.effective_priority());
+        }
+        return false;
+    });
+
+    RefPtr<Thread> woken_thread;
+    if (highest_priority_thread) {
+        do_unblock([&](Thread::Blocker& b, void* data, bool& stop_iterating) {
+            VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+            if (data != highest_priority_thread)
+                return false;
+            stop_iterating = true;
+            if (!static_cast<Thread::FutexBlocker&>(b).unblock())
+                return false;
+            woken_thread = highest_priority_thread;
+            return true;
+        });
+    }
+    is_empty = is_empty_locked() && m_imminent_waits == 0;
+    return woken_thread;
+}
+
 }
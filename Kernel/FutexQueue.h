@@ -25,6 +25,15 @@ public:
     u32 wake_n(u32, const Optional<u32>&, bool&);
     u32 wake_all(bool&);
 
+    // Wakes up the highest priority waiter, so that it can be handed a priority inheritance futex.
+    RefPtr<Thread> wake_highest_priority(u32& highest_remaining_priority, bool& is_empty);
+
+    // Must be called with the futex lock held, before dropping it to block on this queue.
+    // Wakes that happen before we actually block then make the wait return right away,
+    // instead of being lost.
+    void queue_imminent_wait();
+    bool is_empty_and_no_imminent_waits() const;
+
     template<class... Args>
     Thread::BlockResult wait_on(const Thread::BlockTimeout& timeout, Args&&... args)
     {
@@ -37,6 +46,11 @@ protected:
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override;
 
 private:
+    u32 wake_imminent_waits(u32 count);
+
+    u32 m_imminent_waits { 0 };
+    u32 m_pending_wakes { 0 };
+
     // For private futexes we just use the user space address.
     // But for global futexes we use the offset into the VMObject
     const FlatPtr m_user_address_or_offset;
@@ -15,6 +15,12 @@
 
 namespace Kernel {
 
+// Processors beyond this go straight to the shared freelist.
+// Thread affinity masks are 32 bits wide, so we never expect more than this.
+static constexpr size_t max_magazine_processors = 32;
+static constexpr size_t magazine_capacity = 32;
+static constexpr size_t magazine_batch_size = magazine_capacity / 2;
+
 template<size_t templated_slab_size>
 class SlabAllocator {
 public:
@@ -43,19 +49,27 @@ public:
         {
             // We want to avoid being swapped out in the middle of this
             ScopedCritical critical;
-            FreeSlab* next_free;
-            free_slab = m_freelist.load(AK::memory_order_consume);
-            do {
+            auto* magazine = current_magazine();
+            if (magazine && magazine->count == 0) {
+                magazine->misses++;
+                // Grab a whole batch while we're touching the shared freelist anyway.
+                while (magazine->count < magazine_batch_size) {
+                    auto* slab = pop_shared();
+                    if (!slab)
+                        break;
+                    magazine->slabs[magazine->count++] = slab;
+                }
+            } else if (magazine) {
+                magazine->hits++;
+            }
+
+            if (magazine && magazine->count > 0) {
+                free_slab = magazine->slabs[--magazine->count];
+            } else {
+                free_slab = pop_shared();
                 if (!free_slab)
                     return kmalloc(slab_size());
-                // It's possible another processor is doing the same thing at
-                // the same time, so next_free *can* be a bogus pointer. However,
-                // in that case compare_exchange_strong would fail and we would
-                // try again.
-                next_free = free_slab->next;
-            } while (!m_freelist.compare_exchange_strong(free_slab, next_free, AK::memory_order_acq_rel));
-
-            m_num_allocated++;
+            }
         }
 
 #ifdef SANITIZE_SLABS
@@ -79,16 +93,48 @@ public:
 
         // We want to avoid being swapped out in the middle of this
         ScopedCritical critical;
-        FreeSlab* next_free = m_freelist.load(AK::memory_order_consume);
-        do {
-            free_slab->next = next_free;
-        } while (!m_freelist.compare_exchange_strong(next_free, free_slab, AK::memory_order_acq_rel));
+        auto* magazine = current_magazine();
+        if (!magazine) {
+            push_shared(free_slab);
+            return;
+        }
+        if (magazine->count == magazine_capacity) {
+            // Hand back half of the magazine, so that the next few frees
+            // and allocations on this processor can stay local again.
+            while (magazine->count > magazine_capacity - magazine_batch_size)
+                push_shared(magazine->slabs[--magazine->count]);
+        }
+        magazine->slabs[magazine->count++] = free_slab;
+    }
 
-        m_num_allocated--;
+    size_t num_cached() const
+    {
+        size_t cached = 0;
+        for (auto& magazine : m_magazines)
+            cached += magazine.count;
+        return cached;
+    }
+
+    size_t num_magazine_hits() const
+    {
+        size_t hits = 0;
+        for (auto& magazine : m_magazines)
+            hits += magazine.hits;
+        return hits;
     }
 
-    size_t num_allocated() const { return m_num_allocated; }
-    size_t num_free() const { return m_slab_count - m_num_allocated; }
+    size_t num_magazine_misses() const
+    {
+        size_t misses = 0;
+        for (auto& magazine : m_magazines)
+            misses += magazine.misses;
+        return misses;
+    }
+
+    // Slabs sitting in a magazine are free, even though the shared freelist
+    // counts them as allocated.
+    size_t num_allocated() const { return m_num_allocated - num_cached(); }
+    size_t num_free() const { return m_slab_count - num_allocated(); }
 
 private:
     struct FreeSlab {
@@ -96,6 +142,54 @@ private:
         char padding[templated_slab_size - sizeof(FreeSlab*)];
     };
 
+    // A magazine is only ever touched by its own processor while in a
+    // critical section, so it needs no locking.
+    struct Magazine {
+        FreeSlab* slabs[magazine_capacity];
+        size_t count { 0 };
+        size_t hits { 0 };
+        size_t misses { 0 };
+    };
+
+    Magazine* current_magazine()
+    {
+        VERIFY(Processor::current().in_critical());
+        auto cpu = Processor::id();
+        if (cpu >= max_magazine_processors)
+            return nullptr;
+        return &m_magazines[cpu];
+    }
+
+    FreeSlab* pop_shared()
+    {
+        FreeSlab* next_free;
+        FreeSlab* free_slab = m_freelist.load(AK::memory_order_consume);
+        do {
+            if (!free_slab)
+                return nullptr;
+            // It's possible another processor is doing the same thing at
+            // the same time, so next_free *can* be a bogus pointer. However,
+            // in that case compare_exchange_strong would fail and we would
+            // try again.
+            next_free = free_slab->next;
+        } while (!m_freelist.compare_exchange_strong(free_slab, next_free, AK::memory_order_acq_rel));
+
+        m_num_allocated++;
+        return free_slab;
+    }
+
+    void push_shared(FreeSlab* free_slab)
+    {
+        FreeSlab* next_free = m_freelist.load(AK::memory_order_consume);
+        do {
+            free_slab->next = next_free;
+        } while (!m_freelist.compare_exchange_strong(next_free, free_slab, AK::memory_order_acq_rel));
+
+        m_num_allocated--;
+    }
+
+    Magazine m_magazines[max_magazine_processors];
+
     Atomic<FreeSlab*> m_freelist { nullptr };
     Atomic<ssize_t, AK::MemoryOrder::memory_order_relaxed> m_num_allocated;
     size_t m_slab_count;
@@ -157,12 +251,17 @@ void slab_dealloc(void* ptr, size_t slab_size)
     VERIFY_NOT_REACHED();
 }
 
-void slab_alloc_stats(Function<void(size_t slab_size, size_t allocated, size_t free)> callback)
+void slab_alloc_stats(Function<void(const SlabAllocatorStats&)> callback)
 {
     for_each_allocator([&](auto& allocator) {
-        auto num_allocated = allocator.num_allocated();
-        auto num_free = allocator.slab_count() - num_allocated;
-        callback(allocator.slab_size(), num_allocated, num_free);
+        SlabAllocatorStats stats;
+        stats.slab_size = allocator.slab_size();
+        stats.num_allocated = allocator.num_allocated();
+        stats.num_free = allocator.slab_count() - stats.num_allocated;
+        stats.num_cached = allocator.num_cached();
+        stats.magazine_hits = allocator.num_magazine_hits();
+        stats.magazine_misses = allocator.num_magazine_misses();
+        callback(stats);
     });
 }
 
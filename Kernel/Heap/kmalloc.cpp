@@ -179,6 +179,34 @@ struct KmallocGlobalHeap {
     }
 };
 
+using KmallocBlockHeap = KmallocGlobalHeap::HeapType::HeapType;
+
+// Small blocks that get kfree()'d are parked in a per-processor cache, so
+// that the next kmalloc() of the same size on that processor can be served
+// without taking s_lock.
+static constexpr size_t kmalloc_cache_max_processors = 32;
+static constexpr size_t kmalloc_cache_size_classes = 8; // Blocks of 1 to 8 chunks
+static constexpr size_t kmalloc_cache_depth = 16;
+
+struct KmallocProcessorCache {
+    void* blocks[kmalloc_cache_size_classes][kmalloc_cache_depth];
+    size_t counts[kmalloc_cache_size_classes];
+    size_t hits;
+    size_t misses;
+    size_t kfree_call_count;
+};
+
+static KmallocProcessorCache s_kmalloc_processor_caches[kmalloc_cache_max_processors];
+
+static KmallocProcessorCache* current_kmalloc_cache()
+{
+    VERIFY(Processor::current().in_critical());
+    auto cpu = Processor::id();
+    if (cpu >= kmalloc_cache_max_processors)
+        return nullptr;
+    return &s_kmalloc_processor_caches[cpu];
+}
+
 READONLY_AFTER_INIT static KmallocGlobalHeap* g_kmalloc_global;
 static u8 g_kmalloc_global_heap[sizeof(KmallocGlobalHeap)];
 
@@ -229,8 +257,60 @@ void* kmalloc_eternal(size_t size)
     return ptr;
 }
 
+static void* kmalloc_from_processor_cache(size_t chunks)
+{
+    if (chunks > kmalloc_cache_size_classes || !Processor::is_initialized())
+        return nullptr;
+
+    ScopedCritical critical;
+    auto* cache = current_kmalloc_cache();
+    if (!cache)
+        return nullptr;
+    auto& count = cache->counts[chunks - 1];
+    if (count == 0) {
+        cache->misses++;
+        return nullptr;
+    }
+    cache->hits++;
+    return cache->blocks[chunks - 1][--count];
+}
+
+static bool kfree_to_processor_cache(void* ptr)
+{
+    auto chunks = KmallocBlockHeap::allocation_size_in_chunks(ptr);
+    if (chunks > kmalloc_cache_size_classes || !Processor::is_initialized())
+        return false;
+
+    ScopedCritical critical;
+    auto* cache = current_kmalloc_cache();
+    if (!cache)
+        return false;
+
+    memset(ptr, KFREE_SCRUB_BYTE, KmallocBlockHeap::usable_size_for_chunks(chunks));
+
+    auto& count = cache->counts[chunks - 1];
+    if (count == kmalloc_cache_depth) {
+        // Give half of this size class back to the heap, so we don't hold on
+        // to memory that other processors might need.
+        ScopedSpinLock lock(s_lock);
+        while (count > kmalloc_cache_depth / 2)
+            g_kmalloc_global->m_heap.deallocate(cache->blocks[chunks - 1][--count]);
+    }
+    cache->blocks[chunks - 1][count++] = ptr;
+    cache->kfree_call_count++;
+    return true;
+}
+
 void* kmalloc(size_t size)
 {
+    auto chunks = KmallocBlockHeap::chunks_needed_for(size);
+    if (!g_dump_kmalloc_stacks) {
+        if (auto* ptr = kmalloc_from_processor_cache(chunks)) {
+            memset(ptr, KMALLOC_SCRUB_BYTE, KmallocBlockHeap::usable_size_for_chunks(chunks));
+            return ptr;
+        }
+    }
+
     ScopedSpinLock lock(s_lock);
     ++g_kmalloc_call_count;
 
@@ -252,6 +332,9 @@ void kfree(void* ptr)
     if (!ptr)
         return;
 
+    if (kfree_to_processor_cache(ptr))
+        return;
+
     ScopedSpinLock lock(s_lock);
     ++g_kfree_call_count;
 
@@ -282,4 +365,22 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_eternal = g_kmalloc_bytes_eternal;
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+    stats.bytes_cached = 0;
+    stats.cache_hits = 0;
+    stats.cache_misses = 0;
+
+    // NOTE: The per-processor caches are read without synchronization,
+    //       so these numbers are only approximate.
+    for (auto& cache : s_kmalloc_processor_caches) {
+        for (size_t i = 0; i < kmalloc_cache_size_classes; ++i)
+            stats.bytes_cached += cache.counts[i] * (i + 1) * CHUNK_SIZE;
+        stats.cache_hits += cache.hits;
+        stats.cache_misses += cache.misses;
+        stats.kmalloc_call_count += cache.hits;
+        stats.kfree_call_count += cache.kfree_call_count;
+    }
+
+    // Cached blocks are still allocated as far as the heap is concerned.
+    stats.bytes_allocated -= stats.bytes_cached;
+    stats.bytes_free += stats.bytes_cached;
 }
@@ -32,6 +32,9 @@ struct kmalloc_stats {
     size_t bytes_eternal;
     size_t kmalloc_call_count;
     size_t kfree_call_count;
+    size_t bytes_cached;
+    size_t cache_hits;
+    size_t cache_misses;
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
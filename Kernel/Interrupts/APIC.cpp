@@ -11,6 +11,7 @@
 #include <AK/Types.h>
 #include <Kernel/ACPI/Parser.h>
 #include <Kernel/Arch/x86/CPU.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/Arch/x86/ProcessorInfo.h>
 #include <Kernel/Debug.h>
 #include <Kernel/IO.h>
@@ -23,6 +24,7 @@
 #include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/TypedMapping.h>
 
+#define IRQ_APIC_PMC (0xfb - IRQ_VECTOR_BASE)
 #define IRQ_APIC_TIMER (0xfc - IRQ_VECTOR_BASE)
 #define IRQ_APIC_IPI (0xfd - IRQ_VECTOR_BASE)
 #define IRQ_APIC_ERR (0xfe - IRQ_VECTOR_BASE)
@@ -34,6 +36,7 @@
 
 #define APIC_BASE_MSR 0x1b
 
+#define APIC_REG_ID 0x20
 #define APIC_REG_EOI 0xb0
 #define APIC_REG_LD 0xd0
 #define APIC_REG_DF 0xe0
@@ -400,6 +403,7 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
     // read it back to make sure it's actually set
     auto apic_id = read_register(APIC_REG_LD) >> 24;
     Processor::current().info().set_apic_id(apic_id);
+    m_physical_apic_ids[cpu] = read_register(APIC_REG_ID) >> 24;
 
     dbgln_if(APIC_DEBUG, "Enabling local APIC for CPU #{}, logical APIC ID: {}", cpu, apic_id);
 
@@ -412,6 +416,9 @@ UNMAP_AFTER_INIT void APIC::enable(u32 cpu)
 
         // register IPI interrupt vector
         APICIPIInterruptHandler::initialize(IRQ_APIC_IPI);
+
+        if (PerformanceCounters::is_supported())
+            PerformanceCounterInterruptHandler::initialize(IRQ_APIC_PMC);
     }
 
     // set spurious interrupt vector
@@ -542,8 +549,20 @@ void APIC::setup_local_timer(u32 ticks, TimerMode timer_mode, bool enable)
     }
     write_register(APIC_REG_TIMER_CONFIGURATION, config);
 
-    if (timer_mode == TimerMode::Periodic)
-        write_register(APIC_REG_TIMER_INITIAL_COUNT, ticks / get_timer_divisor());
+    if (timer_mode != TimerMode::TSCDeadline)
+        set_timer_initial_count(ticks / get_timer_divisor());
+}
+
+void APIC::set_timer_initial_count(u32 count)
+{
+    // NOTE: count is in units of the timer divisor. Writing it (re)starts the timer, writing 0 stops it.
+    write_register(APIC_REG_TIMER_INITIAL_COUNT, count);
+}
+
+void APIC::setup_performance_counter_interrupt(bool enable)
+{
+    u32 flags = enable ? 0 : APIC_LVT_MASKED;
+    write_register(APIC_REG_LVT_PERFORMANCE_COUNTER, APIC_LVT(IRQ_APIC_PMC + IRQ_VECTOR_BASE, 0) | flags);
 }
 
 u32 APIC::get_timer_current_count()
@@ -34,6 +34,8 @@ public:
     static u8 spurious_interrupt_vector();
     Thread* get_idle_thread(u32 cpu) const;
     u32 enabled_processor_count() const { return m_processor_enabled_cnt; }
+    // The ID that interrupt messages have to be addressed to in physical destination mode.
+    u8 physical_apic_id(u32 cpu) const { return m_physical_apic_ids[cpu]; }
 
     APICTimer* initialize_timers(HardwareTimerBase&);
     APICTimer* get_timer() const { return m_apic_timer; }
@@ -43,6 +45,8 @@ public:
         TSCDeadline
     };
     void setup_local_timer(u32, TimerMode, bool);
+    void set_timer_initial_count(u32);
+    void setup_performance_counter_interrupt(bool enable);
     u32 get_timer_current_count();
     u32 get_timer_divisor();
 
@@ -96,6 +100,7 @@ private:
     Atomic<u8> m_apic_ap_continue { 0 };
     u32 m_processor_cnt { 0 };
     u32 m_processor_enabled_cnt { 0 };
+    u8 m_physical_apic_ids[8] {};
     APICTimer* m_apic_timer { nullptr };
 
     static PhysicalAddress get_base();
@@ -47,6 +47,11 @@ public:
     virtual const char* controller() const = 0;
 
     virtual bool eoi() = 0;
+
+    // The processor that this interrupt is delivered to.
+    virtual u32 target_processor() const { return 0; }
+    virtual bool set_target_processor(u32) { return false; }
+
     ALWAYS_INLINE void increment_invoking_counter()
     {
         m_invoking_count++;
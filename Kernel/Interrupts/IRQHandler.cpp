@@ -6,6 +6,7 @@
 
 #include <Kernel/Arch/x86/CPU.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Interrupts/APIC.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Interrupts/InterruptManagement.h>
 
@@ -20,11 +21,48 @@ IRQHandler::IRQHandler(u8 irq)
 
 IRQHandler::~IRQHandler()
 {
+    if (is_message_signalled())
+        InterruptManagement::the().release_message_signalled_interrupt_number(interrupt_number());
+}
+
+bool IRQHandler::try_to_enable_message_signalled_interrupts(PCI::Address address)
+{
+    VERIFY(!m_enabled && !is_message_signalled());
+    if (!InterruptManagement::the().is_message_signalled_interrupt_supported() || !PCI::is_msi_capable(address))
+        return false;
+    auto interrupt_number = InterruptManagement::the().allocate_message_signalled_interrupt_number();
+    if (!interrupt_number.has_value()) {
+        dbgln("IRQHandler: No free interrupt numbers left for MSI of {}", address);
+        return false;
+    }
+
+    InterruptDisabler disabler;
+    change_interrupt_number(interrupt_number.value());
+    m_message_signalled_device = address;
+    m_target_processor = InterruptManagement::the().next_processor_for_message_signalled_interrupt();
+    dbgln_if(IRQ_DEBUG, "IRQHandler: Using MSI {} on CPU #{} for {}", interrupt_number.value(), m_target_processor, address);
+    return true;
+}
+
+bool IRQHandler::set_target_processor(u32 cpu)
+{
+    // FIXME: Steer the IOAPIC redirection entries as well.
+    if (!is_message_signalled() || cpu >= Processor::count())
+        return false;
+    InterruptDisabler disabler;
+    m_target_processor = cpu;
+    if (m_enabled)
+        PCI::enable_message_signalled_interrupt(m_message_signalled_device.value(), interrupt_number() + IRQ_VECTOR_BASE, APIC::the().physical_apic_id(cpu));
+    return true;
 }
 
 bool IRQHandler::eoi()
 {
     dbgln_if(IRQ_DEBUG, "EOI IRQ {}", interrupt_number());
+    if (is_message_signalled()) {
+        APIC::the().eoi();
+        return true;
+    }
     if (!m_shared_with_others) {
         VERIFY(!m_responsible_irq_controller.is_null());
         m_responsible_irq_controller->eoi(*this);
@@ -39,7 +77,9 @@ void IRQHandler::enable_irq()
     if (!is_registered())
         register_interrupt_handler();
     m_enabled = true;
-    if (!m_shared_with_others)
+    if (is_message_signalled())
+        PCI::enable_message_signalled_interrupt(m_message_signalled_device.value(), interrupt_number() + IRQ_VECTOR_BASE, APIC::the().physical_apic_id(m_target_processor));
+    else if (!m_shared_with_others)
         m_responsible_irq_controller->enable(*this);
 }
 
@@ -47,7 +87,9 @@ void IRQHandler::disable_irq()
 {
     dbgln_if(IRQ_DEBUG, "Disable IRQ {}", interrupt_number());
     m_enabled = false;
-    if (!m_shared_with_others)
+    if (is_message_signalled())
+        PCI::disable_message_signalled_interrupt(m_message_signalled_device.value());
+    else if (!m_shared_with_others)
         m_responsible_irq_controller->disable(*this);
 }
 
@@ -6,12 +6,14 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/x86/CPU.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 #include <Kernel/Interrupts/IRQController.h>
+#include <Kernel/PCI/Definitions.h>
 
 namespace Kernel {
 
@@ -29,20 +31,32 @@ public:
 
     virtual HandlerType type() const override { return HandlerType::IRQHandler; }
     virtual const char* purpose() const override { return "IRQ Handler"; }
-    virtual const char* controller() const override { return m_responsible_irq_controller->model(); }
+    virtual const char* controller() const override { return is_message_signalled() ? "MSI" : m_responsible_irq_controller->model(); }
 
     virtual size_t sharing_devices_count() const override { return 0; }
     virtual bool is_shared_handler() const override { return false; }
     virtual bool is_sharing_with_others() const override { return m_shared_with_others; }
 
+    virtual u32 target_processor() const override { return m_target_processor; }
+    virtual bool set_target_processor(u32) override;
+
+    bool is_message_signalled() const { return m_message_signalled_device.has_value(); }
+
 protected:
     void change_irq_number(u8 irq);
     explicit IRQHandler(u8 irq);
 
+    // Switches over from the device's (possibly shared) interrupt pin to a message signalled
+    // interrupt with an interrupt number of its own, if the device and the system support it.
+    // This has to happen before the first enable_irq().
+    bool try_to_enable_message_signalled_interrupts(PCI::Address);
+
 private:
     bool m_shared_with_others { false };
     bool m_enabled { false };
     RefPtr<IRQController> m_responsible_irq_controller;
+    Optional<PCI::Address> m_message_signalled_device;
+    u32 m_target_processor { 0 };
 };
 
 }
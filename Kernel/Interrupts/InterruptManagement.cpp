@@ -6,6 +6,7 @@
 
 #include <AK/StringView.h>
 #include <Kernel/ACPI/MultiProcessorParser.h>
+#include <Kernel/ACPI/Parser.h>
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/x86/CPU.h>
 #include <Kernel/CommandLine.h>
@@ -21,6 +22,10 @@
 
 #define PCAT_COMPAT_FLAG 0x1
 
+// Everything between the syscall vector and the local APIC's own vectors.
+#define FIRST_MSI_INTERRUPT_NUMBER (0xa0 - IRQ_VECTOR_BASE)
+#define MSI_INTERRUPT_NUMBER_COUNT (0xfb - 0xa0)
+
 namespace Kernel {
 
 static InterruptManagement* s_interrupt_management;
@@ -105,6 +110,42 @@ RefPtr<IRQController> InterruptManagement::get_responsible_irq_controller(u8 int
     VERIFY_NOT_REACHED();
 }
 
+bool InterruptManagement::is_message_signalled_interrupt_supported() const
+{
+    // The messages are delivered straight to the local APICs, which we only set up in IOAPIC mode.
+    if (!m_message_signalled_interrupts_enabled)
+        return false;
+    if (auto* parser = ACPI::Parser::the(); parser && parser->x86_specific_flags().msi_not_supported)
+        return false;
+    return true;
+}
+
+Optional<u8> InterruptManagement::allocate_message_signalled_interrupt_number()
+{
+    ScopedSpinLock lock(m_message_signalled_interrupts_lock);
+    auto index = m_allocated_message_signalled_interrupts.find_first_unset();
+    if (!index.has_value())
+        return {};
+    m_allocated_message_signalled_interrupts.set(index.value(), true);
+    return FIRST_MSI_INTERRUPT_NUMBER + index.value();
+}
+
+void InterruptManagement::release_message_signalled_interrupt_number(u8 interrupt_number)
+{
+    VERIFY(interrupt_number >= FIRST_MSI_INTERRUPT_NUMBER && interrupt_number < FIRST_MSI_INTERRUPT_NUMBER + MSI_INTERRUPT_NUMBER_COUNT);
+    ScopedSpinLock lock(m_message_signalled_interrupts_lock);
+    VERIFY(m_allocated_message_signalled_interrupts.get(interrupt_number - FIRST_MSI_INTERRUPT_NUMBER));
+    m_allocated_message_signalled_interrupts.set(interrupt_number - FIRST_MSI_INTERRUPT_NUMBER, false);
+}
+
+u32 InterruptManagement::next_processor_for_message_signalled_interrupt()
+{
+    ScopedSpinLock lock(m_message_signalled_interrupts_lock);
+    auto processor = m_next_message_signalled_interrupt_processor;
+    m_next_message_signalled_interrupt_processor = (processor + 1) % Processor::count();
+    return processor;
+}
+
 UNMAP_AFTER_INIT PhysicalAddress InterruptManagement::search_for_madt()
 {
     dbgln("Early access to ACPI tables for interrupt setup");
@@ -116,6 +157,7 @@ UNMAP_AFTER_INIT PhysicalAddress InterruptManagement::search_for_madt()
 
 UNMAP_AFTER_INIT InterruptManagement::InterruptManagement()
     : m_madt(search_for_madt())
+    , m_allocated_message_signalled_interrupts(MSI_INTERRUPT_NUMBER_COUNT, false)
 {
     m_interrupt_controllers.resize(1);
 }
@@ -174,6 +216,7 @@ UNMAP_AFTER_INIT void InterruptManagement::switch_to_ioapic_mode()
     }
 
     APIC::the().init_bsp();
+    m_message_signalled_interrupts_enabled = kernel_command_line().is_msi_enabled();
 }
 
 UNMAP_AFTER_INIT void InterruptManagement::locate_apic_data()
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Bitmap.h>
 #include <AK/Function.h>
 #include <AK/NonnullOwnPtr.h>
 #include <AK/OwnPtr.h>
@@ -16,6 +17,7 @@
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 #include <Kernel/Interrupts/IOAPIC.h>
 #include <Kernel/Interrupts/IRQController.h>
+#include <Kernel/SpinLock.h>
 
 namespace Kernel {
 
@@ -63,6 +65,14 @@ public:
     void enumerate_interrupt_handlers(Function<void(GenericInterruptHandler&)>);
     IRQController& get_interrupt_controller(int index);
 
+    // Message signalled interrupts get an interrupt number of their own, outside the range used
+    // by the IRQ controllers. They are handed out to the processors in turn, so that the
+    // interrupt load of multiple devices is spread out by default.
+    bool is_message_signalled_interrupt_supported() const;
+    Optional<u8> allocate_message_signalled_interrupt_number();
+    void release_message_signalled_interrupt_number(u8);
+    u32 next_processor_for_message_signalled_interrupt();
+
 protected:
     virtual ~InterruptManagement() = default;
 
@@ -71,10 +81,14 @@ private:
     PhysicalAddress search_for_madt();
     void locate_apic_data();
     bool m_smp_enabled { false };
+    bool m_message_signalled_interrupts_enabled { false };
     Vector<RefPtr<IRQController>> m_interrupt_controllers;
     Vector<ISAInterruptOverrideMetadata> m_isa_interrupt_overrides;
     Vector<PCIInterruptOverrideMetadata> m_pci_interrupt_overrides;
     PhysicalAddress m_madt;
+    SpinLock<u8> m_message_signalled_interrupts_lock;
+    Bitmap m_allocated_message_signalled_interrupts;
+    u32 m_next_message_signalled_interrupt_processor { 0 };
 };
 
 }
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/KTrace.h>
+#include <Kernel/PerformanceEventBuffer.h>
+#include <Kernel/Process.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+u32 KTrace::s_categories;
+
+// The buffer is never freed once it exists, since a tracepoint on another processor may still be appending to it
+// right after tracing was disabled.
+static PerformanceEventBuffer* s_buffer;
+static ProcessID s_pid { -1 };
+static constexpr size_t buffer_size = 16 * MiB;
+
+KResult KTrace::enable(ProcessID pid, u32 categories)
+{
+    if (categories & ~KTRACE_ALL)
+        return EINVAL;
+
+    ScopedCritical critical;
+    s_categories = 0;
+    if (s_buffer) {
+        s_buffer->clear();
+    } else {
+        s_buffer = PerformanceEventBuffer::try_create_with_size(buffer_size, PerformanceEventBuffer::WhenFull::OverwriteOldestEvents).leak_ptr();
+        if (!s_buffer)
+            return ENOMEM;
+    }
+    s_pid = pid;
+    s_categories = categories;
+    return KSuccess;
+}
+
+void KTrace::disable()
+{
+    s_categories = 0;
+}
+
+bool KTrace::to_json(KBufferBuilder& builder)
+{
+    if (!s_buffer)
+        return false;
+    return s_buffer->to_json(builder);
+}
+
+static bool is_traced(const Thread& thread)
+{
+    return s_pid == -1 || thread.pid() == s_pid;
+}
+
+static void append(int type, const Thread& thread, const PerformanceEvent::Data& data)
+{
+    // The buffer keeps the newest events when it's full, so this can't fail.
+    [[maybe_unused]] auto result = s_buffer->append_trace_event(type, thread.tid(), thread.pid(), TimeManagement::the().precise_uptime_ns(), data);
+}
+
+void KTrace::syscall_enter(const Thread& thread, u32 function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3)
+{
+    if (!is_traced(thread))
+        return;
+    PerformanceEvent::Data data;
+    data.syscall_enter = { function, { arg1, arg2, arg3 } };
+    append(PERF_EVENT_SYSCALL_ENTER, thread, data);
+}
+
+void KTrace::syscall_exit(const Thread& thread, u32 function, FlatPtr result)
+{
+    if (!is_traced(thread))
+        return;
+    PerformanceEvent::Data data;
+    data.syscall_exit = { function, result };
+    append(PERF_EVENT_SYSCALL_EXIT, thread, data);
+}
+
+void KTrace::context_switch(const Thread& from, const Thread& to)
+{
+    if (!is_traced(from) && !is_traced(to))
+        return;
+    PerformanceEvent::Data data;
+    data.context_switch = { (u32)to.tid().value(), (u32)to.pid().value(), from.state() };
+    append(PERF_EVENT_CONTEXT_SWITCH, from, data);
+}
+
+void KTrace::page_fault(const Thread& thread, FlatPtr address, FlatPtr instruction_pointer, u16 code)
+{
+    if (!is_traced(thread))
+        return;
+    PerformanceEvent::Data data;
+    data.page_fault = { address, instruction_pointer, code };
+    append(PERF_EVENT_PAGE_FAULT, thread, data);
+}
+
+void KTrace::block_io(AsyncBlockDeviceRequest& request, u8 result)
+{
+    // Requests the kernel makes on its own behalf (like flushing the disk cache) have nobody to blame them on.
+    auto* thread = request.requesting_thread();
+    if (!thread || !is_traced(*thread))
+        return;
+    auto now = TimeManagement::the().precise_uptime_ns();
+    auto latency_ns = now - min<u64>(now, request.issue_time().to_nanoseconds());
+
+    PerformanceEvent::Data data;
+    data.block_io = {
+        request.block_index(),
+        request.block_count(),
+        (u32)min<u64>(latency_ns / 1000, NumericLimits<u32>::max()),
+        (u16)request.block_device().major(),
+        (u16)request.block_device().minor(),
+        request.request_type() == AsyncBlockDeviceRequest::Write,
+        result,
+    };
+    [[maybe_unused]] auto append_result = s_buffer->append_trace_event(PERF_EVENT_BLOCK_IO, thread->tid(), thread->pid(), now, data);
+}
+
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Format.h>
+#include <AK/Types.h>
+#include <Kernel/Forward.h>
+#include <Kernel/KResult.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+class AsyncBlockDeviceRequest;
+class KBufferBuilder;
+
+// Tracepoints for syscalls, context switches, page faults and block I/O. While a category is being traced, its
+// tracepoints append small events (without a backtrace) to a global PerformanceEventBuffer, which is read from
+// /proc/ktrace. Otherwise, a tracepoint costs a load and a branch, so they're cheap enough to leave in hot paths:
+//
+//     if (KTrace::is_tracing(KTRACE_SYSCALLS))
+//         KTrace::syscall_enter(thread, function, arg1, arg2, arg3);
+class KTrace {
+public:
+    // Starts tracing the given categories, for one process or for all of them (pid -1).
+    // The events of the previous trace, if any, are thrown away.
+    static KResult enable(ProcessID, u32 categories);
+    static void disable();
+
+    static bool to_json(KBufferBuilder&);
+
+    ALWAYS_INLINE static bool is_tracing(u32 category) { return s_categories & category; }
+
+    static void syscall_enter(const Thread&, u32 function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3);
+    static void syscall_exit(const Thread&, u32 function, FlatPtr result);
+    static void context_switch(const Thread& from, const Thread& to);
+    static void page_fault(const Thread&, FlatPtr address, FlatPtr instruction_pointer, u16 code);
+    static void block_io(AsyncBlockDeviceRequest&, u8 result);
+
+private:
+    static u32 s_categories;
+};
+
+}
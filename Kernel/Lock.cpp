@@ -8,10 +8,64 @@
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Lock.h>
+#include <Kernel/SpinLock.h>
+#include <Kernel/StdLib.h>
 #include <Kernel/Thread.h>
 
 namespace Kernel {
 
+// Statistics live in a fixed table, since recording contention must not allocate.
+// Locks whose name doesn't fit anymore are all counted in the last slot.
+static constexpr size_t max_lock_statistics = 256;
+static LockStatistics s_lock_statistics[max_lock_statistics];
+static size_t s_lock_statistics_count;
+static SpinLock<u8> s_lock_statistics_lock;
+
+static LockStatistics& statistics_for_lock_name(const char* name)
+{
+    if (!name)
+        name = "(unnamed)";
+    ScopedSpinLock lock(s_lock_statistics_lock);
+    for (size_t i = 0; i < s_lock_statistics_count; ++i) {
+        auto& statistics = s_lock_statistics[i];
+        if (statistics.name == name || !strcmp(statistics.name, name))
+            return statistics;
+    }
+    if (s_lock_statistics_count == max_lock_statistics - 1) {
+        auto& overflow = s_lock_statistics[max_lock_statistics - 1];
+        overflow.name = "(other)";
+        return overflow;
+    }
+    auto& statistics = s_lock_statistics[s_lock_statistics_count++];
+    statistics.name = name;
+    return statistics;
+}
+
+void Lock::for_each_statistics(Function<void(const LockStatistics&)> callback)
+{
+    size_t count;
+    {
+        ScopedSpinLock lock(s_lock_statistics_lock);
+        count = s_lock_statistics_count;
+    }
+    for (size_t i = 0; i < count; ++i)
+        callback(s_lock_statistics[i]);
+    if (s_lock_statistics[max_lock_statistics - 1].name)
+        callback(s_lock_statistics[max_lock_statistics - 1]);
+}
+
+bool Lock::spin_while_holder_is_running(const Thread& holder)
+{
+    for (size_t i = 0; i < max_spin_iterations; ++i) {
+        if (m_mode == Mode::Unlocked)
+            return true;
+        if (holder.state() != Thread::Running)
+            return false;
+        Processor::wait_check();
+    }
+    return false;
+}
+
 #if LOCK_DEBUG
 void Lock::lock(Mode mode)
 {
@@ -29,10 +83,33 @@ void Lock::lock(Mode mode)
     VERIFY(mode != Mode::Unlocked);
     auto current_thread = Thread::current();
     ScopedCritical critical; // in case we're not in a critical section already
+    bool was_contended = false;
+    bool did_spin = false;
+    bool did_block = false;
+    auto record_contention = [&] {
+        if (!was_contended)
+            return;
+        if (!m_statistics)
+            m_statistics = &statistics_for_lock_name(m_name);
+        m_statistics->contended_count++;
+        if (!did_block)
+            m_statistics->spin_acquired_count++;
+    };
     for (;;) {
+        RefPtr<Thread> holder;
         if (m_lock.exchange(true, AK::memory_order_acq_rel) != false) {
+            // "m_lock" is only ever held for a few instructions, so spin a little before yielding.
+            bool acquired = false;
+            for (size_t i = 0; i < max_spin_iterations && Processor::count() > 1; ++i) {
+                Processor::wait_check();
+                if (!m_lock.load(AK::memory_order_relaxed)) {
+                    acquired = true;
+                    break;
+                }
+            }
             // I don't know *who* is using "m_lock", so just yield.
-            Scheduler::yield_from_critical();
+            if (!acquired)
+                Scheduler::yield_from_critical();
             continue;
         }
 
@@ -57,12 +134,15 @@ void Lock::lock(Mode mode)
 #endif
             m_queue.should_block(true);
             m_lock.store(false, AK::memory_order_release);
+            record_contention();
             return;
         }
         case Mode::Exclusive: {
             VERIFY(m_holder);
-            if (m_holder != current_thread)
+            if (m_holder != current_thread) {
+                holder = m_holder;
                 break;
+            }
             VERIFY(m_shared_holders.is_empty());
 
             if constexpr (LOCK_TRACE_DEBUG) {
@@ -79,6 +159,7 @@ void Lock::lock(Mode mode)
             current_thread->holding_lock(*this, 1, file, line);
 #endif
             m_lock.store(false, AK::memory_order_release);
+            record_contention();
             return;
         }
         case Mode::Shared: {
@@ -100,12 +181,26 @@ void Lock::lock(Mode mode)
             current_thread->holding_lock(*this, 1, file, line);
 #endif
             m_lock.store(false, AK::memory_order_release);
+            record_contention();
             return;
         }
         default:
             VERIFY_NOT_REACHED();
         }
         m_lock.store(false, AK::memory_order_release);
+        was_contended = true;
+
+        // Spinning only makes sense if the holder is running on some other CPU.
+        if (!did_spin && holder && Processor::count() > 1) {
+            did_spin = true;
+            if (spin_while_holder_is_running(*holder))
+                continue;
+        }
+
+        did_block = true;
+        if (!m_statistics)
+            m_statistics = &statistics_for_lock_name(m_name);
+        m_statistics->block_count++;
         dbgln_if(LOCK_TRACE_DEBUG, "Lock::lock @ {} ({}) waiting...", this, m_name);
         m_queue.wait_forever(m_name);
         dbgln_if(LOCK_TRACE_DEBUG, "Lock::lock @ {} ({}) waited", this, m_name);
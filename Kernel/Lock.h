@@ -8,6 +8,7 @@
 
 #include <AK/Assertions.h>
 #include <AK/Atomic.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/Types.h>
 #include <Kernel/Arch/x86/CPU.h>
@@ -17,6 +18,17 @@
 
 namespace Kernel {
 
+// Contention counters, aggregated over all locks that share a name.
+struct LockStatistics {
+    const char* name { nullptr };
+    // Acquisitions that found the lock held by someone else.
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> contended_count { 0 };
+    // Contended acquisitions that succeeded while spinning, without going to sleep.
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> spin_acquired_count { 0 };
+    // Number of times a thread went to sleep waiting for the lock.
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> block_count { 0 };
+};
+
 class Lock {
     AK_MAKE_NONCOPYABLE(Lock);
     AK_MAKE_NONMOVABLE(Lock);
@@ -43,6 +55,8 @@ public:
 
     [[nodiscard]] const char* name() const { return m_name; }
 
+    static void for_each_statistics(Function<void(const LockStatistics&)>);
+
     static const char* mode_to_string(Mode mode)
     {
         switch (mode) {
@@ -58,6 +72,14 @@ public:
     }
 
 private:
+    // While the holder of a contended lock is running on another CPU, it
+    // will likely release the lock soon, so we spin for a while instead of
+    // going to sleep right away.
+    static constexpr size_t max_spin_iterations = 1000;
+    bool spin_while_holder_is_running(const Thread& holder);
+
+    LockStatistics* m_statistics { nullptr };
+
     Atomic<bool> m_lock { false };
     const char* m_name { nullptr };
     WaitQueue m_queue;
@@ -5,8 +5,13 @@
  */
 
 #include <AK/MACAddress.h>
+#include <Kernel/CommandLine.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Net/E1000NetworkAdapter.h>
+#include <Kernel/Net/EtherType.h>
+#include <Kernel/Net/EthernetFrameHeader.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Process.h>
 
 namespace Kernel {
 
@@ -35,6 +40,8 @@ namespace Kernel {
 #define REG_RADV 0x282C             // RX Int. Absolute Delay Timer
 #define REG_RSRPD 0x2C00            // RX Small Packet Detect Interrupt
 #define REG_TIPG 0x0410             // Transmit Inter Packet Gap
+#define REG_MPC 0x4010              // Missed Packets Count
+#define REG_RXCSUM 0x5000           // RX Checksum Control
 #define ECTRL_SLU 0x40              //set link up
 #define RCTL_EN (1 << 1)            // Receiver Enable
 #define RCTL_SBP (1 << 2)           // Store Bad Packets
@@ -77,6 +84,20 @@ namespace Kernel {
 #define CMD_VLE (1 << 6)  // VLAN Packet Enable
 #define CMD_IDE (1 << 7)  // Interrupt Delay Enable
 
+// Extended Transmit Descriptors (Section 3.3.6 and 3.3.7)
+
+#define TXD_DTYP_CONTEXT (0 << 20)
+#define TXD_DTYP_DATA (1 << 20)
+#define TXD_CMD_EOP (1 << 24)     // End of Packet (data)
+#define TXD_CMD_TCP (1 << 24)     // Packet is TCP (context)
+#define TXD_CMD_IFCS (1 << 25)    // Insert FCS (data)
+#define TXD_CMD_IP (1 << 25)      // Packet is IPv4 (context)
+#define TXD_CMD_TSE (1 << 26)     // TCP Segmentation Enable
+#define TXD_CMD_RS (1 << 27)      // Report Status
+#define TXD_CMD_DEXT (1 << 29)    // Descriptor Extension
+#define TXD_POPTS_IXSM (1 << 0)   // Insert IP Checksum
+#define TXD_POPTS_TXSM (1 << 1)   // Insert TCP/UDP Checksum
+
 // TCTL Register
 
 #define TCTL_EN (1 << 1)      // Transmit Enable
@@ -91,6 +112,22 @@ namespace Kernel {
 #define TSTA_LC (1 << 2) // Late Collision
 #define LSTA_TU (1 << 3) // Transmit Underrun
 
+// Receive Descriptor Status
+
+#define RSTA_DD (1 << 0)   // Descriptor Done
+#define RSTA_EOP (1 << 1)  // End of Packet
+#define RSTA_IXSM (1 << 2) // Ignore Checksum Indication
+
+// Receive Descriptor Errors
+
+#define RERR_TCPE (1 << 5) // TCP/UDP Checksum Error
+#define RERR_IPE (1 << 6)  // IP Checksum Error
+
+// RXCSUM Register
+
+#define RXCSUM_IPOFLD (1 << 8) // IP Checksum Offload Enable
+#define RXCSUM_TUOFLD (1 << 9) // TCP/UDP Checksum Offload Enable
+
 // STATUS Register
 
 #define STATUS_FD 0x01
@@ -117,6 +154,8 @@ namespace Kernel {
 #define INTERRUPT_TXD_LOW (1 << 15)
 #define INTERRUPT_SRPD (1 << 16)
 
+#define RX_INTERRUPTS (INTERRUPT_RXDMT0 | INTERRUPT_RXO | INTERRUPT_RXT0)
+
 // https://www.intel.com/content/dam/doc/manual/pci-pci-x-family-gbe-controllers-software-dev-manual.pdf Section 5.2
 static bool is_valid_device_id(u16 device_id)
 {
@@ -172,8 +211,6 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::detect()
 UNMAP_AFTER_INIT E1000NetworkAdapter::E1000NetworkAdapter(PCI::Address address, u8 irq)
     : PCI::Device(address, irq)
     , m_io_base(PCI::get_BAR1(pci_address()) & ~1)
-    , m_rx_descriptors_region(MM.allocate_contiguous_kernel_region(page_round_up(sizeof(e1000_rx_desc) * number_of_rx_descriptors + 16), "E1000 RX", Region::Access::Read | Region::Access::Write))
-    , m_tx_descriptors_region(MM.allocate_contiguous_kernel_region(page_round_up(sizeof(e1000_tx_desc) * number_of_tx_descriptors + 16), "E1000 TX", Region::Access::Read | Region::Access::Write))
 {
     set_interface_name("e1k");
 
@@ -199,15 +236,28 @@ UNMAP_AFTER_INIT E1000NetworkAdapter::E1000NetworkAdapter(PCI::Address address,
     u32 flags = in32(REG_CTRL);
     out32(REG_CTRL, flags | ECTRL_SLU);
 
-    out32(REG_INTERRUPT_RATE, 6000); // Interrupt rate of 1.536 milliseconds
+    // The interrupt throttling register counts in units of 256ns.
+    u32 interrupt_rate = kernel_command_line().e1000_interrupt_rate().value_or(default_interrupt_rate);
+    u32 interrupt_interval = interrupt_rate ? 1'000'000'000 / (interrupt_rate * 256) : 0;
+    out32(REG_INTERRUPT_RATE, interrupt_interval);
+    dmesgln("E1000: Throttling interrupts to {} per second", interrupt_rate);
+
+    // The descriptor ring lengths have to be a multiple of 128 bytes, i.e. 8 descriptors.
+    auto ring_size = [](size_t requested) { return clamp((size_t)round_up_to_power_of_two(requested, 8), (size_t)8, max_number_of_descriptors); };
+    m_number_of_rx_descriptors = ring_size(kernel_command_line().e1000_rx_ring_size().value_or(default_number_of_rx_descriptors));
+    m_number_of_tx_descriptors = ring_size(kernel_command_line().e1000_tx_ring_size().value_or(default_number_of_tx_descriptors));
+    dmesgln("E1000: {} RX and {} TX descriptors", m_number_of_rx_descriptors, m_number_of_tx_descriptors);
 
     initialize_rx_descriptors();
     initialize_tx_descriptors();
+    initialize_offloads();
 
-    out32(REG_INTERRUPT_MASK_SET, 0x1f6dc);
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0);
+    out32(REG_INTERRUPT_MASK_CLEAR, 0xffffffff);
+    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_TXDW | RX_INTERRUPTS);
     in32(REG_INTERRUPT_CAUSE_READ);
 
+    if (try_to_enable_message_signalled_interrupts(pci_address()))
+        dmesgln("E1000: Using MSI {} on CPU #{}", interrupt_number(), target_processor());
     enable_irq();
 }
 
@@ -217,26 +267,23 @@ UNMAP_AFTER_INIT E1000NetworkAdapter::~E1000NetworkAdapter()
 
 void E1000NetworkAdapter::handle_irq(const RegisterState&)
 {
-    out32(REG_INTERRUPT_MASK_CLEAR, 0xffffffff);
-
     u32 status = in32(REG_INTERRUPT_CAUSE_READ);
 
     m_entropy_source.add_random_event(status);
 
-    if (status & 4) {
+    if (status & INTERRUPT_LSC) {
         u32 flags = in32(REG_CTRL);
         out32(REG_CTRL, flags | ECTRL_SLU);
     }
-    if (status & 0x80) {
-        receive();
-    }
-    if (status & 0x10) {
-        // Threshold OK?
+    if (status & RX_INTERRUPTS) {
+        // Don't touch the ring here, NetworkTask will poll the packets out of it. Until it has
+        // caught up with the hardware, further receive interrupts would only be in the way.
+        out32(REG_INTERRUPT_MASK_CLEAR, RX_INTERRUPTS);
+        m_rx_polling = true;
+        schedule_polling();
     }
-
-    m_wait_queue.wake_all();
-
-    out32(REG_INTERRUPT_MASK_SET, INTERRUPT_LSC | INTERRUPT_RXT0 | INTERRUPT_RXO);
+    if (status & INTERRUPT_TXDW)
+        m_wait_queue.wake_all();
 }
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::detect_eeprom()
@@ -295,40 +342,46 @@ bool E1000NetworkAdapter::link_up()
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_rx_descriptors()
 {
-    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    for (size_t i = 0; i < number_of_rx_descriptors; ++i) {
+    m_rx_descriptors_region = MM.allocate_contiguous_kernel_region(page_round_up(sizeof(e1000_rx_desc) * m_number_of_rx_descriptors + 16), "E1000 RX", Region::Access::Read | Region::Access::Write);
+    m_rx_buffers_region = MM.allocate_contiguous_kernel_region(page_round_up(rx_buffer_size * m_number_of_rx_descriptors), "E1000 RX buffers", Region::Access::Read | Region::Access::Write);
+    VERIFY(m_rx_descriptors_region);
+    VERIFY(m_rx_buffers_region);
+
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
+    auto rx_buffers_paddr = m_rx_buffers_region->physical_page(0)->paddr();
+    for (size_t i = 0; i < m_number_of_rx_descriptors; ++i) {
         auto& descriptor = rx_descriptors[i];
-        auto region = MM.allocate_contiguous_kernel_region(8192, "E1000 RX buffer", Region::Access::Read | Region::Access::Write);
-        VERIFY(region);
-        m_rx_buffers_regions.append(region.release_nonnull());
-        descriptor.addr = m_rx_buffers_regions[i].physical_page(0)->paddr().get();
+        descriptor.addr = rx_buffers_paddr.offset(i * rx_buffer_size).get();
         descriptor.status = 0;
     }
 
     out32(REG_RXDESCLO, m_rx_descriptors_region->physical_page(0)->paddr().get());
     out32(REG_RXDESCHI, 0);
-    out32(REG_RXDESCLEN, number_of_rx_descriptors * sizeof(e1000_rx_desc));
+    out32(REG_RXDESCLEN, m_number_of_rx_descriptors * sizeof(e1000_rx_desc));
     out32(REG_RXDESCHEAD, 0);
-    out32(REG_RXDESCTAIL, number_of_rx_descriptors - 1);
+    out32(REG_RXDESCTAIL, m_number_of_rx_descriptors - 1);
 
-    out32(REG_RCTRL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_8192);
+    out32(REG_RCTRL, RCTL_EN | RCTL_SBP | RCTL_UPE | RCTL_MPE | RCTL_LBM_NONE | RTCL_RDMTS_HALF | RCTL_BAM | RCTL_SECRC | RCTL_BSIZE_2048);
 }
 
 UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
 {
+    m_tx_descriptors_region = MM.allocate_contiguous_kernel_region(page_round_up(sizeof(e1000_tx_desc) * m_number_of_tx_descriptors + 16), "E1000 TX", Region::Access::Read | Region::Access::Write);
+    m_tx_buffers_region = MM.allocate_contiguous_kernel_region(page_round_up(tx_buffer_size * m_number_of_tx_descriptors), "E1000 TX buffers", Region::Access::Read | Region::Access::Write);
+    VERIFY(m_tx_descriptors_region);
+    VERIFY(m_tx_buffers_region);
+
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
-    for (size_t i = 0; i < number_of_tx_descriptors; ++i) {
+    auto tx_buffers_paddr = m_tx_buffers_region->physical_page(0)->paddr();
+    for (size_t i = 0; i < m_number_of_tx_descriptors; ++i) {
         auto& descriptor = tx_descriptors[i];
-        auto region = MM.allocate_contiguous_kernel_region(8192, "E1000 TX buffer", Region::Access::Read | Region::Access::Write);
-        VERIFY(region);
-        m_tx_buffers_regions.append(region.release_nonnull());
-        descriptor.addr = m_tx_buffers_regions[i].physical_page(0)->paddr().get();
+        descriptor.addr = tx_buffers_paddr.offset(i * tx_buffer_size).get();
         descriptor.cmd = 0;
     }
 
     out32(REG_TXDESCLO, m_tx_descriptors_region->physical_page(0)->paddr().get());
     out32(REG_TXDESCHI, 0);
-    out32(REG_TXDESCLEN, number_of_tx_descriptors * sizeof(e1000_tx_desc));
+    out32(REG_TXDESCLEN, m_number_of_tx_descriptors * sizeof(e1000_tx_desc));
     out32(REG_TXDESCHEAD, 0);
     out32(REG_TXDESCTAIL, 0);
 
@@ -336,6 +389,20 @@ UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_tx_descriptors()
     out32(REG_TIPG, 0x0060200A);
 }
 
+UNMAP_AFTER_INIT void E1000NetworkAdapter::initialize_offloads()
+{
+    out32(REG_RXCSUM, in32(REG_RXCSUM) | RXCSUM_IPOFLD | RXCSUM_TUOFLD);
+
+    auto offloads = Offload::ReceiveChecksum | Offload::TransmitTCPChecksum;
+    // The 82547 can only segment from its small on-chip FIFO, so don't bother.
+    auto device_id = PCI::get_id(pci_address()).device_id;
+    bool is_82547 = device_id == 0x1019 || device_id == 0x101A;
+    if (!is_82547 && m_number_of_tx_descriptors >= min_number_of_tx_descriptors_for_segmentation)
+        offloads |= Offload::TCPSegmentation;
+    set_offloads(offloads);
+    dmesgln("E1000: Checksum offload enabled, TCP segmentation offload {}", has_offload(Offload::TCPSegmentation) ? "enabled" : "disabled");
+}
+
 void E1000NetworkAdapter::out8(u16 address, u8 data)
 {
     dbgln_if(E1000_DEBUG, "E1000: OUT8 {:#02x} @ {:#04x}", data, address);
@@ -393,52 +460,154 @@ u32 E1000NetworkAdapter::in32(u16 address)
     return m_io_base.offset(address).in<u32>();
 }
 
+void E1000NetworkAdapter::wait_for_free_tx_descriptors(size_t count)
+{
+    // The tail must never catch up with the head, or the hardware would think the ring is empty.
+    auto free_descriptors = [&] {
+        return (in32(REG_TXDESCHEAD) + m_number_of_tx_descriptors - m_tx_current - 1) % m_number_of_tx_descriptors;
+    };
+    while (free_descriptors() < count)
+        m_wait_queue.wait_forever("E1000NetworkAdapter");
+}
+
 void E1000NetworkAdapter::send_raw(ReadonlyBytes payload)
 {
-    disable_irq();
-    size_t tx_current = in32(REG_TXDESCTAIL) % number_of_tx_descriptors;
+    VERIFY(payload.size() <= tx_buffer_size);
+
+    LOCKER(m_tx_lock);
+    wait_for_free_tx_descriptors(1);
+
     dbgln_if(E1000_DEBUG, "E1000: Sending packet ({} bytes)", payload.size());
     auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
-    auto& descriptor = tx_descriptors[tx_current];
-    VERIFY(payload.size() <= 8192);
-    auto* vptr = (void*)m_tx_buffers_regions[tx_current].vaddr().as_ptr();
-    memcpy(vptr, payload.data(), payload.size());
+    auto& descriptor = tx_descriptors[m_tx_current];
+    memcpy(tx_buffer(m_tx_current), payload.data(), payload.size());
+    // Context descriptors may have used this slot before, so none of it can be taken for granted.
+    descriptor.addr = tx_buffer_paddr(m_tx_current).get();
     descriptor.length = payload.size();
+    descriptor.cso = 0;
     descriptor.status = 0;
+    descriptor.css = 0;
+    descriptor.special = 0;
     descriptor.cmd = CMD_EOP | CMD_IFCS | CMD_RS;
-    dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", tx_current, in32(REG_TXDESCHEAD));
-    tx_current = (tx_current + 1) % number_of_tx_descriptors;
-    cli();
-    enable_irq();
-    out32(REG_TXDESCTAIL, tx_current);
-    for (;;) {
-        if (descriptor.status) {
-            sti();
-            break;
-        }
-        m_wait_queue.wait_forever("E1000NetworkAdapter");
+    dbgln_if(E1000_DEBUG, "E1000: Using tx descriptor {} (head is at {})", m_tx_current, in32(REG_TXDESCHEAD));
+    m_tx_current = (m_tx_current + 1) % m_number_of_tx_descriptors;
+    out32(REG_TXDESCTAIL, m_tx_current);
+}
+
+void E1000NetworkAdapter::send_raw_with_tcp_checksum(ReadonlyBytes frame)
+{
+    VERIFY(frame.size() <= tx_buffer_size);
+    send_raw_with_offloads(frame, 0);
+}
+
+void E1000NetworkAdapter::send_raw_tcp_segmentation(ReadonlyBytes frame, u16 mss)
+{
+    VERIFY(mss > 0);
+    send_raw_with_offloads(frame, mss);
+}
+
+void E1000NetworkAdapter::send_raw_with_offloads(ReadonlyBytes frame, u16 mss)
+{
+    constexpr size_t ipv4_offset = sizeof(EthernetFrameHeader);
+    constexpr size_t tcp_offset = ipv4_offset + sizeof(IPv4Packet);
+    auto& tcp_packet = *(const TCPPacket*)(frame.data() + tcp_offset);
+    size_t header_size = tcp_offset + tcp_packet.header_size();
+    bool segment = mss != 0;
+
+    // One context descriptor, followed by as many data descriptors as it takes to hold the frame.
+    size_t data_descriptor_count = (frame.size() + tx_buffer_size - 1) / tx_buffer_size;
+    VERIFY(data_descriptor_count + 1 < m_number_of_tx_descriptors);
+
+    LOCKER(m_tx_lock);
+    wait_for_free_tx_descriptors(data_descriptor_count + 1);
+
+    dbgln_if(E1000_DEBUG, "E1000: Sending packet with offloads ({} bytes, mss {})", frame.size(), mss);
+    auto* tx_descriptors = (e1000_tx_desc*)m_tx_descriptors_region->vaddr().as_ptr();
+
+    auto& context = *(e1000_tx_context_desc*)&tx_descriptors[m_tx_current];
+    context.ipcss = ipv4_offset;
+    context.ipcso = ipv4_offset + 10;
+    context.ipcse = tcp_offset - 1;
+    context.tucss = tcp_offset;
+    context.tucso = tcp_offset + 16;
+    context.tucse = 0;
+    u32 context_command = TXD_DTYP_CONTEXT | TXD_CMD_TCP | TXD_CMD_IP | TXD_CMD_DEXT;
+    if (segment)
+        context_command |= TXD_CMD_TSE | (frame.size() - header_size);
+    context.paylen_and_command = context_command;
+    context.status = 0;
+    context.hdrlen = segment ? header_size : 0;
+    context.mss = mss;
+    m_tx_current = (m_tx_current + 1) % m_number_of_tx_descriptors;
+
+    for (size_t offset = 0; offset < frame.size(); offset += tx_buffer_size) {
+        size_t length = min(tx_buffer_size, frame.size() - offset);
+        memcpy(tx_buffer(m_tx_current), frame.data() + offset, length);
+        auto& descriptor = *(e1000_tx_data_desc*)&tx_descriptors[m_tx_current];
+        descriptor.addr = tx_buffer_paddr(m_tx_current).get();
+        u32 command = length | TXD_DTYP_DATA | TXD_CMD_IFCS | TXD_CMD_DEXT;
+        if (segment)
+            command |= TXD_CMD_TSE;
+        if (offset + length == frame.size())
+            command |= TXD_CMD_EOP | TXD_CMD_RS;
+        descriptor.length_and_command = command;
+        descriptor.status = 0;
+        descriptor.popts = TXD_POPTS_IXSM | TXD_POPTS_TXSM;
+        descriptor.special = 0;
+        m_tx_current = (m_tx_current + 1) % m_number_of_tx_descriptors;
     }
-    dbgln_if(E1000_DEBUG, "E1000: Sent packet, status is now {:#02x}!", (u8)descriptor.status);
+    out32(REG_TXDESCTAIL, m_tx_current);
 }
 
-void E1000NetworkAdapter::receive()
+static bool has_bad_checksum(u8 status, u8 errors, const u8* frame, size_t length)
 {
-    auto* rx_descriptors = (e1000_tx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
-    u32 rx_current;
+    if (status & RSTA_IXSM)
+        return false;
+    if (errors & RERR_IPE)
+        return true;
+    if (!(errors & RERR_TCPE))
+        return false;
+    // UDP checksums are optional, so only believe the hardware about TCP.
+    if (length < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return false;
+    auto& eth = *(const EthernetFrameHeader*)frame;
+    auto& ipv4 = *(const IPv4Packet*)eth.payload();
+    return eth.ether_type() == EtherType::IPv4 && ipv4.protocol() == (u8)IPv4Protocol::TCP;
+}
+
+size_t E1000NetworkAdapter::poll_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
+{
+    auto* rx_descriptors = (e1000_rx_desc*)m_rx_descriptors_region->vaddr().as_ptr();
     for (;;) {
-        rx_current = in32(REG_RXDESCTAIL) % number_of_rx_descriptors;
-        if (rx_current == (in32(REG_RXDESCHEAD) % number_of_rx_descriptors))
-            return;
-        rx_current = (rx_current + 1) % number_of_rx_descriptors;
-        if (!(rx_descriptors[rx_current].status & 1))
-            break;
-        auto* buffer = m_rx_buffers_regions[rx_current].vaddr().as_ptr();
-        u16 length = rx_descriptors[rx_current].length;
-        VERIFY(length <= 8192);
-        dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {:p} ({} bytes)", buffer, length);
-        did_receive({ buffer, length });
-        rx_descriptors[rx_current].status = 0;
-        out32(REG_RXDESCTAIL, rx_current);
+        auto& descriptor = rx_descriptors[m_rx_current];
+        if (!(descriptor.status & RSTA_DD)) {
+            if (m_rx_polling.exchange(false)) {
+                // We've caught up with the hardware, so go back to waiting for interrupts.
+                did_drop_packets(in32(REG_MPC));
+                out32(REG_INTERRUPT_MASK_SET, RX_INTERRUPTS);
+            }
+            return 0;
+        }
+
+        u16 length = descriptor.length;
+        bool is_complete_packet = descriptor.status & RSTA_EOP;
+        VERIFY(length <= rx_buffer_size);
+        if (is_complete_packet && length > 0 && length <= buffer_size && !has_bad_checksum(descriptor.status, descriptor.errors, rx_buffer(m_rx_current), length)) {
+            dbgln_if(E1000_DEBUG, "E1000: Received 1 packet @ {} ({} bytes)", m_rx_current, length);
+            memcpy(buffer, rx_buffer(m_rx_current), length);
+            packet_timestamp = kgettimeofday();
+        } else {
+            did_drop_packets(1);
+            length = 0;
+        }
+
+        // Hand the descriptor back to the hardware.
+        descriptor.status = 0;
+        out32(REG_RXDESCTAIL, m_rx_current);
+        m_rx_current = (m_rx_current + 1) % m_number_of_rx_descriptors;
+
+        if (length)
+            return length;
     }
 }
 
@@ -6,7 +6,7 @@
 
 #pragma once
 
-#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Atomic.h>
 #include <AK/OwnPtr.h>
 #include <Kernel/IO.h>
 #include <Kernel/Interrupts/IRQHandler.h>
@@ -26,12 +26,15 @@ public:
     virtual ~E1000NetworkAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_tcp_checksum(ReadonlyBytes) override;
+    virtual void send_raw_tcp_segmentation(ReadonlyBytes, u16 mss) override;
     virtual bool link_up() override;
 
     virtual const char* purpose() const override { return class_name(); }
 
 private:
     virtual void handle_irq(const RegisterState&) override;
+    virtual size_t poll_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp) override;
     virtual const char* class_name() const override { return "E1000NetworkAdapter"; }
 
     struct [[gnu::packed]] e1000_rx_desc {
@@ -53,6 +56,31 @@ private:
         volatile uint16_t special { 0 };
     };
 
+    // The extended transmit descriptors, which share the ring with the legacy ones above. A context descriptor
+    // tells the hardware where the checksums go (and how to segment), and applies to the data descriptors after it.
+    struct [[gnu::packed]] e1000_tx_context_desc {
+        volatile uint8_t ipcss { 0 };
+        volatile uint8_t ipcso { 0 };
+        volatile uint16_t ipcse { 0 };
+        volatile uint8_t tucss { 0 };
+        volatile uint8_t tucso { 0 };
+        volatile uint16_t tucse { 0 };
+        volatile uint32_t paylen_and_command { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t hdrlen { 0 };
+        volatile uint16_t mss { 0 };
+    };
+
+    struct [[gnu::packed]] e1000_tx_data_desc {
+        volatile uint64_t addr { 0 };
+        volatile uint32_t length_and_command { 0 };
+        volatile uint8_t status { 0 };
+        volatile uint8_t popts { 0 };
+        volatile uint16_t special { 0 };
+    };
+
+    static_assert(sizeof(e1000_tx_desc) == 16 && sizeof(e1000_tx_context_desc) == 16 && sizeof(e1000_tx_data_desc) == 16);
+
     void detect_eeprom();
     u32 read_eeprom(u8 address);
     void read_mac_address();
@@ -62,6 +90,10 @@ private:
 
     void initialize_rx_descriptors();
     void initialize_tx_descriptors();
+    void initialize_offloads();
+
+    void wait_for_free_tx_descriptors(size_t count);
+    void send_raw_with_offloads(ReadonlyBytes frame, u16 mss);
 
     void out8(u16 address, u8);
     void out16(u16 address, u16);
@@ -70,23 +102,40 @@ private:
     u16 in16(u16 address);
     u32 in32(u16 address);
 
-    void receive();
+    u8* rx_buffer(size_t index) { return m_rx_buffers_region->vaddr().offset(index * rx_buffer_size).as_ptr(); }
+    u8* tx_buffer(size_t index) { return m_tx_buffers_region->vaddr().offset(index * tx_buffer_size).as_ptr(); }
+    PhysicalAddress tx_buffer_paddr(size_t index) { return m_tx_buffers_region->physical_page(0)->paddr().offset(index * tx_buffer_size); }
+
+    static constexpr size_t default_number_of_rx_descriptors = 256;
+    static constexpr size_t default_number_of_tx_descriptors = 128;
+    static constexpr size_t max_number_of_descriptors = 4096;
+    static constexpr size_t rx_buffer_size = 2048;
+    static constexpr size_t tx_buffer_size = 2048;
+    static constexpr u32 default_interrupt_rate = 8000;
+    // A 64 KiB segment spreads over 33 transmit buffers, so segmentation needs a ring with some room left.
+    static constexpr size_t min_number_of_tx_descriptors_for_segmentation = 64;
 
     IOAddress m_io_base;
     VirtualAddress m_mmio_base;
     OwnPtr<Region> m_rx_descriptors_region;
     OwnPtr<Region> m_tx_descriptors_region;
-    NonnullOwnPtrVector<Region> m_rx_buffers_regions;
-    NonnullOwnPtrVector<Region> m_tx_buffers_regions;
+    OwnPtr<Region> m_rx_buffers_region;
+    OwnPtr<Region> m_tx_buffers_region;
     OwnPtr<Region> m_mmio_region;
     u8 m_interrupt_line { 0 };
     bool m_has_eeprom { false };
     bool m_use_mmio { false };
     EntropySource m_entropy_source;
 
-    static const size_t number_of_rx_descriptors = 32;
-    static const size_t number_of_tx_descriptors = 8;
+    size_t m_number_of_rx_descriptors { default_number_of_rx_descriptors };
+    size_t m_number_of_tx_descriptors { default_number_of_tx_descriptors };
+    size_t m_rx_current { 0 };
+    size_t m_tx_current { 0 };
+
+    // Set while the receive interrupts are masked and NetworkTask is polling the ring.
+    Atomic<bool> m_rx_polling { false };
 
+    Lock m_tx_lock { "E1000NetworkAdapter TX" };
     WaitQueue m_wait_queue;
 };
 }
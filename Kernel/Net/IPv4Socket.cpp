@@ -13,6 +13,7 @@
 #include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/IPv4Socket.h>
 #include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/Net/NetworkTask.h>
 #include <Kernel/Net/Routing.h>
 #include <Kernel/Net/TCP.h>
 #include <Kernel/Net/TCPSocket.h>
@@ -170,9 +171,15 @@ int IPv4Socket::allocate_local_port_if_needed()
     return port;
 }
 
+void IPv4Socket::deliver_loopback_packets() const
+{
+    if (m_peer_address[0] == 127)
+        NetworkTask::process_loopback_packets();
+}
+
 KResultOr<size_t> IPv4Socket::sendto(FileDescription&, const UserOrKernelBuffer& data, size_t data_length, [[maybe_unused]] int flags, Userspace<const sockaddr*> addr, socklen_t addr_length)
 {
-    LOCKER(lock());
+    Locker locker(lock());
 
     if (addr && addr_length != sizeof(sockaddr_in))
         return EINVAL;
@@ -214,6 +221,27 @@ KResultOr<size_t> IPv4Socket::sendto(FileDescription&, const UserOrKernelBuffer&
     auto nsent_or_error = protocol_send(data, data_length);
     if (!nsent_or_error.is_error())
         Thread::current()->did_ipv4_socket_write(nsent_or_error.value());
+    locker.unlock();
+    deliver_loopback_packets();
+    return nsent_or_error;
+}
+
+KResultOr<size_t> IPv4Socket::sendfile(FileDescription&, FileDescription& source, u64 offset, size_t size)
+{
+    if (is_shut_down_for_writing())
+        return EPIPE;
+
+    Locker locker(lock());
+    if (type() != SOCK_STREAM)
+        return ENOTSUP;
+    if (!is_connected())
+        return ENOTCONN;
+
+    auto nsent_or_error = protocol_sendfile(source, offset, size);
+    if (!nsent_or_error.is_error())
+        Thread::current()->did_ipv4_socket_write(nsent_or_error.value());
+    locker.unlock();
+    deliver_loopback_packets();
     return nsent_or_error;
 }
 
@@ -435,10 +463,10 @@ String IPv4Socket::absolute_path(const FileDescription&) const
     return builder.to_string();
 }
 
-KResult IPv4Socket::setsockopt(int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+KResult IPv4Socket::setsockopt(FileDescription& description, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
 {
     if (level != IPPROTO_IP)
-        return Socket::setsockopt(level, option, user_value, user_value_size);
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
 
     switch (option) {
     case IP_TTL: {
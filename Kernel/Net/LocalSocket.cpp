@@ -344,6 +344,30 @@ String LocalSocket::absolute_path(const FileDescription& description) const
     return builder.to_string();
 }
 
+KResult LocalSocket::setsockopt(FileDescription& description, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+{
+    if (level != SOL_SOCKET || (option != SO_SNDBUF && option != SO_RCVBUF))
+        return Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    if (user_value_size < sizeof(int))
+        return EINVAL;
+    int value;
+    if (!copy_from_user(&value, static_ptr_cast<const int*>(user_value)))
+        return EFAULT;
+    if (value <= 0)
+        return EINVAL;
+    size_t new_size = clamp((size_t)value, min_buffer_size, max_buffer_size);
+
+    auto* socket_buffer = option == SO_SNDBUF ? send_buffer_for(description) : receive_buffer_for(description);
+    if (socket_buffer)
+        return socket_buffer->try_resize(new_size);
+
+    // We don't know which side this description is going to end up on yet, so resize both directions.
+    if (auto result = m_for_client.try_resize(new_size); result.is_error())
+        return result;
+    return m_for_server.try_resize(new_size);
+}
+
 KResult LocalSocket::getsockopt(FileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
 {
     if (level != SOL_SOCKET)
@@ -355,9 +379,18 @@ KResult LocalSocket::getsockopt(FileDescription& description, int level, int opt
 
     switch (option) {
     case SO_SNDBUF:
-        TODO();
-    case SO_RCVBUF:
-        TODO();
+    case SO_RCVBUF: {
+        if (size < sizeof(int))
+            return EINVAL;
+        auto* socket_buffer = option == SO_SNDBUF ? send_buffer_for(description) : receive_buffer_for(description);
+        int buffer_size = socket_buffer ? socket_buffer->capacity() : m_for_client.capacity();
+        if (!copy_to_user(static_ptr_cast<int*>(value), &buffer_size))
+            return EFAULT;
+        size = sizeof(int);
+        if (!copy_to_user(value_size, &size))
+            return EFAULT;
+        return KSuccess;
+    }
     case SO_PEERCRED: {
         if (size < sizeof(ucred))
             return EINVAL;
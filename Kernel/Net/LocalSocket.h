@@ -42,6 +42,7 @@ public:
     virtual bool can_write(const FileDescription&, size_t) const override;
     virtual KResultOr<size_t> sendto(FileDescription&, const UserOrKernelBuffer&, size_t, int, Userspace<const sockaddr*>, socklen_t) override;
     virtual KResultOr<size_t> recvfrom(FileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&) override;
+    virtual KResult setsockopt(FileDescription&, int level, int option, Userspace<const void*>, socklen_t) override;
     virtual KResult getsockopt(FileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
     virtual KResult chown(FileDescription&, uid_t, gid_t) override;
     virtual KResult chmod(FileDescription&, mode_t) override;
@@ -90,6 +91,10 @@ private:
     bool m_accept_side_fd_open { false };
     sockaddr_un m_address { 0, { 0 } };
 
+    // Bounds for SO_SNDBUF and SO_RCVBUF, which resize the buffers below.
+    static constexpr size_t min_buffer_size = 4 * KiB;
+    static constexpr size_t max_buffer_size = 16 * MiB;
+
     DoubleBuffer m_for_client;
     DoubleBuffer m_for_server;
 
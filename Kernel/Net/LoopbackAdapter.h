@@ -19,6 +19,7 @@ public:
     virtual ~LoopbackAdapter() override;
 
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_tcp_checksum(ReadonlyBytes) override;
     virtual const char* class_name() const override { return "LoopbackAdapter"; }
 };
 
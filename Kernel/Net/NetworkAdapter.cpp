@@ -13,6 +13,7 @@
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/LoopbackAdapter.h>
 #include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/Net/TCP.h>
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
 #include <Kernel/StdLib.h>
@@ -152,47 +153,119 @@ KResult NetworkAdapter::send_ipv4_fragmented(const MACAddress& destination_mac,
     return KSuccess;
 }
 
+IPv4Packet& NetworkAdapter::fill_ipv4_frame_header(u8* frame, const MACAddress& destination_mac, const IPv4Address& destination_ipv4, IPv4Protocol protocol, u8 ttl)
+{
+    memset(frame, 0, sizeof(EthernetFrameHeader) + sizeof(IPv4Packet));
+    auto& eth = *(EthernetFrameHeader*)frame;
+    eth.set_source(mac_address());
+    eth.set_destination(destination_mac);
+    eth.set_ether_type(EtherType::IPv4);
+    auto& ipv4 = *(IPv4Packet*)eth.payload();
+    ipv4.set_version(4);
+    ipv4.set_internet_header_length(5);
+    ipv4.set_source(ipv4_address());
+    ipv4.set_destination(destination_ipv4);
+    ipv4.set_protocol((u8)protocol);
+    ipv4.set_ident(1);
+    ipv4.set_ttl(ttl);
+    return ipv4;
+}
+
+void NetworkAdapter::send_tcp_frame(ReadonlyBytes frame, IPv4Packet& ipv4, TCPPacket& tcp_packet, size_t tcp_size)
+{
+    ipv4.set_length(sizeof(IPv4Packet) + tcp_size);
+    tcp_packet.set_checksum(0);
+    if (has_offload(Offload::TransmitTCPChecksum)) {
+        tcp_packet.set_checksum(tcp_pseudo_header_checksum(ipv4.source(), ipv4.destination(), tcp_size));
+        send_raw_with_tcp_checksum(frame);
+    } else {
+        ipv4.set_checksum(ipv4.compute_checksum());
+        tcp_packet.set_checksum(compute_tcp_checksum(ipv4.source(), ipv4.destination(), tcp_packet, tcp_size - tcp_packet.header_size()));
+        send_raw(frame);
+    }
+    m_packets_out++;
+    m_bytes_out += frame.size();
+}
+
+KResult NetworkAdapter::send_ipv4_tcp(const MACAddress& destination_mac, const IPv4Address& destination_ipv4, ReadonlyBytes tcp_segment, u16 mss, u8 ttl)
+{
+    VERIFY(tcp_segment.size() <= max_tcp_segment_size);
+    constexpr size_t headers_size = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
+
+    if (sizeof(IPv4Packet) + tcp_segment.size() <= mtu()) {
+        auto buffer = ByteBuffer::create_uninitialized(headers_size + tcp_segment.size());
+        auto& ipv4 = fill_ipv4_frame_header(buffer.data(), destination_mac, destination_ipv4, IPv4Protocol::TCP, ttl);
+        memcpy(ipv4.payload(), tcp_segment.data(), tcp_segment.size());
+        send_tcp_frame(buffer, ipv4, *(TCPPacket*)ipv4.payload(), tcp_segment.size());
+        return KSuccess;
+    }
+
+    auto& segment = *(const TCPPacket*)tcp_segment.data();
+    size_t header_size = segment.header_size();
+    size_t payload_size = tcp_segment.size() - header_size;
+    size_t max_frame_payload_size = min((size_t)mss, mtu() - sizeof(IPv4Packet) - header_size);
+    VERIFY(max_frame_payload_size > 0);
+
+    if (has_offload(Offload::TCPSegmentation)) {
+        auto buffer = ByteBuffer::create_uninitialized(headers_size + tcp_segment.size());
+        auto& ipv4 = fill_ipv4_frame_header(buffer.data(), destination_mac, destination_ipv4, IPv4Protocol::TCP, ttl);
+        memcpy(ipv4.payload(), tcp_segment.data(), tcp_segment.size());
+        auto& tcp_packet = *(TCPPacket*)ipv4.payload();
+        tcp_packet.set_checksum(tcp_pseudo_header_checksum(ipv4.source(), ipv4.destination(), 0));
+        send_raw_tcp_segmentation(buffer, max_frame_payload_size);
+        size_t frame_count = (payload_size + max_frame_payload_size - 1) / max_frame_payload_size;
+        m_packets_out += frame_count;
+        m_bytes_out += frame_count * (headers_size + header_size) + payload_size;
+        return KSuccess;
+    }
+
+    // Software segmentation: every frame gets a copy of the header, with the sequence number moved along.
+    // PSH and FIN only belong on the last one.
+    auto buffer = ByteBuffer::create_uninitialized(headers_size + header_size + max_frame_payload_size);
+    for (size_t offset = 0; offset < payload_size; offset += max_frame_payload_size) {
+        size_t frame_payload_size = min(max_frame_payload_size, payload_size - offset);
+        bool is_last_frame = offset + frame_payload_size == payload_size;
+        auto& ipv4 = fill_ipv4_frame_header(buffer.data(), destination_mac, destination_ipv4, IPv4Protocol::TCP, ttl);
+        auto& tcp_packet = *(TCPPacket*)ipv4.payload();
+        memcpy(&tcp_packet, &segment, header_size);
+        tcp_packet.set_sequence_number(segment.sequence_number() + offset);
+        if (!is_last_frame)
+            tcp_packet.set_flags(segment.flags() & ~(TCPFlags::PUSH | TCPFlags::FIN));
+        memcpy(tcp_packet.payload(), (const u8*)segment.payload() + offset, frame_payload_size);
+        send_tcp_frame(buffer.bytes().trim(headers_size + header_size + frame_payload_size), ipv4, tcp_packet, header_size + frame_payload_size);
+    }
+    return KSuccess;
+}
+
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
 {
-    InterruptDisabler disabler;
     m_packets_in++;
     m_bytes_in += payload.size();
 
-    Optional<KBuffer> buffer;
-
-    if (m_unused_packet_buffers.is_empty()) {
-        buffer = KBuffer::copy(payload.data(), payload.size());
-    } else {
-        buffer = m_unused_packet_buffers.take_first();
-        --m_unused_packet_buffers_count;
-        if (payload.size() <= buffer.value().capacity()) {
-            memcpy(buffer.value().data(), payload.data(), payload.size());
-            buffer.value().set_size(payload.size());
-        } else {
-            buffer = KBuffer::copy(payload.data(), payload.size());
-        }
+    if (!m_packet_queue.enqueue(payload, kgettimeofday())) {
+        m_packets_dropped++;
+        return;
     }
 
-    m_packet_queue.append({ buffer.value(), kgettimeofday() });
+    if (on_receive)
+        on_receive();
+}
 
+void NetworkAdapter::schedule_polling()
+{
     if (on_receive)
         on_receive();
 }
 
 size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
 {
-    InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
-        return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
-    packet_timestamp = packet_with_timestamp.timestamp;
-    auto packet = move(packet_with_timestamp.packet);
-    size_t packet_size = packet.size();
-    VERIFY(packet_size <= buffer_size);
-    memcpy(buffer, packet.data(), packet_size);
-    if (m_unused_packet_buffers_count < 100) {
-        m_unused_packet_buffers.append(packet);
-        ++m_unused_packet_buffers_count;
+    if (auto packet_size = m_packet_queue.dequeue(buffer, buffer_size, packet_timestamp))
+        return packet_size;
+
+    size_t packet_size = poll_packet(buffer, buffer_size, packet_timestamp);
+    if (packet_size) {
+        m_packets_in++;
+        m_bytes_in += packet_size;
     }
     return packet_size;
 }
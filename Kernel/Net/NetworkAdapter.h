@@ -7,9 +7,9 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/MACAddress.h>
-#include <AK/SinglyLinkedList.h>
 #include <AK/Types.h>
 #include <AK/WeakPtr.h>
 #include <AK/Weakable.h>
@@ -17,14 +17,31 @@
 #include <Kernel/Net/ARP.h>
 #include <Kernel/Net/ICMP.h>
 #include <Kernel/Net/IPv4.h>
+#include <Kernel/Net/PacketQueue.h>
 #include <Kernel/UserOrKernelBuffer.h>
 
 namespace Kernel {
 
 class NetworkAdapter;
+class TCPPacket;
 
 class NetworkAdapter : public RefCounted<NetworkAdapter> {
 public:
+    // Work an adapter can take off the CPU's hands.
+    enum class Offload : u32 {
+        None = 0,
+        // Frames with bad IPv4 or TCP checksums are dropped by the hardware.
+        ReceiveChecksum = 1 << 0,
+        // Fills in the IPv4 and TCP checksums of outgoing frames.
+        TransmitTCPChecksum = 1 << 1,
+        // Cuts a large TCP segment into MSS-sized frames (TSO), see send_raw_tcp_segmentation().
+        TCPSegmentation = 1 << 2,
+    };
+    AK_ENUM_BITWISE_FRIEND_OPERATORS(Offload);
+
+    // The largest TCP segment (header included) send_ipv4_tcp() takes, the most a single IPv4 packet could carry.
+    static constexpr size_t max_tcp_segment_size = 65535 - sizeof(IPv4Packet);
+
     static void for_each(Function<void(NetworkAdapter&)>);
     static RefPtr<NetworkAdapter> from_ipv4_address(const IPv4Address&);
     static RefPtr<NetworkAdapter> lookup_by_name(const StringView&);
@@ -47,6 +64,14 @@ public:
     KResult send_ipv4(const MACAddress&, const IPv4Address&, IPv4Protocol, const UserOrKernelBuffer& payload, size_t payload_size, u8 ttl);
     KResult send_ipv4_fragmented(const MACAddress&, const IPv4Address&, IPv4Protocol, const UserOrKernelBuffer& payload, size_t payload_size, u8 ttl);
 
+    // Sends a TCP segment whose checksum hasn't been computed yet. Segments that don't fit into the MTU are
+    // cut into frames of at most `mss` bytes of payload, by the hardware if it can, or in software otherwise.
+    KResult send_ipv4_tcp(const MACAddress&, const IPv4Address&, ReadonlyBytes tcp_segment, u16 mss, u8 ttl);
+
+    bool has_offload(Offload offload) const { return has_flag(m_offloads, offload); }
+
+    // Hands out the next received packet, either from the queue filled by did_receive()
+    // or, for adapters that support it, straight from the hardware's receive ring.
     size_t dequeue_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp);
 
     bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
@@ -58,6 +83,7 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 packets_dropped() const { return m_packets_dropped; }
 
     Function<void()> on_receive;
 
@@ -66,28 +92,43 @@ protected:
     void set_interface_name(const StringView& basename);
     void set_mac_address(const MACAddress& mac_address) { m_mac_address = mac_address; }
     virtual void send_raw(ReadonlyBytes) = 0;
+
+    void set_offloads(Offload offloads) { m_offloads = offloads; }
+    // Sends an Ethernet+IPv4+TCP frame, asking the hardware to fill in its checksums. The TCP checksum field
+    // holds the pseudo-header sum.
+    virtual void send_raw_with_tcp_checksum(ReadonlyBytes) { VERIFY_NOT_REACHED(); }
+    // Sends an Ethernet+IPv4+TCP frame whose TCP payload is larger than `mss`, for the hardware to segment.
+    // The IPv4 length and checksum are left zero, and the TCP checksum holds the pseudo-header sum without a length.
+    virtual void send_raw_tcp_segmentation(ReadonlyBytes, u16 /* mss */) { VERIFY_NOT_REACHED(); }
     void did_receive(ReadonlyBytes);
 
+    // NAPI-style polling: instead of copying every packet out of its receive ring from the IRQ
+    // handler, an adapter can mask its receive interrupt, call schedule_polling() and wait for
+    // NetworkTask to pull the packets out via poll_packet(). Once the ring is empty, the adapter
+    // should unmask its interrupt again.
+    void schedule_polling();
+    virtual size_t poll_packet(u8* /* buffer */, size_t /* buffer_size */, Time& /* packet_timestamp */) { return 0; }
+
+    void did_drop_packets(u32 count) { m_packets_dropped += count; }
+
 private:
+    IPv4Packet& fill_ipv4_frame_header(u8* frame, const MACAddress&, const IPv4Address&, IPv4Protocol, u8 ttl);
+    void send_tcp_frame(ReadonlyBytes frame, IPv4Packet&, TCPPacket&, size_t tcp_size);
+
     MACAddress m_mac_address;
     IPv4Address m_ipv4_address;
     IPv4Address m_ipv4_netmask;
     IPv4Address m_ipv4_gateway;
 
-    struct PacketWithTimestamp {
-        KBuffer packet;
-        Time timestamp;
-    };
-
-    SinglyLinkedList<PacketWithTimestamp> m_packet_queue;
-    SinglyLinkedList<KBuffer> m_unused_packet_buffers;
-    size_t m_unused_packet_buffers_count { 0 };
+    PacketQueue m_packet_queue { "Network Packet Pool" };
     String m_name;
     u32 m_packets_in { 0 };
     u32 m_bytes_in { 0 };
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
+    u32 m_packets_dropped { 0 };
     u32 m_mtu { 1500 };
+    Offload m_offloads { Offload::None };
 };
 
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Lock.h>
 #include <Kernel/Net/ARP.h>
@@ -12,8 +13,10 @@
 #include <Kernel/Net/ICMP.h>
 #include <Kernel/Net/IPv4.h>
 #include <Kernel/Net/IPv4Socket.h>
+#include <Kernel/Net/IPv4SocketTuple.h>
 #include <Kernel/Net/LoopbackAdapter.h>
 #include <Kernel/Net/NetworkTask.h>
+#include <Kernel/Net/PacketQueue.h>
 #include <Kernel/Net/Routing.h>
 #include <Kernel/Net/TCP.h>
 #include <Kernel/Net/TCPSocket.h>
@@ -25,11 +28,31 @@ namespace Kernel {
 
 static void handle_arp(const EthernetFrameHeader&, size_t frame_size);
 static void handle_ipv4(const EthernetFrameHeader&, size_t frame_size, const Time& packet_timestamp);
+static void dispatch_ipv4(const EthernetFrameHeader&, size_t frame_size, const Time& packet_timestamp);
 static void handle_icmp(const EthernetFrameHeader&, const IPv4Packet&, const Time& packet_timestamp);
 static void handle_udp(const IPv4Packet&, const Time& packet_timestamp);
 static void handle_tcp(const IPv4Packet&, const Time& packet_timestamp);
 
 [[noreturn]] static void NetworkTask_main(void*);
+[[noreturn]] static void NetworkWorker_main(void*);
+
+// On machines with more than one CPU, IPv4 packets are handed off to one worker per CPU.
+// The worker is picked by hashing the packet's flow, so that all packets of a connection
+// are processed in order by the same worker, while different flows are spread out.
+struct NetworkWorker {
+    PacketQueue queue { "Network Worker Packet Pool" };
+    WaitQueue wait_queue;
+};
+
+static NonnullOwnPtrVector<NetworkWorker> s_workers;
+
+static constexpr size_t packet_buffer_size = 64 * KiB;
+
+// Packets sent over the loopback adapter don't have to wait for NetworkTask, their senders deliver them as soon
+// as they've let go of their socket locks. They still have to be handled in order, so only one thread at a time
+// gets to do it, and anyone coming along in the meantime leaves their packets to that thread.
+static Atomic<bool> s_processing_loopback_packets;
+static OwnPtr<Region> s_loopback_packet_buffer_region;
 
 void NetworkTask::spawn()
 {
@@ -37,10 +60,30 @@ void NetworkTask::spawn()
     Process::create_kernel_process(thread, "NetworkTask", NetworkTask_main, nullptr);
 }
 
+void NetworkTask::process_loopback_packets()
+{
+    if (!s_loopback_packet_buffer_region)
+        return;
+
+    auto& adapter = LoopbackAdapter::the();
+    auto* buffer = s_loopback_packet_buffer_region->vaddr().as_ptr();
+    while (adapter.has_queued_packets()) {
+        if (s_processing_loopback_packets.exchange(true))
+            return;
+        Time packet_timestamp;
+        while (size_t packet_size = adapter.dequeue_packet(buffer, packet_buffer_size, packet_timestamp)) {
+            auto& eth = *(const EthernetFrameHeader*)buffer;
+            if (packet_size >= sizeof(EthernetFrameHeader) && eth.ether_type() == EtherType::IPv4)
+                handle_ipv4(eth, packet_size, packet_timestamp);
+        }
+        // Check again once we're done, someone may have given up on a packet that arrived just before.
+        s_processing_loopback_packets.store(false);
+    }
+}
+
 void NetworkTask_main(void*)
 {
     WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkAdapter::for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -51,36 +94,64 @@ void NetworkTask_main(void*)
         }
 
         adapter.on_receive = [&]() {
-            pending_packets++;
             packet_wait_queue.wake_all();
         };
     });
 
-    auto dequeue_packet = [&pending_packets](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
-        if (pending_packets == 0)
-            return 0;
+    s_loopback_packet_buffer_region = MM.allocate_kernel_region(packet_buffer_size, "Loopback Packet Buffer", Region::Access::Read | Region::Access::Write);
+
+    auto dequeue_packet = [](u8* buffer, size_t buffer_size, Time& packet_timestamp) -> size_t {
         size_t packet_size = 0;
         NetworkAdapter::for_each([&](auto& adapter) {
-            if (packet_size || !adapter.has_queued_packets())
+            if (packet_size || &adapter == &LoopbackAdapter::the())
                 return;
             packet_size = adapter.dequeue_packet(buffer, buffer_size, packet_timestamp);
-            pending_packets--;
-            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
+            if (packet_size)
+                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
         });
         return packet_size;
     };
 
-    size_t buffer_size = 64 * KiB;
+    if (Processor::count() > 1) {
+        for (u32 cpu = 0; cpu < Processor::count(); ++cpu) {
+            s_workers.append(make<NetworkWorker>());
+            auto& worker = s_workers.last();
+            RefPtr<Thread> worker_thread;
+            Process::create_kernel_process(worker_thread, String::formatted("NetworkWorker #{}", cpu), NetworkWorker_main, &worker, 1u << cpu);
+        }
+        dmesgln("NetworkTask: Processing packets on {} workers", s_workers.size());
+    }
+
+    size_t buffer_size = packet_buffer_size;
     auto buffer_region = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer", Region::Access::Read | Region::Access::Write);
     auto buffer = (u8*)buffer_region->vaddr().get();
     Time packet_timestamp;
 
+    // TCP timers are checked every few milliseconds while any of them is running, and
+    // less frequently otherwise, since sockets may arm them without waking us up.
+    constexpr i64 idle_tcp_timer_interval_ms = 200;
+    auto next_tcp_timer_check = Time::zero();
+
     for (;;) {
+        auto now = kgettimeofday();
+        if (now >= next_tcp_timer_check) {
+            bool has_pending_timers = TCPSocket::handle_timers();
+            next_tcp_timer_check = now + Time::from_milliseconds(has_pending_timers ? TCPSocket::timer_granularity_ms : idle_tcp_timer_interval_ms);
+        }
+
+        // Loopback packets whose senders couldn't deliver them themselves, like ACKs sent from timers.
+        NetworkTask::process_loopback_packets();
+
         size_t packet_size = dequeue_packet(buffer, buffer_size, packet_timestamp);
         if (!packet_size) {
-            packet_wait_queue.wait_forever("NetworkTask");
+            auto timeout_time = next_tcp_timer_check - now;
+            Thread::BlockTimeout timeout(false, &timeout_time);
+            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask");
             continue;
         }
+
+        // Incoming packets may have started a delayed ACK or retransmission timer.
+        next_tcp_timer_check = min(next_tcp_timer_check, now + Time::from_milliseconds(TCPSocket::timer_granularity_ms));
         if (packet_size < sizeof(EthernetFrameHeader)) {
             dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
             continue;
@@ -93,7 +164,11 @@ void NetworkTask_main(void*)
             handle_arp(eth, packet_size);
             break;
         case EtherType::IPv4:
-            handle_ipv4(eth, packet_size, packet_timestamp);
+            if (s_workers.is_empty()) {
+                handle_ipv4(eth, packet_size, packet_timestamp);
+                break;
+            }
+            dispatch_ipv4(eth, packet_size, packet_timestamp);
             break;
         case EtherType::IPv6:
             // ignore
@@ -104,6 +179,53 @@ void NetworkTask_main(void*)
     }
 }
 
+static unsigned flow_hash(const EthernetFrameHeader& eth, size_t frame_size)
+{
+    auto& packet = *static_cast<const IPv4Packet*>(eth.payload());
+    size_t payload_offset = sizeof(EthernetFrameHeader) + sizeof(IPv4Packet);
+    if (frame_size < payload_offset)
+        return 0;
+
+    // Ports live at the same offset in TCP and UDP headers, which is all we need here.
+    // Hashing the tuple from the receiver's point of view keeps it stable for a connection.
+    auto protocol = (IPv4Protocol)packet.protocol();
+    if ((protocol == IPv4Protocol::TCP && frame_size >= payload_offset + sizeof(TCPPacket))
+        || (protocol == IPv4Protocol::UDP && frame_size >= payload_offset + sizeof(UDPPacket))) {
+        auto& ports = *static_cast<const UDPPacket*>(packet.payload());
+        IPv4SocketTuple tuple(packet.destination(), ports.destination_port(), packet.source(), ports.source_port());
+        return Traits<IPv4SocketTuple>::hash(tuple);
+    }
+
+    return pair_int_hash(pair_int_hash(packet.source().to_u32(), packet.destination().to_u32()), (u32)protocol);
+}
+
+void dispatch_ipv4(const EthernetFrameHeader& eth, size_t frame_size, const Time& packet_timestamp)
+{
+    auto& worker = s_workers[flow_hash(eth, frame_size) % s_workers.size()];
+    if (!worker.queue.enqueue({ (const u8*)&eth, frame_size }, packet_timestamp)) {
+        dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Worker queue is full, dropping packet");
+        return;
+    }
+    worker.wait_queue.wake_all();
+}
+
+void NetworkWorker_main(void* data)
+{
+    auto& worker = *static_cast<NetworkWorker*>(data);
+    auto buffer_region = MM.allocate_kernel_region(packet_buffer_size, "Kernel Packet Buffer", Region::Access::Read | Region::Access::Write);
+    auto buffer = (u8*)buffer_region->vaddr().get();
+    Time packet_timestamp;
+
+    for (;;) {
+        size_t packet_size = worker.queue.dequeue(buffer, packet_buffer_size, packet_timestamp);
+        if (!packet_size) {
+            [[maybe_unused]] auto result = worker.wait_queue.wait_on({}, "NetworkWorker");
+            continue;
+        }
+        handle_ipv4(*(const EthernetFrameHeader*)buffer, packet_size, packet_timestamp);
+    }
+}
+
 void handle_arp(const EthernetFrameHeader& eth, size_t frame_size)
 {
     constexpr size_t minimum_arp_frame_size = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -365,6 +487,7 @@ void handle_tcp(const IPv4Packet& ipv4_packet, const Time& packet_timestamp)
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->process_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
             return;
@@ -529,7 +652,7 @@ void handle_tcp(const IPv4Packet& ipv4_packet, const Time& packet_timestamp)
 
         if (payload_size) {
             if (socket->did_receive(ipv4_packet.source(), tcp_packet.source_port(), KBuffer::copy(&ipv4_packet, sizeof(IPv4Packet) + ipv4_packet.payload_size()), packet_timestamp))
-                unused_rc = socket->send_tcp_packet(TCPFlags::ACK);
+                socket->send_delayed_ack();
         }
     }
 }
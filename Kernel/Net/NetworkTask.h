@@ -10,5 +10,9 @@ namespace Kernel {
 class NetworkTask {
 public:
     static void spawn();
+
+    // Handles the packets waiting on the loopback adapter right away, in the calling thread.
+    // Must not be called with any socket locks held.
+    static void process_loopback_packets();
 };
 }
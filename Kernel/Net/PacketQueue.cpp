@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/PacketQueue.h>
+#include <Kernel/StdLib.h>
+#include <Kernel/VM/MemoryManager.h>
+
+namespace Kernel {
+
+PacketQueue::PacketQueue(const char* name, size_t pool_size, size_t max_size)
+    : m_max_size(max_size)
+{
+    m_pool_region = MM.allocate_kernel_region(page_round_up(pool_size * pool_buffer_size), name, Region::Access::Read | Region::Access::Write);
+    VERIFY(m_pool_region);
+    for (size_t i = 0; i < pool_size; ++i) {
+        auto packet = make<Packet>();
+        packet->pool_buffer = { m_pool_region->vaddr().offset(i * pool_buffer_size).as_ptr(), pool_buffer_size };
+        m_unused_packets.append(*packet);
+        m_pool.append(move(packet));
+    }
+}
+
+PacketQueue::~PacketQueue()
+{
+    ScopedSpinLock lock(m_lock);
+    while (!m_queue.is_empty()) {
+        auto* packet = m_queue.take_first();
+        if (!packet->is_from_pool())
+            delete packet;
+    }
+    m_unused_packets.clear();
+}
+
+bool PacketQueue::enqueue(ReadonlyBytes payload, const Time& timestamp)
+{
+    ScopedSpinLock lock(m_lock);
+    if (m_size >= m_max_size)
+        return false;
+
+    Packet* packet = nullptr;
+    if (payload.size() <= pool_buffer_size && !m_unused_packets.is_empty()) {
+        packet = m_unused_packets.take_first();
+        memcpy(packet->pool_buffer.data(), payload.data(), payload.size());
+    } else {
+        // Don't hold on to the lock while allocating.
+        lock.unlock();
+        packet = new Packet;
+        packet->oversized_buffer = KBuffer::copy(payload.data(), payload.size());
+        lock.lock();
+    }
+    packet->size = payload.size();
+    packet->timestamp = timestamp;
+
+    m_queue.append(*packet);
+    m_size++;
+    return true;
+}
+
+size_t PacketQueue::dequeue(u8* buffer, size_t buffer_size, Time& timestamp)
+{
+    Packet* packet = nullptr;
+    {
+        ScopedSpinLock lock(m_lock);
+        if (m_queue.is_empty())
+            return 0;
+        packet = m_queue.take_first();
+        m_size--;
+    }
+
+    timestamp = packet->timestamp;
+    size_t packet_size = packet->size;
+    VERIFY(packet_size <= buffer_size);
+    memcpy(buffer, packet->data(), packet_size);
+
+    if (!packet->is_from_pool()) {
+        delete packet;
+        return packet_size;
+    }
+
+    ScopedSpinLock lock(m_lock);
+    m_unused_packets.append(*packet);
+    return packet_size;
+}
+
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/Time.h>
+#include <Kernel/KBuffer.h>
+#include <Kernel/SpinLock.h>
+
+namespace Kernel {
+
+// A FIFO of received packets backed by a preallocated buffer pool, so that queueing a packet
+// usually doesn't allocate anything. Only packets that don't fit into a pool buffer, or that
+// arrive while the pool is exhausted, get a buffer of their own.
+class PacketQueue {
+    AK_MAKE_NONCOPYABLE(PacketQueue);
+    AK_MAKE_NONMOVABLE(PacketQueue);
+
+public:
+    static constexpr size_t default_pool_size = 128;
+    static constexpr size_t default_max_size = 1024;
+    static constexpr size_t pool_buffer_size = 2 * KiB;
+
+    explicit PacketQueue(const char* name, size_t pool_size = default_pool_size, size_t max_size = default_max_size);
+    ~PacketQueue();
+
+    // Returns false if the queue is full and the packet was dropped.
+    bool enqueue(ReadonlyBytes, const Time& timestamp);
+
+    // Returns the size of the packet copied into buffer, or 0 if the queue is empty.
+    size_t dequeue(u8* buffer, size_t buffer_size, Time& timestamp);
+
+    bool is_empty() const
+    {
+        ScopedSpinLock lock(m_lock);
+        return m_queue.is_empty();
+    }
+
+private:
+    struct Packet {
+        Bytes pool_buffer;
+        Optional<KBuffer> oversized_buffer;
+        size_t size { 0 };
+        Time timestamp;
+        IntrusiveListNode<Packet> list_node;
+
+        bool is_from_pool() const { return !pool_buffer.is_empty(); }
+        const u8* data() const { return is_from_pool() ? pool_buffer.data() : oversized_buffer.value().data(); }
+    };
+
+    using PacketList = IntrusiveList<Packet, RawPtr<Packet>, &Packet::list_node>;
+
+    OwnPtr<Region> m_pool_region;
+    NonnullOwnPtrVector<Packet> m_pool;
+    size_t m_max_size { 0 };
+
+    mutable SpinLock<u8> m_lock;
+    PacketList m_unused_packets;
+    PacketList m_queue;
+    size_t m_size { 0 };
+};
+
+}
@@ -77,7 +77,7 @@ KResult Socket::queue_connection_from(NonnullRefPtr<Socket> peer)
     return KSuccess;
 }
 
-KResult Socket::setsockopt(int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+KResult Socket::setsockopt(FileDescription&, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
 {
     if (level != SOL_SOCKET)
         return ENOPROTOOPT;
@@ -89,7 +89,12 @@ public:
     virtual KResultOr<size_t> sendto(FileDescription&, const UserOrKernelBuffer&, size_t, int flags, Userspace<const sockaddr*>, socklen_t) = 0;
     virtual KResultOr<size_t> recvfrom(FileDescription&, UserOrKernelBuffer&, size_t, int flags, Userspace<sockaddr*>, Userspace<socklen_t*>, Time&) = 0;
 
-    virtual KResult setsockopt(int level, int option, Userspace<const void*>, socklen_t);
+    // Sends up to `size` bytes read from `source` at `offset` without staging them in an
+    // intermediate buffer. Sockets that can't do that return ENOTSUP, and the caller is
+    // expected to fall back to reading and writing.
+    virtual KResultOr<size_t> sendfile(FileDescription&, FileDescription& /* source */, u64 /* offset */, size_t) { return ENOTSUP; }
+
+    virtual KResult setsockopt(FileDescription&, int level, int option, Userspace<const void*>, socklen_t);
     virtual KResult getsockopt(FileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>);
 
     pid_t origin_pid() const { return m_origin.pid; }
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/RefPtr.h>
+#include <Kernel/SpinLock.h>
+
+namespace Kernel {
+
+// Maps keys (socket tuples or ports) to the sockets bound to them.
+// The table is split into a fixed number of buckets with a lock each, so that looking up
+// a socket for an incoming packet only ever contends with operations on the same bucket,
+// instead of with every other lookup, bind and close in the system.
+// Sockets don't hold a reference to themselves through the table; they are expected to
+// remove themselves from it when they are destroyed.
+template<typename Key, typename SocketType>
+class SocketTable {
+    AK_MAKE_NONCOPYABLE(SocketTable);
+    AK_MAKE_NONMOVABLE(SocketTable);
+
+public:
+    SocketTable() = default;
+
+    RefPtr<SocketType> get(const Key& key) const
+    {
+        auto& bucket = bucket_for(key);
+        ScopedSpinLock lock(bucket.lock);
+        auto it = bucket.sockets.find(key);
+        if (it == bucket.sockets.end())
+            return {};
+        // The socket may already be on its way out, waiting for this lock to remove itself.
+        if (!it->value->try_ref())
+            return {};
+        return adopt_ref(*it->value);
+    }
+
+    bool contains(const Key& key) const
+    {
+        auto& bucket = bucket_for(key);
+        ScopedSpinLock lock(bucket.lock);
+        return bucket.sockets.contains(key);
+    }
+
+    // Returns false if another socket is already registered under this key.
+    bool try_add(const Key& key, SocketType& socket)
+    {
+        auto& bucket = bucket_for(key);
+        ScopedSpinLock lock(bucket.lock);
+        if (bucket.sockets.contains(key))
+            return false;
+        bucket.sockets.set(key, &socket);
+        m_size++;
+        return true;
+    }
+
+    // Only removes the entry if it still belongs to this socket.
+    bool remove(const Key& key, const SocketType& socket)
+    {
+        auto& bucket = bucket_for(key);
+        ScopedSpinLock lock(bucket.lock);
+        auto it = bucket.sockets.find(key);
+        if (it == bucket.sockets.end() || it->value != &socket)
+            return false;
+        bucket.sockets.remove(it);
+        m_size--;
+        return true;
+    }
+
+    size_t size() const { return m_size; }
+
+    // Takes a reference to every socket in the table, so the caller can work on them without holding any locks.
+    void collect(NonnullRefPtrVector<SocketType>& sockets) const
+    {
+        for (auto& bucket : m_buckets) {
+            ScopedSpinLock lock(bucket.lock);
+            for (auto& it : bucket.sockets) {
+                if (it.value->try_ref())
+                    sockets.append(adopt_ref(*it.value));
+            }
+        }
+    }
+
+private:
+    static constexpr size_t bucket_count = 64;
+
+    struct Bucket {
+        SpinLock<u8> lock;
+        HashMap<Key, SocketType*> sockets;
+    };
+
+    Bucket& bucket_for(const Key& key) const { return m_buckets[Traits<Key>::hash(key) % bucket_count]; }
+
+    mutable Bucket m_buckets[bucket_count];
+    Atomic<size_t> m_size { 0 };
+};
+
+}
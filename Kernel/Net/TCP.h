@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Span.h>
 #include <Kernel/Net/IPv4.h>
 
 namespace Kernel {
@@ -21,6 +22,20 @@ struct TCPFlags {
     };
 };
 
+struct TCPOptionKind {
+    enum : u8 {
+        End = 0,
+        NOP = 1,
+        MSS = 2,
+        SACKPermitted = 4,
+        SACK = 5,
+    };
+};
+
+// Sequence numbers wrap around, so they have to be compared modulo 2^32.
+static inline bool tcp_sequence_less_than(u32 a, u32 b) { return static_cast<i32>(a - b) < 0; }
+static inline bool tcp_sequence_less_than_or_equal(u32 a, u32 b) { return static_cast<i32>(a - b) <= 0; }
+
 class [[gnu::packed]] TCPPacket {
 public:
     TCPPacket() = default;
@@ -60,6 +75,32 @@ public:
     u16 urgent() const { return m_urgent; }
     void set_urgent(u16 urgent) { m_urgent = urgent; }
 
+    ReadonlyBytes options() const { return { ((const u8*)this) + sizeof(TCPPacket), header_size() - sizeof(TCPPacket) }; }
+    Bytes options() { return { ((u8*)this) + sizeof(TCPPacket), header_size() - sizeof(TCPPacket) }; }
+
+    // Calls callback(kind, option_data) for every option in the header, stopping at a malformed one.
+    template<typename Callback>
+    void for_each_option(Callback callback) const
+    {
+        auto bytes = options();
+        for (size_t i = 0; i < bytes.size();) {
+            u8 kind = bytes[i];
+            if (kind == TCPOptionKind::End)
+                return;
+            if (kind == TCPOptionKind::NOP) {
+                ++i;
+                continue;
+            }
+            if (i + 1 >= bytes.size())
+                return;
+            u8 length = bytes[i + 1];
+            if (length < 2 || i + length > bytes.size())
+                return;
+            callback(kind, bytes.slice(i + 2, length - 2));
+            i += length;
+        }
+    }
+
     const void* payload() const { return ((const u8*)this) + header_size(); }
     void* payload() { return ((u8*)this) + header_size(); }
 
@@ -77,4 +118,51 @@ private:
 
 static_assert(sizeof(TCPPacket) == 20);
 
+// The ones' complement sum of the pseudo-header that TCP checksums cover (RFC 793), folded but not complemented.
+// Adapters that compute TCP checksums themselves expect to find this in the checksum field.
+inline NetworkOrdered<u16> tcp_pseudo_header_checksum(const IPv4Address& source, const IPv4Address& destination, u16 tcp_length)
+{
+    struct [[gnu::packed]] PseudoHeader {
+        IPv4Address source;
+        IPv4Address destination;
+        u8 zero;
+        u8 protocol;
+        NetworkOrdered<u16> tcp_length;
+    };
+
+    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, tcp_length };
+
+    u32 checksum = 0;
+    auto* w = (const NetworkOrdered<u16>*)&pseudo_header;
+    for (size_t i = 0; i < sizeof(pseudo_header) / sizeof(u16); ++i)
+        checksum += w[i];
+    while (checksum >> 16)
+        checksum = (checksum >> 16) + (checksum & 0xffff);
+    return checksum;
+}
+
+inline NetworkOrdered<u16> compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
+{
+    u32 checksum = tcp_pseudo_header_checksum(source, destination, packet.header_size() + payload_size);
+    auto* w = (const NetworkOrdered<u16>*)&packet;
+    for (size_t i = 0; i < packet.header_size() / sizeof(u16); ++i) {
+        checksum += w[i];
+        if (checksum > 0xffff)
+            checksum = (checksum >> 16) + (checksum & 0xffff);
+    }
+    w = (const NetworkOrdered<u16>*)packet.payload();
+    for (size_t i = 0; i < payload_size / sizeof(u16); ++i) {
+        checksum += w[i];
+        if (checksum > 0xffff)
+            checksum = (checksum >> 16) + (checksum & 0xffff);
+    }
+    if (payload_size & 1) {
+        u16 expanded_byte = ((const u8*)packet.payload())[payload_size - 1] << 8;
+        checksum += expanded_byte;
+        if (checksum > 0xffff)
+            checksum = (checksum >> 16) + (checksum & 0xffff);
+    }
+    return ~(checksum & 0xffff);
+}
+
 }
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Debug.h>
@@ -11,6 +12,7 @@
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/Routing.h>
+#include <Kernel/Net/SocketTable.h>
 #include <Kernel/Net/TCP.h>
 #include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Process.h>
@@ -18,11 +20,28 @@
 
 namespace Kernel {
 
+using TCPSocketTable = SocketTable<IPv4SocketTuple, TCPSocket>;
+
+// Sockets with a peer: outgoing connections and accepted incoming ones.
+static AK::Singleton<TCPSocketTable> s_connected_sockets;
+// Incoming connections that haven't completed the three-way handshake yet.
+static AK::Singleton<TCPSocketTable> s_syn_backlog_sockets;
+// Listening sockets, keyed by local address and port only.
+static AK::Singleton<TCPSocketTable> s_listening_sockets;
+
+static NonnullRefPtrVector<TCPSocket> all_tcp_sockets()
+{
+    NonnullRefPtrVector<TCPSocket> sockets;
+    s_listening_sockets->collect(sockets);
+    s_syn_backlog_sockets->collect(sockets);
+    s_connected_sockets->collect(sockets);
+    return sockets;
+}
+
 void TCPSocket::for_each(Function<void(const TCPSocket&)> callback)
 {
-    LOCKER(sockets_by_tuple().lock(), Lock::Mode::Shared);
-    for (auto& it : sockets_by_tuple().resource())
-        callback(*it.value);
+    for (auto& socket : all_tcp_sockets())
+        callback(socket);
 }
 
 void TCPSocket::set_state(State new_state)
@@ -37,6 +56,17 @@ void TCPSocket::set_state(State new_state)
     if (new_state == State::Established && m_direction == Direction::Outgoing)
         m_role = Role::Connected;
 
+    if (m_in_syn_backlog && new_state != State::SynReceived) {
+        remove_from_syn_backlog();
+        if (new_state == State::Established && !s_connected_sockets->try_add(tuple(), *this))
+            dbgln("TCPSocket({}): Tuple {} is already in use by another connection", this, tuple().to_string());
+        // A connection that died during the handshake will never be accepted, so let go of it.
+        if (new_state == State::Closed) {
+            if (auto originator = m_originator.strong_ref())
+                originator->m_pending_release_for_accept.remove(tuple());
+        }
+    }
+
     if (new_state == State::Closed) {
         LOCKER(closing_sockets().lock());
         closing_sockets().resource().remove(tuple());
@@ -53,32 +83,20 @@ Lockable<HashMap<IPv4SocketTuple, RefPtr<TCPSocket>>>& TCPSocket::closing_socket
     return *s_socket_closing;
 }
 
-static AK::Singleton<Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>> s_socket_tuples;
-
-Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>& TCPSocket::sockets_by_tuple()
-{
-    return *s_socket_tuples;
-}
-
 RefPtr<TCPSocket> TCPSocket::from_tuple(const IPv4SocketTuple& tuple)
 {
-    LOCKER(sockets_by_tuple().lock(), Lock::Mode::Shared);
+    if (auto socket = s_connected_sockets->get(tuple))
+        return socket;
 
-    auto exact_match = sockets_by_tuple().resource().get(tuple);
-    if (exact_match.has_value())
-        return { *exact_match.value() };
+    if (auto socket = s_syn_backlog_sockets->get(tuple))
+        return socket;
 
     auto address_tuple = IPv4SocketTuple(tuple.local_address(), tuple.local_port(), IPv4Address(), 0);
-    auto address_match = sockets_by_tuple().resource().get(address_tuple);
-    if (address_match.has_value())
-        return { *address_match.value() };
+    if (auto socket = s_listening_sockets->get(address_tuple))
+        return socket;
 
     auto wildcard_tuple = IPv4SocketTuple(IPv4Address(), tuple.local_port(), IPv4Address(), 0);
-    auto wildcard_match = sockets_by_tuple().resource().get(wildcard_tuple);
-    if (wildcard_match.has_value())
-        return { *wildcard_match.value() };
-
-    return {};
+    return s_listening_sockets->get(wildcard_tuple);
 }
 
 RefPtr<TCPSocket> TCPSocket::from_endpoints(const IPv4Address& local_address, u16 local_port, const IPv4Address& peer_address, u16 peer_port)
@@ -90,8 +108,12 @@ RefPtr<TCPSocket> TCPSocket::create_client(const IPv4Address& new_local_address,
 {
     auto tuple = IPv4SocketTuple(new_local_address, new_local_port, new_peer_address, new_peer_port);
 
-    LOCKER(sockets_by_tuple().lock());
-    if (sockets_by_tuple().resource().contains(tuple))
+    if (m_pending_release_for_accept.size() >= max_syn_backlog) {
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}): SYN backlog is full, dropping connection from {}", this, tuple.to_string());
+        return {};
+    }
+
+    if (s_connected_sockets->contains(tuple))
         return {};
 
     auto client = TCPSocket::create(protocol());
@@ -104,10 +126,19 @@ RefPtr<TCPSocket> TCPSocket::create_client(const IPv4Address& new_local_address,
     client->set_direction(Direction::Incoming);
     client->set_originator(*this);
 
+    if (!s_syn_backlog_sockets->try_add(tuple, *client))
+        return {};
+    client->m_in_syn_backlog = true;
     m_pending_release_for_accept.set(tuple, client);
-    sockets_by_tuple().resource().set(tuple, client);
 
-    return from_tuple(tuple);
+    return client;
+}
+
+void TCPSocket::remove_from_syn_backlog()
+{
+    VERIFY(m_in_syn_backlog);
+    m_in_syn_backlog = false;
+    s_syn_backlog_sockets->remove(tuple(), *this);
 }
 
 void TCPSocket::release_to_originator()
@@ -131,8 +162,9 @@ TCPSocket::TCPSocket(int protocol)
 
 TCPSocket::~TCPSocket()
 {
-    LOCKER(sockets_by_tuple().lock());
-    sockets_by_tuple().resource().remove(tuple());
+    s_connected_sockets->remove(tuple(), *this);
+    s_syn_backlog_sockets->remove(tuple(), *this);
+    s_listening_sockets->remove(tuple(), *this);
 
     dbgln_if(TCP_SOCKET_DEBUG, "~TCPSocket in state {}", to_string(state()));
 }
@@ -156,15 +188,72 @@ KResultOr<size_t> TCPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, Use
 
 KResultOr<size_t> TCPSocket::protocol_send(const UserOrKernelBuffer& data, size_t data_length)
 {
-    int err = send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &data, data_length);
-    if (err < 0)
-        return KResult((ErrnoCode)-err);
-    return data_length;
+    // Queue the data one segment at a time, so congestion control gets to decide when each of them goes out.
+    size_t nsent = 0;
+    while (nsent < data_length) {
+        size_t segment_size = min(data_length - nsent, (size_t)m_mss);
+        auto segment_data = data.offset(nsent);
+        auto result = send_tcp_packet(TCPFlags::PUSH | TCPFlags::ACK, &segment_data, segment_size);
+        if (result.is_error()) {
+            if (nsent == 0)
+                return result;
+            break;
+        }
+        nsent += segment_size;
+    }
+    return nsent;
 }
 
-KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload, size_t payload_size)
+size_t TCPSocket::OutgoingPacket::payload_size() const
+{
+    auto& tcp_packet = *(const TCPPacket*)buffer.data();
+    return buffer.size() - tcp_packet.header_size();
+}
+
+u32 TCPSocket::local_mss() const
 {
-    const size_t buffer_size = sizeof(TCPPacket) + payload_size;
+    auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
+    if (routing_decision.is_zero())
+        return default_mss;
+    return routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+}
+
+// fill_payload is handed the segment's payload area and returns how much of it it filled in.
+template<typename FillPayload>
+KResultOr<size_t> TCPSocket::send_tcp_packet_with_payload(u16 flags, size_t payload_size, FillPayload fill_payload)
+{
+    if (payload_size > 0 && !(flags & (TCPFlags::SYN | TCPFlags::FIN))) {
+        // If the last segment is still waiting to be sent, top it up instead of queueing another small one.
+        LOCKER(m_not_acked_lock);
+        if (!m_not_acked.is_empty()) {
+            auto& last = m_not_acked.last();
+            auto& last_tcp_packet = *(const TCPPacket*)last.buffer.data();
+            if (last.tx_counter == 0 && last_tcp_packet.flags() == flags && last.payload_size() + payload_size <= m_mss) {
+                size_t old_buffer_size = last.buffer.size();
+                last.buffer.grow(old_buffer_size + payload_size);
+                auto filled_or_error = fill_payload(last.buffer.data() + old_buffer_size, payload_size);
+                if (filled_or_error.is_error()) {
+                    last.buffer.trim(old_buffer_size);
+                    return filled_or_error.error();
+                }
+                VERIFY(filled_or_error.value() <= payload_size);
+                last.buffer.trim(old_buffer_size + filled_or_error.value());
+                last.ack_number += filled_or_error.value();
+                m_sequence_number += filled_or_error.value();
+                send_outgoing_packets();
+                return filled_or_error.value();
+            }
+        }
+    }
+
+    // SYNs carry our MSS and, unless the peer already declined it, an offer to use SACK.
+    bool offers_sack = (flags & TCPFlags::SYN) && (!(flags & TCPFlags::ACK) || m_sack_permitted);
+    size_t options_size = 0;
+    if (flags & TCPFlags::SYN)
+        options_size = offers_sack ? 8 : 4;
+    size_t header_size = sizeof(TCPPacket) + options_size;
+
+    size_t buffer_size = header_size + payload_size;
     auto buffer = ByteBuffer::create_zeroed(buffer_size);
     auto& tcp_packet = *(TCPPacket*)(buffer.data());
     VERIFY(local_port());
@@ -172,168 +261,562 @@ KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload,
     tcp_packet.set_destination_port(peer_port());
     tcp_packet.set_window_size(1024);
     tcp_packet.set_sequence_number(m_sequence_number);
-    tcp_packet.set_data_offset(sizeof(TCPPacket) / sizeof(u32));
+    tcp_packet.set_data_offset(header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
 
     if (flags & TCPFlags::ACK)
         tcp_packet.set_ack_number(m_ack_number);
 
-    if (payload && !payload->read(tcp_packet.payload(), payload_size))
-        return EFAULT;
-
     if (flags & TCPFlags::SYN) {
-        ++m_sequence_number;
-    } else {
-        m_sequence_number += payload_size;
+        auto options = tcp_packet.options();
+        u16 mss = local_mss();
+        options[0] = TCPOptionKind::MSS;
+        options[1] = 4;
+        options[2] = mss >> 8;
+        options[3] = mss & 0xff;
+        if (offers_sack) {
+            options[4] = TCPOptionKind::NOP;
+            options[5] = TCPOptionKind::NOP;
+            options[6] = TCPOptionKind::SACKPermitted;
+            options[7] = 2;
+        }
+    }
+
+    if (payload_size > 0) {
+        auto filled_or_error = fill_payload(static_cast<u8*>(tcp_packet.payload()), payload_size);
+        if (filled_or_error.is_error())
+            return filled_or_error.error();
+        VERIFY(filled_or_error.value() <= payload_size);
+        if (filled_or_error.value() == 0)
+            return 0;
+        payload_size = filled_or_error.value();
+        buffer_size = header_size + payload_size;
+        buffer.trim(buffer_size);
     }
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    u32 sequence_number = m_sequence_number;
+    m_sequence_number += payload_size;
+    if (flags & (TCPFlags::SYN | TCPFlags::FIN))
+        ++m_sequence_number;
 
-    if (tcp_packet.has_syn() || payload_size > 0) {
+    if (tcp_packet.has_syn() || tcp_packet.has_fin() || payload_size > 0) {
         LOCKER(m_not_acked_lock);
-        m_not_acked.append({ m_sequence_number, move(buffer) });
+        m_not_acked.append({ sequence_number, m_sequence_number, move(buffer) });
         send_outgoing_packets();
-        return KSuccess;
+        return payload_size;
+    }
+
+    {
+        // Segments without payload don't wait in line, so they must not claim sequence space that
+        // queued data hasn't been sent in yet.
+        LOCKER(m_not_acked_lock, Lock::Mode::Shared);
+        for (auto& outgoing : m_not_acked) {
+            if (outgoing.tx_counter == 0) {
+                tcp_packet.set_sequence_number(outgoing.sequence_number);
+                break;
+            }
+        }
     }
 
     auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
     VERIFY(!routing_decision.is_zero());
 
-    auto packet_buffer = UserOrKernelBuffer::for_kernel_buffer(buffer.data());
-    auto result = routing_decision.adapter->send_ipv4(
-        routing_decision.next_hop, peer_address(), IPv4Protocol::TCP,
-        packet_buffer, buffer_size, ttl());
+    auto result = routing_decision.adapter->send_ipv4_tcp(routing_decision.next_hop, peer_address(), buffer.bytes().trim(buffer_size), m_mss, ttl());
     if (result.is_error())
         return result;
 
+    if (flags & TCPFlags::ACK)
+        did_send_ack();
+
     m_packets_out++;
     m_bytes_out += buffer_size;
+    return payload_size;
+}
+
+KResultOr<size_t> TCPSocket::protocol_sendfile(FileDescription& source, u64 offset, size_t size)
+{
+    // Read the file contents straight into the segment, so they only get copied once on their way out.
+    return send_tcp_packet_with_payload(TCPFlags::PUSH | TCPFlags::ACK, min(size, (size_t)m_mss), [&](u8* payload, size_t payload_size) {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(payload);
+        return source.file().read(source, offset, buffer, payload_size);
+    });
+}
+
+KResult TCPSocket::send_tcp_packet(u16 flags, const UserOrKernelBuffer* payload, size_t payload_size)
+{
+    auto result = send_tcp_packet_with_payload(flags, payload_size, [&](u8* data, size_t size) -> KResultOr<size_t> {
+        if (payload && !payload->read(data, size))
+            return EFAULT;
+        return size;
+    });
+    if (result.is_error())
+        return result.error();
+    return KSuccess;
+}
+
+void TCPSocket::did_send_ack()
+{
+    m_ack_pending = false;
+    m_segments_received_since_ack = 0;
+}
+
+void TCPSocket::send_delayed_ack()
+{
+    // Never hold back the ACK for more than one segment (RFC 5681, 4.2).
+    if (++m_segments_received_since_ack >= 2) {
+        [[maybe_unused]] auto rc = send_tcp_packet(TCPFlags::ACK);
+        return;
+    }
+    if (!m_ack_pending) {
+        m_ack_pending = true;
+        m_ack_deadline = kgettimeofday() + Time::from_milliseconds(delayed_ack_timeout_ms);
+    }
+}
+
+void TCPSocket::prepare_for_transmission(OutgoingPacket& packet)
+{
+    // The segment may have been sitting in the queue for a while, so bring its ACK up to date.
+    auto& tcp_packet = *(TCPPacket*)packet.buffer.data();
+    if (tcp_packet.has_ack())
+        tcp_packet.set_ack_number(m_ack_number);
+}
+
+KResult TCPSocket::transmit(OutgoingPacket& packet, RoutingDecision& routing_decision)
+{
+    prepare_for_transmission(packet);
+
+    packet.tx_time = kgettimeofday();
+    packet.tx_counter++;
+    packet.lost = false;
+    if (packet.tx_counter > 1)
+        m_retransmissions++;
+
+    auto& tcp_packet = *(const TCPPacket*)(packet.buffer.data());
+    if constexpr (TCP_SOCKET_DEBUG) {
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    auto result = routing_decision.adapter->send_ipv4_tcp(routing_decision.next_hop, peer_address(), packet.buffer, m_mss, ttl());
+    if (result.is_error()) {
+        dmesgln("Error ({}) sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            result.error(),
+            local_address(),
+            local_port(),
+            peer_address(),
+            peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+        return result;
+    }
+
+    if (tcp_packet.has_ack())
+        did_send_ack();
+    m_packets_out++;
+    m_bytes_out += packet.buffer.size();
+    return KSuccess;
+}
+
+KResult TCPSocket::transmit_batch(Span<OutgoingPacket*> batch, RoutingDecision& routing_decision)
+{
+    if (batch.size() == 1)
+        return transmit(*batch[0], routing_decision);
+
+    // Glue the segments' payloads together behind the first one's header, and let the adapter cut them apart again.
+    auto& first = *batch[0];
+    prepare_for_transmission(first);
+    size_t header_size = first.buffer.size() - first.payload_size();
+    size_t segment_size = header_size;
+    for (auto* packet : batch)
+        segment_size += packet->payload_size();
+
+    auto segment = ByteBuffer::create_uninitialized(segment_size);
+    memcpy(segment.data(), first.buffer.data(), header_size);
+    size_t offset = header_size;
+    auto now = kgettimeofday();
+    for (auto* packet : batch) {
+        memcpy(segment.data() + offset, packet->buffer.data() + header_size, packet->payload_size());
+        offset += packet->payload_size();
+        packet->tx_time = now;
+        packet->tx_counter++;
+        packet->lost = false;
+    }
+
+    dbgln_if(TCP_SOCKET_DEBUG, "Sending {} TCP segments from {}:{} to {}:{} in one go, seq_no={}, bytes={}",
+        batch.size(), local_address(), local_port(), peer_address(), peer_port(), first.sequence_number, segment_size - header_size);
+
+    auto result = routing_decision.adapter->send_ipv4_tcp(routing_decision.next_hop, peer_address(), segment, m_mss, ttl());
+    if (result.is_error()) {
+        dmesgln("Error ({}) sending {} TCP segments from {}:{} to {}:{}, seq_no={}",
+            result.error(), batch.size(), local_address(), local_port(), peer_address(), peer_port(), first.sequence_number);
+        return result;
+    }
+
+    if (((const TCPPacket*)segment.data())->has_ack())
+        did_send_ack();
+    m_packets_out += batch.size();
+    m_bytes_out += segment_size;
     return KSuccess;
 }
 
 void TCPSocket::send_outgoing_packets()
 {
+    LOCKER(m_not_acked_lock);
+    if (m_not_acked.is_empty())
+        return;
+
     auto routing_decision = route_to(peer_address(), local_address(), bound_interface());
     VERIFY(!routing_decision.is_zero());
 
-    auto now = kgettimeofday();
+    Vector<OutgoingPacket*, 32> batch;
+    size_t batch_size = 0;
+    auto can_join_batch = [&](const OutgoingPacket& packet) {
+        auto& tcp_packet = *(const TCPPacket*)packet.buffer.data();
+        if (packet.tx_counter != 0 || packet.payload_size() == 0 || (tcp_packet.flags() & (TCPFlags::SYN | TCPFlags::FIN | TCPFlags::RST)))
+            return false;
+        if (batch.is_empty())
+            return true;
+        auto& first = *batch.first();
+        auto& last = *batch.last();
+        auto& first_tcp_packet = *(const TCPPacket*)first.buffer.data();
+        return last.payload_size() == m_mss
+            && packet.sequence_number == last.ack_number
+            && tcp_packet.flags() == first_tcp_packet.flags()
+            && tcp_packet.header_size() == first_tcp_packet.header_size()
+            && tcp_packet.header_size() + batch_size + packet.payload_size() <= NetworkAdapter::max_tcp_segment_size;
+    };
+    auto flush_batch = [&] {
+        if (batch.is_empty())
+            return;
+        [[maybe_unused]] auto result = transmit_batch(batch.span(), routing_decision);
+        batch.clear();
+        batch_size = 0;
+    };
 
-    LOCKER(m_not_acked_lock, Lock::Mode::Shared);
+    u32 send_window = min(m_congestion_window, m_peer_window_size);
     for (auto& packet : m_not_acked) {
-        auto diff = now - packet.tx_time;
-        if (diff <= Time::from_nanoseconds(500'000'000))
+        if (packet.sacked || packet.is_in_flight())
             continue;
-        packet.tx_time = now;
-        packet.tx_counter++;
-
-        if constexpr (TCP_SOCKET_DEBUG) {
-            auto& tcp_packet = *(const TCPPacket*)(packet.buffer.data());
-            dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                local_address(), local_port(),
-                peer_address(), peer_port(),
-                (tcp_packet.has_syn() ? "SYN " : ""),
-                (tcp_packet.has_ack() ? "ACK " : ""),
-                (tcp_packet.has_fin() ? "FIN " : ""),
-                (tcp_packet.has_rst() ? "RST " : ""),
-                tcp_packet.sequence_number(),
-                tcp_packet.ack_number(),
-                packet.tx_counter);
-        }
 
-        auto packet_buffer = UserOrKernelBuffer::for_kernel_buffer(packet.buffer.data());
-        int err = routing_decision.adapter->send_ipv4(
-            routing_decision.next_hop, peer_address(), IPv4Protocol::TCP,
-            packet_buffer, packet.buffer.size(), ttl());
-        if (err < 0) {
-            auto& tcp_packet = *(const TCPPacket*)(packet.buffer.data());
-            dmesgln("Error ({}) sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                err,
-                local_address(),
-                local_port(),
-                peer_address(),
-                peer_port(),
-                (tcp_packet.has_syn() ? "SYN " : ""),
-                (tcp_packet.has_ack() ? "ACK " : ""),
-                (tcp_packet.has_fin() ? "FIN " : ""),
-                (tcp_packet.has_rst() ? "RST " : ""),
-                tcp_packet.sequence_number(),
-                tcp_packet.ack_number(),
-                packet.tx_counter);
+        // Always allow one segment into an empty pipe, that's how a zero window gets probed.
+        u32 length = packet.sequence_length();
+        if (m_bytes_in_flight > 0 && m_bytes_in_flight + length > send_window)
+            break;
+
+        // Nagle: don't send a partial segment while there's still unacknowledged data (RFC 896).
+        bool is_partial_segment = packet.tx_counter == 0 && &packet == &m_not_acked.last() && packet.payload_size() < m_mss;
+        auto& tcp_packet = *(const TCPPacket*)(packet.buffer.data());
+        if (!m_no_delay && m_bytes_in_flight > 0 && is_partial_segment && !tcp_packet.has_syn() && !tcp_packet.has_fin())
+            break;
+
+        // Fresh full-sized segments that follow each other go out as one, see transmit_batch().
+        // A failed send is treated like a lost segment; the retransmission timer will try again.
+        if (!can_join_batch(packet))
+            flush_batch();
+        if (can_join_batch(packet)) {
+            batch.append(&packet);
+            batch_size += packet.payload_size();
         } else {
-            m_packets_out++;
-            m_bytes_out += packet.buffer.size();
+            [[maybe_unused]] auto result = transmit(packet, routing_decision);
         }
+        m_bytes_in_flight += length;
     }
+    flush_batch();
 }
 
-void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
+void TCPSocket::process_syn_options(const TCPPacket& packet)
 {
-    if (packet.has_ack()) {
-        u32 ack_number = packet.ack_number();
+    u32 peer_mss = default_mss;
+    bool peer_permits_sack = false;
+    packet.for_each_option([&](u8 kind, ReadonlyBytes data) {
+        if (kind == TCPOptionKind::MSS && data.size() == 2)
+            peer_mss = (data[0] << 8) | data[1];
+        else if (kind == TCPOptionKind::SACKPermitted)
+            peer_permits_sack = true;
+    });
+
+    // We offer SACK on every SYN we send, so it's enabled whenever the peer asks for it too.
+    m_sack_permitted = peer_permits_sack;
+    m_mss = clamp(peer_mss, 64u, local_mss());
+    m_peer_window_size = packet.window_size();
+
+    // RFC 6928: start out with (roughly) ten segments.
+    m_congestion_window = min(10 * m_mss, max(2 * m_mss, 14600u));
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}): mss={}, sack_permitted={}, initial cwnd={}", this, m_mss, m_sack_permitted, m_congestion_window);
+}
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+void TCPSocket::update_rtt(Time sample)
+{
+    // RFC 6298, 2.2 and 2.3
+    i64 rtt = sample.to_microseconds();
+    i64 srtt = m_smoothed_rtt.to_microseconds();
+    i64 rttvar = m_rtt_variance.to_microseconds();
+    if (!m_has_rtt_sample) {
+        srtt = rtt;
+        rttvar = rtt / 2;
+        m_has_rtt_sample = true;
+    } else {
+        i64 delta = srtt > rtt ? srtt - rtt : rtt - srtt;
+        rttvar = (3 * rttvar + delta) / 4;
+        srtt = (7 * srtt + rtt) / 8;
+    }
+    m_smoothed_rtt = Time::from_microseconds(srtt);
+    m_rtt_variance = Time::from_microseconds(rttvar);
 
-        int removed = 0;
-        LOCKER(m_not_acked_lock);
-        while (!m_not_acked.is_empty()) {
-            auto& packet = m_not_acked.first();
+    i64 rto = srtt + max(timer_granularity_ms * 1000, 4 * rttvar);
+    rto = clamp(rto, min_retransmission_timeout_ms * 1000, max_retransmission_timeout_ms * 1000);
+    m_retransmission_timeout = Time::from_microseconds(rto);
+}
 
-            dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
+void TCPSocket::process_sack_blocks(const TCPPacket& packet)
+{
+    auto read_u32 = [](ReadonlyBytes bytes) {
+        return ((u32)bytes[0] << 24) | ((u32)bytes[1] << 16) | ((u32)bytes[2] << 8) | (u32)bytes[3];
+    };
 
-            if (packet.ack_number <= ack_number) {
-                m_not_acked.take_first();
-                removed++;
-            } else {
-                break;
+    packet.for_each_option([&](u8 kind, ReadonlyBytes data) {
+        if (kind != TCPOptionKind::SACK)
+            return;
+        for (size_t i = 0; i + 8 <= data.size(); i += 8) {
+            u32 left_edge = read_u32(data.slice(i, 4));
+            u32 right_edge = read_u32(data.slice(i + 4, 4));
+            for (auto& outgoing : m_not_acked) {
+                if (outgoing.sacked || outgoing.tx_counter == 0)
+                    continue;
+                if (!tcp_sequence_less_than_or_equal(left_edge, outgoing.sequence_number) || !tcp_sequence_less_than_or_equal(outgoing.ack_number, right_edge))
+                    continue;
+                if (outgoing.is_in_flight())
+                    m_bytes_in_flight -= outgoing.sequence_length();
+                outgoing.sacked = true;
             }
         }
+    });
+}
+
+void TCPSocket::mark_sack_holes_as_lost()
+{
+    // A hole is considered lost once enough segments above it have made it (RFC 6675, IsLost()).
+    size_t sacked_above = 0;
+    for (auto& outgoing : m_not_acked) {
+        if (outgoing.sacked)
+            ++sacked_above;
+    }
+    for (auto& outgoing : m_not_acked) {
+        if (outgoing.sacked) {
+            --sacked_above;
+            continue;
+        }
+        if (sacked_above < duplicate_ack_threshold)
+            break;
+        if (outgoing.is_in_flight()) {
+            outgoing.lost = true;
+            m_bytes_in_flight -= outgoing.sequence_length();
+        }
+    }
+}
+
+void TCPSocket::enter_fast_recovery()
+{
+    // RFC 5681, 3.2 and RFC 6582, 3.2
+    m_slow_start_threshold = max(m_bytes_in_flight / 2, 2 * m_mss);
+    m_in_fast_recovery = true;
+    m_recovery_point = m_last_ack_received;
+    for (auto& outgoing : m_not_acked) {
+        if (outgoing.tx_counter > 0)
+            m_recovery_point = outgoing.ack_number;
+    }
 
-        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+    auto& first = m_not_acked.first();
+    if (first.is_in_flight()) {
+        first.lost = true;
+        m_bytes_in_flight -= first.sequence_length();
     }
 
+    // Without SACK, the segments that triggered the duplicate ACKs are still counted as in flight,
+    // so the window is inflated to make up for them.
+    m_congestion_window = m_slow_start_threshold;
+    if (!m_sack_permitted)
+        m_congestion_window += duplicate_ack_threshold * m_mss;
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}): entering fast recovery, ssthresh={}, recovery_point={}", this, m_slow_start_threshold, m_recovery_point);
+}
+
+void TCPSocket::handle_ack(const TCPPacket& packet, u16 payload_size)
+{
+    u32 ack_number = packet.ack_number();
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
+
+    LOCKER(m_not_acked_lock);
+
+    u32 previous_peer_window_size = m_peer_window_size;
+    m_peer_window_size = packet.window_size();
+
+    if (m_sack_permitted)
+        process_sack_blocks(packet);
+
+    auto now = kgettimeofday();
+    Optional<Time> rtt_sample;
+    u32 bytes_acked = 0;
+    int removed = 0;
+    while (!m_not_acked.is_empty()) {
+        auto& outgoing = m_not_acked.first();
+
+        dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", outgoing.ack_number);
+
+        if (!tcp_sequence_less_than_or_equal(outgoing.ack_number, ack_number))
+            break;
+
+        // Karn's algorithm: an ACK for a retransmitted segment says nothing about the RTT.
+        if (outgoing.tx_counter == 1)
+            rtt_sample = now - outgoing.tx_time;
+        else
+            rtt_sample = {};
+
+        if (outgoing.is_in_flight())
+            m_bytes_in_flight -= outgoing.sequence_length();
+        bytes_acked += outgoing.sequence_length();
+        m_not_acked.take_first();
+        removed++;
+    }
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
+
+    if (rtt_sample.has_value())
+        update_rtt(rtt_sample.value());
+
+    if (bytes_acked > 0) {
+        m_last_ack_received = ack_number;
+        m_duplicate_ack_count = 0;
+        if (m_in_fast_recovery) {
+            if (tcp_sequence_less_than(ack_number, m_recovery_point) && !m_not_acked.is_empty()) {
+                // A partial ACK means the next hole was lost as well.
+                auto& first = m_not_acked.first();
+                if (first.is_in_flight()) {
+                    first.lost = true;
+                    m_bytes_in_flight -= first.sequence_length();
+                }
+                if (!m_sack_permitted)
+                    m_congestion_window = (m_congestion_window > bytes_acked ? m_congestion_window - bytes_acked : 0) + m_mss;
+            } else {
+                m_in_fast_recovery = false;
+                m_congestion_window = min(m_slow_start_threshold, m_bytes_in_flight + m_mss);
+            }
+        } else if (m_congestion_window < m_slow_start_threshold) {
+            m_congestion_window += min(bytes_acked, m_mss);
+        } else {
+            m_congestion_window += max(1u, m_mss * m_mss / m_congestion_window);
+        }
+    } else if (ack_number == m_last_ack_received && payload_size == 0 && !packet.has_syn() && !packet.has_fin()
+        && m_peer_window_size == previous_peer_window_size && !m_not_acked.is_empty() && m_not_acked.first().tx_counter > 0) {
+        // RFC 5681, 2: a duplicate ACK.
+        ++m_duplicate_ack_count;
+        if (m_in_fast_recovery) {
+            if (!m_sack_permitted)
+                m_congestion_window += m_mss;
+        } else if (m_duplicate_ack_count == duplicate_ack_threshold) {
+            enter_fast_recovery();
+        }
+    }
+
+    if (m_in_fast_recovery && m_sack_permitted)
+        mark_sack_holes_as_lost();
+
+    send_outgoing_packets();
+}
+
+void TCPSocket::receive_tcp_packet(const TCPPacket& packet, u16 size)
+{
+    if (packet.has_syn() && state() == State::SynSent)
+        process_syn_options(packet);
+
+    if (packet.has_ack())
+        handle_ack(packet, size - packet.header_size());
+
     m_packets_in++;
     m_bytes_in += packet.header_size() + size;
 }
 
-NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket& packet, u16 payload_size)
+bool TCPSocket::handle_retransmission_timer(Time now)
 {
-    struct [[gnu::packed]] PseudoHeader {
-        IPv4Address source;
-        IPv4Address destination;
-        u8 zero;
-        u8 protocol;
-        NetworkOrdered<u16> payload_size;
-    };
+    LOCKER(m_not_acked_lock);
 
-    PseudoHeader pseudo_header { source, destination, 0, (u8)IPv4Protocol::TCP, sizeof(TCPPacket) + payload_size };
-
-    u32 checksum = 0;
-    auto* w = (const NetworkOrdered<u16>*)&pseudo_header;
-    for (size_t i = 0; i < sizeof(pseudo_header) / sizeof(u16); ++i) {
-        checksum += w[i];
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
+    OutgoingPacket* oldest = nullptr;
+    for (auto& outgoing : m_not_acked) {
+        if (outgoing.is_in_flight()) {
+            oldest = &outgoing;
+            break;
+        }
     }
-    w = (const NetworkOrdered<u16>*)&packet;
-    for (size_t i = 0; i < sizeof(packet) / sizeof(u16); ++i) {
-        checksum += w[i];
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
+    if (!oldest)
+        return false;
+    if (now - oldest->tx_time < m_retransmission_timeout)
+        return true;
+
+    // Give up on half-open connections a lot sooner, so a SYN flood can't fill up the backlog for long.
+    auto retransmission_limit = state() == State::SynReceived ? max_syn_ack_retransmission_count : max_retransmission_count;
+    if (oldest->tx_counter >= retransmission_limit) {
+        // RFC 1122, 4.2.3.5: at some point we have to give up on the peer.
+        dmesgln("TCPSocket({}): Giving up on {}:{} after {} retransmissions", this, peer_address(), peer_port(), oldest->tx_counter - 1);
+        m_not_acked.clear();
+        m_bytes_in_flight = 0;
+        set_state(State::Closed);
+        return false;
     }
-    VERIFY(packet.data_offset() * 4 == sizeof(TCPPacket));
-    w = (const NetworkOrdered<u16>*)packet.payload();
-    for (size_t i = 0; i < payload_size / sizeof(u16); ++i) {
-        checksum += w[i];
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
+
+    // RFC 5681, 3.1 and RFC 6298, 5.5: start over from a single segment and back off the timer.
+    m_slow_start_threshold = max(m_bytes_in_flight / 2, 2 * m_mss);
+    m_congestion_window = m_mss;
+    m_retransmission_timeout = min(m_retransmission_timeout + m_retransmission_timeout, Time::from_milliseconds(max_retransmission_timeout_ms));
+    m_in_fast_recovery = false;
+    m_duplicate_ack_count = 0;
+    for (auto& outgoing : m_not_acked) {
+        if (outgoing.is_in_flight())
+            outgoing.lost = true;
     }
-    if (payload_size & 1) {
-        u16 expanded_byte = ((const u8*)packet.payload())[payload_size - 1] << 8;
-        checksum += expanded_byte;
-        if (checksum > 0xffff)
-            checksum = (checksum >> 16) + (checksum & 0xffff);
+    m_bytes_in_flight = 0;
+
+    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}): retransmission timeout, rto={}ms, ssthresh={}", this, m_retransmission_timeout.to_milliseconds(), m_slow_start_threshold);
+
+    send_outgoing_packets();
+    return true;
+}
+
+bool TCPSocket::has_pending_timers() const
+{
+    return m_ack_pending || m_bytes_in_flight > 0;
+}
+
+bool TCPSocket::handle_timers()
+{
+    auto sockets = all_tcp_sockets();
+
+    bool any_timers_pending = false;
+    auto now = kgettimeofday();
+    for (auto& socket : sockets) {
+        LOCKER(socket.lock());
+        if (socket.m_ack_pending && now >= socket.m_ack_deadline) {
+            [[maybe_unused]] auto rc = socket.send_tcp_packet(TCPFlags::ACK);
+        }
+        socket.handle_retransmission_timer(now);
+        if (socket.has_pending_timers())
+            any_timers_pending = true;
     }
-    return ~(checksum & 0xffff);
+    return any_timers_pending;
 }
 
 KResult TCPSocket::protocol_bind()
@@ -349,10 +832,8 @@ KResult TCPSocket::protocol_bind()
 
 KResult TCPSocket::protocol_listen()
 {
-    LOCKER(sockets_by_tuple().lock());
-    if (sockets_by_tuple().resource().contains(tuple()))
+    if (!s_listening_sockets->try_add(tuple(), *this))
         return EADDRINUSE;
-    sockets_by_tuple().resource().set(tuple(), this);
     set_direction(Direction::Passive);
     set_state(State::Listen);
     set_setup_state(SetupState::Completed);
@@ -386,6 +867,7 @@ KResult TCPSocket::protocol_connect(FileDescription& description, ShouldBlock sh
 
     if (should_block == ShouldBlock::Yes) {
         locker.unlock();
+        deliver_loopback_packets();
         auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
         if (Thread::current()->block<Thread::ConnectBlocker>({}, description, unblock_flags).was_interrupted())
             return EINTR;
@@ -408,14 +890,11 @@ int TCPSocket::protocol_allocate_local_port()
     static const u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    LOCKER(sockets_by_tuple().lock());
     for (u16 port = first_scan_port;;) {
         IPv4SocketTuple proposed_tuple(local_address(), port, peer_address(), peer_port());
 
-        auto it = sockets_by_tuple().resource().find(proposed_tuple);
-        if (it == sockets_by_tuple().resource().end()) {
+        if (s_connected_sockets->try_add(proposed_tuple, *this)) {
             set_local_port(port);
-            sockets_by_tuple().resource().set(proposed_tuple, this);
             return port;
         }
         ++port;
@@ -456,6 +935,56 @@ void TCPSocket::shut_down_for_writing()
     }
 }
 
+KResult TCPSocket::setsockopt(FileDescription& description, int level, int option, Userspace<const void*> user_value, socklen_t user_value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::setsockopt(description, level, option, user_value, user_value_size);
+
+    switch (option) {
+    case TCP_NODELAY: {
+        if (user_value_size < sizeof(int))
+            return EINVAL;
+        int value;
+        if (!copy_from_user(&value, static_ptr_cast<const int*>(user_value)))
+            return EFAULT;
+        LOCKER(lock());
+        m_no_delay = value != 0;
+        // Let go of anything the Nagle algorithm was holding back.
+        if (m_no_delay)
+            send_outgoing_packets();
+        return KSuccess;
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
+KResult TCPSocket::getsockopt(FileDescription& description, int level, int option, Userspace<void*> value, Userspace<socklen_t*> value_size)
+{
+    if (level != IPPROTO_TCP)
+        return IPv4Socket::getsockopt(description, level, option, value, value_size);
+
+    socklen_t size;
+    if (!copy_from_user(&size, value_size.unsafe_userspace_ptr()))
+        return EFAULT;
+
+    switch (option) {
+    case TCP_NODELAY: {
+        if (size < sizeof(int))
+            return EINVAL;
+        int no_delay = m_no_delay;
+        if (!copy_to_user(static_ptr_cast<int*>(value), &no_delay))
+            return EFAULT;
+        size = sizeof(int);
+        if (!copy_to_user(value_size, &size))
+            return EFAULT;
+        return KSuccess;
+    }
+    default:
+        return ENOPROTOOPT;
+    }
+}
+
 KResult TCPSocket::close()
 {
     Locker socket_locker(lock());
@@ -14,6 +14,8 @@
 
 namespace Kernel {
 
+struct RoutingDecision;
+
 class TCPSocket final : public IPv4Socket {
 public:
     static void for_each(Function<void(const TCPSocket&)>);
@@ -127,12 +129,38 @@ public:
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
     u32 bytes_out() const { return m_bytes_out; }
+    u32 retransmissions() const { return m_retransmissions; }
+
+    u32 mss() const { return m_mss; }
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 bytes_in_flight() const { return m_bytes_in_flight; }
+    Time smoothed_rtt() const { return m_smoothed_rtt; }
+    Time rtt_variance() const { return m_rtt_variance; }
+    Time retransmission_timeout() const { return m_retransmission_timeout; }
+    bool is_in_fast_recovery() const { return m_in_fast_recovery; }
+    bool is_sack_permitted() const { return m_sack_permitted; }
+    bool no_delay() const { return m_no_delay; }
 
     KResult send_tcp_packet(u16 flags, const UserOrKernelBuffer* = nullptr, size_t = 0);
     void send_outgoing_packets();
     void receive_tcp_packet(const TCPPacket&, u16 size);
+    void process_syn_options(const TCPPacket&);
+
+    // Called for every in-order data segment we receive. The ACK for it is
+    // either sent right away or held back for a little while in the hope
+    // that it can ride along with outgoing data.
+    void send_delayed_ack();
+
+    // How often NetworkTask should call handle_timers() while some socket has a timer running.
+    static constexpr i64 timer_granularity_ms = 20;
+    static constexpr i64 delayed_ack_timeout_ms = 40;
 
-    static Lockable<HashMap<IPv4SocketTuple, TCPSocket*>>& sockets_by_tuple();
+    // Fires expired delayed ACK and retransmission timers. Returns whether any timer is still pending.
+    static bool handle_timers();
+
+    // Looks up the socket an incoming segment belongs to: established connections first,
+    // then connections that are still being set up, and finally listening sockets.
     static RefPtr<TCPSocket> from_tuple(const IPv4SocketTuple& tuple);
     static RefPtr<TCPSocket> from_endpoints(const IPv4Address& local_address, u16 local_port, const IPv4Address& peer_address, u16 peer_port);
 
@@ -146,6 +174,9 @@ public:
 
     virtual KResult close() override;
 
+    virtual KResult setsockopt(FileDescription&, int level, int option, Userspace<const void*>, socklen_t) override;
+    virtual KResult getsockopt(FileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
+
 protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
@@ -153,12 +184,29 @@ private:
     explicit TCPSocket(int protocol);
     virtual const char* class_name() const override { return "TCPSocket"; }
 
-    static NetworkOrdered<u16> compute_tcp_checksum(const IPv4Address& source, const IPv4Address& destination, const TCPPacket&, u16 payload_size);
+    template<typename FillPayload>
+    KResultOr<size_t> send_tcp_packet_with_payload(u16 flags, size_t payload_size, FillPayload);
+
+    struct OutgoingPacket;
+    void prepare_for_transmission(OutgoingPacket&);
+    KResult transmit(OutgoingPacket&, RoutingDecision&);
+    KResult transmit_batch(Span<OutgoingPacket*>, RoutingDecision&);
+    void handle_ack(const TCPPacket&, u16 payload_size);
+    void process_sack_blocks(const TCPPacket&);
+    void mark_sack_holes_as_lost();
+    void update_rtt(Time sample);
+    void enter_fast_recovery();
+    bool handle_retransmission_timer(Time now);
+    bool has_pending_timers() const;
+    void remove_from_syn_backlog();
+    u32 local_mss() const;
+    void did_send_ack();
 
     virtual void shut_down_for_writing() override;
 
     virtual KResultOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
     virtual KResultOr<size_t> protocol_send(const UserOrKernelBuffer&, size_t) override;
+    virtual KResultOr<size_t> protocol_sendfile(FileDescription& source, u64 offset, size_t) override;
     virtual KResult protocol_connect(FileDescription&, ShouldBlock) override;
     virtual int protocol_allocate_local_port() override;
     virtual bool protocol_is_disconnected() const override;
@@ -177,12 +225,59 @@ private:
     u32 m_bytes_in { 0 };
     u32 m_packets_out { 0 };
     u32 m_bytes_out { 0 };
+    u32 m_retransmissions { 0 };
+
+    // Connections that have received a SYN but not yet the final ACK of the handshake are kept
+    // in a table of their own, and each listening socket only accepts so many of them.
+    static constexpr size_t max_syn_backlog = 256;
+    static constexpr int max_syn_ack_retransmission_count = 5;
+    bool m_in_syn_backlog { false };
+
+    // The MSS we assume until the peer tells us otherwise (RFC 1122, 4.2.2.6).
+    static constexpr u32 default_mss = 536;
+    static constexpr u32 duplicate_ack_threshold = 3;
+    static constexpr int max_retransmission_count = 15;
+    static constexpr i64 initial_retransmission_timeout_ms = 1000;
+    static constexpr i64 min_retransmission_timeout_ms = 200;
+    static constexpr i64 max_retransmission_timeout_ms = 60000;
+
+    // Congestion control, NewReno flavored (RFC 5681, RFC 6582), using SACK information
+    // (RFC 2018, RFC 6675) to pick what to retransmit when the peer supports it.
+    u32 m_mss { default_mss };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+    u32 m_bytes_in_flight { 0 };
+    u32 m_peer_window_size { 0 };
+    u32 m_last_ack_received { 0 };
+    u32 m_duplicate_ack_count { 0 };
+    bool m_in_fast_recovery { false };
+    u32 m_recovery_point { 0 };
+    bool m_sack_permitted { false };
+
+    // Round-trip time estimation (RFC 6298).
+    bool m_has_rtt_sample { false };
+    Time m_smoothed_rtt {};
+    Time m_rtt_variance {};
+    Time m_retransmission_timeout { Time::from_milliseconds(initial_retransmission_timeout_ms) };
+
+    // Delayed ACKs (RFC 1122, 4.2.3.2) and the Nagle algorithm (RFC 896).
+    bool m_ack_pending { false };
+    u32 m_segments_received_since_ack { 0 };
+    Time m_ack_deadline {};
+    bool m_no_delay { false };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
         u32 ack_number { 0 };
         ByteBuffer buffer;
         int tx_counter { 0 };
         Time tx_time {};
+        bool sacked { false };
+        bool lost { false };
+
+        u32 sequence_length() const { return ack_number - sequence_number; }
+        size_t payload_size() const;
+        bool is_in_flight() const { return tx_counter > 0 && !sacked && !lost; }
     };
 
     Lock m_not_acked_lock { "TCPSocket unacked packets" };
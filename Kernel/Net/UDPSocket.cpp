@@ -8,6 +8,7 @@
 #include <Kernel/Devices/RandomDevice.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/Routing.h>
+#include <Kernel/Net/SocketTable.h>
 #include <Kernel/Net/UDP.h>
 #include <Kernel/Net/UDPSocket.h>
 #include <Kernel/Process.h>
@@ -15,31 +16,21 @@
 
 namespace Kernel {
 
-void UDPSocket::for_each(Function<void(const UDPSocket&)> callback)
-{
-    LOCKER(sockets_by_port().lock(), Lock::Mode::Shared);
-    for (auto it : sockets_by_port().resource())
-        callback(*it.value);
-}
+static AK::Singleton<SocketTable<u16, UDPSocket>> s_sockets_by_port;
 
-static AK::Singleton<Lockable<HashMap<u16, UDPSocket*>>> s_map;
-
-Lockable<HashMap<u16, UDPSocket*>>& UDPSocket::sockets_by_port()
+void UDPSocket::for_each(Function<void(const UDPSocket&)> callback)
 {
-    return *s_map;
+    NonnullRefPtrVector<UDPSocket> sockets;
+    s_sockets_by_port->collect(sockets);
+    for (auto& socket : sockets)
+        callback(socket);
 }
 
 SocketHandle<UDPSocket> UDPSocket::from_port(u16 port)
 {
-    RefPtr<UDPSocket> socket;
-    {
-        LOCKER(sockets_by_port().lock(), Lock::Mode::Shared);
-        auto it = sockets_by_port().resource().find(port);
-        if (it == sockets_by_port().resource().end())
-            return {};
-        socket = (*it).value;
-        VERIFY(socket);
-    }
+    auto socket = s_sockets_by_port->get(port);
+    if (!socket)
+        return {};
     return { *socket };
 }
 
@@ -50,8 +41,7 @@ UDPSocket::UDPSocket(int protocol)
 
 UDPSocket::~UDPSocket()
 {
-    LOCKER(sockets_by_port().lock());
-    sockets_by_port().resource().remove(local_port());
+    s_sockets_by_port->remove(local_port(), *this);
 }
 
 NonnullRefPtr<UDPSocket> UDPSocket::create(int protocol)
@@ -104,12 +94,9 @@ int UDPSocket::protocol_allocate_local_port()
     static const u16 ephemeral_port_range_size = last_ephemeral_port - first_ephemeral_port;
     u16 first_scan_port = first_ephemeral_port + get_good_random<u16>() % ephemeral_port_range_size;
 
-    LOCKER(sockets_by_port().lock());
     for (u16 port = first_scan_port;;) {
-        auto it = sockets_by_port().resource().find(port);
-        if (it == sockets_by_port().resource().end()) {
+        if (s_sockets_by_port->try_add(port, *this)) {
             set_local_port(port);
-            sockets_by_port().resource().set(port, this);
             return port;
         }
         ++port;
@@ -123,10 +110,8 @@ int UDPSocket::protocol_allocate_local_port()
 
 KResult UDPSocket::protocol_bind()
 {
-    LOCKER(sockets_by_port().lock());
-    if (sockets_by_port().resource().contains(local_port()))
+    if (!s_sockets_by_port->try_add(local_port(), *this))
         return EADDRINUSE;
-    sockets_by_port().resource().set(local_port(), this);
     return KSuccess;
 }
 
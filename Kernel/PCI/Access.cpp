@@ -202,6 +202,50 @@ u8 get_interrupt_line(Address address)
     return read8(address, PCI_INTERRUPT_LINE);
 }
 
+static Optional<Capability> find_msi_capability(Address address)
+{
+    for (auto& capability : get_capabilities(address)) {
+        if (capability.id() == PCI_CAPABILITY_MSI)
+            return capability;
+    }
+    return {};
+}
+
+bool is_msi_capable(Address address)
+{
+    return find_msi_capability(address).has_value();
+}
+
+void enable_message_signalled_interrupt(Address address, u8 vector, u8 destination_apic_id)
+{
+    auto capability = find_msi_capability(address);
+    VERIFY(capability.has_value());
+
+    // Reprogramming the message while it's enabled could make the device send a half updated one.
+    u16 control = capability->read16(PCI_MSI_CONTROL);
+    control &= ~(PCI_MSI_CONTROL_ENABLE | PCI_MSI_CONTROL_MULTIPLE_MESSAGE_ENABLE);
+    capability->write16(PCI_MSI_CONTROL, control);
+
+    // Fixed delivery, edge triggered, to the local APIC with this physical ID.
+    capability->write32(PCI_MSI_ADDRESS_LOW, PCI_MSI_ADDRESS_BASE | (destination_apic_id << 12));
+    if (control & PCI_MSI_CONTROL_64BIT) {
+        capability->write32(PCI_MSI_ADDRESS_HIGH, 0);
+        capability->write16(PCI_MSI_DATA_64BIT, vector);
+    } else {
+        capability->write16(PCI_MSI_DATA_32BIT, vector);
+    }
+
+    disable_interrupt_line(address);
+    capability->write16(PCI_MSI_CONTROL, control | PCI_MSI_CONTROL_ENABLE);
+}
+
+void disable_message_signalled_interrupt(Address address)
+{
+    auto capability = find_msi_capability(address);
+    VERIFY(capability.has_value());
+    capability->write16(PCI_MSI_CONTROL, capability->read16(PCI_MSI_CONTROL) & ~PCI_MSI_CONTROL_ENABLE);
+}
+
 u32 get_BAR0(Address address)
 {
     return read32(address, PCI_BAR0);
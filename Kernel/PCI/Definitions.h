@@ -52,6 +52,17 @@ namespace Kernel {
 #define PCI_CAPABILITY_VENDOR_SPECIFIC 0x9
 #define PCI_CAPABILITY_MSIX 0x11
 
+// Offsets into the MSI capability structure.
+#define PCI_MSI_CONTROL 0x2         // word
+#define PCI_MSI_ADDRESS_LOW 0x4     // dword
+#define PCI_MSI_ADDRESS_HIGH 0x8    // dword, only if 64-bit capable
+#define PCI_MSI_DATA_32BIT 0x8      // word
+#define PCI_MSI_DATA_64BIT 0xc      // word
+#define PCI_MSI_CONTROL_ENABLE (1 << 0)
+#define PCI_MSI_CONTROL_MULTIPLE_MESSAGE_ENABLE (0x7 << 4)
+#define PCI_MSI_CONTROL_64BIT (1 << 7)
+#define PCI_MSI_ADDRESS_BASE 0xfee00000
+
 namespace PCI {
 struct ID {
     u16 vendor_id { 0 };
@@ -208,6 +219,9 @@ void enumerate(Function<void(Address, ID)> callback);
 void enable_interrupt_line(Address);
 void disable_interrupt_line(Address);
 u8 get_interrupt_line(Address);
+bool is_msi_capable(Address);
+void enable_message_signalled_interrupt(Address, u8 vector, u8 destination_apic_id);
+void disable_message_signalled_interrupt(Address);
 void raw_access(Address, u32, size_t, u32);
 u32 get_BAR0(Address);
 u32 get_BAR1(Address);
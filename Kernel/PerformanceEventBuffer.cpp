@@ -7,7 +7,9 @@
 #include <AK/JsonArraySerializer.h>
 #include <AK/JsonObject.h>
 #include <AK/JsonObjectSerializer.h>
+#include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/x86/SmapDisabler.h>
+#include <Kernel/Devices/AsyncDeviceRequest.h>
 #include <Kernel/FileSystem/Custody.h>
 #include <Kernel/KBufferBuilder.h>
 #include <Kernel/PerformanceEventBuffer.h>
@@ -15,9 +17,33 @@
 
 namespace Kernel {
 
-PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer)
+PerformanceEventBuffer::PerformanceEventBuffer(NonnullOwnPtr<KBuffer> buffer, WhenFull when_full)
     : m_buffer(move(buffer))
+    , m_when_full(when_full)
 {
+    size_t processor_count = max(Processor::count(), 1u);
+    size_t capacity_per_segment = capacity() / processor_count;
+    VERIFY(capacity_per_segment > 0);
+    m_segments.resize(processor_count);
+    for (size_t i = 0; i < processor_count; ++i) {
+        m_segments[i].first_index = i * capacity_per_segment;
+        m_segments[i].capacity = capacity_per_segment;
+    }
+}
+
+void PerformanceEventBuffer::clear()
+{
+    InterruptDisabler disabler;
+    for (auto& segment : m_segments)
+        segment.appended = 0;
+}
+
+size_t PerformanceEventBuffer::count() const
+{
+    size_t count = 0;
+    for (auto& segment : m_segments)
+        count += segment.count();
+    return count;
 }
 
 KResult PerformanceEventBuffer::append(int type, FlatPtr arg1, FlatPtr arg2)
@@ -55,7 +81,9 @@ static Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(Fl
 
 KResult PerformanceEventBuffer::append_with_eip_and_ebp(u32 eip, u32 ebp, int type, FlatPtr arg1, FlatPtr arg2)
 {
-    if (count() >= capacity())
+    InterruptDisabler disabler;
+    auto& segment = m_segments[Processor::id()];
+    if (segment.appended >= segment.capacity && m_when_full == WhenFull::DropNewEvents)
         return ENOBUFS;
 
     PerformanceEvent event;
@@ -63,6 +91,8 @@ KResult PerformanceEventBuffer::append_with_eip_and_ebp(u32 eip, u32 ebp, int ty
 
     switch (type) {
     case PERF_EVENT_SAMPLE:
+        event.data.sample.counter = arg1;
+        event.data.sample.period = arg2;
         break;
     case PERF_EVENT_MALLOC:
         event.data.malloc.size = arg1;
@@ -80,11 +110,65 @@ KResult PerformanceEventBuffer::append_with_eip_and_ebp(u32 eip, u32 ebp, int ty
     memcpy(event.stack, backtrace.data(), event.stack_size * sizeof(FlatPtr));
 
     event.tid = Thread::current()->tid().value();
-    event.timestamp = TimeManagement::the().uptime_ms();
-    at(m_count++) = event;
+    event.pid = Thread::current()->pid().value();
+    event.timestamp = TimeManagement::the().monotonic_time().to_nanoseconds();
+    at(segment.first_index + segment.appended % segment.capacity) = event;
+    ++segment.appended;
     return KSuccess;
 }
 
+KResult PerformanceEventBuffer::append_trace_event(int type, ThreadID tid, ProcessID pid, u64 timestamp, const PerformanceEvent::Data& data)
+{
+    InterruptDisabler disabler;
+    auto& segment = m_segments[Processor::id()];
+    if (segment.appended >= segment.capacity && m_when_full == WhenFull::DropNewEvents)
+        return ENOBUFS;
+
+    // Fill in the slot directly, so that the (unused) stack doesn't get copied around.
+    auto& event = at(segment.first_index + segment.appended % segment.capacity);
+    event.type = type;
+    event.stack_size = 0;
+    event.tid = tid.value();
+    event.pid = pid.value();
+    event.timestamp = timestamp;
+    event.data = data;
+    ++segment.appended;
+    return KSuccess;
+}
+
+void PerformanceEventBuffer::take_sample(const RegisterState& regs, int counter, u32 sample_period)
+{
+    extern PerformanceEventBuffer* g_global_perf_events;
+    extern bool g_profiling_all_threads;
+
+    auto* current_thread = Thread::current();
+    if (!current_thread)
+        return;
+
+    PerformanceEventBuffer* perf_events = nullptr;
+
+    if (g_profiling_all_threads) {
+        VERIFY(g_global_perf_events);
+        // FIXME: We currently don't collect samples while idle.
+        //        That will be an interesting mode to add in the future. :^)
+        if (current_thread != Processor::current().idle_thread()) {
+            perf_events = g_global_perf_events;
+            if (current_thread->process().space().enforces_syscall_regions()) {
+                // NOTE: This only takes a new snapshot of the process's address
+                //       space layout if it changed since it was last sampled.
+                perf_events->add_process(current_thread->process());
+            }
+        }
+    } else if (current_thread->process().is_profiling()) {
+        VERIFY(current_thread->process().perf_events());
+        perf_events = current_thread->process().perf_events();
+    }
+
+    if (perf_events) {
+        [[maybe_unused]] auto rc = perf_events->append_with_eip_and_ebp(regs.eip, regs.ebp, PERF_EVENT_SAMPLE, counter, sample_period);
+    }
+}
+
 PerformanceEvent& PerformanceEventBuffer::at(size_t index)
 {
     VERIFY(index < capacity());
@@ -92,16 +176,50 @@ PerformanceEvent& PerformanceEventBuffer::at(size_t index)
     return events[index];
 }
 
+static const char* counter_name(u32 counter)
+{
+    switch (counter) {
+    case PERF_COUNTER_TIMER:
+        return "timer";
+    case PERF_COUNTER_CYCLES:
+        return "cycles";
+    case PERF_COUNTER_INSTRUCTIONS:
+        return "instructions";
+    case PERF_COUNTER_CACHE_MISSES:
+        return "cache_misses";
+    case PERF_COUNTER_BRANCH_MISSES:
+        return "branch_misses";
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
 template<typename Serializer>
 bool PerformanceEventBuffer::to_json_impl(Serializer& object) const
 {
     auto array = object.add_array("events");
-    for (size_t i = 0; i < m_count; ++i) {
-        auto& event = at(i);
+
+    // Merge the segments back into a single stream of events ordered by time.
+    Vector<size_t> positions;
+    positions.resize(m_segments.size());
+    for (;;) {
+        Optional<size_t> next_segment;
+        for (size_t i = 0; i < m_segments.size(); ++i) {
+            if (positions[i] >= m_segments[i].count())
+                continue;
+            if (!next_segment.has_value() || at(m_segments[i].index_of(positions[i])).timestamp < at(m_segments[next_segment.value()].index_of(positions[next_segment.value()])).timestamp)
+                next_segment = i;
+        }
+        if (!next_segment.has_value())
+            break;
+        auto& event = at(m_segments[next_segment.value()].index_of(positions[next_segment.value()]++));
         auto event_object = array.add_object();
         switch (event.type) {
         case PERF_EVENT_SAMPLE:
             event_object.add("type", "sample");
+            event_object.add("counter", counter_name(event.data.sample.counter));
+            if (event.data.sample.counter != PERF_COUNTER_TIMER)
+                event_object.add("period", event.data.sample.period);
             break;
         case PERF_EVENT_MALLOC:
             event_object.add("type", "malloc");
@@ -112,9 +230,50 @@ bool PerformanceEventBuffer::to_json_impl(Serializer& object) const
             event_object.add("type", "free");
             event_object.add("ptr", static_cast<u64>(event.data.free.ptr));
             break;
+        case PERF_EVENT_SYSCALL_ENTER: {
+            event_object.add("type", "syscall_enter");
+            event_object.add("function", Syscall::to_string((Syscall::Function)event.data.syscall_enter.function));
+            auto arguments_array = event_object.add_array("arguments");
+            for (auto argument : event.data.syscall_enter.arguments)
+                arguments_array.add(static_cast<u64>(argument));
+            arguments_array.finish();
+            break;
+        }
+        case PERF_EVENT_SYSCALL_EXIT:
+            event_object.add("type", "syscall_exit");
+            event_object.add("function", Syscall::to_string((Syscall::Function)event.data.syscall_exit.function));
+            event_object.add("result", static_cast<i32>(event.data.syscall_exit.result));
+            break;
+        case PERF_EVENT_CONTEXT_SWITCH:
+            event_object.add("type", "context_switch");
+            event_object.add("next_tid", event.data.context_switch.next_tid);
+            event_object.add("next_pid", event.data.context_switch.next_pid);
+            event_object.add("previous_state", Thread::state_name((Thread::State)event.data.context_switch.previous_state));
+            break;
+        case PERF_EVENT_PAGE_FAULT:
+            event_object.add("type", "page_fault");
+            event_object.add("address", static_cast<u64>(event.data.page_fault.address));
+            event_object.add("ip", static_cast<u64>(event.data.page_fault.instruction_pointer));
+            event_object.add("write", (event.data.page_fault.code & PageFaultFlags::Write) != 0);
+            event_object.add("not_present", (event.data.page_fault.code & PageFaultFlags::ProtectionViolation) == 0);
+            event_object.add("user", (event.data.page_fault.code & PageFaultFlags::UserMode) != 0);
+            break;
+        case PERF_EVENT_BLOCK_IO:
+            event_object.add("type", "block_io");
+            event_object.add("major", event.data.block_io.major);
+            event_object.add("minor", event.data.block_io.minor);
+            event_object.add("block", event.data.block_io.block_index);
+            event_object.add("count", event.data.block_io.block_count);
+            event_object.add("write", event.data.block_io.is_write != 0);
+            event_object.add("latency_us", event.data.block_io.latency_us);
+            event_object.add("succeeded", event.data.block_io.result == AsyncDeviceRequest::Success);
+            break;
         }
         event_object.add("tid", event.tid);
-        event_object.add("timestamp", event.timestamp);
+        event_object.add("pid", event.pid);
+        // Profiler and friends count in milliseconds, tracing needs the nanoseconds.
+        event_object.add("timestamp", event.timestamp / 1'000'000);
+        event_object.add("timestamp_ns", event.timestamp);
         auto stack_array = event_object.add_array("stack");
         for (size_t j = 0; j < event.stack_size; ++j) {
             stack_array.add(event.stack[j]);
@@ -152,12 +311,12 @@ bool PerformanceEventBuffer::to_json(KBufferBuilder& builder) const
     return to_json_impl(object);
 }
 
-OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size)
+OwnPtr<PerformanceEventBuffer> PerformanceEventBuffer::try_create_with_size(size_t buffer_size, WhenFull when_full)
 {
     auto buffer = KBuffer::try_create_with_size(buffer_size, Region::Access::Read | Region::Access::Write, "Performance events", AllocationStrategy::AllocateNow);
     if (!buffer)
         return {};
-    return adopt_own(*new PerformanceEventBuffer(buffer.release_nonnull()));
+    return adopt_own(*new PerformanceEventBuffer(buffer.release_nonnull(), when_full));
 }
 
 void PerformanceEventBuffer::add_process(const Process& process)
@@ -166,6 +325,17 @@ void PerformanceEventBuffer::add_process(const Process& process)
 
     ScopedSpinLock locker(process.space().get_lock());
 
+    // Global profiling calls this every time a process is sampled, so don't take
+    // a new snapshot unless the address space actually changed since the last one.
+    auto generation = process.space().regions_generation();
+    if (auto it = m_processes.find(process.pid()); it != m_processes.end() && it->value->regions_generation == generation) {
+        process.for_each_thread([&](auto& thread) {
+            it->value->threads.set(thread.tid());
+            return IterationDecision::Continue;
+        });
+        return;
+    }
+
     String executable;
     if (process.executable())
         executable = process.executable()->absolute_path();
@@ -174,6 +344,7 @@ void PerformanceEventBuffer::add_process(const Process& process)
         .pid = process.pid().value(),
         .executable = executable,
         .threads = {},
+        .regions_generation = generation,
         .regions = {},
     });
     process.for_each_thread([&](auto& thread) {
@@ -13,6 +13,11 @@ namespace Kernel {
 
 class KBufferBuilder;
 
+struct [[gnu::packed]] SamplePerformanceEvent {
+    u32 counter;
+    u32 period;
+};
+
 struct [[gnu::packed]] MallocPerformanceEvent {
     size_t size;
     FlatPtr ptr;
@@ -23,14 +28,56 @@ struct [[gnu::packed]] FreePerformanceEvent {
     FlatPtr ptr;
 };
 
+struct [[gnu::packed]] SyscallEnterPerformanceEvent {
+    u32 function;
+    FlatPtr arguments[3];
+};
+
+struct [[gnu::packed]] SyscallExitPerformanceEvent {
+    u32 function;
+    FlatPtr result;
+};
+
+// The event's thread is the one that was switched away from.
+struct [[gnu::packed]] ContextSwitchPerformanceEvent {
+    u32 next_tid;
+    u32 next_pid;
+    u8 previous_state;
+};
+
+struct [[gnu::packed]] PageFaultPerformanceEvent {
+    FlatPtr address;
+    FlatPtr instruction_pointer;
+    u16 code;
+};
+
+// The event's thread is the one that issued the request, and its timestamp is when the request completed.
+struct [[gnu::packed]] BlockIOPerformanceEvent {
+    u64 block_index;
+    u32 block_count;
+    u32 latency_us;
+    u16 major;
+    u16 minor;
+    u8 is_write;
+    u8 result;
+};
+
 struct [[gnu::packed]] PerformanceEvent {
     u8 type { 0 };
     u8 stack_size { 0 };
     u32 tid { 0 };
+    u32 pid { 0 };
+    // Nanoseconds since boot.
     u64 timestamp;
-    union {
+    union Data {
+        SamplePerformanceEvent sample;
         MallocPerformanceEvent malloc;
         FreePerformanceEvent free;
+        SyscallEnterPerformanceEvent syscall_enter;
+        SyscallExitPerformanceEvent syscall_exit;
+        ContextSwitchPerformanceEvent context_switch;
+        PageFaultPerformanceEvent page_fault;
+        BlockIOPerformanceEvent block_io;
     } data;
     static constexpr size_t max_stack_frame_count = 32;
     FlatPtr stack[max_stack_frame_count];
@@ -38,34 +85,56 @@ struct [[gnu::packed]] PerformanceEvent {
 
 class PerformanceEventBuffer {
 public:
-    static OwnPtr<PerformanceEventBuffer> try_create_with_size(size_t buffer_size);
+    enum class WhenFull {
+        DropNewEvents,
+        OverwriteOldestEvents,
+    };
+
+    static OwnPtr<PerformanceEventBuffer> try_create_with_size(size_t buffer_size, WhenFull = WhenFull::DropNewEvents);
 
     KResult append(int type, FlatPtr arg1, FlatPtr arg2);
     KResult append_with_eip_and_ebp(u32 eip, u32 ebp, int type, FlatPtr arg1, FlatPtr arg2);
 
-    void clear()
-    {
-        m_count = 0;
-    }
+    // Appends an event without a backtrace, which is what keeps the tracepoints (see KTrace) cheap.
+    KResult append_trace_event(int type, ThreadID, ProcessID, u64 timestamp, const PerformanceEvent::Data&);
+
+    // Records a PERF_EVENT_SAMPLE of the current thread into whichever buffer is profiling it, if any.
+    static void take_sample(const RegisterState&, int counter, u32 sample_period);
+
+    void clear();
 
     size_t capacity() const { return m_buffer->size() / sizeof(PerformanceEvent); }
-    size_t count() const { return m_count; }
-    const PerformanceEvent& at(size_t index) const
-    {
-        return const_cast<PerformanceEventBuffer&>(*this).at(index);
-    }
+    size_t count() const;
 
     bool to_json(KBufferBuilder&) const;
 
     void add_process(const Process&);
 
 private:
-    explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
+    PerformanceEventBuffer(NonnullOwnPtr<KBuffer>, WhenFull);
+
+    // Every processor gets its own slice of the buffer, which only it ever appends to
+    // (with interrupts disabled). That way appending an event never needs a lock,
+    // and processors sampling at the same time don't fight over the same cache lines.
+    struct Segment {
+        size_t first_index { 0 };
+        size_t capacity { 0 };
+        u64 appended { 0 };
+
+        size_t count() const { return min(appended, (u64)capacity); }
+        // Index (into the whole buffer) of the n-th oldest event in this segment.
+        size_t index_of(size_t n) const
+        {
+            size_t oldest = appended > capacity ? appended % capacity : 0;
+            return first_index + (oldest + n) % capacity;
+        }
+    };
 
     struct SampledProcess {
         ProcessID pid;
         String executable;
         HashTable<ThreadID> threads;
+        u32 regions_generation { 0 };
 
         struct Region {
             String name;
@@ -78,9 +147,14 @@ private:
     bool to_json_impl(Serializer&) const;
 
     PerformanceEvent& at(size_t index);
+    const PerformanceEvent& at(size_t index) const
+    {
+        return const_cast<PerformanceEventBuffer&>(*this).at(index);
+    }
 
-    size_t m_count { 0 };
     NonnullOwnPtr<KBuffer> m_buffer;
+    Vector<Segment> m_segments;
+    WhenFull m_when_full { WhenFull::DropNewEvents };
 
     HashMap<ProcessID, NonnullOwnPtr<SampledProcess>> m_processes;
 };
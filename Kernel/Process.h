@@ -251,6 +251,9 @@ public:
     KResultOr<int> sys$get_process_name(Userspace<char*> buffer, size_t buffer_size);
     KResultOr<int> sys$set_process_name(Userspace<const char*> user_name, size_t user_name_length);
     KResultOr<int> sys$watch_file(Userspace<const char*> path, size_t path_length);
+    KResultOr<int> sys$add_inode_watch(int fd, Userspace<const char*> path, size_t path_length);
+    KResultOr<int> sys$remove_inode_watch(int fd, int watch_descriptor);
+    KResultOr<int> sys$watch_memory_pressure();
     KResultOr<int> sys$dbgputch(u8);
     KResultOr<int> sys$dbgputstr(Userspace<const u8*>, int length);
     KResultOr<int> sys$dump_backtrace();
@@ -294,6 +297,13 @@ public:
     KResultOr<int> sys$purge(int mode);
     KResultOr<int> sys$select(Userspace<const Syscall::SC_select_params*>);
     KResultOr<int> sys$poll(Userspace<const Syscall::SC_poll_params*>);
+    KResultOr<int> sys$epoll_create(int flags);
+    KResultOr<int> sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*>);
+    KResultOr<int> sys$epoll_wait(Userspace<const Syscall::SC_epoll_wait_params*>);
+    KResultOr<ssize_t> sys$sendfile(Userspace<const Syscall::SC_sendfile_params*>);
+    KResultOr<ssize_t> sys$splice(Userspace<const Syscall::SC_splice_params*>);
+    KResultOr<int> sys$io_ring_enter(Userspace<IORing*>);
+    KResultOr<FlatPtr> handle_io_ring_submission(FlatPtr function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3);
     KResultOr<ssize_t> sys$get_dir_entries(int fd, Userspace<void*>, ssize_t);
     KResultOr<int> sys$getcwd(Userspace<char*>, size_t);
     KResultOr<int> sys$chdir(Userspace<const char*>, size_t);
@@ -302,6 +312,7 @@ public:
     KResultOr<int> sys$gettimeofday(Userspace<timeval*>);
     KResultOr<int> sys$clock_gettime(clockid_t, Userspace<timespec*>);
     KResultOr<int> sys$clock_settime(clockid_t, Userspace<const timespec*>);
+    KResultOr<FlatPtr> sys$map_time_page();
     KResultOr<int> sys$clock_nanosleep(Userspace<const Syscall::SC_clock_nanosleep_params*>);
     KResultOr<int> sys$gethostname(Userspace<char*>, ssize_t);
     KResultOr<int> sys$sethostname(Userspace<const char*>, ssize_t);
@@ -372,9 +383,11 @@ public:
     KResultOr<int> sys$setkeymap(Userspace<const Syscall::SC_setkeymap_params*>);
     KResultOr<int> sys$module_load(Userspace<const char*> path, size_t path_length);
     KResultOr<int> sys$module_unload(Userspace<const char*> name, size_t name_length);
-    KResultOr<int> sys$profiling_enable(pid_t);
+    KResultOr<int> sys$profiling_enable(pid_t, int counter, u32 sample_period);
     KResultOr<int> sys$profiling_disable(pid_t);
     KResultOr<int> sys$profiling_free_buffer(pid_t);
+    KResultOr<int> sys$ktrace_enable(pid_t, u32 categories);
+    KResultOr<int> sys$ktrace_disable();
     KResultOr<int> sys$futex(Userspace<const Syscall::SC_futex_params*>);
     KResultOr<int> sys$chroot(Userspace<const char*> path, size_t path_length, int mount_flags);
     KResultOr<int> sys$pledge(Userspace<const Syscall::SC_pledge_params*>);
@@ -8,7 +8,9 @@
 #include <AK/ScopeGuard.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Time.h>
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/Debug.h>
+#include <Kernel/KTrace.h>
 #include <Kernel/Panic.h>
 #include <Kernel/PerformanceEventBuffer.h>
 #include <Kernel/Process.h>
@@ -22,9 +24,6 @@
 
 namespace Kernel {
 
-extern bool g_profiling_all_threads;
-extern PerformanceEventBuffer* g_global_perf_events;
-
 class SchedulerPerProcessorData {
     AK_MAKE_NONCOPYABLE(SchedulerPerProcessorData);
     AK_MAKE_NONMOVABLE(SchedulerPerProcessorData);
@@ -55,16 +54,31 @@ READONLY_AFTER_INIT static Process* s_colonel_process;
 struct ThreadReadyQueue {
     IntrusiveList<Thread, RawPtr<Thread>, &Thread::m_ready_queue_node> thread_list;
 };
-static SpinLock<u8> g_ready_queues_lock;
-static u32 g_ready_queues_mask;
-static constexpr u32 g_ready_queue_buckets = sizeof(g_ready_queues_mask) * 8;
-READONLY_AFTER_INIT static ThreadReadyQueue* g_ready_queues; // g_ready_queue_buckets entries
+
+static constexpr u32 g_ready_queue_buckets = sizeof(u32) * 8;
+
+// Thread affinity is a 32-bit mask, so there can never be more processors than this.
+static constexpr u32 g_max_ready_queue_processors = sizeof(u32) * 8;
+
+struct ThreadReadyQueues {
+    SpinLock<u8> lock;
+    u32 mask { 0 };
+    ThreadReadyQueue queues[g_ready_queue_buckets];
+
+    bool is_empty() const { return mask == 0; }
+
+    Thread* pull_next(u32 affinity_mask);
+    void remove(Thread&);
+    void append(Thread&, u32 priority, u32 cpu);
+};
+
+READONLY_AFTER_INIT static ThreadReadyQueues* g_ready_queues; // g_max_ready_queue_processors entries, indexed by processor id
 static void dump_thread_list();
 
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into ThreadReadyQueues::queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -73,41 +87,125 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+Thread* ThreadReadyQueues::pull_next(u32 affinity_mask)
 {
-    auto affinity_mask = 1u << Processor::current().id();
-
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority_mask = g_ready_queues_mask;
+    VERIFY(lock.is_locked());
+    auto priority_mask = mask;
     while (priority_mask != 0) {
         auto priority = __builtin_ffsl(priority_mask);
         VERIFY(priority > 0);
-        auto& ready_queue = g_ready_queues[--priority];
+        auto& ready_queue = queues[--priority];
         for (auto& thread : ready_queue.thread_list) {
             VERIFY(thread.m_runnable_priority == (int)priority);
             if (thread.is_active())
                 continue;
             if (!(thread.affinity() & affinity_mask))
                 continue;
-            thread.m_runnable_priority = -1;
-            ready_queue.thread_list.remove(thread);
-            if (ready_queue.thread_list.is_empty())
-                g_ready_queues_mask &= ~(1u << priority);
-            // Mark it as active because we are using this thread. This is similar
-            // to comparing it with Processor::current_thread, but when there are
-            // multiple processors there's no easy way to check whether the thread
-            // is actually still needed. This prevents accidental finalization when
-            // a thread is no longer in Running state, but running on another core.
-
-            // We need to mark it active here so that this thread won't be
-            // scheduled on another core if it were to be queued before actually
-            // switching to it.
-            // FIXME: Figure out a better way maybe?
-            thread.set_active(true);
-            return thread;
+            remove(thread);
+            return &thread;
         }
         priority_mask &= ~(1u << priority);
     }
+    return nullptr;
+}
+
+void ThreadReadyQueues::remove(Thread& thread)
+{
+    VERIFY(lock.is_locked());
+    auto priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(mask & (1u << priority));
+    auto& ready_queue = queues[priority];
+    thread.m_runnable_priority = -1;
+    thread.m_runnable_cpu = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        mask &= ~(1u << priority);
+}
+
+void ThreadReadyQueues::append(Thread& thread, u32 priority, u32 cpu)
+{
+    VERIFY(lock.is_locked());
+    VERIFY(thread.m_runnable_priority < 0);
+    VERIFY(!thread.m_ready_queue_node.is_in_list());
+    thread.m_runnable_priority = (int)priority;
+    thread.m_runnable_cpu = (int)cpu;
+    auto& ready_queue = queues[priority];
+    bool was_empty = ready_queue.thread_list.is_empty();
+    ready_queue.thread_list.append(thread);
+    if (was_empty)
+        mask |= (1u << priority);
+}
+
+static u32 select_processor_for(const Thread& thread)
+{
+#if SCHEDULE_ON_ALL_PROCESSORS
+    auto affinity = thread.affinity();
+    auto processor_mask = Processor::count() >= g_max_ready_queue_processors ? 0xffffffffu : (1u << Processor::count()) - 1;
+    affinity &= processor_mask;
+    if (affinity == 0)
+        return Processor::id();
+
+    // Prefer the processor the thread last ran on, its caches are still warm.
+    auto last_cpu = thread.cpu();
+    if (affinity & (1u << last_cpu))
+        return last_cpu;
+
+    auto current_cpu = Processor::id();
+    if (affinity & (1u << current_cpu))
+        return current_cpu;
+    return __builtin_ffsl(affinity) - 1;
+#else
+    // Only the BSP schedules, so there is no point in spreading threads around.
+    (void)thread;
+    return 0;
+#endif
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto current_cpu = Processor::current().id();
+    auto affinity_mask = 1u << current_cpu;
+
+    auto mark_active = [](Thread& thread) -> Thread& {
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread.set_active(true);
+        return thread;
+    };
+
+    {
+        auto& ready_queues = g_ready_queues[current_cpu];
+        ScopedSpinLock lock(ready_queues.lock);
+        if (auto* thread = ready_queues.pull_next(affinity_mask))
+            return mark_active(*thread);
+    }
+
+    // Our own queues are empty, try to steal work from other processors.
+    // We start with our neighbor so that idle processors don't all pile
+    // onto the same victim.
+    auto processor_count = min(Processor::count(), g_max_ready_queue_processors);
+    for (u32 i = 1; i < processor_count; i++) {
+        auto victim_cpu = (current_cpu + i) % processor_count;
+        auto& victim_queues = g_ready_queues[victim_cpu];
+        // This is a racy peek, but we'll double-check under the lock below
+        if (victim_queues.is_empty())
+            continue;
+        ScopedSpinLock lock(victim_queues.lock);
+        if (auto* thread = victim_queues.pull_next(affinity_mask)) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole thread {} from processor {}", current_cpu, *thread, victim_cpu);
+            return mark_active(*thread);
+        }
+    }
+
     return *Processor::current().idle_thread();
 }
 
@@ -115,23 +213,25 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
 {
     if (&thread == Processor::current().idle_thread())
         return true;
-    ScopedSpinLock lock(g_ready_queues_lock);
-    auto priority = thread.m_runnable_priority;
-    if (priority < 0) {
-        VERIFY(!thread.m_ready_queue_node.is_in_list());
-        return false;
-    }
 
     if (check_affinity && !(thread.affinity() & (1 << Processor::current().id())))
         return false;
 
-    VERIFY(g_ready_queues_mask & (1u << priority));
-    auto& ready_queue = g_ready_queues[priority];
-    thread.m_runnable_priority = -1;
-    ready_queue.thread_list.remove(thread);
-    if (ready_queue.thread_list.is_empty())
-        g_ready_queues_mask &= ~(1u << priority);
-    return true;
+    for (;;) {
+        int cpu = thread.m_runnable_cpu;
+        if (cpu < 0) {
+            VERIFY(!thread.m_ready_queue_node.is_in_list());
+            return false;
+        }
+        auto& ready_queues = g_ready_queues[cpu];
+        ScopedSpinLock lock(ready_queues.lock);
+        // The thread may have been stolen by another processor before we
+        // managed to acquire the lock, in which case we have to try again.
+        if (thread.m_runnable_cpu != cpu)
+            continue;
+        ready_queues.remove(thread);
+        return true;
+    }
 }
 
 void Scheduler::queue_runnable_thread(Thread& thread)
@@ -139,17 +239,13 @@ void Scheduler::queue_runnable_thread(Thread& thread)
     VERIFY(g_scheduler_lock.own_lock());
     if (&thread == Processor::current().idle_thread())
         return;
-    auto priority = thread_priority_to_priority_index(thread.priority());
+    auto priority = thread_priority_to_priority_index(thread.effective_priority());
+    auto cpu = select_processor_for(thread);
+    VERIFY(cpu < g_max_ready_queue_processors);
 
-    ScopedSpinLock lock(g_ready_queues_lock);
-    VERIFY(thread.m_runnable_priority < 0);
-    thread.m_runnable_priority = (int)priority;
-    VERIFY(!thread.m_ready_queue_node.is_in_list());
-    auto& ready_queue = g_ready_queues[priority];
-    bool was_empty = ready_queue.thread_list.is_empty();
-    ready_queue.thread_list.append(thread);
-    if (was_empty)
-        g_ready_queues_mask |= (1u << priority);
+    auto& ready_queues = g_ready_queues[cpu];
+    ScopedSpinLock lock(ready_queues.lock);
+    ready_queues.append(thread, priority, cpu);
 }
 
 UNMAP_AFTER_INIT void Scheduler::start()
@@ -364,10 +460,16 @@ bool Scheduler::context_switch(Thread* thread)
     }
 
     auto& proc = Processor::current();
+    if (from_thread == proc.idle_thread())
+        TimeManagement::the().restart_tick();
+
     if (!thread->is_initialized()) {
         proc.init_context(*thread, false);
         thread->set_initialized(true);
     }
+    if (KTrace::is_tracing(KTRACE_CONTEXT_SWITCHES) && from_thread)
+        KTrace::context_switch(*from_thread, *thread);
+
     thread->set_state(Thread::Running);
 
     proc.switch_context(from_thread, thread);
@@ -456,7 +558,7 @@ UNMAP_AFTER_INIT void Scheduler::initialize()
 
     RefPtr<Thread> idle_thread;
     g_finalizer_wait_queue = new WaitQueue;
-    g_ready_queues = new ThreadReadyQueue[g_ready_queue_buckets];
+    g_ready_queues = new ThreadReadyQueues[g_max_ready_queue_processors];
 
     g_finalizer_has_work.store(false, AK::MemoryOrder::memory_order_release);
     s_colonel_process = Process::create_kernel_process(idle_thread, "colonel", idle_loop, nullptr, 1).leak_ref();
@@ -505,29 +607,9 @@ void Scheduler::timer_tick(const RegisterState& regs)
         return; // TODO: This prevents scheduling on other CPUs!
 #endif
 
-    PerformanceEventBuffer* perf_events = nullptr;
-
-    if (g_profiling_all_threads) {
-        VERIFY(g_global_perf_events);
-        // FIXME: We currently don't collect samples while idle.
-        //        That will be an interesting mode to add in the future. :^)
-        if (current_thread != Processor::current().idle_thread()) {
-            perf_events = g_global_perf_events;
-            if (current_thread->process().space().enforces_syscall_regions()) {
-                // FIXME: This is very nasty! We dump the current process's address
-                //        space layout *every time* it's sampled. We should figure out
-                //        a way to do this less often.
-                perf_events->add_process(current_thread->process());
-            }
-        }
-    } else if (current_thread->process().is_profiling()) {
-        VERIFY(current_thread->process().perf_events());
-        perf_events = current_thread->process().perf_events();
-    }
-
-    if (perf_events) {
-        [[maybe_unused]] auto rc = perf_events->append_with_eip_and_ebp(regs.eip, regs.ebp, PERF_EVENT_SAMPLE, 0, 0);
-    }
+    // When profiling with a hardware performance counter, its overflow interrupt takes the samples instead.
+    if (PerformanceCounters::active_counter() == PERF_COUNTER_TIMER)
+        PerformanceEventBuffer::take_sample(regs, PERF_COUNTER_TIMER, 0);
 
     if (current_thread->tick())
         return;
@@ -578,8 +660,12 @@ void Scheduler::idle_loop(void*)
     VERIFY(are_interrupts_enabled());
 
     for (;;) {
+        // Keep interrupts disabled until we halt, so that an interrupt that
+        // makes work available can't sneak in after we stopped the tick.
+        cli();
         proc.idle_begin();
-        asm("hlt");
+        TimeManagement::the().stop_tick();
+        proc.idle();
 
         proc.idle_end();
         VERIFY_INTERRUPTS_ENABLED();
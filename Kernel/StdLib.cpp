@@ -169,6 +169,33 @@ Optional<u32> user_atomic_fetch_xor_relaxed(volatile u32* var, u32 val)
     return Kernel::safe_atomic_fetch_xor_relaxed(var, val);
 }
 
+bool copy_to_user(void* dest_ptr, Span<const ReadonlyBytes> sources)
+{
+    Checked<size_t> n = 0;
+    for (auto& source : sources)
+        n += source.size();
+    if (n.has_overflow() || !Kernel::is_user_range(VirtualAddress(dest_ptr), n.value()))
+        return false;
+    // Gathering the pieces under a single SmapDisabler saves toggling it for every one of them.
+    Kernel::SmapDisabler disabler;
+    u8* dest = static_cast<u8*>(dest_ptr);
+    for (auto& source : sources) {
+        VERIFY(!Kernel::is_user_range(VirtualAddress(source.data()), source.size()));
+        void* fault_at;
+        if (!Kernel::safe_memcpy(dest, source.data(), source.size(), fault_at)) {
+            dbgln("copy_to_user({:p}, {} sources, {}) failed at {}", dest_ptr, sources.size(), n.value(), VirtualAddress { fault_at });
+            return false;
+        }
+        dest += source.size();
+    }
+    return true;
+}
+
+namespace Kernel {
+size_t g_rep_movsb_threshold = NumericLimits<size_t>::max();
+size_t g_rep_stosb_threshold = NumericLimits<size_t>::max();
+}
+
 extern "C" {
 
 bool copy_to_user(void* dest_ptr, const void* src_ptr, size_t n)
@@ -207,6 +234,12 @@ void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
 {
     size_t dest = (size_t)dest_ptr;
     size_t src = (size_t)src_ptr;
+    if (n >= Kernel::g_rep_movsb_threshold) {
+        asm volatile(
+            "rep movsb\n" ::"S"(src), "D"(dest), "c"(n)
+            : "memory");
+        return dest_ptr;
+    }
     // FIXME: Support starting at an unaligned address.
     if (!(dest & 0x3) && !(src & 0x3) && n >= 12) {
         size_t size_ts = n / sizeof(size_t);
@@ -259,6 +292,14 @@ const void* memmem(const void* haystack, size_t haystack_length, const void* nee
 void* memset(void* dest_ptr, int c, size_t n)
 {
     size_t dest = (size_t)dest_ptr;
+    if (n >= Kernel::g_rep_stosb_threshold) {
+        asm volatile(
+            "rep stosb\n"
+            : "=D"(dest), "=c"(n)
+            : "0"(dest), "1"(n), "a"(c)
+            : "memory");
+        return dest_ptr;
+    }
     // FIXME: Support starting at an unaligned address.
     if (!(dest & 0x3) && n >= 12) {
         size_t size_ts = n / sizeof(size_t);
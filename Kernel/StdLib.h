@@ -23,6 +23,9 @@ struct StringArgument;
 template<typename T>
 [[nodiscard]] Optional<Time> copy_time_from_user(Userspace<T*> src);
 
+// Copies the sources one after the other to a single user buffer.
+[[nodiscard]] bool copy_to_user(void* dest, Span<const ReadonlyBytes> sources);
+
 [[nodiscard]] Optional<u32> user_atomic_fetch_add_relaxed(volatile u32* var, u32 val);
 [[nodiscard]] Optional<u32> user_atomic_exchange_relaxed(volatile u32* var, u32 val);
 [[nodiscard]] Optional<u32> user_atomic_load_relaxed(volatile u32* var);
@@ -5,6 +5,7 @@
  */
 
 #include <AK/Atomic.h>
+#include <Kernel/DeferredWorkQueue.h>
 #include <Kernel/SpinLock.h>
 #include <Kernel/Storage/AHCIPort.h>
 #include <Kernel/Storage/ATA.h>
@@ -12,7 +13,6 @@
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/TypedMapping.h>
-#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -52,10 +52,12 @@ AHCIPort::AHCIPort(const AHCIPortHandler& handler, volatile AHCI::PortRegisters&
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Command list page at {}", representative_port_index(), m_command_list_page->paddr());
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: FIS receive page at {}", representative_port_index(), m_command_list_page->paddr());
 
-    for (size_t index = 0; index < 1; index++) {
-        m_dma_buffers.append(MM.allocate_supervisor_physical_page().release_nonnull());
-    }
-    for (size_t index = 0; index < 1; index++) {
+    size_t command_slot_count = min(handler.hba_capabilities().max_command_list_entries_count, max_command_slot_count);
+    for (size_t index = 0; index < command_slot_count; index++) {
+        CommandSlot slot;
+        for (size_t buffer_index = 0; buffer_index < max_dma_buffer_count; buffer_index++)
+            slot.dma_buffers.append(MM.allocate_supervisor_physical_page().release_nonnull());
+        m_command_slots.append(move(slot));
         m_command_table_pages.append(MM.allocate_supervisor_physical_page().release_nonnull());
     }
     m_command_list_region = MM.allocate_kernel_region(m_command_list_page->paddr(), PAGE_SIZE, "AHCI Port Command List", Region::Access::Read | Region::Access::Write, Region::Cacheable::No);
@@ -83,42 +85,40 @@ void AHCIPort::handle_interrupt()
     if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::INF)) {
         // We need to defer the reset, because we can receive interrupts when
         // resetting the device.
-        g_io_work->queue([this]() {
+        DeferredWorkQueue::queue(DeferredWorkQueue::Priority::Low, [this]() {
             reset();
         });
         return;
     }
     if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::IF) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::TFE) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBD) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBF)) {
-        g_io_work->queue([this]() {
+        DeferredWorkQueue::queue(DeferredWorkQueue::Priority::Low, [this]() {
             recover_from_fatal_error();
         });
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
+    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::SDB)) {
         m_wait_for_completion = false;
 
+        // A command is done once its bit is cleared in both PxCI and PxSACT. Queued commands
+        // may finish in any order, and one interrupt can report several of them at once.
+        u32 finished_slots;
+        {
+            ScopedSpinLock lock(m_hard_lock);
+            u32 running_slots = m_port_registers.ci | m_port_registers.sact;
+            finished_slots = m_issued_slots & ~running_slots;
+            m_issued_slots &= running_slots;
+        }
+
         // Now schedule reading/writing the buffer as soon as we leave the irq handler.
         // This is important so that we can safely access the buffers, which could
         // trigger page faults
-        if (!m_current_request) {
+        if (!finished_slots) {
             dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
         } else {
-            g_io_work->queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
+            DeferredWorkQueue::queue(DeferredWorkQueue::Priority::High, [this, finished_slots]() {
+                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Requests in slots {:#08x} handled", representative_port_index(), finished_slots);
                 LOCKER(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (!m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count())) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
+                complete_finished_slots(finished_slots);
             });
         }
     }
@@ -140,6 +140,8 @@ void AHCIPort::recover_from_fatal_error()
     stop_command_list_processing();
     stop_fis_receiving();
     m_interrupt_enable.clear();
+    lock.unlock();
+    fail_all_slots();
 }
 
 void AHCIPort::eject()
@@ -295,6 +297,8 @@ bool AHCIPort::initialize(ScopedSpinLock<SpinLock<u8>>& main_lock)
             m_port_registers.cmd = m_port_registers.cmd | (1 << 24);
         }
 
+        detect_command_queuing(*identify_block);
+
         dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
 
         // FIXME: We don't support ATAPI devices yet, so for now we don't "create" them
@@ -425,65 +429,135 @@ void AHCIPort::set_sleep_state() const
     m_port_registers.cmd = (m_port_registers.cmd & 0x0ffffff) | (0b1000 << 28);
 }
 
+void AHCIPort::detect_command_queuing(const ATAIdentifyBlock& identify_block)
+{
+    m_command_queuing_enabled = false;
+    m_command_queue_depth = 1;
+    if (is_atapi_attached() || !m_parent_handler->hba_capabilities().native_command_queuing_supported)
+        return;
+    // Word 76, bit 8: Native Command Queuing supported. Word 75 holds the maximum queue depth minus one.
+    if (!(identify_block.serial_ata_capabilities & (1 << 8)))
+        return;
+    size_t device_queue_depth = (identify_block.queue_depth & 0x1f) + 1;
+    m_command_queue_depth = min(device_queue_depth, m_command_slots.size());
+    m_command_queuing_enabled = m_command_queue_depth > 1;
+    if (!m_command_queuing_enabled)
+        m_command_queue_depth = 1;
+    dmesgln("AHCI Port {}: Native Command Queuing {}, queue depth {}", representative_port_index(), m_command_queuing_enabled ? "enabled" : "disabled", m_command_queue_depth);
+}
+
 size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
 {
     VERIFY(m_connected_device);
     size_t needed_dma_regions_count = page_round_up((block_count * m_connected_device->block_size())) / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
+    VERIFY(needed_dma_regions_count <= max_dma_buffer_count);
     return needed_dma_regions_count;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(CommandSlot& slot, AsyncBlockDeviceRequest& request)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(request.block_count() > 0);
 
     NonnullRefPtrVector<PhysicalPage> allocated_dma_regions;
     for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
+        allocated_dma_regions.append(slot.dma_buffers.at(index));
     }
 
-    m_current_scatter_list = ScatterList::create(request, allocated_dma_regions, m_connected_device->block_size());
+    slot.scatter_list = ScatterList::create(request, allocated_dma_regions, m_connected_device->block_size());
     if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (!request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
+        if (!request.read_from_buffer(request.buffer(), slot.scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count())) {
             return AsyncDeviceRequest::MemoryFault;
         }
     }
     return {};
 }
 
+Optional<u8> AHCIPort::try_to_allocate_command_slot()
+{
+    VERIFY(m_lock.is_locked());
+    for (u8 index = 0; index < m_command_queue_depth; index++) {
+        if (!(m_allocated_slots & (1u << index))) {
+            m_allocated_slots |= 1u << index;
+            return index;
+        }
+    }
+    return {};
+}
+
 void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
     LOCKER(m_lock);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
 
-    m_current_request = request;
+    // Device never starts more requests than our queue depth, so there's always a free slot.
+    auto slot_index = try_to_allocate_command_slot();
+    VERIFY(slot_index.has_value());
+    auto& slot = m_command_slots[slot_index.value()];
+    VERIFY(!slot.request);
+    VERIFY(!slot.scatter_list);
+    slot.request = request;
 
-    auto result = prepare_and_set_scatter_list(request);
+    auto result = prepare_and_set_scatter_list(slot, request);
     if (result.has_value()) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
-        m_lock.unlock();
-        complete_current_request(result.value());
+        complete_slot(slot_index.value(), result.value());
         return;
     }
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
+    auto success = access_device(slot_index.value(), request.request_type(), request.block_index(), request.block_count());
     if (!success) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
-        m_lock.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
+        complete_slot(slot_index.value(), AsyncDeviceRequest::Failure);
         return;
     }
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+void AHCIPort::complete_slot(u8 slot_index, AsyncDeviceRequest::RequestResult result)
+{
+    VERIFY(m_lock.is_locked());
+    auto& slot = m_command_slots[slot_index];
+    VERIFY(slot.request);
+    auto request = move(slot.request);
+    slot.scatter_list = nullptr;
+    m_allocated_slots &= ~(1u << slot_index);
+    // Completing the request may start the next one, which can end up in this very slot.
+    request->complete(result);
+}
+
+void AHCIPort::complete_finished_slots(u32 finished_slots)
+{
+    VERIFY(m_lock.is_locked());
+    for (u8 slot_index = 0; slot_index < m_command_slots.size(); slot_index++) {
+        if (!(finished_slots & (1u << slot_index)))
+            continue;
+        auto& slot = m_command_slots[slot_index];
+        if (!slot.request)
+            continue;
+        VERIFY(slot.scatter_list);
+        if (slot.request->request_type() == AsyncBlockDeviceRequest::Read) {
+            if (!slot.request->write_to_buffer(slot.request->buffer(), slot.scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * slot.request->block_count())) {
+                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+                complete_slot(slot_index, AsyncDeviceRequest::MemoryFault);
+                continue;
+            }
+        }
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
+        complete_slot(slot_index, AsyncDeviceRequest::Success);
+    }
+}
+
+void AHCIPort::fail_all_slots()
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    VERIFY(m_lock.is_locked());
+    {
+        ScopedSpinLock lock(m_hard_lock);
+        m_issued_slots = 0;
+    }
+    for (u8 slot_index = 0; slot_index < m_command_slots.size(); slot_index++) {
+        if (m_command_slots[slot_index].request)
+            complete_slot(slot_index, AsyncDeviceRequest::Failure);
+    }
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -502,25 +576,27 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(u8 slot_index, AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
 {
     VERIFY(m_connected_device);
     VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
+    auto& scatter_list = m_command_slots[slot_index].scatter_list;
+    VERIFY(scatter_list);
     ScopedSpinLock lock(m_hard_lock);
 
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
-    if (!spin_until_ready())
+    // Queued commands don't keep the device busy, so they can be issued back to back.
+    if (!m_command_queuing_enabled && !spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
+    Optional<u8> unused_command_header = slot_index;
+    VERIFY(!(m_port_registers.ci & (1u << slot_index)));
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
     command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()].paddr().get();
     command_list_entries[unused_command_header.value()].ctbau = 0;
     command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    command_list_entries[unused_command_header.value()].prdtl = scatter_list->scatters_count();
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
@@ -539,7 +615,7 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
 
     size_t scatter_entry_index = 0;
     size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
+    for (auto scatter_page : scatter_list->vmobject().physical_pages()) {
         VERIFY(data_transfer_count != 0);
         VERIFY(scatter_page);
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
@@ -563,6 +639,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_command_queuing_enabled) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -581,17 +662,27 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_command_queuing_enabled) {
+        // FPDMA QUEUED commands carry the sector count in the features field, and the tag in the count field.
+        fis.features_low = block_count;
+        fis.features_high = 0;
+        fis.count = slot_index << 3;
+    } else {
+        fis.count = (block_count);
 
-    // The below loop waits until the port is no longer busy before issuing a new command
-    if (!spin_until_ready())
-        return false;
+        // The below loop waits until the port is no longer busy before issuing a new command
+        if (!spin_until_ready())
+            return false;
+    }
 
     full_memory_barrier();
+    m_issued_slots |= 1u << slot_index;
+    if (m_command_queuing_enabled)
+        m_port_registers.sact = 1u << slot_index;
     mark_command_header_ready_to_process(unused_command_header.value());
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0].paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} in slot {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, slot_index);
     return true;
 }
 
@@ -692,8 +783,6 @@ void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) con
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
     m_port_registers.ci = 1 << command_header_index;
 }
@@ -17,6 +17,7 @@
 #include <Kernel/SpinLock.h>
 #include <Kernel/Storage/AHCI.h>
 #include <Kernel/Storage/AHCIPortHandler.h>
+#include <Kernel/Storage/ATA.h>
 #include <Kernel/Storage/StorageDevice.h>
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/PhysicalPage.h>
@@ -51,6 +52,10 @@ public:
 
     u32 port_index() const { return m_port_index; }
     u32 representative_port_index() const { return port_index() + 1; }
+    size_t max_transfer_size() const { return max_dma_buffer_count * PAGE_SIZE; }
+    // How many requests the port keeps in flight at once. This is only larger than 1
+    // if both the HBA and the device support Native Command Queuing.
+    size_t command_queue_depth() const { return m_command_queue_depth; }
     bool is_operable() const;
     bool is_hot_pluggable() const;
     bool is_atapi_attached() const { return m_port_registers.sig == (u32)AHCI::DeviceSignature::ATAPI; };
@@ -81,11 +86,21 @@ private:
     ALWAYS_INLINE void spin_up() const;
     ALWAYS_INLINE void power_on() const;
 
+    struct CommandSlot {
+        RefPtr<AsyncBlockDeviceRequest> request;
+        RefPtr<ScatterList> scatter_list;
+        NonnullRefPtrVector<PhysicalPage> dma_buffers;
+    };
+
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
+    void complete_slot(u8 slot_index, AsyncDeviceRequest::RequestResult);
+    void complete_finished_slots(u32 finished_slots);
+    void fail_all_slots();
+    Optional<u8> try_to_allocate_command_slot();
+    bool access_device(u8 slot_index, AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
     size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(CommandSlot&, AsyncBlockDeviceRequest& request);
+    void detect_command_queuing(const ATAIdentifyBlock&);
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -109,17 +124,30 @@ private:
 
     ALWAYS_INLINE bool is_interface_disabled() const { return (m_port_registers.ssts & 0xf) == 4; };
 
+    // NOTE: Each request is bounced through these pages, so this limits how
+    //       large a single transfer can be.
+    static constexpr size_t max_dma_buffer_count = 16;
+
+    // Every command slot has bounce buffers of its own, so we only set up a
+    // few of the 32 possible slots to keep the memory usage reasonable.
+    static constexpr size_t max_command_slot_count = 8;
+
     // Data members
 
     EntropySource m_entropy_source;
-    RefPtr<AsyncBlockDeviceRequest> m_current_request;
     SpinLock<u8> m_hard_lock;
     Lock m_lock { "AHCIPort" };
 
     mutable bool m_wait_for_completion { false };
     bool m_wait_connect_for_completion { false };
 
-    NonnullRefPtrVector<PhysicalPage> m_dma_buffers;
+    Vector<CommandSlot, max_command_slot_count> m_command_slots;
+    // Slots that hold a request, and the subset of them that the HBA is still working on.
+    u32 m_allocated_slots { 0 };
+    u32 m_issued_slots { 0 };
+    size_t m_command_queue_depth { 1 };
+    bool m_command_queuing_enabled { false };
+
     NonnullRefPtrVector<PhysicalPage> m_command_table_pages;
     RefPtr<PhysicalPage> m_command_list_page;
     OwnPtr<Region> m_command_list_region;
@@ -132,7 +160,6 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    RefPtr<AHCIPort::ScatterList> m_current_scatter_list;
     bool m_disabled_by_firmware { false };
 };
 }
@@ -27,6 +27,9 @@ AHCIPortHandler::AHCIPortHandler(AHCIController& controller, u8 irq, AHCI::Maske
 
     dbgln_if(AHCI_DEBUG, "AHCI Port Handler: IRQ {}", irq);
 
+    if (try_to_enable_message_signalled_interrupts(controller.pci_address()))
+        dbgln_if(AHCI_DEBUG, "AHCI Port Handler: Using MSI {} on CPU #{}", interrupt_number(), target_processor());
+
     // Clear pending interrupts, if there are any!
     m_pending_ports_interrupts.set_all();
     enable_irq();
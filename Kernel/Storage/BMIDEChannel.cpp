@@ -4,10 +4,10 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/DeferredWorkQueue.h>
 #include <Kernel/Storage/ATA.h>
 #include <Kernel/Storage/BMIDEChannel.h>
 #include <Kernel/Storage/IDEController.h>
-#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -112,7 +112,7 @@ void BMIDEChannel::complete_current_request(AsyncDeviceRequest::RequestResult re
     // This is important so that we can safely write the buffer back,
     // which could cause page faults. Note that this may be called immediately
     // before Processor::deferred_call_queue returns!
-    g_io_work->queue([this, result]() {
+    DeferredWorkQueue::queue(DeferredWorkQueue::Priority::High, [this, result]() {
         dbgln_if(PATA_DEBUG, "BMIDEChannel::complete_current_request result: {}", (int)result);
         ScopedSpinLock lock(m_request_lock);
         VERIFY(m_current_request);
@@ -7,6 +7,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Singleton.h>
 #include <AK/StringView.h>
+#include <Kernel/DeferredWorkQueue.h>
 #include <Kernel/IO.h>
 #include <Kernel/Process.h>
 #include <Kernel/Storage/ATA.h>
@@ -14,7 +15,6 @@
 #include <Kernel/Storage/IDEController.h>
 #include <Kernel/Storage/PATADiskDevice.h>
 #include <Kernel/VM/MemoryManager.h>
-#include <Kernel/WorkQueue.h>
 
 namespace Kernel {
 
@@ -115,7 +115,7 @@ void IDEChannel::complete_current_request(AsyncDeviceRequest::RequestResult resu
     // This is important so that we can safely write the buffer back,
     // which could cause page faults. Note that this may be called immediately
     // before Processor::deferred_call_queue returns!
-    g_io_work->queue([this, result]() {
+    DeferredWorkQueue::queue(DeferredWorkQueue::Priority::High, [this, result]() {
         dbgln_if(PATA_DEBUG, "IDEChannel::complete_current_request result: {}", (int)result);
         LOCKER(m_lock);
         VERIFY(m_current_request);
@@ -204,7 +204,7 @@ void IDEChannel::handle_irq(const RegisterState&)
     // Now schedule reading/writing the buffer as soon as we leave the irq handler.
     // This is important so that we can safely access the buffers, which could
     // trigger page faults
-    g_io_work->queue([this]() {
+    DeferredWorkQueue::queue(DeferredWorkQueue::Priority::High, [this]() {
         LOCKER(m_lock);
         ScopedSpinLock lock(m_request_lock);
         if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
@@ -33,6 +33,16 @@ const char* SATADiskDevice::class_name() const
     return "SATADiskDevice";
 }
 
+size_t SATADiskDevice::max_blocks_per_request() const
+{
+    return m_port->max_transfer_size() / block_size();
+}
+
+size_t SATADiskDevice::max_outstanding_requests() const
+{
+    return m_port->command_queue_depth();
+}
+
 void SATADiskDevice::start_request(AsyncBlockDeviceRequest& request)
 {
     m_port->start_request(request);
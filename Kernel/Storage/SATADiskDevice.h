@@ -28,10 +28,15 @@ public:
     virtual ~SATADiskDevice() override;
 
     // ^StorageDevice
+    virtual size_t max_blocks_per_request() const override;
+
     // ^BlockDevice
     virtual void start_request(AsyncBlockDeviceRequest&) override;
     virtual String device_name() const override;
 
+    // ^Device
+    virtual size_t max_outstanding_requests() const override;
+
 private:
     SATADiskDevice(const AHCIController&, const AHCIPort&, size_t sector_size, u64 max_addressable_block);
 
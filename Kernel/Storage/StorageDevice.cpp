@@ -10,6 +10,7 @@
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/Storage/StorageDevice.h>
 #include <Kernel/Storage/StorageManagement.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
@@ -37,18 +38,22 @@ NonnullRefPtr<StorageController> StorageDevice::controller() const
     return m_storage_controller;
 }
 
+size_t StorageDevice::max_blocks_per_request() const
+{
+    // PATAChannel will chuck a wobbly if we try to transfer more than PAGE_SIZE
+    // at a time, because it uses a single page for its DMA buffer.
+    return PAGE_SIZE / block_size();
+}
+
 KResultOr<size_t> StorageDevice::read(FileDescription&, u64 offset, UserOrKernelBuffer& outbuf, size_t len)
 {
     unsigned index = offset / block_size();
-    u16 whole_blocks = len / block_size();
+    size_t whole_blocks = len / block_size();
     ssize_t remaining = len % block_size();
 
-    unsigned blocks_per_page = PAGE_SIZE / block_size();
-
-    // PATAChannel will chuck a wobbly if we try to read more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= blocks_per_page) {
-        whole_blocks = blocks_per_page;
+    // Larger requests are cut short, and the caller has to come back for the rest.
+    if (whole_blocks >= max_blocks_per_request()) {
+        whole_blocks = max_blocks_per_request();
         remaining = 0;
     }
 
@@ -105,15 +110,12 @@ bool StorageDevice::can_read(const FileDescription&, size_t offset) const
 KResultOr<size_t> StorageDevice::write(FileDescription&, u64 offset, const UserOrKernelBuffer& inbuf, size_t len)
 {
     unsigned index = offset / block_size();
-    u16 whole_blocks = len / block_size();
+    size_t whole_blocks = len / block_size();
     ssize_t remaining = len % block_size();
 
-    unsigned blocks_per_page = PAGE_SIZE / block_size();
-
-    // PATAChannel will chuck a wobbly if we try to write more than PAGE_SIZE
-    // at a time, because it uses a single page for its DMA buffer.
-    if (whole_blocks >= blocks_per_page) {
-        whole_blocks = blocks_per_page;
+    // Larger requests are cut short, and the caller has to come back for the rest.
+    if (whole_blocks >= max_blocks_per_request()) {
+        whole_blocks = max_blocks_per_request();
         remaining = 0;
     }
 
@@ -192,4 +194,21 @@ bool StorageDevice::can_write(const FileDescription&, size_t offset) const
     return offset < (max_addressable_block() * block_size());
 }
 
+void StorageDevice::did_complete_request(const AsyncBlockDeviceRequest& request, AsyncDeviceRequest::RequestResult result)
+{
+    auto& statistics = request.request_type() == AsyncBlockDeviceRequest::Read ? m_read_statistics : m_write_statistics;
+    if (result != AsyncDeviceRequest::Success) {
+        statistics.errors++;
+        return;
+    }
+
+    auto latency = TimeManagement::the().monotonic_time(TimePrecision::Precise) - request.issue_time();
+    u64 latency_us = max<i64>(latency.to_microseconds(), 0);
+    size_t bucket = latency_us ? 64 - __builtin_clzll(latency_us) : 0;
+    statistics.requests++;
+    statistics.bytes += request.buffer_size();
+    statistics.total_latency_us += latency_us;
+    statistics.latency_buckets[min(bucket, RequestStatistics::latency_bucket_count - 1)]++;
+}
+
 }
@@ -19,15 +19,35 @@ class StorageDevice : public BlockDevice {
     AK_MAKE_ETERNAL
 
 public:
+    // Completed requests in one direction, and how long they took from being issued until the
+    // device completed them. Bucket 0 counts requests that took less than a microsecond, and
+    // bucket N those that took [2^(N-1), 2^N) microseconds; the last one also counts anything slower.
+    struct RequestStatistics {
+        static constexpr size_t latency_bucket_count = 24;
+
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> requests { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> bytes { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> errors { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> total_latency_us { 0 };
+        Atomic<u64, AK::MemoryOrder::memory_order_relaxed> latency_buckets[latency_bucket_count] {};
+    };
+
+    const RequestStatistics& read_statistics() const { return m_read_statistics; }
+    const RequestStatistics& write_statistics() const { return m_write_statistics; }
+
     virtual u64 max_addressable_block() const { return m_max_addressable_block; }
 
     NonnullRefPtr<StorageController> controller() const;
 
+    // The largest number of blocks the device can transfer in a single request.
+    virtual size_t max_blocks_per_request() const;
+
     // ^BlockDevice
     virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual bool can_read(const FileDescription&, size_t) const override;
     virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override;
     virtual bool can_write(const FileDescription&, size_t) const override;
+    virtual void did_complete_request(const AsyncBlockDeviceRequest&, AsyncDeviceRequest::RequestResult) override;
 
     // ^Device
     virtual mode_t required_mode() const override { return 0600; }
@@ -42,6 +62,8 @@ private:
     NonnullRefPtr<StorageController> m_storage_controller;
     NonnullRefPtrVector<DiskPartition> m_partitions;
     u64 m_max_addressable_block;
+    RequestStatistics m_read_statistics;
+    RequestStatistics m_write_statistics;
 };
 
 }
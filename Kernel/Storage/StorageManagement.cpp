@@ -17,6 +17,7 @@
 #include <Kernel/Storage/Partition/MBRPartitionTable.h>
 #include <Kernel/Storage/RamdiskController.h>
 #include <Kernel/Storage/StorageManagement.h>
+#include <Kernel/VirtIO/VirtIOBlockController.h>
 
 namespace Kernel {
 
@@ -58,6 +59,7 @@ UNMAP_AFTER_INIT NonnullRefPtrVector<StorageController> StorageManagement::enume
                 controllers.append(AHCIController::initialize(address));
             }
         });
+        controllers.append(VirtIOBlockController::initialize());
     }
     controllers.append(RamdiskController::initialize());
     return controllers;
@@ -28,6 +28,8 @@ public:
 
     NonnullRefPtr<FS> root_filesystem() const;
 
+    const NonnullRefPtrVector<StorageDevice>& storage_devices() const { return m_storage_devices; }
+
     static int major_number();
     static int minor_number();
 
@@ -6,6 +6,7 @@
 
 #include <Kernel/API/Syscall.h>
 #include <Kernel/Arch/x86/CPU.h>
+#include <Kernel/KTrace.h>
 #include <Kernel/Panic.h>
 #include <Kernel/Process.h>
 #include <Kernel/ThreadTracer.h>
@@ -127,6 +128,39 @@ KResultOr<FlatPtr> handle(RegisterState& regs, FlatPtr function, FlatPtr arg1, F
 #pragma GCC diagnostic pop
 }
 
+static bool is_allowed_in_io_ring(FlatPtr function)
+{
+    switch (function) {
+    case SC_read:
+    case SC_readv:
+    case SC_write:
+    case SC_writev:
+    case SC_open:
+    case SC_close:
+    case SC_lseek:
+    case SC_stat:
+    case SC_fstat:
+    case SC_ftruncate:
+    case SC_poll:
+    case SC_sendmsg:
+    case SC_recvmsg:
+    case SC_sendfile:
+    case SC_splice:
+    case SC_epoll_ctl:
+        return true;
+    default:
+        return false;
+    }
+}
+
+}
+
+// Runs a syscall on behalf of an io_ring submission. Only the ones that make sense there are allowed.
+KResultOr<FlatPtr> Process::handle_io_ring_submission(FlatPtr function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3)
+{
+    if (!Syscall::is_allowed_in_io_ring(function))
+        return ENOSYS;
+    return (this->*(Syscall::s_syscall_table[function]))(arg1, arg2, arg3);
 }
 
 void syscall_handler(TrapFrame* trap)
@@ -191,12 +225,18 @@ void syscall_handler(TrapFrame* trap)
     auto arg2 = regs.ecx;
     auto arg3 = regs.ebx;
 
+    if (KTrace::is_tracing(KTRACE_SYSCALLS))
+        KTrace::syscall_enter(*current_thread, function, arg1, arg2, arg3);
+
     auto result = Syscall::handle(regs, function, arg1, arg2, arg3);
     if (result.is_error())
         regs.eax = result.error();
     else
         regs.eax = result.value();
 
+    if (KTrace::is_tracing(KTRACE_SYSCALLS))
+        KTrace::syscall_exit(*current_thread, function, regs.eax);
+
     process.big_lock().unlock();
 
     if (auto tracer = process.tracer(); tracer && tracer->is_tracing_syscalls()) {
@@ -7,6 +7,7 @@
 #include <AK/Time.h>
 #include <Kernel/Process.h>
 #include <Kernel/Time/TimeManagement.h>
+#include <Kernel/VM/Region.h>
 
 namespace Kernel {
 
@@ -24,6 +25,22 @@ KResultOr<int> Process::sys$clock_gettime(clockid_t clock_id, Userspace<timespec
     return 0;
 }
 
+KResultOr<FlatPtr> Process::sys$map_time_page()
+{
+    REQUIRE_PROMISE(stdio);
+
+    auto& vmobject = TimeManagement::the().time_page_region().vmobject();
+    auto range = space().allocate_range({}, PAGE_SIZE);
+    if (!range.has_value())
+        return ENOMEM;
+
+    // This isn't an mmap region, so it can't be made writable with mprotect().
+    auto region_or_error = space().allocate_region_with_vmobject(range.value(), vmobject, 0, "Kernel time page", PROT_READ, true);
+    if (region_or_error.is_error())
+        return region_or_error.error().error();
+    return region_or_error.value()->vaddr().get();
+}
+
 KResultOr<int> Process::sys$clock_settime(clockid_t clock_id, Userspace<const timespec*> user_ts)
 {
     REQUIRE_PROMISE(settime);
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EPoll.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+KResultOr<int> Process::sys$epoll_create(int flags)
+{
+    REQUIRE_PROMISE(stdio);
+    // Reject flags other than EPOLL_CLOEXEC.
+    if ((flags & EPOLL_CLOEXEC) != flags)
+        return EINVAL;
+
+    int fd = alloc_fd();
+    if (fd < 0)
+        return fd;
+
+    auto description = FileDescription::create(*EPoll::create());
+    if (description.is_error())
+        return description.error();
+
+    u32 fd_flags = (flags & EPOLL_CLOEXEC) ? FD_CLOEXEC : 0;
+    m_fds[fd].set(description.release_value(), fd_flags);
+    m_fds[fd].description()->set_readable(true);
+    return fd;
+}
+
+static RefPtr<EPoll> epoll_from_description(FileDescription& description)
+{
+    if (!description.file().is_epoll())
+        return nullptr;
+    return static_cast<EPoll&>(description.file());
+}
+
+KResultOr<int> Process::sys$epoll_ctl(Userspace<const Syscall::SC_epoll_ctl_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_epoll_ctl_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    auto epoll_description = file_description(params.epfd);
+    if (!epoll_description)
+        return EBADF;
+    auto epoll = epoll_from_description(*epoll_description);
+    if (!epoll)
+        return EINVAL;
+
+    // The fd may have been closed since it was added, that shouldn't keep
+    // it from being removed.
+    if (params.op == EPOLL_CTL_DEL)
+        return epoll->remove(params.fd);
+
+    auto description = file_description(params.fd);
+    if (!description)
+        return EBADF;
+
+    epoll_event event;
+    if (!copy_from_user(&event, params.event))
+        return EFAULT;
+
+    switch (params.op) {
+    case EPOLL_CTL_ADD:
+        return epoll->add(params.fd, *description, event);
+    case EPOLL_CTL_MOD:
+        return epoll->modify(params.fd, *description, event);
+    default:
+        return EINVAL;
+    }
+}
+
+KResultOr<int> Process::sys$epoll_wait(Userspace<const Syscall::SC_epoll_wait_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_epoll_wait_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.maxevents <= 0)
+        return EINVAL;
+
+    auto epoll_description = file_description(params.epfd);
+    if (!epoll_description)
+        return EBADF;
+    auto epoll = epoll_from_description(*epoll_description);
+    if (!epoll)
+        return EINVAL;
+
+    Thread::BlockTimeout timeout;
+    bool should_block = true;
+    if (params.timeout) {
+        auto timeout_time = copy_time_from_user(params.timeout);
+        if (!timeout_time.has_value())
+            return EFAULT;
+        should_block = !timeout_time.value().is_zero();
+        timeout = Thread::BlockTimeout(false, &timeout_time.value());
+    }
+
+    Vector<epoll_event> events;
+    size_t max_events = min((size_t)params.maxevents, (size_t)m_max_open_file_descriptors);
+    for (;;) {
+        if (epoll->collect_events(*this, events, max_events) > 0 || !should_block)
+            break;
+
+        Thread::SelectBlocker::FDVector fds_info;
+        fds_info.append({ *epoll_description, Thread::FileBlocker::BlockFlags::Read });
+        auto block_result = Thread::current()->block<Thread::SelectBlocker>(timeout, fds_info);
+        if (block_result.was_interrupted())
+            return EINTR;
+        // Pick up anything that became ready right as we timed out, then give up.
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            should_block = false;
+    }
+
+    if (!events.is_empty() && !copy_to_user(params.events, events.data(), events.size() * sizeof(epoll_event)))
+        return EFAULT;
+    return (int)events.size();
+}
+
+}
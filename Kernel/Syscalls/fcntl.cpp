@@ -42,6 +42,18 @@ KResultOr<int> Process::sys$fcntl(int fd, int cmd, u32 arg)
         break;
     case F_ISTTY:
         return description->is_tty();
+    case F_GETPIPE_SZ:
+        if (!description->is_fifo())
+            return EBADF;
+        return description->fifo()->buffer_capacity();
+    case F_SETPIPE_SZ: {
+        if (!description->is_fifo())
+            return EBADF;
+        auto result = description->fifo()->set_buffer_capacity(arg);
+        if (result.is_error())
+            return result;
+        return description->fifo()->buffer_capacity();
+    }
     default:
         return EINVAL;
     }
@@ -9,6 +9,7 @@
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/Process.h>
 #include <Kernel/VM/Region.h>
+#include <Kernel/VM/TLBShootdownBatch.h>
 
 namespace Kernel {
 
@@ -63,6 +64,8 @@ KResultOr<pid_t> Process::sys$fork(RegisterState& regs)
     dbgln_if(FORK_DEBUG, "fork: child will begin executing at {:04x}:{:08x} with stack {:04x}:{:08x}, kstack {:04x}:{:08x}", child_tss.cs, child_tss.eip, child_tss.ss, child_tss.esp, child_tss.ss0, child_tss.esp0);
 
     {
+        // Marking all of our regions as copy-on-write only needs a single shootdown.
+        TLBShootdownBatch tlb_shootdown_batch(space().page_directory());
         ScopedSpinLock lock(space().get_lock());
         for (auto& region : space().regions()) {
             dbgln_if(FORK_DEBUG, "fork: cloning Region({}) '{}' @ {}", region, region->name(), region->vaddr());
@@ -73,8 +76,10 @@ KResultOr<pid_t> Process::sys$fork(RegisterState& regs)
                 return ENOMEM;
             }
 
+            // Don't populate the child's page tables up front. Most children only touch
+            // a handful of pages before calling exec() and throwing them all away.
             auto& child_region = child->space().add_region(region_clone.release_nonnull());
-            child_region.map(child->space().page_directory(), ShouldFlushTLB::No);
+            child_region.map_lazily(child->space().page_directory());
 
             if (region == m_master_tls_region.unsafe_ptr())
                 child->m_master_tls_region = child_region;
@@ -93,13 +93,15 @@ KResultOr<int> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> use
     switch (cmd) {
     case FUTEX_WAIT:
     case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_LOCK_PI: {
+        // NOTE: For the requeue operations, this is val2 instead.
         if (params.timeout) {
             auto timeout_time = copy_time_from_user(params.timeout);
             if (!timeout_time.has_value())
                 return EFAULT;
-            clockid_t clock_id = (params.futex_op & FUTEX_CLOCK_REALTIME) ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
+            // Like on Linux, FUTEX_LOCK_PI always measures its timeout against CLOCK_REALTIME.
+            bool is_realtime = cmd == FUTEX_LOCK_PI || (params.futex_op & FUTEX_CLOCK_REALTIME);
+            clockid_t clock_id = is_realtime ? CLOCK_REALTIME_COARSE : CLOCK_MONOTONIC_COARSE;
             bool is_absolute = cmd != FUTEX_WAIT;
             timeout = Thread::BlockTimeout(is_absolute, &timeout_time.value(), nullptr, clock_id);
         }
@@ -136,7 +138,7 @@ KResultOr<int> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> use
             if (!region2)
                 return EFAULT;
             vmobject2 = region2->vmobject();
-            user_address_or_offset2 = region->offset_in_vmobject_from_vaddr(VirtualAddress(user_address_or_offset2));
+            user_address_or_offset2 = region2->offset_in_vmobject_from_vaddr(VirtualAddress(user_address_or_offset2));
             break;
         }
         }
@@ -175,10 +177,14 @@ KResultOr<int> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> use
         return {};
     };
 
-    auto remove_futex_queue = [&](VMObject* vmobject, FlatPtr user_address_or_offset) {
+    auto remove_futex_queue = [&](VMObject* vmobject, FlatPtr user_address_or_offset, FutexQueue& futex_queue) {
         auto* queues = is_private ? &m_futex_queues : find_global_futex_queues(*vmobject, false);
         if (queues) {
-            queues->remove(user_address_or_offset);
+            // Someone else might have already replaced it with a new queue while we were blocked.
+            auto it = queues->find(user_address_or_offset);
+            if (it == queues->end() || it->value.ptr() != &futex_queue)
+                return;
+            queues->remove(it);
             if (!is_private && queues->is_empty())
                 g_global_futex_queues->remove(vmobject);
         }
@@ -194,7 +200,7 @@ KResultOr<int> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> use
         u32 woke_count = futex_queue->wake_n(count, bitmask, is_empty);
         if (is_empty) {
             // If there are no more waiters, we want to get rid of the futex!
-            remove_futex_queue(vmobject, user_address_or_offset);
+            remove_futex_queue(vmobject, user_address_or_offset, *futex_queue);
         }
         return (int)woke_count;
     };
@@ -216,14 +222,15 @@ KResultOr<int> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> use
 
         // We need to release the lock before blocking. But we have a reference
         // to the FutexQueue so that we can keep it alive.
+        futex_queue->queue_imminent_wait();
         lock.unlock();
 
         Thread::BlockResult block_result = futex_queue->wait_on(timeout, bitset);
 
         lock.lock();
-        if (futex_queue->is_empty()) {
+        if (futex_queue->is_empty_and_no_imminent_waits()) {
             // If there are no more waiters, we want to get rid of the futex!
-            remove_futex_queue(vmobject, user_address_or_offset);
+            remove_futex_queue(vmobject, user_address_or_offset, *futex_queue);
         }
         if (block_result == Thread::BlockResult::InterruptedByTimeout) {
             return ETIMEDOUT;
@@ -253,17 +260,132 @@ KResultOr<int> Process::sys$futex(Userspace<const Syscall::SC_futex_params*> use
                 },
                 params.val2, is_empty, is_target_empty);
             if (is_empty)
-                remove_futex_queue(vmobject, user_address_or_offset);
+                remove_futex_queue(vmobject, user_address_or_offset, *futex_queue);
             if (is_target_empty && target_futex_queue)
-                remove_futex_queue(vmobject2, user_address_or_offset2);
+                remove_futex_queue(vmobject2, user_address_or_offset2, *target_futex_queue);
         }
         return woken_or_requeued;
     };
 
+    // Priority inheritance futexes hold the TID of their owner. Threads waiting for one lend their
+    // priority to the owner, and unlocking hands the futex straight to the highest priority waiter.
+    auto do_lock_pi = [&](bool try_only) -> int {
+        auto& current_thread = *Thread::current();
+        u32 tid = current_thread.tid().value();
+        for (;;) {
+            auto user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            u32 value = user_value.value();
+            u32 owner_tid = value & FUTEX_TID_MASK;
+            if (owner_tid == tid)
+                return try_only ? EAGAIN : EDEADLK;
+
+            auto owner = owner_tid != 0 ? Thread::from_tid(owner_tid) : nullptr;
+            if (!owner) {
+                // Keep the waiters bit, since there might still be others queued up behind us.
+                u32 new_value = tid | (value & FUTEX_WAITERS) | (owner_tid != 0 ? FUTEX_OWNER_DIED : 0);
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, new_value);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (did_exchange.value()) {
+                    atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                    return 0;
+                }
+                continue;
+            }
+            if (try_only)
+                return EAGAIN;
+
+            if (!(value & FUTEX_WAITERS)) {
+                // Make sure the owner comes to us when unlocking, instead of just clearing the value.
+                auto did_exchange = user_atomic_compare_exchange_relaxed(params.userspace_address, value, value | FUTEX_WAITERS);
+                if (!did_exchange.has_value())
+                    return EFAULT;
+                if (!did_exchange.value())
+                    continue;
+            }
+
+            if (owner->effective_priority() < current_thread.effective_priority())
+                owner->set_inherited_priority(current_thread.effective_priority());
+
+            auto futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, true);
+            VERIFY(futex_queue);
+            futex_queue->queue_imminent_wait();
+            lock.unlock();
+            owner = nullptr;
+
+            Thread::BlockResult block_result = futex_queue->wait_on(timeout, FUTEX_BITSET_MATCH_ANY);
+
+            lock.lock();
+            if (futex_queue->is_empty_and_no_imminent_waits())
+                remove_futex_queue(vmobject, user_address_or_offset, *futex_queue);
+
+            // Even if we timed out, the futex might have been handed over to us already.
+            user_value = user_atomic_load_relaxed(params.userspace_address);
+            if (!user_value.has_value())
+                return EFAULT;
+            if ((user_value.value() & FUTEX_TID_MASK) == tid) {
+                atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+                return 0;
+            }
+            if (block_result == Thread::BlockResult::InterruptedByTimeout)
+                return ETIMEDOUT;
+            if (block_result.was_interrupted())
+                return EINTR;
+        }
+    };
+
+    auto do_unlock_pi = [&]() -> int {
+        auto& current_thread = *Thread::current();
+        u32 tid = current_thread.tid().value();
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value())
+            return EFAULT;
+        if ((user_value.value() & FUTEX_TID_MASK) != tid)
+            return EPERM;
+
+        // FIXME: This is only right as long as we don't hold any other contended PI futexes.
+        current_thread.set_inherited_priority(0);
+
+        atomic_thread_fence(AK::MemoryOrder::memory_order_release);
+        u32 new_value = 0;
+        if (auto futex_queue = find_futex_queue(vmobject.ptr(), user_address_or_offset, false)) {
+            u32 highest_remaining_priority;
+            bool is_empty;
+            auto new_owner = futex_queue->wake_highest_priority(highest_remaining_priority, is_empty);
+            if (new_owner) {
+                // The new owner can't look at the value before we drop the futex lock.
+                new_value = new_owner->tid().value() | (is_empty ? 0 : FUTEX_WAITERS);
+                if (new_owner->effective_priority() < highest_remaining_priority)
+                    new_owner->set_inherited_priority(highest_remaining_priority);
+            } else if (!is_empty) {
+                // Nobody is blocked yet, but someone is just about to. Let them retry taking it.
+                bool is_still_empty;
+                futex_queue->wake_n(1, {}, is_still_empty);
+                new_value = FUTEX_WAITERS;
+            }
+            if (is_empty)
+                remove_futex_queue(vmobject, user_address_or_offset, *futex_queue);
+        }
+        if (!user_atomic_store_relaxed(params.userspace_address, new_value))
+            return EFAULT;
+        return 0;
+    };
+
     switch (cmd) {
     case FUTEX_WAIT:
         return do_wait(0);
 
+    case FUTEX_LOCK_PI:
+        return do_lock_pi(false);
+
+    case FUTEX_TRYLOCK_PI:
+        return do_lock_pi(true);
+
+    case FUTEX_UNLOCK_PI:
+        return do_unlock_pi();
+
     case FUTEX_WAKE:
         return do_wake(vmobject.ptr(), user_address_or_offset, params.val, {});
 
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/API/IORing.h>
+#include <Kernel/API/Syscall.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+KResultOr<int> Process::sys$io_ring_enter(Userspace<IORing*> user_ring)
+{
+    REQUIRE_PROMISE(stdio);
+    IORing ring;
+    if (!copy_from_user(&ring, user_ring))
+        return EFAULT;
+
+    if (ring.entry_count == 0 || ring.entry_count > IORing::max_entry_count || (ring.entry_count & (ring.entry_count - 1)) != 0)
+        return EINVAL;
+    if (ring.submission_tail - ring.submission_head > ring.entry_count)
+        return EINVAL;
+    if (ring.completion_tail - ring.completion_head > ring.entry_count)
+        return EINVAL;
+
+    Checked<FlatPtr> ring_end = user_ring.ptr();
+    ring_end += io_ring_size(ring.entry_count);
+    if (ring_end.has_overflow())
+        return EFAULT;
+
+    auto mask = ring.entry_count - 1;
+    FlatPtr submissions = user_ring.ptr() + sizeof(IORing);
+    FlatPtr completions = submissions + ring.entry_count * sizeof(IORingSubmission);
+    Userspace<u32*> user_submission_head((FlatPtr)&user_ring.unsafe_userspace_ptr()->submission_head);
+    Userspace<u32*> user_completion_tail((FlatPtr)&user_ring.unsafe_userspace_ptr()->completion_tail);
+
+    auto current_thread = Thread::current();
+    bool cancel_linked = false;
+    int nsubmitted = 0;
+
+    while (ring.submission_head != ring.submission_tail) {
+        // Userspace may have consumed completions in the meantime, so look again before giving up.
+        if (ring.completion_tail - ring.completion_head == ring.entry_count) {
+            Userspace<const u32*> user_completion_head((FlatPtr)&user_ring.unsafe_userspace_ptr()->completion_head);
+            if (!copy_from_user(&ring.completion_head, user_completion_head))
+                return EFAULT;
+            if (ring.completion_tail - ring.completion_head >= ring.entry_count)
+                break;
+        }
+
+        IORingSubmission submission;
+        Userspace<const IORingSubmission*> user_submission(submissions + (ring.submission_head & mask) * sizeof(IORingSubmission));
+        if (!copy_from_user(&submission, user_submission))
+            return EFAULT;
+
+        IORingCompletion completion { submission.user_data, 0 };
+        if (cancel_linked) {
+            completion.result = -ECANCELED;
+        } else {
+            auto result = handle_io_ring_submission(submission.function, submission.arguments[0], submission.arguments[1], submission.arguments[2]);
+            if (result.is_error())
+                completion.result = result.error();
+            else
+                completion.result = (FlatPtr)result.value();
+        }
+        if (submission.flags & IO_RING_SUBMISSION_LINK)
+            cancel_linked = completion.result < 0;
+        else
+            cancel_linked = false;
+
+        Userspace<IORingCompletion*> user_completion(completions + (ring.completion_tail & mask) * sizeof(IORingCompletion));
+        if (!copy_to_user(user_completion, &completion))
+            return EFAULT;
+
+        // Publish every completion right away, other threads may be reaping them while we go on.
+        ++ring.completion_tail;
+        ++ring.submission_head;
+        if (!copy_to_user(user_completion_tail, &ring.completion_tail))
+            return EFAULT;
+        if (!copy_to_user(user_submission_head, &ring.submission_head))
+            return EFAULT;
+        ++nsubmitted;
+
+        // Let pending signals get delivered rather than running the whole batch first.
+        if (current_thread->has_unmasked_pending_signals())
+            break;
+    }
+
+    if (nsubmitted == 0 && ring.submission_head != ring.submission_tail)
+        return EBUSY;
+    return nsubmitted;
+}
+
+}
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/KTrace.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+// Tracing sees what every process is doing in the kernel, so it's only for the super-user,
+// even when it's limited to one process.
+KResultOr<int> Process::sys$ktrace_enable(pid_t pid, u32 categories)
+{
+    REQUIRE_NO_PROMISES;
+    if (!is_superuser())
+        return EPERM;
+
+    if (pid != -1) {
+        ScopedSpinLock lock(g_processes_lock);
+        auto process = Process::from_pid(pid);
+        if (!process || process->is_dead())
+            return ESRCH;
+    }
+
+    return KTrace::enable(pid, categories);
+}
+
+KResultOr<int> Process::sys$ktrace_disable()
+{
+    REQUIRE_NO_PROMISES;
+    if (!is_superuser())
+        return EPERM;
+    KTrace::disable();
+    return 0;
+}
+
+}
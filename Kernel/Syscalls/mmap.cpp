@@ -14,6 +14,7 @@
 #include <Kernel/VM/PrivateInodeVMObject.h>
 #include <Kernel/VM/Region.h>
 #include <Kernel/VM/SharedInodeVMObject.h>
+#include <Kernel/VM/TLBShootdownBatch.h>
 #include <LibC/limits.h>
 #include <LibELF/Validation.h>
 
@@ -292,6 +293,8 @@ KResultOr<int> Process::sys$mprotect(Userspace<void*> addr, size_t size, int pro
     if (!is_user_range(range_to_mprotect))
         return EFAULT;
 
+    TLBShootdownBatch tlb_shootdown_batch(space().page_directory());
+
     if (auto* whole_region = space().find_region_from_range(range_to_mprotect)) {
         if (!whole_region->is_mmap())
             return EPERM;
@@ -401,6 +404,13 @@ KResultOr<int> Process::sys$madvise(Userspace<void*> address, size_t size, int a
             return EPERM;
         return region->is_volatile(VirtualAddress(address), size) ? 0 : 1;
     }
+    if (advice & MADV_HUGEPAGE) {
+        if (!region->vmobject().is_anonymous())
+            return EPERM;
+        region->set_wants_large_pages(true);
+        region->populate_large_pages();
+        return 0;
+    }
     return EINVAL;
 }
 
@@ -450,6 +460,8 @@ KResultOr<int> Process::sys$munmap(Userspace<void*> addr, size_t size)
     if (!is_user_range(range_to_unmap))
         return EFAULT;
 
+    TLBShootdownBatch tlb_shootdown_batch(space().page_directory());
+
     if (auto* whole_region = space().find_region_from_range(range_to_unmap)) {
         if (!whole_region->is_mmap())
             return EPERM;
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <Kernel/Arch/x86/PerformanceCounters.h>
 #include <Kernel/CoreDump.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/FileSystem/VirtualFileSystem.h>
@@ -15,19 +16,40 @@ namespace Kernel {
 PerformanceEventBuffer* g_global_perf_events;
 bool g_profiling_all_threads;
 
-KResultOr<int> Process::sys$profiling_enable(pid_t pid)
+// NOTE: There's only one source of samples for the whole system, the last call to profiling_enable() picks it.
+static void start_sampling(int counter, u32 sample_period)
+{
+    if (counter == PERF_COUNTER_TIMER)
+        PerformanceCounters::stop();
+    else
+        PerformanceCounters::start(counter, sample_period);
+}
+
+KResultOr<int> Process::sys$profiling_enable(pid_t pid, int counter, u32 sample_period)
 {
     REQUIRE_NO_PROMISES;
 
+    if (counter != PERF_COUNTER_TIMER) {
+        if (!PerformanceCounters::is_available(counter))
+            return ENOTSUP;
+        if (sample_period == 0)
+            sample_period = PerformanceCounters::default_sample_period(counter);
+        if (sample_period > NumericLimits<i32>::max())
+            return EINVAL;
+    }
+
     if (pid == -1) {
         if (!is_superuser())
             return EPERM;
-        ScopedCritical critical;
-        if (g_global_perf_events)
-            g_global_perf_events->clear();
-        else
-            g_global_perf_events = PerformanceEventBuffer::try_create_with_size(32 * MiB).leak_ptr();
-        g_profiling_all_threads = true;
+        {
+            ScopedCritical critical;
+            if (g_global_perf_events)
+                g_global_perf_events->clear();
+            else
+                g_global_perf_events = PerformanceEventBuffer::try_create_with_size(32 * MiB, PerformanceEventBuffer::WhenFull::OverwriteOldestEvents).leak_ptr();
+            g_profiling_all_threads = true;
+        }
+        start_sampling(counter, sample_period);
         return 0;
     }
 
@@ -42,6 +64,8 @@ KResultOr<int> Process::sys$profiling_enable(pid_t pid)
     if (!process->create_perf_events_buffer_if_needed())
         return ENOMEM;
     process->set_profiling(true);
+    lock.unlock();
+    start_sampling(counter, sample_period);
     return 0;
 }
 
@@ -52,8 +76,11 @@ KResultOr<int> Process::sys$profiling_disable(pid_t pid)
     if (pid == -1) {
         if (!is_superuser())
             return EPERM;
-        ScopedCritical critical;
-        g_profiling_all_threads = false;
+        {
+            ScopedCritical critical;
+            g_profiling_all_threads = false;
+        }
+        PerformanceCounters::stop();
         return 0;
     }
 
@@ -66,6 +93,8 @@ KResultOr<int> Process::sys$profiling_disable(pid_t pid)
     if (!process->is_profiling())
         return EINVAL;
     process->set_profiling(false);
+    lock.unlock();
+    PerformanceCounters::stop();
     return 0;
 }
 
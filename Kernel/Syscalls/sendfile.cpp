@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+// How much we move at a time when the data has to be staged in a kernel buffer.
+static constexpr size_t transfer_chunk_size = 64 * KiB;
+
+static KResult wait_until_readable(FileDescription& description, bool may_block)
+{
+    if (description.can_read())
+        return KSuccess;
+    if (!may_block)
+        return EAGAIN;
+    auto unblock_flags = BlockFlags::None;
+    if (Thread::current()->block<Thread::ReadBlocker>({}, description, unblock_flags).was_interrupted())
+        return EINTR;
+    if (!has_flag(unblock_flags, BlockFlags::Read))
+        return EAGAIN;
+    return KSuccess;
+}
+
+static KResultOr<size_t> read_at(FileDescription& description, Optional<u64> offset, UserOrKernelBuffer& buffer, size_t size)
+{
+    if (offset.has_value())
+        return description.file().read(description, offset.value(), buffer, size);
+    return description.read(buffer, size);
+}
+
+// Once data has been taken out of the source there's no putting it back, so this
+// writes all of it, even if that means blocking on a non-blocking description.
+static KResultOr<size_t> write_fully_at(FileDescription& description, Optional<u64> offset, const UserOrKernelBuffer& buffer, size_t size)
+{
+    size_t total_nwritten = 0;
+    while (total_nwritten < size) {
+        if (!description.can_write()) {
+            auto unblock_flags = BlockFlags::None;
+            if (Thread::current()->block<Thread::WriteBlocker>({}, description, unblock_flags).was_interrupted()) {
+                if (total_nwritten == 0)
+                    return EINTR;
+                break;
+            }
+        }
+        auto data = buffer.offset(total_nwritten);
+        auto nwritten_or_error = offset.has_value()
+            ? description.file().write(description, offset.value() + total_nwritten, data, size - total_nwritten)
+            : description.write(data, size - total_nwritten);
+        if (nwritten_or_error.is_error()) {
+            if (total_nwritten)
+                break;
+            return nwritten_or_error.error();
+        }
+        if (nwritten_or_error.value() == 0)
+            break;
+        total_nwritten += nwritten_or_error.value();
+    }
+    return total_nwritten;
+}
+
+// Moves up to `count` bytes from `in` to `out` through a kernel buffer, so at least
+// the data never has to make a round trip through userspace.
+static KResultOr<size_t> transfer_through_kernel_buffer(FileDescription& out, Optional<u64> out_offset, FileDescription& in, Optional<u64> in_offset, size_t count, bool may_block)
+{
+    auto chunk = ByteBuffer::create_uninitialized(min(count, transfer_chunk_size));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(chunk.data());
+
+    size_t total_transferred = 0;
+    while (total_transferred < count) {
+        // Only wait for the source before the first chunk, after that we return what we've got.
+        auto readable_result = wait_until_readable(in, may_block && total_transferred == 0);
+        if (readable_result.is_error()) {
+            if (total_transferred)
+                break;
+            return readable_result;
+        }
+        if (!out.can_write() && (!may_block || total_transferred)) {
+            if (total_transferred)
+                break;
+            return EAGAIN;
+        }
+
+        size_t chunk_size = min(count - total_transferred, chunk.size());
+        auto nread_or_error = read_at(in, in_offset.has_value() ? in_offset.value() + total_transferred : Optional<u64> {}, buffer, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_transferred)
+                break;
+            return nread_or_error.error();
+        }
+        size_t nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = write_fully_at(out, out_offset.has_value() ? out_offset.value() + total_transferred : Optional<u64> {}, buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            if (total_transferred)
+                break;
+            return nwritten_or_error.error();
+        }
+        total_transferred += nwritten_or_error.value();
+        if (nwritten_or_error.value() < nread)
+            break;
+    }
+    return total_transferred;
+}
+
+static KResultOr<Optional<u64>> copy_offset_from_user(i64* user_offset)
+{
+    if (!user_offset)
+        return Optional<u64> {};
+    off_t offset;
+    if (!copy_from_user(&offset, Userspace<const off_t*>((FlatPtr)user_offset)))
+        return EFAULT;
+    if (offset < 0)
+        return EINVAL;
+    return Optional<u64> { (u64)offset };
+}
+
+KResultOr<ssize_t> Process::sys$sendfile(Userspace<const Syscall::SC_sendfile_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_sendfile_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.count > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto out_description = file_description(params.out_fd);
+    if (!out_description || !out_description->is_writable())
+        return EBADF;
+    auto in_description = file_description(params.in_fd);
+    if (!in_description || !in_description->is_readable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+    if (!in_description->file().is_seekable())
+        return EINVAL;
+
+    auto offset_or_error = copy_offset_from_user(params.offset);
+    if (offset_or_error.is_error())
+        return offset_or_error.error();
+    bool uses_own_offset = offset_or_error.value().has_value();
+    u64 offset = uses_own_offset ? offset_or_error.value().value() : in_description->offset();
+
+    if (params.count == 0)
+        return 0;
+
+    KResultOr<size_t> nsent_or_error = ENOTSUP;
+
+    if (out_description->is_socket()) {
+        // The socket reads the file's contents straight into its outgoing segments.
+        auto& socket = *out_description->socket();
+        size_t total_sent = 0;
+        while (total_sent < params.count) {
+            auto result = socket.sendfile(*out_description, *in_description, offset + total_sent, params.count - total_sent);
+            if (result.is_error()) {
+                if (!total_sent)
+                    nsent_or_error = result.error();
+                break;
+            }
+            if (result.value() == 0)
+                break;
+            total_sent += result.value();
+        }
+        if (total_sent)
+            nsent_or_error = total_sent;
+    }
+
+    if (nsent_or_error.is_error() && nsent_or_error.error() == ENOTSUP) {
+        bool should_append = out_description->should_append() && out_description->file().is_seekable();
+        if (should_append) {
+            auto seek_result = out_description->seek(0, SEEK_END);
+            if (seek_result.is_error())
+                return seek_result.error();
+        }
+        nsent_or_error = transfer_through_kernel_buffer(*out_description, {}, *in_description, offset, params.count, out_description->is_blocking());
+    }
+
+    if (nsent_or_error.is_error())
+        return nsent_or_error.error();
+
+    size_t nsent = nsent_or_error.value();
+    if (uses_own_offset) {
+        off_t new_offset = offset + nsent;
+        if (!copy_to_user(Userspace<off_t*>((FlatPtr)params.offset), &new_offset))
+            return EFAULT;
+    } else {
+        auto seek_result = in_description->seek(offset + nsent, SEEK_SET);
+        if (seek_result.is_error())
+            return seek_result.error();
+    }
+    return nsent;
+}
+
+KResultOr<ssize_t> Process::sys$splice(Userspace<const Syscall::SC_splice_params*> user_params)
+{
+    REQUIRE_PROMISE(stdio);
+    Syscall::SC_splice_params params;
+    if (!copy_from_user(&params, user_params))
+        return EFAULT;
+
+    if (params.flags & ~(SPLICE_F_MOVE | SPLICE_F_NONBLOCK | SPLICE_F_MORE))
+        return EINVAL;
+    if (params.length > NumericLimits<ssize_t>::max())
+        return EINVAL;
+
+    auto in_description = file_description(params.fd_in);
+    if (!in_description || !in_description->is_readable())
+        return EBADF;
+    auto out_description = file_description(params.fd_out);
+    if (!out_description || !out_description->is_writable())
+        return EBADF;
+    if (in_description->is_directory())
+        return EISDIR;
+
+    // Like elsewhere, at least one end has to be a pipe.
+    if (!in_description->is_fifo() && !out_description->is_fifo())
+        return EINVAL;
+    if ((params.off_in && !in_description->file().is_seekable()) || (params.off_out && !out_description->file().is_seekable()))
+        return ESPIPE;
+    if (out_description->should_append() && params.off_out)
+        return EINVAL;
+
+    auto in_offset_or_error = copy_offset_from_user(params.off_in);
+    if (in_offset_or_error.is_error())
+        return in_offset_or_error.error();
+    auto out_offset_or_error = copy_offset_from_user(params.off_out);
+    if (out_offset_or_error.is_error())
+        return out_offset_or_error.error();
+    auto in_offset = in_offset_or_error.value();
+    auto out_offset = out_offset_or_error.value();
+
+    if (params.length == 0)
+        return 0;
+
+    if (!out_offset.has_value() && out_description->should_append() && out_description->file().is_seekable()) {
+        auto seek_result = out_description->seek(0, SEEK_END);
+        if (seek_result.is_error())
+            return seek_result.error();
+    }
+
+    bool may_block = !(params.flags & SPLICE_F_NONBLOCK) && in_description->is_blocking() && out_description->is_blocking();
+    auto ntransferred_or_error = transfer_through_kernel_buffer(*out_description, out_offset, *in_description, in_offset, params.length, may_block);
+    if (ntransferred_or_error.is_error())
+        return ntransferred_or_error.error();
+
+    size_t ntransferred = ntransferred_or_error.value();
+    if (in_offset.has_value()) {
+        off_t new_offset = in_offset.value() + ntransferred;
+        if (!copy_to_user(Userspace<off_t*>((FlatPtr)params.off_in), &new_offset))
+            return EFAULT;
+    }
+    if (out_offset.has_value()) {
+        off_t new_offset = out_offset.value() + ntransferred;
+        if (!copy_to_user(Userspace<off_t*>((FlatPtr)params.off_out), &new_offset))
+            return EFAULT;
+    }
+    return ntransferred;
+}
+
+}
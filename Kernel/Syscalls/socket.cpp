@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <Kernel/FileSystem/FileDescription.h>
 #include <Kernel/Net/IPv4Socket.h>
 #include <Kernel/Net/LocalSocket.h>
@@ -163,6 +164,29 @@ KResultOr<int> Process::sys$shutdown(int sockfd, int how)
     return socket.shutdown(how);
 }
 
+static KResultOr<size_t> total_iovec_length(const Vector<iovec, 8>& iovs)
+{
+    u64 total_length = 0;
+    for (auto& iov : iovs) {
+        total_length += iov.iov_len;
+        if (total_length > NumericLimits<i32>::max())
+            return EINVAL;
+    }
+    return (size_t)total_length;
+}
+
+static KResultOr<Vector<iovec, 8>> copy_iovecs_from_user(const msghdr& msg)
+{
+    // Arbitrary pain threshold, same as writev().
+    if (msg.msg_iovlen < 1 || msg.msg_iovlen > (int)MiB)
+        return EINVAL;
+    Vector<iovec, 8> iovs;
+    iovs.resize(msg.msg_iovlen);
+    if (!copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen))
+        return EFAULT;
+    return iovs;
+}
+
 KResultOr<ssize_t> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*> user_msg, int flags)
 {
     REQUIRE_PROMISE(stdio);
@@ -170,12 +194,14 @@ KResultOr<ssize_t> Process::sys$sendmsg(int sockfd, Userspace<const struct msghd
     if (!copy_from_user(&msg, user_msg))
         return EFAULT;
 
-    if (msg.msg_iovlen != 1)
-        return ENOTSUP; // FIXME: Support this :)
-    Vector<iovec, 1> iovs;
-    iovs.resize(msg.msg_iovlen);
-    if (!copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen))
-        return EFAULT;
+    auto iovs_or_error = copy_iovecs_from_user(msg);
+    if (iovs_or_error.is_error())
+        return iovs_or_error.error();
+    auto& iovs = iovs_or_error.value();
+    auto total_length_or_error = total_iovec_length(iovs);
+    if (total_length_or_error.is_error())
+        return total_length_or_error.error();
+    size_t total_length = total_length_or_error.value();
 
     Userspace<const sockaddr*> user_addr((FlatPtr)msg.msg_name);
     socklen_t addr_length = msg.msg_namelen;
@@ -188,10 +214,41 @@ KResultOr<ssize_t> Process::sys$sendmsg(int sockfd, Userspace<const struct msghd
     auto& socket = *description->socket();
     if (socket.is_shut_down_for_writing())
         return EPIPE;
-    auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len);
-    if (!data_buffer.has_value())
-        return EFAULT;
-    auto result = socket.sendto(*description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, addr_length);
+
+    if (iovs.size() == 1 || socket.type() == SOCK_STREAM) {
+        // Stream sockets take the data piece by piece, straight from userspace.
+        size_t nsent = 0;
+        for (auto& iov : iovs) {
+            if (iov.iov_len == 0)
+                continue;
+            auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iov.iov_base, iov.iov_len);
+            if (!data_buffer.has_value())
+                return EFAULT;
+            auto result = socket.sendto(*description, data_buffer.value(), iov.iov_len, flags, user_addr, addr_length);
+            if (result.is_error()) {
+                if (nsent == 0)
+                    return result.error();
+                break;
+            }
+            nsent += result.value();
+            if (result.value() < iov.iov_len)
+                break;
+        }
+        return nsent;
+    }
+
+    // A datagram has to go out in one piece, so gather it up first.
+    auto gathered = KBuffer::try_create_with_size(max(total_length, (size_t)1));
+    if (!gathered)
+        return ENOMEM;
+    size_t offset = 0;
+    for (auto& iov : iovs) {
+        if (!copy_from_user(gathered->data() + offset, iov.iov_base, iov.iov_len))
+            return EFAULT;
+        offset += iov.iov_len;
+    }
+    auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(gathered->data());
+    auto result = socket.sendto(*description, data_buffer, total_length, flags, user_addr, addr_length);
     if (result.is_error())
         return result.error();
     return result.value();
@@ -205,12 +262,14 @@ KResultOr<ssize_t> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> us
     if (!copy_from_user(&msg, user_msg))
         return EFAULT;
 
-    if (msg.msg_iovlen != 1)
-        return ENOTSUP; // FIXME: Support this :)
-    Vector<iovec, 1> iovs;
-    iovs.resize(msg.msg_iovlen);
-    if (!copy_n_from_user(iovs.data(), msg.msg_iov, msg.msg_iovlen))
-        return EFAULT;
+    auto iovs_or_error = copy_iovecs_from_user(msg);
+    if (iovs_or_error.is_error())
+        return iovs_or_error.error();
+    auto& iovs = iovs_or_error.value();
+    auto total_length_or_error = total_iovec_length(iovs);
+    if (total_length_or_error.is_error())
+        return total_length_or_error.error();
+    size_t total_length = total_length_or_error.value();
 
     Userspace<sockaddr*> user_addr((FlatPtr)msg.msg_name);
     Userspace<socklen_t*> user_addr_length(msg.msg_name ? (FlatPtr)&user_msg.unsafe_userspace_ptr()->msg_namelen : 0);
@@ -229,11 +288,55 @@ KResultOr<ssize_t> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> us
     if (flags & MSG_DONTWAIT)
         description->set_blocking(false);
 
-    auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len);
-    if (!data_buffer.has_value())
-        return EFAULT;
     Time timestamp {};
-    auto result = socket.recvfrom(*description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp);
+    KResultOr<size_t> result { 0 };
+    if (iovs.size() == 1) {
+        auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iovs[0].iov_base, iovs[0].iov_len);
+        if (!data_buffer.has_value())
+            return EFAULT;
+        result = socket.recvfrom(*description, data_buffer.value(), iovs[0].iov_len, flags, user_addr, user_addr_length, timestamp);
+    } else if (socket.type() == SOCK_STREAM) {
+        // Only the first read may block; after that, take whatever else is already buffered.
+        size_t nreceived = 0;
+        for (auto& iov : iovs) {
+            if (iov.iov_len == 0)
+                continue;
+            auto data_buffer = UserOrKernelBuffer::for_user_buffer((u8*)iov.iov_base, iov.iov_len);
+            if (!data_buffer.has_value())
+                return EFAULT;
+            if (nreceived > 0)
+                description->set_blocking(false);
+            auto piece_result = socket.recvfrom(*description, data_buffer.value(), iov.iov_len, flags, user_addr, user_addr_length, timestamp);
+            if (piece_result.is_error()) {
+                if (nreceived == 0)
+                    result = piece_result.error();
+                break;
+            }
+            nreceived += piece_result.value();
+            if (piece_result.value() < iov.iov_len)
+                break;
+        }
+        if (!result.is_error())
+            result = nreceived;
+        description->set_blocking(original_blocking);
+    } else {
+        // Datagrams arrive in one piece, so receive into a kernel buffer and scatter from there.
+        auto gathered = KBuffer::try_create_with_size(max(total_length, (size_t)1));
+        if (!gathered)
+            return ENOMEM;
+        auto data_buffer = UserOrKernelBuffer::for_kernel_buffer(gathered->data());
+        result = socket.recvfrom(*description, data_buffer, total_length, flags, user_addr, user_addr_length, timestamp);
+        if (!result.is_error()) {
+            size_t bytes_to_scatter = min(result.value(), total_length);
+            size_t offset = 0;
+            for (auto& iov : iovs) {
+                size_t piece_size = min(iov.iov_len, bytes_to_scatter - offset);
+                if (!copy_to_user(iov.iov_base, gathered->data() + offset, piece_size))
+                    return EFAULT;
+                offset += piece_size;
+            }
+        }
+    }
     if (flags & MSG_DONTWAIT)
         description->set_blocking(original_blocking);
 
@@ -242,7 +345,7 @@ KResultOr<ssize_t> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> us
 
     int msg_flags = 0;
 
-    if (result.value() > iovs[0].iov_len) {
+    if (result.value() > total_length) {
         VERIFY(socket.type() != SOCK_STREAM);
         msg_flags |= MSG_TRUNC;
     }
@@ -359,7 +462,7 @@ KResultOr<int> Process::sys$setsockopt(Userspace<const Syscall::SC_setsockopt_pa
         return ENOTSOCK;
     auto& socket = *description->socket();
     REQUIRE_PROMISE_FOR_SOCKET_DOMAIN(socket.domain());
-    return socket.setsockopt(params.level, params.option, user_value, params.value_size);
+    return socket.setsockopt(*description, params.level, params.option, user_value, params.value_size);
 }
 
 }
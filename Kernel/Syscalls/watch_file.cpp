@@ -32,7 +32,11 @@ KResultOr<int> Process::sys$watch_file(Userspace<const char*> user_path, size_t
     if (fd < 0)
         return fd;
 
-    auto description = FileDescription::create(*InodeWatcher::create(inode));
+    auto watcher = InodeWatcher::create(inode);
+    if (watcher.is_error())
+        return watcher.error();
+
+    auto description = FileDescription::create(watcher.release_value());
     if (description.is_error())
         return description.error();
 
@@ -41,4 +45,43 @@ KResultOr<int> Process::sys$watch_file(Userspace<const char*> user_path, size_t
     return fd;
 }
 
+KResultOr<int> Process::sys$add_inode_watch(int fd, Userspace<const char*> user_path, size_t path_length)
+{
+    REQUIRE_PROMISE(rpath);
+    auto description = file_description(fd);
+    if (!description)
+        return EBADF;
+    if (!description->file().is_inode_watcher())
+        return EBADF;
+    auto& watcher = static_cast<InodeWatcher&>(description->file());
+
+    auto path = get_syscall_path_argument(user_path, path_length);
+    if (path.is_error())
+        return path.error();
+
+    auto custody_or_error = VFS::the().resolve_path(path.value(), current_directory());
+    if (custody_or_error.is_error())
+        return custody_or_error.error();
+
+    auto& inode = custody_or_error.value()->inode();
+    if (!inode.fs().supports_watchers())
+        return ENOTSUP;
+
+    return watcher.add_watch(inode);
+}
+
+KResultOr<int> Process::sys$remove_inode_watch(int fd, int watch_descriptor)
+{
+    REQUIRE_PROMISE(rpath);
+    auto description = file_description(fd);
+    if (!description)
+        return EBADF;
+    if (!description->file().is_inode_watcher())
+        return EBADF;
+    auto result = static_cast<InodeWatcher&>(description->file()).remove_watch(watch_descriptor);
+    if (result.is_error())
+        return result;
+    return 0;
+}
+
 }
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Process.h>
+#include <Kernel/VM/MemoryPressureWatcher.h>
+
+namespace Kernel {
+
+KResultOr<int> Process::sys$watch_memory_pressure()
+{
+    REQUIRE_PROMISE(stdio);
+    int fd = alloc_fd();
+    if (fd < 0)
+        return fd;
+
+    auto description = FileDescription::create(*MemoryPressureWatcher::create());
+    if (description.is_error())
+        return description.error();
+
+    m_fds[fd].set(description.release_value());
+    m_fds[fd].description()->set_readable(true);
+    return fd;
+}
+
+}
@@ -36,23 +36,20 @@ String SlavePTY::tty_name() const
     return m_tty_name;
 }
 
-void SlavePTY::echo(u8 ch)
+void SlavePTY::echo(ReadonlyBytes bytes)
 {
     if (should_echo_input()) {
-        auto buffer = UserOrKernelBuffer::for_kernel_buffer(&ch);
-        m_master->on_slave_write(buffer, 1);
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(bytes.data()));
+        m_master->on_slave_write(buffer, bytes.size());
     }
 }
 
 void SlavePTY::on_master_write(const UserOrKernelBuffer& buffer, ssize_t size)
 {
-    ssize_t nread = buffer.read_buffered<128>(size, [&](const u8* data, size_t data_size) {
-        for (size_t i = 0; i < data_size; ++i)
-            emit(data[i], false);
+    [[maybe_unused]] ssize_t nread = buffer.read_buffered<512>(size, [&](const u8* data, size_t data_size) {
+        emit({ data, data_size });
         return (ssize_t)data_size;
     });
-    if (nread > 0)
-        evaluate_block_conditions();
 }
 
 ssize_t SlavePTY::on_tty_write(const UserOrKernelBuffer& data, ssize_t size)
@@ -28,7 +28,7 @@ private:
     // ^TTY
     virtual String tty_name() const override;
     virtual ssize_t on_tty_write(const UserOrKernelBuffer&, ssize_t) override;
-    virtual void echo(u8) override;
+    virtual void echo(ReadonlyBytes) override;
 
     // ^CharacterDevice
     virtual bool can_read(const FileDescription&, size_t) const override;
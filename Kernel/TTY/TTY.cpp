@@ -129,6 +129,42 @@ bool TTY::is_werase(u8 ch) const
     return ch == m_termios.c_cc[VWERASE];
 }
 
+bool TTY::is_line_discipline_character(u8 ch) const
+{
+    if (should_generate_signals()) {
+        if (ch == m_termios.c_cc[VINFO] || ch == m_termios.c_cc[VINTR] || ch == m_termios.c_cc[VQUIT] || ch == m_termios.c_cc[VSUSP])
+            return true;
+    }
+    if (in_canonical_mode())
+        return is_eof(ch) || is_kill(ch) || is_erase(ch) || is_werase(ch);
+    return false;
+}
+
+void TTY::emit(ReadonlyBytes input)
+{
+    // Runs of ordinary characters are queued up and echoed in one go, and readers are woken up once for the
+    // whole chunk rather than for every character.
+    size_t run_start = 0;
+    auto echo_run = [&](size_t run_end) {
+        if (run_end > run_start)
+            echo(input.slice(run_start, run_end - run_start));
+    };
+    for (size_t i = 0; i < input.size(); ++i) {
+        u8 ch = input[i];
+        if (is_line_discipline_character(ch)) {
+            echo_run(i);
+            run_start = i + 1;
+            emit(ch, false);
+            continue;
+        }
+        if (in_canonical_mode() && (ch == '\n' || is_eol(ch)))
+            m_available_lines++;
+        m_input_buffer.enqueue(ch);
+    }
+    echo_run(input.size());
+    evaluate_block_conditions();
+}
+
 void TTY::emit(u8 ch, bool do_evaluate_block_conditions)
 {
     if (should_generate_signals()) {
@@ -56,7 +56,9 @@ protected:
 
     TTY(unsigned major, unsigned minor);
     void emit(u8, bool do_evaluate_block_conditions = false);
-    virtual void echo(u8) = 0;
+    void emit(ReadonlyBytes);
+    void echo(u8 ch) { echo({ &ch, 1 }); }
+    virtual void echo(ReadonlyBytes) = 0;
 
     bool can_do_backspace() const;
     void do_backspace();
@@ -70,6 +72,7 @@ protected:
     bool is_kill(u8) const;
     bool is_erase(u8) const;
     bool is_werase(u8) const;
+    bool is_line_discipline_character(u8) const;
 
     void generate_signal(int signal);
 
@@ -79,7 +82,7 @@ private:
     // ^CharacterDevice
     virtual bool is_tty() const final override { return true; }
 
-    CircularDeque<u8, 1024> m_input_buffer;
+    CircularDeque<u8, 4096> m_input_buffer;
     WeakPtr<Process> m_original_process_parent;
     WeakPtr<ProcessGroup> m_pg;
     termios m_termios;
@@ -314,8 +314,7 @@ void VirtualConsole::terminal_history_changed()
 
 void VirtualConsole::emit(const u8* data, size_t size)
 {
-    for (size_t i = 0; i < size; i++)
-        TTY::emit(data[i], true);
+    TTY::emit({ data, size });
 }
 
 String VirtualConsole::device_name() const
@@ -323,11 +322,11 @@ String VirtualConsole::device_name() const
     return String::formatted("tty{}", minor());
 }
 
-void VirtualConsole::echo(u8 ch)
+void VirtualConsole::echo(ReadonlyBytes bytes)
 {
     if (should_echo_input()) {
-        auto buffer = UserOrKernelBuffer::for_kernel_buffer(&ch);
-        on_tty_write(buffer, 1);
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(bytes.data()));
+        on_tty_write(buffer, bytes.size());
     }
 }
 
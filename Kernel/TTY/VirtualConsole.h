@@ -36,7 +36,7 @@ private:
     // ^TTY
     virtual ssize_t on_tty_write(const UserOrKernelBuffer&, ssize_t) override;
     virtual String tty_name() const override { return m_tty_name; }
-    virtual void echo(u8) override;
+    virtual void echo(ReadonlyBytes) override;
 
     // ^TerminalClient
     virtual void beep() override;
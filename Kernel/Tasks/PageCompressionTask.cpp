@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Process.h>
+#include <Kernel/Tasks/PageCompressionTask.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/UnixTypes.h>
+#include <Kernel/VM/MemoryManager.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+// How many pages we compress per scan at most, so that a single scan never holds up the system for long.
+static constexpr size_t max_pages_per_scan = 1024;
+
+static WaitQueue* s_page_compression_task_wait_queue;
+
+void PageCompressionTask::spawn()
+{
+    s_page_compression_task_wait_queue = new WaitQueue;
+    RefPtr<Thread> page_compression_thread;
+    Process::create_kernel_process(page_compression_thread, "PageCompressionTask", [] {
+        Thread::current()->set_priority(THREAD_PRIORITY_LOW);
+        bool was_scanning = false;
+        for (;;) {
+            // While there's plenty of memory, there's no point in paying for the compression
+            // or for the extra faults afterwards. Once memory runs low, every pass compresses
+            // the pages that weren't touched since the previous one.
+            if (MM.memory_pressure_level() != MEMORY_PRESSURE_NORMAL) {
+                auto compressed_page_count = MM.compress_cold_pages(was_scanning ? max_pages_per_scan : 0);
+                if (compressed_page_count > 0)
+                    dbgln("PageCompressionTask: Compressed {} cold pages", compressed_page_count);
+                was_scanning = true;
+            } else {
+                was_scanning = false;
+            }
+            auto timeout = Time::from_seconds(1);
+            (void)s_page_compression_task_wait_queue->wait_on(Thread::BlockTimeout(false, &timeout));
+        }
+    });
+}
+
+}
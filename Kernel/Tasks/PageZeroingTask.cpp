@@ -0,0 +1,36 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Process.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
+#include <Kernel/VM/MemoryManager.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+static WaitQueue* s_page_zeroing_task_wait_queue;
+
+void PageZeroingTask::spawn()
+{
+    s_page_zeroing_task_wait_queue = new WaitQueue;
+    RefPtr<Thread> page_zeroing_thread;
+    Process::create_kernel_process(page_zeroing_thread, "PageZeroingTask", [] {
+        // We only want to run when there's nothing better to do.
+        Thread::current()->set_priority(THREAD_PRIORITY_MIN);
+        for (;;) {
+            MM.refill_zeroed_page_caches();
+            s_page_zeroing_task_wait_queue->wait_forever("PageZeroingTask");
+        }
+    });
+}
+
+void PageZeroingTask::wake()
+{
+    if (s_page_zeroing_task_wait_queue)
+        s_page_zeroing_task_wait_queue->wake_one();
+}
+
+}
@@ -8,19 +8,30 @@
 #include <Kernel/Process.h>
 #include <Kernel/Tasks/SyncTask.h>
 #include <Kernel/Time/TimeManagement.h>
+#include <Kernel/WaitQueue.h>
 
 namespace Kernel {
 
+static WaitQueue* s_sync_task_wait_queue;
+
 void SyncTask::spawn()
 {
+    s_sync_task_wait_queue = new WaitQueue;
     RefPtr<Thread> syncd_thread;
     Process::create_kernel_process(syncd_thread, "SyncTask", [] {
         dbgln("SyncTask is running");
         for (;;) {
-            VFS::the().sync();
-            (void)Thread::current()->sleep(Time::from_seconds(1));
+            FS::writeback_all();
+            auto timeout = Time::from_seconds(1);
+            (void)s_sync_task_wait_queue->wait_on(Thread::BlockTimeout(false, &timeout));
         }
     });
 }
 
+void SyncTask::wake()
+{
+    if (s_sync_task_wait_queue)
+        s_sync_task_wait_queue->wake_one();
+}
+
 }
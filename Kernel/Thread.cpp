@@ -30,17 +30,47 @@ namespace Kernel {
 SpinLock<u8> Thread::g_tid_map_lock;
 READONLY_AFTER_INIT HashMap<ThreadID, Thread*>* Thread::g_tid_map;
 
+// Kernel stacks of dead threads are kept around for new threads, since allocating one means committing,
+// zeroing and mapping 64 KiB of memory, and threads tend to come and go in bursts.
+static constexpr size_t max_cached_kernel_stacks = 16;
+static SpinLock<u8> s_kernel_stack_cache_lock;
+static READONLY_AFTER_INIT Vector<NonnullOwnPtr<Region>, max_cached_kernel_stacks>* s_kernel_stack_cache;
+
 UNMAP_AFTER_INIT void Thread::initialize()
 {
     g_tid_map = new HashMap<ThreadID, Thread*>();
+    s_kernel_stack_cache = new Vector<NonnullOwnPtr<Region>, max_cached_kernel_stacks>();
+}
+
+static OwnPtr<Region> take_cached_kernel_stack()
+{
+    ScopedSpinLock lock(s_kernel_stack_cache_lock);
+    if (s_kernel_stack_cache->is_empty())
+        return {};
+    return s_kernel_stack_cache->take_last();
+}
+
+static void recycle_kernel_stack(NonnullOwnPtr<Region> kernel_stack_region)
+{
+    {
+        ScopedSpinLock lock(s_kernel_stack_cache_lock);
+        if (s_kernel_stack_cache->size() < max_cached_kernel_stacks) {
+            s_kernel_stack_cache->unchecked_append(move(kernel_stack_region));
+            return;
+        }
+    }
+    // The region is unmapped here, outside the lock.
 }
 
 KResultOr<NonnullRefPtr<Thread>> Thread::try_create(NonnullRefPtr<Process> process)
 {
-    auto kernel_stack_region = MM.allocate_kernel_region(default_kernel_stack_size, {}, Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
-    if (!kernel_stack_region)
-        return ENOMEM;
-    kernel_stack_region->set_stack(true);
+    auto kernel_stack_region = take_cached_kernel_stack();
+    if (!kernel_stack_region) {
+        kernel_stack_region = MM.allocate_kernel_region(default_kernel_stack_size, {}, Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
+        if (!kernel_stack_region)
+            return ENOMEM;
+        kernel_stack_region->set_stack(true);
+    }
     return adopt_ref(*new Thread(move(process), kernel_stack_region.release_nonnull()));
 }
 
@@ -91,6 +121,7 @@ Thread::Thread(NonnullRefPtr<Process> process, NonnullOwnPtr<Region> kernel_stac
     }
 
     m_tss.cr3 = m_process->space().page_directory().cr3();
+    m_active_page_directory = &m_process->space().page_directory();
 
     m_kernel_stack_base = m_kernel_stack_region->vaddr().get();
     m_kernel_stack_top = m_kernel_stack_region->vaddr().offset(default_kernel_stack_size).get() & 0xfffffff8u;
@@ -133,6 +164,10 @@ Thread::~Thread()
         auto result = g_tid_map->remove(m_tid);
         VERIFY(result);
     }
+
+    // Nothing runs on this stack anymore, so another thread can have it.
+    if (m_kernel_stack_region)
+        recycle_kernel_stack(m_kernel_stack_region.release_nonnull());
 }
 
 void Thread::unblock_from_blocker(Blocker& blocker)
@@ -328,7 +363,17 @@ auto Thread::sleep_until(clockid_t clock_id, const Time& deadline) -> BlockResul
 
 const char* Thread::state_string() const
 {
-    switch (state()) {
+    if (state() == Thread::Blocked) {
+        ScopedSpinLock block_lock(m_block_lock);
+        VERIFY(m_blocker != nullptr);
+        return m_blocker->state_string();
+    }
+    return state_name(state());
+}
+
+const char* Thread::state_name(State state)
+{
+    switch (state) {
     case Thread::Invalid:
         return "Invalid";
     case Thread::Runnable:
@@ -341,13 +386,10 @@ const char* Thread::state_string() const
         return "Dead";
     case Thread::Stopped:
         return "Stopped";
-    case Thread::Blocked: {
-        ScopedSpinLock block_lock(m_block_lock);
-        VERIFY(m_blocker != nullptr);
-        return m_blocker->state_string();
-    }
+    case Thread::Blocked:
+        return "Blocked";
     }
-    PANIC("Thread::state_string(): Invalid state: {}", (int)state());
+    PANIC("Thread::state_name(): Invalid state: {}", (int)state);
 }
 
 void Thread::finalize()
@@ -69,6 +69,7 @@ class Thread
     friend class ProtectedProcessBase;
     friend class Scheduler;
     friend struct ThreadReadyQueue;
+    friend struct ThreadReadyQueues;
 
     static SpinLock<u8> g_tid_map_lock;
     static HashMap<ThreadID, Thread*>* g_tid_map;
@@ -93,6 +94,11 @@ public:
     void set_priority(u32 p) { m_priority = p; }
     u32 priority() const { return m_priority; }
 
+    // While a higher priority thread is waiting on a priority inheritance futex owned by
+    // this thread, we run at that thread's priority so we get out of its way sooner.
+    void set_inherited_priority(u32 p) { m_inherited_priority = p; }
+    u32 effective_priority() const { return max(m_priority, m_inherited_priority); }
+
     void detach()
     {
         ScopedSpinLock lock(m_lock);
@@ -410,7 +416,7 @@ public:
             Vector<BlockerInfo, 4> taken_blockers;
             taken_blockers.ensure_capacity(move_count);
             for (size_t i = 0; i < move_count; i++)
-                taken_blockers.append(m_blockers.take(i));
+                taken_blockers.append(m_blockers[i]);
             m_blockers.remove(0, move_count);
             return taken_blockers;
         }
@@ -424,8 +430,8 @@ public:
                 return;
             }
             m_blockers.ensure_capacity(m_blockers.size() + blockers_to_append.size());
-            for (size_t i = 0; i < blockers_to_append.size(); i++)
-                m_blockers.append(blockers_to_append.take(i));
+            for (auto& info : blockers_to_append)
+                m_blockers.append(info);
             blockers_to_append.clear();
         }
 
@@ -748,8 +754,17 @@ public:
 
     TSS& tss() { return m_tss; }
     const TSS& tss() const { return m_tss; }
+
+    // The page directory that tss().cr3 refers to.
+    PageDirectory* active_page_directory() { return m_active_page_directory; }
+    void set_active_page_directory(PageDirectory& page_directory) { m_active_page_directory = &page_directory; }
+
+    TLBShootdownBatch* tlb_shootdown_batch() { return m_tlb_shootdown_batch; }
+    void set_tlb_shootdown_batch(TLBShootdownBatch* batch) { m_tlb_shootdown_batch = batch; }
     State state() const { return m_state; }
     const char* state_string() const;
+    // Unlike state_string(), this doesn't say what a blocked thread is blocked on.
+    static const char* state_name(State);
 
     VirtualAddress thread_specific_data() const { return m_thread_specific_data; }
     size_t thread_specific_region_size() const;
@@ -993,6 +1008,25 @@ public:
         m_file_write_bytes += bytes;
     }
 
+    u64 block_read_requests() const { return m_block_read_requests; }
+    u64 block_read_bytes() const { return m_block_read_bytes; }
+    u64 block_write_requests() const { return m_block_write_requests; }
+    u64 block_write_bytes() const { return m_block_write_bytes; }
+
+    // Block device requests are charged to the thread that issued them when they complete,
+    // which happens in interrupt handlers on any processor.
+    void did_block_read(u64 bytes)
+    {
+        m_block_read_requests++;
+        m_block_read_bytes += bytes;
+    }
+
+    void did_block_write(u64 bytes)
+    {
+        m_block_write_requests++;
+        m_block_write_bytes += bytes;
+    }
+
     unsigned unix_socket_read_bytes() const { return m_unix_socket_read_bytes; }
     unsigned unix_socket_write_bytes() const { return m_unix_socket_write_bytes; }
 
@@ -1117,6 +1151,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    Atomic<int, AK::MemoryOrder::memory_order_relaxed> m_runnable_cpu { -1 };
 
     friend class WaitQueue;
 
@@ -1186,6 +1221,8 @@ private:
     NonnullRefPtr<Process> m_process;
     ThreadID m_tid { -1 };
     TSS m_tss {};
+    PageDirectory* m_active_page_directory { nullptr };
+    TLBShootdownBatch* m_tlb_shootdown_batch { nullptr };
     DebugRegisterState m_debug_register_state {};
     TrapFrame* m_current_trap { nullptr };
     u32 m_saved_critical { 1 };
@@ -1231,6 +1268,11 @@ private:
     unsigned m_file_read_bytes { 0 };
     unsigned m_file_write_bytes { 0 };
 
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_block_read_requests { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_block_read_bytes { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_block_write_requests { 0 };
+    Atomic<u64, AK::MemoryOrder::memory_order_relaxed> m_block_write_bytes { 0 };
+
     unsigned m_unix_socket_read_bytes { 0 };
     unsigned m_unix_socket_write_bytes { 0 };
 
@@ -1241,6 +1283,7 @@ private:
     State m_state { Invalid };
     String m_name;
     u32 m_priority { THREAD_PRIORITY_NORMAL };
+    u32 m_inherited_priority { 0 };
 
     State m_stop_state { Invalid };
 
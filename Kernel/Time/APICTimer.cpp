@@ -17,6 +17,9 @@ namespace Kernel {
 
 #define APIC_TIMER_MEASURE_CPU_CLOCK
 
+// Longer delays get cut short; the caller just re-arms the timer when it fires early.
+static constexpr u64 max_one_shot_delay_ns = 10 * 1000000000ull;
+
 UNMAP_AFTER_INIT APICTimer* APICTimer::initialize(u8 interrupt_number, HardwareTimerBase& calibration_source)
 {
     auto timer = adopt_ref(*new APICTimer(interrupt_number, nullptr));
@@ -111,7 +114,8 @@ UNMAP_AFTER_INIT bool APICTimer::calibrate(HardwareTimerBase& calibration_source
     auto delta_apic_count = start_apic_count - end_apic_count; // The APIC current count register decrements!
     m_timer_period = (delta_apic_count * apic.get_timer_divisor()) / ticks_in_100ms;
 
-    u64 apic_freq = delta_apic_count * apic.get_timer_divisor() * 10;
+    u64 apic_freq = (u64)delta_apic_count * apic.get_timer_divisor() * 10;
+    m_bus_frequency = apic_freq;
     dmesgln("APICTimer: Bus clock speed: {}.{} MHz", apic_freq / 1000000, apic_freq % 1000000);
     if (apic_freq < 1000000) {
         dmesgln("APICTimer: Frequency too slow!");
@@ -144,15 +148,23 @@ size_t APICTimer::ticks_per_second() const
     return m_frequency;
 }
 
+void APICTimer::set_next_interrupt(Time delay)
+{
+    VERIFY(m_timer_mode == APIC::TimerMode::OneShot);
+    auto& apic = APIC::the();
+    u64 delay_ns = clamp(delay.to_nanoseconds(), (i64)0, (i64)max_one_shot_delay_ns);
+    u64 count = delay_ns * m_bus_frequency / 1000000000ull / apic.get_timer_divisor();
+    // The initial count register is only 32 bits wide, and 0 would stop the timer.
+    apic.set_timer_initial_count((u32)clamp(count, (u64)1, (u64)0xffffffff));
+}
+
 void APICTimer::set_periodic()
 {
-    // FIXME: Implement it...
-    VERIFY_NOT_REACHED();
+    m_timer_mode = APIC::TimerMode::Periodic;
 }
 void APICTimer::set_non_periodic()
 {
-    // FIXME: Implement it...
-    VERIFY_NOT_REACHED();
+    m_timer_mode = APIC::TimerMode::OneShot;
 }
 
 void APICTimer::reset_to_default_ticks_per_second()
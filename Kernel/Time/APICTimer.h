@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/NonnullRefPtr.h>
+#include <AK/Time.h>
 #include <AK/Types.h>
 #include <Kernel/Interrupts/GenericInterruptHandler.h>
 #include <Kernel/Time/HardwareTimer.h>
@@ -35,12 +36,17 @@ public:
     void enable_local_timer();
     void disable_local_timer();
 
+    // Only valid in one-shot mode: arms the local timer of the current
+    // processor to fire once after (roughly) the given delay.
+    void set_next_interrupt(Time delay);
+
 private:
     explicit APICTimer(u8, Function<void(const RegisterState&)>);
 
     bool calibrate(HardwareTimerBase&);
 
     u32 m_timer_period { 0 };
+    u64 m_bus_frequency { 0 };
     APIC::TimerMode m_timer_mode { APIC::TimerMode::Periodic };
 };
 
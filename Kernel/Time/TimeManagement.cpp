@@ -106,15 +106,24 @@ Time TimeManagement::monotonic_time(TimePrecision precision) const
     return Time::from_timespec({ (i64)seconds, (i32)ns });
 }
 
-Time TimeManagement::epoch_time(TimePrecision) const
+Time TimeManagement::epoch_time(TimePrecision precision) const
 {
-    // TODO: Take into account precision
     timespec ts;
+    u64 delta_ns = 0;
+    bool do_query = precision == TimePrecision::Precise && m_can_query_precise_time;
     u32 update_iteration;
     do {
         update_iteration = m_update1.load(AK::MemoryOrder::memory_order_acquire);
         ts = m_epoch_time;
+        if (do_query) {
+            // Add the time that passed since the epoch time was last updated by the interrupt handler.
+            u64 seconds = m_seconds_since_boot;
+            u32 ticks = m_ticks_this_second;
+            delta_ns = HPET::the().update_time(seconds, ticks, true);
+        }
     } while (update_iteration != m_update2.load(AK::MemoryOrder::memory_order_acquire));
+    if (delta_ns)
+        timespec_add(ts, { (time_t)(delta_ns / 1000000000), (long)(delta_ns % 1000000000) }, ts);
     return Time::from_timespec(ts);
 }
 
@@ -128,6 +137,28 @@ u64 TimeManagement::uptime_ms() const
     return ms;
 }
 
+u64 TimeManagement::precise_uptime_ns() const
+{
+    auto* time_page = AK::atomic_load(&m_time_page, AK::memory_order_acquire);
+    if (time_page && m_tsc_multiplier) {
+        u32 update_iteration;
+        u64 ns;
+        u64 tsc_at_update;
+        do {
+            update_iteration = AK::atomic_load(&time_page->update1, AK::memory_order_acquire);
+            auto& clock = time_page->clocks[CLOCK_MONOTONIC_COARSE];
+            ns = clock.seconds * 1'000'000'000ull + clock.nanoseconds;
+            tsc_at_update = time_page->tsc_at_update;
+        } while (update_iteration != AK::atomic_load(&time_page->update2, AK::memory_order_acquire));
+
+        // Ticks that don't come from the HPET don't record the TSC, and another processor's TSC may lag behind a bit.
+        auto tsc = read_tsc();
+        if (tsc_at_update && tsc >= tsc_at_update)
+            return ns + time_page_tsc_delta_to_nanoseconds(tsc - tsc_at_update, m_tsc_multiplier, m_tsc_shift);
+    }
+    return monotonic_time(TimePrecision::Precise).to_nanoseconds();
+}
+
 UNMAP_AFTER_INIT void TimeManagement::initialize(u32 cpu)
 {
     if (cpu == 0) {
@@ -141,7 +172,12 @@ UNMAP_AFTER_INIT void TimeManagement::initialize(u32 cpu)
         if (auto* apic_timer = APIC::the().initialize_timers(*s_the->m_system_timer)) {
             dmesgln("Time: Using APIC timer as system timer");
             s_the->set_system_timer(*apic_timer);
+            // We need to be able to query the time between interrupts to know when the next tick is due.
+            if (s_the->m_can_query_precise_time && kernel_command_line().is_tickless_enabled())
+                s_the->enable_tickless(*apic_timer);
         }
+        s_the->calibrate_tsc();
+        s_the->initialize_time_page();
     } else {
         VERIFY(s_the.is_initialized());
         if (auto* apic_timer = APIC::the().get_timer()) {
@@ -196,7 +232,7 @@ UNMAP_AFTER_INIT TimeManagement::TimeManagement()
 
 Time TimeManagement::now()
 {
-    return s_the.ptr()->epoch_time();
+    return s_the.ptr()->epoch_time(TimePrecision::Coarse);
 }
 
 UNMAP_AFTER_INIT Vector<HardwareTimerBase*> TimeManagement::scan_and_initialize_periodic_timers()
@@ -329,6 +365,7 @@ void TimeManagement::increment_time_since_boot_hpet()
     auto seconds_since_boot = m_seconds_since_boot;
     auto ticks_this_second = m_ticks_this_second;
     auto delta_ns = HPET::the().update_time(seconds_since_boot, ticks_this_second, false);
+    u64 tsc = m_tsc_multiplier ? read_tsc() : 0;
 
     // Now that we have a precise time, go update it as quickly as we can
     u32 update_iteration = m_update1.fetch_add(1, AK::MemoryOrder::memory_order_acquire);
@@ -337,6 +374,8 @@ void TimeManagement::increment_time_since_boot_hpet()
     // TODO: Apply m_remaining_epoch_time_adjustment
     timespec_add(m_epoch_time, { (time_t)(delta_ns / 1000000000), (long)(delta_ns % 1000000000) }, m_epoch_time);
     m_update2.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
+
+    update_time_page(tsc);
 }
 
 void TimeManagement::increment_time_since_boot()
@@ -367,6 +406,69 @@ void TimeManagement::increment_time_since_boot()
         m_ticks_this_second = 0;
     }
     m_update2.store(update_iteration + 1, AK::MemoryOrder::memory_order_release);
+
+    update_time_page(0);
+}
+
+UNMAP_AFTER_INIT void TimeManagement::calibrate_tsc()
+{
+    // The TSC is only good for extrapolating the time since the last tick if it runs at a
+    // constant rate, even while the processor is sleeping. We also need a precise clock to
+    // measure that rate against.
+    auto& processor = Processor::current();
+    if (!m_can_query_precise_time || !processor.has_feature(CPUFeature::TSC) || !processor.has_feature(CPUFeature::CONSTANT_TSC) || !processor.has_feature(CPUFeature::NONSTOP_TSC))
+        return;
+
+    auto start_time = monotonic_time(TimePrecision::Precise);
+    u64 start_tsc = read_tsc();
+    Time elapsed;
+    do {
+        elapsed = monotonic_time(TimePrecision::Precise) - start_time;
+    } while (elapsed < Time::from_milliseconds(10));
+    u64 tsc_ticks = read_tsc() - start_tsc;
+    u64 elapsed_ns = elapsed.to_nanoseconds();
+    if (tsc_ticks == 0 || elapsed_ns == 0)
+        return;
+
+    // Use as much precision for the nanoseconds per TSC tick as fits into 32 bits.
+    u32 shift = 32;
+    while (shift > 1 && (elapsed_ns << shift) / tsc_ticks > NumericLimits<u32>::max())
+        shift--;
+    m_tsc_multiplier = (elapsed_ns << shift) / tsc_ticks;
+    m_tsc_shift = shift;
+    dmesgln("Time: TSC runs at {} MHz", tsc_ticks * 1000 / elapsed_ns);
+}
+
+UNMAP_AFTER_INIT void TimeManagement::initialize_time_page()
+{
+    auto region = MM.allocate_kernel_region(PAGE_SIZE, "Time page", Region::Access::Read | Region::Access::Write, AllocationStrategy::AllocateNow);
+    VERIFY(region);
+    m_time_page_region = region.leak_ptr();
+    auto* time_page = reinterpret_cast<TimePage*>(m_time_page_region->vaddr().as_ptr());
+    memset(time_page, 0, sizeof(TimePage));
+    time_page->tsc_multiplier = m_tsc_multiplier;
+    time_page->tsc_shift = m_tsc_shift;
+    // Publish the page to the timer interrupt only once it's fully set up.
+    AK::atomic_store(&m_time_page, time_page, AK::memory_order_release);
+}
+
+void TimeManagement::update_time_page(u64 tsc)
+{
+    auto* time_page = AK::atomic_load(&m_time_page, AK::memory_order_acquire);
+    if (!time_page)
+        return;
+
+    auto set_clock = [&](clockid_t clock_id, i64 seconds, u32 nanoseconds) {
+        VERIFY(clock_id < TIME_PAGE_CLOCK_COUNT);
+        time_page->clocks[clock_id].seconds = seconds;
+        time_page->clocks[clock_id].nanoseconds = nanoseconds;
+    };
+
+    u32 update_iteration = AK::atomic_fetch_add(&time_page->update1, 1u, AK::memory_order_acquire);
+    time_page->tsc_at_update = tsc;
+    set_clock(CLOCK_MONOTONIC_COARSE, m_seconds_since_boot, ((u64)m_ticks_this_second * 1000000000ull) / m_time_ticks_per_second);
+    set_clock(CLOCK_REALTIME_COARSE, m_epoch_time.tv_sec, m_epoch_time.tv_nsec);
+    AK::atomic_store(&time_page->update2, update_iteration + 1, AK::memory_order_release);
 }
 
 void TimeManagement::system_timer_tick(const RegisterState& regs)
@@ -378,4 +480,102 @@ void TimeManagement::system_timer_tick(const RegisterState& regs)
     Scheduler::timer_tick(regs);
 }
 
+UNMAP_AFTER_INIT void TimeManagement::enable_tickless(APICTimer& timer)
+{
+    VERIFY(Processor::id() == 0);
+    VERIFY_INTERRUPTS_DISABLED();
+    dmesgln("Time: Enabling tickless mode");
+    m_tick_interval = Time::from_nanoseconds(1000000000 / timer.ticks_per_second());
+    m_tickless_timer = &timer;
+    timer.set_callback([this](const RegisterState& regs) {
+        tickless_timer_tick(regs);
+    });
+    timer.set_non_periodic();
+    m_tickless = true;
+    // Switch the already running local timer of the BSP over to one-shot mode
+    timer.enable_local_timer();
+}
+
+void TimeManagement::tickless_timer_tick(const RegisterState& regs)
+{
+    // The BSP keeps the coarse clocks up to date. It never stops for
+    // longer than a second, which is well within what the HPET main
+    // counter can take before wrapping around.
+    if (Processor::id() == 0)
+        increment_time_since_boot_hpet();
+
+    if (Processor::current().in_irq() <= 1) {
+        // Don't expire timers while handling IRQs
+        TimerQueue::the().fire();
+    }
+
+    auto& state = m_tickless_states[Processor::id()];
+    if (!state.tick_stopped) {
+        // This interrupt may have been for a timer deadline instead of the tick
+        auto now = monotonic_time(TimePrecision::Precise);
+        if (now >= state.next_tick) {
+            state.next_tick = now + m_tick_interval;
+            Scheduler::timer_tick(regs);
+        }
+    }
+
+    program_next_timer_interrupt();
+}
+
+void TimeManagement::program_next_timer_interrupt()
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(Processor::id() < max_tickless_processors);
+    auto& state = m_tickless_states[Processor::id()];
+
+    Time delay;
+    if (!state.tick_stopped)
+        delay = state.next_tick - monotonic_time(TimePrecision::Precise);
+    else if (Processor::id() == 0)
+        delay = Time::from_seconds(1);
+    else
+        delay = Time::max();
+
+    if (auto next_timer = TimerQueue::the().time_until_next_timer(); next_timer.has_value() && next_timer.value() < delay)
+        delay = next_timer.value();
+
+    // Don't let an interrupt storm starve everything else when we're running late.
+    m_tickless_timer->set_next_interrupt(max(delay, Time::from_microseconds(10)));
+}
+
+void TimeManagement::stop_tick()
+{
+    if (!m_tickless)
+        return;
+    VERIFY_INTERRUPTS_DISABLED();
+    auto& state = m_tickless_states[Processor::id()];
+    if (state.tick_stopped)
+        return;
+    state.tick_stopped = true;
+    program_next_timer_interrupt();
+}
+
+void TimeManagement::restart_tick()
+{
+    if (!m_tickless)
+        return;
+    InterruptDisabler disabler;
+    auto& state = m_tickless_states[Processor::id()];
+    if (!state.tick_stopped)
+        return;
+    state.tick_stopped = false;
+    state.next_tick = monotonic_time(TimePrecision::Precise) + m_tick_interval;
+    program_next_timer_interrupt();
+}
+
+void TimeManagement::next_timer_deadline_changed()
+{
+    if (!m_tickless)
+        return;
+    // Every processor takes the next deadline into account when it arms its timer,
+    // so it's enough for this one to fire it if another one was armed for later.
+    InterruptDisabler disabler;
+    program_next_timer_interrupt();
+}
+
 }
@@ -10,6 +10,7 @@
 #include <AK/RefPtr.h>
 #include <AK/Time.h>
 #include <AK/Types.h>
+#include <Kernel/API/TimePage.h>
 #include <Kernel/KResult.h>
 #include <Kernel/UnixTypes.h>
 
@@ -17,7 +18,9 @@ namespace Kernel {
 
 #define OPTIMAL_TICKS_PER_SECOND_RATE 250
 
+class APICTimer;
 class HardwareTimerBase;
+class Region;
 
 enum class TimePrecision {
     Coarse = 0,
@@ -56,6 +59,9 @@ public:
     static bool is_hpet_periodic_mode_allowed();
 
     u64 uptime_ms() const;
+    // Nanoseconds since boot, as precise as monotonic_time(TimePrecision::Precise). It extrapolates from the last
+    // tick with the TSC when it can, like the time page does for userspace, which is much cheaper than the HPET.
+    u64 precise_uptime_ns() const;
     static Time now();
 
     // FIXME: Should use AK::Time internally
@@ -67,6 +73,20 @@ public:
 
     bool can_query_precise_time() const { return m_can_query_precise_time; }
 
+    // The page that sys$map_time_page maps into processes, see Kernel/API/TimePage.h.
+    Region& time_page_region() { return *m_time_page_region; }
+
+    // In tickless mode the local APIC timers run in one-shot mode and are armed for
+    // the next scheduler tick or the next TimerQueue deadline, whichever comes first.
+    // Idle processors stop their scheduler tick entirely.
+    bool is_tickless() const { return m_tickless; }
+    // Called by the idle loop with interrupts disabled, right before halting.
+    void stop_tick();
+    // Called when a processor switches away from its idle thread.
+    void restart_tick();
+    // Called by the TimerQueue whenever a timer was queued in front of all others.
+    void next_timer_deadline_changed();
+
 private:
     bool probe_and_set_legacy_hardware_timers();
     bool probe_and_set_non_legacy_hardware_timers();
@@ -75,6 +95,12 @@ private:
     NonnullRefPtrVector<HardwareTimerBase> m_hardware_timers;
     void set_system_timer(HardwareTimerBase&);
     static void system_timer_tick(const RegisterState&);
+    void enable_tickless(APICTimer&);
+    void tickless_timer_tick(const RegisterState&);
+    void program_next_timer_interrupt();
+    void calibrate_tsc();
+    void initialize_time_page();
+    void update_time_page(u64 tsc);
 
     // Variables between m_update1 and m_update2 are synchronized
     Atomic<u32> m_update1 { 0 };
@@ -90,6 +116,21 @@ private:
 
     RefPtr<HardwareTimerBase> m_system_timer;
     RefPtr<HardwareTimerBase> m_time_keeper_timer;
+
+    struct TicklessState {
+        Time next_tick;
+        bool tick_stopped { false };
+    };
+    static constexpr size_t max_tickless_processors = 32;
+    TicklessState m_tickless_states[max_tickless_processors];
+    APICTimer* m_tickless_timer { nullptr };
+    Time m_tick_interval;
+    bool m_tickless { false };
+
+    Region* m_time_page_region { nullptr };
+    TimePage* m_time_page { nullptr };
+    u32 m_tsc_multiplier { 0 };
+    u32 m_tsc_shift { 0 };
 };
 
 }
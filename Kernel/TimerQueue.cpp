@@ -28,8 +28,9 @@ Time Timer::now(bool is_firing) const
     // NOTE: If is_firing is true then TimePrecision::Precise isn't really useful here.
     // We already have a quite precise time stamp because we just updated the time in the
     // interrupt handler. In those cases, just use coarse timestamps.
+    // In tickless mode the coarse time is only updated sporadically by the BSP though.
     auto clock_id = m_clock_id;
-    if (is_firing) {
+    if (is_firing && !TimeManagement::the().is_tickless()) {
         switch (clock_id) {
         case CLOCK_MONOTONIC:
             clock_id = CLOCK_MONOTONIC_COARSE;
@@ -71,7 +72,11 @@ RefPtr<Timer> TimerQueue::add_timer_without_id(clockid_t clock_id, const Time& d
 
     ScopedSpinLock lock(g_timerqueue_lock);
     timer->m_id = 0; // Don't generate a timer id
-    add_timer_locked(timer);
+    bool is_next_timer = add_timer_locked(timer);
+    lock.unlock();
+
+    if (is_next_timer)
+        TimeManagement::the().next_timer_deadline_changed();
     return timer;
 }
 
@@ -79,13 +84,19 @@ TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
 {
     ScopedSpinLock lock(g_timerqueue_lock);
 
-    timer->m_id = ++m_timer_id_count;
-    VERIFY(timer->m_id != 0); // wrapped
-    add_timer_locked(move(timer));
-    return timer->m_id;
+    auto id = ++m_timer_id_count;
+    timer->m_id = id;
+    VERIFY(id != 0); // wrapped
+    bool is_next_timer = add_timer_locked(move(timer));
+    lock.unlock();
+
+    if (is_next_timer)
+        TimeManagement::the().next_timer_deadline_changed();
+    return id;
 }
 
-void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
+// Returns whether the timer is now the first one due in its queue.
+bool TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
 {
     Time timer_expiration = timer->m_expires;
 
@@ -95,6 +106,7 @@ void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
     if (queue.list.is_empty()) {
         queue.list.append(&timer.leak_ref());
         queue.next_timer_due = timer_expiration;
+        return true;
     } else {
         Timer* following_timer = nullptr;
         queue.list.for_each([&](Timer& t) {
@@ -109,10 +121,12 @@ void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
             queue.list.insert_before(following_timer, &timer.leak_ref());
             if (next_timer_needs_update)
                 queue.next_timer_due = timer_expiration;
+            return next_timer_needs_update;
         } else {
             queue.list.append(&timer.leak_ref());
         }
     }
+    return false;
 }
 
 TimerId TimerQueue::add_timer(clockid_t clock_id, const Time& deadline, Function<void()>&& callback)
@@ -260,6 +274,22 @@ void TimerQueue::fire()
         fire_timers(m_timer_queue_realtime);
 }
 
+Optional<Time> TimerQueue::time_until_next_timer() const
+{
+    ScopedSpinLock lock(g_timerqueue_lock);
+    Optional<Time> next;
+    auto check_queue = [&](const Queue& queue, clockid_t clock_id) {
+        if (queue.list.is_empty())
+            return;
+        auto remaining = queue.next_timer_due - TimeManagement::the().current_time(clock_id).value();
+        if (!next.has_value() || remaining < next.value())
+            next = remaining;
+    };
+    check_queue(m_timer_queue_monotonic, CLOCK_MONOTONIC);
+    check_queue(m_timer_queue_realtime, CLOCK_REALTIME);
+    return next;
+}
+
 void TimerQueue::update_next_timer_due(Queue& queue)
 {
     VERIFY(g_timerqueue_lock.is_locked());
@@ -9,6 +9,7 @@
 #include <AK/Function.h>
 #include <AK/InlineLinkedList.h>
 #include <AK/NonnullRefPtr.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefCounted.h>
 #include <AK/Time.h>
@@ -81,6 +82,8 @@ public:
         return cancel_timer(*move(timer));
     }
     void fire();
+    // How long until the earliest queued timer is due, if any.
+    Optional<Time> time_until_next_timer() const;
 
 private:
     struct Queue {
@@ -89,7 +92,7 @@ private:
     };
     void remove_timer_locked(Queue&, Timer&);
     void update_next_timer_due(Queue&);
-    void add_timer_locked(NonnullRefPtr<Timer>);
+    bool add_timer_locked(NonnullRefPtr<Timer>);
 
     Queue& queue_for_timer(Timer& timer)
     {
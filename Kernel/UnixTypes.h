@@ -49,6 +49,28 @@ enum {
 #define PERF_EVENT_SAMPLE 0
 #define PERF_EVENT_MALLOC 1
 #define PERF_EVENT_FREE 2
+// These are only ever recorded by the kernel's tracepoints, see ktrace_enable().
+#define PERF_EVENT_SYSCALL_ENTER 3
+#define PERF_EVENT_SYSCALL_EXIT 4
+#define PERF_EVENT_CONTEXT_SWITCH 5
+#define PERF_EVENT_PAGE_FAULT 6
+#define PERF_EVENT_BLOCK_IO 7
+
+#define PERF_COUNTER_TIMER 0
+#define PERF_COUNTER_CYCLES 1
+#define PERF_COUNTER_INSTRUCTIONS 2
+#define PERF_COUNTER_CACHE_MISSES 3
+#define PERF_COUNTER_BRANCH_MISSES 4
+
+#define KTRACE_SYSCALLS 0x1
+#define KTRACE_CONTEXT_SWITCHES 0x2
+#define KTRACE_PAGE_FAULTS 0x4
+#define KTRACE_BLOCK_IO 0x8
+#define KTRACE_ALL 0xf
+
+#define MEMORY_PRESSURE_NORMAL 0
+#define MEMORY_PRESSURE_LOW 1
+#define MEMORY_PRESSURE_CRITICAL 2
 
 #define WNOHANG 1
 #define WUNTRACED 2
@@ -87,6 +109,7 @@ enum {
 #define MADV_SET_VOLATILE 0x100
 #define MADV_SET_NONVOLATILE 0x200
 #define MADV_GET_VOLATILE 0x400
+#define MADV_HUGEPAGE 0x800
 
 #define F_DUPFD 0
 #define F_GETFD 1
@@ -94,6 +117,8 @@ enum {
 #define F_GETFL 3
 #define F_SETFL 4
 #define F_ISTTY 5
+#define F_GETPIPE_SZ 1032
+#define F_SETPIPE_SZ 1031
 
 #define FD_CLOEXEC 1
 
@@ -130,6 +155,9 @@ enum {
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
+#define FUTEX_TRYLOCK_PI 8
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
@@ -139,6 +167,11 @@ enum {
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+// The value of a priority inheritance futex is the TID of the thread owning it, or 0.
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_OWNER_DIED 0x40000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 #define S_IFMT 0170000
 #define S_IFDIR 0040000
 #define S_IFCHR 0020000
@@ -466,6 +499,37 @@ struct pollfd {
     short revents;
 };
 
+#define EPOLLIN 0x001u
+#define EPOLLPRI 0x002u
+#define EPOLLOUT 0x004u
+#define EPOLLERR 0x008u
+#define EPOLLHUP 0x010u
+#define EPOLLRDHUP 0x2000u
+#define EPOLLONESHOT (1u << 30)
+#define EPOLLET (1u << 31)
+
+#define SPLICE_F_MOVE 1
+#define SPLICE_F_NONBLOCK 2
+#define SPLICE_F_MORE 4
+
+#define EPOLL_CTL_ADD 1
+#define EPOLL_CTL_DEL 2
+#define EPOLL_CTL_MOD 3
+
+#define EPOLL_CLOEXEC O_CLOEXEC
+
+typedef union epoll_data {
+    void* ptr;
+    int fd;
+    uint32_t u32;
+    uint64_t u64;
+} epoll_data_t;
+
+struct epoll_event {
+    uint32_t events;
+    epoll_data_t data;
+};
+
 #define AF_MASK 0xff
 #define AF_UNSPEC 0
 #define AF_LOCAL 1
@@ -516,6 +580,8 @@ enum {
 
 #define IP_TTL 2
 
+#define TCP_NODELAY 10
+
 struct ucred {
     pid_t pid;
     uid_t uid;
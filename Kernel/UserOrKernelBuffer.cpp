@@ -41,6 +41,22 @@ bool UserOrKernelBuffer::write(const void* src, size_t offset, size_t len)
     return true;
 }
 
+bool UserOrKernelBuffer::write(Span<const ReadonlyBytes> sources)
+{
+    if (!m_buffer)
+        return false;
+
+    if (is_user_address(VirtualAddress(m_buffer)))
+        return copy_to_user(m_buffer, sources);
+
+    u8* dest = m_buffer;
+    for (auto& source : sources) {
+        memcpy(dest, source.data(), source.size());
+        dest += source.size();
+    }
+    return true;
+}
+
 bool UserOrKernelBuffer::read(void* dest, size_t offset, size_t len) const
 {
     if (!m_buffer)
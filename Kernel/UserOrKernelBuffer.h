@@ -64,6 +64,7 @@ public:
     {
         return write(bytes.data(), bytes.size());
     }
+    [[nodiscard]] bool write(Span<const ReadonlyBytes> sources);
 
     [[nodiscard]] bool read(void* dest, size_t offset, size_t len) const;
     [[nodiscard]] bool read(void* dest, size_t len) const
@@ -125,6 +125,7 @@ AnonymousVMObject::AnonymousVMObject(const AnonymousVMObject& other)
     , m_volatile_ranges_cache({ 0, page_count() }) // do *not* clone this
     , m_volatile_ranges_cache_dirty(true)          // do *not* clone this
     , m_purgeable_ranges()                         // do *not* clone this
+    , m_compressed_pages(other.m_compressed_pages) // compressed data is immutable, so it can be shared
     , m_unused_committed_pages(other.m_unused_committed_pages)
     , m_cow_map()                                                      // do *not* clone this
     , m_shared_committed_cow_pages(other.m_shared_committed_cow_pages) // share the pool
@@ -162,15 +163,15 @@ AnonymousVMObject::~AnonymousVMObject()
 int AnonymousVMObject::purge()
 {
     LOCKER(m_paging_lock);
-    return purge_impl();
+    return purge_impl(NumericLimits<size_t>::max());
 }
 
-int AnonymousVMObject::purge_with_interrupts_disabled(Badge<MemoryManager>)
+int AnonymousVMObject::purge_with_interrupts_disabled(Badge<MemoryManager>, size_t max_page_count)
 {
     VERIFY_INTERRUPTS_DISABLED();
     if (m_paging_lock.is_locked())
         return 0;
-    return purge_impl();
+    return purge_impl(max_page_count);
 }
 
 void AnonymousVMObject::set_was_purged(const VolatilePageRange& range)
@@ -180,48 +181,63 @@ void AnonymousVMObject::set_was_purged(const VolatilePageRange& range)
         purgeable_ranges->set_was_purged(range);
 }
 
-int AnonymousVMObject::purge_impl()
+int AnonymousVMObject::purge_impl(size_t max_page_count)
 {
-    int purged_page_count = 0;
+    struct PurgedRange {
+        VolatilePageRange range;
+        int page_count;
+    };
+    Vector<PurgedRange, 8> purged_ranges;
+    size_t purged_page_count = 0;
+
     ScopedSpinLock lock(m_lock);
     for_each_volatile_range([&](const auto& range) {
         int purged_in_range = 0;
         auto range_end = range.base + range.count;
-        for (size_t i = range.base; i < range_end; i++) {
+        size_t i = range.base;
+        for (; i < range_end && purged_page_count < max_page_count; i++) {
             auto& phys_page = m_physical_pages[i];
-            if (phys_page && !phys_page->is_shared_zero_page()) {
+            if (phys_page && phys_page->is_compressed_page()) {
+                // There's no physical page to gain here, but the contents are gone all the same.
+                m_compressed_pages.remove(i);
+            } else if (phys_page && !phys_page->is_shared_zero_page()) {
                 VERIFY(!phys_page->is_lazy_committed_page());
                 ++purged_in_range;
+                ++purged_page_count;
             }
             phys_page = MM.shared_zero_page();
         }
+        if (purged_in_range > 0)
+            purged_ranges.append({ { range.base, i - range.base }, purged_in_range });
+        return purged_page_count < max_page_count ? IterationDecision::Continue : IterationDecision::Break;
+    });
 
-        if (purged_in_range > 0) {
-            purged_page_count += purged_in_range;
-            set_was_purged(range);
-            for_each_region([&](auto& region) {
-                if (&region.vmobject() == this) {
-                    if (auto owner = region.get_owner()) {
-                        // we need to hold a reference the process here (if there is one) as we may not own this region
-                        dmesgln("Purged {} pages from region {} owned by {} at {} - {}",
-                            purged_in_range,
-                            region.name(),
-                            *owner,
-                            region.vaddr_from_page_index(range.base),
-                            region.vaddr_from_page_index(range.base + range.count));
-                    } else {
-                        dmesgln("Purged {} pages from region {} (no ownership) at {} - {}",
-                            purged_in_range,
-                            region.name(),
-                            region.vaddr_from_page_index(range.base),
-                            region.vaddr_from_page_index(range.base + range.count));
-                    }
-                    region.remap_vmobject_page_range(range.base, range.count);
+    // Marking ranges as purged may split or merge the ranges we were just iterating over,
+    // so we do it only after we're done with them.
+    for (auto& purged : purged_ranges) {
+        auto& range = purged.range;
+        set_was_purged(range);
+        for_each_region([&](auto& region) {
+            if (&region.vmobject() == this) {
+                if (auto owner = region.get_owner()) {
+                    // we need to hold a reference the process here (if there is one) as we may not own this region
+                    dmesgln("Purged {} pages from region {} owned by {} at {} - {}",
+                        purged.page_count,
+                        region.name(),
+                        *owner,
+                        region.vaddr_from_page_index(range.base),
+                        region.vaddr_from_page_index(range.base + range.count));
+                } else {
+                    dmesgln("Purged {} pages from region {} (no ownership) at {} - {}",
+                        purged.page_count,
+                        region.name(),
+                        region.vaddr_from_page_index(range.base),
+                        region.vaddr_from_page_index(range.base + range.count));
                 }
-            });
-        }
-        return IterationDecision::Continue;
-    });
+                region.remap_vmobject_page_range(range.base, range.count);
+            }
+        });
+    }
     return purged_page_count;
 }
 
@@ -257,6 +273,123 @@ bool AnonymousVMObject::is_any_volatile() const
     return false;
 }
 
+bool AnonymousVMObject::compress_page(Badge<Region>, size_t page_index)
+{
+    VERIFY(m_lock.is_locked());
+    auto& page_slot = m_physical_pages[page_index];
+    if (!page_slot || page_slot->is_shared_zero_page() || page_slot->is_lazy_committed_page() || page_slot->is_compressed_page())
+        return false;
+    // Anything else holding on to the page (like a COW sibling) might still be using it.
+    if (page_slot->ref_count() != 1 || !page_slot->is_pool_user_page())
+        return false;
+    // Volatile memory should be purged instead, that's way cheaper.
+    if (!is_nonvolatile(page_index))
+        return false;
+
+    u8* page_data = MM.quickmap_page(*page_slot);
+    bool is_all_zeroes = true;
+    for (size_t i = 0; i < PAGE_SIZE / sizeof(FlatPtr); ++i) {
+        if (reinterpret_cast<const FlatPtr*>(page_data)[i] != 0) {
+            is_all_zeroes = false;
+            break;
+        }
+    }
+    RefPtr<CompressedPage> compressed_page;
+    if (!is_all_zeroes)
+        compressed_page = CompressedPage::try_create(page_data);
+    MM.unquickmap_page();
+
+    if (is_all_zeroes) {
+        page_slot = MM.shared_zero_page();
+        return true;
+    }
+    if (!compressed_page)
+        return false;
+    m_compressed_pages.set(page_index, compressed_page.release_nonnull());
+    page_slot = MM.compressed_page();
+    return true;
+}
+
+bool AnonymousVMObject::decompress_page(size_t page_index)
+{
+    // Allocating may have to purge volatile memory, which takes m_lock, so get the page first.
+    auto page = MM.allocate_user_physical_page(MemoryManager::ShouldZeroFill::No);
+    if (!page)
+        return false;
+
+    ScopedSpinLock lock(m_lock);
+    auto& page_slot = m_physical_pages[page_index];
+    if (!page_slot->is_compressed_page()) {
+        // Someone else got here first.
+        return true;
+    }
+    auto it = m_compressed_pages.find(page_index);
+    VERIFY(it != m_compressed_pages.end());
+    u8* page_data = MM.quickmap_page(*page);
+    it->value->decompress_into(page_data);
+    MM.unquickmap_page();
+    m_compressed_pages.remove(it);
+    page_slot = page.release_nonnull();
+    return true;
+}
+
+bool AnonymousVMObject::move_to_contiguous_pages(size_t first_page_index, size_t page_count, size_t physical_alignment)
+{
+    VERIFY(first_page_index + page_count <= this->page_count());
+    if (is_any_volatile())
+        return false;
+
+    auto new_pages = MM.allocate_contiguous_user_physical_pages(page_count * PAGE_SIZE, physical_alignment);
+    if (new_pages.is_empty())
+        return false;
+
+    ScopedSpinLock lock(m_lock);
+    for (size_t i = first_page_index; i < first_page_index + page_count; ++i) {
+        // Pages shared with a COW sibling have to stay where they are.
+        if (!m_cow_map.is_null() && m_cow_map.get(i))
+            return false;
+    }
+
+    size_t consumed_committed_pages = 0;
+    u8 page_buffer[PAGE_SIZE];
+    for (size_t i = 0; i < page_count; ++i) {
+        auto& old_page = m_physical_pages[first_page_index + i];
+        auto& new_page = new_pages[i];
+        bool has_contents = old_page && !old_page->is_shared_zero_page() && !old_page->is_lazy_committed_page();
+        if (has_contents && old_page->is_compressed_page()) {
+            auto it = m_compressed_pages.find(first_page_index + i);
+            VERIFY(it != m_compressed_pages.end());
+            it->value->decompress_into(page_buffer);
+            m_compressed_pages.remove(it);
+        } else if (has_contents) {
+            u8* src = MM.quickmap_page(*old_page);
+            memcpy(page_buffer, src, PAGE_SIZE);
+            MM.unquickmap_page();
+        } else if (old_page && old_page->is_lazy_committed_page()) {
+            ++consumed_committed_pages;
+        }
+        u8* dest = MM.quickmap_page(new_page);
+        if (has_contents)
+            memcpy(dest, page_buffer, PAGE_SIZE);
+        else
+            memset(dest, 0, PAGE_SIZE);
+        MM.unquickmap_page();
+        old_page = new_page;
+    }
+
+    if (consumed_committed_pages > 0) {
+        VERIFY(m_unused_committed_pages >= consumed_committed_pages);
+        m_unused_committed_pages -= consumed_committed_pages;
+        MM.uncommit_user_physical_pages(consumed_committed_pages);
+    }
+
+    for_each_region([&](auto& region) {
+        if (&region.vmobject() == this)
+            region.remap_vmobject_page_range(first_page_index, page_count);
+    });
+    return true;
+}
+
 size_t AnonymousVMObject::remove_lazy_commit_pages(const VolatilePageRange& range)
 {
     VERIFY(m_lock.is_locked());
@@ -294,6 +427,9 @@ void AnonymousVMObject::range_made_volatile(const VolatilePageRange& range)
 {
     VERIFY(m_lock.is_locked());
 
+    static Atomic<u64> s_next_volatile_sequence { 1 };
+    m_volatile_sequence = s_next_volatile_sequence.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+
     if (m_unused_committed_pages == 0)
         return;
 
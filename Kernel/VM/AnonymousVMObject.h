@@ -6,8 +6,10 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <Kernel/PhysicalAddress.h>
 #include <Kernel/VM/AllocationStrategy.h>
+#include <Kernel/VM/CompressedPage.h>
 #include <Kernel/VM/PageFaultResponse.h>
 #include <Kernel/VM/PurgeablePageRanges.h>
 #include <Kernel/VM/VMObject.h>
@@ -36,10 +38,26 @@ public:
     void unregister_purgeable_page_ranges(PurgeablePageRanges&);
 
     int purge();
-    int purge_with_interrupts_disabled(Badge<MemoryManager>);
+    int purge_with_interrupts_disabled(Badge<MemoryManager>, size_t max_page_count);
 
     bool is_any_volatile() const;
 
+    // Increases every time a range of this VMObject is made volatile, across all VMObjects.
+    // The MemoryManager purges the VMObjects with the lowest sequence first, since those
+    // hold the memory that has been sitting unused for the longest. Zero if never volatile.
+    u64 volatile_sequence() const { return m_volatile_sequence.load(AK::MemoryOrder::memory_order_relaxed); }
+
+    // Swaps the page out for a compressed copy of its contents (or for the shared zero page,
+    // if that's all it contains). Only pages that no one else holds on to are eligible.
+    bool compress_page(Badge<Region>, size_t page_index);
+    // Brings a compressed page back into physical memory. Returns false if we're out of pages.
+    bool decompress_page(size_t page_index);
+    size_t compressed_page_count() const { return m_compressed_pages.size(); }
+
+    // Replaces the physical pages backing the given range with a physically
+    // contiguous run, copying over any existing contents.
+    bool move_to_contiguous_pages(size_t first_page_index, size_t page_count, size_t physical_alignment);
+
     template<typename F>
     IterationDecision for_each_volatile_range(F f) const
     {
@@ -105,7 +123,7 @@ private:
 
     virtual const char* class_name() const override { return "AnonymousVMObject"; }
 
-    int purge_impl();
+    int purge_impl(size_t max_page_count);
     void update_volatile_cache();
     void set_was_purged(const VolatilePageRange&);
     size_t remove_lazy_commit_pages(const VolatilePageRange&);
@@ -127,6 +145,8 @@ private:
     VolatilePageRanges m_volatile_ranges_cache;
     bool m_volatile_ranges_cache_dirty { true };
     Vector<PurgeablePageRanges*> m_purgeable_ranges;
+    Atomic<u64> m_volatile_sequence { 0 };
+    HashMap<size_t, NonnullRefPtr<CompressedPage>> m_compressed_pages;
     size_t m_unused_committed_pages { 0 };
 
     Bitmap m_cow_map;
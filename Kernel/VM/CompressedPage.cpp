@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Memory.h>
+#include <Kernel/Heap/kmalloc.h>
+#include <Kernel/SpinLock.h>
+#include <Kernel/StdLib.h>
+#include <Kernel/VM/CompressedPage.h>
+
+namespace Kernel {
+
+// Pages that don't shrink to at most this size are left alone, as storing them would barely save anything.
+static constexpr size_t max_compressed_size = PAGE_SIZE * 3 / 4;
+// Leave this much of the kernel heap alone, so that compressing pages never starves everything else.
+static constexpr size_t kmalloc_reserve = 2 * MiB;
+
+static constexpr size_t min_match_length = 4;
+static constexpr size_t hash_bits = 12;
+
+static Atomic<size_t> s_stored_page_count;
+static Atomic<size_t> s_stored_byte_count;
+static Atomic<size_t> s_compression_count;
+static Atomic<size_t> s_decompression_count;
+static Atomic<size_t> s_rejection_count;
+
+// Pages are compressed one at a time, so we keep the scratch space around instead of putting it on the stack.
+static SpinLock<u8> s_compression_lock;
+static u16 s_hash_table[1 << hash_bits];
+static u8 s_compression_buffer[max_compressed_size];
+
+ALWAYS_INLINE static u32 read_u32(const u8* data)
+{
+    u32 value;
+    __builtin_memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+// Each sequence is a token byte (literal length in the high nibble, match length minus 4 in the
+// low nibble, 15 meaning "more length bytes follow"), the literals, a 16-bit little-endian match
+// offset and any extra match length bytes. The last sequence has literals only.
+static size_t compress(const u8* input, size_t input_size, u8* output, size_t output_capacity)
+{
+    __builtin_memset(s_hash_table, 0, sizeof(s_hash_table));
+
+    size_t in = 0;
+    size_t anchor = 0;
+    size_t out = 0;
+
+    auto emit_extra_length = [&](size_t length) {
+        while (length >= 255) {
+            if (out >= output_capacity)
+                return false;
+            output[out++] = 255;
+            length -= 255;
+        }
+        if (out >= output_capacity)
+            return false;
+        output[out++] = length;
+        return true;
+    };
+
+    auto emit_sequence = [&](size_t match_offset, size_t match_length) {
+        size_t literal_length = in - anchor;
+        if (out >= output_capacity)
+            return false;
+        size_t token_position = out++;
+        u8 token = min(literal_length, (size_t)15) << 4;
+        if (literal_length >= 15 && !emit_extra_length(literal_length - 15))
+            return false;
+        if (out + literal_length > output_capacity)
+            return false;
+        __builtin_memcpy(output + out, input + anchor, literal_length);
+        out += literal_length;
+        if (match_length > 0) {
+            size_t extra_match_length = match_length - min_match_length;
+            token |= min(extra_match_length, (size_t)15);
+            if (out + 2 > output_capacity)
+                return false;
+            output[out++] = match_offset & 0xff;
+            output[out++] = match_offset >> 8;
+            if (extra_match_length >= 15 && !emit_extra_length(extra_match_length - 15))
+                return false;
+        }
+        output[token_position] = token;
+        return true;
+    };
+
+    while (in + min_match_length <= input_size) {
+        u32 sequence = read_u32(input + in);
+        u32 hash = (sequence * 2654435761u) >> (32 - hash_bits);
+        // Positions are stored off by one, so that zero can mean "nothing here yet".
+        size_t candidate = s_hash_table[hash];
+        s_hash_table[hash] = in + 1;
+        if (candidate == 0 || read_u32(input + candidate - 1) != sequence) {
+            ++in;
+            continue;
+        }
+        size_t match_position = candidate - 1;
+        size_t match_length = min_match_length;
+        while (in + match_length < input_size && input[match_position + match_length] == input[in + match_length])
+            ++match_length;
+        if (!emit_sequence(in - match_position, match_length))
+            return 0;
+        in += match_length;
+        anchor = in;
+    }
+
+    in = input_size;
+    if (!emit_sequence(0, 0))
+        return 0;
+    return out;
+}
+
+static bool decompress(const u8* input, size_t input_size, u8* output, size_t output_size)
+{
+    size_t in = 0;
+    size_t out = 0;
+
+    auto read_extra_length = [&](size_t& length) {
+        u8 byte;
+        do {
+            if (in >= input_size)
+                return false;
+            byte = input[in++];
+            length += byte;
+        } while (byte == 255);
+        return true;
+    };
+
+    while (in < input_size) {
+        u8 token = input[in++];
+        size_t literal_length = token >> 4;
+        if (literal_length == 15 && !read_extra_length(literal_length))
+            return false;
+        if (in + literal_length > input_size || out + literal_length > output_size)
+            return false;
+        __builtin_memcpy(output + out, input + in, literal_length);
+        in += literal_length;
+        out += literal_length;
+        if (in == input_size)
+            break;
+
+        if (in + 2 > input_size)
+            return false;
+        size_t match_offset = input[in] | (input[in + 1] << 8);
+        in += 2;
+        size_t match_length = token & 0xf;
+        if (match_length == 15 && !read_extra_length(match_length))
+            return false;
+        match_length += min_match_length;
+        if (match_offset == 0 || match_offset > out || out + match_length > output_size)
+            return false;
+        // Matches may overlap the bytes they produce, so this has to go byte by byte.
+        for (size_t i = 0; i < match_length; ++i, ++out)
+            output[out] = output[out - match_offset];
+    }
+    return out == output_size;
+}
+
+CompressedPage::CompressedPage(size_t size)
+    : m_size(size)
+{
+    ++s_stored_page_count;
+    s_stored_byte_count += size;
+}
+
+CompressedPage::~CompressedPage()
+{
+    --s_stored_page_count;
+    s_stored_byte_count -= m_size;
+}
+
+void CompressedPage::operator delete(void* ptr)
+{
+    kfree(ptr);
+}
+
+RefPtr<CompressedPage> CompressedPage::try_create(const u8* page_data)
+{
+    ScopedSpinLock lock(s_compression_lock);
+    size_t size = compress(page_data, PAGE_SIZE, s_compression_buffer, sizeof(s_compression_buffer));
+    if (size == 0) {
+        ++s_rejection_count;
+        return {};
+    }
+
+    kmalloc_stats stats;
+    get_kmalloc_stats(stats);
+    if (stats.bytes_free < kmalloc_reserve + size) {
+        ++s_rejection_count;
+        return {};
+    }
+
+    auto* slot = kmalloc(sizeof(CompressedPage) + size);
+    auto* page = new (slot) CompressedPage(size);
+    __builtin_memcpy(page->m_data, s_compression_buffer, size);
+    ++s_compression_count;
+    return adopt_ref(*page);
+}
+
+void CompressedPage::decompress_into(u8* page_data) const
+{
+    // We produced this data ourselves, so failing to decompress it means something scribbled over it.
+    bool success = decompress(m_data, m_size, page_data, PAGE_SIZE);
+    VERIFY(success);
+    ++s_decompression_count;
+}
+
+size_t CompressedPage::stored_page_count() { return s_stored_page_count; }
+size_t CompressedPage::stored_byte_count() { return s_stored_byte_count; }
+size_t CompressedPage::compression_count() { return s_compression_count; }
+size_t CompressedPage::decompression_count() { return s_decompression_count; }
+size_t CompressedPage::rejection_count() { return s_rejection_count; }
+
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+// The contents of an anonymous page that was evicted from physical memory by compressing it
+// into the kernel heap. Compression uses a small LZ77 variant tuned for speed over ratio:
+// it only needs to beat the 4 KiB the page was taking up, and it runs in the page fault path.
+// The data is immutable, so forked VMObjects simply share it.
+class CompressedPage : public RefCounted<CompressedPage> {
+    AK_MAKE_NONCOPYABLE(CompressedPage);
+    AK_MAKE_NONMOVABLE(CompressedPage);
+
+public:
+    // Returns null if the page doesn't compress well enough to be worth keeping,
+    // or if the kernel heap is too tight to hold it.
+    static RefPtr<CompressedPage> try_create(const u8* page_data);
+    ~CompressedPage();
+
+    void operator delete(void*);
+
+    void decompress_into(u8* page_data) const;
+
+    size_t size() const { return m_size; }
+
+    static size_t stored_page_count();
+    static size_t stored_byte_count();
+    static size_t compression_count();
+    static size_t decompression_count();
+    static size_t rejection_count();
+
+private:
+    explicit CompressedPage(size_t size);
+
+    u16 m_size { 0 };
+    u8 m_data[0];
+};
+
+}
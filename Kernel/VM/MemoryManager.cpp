@@ -14,9 +14,11 @@
 #include <Kernel/Multiboot.h>
 #include <Kernel/Process.h>
 #include <Kernel/StdLib.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/ContiguousVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
+#include <Kernel/VM/MemoryPressureWatcher.h>
 #include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/PhysicalRegion.h>
 #include <Kernel/VM/SharedInodeVMObject.h>
@@ -64,8 +66,8 @@ UNMAP_AFTER_INIT MemoryManager::MemoryManager()
     write_cr3(kernel_page_directory().cr3());
     protect_kernel_image();
 
-    // We're temporarily "committing" to two pages that we need to allocate below
-    if (!commit_user_physical_pages(2))
+    // We're temporarily "committing" to three pages that we need to allocate below
+    if (!commit_user_physical_pages(3))
         VERIFY_NOT_REACHED();
 
     m_shared_zero_page = allocate_committed_user_physical_page();
@@ -77,6 +79,9 @@ UNMAP_AFTER_INIT MemoryManager::MemoryManager()
     // By using a tag we don't have to query the VMObject for every page
     // whether it was committed or not
     m_lazy_committed_page = allocate_committed_user_physical_page();
+
+    // Same thing here: this tags pages whose contents are stored compressed by their AnonymousVMObject.
+    m_compressed_page = allocate_committed_user_physical_page();
 }
 
 UNMAP_AFTER_INIT MemoryManager::~MemoryManager()
@@ -306,6 +311,11 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(const_cast<PageDirectory&>(page_directory), page_directory_table_index);
+    if (pd[page_directory_index].is_huge()) {
+        if (!split_large_page(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
     const PageDirectoryEntry& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
@@ -323,6 +333,11 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    if (pd[page_directory_index].is_huge()) {
+        if (!split_large_page(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (!pde.is_present()) {
         bool did_purge = false;
@@ -364,6 +379,12 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     u32 page_table_index = (vaddr.get() >> 12) & 0x1ff;
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    if (pd[page_directory_index].is_huge()) {
+        // FIXME: If we can't get a page table here, we leave the whole large page mapped.
+        if (!split_large_page(page_directory, vaddr))
+            return;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+    }
     PageDirectoryEntry& pde = pd[page_directory_index];
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
@@ -390,6 +411,84 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool user_allowed, bool executable, bool cacheable)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(page_directory.get_lock().own_lock());
+    VERIFY(!(vaddr.get() % large_page_size));
+    VERIFY(!(paddr.get() % large_page_size));
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x3;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    PageDirectoryEntry& pde = pd[page_directory_index];
+    if (pde.is_present() && !pde.is_huge()) {
+        // The page table that used to map this range is not needed anymore.
+        auto result = page_directory.m_page_tables.remove(vaddr.get() & ~0x1fffff);
+        VERIFY(result);
+    }
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_present(true);
+    pde.set_writable(writable);
+    pde.set_user_allowed(user_allowed);
+    pde.set_cache_disabled(!cacheable);
+    if (Processor::current().has_feature(CPUFeature::NX))
+        pde.set_execute_disabled(!executable);
+    return true;
+}
+
+bool MemoryManager::split_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(page_directory.get_lock().own_lock());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x3;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+    auto large_page_vaddr = VirtualAddress(vaddr.get() & ~0x1fffff);
+
+    auto page_table = allocate_user_physical_page(ShouldZeroFill::Yes);
+    if (!page_table) {
+        dbgln("MM: Unable to allocate page table to split large page at {}", large_page_vaddr);
+        return false;
+    }
+
+    // NOTE: Allocating the page table may have purged memory, which may in turn have
+    //       split this large page already. So look it up again only now.
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    PageDirectoryEntry& pde = pd[page_directory_index];
+    if (!pde.is_huge())
+        return true;
+
+    FlatPtr base = (FlatPtr)pde.page_table_base();
+    auto* pt = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        auto& pte = pt[i];
+        pte.set_physical_page_base(base + i * PAGE_SIZE);
+        pte.set_present(true);
+        pte.set_writable(pde.is_writable());
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_cache_disabled(pde.is_cache_disabled());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+    }
+
+    // The page directory entry now only points at the page table, so the individual
+    // page table entries decide about permissions, just like in ensure_pte().
+    pde.clear();
+    pde.set_page_table_base(page_table->paddr().get());
+    pde.set_user_allowed(true);
+    pde.set_present(true);
+    pde.set_writable(true);
+    auto result = page_directory.m_page_tables.set(large_page_vaddr.get(), move(page_table));
+    VERIFY(result == AK::HashSetResult::InsertedNewEntry);
+
+    flush_tlb(&page_directory, large_page_vaddr, pages_per_large_page);
+    return true;
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     auto mm_data = new MemoryManagerData;
@@ -529,6 +628,8 @@ bool MemoryManager::commit_user_physical_pages(size_t page_count)
 {
     VERIFY(page_count > 0);
     ScopedSpinLock lock(s_mm_lock);
+    if (m_user_physical_pages_uncommitted < page_count)
+        drain_zeroed_page_caches();
     if (m_user_physical_pages_uncommitted < page_count)
         return false;
 
@@ -561,6 +662,10 @@ void MemoryManager::deallocate_user_physical_page(const PhysicalPage& page)
         // committed and allocated are only freed upon request. Once
         // returned there is no guarantee being able to get them back.
         ++m_user_physical_pages_uncommitted;
+
+        update_memory_pressure(false);
+        lock.unlock();
+        notify_memory_pressure_if_changed();
         return;
     }
 
@@ -593,8 +698,109 @@ RefPtr<PhysicalPage> MemoryManager::find_free_user_physical_page(bool committed)
     return page;
 }
 
+RefPtr<PhysicalPage> MemoryManager::take_zeroed_page_from_cache()
+{
+    RefPtr<PhysicalPage> page;
+    bool should_refill = false;
+    {
+        ScopedCritical critical;
+        auto cpu = Processor::id();
+        if (cpu >= max_zeroed_page_cache_processors)
+            return {};
+        auto& cache = m_zeroed_page_caches[cpu];
+        ScopedSpinLock lock(cache.lock);
+        if (cache.count > 0)
+            page = move(cache.pages[--cache.count]);
+        should_refill = cache.count < zeroed_page_cache_low_watermark;
+    }
+    if (should_refill)
+        PageZeroingTask::wake();
+    return page;
+}
+
+void MemoryManager::drain_zeroed_page_caches()
+{
+    // NOTE: The pages are released after dropping each cache lock, since
+    //       returning them to the freelist takes s_mm_lock.
+    for (auto& cache : m_zeroed_page_caches) {
+        RefPtr<PhysicalPage> pages[zeroed_page_cache_capacity];
+        size_t count = 0;
+        {
+            ScopedSpinLock lock(cache.lock);
+            while (cache.count > 0)
+                pages[count++] = move(cache.pages[--cache.count]);
+        }
+    }
+}
+
+void MemoryManager::refill_zeroed_page_caches()
+{
+    // Always leave some pages that nobody has spoken for yet.
+    static constexpr size_t reserved_page_count = 1024;
+
+    auto processor_count = min((size_t)Processor::count(), max_zeroed_page_cache_processors);
+    for (size_t cpu = 0; cpu < processor_count; ++cpu) {
+        auto& cache = m_zeroed_page_caches[cpu];
+        size_t wanted;
+        {
+            ScopedSpinLock lock(cache.lock);
+            if (cache.count >= zeroed_page_cache_low_watermark)
+                continue;
+            wanted = zeroed_page_cache_capacity - cache.count;
+        }
+
+        RefPtr<PhysicalPage> pages[zeroed_page_cache_capacity];
+        size_t count = 0;
+        {
+            ScopedSpinLock lock(s_mm_lock);
+            while (count < wanted && m_user_physical_pages_uncommitted > reserved_page_count) {
+                auto page = find_free_user_physical_page(false);
+                if (!page)
+                    break;
+                pages[count++] = move(page);
+            }
+        }
+        if (count == 0)
+            continue;
+
+        for (size_t i = 0; i < count; ++i) {
+            InterruptDisabler disabler;
+            auto* ptr = quickmap_page(*pages[i]);
+            memset(ptr, 0, PAGE_SIZE);
+            unquickmap_page();
+        }
+
+        {
+            ScopedSpinLock lock(cache.lock);
+            // Somebody may have drained the cache in the meantime, so only
+            // fill it up to capacity and let the rest go back to the freelist below.
+            for (size_t i = 0; i < count && cache.count < zeroed_page_cache_capacity; ++i)
+                cache.pages[cache.count++] = move(pages[i]);
+        }
+    }
+}
+
+size_t MemoryManager::zeroed_page_cache_count() const
+{
+    size_t count = 0;
+    for (auto& cache : m_zeroed_page_caches)
+        count += cache.count;
+    return count;
+}
+
 NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page(ShouldZeroFill should_zero_fill)
 {
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        if (auto page = take_zeroed_page_from_cache()) {
+            // The cached page came out of the uncommitted pool, so we swap one
+            // committed page for it instead.
+            VERIFY(m_user_physical_pages_committed > 0);
+            m_user_physical_pages_committed--;
+            m_user_physical_pages_uncommitted++;
+            return page.release_nonnull();
+        }
+    }
+
     ScopedSpinLock lock(s_mm_lock);
     auto page = find_free_user_physical_page(true);
     if (should_zero_fill == ShouldZeroFill::Yes) {
@@ -605,30 +811,117 @@ NonnullRefPtr<PhysicalPage> MemoryManager::allocate_committed_user_physical_page
     return page.release_nonnull();
 }
 
+size_t MemoryManager::purge_volatile_pages(size_t target_page_count)
+{
+    VERIFY(s_mm_lock.is_locked());
+    size_t purged_page_count = 0;
+    u64 last_sequence = 0;
+    while (purged_page_count < target_page_count) {
+        // Find the VMObject that was made volatile the longest time ago, among the ones we haven't tried yet.
+        AnonymousVMObject* oldest = nullptr;
+        u64 oldest_sequence = 0;
+        for_each_vmobject([&](auto& vmobject) {
+            if (!vmobject.is_anonymous())
+                return IterationDecision::Continue;
+            auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject);
+            auto sequence = anonymous_vmobject.volatile_sequence();
+            if (sequence <= last_sequence)
+                return IterationDecision::Continue;
+            if (!oldest || sequence < oldest_sequence) {
+                oldest = &anonymous_vmobject;
+                oldest_sequence = sequence;
+            }
+            return IterationDecision::Continue;
+        });
+        if (!oldest)
+            break;
+        last_sequence = oldest_sequence;
+        int purged = oldest->purge_with_interrupts_disabled({}, target_page_count - purged_page_count);
+        if (purged > 0) {
+            dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged);
+            purged_page_count += purged;
+        }
+    }
+    return purged_page_count;
+}
+
+size_t MemoryManager::compress_cold_pages(size_t max_page_count)
+{
+    ScopedSpinLock lock(s_mm_lock);
+    size_t compressed_page_count = 0;
+    for (auto& region : m_user_regions) {
+        if (!region.vmobject().is_anonymous() || region.is_shared() || region.vmobject().is_shared_by_multiple_regions())
+            continue;
+        compressed_page_count += region.compress_cold_pages(max_page_count - compressed_page_count);
+    }
+    return compressed_page_count;
+}
+
+void MemoryManager::update_memory_pressure(bool had_to_purge)
+{
+    VERIFY(s_mm_lock.is_locked());
+    size_t total = m_user_physical_pages;
+    size_t available = m_user_physical_pages_uncommitted;
+
+    u32 level = m_memory_pressure_level;
+    if (had_to_purge || available < total / 32)
+        level = MEMORY_PRESSURE_CRITICAL;
+    else if (available < total / 16)
+        level = max(level, (u32)MEMORY_PRESSURE_LOW);
+    else if (available > total / 8)
+        level = MEMORY_PRESSURE_NORMAL;
+    else if (level == MEMORY_PRESSURE_CRITICAL)
+        level = MEMORY_PRESSURE_LOW;
+    // Otherwise we stay at whatever level we were at, so we don't flap around a single threshold.
+
+    if (m_memory_pressure_level.exchange(level) != level)
+        m_memory_pressure_changed = true;
+}
+
+void MemoryManager::notify_memory_pressure_if_changed()
+{
+    // Pages can be freed while we're still nested inside another MM operation (e.g. while purging),
+    // and waking up watchers has no business happening under s_mm_lock. The outermost caller will
+    // pick up the change once it has let go of the lock.
+    if (s_mm_lock.own_lock())
+        return;
+    if (m_memory_pressure_changed.exchange(false))
+        MemoryPressureWatcher::notify_all({});
+}
+
 RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
+    if (should_zero_fill == ShouldZeroFill::Yes) {
+        if (auto page = take_zeroed_page_from_cache()) {
+            if (did_purge)
+                *did_purge = false;
+            return page;
+        }
+    }
+
     ScopedSpinLock lock(s_mm_lock);
     auto page = find_free_user_physical_page(false);
     bool purged_pages = false;
 
+    if (!page) {
+        // Pages sitting in the zeroed page caches are still up for grabs.
+        drain_zeroed_page_caches();
+        page = find_free_user_physical_page(false);
+    }
+
     if (!page) {
         // We didn't have a single free physical page. Let's try to free something up!
-        // First, we look for a purgeable VMObject in the volatile state.
-        for_each_vmobject([&](auto& vmobject) {
-            if (!vmobject.is_anonymous())
-                return IterationDecision::Continue;
-            int purged_page_count = static_cast<AnonymousVMObject&>(vmobject).purge_with_interrupts_disabled({});
-            if (purged_page_count) {
-                dbgln("MM: Purge saved the day! Purged {} pages from AnonymousVMObject", purged_page_count);
-                page = find_free_user_physical_page(false);
-                purged_pages = true;
-                VERIFY(page);
-                return IterationDecision::Break;
-            }
-            return IterationDecision::Continue;
-        });
+        // Purge a batch of volatile memory, so that the next few allocations don't end up here again.
+        if (purge_volatile_pages(purge_batch_page_count) > 0) {
+            page = find_free_user_physical_page(false);
+            purged_pages = true;
+            VERIFY(page);
+        }
         if (!page) {
+            update_memory_pressure(true);
+            lock.unlock();
             dmesgln("MM: no user physical pages available");
+            notify_memory_pressure_if_changed();
             return {};
         }
     }
@@ -639,6 +932,10 @@ RefPtr<PhysicalPage> MemoryManager::allocate_user_physical_page(ShouldZeroFill s
         unquickmap_page();
     }
 
+    update_memory_pressure(purged_pages);
+    lock.unlock();
+    notify_memory_pressure_if_changed();
+
     if (did_purge)
         *did_purge = purged_pages;
     return page;
@@ -672,7 +969,7 @@ NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_contiguous_supervisor_
     for (auto& region : m_super_physical_regions) {
         physical_pages = region.take_contiguous_free_pages(count, true, physical_alignment);
         if (!physical_pages.is_empty())
-            continue;
+            break;
     }
 
     if (physical_pages.is_empty()) {
@@ -691,6 +988,29 @@ NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_contiguous_supervisor_
     return physical_pages;
 }
 
+NonnullRefPtrVector<PhysicalPage> MemoryManager::allocate_contiguous_user_physical_pages(size_t size, size_t physical_alignment)
+{
+    VERIFY(!(size % PAGE_SIZE));
+    ScopedSpinLock lock(s_mm_lock);
+    size_t count = ceil_div(size, static_cast<size_t>(PAGE_SIZE));
+    // NOTE: Unlike allocate_user_physical_page(), this doesn't try to purge anything, and simply fails instead.
+    if (m_user_physical_pages_uncommitted < count)
+        return {};
+
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    for (auto& region : m_user_physical_regions) {
+        physical_pages = region.take_contiguous_free_pages(count, false, physical_alignment);
+        if (!physical_pages.is_empty())
+            break;
+    }
+    if (physical_pages.is_empty())
+        return {};
+
+    m_user_physical_pages_uncommitted -= count;
+    m_user_physical_pages_used += count;
+    return physical_pages;
+}
+
 RefPtr<PhysicalPage> MemoryManager::allocate_supervisor_physical_page()
 {
     ScopedSpinLock lock(s_mm_lock);
@@ -729,6 +1049,8 @@ void MemoryManager::enter_space(Space& space)
     ScopedSpinLock lock(s_mm_lock);
 
     current_thread->tss().cr3 = space.page_directory().cr3();
+    current_thread->set_active_page_directory(space.page_directory());
+    space.page_directory().set_active_on_processor(Processor::id());
     write_cr3(space.page_directory().cr3());
 }
 
@@ -12,6 +12,7 @@
 #include <Kernel/Arch/x86/CPU.h>
 #include <Kernel/Forward.h>
 #include <Kernel/SpinLock.h>
+#include <Kernel/UnixTypes.h>
 #include <Kernel/VM/AllocationStrategy.h>
 #include <Kernel/VM/PhysicalPage.h>
 #include <Kernel/VM/Region.h>
@@ -105,6 +106,8 @@ class MemoryManager {
     friend class AnonymousVMObject;
     friend class Region;
     friend class ScatterGatherList;
+    friend class TLBShootdownBatch;
+    friend class TmpFSInode;
     friend class VMObject;
 
 public:
@@ -135,15 +138,24 @@ public:
         Yes
     };
 
+    // With PAE paging, a single page directory entry maps 2 MiB.
+    static constexpr size_t large_page_size = 2 * MiB;
+    static constexpr size_t pages_per_large_page = large_page_size / PAGE_SIZE;
+
     bool commit_user_physical_pages(size_t);
     void uncommit_user_physical_pages(size_t);
     NonnullRefPtr<PhysicalPage> allocate_committed_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes);
     RefPtr<PhysicalPage> allocate_user_physical_page(ShouldZeroFill = ShouldZeroFill::Yes, bool* did_purge = nullptr);
     RefPtr<PhysicalPage> allocate_supervisor_physical_page();
     NonnullRefPtrVector<PhysicalPage> allocate_contiguous_supervisor_physical_pages(size_t size, size_t physical_alignment = PAGE_SIZE);
+    NonnullRefPtrVector<PhysicalPage> allocate_contiguous_user_physical_pages(size_t size, size_t physical_alignment = PAGE_SIZE);
     void deallocate_user_physical_page(const PhysicalPage&);
     void deallocate_supervisor_physical_page(const PhysicalPage&);
 
+    // Called by the PageZeroingTask to top up the per-processor caches of pre-zeroed pages.
+    void refill_zeroed_page_caches();
+    size_t zeroed_page_cache_count() const;
+
     OwnPtr<Region> allocate_contiguous_kernel_region(size_t, String name, Region::Access access, size_t physical_alignment = PAGE_SIZE, Region::Cacheable = Region::Cacheable::Yes);
     OwnPtr<Region> allocate_kernel_region(size_t, String name, Region::Access access, AllocationStrategy strategy = AllocationStrategy::Reserve, Region::Cacheable = Region::Cacheable::Yes);
     OwnPtr<Region> allocate_kernel_region(PhysicalAddress, size_t, String name, Region::Access access, Region::Cacheable = Region::Cacheable::Yes);
@@ -156,6 +168,9 @@ public:
     unsigned user_physical_pages_committed() const { return m_user_physical_pages_committed; }
     unsigned user_physical_pages_uncommitted() const { return m_user_physical_pages_uncommitted; }
     unsigned super_physical_pages() const { return m_super_physical_pages; }
+
+    // One of the MEMORY_PRESSURE_* levels.
+    u32 memory_pressure_level() const { return m_memory_pressure_level; }
     unsigned super_physical_pages_used() const { return m_super_physical_pages_used; }
 
     template<typename Callback>
@@ -174,6 +189,11 @@ public:
 
     PhysicalPage& shared_zero_page() { return *m_shared_zero_page; }
     PhysicalPage& lazy_committed_page() { return *m_lazy_committed_page; }
+    PhysicalPage& compressed_page() { return *m_compressed_page; }
+
+    // Compresses anonymous pages that haven't been touched since the last call, and
+    // clears the accessed bits of the ones that have. Returns the number of pages freed.
+    size_t compress_cold_pages(size_t max_page_count);
 
     PageDirectory& kernel_page_directory() { return *m_kernel_page_directory; }
 
@@ -201,6 +221,11 @@ private:
     static Region* find_region_from_vaddr(VirtualAddress);
 
     RefPtr<PhysicalPage> find_free_user_physical_page(bool);
+    size_t purge_volatile_pages(size_t target_page_count);
+    void update_memory_pressure(bool had_to_purge);
+    void notify_memory_pressure_if_changed();
+    RefPtr<PhysicalPage> take_zeroed_page_from_cache();
+    void drain_zeroed_page_caches();
     u8* quickmap_page(PhysicalPage&);
     void unquickmap_page();
 
@@ -208,6 +233,8 @@ private:
     PageTableEntry* quickmap_pt(PhysicalAddress);
 
     PageTableEntry* pte(PageDirectory&, VirtualAddress);
+    bool map_large_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool user_allowed, bool executable, bool cacheable);
+    bool split_large_page(PageDirectory&, VirtualAddress);
     PageTableEntry* ensure_pte(PageDirectory&, VirtualAddress);
     void release_pte(PageDirectory&, VirtualAddress, bool);
 
@@ -215,6 +242,7 @@ private:
 
     RefPtr<PhysicalPage> m_shared_zero_page;
     RefPtr<PhysicalPage> m_lazy_committed_page;
+    RefPtr<PhysicalPage> m_compressed_page;
 
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_user_physical_pages { 0 };
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_user_physical_pages_used { 0 };
@@ -223,6 +251,23 @@ private:
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_super_physical_pages { 0 };
     Atomic<unsigned, AK::MemoryOrder::memory_order_relaxed> m_super_physical_pages_used { 0 };
 
+    static constexpr size_t purge_batch_page_count = 64;
+    Atomic<u32> m_memory_pressure_level { MEMORY_PRESSURE_NORMAL };
+    Atomic<bool> m_memory_pressure_changed { false };
+
+    // Each processor keeps a few pages that have already been zeroed in the background,
+    // so that anonymous page faults neither have to zero the page inline nor take s_mm_lock.
+    // Cached pages are accounted as allocated from the uncommitted pool.
+    static constexpr size_t max_zeroed_page_cache_processors = 32;
+    static constexpr size_t zeroed_page_cache_capacity = 64;
+    static constexpr size_t zeroed_page_cache_low_watermark = 16;
+    struct ZeroedPageCache {
+        SpinLock<u8> lock;
+        RefPtr<PhysicalPage> pages[zeroed_page_cache_capacity];
+        size_t count { 0 };
+    };
+    ZeroedPageCache m_zeroed_page_caches[max_zeroed_page_cache_processors];
+
     NonnullRefPtrVector<PhysicalRegion> m_user_physical_regions;
     NonnullRefPtrVector<PhysicalRegion> m_super_physical_regions;
 
@@ -278,4 +323,9 @@ inline bool PhysicalPage::is_lazy_committed_page() const
     return this == &MM.lazy_committed_page();
 }
 
+inline bool PhysicalPage::is_compressed_page() const
+{
+    return this == &MM.compressed_page();
+}
+
 }
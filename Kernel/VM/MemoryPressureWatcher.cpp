@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/SpinLock.h>
+#include <Kernel/UnixTypes.h>
+#include <Kernel/VM/MemoryManager.h>
+#include <Kernel/VM/MemoryPressureWatcher.h>
+
+namespace Kernel {
+
+static SpinLock<u8> s_watchers_lock;
+static AK::Singleton<MemoryPressureWatcher::List> s_watchers;
+
+NonnullRefPtr<MemoryPressureWatcher> MemoryPressureWatcher::create()
+{
+    return adopt_ref(*new MemoryPressureWatcher);
+}
+
+MemoryPressureWatcher::MemoryPressureWatcher()
+{
+    ScopedSpinLock lock(s_watchers_lock);
+    s_watchers->append(*this);
+}
+
+MemoryPressureWatcher::~MemoryPressureWatcher()
+{
+    ScopedSpinLock lock(s_watchers_lock);
+    s_watchers->remove(*this);
+}
+
+bool MemoryPressureWatcher::can_read(const FileDescription&, size_t) const
+{
+    return m_last_reported_level != MM.memory_pressure_level();
+}
+
+KResultOr<size_t> MemoryPressureWatcher::read(FileDescription&, u64, UserOrKernelBuffer& buffer, size_t buffer_size)
+{
+    u32 level = MM.memory_pressure_level();
+    if (buffer_size < sizeof(level))
+        return EINVAL;
+    if (!buffer.write(&level, sizeof(level)))
+        return EFAULT;
+    m_last_reported_level = level;
+    return sizeof(level);
+}
+
+void MemoryPressureWatcher::notify_all(Badge<MemoryManager>)
+{
+    ScopedSpinLock lock(s_watchers_lock);
+    for (auto& watcher : *s_watchers)
+        watcher.evaluate_block_conditions();
+}
+
+}
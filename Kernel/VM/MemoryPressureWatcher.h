@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Badge.h>
+#include <AK/IntrusiveList.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/UnixTypes.h>
+
+namespace Kernel {
+
+// Becomes readable whenever the system memory pressure level changes. Each read returns
+// the current MEMORY_PRESSURE_* level as a u32, so services can drop their caches before
+// the kernel has to start purging volatile memory (or fail allocations) on their behalf.
+class MemoryPressureWatcher final : public File {
+public:
+    static NonnullRefPtr<MemoryPressureWatcher> create();
+    virtual ~MemoryPressureWatcher() override;
+
+    virtual bool can_read(const FileDescription&, size_t) const override;
+    virtual bool can_write(const FileDescription&, size_t) const override { return false; }
+    virtual KResultOr<size_t> read(FileDescription&, u64, UserOrKernelBuffer&, size_t) override;
+    virtual KResultOr<size_t> write(FileDescription&, u64, const UserOrKernelBuffer&, size_t) override { return EIO; }
+    virtual String absolute_path(const FileDescription&) const override { return "MemoryPressureWatcher"; }
+    virtual const char* class_name() const override { return "MemoryPressureWatcher"; }
+
+    static void notify_all(Badge<MemoryManager>);
+
+private:
+    MemoryPressureWatcher();
+
+    IntrusiveListNode<MemoryPressureWatcher> m_list_node;
+    Atomic<u32> m_last_reported_level { MEMORY_PRESSURE_NORMAL };
+
+public:
+    using List = IntrusiveList<MemoryPressureWatcher, RawPtr<MemoryPressureWatcher>, &MemoryPressureWatcher::m_list_node>;
+};
+
+}
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/HashMap.h>
 #include <AK/RefCounted.h>
 #include <AK/RefPtr.h>
@@ -48,6 +49,23 @@ public:
 
     RecursiveSpinLock& get_lock() { return m_lock; }
 
+    // A bit is set for every processor that may have this page directory loaded,
+    // so that TLB shootdowns only need to interrupt those. Bits are set when a
+    // processor switches to this page directory, and only cleared lazily once a
+    // shootdown finds that the processor has moved on.
+    u32 active_processors() const { return m_active_processors.load(AK::MemoryOrder::memory_order_acquire); }
+    void set_active_on_processor(u32 cpu) const
+    {
+        u32 bit = cpu < 32 ? 1u << cpu : 0xffffffff;
+        if ((m_active_processors.load(AK::MemoryOrder::memory_order_relaxed) & bit) != bit)
+            m_active_processors.fetch_or(bit, AK::MemoryOrder::memory_order_acq_rel);
+    }
+    void clear_active_on_processor(u32 cpu) const
+    {
+        if (cpu < 32)
+            m_active_processors.fetch_and(~(1u << cpu), AK::MemoryOrder::memory_order_acq_rel);
+    }
+
 private:
     explicit PageDirectory(const RangeAllocator* parent_range_allocator);
     PageDirectory();
@@ -59,6 +77,7 @@ private:
     RefPtr<PhysicalPage> m_directory_pages[4];
     HashMap<u32, RefPtr<PhysicalPage>> m_page_tables;
     RecursiveSpinLock m_lock;
+    mutable Atomic<u32> m_active_processors { 0 };
     bool m_valid { false };
 };
 
@@ -45,6 +45,11 @@ public:
 
     bool is_shared_zero_page() const;
     bool is_lazy_committed_page() const;
+    bool is_compressed_page() const;
+
+    // Whether this page came from (and goes back to) the general pool of user physical pages,
+    // as opposed to e.g. device memory that was mapped into a VMObject.
+    bool is_pool_user_page() const { return m_may_return_to_freelist && !m_supervisor; }
 
 private:
     PhysicalPage(PhysicalAddress paddr, bool supervisor, bool may_return_to_freelist = true);
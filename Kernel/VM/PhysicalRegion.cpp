@@ -39,99 +39,141 @@ unsigned PhysicalRegion::finalize_capacity()
     VERIFY(!m_pages);
 
     m_pages = (m_upper.get() - m_lower.get()) / PAGE_SIZE;
-    m_bitmap.grow(m_pages, false);
+
+    // Pick the smallest tree whose naturally aligned span covers the whole region,
+    // so that a block of order N is always aligned to 2^N pages physically as well.
+    auto first_page = m_lower.get() / PAGE_SIZE;
+    m_tree_height = 1;
+    for (;;) {
+        m_base_page = first_page & ~(leaf_count() - 1);
+        if (m_base_page + leaf_count() >= first_page + m_pages)
+            break;
+        ++m_tree_height;
+    }
+
+    // Pages in the tree's span that aren't part of this region are permanently "in use".
+    m_bitmap.grow(leaf_count(), true);
+    if (m_pages)
+        m_bitmap.set_range<false>(first_page - m_base_page, m_pages);
+    m_tree.resize(leaf_count());
+    update_tree(0, leaf_count());
 
     return size();
 }
 
-NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(size_t count, bool supervisor, size_t physical_alignment)
+u8 PhysicalRegion::node_value(size_t node) const
 {
-    VERIFY(m_pages);
-    VERIFY(m_used != m_pages);
+    if (node >= leaf_count())
+        return m_bitmap.get(node - leaf_count()) ? 0 : 1;
+    return m_tree[node];
+}
 
-    NonnullRefPtrVector<PhysicalPage> physical_pages;
-    physical_pages.ensure_capacity(count);
+void PhysicalRegion::update_tree(size_t first_leaf, size_t count)
+{
+    VERIFY(count != 0);
+    auto first_node = first_leaf + leaf_count();
+    auto last_node = first_node + count - 1;
+    for (unsigned level = 1; level <= m_tree_height; ++level) {
+        first_node >>= 1;
+        last_node >>= 1;
+        for (auto node = first_node; node <= last_node; ++node) {
+            auto left = node_value(node * 2);
+            auto right = node_value(node * 2 + 1);
+            // Children at level - 1 are entirely free when their value is level.
+            if (left == level && right == level)
+                m_tree[node] = level + 1;
+            else
+                m_tree[node] = max(left, right);
+        }
+    }
+}
 
-    auto first_contiguous_page = find_contiguous_free_pages(count, physical_alignment);
+Optional<unsigned> PhysicalRegion::allocate_block(unsigned order)
+{
+    if (order > m_tree_height || node_value(1) < order + 1)
+        return {};
 
-    for (size_t index = 0; index < count; index++)
-        physical_pages.append(PhysicalPage::create(m_lower.offset(PAGE_SIZE * (index + first_contiguous_page)), supervisor));
-    return physical_pages;
+    size_t node = 1;
+    for (auto level = m_tree_height; level > order; --level) {
+        node *= 2;
+        if (node_value(node) < order + 1)
+            ++node;
+    }
+
+    size_t first_leaf = (node << order) - leaf_count();
+    size_t block_size = (size_t)1 << order;
+    VERIFY(first_leaf + block_size <= leaf_count());
+    m_bitmap.set_range<true>(first_leaf, block_size);
+    update_tree(first_leaf, block_size);
+    return first_leaf;
 }
 
-unsigned PhysicalRegion::find_contiguous_free_pages(size_t count, size_t physical_alignment)
+NonnullRefPtrVector<PhysicalPage> PhysicalRegion::take_contiguous_free_pages(size_t count, bool supervisor, size_t physical_alignment)
 {
+    VERIFY(m_pages);
     VERIFY(count != 0);
     VERIFY(physical_alignment % PAGE_SIZE == 0);
-    // search from the last page we allocated
-    auto range = find_and_allocate_contiguous_range(count, physical_alignment / PAGE_SIZE);
-    VERIFY(range.has_value());
-    return range.value();
+    VERIFY(__builtin_popcountl(physical_alignment) == 1);
+    if (m_pages - m_used < count)
+        return {};
+
+    unsigned order = 0;
+    while (((size_t)1 << order) < max(count, physical_alignment / PAGE_SIZE))
+        ++order;
+
+    auto first_leaf = allocate_block(order);
+    if (!first_leaf.has_value())
+        return {};
+
+    // Hand back the tail of the block that we don't need.
+    size_t block_size = (size_t)1 << order;
+    if (block_size > count) {
+        m_bitmap.set_range<false>(first_leaf.value() + count, block_size - count);
+        update_tree(first_leaf.value() + count, block_size - count);
+    }
+    m_used += count;
+
+    NonnullRefPtrVector<PhysicalPage> physical_pages;
+    physical_pages.ensure_capacity(count);
+    for (size_t index = 0; index < count; index++)
+        physical_pages.append(PhysicalPage::create(PhysicalAddress((m_base_page + first_leaf.value() + index) * PAGE_SIZE), supervisor));
+    return physical_pages;
 }
 
 Optional<unsigned> PhysicalRegion::find_one_free_page()
 {
     if (m_used == m_pages) {
-        // We know we don't have any free pages, no need to check the bitmap
+        // We know we don't have any free pages, no need to check the tree
         // Check if we can draw one from the return queue
         if (m_recently_returned.size() > 0) {
             u8 index = get_fast_random<u8>() % m_recently_returned.size();
             Checked<FlatPtr> local_offset = m_recently_returned[index].get();
             local_offset -= m_lower.get();
-            m_recently_returned.remove(index);
             VERIFY(!local_offset.has_overflow());
             VERIFY(local_offset.value() < (FlatPtr)(m_pages * PAGE_SIZE));
-            return local_offset.value() / PAGE_SIZE;
+            auto leaf = m_recently_returned[index].get() / PAGE_SIZE - m_base_page;
+            m_recently_returned.remove(index);
+            return leaf;
         }
         return {};
     }
-    auto free_index = m_bitmap.find_one_anywhere_unset(m_free_hint);
-    if (!free_index.has_value())
-        return {};
-
-    auto page_index = free_index.value();
-    m_bitmap.set(page_index, true);
-    m_used++;
-    m_free_hint = free_index.value() + 1; // Just a guess
-    if (m_free_hint >= m_bitmap.size())
-        m_free_hint = 0;
-    return page_index;
-}
 
-Optional<unsigned> PhysicalRegion::find_and_allocate_contiguous_range(size_t count, unsigned alignment)
-{
-    VERIFY(count != 0);
-    size_t found_pages_count = 0;
-    // TODO: Improve how we deal with alignment != 1
-    auto first_index = m_bitmap.find_longest_range_of_unset_bits(count + alignment - 1, found_pages_count);
-    if (!first_index.has_value())
+    auto leaf = allocate_block(0);
+    if (!leaf.has_value())
         return {};
-
-    auto page = first_index.value();
-    if (alignment != 1) {
-        auto lower_page = m_lower.get() / PAGE_SIZE;
-        page = ((lower_page + page + alignment - 1) & ~(alignment - 1)) - lower_page;
-    }
-    if (found_pages_count >= count) {
-        m_bitmap.set_range<true>(page, count);
-        m_used += count;
-        m_free_hint = first_index.value() + count + 1; // Just a guess
-        if (m_free_hint >= m_bitmap.size())
-            m_free_hint = 0;
-        return page;
-    }
-    return {};
+    m_used++;
+    return leaf;
 }
 
 RefPtr<PhysicalPage> PhysicalRegion::take_free_page(bool supervisor)
 {
     VERIFY(m_pages);
 
-    auto free_index = find_one_free_page();
-    if (!free_index.has_value())
+    auto free_leaf = find_one_free_page();
+    if (!free_leaf.has_value())
         return nullptr;
 
-    return PhysicalPage::create(m_lower.offset(free_index.value() * PAGE_SIZE), supervisor);
+    return PhysicalPage::create(PhysicalAddress((m_base_page + free_leaf.value()) * PAGE_SIZE), supervisor);
 }
 
 void PhysicalRegion::free_page_at(PhysicalAddress addr)
@@ -147,9 +189,10 @@ void PhysicalRegion::free_page_at(PhysicalAddress addr)
     VERIFY(!local_offset.has_overflow());
     VERIFY(local_offset.value() < (FlatPtr)(m_pages * PAGE_SIZE));
 
-    auto page = local_offset.value() / PAGE_SIZE;
-    m_bitmap.set(page, false);
-    m_free_hint = page; // We know we can find one here for sure
+    auto leaf = addr.get() / PAGE_SIZE - m_base_page;
+    VERIFY(m_bitmap.get(leaf));
+    m_bitmap.set(leaf, false);
+    update_tree(leaf, 1);
     m_used--;
 }
 
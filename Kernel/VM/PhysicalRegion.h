@@ -10,6 +10,7 @@
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/Optional.h>
 #include <AK/RefCounted.h>
+#include <AK/Vector.h>
 #include <Kernel/VM/PhysicalPage.h>
 
 namespace Kernel {
@@ -36,10 +37,17 @@ public:
     void return_page(const PhysicalPage& page);
 
 private:
-    unsigned find_contiguous_free_pages(size_t count, size_t physical_alignment = PAGE_SIZE);
-    Optional<unsigned> find_and_allocate_contiguous_range(size_t count, unsigned alignment = 1);
+    // Free pages are tracked by a buddy allocator laid out as an implicit binary tree
+    // over the (power-of-two sized) range of pages starting at m_base_page.
+    // Every internal node stores 1 + the order of the largest free block below it,
+    // or 0 if there is none. The leaves live in m_bitmap (a set bit means the page is
+    // in use), which also lets us catch double frees.
+    Optional<unsigned> allocate_block(unsigned order);
     Optional<unsigned> find_one_free_page();
     void free_page_at(PhysicalAddress addr);
+    void update_tree(size_t first_leaf, size_t count);
+    u8 node_value(size_t node) const;
+    size_t leaf_count() const { return (size_t)1 << m_tree_height; }
 
     PhysicalRegion(PhysicalAddress lower, PhysicalAddress upper);
 
@@ -48,7 +56,9 @@ private:
     unsigned m_pages { 0 };
     unsigned m_used { 0 };
     Bitmap m_bitmap;
-    size_t m_free_hint { 0 };
+    Vector<u8> m_tree;
+    size_t m_base_page { 0 };
+    unsigned m_tree_height { 0 };
     Vector<PhysicalAddress, 256> m_recently_returned;
 };
 
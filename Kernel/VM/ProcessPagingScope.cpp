@@ -5,6 +5,7 @@
  */
 
 #include <Kernel/VM/MemoryManager.h>
+#include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/ProcessPagingScope.h>
 
 namespace Kernel {
@@ -13,6 +14,7 @@ ProcessPagingScope::ProcessPagingScope(Process& process)
 {
     VERIFY(Thread::current() != nullptr);
     m_previous_cr3 = read_cr3();
+    m_previous_page_directory = Thread::current()->active_page_directory();
     MM.enter_process_paging_scope(process);
 }
 
@@ -20,6 +22,10 @@ ProcessPagingScope::~ProcessPagingScope()
 {
     InterruptDisabler disabler;
     Thread::current()->tss().cr3 = m_previous_cr3;
+    if (m_previous_page_directory) {
+        Thread::current()->set_active_page_directory(*m_previous_page_directory);
+        m_previous_page_directory->set_active_on_processor(Processor::id());
+    }
     write_cr3(m_previous_cr3);
 }
 
@@ -4,9 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/BinarySearch.h>
 #include <AK/Checked.h>
-#include <AK/QuickSort.h>
 #include <Kernel/Random.h>
 #include <Kernel/Thread.h>
 #include <Kernel/VM/RangeAllocator.h>
@@ -15,6 +13,104 @@
 
 namespace Kernel {
 
+static void update_largest_size_in_subtree(AvailableRangeTree::Node& node)
+{
+    auto largest_size = node.size;
+    if (auto* left_child = static_cast<AvailableRangeTree::Node*>(node.left_child))
+        largest_size = max(largest_size, left_child->largest_size_in_subtree);
+    if (auto* right_child = static_cast<AvailableRangeTree::Node*>(node.right_child))
+        largest_size = max(largest_size, right_child->largest_size_in_subtree);
+    node.largest_size_in_subtree = largest_size;
+}
+
+void AvailableRangeTree::subtree_did_change(BaseRedBlackTree::Node* node)
+{
+    update_largest_size_in_subtree(static_cast<Node&>(*node));
+}
+
+void AvailableRangeTree::node_did_change(Node& node)
+{
+    for (auto* ancestor = &node; ancestor; ancestor = static_cast<Node*>(ancestor->parent))
+        update_largest_size_in_subtree(*ancestor);
+}
+
+void AvailableRangeTree::insert(const Range& range)
+{
+    auto* node = new Node(range);
+    BaseRedBlackTree::insert(node);
+    node_did_change(*node);
+}
+
+void AvailableRangeTree::remove(Node& node)
+{
+    BaseRedBlackTree::remove(&node);
+    // The node's parent is now where it was taken out of the tree, so everything above that has lost a range.
+    auto* parent = static_cast<Node*>(node.parent);
+    delete &node;
+    if (parent)
+        node_did_change(*parent);
+    if (is_empty())
+        m_minimum = nullptr;
+}
+
+AvailableRangeTree::Node* AvailableRangeTree::find_lowest_with_size_at_least(size_t size)
+{
+    auto* node = static_cast<Node*>(m_root);
+    if (!node || node->largest_size_in_subtree < size)
+        return nullptr;
+    for (;;) {
+        auto* left_child = static_cast<Node*>(node->left_child);
+        if (left_child && left_child->largest_size_in_subtree >= size) {
+            node = left_child;
+            continue;
+        }
+        if (node->size >= size)
+            return node;
+        node = static_cast<Node*>(node->right_child);
+        VERIFY(node && node->largest_size_in_subtree >= size);
+    }
+}
+
+static void delete_subtree(AvailableRangeTree::Node* node)
+{
+    if (!node)
+        return;
+    delete_subtree(static_cast<AvailableRangeTree::Node*>(node->left_child));
+    delete_subtree(static_cast<AvailableRangeTree::Node*>(node->right_child));
+    delete node;
+}
+
+void AvailableRangeTree::clear()
+{
+    delete_subtree(static_cast<Node*>(m_root));
+    m_root = nullptr;
+    m_minimum = nullptr;
+    m_size = 0;
+}
+
+static AvailableRangeTree::Node* clone_subtree(const AvailableRangeTree::Node* node, AvailableRangeTree::Node* parent)
+{
+    if (!node)
+        return nullptr;
+    auto* clone = new AvailableRangeTree::Node(node->range());
+    clone->color = node->color;
+    clone->largest_size_in_subtree = node->largest_size_in_subtree;
+    clone->parent = parent;
+    clone->left_child = clone_subtree(static_cast<const AvailableRangeTree::Node*>(node->left_child), clone);
+    clone->right_child = clone_subtree(static_cast<const AvailableRangeTree::Node*>(node->right_child), clone);
+    return clone;
+}
+
+void AvailableRangeTree::clone_from(const AvailableRangeTree& other)
+{
+    clear();
+    m_root = clone_subtree(static_cast<const Node*>(other.m_root), nullptr);
+    m_size = other.m_size;
+    m_minimum = m_root;
+    while (m_minimum && m_minimum->left_child)
+        m_minimum = m_minimum->left_child;
+}
+
 RangeAllocator::RangeAllocator()
     : m_total_range({}, 0)
 {
@@ -23,14 +119,14 @@ RangeAllocator::RangeAllocator()
 void RangeAllocator::initialize_with_range(VirtualAddress base, size_t size)
 {
     m_total_range = { base, size };
-    m_available_ranges.append({ base, size });
+    m_available_ranges.insert({ base, size });
 }
 
 void RangeAllocator::initialize_from_parent(const RangeAllocator& parent_allocator)
 {
     ScopedSpinLock lock(parent_allocator.m_lock);
     m_total_range = parent_allocator.m_total_range;
-    m_available_ranges = parent_allocator.m_available_ranges;
+    m_available_ranges.clone_from(parent_allocator.m_available_ranges);
 }
 
 RangeAllocator::~RangeAllocator()
@@ -41,21 +137,28 @@ void RangeAllocator::dump() const
 {
     VERIFY(m_lock.is_locked());
     dbgln("RangeAllocator({})", this);
-    for (auto& range : m_available_ranges) {
+    for (auto* node = const_cast<AvailableRangeTree&>(m_available_ranges).first(); node; node = AvailableRangeTree::next(*node)) {
+        auto range = node->range();
         dbgln("    {:x} -> {:x}", range.base().get(), range.end().get() - 1);
     }
 }
 
-void RangeAllocator::carve_at_index(int index, const Range& range)
+void RangeAllocator::carve(AvailableRangeTree::Node& node, const Range& range)
 {
     VERIFY(m_lock.is_locked());
-    auto remaining_parts = m_available_ranges[index].carve(range);
-    VERIFY(remaining_parts.size() >= 1);
+    auto remaining_parts = node.range().carve(range);
+    if (remaining_parts.is_empty()) {
+        m_available_ranges.remove(node);
+        return;
+    }
     VERIFY(m_total_range.contains(remaining_parts[0]));
-    m_available_ranges[index] = remaining_parts[0];
+    // The first remaining part is still where the node was, so it can stay in its place in the tree.
+    node.key = remaining_parts[0].base().get();
+    node.size = remaining_parts[0].size();
+    m_available_ranges.node_did_change(node);
     if (remaining_parts.size() == 2) {
         VERIFY(m_total_range.contains(remaining_parts[1]));
-        m_available_ranges.insert(index + 1, move(remaining_parts[1]));
+        m_available_ranges.insert(remaining_parts[1]);
     }
 }
 
@@ -107,27 +210,20 @@ Optional<Range> RangeAllocator::allocate_anywhere(size_t size, size_t alignment)
         return {};
 
     ScopedSpinLock lock(m_lock);
-    for (size_t i = 0; i < m_available_ranges.size(); ++i) {
-        auto& available_range = m_available_ranges[i];
-        // FIXME: This check is probably excluding some valid candidates when using a large alignment.
-        if (available_range.size() < (effective_size + alignment))
-            continue;
-
-        FlatPtr initial_base = available_range.base().offset(offset_from_effective_base).get();
-        FlatPtr aligned_base = round_up_to_power_of_two(initial_base, alignment);
+    // FIXME: This size is probably excluding some valid candidates when using a large alignment.
+    auto* node = m_available_ranges.find_lowest_with_size_at_least(effective_size + alignment);
+    if (!node) {
+        dmesgln("RangeAllocator: Failed to allocate anywhere: size={}, alignment={}", size, alignment);
+        return {};
+    }
 
-        Range allocated_range(VirtualAddress(aligned_base), size);
-        VERIFY(m_total_range.contains(allocated_range));
+    FlatPtr initial_base = node->range().base().offset(offset_from_effective_base).get();
+    FlatPtr aligned_base = round_up_to_power_of_two(initial_base, alignment);
 
-        if (available_range == allocated_range) {
-            m_available_ranges.remove(i);
-            return allocated_range;
-        }
-        carve_at_index(i, allocated_range);
-        return allocated_range;
-    }
-    dmesgln("RangeAllocator: Failed to allocate anywhere: size={}, alignment={}", size, alignment);
-    return {};
+    Range allocated_range(VirtualAddress(aligned_base), size);
+    VERIFY(m_total_range.contains(allocated_range));
+    carve(*node, allocated_range);
+    return allocated_range;
 }
 
 Optional<Range> RangeAllocator::allocate_specific(VirtualAddress base, size_t size)
@@ -140,19 +236,12 @@ Optional<Range> RangeAllocator::allocate_specific(VirtualAddress base, size_t si
 
     Range allocated_range(base, size);
     ScopedSpinLock lock(m_lock);
-    for (size_t i = 0; i < m_available_ranges.size(); ++i) {
-        auto& available_range = m_available_ranges[i];
-        VERIFY(m_total_range.contains(allocated_range));
-        if (!available_range.contains(base, size))
-            continue;
-        if (available_range == allocated_range) {
-            m_available_ranges.remove(i);
-            return allocated_range;
-        }
-        carve_at_index(i, allocated_range);
-        return allocated_range;
-    }
-    return {};
+    VERIFY(m_total_range.contains(allocated_range));
+    auto* node = m_available_ranges.find_largest_not_above(base.get());
+    if (!node || !node->range().contains(base, size))
+        return {};
+    carve(*node, allocated_range);
+    return allocated_range;
 }
 
 void RangeAllocator::deallocate(const Range& range)
@@ -162,36 +251,28 @@ void RangeAllocator::deallocate(const Range& range)
     VERIFY(range.size());
     VERIFY((range.size() % PAGE_SIZE) == 0);
     VERIFY(range.base() < range.end());
-    VERIFY(!m_available_ranges.is_empty());
-
-    size_t nearby_index = 0;
-    auto* existing_range = binary_search(
-        m_available_ranges.span(),
-        range,
-        &nearby_index,
-        [](auto& a, auto& b) { return a.base().get() - b.end().get(); });
-
-    size_t inserted_index = 0;
-    if (existing_range) {
-        existing_range->m_size += range.size();
-        inserted_index = nearby_index;
-    } else {
-        m_available_ranges.insert_before_matching(
-            Range(range), [&](auto& entry) {
-                return entry.base() >= range.end();
-            },
-            nearby_index, &inserted_index);
-    }
 
-    if (inserted_index < (m_available_ranges.size() - 1)) {
-        // We already merged with previous. Try to merge with next.
-        auto& inserted_range = m_available_ranges[inserted_index];
-        auto& next_range = m_available_ranges[inserted_index + 1];
-        if (inserted_range.end() == next_range.base()) {
-            inserted_range.m_size += next_range.size();
-            m_available_ranges.remove(inserted_index + 1);
-            return;
+    auto* previous = m_available_ranges.find_largest_not_above(range.base().get());
+    auto* next = previous ? AvailableRangeTree::next(*previous) : m_available_ranges.first();
+    VERIFY(!previous || previous->range().end() <= range.base());
+    VERIFY(!next || range.end() <= next->range().base());
+
+    bool merges_with_previous = previous && previous->range().end() == range.base();
+    bool merges_with_next = next && range.end() == next->range().base();
+
+    if (merges_with_previous) {
+        previous->size += range.size();
+        if (merges_with_next) {
+            previous->size += next->size;
+            m_available_ranges.remove(*next);
         }
+        m_available_ranges.node_did_change(*previous);
+    } else if (merges_with_next) {
+        next->key = range.base().get();
+        next->size += range.size();
+        m_available_ranges.node_did_change(*next);
+    } else {
+        m_available_ranges.insert(range);
     }
 }
 
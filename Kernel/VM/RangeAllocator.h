@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/RedBlackTree.h>
 #include <AK/Traits.h>
 #include <AK/Vector.h>
 #include <Kernel/SpinLock.h>
@@ -13,6 +14,45 @@
 
 namespace Kernel {
 
+// The available ranges, ordered by base address. Every node also knows the size of the largest range in its subtree,
+// so the lowest range that's big enough for an allocation can be found without looking at all the ones before it.
+class AvailableRangeTree final : public AK::BaseRedBlackTree<FlatPtr> {
+public:
+    struct Node final : public AK::BaseRedBlackTree<FlatPtr>::Node {
+        explicit Node(const Range& range)
+            : AK::BaseRedBlackTree<FlatPtr>::Node(range.base().get())
+            , size(range.size())
+            , largest_size_in_subtree(range.size())
+        {
+        }
+
+        Range range() const { return { VirtualAddress(key), size }; }
+
+        size_t size { 0 };
+        size_t largest_size_in_subtree { 0 };
+    };
+
+    AvailableRangeTree() = default;
+    virtual ~AvailableRangeTree() override { clear(); }
+
+    void clear();
+    void clone_from(const AvailableRangeTree&);
+
+    Node* first() { return static_cast<Node*>(m_minimum); }
+    static Node* next(Node& node) { return static_cast<Node*>(successor(&node)); }
+    Node* find_largest_not_above(FlatPtr base) { return static_cast<Node*>(BaseRedBlackTree::find_largest_not_above(m_root, base)); }
+    Node* find_lowest_with_size_at_least(size_t);
+
+    void insert(const Range&);
+    void remove(Node&);
+
+    // Must be called after changing a node's range. Its base must stay between the bases of its neighbors.
+    void node_did_change(Node&);
+
+private:
+    virtual void subtree_did_change(BaseRedBlackTree::Node*) override;
+};
+
 class RangeAllocator {
 public:
     RangeAllocator();
@@ -35,9 +75,9 @@ public:
     }
 
 private:
-    void carve_at_index(int, const Range&);
+    void carve(AvailableRangeTree::Node&, const Range&);
 
-    Vector<Range> m_available_ranges;
+    AvailableRangeTree m_available_ranges;
     Range m_total_range;
     mutable SpinLock<u8> m_lock;
 };
@@ -16,6 +16,7 @@
 #include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/Region.h>
 #include <Kernel/VM/SharedInodeVMObject.h>
+#include <Kernel/VM/TLBShootdownBatch.h>
 
 namespace Kernel {
 
@@ -191,7 +192,7 @@ size_t Region::amount_resident() const
     size_t bytes = 0;
     for (size_t i = 0; i < page_count(); ++i) {
         auto* page = physical_page(i);
-        if (page && !page->is_shared_zero_page() && !page->is_lazy_committed_page())
+        if (page && !page->is_shared_zero_page() && !page->is_lazy_committed_page() && !page->is_compressed_page())
             bytes += PAGE_SIZE;
     }
     return bytes;
@@ -202,7 +203,7 @@ size_t Region::amount_shared() const
     size_t bytes = 0;
     for (size_t i = 0; i < page_count(); ++i) {
         auto* page = physical_page(i);
-        if (page && page->ref_count() > 1 && !page->is_shared_zero_page() && !page->is_lazy_committed_page())
+        if (page && page->ref_count() > 1 && !page->is_shared_zero_page() && !page->is_lazy_committed_page() && !page->is_compressed_page())
             bytes += PAGE_SIZE;
     }
     return bytes;
@@ -249,7 +250,7 @@ bool Region::map_individual_page_impl(size_t page_index)
     if (!pte)
         return false;
     auto* page = physical_page(page_index);
-    if (!page || (!is_readable() && !is_writable())) {
+    if (!page || page->is_compressed_page() || (!is_readable() && !is_writable())) {
         pte->clear();
     } else {
         pte->set_cache_disabled(!m_cacheable);
@@ -266,6 +267,56 @@ bool Region::map_individual_page_impl(size_t page_index)
     return true;
 }
 
+bool Region::can_map_large_page(size_t first_page_index) const
+{
+    auto* first_page = physical_page(first_page_index);
+    if (!first_page || first_page->paddr().get() % MemoryManager::large_page_size)
+        return false;
+    for (size_t i = 0; i < MemoryManager::pages_per_large_page; ++i) {
+        auto* page = physical_page(first_page_index + i);
+        if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page() || page->is_compressed_page() || should_cow(first_page_index + i))
+            return false;
+        if (page->paddr() != first_page->paddr().offset(i * PAGE_SIZE))
+            return false;
+    }
+    return true;
+}
+
+void Region::map_large_pages()
+{
+    VERIFY(m_page_directory->get_lock().own_lock());
+    if (!m_wants_large_pages || !vmobject().is_anonymous() || (!is_readable() && !is_writable()))
+        return;
+
+    auto first_vaddr = (vaddr().get() + MemoryManager::large_page_size - 1) & ~(MemoryManager::large_page_size - 1);
+    for (FlatPtr chunk = first_vaddr; chunk + MemoryManager::large_page_size <= vaddr().get() + size(); chunk += MemoryManager::large_page_size) {
+        auto first_page_index = page_index_from_address(VirtualAddress(chunk));
+        if (!can_map_large_page(first_page_index))
+            continue;
+        bool user_allowed = chunk >= 0x00800000 && is_user_address(VirtualAddress(chunk));
+        MM.map_large_page(*m_page_directory, VirtualAddress(chunk), physical_page(first_page_index)->paddr(), is_writable(), user_allowed, is_executable(), m_cacheable);
+    }
+}
+
+void Region::populate_large_pages()
+{
+    if (!vmobject().is_anonymous())
+        return;
+    auto& vmobject = static_cast<AnonymousVMObject&>(this->vmobject());
+    auto first_vaddr = (vaddr().get() + MemoryManager::large_page_size - 1) & ~(MemoryManager::large_page_size - 1);
+    for (FlatPtr chunk = first_vaddr; chunk + MemoryManager::large_page_size <= vaddr().get() + size(); chunk += MemoryManager::large_page_size) {
+        auto first_page_index = page_index_from_address(VirtualAddress(chunk));
+        if (can_map_large_page(first_page_index))
+            continue;
+        if (!vmobject.move_to_contiguous_pages(translate_to_vmobject_page(first_page_index), MemoryManager::pages_per_large_page, MemoryManager::large_page_size)) {
+            dbgln_if(PAGE_FAULT_DEBUG, "Region {}: Unable to back {} with a large page", name(), VirtualAddress(chunk));
+            break;
+        }
+    }
+    if (m_page_directory)
+        remap();
+}
+
 bool Region::do_remap_vmobject_page_range(size_t page_index, size_t page_count)
 {
     bool success = true;
@@ -348,7 +399,12 @@ void Region::unmap(ShouldDeallocateVirtualMemoryRange deallocate_range)
         auto vaddr = vaddr_from_page_index(i);
         MM.release_pte(*m_page_directory, vaddr, i == count - 1);
     }
-    MM.flush_tlb(m_page_directory, vaddr(), page_count());
+    if (auto* batch = TLBShootdownBatch::current_for(m_page_directory)) {
+        batch->add(vaddr(), page_count());
+        batch->retain(vmobject());
+    } else {
+        MM.flush_tlb(m_page_directory, vaddr(), page_count());
+    }
     if (deallocate_range == ShouldDeallocateVirtualMemoryRange::Yes) {
         if (m_page_directory->range_allocator().contains(range()))
             m_page_directory->range_allocator().deallocate(range());
@@ -382,14 +438,26 @@ bool Region::map(PageDirectory& page_directory, ShouldFlushTLB should_flush_tlb)
             break;
         ++page_index;
     }
+    if (page_index == page_count())
+        map_large_pages();
     if (page_index > 0) {
-        if (should_flush_tlb == ShouldFlushTLB::Yes)
-            MM.flush_tlb(m_page_directory, vaddr(), page_index);
+        if (should_flush_tlb == ShouldFlushTLB::Yes) {
+            if (auto* batch = TLBShootdownBatch::current_for(m_page_directory))
+                batch->add(vaddr(), page_index);
+            else
+                MM.flush_tlb(m_page_directory, vaddr(), page_index);
+        }
         return page_index == page_count();
     }
     return false;
 }
 
+void Region::map_lazily(PageDirectory& page_directory)
+{
+    ScopedSpinLock lock(s_mm_lock);
+    set_page_directory(page_directory);
+}
+
 void Region::remap()
 {
     VERIFY(m_page_directory);
@@ -414,12 +482,24 @@ PageFaultResponse Region::handle_fault(const PageFault& fault, ScopedSpinLock<Re
         }
 
         auto& page_slot = physical_page_slot(page_index_in_region);
+        if (page_slot->is_compressed_page()) {
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(compressed) fault in Region({})[{}]", this, page_index_in_region);
+            return handle_compressed_fault(page_index_in_region);
+        }
         if (page_slot->is_lazy_committed_page()) {
             auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
             page_slot = static_cast<AnonymousVMObject&>(*m_vmobject).allocate_committed_page(page_index_in_vmobject);
             remap_vmobject_page(page_index_in_vmobject);
             return PageFaultResponse::Continue;
         }
+        if (!page_slot.is_null()) {
+            // The page is there, it just hasn't been mapped into this region yet (see map_lazily()).
+            // If it needs to be copied or allocated, the next write will take care of that.
+            dbgln_if(PAGE_FAULT_DEBUG, "NP(lazy) fault in Region({})[{}]", this, page_index_in_region);
+            if (!remap_vmobject_page(translate_to_vmobject_page(page_index_in_region)))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
 #ifdef MAP_SHARED_ZERO_PAGE_LAZILY
         if (fault.is_read()) {
             page_slot = MM.shared_zero_page();
@@ -488,6 +568,62 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region)
     return PageFaultResponse::Continue;
 }
 
+PageFaultResponse Region::handle_compressed_fault(size_t page_index_in_region)
+{
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(vmobject().is_anonymous());
+
+    LOCKER(vmobject().m_paging_lock);
+
+    auto page_index_in_vmobject = translate_to_vmobject_page(page_index_in_region);
+    if (!static_cast<AnonymousVMObject&>(vmobject()).decompress_page(page_index_in_vmobject)) {
+        dmesgln("MM: handle_compressed_fault was unable to allocate a physical page");
+        return PageFaultResponse::OutOfMemory;
+    }
+    if (!remap_vmobject_page(page_index_in_vmobject))
+        return PageFaultResponse::OutOfMemory;
+    return PageFaultResponse::Continue;
+}
+
+size_t Region::compress_cold_pages(size_t max_page_count)
+{
+    VERIFY(s_mm_lock.own_lock());
+    VERIFY(vmobject().is_anonymous());
+    if (!m_page_directory || m_wants_large_pages)
+        return 0;
+
+    auto& vmobject = static_cast<AnonymousVMObject&>(this->vmobject());
+    // Someone is busy paging this VMObject in or out, let's not get in their way.
+    if (vmobject.m_paging_lock.is_locked())
+        return 0;
+
+    ScopedSpinLock vmobject_lock(vmobject.m_lock);
+    ScopedSpinLock page_lock(m_page_directory->get_lock());
+    size_t compressed_page_count = 0;
+    bool needs_flush = false;
+    for (size_t i = 0; i < page_count(); ++i) {
+        auto* pte = MM.pte(*m_page_directory, vaddr_from_page_index(i));
+        if (!pte || !pte->is_present())
+            continue;
+        if (pte->is_accessed()) {
+            // It was used recently, so it gets another round before we consider it cold.
+            pte->set_accessed(false);
+            needs_flush = true;
+            continue;
+        }
+        if (compressed_page_count >= max_page_count)
+            continue;
+        if (!vmobject.compress_page({}, translate_to_vmobject_page(i)))
+            continue;
+        pte->clear();
+        needs_flush = true;
+        ++compressed_page_count;
+    }
+    if (needs_flush)
+        MM.flush_tlb(m_page_directory, vaddr(), page_count());
+    return compressed_page_count;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -536,12 +672,28 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, Scoped
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
 
+    if (inode_vmobject.is_shared_inode()) {
+        // Finding the page may block, so release the MM lock temporarily.
+        mm_lock.unlock();
+        auto page = inode.page_for_shared_mapping(page_index_in_vmobject);
+        mm_lock.lock();
+        if (page) {
+            vmobject_physical_page_entry = move(page);
+            if (!remap_vmobject_page(page_index_in_vmobject))
+                return PageFaultResponse::OutOfMemory;
+            return PageFaultResponse::Continue;
+        }
+    }
+
+    u8 page_buffer[PAGE_SIZE];
+
     // Reading the page may block, so release the MM lock temporarily
     mm_lock.unlock();
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
+    if (auto request = inode_vmobject.readahead_state().will_read(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE); request.has_value())
+        inode.read_ahead(request->offset, request->size);
     auto nread = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
     mm_lock.lock();
 
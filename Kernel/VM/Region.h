@@ -203,6 +203,9 @@ public:
 
     void set_page_directory(PageDirectory&);
     bool map(PageDirectory&, ShouldFlushTLB = ShouldFlushTLB::Yes);
+    // Like map(), but leaves the page tables alone. Pages get mapped in one
+    // at a time by the page fault handler when they are first accessed.
+    void map_lazily(PageDirectory&);
     enum class ShouldDeallocateVirtualMemoryRange {
         No,
         Yes,
@@ -230,6 +233,16 @@ public:
     bool is_syscall_region() const { return m_syscall_region; }
     void set_syscall_region(bool b) { m_syscall_region = b; }
 
+    bool wants_large_pages() const { return m_wants_large_pages; }
+    void set_wants_large_pages(bool b) { m_wants_large_pages = b; }
+
+    // Moves every suitably aligned 2 MiB chunk of this region onto physically
+    // contiguous memory, so that it can be mapped with a single large page.
+    void populate_large_pages();
+
+    // See MemoryManager::compress_cold_pages().
+    size_t compress_cold_pages(size_t max_page_count);
+
 private:
     Region(const Range&, NonnullRefPtr<VMObject>, size_t offset_in_vmobject, String, Region::Access access, Cacheable, bool shared);
 
@@ -249,8 +262,11 @@ private:
     PageFaultResponse handle_cow_fault(size_t page_index);
     PageFaultResponse handle_inode_fault(size_t page_index, ScopedSpinLock<RecursiveSpinLock>&);
     PageFaultResponse handle_zero_fault(size_t page_index);
+    PageFaultResponse handle_compressed_fault(size_t page_index);
 
     bool map_individual_page_impl(size_t page_index);
+    bool can_map_large_page(size_t first_page_index) const;
+    void map_large_pages();
 
     void register_purgeable_page_ranges();
     void unregister_purgeable_page_ranges();
@@ -266,6 +282,7 @@ private:
     bool m_stack : 1 { false };
     bool m_mmap : 1 { false };
     bool m_syscall_region : 1 { false };
+    bool m_wants_large_pages : 1 { false };
     WeakPtr<Process> m_owner;
 };
 
@@ -51,6 +51,7 @@ Region& Space::allocate_split_region(const Region& source_region, const Range& r
     region.set_syscall_region(source_region.is_syscall_region());
     region.set_mmap(source_region.is_mmap());
     region.set_stack(source_region.is_stack());
+    region.set_wants_large_pages(source_region.wants_large_pages());
     size_t page_offset_in_source_region = (offset_in_vmobject - source_region.offset_in_vmobject()) / PAGE_SIZE;
     for (size_t i = 0; i < region.page_count(); ++i) {
         if (source_region.should_cow(page_offset_in_source_region + i))
@@ -101,6 +102,13 @@ bool Space::deallocate_region(Region& region)
     return take_region(region);
 }
 
+void Space::bump_regions_generation()
+{
+    // Use a global counter so that a snapshot of a previous Space (before exec) can't be mistaken for this one.
+    static Atomic<u32> s_next_generation { 1 };
+    m_regions_generation = s_next_generation.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
 OwnPtr<Region> Space::take_region(Region& region)
 {
     ScopedSpinLock lock(m_lock);
@@ -114,6 +122,7 @@ OwnPtr<Region> Space::take_region(Region& region)
         return {};
     if (found_region->ptr() != &region)
         return {};
+    bump_regions_generation();
     return m_regions.unsafe_remove(region.vaddr().get());
 }
 
@@ -172,6 +181,7 @@ Region& Space::add_region(NonnullOwnPtr<Region> region)
 {
     auto* ptr = region.ptr();
     ScopedSpinLock lock(m_lock);
+    bump_regions_generation();
     m_regions.insert(region->vaddr().get(), move(region));
     return *ptr;
 }
@@ -219,6 +229,7 @@ void Space::dump_regions()
 void Space::remove_all_regions(Badge<Process>)
 {
     ScopedSpinLock lock(m_lock);
+    bump_regions_generation();
     m_regions.clear();
 }
 
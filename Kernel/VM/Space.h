@@ -53,6 +53,10 @@ public:
 
     void remove_all_regions(Badge<Process>);
 
+    // Changes whenever a region is added or removed, so that others can tell
+    // when a snapshot of the address space layout is out of date.
+    u32 regions_generation() const { return m_regions_generation; }
+
     RecursiveSpinLock& get_lock() const { return m_lock; }
 
     size_t amount_clean_inode() const;
@@ -66,6 +70,8 @@ public:
 private:
     Space(Process&, NonnullRefPtr<PageDirectory>);
 
+    void bump_regions_generation();
+
     Process* m_process { nullptr };
     mutable RecursiveSpinLock m_lock;
 
@@ -79,6 +85,8 @@ private:
     };
     RegionLookupCache m_region_lookup_cache;
 
+    u32 m_regions_generation { 0 };
+
     bool m_enforces_syscall_regions { false };
 };
 
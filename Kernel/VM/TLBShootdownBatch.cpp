@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Thread.h>
+#include <Kernel/VM/MemoryManager.h>
+#include <Kernel/VM/TLBShootdownBatch.h>
+
+namespace Kernel {
+
+TLBShootdownBatch::TLBShootdownBatch(PageDirectory& page_directory)
+    : m_page_directory(page_directory)
+{
+    auto* current_thread = Thread::current();
+    VERIFY(current_thread);
+    m_previous_batch = current_thread->tlb_shootdown_batch();
+    current_thread->set_tlb_shootdown_batch(this);
+}
+
+TLBShootdownBatch::~TLBShootdownBatch()
+{
+    auto* current_thread = Thread::current();
+    VERIFY(current_thread->tlb_shootdown_batch() == this);
+    current_thread->set_tlb_shootdown_batch(m_previous_batch);
+
+    if (m_end > m_start) {
+        // If the collected range ends up being large, this turns into a full flush.
+        ScopedSpinLock lock(s_mm_lock);
+        MM.flush_tlb(m_page_directory.ptr(), VirtualAddress(m_start), (m_end - m_start) / PAGE_SIZE);
+    }
+    // Only now is it safe to let go of the pages that were unmapped.
+    m_retained_vmobjects.clear();
+}
+
+TLBShootdownBatch* TLBShootdownBatch::current_for(const PageDirectory* page_directory)
+{
+    auto* current_thread = Thread::current();
+    if (!current_thread)
+        return nullptr;
+    auto* batch = current_thread->tlb_shootdown_batch();
+    if (!batch || batch->m_page_directory.ptr() != page_directory)
+        return nullptr;
+    return batch;
+}
+
+void TLBShootdownBatch::add(VirtualAddress vaddr, size_t page_count)
+{
+    if (page_count == 0)
+        return;
+    auto end = vaddr.get() + page_count * PAGE_SIZE;
+    if (m_end == m_start) {
+        m_start = vaddr.get();
+        m_end = end;
+        return;
+    }
+    m_start = min(m_start, vaddr.get());
+    m_end = max(m_end, end);
+}
+
+}
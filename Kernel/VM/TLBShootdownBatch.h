@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullRefPtrVector.h>
+#include <Kernel/Forward.h>
+#include <Kernel/VM/PageDirectory.h>
+#include <Kernel/VM/VMObject.h>
+
+namespace Kernel {
+
+// While a TLBShootdownBatch is alive, Region::map() and Region::unmap() on the current
+// thread don't flush the TLB for its page directory right away. Instead, the affected
+// ranges are collected and flushed with a single shootdown when the batch goes away.
+// VMObjects that lost a mapping are kept alive until then, so that none of their
+// physical pages can be reused while another processor may still reach them.
+class TLBShootdownBatch {
+    AK_MAKE_NONCOPYABLE(TLBShootdownBatch);
+    AK_MAKE_NONMOVABLE(TLBShootdownBatch);
+
+public:
+    explicit TLBShootdownBatch(PageDirectory&);
+    ~TLBShootdownBatch();
+
+    static TLBShootdownBatch* current_for(const PageDirectory*);
+
+    void add(VirtualAddress, size_t page_count);
+    void retain(VMObject& vmobject) { m_retained_vmobjects.append(vmobject); }
+
+private:
+    NonnullRefPtr<PageDirectory> m_page_directory;
+    TLBShootdownBatch* m_previous_batch { nullptr };
+    FlatPtr m_start { 0 };
+    FlatPtr m_end { 0 };
+    NonnullRefPtrVector<VMObject, 4> m_retained_vmobjects;
+};
+
+}
@@ -6,7 +6,9 @@
 
 #include <Kernel/CommandLine.h>
 #include <Kernel/VirtIO/VirtIO.h>
+#include <Kernel/VirtIO/VirtIOBlockDevice.h>
 #include <Kernel/VirtIO/VirtIOConsole.h>
+#include <Kernel/VirtIO/VirtIONetworkAdapter.h>
 #include <Kernel/VirtIO/VirtIORNG.h>
 
 namespace Kernel {
@@ -29,6 +31,15 @@ void VirtIO::detect()
             [[maybe_unused]] auto& unused = adopt_ref(*new VirtIORNG(address)).leak_ref();
             break;
         }
+        case VIRTIO_NETWORK_PCI_DEVICE_ID:
+        case VIRTIO_NETWORK_MODERN_PCI_DEVICE_ID: {
+            [[maybe_unused]] auto& unused = adopt_ref(*new VirtIONetworkAdapter(address)).leak_ref();
+            break;
+        }
+        case VIRTIO_BLOCK_PCI_DEVICE_ID:
+        case VIRTIO_BLOCK_MODERN_PCI_DEVICE_ID:
+            // Block devices are picked up by StorageManagement, through VirtIOBlockController.
+            break;
         default:
             dbgln_if(VIRTIO_DEBUG, "VirtIO: Unknown VirtIO device with ID: {}", id.device_id);
             break;
@@ -212,6 +223,11 @@ bool VirtIODevice::accept_device_features(u64 device_features, u64 accepted_feat
         accepted_features |= VIRTIO_F_IN_ORDER;
     }
 
+    // Lets both sides tell each other exactly when they want to be notified, instead of notifying on every buffer.
+    if (is_feature_set(device_features, VIRTIO_F_EVENT_IDX)) {
+        accepted_features |= VIRTIO_F_EVENT_IDX;
+    }
+
     dbgln_if(VIRTIO_DEBUG, "{}: Device features: {}", m_class_name, device_features);
     dbgln_if(VIRTIO_DEBUG, "{}: Accepted features: {}", m_class_name, accepted_features);
 
@@ -266,7 +282,7 @@ bool VirtIODevice::setup_queue(u16 queue_index)
 
     u16 queue_notify_offset = config_read16(*m_common_cfg, COMMON_CFG_QUEUE_NOTIFY_OFF);
 
-    auto queue = make<VirtIOQueue>(queue_size, queue_notify_offset);
+    auto queue = make<VirtIOQueue>(queue_size, queue_notify_offset, is_feature_accepted(VIRTIO_F_EVENT_IDX));
     if (queue->is_null())
         return false;
 
@@ -341,6 +357,27 @@ void VirtIODevice::supply_buffer_and_notify(u16 queue_index, const ScatterGather
         notify_queue(queue_index);
 }
 
+bool VirtIODevice::supply_chain(u16 queue_index, Span<const VirtIOQueueChainEntry> chain, void* token)
+{
+    VERIFY(queue_index < m_queue_count);
+    return get_queue(queue_index).add_chain({}, chain, token);
+}
+
+void VirtIODevice::flush_queue(u16 queue_index)
+{
+    VERIFY(queue_index < m_queue_count);
+    if (get_queue(queue_index).publish_chains({}))
+        notify_queue(queue_index);
+}
+
+bool VirtIODevice::supply_chain_and_notify(u16 queue_index, Span<const VirtIOQueueChainEntry> chain, void* token)
+{
+    if (!supply_chain(queue_index, chain, token))
+        return false;
+    flush_queue(queue_index);
+    return true;
+}
+
 u8 VirtIODevice::isr_status()
 {
     if (!m_isr_cfg)
@@ -358,11 +395,16 @@ void VirtIODevice::handle_irq(const RegisterState&)
         }
     }
     if (isr_type & QUEUE_INTERRUPT) {
+        // A single interrupt can cover buffers used on several queues (e.g. both receive and transmit).
+        bool handled_any_queue = false;
         for (size_t i = 0; i < m_queues.size(); i++) {
-            if (get_queue(i).new_data_available())
-                return handle_queue_update(i);
+            if (get_queue(i).new_data_available()) {
+                handle_queue_update(i);
+                handled_any_queue = true;
+            }
         }
-        dbgln_if(VIRTIO_DEBUG, "{}: Got queue interrupt but all queues are up to date!", m_class_name);
+        if (!handled_any_queue)
+            dbgln_if(VIRTIO_DEBUG, "{}: Got queue interrupt but all queues are up to date!", m_class_name);
     }
     if (isr_type & ~(QUEUE_INTERRUPT | DEVICE_CONFIG_INTERRUPT))
         dbgln("{}: Handling interrupt with unknown type: {}", m_class_name, isr_type);
@@ -36,6 +36,7 @@ namespace Kernel {
 #define DEVICE_STATUS_FAILED (1 << 7)
 
 #define VIRTIO_F_INDIRECT_DESC ((u64)1 << 28)
+#define VIRTIO_F_EVENT_IDX ((u64)1 << 29)
 #define VIRTIO_F_VERSION_1 ((u64)1 << 32)
 #define VIRTIO_F_RING_PACKED ((u64)1 << 34)
 #define VIRTIO_F_IN_ORDER ((u64)1 << 35)
@@ -200,6 +201,12 @@ protected:
 
     void supply_buffer_and_notify(u16 queue_index, const ScatterGatherList&, BufferType, void* token);
 
+    // Multi-descriptor chains, e.g. a request header, its data and a status byte. supply_chain() only queues
+    // the chain up; flush_queue() then hands everything queued so far to the device with at most one notification.
+    bool supply_chain(u16 queue_index, Span<const VirtIOQueueChainEntry>, void* token);
+    void flush_queue(u16 queue_index);
+    bool supply_chain_and_notify(u16 queue_index, Span<const VirtIOQueueChainEntry>, void* token);
+
     virtual bool handle_device_config_change() = 0;
     virtual void handle_queue_update(u16 queue_index) = 0;
 
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/CommandLine.h>
+#include <Kernel/PCI/Access.h>
+#include <Kernel/VirtIO/VirtIOBlockController.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT NonnullRefPtr<VirtIOBlockController> VirtIOBlockController::initialize()
+{
+    return adopt_ref(*new VirtIOBlockController());
+}
+
+bool VirtIOBlockController::reset()
+{
+    TODO();
+}
+
+bool VirtIOBlockController::shutdown()
+{
+    TODO();
+}
+
+size_t VirtIOBlockController::devices_count() const
+{
+    return m_devices.size();
+}
+
+void VirtIOBlockController::start_request(const StorageDevice&, AsyncBlockDeviceRequest&)
+{
+    // Every VirtIOBlockDevice handles its own requests.
+    VERIFY_NOT_REACHED();
+}
+
+void VirtIOBlockController::complete_current_request(AsyncDeviceRequest::RequestResult)
+{
+    VERIFY_NOT_REACHED();
+}
+
+UNMAP_AFTER_INIT VirtIOBlockController::VirtIOBlockController()
+    : StorageController()
+{
+    if (kernel_command_line().disable_virtio())
+        return;
+    PCI::enumerate([&](const PCI::Address& address, PCI::ID id) {
+        if (address.is_null() || id.is_null())
+            return;
+        if (id.vendor_id != VIRTIO_PCI_VENDOR_ID)
+            return;
+        if (id.device_id != VIRTIO_BLOCK_PCI_DEVICE_ID && id.device_id != VIRTIO_BLOCK_MODERN_PCI_DEVICE_ID)
+            return;
+        if (auto device = VirtIOBlockDevice::create(*this, address))
+            m_devices.append(device.release_nonnull());
+    });
+}
+
+VirtIOBlockController::~VirtIOBlockController()
+{
+}
+
+RefPtr<StorageDevice> VirtIOBlockController::device(u32 index) const
+{
+    if (index >= m_devices.size())
+        return nullptr;
+    return m_devices[index];
+}
+
+}
@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/DeferredWorkQueue.h>
+#include <Kernel/VM/AnonymousVMObject.h>
+#include <Kernel/VirtIO/VirtIOBlockController.h>
+#include <Kernel/VirtIO/VirtIOBlockDevice.h>
+
+namespace Kernel {
+
+static constexpr u16 request_queue_index = 0;
+
+UNMAP_AFTER_INIT RefPtr<VirtIOBlockDevice> VirtIOBlockDevice::create(const VirtIOBlockController& controller, PCI::Address address)
+{
+    auto device = adopt_ref(*new VirtIOBlockDevice(controller, address));
+    if (!device->initialize()) {
+        dmesgln("VirtIOBlockDevice: Failed to initialize device @ {}", address);
+        // Storage devices are eternal, so there is no way to get rid of this one again.
+        [[maybe_unused]] auto& unused = device.leak_ref();
+        return {};
+    }
+    return device;
+}
+
+UNMAP_AFTER_INIT VirtIOBlockDevice::VirtIOBlockDevice(const VirtIOBlockController& controller, PCI::Address address)
+    : StorageDevice(controller, 512, 0)
+    , VirtIODevice(address, "VirtIOBlockDevice")
+{
+}
+
+VirtIOBlockDevice::~VirtIOBlockDevice()
+{
+}
+
+UNMAP_AFTER_INIT bool VirtIOBlockDevice::initialize()
+{
+    auto* cfg = get_config(ConfigurationType::Device);
+    if (!cfg)
+        return false;
+
+    bool success = negotiate_features([&](u64 supported_features) {
+        u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_SEG_MAX))
+            negotiated |= VIRTIO_BLK_F_SEG_MAX;
+        if (is_feature_set(supported_features, VIRTIO_BLK_F_RO))
+            negotiated |= VIRTIO_BLK_F_RO;
+        return negotiated;
+    });
+    if (!success)
+        return false;
+
+    u32 max_segment_count = 0;
+    read_config_atomic([&]() {
+        m_capacity = config_read32(*cfg, 0x0) | ((u64)config_read32(*cfg, 0x4) << 32);
+        if (is_feature_accepted(VIRTIO_BLK_F_SEG_MAX))
+            max_segment_count = config_read32(*cfg, 0xc);
+    });
+    m_read_only = is_feature_accepted(VIRTIO_BLK_F_RO);
+    if (max_segment_count)
+        m_pages_per_request = clamp((size_t)max_segment_count, (size_t)1, max_pages_per_request);
+
+    if (!setup_queues(1))
+        return false;
+    finish_init();
+
+    // Every request takes up a descriptor for its header, one per data page and one for its status.
+    auto queue_size = get_queue(request_queue_index).size();
+    if (queue_size < 3)
+        return false;
+    m_pages_per_request = min(m_pages_per_request, (size_t)queue_size - 2);
+    size_t slot_count = min(max_request_slots, queue_size / (m_pages_per_request + 2));
+
+    static_assert(max_request_slots * request_header_stride <= PAGE_SIZE);
+    static_assert(max_request_slots <= 32);
+    m_headers_region = MM.allocate_contiguous_kernel_region(PAGE_SIZE, "VirtIOBlockDevice Requests", Region::Access::Read | Region::Access::Write);
+    if (!m_headers_region)
+        return false;
+
+    for (size_t slot_index = 0; slot_index < slot_count; slot_index++) {
+        RequestSlot slot;
+        for (size_t page_index = 0; page_index < m_pages_per_request; page_index++) {
+            auto page = MM.allocate_supervisor_physical_page();
+            if (!page)
+                return false;
+            slot.data_pages.append(page.release_nonnull());
+        }
+        auto vmobject = AnonymousVMObject::create_with_physical_pages(slot.data_pages);
+        slot.data_region = MM.allocate_kernel_region_with_vmobject(vmobject, m_pages_per_request * PAGE_SIZE, "VirtIOBlockDevice DMA", Region::Access::Read | Region::Access::Write);
+        if (!slot.data_region)
+            return false;
+        m_request_slots.append(move(slot));
+    }
+
+    dmesgln("VirtIOBlockDevice: {} has {} sectors{}, up to {} requests of {} KiB in flight", device_name(), m_capacity, m_read_only ? " (read-only)" : "", slot_count, m_pages_per_request * PAGE_SIZE / KiB);
+    return true;
+}
+
+size_t VirtIOBlockDevice::max_blocks_per_request() const
+{
+    return m_pages_per_request * PAGE_SIZE / block_size();
+}
+
+String VirtIOBlockDevice::device_name() const
+{
+    return String::formatted("hd{:c}", 'a' + minor());
+}
+
+bool VirtIOBlockDevice::handle_device_config_change()
+{
+    // The only thing that can change on the fly is the capacity, e.g. when the backing image gets resized.
+    auto* cfg = get_config(ConfigurationType::Device);
+    VERIFY(cfg);
+    read_config_atomic([&]() {
+        m_capacity = config_read32(*cfg, 0x0) | ((u64)config_read32(*cfg, 0x4) << 32);
+    });
+    dbgln_if(VIRTIO_DEBUG, "VirtIOBlockDevice: Capacity changed to {} sectors", m_capacity);
+    return true;
+}
+
+void VirtIOBlockDevice::handle_queue_update(u16 queue_index)
+{
+    VERIFY(queue_index == request_queue_index);
+    // Copying the data of finished reads into the requests' buffers may page fault,
+    // so it has to happen outside of the IRQ handler.
+    if (m_completion_scheduled.exchange(true))
+        return;
+    DeferredWorkQueue::queue(DeferredWorkQueue::Priority::High, [this]() {
+        complete_used_requests();
+    });
+}
+
+void VirtIOBlockDevice::start_request(AsyncBlockDeviceRequest& request)
+{
+    LOCKER(m_lock);
+    if (m_request_slots.is_empty() || (m_read_only && request.request_type() == AsyncBlockDeviceRequest::Write)) {
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+
+    // Device never starts more requests than we have slots for, so there's always a free one.
+    Optional<size_t> slot_index;
+    for (size_t index = 0; index < m_request_slots.size(); index++) {
+        if (!(m_allocated_slots & (1u << index))) {
+            slot_index = index;
+            break;
+        }
+    }
+    VERIFY(slot_index.has_value());
+    m_allocated_slots |= 1u << slot_index.value();
+    m_request_slots[slot_index.value()].request = request;
+
+    auto result = submit_request(slot_index.value(), request);
+    if (result.has_value())
+        complete_slot(slot_index.value(), result.value());
+}
+
+Optional<AsyncDeviceRequest::RequestResult> VirtIOBlockDevice::submit_request(size_t slot_index, AsyncBlockDeviceRequest& request)
+{
+    VERIFY(m_lock.is_locked());
+    auto& slot = m_request_slots[slot_index];
+    size_t transfer_size = request.block_count() * block_size();
+    VERIFY(transfer_size <= m_pages_per_request * PAGE_SIZE);
+
+    bool is_write = request.request_type() == AsyncBlockDeviceRequest::Write;
+    if (is_write && !request.read_from_buffer(request.buffer(), slot.data_region->vaddr().as_ptr(), transfer_size))
+        return AsyncDeviceRequest::MemoryFault;
+
+    auto& header = request_header(slot_index);
+    header.type = is_write ? VIRTIO_BLK_T_OUT : VIRTIO_BLK_T_IN;
+    header.reserved = 0;
+    header.sector = request.block_index();
+    request_status(slot_index) = 0xff;
+
+    Vector<VirtIOQueueChainEntry, max_pages_per_request + 2> chain;
+    chain.append({ request_header_address(slot_index), sizeof(RequestHeader), BufferType::DeviceReadable });
+    auto data_buffer_type = is_write ? BufferType::DeviceReadable : BufferType::DeviceWritable;
+    for (size_t offset = 0; offset < transfer_size; offset += PAGE_SIZE)
+        chain.append({ slot.data_pages[offset / PAGE_SIZE].paddr(), min((size_t)PAGE_SIZE, transfer_size - offset), data_buffer_type });
+    chain.append({ request_header_address(slot_index).offset(sizeof(RequestHeader)), sizeof(u8), BufferType::DeviceWritable });
+
+    dbgln_if(VIRTIO_DEBUG, "VirtIOBlockDevice: Slot {}: {} {} blocks at {}", slot_index, is_write ? "write" : "read", request.block_count(), request.block_index());
+
+    // A null token means there is no used buffer, so the token is the slot index plus one.
+    if (!supply_chain(request_queue_index, chain.span(), reinterpret_cast<void*>(slot_index + 1)))
+        return AsyncDeviceRequest::Failure;
+    if (!m_is_completing_requests)
+        flush_queue(request_queue_index);
+    return {};
+}
+
+void VirtIOBlockDevice::complete_slot(size_t slot_index, AsyncDeviceRequest::RequestResult result)
+{
+    VERIFY(m_lock.is_locked());
+    auto& slot = m_request_slots[slot_index];
+    VERIFY(slot.request);
+    auto request = move(slot.request);
+    m_allocated_slots &= ~(1u << slot_index);
+    // Completing the request may start the next one, which can end up in this very slot.
+    request->complete(result);
+}
+
+void VirtIOBlockDevice::complete_used_requests()
+{
+    LOCKER(m_lock);
+    m_completion_scheduled = false;
+
+    m_is_completing_requests = true;
+    auto& queue = get_queue(request_queue_index);
+    for (;;) {
+        size_t used_length;
+        auto* token = queue.get_buffer(&used_length);
+        if (!token)
+            break;
+        size_t slot_index = reinterpret_cast<FlatPtr>(token) - 1;
+        VERIFY(slot_index < m_request_slots.size());
+        auto& slot = m_request_slots[slot_index];
+        VERIFY(slot.request);
+
+        if (request_status(slot_index) != VIRTIO_BLK_S_OK) {
+            dbgln_if(VIRTIO_DEBUG, "VirtIOBlockDevice: Slot {}: Request failed with status {}", slot_index, request_status(slot_index));
+            complete_slot(slot_index, AsyncDeviceRequest::Failure);
+            continue;
+        }
+        if (slot.request->request_type() == AsyncBlockDeviceRequest::Read) {
+            if (!slot.request->write_to_buffer(slot.request->buffer(), slot.data_region->vaddr().as_ptr(), slot.request->block_count() * block_size())) {
+                complete_slot(slot_index, AsyncDeviceRequest::MemoryFault);
+                continue;
+            }
+        }
+        complete_slot(slot_index, AsyncDeviceRequest::Success);
+    }
+    m_is_completing_requests = false;
+
+    // Hand all the requests that were started while completing the others to the device at once.
+    flush_queue(request_queue_index);
+}
+
+}
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtrVector.h>
+#include <Kernel/Lock.h>
+#include <Kernel/Storage/StorageDevice.h>
+#include <Kernel/VirtIO/VirtIO.h>
+
+namespace Kernel {
+
+#define VIRTIO_BLOCK_PCI_DEVICE_ID 0x1001
+#define VIRTIO_BLOCK_MODERN_PCI_DEVICE_ID 0x1042
+
+#define VIRTIO_BLK_F_SIZE_MAX (1 << 1)
+#define VIRTIO_BLK_F_SEG_MAX (1 << 2)
+#define VIRTIO_BLK_F_RO (1 << 5)
+
+#define VIRTIO_BLK_T_IN 0
+#define VIRTIO_BLK_T_OUT 1
+
+#define VIRTIO_BLK_S_OK 0
+
+class VirtIOBlockController;
+
+class VirtIOBlockDevice final : public StorageDevice
+    , public VirtIODevice {
+public:
+    static RefPtr<VirtIOBlockDevice> create(const VirtIOBlockController&, PCI::Address);
+    virtual ~VirtIOBlockDevice() override;
+
+    // ^StorageDevice
+    virtual u64 max_addressable_block() const override { return m_capacity; }
+    virtual size_t max_blocks_per_request() const override;
+
+    // ^BlockDevice
+    virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual String device_name() const override;
+
+    // ^Device
+    virtual size_t max_outstanding_requests() const override { return max(m_request_slots.size(), (size_t)1); }
+
+private:
+    VirtIOBlockDevice(const VirtIOBlockController&, PCI::Address);
+    bool initialize();
+
+    // ^DiskDevice
+    virtual const char* class_name() const override { return m_class_name.characters(); }
+
+    // ^VirtIODevice
+    virtual bool handle_device_config_change() override;
+    virtual void handle_queue_update(u16 queue_index) override;
+
+    // Every request in flight owns one of these: its header and status live in m_headers_region,
+    // and its data is bounced through a set of (not necessarily contiguous) pages.
+    struct RequestSlot {
+        RefPtr<AsyncBlockDeviceRequest> request;
+        NonnullRefPtrVector<PhysicalPage> data_pages;
+        OwnPtr<Region> data_region;
+    };
+
+    struct [[gnu::packed]] RequestHeader {
+        u32 type;
+        u32 reserved;
+        u64 sector;
+    };
+
+    // The header is read by the device, the status byte right behind it is written by the device.
+    static constexpr size_t request_header_stride = 32;
+    static constexpr size_t max_pages_per_request = 16;
+    static constexpr size_t max_request_slots = 16;
+
+    RequestHeader& request_header(size_t slot_index) { return *reinterpret_cast<RequestHeader*>(m_headers_region->vaddr().offset(slot_index * request_header_stride).as_ptr()); }
+    volatile u8& request_status(size_t slot_index) { return *m_headers_region->vaddr().offset(slot_index * request_header_stride + sizeof(RequestHeader)).as_ptr(); }
+    PhysicalAddress request_header_address(size_t slot_index) const { return m_headers_region->physical_page(0)->paddr().offset(slot_index * request_header_stride); }
+
+    Optional<AsyncDeviceRequest::RequestResult> submit_request(size_t slot_index, AsyncBlockDeviceRequest&);
+    void complete_slot(size_t slot_index, AsyncDeviceRequest::RequestResult);
+    void complete_used_requests();
+
+    Lock m_lock { "VirtIOBlockDevice" };
+    // The capacity is only known once the device is set up, which happens after StorageDevice was constructed.
+    u64 m_capacity { 0 };
+    OwnPtr<Region> m_headers_region;
+    Vector<RequestSlot> m_request_slots;
+    u32 m_allocated_slots { 0 };
+    size_t m_pages_per_request { max_pages_per_request };
+    bool m_read_only { false };
+
+    // While used requests are being completed, newly started requests are only queued up,
+    // and then handed to the device together with a single notification.
+    bool m_is_completing_requests { false };
+    Atomic<bool> m_completion_scheduled { false };
+};
+
+}
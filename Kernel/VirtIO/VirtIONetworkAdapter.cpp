@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Process.h>
+#include <Kernel/Random.h>
+#include <Kernel/VirtIO/VirtIONetworkAdapter.h>
+
+namespace Kernel {
+
+static constexpr u16 receive_queue_index = 0;
+static constexpr u16 transmit_queue_index = 1;
+
+UNMAP_AFTER_INIT VirtIONetworkAdapter::VirtIONetworkAdapter(PCI::Address address)
+    : VirtIODevice(address, "VirtIONetworkAdapter")
+{
+    set_interface_name("virtio");
+    m_is_operational = initialize();
+    if (!m_is_operational)
+        dmesgln("VirtIONetworkAdapter: Failed to initialize device @ {}", address);
+}
+
+UNMAP_AFTER_INIT VirtIONetworkAdapter::~VirtIONetworkAdapter()
+{
+}
+
+UNMAP_AFTER_INIT bool VirtIONetworkAdapter::initialize()
+{
+    auto* cfg = get_config(ConfigurationType::Device);
+    if (!cfg)
+        return false;
+
+    bool success = negotiate_features([&](u64 supported_features) {
+        u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MAC))
+            negotiated |= VIRTIO_NET_F_MAC;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_STATUS))
+            negotiated |= VIRTIO_NET_F_STATUS;
+        return negotiated;
+    });
+    if (!success)
+        return false;
+    read_mac_address(*cfg);
+
+    if (!setup_queues(2))
+        return false;
+    finish_init();
+
+    // Every received packet takes up one descriptor, every transmitted one takes two: the header and the frame.
+    m_rx_buffer_count = min(max_rx_buffer_count, (size_t)get_queue(receive_queue_index).size());
+    m_tx_buffer_count = min(max_tx_buffer_count, (size_t)get_queue(transmit_queue_index).size() / 2);
+    if (!m_rx_buffer_count || !m_tx_buffer_count)
+        return false;
+
+    m_rx_buffers_region = MM.allocate_contiguous_kernel_region(page_round_up(m_rx_buffer_count * rx_buffer_size), "VirtIONetworkAdapter RX buffers", Region::Access::Read | Region::Access::Write);
+    m_tx_buffers_region = MM.allocate_contiguous_kernel_region(page_round_up(m_tx_buffer_count * tx_buffer_size + sizeof(NetworkHeader)), "VirtIONetworkAdapter TX buffers", Region::Access::Read | Region::Access::Write);
+    if (!m_rx_buffers_region || !m_tx_buffers_region)
+        return false;
+    memset(m_tx_buffers_region->vaddr().offset(m_tx_buffer_count * tx_buffer_size).as_ptr(), 0, sizeof(NetworkHeader));
+    m_free_tx_buffers = m_tx_buffer_count == 64 ? ~(u64)0 : ((u64)1 << m_tx_buffer_count) - 1;
+
+    // We reclaim transmitted buffers whenever we send something, and only ask for an interrupt when we run out of them.
+    get_queue(transmit_queue_index).disable_interrupts();
+
+    for (size_t index = 0; index < m_rx_buffer_count; index++)
+        supply_rx_buffer(index);
+    flush_queue(receive_queue_index);
+
+    dmesgln("VirtIONetworkAdapter: MAC address: {}, {} RX and {} TX buffers", mac_address().to_string(), m_rx_buffer_count, m_tx_buffer_count);
+    return true;
+}
+
+UNMAP_AFTER_INIT void VirtIONetworkAdapter::read_mac_address(const Configuration& cfg)
+{
+    MACAddress mac {};
+    if (is_feature_accepted(VIRTIO_NET_F_MAC)) {
+        read_config_atomic([&]() {
+            for (size_t i = 0; i < 6; i++)
+                mac[i] = config_read8(cfg, i);
+        });
+    } else {
+        // The device leaves it to us to pick an address. Use a random, locally administered one.
+        u8 random_bytes[6];
+        get_fast_random_bytes(random_bytes, sizeof(random_bytes));
+        for (size_t i = 0; i < 6; i++)
+            mac[i] = random_bytes[i];
+        mac[0] = (mac[0] & 0xfe) | 0x02;
+    }
+    set_mac_address(mac);
+}
+
+bool VirtIONetworkAdapter::link_up()
+{
+    if (!m_is_operational)
+        return false;
+    if (!is_feature_accepted(VIRTIO_NET_F_STATUS))
+        return true;
+    auto* cfg = get_config(ConfigurationType::Device);
+    VERIFY(cfg);
+    return config_read16(*cfg, 0x6) & VIRTIO_NET_S_LINK_UP;
+}
+
+bool VirtIONetworkAdapter::handle_device_config_change()
+{
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: Link is {}", link_up() ? "up" : "down");
+    return true;
+}
+
+void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
+{
+    switch (queue_index) {
+    case receive_queue_index:
+        // Don't touch the queue here, NetworkTask will poll the packets out of it. Until it has
+        // caught up with the device, further receive interrupts would only be in the way.
+        get_queue(receive_queue_index).disable_interrupts();
+        m_rx_polling = true;
+        schedule_polling();
+        break;
+    case transmit_queue_index:
+        get_queue(transmit_queue_index).disable_interrupts();
+        reclaim_transmitted_buffers();
+        m_tx_wait_queue.wake_all();
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void VirtIONetworkAdapter::supply_rx_buffer(size_t index)
+{
+    VirtIOQueueChainEntry chain[] = {
+        { rx_buffer_address(index), rx_buffer_size, BufferType::DeviceWritable },
+    };
+    // A null token means there is no used buffer, so the token is the buffer index plus one.
+    VERIFY(supply_chain(receive_queue_index, { chain, 1 }, reinterpret_cast<void*>(index + 1)));
+    m_rx_buffers_pending_flush++;
+}
+
+size_t VirtIONetworkAdapter::poll_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp)
+{
+    if (!m_is_operational)
+        return 0;
+    auto& queue = get_queue(receive_queue_index);
+    for (;;) {
+        size_t used_length;
+        auto* token = queue.get_buffer(&used_length);
+        if (!token) {
+            if (m_rx_buffers_pending_flush) {
+                flush_queue(receive_queue_index);
+                m_rx_buffers_pending_flush = 0;
+            }
+            if (!m_rx_polling.exchange(false))
+                return 0;
+            // We've caught up with the device, so go back to waiting for interrupts. A packet may
+            // have arrived right before interrupts were enabled again though, so check once more.
+            queue.enable_interrupts();
+            if (!queue.new_data_available())
+                return 0;
+            queue.disable_interrupts();
+            m_rx_polling = true;
+            continue;
+        }
+
+        size_t index = reinterpret_cast<FlatPtr>(token) - 1;
+        VERIFY(index < m_rx_buffer_count);
+        size_t packet_size = 0;
+        if (used_length > sizeof(NetworkHeader) && used_length - sizeof(NetworkHeader) <= buffer_size) {
+            packet_size = used_length - sizeof(NetworkHeader);
+            dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: Received 1 packet in buffer {} ({} bytes)", index, packet_size);
+            memcpy(buffer, rx_buffer(index) + sizeof(NetworkHeader), packet_size);
+            packet_timestamp = kgettimeofday();
+        } else {
+            did_drop_packets(1);
+        }
+
+        // Give the buffer back to the device, but only notify it once we've collected a bunch of them.
+        supply_rx_buffer(index);
+        if (m_rx_buffers_pending_flush >= rx_buffer_batch_size) {
+            flush_queue(receive_queue_index);
+            m_rx_buffers_pending_flush = 0;
+        }
+        if (packet_size)
+            return packet_size;
+    }
+}
+
+void VirtIONetworkAdapter::reclaim_transmitted_buffers()
+{
+    auto& queue = get_queue(transmit_queue_index);
+    for (;;) {
+        size_t used_length;
+        auto* token = queue.get_buffer(&used_length);
+        if (!token)
+            return;
+        size_t index = reinterpret_cast<FlatPtr>(token) - 1;
+        VERIFY(index < m_tx_buffer_count);
+        ScopedSpinLock lock(m_tx_buffers_lock);
+        m_free_tx_buffers |= (u64)1 << index;
+    }
+}
+
+void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
+{
+    VERIFY(payload.size() <= tx_buffer_size);
+    if (!m_is_operational)
+        return;
+
+    LOCKER(m_tx_lock);
+
+    auto& queue = get_queue(transmit_queue_index);
+    size_t index;
+    for (;;) {
+        reclaim_transmitted_buffers();
+        {
+            ScopedSpinLock lock(m_tx_buffers_lock);
+            if (m_free_tx_buffers) {
+                index = __builtin_ctzll(m_free_tx_buffers);
+                m_free_tx_buffers &= ~((u64)1 << index);
+                break;
+            }
+        }
+        // All of our buffers are still in flight, so ask the device to tell us when it's done with one.
+        queue.enable_interrupts();
+        if (queue.new_data_available())
+            continue;
+        m_tx_wait_queue.wait_forever("VirtIONetworkAdapter");
+    }
+    queue.disable_interrupts();
+
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: Sending packet in buffer {} ({} bytes)", index, payload.size());
+    memcpy(tx_buffer(index), payload.data(), payload.size());
+    VirtIOQueueChainEntry chain[] = {
+        { tx_header_address(), sizeof(NetworkHeader), BufferType::DeviceReadable },
+        { tx_buffer_address(index), payload.size(), BufferType::DeviceReadable },
+    };
+    VERIFY(supply_chain_and_notify(transmit_queue_index, { chain, 2 }, reinterpret_cast<void*>(index + 1)));
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <Kernel/Lock.h>
+#include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/VirtIO/VirtIO.h>
+#include <Kernel/WaitQueue.h>
+
+namespace Kernel {
+
+#define VIRTIO_NETWORK_PCI_DEVICE_ID 0x1000
+#define VIRTIO_NETWORK_MODERN_PCI_DEVICE_ID 0x1041
+
+#define VIRTIO_NET_F_MAC (1 << 5)
+#define VIRTIO_NET_F_STATUS (1 << 16)
+
+#define VIRTIO_NET_S_LINK_UP 1
+
+class VirtIONetworkAdapter final : public NetworkAdapter
+    , public VirtIODevice {
+public:
+    VirtIONetworkAdapter(PCI::Address);
+    virtual ~VirtIONetworkAdapter() override;
+
+    virtual void send_raw(ReadonlyBytes) override;
+    virtual bool link_up() override;
+
+private:
+    virtual const char* class_name() const override { return m_class_name.characters(); }
+    virtual size_t poll_packet(u8* buffer, size_t buffer_size, Time& packet_timestamp) override;
+
+    // ^VirtIODevice
+    virtual bool handle_device_config_change() override;
+    virtual void handle_queue_update(u16 queue_index) override;
+
+    bool initialize();
+    void read_mac_address(const Configuration&);
+    void supply_rx_buffer(size_t index);
+    void reclaim_transmitted_buffers();
+
+    // Every packet is preceded by a virtio_net_hdr. We don't use any offloads, so ours are always zeroed.
+    struct [[gnu::packed]] NetworkHeader {
+        u8 flags;
+        u8 gso_type;
+        u16 header_length;
+        u16 gso_size;
+        u16 checksum_start;
+        u16 checksum_offset;
+        u16 buffer_count;
+    };
+
+    static constexpr size_t rx_buffer_size = 2048;
+    static constexpr size_t tx_buffer_size = 2048;
+    static constexpr size_t max_rx_buffer_count = 256;
+    static constexpr size_t max_tx_buffer_count = 64;
+    // How many receive buffers we collect before handing them back to the device in one go.
+    static constexpr size_t rx_buffer_batch_size = 16;
+
+    u8* rx_buffer(size_t index) { return m_rx_buffers_region->vaddr().offset(index * rx_buffer_size).as_ptr(); }
+    u8* tx_buffer(size_t index) { return m_tx_buffers_region->vaddr().offset(index * tx_buffer_size).as_ptr(); }
+    PhysicalAddress rx_buffer_address(size_t index) const { return m_rx_buffers_region->physical_page(0)->paddr().offset(index * rx_buffer_size); }
+    PhysicalAddress tx_buffer_address(size_t index) const { return m_tx_buffers_region->physical_page(0)->paddr().offset(index * tx_buffer_size); }
+    // The shared transmit header lives right behind the last transmit buffer.
+    PhysicalAddress tx_header_address() const { return tx_buffer_address(m_tx_buffer_count); }
+
+    OwnPtr<Region> m_rx_buffers_region;
+    OwnPtr<Region> m_tx_buffers_region;
+    size_t m_rx_buffer_count { 0 };
+    size_t m_tx_buffer_count { 0 };
+    size_t m_rx_buffers_pending_flush { 0 };
+    bool m_is_operational { false };
+
+    // Set while the receive interrupts are masked and NetworkTask is polling the queue.
+    Atomic<bool> m_rx_polling { false };
+
+    SpinLock<u8> m_tx_buffers_lock;
+    u64 m_free_tx_buffers { 0 };
+    Lock m_tx_lock { "VirtIONetworkAdapter TX" };
+    WaitQueue m_tx_wait_queue;
+};
+
+}
@@ -9,22 +9,25 @@
 
 namespace Kernel {
 
-VirtIOQueue::VirtIOQueue(u16 queue_size, u16 notify_offset)
+VirtIOQueue::VirtIOQueue(u16 queue_size, u16 notify_offset, bool use_event_index)
     : m_queue_size(queue_size)
     , m_notify_offset(notify_offset)
     , m_free_buffers(queue_size)
+    , m_use_event_index(use_event_index)
 {
+    // The driver ring is followed by the used_event field, and the device ring by the avail_event field.
     size_t size_of_descriptors = sizeof(VirtIOQueueDescriptor) * queue_size;
-    size_t size_of_driver = sizeof(VirtIOQueueDriver) + queue_size * sizeof(u16);
-    size_t size_of_device = sizeof(VirtIOQueueDevice) + queue_size * sizeof(VirtIOQueueDeviceItem);
-    m_queue_region = MM.allocate_contiguous_kernel_region(page_round_up(size_of_descriptors + size_of_driver + size_of_device), "VirtIO Queue", Region::Access::Read | Region::Access::Write);
+    size_t size_of_driver = sizeof(VirtIOQueueDriver) + queue_size * sizeof(u16) + sizeof(u16);
+    size_t size_of_device = sizeof(VirtIOQueueDevice) + queue_size * sizeof(VirtIOQueueDeviceItem) + sizeof(u16);
+    // The descriptor table has to be 16-byte aligned, the driver area 2-byte aligned and the device area 4-byte aligned.
+    size_t offset_of_device = round_up_to_power_of_two(size_of_descriptors + size_of_driver, 4);
+    m_queue_region = MM.allocate_contiguous_kernel_region(page_round_up(offset_of_device + size_of_device), "VirtIO Queue", Region::Access::Read | Region::Access::Write);
     VERIFY(m_queue_region);
-    // TODO: ensure alignment!!!
     u8* ptr = m_queue_region->vaddr().as_ptr();
     memset(ptr, 0, m_queue_region->size());
     m_descriptors = reinterpret_cast<VirtIOQueueDescriptor*>(ptr);
     m_driver = reinterpret_cast<VirtIOQueueDriver*>(ptr + size_of_descriptors);
-    m_device = reinterpret_cast<VirtIOQueueDevice*>(ptr + size_of_descriptors + size_of_driver);
+    m_device = reinterpret_cast<VirtIOQueueDevice*>(ptr + offset_of_device);
     m_tokens.resize(queue_size);
 
     for (auto i = 0; i < queue_size; i++) {
@@ -40,53 +43,107 @@ VirtIOQueue::~VirtIOQueue()
 
 void VirtIOQueue::enable_interrupts()
 {
+    ScopedSpinLock lock(m_lock);
+    if (m_use_event_index) {
+        // Ask for an interrupt as soon as the device uses the next buffer.
+        used_event() = m_used_tail;
+        full_memory_barrier();
+        return;
+    }
     m_driver->flags = 0;
 }
 
 void VirtIOQueue::disable_interrupts()
 {
-    m_driver->flags = 1;
+    ScopedSpinLock lock(m_lock);
+    // With the event index feature, the device ignores the flags and only interrupts once it
+    // passes used_event, which we simply stop moving forward.
+    if (!m_use_event_index)
+        m_driver->flags = VIRTQ_AVAIL_F_NO_INTERRUPT;
 }
 
 bool VirtIOQueue::supply_buffer(Badge<VirtIODevice>, const ScatterGatherList& scatter_list, BufferType buffer_type, void* token)
 {
-    VERIFY(scatter_list.length() && scatter_list.length() <= m_free_buffers);
-    m_free_buffers -= scatter_list.length();
+    Vector<VirtIOQueueChainEntry, 16> chain;
+    scatter_list.for_each_entry([&](auto paddr, auto size) {
+        chain.append({ PhysicalAddress(paddr), size, buffer_type });
+    });
+    ScopedSpinLock lock(m_lock);
+    VERIFY(do_add_chain(chain.span(), token));
+    return do_publish_chains();
+}
+
+bool VirtIOQueue::add_chain(Badge<VirtIODevice>, Span<const VirtIOQueueChainEntry> chain, void* token)
+{
+    ScopedSpinLock lock(m_lock);
+    return do_add_chain(chain, token);
+}
+
+bool VirtIOQueue::do_add_chain(Span<const VirtIOQueueChainEntry> chain, void* token)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(!chain.is_empty());
+    if (chain.size() > m_free_buffers)
+        return false;
+    m_free_buffers -= chain.size();
 
     auto descriptor_index = m_free_head;
     auto last_index = descriptor_index;
-    scatter_list.for_each_entry([&](auto paddr, auto size) {
-        m_descriptors[descriptor_index].flags = static_cast<u16>(buffer_type) | VIRTQ_DESC_F_NEXT;
-        m_descriptors[descriptor_index].address = static_cast<u64>(paddr);
-        m_descriptors[descriptor_index].length = static_cast<u32>(size);
+    for (auto& entry : chain) {
+        m_descriptors[descriptor_index].flags = static_cast<u16>(entry.buffer_type) | VIRTQ_DESC_F_NEXT;
+        m_descriptors[descriptor_index].address = static_cast<u64>(entry.address.get());
+        m_descriptors[descriptor_index].length = static_cast<u32>(entry.length);
         last_index = descriptor_index;
         descriptor_index = m_descriptors[descriptor_index].next; // ensure we place the buffer in chain order
-    });
+    }
     m_descriptors[last_index].flags &= ~(VIRTQ_DESC_F_NEXT); // last descriptor in chain doesn't have a next descriptor
 
     m_driver->rings[m_driver_index_shadow % m_queue_size] = m_free_head; // m_driver_index_shadow is used to prevent accesses to index before the rings are updated
     m_tokens[m_free_head] = token;
     m_free_head = descriptor_index;
+    m_driver_index_shadow++;
+    return true;
+}
+
+bool VirtIOQueue::publish_chains(Badge<VirtIODevice>)
+{
+    ScopedSpinLock lock(m_lock);
+    return do_publish_chains();
+}
+
+bool VirtIOQueue::do_publish_chains()
+{
+    VERIFY(m_lock.is_locked());
+    u16 old_index = m_driver->index;
+    u16 new_index = m_driver_index_shadow;
+    if (old_index == new_index)
+        return false;
 
     full_memory_barrier();
 
-    m_driver_index_shadow++;
-    m_driver->index++;
+    m_driver->index = new_index;
 
     full_memory_barrier();
 
-    auto device_flags = m_device->flags;
-    return !(device_flags & 1); // if bit 1 is enabled the device disabled interrupts
+    if (m_use_event_index) {
+        // Only notify if the device's avail_event lies within the chains we've just published.
+        u16 event_index = available_event();
+        return (u16)(new_index - event_index - 1) < (u16)(new_index - old_index);
+    }
+    return !(m_device->flags & VIRTQ_USED_F_NO_NOTIFY);
 }
 
 bool VirtIOQueue::new_data_available() const
 {
+    ScopedSpinLock lock(m_lock);
+    full_memory_barrier();
     return m_device->index != m_used_tail;
 }
 
 void* VirtIOQueue::get_buffer(size_t* size)
 {
-    if (!new_data_available()) {
+    ScopedSpinLock lock(m_lock);
+    if (m_device->index == m_used_tail) {
         *size = 0;
         return nullptr;
     }
@@ -106,8 +163,8 @@ void* VirtIOQueue::get_buffer(size_t* size)
 void VirtIOQueue::discard_used_buffers()
 {
     size_t size;
-    while (!get_buffer(&size)) {
-    }
+    while (new_data_available())
+        get_buffer(&size);
 }
 
 void VirtIOQueue::pop_buffer(u16 descriptor_index)
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Badge.h>
+#include <AK/Span.h>
 #include <Kernel/SpinLock.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/ScatterGatherList.h>
@@ -16,21 +17,34 @@ namespace Kernel {
 #define VIRTQ_DESC_F_NEXT 1
 #define VIRTQ_DESC_F_INDIRECT 4
 
+#define VIRTQ_AVAIL_F_NO_INTERRUPT 1
+#define VIRTQ_USED_F_NO_NOTIFY 1
+
 enum class BufferType {
     DeviceReadable = 0,
     DeviceWritable = 2
 };
 
+// One physically contiguous piece of a buffer; a descriptor chain is made up of one or more of these.
+struct VirtIOQueueChainEntry {
+    PhysicalAddress address;
+    size_t length { 0 };
+    BufferType buffer_type { BufferType::DeviceReadable };
+};
+
 class VirtIODevice;
 
 class VirtIOQueue {
 public:
-    VirtIOQueue(u16 queue_size, u16 notify_offset);
+    VirtIOQueue(u16 queue_size, u16 notify_offset, bool use_event_index);
     ~VirtIOQueue();
 
     bool is_null() const { return !m_queue_region; }
     u16 notify_offset() const { return m_notify_offset; }
+    u16 size() const { return m_queue_size; }
 
+    // Note: When the event index feature was negotiated, re-enabling interrupts only asks the device
+    //       to interrupt for buffers used from now on, so callers have to check new_data_available() afterwards.
     void enable_interrupts();
     void disable_interrupts();
 
@@ -39,13 +53,26 @@ public:
     PhysicalAddress device_area() const { return to_physical(m_device.ptr()); }
 
     bool supply_buffer(Badge<VirtIODevice>, const ScatterGatherList&, BufferType, void* token);
+
+    // Adds a descriptor chain to the available ring without making it visible to the device yet,
+    // so that several chains can be handed over with a single notification by publish_chains().
+    bool add_chain(Badge<VirtIODevice>, Span<const VirtIOQueueChainEntry>, void* token);
+    // Returns whether the device asked to be notified about the newly published chains.
+    bool publish_chains(Badge<VirtIODevice>);
+
     bool new_data_available() const;
     bool can_write() const;
+    size_t free_descriptor_count() const { return m_free_buffers; }
     void* get_buffer(size_t*);
     void discard_used_buffers();
 
 private:
     void pop_buffer(u16 descriptor_index);
+    bool do_add_chain(Span<const VirtIOQueueChainEntry>, void* token);
+    bool do_publish_chains();
+
+    volatile u16& used_event() { return *reinterpret_cast<volatile u16*>(reinterpret_cast<u8*>(m_driver.ptr()) + sizeof(VirtIOQueueDriver) + m_queue_size * sizeof(u16)); }
+    volatile u16& available_event() { return *reinterpret_cast<volatile u16*>(reinterpret_cast<u8*>(m_device.ptr()) + sizeof(VirtIOQueueDevice) + m_queue_size * sizeof(VirtIOQueueDeviceItem)); }
 
     PhysicalAddress to_physical(const void* ptr) const
     {
@@ -82,13 +109,14 @@ private:
     u16 m_free_head { 0 };
     u16 m_used_tail { 0 };
     u16 m_driver_index_shadow { 0 };
+    const bool m_use_event_index { false };
 
     OwnPtr<VirtIOQueueDescriptor> m_descriptors { nullptr };
     OwnPtr<VirtIOQueueDriver> m_driver { nullptr };
     OwnPtr<VirtIOQueueDevice> m_device { nullptr };
     Vector<void*> m_tokens;
     OwnPtr<Region> m_queue_region;
-    SpinLock<u8> m_lock;
+    mutable SpinLock<u8> m_lock;
 };
 
 }
@@ -12,6 +12,7 @@
 #include <Kernel/CMOS.h>
 #include <Kernel/CommandLine.h>
 #include <Kernel/DMI.h>
+#include <Kernel/DeferredWorkQueue.h>
 #include <Kernel/Devices/BXVGADevice.h>
 #include <Kernel/Devices/FullDevice.h>
 #include <Kernel/Devices/HID/HIDManagement.h>
@@ -49,6 +50,8 @@
 #include <Kernel/TTY/PTYMultiplexer.h>
 #include <Kernel/TTY/VirtualConsole.h>
 #include <Kernel/Tasks/FinalizerTask.h>
+#include <Kernel/Tasks/PageCompressionTask.h>
+#include <Kernel/Tasks/PageZeroingTask.h>
 #include <Kernel/Tasks/SyncTask.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/VM/MemoryManager.h>
@@ -128,6 +131,7 @@ extern "C" UNMAP_AFTER_INIT [[noreturn]] void init()
     s_bsp_processor.initialize(0);
 
     CommandLine::initialize();
+    Processor::initialize_idle();
     MemoryManager::initialize(0);
 
     // Ensure that the safemem sections are not empty. This could happen if the linker accidentally discards the sections.
@@ -228,8 +232,13 @@ void init_stage2(void*)
         APIC::the().boot_aps();
     }
 
+    DeferredWorkQueue::initialize();
+
     SyncTask::spawn();
     FinalizerTask::spawn();
+    PageZeroingTask::spawn();
+    if (kernel_command_line().is_page_compression_enabled())
+        PageCompressionTask::spawn();
 
     PCI::initialize();
     auto boot_profiling = kernel_command_line().is_boot_profiling_enabled();
@@ -309,7 +318,7 @@ void init_stage2(void*)
 
     if (boot_profiling) {
         dbgln("Starting full system boot profiling");
-        auto result = Process::current()->sys$profiling_enable(-1);
+        auto result = Process::current()->sys$profiling_enable(-1, PERF_COUNTER_TIMER, 0);
         VERIFY(!result.is_error());
     }
 
@@ -23,6 +23,7 @@ set(VIRTIO_DEBUG ON)
 set(IOAPIC_DEBUG ON)
 set(IRQ_DEBUG ON)
 set(INTERRUPT_DEBUG ON)
+set(DEFERRED_WORK_DEBUG ON)
 set(E1000_DEBUG ON)
 set(IPV4_SOCKET_DEBUG ON)
 set(LOCAL_SOCKET_DEBUG ON)
@@ -58,6 +59,7 @@ set(HUNKS_DEBUG ON)
 set(JOB_DEBUG ON)
 set(GIF_DEBUG ON)
 set(JPG_DEBUG ON)
+set(JS_BYTECODE_DEBUG ON)
 set(EMOJI_DEBUG ON)
 set(FILL_PATH_DEBUG ON)
 set(PNG_DEBUG ON)
@@ -132,6 +134,7 @@ set(GLOBAL_DTORS_DEBUG ON)
 set(HEAP_DEBUG ON)
 set(HEX_DEBUG ON)
 set(HTML_SCRIPT_DEBUG ON)
+set(HTTP2_DEBUG ON)
 set(HTTPSJOB_DEBUG ON)
 set(ICMP_DEBUG ON)
 set(ICO_DEBUG ON)
@@ -140,6 +143,7 @@ set(IRC_DEBUG ON)
 set(KEYBOARD_DEBUG ON)
 set(LEXER_DEBUG ON)
 set(LOOKUPSERVER_DEBUG ON)
+set(LOOPBACK_DEBUG ON)
 set(MALLOC_DEBUG ON)
 set(MBR_DEBUG ON)
 set(MEMORY_DEBUG ON)
@@ -165,6 +169,7 @@ set(UHCI_VERBOSE_DEBUG ON)
 set(UPDATE_COALESCING_DEBUG ON)
 set(VOLATILE_PAGE_RANGES_DEBUG ON)
 set(WSMESSAGELOOP_DEBUG ON)
+set(WEBSERVER_DEBUG ON)
 set(GPT_DEBUG ON)
 set(CPP_DEBUG ON)
 set(DEBUG_SPAM ON)
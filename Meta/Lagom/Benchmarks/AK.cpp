@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Benchmark.h"
+#include <AK/HashMap.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
+#include <AK/Vector.h>
+
+static constexpr size_t element_count = 10'000;
+
+// A fixed sequence that looks random enough to defeat the branch predictor, and is the same in every run.
+static Vector<u32> pseudo_random_numbers(size_t count)
+{
+    Vector<u32> numbers;
+    numbers.ensure_capacity(count);
+    u32 state = 0x2545f491;
+    for (size_t i = 0; i < count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        numbers.unchecked_append(state);
+    }
+    return numbers;
+}
+
+BENCHMARK(ak_hashmap_set_and_get_integers)
+{
+    static auto keys = pseudo_random_numbers(element_count);
+    HashMap<u32, u32> map;
+    for (auto key : keys)
+        map.set(key, key);
+    u32 sum = 0;
+    for (auto key : keys)
+        sum += map.get(key).value();
+    Benchmark::do_not_optimize(sum);
+}
+
+BENCHMARK(ak_hashmap_set_and_get_strings)
+{
+    static auto keys = [] {
+        Vector<String> keys;
+        for (auto number : pseudo_random_numbers(element_count / 10))
+            keys.append(String::formatted("key-{}", number));
+        return keys;
+    }();
+    HashMap<String, size_t> map;
+    for (size_t i = 0; i < keys.size(); ++i)
+        map.set(keys[i], i);
+    size_t sum = 0;
+    for (auto& key : keys)
+        sum += map.get(key).value();
+    Benchmark::do_not_optimize(sum);
+}
+
+BENCHMARK(ak_string_builder_append)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < element_count / 10; ++i) {
+        builder.append("line ");
+        builder.append(':');
+        builder.appendff("{}", i);
+        builder.append('\n');
+    }
+    auto string = builder.to_string();
+    Benchmark::do_not_optimize(string);
+}
+
+BENCHMARK(ak_string_formatted)
+{
+    for (size_t i = 0; i < 100; ++i) {
+        auto string = String::formatted("{} of {}: {:.2f}", i, 100, i / 3.0);
+        Benchmark::do_not_optimize(string);
+    }
+}
+
+BENCHMARK(ak_vector_append)
+{
+    Vector<u32> vector;
+    for (size_t i = 0; i < element_count; ++i)
+        vector.append(i);
+    Benchmark::do_not_optimize(vector);
+}
+
+BENCHMARK(ak_vector_sort)
+{
+    static auto numbers = pseudo_random_numbers(element_count);
+    auto vector = numbers;
+    quick_sort(vector);
+    Benchmark::do_not_optimize(vector);
+}
+
+// Something shaped like what the system services pass around: an array of objects with a few fields each.
+static String make_json_document()
+{
+    JsonArray array;
+    auto numbers = pseudo_random_numbers(element_count / 10);
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        JsonObject object;
+        object.set("pid", i);
+        object.set("name", String::formatted("process-{}", numbers[i]));
+        object.set("amount_virtual", numbers[i]);
+        object.set("cpu_percent", numbers[i] / 1e9);
+        object.set("kernel", i % 7 == 0);
+        array.append(move(object));
+    }
+    return array.to_string();
+}
+
+BENCHMARK(ak_json_parse)
+{
+    static auto document = make_json_document();
+    auto json = JsonValue::from_string(document);
+    Benchmark::do_not_optimize(json);
+}
+
+BENCHMARK(ak_json_serialize)
+{
+    static auto json = JsonValue::from_string(make_json_document()).value();
+    auto string = json.to_string();
+    Benchmark::do_not_optimize(string);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/String.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+// A benchmark is a function that does one unit of work. It's called repeatedly, first to warm up, and then in samples
+// of as many calls as it takes to fill the minimum sample time, so that even very short ones can be measured.
+// Anything a benchmark needs as input should be built in a function-local static, which happens during the warmup.
+
+namespace Benchmark {
+
+struct Case {
+    const char* name;
+    void (*function)();
+};
+
+Vector<Case>& all_cases();
+
+struct Registration {
+    Registration(const char* name, void (*function)())
+    {
+        all_cases().append({ name, function });
+    }
+};
+
+// Keeps the compiler from throwing away a result that the benchmark doesn't otherwise use.
+template<typename T>
+ALWAYS_INLINE void do_not_optimize(const T& value)
+{
+    asm volatile(""
+                 :
+                 : "r"(&value)
+                 : "memory");
+}
+
+// The path of a file in the source tree, which is where benchmarks find real data like the images in Base/.
+String source_path(const StringView& relative_path);
+
+// Reads a file from the source tree. Exits if it's not there, since none of the numbers would mean anything without it.
+ByteBuffer read_source_file(const StringView& relative_path);
+
+}
+
+#define BENCHMARK(name)                                                                        \
+    static void __benchmark_##name();                                                          \
+    static Benchmark::Registration __benchmark_registration_##name(#name, __benchmark_##name); \
+    static void __benchmark_##name()
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Benchmark.h"
+#include <LibCompress/Deflate.h>
+
+// Our own source code is a decent stand-in for the text that usually gets compressed.
+static ByteBuffer make_input()
+{
+    auto source = Benchmark::read_source_file("AK/Format.cpp");
+    auto input = ByteBuffer::create_uninitialized(256 * KiB);
+    for (size_t offset = 0; offset < input.size(); offset += source.size())
+        input.overwrite(offset, source.data(), min(source.size(), input.size() - offset));
+    return input;
+}
+
+BENCHMARK(libcompress_deflate_compress)
+{
+    static auto input = make_input();
+    auto compressed = Compress::DeflateCompressor::compress_all(input);
+    Benchmark::do_not_optimize(compressed);
+}
+
+BENCHMARK(libcompress_deflate_compress_fast)
+{
+    static auto input = make_input();
+    auto compressed = Compress::DeflateCompressor::compress_all(input, Compress::DeflateCompressor::CompressionLevel::FAST);
+    Benchmark::do_not_optimize(compressed);
+}
+
+BENCHMARK(libcompress_deflate_decompress)
+{
+    static auto compressed = Compress::DeflateCompressor::compress_all(make_input()).value();
+    auto decompressed = Compress::DeflateDecompressor::decompress_all(compressed);
+    Benchmark::do_not_optimize(decompressed);
+}
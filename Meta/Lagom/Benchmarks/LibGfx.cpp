@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Benchmark.h"
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/JPGLoader.h>
+#include <LibGfx/PNGLoader.h>
+#include <LibGfx/PNGWriter.h>
+#include <LibGfx/Painter.h>
+
+// A gradient with some alpha in it, so that neither the PNG filters nor the blending get an easy ride.
+static NonnullRefPtr<Gfx::Bitmap> make_bitmap(Gfx::BitmapFormat format, const Gfx::IntSize& size)
+{
+    auto bitmap = Gfx::Bitmap::create(format, size).release_nonnull();
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x)
+            bitmap->set_pixel(x, y, Gfx::Color(x * 255 / size.width(), y * 255 / size.height(), (x ^ y) & 0xff, 128 + (x + y) % 128));
+    }
+    return bitmap;
+}
+
+static NonnullRefPtr<Gfx::Bitmap> target_bitmap()
+{
+    static auto target = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRx8888, { 1024, 768 }).release_nonnull();
+    return target;
+}
+
+BENCHMARK(libgfx_png_decode)
+{
+    static auto png = Gfx::PNGWriter::encode(make_bitmap(Gfx::BitmapFormat::BGRA8888, { 256, 256 }));
+    auto bitmap = Gfx::load_png_from_memory(png.data(), png.size());
+    Benchmark::do_not_optimize(bitmap);
+}
+
+BENCHMARK(libgfx_png_encode)
+{
+    static auto bitmap = make_bitmap(Gfx::BitmapFormat::BGRA8888, { 256, 256 });
+    auto png = Gfx::PNGWriter::encode(bitmap);
+    Benchmark::do_not_optimize(png);
+}
+
+BENCHMARK(libgfx_jpg_decode)
+{
+    static auto jpg = Benchmark::read_source_file("Base/res/html/misc/jpgsuite_files/non-subsampled-lena.jpg");
+    auto bitmap = Gfx::load_jpg_from_memory(jpg.data(), jpg.size());
+    Benchmark::do_not_optimize(bitmap);
+}
+
+BENCHMARK(libgfx_jpg_decode_subsampled)
+{
+    static auto jpg = Benchmark::read_source_file("Base/res/html/misc/jpgsuite_files/chroma-quartered-lena.jpg");
+    auto bitmap = Gfx::load_jpg_from_memory(jpg.data(), jpg.size());
+    Benchmark::do_not_optimize(bitmap);
+}
+
+BENCHMARK(libgfx_painter_blit_opaque)
+{
+    static auto source = make_bitmap(Gfx::BitmapFormat::BGRx8888, { 512, 512 });
+    Gfx::Painter painter(target_bitmap());
+    painter.blit({ 100, 100 }, source, source->rect());
+}
+
+BENCHMARK(libgfx_painter_blit_alpha)
+{
+    static auto source = make_bitmap(Gfx::BitmapFormat::BGRA8888, { 512, 512 });
+    Gfx::Painter painter(target_bitmap());
+    painter.blit({ 100, 100 }, source, source->rect());
+}
+
+BENCHMARK(libgfx_painter_blit_opacity)
+{
+    static auto source = make_bitmap(Gfx::BitmapFormat::BGRx8888, { 512, 512 });
+    Gfx::Painter painter(target_bitmap());
+    painter.blit({ 100, 100 }, source, source->rect(), 0.5f);
+}
+
+BENCHMARK(libgfx_painter_draw_scaled_bitmap)
+{
+    static auto source = make_bitmap(Gfx::BitmapFormat::BGRA8888, { 256, 256 });
+    Gfx::Painter painter(target_bitmap());
+    painter.draw_scaled_bitmap({ 0, 0, 1024, 768 }, source, source->rect());
+}
+
+BENCHMARK(libgfx_painter_fill_rect)
+{
+    Gfx::Painter painter(target_bitmap());
+    painter.fill_rect({ 0, 0, 1024, 768 }, Gfx::Color::from_rgb(0x336699));
+}
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Benchmark.h"
+#include <AK/StringBuilder.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+
+// The bigger JS benchmarks live in Userland/Libraries/LibJS/Benchmarks and are run by js-bench. These are only here
+// so that the parser and the interpreter show up next to the libraries they depend on.
+
+static String make_source()
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 100; ++i) {
+        builder.appendff("function f{}(a, b) {{ let x = [a, b, {{ key: \"value {}\" }}]; return x.length > 2 ? a * b : a + b; }}\n", i, i);
+        builder.appendff("const c{} = f{}({}, {}) + `template ${{{}}}`.length;\n", i, i, i, i + 1, i);
+    }
+    return builder.to_string();
+}
+
+static NonnullRefPtr<JS::Program> parse(const StringView& source)
+{
+    auto parser = JS::Parser(JS::Lexer(source));
+    auto program = parser.parse_program();
+    VERIFY(!parser.has_errors());
+    return program;
+}
+
+BENCHMARK(libjs_parse)
+{
+    static auto source = make_source();
+    auto program = parse(source);
+    Benchmark::do_not_optimize(program);
+}
+
+BENCHMARK(libjs_run_loop)
+{
+    static auto vm = JS::VM::create();
+    static auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    static auto program = parse("let sum = 0; for (let i = 0; i < 10000; ++i) { sum += i % 7; }");
+    interpreter->run(interpreter->global_object(), *program);
+    VERIFY(!vm->exception());
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Benchmark.h"
+#include <AK/StringBuilder.h>
+#include <LibRegex/Regex.h>
+
+// A few kilobytes of text with an email address every few lines, which is what the search benchmarks look for.
+static String make_text()
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 100; ++i) {
+        builder.appendff("Line {} has some words in it that nobody is looking for, ", i);
+        if (i % 5 == 0)
+            builder.appendff("and mail for user{}@example.com", i);
+        builder.append('\n');
+    }
+    return builder.to_string();
+}
+
+BENCHMARK(libregex_posix_match_catch_all)
+{
+    static Regex<PosixExtended> re("^.*$");
+    RegexResult result;
+    auto matched = re.match("Hello World", result);
+    Benchmark::do_not_optimize(matched);
+}
+
+BENCHMARK(libregex_posix_search)
+{
+    static Regex<PosixExtended> re("[a-z0-9]+@[a-z]+\\.com");
+    static auto text = make_text();
+    RegexResult result;
+    auto matched = re.search(text.view(), result);
+    Benchmark::do_not_optimize(matched);
+}
+
+BENCHMARK(libregex_ecma262_search)
+{
+    static Regex<ECMA262> re("\\w+@\\w+\\.com");
+    static auto text = make_text();
+    RegexResult result;
+    auto matched = re.search(text.view(), result);
+    Benchmark::do_not_optimize(matched);
+}
+
+BENCHMARK(libregex_ecma262_compile)
+{
+    Regex<ECMA262> re("^(?:[a-z0-9!#$%&'*+/=?^_`{|}~-]+(?:\\.[a-z0-9!#$%&'*+/=?^_`{|}~-]+)*)@(?:[a-z0-9](?:[a-z0-9-]*[a-z0-9])?\\.)+[a-z]{2,}$");
+    Benchmark::do_not_optimize(re);
+}
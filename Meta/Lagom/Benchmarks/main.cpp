@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "Benchmark.h"
+#include <AK/HashMap.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
+#include <LibGfx/FontDatabase.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+
+namespace Benchmark {
+
+Vector<Case>& all_cases()
+{
+    static Vector<Case> cases;
+    return cases;
+}
+
+String source_path(const StringView& relative_path)
+{
+    // The environment variable wins over the checkout the binary was built from, like it does for js-bench.
+    auto* serenity_source_dir = getenv("SERENITY_SOURCE_DIR");
+    return String::formatted("{}/{}", serenity_source_dir ? serenity_source_dir : SERENITY_SOURCE_DIR, relative_path);
+}
+
+ByteBuffer read_source_file(const StringView& relative_path)
+{
+    auto path = source_path(relative_path);
+    auto file = Core::File::open(path, Core::IODevice::ReadOnly);
+    if (file.is_error()) {
+        warnln("Failed to open {}: {}", path, file.error());
+        exit(1);
+    }
+    return file.value()->read_all();
+}
+
+}
+
+struct BenchmarkResult {
+    String name;
+    size_t samples { 0 };
+    size_t calls_per_sample { 0 };
+    // These are the time of one call, in nanoseconds.
+    double mean_ns { 0 };
+    double median_ns { 0 };
+    double min_ns { 0 };
+    double stddev_ns { 0 };
+};
+
+static u64 get_time_in_ns()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1'000'000'000 + static_cast<u64>(now.tv_nsec);
+}
+
+static u64 time_calls(void (*function)(), size_t calls)
+{
+    auto start_time = get_time_in_ns();
+    for (size_t i = 0; i < calls; ++i)
+        function();
+    return get_time_in_ns() - start_time;
+}
+
+static BenchmarkResult run_benchmark(const Benchmark::Case& benchmark, size_t samples, u64 warmup_ns, u64 min_sample_ns)
+{
+    BenchmarkResult result;
+    result.name = benchmark.name;
+
+    // The first call usually builds the input, so it doesn't count towards the warmup. The warmup then tells us roughly
+    // how long a call takes, which decides how many of them go into a sample.
+    benchmark.function();
+    size_t warmup_calls = 0;
+    u64 warmup_time = 0;
+    do {
+        warmup_time += time_calls(benchmark.function, 1);
+        ++warmup_calls;
+    } while (warmup_time < warmup_ns);
+    auto time_per_call = max<u64>(warmup_time / warmup_calls, 1);
+    result.calls_per_sample = max<u64>(min_sample_ns / time_per_call, 1);
+
+    Vector<double> times;
+    for (size_t i = 0; i < samples; ++i)
+        times.append(static_cast<double>(time_calls(benchmark.function, result.calls_per_sample)) / result.calls_per_sample);
+
+    double sum = 0;
+    for (auto time : times)
+        sum += time;
+    result.mean_ns = sum / samples;
+
+    double squared_deviations = 0;
+    for (auto time : times)
+        squared_deviations += (time - result.mean_ns) * (time - result.mean_ns);
+    result.stddev_ns = samples > 1 ? sqrt(squared_deviations / (samples - 1)) : 0;
+
+    quick_sort(times);
+    result.samples = samples;
+    result.min_ns = times.first();
+    result.median_ns = samples % 2 ? times[samples / 2] : (times[samples / 2 - 1] + times[samples / 2]) / 2;
+    return result;
+}
+
+static JsonObject result_to_json(const BenchmarkResult& result)
+{
+    JsonObject object;
+    object.set("name", result.name);
+    object.set("samples", result.samples);
+    object.set("calls_per_sample", result.calls_per_sample);
+    object.set("mean_ns", result.mean_ns);
+    object.set("median_ns", result.median_ns);
+    object.set("min_ns", result.min_ns);
+    object.set("stddev_ns", result.stddev_ns);
+    return object;
+}
+
+static Optional<HashMap<String, double>> load_baseline(const String& path)
+{
+    auto file = Core::File::construct(path);
+    if (!file->open(Core::IODevice::ReadOnly)) {
+        warnln("Failed to open the baseline {}", path);
+        return {};
+    }
+    auto json = JsonValue::from_string(file->read_all());
+    if (!json.has_value() || !json->is_object() || !json->as_object().get("benchmarks").is_array()) {
+        warnln("The baseline {} is not the output of lagom-bench --json", path);
+        return {};
+    }
+
+    HashMap<String, double> median_times;
+    json->as_object().get("benchmarks").as_array().for_each([&](auto& value) {
+        if (!value.is_object())
+            return;
+        auto& benchmark = value.as_object();
+        auto median = benchmark.get("median_ns");
+        if (median.is_number())
+            median_times.set(benchmark.get("name").to_string(), median.template to_number<double>());
+    });
+    return median_times;
+}
+
+// Picks a unit that keeps the numbers readable, since the benchmarks range from nanoseconds to milliseconds.
+static String format_time(double ns)
+{
+    if (ns >= 1'000'000)
+        return String::formatted("{:.2f} ms", ns / 1'000'000);
+    if (ns >= 1'000)
+        return String::formatted("{:.2f} us", ns / 1'000);
+    return String::formatted("{:.1f} ns", ns);
+}
+
+int main(int argc, char** argv)
+{
+    int samples = 20;
+    int warmup_ms = 100;
+    int min_sample_ms = 10;
+    bool print_json = false;
+    bool list = false;
+    const char* baseline_path = nullptr;
+    double threshold = 10;
+    const char* filter = nullptr;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Run the Lagom benchmarks, and optionally compare them against an earlier run.");
+    args_parser.add_option(samples, "Number of measured samples (default: 20)", "samples", 's', "count");
+    args_parser.add_option(warmup_ms, "How long to run a benchmark before measuring it (default: 100)", "warmup", 'w', "ms");
+    args_parser.add_option(min_sample_ms, "How long a sample should take at least (default: 10)", "sample-time", 'm', "ms");
+    args_parser.add_option(filter, "Only run the benchmarks whose name contains this", "filter", 'f', "text");
+    args_parser.add_option(list, "List the benchmarks instead of running them", "list", 'l');
+    args_parser.add_option(print_json, "Print the results as JSON", "json", 'j');
+    args_parser.add_option(baseline_path, "Fail if a benchmark got slower than in this output of --json", "baseline", 'b', "file");
+    args_parser.add_option(threshold, "How many percent slower than the baseline a benchmark may get (default: 10)", "threshold", 't', "percent");
+    args_parser.parse(argc, argv);
+
+    if (samples < 1 || warmup_ms < 0 || min_sample_ms < 0) {
+        warnln("There has to be at least one sample, and the times can't be negative");
+        return 1;
+    }
+
+    // Every Painter wants the default font, and there is no /res/fonts here.
+    Gfx::FontDatabase::set_fonts_directory(Benchmark::source_path("Base/res/fonts"));
+
+    auto benchmarks = Benchmark::all_cases();
+    quick_sort(benchmarks, [](auto& a, auto& b) { return StringView(a.name) < StringView(b.name); });
+    if (filter)
+        benchmarks.remove_all_matching([&](auto& benchmark) { return !StringView(benchmark.name).contains(filter); });
+
+    if (list) {
+        for (auto& benchmark : benchmarks)
+            outln("{}", benchmark.name);
+        return 0;
+    }
+
+    Optional<HashMap<String, double>> baseline;
+    if (baseline_path) {
+        baseline = load_baseline(baseline_path);
+        if (!baseline.has_value())
+            return 1;
+    }
+
+    bool any_failed = false;
+    JsonArray json_results;
+    for (auto& benchmark : benchmarks) {
+        auto result = run_benchmark(benchmark, samples, static_cast<u64>(warmup_ms) * 1'000'000, static_cast<u64>(min_sample_ms) * 1'000'000);
+        if (!print_json) {
+            outln("{:36} {:>12} median {:>12} mean {:>12} stddev {:>10} calls",
+                result.name, format_time(result.median_ns), format_time(result.mean_ns), format_time(result.stddev_ns), result.calls_per_sample * result.samples);
+        }
+
+        if (baseline.has_value()) {
+            if (auto baseline_time = baseline->get(result.name); baseline_time.has_value() && baseline_time.value() > 0) {
+                auto change = (result.median_ns / baseline_time.value() - 1) * 100;
+                if (change > threshold) {
+                    any_failed = true;
+                    warnln("{}: {} is {:.1f}% slower than the baseline ({})", result.name, format_time(result.median_ns), change, format_time(baseline_time.value()));
+                }
+            }
+        }
+        json_results.append(result_to_json(result));
+    }
+
+    if (print_json) {
+        JsonObject json;
+        json.set("benchmarks", move(json_results));
+        outln("{}", json.to_string());
+    }
+
+    return any_failed ? 1 : 0;
+}
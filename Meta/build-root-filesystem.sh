@@ -98,6 +98,7 @@ mkdir -p mnt/home/anon/Downloads
 mkdir -p mnt/home/nona
 cp "$SERENITY_SOURCE_DIR"/README.md mnt/home/anon/
 cp -r "$SERENITY_SOURCE_DIR"/Userland/Libraries/LibJS/Tests mnt/home/anon/js-tests
+cp -r "$SERENITY_SOURCE_DIR"/Userland/Libraries/LibJS/Benchmarks mnt/home/anon/js-benchmarks
 cp -r "$SERENITY_SOURCE_DIR"/Userland/Libraries/LibWeb/Tests mnt/home/anon/web-tests
 chmod 700 mnt/root
 chmod 700 mnt/home/anon
@@ -17,6 +17,7 @@
 #include <LibGUI/MessageBox.h>
 #include <LibGUI/SeparatorWidget.h>
 #include <LibGUI/TabWidget.h>
+#include <LibThread/DirectoryWalker.h>
 #include <grp.h>
 #include <limits.h>
 #include <pwd.h>
@@ -109,13 +110,16 @@ PropertiesWindow::PropertiesWindow(const String& path, bool disable_rename, Wind
         }
     }
 
-    properties.append({ "Size:", human_readable_size_long(st.st_size) });
+    auto size_index = properties.size();
+    properties.append({ "Size:", S_ISDIR(m_mode) ? "Calculating..." : human_readable_size_long(st.st_size) });
     properties.append({ "Owner:", String::formatted("{} ({})", owner_name, st.st_uid) });
     properties.append({ "Group:", String::formatted("{} ({})", group_name, st.st_gid) });
     properties.append({ "Created at:", GUI::FileSystemModel::timestamp_string(st.st_ctime) });
     properties.append({ "Last modified:", GUI::FileSystemModel::timestamp_string(st.st_mtime) });
 
-    make_property_value_pairs(properties, general_tab);
+    auto value_labels = make_property_value_pairs(properties, general_tab);
+    if (S_ISDIR(m_mode))
+        calculate_directory_size(value_labels[size_index]);
 
     general_tab.add<GUI::SeparatorWidget>(Gfx::Orientation::Horizontal);
 
@@ -149,6 +153,35 @@ PropertiesWindow::PropertiesWindow(const String& path, bool disable_rename, Wind
 
 PropertiesWindow::~PropertiesWindow()
 {
+    if (m_directory_size_action) {
+        m_directory_size_cancellation_token->cancel();
+        m_directory_size_action->cancel();
+    }
+}
+
+void PropertiesWindow::calculate_directory_size(GUI::Label& size_label)
+{
+    // Directories can be huge, so their contents are added up in the background. The order doesn't matter
+    // here, which lets the walker keep all of its threads busy.
+    auto cancellation_token = LibThread::CancellationToken::create();
+    m_directory_size_cancellation_token = cancellation_token;
+    m_directory_size_action = LibThread::BackgroundAction<u64>::create(
+        [path = m_path, cancellation_token] {
+            u64 size = 0;
+            LibThread::DirectoryWalker walker;
+            walker.set_order(LibThread::DirectoryWalker::Order::Unordered);
+            walker.walk(path, [&](auto& entry) {
+                if (cancellation_token->is_cancelled())
+                    return IterationDecision::Break;
+                if (entry.stat.has_value())
+                    size += entry.stat.value().st_size;
+                return IterationDecision::Continue;
+            });
+            return size;
+        },
+        [&size_label](u64 size) {
+            size_label.set_text(human_readable_size_long(size));
+        });
 }
 
 void PropertiesWindow::update()
@@ -244,12 +277,14 @@ void PropertiesWindow::make_permission_checkboxes(GUI::Widget& parent, Permissio
     box_execute.set_enabled(can_edit_checkboxes);
 }
 
-void PropertiesWindow::make_property_value_pairs(const Vector<PropertyValuePair>& pairs, GUI::Widget& parent)
+Vector<NonnullRefPtr<GUI::Label>> PropertiesWindow::make_property_value_pairs(const Vector<PropertyValuePair>& pairs, GUI::Widget& parent)
 {
     int max_width = 0;
     Vector<NonnullRefPtr<GUI::Label>> property_labels;
+    Vector<NonnullRefPtr<GUI::Label>> value_labels;
 
     property_labels.ensure_capacity(pairs.size());
+    value_labels.ensure_capacity(pairs.size());
     for (auto pair : pairs) {
         auto& label_container = parent.add<GUI::Widget>();
         label_container.set_layout<GUI::HorizontalBoxLayout>();
@@ -260,13 +295,16 @@ void PropertiesWindow::make_property_value_pairs(const Vector<PropertyValuePair>
         label_property.set_text_alignment(Gfx::TextAlignment::CenterLeft);
 
         if (!pair.link.has_value()) {
-            label_container.add<GUI::Label>(pair.value).set_text_alignment(Gfx::TextAlignment::CenterLeft);
+            auto& label_value = label_container.add<GUI::Label>(pair.value);
+            label_value.set_text_alignment(Gfx::TextAlignment::CenterLeft);
+            value_labels.append(label_value);
         } else {
             auto& link = label_container.add<GUI::LinkLabel>(pair.value);
             link.set_text_alignment(Gfx::TextAlignment::CenterLeft);
             link.on_click = [pair]() {
                 Desktop::Launcher::open(pair.link.value());
             };
+            value_labels.append(link);
         }
 
         max_width = max(max_width, label_property.font().width(pair.property));
@@ -275,6 +313,8 @@ void PropertiesWindow::make_property_value_pairs(const Vector<PropertyValuePair>
 
     for (auto label : property_labels)
         label->set_fixed_width(max_width);
+
+    return value_labels;
 }
 
 GUI::Button& PropertiesWindow::make_button(String text, GUI::Widget& parent)
@@ -13,6 +13,7 @@
 #include <LibGUI/ImageWidget.h>
 #include <LibGUI/Label.h>
 #include <LibGUI/TextBox.h>
+#include <LibThread/BackgroundAction.h>
 
 class PropertiesWindow final : public GUI::Window {
     C_OBJECT(PropertiesWindow);
@@ -58,11 +59,13 @@ private:
     }
 
     GUI::Button& make_button(String, GUI::Widget& parent);
-    void make_property_value_pairs(const Vector<PropertyValuePair>& pairs, GUI::Widget& parent);
+    // Returns the labels with the values, in the same order as the pairs.
+    Vector<NonnullRefPtr<GUI::Label>> make_property_value_pairs(const Vector<PropertyValuePair>& pairs, GUI::Widget& parent);
     void make_permission_checkboxes(GUI::Widget& parent, PermissionMasks, String label_string, mode_t mode);
     void permission_changed(mode_t mask, bool set);
     bool apply_changes();
     void update();
+    void calculate_directory_size(GUI::Label& size_label);
     String make_full_path(const String& name);
 
     RefPtr<GUI::Button> m_apply_button;
@@ -75,4 +78,6 @@ private:
     mode_t m_old_mode { 0 };
     bool m_permissions_dirty { false };
     bool m_name_dirty { false };
+    RefPtr<LibThread::CancellationToken> m_directory_size_cancellation_token;
+    RefPtr<LibThread::BackgroundAction<u64>> m_directory_size_action;
 };
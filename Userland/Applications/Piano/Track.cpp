@@ -209,7 +209,7 @@ Audio::Frame Track::recorded_sample(size_t note)
     }
     double recorded_sample_step = note_frequencies[note] / middle_c;
     m_pos[note] += recorded_sample_step;
-    return { w_left, w_right };
+    return Audio::Frame(w_left, w_right);
 }
 
 static inline double calculate_step(double distance, int milliseconds)
@@ -53,6 +53,7 @@ void EllipseTool::on_mouseup(Layer& layer, GUI::MouseEvent& event, GUI::MouseEve
     if (event.button() == m_drawing_button) {
         GUI::Painter painter(layer.bitmap());
         draw_using(painter, Gfx::IntRect::from_two_points(m_ellipse_start_position, m_ellipse_end_position));
+        layer.did_modify_bitmap(*m_editor->image());
         m_drawing_button = GUI::MouseButton::None;
         m_editor->update();
         m_editor->did_complete_action();
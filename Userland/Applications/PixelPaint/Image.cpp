@@ -15,6 +15,7 @@
 #include <LibGfx/BMPWriter.h>
 #include <LibGfx/ImageDecoder.h>
 #include <LibGfx/PNGWriter.h>
+#include <LibThread/Parallel.h>
 #include <stdio.h>
 
 namespace PixelPaint {
@@ -37,16 +38,68 @@ Image::Image(const Gfx::IntSize& size)
 
 void Image::paint_into(GUI::Painter& painter, const Gfx::IntRect& dest_rect)
 {
-    float scale = (float)dest_rect.width() / (float)rect().width();
+    update_composite();
     Gfx::PainterStateSaver saver(painter);
     painter.add_clip_rect(dest_rect);
-    for (auto& layer : m_layers) {
-        if (!layer.is_visible())
+    painter.draw_scaled_bitmap(dest_rect, *m_composite, rect());
+}
+
+static size_t composite_tile_columns(const Gfx::IntSize& size)
+{
+    return (size.width() + Layer::tile_size - 1) / Layer::tile_size;
+}
+
+void Image::invalidate_composite(const Gfx::IntRect& a_rect)
+{
+    // Until there is a composite, all of it is going to be composited anyway.
+    if (!m_composite)
+        return;
+    auto rect = a_rect.intersected(this->rect());
+    if (rect.is_empty())
+        return;
+    auto columns = composite_tile_columns(m_size);
+    for (int row = rect.top() / Layer::tile_size; row <= rect.bottom() / Layer::tile_size; ++row) {
+        for (int column = rect.left() / Layer::tile_size; column <= rect.right() / Layer::tile_size; ++column)
+            m_composite_tile_is_dirty[row * columns + column] = true;
+    }
+}
+
+void Image::update_composite()
+{
+    auto columns = composite_tile_columns(m_size);
+    if (!m_composite) {
+        m_composite = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, m_size);
+        VERIFY(m_composite);
+        auto rows = (m_size.height() + Layer::tile_size - 1) / Layer::tile_size;
+        m_composite_tile_is_dirty.clear();
+        m_composite_tile_is_dirty.ensure_capacity(columns * rows);
+        for (size_t i = 0; i < columns * rows; ++i)
+            m_composite_tile_is_dirty.append(true);
+    }
+
+    Vector<size_t> dirty_tiles;
+    for (size_t i = 0; i < m_composite_tile_is_dirty.size(); ++i) {
+        if (!m_composite_tile_is_dirty[i])
             continue;
-        auto target = dest_rect.translated(layer.location().x() * scale, layer.location().y() * scale);
-        target.set_size(layer.size().width() * scale, layer.size().height() * scale);
-        painter.draw_scaled_bitmap(target, layer.bitmap(), layer.rect(), (float)layer.opacity_percent() / 100.0f);
+        dirty_tiles.append(i);
+        m_composite_tile_is_dirty[i] = false;
     }
+
+    // The tiles don't overlap, so each one can be composited on a thread of its own.
+    LibThread::parallel_for(0, dirty_tiles.size(), 1, [&](size_t i) {
+        auto index = dirty_tiles[i];
+        Gfx::IntRect tile_rect { (int)(index % columns) * Layer::tile_size, (int)(index / columns) * Layer::tile_size, Layer::tile_size, Layer::tile_size };
+        tile_rect.intersect(rect());
+
+        Gfx::Painter painter(*m_composite);
+        painter.add_clip_rect(tile_rect);
+        painter.clear_rect(tile_rect, Color::Transparent);
+        for (auto& layer : m_layers) {
+            if (!layer.is_visible())
+                continue;
+            painter.blit(layer.location(), layer.bitmap(), layer.rect(), (float)layer.opacity_percent() / 100.0f);
+        }
+    });
 }
 
 RefPtr<Image> Image::create_from_file(const String& file_path)
@@ -72,16 +125,18 @@ RefPtr<Image> Image::create_from_file(const String& file_path)
         auto height = json_layer_object.get("height").to_i32();
         auto name = json_layer_object.get("name").as_string();
         auto layer = Layer::create_with_size(*image, { width, height }, name);
-        layer->set_location({ json_layer_object.get("locationx").to_i32(), json_layer_object.get("locationy").to_i32() });
-        layer->set_opacity_percent(json_layer_object.get("opacity_percent").to_i32());
-        layer->set_visible(json_layer_object.get("visible").as_bool());
-        layer->set_selected(json_layer_object.get("selected").as_bool());
 
         auto bitmap_base64_encoded = json_layer_object.get("bitmap").as_string();
         auto bitmap_data = decode_base64(bitmap_base64_encoded);
         auto image_decoder = Gfx::ImageDecoder::create(bitmap_data);
         layer->set_bitmap(*image_decoder->bitmap());
+        // The setters let the image know about the change, so the layer has to be part of it already.
         image->add_layer(*layer);
+
+        layer->set_location({ json_layer_object.get("locationx").to_i32(), json_layer_object.get("locationy").to_i32() });
+        layer->set_opacity_percent(json_layer_object.get("opacity_percent").to_i32());
+        layer->set_visible(json_layer_object.get("visible").as_bool());
+        layer->set_selected(json_layer_object.get("selected").as_bool());
     });
 
     return image;
@@ -171,7 +226,7 @@ void Image::restore_snapshot(const Image& snapshot)
     m_layers.clear();
     select_layer(nullptr);
     for (const auto& snapshot_layer : snapshot.m_layers) {
-        auto layer = Layer::create_snapshot(*this, snapshot_layer);
+        auto layer = Layer::create_from_snapshot(*this, snapshot_layer);
         if (layer->is_selected())
             select_layer(layer.ptr());
         add_layer(*layer);
@@ -244,6 +299,8 @@ void Image::change_layer_index(size_t old_index, size_t new_index)
 
 void Image::did_modify_layer_stack()
 {
+    invalidate_composite(rect());
+
     for (auto* client : m_clients)
         client->image_did_modify_layer_stack();
 
@@ -280,8 +337,10 @@ void Image::remove_client(ImageClient& client)
     m_clients.remove(&client);
 }
 
-void Image::layer_did_modify_bitmap(Badge<Layer>, const Layer& layer)
+void Image::layer_did_modify_bitmap(Badge<Layer>, const Layer& layer, const Gfx::IntRect& rect)
 {
+    invalidate_composite(rect.translated(layer.location()));
+
     auto layer_index = index_of(layer);
     for (auto* client : m_clients)
         client->image_did_modify_layer(layer_index);
@@ -291,6 +350,20 @@ void Image::layer_did_modify_bitmap(Badge<Layer>, const Layer& layer)
 
 void Image::layer_did_modify_properties(Badge<Layer>, const Layer& layer)
 {
+    invalidate_composite(layer.relative_rect());
+
+    auto layer_index = index_of(layer);
+    for (auto* client : m_clients)
+        client->image_did_modify_layer(layer_index);
+
+    did_change();
+}
+
+void Image::layer_did_move(Badge<Layer>, const Layer& layer, const Gfx::IntRect& old_rect)
+{
+    invalidate_composite(old_rect);
+    invalidate_composite(layer.relative_rect());
+
     auto layer_index = index_of(layer);
     for (auto* client : m_clients)
         client->image_did_modify_layer(layer_index);
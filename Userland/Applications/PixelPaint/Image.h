@@ -66,8 +66,9 @@ public:
     void add_client(ImageClient&);
     void remove_client(ImageClient&);
 
-    void layer_did_modify_bitmap(Badge<Layer>, const Layer&);
+    void layer_did_modify_bitmap(Badge<Layer>, const Layer&, const Gfx::IntRect&);
     void layer_did_modify_properties(Badge<Layer>, const Layer&);
+    void layer_did_move(Badge<Layer>, const Layer&, const Gfx::IntRect& old_rect);
 
     size_t index_of(const Layer&) const;
 
@@ -77,9 +78,16 @@ private:
     void did_change();
     void did_modify_layer_stack();
 
+    void invalidate_composite(const Gfx::IntRect&);
+    void update_composite();
+
     Gfx::IntSize m_size;
     NonnullRefPtrVector<Layer> m_layers;
 
+    // All the visible layers blended together. It's composited again tile by tile, and only where the layers changed.
+    RefPtr<Gfx::Bitmap> m_composite;
+    Vector<bool> m_composite_tile_is_dirty;
+
     HashTable<ImageClient*> m_clients;
 };
 
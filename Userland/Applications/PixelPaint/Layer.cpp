@@ -7,6 +7,8 @@
 #include "Layer.h"
 #include "Image.h"
 #include <LibGfx/Bitmap.h>
+#include <LibThread/Parallel.h>
+#include <string.h>
 
 namespace PixelPaint {
 
@@ -34,24 +36,71 @@ RefPtr<Layer> Layer::create_with_bitmap(Image& image, const Gfx::Bitmap& bitmap,
 
 RefPtr<Layer> Layer::create_snapshot(Image& image, const Layer& layer)
 {
-    auto snapshot = create_with_bitmap(image, *layer.bitmap().clone(), layer.name());
-    /*
-        We set these properties directly because calling the setters might 
-        notify the image of an update on the newly created layer, but this 
-        layer has not yet been added to the image.
-    */
-    snapshot->m_opacity_percent = layer.opacity_percent();
-    snapshot->m_visible = layer.is_visible();
+    layer.update_tiles();
+    return adopt_ref(*new Layer(image, layer));
+}
+
+RefPtr<Layer> Layer::create_from_snapshot(Image& image, const Layer& snapshot)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, snapshot.size());
+    if (!bitmap)
+        return nullptr;
+
+    auto layer = adopt_ref(*new Layer(image, snapshot));
+    layer->m_bitmap = bitmap;
+    LibThread::parallel_for(0, layer->m_tiles.size(), 1, [&](size_t index) {
+        auto rect = layer->tile_rect(index);
+        auto& tile = *layer->m_tiles[index];
+        for (int y = 0; y < rect.height(); ++y)
+            memcpy(bitmap->scanline(rect.y() + y) + rect.x(), tile.scanline(y), rect.width() * sizeof(Gfx::RGBA32));
+    });
+    return layer;
+}
 
-    snapshot->set_selected(layer.is_selected());
-    snapshot->set_location(layer.location());
+static bool tile_has_same_contents(const Gfx::Bitmap& tile, const Gfx::Bitmap& bitmap, const Gfx::IntRect& rect)
+{
+    for (int y = 0; y < rect.height(); ++y) {
+        if (memcmp(tile.scanline(y), bitmap.scanline(rect.y() + y) + rect.x(), rect.width() * sizeof(Gfx::RGBA32)) != 0)
+            return false;
+    }
+    return true;
+}
+
+Gfx::IntRect Layer::tile_rect(size_t index) const
+{
+    size_t columns = (m_size.width() + tile_size - 1) / tile_size;
+    Gfx::IntRect rect { (int)(index % columns) * tile_size, (int)(index / columns) * tile_size, tile_size, tile_size };
+    return rect.intersected(this->rect());
+}
 
-    return snapshot;
+void Layer::update_tiles() const
+{
+    VERIFY(m_bitmap);
+    size_t tile_count = ((m_size.width() + tile_size - 1) / tile_size) * ((m_size.height() + tile_size - 1) / tile_size);
+    if (m_tiles.size() != tile_count) {
+        m_tiles.clear();
+        m_tiles.resize(tile_count);
+    }
+
+    // Comparing a tile is a lot cheaper than keeping another copy of it around, so we don't bother
+    // tracking which ones the tools have drawn on.
+    LibThread::parallel_for(0, tile_count, 1, [&](size_t index) {
+        auto rect = tile_rect(index);
+        auto& tile = m_tiles[index];
+        if (tile && tile_has_same_contents(*tile, *m_bitmap, rect))
+            return;
+        auto new_tile = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, rect.size());
+        VERIFY(new_tile);
+        for (int y = 0; y < rect.height(); ++y)
+            memcpy(new_tile->scanline(y), m_bitmap->scanline(rect.y() + y) + rect.x(), rect.width() * sizeof(Gfx::RGBA32));
+        tile = move(new_tile);
+    });
 }
 
 Layer::Layer(Image& image, const Gfx::IntSize& size, const String& name)
     : m_image(image)
     , m_name(name)
+    , m_size(size)
 {
     m_bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size);
 }
@@ -59,13 +108,41 @@ Layer::Layer(Image& image, const Gfx::IntSize& size, const String& name)
 Layer::Layer(Image& image, const Gfx::Bitmap& bitmap, const String& name)
     : m_image(image)
     , m_name(name)
+    , m_size(bitmap.size())
     , m_bitmap(bitmap)
 {
 }
 
-void Layer::did_modify_bitmap(Image& image)
+Layer::Layer(Image& image, const Layer& snapshot_source)
+    : m_image(image)
+    , m_name(snapshot_source.m_name)
+    , m_location(snapshot_source.m_location)
+    , m_size(snapshot_source.m_size)
+    , m_tiles(snapshot_source.m_tiles)
+    , m_selected(snapshot_source.m_selected)
+    , m_visible(snapshot_source.m_visible)
+    , m_opacity_percent(snapshot_source.m_opacity_percent)
+{
+}
+
+void Layer::set_bitmap(Gfx::Bitmap& bitmap)
 {
-    image.layer_did_modify_bitmap({}, *this);
+    m_bitmap = bitmap;
+    m_size = bitmap.size();
+}
+
+void Layer::did_modify_bitmap(Image& image, const Gfx::IntRect& rect)
+{
+    image.layer_did_modify_bitmap({}, *this, rect.is_empty() ? this->rect() : rect.intersected(this->rect()));
+}
+
+void Layer::set_location(const Gfx::IntPoint& location)
+{
+    if (m_location == location)
+        return;
+    auto old_rect = relative_rect();
+    m_location = location;
+    m_image.layer_did_move({}, *this, old_rect);
 }
 
 void Layer::set_visible(bool visible)
@@ -9,6 +9,7 @@
 #include <AK/Noncopyable.h>
 #include <AK/RefCounted.h>
 #include <AK/String.h>
+#include <AK/Vector.h>
 #include <AK/Weakable.h>
 #include <LibGfx/Bitmap.h>
 
@@ -26,16 +27,20 @@ class Layer
 public:
     static RefPtr<Layer> create_with_size(Image&, const Gfx::IntSize&, const String& name);
     static RefPtr<Layer> create_with_bitmap(Image&, const Gfx::Bitmap&, const String& name);
+    // Snapshots only hold the layer's tiles, and have no bitmap. Turn them back into a layer with create_from_snapshot().
     static RefPtr<Layer> create_snapshot(Image&, const Layer&);
+    static RefPtr<Layer> create_from_snapshot(Image&, const Layer& snapshot);
+
+    static constexpr int tile_size = 256;
 
     ~Layer() { }
 
     const Gfx::IntPoint& location() const { return m_location; }
-    void set_location(const Gfx::IntPoint& location) { m_location = location; }
+    void set_location(const Gfx::IntPoint&);
 
     const Gfx::Bitmap& bitmap() const { return *m_bitmap; }
     Gfx::Bitmap& bitmap() { return *m_bitmap; }
-    Gfx::IntSize size() const { return bitmap().size(); }
+    Gfx::IntSize size() const { return m_size; }
 
     Gfx::IntRect relative_rect() const { return { location(), size() }; }
     Gfx::IntRect rect() const { return { {}, size() }; }
@@ -43,9 +48,10 @@ public:
     const String& name() const { return m_name; }
     void set_name(const String&);
 
-    void set_bitmap(Gfx::Bitmap& bitmap) { m_bitmap = bitmap; }
+    void set_bitmap(Gfx::Bitmap&);
 
-    void did_modify_bitmap(Image&);
+    // The rect is in layer coordinates. An empty one means the whole layer may have changed.
+    void did_modify_bitmap(Image&, const Gfx::IntRect& = {});
 
     void set_selected(bool selected) { m_selected = selected; }
     bool is_selected() const { return m_selected; }
@@ -59,13 +65,22 @@ public:
 private:
     Layer(Image&, const Gfx::IntSize&, const String& name);
     Layer(Image&, const Gfx::Bitmap&, const String& name);
+    Layer(Image&, const Layer& snapshot_source);
+
+    Gfx::IntRect tile_rect(size_t index) const;
+    void update_tiles() const;
 
     Image& m_image;
 
     String m_name;
     Gfx::IntPoint m_location;
+    Gfx::IntSize m_size;
     RefPtr<Gfx::Bitmap> m_bitmap;
 
+    // The contents of the layer as of the last snapshot, in tile_size squares, row by row. Snapshots share the
+    // tiles that haven't changed since the one before them, so undo history only keeps copies of the ones that did.
+    mutable Vector<RefPtr<Gfx::Bitmap>> m_tiles;
+
     bool m_selected { false };
     bool m_visible { true };
 
@@ -298,6 +298,7 @@ int main(int argc, char** argv)
             Gfx::LaplacianFilter filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::LaplacianFilter>::get(false)) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -307,6 +308,7 @@ int main(int argc, char** argv)
             Gfx::LaplacianFilter filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::LaplacianFilter>::get(true)) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -317,6 +319,7 @@ int main(int argc, char** argv)
             Gfx::SpatialGaussianBlurFilter<3> filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::SpatialGaussianBlurFilter<3>>::get()) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -326,6 +329,7 @@ int main(int argc, char** argv)
             Gfx::SpatialGaussianBlurFilter<5> filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::SpatialGaussianBlurFilter<5>>::get()) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -335,6 +339,7 @@ int main(int argc, char** argv)
             Gfx::BoxBlurFilter<3> filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::BoxBlurFilter<3>>::get()) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -344,6 +349,7 @@ int main(int argc, char** argv)
             Gfx::BoxBlurFilter<5> filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::BoxBlurFilter<5>>::get()) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -353,6 +359,7 @@ int main(int argc, char** argv)
             Gfx::SharpenFilter filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::SharpenFilter>::get()) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -364,6 +371,7 @@ int main(int argc, char** argv)
             Gfx::GenericConvolutionFilter<5> filter;
             if (auto parameters = PixelPaint::FilterParameters<Gfx::GenericConvolutionFilter<5>>::get(window)) {
                 filter.apply(layer->bitmap(), layer->rect(), layer->bitmap(), layer->rect(), *parameters);
+                layer->did_modify_bitmap(*image_editor.image());
                 image_editor.did_complete_action();
             }
         }
@@ -390,13 +398,13 @@ int main(int argc, char** argv)
         bg_layer->bitmap().fill(Color::White);
 
         auto fg_layer1 = PixelPaint::Layer::create_with_size(*image, { 200, 200 }, "FG Layer 1");
-        fg_layer1->set_location({ 50, 50 });
         image->add_layer(*fg_layer1);
+        fg_layer1->set_location({ 50, 50 });
         fg_layer1->bitmap().fill(Color::Yellow);
 
         auto fg_layer2 = PixelPaint::Layer::create_with_size(*image, { 100, 100 }, "FG Layer 2");
-        fg_layer2->set_location({ 300, 300 });
         image->add_layer(*fg_layer2);
+        fg_layer2->set_location({ 300, 300 });
         fg_layer2->bitmap().fill(Color::Blue);
 
         layer_list_widget.set_image(image);
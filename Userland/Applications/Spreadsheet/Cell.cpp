@@ -8,9 +8,14 @@
 #include "Spreadsheet.h"
 #include <AK/StringBuilder.h>
 #include <AK/TemporaryChange.h>
+#include <LibJS/AST.h>
 
 namespace Spreadsheet {
 
+Cell::~Cell()
+{
+}
+
 void Cell::set_data(String new_data)
 {
     if (m_data == new_data)
@@ -26,6 +31,7 @@ void Cell::set_data(String new_data)
     m_data = move(new_data);
     m_dirty = true;
     m_evaluated_externally = false;
+    m_is_formula_compiled = false;
 }
 
 void Cell::set_data(JS::Value new_data)
@@ -37,6 +43,7 @@ void Cell::set_data(JS::Value new_data)
 
     builder.append(new_data.to_string_without_side_effects());
     m_data = builder.build();
+    m_is_formula_compiled = false;
 
     m_evaluated_data = move(new_data);
 }
@@ -91,22 +98,16 @@ void Cell::update_data(Badge<Sheet>)
         return;
 
     m_js_exception = {};
+    m_dirty = false;
 
-    if (m_dirty) {
-        m_dirty = false;
+    // The sheet updates the cells that reference this one afterwards, in an order that has each of them come after
+    // all the cells it references.
+    if (!m_evaluated_externally) {
+        // What the cell references may change along with its data, so it's recorded anew as it's evaluated.
+        clear_references();
         if (m_kind == Formula) {
-            if (!m_evaluated_externally) {
-                auto [value, exception] = m_sheet->evaluate(m_data, this);
-                m_evaluated_data = value;
-                m_js_exception = move(exception);
-            }
-        }
-
-        for (auto& ref : m_referencing_cells) {
-            if (ref) {
-                ref->m_dirty = true;
-                ref->update();
-            }
+            TemporaryChange evaluating_change { m_is_being_evaluated, true };
+            evaluate_formula();
         }
     }
 
@@ -136,6 +137,32 @@ void Cell::update_data(Badge<Sheet>)
     }
 }
 
+void Cell::evaluate_formula()
+{
+    // Simple formulas skip the interpreter, and the rest are parsed only once.
+    if (!m_is_formula_compiled) {
+        m_native_formula = NativeFormula::parse(m_data, *m_sheet);
+        m_program = nullptr;
+        m_is_formula_compiled = true;
+    }
+    if (m_native_formula) {
+        if (auto value = m_native_formula->evaluate(*m_sheet, *this); value.has_value()) {
+            m_evaluated_data = JS::Value(value.value());
+            return;
+        }
+    }
+
+    if (!m_program)
+        m_program = m_sheet->parse(m_data);
+    if (!m_program) {
+        m_evaluated_data = JS::js_undefined();
+        return;
+    }
+    auto [value, exception] = m_sheet->evaluate(*m_program, this);
+    m_evaluated_data = value;
+    m_js_exception = move(exception);
+}
+
 void Cell::update()
 {
     m_sheet->update(*this);
@@ -161,7 +188,6 @@ String Cell::source() const
     return builder.to_string();
 }
 
-// FIXME: Find a better way to figure out dependencies
 void Cell::reference_from(Cell* other)
 {
     if (!other || other == this)
@@ -171,6 +197,16 @@ void Cell::reference_from(Cell* other)
         return;
 
     m_referencing_cells.append(other->make_weak_ptr());
+    other->m_referenced_cells.append(make_weak_ptr());
+}
+
+void Cell::clear_references()
+{
+    for (auto& referenced_cell : m_referenced_cells) {
+        if (referenced_cell)
+            referenced_cell->m_referencing_cells.remove_first_matching([this](auto& ptr) { return ptr.ptr() == this; });
+    }
+    m_referenced_cells.clear();
 }
 
 void Cell::copy_from(const Cell& other)
@@ -178,6 +214,7 @@ void Cell::copy_from(const Cell& other)
     m_dirty = true;
     m_evaluated_externally = other.m_evaluated_externally;
     m_data = other.m_data;
+    m_is_formula_compiled = false;
     m_evaluated_data = other.m_evaluated_data;
     m_kind = other.m_kind;
     m_type = other.m_type;
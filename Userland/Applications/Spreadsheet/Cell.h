@@ -10,6 +10,7 @@
 #include "ConditionalFormatting.h"
 #include "Forward.h"
 #include "JSIntegration.h"
+#include "NativeFormula.h"
 #include "Position.h"
 #include <AK/String.h>
 #include <AK/Types.h>
@@ -42,12 +43,17 @@ struct Cell : public Weakable<Cell> {
     {
     }
 
-    void reference_from(Cell*);
+    ~Cell();
+
+    // Records that |other| reads this cell, so that it is updated whenever this cell changes.
+    void reference_from(Cell* other);
 
     void set_data(String new_data);
     void set_data(JS::Value new_data);
     bool dirty() const { return m_dirty; }
+    void mark_dirty() { m_dirty = true; }
     void clear_dirty() { m_dirty = false; }
+    bool is_being_evaluated() const { return m_is_being_evaluated; }
 
     void set_exception(JS::Exception* exc) { m_js_exception = exc; }
     JS::Exception* exception() const { return m_js_exception; }
@@ -55,7 +61,9 @@ struct Cell : public Weakable<Cell> {
     const String& data() const { return m_data; }
     const JS::Value& evaluated_data() const { return m_evaluated_data; }
     Kind kind() const { return m_kind; }
+    // The cells that read this cell, and the cells this cell read, the last time it was evaluated.
     const Vector<WeakPtr<Cell>>& referencing_cells() const { return m_referencing_cells; }
+    const Vector<WeakPtr<Cell>>& referenced_cells() const { return m_referenced_cells; }
 
     void set_type(const StringView& name);
     void set_type(const CellType*);
@@ -99,14 +107,23 @@ struct Cell : public Weakable<Cell> {
     void copy_from(const Cell&);
 
 private:
+    void evaluate_formula();
+    void clear_references();
+
     bool m_dirty { false };
     bool m_evaluated_externally { false };
+    bool m_is_being_evaluated { false };
     String m_data;
+    // The formula is compiled when it's first evaluated, and kept until it changes.
+    bool m_is_formula_compiled { false };
+    OwnPtr<NativeFormula> m_native_formula;
+    RefPtr<JS::Program> m_program;
     JS::Value m_evaluated_data;
     JS::Exception* m_js_exception { nullptr };
     Kind m_kind { LiteralString };
     WeakPtr<Sheet> m_sheet;
     Vector<WeakPtr<Cell>> m_referencing_cells;
+    Vector<WeakPtr<Cell>> m_referenced_cells;
     const CellType* m_type { nullptr };
     CellTypeMetadata m_type_metadata;
     Position m_position;
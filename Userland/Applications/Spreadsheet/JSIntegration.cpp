@@ -113,6 +113,10 @@ JS::Value SheetGlobalObject::get(const JS::PropertyName& name, JS::Value receive
         if (auto pos = m_sheet.parse_cell_name(name.as_string()); pos.has_value()) {
             auto& cell = m_sheet.ensure(pos.value());
             cell.reference_from(m_sheet.current_evaluated_cell());
+            if (cell.is_being_evaluated()) {
+                vm().throw_exception<JS::Error>(const_cast<SheetGlobalObject&>(*this), String::formatted("Circular reference to cell {}", name.as_string()));
+                return {};
+            }
             return cell.typed_js_data();
         }
     }
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "NativeFormula.h"
+#include "Cell.h"
+#include "Spreadsheet.h"
+#include <AK/GenericLexer.h>
+#include <AK/ScopeGuard.h>
+#include <LibJS/Runtime/PrimitiveString.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+namespace Spreadsheet {
+
+// Parses the subset of JS that NativeFormula understands, and bails out on anything else. Some of that is valid JS
+// which merely looks like what's understood, like `A1--B1` or `2**3`, so those have to be recognized and rejected.
+class NativeFormula::Parser {
+public:
+    Parser(const StringView& source, const Sheet& sheet)
+        : m_lexer(source)
+        , m_sheet(sheet)
+    {
+    }
+
+    bool parse_formula()
+    {
+        if (!parse_expression())
+            return false;
+        skip_whitespace();
+        return m_lexer.is_eof();
+    }
+
+    Vector<Instruction> take_instructions() { return move(m_instructions); }
+
+private:
+    // Deeper nesting than this is left to the interpreter, rather than to this parser's stack.
+    static constexpr size_t max_depth = 64;
+
+    static bool is_identifier_character(char c) { return isalnum(c) || c == '_' || c == '$'; }
+
+    void skip_whitespace() { m_lexer.ignore_while(isspace); }
+
+    // Consumes |op| if it comes next, as long as it isn't the start of a longer operator or a comment.
+    bool consume_operator(char op)
+    {
+        skip_whitespace();
+        if (!m_lexer.next_is(op))
+            return false;
+        auto following = m_lexer.peek(1);
+        if (following == op || following == '=' || (op == '/' && following == '*'))
+            return false;
+        m_lexer.ignore();
+        return true;
+    }
+
+    bool parse_expression()
+    {
+        if (!parse_term())
+            return false;
+        for (;;) {
+            Instruction::Type type;
+            if (consume_operator('+'))
+                type = Instruction::Type::Add;
+            else if (consume_operator('-'))
+                type = Instruction::Type::Subtract;
+            else
+                return true;
+            if (!parse_term())
+                return false;
+            m_instructions.append({ type });
+        }
+    }
+
+    bool parse_term()
+    {
+        if (!parse_factor())
+            return false;
+        for (;;) {
+            Instruction::Type type;
+            if (consume_operator('*'))
+                type = Instruction::Type::Multiply;
+            else if (consume_operator('/'))
+                type = Instruction::Type::Divide;
+            else
+                return true;
+            if (!parse_factor())
+                return false;
+            m_instructions.append({ type });
+        }
+    }
+
+    bool parse_factor()
+    {
+        if (++m_depth > max_depth)
+            return false;
+        ScopeGuard decrease_depth { [&] { --m_depth; } };
+
+        skip_whitespace();
+        if (consume_operator('-')) {
+            if (!parse_factor())
+                return false;
+            m_instructions.append({ Instruction::Type::Negate });
+            return true;
+        }
+        if (m_lexer.consume_specific('(')) {
+            if (!parse_expression())
+                return false;
+            skip_whitespace();
+            return m_lexer.consume_specific(')');
+        }
+        if (isdigit(m_lexer.peek()) || m_lexer.next_is('.'))
+            return parse_number();
+
+        auto identifier = m_lexer.consume_while(is_identifier_character);
+        if (identifier.is_empty())
+            return false;
+        skip_whitespace();
+        if (m_lexer.next_is('('))
+            return parse_call(identifier);
+
+        auto position = m_sheet.parse_cell_name(identifier);
+        if (!position.has_value())
+            return false;
+        m_instructions.append({ Instruction::Type::Cell, 0, position.value() });
+        return true;
+    }
+
+    bool parse_number()
+    {
+        auto integer_part = m_lexer.consume_while(isdigit);
+        auto has_fraction = m_lexer.consume_specific('.');
+        auto fraction_part = m_lexer.consume_while(isdigit);
+        // Leave exponents, hex, octal and BigInt literals, and member accesses on numbers, to the interpreter.
+        if ((integer_part.is_empty() && fraction_part.is_empty()) || is_identifier_character(m_lexer.peek()) || m_lexer.next_is('.'))
+            return false;
+        if (integer_part.length() > 1 && integer_part[0] == '0')
+            return false;
+
+        auto text = String::formatted("{}{}{}", integer_part, has_fraction ? "." : "", fraction_part);
+        m_instructions.append({ Instruction::Type::Number, strtod(text.characters(), nullptr) });
+        return true;
+    }
+
+    // Parses the rest of `sum(R`A1:B10`)` and the like.
+    bool parse_call(const StringView& function_name)
+    {
+        Instruction::Type type;
+        if (function_name == "sum")
+            type = Instruction::Type::Sum;
+        else if (function_name == "average")
+            type = Instruction::Type::Average;
+        else if (function_name == "count")
+            type = Instruction::Type::Count;
+        else
+            return false;
+
+        m_lexer.ignore();
+        skip_whitespace();
+        if (!m_lexer.consume_specific("R`"))
+            return false;
+        auto start = m_sheet.parse_cell_name(m_lexer.consume_until(':'));
+        auto end = m_sheet.parse_cell_name(m_lexer.consume_until('`'));
+        if (!start.has_value() || !end.has_value())
+            return false;
+        skip_whitespace();
+        if (!m_lexer.consume_specific(')'))
+            return false;
+
+        m_instructions.append({ type, 0, start.value(), end.value() });
+        return true;
+    }
+
+    GenericLexer m_lexer;
+    const Sheet& m_sheet;
+    Vector<Instruction> m_instructions;
+    size_t m_depth { 0 };
+};
+
+OwnPtr<NativeFormula> NativeFormula::parse(const StringView& source, const Sheet& sheet)
+{
+    Parser parser(source, sheet);
+    if (!parser.parse_formula())
+        return {};
+    return adopt_own(*new NativeFormula(parser.take_instructions()));
+}
+
+// Reads a cell the way the interpreter would, so that the cell is recorded as referenced by |on_behalf_of| all the
+// same. Only numbers are taken as they are. Empty cells count as 0, when that is what Number() would make of them.
+static Optional<double> read_number(Sheet& sheet, const Position& position, Cell& on_behalf_of, bool empty_is_zero)
+{
+    auto& cell = sheet.ensure(position);
+    cell.reference_from(&on_behalf_of);
+    // The interpreter reports reference cycles.
+    if (cell.is_being_evaluated())
+        return {};
+
+    auto value = cell.typed_js_data();
+    if (value.is_number())
+        return value.as_double();
+    if (empty_is_zero && value.is_string() && value.as_string().string().is_empty())
+        return 0;
+    return {};
+}
+
+Optional<double> NativeFormula::evaluate(Sheet& sheet, Cell& on_behalf_of) const
+{
+    Vector<double, 16> stack;
+    for (auto& instruction : m_instructions) {
+        switch (instruction.type) {
+        case Instruction::Type::Number:
+            stack.append(instruction.number);
+            break;
+        case Instruction::Type::Cell: {
+            auto value = read_number(sheet, instruction.position, on_behalf_of, false);
+            if (!value.has_value())
+                return {};
+            stack.append(value.value());
+            break;
+        }
+        case Instruction::Type::Negate:
+            stack.last() = -stack.last();
+            break;
+        case Instruction::Type::Add:
+        case Instruction::Type::Subtract:
+        case Instruction::Type::Multiply:
+        case Instruction::Type::Divide: {
+            auto rhs = stack.take_last();
+            auto& lhs = stack.last();
+            if (instruction.type == Instruction::Type::Add)
+                lhs = lhs + rhs;
+            else if (instruction.type == Instruction::Type::Subtract)
+                lhs = lhs - rhs;
+            else if (instruction.type == Instruction::Type::Multiply)
+                lhs = lhs * rhs;
+            else
+                lhs = lhs / rhs;
+            break;
+        }
+        case Instruction::Type::Sum:
+        case Instruction::Type::Average:
+        case Instruction::Type::Count: {
+            // Go through the range in the same order as range() in the runtime does, column by column, so that the
+            // sum is rounded the same way.
+            auto& start = instruction.position;
+            auto& end = instruction.range_end;
+            double sum = 0;
+            size_t count = 0;
+            for (auto column = min(start.column, end.column); column <= max(start.column, end.column); ++column) {
+                for (auto row = min(start.row, end.row); row <= max(start.row, end.row); ++row) {
+                    ++count;
+                    if (instruction.type == Instruction::Type::Count) {
+                        auto& cell = sheet.ensure({ column, row });
+                        cell.reference_from(&on_behalf_of);
+                        if (cell.is_being_evaluated())
+                            return {};
+                        continue;
+                    }
+                    auto value = read_number(sheet, { column, row }, on_behalf_of, true);
+                    if (!value.has_value())
+                        return {};
+                    sum = sum + value.value();
+                }
+            }
+            if (instruction.type == Instruction::Type::Sum)
+                stack.append(sum);
+            else if (instruction.type == Instruction::Type::Average)
+                stack.append(sum / count);
+            else
+                stack.append(static_cast<double>(count));
+            break;
+        }
+        }
+    }
+    VERIFY(stack.size() == 1);
+    return stack.first();
+}
+
+}
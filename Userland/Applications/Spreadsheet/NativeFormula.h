@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include "Forward.h"
+#include "Position.h"
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace Spreadsheet {
+
+// A formula that is simple enough to evaluate without the JS interpreter: arithmetic on numbers and cells, and
+// sum(), average() and count() of a range, like `A1 * 2 + B1` or `sum(R`A1:A1000`)`.
+// The results are exactly what the interpreter would compute. Whenever they might not be, for example because a cell
+// doesn't hold a number, evaluate() gives up, and the formula is left to the interpreter.
+class NativeFormula {
+public:
+    static OwnPtr<NativeFormula> parse(const StringView& source, const Sheet&);
+
+    Optional<double> evaluate(Sheet&, Cell& on_behalf_of) const;
+
+private:
+    class Parser;
+
+    // The formula is kept in postfix order, and evaluated on a stack.
+    struct Instruction {
+        enum class Type {
+            Number,
+            Cell,
+            Negate,
+            Add,
+            Subtract,
+            Multiply,
+            Divide,
+            Sum,
+            Average,
+            Count,
+        };
+
+        Type type;
+        double number { 0 };
+        // For a cell, or the corners of a range.
+        Position position {};
+        Position range_end {};
+    };
+
+    explicit NativeFormula(Vector<Instruction> instructions)
+        : m_instructions(move(instructions))
+    {
+    }
+
+    Vector<Instruction> m_instructions;
+};
+
+}
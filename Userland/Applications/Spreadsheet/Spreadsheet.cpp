@@ -139,22 +139,79 @@ void Sheet::update()
         return;
     }
     m_visited_cells_in_update.clear();
-    Vector<Cell*> cells_copy;
 
-    // Grab a copy as updates might insert cells into the table.
-    for (auto& it : m_cells) {
-        if (it.value->dirty()) {
-            cells_copy.append(it.value);
-            m_workbook.set_dirty(true);
+    // Formulas can assign to other cells, so keep going until there are no dirty cells left that haven't been
+    // updated yet. Each cell is updated at most once, so this ends even if the assignments go around in circles.
+    for (;;) {
+        Vector<Cell*> dirty_cells;
+
+        // Grab a copy as updates might insert cells into the table.
+        for (auto& it : m_cells) {
+            if (it.value->dirty() && !has_been_visited(it.value)) {
+                dirty_cells.append(it.value);
+                m_workbook.set_dirty(true);
+            }
         }
-    }
+        if (dirty_cells.is_empty())
+            break;
 
-    for (auto& cell : cells_copy)
-        update(*cell);
+        for (auto* cell : cells_in_update_order(dirty_cells))
+            update(*cell);
+    }
 
     m_visited_cells_in_update.clear();
 }
 
+Vector<Cell*> Sheet::cells_in_update_order(const Vector<Cell*>& dirty_cells)
+{
+    HashTable<Cell*> affected_cells;
+    Vector<Cell*> cells_to_visit;
+    for (auto* cell : dirty_cells) {
+        if (affected_cells.set(cell) == AK::HashSetResult::InsertedNewEntry)
+            cells_to_visit.append(cell);
+    }
+    for (size_t i = 0; i < cells_to_visit.size(); ++i) {
+        for (auto& referencing_cell : cells_to_visit[i]->referencing_cells()) {
+            if (referencing_cell && affected_cells.set(referencing_cell.ptr()) == AK::HashSetResult::InsertedNewEntry)
+                cells_to_visit.append(referencing_cell.ptr());
+        }
+    }
+
+    // A cell is ready once all cells it references that are going to be updated come before it.
+    Vector<Cell*> order;
+    HashMap<Cell*, size_t> pending_reference_counts;
+    for (auto* cell : cells_to_visit) {
+        cell->mark_dirty();
+        size_t pending_reference_count = 0;
+        for (auto& referenced_cell : cell->referenced_cells()) {
+            if (referenced_cell && affected_cells.contains(referenced_cell.ptr()))
+                ++pending_reference_count;
+        }
+        if (pending_reference_count == 0)
+            order.append(cell);
+        else
+            pending_reference_counts.set(cell, pending_reference_count);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        for (auto& referencing_cell : order[i]->referencing_cells()) {
+            if (!referencing_cell)
+                continue;
+            auto it = pending_reference_counts.find(referencing_cell.ptr());
+            if (it == pending_reference_counts.end() || --it->value > 0)
+                continue;
+            pending_reference_counts.remove(it);
+            order.append(referencing_cell.ptr());
+        }
+    }
+
+    // Evaluating the cells in a cycle reports it, if it's still there.
+    for (auto* cell : cells_to_visit) {
+        if (pending_reference_counts.contains(cell))
+            order.append(cell);
+    }
+    return order;
+}
+
 void Sheet::update(Cell& cell)
 {
     if (m_should_ignore_updates) {
@@ -173,14 +230,29 @@ void Sheet::update(Cell& cell)
     }
 }
 
+RefPtr<JS::Program> Sheet::parse(const StringView& source) const
+{
+    auto parser = JS::Parser(JS::Lexer(source));
+    auto program = parser.parse_program();
+    if (parser.has_errors())
+        return {};
+    return program;
+}
+
 Sheet::ValueAndException Sheet::evaluate(const StringView& source, Cell* on_behalf_of)
+{
+    auto program = parse(source);
+    if (!program)
+        return { JS::js_undefined(), nullptr };
+    return evaluate(*program, on_behalf_of);
+}
+
+Sheet::ValueAndException Sheet::evaluate(const JS::Program& program, Cell* on_behalf_of)
 {
     TemporaryChange cell_change { m_current_cell_being_evaluated, on_behalf_of };
     ScopeGuard clear_exception { [&] { interpreter().vm().clear_exception(); } };
 
-    auto parser = JS::Parser(JS::Lexer(source));
-    auto program = parser.parse_program();
-    if (parser.has_errors() || interpreter().exception())
+    if (interpreter().exception())
         return { JS::js_undefined(), interpreter().exception() };
 
     interpreter().run(global_object(), program);
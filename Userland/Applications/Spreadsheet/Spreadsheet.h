@@ -112,6 +112,9 @@ public:
         JS::Exception* exception { nullptr };
     };
     ValueAndException evaluate(const StringView&, Cell* = nullptr);
+    ValueAndException evaluate(const JS::Program&, Cell* = nullptr);
+    // Returns nothing if |source| has syntax errors.
+    RefPtr<JS::Program> parse(const StringView& source) const;
     JS::Interpreter& interpreter() const;
     SheetGlobalObject& global_object() const { return *m_global_object; }
 
@@ -138,6 +141,10 @@ private:
     explicit Sheet(Workbook&);
     explicit Sheet(const StringView& name, Workbook&);
 
+    // Orders the dirty cells and all cells that reference them, directly or not, so that each cell comes after the
+    // cells it references. Cells in a reference cycle have no such order, and come last.
+    Vector<Cell*> cells_in_update_order(const Vector<Cell*>& dirty_cells);
+
     String m_name;
     Vector<String> m_columns;
     size_t m_rows { 0 };
@@ -31,7 +31,7 @@ MemoryStatsWidget::MemoryStatsWidget(GraphWidget& graph)
     VERIFY(!s_the);
     s_the = this;
 
-    set_fixed_height(110);
+    set_fixed_height(125);
 
     set_layout<GUI::VerticalBoxLayout>();
     layout()->set_margins({ 0, 8, 0, 0 });
@@ -51,6 +51,7 @@ MemoryStatsWidget::MemoryStatsWidget(GraphWidget& graph)
 
     m_user_physical_pages_label = build_widgets_for_label("Physical memory:");
     m_user_physical_pages_committed_label = build_widgets_for_label("Committed memory:");
+    m_compressed_pages_label = build_widgets_for_label("Compressed memory:");
     m_supervisor_physical_pages_label = build_widgets_for_label("Supervisor physical:");
     m_kmalloc_space_label = build_widgets_for_label("Kernel heap:");
     m_kmalloc_count_label = build_widgets_for_label("Calls kmalloc:");
@@ -96,6 +97,8 @@ void MemoryStatsWidget::refresh()
     unsigned super_physical_free = json.get("super_physical_available").to_u32();
     unsigned kmalloc_call_count = json.get("kmalloc_call_count").to_u32();
     unsigned kfree_call_count = json.get("kfree_call_count").to_u32();
+    unsigned compressed_pages = json.get("compressed_pages").to_u32();
+    unsigned compressed_bytes = json.get("compressed_bytes").to_u32();
 
     size_t kmalloc_bytes_total = kmalloc_allocated + kmalloc_available;
     size_t user_physical_pages_total = user_physical_allocated + user_physical_available;
@@ -108,6 +111,7 @@ void MemoryStatsWidget::refresh()
     m_kmalloc_space_label->set_text(String::formatted("{}K/{}K", bytes_to_kb(kmalloc_allocated), bytes_to_kb(kmalloc_bytes_total)));
     m_user_physical_pages_label->set_text(String::formatted("{}K/{}K", page_count_to_kb(physical_pages_in_use), page_count_to_kb(physical_pages_total)));
     m_user_physical_pages_committed_label->set_text(String::formatted("{}K", page_count_to_kb(user_physical_committed)));
+    m_compressed_pages_label->set_text(String::formatted("{}K in {}K", page_count_to_kb(compressed_pages), bytes_to_kb(compressed_bytes)));
     m_supervisor_physical_pages_label->set_text(String::formatted("{}K/{}K", page_count_to_kb(super_physical_alloc), page_count_to_kb(supervisor_pages_total)));
     m_kmalloc_count_label->set_text(String::formatted("{}", kmalloc_call_count));
     m_kfree_count_label->set_text(String::formatted("{}", kfree_call_count));
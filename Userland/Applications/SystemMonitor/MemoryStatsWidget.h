@@ -25,6 +25,7 @@ private:
     GraphWidget& m_graph;
     RefPtr<GUI::Label> m_user_physical_pages_label;
     RefPtr<GUI::Label> m_user_physical_pages_committed_label;
+    RefPtr<GUI::Label> m_compressed_pages_label;
     RefPtr<GUI::Label> m_supervisor_physical_pages_label;
     RefPtr<GUI::Label> m_kmalloc_space_label;
     RefPtr<GUI::Label> m_kmalloc_count_label;
@@ -114,6 +114,14 @@ String ProcessModel::column_name(int column) const
         return "File In";
     case Column::FileWriteBytes:
         return "File Out";
+    case Column::BlockReads:
+        return "Disk Reads";
+    case Column::BlockReadBytes:
+        return "Disk In";
+    case Column::BlockWrites:
+        return "Disk Writes";
+    case Column::BlockWriteBytes:
+        return "Disk Out";
     case Column::Pledge:
         return "Pledge";
     case Column::Veil:
@@ -161,6 +169,10 @@ GUI::Variant ProcessModel::data(const GUI::ModelIndex& index, GUI::ModelRole rol
         case Column::CowFaults:
         case Column::FileReadBytes:
         case Column::FileWriteBytes:
+        case Column::BlockReads:
+        case Column::BlockReadBytes:
+        case Column::BlockWrites:
+        case Column::BlockWriteBytes:
         case Column::UnixSocketReadBytes:
         case Column::UnixSocketWriteBytes:
         case Column::IPv4SocketReadBytes:
@@ -232,6 +244,14 @@ GUI::Variant ProcessModel::data(const GUI::ModelIndex& index, GUI::ModelRole rol
             return thread.current_state.file_read_bytes;
         case Column::FileWriteBytes:
             return thread.current_state.file_write_bytes;
+        case Column::BlockReads:
+            return (i64)thread.current_state.block_read_requests;
+        case Column::BlockReadBytes:
+            return (i64)thread.current_state.block_read_bytes;
+        case Column::BlockWrites:
+            return (i64)thread.current_state.block_write_requests;
+        case Column::BlockWriteBytes:
+            return (i64)thread.current_state.block_write_bytes;
         case Column::Pledge:
             return thread.current_state.pledge;
         case Column::Veil:
@@ -303,6 +323,14 @@ GUI::Variant ProcessModel::data(const GUI::ModelIndex& index, GUI::ModelRole rol
             return thread.current_state.file_read_bytes;
         case Column::FileWriteBytes:
             return thread.current_state.file_write_bytes;
+        case Column::BlockReads:
+            return (i64)thread.current_state.block_read_requests;
+        case Column::BlockReadBytes:
+            return (i64)thread.current_state.block_read_bytes;
+        case Column::BlockWrites:
+            return (i64)thread.current_state.block_write_requests;
+        case Column::BlockWriteBytes:
+            return (i64)thread.current_state.block_write_bytes;
         case Column::Pledge:
             return thread.current_state.pledge;
         case Column::Veil:
@@ -316,7 +344,7 @@ GUI::Variant ProcessModel::data(const GUI::ModelIndex& index, GUI::ModelRole rol
 void ProcessModel::update()
 {
     auto previous_tid_count = m_tids.size();
-    auto all_processes = Core::ProcessStatisticsReader::get_all(m_proc_all);
+    auto all_processes = Core::ProcessStatisticsReader::get_all(m_proc_processes);
 
     u64 last_sum_ticks_scheduled = 0, last_sum_ticks_scheduled_kernel = 0;
     for (auto& it : m_threads) {
@@ -346,6 +374,10 @@ void ProcessModel::update()
                 state.ipv4_socket_write_bytes = thread.ipv4_socket_write_bytes;
                 state.file_read_bytes = thread.file_read_bytes;
                 state.file_write_bytes = thread.file_write_bytes;
+                state.block_read_requests = thread.block_read_requests;
+                state.block_read_bytes = thread.block_read_bytes;
+                state.block_write_requests = thread.block_write_requests;
+                state.block_write_bytes = thread.block_write_bytes;
                 state.amount_virtual = it.value.amount_virtual;
                 state.amount_resident = it.value.amount_resident;
                 state.amount_dirty_private = it.value.amount_dirty_private;
@@ -44,6 +44,10 @@ public:
         CowFaults,
         FileReadBytes,
         FileWriteBytes,
+        BlockReads,
+        BlockReadBytes,
+        BlockWrites,
+        BlockWriteBytes,
         UnixSocketReadBytes,
         UnixSocketWriteBytes,
         IPv4SocketReadBytes,
@@ -114,6 +118,10 @@ private:
         unsigned ipv4_socket_write_bytes;
         unsigned file_read_bytes;
         unsigned file_write_bytes;
+        u64 block_read_requests;
+        u64 block_read_bytes;
+        u64 block_write_requests;
+        u64 block_write_bytes;
         float cpu_percent;
         float cpu_percent_kernel;
     };
@@ -126,6 +134,6 @@ private:
     HashMap<int, NonnullOwnPtr<Thread>> m_threads;
     NonnullOwnPtrVector<CpuInfo> m_cpus;
     Vector<int> m_tids;
-    RefPtr<Core::File> m_proc_all;
+    RefPtr<Core::File> m_proc_processes;
     GUI::Icon m_kernel_process_icon;
 };
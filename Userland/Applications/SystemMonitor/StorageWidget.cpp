@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "StorageWidget.h"
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/NumberFormat.h>
+#include <LibGUI/BoxLayout.h>
+#include <LibGUI/JsonArrayModel.h>
+#include <LibGUI/SortingProxyModel.h>
+#include <LibGUI/TableView.h>
+
+// The latency below which the given fraction of requests completed, as the upper bound of the
+// histogram bucket it falls into. See StorageDevice::RequestStatistics in the kernel.
+static u64 latency_percentile_us(const JsonObject& statistics, float fraction)
+{
+    auto& buckets = statistics.get("latency_buckets").as_array();
+    u64 total = 0;
+    for (auto& bucket : buckets.values())
+        total += bucket.to_u64();
+    if (total == 0)
+        return 0;
+
+    u64 seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets.at(i).to_u64();
+        if (seen >= total * fraction)
+            return 1ull << i;
+    }
+    return 1ull << (buckets.size() - 1);
+}
+
+static void add_direction_fields(Vector<GUI::JsonArrayModel::FieldSpec>& fields, String const& direction, String const& requests_title, String const& bytes_title)
+{
+    fields.empend(requests_title, Gfx::TextAlignment::CenterRight, [direction](const JsonObject& object) {
+        return (i64)object.get(direction).as_object().get("requests").to_u64();
+    });
+    fields.empend(
+        bytes_title, Gfx::TextAlignment::CenterRight,
+        [direction](const JsonObject& object) {
+            return human_readable_size(object.get(direction).as_object().get("bytes").to_u64());
+        },
+        [direction](const JsonObject& object) {
+            return (i64)object.get(direction).as_object().get("bytes").to_u64();
+        });
+    fields.empend("Avg latency (µs)", Gfx::TextAlignment::CenterRight, [direction](const JsonObject& object) {
+        auto& statistics = object.get(direction).as_object();
+        auto requests = statistics.get("requests").to_u64();
+        return requests ? (i64)(statistics.get("total_latency_us").to_u64() / requests) : 0;
+    });
+    fields.empend("P50 (µs)", Gfx::TextAlignment::CenterRight, [direction](const JsonObject& object) {
+        return (i64)latency_percentile_us(object.get(direction).as_object(), 0.5f);
+    });
+    fields.empend("P99 (µs)", Gfx::TextAlignment::CenterRight, [direction](const JsonObject& object) {
+        return (i64)latency_percentile_us(object.get(direction).as_object(), 0.99f);
+    });
+    fields.empend("Errors", Gfx::TextAlignment::CenterRight, [direction](const JsonObject& object) {
+        return (i64)object.get(direction).as_object().get("errors").to_u64();
+    });
+}
+
+StorageWidget::StorageWidget()
+{
+    on_first_show = [this](auto&) {
+        set_layout<GUI::VerticalBoxLayout>();
+        layout()->set_margins({ 4, 4, 4, 4 });
+
+        Vector<GUI::JsonArrayModel::FieldSpec> storage_fields;
+        storage_fields.empend("Device", Gfx::TextAlignment::CenterLeft, [](const JsonObject& object) {
+            return String::formatted("{},{}", object.get("major").to_u32(), object.get("minor").to_u32());
+        });
+        add_direction_fields(storage_fields, "read", "Reads", "Read");
+        add_direction_fields(storage_fields, "write", "Writes", "Written");
+
+        m_storage_table_view = add<GUI::TableView>();
+        m_storage_model = GUI::JsonArrayModel::create("/proc/storage", move(storage_fields));
+        m_storage_table_view->set_model(GUI::SortingProxyModel::create(*m_storage_model));
+
+        m_update_timer = add<Core::Timer>(
+            1000, [this] {
+                update_model();
+            });
+
+        update_model();
+    };
+}
+
+StorageWidget::~StorageWidget()
+{
+}
+
+void StorageWidget::update_model()
+{
+    m_storage_table_view->model()->update();
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibCore/Timer.h>
+#include <LibGUI/LazyWidget.h>
+
+class StorageWidget final : public GUI::LazyWidget {
+    C_OBJECT(StorageWidget)
+public:
+    virtual ~StorageWidget() override;
+
+private:
+    StorageWidget();
+    void update_model();
+
+    RefPtr<GUI::TableView> m_storage_table_view;
+    RefPtr<GUI::JsonArrayModel> m_storage_model;
+    RefPtr<Core::Timer> m_update_timer;
+};
@@ -14,6 +14,7 @@
 #include "ProcessModel.h"
 #include "ProcessStateWidget.h"
 #include "ProcessUnveiledPathsWidget.h"
+#include "StorageWidget.h"
 #include "ThreadStackWidget.h"
 #include <AK/NumberFormat.h>
 #include <LibCore/ArgsParser.h>
@@ -149,7 +150,7 @@ int main(int argc, char** argv)
 
     const char* args_tab = "processes";
     Core::ArgsParser parser;
-    parser.add_option(args_tab, "Tab, one of 'processes', 'graphs', 'fs', 'pci', 'devices', 'network', 'processors' or 'interrupts'", "open-tab", 't', "tab");
+    parser.add_option(args_tab, "Tab, one of 'processes', 'graphs', 'fs', 'pci', 'devices', 'storage', 'network', 'processors' or 'interrupts'", "open-tab", 't', "tab");
     parser.parse(argc, argv);
     StringView args_tab_view = args_tab;
 
@@ -194,6 +195,9 @@ int main(int argc, char** argv)
     auto devices_widget = build_devices_tab();
     tabwidget.add_widget("Devices", devices_widget);
 
+    auto storage_widget = StorageWidget::construct();
+    tabwidget.add_widget("Storage", storage_widget);
+
     auto network_stats_widget = NetworkStatisticsWidget::construct();
     tabwidget.add_widget("Network", network_stats_widget);
 
@@ -386,6 +390,8 @@ int main(int argc, char** argv)
         tabwidget.set_active_widget(pci_devices_widget);
     else if (args_tab_view == "devices")
         tabwidget.set_active_widget(devices_widget);
+    else if (args_tab_view == "storage")
+        tabwidget.set_active_widget(storage_widget);
     else if (args_tab_view == "network")
         tabwidget.set_active_widget(network_stats_widget);
     else if (args_tab_view == "processors")
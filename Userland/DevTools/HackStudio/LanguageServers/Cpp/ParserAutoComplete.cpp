@@ -25,7 +25,13 @@ const ParserAutoComplete::DocumentData* ParserAutoComplete::get_or_create_docume
 {
     auto absolute_path = filedb().to_absolute_path(file);
     if (!m_documents.contains(absolute_path)) {
+        // An include cycle leads back here before the document is done. The documents in the cycle just don't see
+        // each other's declarations until one of them is parsed again.
+        if (m_documents_being_created.contains(absolute_path))
+            return nullptr;
+        m_documents_being_created.set(absolute_path);
         set_document_data(absolute_path, create_document_data_for(absolute_path));
+        m_documents_being_created.remove(absolute_path);
     }
     return get_document_data(absolute_path);
 }
@@ -46,15 +52,18 @@ OwnPtr<ParserAutoComplete::DocumentData> ParserAutoComplete::create_document_dat
     auto content = document->text();
     auto document_data = create_document_data(document->text(), file);
     auto root = document_data->parser().parse();
-    for (auto& path : document_data->preprocessor().included_paths()) {
-        get_or_create_document_data(document_path_from_include_path(path));
-    }
 #ifdef CPP_LANGUAGE_SERVER_DEBUG
     root->dump(0);
 #endif
 
+    index_global_declarations(*document_data);
     update_declared_symbols(*document_data);
 
+    // Files that aren't open in the editor, like most headers, are only read from disk once. Parse them again when
+    // they change there.
+    if (!filedb().is_open(file))
+        watch_for_changes_on_disk(filedb().to_absolute_path(file));
+
     return document_data;
 }
 
@@ -119,10 +128,11 @@ Vector<GUI::AutocompleteProvider::Entry> ParserAutoComplete::autocomplete_name(c
 {
     auto available_declarations = get_available_declarations(document, node);
     Vector<StringView> available_names;
-    auto add_name = [&available_names](auto& name) {
+    HashTable<StringView> seen_names;
+    auto add_name = [&](auto& name) {
         if (name.is_null() || name.is_empty())
             return;
-        if (!available_names.contains_slow(name))
+        if (seen_names.set(name) == AK::HashSetResult::InsertedNewEntry)
             available_names.append(name);
     };
     for (auto& decl : available_declarations) {
@@ -248,34 +258,30 @@ String ParserAutoComplete::type_of(const DocumentData& document, const Expressio
 
 Vector<ParserAutoComplete::PropertyInfo> ParserAutoComplete::properties_of_type(const DocumentData& document, const String& type) const
 {
-    auto declarations = get_global_declarations_including_headers(document);
     Vector<PropertyInfo> properties;
-    for (auto& decl : declarations) {
-        if (!decl.is_struct_or_class())
-            continue;
-        auto& struct_or_class = (StructOrClassDeclaration&)decl;
-        if (struct_or_class.m_name != type)
-            continue;
-        for (auto& member : struct_or_class.m_members) {
-            properties.append({ member.m_name, member.m_type });
+    for_each_document_in_include_closure(document, [&](auto& included_document) {
+        auto declarations = included_document.m_global_declarations_by_name.find(type);
+        if (declarations == included_document.m_global_declarations_by_name.end())
+            return IterationDecision::Continue;
+        for (auto& decl : declarations->value) {
+            if (!decl.is_struct_or_class())
+                continue;
+            for (auto& member : ((const StructOrClassDeclaration&)decl).m_members) {
+                properties.append({ member.m_name, member.m_type });
+            }
         }
-    }
+        return IterationDecision::Continue;
+    });
     return properties;
 }
 
 NonnullRefPtrVector<Declaration> ParserAutoComplete::get_global_declarations_including_headers(const DocumentData& document) const
 {
     NonnullRefPtrVector<Declaration> declarations;
-    for (auto& include : document.preprocessor().included_paths()) {
-        document_path_from_include_path(include);
-        auto included_document = get_document_data(document_path_from_include_path(include));
-        if (!included_document)
-            continue;
-        declarations.append(get_global_declarations_including_headers(*included_document));
-    }
-
-    declarations.append(get_global_declarations(*document.parser().root_node()));
-
+    for_each_document_in_include_closure(document, [&](auto& included_document) {
+        declarations.append(included_document.m_global_declarations);
+        return IterationDecision::Continue;
+    });
     return declarations;
 }
 
@@ -405,47 +411,86 @@ static Optional<TargetDeclaration> get_target_declaration(const ASTNode& node)
     return TargetDeclaration { TargetDeclaration::Type::Variable, name };
 }
 
+static RefPtr<Declaration> declaration_matching(Declaration& decl, const TargetDeclaration& target)
+{
+    if (decl.is_function() && target.type == TargetDeclaration::Function) {
+        if (decl.name() == target.name)
+            return decl;
+    }
+    if (decl.is_variable_or_parameter_declaration() && target.type == TargetDeclaration::Variable) {
+        if (decl.name() == target.name)
+            return decl;
+    }
+
+    if (decl.is_struct_or_class() && target.type == TargetDeclaration::Property) {
+        // TODO: Also check that the type of the struct/class matches (not just the property name)
+        for (auto& member : ((Cpp::StructOrClassDeclaration&)decl).m_members) {
+            if (member.m_name == target.name) {
+                return member;
+            }
+        }
+    }
+
+    if (decl.is_struct_or_class() && target.type == TargetDeclaration::Type) {
+        if (decl.name() == target.name)
+            return decl;
+    }
+    return {};
+}
+
 RefPtr<Declaration> ParserAutoComplete::find_declaration_of(const DocumentData& document_data, const ASTNode& node) const
 {
     dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "find_declaration_of: {} ({})", document_data.parser().text_of_node(node), node.class_name());
     auto target_decl = get_target_declaration(node);
     if (!target_decl.has_value())
         return {};
+    auto& target = target_decl.value();
 
-    auto declarations = get_available_declarations(document_data, node);
-    for (auto& decl : declarations) {
-        if (decl.is_function() && target_decl.value().type == TargetDeclaration::Function) {
-            if (((Cpp::FunctionDeclaration&)decl).m_name == target_decl.value().name)
-                return decl;
-        }
-        if (decl.is_variable_or_parameter_declaration() && target_decl.value().type == TargetDeclaration::Variable) {
-            if (((Cpp::VariableOrParameterDeclaration&)decl).m_name == target_decl.value().name)
-                return decl;
+    for (auto* current = &node; current; current = current->parent()) {
+        for (auto& decl : current->declarations()) {
+            if (auto match = declaration_matching(decl, target))
+                return match;
         }
+    }
 
-        if (decl.is_struct_or_class() && target_decl.value().type == TargetDeclaration::Property) {
-            // TODO: Also check that the type of the struct/class matches (not just the property name)
-            for (auto& member : ((Cpp::StructOrClassDeclaration&)decl).m_members) {
-                VERIFY(node.is_identifier());
-                if (member.m_name == target_decl.value().name) {
-                    return member;
-                }
+    // Global declarations are looked up by name. Members are indexed along with the structs and classes they belong to,
+    // so a property is found by its own name.
+    RefPtr<Declaration> match;
+    for_each_document_in_include_closure(document_data, [&](auto& document) {
+        auto declarations = document.m_global_declarations_by_name.find(target.name);
+        if (declarations == document.m_global_declarations_by_name.end())
+            return IterationDecision::Continue;
+        for (auto& declaration : declarations->value) {
+            auto& decl = const_cast<Declaration&>(declaration);
+            if (target.type == TargetDeclaration::Property) {
+                if (decl.is_member())
+                    match = decl;
+            } else {
+                match = declaration_matching(decl, target);
             }
+            if (match)
+                return IterationDecision::Break;
         }
+        return IterationDecision::Continue;
+    });
+    return match;
+}
 
-        if (decl.is_struct_or_class() && target_decl.value().type == TargetDeclaration::Type) {
-            if (((Cpp::StructOrClassDeclaration&)decl).m_name == target_decl.value().name)
-                return decl;
-        }
+void ParserAutoComplete::index_global_declarations(DocumentData& document)
+{
+    document.m_global_declarations = get_global_declarations(*document.parser().root_node());
+    for (auto& decl : document.m_global_declarations) {
+        if (decl.name().is_empty())
+            continue;
+        document.m_global_declarations_by_name.ensure(decl.name()).append(decl);
     }
-    return {};
 }
 
 void ParserAutoComplete::update_declared_symbols(const DocumentData& document)
 {
     Vector<GUI::AutocompleteProvider::Declaration> declarations;
 
-    for (auto& decl : get_global_declarations(*document.parser().root_node())) {
+    for (auto& decl : document.m_global_declarations) {
         declarations.append({ decl.name(), { document.filename(), decl.start().line, decl.start().column }, type_of_declaration(decl), scope_of_declaration(decl) });
     }
 
@@ -487,7 +532,11 @@ OwnPtr<ParserAutoComplete::DocumentData> ParserAutoComplete::create_document_dat
         all_definitions.set(move(item.key), move(item.value));
 
     for (auto include : document_data->preprocessor().included_paths()) {
-        auto included_document = get_or_create_document_data(document_path_from_include_path(include));
+        auto path = document_path_from_include_path(include);
+        if (path.is_null())
+            continue;
+        document_data->m_included_documents.append(filedb().to_absolute_path(path));
+        auto included_document = get_or_create_document_data(path);
         if (!included_document)
             continue;
         for (auto item : included_document->parser().definitions())
@@ -498,6 +547,28 @@ OwnPtr<ParserAutoComplete::DocumentData> ParserAutoComplete::create_document_dat
     return document_data;
 }
 
+void ParserAutoComplete::watch_for_changes_on_disk(const String& file)
+{
+    if (m_file_watcher) {
+        if (m_file_watcher->is_watching(file))
+            return;
+        // Not all file systems support watching files. Files on those are only parsed once.
+        (void)m_file_watcher->add_watch(file);
+        return;
+    }
+
+    auto watcher_or_error = Core::FileWatcher::watch(file);
+    if (watcher_or_error.is_error())
+        return;
+    m_file_watcher = watcher_or_error.release_value();
+    m_file_watcher->on_change = [this](auto event) {
+        if (event.type != Core::FileWatcherEvent::Type::Modified || filedb().is_open(event.path))
+            return;
+        dbgln_if(CPP_LANGUAGE_SERVER_DEBUG, "{} changed on disk, parsing it again", event.path);
+        set_document_data(event.path, create_document_data_for(event.path));
+    };
+}
+
 String ParserAutoComplete::scope_of_declaration(const Declaration& decl)
 {
     auto parent = decl.parent();
@@ -7,6 +7,9 @@
 #pragma once
 
 #include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/IterationDecision.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <DevTools/HackStudio/AutoCompleteResponse.h>
@@ -15,6 +18,7 @@
 #include <LibCpp/AST.h>
 #include <LibCpp/Parser.h>
 #include <LibCpp/Preprocessor.h>
+#include <LibCore/FileWatcher.h>
 #include <LibGUI/TextPosition.h>
 
 namespace LanguageServers::Cpp {
@@ -59,6 +63,11 @@ private:
         String m_text;
         OwnPtr<Preprocessor> m_preprocessor;
         OwnPtr<Parser> m_parser;
+
+        // These are looked up for every suggestion, so they are worked out once, when the document is parsed.
+        Vector<String> m_included_documents;
+        NonnullRefPtrVector<Declaration> m_global_declarations;
+        HashMap<StringView, NonnullRefPtrVector<Declaration>> m_global_declarations_by_name;
     };
 
     Vector<GUI::AutocompleteProvider::Entry> autocomplete_property(const DocumentData&, const MemberExpression&, const String partial_text) const;
@@ -79,13 +88,39 @@ private:
     NonnullRefPtrVector<Declaration> get_global_declarations_including_headers(const DocumentData& document) const;
     NonnullRefPtrVector<Declaration> get_global_declarations(const ASTNode& node) const;
 
+    // Calls back with each document that |document| includes, directly or not, before the documents that include it.
+    // |document| itself comes last.
+    template<typename Callback>
+    void for_each_document_in_include_closure(const DocumentData& document, Callback callback) const
+    {
+        HashTable<const DocumentData*> visited_documents;
+        for_each_document_in_include_closure(document, visited_documents, callback);
+    }
+    template<typename Callback>
+    IterationDecision for_each_document_in_include_closure(const DocumentData& document, HashTable<const DocumentData*>& visited_documents, Callback& callback) const
+    {
+        if (visited_documents.contains(&document))
+            return IterationDecision::Continue;
+        visited_documents.set(&document);
+        for (auto& path : document.m_included_documents) {
+            auto included_document = m_documents.get(path);
+            if (!included_document.has_value() || !included_document.value())
+                continue;
+            if (for_each_document_in_include_closure(*included_document.value(), visited_documents, callback) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
+        return callback(document);
+    }
+
     const DocumentData* get_document_data(const String& file) const;
     const DocumentData* get_or_create_document_data(const String& file);
     void set_document_data(const String& file, OwnPtr<DocumentData>&& data);
 
     OwnPtr<DocumentData> create_document_data_for(const String& file);
     String document_path_from_include_path(const StringView& include_path) const;
+    void index_global_declarations(DocumentData&);
     void update_declared_symbols(const DocumentData&);
+    void watch_for_changes_on_disk(const String& file);
     GUI::AutocompleteProvider::DeclarationType type_of_declaration(const Declaration&);
     String scope_of_declaration(const Declaration&);
     Optional<GUI::AutocompleteProvider::ProjectLocation> find_preprocessor_definition(const DocumentData&, const GUI::TextPosition&);
@@ -93,6 +128,9 @@ private:
     OwnPtr<DocumentData> create_document_data(String&& text, const String& filename);
 
     HashMap<String, OwnPtr<DocumentData>> m_documents;
+    HashTable<String> m_documents_being_created;
+    // All files are watched through this one watcher.
+    RefPtr<Core::FileWatcher> m_file_watcher;
 };
 
 }
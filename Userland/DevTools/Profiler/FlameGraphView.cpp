@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "FlameGraphView.h"
+#include "Profile.h"
+#include <LibGUI/Painter.h>
+#include <LibGfx/Font.h>
+
+FlameGraphView::FlameGraphView(Profile& profile)
+    : m_profile(profile)
+{
+    set_fill_with_background_color(true);
+    m_profile.model().register_client(*this);
+}
+
+FlameGraphView::~FlameGraphView()
+{
+    m_profile.model().unregister_client(*this);
+}
+
+void FlameGraphView::model_did_update(unsigned)
+{
+    m_zoomed_node = nullptr;
+    set_hovered_node(nullptr);
+    update();
+}
+
+int FlameGraphView::bar_height() const
+{
+    return font().glyph_height() + 4;
+}
+
+static void for_each_visible_bar_in(const ProfileNode& node, float x, int y, float pixels_per_event, int bar_height, const Function<void(const ProfileNode&, const Gfx::IntRect&)>& callback)
+{
+    float width = (float)node.event_count() * pixels_per_event;
+    if (width < 1 || y + bar_height <= 0)
+        return;
+
+    callback(node, { (int)x, y, (int)(x + width) - (int)x, bar_height });
+
+    float child_x = x;
+    for (auto& child : node.children()) {
+        for_each_visible_bar_in(child, child_x, y - bar_height, pixels_per_event, bar_height, callback);
+        child_x += (float)child->event_count() * pixels_per_event;
+    }
+}
+
+void FlameGraphView::for_each_visible_bar(Function<void(const ProfileNode&, const Gfx::IntRect&)> callback) const
+{
+    Vector<const ProfileNode*> roots;
+    if (m_zoomed_node) {
+        roots.append(m_zoomed_node);
+    } else {
+        for (auto& root : m_profile.roots())
+            roots.append(root.ptr());
+    }
+
+    u64 event_count = 0;
+    for (auto* root : roots)
+        event_count += root->event_count();
+    if (!event_count)
+        return;
+
+    auto inner_rect = frame_inner_rect();
+    float pixels_per_event = (float)inner_rect.width() / (float)event_count;
+    float x = inner_rect.x();
+    for (auto* root : roots) {
+        for_each_visible_bar_in(*root, x, inner_rect.bottom() + 1 - bar_height(), pixels_per_event, bar_height(), callback);
+        x += (float)root->event_count() * pixels_per_event;
+    }
+}
+
+const ProfileNode* FlameGraphView::node_at(const Gfx::IntPoint& position) const
+{
+    const ProfileNode* found_node = nullptr;
+    for_each_visible_bar([&](auto& node, auto& rect) {
+        if (rect.contains(position))
+            found_node = &node;
+    });
+    return found_node;
+}
+
+void FlameGraphView::set_hovered_node(const ProfileNode* node)
+{
+    if (m_hovered_node == node)
+        return;
+    m_hovered_node = node;
+
+    if (!node) {
+        set_tooltip({});
+    } else {
+        auto total_event_count = m_zoomed_node ? m_zoomed_node->event_count() : m_profile.filtered_event_count();
+        auto percentage = total_event_count ? node->event_count() * 100 / total_event_count : 0;
+        set_tooltip(String::formatted("{} ({} samples, {}%)", node->symbol(), node->event_count(), percentage));
+    }
+    update();
+}
+
+static Color color_for_node(const ProfileNode& node)
+{
+    // Kernel frames get the same color as in the timeline, and the rest a warm color that stays the same for a symbol.
+    if (node.address() >= 0xc0000000)
+        return Color::from_rgb(0xc25e5a);
+    auto hue = 20 + node.symbol().hash() % 40;
+    return Color::from_hsv(hue, 0.55, 0.95);
+}
+
+void FlameGraphView::paint_event(GUI::PaintEvent& event)
+{
+    GUI::Frame::paint_event(event);
+
+    GUI::Painter painter(*this);
+    painter.add_clip_rect(frame_inner_rect());
+    painter.add_clip_rect(event.rect());
+
+    for_each_visible_bar([&](auto& node, auto& rect) {
+        if (!rect.intersects(event.rect()))
+            return;
+
+        auto bar_rect = rect.shrunken(1, 1);
+        auto color = color_for_node(node);
+        if (&node == m_hovered_node)
+            color = color.lightened();
+        painter.fill_rect(bar_rect, color);
+
+        auto text_rect = bar_rect.shrunken(6, 0);
+        if (text_rect.width() > font().glyph_width('x') * 3)
+            painter.draw_text(text_rect, node.symbol(), font(), Gfx::TextAlignment::CenterLeft, Color::Black, Gfx::TextElision::Right);
+    });
+}
+
+void FlameGraphView::mousemove_event(GUI::MouseEvent& event)
+{
+    set_hovered_node(node_at(event.position()));
+}
+
+void FlameGraphView::mousedown_event(GUI::MouseEvent& event)
+{
+    if (event.button() != GUI::MouseButton::Left)
+        return;
+
+    auto* node = node_at(event.position());
+    if (!node)
+        return;
+
+    if (node == m_zoomed_node)
+        m_zoomed_node = node->parent();
+    else
+        m_zoomed_node = node;
+    set_hovered_node(node_at(event.position()));
+    update();
+}
+
+void FlameGraphView::leave_event(Core::Event&)
+{
+    set_hovered_node(nullptr);
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <LibGUI/Frame.h>
+#include <LibGUI/Model.h>
+
+class Profile;
+class ProfileNode;
+
+// Draws the call tree as a flame graph: each node is a bar as wide as its share of the samples, stacked on top of
+// the node it was called from. Clicking a bar zooms in on it, and clicking the bottom bar zooms back out.
+class FlameGraphView final : public GUI::Frame
+    , public GUI::ModelClient {
+    C_OBJECT(FlameGraphView)
+public:
+    virtual ~FlameGraphView() override;
+
+private:
+    explicit FlameGraphView(Profile&);
+
+    virtual void model_did_update(unsigned flags) override;
+
+    virtual void paint_event(GUI::PaintEvent&) override;
+    virtual void mousemove_event(GUI::MouseEvent&) override;
+    virtual void mousedown_event(GUI::MouseEvent&) override;
+    virtual void leave_event(Core::Event&) override;
+
+    int bar_height() const;
+    void for_each_visible_bar(Function<void(const ProfileNode&, const Gfx::IntRect&)>) const;
+    const ProfileNode* node_at(const Gfx::IntPoint&) const;
+    void set_hovered_node(const ProfileNode*);
+
+    Profile& m_profile;
+
+    // Both belong to the profile's current call tree, and are forgotten whenever it's rebuilt.
+    const ProfileNode* m_zoomed_node { nullptr };
+    const ProfileNode* m_hovered_node { nullptr };
+};
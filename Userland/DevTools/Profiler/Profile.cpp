@@ -34,6 +34,15 @@ Profile::Profile(Vector<Process> processes, Vector<Event> events)
     m_first_timestamp = m_events.first().timestamp;
     m_last_timestamp = m_events.last().timestamp;
 
+    m_events_are_sorted_by_timestamp = true;
+    for (size_t i = 1; i < m_events.size(); ++i) {
+        if (m_events[i].timestamp < m_events[i - 1].timestamp) {
+            m_events_are_sorted_by_timestamp = false;
+            break;
+        }
+    }
+    m_filter_range_end_event_index = m_events.size();
+
     m_model = ProfileModel::create(*this);
     m_samples_model = SamplesModel::create(*this);
 
@@ -86,7 +95,7 @@ void Profile::rebuild_tree()
 
     Optional<size_t> first_filtered_event_index;
 
-    for (size_t event_index = 0; event_index < m_events.size(); ++event_index) {
+    for (size_t event_index = m_filter_range_first_event_index; event_index < m_filter_range_end_event_index; ++event_index) {
         auto& event = m_events.at(event_index);
         if (has_timestamp_filter_range()) {
             auto timestamp = event.timestamp;
@@ -254,6 +263,12 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
         return String { "No events captured (targeted process was never on CPU)" };
 
     Vector<Event> events;
+    String sample_counter;
+    u32 sample_period = 0;
+
+    // The same few return addresses make up most of the stacks, so each one is only symbolicated once.
+    HashMap<FlatPtr, Frame> kernel_frame_cache;
+    HashMap<pid_t, HashMap<FlatPtr, Frame>> process_frame_caches;
 
     for (auto& perf_event_value : perf_events.values()) {
         auto& perf_event = perf_event_value.as_object();
@@ -269,12 +284,32 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
             event.size = perf_event.get("size").to_number<size_t>();
         } else if (event.type == "free") {
             event.ptr = perf_event.get("ptr").to_number<FlatPtr>();
+        } else if (event.type == "sample" && sample_counter.is_null()) {
+            sample_counter = perf_event.get("counter").as_string_or("timer");
+            sample_counter.replace("_", " ", true);
+            sample_period = perf_event.get("period").to_number<u32>();
         }
 
+        auto it = sampled_processes.find_if([&](auto& entry) {
+            // FIXME: This doesn't support multi-threaded programs!
+            return entry.pid == event.tid;
+        });
+        LibraryMetadata* library_metadata {};
+        if (!it.is_end())
+            library_metadata = it->library_metadata.ptr();
+        auto& process_frame_cache = process_frame_caches.ensure(event.tid);
+
         auto stack_array = perf_event.get("stack").as_array();
         for (ssize_t i = stack_array.values().size() - 1; i >= 0; --i) {
             auto& frame = stack_array.at(i);
             auto ptr = frame.to_number<u32>();
+
+            auto& frame_cache = ptr >= 0xc0000000 ? kernel_frame_cache : process_frame_cache;
+            if (auto cached_frame = frame_cache.get(ptr); cached_frame.has_value()) {
+                event.frames.append(cached_frame.value());
+                continue;
+            }
+
             u32 offset = 0;
             FlyString object_name;
             String symbol;
@@ -286,14 +321,6 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
                     symbol = "??";
                 }
             } else {
-                auto it = sampled_processes.find_if([&](auto& entry) {
-                    // FIXME: This doesn't support multi-threaded programs!
-                    return entry.pid == event.tid;
-                });
-                // FIXME: This logic is kinda gnarly, find a way to clean it up.
-                LibraryMetadata* library_metadata {};
-                if (!it.is_end())
-                    library_metadata = it->library_metadata.ptr();
                 if (auto* library = library_metadata ? library_metadata->library_containing(ptr) : nullptr) {
                     object_name = library->name;
                     symbol = library->symbolicate(ptr, &offset);
@@ -302,7 +329,9 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
                 }
             }
 
-            event.frames.append({ object_name, symbol, ptr, offset });
+            Frame symbolicated_frame { object_name, symbol, ptr, offset };
+            frame_cache.set(ptr, symbolicated_frame);
+            event.frames.append(move(symbolicated_frame));
         }
 
         if (event.frames.size() < 2)
@@ -314,7 +343,12 @@ Result<NonnullOwnPtr<Profile>, String> Profile::load_from_perfcore_file(const St
         events.append(move(event));
     }
 
-    return adopt_own(*new Profile(move(sampled_processes), move(events)));
+    auto profile = adopt_own(*new Profile(move(sampled_processes), move(events)));
+    if (!sample_counter.is_null()) {
+        profile->m_sample_counter = move(sample_counter);
+        profile->m_sample_period = sample_period;
+    }
+    return profile;
 }
 
 void ProfileNode::sort_children()
@@ -330,6 +364,7 @@ void Profile::set_timestamp_filter_range(u64 start, u64 end)
 
     m_timestamp_filter_range_start = min(start, end);
     m_timestamp_filter_range_end = max(start, end);
+    update_filter_range_event_indices();
 
     rebuild_tree();
     m_samples_model->update();
@@ -340,10 +375,36 @@ void Profile::clear_timestamp_filter_range()
     if (!m_has_timestamp_filter_range)
         return;
     m_has_timestamp_filter_range = false;
+    update_filter_range_event_indices();
     rebuild_tree();
     m_samples_model->update();
 }
 
+void Profile::update_filter_range_event_indices()
+{
+    m_filter_range_first_event_index = 0;
+    m_filter_range_end_event_index = m_events.size();
+    if (!m_has_timestamp_filter_range || !m_events_are_sorted_by_timestamp)
+        return;
+
+    // Returns the index of the first event that happened after |timestamp|, or the event count if there is none.
+    auto index_of_first_event_after = [this](u64 timestamp) {
+        size_t low = 0;
+        size_t high = m_events.size();
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (m_events[middle].timestamp > timestamp)
+                high = middle;
+            else
+                low = middle + 1;
+        }
+        return low;
+    };
+
+    m_filter_range_first_event_index = m_timestamp_filter_range_start ? index_of_first_event_after(m_timestamp_filter_range_start - 1) : 0;
+    m_filter_range_end_event_index = index_of_first_event_after(m_timestamp_filter_range_end);
+}
+
 void Profile::set_inverted(bool inverted)
 {
     if (m_inverted == inverted)
@@ -204,6 +204,10 @@ public:
     u64 last_timestamp() const { return m_last_timestamp; }
     u32 deepest_stack_depth() const { return m_deepest_stack_depth; }
 
+    // What triggered the samples: "timer", or the hardware event that was counted (e.g. "cache misses").
+    const String& sample_counter() const { return m_sample_counter; }
+    u32 sample_period() const { return m_sample_period; }
+
     void set_timestamp_filter_range(u64 start, u64 end);
     void clear_timestamp_filter_range();
     bool has_timestamp_filter_range() const { return m_has_timestamp_filter_range; }
@@ -219,7 +223,8 @@ public:
     template<typename Callback>
     void for_each_event_in_filter_range(Callback callback)
     {
-        for (auto& event : m_events) {
+        for (size_t event_index = m_filter_range_first_event_index; event_index < m_filter_range_end_event_index; ++event_index) {
+            auto& event = m_events[event_index];
             if (has_timestamp_filter_range()) {
                 auto timestamp = event.timestamp;
                 if (timestamp < m_timestamp_filter_range_start || timestamp > m_timestamp_filter_range_end)
@@ -233,6 +238,7 @@ private:
     Profile(Vector<Process>, Vector<Event>);
 
     void rebuild_tree();
+    void update_filter_range_event_indices();
 
     RefPtr<ProfileModel> m_model;
     RefPtr<SamplesModel> m_samples_model;
@@ -249,10 +255,19 @@ private:
     Vector<Process> m_processes;
     Vector<Event> m_events;
 
+    String m_sample_counter { "timer" };
+    u32 m_sample_period { 0 };
+
     bool m_has_timestamp_filter_range { false };
     u64 m_timestamp_filter_range_start { 0 };
     u64 m_timestamp_filter_range_end { 0 };
 
+    // All the events in the filter range are between these indices. When the events aren't in timestamp order,
+    // that is all of them.
+    bool m_events_are_sorted_by_timestamp { true };
+    size_t m_filter_range_first_event_index { 0 };
+    size_t m_filter_range_end_event_index { 0 };
+
     u32 m_deepest_stack_depth { 0 };
     bool m_inverted { false };
     bool m_show_top_functions { false };
@@ -77,6 +77,8 @@ String ProfileModel::column_name(int column) const
 {
     switch (column) {
     case Column::SampleCount:
+        if (m_profile.sample_counter() != "timer")
+            return String::formatted("{} Samples ({} every {})", m_profile.show_percentages() ? "%" : "#", m_profile.sample_counter(), m_profile.sample_period());
         return m_profile.show_percentages() ? "% Samples" : "# Samples";
     case Column::SelfCount:
         return m_profile.show_percentages() ? "% Self" : "# Self";
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include "FlameGraphView.h"
 #include "IndividualSampleModel.h"
 #include "Profile.h"
 #include "ProfileTimelineWidget.h"
@@ -31,14 +32,31 @@
 #include <serenity.h>
 #include <string.h>
 
-static bool generate_profile(pid_t& pid);
+static bool generate_profile(pid_t& pid, int counter);
+
+static Optional<int> parse_counter(const StringView& name)
+{
+    if (name == "timer")
+        return PERF_COUNTER_TIMER;
+    if (name == "cycles")
+        return PERF_COUNTER_CYCLES;
+    if (name == "instructions")
+        return PERF_COUNTER_INSTRUCTIONS;
+    if (name == "cache-misses")
+        return PERF_COUNTER_CACHE_MISSES;
+    if (name == "branch-misses")
+        return PERF_COUNTER_BRANCH_MISSES;
+    return {};
+}
 
 int main(int argc, char** argv)
 {
     int pid = 0;
     const char* perfcore_file_arg = nullptr;
+    const char* counter_arg = "timer";
     Core::ArgsParser args_parser;
     args_parser.add_option(pid, "PID to profile", "pid", 'p', "PID");
+    args_parser.add_option(counter_arg, "What to sample on: timer (default), cycles, instructions, cache-misses or branch-misses", "counter", 'C', "counter");
     args_parser.add_positional_argument(perfcore_file_arg, "Path of perfcore file", "perfcore-file", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -47,12 +65,18 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    auto counter = parse_counter(counter_arg);
+    if (!counter.has_value()) {
+        warnln("Unknown counter '{}'", counter_arg);
+        return 1;
+    }
+
     auto app = GUI::Application::construct(argc, argv);
     auto app_icon = GUI::Icon::default_icon("app-profiler");
 
     String perfcore_file;
     if (!perfcore_file_arg) {
-        if (!generate_profile(pid))
+        if (!generate_profile(pid, counter.value()))
             return 0;
         perfcore_file = String::formatted("/proc/{}/perf_events", pid);
     } else {
@@ -106,6 +130,11 @@ int main(int argc, char** argv)
         disassembly_view.set_model(profile->disassembly_model());
     };
 
+    auto& flame_graph_tab = tab_widget.add_tab<GUI::Widget>("Flame Graph");
+    flame_graph_tab.set_layout<GUI::VerticalBoxLayout>();
+    flame_graph_tab.layout()->set_margins({ 4, 4, 4, 4 });
+    flame_graph_tab.add<FlameGraphView>(*profile);
+
     auto& samples_tab = tab_widget.add_tab<GUI::Widget>("Samples");
     samples_tab.set_layout<GUI::VerticalBoxLayout>();
     samples_tab.layout()->set_margins({ 4, 4, 4, 4 });
@@ -187,7 +216,7 @@ static bool prompt_to_stop_profiling(pid_t pid, const String& process_name)
     return GUI::Application::the()->exec() == 0;
 }
 
-bool generate_profile(pid_t& pid)
+bool generate_profile(pid_t& pid, int counter)
 {
     if (!pid) {
         auto process_chooser = GUI::ProcessChooser::construct("Profiler", "Profile", Gfx::Bitmap::load_from_file("/res/icons/16x16/app-profiler.png"));
@@ -208,7 +237,7 @@ bool generate_profile(pid_t& pid)
         process_name = "(unknown)";
     }
 
-    if (profiling_enable(pid) < 0) {
+    if (profiling_enable_counter(pid, counter, 0) < 0) {
         int saved_errno = errno;
         GUI::MessageBox::show(nullptr, String::formatted("Unable to profile process {}({}): {}", process_name, pid, strerror(saved_errno)), "Profiler", GUI::MessageBox::Type::Error);
         return false;
@@ -206,37 +206,95 @@ bool Emulator::load_elf()
     return true;
 }
 
+static constexpr bool trace = false;
+
 int Emulator::exec()
 {
-    // X86::ELFSymbolProvider symbol_provider(*m_elf);
-    X86::ELFSymbolProvider* symbol_provider = nullptr;
-
-    constexpr bool trace = false;
-
     while (!m_shutdown) {
+        if (auto* block = basic_block_at(m_cpu.eip())) {
+            execute_basic_block(*block);
+            continue;
+        }
         m_cpu.save_base_eip();
+        execute_instruction(X86::Instruction::from_stream(m_cpu, true, true));
+    }
 
-        auto insn = X86::Instruction::from_stream(m_cpu, true, true);
+    if (auto* tracer = malloc_tracer())
+        tracer->dump_leak_report();
 
-        if constexpr (trace) {
-            outln("{:p}  \033[33;1m{}\033[0m", m_cpu.base_eip(), insn.to_string(m_cpu.base_eip(), symbol_provider));
-        }
+    return m_exit_status;
+}
 
-        (m_cpu.*insn.handler())(insn);
+ALWAYS_INLINE void Emulator::execute_instruction(const X86::Instruction& insn)
+{
+    if constexpr (trace) {
+        // X86::ELFSymbolProvider symbol_provider(*m_elf);
+        X86::ELFSymbolProvider* symbol_provider = nullptr;
+        outln("{:p}  \033[33;1m{}\033[0m", m_cpu.base_eip(), insn.to_string(m_cpu.base_eip(), symbol_provider));
+    }
 
-        if constexpr (trace) {
-            m_cpu.dump();
-        }
+    (m_cpu.*insn.handler())(insn);
 
-        if (m_pending_signals) [[unlikely]] {
-            dispatch_one_pending_signal();
-        }
+    if constexpr (trace) {
+        m_cpu.dump();
     }
 
-    if (auto* tracer = malloc_tracer())
-        tracer->dump_leak_report();
+    if (m_pending_signals) [[unlikely]] {
+        dispatch_one_pending_signal();
+    }
+}
 
-    return m_exit_status;
+// Only code that can't be written to is cached. Code only stops being that when it is unmapped or changes protection,
+// which invalidates the cache.
+bool Emulator::can_cache_code_at(u32 address)
+{
+    auto* region = m_mmu.find_region({ m_cpu.cs(), address });
+    return region && region->is_executable() && (region->is_text() || !region->is_writable());
+}
+
+Emulator::BasicBlock* Emulator::basic_block_at(u32 eip)
+{
+    if (auto it = m_basic_blocks.find(eip); it != m_basic_blocks.end())
+        return it->value.ptr();
+    if (!can_cache_code_at(eip))
+        return nullptr;
+    auto block = make<BasicBlock>();
+    auto* block_ptr = block.ptr();
+    m_basic_blocks.set(eip, move(block));
+    return block_ptr;
+}
+
+void Emulator::execute_basic_block(BasicBlock& block)
+{
+    auto generation = m_basic_blocks_generation;
+    for (size_t i = 0;; ++i) {
+        m_cpu.save_base_eip();
+        if (i == block.instructions.size()) {
+            auto insn = X86::Instruction::from_stream(m_cpu, true, true);
+            if (!can_cache_code_at(m_cpu.base_eip()) || !can_cache_code_at(m_cpu.eip() - 1)) {
+                execute_instruction(insn);
+                return;
+            }
+            block.instructions.append({ insn, m_cpu.eip() });
+        } else {
+            m_cpu.set_eip(block.instructions[i].next_eip);
+        }
+
+        // The block may go away while the instruction executes, so nothing in it can be used after this.
+        auto insn = block.instructions[i].instruction;
+        auto next_eip = block.instructions[i].next_eip;
+        execute_instruction(insn);
+
+        if (m_shutdown || generation != m_basic_blocks_generation || m_cpu.eip() != next_eip)
+            return;
+    }
+}
+
+void Emulator::invalidate_basic_blocks()
+{
+    m_basic_blocks.clear();
+    ++m_basic_blocks_generation;
+    m_cpu.invalidate_code_cache();
 }
 
 Vector<FlatPtr> Emulator::raw_backtrace()
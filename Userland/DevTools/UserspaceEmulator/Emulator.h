@@ -49,6 +49,9 @@ public:
 
     void did_receive_signal(int signum) { m_pending_signals |= (1 << signum); }
 
+    // Drops all decoded instructions. Must be called when executable memory is unmapped or changes protection.
+    void invalidate_basic_blocks();
+
     void dump_regions() const;
 
 private:
@@ -61,6 +64,24 @@ private:
 
     OwnPtr<MallocTracer> m_malloc_tracer;
 
+    // The instructions from one address on, as they were decoded the first time they were executed, up to the first
+    // one that went somewhere else than the next instruction.
+    struct BasicBlock {
+        struct CachedInstruction {
+            X86::Instruction instruction;
+            u32 next_eip { 0 };
+        };
+        Vector<CachedInstruction> instructions;
+    };
+
+    bool can_cache_code_at(u32 address);
+    BasicBlock* basic_block_at(u32 eip);
+    void execute_basic_block(BasicBlock&);
+    void execute_instruction(const X86::Instruction&);
+
+    HashMap<u32, NonnullOwnPtr<BasicBlock>> m_basic_blocks;
+    u64 m_basic_blocks_generation { 0 };
+
     void setup_stack(Vector<ELF::AuxiliaryValue>);
     Vector<ELF::AuxiliaryValue> generate_auxiliary_vector(FlatPtr load_base, FlatPtr entry_eip, String executable_path, int executable_fd) const;
     void register_signal_handlers();
@@ -77,8 +98,10 @@ private:
     int virt$stat(FlatPtr);
     int virt$realpath(FlatPtr);
     int virt$gethostname(FlatPtr, ssize_t);
-    int virt$profiling_enable(pid_t);
+    int virt$profiling_enable(pid_t, int, u32);
     int virt$profiling_disable(pid_t);
+    int virt$ktrace_enable(pid_t, u32);
+    int virt$ktrace_disable();
     int virt$disown(pid_t);
     int virt$purge(int mode);
     u32 virt$mmap(u32);
@@ -159,6 +182,8 @@ private:
     int virt$set_thread_name(pid_t, FlatPtr, size_t);
     pid_t virt$setsid();
     int virt$watch_file(FlatPtr, size_t);
+    int virt$add_inode_watch(int fd, FlatPtr, size_t);
+    int virt$remove_inode_watch(int fd, int watch_descriptor);
     int virt$readlink(FlatPtr);
     u32 virt$allocate_tls(size_t);
     int virt$ptsname(int fd, FlatPtr buffer, size_t buffer_size);
@@ -35,6 +35,9 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
     reportln("Syscall: {} ({:x})", Syscall::to_string((Syscall::Function)function), function);
 #endif
     switch (function) {
+    case SC_map_time_page:
+        // The kernel's time page isn't part of the emulated address space, so have LibC fall back to the syscalls.
+        return -ENOSYS;
     case SC_chdir:
         return virt$chdir(arg1, arg2);
     case SC_dup2:
@@ -72,7 +75,7 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
     case SC_get_dir_entries:
         return virt$get_dir_entries(arg1, arg2, arg3);
     case SC_profiling_enable:
-        return virt$profiling_enable(arg1);
+        return virt$profiling_enable(arg1, arg2, arg3);
     case SC_profiling_disable:
         return virt$profiling_disable(arg1);
     case SC_disown:
@@ -225,6 +228,14 @@ u32 Emulator::virt_syscall(u32 function, u32 arg1, u32 arg2, u32 arg3)
         return virt$setsid();
     case SC_watch_file:
         return virt$watch_file(arg1, arg2);
+    case SC_add_inode_watch:
+        return virt$add_inode_watch(arg1, arg2, arg3);
+    case SC_remove_inode_watch:
+        return virt$remove_inode_watch(arg1, arg2);
+    case SC_ktrace_enable:
+        return virt$ktrace_enable(arg1, arg2);
+    case SC_ktrace_disable:
+        return virt$ktrace_disable();
     case SC_clock_nanosleep:
         return virt$clock_nanosleep(arg1);
     case SC_readlink:
@@ -265,9 +276,9 @@ int Emulator::virt$recvfd(int socket, int options)
     return syscall(SC_recvfd, socket, options);
 }
 
-int Emulator::virt$profiling_enable(pid_t pid)
+int Emulator::virt$profiling_enable(pid_t pid, int counter, u32 sample_period)
 {
-    return syscall(SC_profiling_enable, pid);
+    return syscall(SC_profiling_enable, pid, counter, sample_period);
 }
 
 int Emulator::virt$profiling_disable(pid_t pid)
@@ -275,6 +286,16 @@ int Emulator::virt$profiling_disable(pid_t pid)
     return syscall(SC_profiling_disable, pid);
 }
 
+int Emulator::virt$ktrace_enable(pid_t pid, u32 categories)
+{
+    return syscall(SC_ktrace_enable, pid, categories);
+}
+
+int Emulator::virt$ktrace_disable()
+{
+    return syscall(SC_ktrace_disable);
+}
+
 int Emulator::virt$disown(pid_t pid)
 {
     return syscall(SC_disown, pid);
@@ -812,10 +833,14 @@ u32 Emulator::virt$munmap(FlatPtr address, size_t size)
     if (has_non_mmap_region)
         return -EINVAL;
 
+    bool has_executable_region = false;
     for (Region* region : marked_for_deletion) {
+        has_executable_region |= region->is_executable();
         m_range_allocator.deallocate(region->range());
         mmu().remove_region(*region);
     }
+    if (has_executable_region)
+        invalidate_basic_blocks();
     return 0;
 }
 
@@ -930,6 +955,7 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
 {
     round_to_page_size(base, size);
     bool has_non_mmapped_region = false;
+    bool has_executable_region = false;
 
     mmu().for_regions_in({ 0x23, base }, size, [&](Region* region) {
         if (region) {
@@ -938,10 +964,13 @@ u32 Emulator::virt$mprotect(FlatPtr base, size_t size, int prot)
                 return IterationDecision::Break;
             }
             auto& mmap_region = *(MmapRegion*)region;
+            has_executable_region |= mmap_region.is_executable() || (prot & PROT_EXEC);
             mmap_region.set_prot(prot);
         }
         return IterationDecision::Continue;
     });
+    if (has_executable_region)
+        invalidate_basic_blocks();
     if (has_non_mmapped_region)
         return -EINVAL;
 
@@ -1174,11 +1203,7 @@ int Emulator::virt$stat(FlatPtr params_addr)
 
     auto path = String::copy(mmu().copy_buffer_from_vm((FlatPtr)params.path.characters, params.path.length));
     struct stat host_statbuf;
-    int rc;
-    if (params.follow_symlinks)
-        rc = stat(path.characters(), &host_statbuf);
-    else
-        rc = lstat(path.characters(), &host_statbuf);
+    int rc = fstatat(params.dirfd, path.characters(), &host_statbuf, params.follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW);
     if (rc < 0)
         return -errno;
     mmu().copy_to_vm((FlatPtr)params.statbuf, &host_statbuf, sizeof(host_statbuf));
@@ -1391,6 +1416,17 @@ int Emulator::virt$watch_file(FlatPtr user_path_addr, size_t path_length)
     return syscall(SC_watch_file, user_path.data(), user_path.size());
 }
 
+int Emulator::virt$add_inode_watch(int fd, FlatPtr user_path_addr, size_t path_length)
+{
+    auto user_path = mmu().copy_buffer_from_vm(user_path_addr, path_length);
+    return syscall(SC_add_inode_watch, fd, user_path.data(), user_path.size());
+}
+
+int Emulator::virt$remove_inode_watch(int fd, int watch_descriptor)
+{
+    return syscall(SC_remove_inode_watch, fd, watch_descriptor);
+}
+
 int Emulator::virt$clock_nanosleep(FlatPtr params_addr)
 {
     Syscall::SC_clock_nanosleep_params params;
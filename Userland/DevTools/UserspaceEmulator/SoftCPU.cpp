@@ -96,7 +96,6 @@ void SoftCPU::update_code_cache()
         TODO();
     }
 
-    // FIXME: This cache needs to be invalidated if the code region is ever unmapped.
     m_cached_code_region = region;
     m_cached_code_base_ptr = region->data();
 }
@@ -52,6 +52,13 @@ public:
         m_eip = eip;
     }
 
+    // Must be called when code regions are unmapped or change protection, as the CPU reads code from the last one.
+    void invalidate_code_cache()
+    {
+        m_cached_code_region = nullptr;
+        m_cached_code_base_ptr = nullptr;
+    }
+
     struct Flags {
         enum Flag {
             CF = 0x0001,
@@ -158,11 +158,10 @@ void TarOutputStream::add_file(const String& path, mode_t mode, const ReadonlyBy
     VERIFY(m_stream.write_or_error(Bytes { &header, sizeof(header) }));
     u8 padding[block_size] = { 0 };
     VERIFY(m_stream.write_or_error(Bytes { &padding, block_size - sizeof(header) }));
-    size_t n_written = 0;
-    while (n_written < bytes.size()) {
-        n_written += m_stream.write(bytes.slice(n_written, min(bytes.size() - n_written, block_size)));
-    }
-    VERIFY(m_stream.write_or_error(Bytes { &padding, block_size - (n_written % block_size) }));
+    // Hand over the contents in one go, so that a buffered stream can pass them straight through.
+    VERIFY(m_stream.write_or_error(bytes));
+    if (bytes.size() % block_size != 0)
+        VERIFY(m_stream.write_or_error(Bytes { &padding, block_size - (bytes.size() % block_size) }));
 }
 
 void TarOutputStream::finish()
@@ -37,6 +37,10 @@ Optional<Zip> Zip::try_create(const ReadonlyBytes& buffer)
     if (end_of_central_directory.disk_number != 0 || end_of_central_directory.central_directory_start_disk != 0 || end_of_central_directory.disk_records_count != end_of_central_directory.total_records_count)
         return {}; // TODO: support multi-volume zip archives
 
+    Zip zip;
+    zip.m_input_data = buffer;
+    zip.m_central_directory_record_offsets.ensure_capacity(end_of_central_directory.total_records_count);
+
     size_t member_offset = end_of_central_directory.central_directory_offset;
     for (size_t i = 0; i < end_of_central_directory.total_records_count; i++) {
         CentralDirectoryRecord central_directory_record {};
@@ -63,44 +67,50 @@ Optional<Zip> Zip::try_create(const ReadonlyBytes& buffer)
             return {};
         if (buffer.size() - (local_file_header.compressed_data - buffer.data()) < central_directory_record.compressed_size)
             return {};
+        zip.m_central_directory_record_offsets.unchecked_append(member_offset);
         member_offset += central_directory_record.size();
     }
 
-    Zip zip;
-    zip.m_input_data = buffer;
-    zip.member_count = end_of_central_directory.total_records_count;
-    zip.members_start_offset = end_of_central_directory.central_directory_offset;
     return zip;
 }
 
 bool Zip::for_each_member(Function<IterationDecision(const ZipMember&)> callback)
 {
-    size_t member_offset = members_start_offset;
-    for (size_t i = 0; i < member_count; i++) {
-        CentralDirectoryRecord central_directory_record {};
-        VERIFY(central_directory_record.read(m_input_data.slice(member_offset)));
-        LocalFileHeader local_file_header {};
-        VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
-
-        ZipMember member;
-        char null_terminated_name[central_directory_record.name_length + 1];
-        memcpy(null_terminated_name, central_directory_record.name, central_directory_record.name_length);
-        null_terminated_name[central_directory_record.name_length] = 0;
-        member.name = String { null_terminated_name };
-        member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
-        member.compression_method = static_cast<ZipCompressionMethod>(central_directory_record.compression_method);
-        member.uncompressed_size = central_directory_record.uncompressed_size;
-        member.crc32 = central_directory_record.crc32;
-        member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.ends_with('/'); // FIXME: better directory detection
-
-        if (callback(member) == IterationDecision::Break)
+    for (size_t i = 0; i < member_count(); i++) {
+        if (callback(member_at(i)) == IterationDecision::Break)
             return false;
-
-        member_offset += central_directory_record.size();
     }
     return true;
 }
 
+ZipMember Zip::member_at(size_t index) const
+{
+    CentralDirectoryRecord central_directory_record {};
+    VERIFY(central_directory_record.read(m_input_data.slice(m_central_directory_record_offsets[index])));
+    LocalFileHeader local_file_header {};
+    VERIFY(local_file_header.read(m_input_data.slice(central_directory_record.local_file_header_offset)));
+
+    ZipMember member;
+    member.name = String { reinterpret_cast<const char*>(central_directory_record.name), central_directory_record.name_length };
+    member.compressed_data = { local_file_header.compressed_data, central_directory_record.compressed_size };
+    member.compression_method = static_cast<ZipCompressionMethod>(central_directory_record.compression_method);
+    member.uncompressed_size = central_directory_record.uncompressed_size;
+    member.crc32 = central_directory_record.crc32;
+    member.is_directory = central_directory_record.external_attributes & zip_directory_external_attribute || member.name.ends_with('/'); // FIXME: better directory detection
+    return member;
+}
+
+Optional<ZipMember> Zip::find_member(const StringView& name) const
+{
+    for (size_t i = 0; i < member_count(); i++) {
+        CentralDirectoryRecord central_directory_record {};
+        VERIFY(central_directory_record.read(m_input_data.slice(m_central_directory_record_offsets[i])));
+        if (StringView { central_directory_record.name, central_directory_record.name_length } == name)
+            return member_at(i);
+    }
+    return {};
+}
+
 ZipOutputStream::ZipOutputStream(OutputStream& stream)
     : m_stream(stream)
 {
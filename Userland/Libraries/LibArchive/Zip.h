@@ -11,6 +11,7 @@
 #include <AK/Span.h>
 #include <AK/Stream.h>
 #include <AK/String.h>
+#include <AK/StringView.h>
 #include <AK/Vector.h>
 #include <string.h>
 
@@ -210,11 +211,15 @@ public:
     static Optional<Zip> try_create(const ReadonlyBytes& buffer);
     bool for_each_member(Function<IterationDecision(const ZipMember&)>);
 
+    // Members are found through the central directory, so getting at one doesn't involve any of the others.
+    size_t member_count() const { return m_central_directory_record_offsets.size(); }
+    ZipMember member_at(size_t index) const;
+    Optional<ZipMember> find_member(const StringView& name) const;
+
 private:
     static bool find_end_of_central_directory_offset(const ReadonlyBytes&, size_t& offset);
 
-    u16 member_count { 0 };
-    size_t members_start_offset { 0 };
+    Vector<u32> m_central_directory_record_offsets;
     ReadonlyBytes m_input_data;
 };
 
@@ -18,43 +18,35 @@ i32 Buffer::allocate_id()
 template<typename SampleReader>
 static void read_samples_from_stream(InputMemoryStream& stream, SampleReader read_sample, Vector<Frame>& samples, ResampleHelper& resampler, int num_channels)
 {
-    double norm_l = 0;
-    double norm_r = 0;
+    Vector<Frame> decoded_samples;
+    decoded_samples.ensure_capacity(samples.capacity());
 
     switch (num_channels) {
     case 1:
         for (;;) {
-            while (resampler.read_sample(norm_l, norm_r)) {
-                samples.append(Frame(norm_l));
-            }
-            norm_l = read_sample(stream);
-
-            if (stream.handle_any_error()) {
+            auto norm_l = read_sample(stream);
+            if (stream.handle_any_error())
                 break;
-            }
-            resampler.process_sample(norm_l, norm_r);
+            decoded_samples.append(Frame(norm_l));
         }
         break;
     case 2:
         for (;;) {
-            while (resampler.read_sample(norm_l, norm_r)) {
-                samples.append(Frame(norm_l, norm_r));
-            }
-            norm_l = read_sample(stream);
-            norm_r = read_sample(stream);
-
-            if (stream.handle_any_error()) {
+            auto norm_l = read_sample(stream);
+            auto norm_r = read_sample(stream);
+            if (stream.handle_any_error())
                 break;
-            }
-            resampler.process_sample(norm_l, norm_r);
+            decoded_samples.append(Frame(norm_l, norm_r));
         }
         break;
     default:
         VERIFY_NOT_REACHED();
     }
+
+    resampler.process(decoded_samples, samples);
 }
 
-static double read_norm_sample_24(InputMemoryStream& stream)
+static float read_norm_sample_24(InputMemoryStream& stream)
 {
     u8 byte = 0;
     stream >> byte;
@@ -68,21 +60,21 @@ static double read_norm_sample_24(InputMemoryStream& stream)
     value = sample1 << 8;
     value |= (sample2 << 16);
     value |= (sample3 << 24);
-    return double(value) / NumericLimits<i32>::max();
+    return float(value) / NumericLimits<i32>::max();
 }
 
-static double read_norm_sample_16(InputMemoryStream& stream)
+static float read_norm_sample_16(InputMemoryStream& stream)
 {
     LittleEndian<i16> sample;
     stream >> sample;
-    return double(sample) / NumericLimits<i16>::max();
+    return float(sample) / NumericLimits<i16>::max();
 }
 
-static double read_norm_sample_8(InputMemoryStream& stream)
+static float read_norm_sample_8(InputMemoryStream& stream)
 {
     u8 sample = 0;
     stream >> sample;
-    return double(sample) / NumericLimits<u8>::max();
+    return float(sample) / NumericLimits<u8>::max();
 }
 
 RefPtr<Buffer> Buffer::from_pcm_data(ReadonlyBytes data, ResampleHelper& resampler, int num_channels, int bits_per_sample)
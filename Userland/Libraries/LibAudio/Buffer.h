@@ -8,6 +8,7 @@
 
 #include <AK/ByteBuffer.h>
 #include <AK/MemoryStream.h>
+#include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/AnonymousBuffer.h>
@@ -25,14 +26,14 @@ struct Frame {
     }
 
     // For mono
-    Frame(double left)
+    Frame(float left)
         : left(left)
         , right(left)
     {
     }
 
     // For stereo
-    Frame(double left, double right)
+    Frame(float left, float right)
         : left(left)
         , right(right)
     {
@@ -53,7 +54,7 @@ struct Frame {
 
     void scale(int percent)
     {
-        double pct = (double)percent / 100.0;
+        float pct = (float)percent / 100.0f;
         left *= pct;
         right *= pct;
     }
@@ -65,25 +66,33 @@ struct Frame {
         return *this;
     }
 
-    double left;
-    double right;
+    float left;
+    float right;
 };
 
-// Small helper to resample from one playback rate to another
-// This isn't really "smart", in that we just insert (or drop) samples.
-// Should do better...
+// Converts audio from one sample rate to another with a windowed-sinc filter.
+// The filter is precomputed for a number of phases between two input frames, and interpolated between the two
+// nearest phases for each output frame. Input frames are kept between calls, so a stream can be fed in blocks.
 class ResampleHelper {
 public:
     ResampleHelper(double source, double target);
 
-    void process_sample(double sample_l, double sample_r);
-    bool read_sample(double& next_l, double& next_r);
+    // Appends as many resampled frames onto |output| as the input so far allows.
+    void process(Span<const Frame> input, Vector<Frame>& output);
+    // Forgets the input so far, e.g. after seeking.
+    void reset();
 
 private:
+    // Each output frame is made from this many input frames around it.
+    static constexpr size_t tap_count = 16;
+    static constexpr size_t phase_count = 256;
+
     const double m_ratio;
-    double m_current_ratio { 0 };
-    double m_last_sample_l { 0 };
-    double m_last_sample_r { 0 };
+    // For each phase, and one past the last one, the coefficients of the taps. Each coefficient is there twice, so
+    // that a row lines up with the interleaved left and right samples of the input frames.
+    Vector<float> m_filter_bank;
+    Vector<Frame> m_history;
+    double m_position { 0 };
 };
 
 // A buffer of audio samples, normalized to 44100hz.
@@ -7,10 +7,12 @@
 #include <AK/Debug.h>
 #include <AK/NumericLimits.h>
 #include <AK/OwnPtr.h>
+#include <AK/SIMD.h>
 #include <LibAudio/Buffer.h>
 #include <LibAudio/WavLoader.h>
 #include <LibCore/File.h>
 #include <LibCore/IODeviceStreamReader.h>
+#include <math.h>
 
 namespace Audio {
 
@@ -84,6 +86,8 @@ void WavLoaderPlugin::seek(const int position)
         m_file->seek(byte_position);
     else
         m_stream->seek(byte_position);
+
+    m_resampler->reset();
 }
 
 void WavLoaderPlugin::reset()
@@ -237,25 +241,86 @@ bool WavLoaderPlugin::parse_header()
 ResampleHelper::ResampleHelper(double source, double target)
     : m_ratio(source / target)
 {
+    reset();
+    if (m_ratio == 1)
+        return;
+
+    // Keep below the lower of the two Nyquist frequencies, with some room for the filter to roll off.
+    double cutoff = min(1.0, 1.0 / m_ratio) * 0.95;
+    constexpr double half_width = tap_count / 2;
+
+    m_filter_bank.resize((phase_count + 1) * tap_count * 2);
+    for (size_t phase = 0; phase <= phase_count; ++phase) {
+        double fraction = (double)phase / phase_count;
+        double coefficients[tap_count];
+        double sum = 0;
+        for (size_t tap = 0; tap < tap_count; ++tap) {
+            // The distance between this tap's input frame and the output frame, in input frames.
+            double x = (double)tap - (half_width - 1) - fraction;
+            double sinc = x == 0 ? 1 : sin(M_PI * cutoff * x) / (M_PI * cutoff * x);
+            double blackman = 0.42 + 0.5 * cos(M_PI * x / half_width) + 0.08 * cos(2 * M_PI * x / half_width);
+            coefficients[tap] = fabs(x) >= half_width ? 0 : sinc * blackman;
+            sum += coefficients[tap];
+        }
+        // Normalize each phase on its own, so that a constant signal stays the same.
+        for (size_t tap = 0; tap < tap_count; ++tap) {
+            auto coefficient = (float)(coefficients[tap] / sum);
+            m_filter_bank[(phase * tap_count + tap) * 2] = coefficient;
+            m_filter_bank[(phase * tap_count + tap) * 2 + 1] = coefficient;
+        }
+    }
 }
 
-void ResampleHelper::process_sample(double sample_l, double sample_r)
+void ResampleHelper::reset()
 {
-    m_last_sample_l = sample_l;
-    m_last_sample_r = sample_r;
-    m_current_ratio += 1;
+    // The first output frame lines up with the first input frame, which has no frames before it to filter with.
+    m_history.clear();
+    if (m_ratio != 1) {
+        m_history.resize(tap_count / 2 - 1);
+        m_position = tap_count / 2 - 1;
+    }
 }
 
-bool ResampleHelper::read_sample(double& next_l, double& next_r)
+void ResampleHelper::process(Span<const Frame> input, Vector<Frame>& output)
 {
-    if (m_current_ratio > 0) {
-        m_current_ratio -= m_ratio;
-        next_l = m_last_sample_l;
-        next_r = m_last_sample_r;
-        return true;
+    if (m_ratio == 1) {
+        output.append(input.data(), input.size());
+        return;
+    }
+
+    m_history.append(input.data(), input.size());
+
+    constexpr size_t floats_per_row = tap_count * 2;
+    while ((size_t)m_position + tap_count / 2 < m_history.size()) {
+        auto base = (size_t)m_position;
+        float phase = (float)(m_position - base) * phase_count;
+        auto row = min((size_t)phase, phase_count - 1);
+        float weight = phase - row;
+
+        auto* first_row = &m_filter_bank[row * floats_per_row];
+        auto* second_row = first_row + floats_per_row;
+        auto* samples = (const float*)&m_history[base + 1 - tap_count / 2];
+
+        // Four interleaved samples (two frames) at a time; the even lanes end up with the left channel, the odd
+        // lanes with the right one.
+        AK::SIMD::f32x4 weights = { weight, weight, weight, weight };
+        AK::SIMD::f32x4 sum = {};
+        for (size_t i = 0; i < floats_per_row; i += 4) {
+            AK::SIMD::f32x4 first, second, sample;
+            __builtin_memcpy(&first, first_row + i, sizeof(first));
+            __builtin_memcpy(&second, second_row + i, sizeof(second));
+            __builtin_memcpy(&sample, samples + i, sizeof(sample));
+            sum += (first + (second - first) * weights) * sample;
+        }
+        output.append(Frame(sum[0] + sum[2], sum[1] + sum[3]));
+
+        m_position += m_ratio;
     }
 
-    return false;
+    // Drop the input frames that no output frame will need anymore.
+    auto unneeded_frames = min((size_t)m_position + 1 - tap_count / 2, m_history.size());
+    m_history.remove(0, unneeded_frames);
+    m_position -= unneeded_frames;
 }
 
 }
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <sys/cdefs.h>
+#include <sys/types.h>
+
+__BEGIN_DECLS
+
+#ifdef __i386__
+// The implementations memcpy(), memset(), strlen() and memchr() choose between, depending on
+// the processor. Callers should use those instead, these are only here so they can be compared.
+// The _sse2 variants may only be called if the processor supports SSE2.
+void* __memcpy_rep_movsb(void*, const void*, size_t);
+void* __memcpy_sse2(void*, const void*, size_t);
+void* __memset_rep_stos(void*, int, size_t);
+void* __memset_sse2(void*, int, size_t);
+size_t __strlen_generic(const char*);
+size_t __strlen_sse2(const char*);
+void* __memchr_generic(const void*, int, size_t);
+void* __memchr_sse2(const void*, int, size_t);
+#endif
+
+__END_DECLS
@@ -31,6 +31,9 @@ enum {
 #define DT_WHT DT_WHT
 };
 
+#define IFTODT(mode) (((mode)&0170000) >> 12)
+#define DTTOIF(type) ((type) << 12)
+
 struct dirent {
     ino_t d_ino;
     off_t d_off;
@@ -49,6 +52,7 @@ struct __DIR {
 typedef struct __DIR DIR;
 
 DIR* opendir(const char* name);
+DIR* fdopendir(int fd);
 int closedir(DIR*);
 struct dirent* readdir(DIR*);
 int readdir_r(DIR*, struct dirent*, struct dirent**);
@@ -155,6 +155,8 @@ enum ErrnoCode {
 #define EPFNOSUPPORT EPFNOSUPPORT
     EDIRINTOSELF,
 #define EDIRINTOSELF EDIRINTOSELF
+    ECANCELED,
+#define ECANCELED ECANCELED
     EMAXERRNO,
 #define EMAXERRNO EMAXERRNO
 };
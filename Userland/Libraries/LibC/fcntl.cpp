@@ -28,6 +28,18 @@ int watch_file(const char* path, size_t path_length)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int add_inode_watch(int fd, const char* path, size_t path_length)
+{
+    int rc = syscall(SC_add_inode_watch, fd, path, path_length);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int remove_inode_watch(int fd, int watch_descriptor)
+{
+    int rc = syscall(SC_remove_inode_watch, fd, watch_descriptor);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int creat(const char* path, mode_t mode)
 {
     return open(path, O_CREAT | O_WRONLY | O_TRUNC, mode);
@@ -72,4 +84,11 @@ int openat(int dirfd, const char* path, int options, ...)
     int rc = syscall(SC_open, &params);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
+
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t length, unsigned flags)
+{
+    Syscall::SC_splice_params params { fd_in, off_in, fd_out, off_out, length, flags };
+    int rc = syscall(SC_splice, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
 }
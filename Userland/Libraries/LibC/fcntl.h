@@ -17,6 +17,8 @@ __BEGIN_DECLS
 #define F_GETFL 3
 #define F_SETFL 4
 #define F_ISTTY 5
+#define F_GETPIPE_SZ 1032
+#define F_SETPIPE_SZ 1031
 
 #define FD_CLOEXEC 1
 
@@ -39,10 +41,13 @@ __BEGIN_DECLS
 int creat(const char* path, mode_t);
 int open(const char* path, int options, ...);
 #define AT_FDCWD -100
+#define AT_SYMLINK_NOFOLLOW 0x100
 int openat(int dirfd, const char* path, int options, ...);
 
 int fcntl(int fd, int cmd, ...);
 int watch_file(const char* path, size_t path_length);
+int add_inode_watch(int fd, const char* path, size_t path_length);
+int remove_inode_watch(int fd, int watch_descriptor);
 
 #define F_RDLCK 0
 #define F_WRLCK 1
@@ -59,4 +64,10 @@ struct flock {
     pid_t l_pid;
 };
 
+#define SPLICE_F_MOVE 1
+#define SPLICE_F_NONBLOCK 2
+#define SPLICE_F_MORE 4
+
+ssize_t splice(int fd_in, off_t* off_in, int fd_out, off_t* off_out, size_t length, unsigned flags);
+
 __END_DECLS
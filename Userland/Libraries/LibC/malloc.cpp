@@ -32,9 +32,22 @@ static LibThread::Lock& malloc_lock()
     return *reinterpret_cast<LibThread::Lock*>(&lock_storage);
 }
 
+class MallocLocker {
+public:
+    ALWAYS_INLINE MallocLocker();
+    ALWAYS_INLINE ~MallocLocker() { malloc_lock().unlock(); }
+};
+
 constexpr size_t number_of_chunked_blocks_to_keep_around_per_size_class = 4;
 constexpr size_t number_of_big_blocks_to_keep_around_per_size_class = 8;
 
+// Each thread keeps a small stash of free chunks per size class, so that most
+// malloc() and free() calls never have to touch malloc_lock(). The stash is
+// refilled from and drained to the shared allocators in batches.
+constexpr size_t largest_thread_cached_chunk_size = 1016;
+constexpr size_t number_of_thread_cached_chunks_per_size_class = 32;
+constexpr size_t thread_cache_batch_size = number_of_thread_cached_chunks_per_size_class / 2;
+
 static bool s_log_malloc = false;
 static bool s_scrub_malloc = true;
 static bool s_scrub_free = true;
@@ -79,9 +92,34 @@ struct MallocStats {
     size_t number_of_freed_full_blocks;
     size_t number_of_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_refills;
+    size_t number_of_thread_cache_flushes;
+    size_t number_of_lock_contentions;
 };
 static MallocStats g_malloc_stats = {};
 
+ALWAYS_INLINE MallocLocker::MallocLocker()
+{
+    if (malloc_lock().try_lock())
+        return;
+    malloc_lock().lock();
+    g_malloc_stats.number_of_lock_contentions++;
+}
+
+struct ThreadCache {
+    FreelistEntry* freelists[num_size_classes];
+    size_t chunk_counts[num_size_classes];
+    // Fast path calls are counted per thread and folded into g_malloc_stats
+    // whenever we take the lock anyway, to keep the fast path free of shared writes.
+    size_t pending_malloc_hits;
+    size_t pending_free_hits;
+};
+
+// Zero-initialized, so no constructor has to run before the first malloc().
+static __thread ThreadCache t_thread_cache;
+
 struct Allocator {
     size_t size { 0 };
     size_t block_count { 0 };
@@ -114,6 +152,16 @@ static inline BigAllocator (&big_allocators())[1]
     return reinterpret_cast<BigAllocator(&)[1]>(g_big_allocators_storage);
 }
 
+static size_t size_class_index(const Allocator& allocator)
+{
+    return &allocator - &allocators()[0];
+}
+
+static bool is_thread_cached(size_t good_size)
+{
+    return good_size <= largest_thread_cached_chunk_size;
+}
+
 static Allocator* allocator_for_size(size_t size, size_t& good_size)
 {
     for (size_t i = 0; size_classes[i]; ++i) {
@@ -155,65 +203,18 @@ enum class CallerWillInitializeMemory {
     Yes,
 };
 
-static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
+static void* allocate_chunk(Allocator& allocator, size_t good_size)
 {
-    LOCKER(malloc_lock());
-
-    if (s_log_malloc)
-        dbgln("LibC: malloc({})", size);
-
-    if (!size)
-        return nullptr;
-
-    g_malloc_stats.number_of_malloc_calls++;
-
-    size_t good_size;
-    auto* allocator = allocator_for_size(size, good_size);
-
-    if (!allocator) {
-        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
-#ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(real_size)) {
-            if (!allocator->blocks.is_empty()) {
-                g_malloc_stats.number_of_big_allocator_hits++;
-                auto* block = allocator->blocks.take_last();
-                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
-                bool this_block_was_purged = rc == 1;
-                if (rc < 0) {
-                    perror("madvise");
-                    VERIFY_NOT_REACHED();
-                }
-                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
-                    perror("mprotect");
-                    VERIFY_NOT_REACHED();
-                }
-                if (this_block_was_purged) {
-                    g_malloc_stats.number_of_big_allocator_purge_hits++;
-                    new (block) BigAllocationBlock(real_size);
-                }
-
-                ue_notify_malloc(&block->m_slot[0], size);
-                return &block->m_slot[0];
-            }
-        }
-#endif
-        g_malloc_stats.number_of_big_allocs++;
-        auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
-        new (block) BigAllocationBlock(real_size);
-        ue_notify_malloc(&block->m_slot[0], size);
-        return &block->m_slot[0];
-    }
-
     ChunkedBlock* block = nullptr;
 
-    for (block = allocator->usable_blocks.head(); block; block = block->next()) {
+    for (block = allocator.usable_blocks.head(); block; block = block->next()) {
         if (block->free_chunks())
             break;
     }
 
-    if (!block && allocator->empty_block_count) {
+    if (!block && allocator.empty_block_count) {
         g_malloc_stats.number_of_empty_block_hits++;
-        block = allocator->empty_blocks[--allocator->empty_block_count];
+        block = allocator.empty_blocks[--allocator.empty_block_count];
         int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
         bool this_block_was_purged = rc == 1;
         if (rc < 0) {
@@ -229,7 +230,7 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
             g_malloc_stats.number_of_empty_block_purge_hits++;
             new (block) ChunkedBlock(good_size);
         }
-        allocator->usable_blocks.append(block);
+        allocator.usable_blocks.append(block);
     }
 
     if (!block) {
@@ -238,8 +239,8 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
         snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
         block = (ChunkedBlock*)os_alloc(ChunkedBlock::block_size, buffer);
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(block);
+        ++allocator.block_count;
     }
 
     --block->m_free_chunks;
@@ -249,13 +250,174 @@ static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_ini
     if (block->is_full()) {
         g_malloc_stats.number_of_blocks_full++;
         dbgln_if(MALLOC_DEBUG, "Block {:p} is now full in size class {}", block, good_size);
-        allocator->usable_blocks.remove(block);
-        allocator->full_blocks.append(block);
+        allocator.usable_blocks.remove(block);
+        allocator.full_blocks.append(block);
     }
     dbgln_if(MALLOC_DEBUG, "LibC: allocated {:p} (chunk in block {:p}, size {})", ptr, block, block->bytes_per_chunk());
+    return ptr;
+}
+
+static void return_chunk_to_block(ChunkedBlock* block, void* ptr)
+{
+    auto* entry = (FreelistEntry*)ptr;
+    entry->next = block->m_freelist;
+    block->m_freelist = entry;
+
+    if (block->is_full()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
+        g_malloc_stats.number_of_freed_full_blocks++;
+        allocator->full_blocks.remove(block);
+        allocator->usable_blocks.prepend(block);
+    }
+
+    ++block->m_free_chunks;
+
+    if (!block->used_chunks()) {
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (allocator->block_count < number_of_chunked_blocks_to_keep_around_per_size_class) {
+            dbgln_if(MALLOC_DEBUG, "Keeping block {:p} around for size class {}", block, good_size);
+            g_malloc_stats.number_of_keeps++;
+            allocator->usable_blocks.remove(block);
+            allocator->empty_blocks[allocator->empty_block_count++] = block;
+            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
+            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
+            return;
+        }
+        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
+        g_malloc_stats.number_of_frees++;
+        allocator->usable_blocks.remove(block);
+        --allocator->block_count;
+        os_free(block, ChunkedBlock::block_size);
+    }
+}
+
+ALWAYS_INLINE static void* thread_cache_take(size_t size_class)
+{
+    auto& cache = t_thread_cache;
+    auto* entry = cache.freelists[size_class];
+    if (!entry)
+        return nullptr;
+    cache.freelists[size_class] = entry->next;
+    --cache.chunk_counts[size_class];
+    return entry;
+}
+
+static void fold_thread_cache_stats()
+{
+    // NOTE: The caller is expected to hold malloc_lock().
+    auto& cache = t_thread_cache;
+    g_malloc_stats.number_of_malloc_calls += cache.pending_malloc_hits;
+    g_malloc_stats.number_of_thread_cache_hits += cache.pending_malloc_hits;
+    g_malloc_stats.number_of_free_calls += cache.pending_free_hits;
+    cache.pending_malloc_hits = 0;
+    cache.pending_free_hits = 0;
+}
+
+static void thread_cache_refill(Allocator& allocator, size_t good_size)
+{
+    // NOTE: The caller is expected to hold malloc_lock().
+    auto size_class = size_class_index(allocator);
+    auto& cache = t_thread_cache;
+    g_malloc_stats.number_of_thread_cache_refills++;
+    for (size_t i = cache.chunk_counts[size_class]; i < thread_cache_batch_size; ++i) {
+        auto* entry = (FreelistEntry*)allocate_chunk(allocator, good_size);
+        entry->next = cache.freelists[size_class];
+        cache.freelists[size_class] = entry;
+        ++cache.chunk_counts[size_class];
+    }
+}
+
+static void thread_cache_flush(size_t size_class, size_t chunks_to_keep)
+{
+    // NOTE: The caller is expected to hold malloc_lock().
+    auto& cache = t_thread_cache;
+    if (cache.chunk_counts[size_class] > chunks_to_keep)
+        g_malloc_stats.number_of_thread_cache_flushes++;
+    while (cache.chunk_counts[size_class] > chunks_to_keep) {
+        auto* entry = cache.freelists[size_class];
+        cache.freelists[size_class] = entry->next;
+        --cache.chunk_counts[size_class];
+        auto* block = (ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask);
+        return_chunk_to_block(block, entry);
+    }
+}
+
+static void* allocate_big(size_t size)
+{
+    size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
+#ifdef RECYCLE_BIG_ALLOCATIONS
+    if (auto* allocator = big_allocator_for_size(real_size)) {
+        if (!allocator->blocks.is_empty()) {
+            g_malloc_stats.number_of_big_allocator_hits++;
+            auto* block = allocator->blocks.take_last();
+            int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
+            bool this_block_was_purged = rc == 1;
+            if (rc < 0) {
+                perror("madvise");
+                VERIFY_NOT_REACHED();
+            }
+            if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
+                perror("mprotect");
+                VERIFY_NOT_REACHED();
+            }
+            if (this_block_was_purged) {
+                g_malloc_stats.number_of_big_allocator_purge_hits++;
+                new (block) BigAllocationBlock(real_size);
+            }
+
+            ue_notify_malloc(&block->m_slot[0], size);
+            return &block->m_slot[0];
+        }
+    }
+#endif
+    g_malloc_stats.number_of_big_allocs++;
+    auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
+    new (block) BigAllocationBlock(real_size);
+    ue_notify_malloc(&block->m_slot[0], size);
+    return &block->m_slot[0];
+}
+
+static void* malloc_impl(size_t size, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    if (s_log_malloc)
+        dbgln("LibC: malloc({})", size);
+
+    if (!size)
+        return nullptr;
+
+    size_t good_size;
+    auto* allocator = allocator_for_size(size, good_size);
+
+    void* ptr = nullptr;
+    if (allocator && is_thread_cached(good_size)) {
+        ptr = thread_cache_take(size_class_index(*allocator));
+        if (ptr)
+            ++t_thread_cache.pending_malloc_hits;
+    }
+
+    if (!ptr) {
+        MallocLocker locker;
+
+        g_malloc_stats.number_of_malloc_calls++;
+        fold_thread_cache_stats();
+
+        if (!allocator)
+            return allocate_big(size);
+
+        if (is_thread_cached(good_size)) {
+            thread_cache_refill(*allocator, good_size);
+            ptr = thread_cache_take(size_class_index(*allocator));
+        } else {
+            ptr = allocate_chunk(*allocator, good_size);
+        }
+    }
+    VERIFY(ptr);
 
     if (s_scrub_malloc && caller_will_initialize_memory == CallerWillInitializeMemory::No)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
     ue_notify_malloc(ptr, size);
     return ptr;
@@ -268,13 +430,38 @@ static void free_impl(void* ptr)
     if (!ptr)
         return;
 
-    g_malloc_stats.number_of_free_calls++;
-
-    LOCKER(malloc_lock());
-
     void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
     size_t magic = *(size_t*)block_base;
 
+    if (magic == MAGIC_PAGE_HEADER) {
+        auto* block = (ChunkedBlock*)block_base;
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        if (is_thread_cached(good_size)) {
+            if (s_scrub_free)
+                memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+
+            auto size_class = size_class_index(*allocator);
+            auto& cache = t_thread_cache;
+            auto* entry = (FreelistEntry*)ptr;
+            entry->next = cache.freelists[size_class];
+            cache.freelists[size_class] = entry;
+            ++cache.pending_free_hits;
+            if (++cache.chunk_counts[size_class] <= number_of_thread_cached_chunks_per_size_class)
+                return;
+
+            MallocLocker locker;
+            fold_thread_cache_stats();
+            thread_cache_flush(size_class, number_of_thread_cached_chunks_per_size_class - thread_cache_batch_size);
+            return;
+        }
+    }
+
+    MallocLocker locker;
+
+    g_malloc_stats.number_of_free_calls++;
+    fold_thread_cache_stats();
+
     if (magic == MAGIC_BIGALLOC_HEADER) {
         auto* block = (BigAllocationBlock*)block_base;
 #ifdef RECYCLE_BIG_ALLOCATIONS
@@ -308,39 +495,7 @@ static void free_impl(void* ptr)
     if (s_scrub_free)
         memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
 
-    auto* entry = (FreelistEntry*)ptr;
-    entry->next = block->m_freelist;
-    block->m_freelist = entry;
-
-    if (block->is_full()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        dbgln_if(MALLOC_DEBUG, "Block {:p} no longer full in size class {}", block, good_size);
-        g_malloc_stats.number_of_freed_full_blocks++;
-        allocator->full_blocks.remove(block);
-        allocator->usable_blocks.prepend(block);
-    }
-
-    ++block->m_free_chunks;
-
-    if (!block->used_chunks()) {
-        size_t good_size;
-        auto* allocator = allocator_for_size(block->m_size, good_size);
-        if (allocator->block_count < number_of_chunked_blocks_to_keep_around_per_size_class) {
-            dbgln_if(MALLOC_DEBUG, "Keeping block {:p} around for size class {}", block, good_size);
-            g_malloc_stats.number_of_keeps++;
-            allocator->usable_blocks.remove(block);
-            allocator->empty_blocks[allocator->empty_block_count++] = block;
-            mprotect(block, ChunkedBlock::block_size, PROT_NONE);
-            madvise(block, ChunkedBlock::block_size, MADV_SET_VOLATILE);
-            return;
-        }
-        dbgln_if(MALLOC_DEBUG, "Releasing block {:p} for size class {}", block, good_size);
-        g_malloc_stats.number_of_frees++;
-        allocator->usable_blocks.remove(block);
-        --allocator->block_count;
-        os_free(block, ChunkedBlock::block_size);
-    }
+    return_chunk_to_block(block, ptr);
 }
 
 [[gnu::flatten]] void* malloc(size_t size)
@@ -372,7 +527,6 @@ size_t malloc_size(void* ptr)
 {
     if (!ptr)
         return 0;
-    LOCKER(malloc_lock());
     void* page_base = (void*)((FlatPtr)ptr & ChunkedBlock::block_mask);
     auto* header = (const CommonHeader*)page_base;
     auto size = header->m_size;
@@ -390,7 +544,6 @@ void* realloc(void* ptr, size_t size)
     if (!size)
         return nullptr;
 
-    LOCKER(malloc_lock());
     auto existing_allocation_size = malloc_size(ptr);
 
     if (size <= existing_allocation_size) {
@@ -405,6 +558,14 @@ void* realloc(void* ptr, size_t size)
     return new_ptr;
 }
 
+void __malloc_flush_thread_cache()
+{
+    MallocLocker locker;
+    fold_thread_cache_stats();
+    for (size_t i = 0; i < num_size_classes; ++i)
+        thread_cache_flush(i, 0);
+}
+
 void __malloc_init()
 {
     new (&malloc_lock()) LibThread::Lock();
@@ -455,5 +616,10 @@ void serenity_dump_malloc_stats()
     dbgln("full block frees: {}", g_malloc_stats.number_of_freed_full_blocks);
     dbgln("number of keeps: {}", g_malloc_stats.number_of_keeps);
     dbgln("number of frees: {}", g_malloc_stats.number_of_frees);
+    dbgln();
+    dbgln("thread cache hits: {}", g_malloc_stats.number_of_thread_cache_hits);
+    dbgln("thread cache refills: {}", g_malloc_stats.number_of_thread_cache_refills);
+    dbgln("thread cache flushes: {}", g_malloc_stats.number_of_thread_cache_flushes);
+    dbgln("lock contentions: {}", g_malloc_stats.number_of_lock_contentions);
 }
 }
@@ -8,7 +8,8 @@
 #include <AK/NeverDestroyed.h>
 #include <AK/Vector.h>
 #include <bits/pthread_integration.h>
-#include <sched.h>
+#include <errno.h>
+#include <serenity.h>
 #include <unistd.h>
 
 namespace {
@@ -90,36 +91,129 @@ int __pthread_self()
 
 int pthread_self() __attribute__((weak, alias("__pthread_self")));
 
-int __pthread_mutex_lock(pthread_mutex_t* mutex)
+// The lock word of a mutex is 0 when it's unlocked, 1 when it's locked, and 2 when
+// it's locked and somebody may be sleeping on it, so that unlocking only needs to
+// call into the kernel when there's actually someone to wake up.
+static constexpr u32 MUTEX_UNLOCKED = 0;
+static constexpr u32 MUTEX_LOCKED_NO_NEED_TO_WAKE = 1;
+static constexpr u32 MUTEX_LOCKED_NEED_TO_WAKE = 2;
+
+// Mutexes are usually held for a very short time, so it's worth spinning a little
+// while before going to sleep.
+static constexpr int MUTEX_SPIN_COUNT = 100;
+
+// Priority inheritance mutexes hold the TID of their owner instead, and leave all the waiting
+// to the kernel, which needs to know who to lend the waiters' priority to.
+static int pi_mutex_lock(pthread_mutex_t* mutex)
 {
     auto& atomic = reinterpret_cast<Atomic<u32>&>(mutex->lock);
     pthread_t this_thread = __pthread_self();
-    for (;;) {
-        u32 expected = false;
-        if (!atomic.compare_exchange_strong(expected, true, AK::memory_order_acq_rel)) {
-            if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
-                mutex->level++;
-                return 0;
-            }
-            sched_yield();
-            continue;
+
+    u32 value = 0;
+    if (!atomic.compare_exchange_strong(value, this_thread, AK::memory_order_acquire)) {
+        if ((value & FUTEX_TID_MASK) == (u32)this_thread) {
+            if (mutex->type != __PTHREAD_MUTEX_RECURSIVE)
+                return EDEADLK;
+            mutex->level++;
+            return 0;
+        }
+        while (futex(&mutex->lock, FUTEX_LOCK_PI, 0, nullptr, nullptr, 0) < 0) {
+            if (errno != EINTR)
+                return errno;
         }
-        mutex->owner = this_thread;
-        mutex->level = 0;
+    }
+    mutex->owner = this_thread;
+    mutex->level = 0;
+    return 0;
+}
+
+static int pi_mutex_unlock(pthread_mutex_t* mutex)
+{
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
+        mutex->level--;
         return 0;
     }
+    mutex->owner = 0;
+    auto& atomic = reinterpret_cast<Atomic<u32>&>(mutex->lock);
+    u32 value = __pthread_self();
+    if (!atomic.compare_exchange_strong(value, 0, AK::memory_order_release)) {
+        // Someone is waiting, so the kernel has to pick who gets the mutex next.
+        if (futex(&mutex->lock, FUTEX_UNLOCK_PI, 0, nullptr, nullptr, 0) < 0)
+            return errno;
+    }
+    return 0;
+}
+
+int __pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pi_mutex_lock(mutex);
+
+    auto& atomic = reinterpret_cast<Atomic<u32>&>(mutex->lock);
+    pthread_t this_thread = __pthread_self();
+
+    u32 value = MUTEX_UNLOCKED;
+    if (!atomic.compare_exchange_strong(value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire)) {
+        if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
+            mutex->level++;
+            return 0;
+        }
+
+        bool acquired = false;
+        for (int i = 0; i < MUTEX_SPIN_COUNT && !acquired; ++i) {
+            __builtin_ia32_pause();
+            value = MUTEX_UNLOCKED;
+            if (atomic.load(AK::memory_order_relaxed) == MUTEX_UNLOCKED)
+                acquired = atomic.compare_exchange_strong(value, MUTEX_LOCKED_NO_NEED_TO_WAKE, AK::memory_order_acquire);
+        }
+
+        if (!acquired) {
+            // We don't know whether anyone else is waiting, so whoever unlocks next has to wake someone up.
+            while (atomic.exchange(MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire) != MUTEX_UNLOCKED)
+                futex(&mutex->lock, FUTEX_WAIT, MUTEX_LOCKED_NEED_TO_WAKE, nullptr, nullptr, 0);
+        }
+    }
+    mutex->owner = this_thread;
+    mutex->level = 0;
+    return 0;
 }
 
 int pthread_mutex_lock(pthread_mutex_t*) __attribute__((weak, alias("__pthread_mutex_lock")));
 
+// Used by threads that may have been moved from a condition variable onto the mutex's futex
+// by pthread_cond_broadcast(). Others might be sleeping on the mutex without having told
+// anyone, so we always mark it as needing a wake, and whoever unlocks it next wakes the next one.
+int __pthread_mutex_lock_pessimistic_np(pthread_mutex_t* mutex)
+{
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pi_mutex_lock(mutex);
+
+    auto& atomic = reinterpret_cast<Atomic<u32>&>(mutex->lock);
+    pthread_t this_thread = __pthread_self();
+    if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->owner == this_thread) {
+        mutex->level++;
+        return 0;
+    }
+    while (atomic.exchange(MUTEX_LOCKED_NEED_TO_WAKE, AK::memory_order_acquire) != MUTEX_UNLOCKED)
+        futex(&mutex->lock, FUTEX_WAIT, MUTEX_LOCKED_NEED_TO_WAKE, nullptr, nullptr, 0);
+    mutex->owner = this_thread;
+    mutex->level = 0;
+    return 0;
+}
+
 int __pthread_mutex_unlock(pthread_mutex_t* mutex)
 {
+    if (mutex->protocol == __PTHREAD_PRIO_INHERIT)
+        return pi_mutex_unlock(mutex);
+
     if (mutex->type == __PTHREAD_MUTEX_RECURSIVE && mutex->level > 0) {
         mutex->level--;
         return 0;
     }
     mutex->owner = 0;
-    mutex->lock = 0;
+    auto& atomic = reinterpret_cast<Atomic<u32>&>(mutex->lock);
+    if (atomic.exchange(MUTEX_UNLOCKED, AK::memory_order_release) == MUTEX_LOCKED_NEED_TO_WAKE)
+        futex(&mutex->lock, FUTEX_WAKE, 1, nullptr, nullptr, 0);
     return 0;
 }
 
@@ -131,6 +225,7 @@ int __pthread_mutex_init(pthread_mutex_t* mutex, const pthread_mutexattr_t* attr
     mutex->owner = 0;
     mutex->level = 0;
     mutex->type = attributes ? attributes->type : __PTHREAD_MUTEX_NORMAL;
+    mutex->protocol = attributes ? attributes->protocol : __PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -32,7 +32,12 @@ int module_unload(const char* name, size_t name_length)
 
 int profiling_enable(pid_t pid)
 {
-    int rc = syscall(SC_profiling_enable, pid);
+    return profiling_enable_counter(pid, PERF_COUNTER_TIMER, 0);
+}
+
+int profiling_enable_counter(pid_t pid, int counter, uint32_t sample_period)
+{
+    int rc = syscall(SC_profiling_enable, pid, counter, sample_period);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
@@ -95,6 +100,18 @@ int perf_event(int type, uintptr_t arg1, FlatPtr arg2)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int ktrace_enable(pid_t pid, unsigned categories)
+{
+    int rc = syscall(SC_ktrace_enable, pid, categories);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int ktrace_disable()
+{
+    int rc = syscall(SC_ktrace_disable);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size)
 {
     int rc = syscall(SC_get_stack_bounds, user_stack_base, user_stack_size);
@@ -107,6 +124,18 @@ int anon_create(size_t size, int options)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+int watch_memory_pressure()
+{
+    int rc = syscall(SC_watch_memory_pressure);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(IORing* ring)
+{
+    int rc = syscall(SC_io_ring_enter, ring);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
 int serenity_readlink(const char* path, size_t path_length, char* buffer, size_t buffer_size)
 {
     Syscall::SC_readlink_params small_params {
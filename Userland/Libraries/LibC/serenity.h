@@ -18,6 +18,7 @@ int module_load(const char* path, size_t path_length);
 int module_unload(const char* name, size_t name_length);
 
 int profiling_enable(pid_t);
+int profiling_enable_counter(pid_t, int counter, uint32_t sample_period);
 int profiling_disable(pid_t);
 int profiling_free_buffer(pid_t);
 
@@ -59,6 +60,9 @@ int profiling_free_buffer(pid_t);
 #define FUTEX_REQUEUE 3
 #define FUTEX_CMP_REQUEUE 4
 #define FUTEX_WAKE_OP 5
+#define FUTEX_LOCK_PI 6
+#define FUTEX_UNLOCK_PI 7
+#define FUTEX_TRYLOCK_PI 8
 #define FUTEX_WAIT_BITSET 9
 #define FUTEX_WAKE_BITSET 10
 
@@ -68,6 +72,11 @@ int profiling_free_buffer(pid_t);
 
 #define FUTEX_BITSET_MATCH_ANY 0xffffffff
 
+// The value of a priority inheritance futex is the TID of the thread owning it, or 0.
+#define FUTEX_WAITERS 0x80000000
+#define FUTEX_OWNER_DIED 0x40000000
+#define FUTEX_TID_MASK 0x3fffffff
+
 int futex(uint32_t* userspace_address, int futex_op, uint32_t value, const struct timespec* timeout, uint32_t* userspace_address2, uint32_t value3);
 
 #define PURGE_ALL_VOLATILE 0x1
@@ -78,13 +87,45 @@ int purge(int mode);
 #define PERF_EVENT_SAMPLE 0
 #define PERF_EVENT_MALLOC 1
 #define PERF_EVENT_FREE 2
+// These are only ever recorded by the kernel's tracepoints, see ktrace_enable().
+#define PERF_EVENT_SYSCALL_ENTER 3
+#define PERF_EVENT_SYSCALL_EXIT 4
+#define PERF_EVENT_CONTEXT_SWITCH 5
+#define PERF_EVENT_PAGE_FAULT 6
+#define PERF_EVENT_BLOCK_IO 7
+
+#define PERF_COUNTER_TIMER 0
+#define PERF_COUNTER_CYCLES 1
+#define PERF_COUNTER_INSTRUCTIONS 2
+#define PERF_COUNTER_CACHE_MISSES 3
+#define PERF_COUNTER_BRANCH_MISSES 4
+
+#define KTRACE_SYSCALLS 0x1
+#define KTRACE_CONTEXT_SWITCHES 0x2
+#define KTRACE_PAGE_FAULTS 0x4
+#define KTRACE_BLOCK_IO 0x8
+#define KTRACE_ALL 0xf
 
 int perf_event(int type, uintptr_t arg1, uintptr_t arg2);
 
+int ktrace_enable(pid_t, unsigned categories);
+int ktrace_disable(void);
+
 int get_stack_bounds(uintptr_t* user_stack_base, size_t* user_stack_size);
 
 int anon_create(size_t size, int options);
 
+#define MEMORY_PRESSURE_NORMAL 0
+#define MEMORY_PRESSURE_LOW 1
+#define MEMORY_PRESSURE_CRITICAL 2
+
+// Returns a file descriptor that becomes readable when the memory pressure level changes.
+// Reading from it yields the current MEMORY_PRESSURE_* level as a uint32_t.
+int watch_memory_pressure(void);
+
+struct IORing;
+int io_ring_enter(struct IORing*);
+
 int serenity_readlink(const char* path, size_t path_length, char* buffer, size_t buffer_size);
 
 int getkeymap(char* name_buffer, size_t name_buffer_size, uint32_t* map, uint32_t* shift_map, uint32_t* alt_map, uint32_t* altgr_map, uint32_t* shift_altgr_map);
@@ -49,6 +49,7 @@ public:
     size_t write(const u8*, size_t);
 
     bool gets(u8*, size_t);
+    ssize_t getdelim(char** lineptr, size_t* line_size, u8 delimiter);
     bool ungetc(u8 byte) { return m_buffer.enqueue_front(byte); }
 
     int seek(off_t offset, int whence);
@@ -84,6 +85,13 @@ private:
 
         bool enqueue_front(u8 byte);
 
+        // Doubles the size of an empty buffer that we allocated ourselves, up to max_capacity.
+        void grow();
+
+        // Streams that are read or written in bulk keep growing their buffer up to this size,
+        // so that large sequential transfers don't take one syscall per BUFSIZ bytes.
+        static constexpr size_t max_capacity = 64 * KiB;
+
     private:
         // Note: the fields here are arranged this way
         // to make sizeof(Buffer) smaller.
@@ -114,6 +122,9 @@ private:
     int m_mode { 0 };
     int m_error { 0 };
     bool m_eof { false };
+    // Set when the last read from the fd filled all the space in the buffer, meaning that there
+    // was likely more data to be had than we had room for.
+    bool m_last_read_filled_buffer { false };
     pid_t m_popen_child { -1 };
     Buffer m_buffer;
 };
@@ -197,6 +208,11 @@ ssize_t FILE::do_write(const u8* data, size_t size)
 
 bool FILE::read_into_buffer()
 {
+    // The caller has used up everything we read last time, and that filled the whole buffer.
+    // Looks like it's reading through a big file, so read more at once from now on.
+    if (m_last_read_filled_buffer && !m_buffer.is_not_empty())
+        m_buffer.grow();
+
     m_buffer.realize(m_fd);
 
     size_t available_size;
@@ -205,6 +221,7 @@ bool FILE::read_into_buffer()
     VERIFY(available_size);
 
     ssize_t nread = do_read(data, available_size);
+    m_last_read_filled_buffer = nread > 0 && static_cast<size_t>(nread) == available_size;
 
     if (nread <= 0)
         return false;
@@ -284,6 +301,10 @@ size_t FILE::write(const u8* data, size_t size)
                 // There's no space in the buffer; we're going to free some.
                 bool freed_some_space = write_from_buffer();
                 if (freed_some_space) {
+                    // We just wrote out a full buffer, so the caller is writing a lot.
+                    // Buffer more of it before the next write.
+                    if (m_buffer.mode() == _IOFBF && !m_buffer.is_not_empty())
+                        m_buffer.grow();
                     // Great, now try this again.
                     continue;
                 }
@@ -372,6 +393,58 @@ bool FILE::gets(u8* data, size_t size)
     return total_read > 0;
 }
 
+ssize_t FILE::getdelim(char** lineptr, size_t* line_size, u8 delimiter)
+{
+    // Note: The caller makes sure that *lineptr has room for at least the null terminator.
+    size_t total_read = 0;
+    auto append = [&](const u8* data, size_t size) {
+        if (total_read + size + 1 > *line_size) {
+            auto new_size = max(*line_size * 2, total_read + size + 1);
+            auto* new_line = static_cast<char*>(realloc(*lineptr, new_size));
+            if (!new_line)
+                return false;
+            *lineptr = new_line;
+            *line_size = new_size;
+        }
+        memcpy(*lineptr + total_read, data, size);
+        total_read += size;
+        return true;
+    };
+
+    for (;;) {
+        if (m_buffer.may_use()) {
+            // Look for the delimiter right in the buffer, and copy out everything up to it at once.
+            size_t queued_size;
+            const u8* queued_data = m_buffer.begin_dequeue(queued_size);
+            if (queued_size == 0) {
+                // Nothing buffered; we're going to have to read some.
+                if (read_into_buffer())
+                    continue;
+                break;
+            }
+            auto* delimiter_in_buffer = reinterpret_cast<const u8*>(memchr(queued_data, delimiter, queued_size));
+            size_t actual_size = delimiter_in_buffer ? delimiter_in_buffer - queued_data + 1 : queued_size;
+            if (!append(queued_data, actual_size))
+                return -1;
+            m_buffer.did_dequeue(actual_size);
+            if (delimiter_in_buffer)
+                break;
+        } else {
+            // Sadly, we have to actually read these characters one by one.
+            u8 byte;
+            if (do_read(&byte, 1) <= 0)
+                break;
+            if (!append(&byte, 1))
+                return -1;
+            if (byte == delimiter)
+                break;
+        }
+    }
+
+    (*lineptr)[total_read] = '\0';
+    return total_read > 0 ? total_read : -1;
+}
+
 int FILE::seek(off_t offset, int whence)
 {
     bool ok = flush();
@@ -441,6 +514,18 @@ void FILE::Buffer::setbuf(u8* data, int mode, size_t size)
     }
 }
 
+void FILE::Buffer::grow()
+{
+    // A buffer handed to us with setvbuf() stays the way it is, and since this one is empty,
+    // there is nothing to move over to the new allocation.
+    if (!m_data_is_malloced || !m_empty || m_capacity >= max_capacity)
+        return;
+    free(m_data);
+    m_capacity = min(m_capacity * 2, max_capacity);
+    m_data = reinterpret_cast<u8*>(malloc(m_capacity));
+    m_begin = m_end = 0;
+}
+
 void FILE::Buffer::drop()
 {
     if (m_data_is_malloced) {
@@ -656,36 +741,8 @@ ssize_t getdelim(char** lineptr, size_t* n, int delim, FILE* stream)
         }
     }
 
-    char* ptr;
-    char* eptr;
-    for (ptr = *lineptr, eptr = *lineptr + *n;;) {
-        int c = fgetc(stream);
-        if (c == -1) {
-            if (feof(stream)) {
-                *ptr = '\0';
-                return ptr == *lineptr ? -1 : ptr - *lineptr;
-            } else {
-                return -1;
-            }
-        }
-        *ptr++ = c;
-        if (c == delim) {
-            *ptr = '\0';
-            return ptr - *lineptr;
-        }
-        if (ptr + 2 >= eptr) {
-            char* nbuf;
-            size_t nbuf_sz = *n * 2;
-            ssize_t d = ptr - *lineptr;
-            if ((nbuf = static_cast<char*>(realloc(*lineptr, nbuf_sz))) == nullptr) {
-                return -1;
-            }
-            *lineptr = nbuf;
-            *n = nbuf_sz;
-            eptr = nbuf + nbuf_sz;
-            ptr = nbuf + d;
-        }
-    }
+    VERIFY(stream);
+    return stream->getdelim(lineptr, n, delim);
 }
 
 ssize_t getline(char** lineptr, size_t* n, FILE* stream)
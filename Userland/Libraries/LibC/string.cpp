@@ -10,6 +10,7 @@
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <assert.h>
+#include <bits/string_variants.h>
 #include <ctype.h>
 #include <errno.h>
 #include <signal.h>
@@ -17,6 +18,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if ARCH(I386)
+#    include <emmintrin.h>
+#endif
+
 extern "C" {
 
 size_t strspn(const char* s, const char* accept)
@@ -45,14 +50,6 @@ size_t strcspn(const char* s, const char* reject)
     }
 }
 
-size_t strlen(const char* str)
-{
-    size_t len = 0;
-    while (*(str++))
-        ++len;
-    return len;
-}
-
 size_t strnlen(const char* str, size_t maxlen)
 {
     size_t len = 0;
@@ -112,7 +109,44 @@ int memcmp(const void* v1, const void* v2, size_t n)
 }
 
 #if ARCH(I386)
-void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
+// The generic routines below are picked at runtime when the processor has something better.
+// Only SSE2 is used: the kernel doesn't preserve the upper halves of the AVX registers across
+// context switches.
+
+enum StringFeature : u32 {
+    Detected = 1 << 0,
+    SSE2 = 1 << 1,
+    ERMS = 1 << 2,
+};
+
+static u32 s_string_features;
+
+static u32 string_features()
+{
+    // Racing threads will all come up with the same answer, so there's no need for a lock.
+    if (s_string_features & StringFeature::Detected)
+        return s_string_features;
+    u32 features = StringFeature::Detected;
+    auto cpuid = [](u32 leaf, u32& eax, u32& ebx, u32& ecx, u32& edx) {
+        asm volatile("cpuid"
+                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                     : "a"(leaf), "c"(0));
+    };
+    u32 max_leaf, eax, ebx, ecx, edx;
+    cpuid(0, max_leaf, ebx, ecx, edx);
+    cpuid(1, eax, ebx, ecx, edx);
+    if (edx & (1 << 26))
+        features |= StringFeature::SSE2;
+    if (max_leaf >= 7) {
+        cpuid(7, eax, ebx, ecx, edx);
+        if (ebx & (1 << 9))
+            features |= StringFeature::ERMS;
+    }
+    s_string_features = features;
+    return features;
+}
+
+void* __memcpy_rep_movsb(void* dest_ptr, const void* src_ptr, size_t n)
 {
     void* original_dest = dest_ptr;
     asm volatile(
@@ -121,7 +155,45 @@ void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
     return original_dest;
 }
 
-void* memset(void* dest_ptr, int c, size_t n)
+[[gnu::target("sse2")]] void* __memcpy_sse2(void* dest_ptr, const void* src_ptr, size_t n)
+{
+    auto* dest = (u8*)dest_ptr;
+    auto* src = (const u8*)src_ptr;
+    if (n >= 16) {
+        // Copy the (possibly unaligned) head, then continue with aligned stores.
+        _mm_storeu_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)src));
+        size_t head = 16 - ((FlatPtr)dest & 15);
+        dest += head;
+        src += head;
+        n -= head;
+        for (; n >= 64; n -= 64, dest += 64, src += 64) {
+            auto a = _mm_loadu_si128((const __m128i*)src);
+            auto b = _mm_loadu_si128((const __m128i*)(src + 16));
+            auto c = _mm_loadu_si128((const __m128i*)(src + 32));
+            auto d = _mm_loadu_si128((const __m128i*)(src + 48));
+            _mm_store_si128((__m128i*)dest, a);
+            _mm_store_si128((__m128i*)(dest + 16), b);
+            _mm_store_si128((__m128i*)(dest + 32), c);
+            _mm_store_si128((__m128i*)(dest + 48), d);
+        }
+        for (; n >= 16; n -= 16, dest += 16, src += 16)
+            _mm_store_si128((__m128i*)dest, _mm_loadu_si128((const __m128i*)src));
+    }
+    for (; n; --n)
+        *dest++ = *src++;
+    return dest_ptr;
+}
+
+void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
+{
+    // rep movsb is hard to beat when the processor has ERMS, but takes a while to get going.
+    auto features = string_features();
+    if (n >= 64 && (features & StringFeature::SSE2) && !(features & StringFeature::ERMS))
+        return __memcpy_sse2(dest_ptr, src_ptr, n);
+    return __memcpy_rep_movsb(dest_ptr, src_ptr, n);
+}
+
+void* __memset_rep_stos(void* dest_ptr, int c, size_t n)
 {
     size_t dest = (size_t)dest_ptr;
     // FIXME: Support starting at an unaligned address.
@@ -144,7 +216,116 @@ void* memset(void* dest_ptr, int c, size_t n)
         : "memory");
     return dest_ptr;
 }
+
+[[gnu::target("sse2")]] void* __memset_sse2(void* dest_ptr, int c, size_t n)
+{
+    auto* dest = (u8*)dest_ptr;
+    if (n >= 16) {
+        auto value = _mm_set1_epi8((char)c);
+        _mm_storeu_si128((__m128i*)dest, value);
+        size_t head = 16 - ((FlatPtr)dest & 15);
+        dest += head;
+        n -= head;
+        for (; n >= 64; n -= 64, dest += 64) {
+            _mm_store_si128((__m128i*)dest, value);
+            _mm_store_si128((__m128i*)(dest + 16), value);
+            _mm_store_si128((__m128i*)(dest + 32), value);
+            _mm_store_si128((__m128i*)(dest + 48), value);
+        }
+        for (; n >= 16; n -= 16, dest += 16)
+            _mm_store_si128((__m128i*)dest, value);
+    }
+    for (; n; --n)
+        *dest++ = (u8)c;
+    return dest_ptr;
+}
+
+void* memset(void* dest_ptr, int c, size_t n)
+{
+    auto features = string_features();
+    if (n >= 64 && (features & StringFeature::SSE2) && !(features & StringFeature::ERMS))
+        return __memset_sse2(dest_ptr, c, n);
+    return __memset_rep_stos(dest_ptr, c, n);
+}
+
+// Keep GCC from turning these loops right back into calls to strlen() and memchr().
+[[gnu::optimize("no-tree-loop-distribute-patterns")]] size_t __strlen_generic(const char* str)
+{
+    size_t len = 0;
+    while (*(str++))
+        ++len;
+    return len;
+}
+
+[[gnu::target("sse2")]] size_t __strlen_sse2(const char* str)
+{
+    // Aligned loads never cross into the next page, so reading past the terminator is harmless.
+    auto zero = _mm_setzero_si128();
+    auto* chunk = (const char*)((FlatPtr)str & ~15);
+    u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)chunk), zero));
+    mask &= 0xffff << ((FlatPtr)str & 15);
+    while (!mask) {
+        chunk += 16;
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)chunk), zero));
+    }
+    return chunk + __builtin_ctz(mask) - str;
+}
+
+size_t strlen(const char* str)
+{
+    if (string_features() & StringFeature::SSE2)
+        return __strlen_sse2(str);
+    return __strlen_generic(str);
+}
+
+[[gnu::optimize("no-tree-loop-distribute-patterns")]] void* __memchr_generic(const void* ptr, int c, size_t size)
+{
+    char ch = c;
+    auto* cptr = (const char*)ptr;
+    for (size_t i = 0; i < size; ++i) {
+        if (cptr[i] == ch)
+            return const_cast<char*>(cptr + i);
+    }
+    return nullptr;
+}
+
+[[gnu::target("sse2")]] void* __memchr_sse2(const void* ptr, int c, size_t size)
+{
+    if (size == 0)
+        return nullptr;
+    auto* start = (const char*)ptr;
+    auto* end = start + size;
+    auto needle = _mm_set1_epi8((char)c);
+    auto* chunk = (const char*)((FlatPtr)start & ~15);
+    u32 mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)chunk), needle));
+    mask &= 0xffff << (start - chunk);
+    for (;;) {
+        if (mask) {
+            auto* found = chunk + __builtin_ctz(mask);
+            return found < end ? const_cast<char*>(found) : nullptr;
+        }
+        chunk += 16;
+        if (chunk >= end)
+            return nullptr;
+        mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)chunk), needle));
+    }
+}
+
+void* memchr(const void* ptr, int c, size_t size)
+{
+    if (size >= 16 && (string_features() & StringFeature::SSE2))
+        return __memchr_sse2(ptr, c, size);
+    return __memchr_generic(ptr, c, size);
+}
 #else
+size_t strlen(const char* str)
+{
+    size_t len = 0;
+    while (*(str++))
+        ++len;
+    return len;
+}
+
 void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
 {
     auto* dest = (u8*)dest_ptr;
@@ -161,6 +342,17 @@ void* memset(void* dest_ptr, int c, size_t n)
         dest[i] = (u8)c;
     return dest_ptr;
 }
+
+void* memchr(const void* ptr, int c, size_t size)
+{
+    char ch = c;
+    auto* cptr = (const char*)ptr;
+    for (size_t i = 0; i < size; ++i) {
+        if (cptr[i] == ch)
+            return const_cast<char*>(cptr + i);
+    }
+    return nullptr;
+}
 #endif
 
 void* memmove(void* dest, const void* src, size_t n)
@@ -231,17 +423,6 @@ char* strchrnul(const char* str, int c)
     }
 }
 
-void* memchr(const void* ptr, int c, size_t size)
-{
-    char ch = c;
-    auto* cptr = (const char*)ptr;
-    for (size_t i = 0; i < size; ++i) {
-        if (cptr[i] == ch)
-            return const_cast<char*>(cptr + i);
-    }
-    return nullptr;
-}
-
 char* strrchr(const char* str, int ch)
 {
     char* last = nullptr;
@@ -349,6 +530,7 @@ const char* const sys_errlist[] = {
     "Not supported",
     "Protocol family not supported",
     "Cannot make directory a subdirectory of itself",
+    "Operation cancelled",
     "The highest errno +1 :^)",
 };
 
@@ -65,16 +65,18 @@ typedef struct __pthread_mutex_t {
     pthread_t owner;
     int level;
     int type;
+    int protocol;
 } pthread_mutex_t;
 
 typedef void* pthread_attr_t;
 typedef struct __pthread_mutexattr_t {
     int type;
+    int protocol;
 } pthread_mutexattr_t;
 
 typedef struct __pthread_cond_t {
+    pthread_mutex_t* mutex;
     uint32_t value;
-    uint32_t previous;
     int clockid; // clockid_t
 } pthread_cond_t;
 
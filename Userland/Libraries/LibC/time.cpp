@@ -6,7 +6,9 @@
 
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <AK/Atomic.h>
 #include <AK/Time.h>
+#include <Kernel/API/TimePage.h>
 #include <assert.h>
 #include <errno.h>
 #include <stdio.h>
@@ -36,8 +38,15 @@ int adjtime(const struct timeval* delta, struct timeval* old_delta)
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
 
+static bool read_time_page(clockid_t, struct timespec*);
+
 int gettimeofday(struct timeval* __restrict__ tv, void* __restrict__)
 {
+    struct timespec ts;
+    if (read_time_page(CLOCK_REALTIME, &ts)) {
+        TIMESPEC_TO_TIMEVAL(tv, &ts);
+        return 0;
+    }
     int rc = syscall(SC_gettimeofday, tv);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
@@ -353,8 +362,81 @@ clock_t clock()
     return tms.tms_utime + tms.tms_stime;
 }
 
+static TimePage* time_page()
+{
+    static Atomic<TimePage*> s_time_page;
+    static Atomic<bool> s_time_page_unavailable;
+    if (auto* time_page = s_time_page.load(AK::memory_order_acquire))
+        return time_page;
+    if (s_time_page_unavailable.load(AK::memory_order_relaxed))
+        return nullptr;
+
+    int rc = syscall(SC_map_time_page);
+    if (rc < 0 && rc > -EMAXERRNO) {
+        s_time_page_unavailable.store(true, AK::memory_order_relaxed);
+        return nullptr;
+    }
+    // If another thread got here first, we waste a mapping, but both of them work.
+    auto* time_page = reinterpret_cast<TimePage*>(rc);
+    s_time_page.store(time_page, AK::memory_order_release);
+    return time_page;
+}
+
+// Reads the clock from the kernel's time page, if it's published there.
+static bool read_time_page(clockid_t clock_id, struct timespec* ts)
+{
+    bool is_precise;
+    clockid_t coarse_clock_id;
+    switch (clock_id) {
+    case CLOCK_REALTIME:
+        is_precise = true;
+        coarse_clock_id = CLOCK_REALTIME_COARSE;
+        break;
+    case CLOCK_MONOTONIC:
+    case CLOCK_MONOTONIC_RAW:
+        is_precise = true;
+        coarse_clock_id = CLOCK_MONOTONIC_COARSE;
+        break;
+    case CLOCK_REALTIME_COARSE:
+    case CLOCK_MONOTONIC_COARSE:
+        is_precise = false;
+        coarse_clock_id = clock_id;
+        break;
+    default:
+        return false;
+    }
+
+    auto* page = time_page();
+    if (!page)
+        return false;
+    // These never change once the page is mapped.
+    if (is_precise && page->tsc_multiplier == 0)
+        return false;
+
+    for (;;) {
+        u32 update_iteration = AK::atomic_load(&page->update1, AK::memory_order_acquire);
+        i64 seconds = page->clocks[coarse_clock_id].seconds;
+        u64 nanoseconds = page->clocks[coarse_clock_id].nanoseconds;
+        u64 tsc_at_update = page->tsc_at_update;
+        u64 tsc = is_precise ? __builtin_ia32_rdtsc() : 0;
+        AK::atomic_thread_fence(AK::memory_order_acquire);
+        if (update_iteration != AK::atomic_load(&page->update2, AK::memory_order_acquire))
+            continue;
+
+        // Another processor's TSC may be slightly behind the one that did the update.
+        if (is_precise && tsc > tsc_at_update)
+            nanoseconds += time_page_tsc_delta_to_nanoseconds(tsc - tsc_at_update, page->tsc_multiplier, page->tsc_shift);
+        ts->tv_sec = seconds + nanoseconds / 1'000'000'000;
+        ts->tv_nsec = nanoseconds % 1'000'000'000;
+        return true;
+    }
+}
+
 int clock_gettime(clockid_t clock_id, struct timespec* ts)
 {
+    if (read_time_page(clock_id, ts))
+        return 0;
+
     int rc = syscall(SC_clock_gettime, clock_id, ts);
     __RETURN_WITH_ERRNO(rc, rc, -1);
 }
@@ -8,7 +8,6 @@
 #include <AK/Array.h>
 #include <AK/Assertions.h>
 #include <AK/BinaryHeap.h>
-#include <AK/BinarySearch.h>
 #include <AK/MemoryStream.h>
 #include <string.h>
 
@@ -18,29 +17,15 @@ namespace Compress {
 
 const CanonicalCode& CanonicalCode::fixed_literal_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = CanonicalCode::from_bytes(fixed_literal_bit_lengths).value();
-    initialized = true;
-
+    // Compressors and decompressors on different threads may get here at the same time.
+    static const CanonicalCode code = CanonicalCode::from_bytes(fixed_literal_bit_lengths).value();
     return code;
 }
 
 const CanonicalCode& CanonicalCode::fixed_distance_codes()
 {
-    static CanonicalCode code;
-    static bool initialized = false;
-
-    if (initialized)
-        return code;
-
-    code = CanonicalCode::from_bytes(fixed_distance_bit_lengths).value();
-    initialized = true;
-
+    // Compressors and decompressors on different threads may get here at the same time.
+    static const CanonicalCode code = CanonicalCode::from_bytes(fixed_distance_bit_lengths).value();
     return code;
 }
 
@@ -59,8 +44,8 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
         }
     }
     if (non_zero_symbols == 1) { // special case - only 1 symbol
-        code.m_symbol_codes.append(0b10);
         code.m_symbol_values.append(last_non_zero);
+        code.m_code_length_counts[1] = 1;
         code.m_bit_codes[last_non_zero] = 0;
         code.m_bit_code_lengths[last_non_zero] = 1;
         return code;
@@ -78,8 +63,10 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
             if (next_code > start_bit)
                 return {};
 
-            code.m_symbol_codes.append(start_bit | next_code);
+            if (code.m_symbol_values.is_empty())
+                code.m_min_code_length = code_length;
             code.m_symbol_values.append(symbol);
+            code.m_code_length_counts[code_length]++;
             code.m_bit_codes[symbol] = fast_reverse16(start_bit | next_code, code_length); // DEFLATE writes huffman encoded symbols as lsb-first
             code.m_bit_code_lengths[symbol] = code_length;
 
@@ -96,18 +83,22 @@ Optional<CanonicalCode> CanonicalCode::from_bytes(ReadonlyBytes bytes)
 
 u32 CanonicalCode::read_symbol(InputBitStream& stream) const
 {
-    u32 code_bits = 1;
+    // No code is shorter than the shortest one, so those bits can be read all at once. These are written msb-first.
+    u32 code = fast_reverse16(stream.read_bits(m_min_code_length), m_min_code_length);
+    u32 first_code = 0;
+    size_t index = 0;
+
+    for (size_t code_length = m_min_code_length;;) {
+        auto count = m_code_length_counts[code_length];
+        if (code - first_code < count)
+            return m_symbol_values[index + code - first_code];
 
-    for (;;) {
-        code_bits = code_bits << 1 | stream.read_bits(1);
-        if (code_bits >= (1 << 16))
+        if (++code_length > 15)
             return UINT32_MAX; // the maximum symbol in deflate is 288, so we use UINT32_MAX (an impossible value) to indicate an error
 
-        // FIXME: This is very inefficient and could greatly be improved by implementing this
-        //        algorithm: https://www.hanshq.net/zip.html#huffdec
-        size_t index;
-        if (binary_search(m_symbol_codes.span(), code_bits, &index))
-            return m_symbol_values[index];
+        index += count;
+        first_code = (first_code + count) << 1;
+        code = code << 1 | stream.read_bits(1);
     }
 }
 
@@ -128,45 +119,50 @@ bool DeflateDecompressor::CompressedBlock::try_read_more()
     if (m_eof == true)
         return false;
 
-    const auto symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
+    // Handing out every symbol as soon as it is decoded costs more than decoding it, so keep going for as long as
+    // another back reference would fit.
+    bool read_any = false;
+    while (m_decompressor.m_output_stream.remaining_space() >= DeflateCompressor::max_match_length) {
+        if (m_decompressor.m_input_stream.has_any_error())
+            return read_any;
 
-    if (symbol >= 286) { // invalid deflate literal/length symbol
-        m_decompressor.set_fatal_error();
-        return false;
-    }
+        const auto symbol = m_literal_codes.read_symbol(m_decompressor.m_input_stream);
 
-    if (symbol < 256) {
-        m_decompressor.m_output_stream << static_cast<u8>(symbol);
-        return true;
-    } else if (symbol == 256) {
-        m_eof = true;
-        return false;
-    } else {
-        if (!m_distance_codes.has_value()) {
+        if (symbol >= 286) { // invalid deflate literal/length symbol
             m_decompressor.set_fatal_error();
             return false;
         }
 
-        const auto length = m_decompressor.decode_length(symbol);
-        const auto distance_symbol = m_distance_codes.value().read_symbol(m_decompressor.m_input_stream);
-        if (distance_symbol >= 30) { // invalid deflate distance symbol
-            m_decompressor.set_fatal_error();
-            return false;
-        }
-        const auto distance = m_decompressor.decode_distance(distance_symbol);
+        if (symbol < 256) {
+            m_decompressor.m_output_stream << static_cast<u8>(symbol);
+        } else if (symbol == 256) {
+            m_eof = true;
+            return read_any;
+        } else {
+            if (!m_distance_codes.has_value()) {
+                m_decompressor.set_fatal_error();
+                return false;
+            }
 
-        for (size_t idx = 0; idx < length; ++idx) {
-            u8 byte = 0;
-            m_decompressor.m_output_stream.read({ &byte, sizeof(byte) }, distance);
-            if (m_decompressor.m_output_stream.handle_any_error()) {
+            const auto length = m_decompressor.decode_length(symbol);
+            const auto distance_symbol = m_distance_codes.value().read_symbol(m_decompressor.m_input_stream);
+            if (distance_symbol >= 30) { // invalid deflate distance symbol
+                m_decompressor.set_fatal_error();
+                return false;
+            }
+            const auto distance = m_decompressor.decode_distance(distance_symbol);
+
+            if (!m_decompressor.m_output_stream.copy_from_seekback(distance, length)) {
+                m_decompressor.m_output_stream.handle_any_error();
                 m_decompressor.set_fatal_error();
                 return false; // a back reference was requested that was too far back (outside our current sliding window)
             }
-            m_decompressor.m_output_stream << byte;
         }
 
-        return true;
+        read_any = true;
     }
+
+    return true;
 }
 
 DeflateDecompressor::UncompressedBlock::UncompressedBlock(DeflateDecompressor& decompressor, size_t length)
@@ -517,6 +513,14 @@ DeflateCompressor::~DeflateCompressor()
     VERIFY(m_finished);
 }
 
+void DeflateCompressor::set_dictionary(ReadonlyBytes dictionary)
+{
+    VERIFY(m_pending_block_size == 0 && m_dictionary_size == 0);
+
+    m_dictionary_size = min(dictionary.size(), block_size);
+    dictionary.slice(dictionary.size() - m_dictionary_size).copy_to({ m_rolling_window + block_size - m_dictionary_size, m_dictionary_size });
+}
+
 size_t DeflateCompressor::write(ReadonlyBytes bytes)
 {
     VERIFY(!m_finished);
@@ -590,7 +594,7 @@ size_t DeflateCompressor::find_back_match(size_t start, u16 hash, size_t previou
             break; // no remaining candidates
 
         VERIFY(candidate < start);
-        if (start - candidate > window_size)
+        if (start - candidate > max_distance)
             break; // outside the window
 
         auto match_length = compare_match_candidate(start, candidate, previous_match_length, maximum_match_length);
@@ -717,6 +721,11 @@ void DeflateCompressor::lz77_compress_block()
         m_distance_frequencies[distance_to_base(distance)]++;
     };
 
+    // Make the data that comes right before this block available for back references. The last few sequences
+    // overlap the start of this block, which is fine, since the data is contiguous.
+    for (size_t position = block_size - m_dictionary_size; position < block_size; position++)
+        insert_hash(position, hash_sequence(&m_rolling_window[position]));
+
     size_t previous_match_length = 0;
     size_t previous_match_position = 0;
 
@@ -1043,6 +1052,29 @@ void DeflateCompressor::flush()
     m_distance_frequencies.fill(0);
     // On the final block this copy will potentially produce an invalid search window, but since its the final block we dont care
     pending_block().copy_trimmed_to({ m_rolling_window, block_size });
+    m_dictionary_size = block_size;
+}
+
+void DeflateCompressor::sync_flush()
+{
+    VERIFY(!m_finished);
+
+    // The pending block is always a partial one here, since write() flushes full ones right away.
+    if (m_pending_block_size > 0) {
+        auto pending_size = m_pending_block_size;
+        flush();
+        // flush() left the partial block at the start of the window, but it has to come right before the next one.
+        __builtin_memmove(m_rolling_window + block_size - pending_size, m_rolling_window, pending_size);
+        m_dictionary_size = pending_size;
+    }
+
+    m_output_stream.write_bit(false);    // not the final block
+    m_output_stream.write_bits(0b00, 2); // no compression
+    m_output_stream.align_to_byte_boundary();
+    LittleEndian<u16> len = 0;
+    m_output_stream << len;
+    LittleEndian<u16> nlen = 0xffff;
+    m_output_stream << nlen;
 }
 
 void DeflateCompressor::final_flush()
@@ -1052,6 +1084,27 @@ void DeflateCompressor::final_flush()
     flush();
 }
 
+Optional<ByteBuffer> DeflateCompressor::compress_part(ReadonlyBytes dictionary, ReadonlyBytes bytes, bool is_last_part, CompressionLevel compression_level)
+{
+    DuplexMemoryStream output_stream;
+    DeflateCompressor deflate_stream { output_stream, compression_level };
+
+    deflate_stream.set_dictionary(dictionary);
+    deflate_stream.write_or_error(bytes);
+
+    if (is_last_part) {
+        deflate_stream.final_flush();
+    } else {
+        deflate_stream.sync_flush();
+        deflate_stream.m_finished = true;
+    }
+
+    if (deflate_stream.handle_any_error())
+        return {};
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 Optional<ByteBuffer> DeflateCompressor::compress_all(const ReadonlyBytes& bytes, CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
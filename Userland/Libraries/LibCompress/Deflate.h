@@ -28,9 +28,12 @@ public:
     static Optional<CanonicalCode> from_bytes(ReadonlyBytes);
 
 private:
-    // Decompression - indexed by code
-    Vector<u16> m_symbol_codes;
+    // Decompression - the symbols ordered by the length of their codes, and how many codes there are of each length.
+    // Canonical codes of the same length are consecutive, so a code can be told apart from longer ones by comparing it
+    // to the first code of its length.
     Vector<u16> m_symbol_values;
+    Array<u16, 16> m_code_length_counts {};
+    u8 m_min_code_length { 1 };
 
     // Compression - indexed by symbol
     Array<u16, 288> m_bit_codes {}; // deflate uses a maximum of 288 symbols (maximum of 32 for distances)
@@ -118,6 +121,7 @@ public:
     static constexpr size_t max_huffman_distances = 32;
     static constexpr size_t min_match_length = 4;   // matches smaller than these are not worth the size of the back reference
     static constexpr size_t max_match_length = 258; // matches longer than these cannot be encoded using huffman codes
+    static constexpr size_t max_distance = 32 * KiB; // back references cannot reach further back than this
     static constexpr u16 empty_slot = UINT16_MAX;
 
     struct CompressionConstants {
@@ -147,12 +151,24 @@ public:
     DeflateCompressor(OutputStream&, CompressionLevel = CompressionLevel::GOOD);
     ~DeflateCompressor();
 
+    // Lets back references reach into |dictionary|, the data that came right before this stream. Only the last
+    // block_size bytes of it are used. Has to be called before anything is written.
+    void set_dictionary(ReadonlyBytes dictionary);
+
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
+    // Writes out everything that's pending, followed by an empty uncompressed block, so that the output ends on a byte
+    // boundary without ending the deflate stream. The stream can be written to afterwards.
+    void sync_flush();
     void final_flush();
 
     static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, CompressionLevel = CompressionLevel::GOOD);
 
+    // Compresses one part of a larger stream, independently of the others: |dictionary| is the data that comes
+    // right before the part. Unless this is the last part, the result ends with a sync_flush(), so the compressed
+    // parts can simply be concatenated.
+    static Optional<ByteBuffer> compress_part(ReadonlyBytes dictionary, ReadonlyBytes bytes, bool is_last_part, CompressionLevel = CompressionLevel::GOOD);
+
 private:
     Bytes pending_block() { return { m_rolling_window + block_size, block_size }; }
 
@@ -188,6 +204,8 @@ private:
 
     u8 m_rolling_window[window_size];
     size_t m_pending_block_size { 0 };
+    // How much of the data right before the pending block may be referred back to.
+    size_t m_dictionary_size { 0 };
 
     struct [[gnu::packed]] {
         u16 distance; // back reference length
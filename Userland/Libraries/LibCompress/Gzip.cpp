@@ -193,16 +193,14 @@ bool GzipDecompressor::handle_any_error()
     return Stream::handle_any_error() || handled_errors;
 }
 
-GzipCompressor::GzipCompressor(OutputStream& stream)
+GzipCompressor::GzipCompressor(OutputStream& stream, DeflateCompressor::CompressionLevel compression_level)
     : m_output_stream(stream)
+    , m_compressed_stream(stream, compression_level)
 {
+    write_header(m_output_stream, compression_level);
 }
 
-GzipCompressor::~GzipCompressor()
-{
-}
-
-size_t GzipCompressor::write(ReadonlyBytes bytes)
+void GzipCompressor::write_header(OutputStream& stream, DeflateCompressor::CompressionLevel compression_level)
 {
     BlockHeader header;
     header.identification_1 = 0x1f;
@@ -210,18 +208,30 @@ size_t GzipCompressor::write(ReadonlyBytes bytes)
     header.compression_method = 0x08;
     header.flags = 0;
     header.modification_time = 0;
-    header.extra_flags = 3;      // DEFLATE sets 2 for maximum compression and 4 for minimum compression
+    // DEFLATE sets 2 for maximum compression and 4 for minimum compression
+    if (compression_level >= DeflateCompressor::CompressionLevel::GREAT)
+        header.extra_flags = 2;
+    else if (compression_level <= DeflateCompressor::CompressionLevel::FAST)
+        header.extra_flags = 4;
+    else
+        header.extra_flags = 3;
     header.operating_system = 3; // unix
-    m_output_stream << Bytes { &header, sizeof(header) };
-    DeflateCompressor compressed_stream { m_output_stream };
-    VERIFY(compressed_stream.write_or_error(bytes));
-    compressed_stream.final_flush();
-    Crypto::Checksum::CRC32 crc32;
-    crc32.update(bytes);
-    LittleEndian<u32> digest = crc32.digest();
-    LittleEndian<u32> size = bytes.size();
-    m_output_stream << digest << size;
-    return bytes.size();
+    stream << Bytes { &header, sizeof(header) };
+}
+
+GzipCompressor::~GzipCompressor()
+{
+    VERIFY(m_finished);
+}
+
+size_t GzipCompressor::write(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+
+    auto nwritten = m_compressed_stream.write(bytes);
+    m_checksum.update(bytes.trim(nwritten));
+    m_total_input_size += nwritten;
+    return nwritten;
 }
 
 bool GzipCompressor::write_or_error(ReadonlyBytes bytes)
@@ -234,17 +244,115 @@ bool GzipCompressor::write_or_error(ReadonlyBytes bytes)
     return true;
 }
 
-Optional<ByteBuffer> GzipCompressor::compress_all(const ReadonlyBytes& bytes)
+void GzipCompressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+
+    m_compressed_stream.final_flush();
+    LittleEndian<u32> digest = m_checksum.digest();
+    LittleEndian<u32> size = m_total_input_size;
+    m_output_stream << digest << size;
+}
+
+Optional<ByteBuffer> GzipCompressor::compress_all(const ReadonlyBytes& bytes, DeflateCompressor::CompressionLevel compression_level)
 {
     DuplexMemoryStream output_stream;
-    GzipCompressor gzip_stream { output_stream };
+    GzipCompressor gzip_stream { output_stream, compression_level };
 
     gzip_stream.write_or_error(bytes);
 
+    gzip_stream.final_flush();
+
     if (gzip_stream.handle_any_error())
         return {};
 
     return output_stream.copy_into_contiguous_buffer();
 }
 
+ParallelGzipCompressor::ParallelGzipCompressor(OutputStream& stream, size_t parts_per_batch, ParallelRunner run_in_parallel, DeflateCompressor::CompressionLevel compression_level)
+    : m_output_stream(stream)
+    , m_parts_per_batch(max(parts_per_batch, (size_t)1))
+    , m_run_in_parallel(move(run_in_parallel))
+    , m_compression_level(compression_level)
+{
+    GzipCompressor::write_header(m_output_stream, compression_level);
+}
+
+ParallelGzipCompressor::~ParallelGzipCompressor()
+{
+    VERIFY(m_finished);
+}
+
+size_t ParallelGzipCompressor::write(ReadonlyBytes bytes)
+{
+    VERIFY(!m_finished);
+
+    auto batch_size = m_parts_per_batch * part_size;
+    size_t nwritten = 0;
+    while (nwritten < bytes.size()) {
+        // Only compress a full batch once there's more to come, the last batch has to be compressed by final_flush().
+        if (m_buffer.size() - m_dictionary_size == batch_size)
+            compress_batch(false);
+        auto chunk = bytes.slice(nwritten, min(bytes.size() - nwritten, batch_size - (m_buffer.size() - m_dictionary_size)));
+        m_buffer.append(chunk.data(), chunk.size());
+        nwritten += chunk.size();
+    }
+    m_total_input_size += nwritten;
+    return nwritten;
+}
+
+bool ParallelGzipCompressor::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+void ParallelGzipCompressor::compress_batch(bool is_last_batch)
+{
+    auto input = m_buffer.span().slice(m_dictionary_size);
+    auto part_count = max((input.size() + part_size - 1) / part_size, (size_t)1);
+
+    // The checksum has to be calculated over all of the input in order, so that gets a task of its own.
+    Vector<Optional<ByteBuffer>> compressed_parts;
+    compressed_parts.resize(part_count);
+    m_run_in_parallel(part_count + 1, [&](size_t index) {
+        if (index == part_count) {
+            m_checksum.update(input);
+            return;
+        }
+        auto part_start = index * part_size;
+        auto part = input.slice(part_start, min(part_size, input.size() - part_start));
+        auto dictionary = m_buffer.span().slice(0, m_dictionary_size + part_start);
+        compressed_parts[index] = DeflateCompressor::compress_part(dictionary, part, is_last_batch && index == part_count - 1, m_compression_level);
+    });
+
+    for (auto& compressed_part : compressed_parts) {
+        if (!compressed_part.has_value() || !m_output_stream.write_or_error(compressed_part.value())) {
+            set_fatal_error();
+            break;
+        }
+    }
+
+    // Keep as much of the input as the next batch can refer back to.
+    auto new_dictionary_size = min(m_buffer.size(), DeflateCompressor::block_size);
+    m_buffer.remove(0, m_buffer.size() - new_dictionary_size);
+    m_dictionary_size = new_dictionary_size;
+}
+
+void ParallelGzipCompressor::final_flush()
+{
+    VERIFY(!m_finished);
+    m_finished = true;
+
+    compress_batch(true);
+    LittleEndian<u32> digest = m_checksum.digest();
+    LittleEndian<u32> size = m_total_input_size;
+    m_output_stream << digest << size;
+}
+
 }
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <AK/Function.h>
+#include <AK/Vector.h>
 #include <LibCompress/Deflate.h>
 #include <LibCrypto/Checksum/CRC32.h>
 
@@ -80,16 +82,56 @@ private:
 
 class GzipCompressor final : public OutputStream {
 public:
-    GzipCompressor(OutputStream&);
+    GzipCompressor(OutputStream&, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD);
     ~GzipCompressor();
 
     size_t write(ReadonlyBytes) override;
     bool write_or_error(ReadonlyBytes) override;
+    void final_flush();
 
-    static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes);
+    static Optional<ByteBuffer> compress_all(const ReadonlyBytes& bytes, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD);
+
+    static void write_header(OutputStream&, DeflateCompressor::CompressionLevel);
 
 private:
+    bool m_finished { false };
+    OutputStream& m_output_stream;
+    DeflateCompressor m_compressed_stream;
+    Crypto::Checksum::CRC32 m_checksum;
+    size_t m_total_input_size { 0 };
+};
+
+// Writes a single gzip member, just like GzipCompressor, but compresses it in parts that don't depend on each other,
+// so that several of them can be compressed at the same time. Every part can still refer back to the end of the one
+// before it, so this compresses nearly as well.
+// Since LibCompress doesn't know about threads, spreading the parts over them is up to the ParallelRunner.
+class ParallelGzipCompressor final : public OutputStream {
+public:
+    static constexpr size_t part_size = 128 * KiB;
+
+    // Calls task(i) for every i in [0, count), and returns once all of those calls are done.
+    using ParallelRunner = Function<void(size_t count, const Function<void(size_t)>& task)>;
+
+    ParallelGzipCompressor(OutputStream&, size_t parts_per_batch, ParallelRunner, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD);
+    ~ParallelGzipCompressor();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+    void final_flush();
+
+private:
+    void compress_batch(bool is_last_batch);
+
+    bool m_finished { false };
     OutputStream& m_output_stream;
+    const size_t m_parts_per_batch;
+    ParallelRunner m_run_in_parallel;
+    DeflateCompressor::CompressionLevel m_compression_level;
+    // The end of the previous batch, as the dictionary for this one, followed by the input for this batch.
+    Vector<u8> m_buffer;
+    size_t m_dictionary_size { 0 };
+    Crypto::Checksum::CRC32 m_checksum;
+    size_t m_total_input_size { 0 };
 };
 
 }
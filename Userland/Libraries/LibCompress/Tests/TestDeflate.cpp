@@ -9,6 +9,7 @@
 #include <AK/Array.h>
 #include <AK/MemoryStream.h>
 #include <AK/Random.h>
+#include <AK/StringBuilder.h>
 #include <LibCompress/Deflate.h>
 #include <cstring>
 
@@ -156,4 +157,67 @@ TEST_CASE(deflate_compress_literals)
     EXPECT(compressed.has_value());
 }
 
+TEST_CASE(deflate_compress_parts)
+{
+    // The second half repeats the first, so the second part only compresses well if it can refer back into the first.
+    auto half = ByteBuffer::create_uninitialized(10000);
+    fill_with_random(half.data(), half.size());
+    auto original = ByteBuffer::create_uninitialized(half.size() * 2);
+    half.bytes().copy_to(original.bytes());
+    half.bytes().copy_to(original.bytes().slice(half.size()));
+
+    auto first_part = Compress::DeflateCompressor::compress_part({}, half, false);
+    EXPECT(first_part.has_value());
+    auto second_part = Compress::DeflateCompressor::compress_part(half, half, true);
+    EXPECT(second_part.has_value());
+    EXPECT(second_part.value().size() < 100);
+
+    auto compressed = ByteBuffer::copy(first_part.value());
+    compressed.append(second_part.value().data(), second_part.value().size());
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed);
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(deflate_round_trip_primed_blocks)
+{
+    // Every block but the first refers back into the one before it.
+    auto pattern = ByteBuffer::create_uninitialized(1000);
+    fill_with_random(pattern.data(), pattern.size());
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::block_size * 3);
+    for (size_t offset = 0; offset < original.size(); offset += pattern.size())
+        pattern.bytes().copy_trimmed_to(original.bytes().slice(offset));
+
+    auto compressed = Compress::DeflateCompressor::compress_all(original);
+    EXPECT(compressed.has_value());
+    EXPECT(compressed.value().size() < 2000);
+    auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+BENCHMARK_CASE(deflate_decompress_text)
+{
+    // Words picked at random give a mix of literals and back references, like text does.
+    constexpr StringView words[] = { "the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog", "deflate", "stream", "huffman", "code", "window", "block", "symbol", "length" };
+    constexpr size_t run_count = 16;
+    constexpr size_t size = 1 * MiB;
+
+    StringBuilder builder(size);
+    while (builder.length() < size) {
+        builder.append(words[get_random<u8>() % array_size(words)]);
+        builder.append(' ');
+    }
+    auto original = builder.to_byte_buffer();
+
+    auto compressed = Compress::DeflateCompressor::compress_all(original, Compress::DeflateCompressor::CompressionLevel::FAST);
+    EXPECT(compressed.has_value());
+
+    for (size_t run = 0; run < run_count; ++run) {
+        auto uncompressed = Compress::DeflateDecompressor::decompress_all(compressed.value());
+        EXPECT(uncompressed.has_value());
+        EXPECT(uncompressed.value() == original);
+    }
+}
+
 TEST_MAIN(Deflate)
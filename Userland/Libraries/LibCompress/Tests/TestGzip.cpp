@@ -7,7 +7,9 @@
 #include <AK/TestSuite.h>
 
 #include <AK/Array.h>
+#include <AK/MemoryStream.h>
 #include <AK/Random.h>
+#include <AK/StringBuilder.h>
 #include <LibCompress/Gzip.h>
 
 TEST_CASE(gzip_decompress_simple)
@@ -96,4 +98,67 @@ TEST_CASE(gzip_round_trip)
     EXPECT(uncompressed.value() == original);
 }
 
+TEST_CASE(gzip_round_trip_streaming)
+{
+    auto original = ByteBuffer::create_uninitialized(Compress::DeflateCompressor::block_size * 2);
+    fill_with_random(original.data(), original.size());
+
+    // Every write goes into the same member, so the result decompresses back in one piece.
+    DuplexMemoryStream output_stream;
+    Compress::GzipCompressor gzip_stream { output_stream, Compress::DeflateCompressor::CompressionLevel::FAST };
+    for (size_t offset = 0; offset < original.size(); offset += 1000)
+        EXPECT(gzip_stream.write_or_error(original.bytes().slice(offset, min<size_t>(1000, original.size() - offset))));
+    gzip_stream.final_flush();
+
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(output_stream.copy_into_contiguous_buffer());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(gzip_round_trip_parallel)
+{
+    // Text-like data, so that the parts have something to refer back to. With two parts per batch, this takes a few batches.
+    constexpr StringView words[] = { "gzip", "member", "part", "batch", "dictionary", "deflate", "block", "thread" };
+    StringBuilder builder;
+    while (builder.length() < Compress::ParallelGzipCompressor::part_size * 5 + 1234) {
+        builder.append(words[get_random<u8>() % array_size(words)]);
+        builder.append(' ');
+    }
+    auto original = builder.to_byte_buffer();
+
+    // The parts don't depend on each other, so doing them out of order has to give the same result.
+    DuplexMemoryStream output_stream;
+    Compress::ParallelGzipCompressor gzip_stream { output_stream, 2, [](size_t count, auto& task) {
+                                                      for (size_t i = count; i > 0; --i)
+                                                          task(i - 1);
+                                                  } };
+    for (size_t offset = 0; offset < original.size(); offset += 100000)
+        EXPECT(gzip_stream.write_or_error(original.bytes().slice(offset, min<size_t>(100000, original.size() - offset))));
+    gzip_stream.final_flush();
+    EXPECT(!gzip_stream.handle_any_error());
+
+    auto compressed = output_stream.copy_into_contiguous_buffer();
+    auto serially_compressed = Compress::GzipCompressor::compress_all(original);
+    EXPECT(serially_compressed.has_value());
+    EXPECT(compressed.size() < serially_compressed.value().size() * 11 / 10);
+
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(compressed);
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value() == original);
+}
+
+TEST_CASE(gzip_round_trip_parallel_empty)
+{
+    DuplexMemoryStream output_stream;
+    Compress::ParallelGzipCompressor gzip_stream { output_stream, 4, [](size_t count, auto& task) {
+                                                      for (size_t i = 0; i < count; ++i)
+                                                          task(i);
+                                                  } };
+    gzip_stream.final_flush();
+
+    auto uncompressed = Compress::GzipDecompressor::decompress_all(output_stream.copy_into_contiguous_buffer());
+    EXPECT(uncompressed.has_value());
+    EXPECT(uncompressed.value().is_empty());
+}
+
 TEST_MAIN(Gzip)
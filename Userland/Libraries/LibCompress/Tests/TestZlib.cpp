@@ -24,4 +24,15 @@ TEST_CASE(zlib_decompress_simple)
     EXPECT(decompressed.value().bytes() == (ReadonlyBytes { uncompressed, sizeof(uncompressed) - 1 }));
 }
 
+TEST_CASE(zlib_round_trip)
+{
+    const u8 original[] = "This is a simple text file :) This is a simple text file :)";
+    const ReadonlyBytes original_bytes { original, sizeof(original) - 1 };
+
+    const auto compressed = Compress::Zlib::compress_all(original_bytes);
+    EXPECT(compressed.has_value());
+    const auto decompressed = Compress::Zlib::decompress_all(compressed.value());
+    EXPECT(decompressed.value().bytes() == original_bytes);
+}
+
 TEST_MAIN(Zlib)
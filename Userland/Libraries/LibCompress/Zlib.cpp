@@ -4,11 +4,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/MemoryStream.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCompress/Deflate.h>
 #include <LibCompress/Zlib.h>
+#include <LibCrypto/Checksum/Adler32.h>
 
 namespace Compress {
 
@@ -59,6 +61,41 @@ Optional<ByteBuffer> Zlib::decompress_all(ReadonlyBytes bytes)
     return zlib->decompress();
 }
 
+Optional<ByteBuffer> Zlib::compress_all(ReadonlyBytes bytes, DeflateCompressor::CompressionLevel compression_level)
+{
+    DuplexMemoryStream output_stream;
+
+    u8 compression_info = 0x78; // deflate with a 32 KiB window
+    u8 flags = 0;
+    switch (compression_level) {
+    case DeflateCompressor::CompressionLevel::STORE:
+        break;
+    case DeflateCompressor::CompressionLevel::FAST:
+        flags = 1 << 6;
+        break;
+    case DeflateCompressor::CompressionLevel::GOOD:
+        flags = 2 << 6;
+        break;
+    case DeflateCompressor::CompressionLevel::GREAT:
+    case DeflateCompressor::CompressionLevel::BEST:
+        flags = 3 << 6;
+        break;
+    }
+    flags |= 31 - (compression_info * 256 + flags) % 31; // error correction code
+    output_stream << compression_info << flags;
+
+    DeflateCompressor deflate_stream { output_stream, compression_level };
+    deflate_stream.write_or_error(bytes);
+    deflate_stream.final_flush();
+    if (deflate_stream.handle_any_error())
+        return {};
+
+    BigEndian<u32> checksum = Crypto::Checksum::Adler32(bytes).digest();
+    output_stream << checksum;
+
+    return output_stream.copy_into_contiguous_buffer();
+}
+
 u32 Zlib::checksum()
 {
     if (!m_checksum) {
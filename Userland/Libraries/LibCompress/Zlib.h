@@ -9,6 +9,7 @@
 #include <AK/ByteBuffer.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
+#include <LibCompress/Deflate.h>
 
 namespace Compress {
 
@@ -19,6 +20,7 @@ public:
 
     static Optional<Zlib> try_create(ReadonlyBytes data);
     static Optional<ByteBuffer> decompress_all(ReadonlyBytes);
+    static Optional<ByteBuffer> compress_all(ReadonlyBytes, DeflateCompressor::CompressionLevel = DeflateCompressor::CompressionLevel::GOOD);
 
 private:
     Zlib(const ReadonlyBytes& data);
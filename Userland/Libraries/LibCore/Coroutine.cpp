@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/Coroutine.h>
+#include <LibCore/IODevice.h>
+#include <LibCore/Notifier.h>
+#include <errno.h>
+#include <unistd.h>
+
+namespace Core {
+
+NotifierAwaiter::NotifierAwaiter(int fd, unsigned event_mask)
+    : m_fd(fd)
+    , m_event_mask(event_mask)
+{
+}
+
+NotifierAwaiter::~NotifierAwaiter()
+{
+}
+
+void NotifierAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    m_notifier = Notifier::construct(m_fd, m_event_mask);
+    auto callback = [this, handle] {
+        m_notifier->set_enabled(false);
+        // Resuming right here could destroy the Notifier, and this callback with it, while it's still running.
+        m_notifier->deferred_invoke([handle](auto&) {
+            handle.resume();
+        });
+    };
+    if (m_event_mask & Notifier::Event::Read)
+        m_notifier->on_ready_to_read = move(callback);
+    else
+        m_notifier->on_ready_to_write = move(callback);
+}
+
+NotifierAwaiter wait_until_readable(int fd)
+{
+    return NotifierAwaiter { fd, Notifier::Event::Read };
+}
+
+NotifierAwaiter wait_until_writable(int fd)
+{
+    return NotifierAwaiter { fd, Notifier::Event::Write };
+}
+
+Task<ByteBuffer> async_read(IODevice& device, size_t max_size)
+{
+    if (!device.can_read())
+        co_await wait_until_readable(device.fd());
+    co_return device.read(max_size);
+}
+
+Task<bool> async_write(IODevice& device, ReadonlyBytes bytes)
+{
+    while (!bytes.is_empty()) {
+        auto nwritten = ::write(device.fd(), bytes.data(), bytes.size());
+        if (nwritten < 0) {
+            if (errno != EAGAIN && errno != EINTR)
+                co_return false;
+            if (errno == EAGAIN)
+                co_await wait_until_writable(device.fd());
+            continue;
+        }
+        bytes = bytes.slice(nwritten);
+    }
+    co_return true;
+}
+
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/ByteBuffer.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/RefPtr.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <LibCore/Forward.h>
+#include <coroutine>
+
+namespace Core {
+
+template<typename T = void>
+class Task;
+
+namespace Detail {
+
+class TaskPromiseBase {
+public:
+    // Once the task is done, hand control back to whoever was co_awaiting it.
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            if (auto continuation = handle.promise().continuation)
+                return continuation;
+            return std::noop_coroutine();
+        }
+        void await_resume() noexcept { }
+    };
+
+    std::coroutine_handle<> continuation;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() { VERIFY_NOT_REACHED(); }
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    Task<T> get_return_object();
+
+    template<typename U>
+    void return_value(U&& value) { m_result = forward<U>(value); }
+
+    T take_result() { return m_result.release_value(); }
+
+private:
+    Optional<T> m_result;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+
+    void return_void() { }
+
+    void take_result() { }
+};
+
+}
+
+// A coroutine that produces a T. A Task doesn't start running until it is either co_awaited by another coroutine,
+// which then resumes once the task has finished, or started with start() by plain code. The Task owns the coroutine:
+// destroying it destroys the coroutine wherever it is suspended, along with any Task it is co_awaiting in turn.
+// That makes destroying the Task the way to cancel it, but it must never happen while the coroutine is running.
+template<typename T>
+class [[nodiscard]] Task {
+    AK_MAKE_NONCOPYABLE(Task);
+
+public:
+    using promise_type = Detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() = default;
+
+    Task(Task&& other)
+        : m_handle(exchange(other.m_handle, nullptr))
+    {
+    }
+
+    Task& operator=(Task&& other)
+    {
+        if (this != &other) {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = exchange(other.m_handle, nullptr);
+        }
+        return *this;
+    }
+
+    ~Task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    bool is_valid() const { return static_cast<bool>(m_handle); }
+    bool is_done() const { return m_handle && m_handle.done(); }
+
+    // Runs the task up to its first suspension point, for tasks that nobody co_awaits.
+    void start()
+    {
+        VERIFY(m_handle && !m_handle.done());
+        m_handle.resume();
+    }
+
+    auto operator co_await() &&
+    {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() { return handle.done(); }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting_coroutine)
+            {
+                handle.promise().continuation = awaiting_coroutine;
+                return handle;
+            }
+            T await_resume() { return handle.promise().take_result(); }
+        };
+        VERIFY(m_handle);
+        return Awaiter { m_handle };
+    }
+
+private:
+    friend class Detail::TaskPromise<T>;
+
+    explicit Task(Handle handle)
+        : m_handle(handle)
+    {
+    }
+
+    Handle m_handle;
+};
+
+template<typename T>
+Task<T> Detail::TaskPromise<T>::get_return_object()
+{
+    return Task<T> { Task<T>::Handle::from_promise(*this) };
+}
+
+inline Task<void> Detail::TaskPromise<void>::get_return_object()
+{
+    return Task<void> { Task<void>::Handle::from_promise(*this) };
+}
+
+// Lets a coroutine wait until something happens, such as a socket receiving data. Whatever the coroutine is waiting
+// for calls notify(), which resumes the coroutine that is waiting, if there is one. Notifications while no one is
+// waiting are dropped, so this is meant for conditions the coroutine checks for itself before it waits again:
+//
+//     while (!socket.can_read())
+//         co_await m_ready_to_read.wait();
+class AsyncEvent {
+    AK_MAKE_NONCOPYABLE(AsyncEvent);
+    AK_MAKE_NONMOVABLE(AsyncEvent);
+
+public:
+    AsyncEvent() = default;
+
+    auto wait()
+    {
+        struct Awaiter {
+            AsyncEvent& event;
+            std::coroutine_handle<> handle {};
+
+            // The waiting coroutine was destroyed, so there is nothing to resume anymore.
+            ~Awaiter()
+            {
+                if (handle && event.m_waiting_coroutine == handle)
+                    event.m_waiting_coroutine = nullptr;
+            }
+
+            bool await_ready() { return false; }
+            void await_suspend(std::coroutine_handle<> waiting_coroutine)
+            {
+                VERIFY(!event.m_waiting_coroutine);
+                handle = waiting_coroutine;
+                event.m_waiting_coroutine = waiting_coroutine;
+            }
+            void await_resume() { }
+        };
+        return Awaiter { *this };
+    }
+
+    bool has_waiter() const { return static_cast<bool>(m_waiting_coroutine); }
+
+    void notify()
+    {
+        if (auto coroutine = exchange(m_waiting_coroutine, nullptr))
+            coroutine.resume();
+    }
+
+private:
+    std::coroutine_handle<> m_waiting_coroutine;
+};
+
+// Suspends the calling coroutine until |fd| becomes readable or writable, as seen by the current event loop.
+// The coroutine is resumed from the event loop, not from inside the Notifier's callback.
+class NotifierAwaiter {
+public:
+    NotifierAwaiter(int fd, unsigned event_mask);
+    ~NotifierAwaiter();
+
+    bool await_ready() { return false; }
+    void await_suspend(std::coroutine_handle<>);
+    void await_resume() { }
+
+private:
+    int m_fd { -1 };
+    unsigned m_event_mask { 0 };
+    RefPtr<Notifier> m_notifier;
+};
+
+NotifierAwaiter wait_until_readable(int fd);
+NotifierAwaiter wait_until_writable(int fd);
+
+// Reads at most |max_size| bytes from |device|, waiting for it to become readable first if needed.
+Task<ByteBuffer> async_read(IODevice&, size_t max_size);
+// Writes all of |bytes| to |device|, waiting for it to become writable whenever it can't take more.
+Task<bool> async_write(IODevice&, ReadonlyBytes);
+
+}
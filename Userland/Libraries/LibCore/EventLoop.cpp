@@ -12,6 +12,7 @@
 #include <AK/JsonObject.h>
 #include <AK/JsonValue.h>
 #include <AK/NeverDestroyed.h>
+#include <AK/NumericLimits.h>
 #include <AK/Singleton.h>
 #include <AK/TemporaryChange.h>
 #include <AK/Time.h>
@@ -35,20 +36,105 @@
 #include <time.h>
 #include <unistd.h>
 
+#if defined(__serenity__) || defined(__linux__)
+#    define EVENTLOOP_USE_EPOLL
+#    include <sys/epoll.h>
+#endif
+
 namespace Core {
 
 class RPCClient;
 
 struct EventLoopTimer {
+    static constexpr size_t not_in_heap = NumericLimits<size_t>::max();
+
     int timer_id { 0 };
     int interval { 0 };
     timeval fire_time { 0, 0 };
     bool should_reload { false };
     TimerShouldFireWhenNotVisible fire_when_not_visible { TimerShouldFireWhenNotVisible::No };
     WeakPtr<Object> owner;
+    // Position in s_timer_heap, or not_in_heap while the timer is parked in s_parked_timers.
+    size_t heap_index { not_in_heap };
 
     void reload(const timeval& now);
     bool has_expired(const timeval& now) const;
+    bool fires_before(const EventLoopTimer& other) const;
+    bool is_suppressed() const;
+};
+
+// The registered timers ordered by fire time, soonest first. Every timer knows where it sits in the heap,
+// so unregistering one doesn't have to search for it.
+class TimerHeap {
+public:
+    bool is_empty() const { return m_timers.is_empty(); }
+    EventLoopTimer& soonest() { return *m_timers.first(); }
+
+    void insert(EventLoopTimer& timer)
+    {
+        VERIFY(timer.heap_index == EventLoopTimer::not_in_heap);
+        m_timers.append(&timer);
+        sift_up(m_timers.size() - 1);
+    }
+
+    void remove(EventLoopTimer& timer)
+    {
+        auto index = timer.heap_index;
+        VERIFY(index < m_timers.size() && m_timers[index] == &timer);
+        timer.heap_index = EventLoopTimer::not_in_heap;
+        auto* last = m_timers.take_last();
+        if (last == &timer)
+            return;
+        place(index, *last);
+        sift_up(index);
+        sift_down(last->heap_index);
+    }
+
+    void clear()
+    {
+        for (auto* timer : m_timers)
+            timer->heap_index = EventLoopTimer::not_in_heap;
+        m_timers.clear();
+    }
+
+private:
+    void place(size_t index, EventLoopTimer& timer)
+    {
+        m_timers[index] = &timer;
+        timer.heap_index = index;
+    }
+
+    void sift_up(size_t index)
+    {
+        auto& timer = *m_timers[index];
+        while (index > 0) {
+            auto parent = (index - 1) / 2;
+            if (!timer.fires_before(*m_timers[parent]))
+                break;
+            place(index, *m_timers[parent]);
+            index = parent;
+        }
+        place(index, timer);
+    }
+
+    void sift_down(size_t index)
+    {
+        auto& timer = *m_timers[index];
+        for (;;) {
+            auto child = index * 2 + 1;
+            if (child >= m_timers.size())
+                break;
+            if (child + 1 < m_timers.size() && m_timers[child + 1]->fires_before(*m_timers[child]))
+                ++child;
+            if (!m_timers[child]->fires_before(timer))
+                break;
+            place(index, *m_timers[child]);
+            index = child;
+        }
+        place(index, timer);
+    }
+
+    Vector<EventLoopTimer*> m_timers;
 };
 
 struct EventLoop::Private {
@@ -59,8 +145,76 @@ static EventLoop* s_main_event_loop;
 static Vector<EventLoop*>* s_event_loop_stack;
 static NeverDestroyed<IDAllocator> s_id_allocator;
 static HashMap<int, NonnullOwnPtr<EventLoopTimer>>* s_timers;
+static TimerHeap* s_timer_heap;
+// Timers that expired while their owner wasn't visible. They fire as soon as it is again.
+static Vector<EventLoopTimer*>* s_parked_timers;
 static HashTable<Notifier*>* s_notifiers;
 int EventLoop::s_wake_pipe_fds[2];
+
+#ifdef EVENTLOOP_USE_EPOLL
+// The notifiers are kept in a persistent epoll set, so waiting for events doesn't
+// have to hand every single fd to the kernel again on each iteration.
+struct EpollInterest {
+    Vector<Notifier*, 1> notifiers;
+    unsigned registered_event_mask { 0 };
+};
+static HashMap<int, EpollInterest>* s_epoll_interests;
+static int s_epoll_fd = -1;
+
+static int epoll_fd()
+{
+    if (s_epoll_fd >= 0)
+        return s_epoll_fd;
+    s_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (s_epoll_fd < 0) {
+        perror("epoll_create1");
+        VERIFY_NOT_REACHED();
+    }
+    return s_epoll_fd;
+}
+
+static void update_epoll_interest(int fd)
+{
+    auto it = s_epoll_interests->find(fd);
+    if (it == s_epoll_interests->end())
+        return;
+    auto& interest = it->value;
+
+    unsigned event_mask = 0;
+    for (auto* notifier : interest.notifiers)
+        event_mask |= notifier->event_mask();
+    if (event_mask & Notifier::Exceptional)
+        VERIFY_NOT_REACHED();
+
+    if (event_mask != interest.registered_event_mask) {
+        if (event_mask == 0) {
+            // The fd may well have been closed already, so failure is fine here.
+            epoll_ctl(epoll_fd(), EPOLL_CTL_DEL, fd, nullptr);
+        } else {
+            epoll_event event {};
+            if (event_mask & Notifier::Read)
+                event.events |= EPOLLIN;
+            if (event_mask & Notifier::Write)
+                event.events |= EPOLLOUT;
+            event.data.fd = fd;
+            int rc = epoll_ctl(epoll_fd(), interest.registered_event_mask ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event);
+            // If the fd was closed and reused behind our back, the kernel's view of it differs from ours.
+            if (rc < 0 && errno == EEXIST)
+                rc = epoll_ctl(epoll_fd(), EPOLL_CTL_MOD, fd, &event);
+            else if (rc < 0 && errno == ENOENT)
+                rc = epoll_ctl(epoll_fd(), EPOLL_CTL_ADD, fd, &event);
+            if (rc < 0) {
+                perror("epoll_ctl");
+                event_mask = 0;
+            }
+        }
+        interest.registered_event_mask = event_mask;
+    }
+
+    if (interest.notifiers.is_empty())
+        s_epoll_interests->remove(it);
+}
+#endif
 static RefPtr<LocalServer> s_rpc_server;
 HashMap<int, RefPtr<RPCClient>> s_rpc_clients;
 
@@ -260,7 +414,12 @@ EventLoop::EventLoop()
     if (!s_event_loop_stack) {
         s_event_loop_stack = new Vector<EventLoop*>;
         s_timers = new HashMap<int, NonnullOwnPtr<EventLoopTimer>>;
+        s_timer_heap = new TimerHeap;
+        s_parked_timers = new Vector<EventLoopTimer*>;
         s_notifiers = new HashTable<Notifier*>;
+#ifdef EVENTLOOP_USE_EPOLL
+        s_epoll_interests = new HashMap<int, EpollInterest>;
+#endif
     }
 
     if (!s_main_event_loop) {
@@ -275,6 +434,13 @@ EventLoop::EventLoop()
 
 #endif
         VERIFY(rc == 0);
+#ifdef EVENTLOOP_USE_EPOLL
+        epoll_event event {};
+        event.events = EPOLLIN;
+        event.data.fd = s_wake_pipe_fds[0];
+        rc = epoll_ctl(epoll_fd(), EPOLL_CTL_ADD, s_wake_pipe_fds[0], &event);
+        VERIFY(rc == 0);
+#endif
         s_event_loop_stack->append(this);
 
 #ifdef __serenity__
@@ -375,6 +541,12 @@ void EventLoop::pump(WaitMode mode)
         LOCKER(m_private->lock);
         events = move(m_queued_events);
     }
+    // Other threads post to the main loop (it's the only one that is sure to still exist), and those events shouldn't
+    // have to wait for a nested loop to exit.
+    if (this != s_main_event_loop) {
+        LOCKER(s_main_event_loop->m_private->lock);
+        events.append(move(s_main_event_loop->m_queued_events));
+    }
 
     for (size_t i = 0; i < events.size(); ++i) {
         auto& queued_event = events.at(i);
@@ -557,8 +729,18 @@ void EventLoop::notify_forked(ForkEvent event)
     case ForkEvent::Child:
         s_main_event_loop = nullptr;
         s_event_loop_stack->clear();
+        s_timer_heap->clear();
+        s_parked_timers->clear();
         s_timers->clear();
         s_notifiers->clear();
+#ifdef EVENTLOOP_USE_EPOLL
+        // The epoll set is shared with the parent, so start over with a fresh one.
+        s_epoll_interests->clear();
+        if (s_epoll_fd >= 0) {
+            close(s_epoll_fd);
+            s_epoll_fd = -1;
+        }
+#endif
         if (auto* info = signals_info<false>()) {
             info->signal_handlers.clear();
             info->next_signal_id = 0;
@@ -576,9 +758,14 @@ void EventLoop::notify_forked(ForkEvent event)
 
 void EventLoop::wait_for_event(WaitMode mode)
 {
+#ifdef EVENTLOOP_USE_EPOLL
+    epoll_event events[32];
+#else
     fd_set rfds;
     fd_set wfds;
+#endif
 retry:
+#ifndef EVENTLOOP_USE_EPOLL
     FD_ZERO(&rfds);
     FD_ZERO(&wfds);
 
@@ -600,6 +787,7 @@ retry:
         if (notifier->event_mask() & Notifier::Exceptional)
             VERIFY_NOT_REACHED();
     }
+#endif
 
     bool queued_events_is_empty;
     {
@@ -621,14 +809,28 @@ retry:
             if (timeout.tv_sec < 0 || (timeout.tv_sec == 0 && timeout.tv_usec < 0)) {
                 timeout.tv_sec = 0;
                 timeout.tv_usec = 0;
+            } else if (timeout.tv_usec % 1000) {
+                // Round up to a whole millisecond, so timers expiring within the same millisecond are handled in one wakeup.
+                timeout.tv_usec += 1000 - timeout.tv_usec % 1000;
+                if (timeout.tv_usec >= 1'000'000) {
+                    timeout.tv_usec -= 1'000'000;
+                    ++timeout.tv_sec;
+                }
             }
         } else {
             should_wait_forever = true;
         }
     }
 
+#ifdef EVENTLOOP_USE_EPOLL
+    // Round up, so we don't wake up just before the next timer expires.
+    int timeout_ms = should_wait_forever ? -1 : timeout.tv_sec * 1000 + (timeout.tv_usec + 999) / 1000;
+try_select_again:
+    int marked_fd_count = epoll_wait(epoll_fd(), events, sizeof(events) / sizeof(events[0]), timeout_ms);
+#else
 try_select_again:
     int marked_fd_count = select(max_fd + 1, &rfds, &wfds, nullptr, should_wait_forever ? nullptr : &timeout);
+#endif
     if (marked_fd_count < 0) {
         int saved_errno = errno;
         if (saved_errno == EINTR) {
@@ -639,7 +841,17 @@ try_select_again:
         dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop::wait_for_event: {} ({}: {})", marked_fd_count, saved_errno, strerror(saved_errno));
         VERIFY_NOT_REACHED();
     }
-    if (FD_ISSET(s_wake_pipe_fds[0], &rfds)) {
+
+#ifdef EVENTLOOP_USE_EPOLL
+    bool wake_pipe_is_readable = false;
+    for (int i = 0; i < marked_fd_count; ++i) {
+        if (events[i].data.fd == s_wake_pipe_fds[0])
+            wake_pipe_is_readable = true;
+    }
+#else
+    bool wake_pipe_is_readable = FD_ISSET(s_wake_pipe_fds[0], &rfds);
+#endif
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         auto nread = read(s_wake_pipe_fds[0], wake_events, sizeof(wake_events));
         if (nread < 0) {
@@ -667,22 +879,35 @@ try_select_again:
         now.tv_usec = now_spec.tv_nsec / 1000;
     }
 
-    for (auto& it : *s_timers) {
-        auto& timer = *it.value;
-        if (!timer.has_expired(now))
-            continue;
-        auto owner = timer.owner.strong_ref();
-        if (timer.fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
+    // Take all expired timers off the heap before firing any of them, so that a timer with a zero
+    // interval fires once per pass instead of being reloaded and found expired again.
+    Vector<EventLoopTimer*, 16> expired_timers;
+    for (size_t i = 0; i < s_parked_timers->size();) {
+        if (s_parked_timers->at(i)->is_suppressed()) {
+            ++i;
             continue;
         }
+        expired_timers.append(s_parked_timers->unstable_take(i));
+    }
+    while (!s_timer_heap->is_empty() && s_timer_heap->soonest().has_expired(now)) {
+        auto& timer = s_timer_heap->soonest();
+        s_timer_heap->remove(timer);
+        if (timer.is_suppressed())
+            s_parked_timers->append(&timer);
+        else
+            expired_timers.append(&timer);
+    }
 
-        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer.timer_id, *owner);
+    for (auto* timer : expired_timers) {
+        auto owner = timer->owner.strong_ref();
+
+        dbgln_if(EVENTLOOP_DEBUG, "Core::EventLoop: Timer {} has expired, sending Core::TimerEvent to {}", timer->timer_id, *owner);
 
         if (owner)
-            post_event(*owner, make<TimerEvent>(timer.timer_id));
-        if (timer.should_reload) {
-            timer.reload(now);
+            post_event(*owner, make<TimerEvent>(timer->timer_id));
+        if (timer->should_reload) {
+            timer->reload(now);
+            s_timer_heap->insert(*timer);
         } else {
             // FIXME: Support removing expired timers that don't want to reload.
             VERIFY_NOT_REACHED();
@@ -692,6 +917,25 @@ try_select_again:
     if (!marked_fd_count)
         return;
 
+#ifdef EVENTLOOP_USE_EPOLL
+    for (int i = 0; i < marked_fd_count; ++i) {
+        auto& event = events[i];
+        if (event.data.fd == s_wake_pipe_fds[0])
+            continue;
+        auto it = s_epoll_interests->find(event.data.fd);
+        if (it == s_epoll_interests->end())
+            continue;
+        // Like select(), report errors and hangups as readiness and let the read or write find out what happened.
+        bool is_readable = event.events & (EPOLLIN | EPOLLERR | EPOLLHUP);
+        bool is_writable = event.events & (EPOLLOUT | EPOLLERR | EPOLLHUP);
+        for (auto* notifier : it->value.notifiers) {
+            if (is_readable && (notifier->event_mask() & Notifier::Event::Read))
+                post_event(*notifier, make<NotifierReadEvent>(notifier->fd()));
+            if (is_writable && (notifier->event_mask() & Notifier::Event::Write))
+                post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
+        }
+    }
+#else
     for (auto& notifier : *s_notifiers) {
         if (FD_ISSET(notifier->fd(), &rfds)) {
             if (notifier->event_mask() & Notifier::Event::Read)
@@ -702,6 +946,7 @@ try_select_again:
                 post_event(*notifier, make<NotifierWriteEvent>(notifier->fd()));
         }
     }
+#endif
 }
 
 bool EventLoopTimer::has_expired(const timeval& now) const
@@ -711,25 +956,39 @@ bool EventLoopTimer::has_expired(const timeval& now) const
 
 void EventLoopTimer::reload(const timeval& now)
 {
-    fire_time = now;
-    fire_time.tv_sec += interval / 1000;
-    fire_time.tv_usec += (interval % 1000) * 1000;
+    timeval interval_time { interval / 1000, (interval % 1000) * 1000 };
+    timeval_add(now, interval_time, fire_time);
+}
+
+bool EventLoopTimer::fires_before(const EventLoopTimer& other) const
+{
+    if (fire_time.tv_sec != other.fire_time.tv_sec)
+        return fire_time.tv_sec < other.fire_time.tv_sec;
+    if (fire_time.tv_usec != other.fire_time.tv_usec)
+        return fire_time.tv_usec < other.fire_time.tv_usec;
+    // Timers due at the same time fire in the order they were registered.
+    return timer_id < other.timer_id;
+}
+
+bool EventLoopTimer::is_suppressed() const
+{
+    if (fire_when_not_visible == TimerShouldFireWhenNotVisible::Yes)
+        return false;
+    auto strong_owner = owner.strong_ref();
+    return strong_owner && !strong_owner->is_visible_for_timer_purposes();
 }
 
 Optional<struct timeval> EventLoop::get_next_timer_expiration()
 {
-    Optional<struct timeval> soonest {};
-    for (auto& it : *s_timers) {
-        auto& fire_time = it.value->fire_time;
-        auto owner = it.value->owner.strong_ref();
-        if (it.value->fire_when_not_visible == TimerShouldFireWhenNotVisible::No
-            && owner && !owner->is_visible_for_timer_purposes()) {
-            continue;
-        }
-        if (!soonest.has_value() || fire_time.tv_sec < soonest.value().tv_sec || (fire_time.tv_sec == soonest.value().tv_sec && fire_time.tv_usec < soonest.value().tv_usec))
-            soonest = fire_time;
+    // A parked timer whose owner has become visible again is overdue.
+    for (auto* timer : *s_parked_timers) {
+        if (!timer->is_suppressed())
+            return timer->fire_time;
     }
-    return soonest;
+    // The soonest timer may turn out to be suppressed too, in which case it gets parked when we wake up for it.
+    if (s_timer_heap->is_empty())
+        return {};
+    return s_timer_heap->soonest().fire_time;
 }
 
 int EventLoop::register_timer(Object& object, int milliseconds, bool should_reload, TimerShouldFireWhenNotVisible fire_when_not_visible)
@@ -748,6 +1007,7 @@ int EventLoop::register_timer(Object& object, int milliseconds, bool should_relo
     timer->fire_when_not_visible = fire_when_not_visible;
     int timer_id = s_id_allocator->allocate();
     timer->timer_id = timer_id;
+    s_timer_heap->insert(*timer);
     s_timers->set(timer_id, move(timer));
     return timer_id;
 }
@@ -758,18 +1018,45 @@ bool EventLoop::unregister_timer(int timer_id)
     auto it = s_timers->find(timer_id);
     if (it == s_timers->end())
         return false;
+    auto& timer = *it->value;
+    if (timer.heap_index != EventLoopTimer::not_in_heap)
+        s_timer_heap->remove(timer);
+    else
+        s_parked_timers->remove_first_matching([&](auto* parked_timer) { return parked_timer == &timer; });
     s_timers->remove(it);
     return true;
 }
 
 void EventLoop::register_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->set(&notifier);
+    if (s_notifiers->set(&notifier) != AK::HashSetResult::InsertedNewEntry)
+        return;
+#ifdef EVENTLOOP_USE_EPOLL
+    s_epoll_interests->ensure(notifier.fd()).notifiers.append(&notifier);
+    update_epoll_interest(notifier.fd());
+#endif
 }
 
 void EventLoop::unregister_notifier(Badge<Notifier>, Notifier& notifier)
 {
-    s_notifiers->remove(&notifier);
+    if (!s_notifiers->remove(&notifier))
+        return;
+#ifdef EVENTLOOP_USE_EPOLL
+    auto it = s_epoll_interests->find(notifier.fd());
+    VERIFY(it != s_epoll_interests->end());
+    it->value.notifiers.remove_first_matching([&](auto* entry) { return entry == &notifier; });
+    update_epoll_interest(notifier.fd());
+#endif
+}
+
+void EventLoop::notifier_event_mask_changed(Badge<Notifier>, Notifier& notifier)
+{
+#ifdef EVENTLOOP_USE_EPOLL
+    if (s_notifiers->contains(&notifier))
+        update_epoll_interest(notifier.fd());
+#else
+    (void)notifier;
+#endif
 }
 
 void EventLoop::wake()
@@ -15,8 +15,12 @@
 #include <fcntl.h>
 #include <libgen.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
+#if defined(__serenity__) || defined(__linux__)
+#    include <sys/sendfile.h>
+#endif
 #include <unistd.h>
 
 // On Linux distros that use glibc `basename` is defined as a macro that expands to `__xpg_basename`, so we undefine it
@@ -339,37 +343,70 @@ Result<void, File::CopyError> File::copy_file(const String& dst_path, const stru
 
     ScopeGuard close_fd_guard([dst_fd]() { ::close(dst_fd); });
 
+    auto result = copy_file_contents(dst_fd, source.fd(), src_stat);
+    if (result.is_error())
+        return CopyError { result.error(), false };
+
+    // NOTE: We don't copy the set-uid and set-gid bits.
+    auto my_umask = umask(0);
+    umask(my_umask);
+    if (fchmod(dst_fd, (src_stat.st_mode & ~my_umask) & ~06000) < 0)
+        return CopyError { OSError(errno), false };
+
+    return {};
+}
+
+Result<void, OSError> File::copy_file_contents(int dst_fd, int src_fd, const struct stat& src_stat)
+{
     if (src_stat.st_size > 0) {
         if (ftruncate(dst_fd, src_stat.st_size) < 0)
-            return CopyError { OSError(errno), false };
+            return OSError(errno);
     }
 
+    bool contents_copied = false;
+#if defined(__serenity__) || defined(__linux__)
+    // Let the kernel copy the data without taking a detour through our address space.
+    // If it can't do that for these files, fall back to reading and writing below.
     for (;;) {
-        char buffer[32768];
-        ssize_t nread = ::read(source.fd(), buffer, sizeof(buffer));
-        if (nread < 0) {
-            return CopyError { OSError(errno), false };
+        ssize_t nsent = ::sendfile(dst_fd, src_fd, nullptr, 16 * MiB);
+        if (nsent < 0) {
+            if (errno == EINVAL || errno == ENOSYS)
+                break;
+            return OSError(errno);
         }
-        if (nread == 0)
+        if (nsent == 0) {
+            contents_copied = true;
             break;
-        ssize_t remaining_to_write = nread;
-        char* bufptr = buffer;
-        while (remaining_to_write) {
-            ssize_t nwritten = ::write(dst_fd, bufptr, remaining_to_write);
-            if (nwritten < 0)
-                return CopyError { OSError(errno), false };
-
-            VERIFY(nwritten > 0);
-            remaining_to_write -= nwritten;
-            bufptr += nwritten;
         }
     }
+#endif
 
-    // NOTE: We don't copy the set-uid and set-gid bits.
-    auto my_umask = umask(0);
-    umask(my_umask);
-    if (fchmod(dst_fd, (src_stat.st_mode & ~my_umask) & ~06000) < 0)
-        return CopyError { OSError(errno), false };
+    if (!contents_copied) {
+        // Whatever can't be sendfile()d is usually a pipe or a device, so make every read count.
+        constexpr size_t buffer_size = 1 * MiB;
+        auto* buffer = static_cast<u8*>(malloc(buffer_size));
+        if (!buffer)
+            return OSError(ENOMEM);
+        ScopeGuard free_buffer_guard([buffer] { free(buffer); });
+        for (;;) {
+            ssize_t nread = ::read(src_fd, buffer, buffer_size);
+            if (nread < 0)
+                return OSError(errno);
+            if (nread == 0)
+                break;
+            ssize_t remaining_to_write = nread;
+            u8* bufptr = buffer;
+            while (remaining_to_write) {
+                ssize_t nwritten = ::write(dst_fd, bufptr, remaining_to_write);
+                if (nwritten < 0)
+                    return OSError(errno);
+
+                VERIFY(nwritten > 0);
+                remaining_to_write -= nwritten;
+                bufptr += nwritten;
+            }
+        }
+    }
 
     return {};
 }
@@ -54,6 +54,9 @@ public:
     };
 
     static Result<void, CopyError> copy_file(const String& dst_path, const struct stat& src_stat, File& source);
+    // Copies the contents of one open file to another, but not its permissions. Unlike the other helpers, this
+    // doesn't create any Core::Objects or touch the umask, so it may be used on several threads at once.
+    static Result<void, OSError> copy_file_contents(int dst_fd, int src_fd, const struct stat& src_stat);
     static Result<void, CopyError> copy_directory(const String& dst_path, const String& src_path, const struct stat& src_stat, LinkMode = LinkMode::Disallowed);
     static Result<void, CopyError> copy_file_or_directory(const String& dst_path, const String& src_path, RecursionMode = RecursionMode::Allowed, LinkMode = LinkMode::Disallowed, AddDuplicateFileMarker = AddDuplicateFileMarker::Yes);
 
@@ -49,25 +49,8 @@ static String get_child_path_from_inode_index(const String& path, unsigned child
     return {};
 }
 
-BlockingFileWatcher::BlockingFileWatcher(const String& path)
-    : m_path(path)
-{
-    m_watcher_fd = watch_file(path.characters(), path.length());
-    VERIFY(m_watcher_fd != -1);
-}
-
-BlockingFileWatcher::~BlockingFileWatcher()
+static Optional<FileWatcherEvent> file_watcher_event_from(const InodeWatcherEvent& event, const String& path)
 {
-    close(m_watcher_fd);
-}
-
-Optional<FileWatcherEvent> BlockingFileWatcher::wait_for_event()
-{
-    InodeWatcherEvent event {};
-    int rc = read(m_watcher_fd, &event, sizeof(event));
-    if (rc <= 0)
-        return {};
-
     FileWatcherEvent result;
     if (event.type == InodeWatcherEvent::Type::ChildAdded)
         result.type = FileWatcherEvent::Type::ChildAdded;
@@ -78,8 +61,9 @@ Optional<FileWatcherEvent> BlockingFileWatcher::wait_for_event()
     else
         return {};
 
+    result.path = path;
     if (result.type == FileWatcherEvent::Type::ChildAdded || result.type == FileWatcherEvent::Type::ChildRemoved) {
-        auto child_path = get_child_path_from_inode_index(m_path, event.inode_index);
+        auto child_path = get_child_path_from_inode_index(path, event.inode_index);
         if (!LexicalPath(child_path).is_valid())
             return {};
 
@@ -89,7 +73,29 @@ Optional<FileWatcherEvent> BlockingFileWatcher::wait_for_event()
     return result;
 }
 
-Result<NonnullRefPtr<FileWatcher>, String> FileWatcher::watch(const String& path)
+BlockingFileWatcher::BlockingFileWatcher(const String& path)
+    : m_path(path)
+{
+    m_watcher_fd = watch_file(path.characters(), path.length());
+    VERIFY(m_watcher_fd != -1);
+}
+
+BlockingFileWatcher::~BlockingFileWatcher()
+{
+    close(m_watcher_fd);
+}
+
+Optional<FileWatcherEvent> BlockingFileWatcher::wait_for_event()
+{
+    InodeWatcherEvent event {};
+    int rc = read(m_watcher_fd, &event, sizeof(event));
+    if (rc <= 0)
+        return {};
+
+    return file_watcher_event_from(event, m_path);
+}
+
+Result<NonnullRefPtr<FileWatcher>, String> FileWatcher::watch(const String& path, Recursive recursive)
 {
     auto watch_fd = watch_file(path.characters(), path.length());
     if (watch_fd < 0) {
@@ -103,40 +109,36 @@ Result<NonnullRefPtr<FileWatcher>, String> FileWatcher::watch(const String& path
 
     dbgln_if(FILE_WATCHER_DEBUG, "Started watcher for file '{}'", path.characters());
     auto notifier = Notifier::construct(watch_fd, Notifier::Event::Read);
-    return adopt_ref(*new FileWatcher(move(notifier), move(path)));
+    auto watcher = adopt_ref(*new FileWatcher(move(notifier)));
+    // The watch that watch_file() sets up is always the first one.
+    watcher->did_add_watch(1, path, recursive);
+    return watcher;
 }
 
-FileWatcher::FileWatcher(NonnullRefPtr<Notifier> notifier, const String& path)
+FileWatcher::FileWatcher(NonnullRefPtr<Notifier> notifier)
     : m_notifier(move(notifier))
-    , m_path(path)
 {
     m_notifier->on_ready_to_read = [this] {
-        InodeWatcherEvent event {};
-        int rc = read(m_notifier->fd(), &event, sizeof(event));
+        // The kernel hands out as many events as fit, so bursts are picked up in one go.
+        InodeWatcherEvent events[32];
+        int rc = read(m_notifier->fd(), events, sizeof(events));
         if (rc <= 0)
             return;
 
-        FileWatcherEvent result;
-        if (event.type == InodeWatcherEvent::Type::ChildAdded) {
-            result.type = FileWatcherEvent::Type::ChildAdded;
-        } else if (event.type == InodeWatcherEvent::Type::ChildRemoved) {
-            result.type = FileWatcherEvent::Type::ChildRemoved;
-        } else if (event.type == InodeWatcherEvent::Type::Modified) {
-            result.type = FileWatcherEvent::Type::Modified;
-        } else {
-            warnln("Unknown event type {} returned by the watch_file descriptor for {}", (unsigned)event.type, m_path.characters());
-            return;
+        for (size_t i = 0; i < rc / sizeof(InodeWatcherEvent); ++i) {
+            auto& event = events[i];
+            auto it = m_watches.find(event.watch_descriptor);
+            // Events for a watch that was just removed may still be queued up.
+            if (it == m_watches.end())
+                continue;
+            auto result = file_watcher_event_from(event, it->value.path);
+            if (!result.has_value()) {
+                if (event.type != InodeWatcherEvent::Type::ChildAdded && event.type != InodeWatcherEvent::Type::ChildRemoved)
+                    warnln("Unknown event type {} returned by the watch_file descriptor for {}", (unsigned)event.type, it->value.path);
+                continue;
+            }
+            handle_event(event.watch_descriptor, result.release_value());
         }
-
-        if (result.type == FileWatcherEvent::Type::ChildAdded || result.type == FileWatcherEvent::Type::ChildRemoved) {
-            auto child_path = get_child_path_from_inode_index(m_path, event.inode_index);
-            if (!LexicalPath(child_path).is_valid())
-                return;
-
-            result.child_path = child_path;
-        }
-
-        on_change(result);
     };
 }
 
@@ -144,7 +146,81 @@ FileWatcher::~FileWatcher()
 {
     m_notifier->on_ready_to_read = nullptr;
     close(m_notifier->fd());
-    dbgln_if(FILE_WATCHER_DEBUG, "Ended watcher for file '{}'", m_path.characters());
+    dbgln_if(FILE_WATCHER_DEBUG, "Ended watcher for {} paths", m_watches.size());
+}
+
+Result<void, String> FileWatcher::add_watch(const String& path, Recursive recursive)
+{
+    int watch_descriptor = add_inode_watch(m_notifier->fd(), path.characters(), path.length());
+    if (watch_descriptor < 0)
+        return String::formatted("Could not watch file '{}' : {}", path.characters(), strerror(errno));
+
+    dbgln_if(FILE_WATCHER_DEBUG, "Started watching '{}'", path.characters());
+    did_add_watch(watch_descriptor, path, recursive);
+    return {};
+}
+
+bool FileWatcher::remove_watch(const String& path)
+{
+    auto watch_descriptor = m_watch_descriptors.get(path);
+    if (!watch_descriptor.has_value())
+        return false;
+
+    // A recursive watch takes the watches for the directories below it along.
+    if (m_watches.get(watch_descriptor.value())->recursive == Recursive::Yes) {
+        auto prefix = String::formatted("{}/", path);
+        Vector<String> paths_below;
+        for (auto& it : m_watch_descriptors) {
+            if (it.key.starts_with(prefix))
+                paths_below.append(it.key);
+        }
+        for (auto& path_below : paths_below) {
+            auto watch_descriptor_below = m_watch_descriptors.get(path_below).value();
+            m_watch_descriptors.remove(path_below);
+            remove_inode_watch(m_notifier->fd(), watch_descriptor_below);
+            m_watches.remove(watch_descriptor_below);
+        }
+    }
+
+    remove_inode_watch(m_notifier->fd(), watch_descriptor.value());
+    m_watches.remove(watch_descriptor.value());
+    m_watch_descriptors.remove(path);
+    dbgln_if(FILE_WATCHER_DEBUG, "Stopped watching '{}'", path.characters());
+    return true;
+}
+
+void FileWatcher::did_add_watch(int watch_descriptor, const String& path, Recursive recursive)
+{
+    m_watches.set(watch_descriptor, { path, recursive });
+    m_watch_descriptors.set(path, watch_descriptor);
+    if (recursive == Recursive::Yes)
+        add_watches_for_subdirectories(path);
+}
+
+void FileWatcher::add_watches_for_subdirectories(const String& path)
+{
+    DirIterator iterator(path, Core::DirIterator::SkipDots);
+    while (iterator.has_next()) {
+        auto child_path = iterator.next_full_path();
+        struct stat st = {};
+        if (lstat(child_path.characters(), &st) < 0 || !S_ISDIR(st.st_mode))
+            continue;
+        // Directories we can't watch are skipped, so one unreadable directory doesn't fail the whole tree.
+        (void)add_watch(child_path, Recursive::Yes);
+    }
+}
+
+void FileWatcher::handle_event(int watch_descriptor, FileWatcherEvent event)
+{
+    auto& watch = m_watches.find(watch_descriptor)->value;
+    if (watch.recursive == Recursive::Yes && event.type == FileWatcherEvent::Type::ChildAdded && !is_watching(event.child_path)) {
+        struct stat st = {};
+        if (lstat(event.child_path.characters(), &st) == 0 && S_ISDIR(st.st_mode))
+            (void)add_watch(event.child_path, Recursive::Yes);
+    }
+
+    if (on_change)
+        on_change(move(event));
 }
 
 #endif
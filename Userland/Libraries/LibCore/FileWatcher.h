@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/RefCounted.h>
@@ -24,6 +25,8 @@ struct FileWatcherEvent {
         ChildRemoved,
     };
     Type type;
+    // The watched path this event is about.
+    String path;
     String child_path;
 };
 
@@ -41,20 +44,41 @@ private:
     int m_watcher_fd { -1 };
 };
 
+// Watches any number of paths through a single file descriptor.
 class FileWatcher : public RefCounted<FileWatcher> {
     AK_MAKE_NONCOPYABLE(FileWatcher);
 
 public:
-    static Result<NonnullRefPtr<FileWatcher>, String> watch(const String& path);
+    // With Recursive::Yes, every directory below the path is watched as well, including ones that are created later.
+    enum class Recursive {
+        No,
+        Yes,
+    };
+
+    static Result<NonnullRefPtr<FileWatcher>, String> watch(const String& path, Recursive = Recursive::No);
     ~FileWatcher();
 
+    Result<void, String> add_watch(const String& path, Recursive = Recursive::No);
+    bool remove_watch(const String& path);
+    bool is_watching(const String& path) const { return m_watch_descriptors.contains(path); }
+
     Function<void(FileWatcherEvent)> on_change;
 
 private:
-    FileWatcher(NonnullRefPtr<Notifier>, const String& path);
+    explicit FileWatcher(NonnullRefPtr<Notifier>);
+
+    void did_add_watch(int watch_descriptor, const String& path, Recursive);
+    void add_watches_for_subdirectories(const String& path);
+    void handle_event(int watch_descriptor, FileWatcherEvent);
+
+    struct Watch {
+        String path;
+        Recursive recursive { Recursive::No };
+    };
 
     NonnullRefPtr<Notifier> m_notifier;
-    String m_path;
+    HashMap<int, Watch> m_watches;
+    HashMap<String, int> m_watch_descriptors;
 };
 
 }
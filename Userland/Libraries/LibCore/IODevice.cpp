@@ -5,6 +5,7 @@
  */
 
 #include <AK/ByteBuffer.h>
+#include <AK/MemMem.h>
 #include <AK/PrintfImplementation.h>
 #include <LibCore/IODevice.h>
 #include <errno.h>
@@ -108,14 +109,14 @@ bool IODevice::can_read_line() const
 {
     if (m_eof && !m_buffered_data.is_empty())
         return true;
-    if (m_buffered_data.contains_slow('\n'))
+    if (find_byte(m_buffered_data.span(), '\n').has_value())
         return true;
     if (!can_read_from_fd())
         return false;
     populate_read_buffer();
     if (m_eof && !m_buffered_data.is_empty())
         return true;
-    return m_buffered_data.contains_slow('\n');
+    return find_byte(m_buffered_data.span(), '\n').has_value();
 }
 
 bool IODevice::can_read() const
@@ -174,20 +175,13 @@ String IODevice::read_line(size_t max_size)
         m_buffered_data.clear();
         return line;
     }
-    auto line = ByteBuffer::create_uninitialized(max_size + 1);
-    size_t line_index = 0;
-    while (line_index < max_size) {
-        u8 ch = m_buffered_data[line_index];
-        line[line_index++] = ch;
-        if (ch == '\n') {
-            Vector<u8> new_buffered_data;
-            new_buffered_data.append(m_buffered_data.data() + line_index, m_buffered_data.size() - line_index);
-            m_buffered_data = move(new_buffered_data);
-            line.trim(line_index);
-            return String::copy(line, Chomp);
-        }
-    }
-    return {};
+    auto newline_index = find_byte(m_buffered_data.span().trim(max_size), '\n');
+    if (!newline_index.has_value())
+        return {};
+    auto line_length = newline_index.value() + 1;
+    auto line = String((const char*)m_buffered_data.data(), line_length, Chomp);
+    m_buffered_data.remove(0, line_length);
+    return line;
 }
 
 bool IODevice::populate_read_buffer() const
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCore/IODevice.h>
+#include <LibCore/IOQueue.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifdef __serenity__
+#    include <serenity.h>
+#endif
+
+namespace Core {
+
+OwnPtr<IOQueue> IOQueue::create(u32 entry_count)
+{
+    if (entry_count == 0 || entry_count > IORing::max_entry_count || (entry_count & (entry_count - 1)) != 0) {
+        errno = EINVAL;
+        return {};
+    }
+
+    size_t size = io_ring_size(entry_count);
+    auto* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (memory == MAP_FAILED)
+        return {};
+
+    auto* ring = reinterpret_cast<IORing*>(memory);
+    ring->entry_count = entry_count;
+    return adopt_own(*new IOQueue(ring, size));
+}
+
+IOQueue::IOQueue(IORing* ring, size_t size)
+    : m_ring(ring)
+    , m_size(size)
+{
+}
+
+IOQueue::~IOQueue()
+{
+    munmap(m_ring, m_size);
+}
+
+bool IOQueue::submit(Syscall::Function function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3, u64 user_data, u32 flags)
+{
+    if (pending_submission_count() == m_ring->entry_count)
+        return false;
+    auto& submission = submissions()[m_ring->submission_tail & (m_ring->entry_count - 1)];
+    submission.function = function;
+    submission.flags = flags;
+    submission.arguments[0] = arg1;
+    submission.arguments[1] = arg2;
+    submission.arguments[2] = arg3;
+    submission.user_data = user_data;
+    ++m_ring->submission_tail;
+    return true;
+}
+
+bool IOQueue::submit_read(int fd, Bytes buffer, u64 user_data, u32 flags)
+{
+    return submit(Syscall::SC_read, fd, (FlatPtr)buffer.data(), buffer.size(), user_data, flags);
+}
+
+bool IOQueue::submit_write(int fd, ReadonlyBytes buffer, u64 user_data, u32 flags)
+{
+    return submit(Syscall::SC_write, fd, (FlatPtr)buffer.data(), buffer.size(), user_data, flags);
+}
+
+bool IOQueue::submit_read(IODevice& device, Bytes buffer, u64 user_data, u32 flags)
+{
+    return submit_read(device.fd(), buffer, user_data, flags);
+}
+
+bool IOQueue::submit_write(IODevice& device, ReadonlyBytes buffer, u64 user_data, u32 flags)
+{
+    return submit_write(device.fd(), buffer, user_data, flags);
+}
+
+bool IOQueue::submit_fstat(int fd, struct stat& buffer, u64 user_data, u32 flags)
+{
+    return submit(Syscall::SC_fstat, fd, (FlatPtr)&buffer, 0, user_data, flags);
+}
+
+bool IOQueue::submit_close(int fd, u64 user_data, u32 flags)
+{
+    return submit(Syscall::SC_close, fd, 0, 0, user_data, flags);
+}
+
+int IOQueue::flush()
+{
+    if (pending_submission_count() == 0)
+        return 0;
+#ifdef __serenity__
+    return io_ring_enter(m_ring);
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
+
+Optional<IORingCompletion> IOQueue::take_completion()
+{
+    if (m_ring->completion_head == m_ring->completion_tail)
+        return {};
+    auto completion = completions()[m_ring->completion_head & (m_ring->entry_count - 1)];
+    ++m_ring->completion_head;
+    return completion;
+}
+
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
+#include <AK/Span.h>
+#include <Kernel/API/IORing.h>
+#include <Kernel/API/Syscall.h>
+#include <LibCore/Forward.h>
+
+struct stat;
+
+namespace Core {
+
+// Queues up syscalls in an io_ring shared with the kernel, so a whole batch of them
+// only costs a single trap. Submissions run in the order they were queued.
+class IOQueue {
+    AK_MAKE_NONCOPYABLE(IOQueue);
+    AK_MAKE_NONMOVABLE(IOQueue);
+
+public:
+    static OwnPtr<IOQueue> create(u32 entry_count = 64);
+    ~IOQueue();
+
+    // These return false when the submission ring is full, flush() to make room.
+    bool submit(Syscall::Function, FlatPtr arg1, FlatPtr arg2, FlatPtr arg3, u64 user_data, u32 flags = 0);
+    bool submit_read(int fd, Bytes, u64 user_data, u32 flags = 0);
+    bool submit_write(int fd, ReadonlyBytes, u64 user_data, u32 flags = 0);
+    bool submit_read(IODevice&, Bytes, u64 user_data, u32 flags = 0);
+    bool submit_write(IODevice&, ReadonlyBytes, u64 user_data, u32 flags = 0);
+    bool submit_fstat(int fd, struct stat&, u64 user_data, u32 flags = 0);
+    bool submit_close(int fd, u64 user_data, u32 flags = 0);
+
+    u32 pending_submission_count() const { return m_ring->submission_tail - m_ring->submission_head; }
+
+    // Hands everything queued so far to the kernel. Returns how many submissions
+    // were run, or -1 with errno set.
+    int flush();
+
+    Optional<IORingCompletion> take_completion();
+
+private:
+    IOQueue(IORing*, size_t size);
+
+    IORingSubmission* submissions() { return reinterpret_cast<IORingSubmission*>(m_ring + 1); }
+    IORingCompletion* completions() { return reinterpret_cast<IORingCompletion*>(submissions() + m_ring->entry_count); }
+
+    IORing* m_ring { nullptr };
+    size_t m_size { 0 };
+};
+
+}
@@ -7,10 +7,12 @@
 #include <LibCore/LocalSocket.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 #ifndef SOCK_NONBLOCK
 #    include <sys/ioctl.h>
@@ -56,6 +58,7 @@ LocalSocket::~LocalSocket()
 
 HashMap<String, int> LocalSocket::s_overtaken_sockets {};
 bool LocalSocket::s_overtaken_sockets_parsed { false };
+int LocalSocket::s_prespawned_notify_fd { -1 };
 
 void LocalSocket::parse_sockets_from_system_server()
 {
@@ -77,6 +80,42 @@ void LocalSocket::parse_sockets_from_system_server()
     // We wouldn't want our children to think we're passing
     // them a socket either, so unset the env variable.
     unsetenv(socket_takeover);
+
+    constexpr auto socket_takeover_prespawned = "SOCKET_TAKEOVER_PRESPAWNED";
+    if (const char* notify_fd = getenv(socket_takeover_prespawned)) {
+        s_prespawned_notify_fd = strtol(notify_fd, nullptr, 10);
+        unsetenv(socket_takeover_prespawned);
+    }
+}
+
+int LocalSocket::accept_client_for_system_server(int listening_fd)
+{
+    // The listening socket is shared with SystemServer and any other pre-spawned instances, and non-blocking,
+    // so wait for a client to show up and try to be the one to accept it.
+    for (;;) {
+        pollfd poll_fd { listening_fd, POLLIN, 0 };
+        if (poll(&poll_fd, 1, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            return -1;
+        }
+        int client_fd = accept(listening_fd, nullptr, nullptr);
+        if (client_fd >= 0) {
+            // Tell SystemServer to spawn our replacement.
+            char accepted = 1;
+            if (::write(s_prespawned_notify_fd, &accepted, sizeof(accepted)) < 0)
+                perror("write");
+            ::close(s_prespawned_notify_fd);
+            s_prespawned_notify_fd = -1;
+            ::close(listening_fd);
+            return client_fd;
+        }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) {
+            perror("accept");
+            return -1;
+        }
+    }
 }
 
 RefPtr<LocalSocket> LocalSocket::take_over_accepted_socket_from_system_server(String const& socket_path)
@@ -108,6 +147,13 @@ RefPtr<LocalSocket> LocalSocket::take_over_accepted_socket_from_system_server(St
         return nullptr;
     }
 
+    // We were spawned ahead of time, so our client has yet to connect.
+    if (s_prespawned_notify_fd >= 0) {
+        fd = accept_client_for_system_server(fd);
+        if (fd < 0)
+            return nullptr;
+    }
+
     auto socket = LocalSocket::construct(fd);
 
     // It had to be !CLOEXEC for obvious reasons, but we
@@ -26,9 +26,12 @@ private:
     friend class LocalServer;
 
     static void parse_sockets_from_system_server();
+    static int accept_client_for_system_server(int listening_fd);
 
     static HashMap<String, int> s_overtaken_sockets;
     static bool s_overtaken_sockets_parsed;
+    // For pre-spawned instances, the pipe to let SystemServer know we've accepted our client through.
+    static int s_prespawned_notify_fd;
 };
 
 }
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/FlatMap.h>
 #include <AK/Forward.h>
 #include <AK/HashMap.h>
 #include <AK/IntrusiveList.h>
@@ -102,7 +103,7 @@ public:
 
     bool set_property(String const& name, const JsonValue& value);
     JsonValue property(String const& name) const;
-    const HashMap<String, NonnullOwnPtr<Property>>& properties() const { return m_properties; }
+    const FlatMap<String, NonnullOwnPtr<Property>>& properties() const { return m_properties; }
 
     static IntrusiveList<Object, RawPtr<Object>, &Object::m_all_objects_list_node>& all_objects();
 
@@ -150,7 +151,7 @@ private:
     String m_name;
     int m_timer_id { 0 };
     unsigned m_inspector_count { 0 };
-    HashMap<String, NonnullOwnPtr<Property>> m_properties;
+    FlatMap<String, NonnullOwnPtr<Property>> m_properties;
     NonnullRefPtrVector<Object> m_children;
     Function<bool(Core::Event&)> m_event_filter;
 };
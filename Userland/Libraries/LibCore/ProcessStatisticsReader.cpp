@@ -5,96 +5,149 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <Kernel/API/ProcessStatistics.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
 #include <stdio.h>
+#include <string.h>
 
 namespace Core {
 
 HashMap<uid_t, String> ProcessStatisticsReader::s_usernames;
 
-Optional<HashMap<pid_t, Core::ProcessStatistics>> ProcessStatisticsReader::get_all(RefPtr<Core::File>& proc_all_file)
+namespace {
+
+class SnapshotReader {
+public:
+    explicit SnapshotReader(ReadonlyBytes bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    // Copies a record of `size` bytes into `record`, zero-filling fields the kernel didn't send
+    // and skipping over any the reader doesn't know about.
+    template<typename T>
+    bool read_record(T& record, size_t size)
+    {
+        if (m_offset + size > m_bytes.size())
+            return false;
+        memset(&record, 0, sizeof(T));
+        memcpy(&record, m_bytes.offset_pointer(m_offset), min(size, sizeof(T)));
+        m_offset += size;
+        return true;
+    }
+
+    bool read_string(String& string)
+    {
+        u16 length;
+        if (!read_record(length, sizeof(length)))
+            return false;
+        if (m_offset + length > m_bytes.size())
+            return false;
+        string = String(reinterpret_cast<const char*>(m_bytes.offset_pointer(m_offset)), length);
+        m_offset += length;
+        return true;
+    }
+
+private:
+    ReadonlyBytes m_bytes;
+    size_t m_offset { 0 };
+};
+
+}
+
+Optional<HashMap<pid_t, Core::ProcessStatistics>> ProcessStatisticsReader::get_all(RefPtr<Core::File>& proc_processes_file)
 {
-    if (proc_all_file) {
-        if (!proc_all_file->seek(0, Core::File::SeekMode::SetPosition)) {
-            fprintf(stderr, "ProcessStatisticsReader: Failed to refresh /proc/all: %s\n", proc_all_file->error_string());
+    if (proc_processes_file) {
+        if (!proc_processes_file->seek(0, Core::File::SeekMode::SetPosition)) {
+            fprintf(stderr, "ProcessStatisticsReader: Failed to refresh /proc/processes: %s\n", proc_processes_file->error_string());
             return {};
         }
     } else {
-        proc_all_file = Core::File::construct("/proc/all");
-        if (!proc_all_file->open(Core::IODevice::ReadOnly)) {
-            fprintf(stderr, "ProcessStatisticsReader: Failed to open /proc/all: %s\n", proc_all_file->error_string());
+        proc_processes_file = Core::File::construct("/proc/processes");
+        if (!proc_processes_file->open(Core::IODevice::ReadOnly)) {
+            fprintf(stderr, "ProcessStatisticsReader: Failed to open /proc/processes: %s\n", proc_processes_file->error_string());
             return {};
         }
     }
 
-    HashMap<pid_t, Core::ProcessStatistics> map;
+    auto file_contents = proc_processes_file->read_all();
+    SnapshotReader reader(file_contents.bytes());
 
-    auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (!json.has_value())
+    ProcessStatisticsHeader header;
+    if (!reader.read_record(header, sizeof(header)) || header.magic != PROCESS_STATISTICS_MAGIC) {
+        fprintf(stderr, "ProcessStatisticsReader: /proc/processes is not a process statistics snapshot\n");
         return {};
-    json.value().as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
+    }
+
+    HashMap<pid_t, Core::ProcessStatistics> map;
+    map.ensure_capacity(header.process_count);
+
+    for (u32 i = 0; i < header.process_count; ++i) {
+        ProcessStatisticsRecord record;
         Core::ProcessStatistics process;
+        if (!reader.read_record(record, header.process_record_size)
+            || !reader.read_string(process.name)
+            || !reader.read_string(process.executable)
+            || !reader.read_string(process.tty)
+            || !reader.read_string(process.pledge)
+            || !reader.read_string(process.veil))
+            return {};
 
         // kernel data first
-        process.pid = process_object.get("pid").to_u32();
-        process.pgid = process_object.get("pgid").to_u32();
-        process.pgp = process_object.get("pgp").to_u32();
-        process.sid = process_object.get("sid").to_u32();
-        process.uid = process_object.get("uid").to_u32();
-        process.gid = process_object.get("gid").to_u32();
-        process.ppid = process_object.get("ppid").to_u32();
-        process.nfds = process_object.get("nfds").to_u32();
-        process.kernel = process_object.get("kernel").to_bool();
-        process.name = process_object.get("name").to_string();
-        process.executable = process_object.get("executable").to_string();
-        process.tty = process_object.get("tty").to_string();
-        process.pledge = process_object.get("pledge").to_string();
-        process.veil = process_object.get("veil").to_string();
-        process.amount_virtual = process_object.get("amount_virtual").to_u32();
-        process.amount_resident = process_object.get("amount_resident").to_u32();
-        process.amount_shared = process_object.get("amount_shared").to_u32();
-        process.amount_dirty_private = process_object.get("amount_dirty_private").to_u32();
-        process.amount_clean_inode = process_object.get("amount_clean_inode").to_u32();
-        process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile").to_u32();
-        process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile").to_u32();
-
-        auto& thread_array = process_object.get_ptr("threads")->as_array();
-        process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
+        process.pid = record.pid;
+        process.pgid = record.pgid;
+        process.pgp = record.pgp;
+        process.sid = record.sid;
+        process.uid = record.uid;
+        process.gid = record.gid;
+        process.ppid = record.ppid;
+        process.nfds = record.nfds;
+        process.kernel = record.kernel;
+        process.amount_virtual = record.amount_virtual;
+        process.amount_resident = record.amount_resident;
+        process.amount_shared = record.amount_shared;
+        process.amount_dirty_private = record.amount_dirty_private;
+        process.amount_clean_inode = record.amount_clean_inode;
+        process.amount_purgeable_volatile = record.amount_purgeable_volatile;
+        process.amount_purgeable_nonvolatile = record.amount_purgeable_nonvolatile;
+
+        process.threads.ensure_capacity(record.thread_count);
+        for (u32 j = 0; j < record.thread_count; ++j) {
+            ThreadStatisticsRecord thread_record;
             Core::ThreadStatistics thread;
-            thread.tid = thread_object.get("tid").to_u32();
-            thread.times_scheduled = thread_object.get("times_scheduled").to_u32();
-            thread.name = thread_object.get("name").to_string();
-            thread.state = thread_object.get("state").to_string();
-            thread.ticks_user = thread_object.get("ticks_user").to_u32();
-            thread.ticks_kernel = thread_object.get("ticks_kernel").to_u32();
-            thread.cpu = thread_object.get("cpu").to_u32();
-            thread.priority = thread_object.get("priority").to_u32();
-            thread.syscall_count = thread_object.get("syscall_count").to_u32();
-            thread.inode_faults = thread_object.get("inode_faults").to_u32();
-            thread.zero_faults = thread_object.get("zero_faults").to_u32();
-            thread.cow_faults = thread_object.get("cow_faults").to_u32();
-            thread.unix_socket_read_bytes = thread_object.get("unix_socket_read_bytes").to_u32();
-            thread.unix_socket_write_bytes = thread_object.get("unix_socket_write_bytes").to_u32();
-            thread.ipv4_socket_read_bytes = thread_object.get("ipv4_socket_read_bytes").to_u32();
-            thread.ipv4_socket_write_bytes = thread_object.get("ipv4_socket_write_bytes").to_u32();
-            thread.file_read_bytes = thread_object.get("file_read_bytes").to_u32();
-            thread.file_write_bytes = thread_object.get("file_write_bytes").to_u32();
-            process.threads.append(move(thread));
-        });
+            if (!reader.read_record(thread_record, header.thread_record_size)
+                || !reader.read_string(thread.name)
+                || !reader.read_string(thread.state))
+                return {};
+            thread.tid = thread_record.tid;
+            thread.times_scheduled = thread_record.times_scheduled;
+            thread.ticks_user = thread_record.ticks_user;
+            thread.ticks_kernel = thread_record.ticks_kernel;
+            thread.cpu = thread_record.cpu;
+            thread.priority = thread_record.priority;
+            thread.syscall_count = thread_record.syscall_count;
+            thread.inode_faults = thread_record.inode_faults;
+            thread.zero_faults = thread_record.zero_faults;
+            thread.cow_faults = thread_record.cow_faults;
+            thread.unix_socket_read_bytes = thread_record.unix_socket_read_bytes;
+            thread.unix_socket_write_bytes = thread_record.unix_socket_write_bytes;
+            thread.ipv4_socket_read_bytes = thread_record.ipv4_socket_read_bytes;
+            thread.ipv4_socket_write_bytes = thread_record.ipv4_socket_write_bytes;
+            thread.file_read_bytes = thread_record.file_read_bytes;
+            thread.file_write_bytes = thread_record.file_write_bytes;
+            thread.block_read_requests = thread_record.block_read_requests;
+            thread.block_read_bytes = thread_record.block_read_bytes;
+            thread.block_write_requests = thread_record.block_write_requests;
+            thread.block_write_bytes = thread_record.block_write_bytes;
+            process.threads.unchecked_append(move(thread));
+        }
 
         // and synthetic data last
         process.username = username_from_uid(process.uid);
-        map.set(process.pid, process);
-    });
+        map.set(process.pid, move(process));
+    }
 
     return map;
 }
@@ -28,6 +28,10 @@ struct ThreadStatistics {
     unsigned ipv4_socket_write_bytes;
     unsigned file_read_bytes;
     unsigned file_write_bytes;
+    u64 block_read_requests;
+    u64 block_read_bytes;
+    u64 block_write_requests;
+    u64 block_write_bytes;
     String state;
     u32 cpu;
     u32 priority;
@@ -35,7 +39,7 @@ struct ThreadStatistics {
 };
 
 struct ProcessStatistics {
-    // Keep this in sync with /proc/all.
+    // Keep this in sync with Kernel/API/ProcessStatistics.h.
     // From the kernel side:
     pid_t pid;
     pid_t pgid;
@@ -9,6 +9,7 @@
 #include <LibCore/Notifier.h>
 #include <LibCore/TCPServer.h>
 #include <LibCore/TCPSocket.h>
+#include <errno.h>
 #include <stdio.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -56,12 +57,24 @@ bool TCPServer::listen(const IPv4Address& address, u16 port)
     }
     m_listening = true;
 
+    setup_notifier();
+    return true;
+}
+
+void TCPServer::setup_notifier()
+{
     m_notifier = Notifier::construct(m_fd, Notifier::Event::Read, this);
     m_notifier->on_ready_to_read = [this] {
         if (on_ready_to_accept)
             on_ready_to_accept();
     };
-    return true;
+}
+
+void TCPServer::resume_listening_after_fork()
+{
+    VERIFY(m_listening);
+    m_notifier->remove_from_parent();
+    setup_notifier();
 }
 
 RefPtr<TCPSocket> TCPServer::accept()
@@ -71,7 +84,9 @@ RefPtr<TCPSocket> TCPServer::accept()
     socklen_t in_size = sizeof(in);
     int accepted_fd = ::accept(m_fd, (sockaddr*)&in, &in_size);
     if (accepted_fd < 0) {
-        perror("accept");
+        // Another process sharing the socket may have taken the connection first.
+        if (errno != EAGAIN)
+            perror("accept");
         return nullptr;
     }
 
@@ -19,6 +19,8 @@ public:
 
     bool is_listening() const { return m_listening; }
     bool listen(const IPv4Address& address, u16 port);
+    // A forked child starts out with an empty event loop, so it has to watch the listening socket it inherited again.
+    void resume_listening_after_fork();
 
     RefPtr<TCPSocket> accept();
 
@@ -30,6 +32,8 @@ public:
 private:
     explicit TCPServer(Object* parent = nullptr);
 
+    void setup_notifier();
+
     int m_fd { -1 };
     bool m_listening { false };
     RefPtr<Notifier> m_notifier;
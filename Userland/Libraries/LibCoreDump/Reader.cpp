@@ -18,12 +18,13 @@ OwnPtr<Reader> Reader::create(const String& path)
     auto file_or_error = MappedFile::map(path);
     if (file_or_error.is_error())
         return {};
-    return adopt_own(*new Reader(file_or_error.value()->bytes()));
+    return adopt_own(*new Reader(file_or_error.release_value()));
 }
 
-Reader::Reader(ReadonlyBytes coredump_bytes)
-    : m_coredump_buffer(decompress_coredump(coredump_bytes))
-    , m_coredump_image(m_coredump_buffer.bytes())
+Reader::Reader(NonnullRefPtr<MappedFile> coredump_file)
+    : m_coredump_file(move(coredump_file))
+    , m_coredump_buffer(decompress_coredump(m_coredump_file->bytes()))
+    , m_coredump_image(m_coredump_buffer.is_empty() ? m_coredump_file->bytes() : m_coredump_buffer.bytes())
 {
     size_t index = 0;
     m_coredump_image.for_each_program_header([this, &index](auto pheader) {
@@ -40,11 +41,11 @@ Reader::Reader(ReadonlyBytes coredump_bytes)
 ByteBuffer Reader::decompress_coredump(const ReadonlyBytes& raw_coredump)
 {
     if (!Compress::GzipDecompressor::is_likely_compressed(raw_coredump))
-        return ByteBuffer::copy(raw_coredump); // handle old format core dumps (uncompressed)
+        return {};
     auto decompressed_coredump = Compress::GzipDecompressor::decompress_all(raw_coredump);
     if (!decompressed_coredump.has_value())
-        return ByteBuffer::copy(raw_coredump); // if we didn't manage to decompress it, try and parse it as decompressed core dump
-    return decompressed_coredump.value();
+        return {}; // if we didn't manage to decompress it, try and parse it as decompressed core dump
+    return decompressed_coredump.release_value();
 }
 
 Reader::~Reader()
@@ -112,9 +113,17 @@ Optional<uint32_t> Reader::peek_memory(FlatPtr address) const
     if (!region)
         return {};
 
-    FlatPtr offset_in_region = address - region->region_start;
-    const char* region_data = image().program_header(region->program_header_index).raw_data();
-    return *(const uint32_t*)(&region_data[offset_in_region]);
+    // Zero pages at either end of a region are left out of the dump, which the program header covers by starting
+    // later, and being shorter in the file than in memory.
+    auto program_header = image().program_header(region->program_header_index);
+    auto segment_start = program_header.vaddr().get();
+    if (address < segment_start || address - segment_start >= program_header.size_in_image())
+        return 0;
+
+    FlatPtr offset_in_segment = address - segment_start;
+    uint32_t value = 0;
+    memcpy(&value, program_header.raw_data() + offset_in_segment, min(sizeof(value), program_header.size_in_image() - offset_in_segment));
+    return value;
 }
 
 const JsonObject Reader::process_info() const
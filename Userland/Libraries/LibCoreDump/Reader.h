@@ -50,8 +50,9 @@ public:
     HashMap<String, String> metadata() const;
 
 private:
-    Reader(ReadonlyBytes);
+    Reader(NonnullRefPtr<MappedFile>);
 
+    // Returns an empty buffer for core dumps that aren't compressed, which are used right from the mapped file.
     static ByteBuffer decompress_coredump(const ReadonlyBytes&);
 
     class NotesEntryIterator {
@@ -74,6 +75,7 @@ private:
     // as getters with the appropriate (non-JsonValue) types.
     const JsonObject process_info() const;
 
+    NonnullRefPtr<MappedFile> m_coredump_file;
     ByteBuffer m_coredump_buffer;
     ELF::Image m_coredump_image;
     ssize_t m_notes_segment_index { -1 };
@@ -207,12 +207,33 @@ static bool is_known_type(const StringView& string)
 Vector<Token> Lexer::lex()
 {
     Vector<Token> tokens;
+    lex_iterable([&](auto token, bool) {
+        tokens.append(move(token));
+        return IterationDecision::Continue;
+    });
+    return tokens;
+}
+
+void Lexer::lex_iterable(Function<IterationDecision(Token, bool is_restart_point)> callback)
+{
+    bool is_stopped = false;
+    // Nothing but the position in the input carries over from one run through the loop below to the next, so lexing
+    // could start over at the first token of each run.
+    bool is_restart_point = true;
+
+    auto emit = [&](Token token) {
+        if (is_stopped)
+            return;
+        if (callback(move(token), is_restart_point) == IterationDecision::Break)
+            is_stopped = true;
+        is_restart_point = false;
+    };
 
     size_t token_start_index = 0;
     Position token_start_position;
 
     auto emit_single_char_token = [&](auto type) {
-        tokens.empend(type, m_position, m_position, m_input.substring_view(m_index, 1));
+        emit(Token(type, m_position, m_position, m_input.substring_view(m_index, 1)));
         consume();
     };
 
@@ -221,7 +242,7 @@ Vector<Token> Lexer::lex()
         token_start_position = m_position;
     };
     auto commit_token = [&](auto type) {
-        tokens.empend(type, token_start_position, m_previous_position, m_input.substring_view(token_start_index, m_index - token_start_index));
+        emit(Token(type, token_start_position, m_previous_position, m_input.substring_view(token_start_index, m_index - token_start_index)));
     };
 
     auto emit_token_equals = [&](auto type, auto equals_type) {
@@ -305,7 +326,8 @@ Vector<Token> Lexer::lex()
         return 0;
     };
 
-    while (m_index < m_input.length()) {
+    while (m_index < m_input.length() && !is_stopped) {
+        is_restart_point = true;
         auto ch = peek();
         if (isspace(ch)) {
             begin_token();
@@ -760,7 +782,6 @@ Vector<Token> Lexer::lex()
         dbgln("Unimplemented token character: {}", ch);
         emit_single_char_token(Token::Type::Unknown);
     }
-    return tokens;
 }
 
 }
@@ -7,6 +7,8 @@
 #pragma once
 
 #include "LibCpp/Token.h"
+#include <AK/Function.h>
+#include <AK/IterationDecision.h>
 #include <AK/StringView.h>
 #include <AK/Vector.h>
 
@@ -18,6 +20,10 @@ public:
 
     Vector<Token> lex();
 
+    // Calls back for each token, and tells whether lexing the input from the start of that token on would give the
+    // same tokens from there, as it does for most tokens. Returning IterationDecision::Break stops lexing.
+    void lex_iterable(Function<IterationDecision(Token, bool is_restart_point)>);
+
 private:
     char peek(size_t offset = 0) const;
     char consume();
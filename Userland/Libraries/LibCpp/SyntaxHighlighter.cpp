@@ -57,12 +57,18 @@ bool SyntaxHighlighter::is_navigatable(void* token) const
 
 void SyntaxHighlighter::rehighlight(const Palette& palette)
 {
-    auto text = m_client->get_text();
-    Cpp::Lexer lexer(text);
-    auto tokens = lexer.lex();
+    relex_changed_lines(palette);
+
+    m_has_brace_buddies = false;
+    highlight_matching_token_pair();
 
-    Vector<GUI::TextDocumentSpan> spans;
-    for (auto& token : tokens) {
+    m_client->do_update();
+}
+
+void SyntaxHighlighter::lex_for_highlighting(const StringView& text, const Palette& palette, SpanCallback callback)
+{
+    Cpp::Lexer lexer(text);
+    lexer.lex_iterable([&](auto token, bool is_restart_point) {
         dbgln_if(SYNTAX_HIGHLIGHTING_DEBUG, "{} @ {}:{} - {}:{}", token.to_string(), token.start().line, token.start().column, token.end().line, token.end().column);
         GUI::TextDocumentSpan span;
         span.range.set_start({ token.start().line, token.start().column });
@@ -72,14 +78,8 @@ void SyntaxHighlighter::rehighlight(const Palette& palette)
         span.attributes.bold = style.bold;
         span.is_skippable = token.type() == Cpp::Token::Type::Whitespace;
         span.data = reinterpret_cast<void*>(token.type());
-        spans.append(span);
-    }
-    m_client->do_set_spans(move(spans));
-
-    m_has_brace_buddies = false;
-    highlight_matching_token_pair();
-
-    m_client->do_update();
+        return callback(move(span), is_restart_point);
+    });
 }
 
 Vector<SyntaxHighlighter::MatchingTokenPair> SyntaxHighlighter::matching_token_pairs() const
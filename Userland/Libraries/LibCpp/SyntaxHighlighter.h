@@ -24,6 +24,7 @@ public:
 protected:
     virtual Vector<MatchingTokenPair> matching_token_pairs() const override;
     virtual bool token_types_equal(void*, void*) const override;
+    virtual void lex_for_highlighting(const StringView&, const Palette&, SpanCallback) override;
 };
 
 }
@@ -10,6 +10,11 @@
 #include <AK/Vector.h>
 #include <LibCrypto/Authentication/GHash.h>
 #include <LibCrypto/BigInt/UnsignedBigInteger.h>
+#include <LibCrypto/CPUFeatures.h>
+
+#if CRYPTO_HAS_X86_INTRINSICS
+#    include <wmmintrin.h>
+#endif
 
 namespace {
 
@@ -26,37 +31,195 @@ static void to_u8s(u8* b, const u32* w)
     }
 }
 
+// Reduction constants for the 4-bit table method, i.e. the contribution of each nibble shifted out of the bottom.
+static constexpr u16 s_last4[16] = {
+    0x0000, 0x1c20, 0x3840, 0x2460, 0x7080, 0x6ca0, 0x48c0, 0x54e0,
+    0xe100, 0xfd20, 0xd940, 0xc560, 0x9180, 0x8da0, 0xa9c0, 0xb5e0
+};
+
+#if CRYPTO_HAS_X86_INTRINSICS
+// Our words are big endian and GHASH is bit-reflected, so placing word 0 in the top lane
+// gives the byte-reversed form that the carry-less multiplication formulas want.
+[[gnu::target("sse2")]] static __m128i load_words(const u32* words)
+{
+    return _mm_set_epi32(words[0], words[1], words[2], words[3]);
+}
+
+[[gnu::target("sse2")]] static __m128i load_block(const u8* block)
+{
+    return _mm_set_epi32(to_u32(block), to_u32(block + 4), to_u32(block + 8), to_u32(block + 12));
+}
+
+[[gnu::target("sse2")]] static void store_words(u32* words, __m128i value)
+{
+    u32 lanes[4];
+    _mm_storeu_si128((__m128i*)lanes, value);
+    for (auto i = 0; i < 4; ++i)
+        words[i] = lanes[3 - i];
+}
+
+// 256-bit carry-less product of a and b, accumulated into (low, high).
+[[gnu::target("pclmul,sse2")]] static void accumulate_product(__m128i a, __m128i b, __m128i& low, __m128i& high)
+{
+    auto low_product = _mm_clmulepi64_si128(a, b, 0x00);
+    auto middle_product = _mm_xor_si128(_mm_clmulepi64_si128(a, b, 0x10), _mm_clmulepi64_si128(a, b, 0x01));
+    auto high_product = _mm_clmulepi64_si128(a, b, 0x11);
+    low = _mm_xor_si128(low, _mm_xor_si128(low_product, _mm_slli_si128(middle_product, 8)));
+    high = _mm_xor_si128(high, _mm_xor_si128(high_product, _mm_srli_si128(middle_product, 8)));
+}
+
+// Reduces a 256-bit product modulo x^128 + x^7 + x^2 + x + 1, compensating for the bit reflection.
+// See Intel's "Carry-Less Multiplication Instruction and its Usage for Computing the GCM Mode", algorithm 5.
+[[gnu::target("pclmul,sse2")]] static __m128i reduce(__m128i low, __m128i high)
+{
+    // Shift the product left by one bit.
+    auto low_carry = _mm_srli_epi32(low, 31);
+    auto high_carry = _mm_srli_epi32(high, 31);
+    low = _mm_slli_epi32(low, 1);
+    high = _mm_slli_epi32(high, 1);
+    auto crossing_carry = _mm_srli_si128(low_carry, 12);
+    high_carry = _mm_slli_si128(high_carry, 4);
+    low_carry = _mm_slli_si128(low_carry, 4);
+    low = _mm_or_si128(low, low_carry);
+    high = _mm_or_si128(_mm_or_si128(high, high_carry), crossing_carry);
+
+    auto a = _mm_xor_si128(_mm_xor_si128(_mm_slli_epi32(low, 31), _mm_slli_epi32(low, 30)), _mm_slli_epi32(low, 25));
+    auto b = _mm_srli_si128(a, 4);
+    low = _mm_xor_si128(low, _mm_slli_si128(a, 12));
+
+    auto c = _mm_xor_si128(_mm_xor_si128(_mm_srli_epi32(low, 1), _mm_srli_epi32(low, 2)), _mm_srli_epi32(low, 7));
+    c = _mm_xor_si128(c, b);
+    low = _mm_xor_si128(low, c);
+    return _mm_xor_si128(high, low);
+}
+
+[[gnu::target("pclmul,sse2")]] static void absorb_blocks_pclmul(u32 (&tag)[4], const u32 (&key)[4], const u32 (&key_powers)[3][4], const u8* blocks, size_t count)
+{
+    auto h1 = load_words(key);
+    auto h2 = load_words(key_powers[0]);
+    auto h3 = load_words(key_powers[1]);
+    auto h4 = load_words(key_powers[2]);
+    auto y = load_words(tag);
+
+    // ((((y + x0)H + x1)H + x2)H + x3)H = (y + x0)H^4 + x1H^3 + x2H^2 + x3H, with a single reduction.
+    for (; count >= 4; count -= 4, blocks += 64) {
+        auto low = _mm_setzero_si128();
+        auto high = _mm_setzero_si128();
+        accumulate_product(_mm_xor_si128(y, load_block(blocks)), h4, low, high);
+        accumulate_product(load_block(blocks + 16), h3, low, high);
+        accumulate_product(load_block(blocks + 32), h2, low, high);
+        accumulate_product(load_block(blocks + 48), h1, low, high);
+        y = reduce(low, high);
+    }
+
+    for (; count > 0; --count, blocks += 16) {
+        auto low = _mm_setzero_si128();
+        auto high = _mm_setzero_si128();
+        accumulate_product(_mm_xor_si128(y, load_block(blocks)), h1, low, high);
+        y = reduce(low, high);
+    }
+
+    store_words(tag, y);
+}
+#endif
+
 }
 
 namespace Crypto {
 namespace Authentication {
 
+GHash::GHash(const ReadonlyBytes& key)
+{
+    for (size_t i = 0; i < 16; i += 4)
+        m_key[i / 4] = to_u32(key.offset(i));
+
+    galois_multiply(m_key_powers[0], m_key, m_key);
+    galois_multiply(m_key_powers[1], m_key_powers[0], m_key);
+    galois_multiply(m_key_powers[2], m_key_powers[1], m_key);
+
+    // Entry 8 is H itself (the nibble 0b1000 is x^0 in GHASH's reflected bit order),
+    // 4, 2 and 1 are successive multiplications by x, and the rest are sums of those.
+    u64 high = ((u64)m_key[0] << 32) | m_key[1];
+    u64 low = ((u64)m_key[2] << 32) | m_key[3];
+    m_table_high[0] = 0;
+    m_table_low[0] = 0;
+    m_table_high[8] = high;
+    m_table_low[8] = low;
+    for (size_t i = 4; i > 0; i >>= 1) {
+        u64 reduction = (low & 1) ? 0xe100000000000000ull : 0;
+        low = (high << 63) | (low >> 1);
+        high = (high >> 1) ^ reduction;
+        m_table_high[i] = high;
+        m_table_low[i] = low;
+    }
+    for (size_t i = 2; i <= 8; i *= 2) {
+        for (size_t j = 1; j < i; ++j) {
+            m_table_high[i + j] = m_table_high[i] ^ m_table_high[j];
+            m_table_low[i + j] = m_table_low[i] ^ m_table_low[j];
+        }
+    }
+}
+
+void GHash::multiply_by_key(u32 (&tag)[4]) const
+{
+    u8 x[16];
+    to_u8s(x, tag);
+
+    u64 high = 0;
+    u64 low = 0;
+    auto shift_in = [&](size_t nibble, bool shift) {
+        if (shift) {
+            u8 remainder = low & 0xf;
+            low = (high << 60) | (low >> 4);
+            high = (high >> 4) ^ ((u64)s_last4[remainder] << 48);
+        }
+        high ^= m_table_high[nibble];
+        low ^= m_table_low[nibble];
+    };
+
+    for (ssize_t i = 15; i >= 0; --i) {
+        shift_in(x[i] & 0xf, i != 15);
+        shift_in(x[i] >> 4, true);
+    }
+
+    tag[0] = high >> 32;
+    tag[1] = high;
+    tag[2] = low >> 32;
+    tag[3] = low;
+}
+
+void GHash::absorb_blocks(u32 (&tag)[4], const u8* blocks, size_t count) const
+{
+#if CRYPTO_HAS_X86_INTRINSICS
+    if (has_cpu_feature(CPUFeature::PCLMUL)) {
+        absorb_blocks_pclmul(tag, m_key, m_key_powers, blocks, count);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < count; ++i, blocks += 16) {
+        for (auto j = 0; j < 4; ++j)
+            tag[j] ^= to_u32(blocks + j * 4);
+        multiply_by_key(tag);
+    }
+}
+
 GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 {
     u32 tag[4] { 0, 0, 0, 0 };
 
     auto transform_one = [&](auto& buf) {
-        size_t i = 0;
-        for (; i < buf.size(); i += 16) {
-            if (i + 16 <= buf.size()) {
-                for (auto j = 0; j < 4; ++j) {
-                    tag[j] ^= to_u32(buf.offset(i + j * 4));
-                }
-                galois_multiply(tag, m_key, tag);
-            }
-        }
+        auto full_blocks = buf.size() / 16;
+        absorb_blocks(tag, buf.data(), full_blocks);
 
-        if (i > buf.size()) {
-            static u8 buffer[16];
+        if (buf.size() % 16) {
+            u8 buffer[16];
             Bytes buffer_bytes { buffer, 16 };
             OutputMemoryStream stream { buffer_bytes };
-            stream.write(buf.slice(i - 16));
+            stream.write(buf.slice(full_blocks * 16));
             stream.fill_to_end(0);
 
-            for (auto j = 0; j < 4; ++j) {
-                tag[j] ^= to_u32(buffer_bytes.offset(j * 4));
-            }
-            galois_multiply(tag, m_key, tag);
+            absorb_blocks(tag, buffer, 1);
         }
     };
 
@@ -82,7 +245,7 @@ GHash::TagType GHash::process(ReadonlyBytes aad, ReadonlyBytes cipher)
 
     dbgln_if(GHASH_PROCESS_DEBUG, "Tag bits: {} : {} : {} : {}", tag[0], tag[1], tag[2], tag[3]);
 
-    galois_multiply(tag, m_key, tag);
+    multiply_by_key(tag);
 
     TagType digest;
     to_u8s(digest.data, tag);
@@ -33,11 +33,7 @@ public:
     {
     }
 
-    explicit GHash(const ReadonlyBytes& key)
-    {
-        for (size_t i = 0; i < 16; i += 4)
-            m_key[i / 4] = AK::convert_between_host_and_big_endian(*(const u32*)(key.offset(i)));
-    }
+    explicit GHash(const ReadonlyBytes& key);
 
     constexpr static size_t digest_size() { return TagType::Size; }
 
@@ -46,9 +42,15 @@ public:
     TagType process(ReadonlyBytes aad, ReadonlyBytes cipher);
 
 private:
-    inline void transform(ReadonlyBytes, ReadonlyBytes);
+    void absorb_blocks(u32 (&tag)[4], const u8* blocks, size_t count) const;
+    void multiply_by_key(u32 (&tag)[4]) const;
 
     u32 m_key[4];
+    // H^2, H^3 and H^4, so that the carry-less multiplication path can fold four blocks per reduction.
+    u32 m_key_powers[3][4];
+    // Shoup's 4-bit tables: (i * H) for every 4-bit i, split into 64-bit halves.
+    u64 m_table_high[16];
+    u64 m_table_low[16];
 };
 
 }
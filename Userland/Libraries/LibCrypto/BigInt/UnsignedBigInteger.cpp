@@ -9,6 +9,143 @@
 
 namespace Crypto {
 
+// Below this many words, the extra additions of Karatsuba cost more than the multiplications it saves.
+static constexpr size_t KARATSUBA_THRESHOLD = 32;
+
+ALWAYS_INLINE static u32 count_leading_zeroes(u32 word)
+{
+    return word == 0 ? 32 : __builtin_clz(word);
+}
+
+// dest[0, dest_length) += source[0, source_length), with source_length <= dest_length.
+// Returns the carry out of the top word.
+static u32 add_words_in_place(u32* dest, size_t dest_length, const u32* source, size_t source_length)
+{
+    u64 carry = 0;
+    size_t i = 0;
+    for (; i < source_length; ++i) {
+        u64 sum = (u64)dest[i] + source[i] + carry;
+        dest[i] = (u32)sum;
+        carry = sum >> 32;
+    }
+    for (; carry && i < dest_length; ++i) {
+        u64 sum = (u64)dest[i] + carry;
+        dest[i] = (u32)sum;
+        carry = sum >> 32;
+    }
+    return carry;
+}
+
+// dest[0, dest_length) -= source[0, source_length), with source_length <= dest_length.
+// Returns the borrow out of the top word.
+static u32 subtract_words_in_place(u32* dest, size_t dest_length, const u32* source, size_t source_length)
+{
+    u32 borrow = 0;
+    size_t i = 0;
+    for (; i < source_length; ++i) {
+        u64 difference = (u64)dest[i] - source[i] - borrow;
+        dest[i] = (u32)difference;
+        borrow = (difference >> 32) & 1;
+    }
+    for (; borrow && i < dest_length; ++i) {
+        borrow = dest[i] == 0;
+        --dest[i];
+    }
+    return borrow;
+}
+
+// out[0, left_length + right_length) = left * right
+static void schoolbook_multiply(const u32* left, size_t left_length, const u32* right, size_t right_length, u32* out)
+{
+    __builtin_memset(out, 0, (left_length + right_length) * sizeof(u32));
+    for (size_t i = 0; i < left_length; ++i) {
+        u64 carry = 0;
+        for (size_t j = 0; j < right_length; ++j) {
+            u64 product = (u64)left[i] * right[j] + out[i + j] + carry;
+            out[i + j] = (u32)product;
+            carry = product >> 32;
+        }
+        out[i + right_length] = (u32)carry;
+    }
+}
+
+static size_t karatsuba_scratch_size(size_t length)
+{
+    if (length < KARATSUBA_THRESHOLD)
+        return 0;
+    // The sums of the halves are one word longer than the high half.
+    auto sum_length = length - length / 2 + 1;
+    return 4 * sum_length + karatsuba_scratch_size(sum_length);
+}
+
+// out[0, 2 * length) = left * right, where both operands are |length| words long.
+static void karatsuba_multiply(const u32* left, const u32* right, size_t length, u32* out, u32* scratch)
+{
+    if (length < KARATSUBA_THRESHOLD) {
+        schoolbook_multiply(left, length, right, length, out);
+        return;
+    }
+
+    auto low_length = length / 2;
+    auto high_length = length - low_length;
+    auto sum_length = high_length + 1;
+
+    // z0 = left_low * right_low and z2 = left_high * right_high go straight into their places in |out|.
+    karatsuba_multiply(left, right, low_length, out, scratch);
+    karatsuba_multiply(left + low_length, right + low_length, high_length, out + 2 * low_length, scratch);
+
+    // z1 = (left_low + left_high) * (right_low + right_high) - z0 - z2
+    u32* left_sum = scratch;
+    u32* right_sum = scratch + sum_length;
+    u32* middle = scratch + 2 * sum_length;
+    __builtin_memcpy(left_sum, left + low_length, high_length * sizeof(u32));
+    left_sum[high_length] = 0;
+    add_words_in_place(left_sum, sum_length, left, low_length);
+    __builtin_memcpy(right_sum, right + low_length, high_length * sizeof(u32));
+    right_sum[high_length] = 0;
+    add_words_in_place(right_sum, sum_length, right, low_length);
+
+    karatsuba_multiply(left_sum, right_sum, sum_length, middle, scratch + 4 * sum_length);
+    subtract_words_in_place(middle, 2 * sum_length, out, 2 * low_length);
+    subtract_words_in_place(middle, 2 * sum_length, out + 2 * low_length, 2 * high_length);
+
+    add_words_in_place(out + low_length, 2 * length - low_length, middle, 2 * sum_length);
+}
+
+static size_t multiply_scratch_size(size_t shorter_length)
+{
+    if (shorter_length < KARATSUBA_THRESHOLD)
+        return 0;
+    // One partial product, and the zero-padded final slice of the longer operand.
+    return 3 * shorter_length + karatsuba_scratch_size(shorter_length);
+}
+
+// out[0, longer_length + shorter_length) = longer * shorter, with shorter_length <= longer_length.
+static void multiply_words(const u32* longer, size_t longer_length, const u32* shorter, size_t shorter_length, u32* out, u32* scratch)
+{
+    if (shorter_length < KARATSUBA_THRESHOLD) {
+        schoolbook_multiply(longer, longer_length, shorter, shorter_length, out);
+        return;
+    }
+
+    // Multiply |shorter| by equally sized slices of |longer|, so that Karatsuba always sees balanced operands.
+    __builtin_memset(out, 0, (longer_length + shorter_length) * sizeof(u32));
+    u32* product = scratch;
+    u32* padded_slice = scratch + 2 * shorter_length;
+    scratch += 3 * shorter_length;
+    for (size_t offset = 0; offset < longer_length; offset += shorter_length) {
+        auto slice_length = min(shorter_length, longer_length - offset);
+        const u32* slice = longer + offset;
+        if (slice_length < shorter_length) {
+            __builtin_memcpy(padded_slice, slice, slice_length * sizeof(u32));
+            __builtin_memset(padded_slice + slice_length, 0, (shorter_length - slice_length) * sizeof(u32));
+            slice = padded_slice;
+        }
+        karatsuba_multiply(slice, shorter, shorter_length, product, scratch);
+        add_words_in_place(out + offset, longer_length + shorter_length - offset, product, slice_length + shorter_length);
+    }
+}
+
 UnsignedBigInteger::UnsignedBigInteger(const u8* ptr, size_t length)
 {
     m_words.resize_and_keep_capacity((length + sizeof(u32) - 1) / sizeof(u32));
@@ -575,74 +712,148 @@ FLATTEN void UnsignedBigInteger::shift_left_without_allocation(
 }
 
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N^2) for small numbers, O(N^1.585) once both operands are at least KARATSUBA_THRESHOLD words long.
  * Multiplication method:
- * An integer is equal to the sum of the powers of two
- * according to the indexes of its 'on' bits.
- * So to multiple x*y, we go over each '1' bit in x (say the i'th bit),
- * and add y<<i to the result.
+ * Schoolbook multiplication of 32-bit words into 64-bit products, switching to Karatsuba
+ * for large, balanced operands. All scratch space lives in |temp_shift_result|, so repeated
+ * calls with the same temporaries don't allocate once it has grown large enough.
  */
 FLATTEN void UnsignedBigInteger::multiply_without_allocation(
     const UnsignedBigInteger& left,
     const UnsignedBigInteger& right,
     UnsignedBigInteger& temp_shift_result,
-    UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_plus,
+    [[maybe_unused]] UnsignedBigInteger& temp_shift_plus,
+    [[maybe_unused]] UnsignedBigInteger& temp_shift,
+    [[maybe_unused]] UnsignedBigInteger& temp_plus,
     UnsignedBigInteger& output)
 {
     output.set_to_0();
 
-    // iterate all bits
-    for (size_t word_index = 0; word_index < left.length(); ++word_index) {
-        for (size_t bit_index = 0; bit_index < UnsignedBigInteger::BITS_IN_WORD; ++bit_index) {
-            // If the bit is off - skip over it
-            if (!(left.m_words[word_index] & (1 << bit_index)))
-                continue;
+    const UnsignedBigInteger* longer = &left;
+    const UnsignedBigInteger* shorter = &right;
+    if (longer->trimmed_length() < shorter->trimmed_length())
+        swap(longer, shorter);
 
-            const size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
+    auto longer_length = longer->trimmed_length();
+    auto shorter_length = shorter->trimmed_length();
+    if (shorter_length == 0)
+        return;
 
-            // output += (right << shift_amount);
-            shift_left_without_allocation(right, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-            add_without_allocation(output, temp_shift, temp_plus);
-            output.set_to(temp_plus);
-        }
-    }
+    temp_shift_result.set_to_0();
+    temp_shift_result.m_words.resize_and_keep_capacity(multiply_scratch_size(shorter_length));
+
+    output.m_words.resize_and_keep_capacity(longer_length + shorter_length);
+    multiply_words(longer->m_words.data(), longer_length, shorter->m_words.data(), shorter_length, output.m_words.data(), temp_shift_result.m_words.data());
 }
 
 /**
- * Complexity: O(N^2) where N is the number of words in the larger number
+ * Complexity: O(N * M) where N and M are the numbers of words in the quotient and the denominator
  * Division method:
- * We loop over the bits of the divisor, attempting to subtract divisor<<i from the dividend.
- * If the result is non-negative, it means that divisor*2^i "fits" in the dividend,
- * so we set the ith bit in the quotient and reduce divisor<<i from the dividend.
- * When we're done, what's left from the dividend is the remainder.
+ * Knuth's Algorithm D (The Art of Computer Programming, Vol. 2, 4.3.1): long division in base 2^32,
+ * estimating each quotient word from the top two words of the remainder and correcting it at most twice.
+ * Both operands are first shifted left so that the top bit of the denominator is set, which keeps the
+ * estimates tight; the normalized copies live in |temp_shift_result| and |temp_shift_plus|.
  */
 FLATTEN void UnsignedBigInteger::divide_without_allocation(
     const UnsignedBigInteger& numerator,
     const UnsignedBigInteger& denominator,
     UnsignedBigInteger& temp_shift_result,
     UnsignedBigInteger& temp_shift_plus,
-    UnsignedBigInteger& temp_shift,
-    UnsignedBigInteger& temp_minus,
+    [[maybe_unused]] UnsignedBigInteger& temp_shift,
+    [[maybe_unused]] UnsignedBigInteger& temp_minus,
     UnsignedBigInteger& quotient,
     UnsignedBigInteger& remainder)
 {
+    auto numerator_length = numerator.trimmed_length();
+    auto denominator_length = denominator.trimmed_length();
+    VERIFY(denominator_length != 0);
+
+    if (numerator_length < denominator_length || numerator < denominator) {
+        quotient.set_to(0);
+        remainder.set_to(numerator);
+        return;
+    }
+
     quotient.set_to_0();
-    remainder.set_to(numerator);
-
-    // iterate all bits
-    for (int word_index = numerator.trimmed_length() - 1; word_index >= 0; --word_index) {
-        for (int bit_index = UnsignedBigInteger::BITS_IN_WORD - 1; bit_index >= 0; --bit_index) {
-            const size_t shift_amount = word_index * UnsignedBigInteger::BITS_IN_WORD + bit_index;
-            shift_left_without_allocation(denominator, shift_amount, temp_shift_result, temp_shift_plus, temp_shift);
-
-            subtract_without_allocation(remainder, temp_shift, temp_minus);
-            if (!temp_minus.is_invalid()) {
-                remainder.set_to(temp_minus);
-                quotient.set_bit_inplace(shift_amount);
+    quotient.m_words.resize_and_keep_capacity(numerator_length - denominator_length + 1);
+
+    if (denominator_length == 1) {
+        u64 divisor = denominator.m_words[0];
+        u64 remainder_word = 0;
+        for (size_t i = numerator_length; i > 0; --i) {
+            u64 dividend = (remainder_word << 32) | numerator.m_words[i - 1];
+            quotient.m_words[i - 1] = dividend / divisor;
+            remainder_word = dividend % divisor;
+        }
+        remainder.set_to(remainder_word);
+        return;
+    }
+
+    auto normalize_shift = count_leading_zeroes(denominator.m_words[denominator_length - 1]);
+    auto shifted_word = [normalize_shift](const UnsignedBigInteger& number, size_t index) -> u32 {
+        u64 pair = ((u64)number.m_words[index] << 32) | (index > 0 ? number.m_words[index - 1] : 0);
+        return pair >> (32 - normalize_shift);
+    };
+
+    auto& normalized_numerator = temp_shift_result;
+    normalized_numerator.set_to_0();
+    normalized_numerator.m_words.resize_and_keep_capacity(numerator_length + 1);
+    for (size_t i = 0; i < numerator_length; ++i)
+        normalized_numerator.m_words[i] = shifted_word(numerator, i);
+    normalized_numerator.m_words[numerator_length] = (u64)numerator.m_words[numerator_length - 1] >> (32 - normalize_shift);
+
+    auto& normalized_denominator = temp_shift_plus;
+    normalized_denominator.set_to_0();
+    normalized_denominator.m_words.resize_and_keep_capacity(denominator_length);
+    for (size_t i = 0; i < denominator_length; ++i)
+        normalized_denominator.m_words[i] = shifted_word(denominator, i);
+
+    u32* u = normalized_numerator.m_words.data();
+    const u32* v = normalized_denominator.m_words.data();
+    auto n = denominator_length;
+
+    for (size_t j = numerator_length - n + 1; j-- > 0;) {
+        u64 top = ((u64)u[j + n] << 32) | u[j + n - 1];
+        u64 estimate = top / v[n - 1];
+        u64 estimate_remainder = top % v[n - 1];
+        while (estimate > NumericLimits<u32>::max() || estimate * v[n - 2] > ((estimate_remainder << 32) | u[j + n - 2])) {
+            --estimate;
+            estimate_remainder += v[n - 1];
+            if (estimate_remainder > NumericLimits<u32>::max())
+                break;
+        }
+
+        // u[j, j + n] -= estimate * v
+        i64 borrow = 0;
+        i64 difference;
+        for (size_t i = 0; i < n; ++i) {
+            u64 product = estimate * v[i];
+            difference = (i64)u[i + j] - borrow - (i64)(product & 0xffffffff);
+            u[i + j] = (u32)difference;
+            borrow = (i64)(product >> 32) - (difference >> 32);
+        }
+        difference = (i64)u[j + n] - borrow;
+        u[j + n] = (u32)difference;
+
+        if (difference < 0) {
+            // The estimate was one too large, add v back.
+            --estimate;
+            u64 carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                u64 sum = (u64)u[i + j] + v[i] + carry;
+                u[i + j] = (u32)sum;
+                carry = sum >> 32;
             }
+            u[j + n] += carry;
         }
+        quotient.m_words[j] = (u32)estimate;
+    }
+
+    remainder.set_to_0();
+    remainder.m_words.resize_and_keep_capacity(n);
+    for (size_t i = 0; i < n; ++i) {
+        u64 pair = ((u64)u[i + 1] << 32) | u[i];
+        remainder.m_words[i] = pair >> normalize_shift;
     }
 }
 
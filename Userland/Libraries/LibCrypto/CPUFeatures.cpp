@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/CPUFeatures.h>
+
+namespace Crypto {
+
+#if CRYPTO_HAS_X86_INTRINSICS
+static u32 s_cpu_features;
+#endif
+
+u32 cpu_features()
+{
+#if CRYPTO_HAS_X86_INTRINSICS
+    // Racing threads will all come up with the same answer, so there's no need for a lock.
+    if (s_cpu_features & CPUFeature::Detected)
+        return s_cpu_features;
+    u32 features = CPUFeature::Detected;
+    auto cpuid = [](u32 leaf, u32& eax, u32& ebx, u32& ecx, u32& edx) {
+        asm volatile("cpuid"
+                     : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                     : "a"(leaf), "c"(0));
+    };
+    u32 max_leaf, eax, ebx, ecx, edx;
+    cpuid(0, max_leaf, ebx, ecx, edx);
+    cpuid(1, eax, ebx, ecx, edx);
+    if (edx & (1 << 26))
+        features |= CPUFeature::SSE2;
+    if ((features & CPUFeature::SSE2) && (ecx & (1 << 1)))
+        features |= CPUFeature::PCLMUL;
+    if ((features & CPUFeature::SSE2) && (ecx & (1 << 25)))
+        features |= CPUFeature::AESNI;
+    if ((features & CPUFeature::SSE2) && (ecx & (1 << 9)))
+        features |= CPUFeature::SSSE3;
+    if ((features & CPUFeature::SSSE3) && (ecx & (1 << 19)))
+        features |= CPUFeature::SSE41;
+    if (max_leaf >= 7) {
+        cpuid(7, eax, ebx, ecx, edx);
+        if ((features & CPUFeature::SSE41) && (ebx & (1 << 29)))
+            features |= CPUFeature::SHA;
+    }
+    s_cpu_features = features;
+    return features;
+#else
+    return 0;
+#endif
+}
+
+}
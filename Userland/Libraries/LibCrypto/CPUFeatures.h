@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+#include <AK/Types.h>
+
+namespace Crypto {
+
+// The kernel builds some of our primitives too, but it doesn't get to touch the vector registers.
+#if (ARCH(I386) || ARCH(X86_64)) && !defined(KERNEL)
+#    define CRYPTO_HAS_X86_INTRINSICS 1
+#else
+#    define CRYPTO_HAS_X86_INTRINSICS 0
+#endif
+
+enum CPUFeature : u32 {
+    Detected = 1 << 0,
+    SSE2 = 1 << 1,
+    PCLMUL = 1 << 2,
+    AESNI = 1 << 3,
+    SSSE3 = 1 << 4,
+    SSE41 = 1 << 5,
+    SHA = 1 << 6,
+};
+
+// Returns a mask of CPUFeature bits; always 0 where CRYPTO_HAS_X86_INTRINSICS is unset.
+u32 cpu_features();
+
+inline bool has_cpu_feature(CPUFeature feature)
+{
+    return cpu_features() & feature;
+}
+
+}
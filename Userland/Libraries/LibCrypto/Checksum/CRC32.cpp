@@ -10,11 +10,40 @@
 
 namespace Crypto::Checksum {
 
+// Tables for "slicing-by-8": slice_tables[n][i] is the CRC of byte i followed by n zero bytes,
+// which lets the update loop fold in eight bytes with eight independent lookups.
+struct SliceTables {
+    u32 data[8][256];
+
+    constexpr SliceTables()
+        : data()
+    {
+        for (auto i = 0; i < 256; i++)
+            data[0][i] = table[i];
+        for (auto n = 1; n < 8; n++) {
+            for (auto i = 0; i < 256; i++)
+                data[n][i] = (data[n - 1][i] >> 8) ^ table[data[n - 1][i] & 0xFF];
+        }
+    }
+};
+
+constexpr static auto slice_tables = SliceTables();
+
 void CRC32::update(ReadonlyBytes data)
 {
-    for (size_t i = 0; i < data.size(); i++) {
-        m_state = table[(m_state ^ data.at(i)) & 0xFF] ^ (m_state >> 8);
+    auto* bytes = data.data();
+    auto size = data.size();
+    auto& t = slice_tables.data;
+
+    for (; size >= 8; size -= 8, bytes += 8) {
+        u32 low = m_state ^ (bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((u32)bytes[3] << 24));
+        u32 high = bytes[4] | (bytes[5] << 8) | (bytes[6] << 16) | ((u32)bytes[7] << 24);
+        m_state = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+            ^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
     }
+
+    for (size_t i = 0; i < size; i++)
+        m_state = table[(m_state ^ bytes[i]) & 0xFF] ^ (m_state >> 8);
 };
 
 u32 CRC32::digest()
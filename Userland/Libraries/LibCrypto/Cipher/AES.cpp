@@ -5,8 +5,13 @@
  */
 
 #include <AK/StringBuilder.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Cipher/AES.h>
 
+#if CRYPTO_HAS_X86_INTRINSICS
+#    include <wmmintrin.h>
+#endif
+
 namespace Crypto {
 namespace Cipher {
 
@@ -81,6 +86,7 @@ void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
                 break;
             round_key += 4;
         }
+        update_round_key_bytes();
         return;
     }
 
@@ -109,6 +115,7 @@ void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
 
             round_key += 6;
         }
+        update_round_key_bytes();
         return;
     }
 
@@ -146,6 +153,7 @@ void AESCipherKey::expand_encrypt_key(ReadonlyBytes user_key, size_t bits)
 
             round_key += 8;
         }
+        update_round_key_bytes();
         return;
     }
 }
@@ -192,10 +200,104 @@ void AESCipherKey::expand_decrypt_key(ReadonlyBytes user_key, size_t bits)
                 AESTables::Decode3[AESTables::Encode1[(round_key[3]      ) & 0xff] & 0xff] ;
         // clang-format on
     }
+
+    update_round_key_bytes();
+}
+
+void AESCipherKey::update_round_key_bytes()
+{
+    for (size_t i = 0; i < (rounds() + 1) * 4; ++i) {
+        m_rd_key_bytes[i * 4 + 0] = m_rd_keys[i] >> 24;
+        m_rd_key_bytes[i * 4 + 1] = m_rd_keys[i] >> 16;
+        m_rd_key_bytes[i * 4 + 2] = m_rd_keys[i] >> 8;
+        m_rd_key_bytes[i * 4 + 3] = m_rd_keys[i];
+    }
+}
+
+#if CRYPTO_HAS_X86_INTRINSICS
+// The decryption schedule is already the "equivalent inverse cipher" one (reversed, with
+// InvMixColumns applied to the middle rounds), which is exactly what aesdec expects.
+template<bool encrypt>
+[[gnu::target("aes,sse2")]] static __m128i aesni_round(__m128i block, __m128i key)
+{
+    if constexpr (encrypt)
+        return _mm_aesenc_si128(block, key);
+    else
+        return _mm_aesdec_si128(block, key);
+}
+
+template<bool encrypt>
+[[gnu::target("aes,sse2")]] static __m128i aesni_last_round(__m128i block, __m128i key)
+{
+    if constexpr (encrypt)
+        return _mm_aesenclast_si128(block, key);
+    else
+        return _mm_aesdeclast_si128(block, key);
+}
+
+// Four independent blocks are enough to hide the latency of aesenc/aesdec on current cores.
+template<bool encrypt>
+[[gnu::target("aes,sse2")]] static void process_blocks_aesni(const u8* round_key_bytes, size_t rounds, const u8* in, u8* out, size_t count)
+{
+    __m128i keys[15];
+    for (size_t i = 0; i <= rounds; ++i)
+        keys[i] = _mm_loadu_si128((const __m128i*)(round_key_bytes + i * 16));
+
+    for (; count >= 4; count -= 4, in += 64, out += 64) {
+        auto b0 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 0)), keys[0]);
+        auto b1 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 16)), keys[0]);
+        auto b2 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 32)), keys[0]);
+        auto b3 = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + 48)), keys[0]);
+        for (size_t i = 1; i < rounds; ++i) {
+            b0 = aesni_round<encrypt>(b0, keys[i]);
+            b1 = aesni_round<encrypt>(b1, keys[i]);
+            b2 = aesni_round<encrypt>(b2, keys[i]);
+            b3 = aesni_round<encrypt>(b3, keys[i]);
+        }
+        _mm_storeu_si128((__m128i*)(out + 0), aesni_last_round<encrypt>(b0, keys[rounds]));
+        _mm_storeu_si128((__m128i*)(out + 16), aesni_last_round<encrypt>(b1, keys[rounds]));
+        _mm_storeu_si128((__m128i*)(out + 32), aesni_last_round<encrypt>(b2, keys[rounds]));
+        _mm_storeu_si128((__m128i*)(out + 48), aesni_last_round<encrypt>(b3, keys[rounds]));
+    }
+
+    for (; count > 0; --count, in += 16, out += 16) {
+        auto block = _mm_xor_si128(_mm_loadu_si128((const __m128i*)in), keys[0]);
+        for (size_t i = 1; i < rounds; ++i)
+            block = aesni_round<encrypt>(block, keys[i]);
+        _mm_storeu_si128((__m128i*)out, aesni_last_round<encrypt>(block, keys[rounds]));
+    }
+}
+#endif
+
+void AESCipher::encrypt_blocks(ReadonlyBytes in, Bytes out)
+{
+    VERIFY(in.size() == out.size());
+    VERIFY(in.size() % block_size() == 0);
+
+#if CRYPTO_HAS_X86_INTRINSICS
+    if (has_cpu_feature(CPUFeature::AESNI)) {
+        process_blocks_aesni<true>(m_key.round_key_bytes(), m_key.rounds(), in.data(), out.data(), in.size() / block_size());
+        return;
+    }
+#endif
+
+    AESCipherBlock block;
+    for (size_t offset = 0; offset < in.size(); offset += block_size()) {
+        block.overwrite(in.slice(offset, block_size()));
+        encrypt_block(block, block);
+        block.bytes().copy_to(out.slice(offset, block_size()));
+    }
 }
 
 void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_INTRINSICS
+    if (has_cpu_feature(CPUFeature::AESNI)) {
+        process_blocks_aesni<true>(m_key.round_key_bytes(), m_key.rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
+
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
 
@@ -288,6 +390,12 @@ void AESCipher::encrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 
 void AESCipher::decrypt_block(const AESCipherBlock& in, AESCipherBlock& out)
 {
+#if CRYPTO_HAS_X86_INTRINSICS
+    if (has_cpu_feature(CPUFeature::AESNI)) {
+        process_blocks_aesni<false>(m_key.round_key_bytes(), m_key.rounds(), in.bytes().data(), out.bytes().data(), 1);
+        return;
+    }
+#endif
 
     u32 s0, s1, s2, s3, t0, t1, t2, t3;
     size_t r { 0 };
@@ -61,6 +61,8 @@ struct AESCipherKey : public CipherKey {
     {
         return (const u32*)m_rd_keys;
     }
+    // The same schedule laid out in memory order, as the AES-NI instructions want it.
+    const u8* round_key_bytes() const { return m_rd_key_bytes; }
 
     AESCipherKey(ReadonlyBytes user_key, size_t key_bits, Intent intent)
         : m_bits(key_bits)
@@ -83,8 +85,11 @@ protected:
     }
 
 private:
+    void update_round_key_bytes();
+
     static constexpr size_t MAX_ROUND_COUNT = 14;
     u32 m_rd_keys[(MAX_ROUND_COUNT + 1) * 4] { 0 };
+    u8 m_rd_key_bytes[(MAX_ROUND_COUNT + 1) * 16] { 0 };
     size_t m_rounds;
     size_t m_bits;
 };
@@ -109,6 +114,10 @@ public:
     virtual void encrypt_block(const BlockType& in, BlockType& out) override;
     virtual void decrypt_block(const BlockType& in, BlockType& out) override;
 
+    // Encrypts consecutive blocks in one go, so that implementations which can keep several blocks
+    // in flight (i.e. AES-NI) get the chance to. |in| and |out| must be the same multiple of the block size.
+    void encrypt_blocks(ReadonlyBytes in, Bytes out);
+
     virtual String class_name() const override { return "AES"; }
 
 protected:
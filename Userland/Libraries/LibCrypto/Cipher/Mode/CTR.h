@@ -163,6 +163,33 @@ protected:
         size_t offset { 0 };
         auto block_size = cipher.block_size();
 
+        if constexpr (requires { cipher.encrypt_blocks(ReadonlyBytes {}, Bytes {}); }) {
+            // Hand the cipher a batch of counter blocks at a time, so it can work on them in parallel.
+            constexpr size_t blocks_per_batch = 4;
+            constexpr size_t batch_size = blocks_per_batch * T::BlockType::BlockSizeInBits / 8;
+            u8 counters[batch_size];
+            u8 key_stream[batch_size];
+
+            while (length >= batch_size) {
+                for (size_t i = 0; i < blocks_per_batch; ++i) {
+                    __builtin_memcpy(counters + i * block_size, iv.data(), block_size);
+                    increment(iv);
+                }
+                cipher.encrypt_blocks({ counters, batch_size }, { key_stream, batch_size });
+
+                VERIFY(offset + batch_size <= out.size());
+                if (in) {
+                    for (size_t i = 0; i < batch_size; ++i)
+                        out[offset + i] = key_stream[i] ^ (*in)[offset + i];
+                } else {
+                    __builtin_memcpy(out.offset(offset), key_stream, batch_size);
+                }
+
+                length -= batch_size;
+                offset += batch_size;
+            }
+        }
+
         while (length > 0) {
             m_cipher_block.overwrite(iv.slice(0, block_size));
 
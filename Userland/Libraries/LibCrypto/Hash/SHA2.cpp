@@ -5,8 +5,13 @@
  */
 
 #include <AK/Types.h>
+#include <LibCrypto/CPUFeatures.h>
 #include <LibCrypto/Hash/SHA2.h>
 
+#if CRYPTO_HAS_X86_INTRINSICS
+#    include <immintrin.h>
+#endif
+
 namespace Crypto {
 namespace Hash {
 constexpr static auto ROTRIGHT(u32 a, size_t b) { return (a >> b) | (a << (32 - b)); }
@@ -66,16 +71,228 @@ inline void SHA256::transform(const u8* data)
     m_state[7] += h;
 }
 
+#if CRYPTO_HAS_X86_INTRINSICS
+// Based on the instruction sequences in Intel's "Intel SHA Extensions" white paper.
+// The state is kept as ABEF/CDGH pairs, which is the layout sha256rnds2 works on.
+[[gnu::target("sha,sse4.1")]] static void transform_blocks_sha_ni(u32* state, const u8* data, size_t count)
+{
+    const auto byte_swap_mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+
+    auto dcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[0]), 0xb1);
+    auto efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)&state[4]), 0x1b);
+    auto abef = _mm_alignr_epi8(dcba, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, dcba, 0xf0);
+
+    for (; count > 0; --count, data += 64) {
+        auto abef_save = abef;
+        auto cdgh_save = cdgh;
+        __m128i w[4];
+
+        for (size_t group = 0; group < 16; ++group) {
+            auto& current = w[group % 4];
+            if (group < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(data + group * 16)), byte_swap_mask);
+
+            auto message = _mm_add_epi32(current, _mm_loadu_si128((const __m128i*)&SHA256Constants::RoundConstants[group * 4]));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, message);
+
+            // Schedule words 4 * (group + 1) onward while the rounds are in flight.
+            if (group >= 3 && group <= 14) {
+                auto& next = w[(group + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(current, w[(group + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+
+            message = _mm_shuffle_epi32(message, 0x0e);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, message);
+
+            if (group >= 1 && group <= 12) {
+                auto& previous = w[(group + 3) % 4];
+                previous = _mm_sha256msg1_epu32(previous, current);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_save);
+        cdgh = _mm_add_epi32(cdgh, cdgh_save);
+    }
+
+    auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128((__m128i*)&state[0], _mm_blend_epi16(feba, dchg, 0xf0));
+    _mm_storeu_si128((__m128i*)&state[4], _mm_alignr_epi8(dchg, feba, 8));
+}
+
+[[gnu::target("sse2")]] static __m128i rotate_right_x4(__m128i value, int bits)
+{
+    return _mm_or_si128(_mm_srli_epi32(value, bits), _mm_slli_epi32(value, 32 - bits));
+}
+
+// Runs four independent SHA-256 computations side by side, one per 32-bit lane.
+// Each lane processes |count| blocks from its own |data| pointer.
+[[gnu::target("sse2")]] static void transform_blocks_x4(u32* const (&states)[4], const u8* const (&data)[4], size_t count)
+{
+    __m128i state[8];
+    for (size_t i = 0; i < 8; ++i)
+        state[i] = _mm_set_epi32(states[3][i], states[2][i], states[1][i], states[0][i]);
+
+    for (size_t block = 0; block < count; ++block) {
+        __m128i w[16];
+        for (size_t i = 0; i < 16; ++i) {
+            u32 words[4];
+            for (size_t lane = 0; lane < 4; ++lane) {
+                auto* bytes = data[lane] + block * 64 + i * 4;
+                words[lane] = ((u32)bytes[0] << 24) | ((u32)bytes[1] << 16) | ((u32)bytes[2] << 8) | bytes[3];
+            }
+            w[i] = _mm_set_epi32(words[3], words[2], words[1], words[0]);
+        }
+
+        auto a = state[0], b = state[1], c = state[2], d = state[3];
+        auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (size_t i = 0; i < 64; ++i) {
+            if (i >= 16) {
+                auto w15 = w[(i - 15) % 16];
+                auto w2 = w[(i - 2) % 16];
+                auto sign0 = _mm_xor_si128(_mm_xor_si128(rotate_right_x4(w15, 7), rotate_right_x4(w15, 18)), _mm_srli_epi32(w15, 3));
+                auto sign1 = _mm_xor_si128(_mm_xor_si128(rotate_right_x4(w2, 17), rotate_right_x4(w2, 19)), _mm_srli_epi32(w2, 10));
+                w[i % 16] = _mm_add_epi32(_mm_add_epi32(w[i % 16], sign0), _mm_add_epi32(w[(i - 7) % 16], sign1));
+            }
+
+            auto ep1 = _mm_xor_si128(_mm_xor_si128(rotate_right_x4(e, 6), rotate_right_x4(e, 11)), rotate_right_x4(e, 25));
+            auto ch = _mm_xor_si128(_mm_and_si128(e, f), _mm_andnot_si128(e, g));
+            auto temp0 = _mm_add_epi32(_mm_add_epi32(h, ep1), _mm_add_epi32(ch, _mm_add_epi32(_mm_set1_epi32(SHA256Constants::RoundConstants[i]), w[i % 16])));
+            auto ep0 = _mm_xor_si128(_mm_xor_si128(rotate_right_x4(a, 2), rotate_right_x4(a, 13)), rotate_right_x4(a, 22));
+            auto maj = _mm_xor_si128(_mm_xor_si128(_mm_and_si128(a, b), _mm_and_si128(a, c)), _mm_and_si128(b, c));
+            auto temp1 = _mm_add_epi32(ep0, maj);
+            h = g;
+            g = f;
+            f = e;
+            e = _mm_add_epi32(d, temp0);
+            d = c;
+            c = b;
+            b = a;
+            a = _mm_add_epi32(temp0, temp1);
+        }
+
+        state[0] = _mm_add_epi32(state[0], a);
+        state[1] = _mm_add_epi32(state[1], b);
+        state[2] = _mm_add_epi32(state[2], c);
+        state[3] = _mm_add_epi32(state[3], d);
+        state[4] = _mm_add_epi32(state[4], e);
+        state[5] = _mm_add_epi32(state[5], f);
+        state[6] = _mm_add_epi32(state[6], g);
+        state[7] = _mm_add_epi32(state[7], h);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        u32 lanes[4];
+        _mm_storeu_si128((__m128i*)lanes, state[i]);
+        for (size_t lane = 0; lane < 4; ++lane)
+            states[lane][i] = lanes[lane];
+    }
+}
+#endif
+
+void SHA256::transform_blocks(const u8* data, size_t count)
+{
+#if CRYPTO_HAS_X86_INTRINSICS
+    if (has_cpu_feature(CPUFeature::SHA)) {
+        transform_blocks_sha_ni(m_state, data, count);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < count; ++i)
+        transform(data + i * BlockSize);
+}
+
+// Tops up a partially filled block buffer from |message|, and returns what's left of it.
+ReadonlyBytes SHA256::complete_partial_block(ReadonlyBytes message)
+{
+    if (m_data_length == 0)
+        return message;
+
+    auto fill_size = min(message.size(), BlockSize - m_data_length);
+    __builtin_memcpy(m_data_buffer + m_data_length, message.data(), fill_size);
+    m_data_length += fill_size;
+    if (m_data_length == BlockSize) {
+        transform_blocks(m_data_buffer, 1);
+        m_bit_length += BlockSize * 8;
+        m_data_length = 0;
+    }
+    return message.slice(fill_size);
+}
+
 void SHA256::update(const u8* message, size_t length)
 {
-    for (size_t i = 0; i < length; ++i) {
-        if (m_data_length == BlockSize) {
-            transform(m_data_buffer);
-            m_bit_length += 512;
-            m_data_length = 0;
+    auto remaining = complete_partial_block({ message, length });
+
+    auto block_count = remaining.size() / BlockSize;
+    transform_blocks(remaining.data(), block_count);
+    m_bit_length += block_count * BlockSize * 8;
+
+    remaining = remaining.slice(block_count * BlockSize);
+    __builtin_memcpy(m_data_buffer + m_data_length, remaining.data(), remaining.size());
+    m_data_length += remaining.size();
+}
+
+void SHA256::update_many(Span<SHA256*> hashers, Span<const ReadonlyBytes> inputs)
+{
+    VERIFY(hashers.size() == inputs.size());
+
+#if CRYPTO_HAS_X86_INTRINSICS
+    if (!has_cpu_feature(CPUFeature::SHA) && has_cpu_feature(CPUFeature::SSE2)) {
+        for (size_t first = 0; first < hashers.size(); first += 4) {
+            auto lane_count = min<size_t>(4, hashers.size() - first);
+            ReadonlyBytes remaining[4];
+            for (size_t lane = 0; lane < lane_count; ++lane)
+                remaining[lane] = hashers[first + lane]->complete_partial_block(inputs[first + lane]);
+
+            // Run the hashers that still have whole blocks in lockstep, for as long as at least two of them do.
+            // Idle lanes hash a copy of the first active one into a scratch state.
+            u32 scratch_state[8];
+            for (;;) {
+                size_t active[4];
+                size_t active_count = 0;
+                size_t common_blocks = NumericLimits<size_t>::max();
+                for (size_t lane = 0; lane < lane_count; ++lane) {
+                    auto blocks = remaining[lane].size() / BlockSize;
+                    if (blocks == 0)
+                        continue;
+                    active[active_count++] = lane;
+                    common_blocks = min(common_blocks, blocks);
+                }
+                if (active_count < 2)
+                    break;
+
+                u32* states[4];
+                const u8* data[4];
+                for (size_t i = 0; i < 4; ++i) {
+                    if (i < active_count) {
+                        states[i] = hashers[first + active[i]]->m_state;
+                        data[i] = remaining[active[i]].data();
+                    } else {
+                        states[i] = scratch_state;
+                        data[i] = data[0];
+                    }
+                }
+                transform_blocks_x4(states, data, common_blocks);
+
+                for (size_t i = 0; i < active_count; ++i) {
+                    auto lane = active[i];
+                    hashers[first + lane]->m_bit_length += common_blocks * BlockSize * 8;
+                    remaining[lane] = remaining[lane].slice(common_blocks * BlockSize);
+                }
+            }
+
+            for (size_t lane = 0; lane < lane_count; ++lane)
+                hashers[first + lane]->update(remaining[lane]);
         }
-        m_data_buffer[m_data_length++] = message[i];
+        return;
     }
+#endif
+
+    for (size_t i = 0; i < hashers.size(); ++i)
+        hashers[i]->update(inputs[i]);
 }
 
 SHA256::DigestType SHA256::digest()
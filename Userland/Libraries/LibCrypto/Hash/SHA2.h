@@ -85,6 +85,9 @@ public:
 
     virtual void update(const u8*, size_t) override;
 
+    // Feeds inputs[i] to hashers[i]. Without SHA-NI, up to four hashers at a time share the SSE2 lanes.
+    static void update_many(Span<SHA256*> hashers, Span<const ReadonlyBytes> inputs);
+
     virtual DigestType digest() override;
     virtual DigestType peek() override;
 
@@ -115,6 +118,8 @@ public:
 
 private:
     inline void transform(const u8*);
+    void transform_blocks(const u8*, size_t count);
+    ReadonlyBytes complete_partial_block(ReadonlyBytes);
 
     u8 m_data_buffer[BlockSize];
     size_t m_data_length { 0 };
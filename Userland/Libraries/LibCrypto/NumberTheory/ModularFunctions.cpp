@@ -97,11 +97,8 @@ UnsignedBigInteger ModularInverse(const UnsignedBigInteger& a_, const UnsignedBi
     return temp_remainder;
 }
 
-UnsignedBigInteger ModularPower(const UnsignedBigInteger& b, const UnsignedBigInteger& e, const UnsignedBigInteger& m)
+static UnsignedBigInteger simple_modular_power(const UnsignedBigInteger& b, const UnsignedBigInteger& e, const UnsignedBigInteger& m)
 {
-    if (m == 1)
-        return 0;
-
     UnsignedBigInteger ep { e };
     UnsignedBigInteger base { b };
     UnsignedBigInteger exp { 1 };
@@ -141,6 +138,183 @@ UnsignedBigInteger ModularPower(const UnsignedBigInteger& b, const UnsignedBigIn
     return exp;
 }
 
+// Montgomery arithmetic modulo an odd |modulus| of |length| words, with R = 2^(32 * length).
+struct MontgomeryModulus {
+    const u32* words;
+    size_t length;
+    // -modulus^-1 mod 2^32
+    u32 inverse;
+};
+
+static u32 negated_inverse_of_word(u32 word)
+{
+    VERIFY(word & 1);
+    // Newton's iteration doubles the number of correct low bits each step, and any odd word
+    // is its own inverse modulo 8.
+    u32 inverse = word;
+    for (size_t i = 0; i < 4; ++i)
+        inverse *= 2 - word * inverse;
+    return -inverse;
+}
+
+// out = left * right * R^-1 mod modulus, using the CIOS method from Koç, Acar and Kaliski,
+// "Analyzing and Comparing Montgomery Multiplication Algorithms".
+// All operands are |modulus.length| words; |out| may alias either input, and |scratch| needs |length + 2| words.
+static void montgomery_multiply(const MontgomeryModulus& modulus, const u32* left, const u32* right, u32* out, u32* scratch)
+{
+    auto length = modulus.length;
+    const u32* n = modulus.words;
+    u32* t = scratch;
+    __builtin_memset(t, 0, (length + 2) * sizeof(u32));
+
+    for (size_t i = 0; i < length; ++i) {
+        u64 carry = 0;
+        for (size_t j = 0; j < length; ++j) {
+            u64 sum = (u64)left[j] * right[i] + t[j] + carry;
+            t[j] = (u32)sum;
+            carry = sum >> 32;
+        }
+        u64 sum = (u64)t[length] + carry;
+        t[length] = (u32)sum;
+        t[length + 1] = (u32)(sum >> 32);
+
+        // Add a multiple of the modulus that clears the low word, then drop that word.
+        u32 factor = t[0] * modulus.inverse;
+        carry = ((u64)factor * n[0] + t[0]) >> 32;
+        for (size_t j = 1; j < length; ++j) {
+            sum = (u64)factor * n[j] + t[j] + carry;
+            t[j - 1] = (u32)sum;
+            carry = sum >> 32;
+        }
+        sum = (u64)t[length] + carry;
+        t[length - 1] = (u32)sum;
+        t[length] = t[length + 1] + (u32)(sum >> 32);
+    }
+
+    // t < 2 * modulus here, so one subtraction is enough.
+    auto needs_subtraction = [&] {
+        if (t[length] != 0)
+            return true;
+        for (size_t i = length; i > 0; --i) {
+            if (t[i - 1] != n[i - 1])
+                return t[i - 1] > n[i - 1];
+        }
+        return true;
+    };
+    if (needs_subtraction()) {
+        u32 borrow = 0;
+        for (size_t i = 0; i < length; ++i) {
+            u64 difference = (u64)t[i] - n[i] - borrow;
+            t[i] = (u32)difference;
+            borrow = (difference >> 32) & 1;
+        }
+    }
+    __builtin_memcpy(out, t, length * sizeof(u32));
+}
+
+static size_t window_size_for_exponent(size_t bits)
+{
+    // The usual thresholds (as used by e.g. OpenSSL) that balance the precomputed odd powers
+    // against the multiplications they save.
+    if (bits > 671)
+        return 6;
+    if (bits > 239)
+        return 5;
+    if (bits > 79)
+        return 4;
+    if (bits > 23)
+        return 3;
+    return 1;
+}
+
+/**
+ * Left-to-right sliding window exponentiation in the Montgomery domain, which trades the
+ * long division of every step for two multiplications. Only works for odd moduli.
+ */
+static UnsignedBigInteger montgomery_modular_power(const UnsignedBigInteger& b, const UnsignedBigInteger& e, const UnsignedBigInteger& m)
+{
+    auto length = m.trimmed_length();
+    MontgomeryModulus modulus { m.words().data(), length, negated_inverse_of_word(m.words()[0]) };
+
+    auto exponent_length = e.trimmed_length();
+    if (exponent_length == 0)
+        return { 1 };
+    auto top_word = e.words()[exponent_length - 1];
+    size_t exponent_bits = (exponent_length - 1) * 32 + (32 - __builtin_clz(top_word));
+    auto exponent_bit = [&](size_t index) { return (e.words()[index / 32] >> (index % 32)) & 1; };
+
+    auto window_size = window_size_for_exponent(exponent_bits);
+    size_t table_size = 1u << (window_size - 1);
+
+    // Everything lives in one buffer: the odd powers base^1, base^3, ..., the accumulator, and the multiplication scratch.
+    Vector<u32> storage;
+    storage.resize((table_size + 2) * length + 2);
+    u32* table = storage.data();
+    u32* result = table + table_size * length;
+    u32* scratch = result + length;
+
+    // x -> x * R mod m
+    auto to_montgomery = [&](const UnsignedBigInteger& value, u32* out) {
+        auto reduced = value.shift_left(32 * length).divided_by(m).remainder;
+        auto& words = reduced.words();
+        for (size_t i = 0; i < length; ++i)
+            out[i] = i < words.size() ? words[i] : 0;
+    };
+
+    to_montgomery(b, table);
+    if (table_size > 1) {
+        montgomery_multiply(modulus, table, table, result, scratch);
+        for (size_t i = 1; i < table_size; ++i)
+            montgomery_multiply(modulus, table + (i - 1) * length, result, table + i * length, scratch);
+    }
+    to_montgomery(1, result);
+
+    for (ssize_t i = exponent_bits - 1; i >= 0;) {
+        if (!exponent_bit(i)) {
+            montgomery_multiply(modulus, result, result, result, scratch);
+            --i;
+            continue;
+        }
+
+        // Take the longest window of at most |window_size| bits that starts and ends with a set bit.
+        ssize_t window_end = max<ssize_t>(i - window_size + 1, 0);
+        while (!exponent_bit(window_end))
+            ++window_end;
+
+        size_t window_value = 0;
+        for (ssize_t bit = i; bit >= window_end; --bit) {
+            window_value = (window_value << 1) | exponent_bit(bit);
+            montgomery_multiply(modulus, result, result, result, scratch);
+        }
+        montgomery_multiply(modulus, result, table + (window_value >> 1) * length, result, scratch);
+        i = window_end - 1;
+    }
+
+    // Leave the Montgomery domain by multiplying with a plain 1.
+    u32* one = table;
+    __builtin_memset(one, 0, length * sizeof(u32));
+    one[0] = 1;
+    montgomery_multiply(modulus, result, one, result, scratch);
+
+    Vector<u32, STARTING_WORD_SIZE> words;
+    words.append(result, length);
+    UnsignedBigInteger power { move(words) };
+    power.clamp_to_trimmed_length();
+    return power;
+}
+
+UnsignedBigInteger ModularPower(const UnsignedBigInteger& b, const UnsignedBigInteger& e, const UnsignedBigInteger& m)
+{
+    if (m == 1)
+        return 0;
+
+    // RSA and Miller-Rabin only ever use odd moduli.
+    if (m.words()[0] % 2 == 1)
+        return montgomery_modular_power(b, e, m);
+
+    return simple_modular_power(b, e, m);
+}
+
 static void GCD_without_allocation(
     const UnsignedBigInteger& a,
     const UnsignedBigInteger& b,
@@ -21,19 +21,21 @@ DebugInfo::DebugInfo(NonnullOwnPtr<const ELF::Image> elf, String source_root, Fl
     , m_base_address(base_address)
     , m_dwarf_info(*m_elf)
 {
-    prepare_variable_scopes();
-    prepare_lines();
+    m_scopes_of_compilation_units.resize(m_dwarf_info.compilation_unit_count());
+    m_lines_of_compilation_units.resize(m_dwarf_info.compilation_unit_count());
 }
 
-void DebugInfo::prepare_variable_scopes()
+const Vector<DebugInfo::VariablesScope>& DebugInfo::scopes_of_compilation_unit(size_t index) const
 {
-    m_dwarf_info.for_each_compilation_unit([&](const Dwarf::CompilationUnit& unit) {
-        auto root = unit.root_die();
-        parse_scopes_impl(root);
-    });
+    auto& scopes = m_scopes_of_compilation_units[index];
+    if (!scopes.has_value()) {
+        scopes = Vector<VariablesScope> {};
+        parse_scopes_impl(m_dwarf_info.compilation_unit(index).root_die(), scopes.value());
+    }
+    return scopes.value();
 }
 
-void DebugInfo::parse_scopes_impl(const Dwarf::DIE& die)
+void DebugInfo::parse_scopes_impl(const Dwarf::DIE& die, Vector<VariablesScope>& scopes) const
 {
     die.for_each_child([&](const Dwarf::DIE& child) {
         if (child.is_null())
@@ -76,32 +78,52 @@ void DebugInfo::parse_scopes_impl(const Dwarf::DIE& die)
                 return;
             scope.dies_of_variables.append(variable_entry);
         });
-        m_scopes.append(scope);
+        scopes.append(scope);
 
-        parse_scopes_impl(child);
+        parse_scopes_impl(child, scopes);
     });
 }
 
-void DebugInfo::prepare_lines()
+const Vector<Dwarf::LineProgram::LineInfo>& DebugInfo::lines_of_compilation_unit(size_t index) const
 {
-    auto section = elf().lookup_section(".debug_line");
-    if (section.is_undefined())
-        return;
-
-    InputMemoryStream stream { section.bytes() };
-
-    Vector<Dwarf::LineProgram::LineInfo> all_lines;
-    while (!stream.eof()) {
-        Dwarf::LineProgram program(stream);
-        all_lines.append(program.lines());
+    auto& lines = m_lines_of_compilation_units[index];
+    if (lines.has_value())
+        return lines.value();
+    lines = Vector<Dwarf::LineProgram::LineInfo> {};
+
+    auto statement_list = m_dwarf_info.compilation_unit(index).root_die().get_attribute(Dwarf::Attribute::StmtList);
+    if (!statement_list.has_value())
+        return lines.value();
+    auto line_program_offset = statement_list.value().data.as_u32;
+    if (line_program_offset >= m_dwarf_info.debug_line_data().size())
+        return lines.value();
+
+    InputMemoryStream stream { m_dwarf_info.debug_line_data() };
+    stream.discard_or_error(line_program_offset);
+    Dwarf::LineProgram program(stream);
+
+    for (auto& line_info : program.lines()) {
+        auto file_path = normalized_file_path(line_info.file);
+        if (file_path.is_null())
+            continue;
+        lines.value().append({ line_info.address, move(file_path), line_info.line });
     }
+    quick_sort(lines.value(), [](auto& a, auto& b) {
+        return a.address < b.address;
+    });
+    return lines.value();
+}
 
-    String serenity_slash("serenity/");
+FlyString DebugInfo::normalized_file_path(const FlyString& file) const
+{
+    if (auto it = m_normalized_file_paths.find(file); it != m_normalized_file_paths.end())
+        return it->value;
 
-    for (auto& line_info : all_lines) {
-        String file_path = line_info.file;
-        if (file_path.contains("Toolchain/") || file_path.contains("libgcc"))
-            continue;
+    String file_path = file;
+    if (file_path.contains("Toolchain/") || file_path.contains("libgcc")) {
+        file_path = {};
+    } else {
+        String serenity_slash("serenity/");
         if (file_path.contains(serenity_slash)) {
             auto start_index = file_path.index_of(serenity_slash).value() + serenity_slash.length();
             file_path = file_path.substring(start_index, file_path.length() - start_index);
@@ -109,27 +131,33 @@ void DebugInfo::prepare_lines()
         if (file_path.starts_with("./") && !m_source_root.is_null()) {
             file_path = LexicalPath::canonicalized_path(String::formatted("{}/{}", m_source_root, file_path));
         }
-        m_sorted_lines.append({ line_info.address, file_path, line_info.line });
     }
-    quick_sort(m_sorted_lines, [](auto& a, auto& b) {
-        return a.address < b.address;
-    });
+
+    m_normalized_file_paths.set(file, file_path);
+    return file_path;
 }
 
 Optional<DebugInfo::SourcePosition> DebugInfo::get_source_position(u32 target_address) const
 {
-    if (m_sorted_lines.is_empty())
-        return {};
-    if (target_address < m_sorted_lines[0].address)
+    auto unit_index = m_dwarf_info.compilation_unit_containing(target_address);
+    if (!unit_index.has_value())
         return {};
-
-    // TODO: We can do a binray search here
-    for (size_t i = 0; i < m_sorted_lines.size() - 1; ++i) {
-        if (m_sorted_lines[i + 1].address > target_address) {
-            return SourcePosition::from_line_info(m_sorted_lines[i]);
-        }
+    auto& lines = lines_of_compilation_unit(unit_index.value());
+
+    // Find the first line after the address. The one before it is the line the address belongs to.
+    // That may be the last line of the unit, as the end of a sequence isn't always recorded.
+    size_t low = 0;
+    size_t high = lines.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (lines[middle].address <= target_address)
+            low = middle + 1;
+        else
+            high = middle;
     }
-    return {};
+    if (low == 0)
+        return {};
+    return SourcePosition::from_line_info(lines[low - 1]);
 }
 
 Optional<DebugInfo::SourcePositionAndAddress> DebugInfo::get_address_from_source_position(const String& file, size_t line) const
@@ -145,18 +173,22 @@ Optional<DebugInfo::SourcePositionAndAddress> DebugInfo::get_address_from_source
     }
 
     Optional<SourcePositionAndAddress> result;
-    for (const auto& line_entry : m_sorted_lines) {
-        if (!line_entry.file.ends_with(file_path))
-            continue;
+    for (size_t unit_index = 0; unit_index < m_dwarf_info.compilation_unit_count(); ++unit_index) {
+        for (const auto& line_entry : lines_of_compilation_unit(unit_index)) {
+            if (!line_entry.file.ends_with(file_path))
+                continue;
 
-        if (line_entry.line > line)
-            continue;
+            if (line_entry.line > line)
+                continue;
 
-        // We look for the source position that is closest to the desired position, and is not after it.
-        // For example, get_address_of_source_position("main.cpp", 73) could return the address for an instruction whose location is ("main.cpp", 72)
-        // as there might not be an instruction mapped for "main.cpp", 73.
-        if (!result.has_value() || (line_entry.line > result.value().line)) {
-            result = SourcePositionAndAddress { line_entry.file, line_entry.line, line_entry.address };
+            // We look for the source position that is closest to the desired position, and is not after it.
+            // For example, get_address_of_source_position("main.cpp", 73) could return the address for an instruction whose location is ("main.cpp", 72)
+            // as there might not be an instruction mapped for "main.cpp", 73.
+            // Of the instructions for that position, we want the first one.
+            if (!result.has_value() || (line_entry.line > result.value().line)
+                || (line_entry.line == result.value().line && line_entry.address < result.value().address)) {
+                result = SourcePositionAndAddress { line_entry.file, line_entry.line, line_entry.address };
+            }
         }
     }
     return result;
@@ -166,9 +198,13 @@ NonnullOwnPtrVector<DebugInfo::VariableInfo> DebugInfo::get_variables_in_current
 {
     NonnullOwnPtrVector<DebugInfo::VariableInfo> variables;
 
-    // TODO: We can store the scopes in a better data structure
-    for (const auto& scope : m_scopes) {
-        if (regs.eip - m_base_address < scope.address_low || regs.eip - m_base_address >= scope.address_high)
+    auto address = regs.eip - m_base_address;
+    auto unit_index = m_dwarf_info.compilation_unit_containing(address);
+    if (!unit_index.has_value())
+        return variables;
+
+    for (const auto& scope : scopes_of_compilation_unit(unit_index.value())) {
+        if (address < scope.address_low || address >= scope.address_high)
             continue;
 
         for (const auto& die_entry : scope.dies_of_variables) {
@@ -354,7 +390,11 @@ String DebugInfo::name_of_containing_function(u32 address) const
 
 Optional<DebugInfo::VariablesScope> DebugInfo::get_containing_function(u32 address) const
 {
-    for (const auto& scope : m_scopes) {
+    auto unit_index = m_dwarf_info.compilation_unit_containing(address);
+    if (!unit_index.has_value())
+        return {};
+
+    for (const auto& scope : scopes_of_compilation_unit(unit_index.value())) {
         if (!scope.is_function || address < scope.address_low || address >= scope.address_high)
             continue;
         return scope;
@@ -365,7 +405,11 @@ Optional<DebugInfo::VariablesScope> DebugInfo::get_containing_function(u32 addre
 Vector<DebugInfo::SourcePosition> DebugInfo::source_lines_in_scope(const VariablesScope& scope) const
 {
     Vector<DebugInfo::SourcePosition> source_lines;
-    for (const auto& line : m_sorted_lines) {
+    auto unit_index = m_dwarf_info.compilation_unit_containing(scope.address_low);
+    if (!unit_index.has_value())
+        return source_lines;
+
+    for (const auto& line : lines_of_compilation_unit(unit_index.value())) {
         if (line.address < scope.address_low)
             continue;
 
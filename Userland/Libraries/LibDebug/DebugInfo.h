@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/Optional.h>
@@ -104,12 +105,14 @@ public:
     {
         FlyString previous_file = "";
         size_t previous_line = 0;
-        for (const auto& line_info : m_sorted_lines) {
-            if (line_info.file == previous_file && line_info.line == previous_line)
-                continue;
-            previous_file = line_info.file;
-            previous_line = line_info.line;
-            callback({ line_info.file, line_info.line, line_info.address });
+        for (size_t unit_index = 0; unit_index < m_dwarf_info.compilation_unit_count(); ++unit_index) {
+            for (const auto& line_info : lines_of_compilation_unit(unit_index)) {
+                if (line_info.file == previous_file && line_info.line == previous_line)
+                    continue;
+                previous_file = line_info.file;
+                previous_line = line_info.line;
+                callback({ line_info.file, line_info.line, line_info.address });
+            }
         }
     }
 
@@ -118,9 +121,12 @@ public:
     Optional<VariablesScope> get_containing_function(u32 address) const;
 
 private:
-    void prepare_variable_scopes();
-    void prepare_lines();
-    void parse_scopes_impl(const Dwarf::DIE& die);
+    // Scopes and lines are parsed separately for each compilation unit, the first time they're needed.
+    const Vector<VariablesScope>& scopes_of_compilation_unit(size_t index) const;
+    const Vector<Dwarf::LineProgram::LineInfo>& lines_of_compilation_unit(size_t index) const;
+    FlyString normalized_file_path(const FlyString&) const;
+
+    void parse_scopes_impl(const Dwarf::DIE& die, Vector<VariablesScope>&) const;
     OwnPtr<VariableInfo> create_variable_info(const Dwarf::DIE& variable_die, const PtraceRegisters&, u32 address_offset = 0) const;
     static bool is_variable_tag_supported(const Dwarf::EntryTag& tag);
     void add_type_info_to_variable(const Dwarf::DIE& type_die, const PtraceRegisters& regs, DebugInfo::VariableInfo* parent_variable) const;
@@ -130,8 +136,11 @@ private:
     FlatPtr m_base_address { 0 };
     Dwarf::DwarfInfo m_dwarf_info;
 
-    Vector<VariablesScope> m_scopes;
-    Vector<Dwarf::LineProgram::LineInfo> m_sorted_lines;
+    mutable Vector<Optional<Vector<VariablesScope>>> m_scopes_of_compilation_units;
+    // Each sorted by address.
+    mutable Vector<Optional<Vector<Dwarf::LineProgram::LineInfo>>> m_lines_of_compilation_units;
+    // Null for files whose lines we don't care about.
+    mutable HashMap<FlyString, FlyString> m_normalized_file_paths;
 };
 
 }
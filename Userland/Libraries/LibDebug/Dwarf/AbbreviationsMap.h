@@ -27,7 +27,7 @@ public:
         Vector<AttributeSpecification> attribute_specifications;
     };
 
-    Optional<AbbreviationEntry> get(u32 code) const;
+    const AbbreviationEntry* get(u32 code) const;
 
 private:
     void populate_map();
@@ -12,10 +12,16 @@ CompilationUnit::CompilationUnit(const DwarfInfo& dwarf_info, u32 offset, const
     : m_dwarf_info(dwarf_info)
     , m_offset(offset)
     , m_header(header)
-    , m_abbreviations(dwarf_info, header.abbrev_offset)
 {
 }
 
+const AbbreviationsMap& CompilationUnit::abbreviations_map() const
+{
+    if (!m_abbreviations)
+        m_abbreviations = make<AbbreviationsMap>(m_dwarf_info, m_header.abbrev_offset);
+    return *m_abbreviations;
+}
+
 DIE CompilationUnit::root_die() const
 {
     return DIE(*this, m_offset + sizeof(CompilationUnitHeader));
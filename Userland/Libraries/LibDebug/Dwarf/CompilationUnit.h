@@ -7,6 +7,7 @@
 #pragma once
 
 #include "AbbreviationsMap.h"
+#include <AK/OwnPtr.h>
 #include <AK/Types.h>
 
 namespace Debug::Dwarf {
@@ -24,13 +25,13 @@ public:
     DIE root_die() const;
 
     const DwarfInfo& dwarf_info() const { return m_dwarf_info; }
-    const AbbreviationsMap& abbreviations_map() const { return m_abbreviations; }
+    const AbbreviationsMap& abbreviations_map() const;
 
 private:
     const DwarfInfo& m_dwarf_info;
     u32 m_offset { 0 };
     CompilationUnitHeader m_header;
-    AbbreviationsMap m_abbreviations;
+    mutable OwnPtr<AbbreviationsMap> m_abbreviations;
 };
 
 }
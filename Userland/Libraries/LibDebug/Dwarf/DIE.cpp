@@ -25,14 +25,14 @@ DIE::DIE(const CompilationUnit& unit, u32 offset)
         // An abbreviation code of 0 ( = null DIE entry) means the end of a chain of siblings
         m_tag = EntryTag::None;
     } else {
-        auto abbreviation_info = m_compilation_unit.abbreviations_map().get(m_abbreviation_code);
-        VERIFY(abbreviation_info.has_value());
+        auto* abbreviation_info = m_compilation_unit.abbreviations_map().get(m_abbreviation_code);
+        VERIFY(abbreviation_info);
 
-        m_tag = abbreviation_info.value().tag;
-        m_has_children = abbreviation_info.value().has_children;
+        m_tag = abbreviation_info->tag;
+        m_has_children = abbreviation_info->has_children;
 
         // We iterate the attributes data only to calculate this DIE's size
-        for (auto& attribute_spec : abbreviation_info.value().attribute_specifications) {
+        for (auto& attribute_spec : abbreviation_info->attribute_specifications) {
             get_attribute_value(attribute_spec.form, stream);
         }
     }
@@ -193,10 +193,10 @@ Optional<DIE::AttributeValue> DIE::get_attribute(const Attribute& attribute) con
     InputMemoryStream stream { m_compilation_unit.dwarf_info().debug_info_data() };
     stream.discard_or_error(m_data_offset);
 
-    auto abbreviation_info = m_compilation_unit.abbreviations_map().get(m_abbreviation_code);
-    VERIFY(abbreviation_info.has_value());
+    auto* abbreviation_info = m_compilation_unit.abbreviations_map().get(m_abbreviation_code);
+    VERIFY(abbreviation_info);
 
-    for (const auto& attribute_spec : abbreviation_info.value().attribute_specifications) {
+    for (const auto& attribute_spec : abbreviation_info->attribute_specifications) {
         auto value = get_attribute_value(attribute_spec.form, stream);
         if (attribute_spec.attribute == attribute) {
             return value;
@@ -5,8 +5,11 @@
  */
 
 #include "DwarfInfo.h"
+#include "DIE.h"
 
 #include <AK/MemoryStream.h>
+#include <AK/NumericLimits.h>
+#include <AK/QuickSort.h>
 
 namespace Debug::Dwarf {
 
@@ -16,6 +19,9 @@ DwarfInfo::DwarfInfo(const ELF::Image& elf)
     m_debug_info_data = section_data(".debug_info");
     m_abbreviation_data = section_data(".debug_abbrev");
     m_debug_strings_data = section_data(".debug_str");
+    m_debug_line_data = section_data(".debug_line");
+    m_debug_address_ranges_data = section_data(".debug_aranges");
+    m_debug_ranges_data = section_data(".debug_ranges");
 
     populate_compilation_units();
 }
@@ -48,4 +54,112 @@ void DwarfInfo::populate_compilation_units()
     }
 }
 
+void DwarfInfo::populate_address_ranges() const
+{
+    m_has_populated_address_ranges = true;
+
+    HashMap<u32, size_t> compilation_unit_indices_by_offset;
+    for (size_t i = 0; i < m_compilation_units.size(); ++i)
+        compilation_unit_indices_by_offset.set(m_compilation_units[i].offset(), i);
+
+    if (m_debug_address_ranges_data.data()) {
+        InputMemoryStream stream { m_debug_address_ranges_data };
+        while (!stream.eof()) {
+            auto set_offset = stream.offset();
+            AddressRangeSetHeader set_header {};
+            stream >> Bytes { &set_header, sizeof(set_header) };
+            if (stream.handle_any_error())
+                break;
+            VERIFY(set_header.address_size == sizeof(u32));
+
+            auto set_end = set_offset + sizeof(u32) + set_header.length;
+            // The ranges themselves are aligned to the size of a range.
+            constexpr size_t range_size = 2 * sizeof(u32);
+            stream.discard_or_error((range_size - (stream.offset() - set_offset) % range_size) % range_size);
+
+            auto compilation_unit_index = compilation_unit_indices_by_offset.get(set_header.debug_info_offset);
+            while (stream.offset() + range_size <= set_end) {
+                u32 start = 0;
+                u32 length = 0;
+                stream >> start >> length;
+                if (!start && !length)
+                    break;
+                // Code that the linker discarded, like duplicates of inline functions, ends up at address 0.
+                if (!compilation_unit_index.has_value() || !start || !length)
+                    continue;
+                m_address_ranges.append({ start, start + length, compilation_unit_index.value() });
+            }
+            if (stream.offset() < set_end)
+                stream.discard_or_error(set_end - stream.offset());
+            if (stream.handle_any_error())
+                break;
+        }
+    } else {
+        // Without .debug_aranges, fall back to the ranges of each compilation unit's root DIE.
+        for (size_t i = 0; i < m_compilation_units.size(); ++i) {
+            auto root = m_compilation_units[i].root_die();
+            auto low_pc = root.get_attribute(Attribute::LowPc);
+            auto base_address = low_pc.has_value() ? low_pc.value().data.as_u32 : 0;
+            if (auto ranges = root.get_attribute(Attribute::Ranges); ranges.has_value()) {
+                add_address_ranges_from_range_list(ranges.value().data.as_u32, base_address, i);
+                continue;
+            }
+            auto high_pc = root.get_attribute(Attribute::HighPc);
+            if (!low_pc.has_value() || !high_pc.has_value() || !base_address)
+                continue;
+            // Like for other DIEs, HighPc is an offset from LowPc.
+            m_address_ranges.append({ base_address, base_address + high_pc.value().data.as_u32, i });
+        }
+    }
+
+    quick_sort(m_address_ranges, [](auto& a, auto& b) {
+        return a.start < b.start;
+    });
+}
+
+void DwarfInfo::add_address_ranges_from_range_list(u32 offset, u32 base_address, size_t compilation_unit_index) const
+{
+    if (offset >= m_debug_ranges_data.size())
+        return;
+
+    InputMemoryStream stream { m_debug_ranges_data };
+    stream.discard_or_error(offset);
+    while (!stream.eof()) {
+        u32 start = 0;
+        u32 end = 0;
+        stream >> start >> end;
+        if (stream.handle_any_error() || (!start && !end))
+            break;
+        // An entry like this changes the address that the following ones are relative to.
+        if (start == NumericLimits<u32>::max()) {
+            base_address = end;
+            continue;
+        }
+        if (!base_address && !start)
+            continue;
+        if (start < end)
+            m_address_ranges.append({ base_address + start, base_address + end, compilation_unit_index });
+    }
+}
+
+Optional<size_t> DwarfInfo::compilation_unit_containing(u32 address) const
+{
+    if (!m_has_populated_address_ranges)
+        populate_address_ranges();
+
+    // Find the last range that starts at or before the address.
+    size_t low = 0;
+    size_t high = m_address_ranges.size();
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        if (m_address_ranges[middle].start <= address)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    if (low == 0 || address >= m_address_ranges[low - 1].end)
+        return {};
+    return m_address_ranges[low - 1].compilation_unit_index;
+}
+
 }
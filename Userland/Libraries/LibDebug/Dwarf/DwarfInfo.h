@@ -23,12 +23,21 @@ public:
     ReadonlyBytes debug_info_data() const { return m_debug_info_data; }
     ReadonlyBytes abbreviation_data() const { return m_abbreviation_data; }
     ReadonlyBytes debug_strings_data() const { return m_debug_strings_data; }
+    ReadonlyBytes debug_line_data() const { return m_debug_line_data; }
+
+    size_t compilation_unit_count() const { return m_compilation_units.size(); }
+    const CompilationUnit& compilation_unit(size_t index) const { return m_compilation_units[index]; }
 
     template<typename Callback>
     void for_each_compilation_unit(Callback) const;
 
+    // Returns the index of the compilation unit whose code contains |address|, if any.
+    Optional<size_t> compilation_unit_containing(u32 address) const;
+
 private:
     void populate_compilation_units();
+    void populate_address_ranges() const;
+    void add_address_ranges_from_range_list(u32 offset, u32 base_address, size_t compilation_unit_index) const;
 
     ReadonlyBytes section_data(const String& section_name) const;
 
@@ -36,8 +45,21 @@ private:
     ReadonlyBytes m_debug_info_data;
     ReadonlyBytes m_abbreviation_data;
     ReadonlyBytes m_debug_strings_data;
+    ReadonlyBytes m_debug_line_data;
+    ReadonlyBytes m_debug_address_ranges_data;
+    ReadonlyBytes m_debug_ranges_data;
 
     Vector<Dwarf::CompilationUnit> m_compilation_units;
+
+    struct AddressRange {
+        u32 start { 0 };
+        u32 end { 0 };
+        size_t compilation_unit_index { 0 };
+    };
+
+    // Sorted by start address, and built the first time an address is looked up.
+    mutable Vector<AddressRange> m_address_ranges;
+    mutable bool m_has_populated_address_ranges { false };
 };
 
 template<typename Callback>
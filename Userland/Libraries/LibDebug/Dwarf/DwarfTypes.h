@@ -17,6 +17,14 @@ struct [[gnu::packed]] CompilationUnitHeader {
     u8 address_size;
 };
 
+struct [[gnu::packed]] AddressRangeSetHeader {
+    u32 length;
+    u16 version;
+    u32 debug_info_offset;
+    u8 address_size;
+    u8 segment_size;
+};
+
 enum class EntryTag : u16 {
     None = 0,
     ArrayType = 0x1,
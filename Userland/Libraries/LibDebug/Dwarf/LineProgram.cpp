@@ -73,14 +73,18 @@ void LineProgram::append_to_line_info()
     if (m_file_index >= m_source_files.size())
         return;
 
-    String directory = m_source_directories[m_source_files[m_file_index].directory_index];
+    auto& file = m_source_files[m_file_index];
+    if (file.full_path.is_null()) {
+        String directory = m_source_directories[file.directory_index];
 
-    StringBuilder full_path(directory.length() + m_source_files[m_file_index].name.length() + 1);
-    full_path.append(directory);
-    full_path.append('/');
-    full_path.append(m_source_files[m_file_index].name);
+        StringBuilder full_path(directory.length() + file.name.length() + 1);
+        full_path.append(directory);
+        full_path.append('/');
+        full_path.append(file.name);
+        file.full_path = full_path.to_string();
+    }
 
-    m_lines.append({ m_address, full_path.to_string(), m_line });
+    m_lines.append({ m_address, file.full_path, m_line });
 }
 
 void LineProgram::reset_registers()
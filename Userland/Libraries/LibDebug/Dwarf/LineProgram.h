@@ -74,6 +74,7 @@ private:
     struct FileEntry {
         FlyString name;
         size_t directory_index { 0 };
+        FlyString full_path {};
     };
 
     static constexpr u16 DWARF_VERSION = 3;
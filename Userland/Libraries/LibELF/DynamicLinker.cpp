@@ -43,9 +43,18 @@ LibCExitFunction g_libc_exit = nullptr;
 
 bool g_allowed_to_check_environment_variables { false };
 bool g_do_breakpoint_trap_before_entry { false };
+
+// While relocating at startup, the same few symbols (malloc, free, vtables of common classes, ...)
+// get looked up by every library that uses them. All objects are mapped before we start relocating,
+// so the result for a given name is always the same, and we can remember it, misses included.
+// The keys point into the string tables of the loaded objects, which stay mapped forever.
+// NOTE: The cache is dropped before jumping to the entry point, since lazy PLT binding
+//       can then happen on multiple threads at once.
+HashMap<StringView, Optional<DynamicObject::SymbolLookupResult>> g_global_symbol_cache;
+bool g_global_symbol_cache_enabled { true };
 }
 
-Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(const StringView& symbol)
+static Optional<DynamicObject::SymbolLookupResult> lookup_global_symbol_uncached(const StringView& symbol)
 {
     Optional<DynamicObject::SymbolLookupResult> weak_result;
 
@@ -65,6 +74,18 @@ Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(
     return weak_result;
 }
 
+Optional<DynamicObject::SymbolLookupResult> DynamicLinker::lookup_global_symbol(const StringView& symbol)
+{
+    if (!g_global_symbol_cache_enabled)
+        return lookup_global_symbol_uncached(symbol);
+
+    if (auto it = g_global_symbol_cache.find(symbol); it != g_global_symbol_cache.end())
+        return it->value;
+    auto result = lookup_global_symbol_uncached(symbol);
+    g_global_symbol_cache.set(symbol, result);
+    return result;
+}
+
 static void map_library(const String& name, int fd)
 {
     auto loader = ELF::DynamicLoader::try_create(fd, name);
@@ -294,6 +315,8 @@ void ELF::DynamicLinker::linker_main(String&& main_program_name, int main_progra
     }();
 
     g_loaders.clear();
+    g_global_symbol_cache_enabled = false;
+    g_global_symbol_cache.clear();
 
     int rc = syscall(SC_msyscall, nullptr);
     if (rc < 0) {
@@ -219,6 +219,9 @@ private:
         Optional<Image::Symbol> symbol;
     };
 
+    // Sorts the symbols by address on first use, then finds the first one that starts past |address|.
+    size_t index_of_first_sorted_symbol_after(u32 address) const;
+
     mutable Vector<SortedSymbol> m_sorted_symbols;
 };
 
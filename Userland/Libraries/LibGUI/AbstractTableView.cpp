@@ -50,24 +50,29 @@ void AbstractTableView::select_all()
     }
 }
 
-void AbstractTableView::auto_resize_column(int column)
+int AbstractTableView::first_visible_row() const
 {
-    if (!model())
-        return;
+    return min(vertical_scrollbar().value() / row_height(), item_count());
+}
 
-    if (!column_header().is_section_visible(column))
-        return;
+int AbstractTableView::last_visible_row() const
+{
+    int visible_height = available_size().height();
+    if (visible_height <= 0)
+        return first_visible_row() - 1;
+    return min((vertical_scrollbar().value() + visible_height - 1) / row_height(), item_count() - 1);
+}
 
+int AbstractTableView::measure_column(int column, bool& has_cell_content) const
+{
     auto& model = *this->model();
-    int row_count = model.row_count();
-
     int header_width = m_column_header->font().width(model.column_name(column));
     if (column == m_key_column && model.is_column_sortable(column))
-        header_width += font().width(" \xE2\xAC\x86");
+        header_width += font().width(" \xE2\xAC\x86"); // UPWARDS BLACK ARROW
 
     int column_width = header_width;
-    bool is_empty = true;
-    for (int row = 0; row < row_count; ++row) {
+    has_cell_content = false;
+    for (int row = first_visible_row(), last_row = last_visible_row(); row <= last_row; ++row) {
         auto cell_data = model.index(row, column).data();
         int cell_width = 0;
         if (cell_data.is_icon()) {
@@ -77,45 +82,52 @@ void AbstractTableView::auto_resize_column(int column)
         } else if (cell_data.is_valid()) {
             cell_width = font().width(cell_data.to_string());
         }
-        if (is_empty && cell_width > 0)
-            is_empty = false;
+        if (cell_width > 0)
+            has_cell_content = true;
         column_width = max(column_width, cell_width);
     }
+    return column_width;
+}
+
+void AbstractTableView::auto_resize_column(int column)
+{
+    if (!model())
+        return;
+
+    if (!column_header().is_section_visible(column))
+        return;
+
+    int first_row = first_visible_row();
+    int last_row = last_visible_row();
+    if (first_row <= last_row)
+        model()->prefetch_rows(first_row, last_row);
+
+    bool has_cell_content;
+    int column_width = measure_column(column, has_cell_content);
 
     auto default_column_size = column_header().default_section_size(column);
-    if (is_empty && column_header().is_default_section_size_initialized(column))
+    if (!has_cell_content && column_header().is_default_section_size_initialized(column))
         column_header().set_section_size(column, default_column_size);
     else
         column_header().set_section_size(column, column_width);
 }
+
 void AbstractTableView::update_column_sizes()
 {
     if (!model())
         return;
 
-    auto& model = *this->model();
-    int column_count = model.column_count();
-    int row_count = model.row_count();
+    int first_row = first_visible_row();
+    int last_row = last_visible_row();
+    if (first_row <= last_row)
+        model()->prefetch_rows(first_row, last_row);
 
+    int column_count = model()->column_count();
     for (int column = 0; column < column_count; ++column) {
         if (!column_header().is_section_visible(column))
             continue;
-        int header_width = m_column_header->font().width(model.column_name(column));
-        if (column == m_key_column && model.is_column_sortable(column))
-            header_width += font().width(" \xE2\xAC\x86"); // UPWARDS BLACK ARROW
-        int column_width = header_width;
-        for (int row = 0; row < row_count; ++row) {
-            auto cell_data = model.index(row, column).data();
-            int cell_width = 0;
-            if (cell_data.is_icon()) {
-                cell_width = cell_data.as_icon().bitmap_for_size(16)->width();
-            } else if (cell_data.is_bitmap()) {
-                cell_width = cell_data.as_bitmap().width();
-            } else if (cell_data.is_valid()) {
-                cell_width = font().width(cell_data.to_string());
-            }
-            column_width = max(column_width, cell_width);
-        }
+        bool has_cell_content;
+        int column_width = measure_column(column, has_cell_content);
         column_header().set_section_size(column, max(m_column_header->section_size(column), column_width));
     }
 }
@@ -218,17 +230,18 @@ ModelIndex AbstractTableView::index_at_event_position(const Gfx::IntPoint& posit
         return {};
 
     auto adjusted_position = this->adjusted_position(position);
-    for (int row = 0, row_count = model()->row_count(); row < row_count; ++row) {
-        if (!row_rect(row).contains(adjusted_position))
+    int rows_y = column_header().is_visible() ? column_header().height() : 0;
+    if (adjusted_position.y() < rows_y)
+        return {};
+    int row = (adjusted_position.y() - rows_y) / row_height();
+    if (row >= model()->row_count() || !row_rect(row).contains(adjusted_position))
+        return {};
+    for (int column = 0, column_count = model()->column_count(); column < column_count; ++column) {
+        if (!content_rect(row, column).contains(adjusted_position))
             continue;
-        for (int column = 0, column_count = model()->column_count(); column < column_count; ++column) {
-            if (!content_rect(row, column).contains(adjusted_position))
-                continue;
-            return model()->index(row, column);
-        }
-        return model()->index(row, 0);
+        return model()->index(row, column);
     }
-    return {};
+    return model()->index(row, 0);
 }
 
 ModelIndex AbstractTableView::index_at_event_position(const Gfx::IntPoint& position) const
@@ -332,6 +345,8 @@ void AbstractTableView::model_did_update(unsigned flags)
 void AbstractTableView::resize_event(ResizeEvent& event)
 {
     AbstractView::resize_event(event);
+    // Column sizes only account for the rows on screen, and there may be more of those now.
+    update_column_sizes();
     layout_headers();
 }
 
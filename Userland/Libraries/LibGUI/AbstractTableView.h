@@ -92,12 +92,18 @@ protected:
     virtual void update_row_sizes();
     virtual int item_count() const;
 
+    // The rows that are at least partly within the viewport. Only these are ever painted or measured, so that both
+    // take the same time no matter how many rows the model has.
+    int first_visible_row() const;
+    int last_visible_row() const;
+
     TableCellPaintingDelegate* column_painting_delegate(int column) const;
 
     void move_cursor_relative(int vertical_steps, int horizontal_steps, SelectionUpdate);
 
 private:
     void layout_headers();
+    int measure_column(int column, bool& has_cell_content) const;
 
     RefPtr<HeaderView> m_column_header;
     RefPtr<HeaderView> m_row_header;
@@ -14,20 +14,20 @@ namespace GUI {
 
 class DisplayLinkCallback : public RefCounted<DisplayLinkCallback> {
 public:
-    DisplayLinkCallback(i32 link_id, Function<void(i32)> callback)
+    DisplayLinkCallback(i32 link_id, Function<void(i32, i64)> callback)
         : m_link_id(link_id)
         , m_callback(move(callback))
     {
     }
 
-    void invoke()
+    void invoke(i64 frame_time_in_microseconds)
     {
-        m_callback(m_link_id);
+        m_callback(m_link_id, frame_time_in_microseconds);
     }
 
 private:
     i32 m_link_id { 0 };
-    Function<void(i32)> m_callback;
+    Function<void(i32, i64)> m_callback;
 };
 
 static HashMap<i32, RefPtr<DisplayLinkCallback>>& callbacks()
@@ -40,7 +40,7 @@ static HashMap<i32, RefPtr<DisplayLinkCallback>>& callbacks()
 
 static i32 s_next_callback_id = 1;
 
-i32 DisplayLink::register_callback(Function<void(i32)> callback)
+i32 DisplayLink::register_callback(Function<void(i32, i64)> callback)
 {
     if (callbacks().is_empty())
         WindowServerConnection::the().post_message(Messages::WindowServer::EnableDisplayLink());
@@ -62,11 +62,11 @@ bool DisplayLink::unregister_callback(i32 callback_id)
     return true;
 }
 
-void DisplayLink::notify(Badge<WindowServerConnection>)
+void DisplayLink::notify(Badge<WindowServerConnection>, i64 frame_time_in_microseconds)
 {
     auto copy_of_callbacks = callbacks();
     for (auto& it : copy_of_callbacks)
-        it.value->invoke();
+        it.value->invoke(frame_time_in_microseconds);
 }
 
 }
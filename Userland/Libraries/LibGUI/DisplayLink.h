@@ -13,10 +13,11 @@ namespace GUI {
 
 class DisplayLink {
 public:
-    static i32 register_callback(Function<void(i32)>);
+    // The callback gets its ID, and the time of the frame it is called for, in microseconds of the monotonic clock.
+    static i32 register_callback(Function<void(i32, i64)>);
     static bool unregister_callback(i32 callback_id);
 
-    static void notify(Badge<WindowServerConnection>);
+    static void notify(Badge<WindowServerConnection>, i64 frame_time_in_microseconds);
 };
 
 }
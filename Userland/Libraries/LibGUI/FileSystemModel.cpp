@@ -15,6 +15,8 @@
 #include <LibGUI/FileSystemModel.h>
 #include <LibGUI/Painter.h>
 #include <LibGfx/Bitmap.h>
+#include <LibGfx/JPGLoader.h>
+#include <LibGfx/PNGWriter.h>
 #include <LibThread/BackgroundAction.h>
 #include <grp.h>
 #include <pwd.h>
@@ -230,6 +232,7 @@ FileSystemModel::FileSystemModel(String root_path, Mode mode)
 
 FileSystemModel::~FileSystemModel()
 {
+    cancel_pending_thumbnails();
 }
 
 String FileSystemModel::name_for_uid(uid_t uid) const
@@ -304,6 +307,7 @@ void FileSystemModel::set_root_path(String root_path)
         m_root_path = {};
     else
         m_root_path = LexicalPath::canonicalized_path(move(root_path));
+    cancel_pending_thumbnails();
     update();
 
     if (m_root->has_error()) {
@@ -492,20 +496,56 @@ Icon FileSystemModel::icon_for(const Node& node) const
 
 static HashMap<String, RefPtr<Gfx::Bitmap>> s_thumbnail_cache;
 
-static RefPtr<Gfx::Bitmap> render_thumbnail(const StringView& path)
+static const Gfx::IntSize thumbnail_size { 32, 32 };
+
+// Thumbnails are kept on disk too, so a directory full of images doesn't have to be decoded again every time it's
+// opened. A file that changes gets a new cache entry, since its modification time and size are part of the name.
+static String thumbnail_cache_path(const String& path, time_t mtime, size_t size)
+{
+    return String::formatted("{}/.cache/thumbnails/{:08x}-{}-{}.png", Core::StandardPaths::home_directory(), path.hash(), mtime, size);
+}
+
+static RefPtr<Gfx::Bitmap> render_thumbnail(const String& path, time_t mtime, size_t size, bool write_to_cache)
 {
-    auto png_bitmap = Gfx::Bitmap::load_from_file(path);
-    if (!png_bitmap)
+    auto cache_path = thumbnail_cache_path(path, mtime, size);
+    if (access(cache_path.characters(), R_OK) == 0) {
+        auto cached_thumbnail = Gfx::Bitmap::load_from_file(cache_path);
+        if (cached_thumbnail && cached_thumbnail->size() == thumbnail_size)
+            return cached_thumbnail;
+    }
+
+    // JPEGs can be decoded straight to a fraction of their size, which is all a thumbnail needs.
+    auto lowercase_path = path.to_lowercase();
+    RefPtr<Gfx::Bitmap> bitmap;
+    if (lowercase_path.ends_with(".jpg") || lowercase_path.ends_with(".jpeg"))
+        bitmap = Gfx::load_jpg_downscaled(path, thumbnail_size);
+    else
+        bitmap = Gfx::Bitmap::load_from_file(path);
+    if (!bitmap)
         return nullptr;
 
-    double scale = min(32 / (double)png_bitmap->width(), 32 / (double)png_bitmap->height());
+    double scale = min(thumbnail_size.width() / (double)bitmap->width(), thumbnail_size.height() / (double)bitmap->height());
 
-    auto thumbnail = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { 32, 32 });
-    Gfx::IntRect destination = Gfx::IntRect(0, 0, (int)(png_bitmap->width() * scale), (int)(png_bitmap->height() * scale));
+    auto thumbnail = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, thumbnail_size);
+    Gfx::IntRect destination = Gfx::IntRect(0, 0, (int)(bitmap->width() * scale), (int)(bitmap->height() * scale));
     destination.center_within(thumbnail->rect());
 
     Painter painter(*thumbnail);
-    painter.draw_scaled_bitmap(destination, *png_bitmap, png_bitmap->rect());
+    painter.draw_scaled_bitmap(destination, *bitmap, bitmap->rect());
+
+    // If the thumbnail can't be cached, it's simply rendered again next time. It's written under a temporary name
+    // first, so nobody ever reads a half-written one.
+    if (write_to_cache && Core::File::ensure_parent_directories(cache_path)) {
+        auto temporary_path = String::formatted("{}.{}", cache_path, getpid());
+        auto file_or_error = Core::File::open(temporary_path, Core::IODevice::WriteOnly);
+        if (!file_or_error.is_error()) {
+            auto encoded_thumbnail = Gfx::PNGWriter::encode(*thumbnail);
+            bool wrote_thumbnail = file_or_error.value()->write(encoded_thumbnail.data(), encoded_thumbnail.size());
+            file_or_error.value()->close();
+            if (!wrote_thumbnail || rename(temporary_path.characters(), cache_path.characters()) < 0)
+                unlink(temporary_path.characters());
+        }
+    }
     return thumbnail;
 }
 
@@ -524,15 +564,17 @@ bool FileSystemModel::fetch_thumbnail_for(const Node& node)
 
     // Otherwise, arrange to render the thumbnail
     // in background and make it available later.
+    // Thumbnails are only asked for when their items are painted, so these are the ones in view. They're rendered
+    // on the shared thread pool, so several of them are decoded at once.
 
     s_thumbnail_cache.set(path, nullptr);
     m_thumbnail_progress_total++;
 
     auto weak_this = make_weak_ptr();
 
-    LibThread::BackgroundAction<RefPtr<Gfx::Bitmap>>::create(
-        [path] {
-            return render_thumbnail(path);
+    auto action = LibThread::BackgroundAction<RefPtr<Gfx::Bitmap>>::create(
+        [path, mtime = node.mtime, size = node.size, write_to_cache = m_writes_thumbnail_cache] {
+            return render_thumbnail(path, mtime, size, write_to_cache);
         },
 
         [this, path, weak_this](auto thumbnail) {
@@ -543,6 +585,7 @@ bool FileSystemModel::fetch_thumbnail_for(const Node& node)
             if (weak_this.is_null())
                 return;
 
+            m_pending_thumbnails.remove(path);
             m_thumbnail_progress++;
             if (on_thumbnail_progress)
                 on_thumbnail_progress(m_thumbnail_progress, m_thumbnail_progress_total);
@@ -553,10 +596,24 @@ bool FileSystemModel::fetch_thumbnail_for(const Node& node)
 
             did_update();
         });
+    m_pending_thumbnails.set(path, move(action));
 
     return false;
 }
 
+void FileSystemModel::cancel_pending_thumbnails()
+{
+    // The thumbnails of whatever was shown before shouldn't hold up the ones that are shown now.
+    for (auto& it : m_pending_thumbnails) {
+        it.value->cancel();
+        // Forget the placeholder, so the thumbnail is fetched again if it's needed after all.
+        s_thumbnail_cache.remove(it.key);
+    }
+    m_pending_thumbnails.clear();
+    m_thumbnail_progress = 0;
+    m_thumbnail_progress_total = 0;
+}
+
 int FileSystemModel::column_count(const ModelIndex&) const
 {
     return Column::__Count;
@@ -11,6 +11,7 @@
 #include <LibCore/DateTime.h>
 #include <LibCore/FileWatcher.h>
 #include <LibGUI/Model.h>
+#include <LibThread/BackgroundAction.h>
 #include <string.h>
 #include <sys/stat.h>
 #include <time.h>
@@ -142,6 +143,11 @@ public:
     bool should_show_dotfiles() const { return m_should_show_dotfiles; }
     void set_should_show_dotfiles(bool);
 
+    // Thumbnails are always looked for in the on-disk cache, but only added to it if this is set, since that needs
+    // the "cpath" and "wpath" promises.
+    bool writes_thumbnail_cache() const { return m_writes_thumbnail_cache; }
+    void set_writes_thumbnail_cache(bool writes_thumbnail_cache) { m_writes_thumbnail_cache = writes_thumbnail_cache; }
+
 private:
     FileSystemModel(String root_path, Mode);
 
@@ -152,16 +158,19 @@ private:
     HashMap<gid_t, String> m_group_names;
 
     bool fetch_thumbnail_for(const Node& node);
+    void cancel_pending_thumbnails();
     GUI::Icon icon_for(const Node& node) const;
 
     String m_root_path;
     Mode m_mode { Invalid };
     OwnPtr<Node> m_root { nullptr };
 
+    HashMap<String, NonnullRefPtr<LibThread::BackgroundAction<RefPtr<Gfx::Bitmap>>>> m_pending_thumbnails;
     unsigned m_thumbnail_progress { 0 };
     unsigned m_thumbnail_progress_total { 0 };
 
     bool m_should_show_dotfiles { false };
+    bool m_writes_thumbnail_cache { false };
 };
 
 }
@@ -66,6 +66,11 @@ public:
     virtual bool accepts_drag(const ModelIndex&, const Vector<String>& mime_types) const;
     virtual Vector<ModelIndex, 1> matches(const StringView&, unsigned = MatchesFlag::AllMatching, const ModelIndex& = ModelIndex()) { return {}; }
 
+    // Views call this before asking for the data of a range of rows, and they only ever ask for the rows on screen.
+    // Models that produce their data on demand, e.g. from a file or a database, can fetch the whole range in one go
+    // here, and leave every other row alone until it is scrolled into view.
+    virtual void prefetch_rows([[maybe_unused]] int first_row, [[maybe_unused]] int last_row, [[maybe_unused]] const ModelIndex& parent = {}) { }
+
     virtual bool is_column_sortable([[maybe_unused]] int column_index) const { return true; }
     virtual void sort([[maybe_unused]] int column, SortOrder) { }
 
@@ -16,10 +16,10 @@ Painter::Painter(Gfx::Bitmap& bitmap)
 }
 
 Painter::Painter(Widget& widget)
-    : Painter(*widget.window()->back_bitmap())
+    : Painter(*widget.window()->paint_target())
 {
     state().font = &widget.font();
-    auto origin_rect = widget.window_relative_rect();
+    auto origin_rect = widget.window_relative_rect().translated(-widget.window()->paint_target_origin());
     state().translation = origin_rect.location();
     state().clip_rect = origin_rect;
     m_clip_origin = origin_rect;
@@ -177,9 +177,11 @@ void SortingProxyModel::sort_mapping(Mapping& mapping, int column, SortOrder sor
     for (int i = 0; i < row_count; ++i)
         mapping.source_rows[i] = i;
 
-    quick_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
-        bool is_less_than = less_than(source().index(row1, column, mapping.source_parent), source().index(row2, column, mapping.source_parent));
-        return sort_order == SortOrder::Ascending ? is_less_than : !is_less_than;
+    // Use a stable sort so that rows which compare equal keep their relative order across re-sorts.
+    merge_sort(mapping.source_rows, [&](auto row1, auto row2) -> bool {
+        auto index1 = source().index(row1, column, mapping.source_parent);
+        auto index2 = source().index(row2, column, mapping.source_parent);
+        return sort_order == SortOrder::Ascending ? less_than(index1, index2) : less_than(index2, index1);
     });
 
     for (int i = 0; i < row_count; ++i)
@@ -54,14 +54,10 @@ void TableView::paint_event(PaintEvent& event)
     int x_offset = row_header().is_visible() ? row_header().width() : 0;
     int y_offset = column_header().is_visible() ? column_header().height() : 0;
 
-    bool dummy;
-    int first_visible_row = index_at_event_position(frame_inner_rect().top_left().translated(x_offset, y_offset), dummy).row();
-    int last_visible_row = index_at_event_position(frame_inner_rect().bottom_right().translated(x_offset, y_offset), dummy).row();
-
-    if (first_visible_row == -1)
-        first_visible_row = 0;
-    if (last_visible_row == -1)
-        last_visible_row = model()->row_count() - 1;
+    int first_visible_row = this->first_visible_row();
+    int last_visible_row = this->last_visible_row();
+    if (first_visible_row <= last_visible_row)
+        model()->prefetch_rows(first_visible_row, last_visible_row);
 
     int painted_item_index = first_visible_row;
 
@@ -164,13 +164,13 @@ TextDocumentLine::TextDocumentLine(TextDocument& document, const StringView& tex
 void TextDocumentLine::clear(TextDocument& document)
 {
     m_text.clear();
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::set_text(TextDocument& document, const Vector<u32> text)
 {
     m_text = move(text);
-    document.update_views({});
+    did_change(document);
 }
 
 bool TextDocumentLine::set_text(TextDocument& document, const StringView& text)
@@ -184,9 +184,10 @@ bool TextDocumentLine::set_text(TextDocument& document, const StringView& text)
     if (!utf8_view.validate()) {
         return false;
     }
+    m_text.ensure_capacity(text.length());
     for (auto code_point : utf8_view)
         m_text.append(code_point);
-    document.update_views({});
+    did_change(document);
     return true;
 }
 
@@ -195,7 +196,7 @@ void TextDocumentLine::append(TextDocument& document, const u32* code_points, si
     if (length == 0)
         return;
     m_text.append(code_points, length);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::append(TextDocument& document, u32 code_point)
@@ -215,7 +216,7 @@ void TextDocumentLine::insert(TextDocument& document, size_t index, u32 code_poi
     } else {
         m_text.insert(index, code_point);
     }
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::remove(TextDocument& document, size_t index)
@@ -225,7 +226,7 @@ void TextDocumentLine::remove(TextDocument& document, size_t index)
     } else {
         m_text.remove(index);
     }
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t length)
@@ -239,12 +240,18 @@ void TextDocumentLine::remove_range(TextDocument& document, size_t start, size_t
     for (size_t i = (start + length); i < m_text.size(); ++i)
         new_data.append(m_text[i]);
     m_text = move(new_data);
-    document.update_views({});
+    did_change(document);
 }
 
 void TextDocumentLine::truncate(TextDocument& document, size_t length)
 {
     m_text.resize(length);
+    did_change(document);
+}
+
+void TextDocumentLine::did_change(TextDocument& document)
+{
+    m_generation = document.next_line_generation({});
     document.update_views({});
 }
 
@@ -82,6 +82,7 @@ public:
     void unregister_client(Client&);
 
     void update_views(Badge<TextDocumentLine>);
+    u64 next_line_generation(Badge<TextDocumentLine>) { return ++m_line_generation; }
 
     String text() const;
     String text_in_range(const TextRange&) const;
@@ -144,6 +145,8 @@ private:
 
     bool m_regex_needs_update { true };
     String m_regex_needle;
+
+    u64 m_line_generation { 0 };
 };
 
 class TextDocumentLine {
@@ -174,9 +177,16 @@ public:
     bool is_empty() const { return length() == 0; }
     size_t leading_spaces() const;
 
+    // Every change to the line's text gives it a new generation, which no other line of the same document has had.
+    // Views use it to tell which lines they need to lay out again.
+    u64 generation() const { return m_generation; }
+
 private:
+    void did_change(TextDocument&);
+
     // NOTE: This vector is null terminated.
     Vector<u32> m_text;
+    u64 m_generation { 0 };
 };
 
 class TextDocumentUndoCommand : public Command {
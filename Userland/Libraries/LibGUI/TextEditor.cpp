@@ -1434,7 +1434,7 @@ void TextEditor::theme_change_event(ThemeChangeEvent& event)
 {
     ScrollableWidget::theme_change_event(event);
     if (m_highlighter)
-        m_highlighter->rehighlight(palette());
+        m_highlighter->rehighlight_from_scratch(palette());
 }
 
 void TextEditor::set_selection(const TextRange& selection)
@@ -1464,16 +1464,32 @@ void TextEditor::recompute_all_visual_lines()
 
     m_reflow_requested = false;
 
+    // Wrapped lines have to be laid out again whenever the width they are wrapped to changes. Otherwise, only the
+    // lines whose text changed since they were last laid out are.
+    int wrapping_width = is_wrapping_enabled() ? visible_text_rect_in_inner_coordinates().width() : 0;
+    if (wrapping_width != m_wrapping_width) {
+        m_wrapping_width = wrapping_width;
+        invalidate_all_visual_lines();
+    }
+
     int y_offset = 0;
     for (size_t line_index = 0; line_index < line_count(); ++line_index) {
-        recompute_visual_lines(line_index);
-        m_line_visual_data[line_index].visual_rect.set_y(y_offset);
-        y_offset += m_line_visual_data[line_index].visual_rect.height();
+        auto& visual_data = m_line_visual_data[line_index];
+        if (visual_data.line_generation != document().line(line_index).generation())
+            recompute_visual_lines(line_index);
+        visual_data.visual_rect.set_y(y_offset);
+        y_offset += visual_data.visual_rect.height();
     }
 
     update_content_size();
 }
 
+void TextEditor::invalidate_all_visual_lines()
+{
+    for (auto& visual_data : m_line_visual_data)
+        visual_data.line_generation = 0;
+}
+
 void TextEditor::ensure_cursor_is_valid()
 {
     auto new_cursor = m_cursor;
@@ -1503,6 +1519,7 @@ void TextEditor::recompute_visual_lines(size_t line_index)
     auto& visual_data = m_line_visual_data[line_index];
 
     visual_data.visual_line_breaks.clear_with_capacity();
+    visual_data.line_generation = line.generation();
 
     int available_width = visible_text_rect_in_inner_coordinates().width();
 
@@ -1584,6 +1601,7 @@ void TextEditor::set_wrapping_mode(WrappingMode mode)
 
     m_wrapping_mode = mode;
     horizontal_scrollbar().set_visible(m_wrapping_mode == WrappingMode::NoWrap);
+    invalidate_all_visual_lines();
     update_content_size();
     recompute_all_visual_lines();
     update();
@@ -1597,6 +1615,7 @@ void TextEditor::add_custom_context_menu_action(Action& action)
 void TextEditor::did_change_font()
 {
     vertical_scrollbar().set_step(line_height());
+    invalidate_all_visual_lines();
     recompute_all_visual_lines();
     update();
     ScrollableWidget::did_change_font();
@@ -270,6 +270,7 @@ private:
     Gfx::IntRect ruler_rect_in_inner_coordinates() const;
     Gfx::IntRect visible_text_rect_in_inner_coordinates() const;
     void recompute_all_visual_lines();
+    void invalidate_all_visual_lines();
     void ensure_cursor_is_valid();
     void flush_pending_change_notification_if_needed();
 
@@ -321,6 +322,7 @@ private:
 
     size_t m_reflow_deferred { 0 };
     bool m_reflow_requested { false };
+    int m_wrapping_width { 0 };
 
     bool is_visual_data_up_to_date() const { return !m_reflow_requested; }
 
@@ -334,6 +336,8 @@ private:
     struct LineVisualData {
         Vector<size_t, 1> visual_line_breaks;
         Gfx::IntRect visual_rect;
+        // The generation of the line's text that this was computed for, or 0 if it needs to be computed again.
+        u64 line_generation { 0 };
     };
 
     NonnullOwnPtrVector<LineVisualData> m_line_visual_data;
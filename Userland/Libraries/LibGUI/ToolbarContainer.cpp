@@ -18,6 +18,7 @@ ToolbarContainer::ToolbarContainer(Gfx::Orientation orientation)
     : m_orientation(orientation)
 {
     set_fill_with_background_color(true);
+    set_cached_rendering(true);
 
     set_frame_thickness(2);
     set_frame_shape(Gfx::FrameShape::Box);
@@ -33,6 +33,12 @@ TreeView::MetadataForIndex& TreeView::ensure_metadata_for_index(const ModelIndex
     return new_metadata_ref;
 }
 
+bool TreeView::is_open(const ModelIndex& index) const
+{
+    auto it = m_view_metadata.find(index.internal_data());
+    return it != m_view_metadata.end() && it->value->open;
+}
+
 TreeView::TreeView()
 {
     set_fill_with_background_color(true);
@@ -51,22 +57,14 @@ ModelIndex TreeView::index_at_event_position(const Gfx::IntPoint& a_position, bo
 {
     auto position = a_position.translated(0, -column_header().height()).translated(horizontal_scrollbar().value() - frame_thickness(), vertical_scrollbar().value() - frame_thickness());
     is_toggle = false;
-    if (!model())
+    if (!model() || position.y() < 0)
         return {};
-    ModelIndex result;
-    traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect& rect, const Gfx::IntRect& toggle_rect, int) {
-        if (toggle_rect.contains(position)) {
-            result = index;
-            is_toggle = true;
-            return IterationDecision::Break;
-        }
-        if (rect.contains_vertically(position.y())) {
-            result = index;
-            return IterationDecision::Break;
-        }
-        return IterationDecision::Continue;
-    });
-    return result;
+    auto& rows = rows_in_paint_order();
+    size_t row = position.y() / row_height();
+    if (row >= rows.size())
+        return {};
+    is_toggle = toggle_rect(row).contains(position);
+    return rows[row].index;
 }
 
 void TreeView::doubleclick_event(MouseEvent& event)
@@ -93,6 +91,7 @@ void TreeView::set_open_state_of_all_in_subtree(const ModelIndex& root, bool ope
 {
     if (root.is_valid()) {
         ensure_metadata_for_index(root).open = open;
+        invalidate_rows();
         if (model()->row_count(root)) {
             if (on_toggle)
                 on_toggle(root, open);
@@ -114,6 +113,7 @@ void TreeView::expand_all_parents_of(const ModelIndex& index)
     auto current = index;
     while (current.is_valid()) {
         ensure_metadata_for_index(current).open = true;
+        invalidate_rows();
         if (on_toggle)
             on_toggle(current, true);
         current = current.parent();
@@ -148,6 +148,7 @@ void TreeView::toggle_index(const ModelIndex& index)
     VERIFY(model()->row_count(index));
     auto& metadata = ensure_metadata_for_index(index);
     metadata.open = !metadata.open;
+    invalidate_rows();
     if (on_toggle)
         on_toggle(index, metadata.open);
     update_column_sizes();
@@ -155,56 +156,96 @@ void TreeView::toggle_index(const ModelIndex& index)
     update();
 }
 
-template<typename Callback>
-void TreeView::traverse_in_paint_order(Callback callback) const
+const Vector<TreeView::Row>& TreeView::rows_in_paint_order() const
 {
-    VERIFY(model());
-    auto& model = *this->model();
-    int indent_level = 1;
-    int y_offset = 0;
-    int tree_column_x_offset = this->tree_column_x_offset();
+    if (m_rows_are_valid)
+        return m_rows;
+    m_rows_are_valid = true;
+    m_rows.clear_with_capacity();
+    if (!model())
+        return m_rows;
 
-    Function<IterationDecision(const ModelIndex&)> traverse_index = [&](const ModelIndex& index) {
-        int row_count_at_index = model.row_count(index);
-        if (index.is_valid()) {
-            auto& metadata = ensure_metadata_for_index(index);
-            int x_offset = tree_column_x_offset + horizontal_padding() + indent_level * indent_width_in_pixels();
-            auto node_text = index.data().to_string();
-            Gfx::IntRect rect = {
-                x_offset, y_offset,
-                icon_size() + icon_spacing() + text_padding() + font_for_index(index)->width(node_text) + text_padding(), row_height()
-            };
-            Gfx::IntRect toggle_rect;
-            if (row_count_at_index > 0) {
-                int toggle_x = tree_column_x_offset + horizontal_padding() + (indent_width_in_pixels() * indent_level) - (icon_size() / 2) - 4;
-                toggle_rect = { toggle_x, rect.y(), toggle_size(), toggle_size() };
-                toggle_rect.center_vertically_within(rect);
-            }
-            if (callback(index, rect, toggle_rect, indent_level) == IterationDecision::Break)
-                return IterationDecision::Break;
-            y_offset += row_height();
-            // NOTE: Skip traversing children if this index is closed!
-            if (!metadata.open)
-                return IterationDecision::Continue;
+    auto& model = *this->model();
+    Function<void(const ModelIndex&, int)> add_rows = [&](const ModelIndex& parent, int indent_level) {
+        int row_count = model.row_count(parent);
+        for (int i = 0; i < row_count; ++i) {
+            auto index = model.index(i, model.tree_column(), parent);
+            m_rows.append({ index, indent_level });
+            // NOTE: Skip the children if this index is closed!
+            if (is_open(index))
+                add_rows(index, indent_level + 1);
         }
+    };
+    add_rows({}, 1);
+    return m_rows;
+}
 
-        if (indent_level > 0 && !index.is_valid())
-            return IterationDecision::Continue;
+Optional<size_t> TreeView::row_of(const ModelIndex& index) const
+{
+    auto& rows = rows_in_paint_order();
+    for (size_t row = 0; row < rows.size(); ++row) {
+        if (rows[row].index == index)
+            return row;
+    }
+    return {};
+}
 
-        ++indent_level;
-        int row_count = model.row_count(index);
-        for (int i = 0; i < row_count; ++i) {
-            if (traverse_index(model.index(i, model.tree_column(), index)) == IterationDecision::Break)
-                return IterationDecision::Break;
+template<typename Callback>
+void TreeView::for_each_visible_row(Callback callback) const
+{
+    auto& rows = rows_in_paint_order();
+    int visible_height = available_size().height();
+    if (rows.is_empty() || visible_height <= 0)
+        return;
+    size_t first_row = vertical_scrollbar().value() / row_height();
+    size_t end_row = min(rows.size(), static_cast<size_t>((vertical_scrollbar().value() + visible_height - 1) / row_height() + 1));
+    for (size_t row = first_row; row < end_row; ++row)
+        callback(row, rows[row]);
+}
+
+void TreeView::prefetch_visible_rows()
+{
+    // Siblings that are next to each other on screen are fetched together.
+    ModelIndex parent;
+    int first_row = -1;
+    int last_row = -1;
+    for_each_visible_row([&](size_t, const Row& row) {
+        auto row_parent = row.index.parent();
+        if (first_row != -1 && row_parent == parent && row.index.row() == last_row + 1) {
+            last_row = row.index.row();
+            return;
         }
-        --indent_level;
-        return IterationDecision::Continue;
+        if (first_row != -1)
+            model()->prefetch_rows(first_row, last_row, parent);
+        parent = row_parent;
+        first_row = last_row = row.index.row();
+    });
+    if (first_row != -1)
+        model()->prefetch_rows(first_row, last_row, parent);
+}
+
+Gfx::IntRect TreeView::item_rect(size_t row) const
+{
+    auto& visible_row = rows_in_paint_order()[row];
+    auto& index = visible_row.index;
+    int x_offset = tree_column_x_offset() + horizontal_padding() + visible_row.indent_level * indent_width_in_pixels();
+    auto node_text = index.data().to_string();
+    return {
+        x_offset, static_cast<int>(row) * row_height(),
+        icon_size() + icon_spacing() + text_padding() + font_for_index(index)->width(node_text) + text_padding(), row_height()
     };
-    int root_count = model.row_count();
-    for (int root_index = 0; root_index < root_count; ++root_index) {
-        if (traverse_index(model.index(root_index, model.tree_column(), ModelIndex())) == IterationDecision::Break)
-            break;
-    }
+}
+
+Gfx::IntRect TreeView::toggle_rect(size_t row) const
+{
+    auto& visible_row = rows_in_paint_order()[row];
+    if (model()->row_count(visible_row.index) == 0)
+        return {};
+    int y = static_cast<int>(row) * row_height();
+    int toggle_x = tree_column_x_offset() + horizontal_padding() + (indent_width_in_pixels() * visible_row.indent_level) - (icon_size() / 2) - 4;
+    Gfx::IntRect toggle_rect = { toggle_x, y, toggle_size(), toggle_size() };
+    toggle_rect.center_vertically_within({ toggle_x, y, toggle_size(), row_height() });
+    return toggle_rect;
 }
 
 void TreeView::paint_event(PaintEvent& event)
@@ -223,7 +264,6 @@ void TreeView::paint_event(PaintEvent& event)
     painter.translate(frame_inner_rect().location());
     painter.translate(-horizontal_scrollbar().value(), -vertical_scrollbar().value());
 
-    auto visible_content_rect = this->visible_content_rect();
     int tree_column = model.tree_column();
     int tree_column_x_offset = this->tree_column_x_offset();
 
@@ -231,12 +271,12 @@ void TreeView::paint_event(PaintEvent& event)
 
     int painted_row_index = 0;
 
-    traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect& a_rect, const Gfx::IntRect& a_toggle_rect, int indent_level) {
-        if (!a_rect.intersects_vertically(visible_content_rect))
-            return IterationDecision::Continue;
-
-        auto rect = a_rect.translated(0, y_offset);
-        auto toggle_rect = a_toggle_rect.translated(0, y_offset);
+    prefetch_visible_rows();
+    for_each_visible_row([&](size_t row, const Row& visible_row) {
+        auto& index = visible_row.index;
+        int indent_level = visible_row.indent_level;
+        auto rect = item_rect(row).translated(0, y_offset);
+        auto toggle_rect = this->toggle_rect(row).translated(0, y_offset);
 
 #if ITEM_RECTS_DEBUG
         painter.fill_rect(rect, Color::WarmGray);
@@ -364,8 +404,6 @@ void TreeView::paint_event(PaintEvent& event)
             }
             x_offset += column_width + horizontal_padding() * 2;
         }
-
-        return IterationDecision::Continue;
     });
 }
 
@@ -374,19 +412,15 @@ void TreeView::scroll_into_view(const ModelIndex& a_index, bool scroll_horizonta
     if (!a_index.is_valid())
         return;
     Gfx::IntRect found_rect;
-    traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect& rect, const Gfx::IntRect&, int) {
-        if (index == a_index) {
-            found_rect = rect;
-            return IterationDecision::Break;
-        }
-        return IterationDecision::Continue;
-    });
+    if (auto row = row_of(a_index); row.has_value())
+        found_rect = item_rect(row.value());
     ScrollableWidget::scroll_into_view(found_rect, scroll_horizontally, scroll_vertically);
 }
 
 void TreeView::model_did_update(unsigned flags)
 {
     m_view_metadata.clear();
+    invalidate_rows();
     AbstractTableView::model_did_update(flags);
 }
 
@@ -418,6 +452,7 @@ void TreeView::keydown_event(KeyEvent& event)
         if (on_toggle)
             on_toggle(cursor_index(), open);
         metadata.open = open;
+        invalidate_rows();
         update_column_sizes();
         update_content_size();
         update();
@@ -475,33 +510,21 @@ void TreeView::move_cursor(CursorMovement movement, SelectionUpdate selection_up
 {
     switch (movement) {
     case CursorMovement::Up: {
-        ModelIndex previous_index;
-        ModelIndex found_index;
-        traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int) {
-            if (index == cursor_index()) {
-                found_index = previous_index;
-                return IterationDecision::Break;
-            }
-            previous_index = index;
-            return IterationDecision::Continue;
-        });
-        if (found_index.is_valid())
-            set_cursor(found_index, selection_update);
+        auto row = row_of(cursor_index());
+        if (row.has_value() && row.value() > 0)
+            set_cursor(rows_in_paint_order()[row.value() - 1].index, selection_update);
         break;
     }
     case CursorMovement::Down: {
-        ModelIndex previous_index;
-        ModelIndex found_index;
-        traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int) {
-            if (previous_index == cursor_index()) {
-                found_index = index;
-                return IterationDecision::Break;
-            }
-            previous_index = index;
-            return IterationDecision::Continue;
-        });
-        if (found_index.is_valid())
-            set_cursor(found_index, selection_update);
+        auto& rows = rows_in_paint_order();
+        if (!cursor_index().is_valid()) {
+            if (!rows.is_empty())
+                set_cursor(rows.first().index, selection_update);
+            return;
+        }
+        auto row = row_of(cursor_index());
+        if (row.has_value() && row.value() + 1 < rows.size())
+            set_cursor(rows[row.value() + 1].index, selection_update);
         return;
     }
 
@@ -530,12 +553,7 @@ void TreeView::move_cursor(CursorMovement movement, SelectionUpdate selection_up
 
 int TreeView::item_count() const
 {
-    int count = 0;
-    traverse_in_paint_order([&](const ModelIndex&, const Gfx::IntRect&, const Gfx::IntRect&, int) {
-        ++count;
-        return IterationDecision::Continue;
-    });
-    return count;
+    return rows_in_paint_order().size();
 }
 
 void TreeView::auto_resize_column(int column)
@@ -546,6 +564,7 @@ void TreeView::auto_resize_column(int column)
     if (!column_header().is_section_visible(column))
         return;
 
+    prefetch_visible_rows();
     auto& model = *this->model();
 
     int header_width = column_header().font().width(model.column_name(column));
@@ -554,8 +573,8 @@ void TreeView::auto_resize_column(int column)
     int column_width = header_width;
 
     bool is_empty = true;
-    traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int indent_level) {
-        auto cell_data = model.index(index.row(), column, index.parent()).data();
+    for_each_visible_row([&](size_t, const Row& row) {
+        auto cell_data = model.index(row.index.row(), column, row.index.parent()).data();
         int cell_width = 0;
         if (cell_data.is_icon()) {
             cell_width = cell_data.as_icon().bitmap_for_size(16)->width();
@@ -567,9 +586,8 @@ void TreeView::auto_resize_column(int column)
         if (is_empty && cell_width > 0)
             is_empty = false;
         if (column == model.tree_column())
-            cell_width += horizontal_padding() * 2 + indent_level * indent_width_in_pixels() + icon_size() / 2;
+            cell_width += horizontal_padding() * 2 + row.indent_level * indent_width_in_pixels() + icon_size() / 2;
         column_width = max(column_width, cell_width);
-        return IterationDecision::Continue;
     });
 
     auto default_column_width = column_header().default_section_size(column);
@@ -584,6 +602,7 @@ void TreeView::update_column_sizes()
     if (!model())
         return;
 
+    prefetch_visible_rows();
     auto& model = *this->model();
     int column_count = model.column_count();
     int tree_column = model.tree_column();
@@ -597,8 +616,8 @@ void TreeView::update_column_sizes()
         if (column == m_key_column && model.is_column_sortable(column))
             header_width += font().width(" \xE2\xAC\x86");
         int column_width = header_width;
-        traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int) {
-            auto cell_data = model.index(index.row(), column, index.parent()).data();
+        for_each_visible_row([&](size_t, const Row& row) {
+            auto cell_data = model.index(row.index.row(), column, row.index.parent()).data();
             int cell_width = 0;
             if (cell_data.is_icon()) {
                 cell_width = cell_data.as_icon().bitmap_for_size(16)->width();
@@ -608,7 +627,6 @@ void TreeView::update_column_sizes()
                 cell_width = font().width(cell_data.to_string());
             }
             column_width = max(column_width, cell_width);
-            return IterationDecision::Continue;
         });
 
         set_column_width(column, max(this->column_width(column), column_width));
@@ -618,15 +636,14 @@ void TreeView::update_column_sizes()
     if (tree_column == m_key_column && model.is_column_sortable(tree_column))
         tree_column_header_width += font().width(" \xE2\xAC\x86");
     int tree_column_width = tree_column_header_width;
-    traverse_in_paint_order([&](const ModelIndex& index, const Gfx::IntRect&, const Gfx::IntRect&, int indent_level) {
-        auto cell_data = model.index(index.row(), tree_column, index.parent()).data();
+    for_each_visible_row([&](size_t, const Row& row) {
+        auto cell_data = model.index(row.index.row(), tree_column, row.index.parent()).data();
         int cell_width = 0;
         if (cell_data.is_valid()) {
             cell_width = font().width(cell_data.to_string());
-            cell_width += horizontal_padding() * 2 + indent_level * indent_width_in_pixels() + icon_size() / 2;
+            cell_width += horizontal_padding() * 2 + row.indent_level * indent_width_in_pixels() + icon_size() / 2;
         }
         tree_column_width = max(tree_column_width, cell_width);
-        return IterationDecision::Continue;
     });
 
     set_column_width(tree_column, tree_column_width);
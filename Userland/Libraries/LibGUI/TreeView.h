@@ -58,16 +58,37 @@ private:
     virtual void update_column_sizes() override;
     virtual void auto_resize_column(int column) override;
 
+    // An index that is shown in the tree, i.e. one whose parents are all open.
+    struct Row {
+        ModelIndex index;
+        int indent_level { 0 };
+    };
+
+    // All the rows, top to bottom. This is only rebuilt after indexes are opened or closed, or the model changes,
+    // so that painting and hit testing can go straight to the rows they need.
+    const Vector<Row>& rows_in_paint_order() const;
+    void invalidate_rows() { m_rows_are_valid = false; }
+    Optional<size_t> row_of(const ModelIndex&) const;
+
+    // Calls back for the rows that are at least partly within the viewport, and only for those.
     template<typename Callback>
-    void traverse_in_paint_order(Callback) const;
+    void for_each_visible_row(Callback) const;
+    void prefetch_visible_rows();
+
+    Gfx::IntRect item_rect(size_t row) const;
+    Gfx::IntRect toggle_rect(size_t row) const;
 
     struct MetadataForIndex;
 
     MetadataForIndex& ensure_metadata_for_index(const ModelIndex&) const;
+    bool is_open(const ModelIndex&) const;
     void set_open_state_of_all_in_subtree(const ModelIndex& root, bool open);
 
     mutable HashMap<void*, NonnullOwnPtr<MetadataForIndex>> m_view_metadata;
 
+    mutable Vector<Row> m_rows;
+    mutable bool m_rows_are_valid { false };
+
     RefPtr<Gfx::Bitmap> m_expand_bitmap;
     RefPtr<Gfx::Bitmap> m_collapse_bitmap;
 
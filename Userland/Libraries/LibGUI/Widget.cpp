@@ -67,6 +67,7 @@ Widget::Widget()
 {
     REGISTER_RECT_PROPERTY("relative_rect", relative_rect, set_relative_rect);
     REGISTER_BOOL_PROPERTY("fill_with_background_color", fill_with_background_color, set_fill_with_background_color);
+    REGISTER_BOOL_PROPERTY("cached_rendering", has_cached_rendering, set_cached_rendering);
     REGISTER_BOOL_PROPERTY("visible", is_visible, set_visible);
     REGISTER_BOOL_PROPERTY("focused", is_focused, set_focus);
     REGISTER_BOOL_PROPERTY("enabled", is_enabled, set_enabled);
@@ -280,6 +281,7 @@ void Widget::event(Core::Event& event)
     case Event::Drop:
         return drop_event(static_cast<DropEvent&>(event));
     case Event::ThemeChange:
+        invalidate_cached_renderings(rect());
         return theme_change_event(static_cast<ThemeChangeEvent&>(event));
     case Event::Enter:
         return handle_enter_event(event);
@@ -304,6 +306,46 @@ void Widget::handle_keydown_event(KeyEvent& event)
 void Widget::handle_paint_event(PaintEvent& event)
 {
     VERIFY(is_visible());
+    if (m_has_cached_rendering && window() && window()->back_bitmap())
+        paint_from_cached_rendering(event);
+    else
+        paint_with_children(event);
+}
+
+void Widget::paint_from_cached_rendering(PaintEvent& event)
+{
+    auto& window = *this->window();
+    int scale = window.back_bitmap()->scale();
+    if (!m_cached_rendering || m_cached_rendering->size() != size() || m_cached_rendering->scale() != scale) {
+        m_cached_rendering = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size(), scale);
+        m_cached_rendering_dirty_rect = rect();
+        if (!m_cached_rendering)
+            return paint_with_children(event);
+    }
+
+    if (!m_cached_rendering_dirty_rect.is_empty()) {
+        auto dirty_rect = exchange(m_cached_rendering_dirty_rect, Gfx::IntRect {});
+        {
+            Gfx::Painter painter(*m_cached_rendering);
+            painter.clear_rect(dirty_rect, Color::Transparent);
+        }
+
+        // We may be nested in another widget's cached rendering, so put back whatever we were painting into before.
+        auto* outer_target = window.paint_target_override();
+        auto outer_origin = window.paint_target_origin();
+        window.set_paint_target_override({}, m_cached_rendering, window_relative_rect().location());
+        PaintEvent render_event(dirty_rect);
+        paint_with_children(render_event);
+        window.set_paint_target_override({}, outer_target, outer_origin);
+    }
+
+    Painter painter(*this);
+    painter.add_clip_rect(event.rect());
+    painter.blit(event.rect().location(), *m_cached_rendering, event.rect());
+}
+
+void Widget::paint_with_children(PaintEvent& event)
+{
     if (fill_with_background_color()) {
         Painter painter(*this);
         painter.fill_rect(event.rect(), palette().color(background_role()));
@@ -313,8 +355,9 @@ void Widget::handle_paint_event(PaintEvent& event)
     for_each_child_widget([&](auto& child) {
         if (!child.is_visible())
             return IterationDecision::Continue;
-        if (child.relative_rect().intersects(event.rect())) {
-            PaintEvent local_event(event.rect().intersected(children_clip_rect).intersected(child.relative_rect()).translated(-child.relative_position()));
+        auto child_rect = event.rect().intersected(children_clip_rect).intersected(child.relative_rect());
+        if (!child_rect.is_empty()) {
+            PaintEvent local_event(child_rect.translated(-child.relative_position()));
             child.dispatch_event(local_event, this);
         }
         return IterationDecision::Continue;
@@ -559,6 +602,8 @@ void Widget::update(const Gfx::IntRect& rect)
     if (bound_by_widget.is_empty())
         return;
 
+    invalidate_cached_renderings(bound_by_widget);
+
     Window* window = m_window;
     Widget* parent = parent_widget();
     while (parent) {
@@ -752,8 +797,11 @@ void Widget::set_visible(bool visible)
     if (visible == m_visible)
         return;
     m_visible = visible;
-    if (auto* parent = parent_widget())
+    if (auto* parent = parent_widget()) {
         parent->invalidate_layout();
+        if (!m_visible)
+            parent->invalidate_cached_renderings(relative_rect());
+    }
     if (m_visible)
         update();
 
@@ -919,6 +967,27 @@ Vector<Widget*> Widget::child_widgets() const
 void Widget::set_palette(const Palette& palette)
 {
     m_palette = palette.impl();
+    invalidate_cached_renderings(rect());
+}
+
+void Widget::set_cached_rendering(bool cached_rendering)
+{
+    if (m_has_cached_rendering == cached_rendering)
+        return;
+    m_has_cached_rendering = cached_rendering;
+    m_cached_rendering = nullptr;
+    m_cached_rendering_dirty_rect = {};
+}
+
+void Widget::invalidate_cached_renderings(const Gfx::IntRect& rect)
+{
+    // Whatever changes in a widget is out of date in the cached renderings of the widget itself and all of its ancestors.
+    auto widget_rect = rect;
+    for (auto* widget = this; widget; widget = widget->parent_widget()) {
+        if (widget->m_has_cached_rendering)
+            widget->m_cached_rendering_dirty_rect = widget->m_cached_rendering_dirty_rect.united(widget_rect.intersected(widget->rect()));
+        widget_rect.move_by(widget->relative_position());
+    }
 }
 
 void Widget::set_background_role(ColorRole role)
@@ -218,6 +218,12 @@ public:
     void set_fill_with_background_color(bool b) { m_fill_with_background_color = b; }
     bool fill_with_background_color() const { return m_fill_with_background_color; }
 
+    // A widget with cached rendering paints itself and its children into a bitmap of its own, and paints from there.
+    // Only the parts that have been updated since are painted again, so it's meant for widgets that are expensive
+    // to paint but rarely change, like toolbars.
+    bool has_cached_rendering() const { return m_has_cached_rendering; }
+    void set_cached_rendering(bool);
+
     const Gfx::Font& font() const { return *m_font; }
 
     void set_font(const Gfx::Font*);
@@ -331,6 +337,9 @@ protected:
 
 private:
     void handle_paint_event(PaintEvent&);
+    void paint_with_children(PaintEvent&);
+    void paint_from_cached_rendering(PaintEvent&);
+    void invalidate_cached_renderings(const Gfx::IntRect&);
     void handle_resize_event(ResizeEvent&);
     void handle_mousedown_event(MouseEvent&);
     void handle_mousedoubleclick_event(MouseEvent&);
@@ -368,6 +377,10 @@ private:
     bool m_updates_enabled { true };
     bool m_accepts_emoji_input { false };
     bool m_shrink_to_fit { false };
+    bool m_has_cached_rendering { false };
+
+    RefPtr<Gfx::Bitmap> m_cached_rendering;
+    Gfx::IntRect m_cached_rendering_dirty_rect;
 
     NonnullRefPtr<Gfx::PaletteImpl> m_palette;
 
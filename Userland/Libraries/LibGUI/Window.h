@@ -152,6 +152,16 @@ public:
 
     Gfx::Bitmap* back_bitmap();
 
+    // While a widget renders into its cached rendering, that's where its painters (and those of its children) paint.
+    Gfx::Bitmap* paint_target() { return m_paint_target_override ? m_paint_target_override : back_bitmap(); }
+    Gfx::IntPoint paint_target_origin() const { return m_paint_target_override_origin; }
+    Gfx::Bitmap* paint_target_override() { return m_paint_target_override; }
+    void set_paint_target_override(Badge<Widget>, Gfx::Bitmap* bitmap, const Gfx::IntPoint& window_relative_origin)
+    {
+        m_paint_target_override = bitmap;
+        m_paint_target_override_origin = window_relative_origin;
+    }
+
     Gfx::IntSize size_increment() const { return m_size_increment; }
     void set_size_increment(const Gfx::IntSize&);
     Gfx::IntSize base_size() const { return m_base_size; }
@@ -227,6 +237,9 @@ private:
     OwnPtr<WindowBackingStore> m_front_store;
     OwnPtr<WindowBackingStore> m_back_store;
 
+    Gfx::Bitmap* m_paint_target_override { nullptr };
+    Gfx::IntPoint m_paint_target_override_origin;
+
     RefPtr<Menubar> m_menubar;
 
     RefPtr<Gfx::Bitmap> m_icon;
@@ -323,15 +323,17 @@ void WindowServerConnection::handle(const Messages::WindowClient::WindowStateCha
         window->notify_state_changed({}, message.minimized(), message.occluded());
 }
 
-void WindowServerConnection::handle(const Messages::WindowClient::DisplayLinkNotification&)
+void WindowServerConnection::handle(const Messages::WindowClient::DisplayLinkNotification& message)
 {
+    // If we fell behind, only the latest frame is worth drawing.
+    m_pending_display_link_frame_time = message.frame_time_in_microseconds();
     if (m_display_link_notification_pending)
         return;
 
     m_display_link_notification_pending = true;
     deferred_invoke([this](auto&) {
-        DisplayLink::notify({});
         m_display_link_notification_pending = false;
+        DisplayLink::notify({}, m_pending_display_link_frame_time);
     });
 }
 
@@ -340,4 +342,23 @@ void WindowServerConnection::handle(const Messages::WindowClient::Ping&)
     post_message(Messages::WindowServer::Pong());
 }
 
+bool WindowServerConnection::is_superseded_by(const IPC::Message& message, const IPC::Message& next_message) const
+{
+    if (message.endpoint_magic() != WindowClientEndpoint::static_magic() || next_message.endpoint_magic() != WindowClientEndpoint::static_magic())
+        return false;
+
+    // If we've fallen behind, only the latest of a run of mouse moves with the same buttons held down matters.
+    if (message.message_id() == Messages::WindowClient::MouseMove::static_message_id() && next_message.message_id() == Messages::WindowClient::MouseMove::static_message_id()) {
+        auto& mouse_move = static_cast<const Messages::WindowClient::MouseMove&>(message);
+        auto& next_mouse_move = static_cast<const Messages::WindowClient::MouseMove&>(next_message);
+        return mouse_move.window_id() == next_mouse_move.window_id()
+            && mouse_move.buttons() == next_mouse_move.buttons()
+            && mouse_move.modifiers() == next_mouse_move.modifiers()
+            && mouse_move.is_drag() == next_mouse_move.is_drag()
+            && !mouse_move.wheel_delta();
+    }
+
+    return false;
+}
+
 }
@@ -57,7 +57,10 @@ private:
     virtual void handle(const Messages::WindowClient::DisplayLinkNotification&) override;
     virtual void handle(const Messages::WindowClient::Ping&) override;
 
+    virtual bool is_superseded_by(const IPC::Message&, const IPC::Message& next_message) const override;
+
     bool m_display_link_notification_pending { false };
+    i64 m_pending_display_link_frame_time { 0 };
 };
 
 }
@@ -11,6 +11,7 @@
 #include <LibGfx/ClassicStylePainter.h>
 #include <LibGfx/Painter.h>
 #include <LibGfx/Palette.h>
+#include <LibThread/Lock.h>
 
 namespace Gfx {
 
@@ -329,6 +330,9 @@ void ClassicStylePainter::paint_progressbar(Painter& painter, const IntRect& rec
         painter.draw_text(rect.translated(0, 0), text, TextAlignment::Center, palette.base_text());
 }
 
+// These get loaded the first time they are needed, which may be on more than one thread at a time.
+static LibThread::Lock s_lazy_bitmaps_lock;
+
 static RefPtr<Gfx::Bitmap> s_unfilled_circle_bitmap;
 static RefPtr<Gfx::Bitmap> s_filled_circle_bitmap;
 static RefPtr<Gfx::Bitmap> s_changing_filled_circle_bitmap;
@@ -343,6 +347,7 @@ static const Gfx::Bitmap& circle_bitmap(bool checked, bool changing)
 
 void ClassicStylePainter::paint_radio_button(Painter& painter, const IntRect& rect, const Palette&, bool is_checked, bool is_being_pressed)
 {
+    LOCKER(s_lazy_bitmaps_lock);
     if (!s_unfilled_circle_bitmap) {
         s_unfilled_circle_bitmap = Bitmap::load_from_file("/res/icons/serenity/unfilled-radio-circle.png");
         s_filled_circle_bitmap = Bitmap::load_from_file("/res/icons/serenity/filled-radio-circle.png");
@@ -381,6 +386,7 @@ void ClassicStylePainter::paint_check_box(Painter& painter, const IntRect& rect,
     }
 
     if (is_checked) {
+        LOCKER(s_lazy_bitmaps_lock);
         if (!s_checked_bitmap)
             s_checked_bitmap = &Gfx::CharacterBitmap::create_from_ascii(s_checked_bitmap_data, s_checked_bitmap_width, s_checked_bitmap_height).leak_ref();
         painter.draw_bitmap(rect.shrunken(4, 4).location(), *s_checked_bitmap, is_enabled ? palette.base_text() : palette.threed_shadow1());
@@ -8,13 +8,16 @@
 #include <AK/String.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Emoji.h>
+#include <LibThread/Lock.h>
 
 namespace Gfx {
 
+static LibThread::Lock s_emojis_lock;
 static HashMap<u32, RefPtr<Gfx::Bitmap>> s_emojis;
 
 const Bitmap* Emoji::emoji_for_code_point(u32 code_point)
 {
+    LOCKER(s_emojis_lock);
     auto it = s_emojis.find(code_point);
     if (it != s_emojis.end())
         return (*it).value.ptr();
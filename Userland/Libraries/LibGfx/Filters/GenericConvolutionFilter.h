@@ -7,8 +7,12 @@
 #pragma once
 
 #include "Filter.h"
+#include <AK/SIMD.h>
+#include <AK/Vector.h>
 #include <LibGfx/Matrix.h>
 #include <LibGfx/Matrix4x4.h>
+#include <LibThread/Parallel.h>
+#include <math.h>
 
 namespace Gfx {
 
@@ -82,6 +86,9 @@ public:
         VERIFY(source.size().contains(target.size()));
         VERIFY(target.rect().contains(target_rect));
         VERIFY(source.rect().contains(source_rect));
+        // We work on the scanlines directly, so we have to know what the pixels look like.
+        VERIFY(source.format() == BitmapFormat::BGRx8888 || source.format() == BitmapFormat::BGRA8888);
+        VERIFY(target.format() == BitmapFormat::BGRx8888 || target.format() == BitmapFormat::BGRA8888);
 
         // If source is different from target, it should still be describing
         // essentially the same bitmap. But it allows us to modify target
@@ -89,62 +96,260 @@ public:
         // is applied on multiple areas of the same bitmap, at which point
         // we would need to be able to access unmodified pixels if the
         // areas are (almost) adjacent.
-        int source_delta_x = target_rect.x() - source_rect.x();
-        int source_delta_y = target_rect.y() - source_rect.y();
-        if (&target == &source && (!apply_cache.m_target || !apply_cache.m_target->size().contains(source_rect.size()))) {
-            // TODO: We probably don't need the entire source_rect, we could inflate
-            // the target_rect appropriately
-            apply_cache.m_target = Gfx::Bitmap::create(source.format(), source_rect.size());
-            target_rect.move_by(-target_rect.location());
+        Bitmap* render_target_bitmap = &target;
+        IntPoint render_target_origin = target_rect.location();
+        if (&target == &source) {
+            if (!apply_cache.m_target || !apply_cache.m_target->size().contains(target_rect.size()))
+                apply_cache.m_target = Gfx::Bitmap::create(source.format(), target_rect.size());
+            render_target_bitmap = apply_cache.m_target.ptr();
+            render_target_origin = {};
         }
 
-        Bitmap* render_target_bitmap = (&target != &source) ? &target : apply_cache.m_target.ptr();
-
-        // FIXME: Help! I am naive!
-        constexpr static ssize_t offset = N / 2;
-        for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
-            ssize_t i = i_ + target_rect.x();
-            for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
-                ssize_t j = j_ + target_rect.y();
-                FloatVector3 value(0, 0, 0);
-                for (auto k = 0l; k < (ssize_t)N; ++k) {
-                    auto ki = i + k - offset;
-                    if (ki < source_rect.x() || ki > source_rect.right()) {
-                        if (parameters.should_wrap())
-                            ki = (ki + source.size().width()) % source.size().width(); // TODO: fix up using source_rect
-                        else
-                            continue;
-                    }
-
-                    for (auto l = 0l; l < (ssize_t)N; ++l) {
-                        auto lj = j + l - offset;
-                        if (lj < source_rect.y() || lj > source_rect.bottom()) {
-                            if (parameters.should_wrap())
-                                lj = (lj + source.size().height()) % source.size().height(); // TODO: fix up using source_rect
-                            else
-                                continue;
-                        }
-
-                        auto pixel = source.get_pixel(ki, lj);
-                        FloatVector3 pixel_value(pixel.red(), pixel.green(), pixel.blue());
-
-                        value = value + pixel_value * parameters.kernel().elements()[k][l];
-                    }
+        auto kernel = analyze_kernel(parameters.kernel());
+
+        // Where every column of the padded input comes from in the source, or -1 if it's outside
+        // the source and doesn't contribute.
+        Vector<int> source_columns;
+        source_columns.ensure_capacity(target_rect.width() + 2 * offset);
+        for (int x = target_rect.x() - offset; x <= target_rect.right() + offset; ++x)
+            source_columns.unchecked_append(source_coordinate(x, source_rect.x(), source_rect.width(), parameters.should_wrap()));
+
+        // Every band of rows only reads the source and writes its own rows of the render target,
+        // so the bands can be filtered in parallel.
+        size_t band_count = (target_rect.height() + band_height - 1) / band_height;
+        LibThread::parallel_for(0, band_count, 1, [&](size_t band) {
+            int top = target_rect.y() + band * band_height;
+            int row_count = min(band_height, target_rect.bottom() + 1 - top);
+            int width = target_rect.width();
+            int padded_width = width + 2 * offset;
+            int padded_height = row_count + 2 * offset;
+
+            Vector<float> input;
+            input.resize(padded_width * padded_height * 4);
+            // Whatever isn't filled in below is outside the source, and counts as zero.
+            __builtin_memset(input.data(), 0, input.size() * sizeof(float));
+            for (int row = 0; row < padded_height; ++row) {
+                auto source_y = source_coordinate(top - offset + row, source_rect.y(), source_rect.height(), parameters.should_wrap());
+                if (source_y < 0)
+                    continue;
+                auto* scanline = source.scanline(source_y);
+                auto* input_row = &input[row * padded_width * 4];
+                for (int column = 0; column < padded_width; ++column) {
+                    if (source_columns[column] >= 0)
+                        store(input_row + column * 4, to_vector(scanline[source_columns[column]]));
                 }
+            }
 
-                value.clamp(0, 255);
-                render_target_bitmap->set_pixel(i, j, Color(value.x(), value.y(), value.z(), source.get_pixel(i + source_delta_x, j + source_delta_y).alpha()));
+            Vector<float> output;
+            output.resize(width * row_count * 4);
+            switch (kernel.type) {
+            case KernelType::Box:
+                apply_box(input, output, width, row_count, kernel.horizontal[0]);
+                break;
+            case KernelType::Separable:
+                apply_separable(input, output, width, row_count, kernel);
+                break;
+            case KernelType::General:
+                apply_general(input, output, width, row_count, parameters.kernel());
+                break;
             }
-        }
+
+            for (int row = 0; row < row_count; ++row) {
+                auto* source_scanline = source.scanline(top + row);
+                auto* target_scanline = render_target_bitmap->scanline(render_target_origin.y() + (top - target_rect.y()) + row) + render_target_origin.x();
+                auto* output_row = &output[row * width * 4];
+                for (int column = 0; column < width; ++column) {
+                    auto value = load(output_row + column * 4);
+                    auto alpha = Color::from_rgba(source_scanline[target_rect.x() + column]).alpha();
+                    target_scanline[column] = Color(clamp_to_u8(value[0]), clamp_to_u8(value[1]), clamp_to_u8(value[2]), alpha).value();
+                }
+            }
+        });
 
         if (render_target_bitmap != &target) {
-            // FIXME: Substitute for some sort of faster "blit" method.
-            for (auto i_ = 0; i_ < target_rect.width(); ++i_) {
-                auto i = i_ + target_rect.x();
-                for (auto j_ = 0; j_ < target_rect.height(); ++j_) {
-                    auto j = j_ + target_rect.y();
-                    target.set_pixel(i, j, render_target_bitmap->get_pixel(i_, j_));
+            for (int row = 0; row < target_rect.height(); ++row)
+                __builtin_memcpy(target.scanline(target_rect.y() + row) + target_rect.x(), render_target_bitmap->scanline(row), target_rect.width() * sizeof(RGBA32));
+        }
+    }
+
+private:
+    using f32x4 = AK::SIMD::f32x4;
+
+    static constexpr int offset = N / 2;
+    // How many rows a thread filters at once.
+    static constexpr int band_height = 64;
+
+    enum class KernelType {
+        // All the weights are the same, so the sum of the window can be slid along.
+        Box,
+        // kernel[k][l] == horizontal[k] * vertical[l], so it can be applied in two one-dimensional passes.
+        Separable,
+        General,
+    };
+
+    struct AnalyzedKernel {
+        KernelType type { KernelType::General };
+        // For a box kernel, horizontal[0] is its weight.
+        float horizontal[N] {};
+        float vertical[N] {};
+    };
+
+    static AnalyzedKernel analyze_kernel(const Matrix<N, float>& matrix)
+    {
+        auto elements = matrix.elements();
+        AnalyzedKernel kernel;
+
+        bool is_box = true;
+        float max_magnitude = 0;
+        size_t pivot_k = 0;
+        size_t pivot_l = 0;
+        for (size_t k = 0; k < N; ++k) {
+            for (size_t l = 0; l < N; ++l) {
+                if (elements[k][l] != elements[0][0])
+                    is_box = false;
+                if (fabsf(elements[k][l]) > max_magnitude) {
+                    max_magnitude = fabsf(elements[k][l]);
+                    pivot_k = k;
+                    pivot_l = l;
+                }
+            }
+        }
+        if (max_magnitude == 0)
+            return kernel;
+        if (is_box) {
+            kernel.type = KernelType::Box;
+            kernel.horizontal[0] = elements[0][0];
+            return kernel;
+        }
+
+        for (size_t i = 0; i < N; ++i) {
+            kernel.horizontal[i] = elements[i][pivot_l];
+            kernel.vertical[i] = elements[pivot_k][i] / elements[pivot_k][pivot_l];
+        }
+        for (size_t k = 0; k < N; ++k) {
+            for (size_t l = 0; l < N; ++l) {
+                if (fabsf(elements[k][l] - kernel.horizontal[k] * kernel.vertical[l]) > max_magnitude * 1e-5f)
+                    return kernel;
+            }
+        }
+        kernel.type = KernelType::Separable;
+        return kernel;
+    }
+
+    static int source_coordinate(int coordinate, int start, int length, bool should_wrap)
+    {
+        if (coordinate >= start && coordinate < start + length)
+            return coordinate;
+        if (!should_wrap)
+            return -1;
+        auto wrapped = (coordinate - start) % length;
+        return start + (wrapped < 0 ? wrapped + length : wrapped);
+    }
+
+    ALWAYS_INLINE static f32x4 load(const float* p)
+    {
+        f32x4 value;
+        __builtin_memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    ALWAYS_INLINE static void store(float* p, f32x4 value)
+    {
+        __builtin_memcpy(p, &value, sizeof(value));
+    }
+
+    ALWAYS_INLINE static f32x4 to_vector(RGBA32 pixel)
+    {
+        return f32x4 { (float)((pixel >> 16) & 0xff), (float)((pixel >> 8) & 0xff), (float)(pixel & 0xff), 0 };
+    }
+
+    ALWAYS_INLINE static u8 clamp_to_u8(float value)
+    {
+        return value <= 0 ? 0 : (value >= 255 ? 255 : (u8)value);
+    }
+
+    static void apply_box(const Vector<float>& input, Vector<float>& output, int width, int row_count, float weight)
+    {
+        int padded_width = width + 2 * offset;
+        int padded_height = row_count + 2 * offset;
+
+        // Horizontal sums of every window, for every padded row.
+        Vector<float> row_sums;
+        row_sums.resize(width * padded_height * 4);
+        for (int row = 0; row < padded_height; ++row) {
+            auto* in = &input[row * padded_width * 4];
+            auto* out = &row_sums[row * width * 4];
+            f32x4 sum {};
+            for (size_t k = 0; k < N; ++k)
+                sum += load(in + k * 4);
+            store(out, sum);
+            for (int column = 1; column < width; ++column) {
+                sum += load(in + (column + N - 1) * 4) - load(in + (column - 1) * 4);
+                store(out + column * 4, sum);
+            }
+        }
+
+        // Then slide a window of rows down over those.
+        Vector<float> column_sums;
+        column_sums.resize(width * 4);
+        __builtin_memset(column_sums.data(), 0, column_sums.size() * sizeof(float));
+        for (size_t l = 0; l < N; ++l) {
+            for (int column = 0; column < width; ++column)
+                store(&column_sums[column * 4], load(&column_sums[column * 4]) + load(&row_sums[(l * width + column) * 4]));
+        }
+        for (int row = 0; row < row_count; ++row) {
+            for (int column = 0; column < width; ++column) {
+                auto sum = load(&column_sums[column * 4]);
+                store(&output[(row * width + column) * 4], sum * weight);
+                if (row + 1 < row_count)
+                    store(&column_sums[column * 4], sum + load(&row_sums[((row + N) * width + column) * 4]) - load(&row_sums[(row * width + column) * 4]));
+            }
+        }
+    }
+
+    static void apply_separable(const Vector<float>& input, Vector<float>& output, int width, int row_count, const AnalyzedKernel& kernel)
+    {
+        int padded_width = width + 2 * offset;
+        int padded_height = row_count + 2 * offset;
+
+        Vector<float> horizontal;
+        horizontal.resize(width * padded_height * 4);
+        for (int row = 0; row < padded_height; ++row) {
+            auto* in = &input[row * padded_width * 4];
+            auto* out = &horizontal[row * width * 4];
+            for (int column = 0; column < width; ++column) {
+                f32x4 sum {};
+                for (size_t k = 0; k < N; ++k)
+                    sum += load(in + (column + k) * 4) * kernel.horizontal[k];
+                store(out + column * 4, sum);
+            }
+        }
+
+        for (int row = 0; row < row_count; ++row) {
+            auto* out = &output[row * width * 4];
+            for (int column = 0; column < width; ++column) {
+                f32x4 sum {};
+                for (size_t l = 0; l < N; ++l)
+                    sum += load(&horizontal[((row + l) * width + column) * 4]) * kernel.vertical[l];
+                store(out + column * 4, sum);
+            }
+        }
+    }
+
+    static void apply_general(const Vector<float>& input, Vector<float>& output, int width, int row_count, const Matrix<N, float>& matrix)
+    {
+        auto elements = matrix.elements();
+        int padded_width = width + 2 * offset;
+        for (int row = 0; row < row_count; ++row) {
+            auto* out = &output[row * width * 4];
+            for (int column = 0; column < width; ++column) {
+                f32x4 sum {};
+                for (size_t l = 0; l < N; ++l) {
+                    auto* in = &input[((row + l) * padded_width + column) * 4];
+                    for (size_t k = 0; k < N; ++k)
+                        sum += load(in + k * 4) * elements[k][l];
                 }
+                store(out + column * 4, sum);
             }
         }
     }
@@ -60,6 +60,17 @@ public:
 
     Glyph(RefPtr<Bitmap> bitmap, int left_bearing, int advance, int ascent)
         : m_bitmap(bitmap)
+        , m_bitmap_rect(bitmap ? bitmap->rect() : IntRect {})
+        , m_left_bearing(left_bearing)
+        , m_advance(advance)
+        , m_ascent(ascent)
+    {
+    }
+
+    // For a glyph that is only a part of the bitmap, e.g one that is shared by many glyphs.
+    Glyph(RefPtr<Bitmap> bitmap, const IntRect& bitmap_rect, int left_bearing, int advance, int ascent)
+        : m_bitmap(bitmap)
+        , m_bitmap_rect(bitmap_rect)
         , m_left_bearing(left_bearing)
         , m_advance(advance)
         , m_ascent(ascent)
@@ -69,6 +80,7 @@ public:
     bool is_glyph_bitmap() const { return !m_bitmap; }
     GlyphBitmap glyph_bitmap() const { return m_glyph_bitmap; }
     RefPtr<Bitmap> bitmap() const { return m_bitmap; }
+    const IntRect& bitmap_rect() const { return m_bitmap_rect; }
     int left_bearing() const { return m_left_bearing; }
     int advance() const { return m_advance; }
     int ascent() const { return m_ascent; }
@@ -76,6 +88,7 @@ public:
 private:
     GlyphBitmap m_glyph_bitmap;
     RefPtr<Bitmap> m_bitmap;
+    IntRect m_bitmap_rect;
     int m_left_bearing;
     int m_advance;
     int m_ascent;
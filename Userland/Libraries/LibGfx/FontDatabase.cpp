@@ -16,6 +16,7 @@
 namespace Gfx {
 
 static FontDatabase* s_the;
+static String s_fonts_directory = "/res/fonts";
 
 FontDatabase& FontDatabase::the()
 {
@@ -24,6 +25,12 @@ FontDatabase& FontDatabase::the()
     return *s_the;
 }
 
+void FontDatabase::set_fonts_directory(String directory)
+{
+    VERIFY(!s_the);
+    s_fonts_directory = move(directory);
+}
+
 Font& FontDatabase::default_font()
 {
     static Font* font;
@@ -72,7 +79,7 @@ struct FontDatabase::Private {
 FontDatabase::FontDatabase()
     : m_private(make<Private>())
 {
-    Core::DirIterator dir_iterator("/res/fonts", Core::DirIterator::SkipDots);
+    Core::DirIterator dir_iterator(s_fonts_directory, Core::DirIterator::SkipDots);
     if (dir_iterator.has_error()) {
         warnln("DirIterator: {}", dir_iterator.error_string());
         exit(1);
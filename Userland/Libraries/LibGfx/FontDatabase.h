@@ -33,6 +33,10 @@ class FontDatabase {
 public:
     static FontDatabase& the();
 
+    // Where the fonts are loaded from, which is /res/fonts unless this is called before the first use of the
+    // database. That's mostly useful on other systems, which have the fonts in a checkout of Base/ instead.
+    static void set_fonts_directory(String);
+
     static Font& default_font();
     static Font& default_bold_font();
 
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Bitmap.h>
 #include <AK/ByteBuffer.h>
 #include <AK/Debug.h>
@@ -11,6 +12,7 @@
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
 #include <AK/MemoryStream.h>
+#include <AK/SIMD.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
@@ -156,12 +158,18 @@ struct StartOfFrame {
     u16 width { 0 };
 };
 
+// Most symbols have short codes, so the next few bits of the stream find them in one lookup.
+static constexpr u8 huffman_lookahead_bits = 9;
+
 struct HuffmanTableSpec {
     u8 type { 0 };
     u8 destination_id { 0 };
     u8 code_counts[16] = { 0 };
     Vector<u8> symbols;
     Vector<u16> codes;
+    // The length of the code starting with these bits in the upper byte and its symbol in the lower one, or 0 when
+    // the code is longer than the lookahead.
+    Array<u16, 1 << huffman_lookahead_bits> lookahead {};
 };
 
 struct HuffmanStreamState {
@@ -195,18 +203,54 @@ struct JPGLoadingContext {
     HuffmanStreamState huffman_stream;
     i32 previous_dc_values[3] = { 0 };
     MacroblockMeta mblock_meta;
+    // If the image at an eighth of its size is at least this big, it's decoded at that size.
+    IntSize minimum_size;
 };
 
 static void generate_huffman_codes(HuffmanTableSpec& table)
 {
     unsigned code = 0;
-    for (auto number_of_codes : table.code_counts) {
-        for (int i = 0; i < number_of_codes; i++)
+    for (u8 code_length = 1; code_length <= 16; ++code_length) {
+        for (int i = 0; i < table.code_counts[code_length - 1]; i++) {
+            // Codes that overflowed their length can never be matched.
+            if (code_length <= huffman_lookahead_bits && code < (1u << code_length)) {
+                u8 unused_bits = huffman_lookahead_bits - code_length;
+                u16 entry = (code_length << 8) | table.symbols[table.codes.size()];
+                for (unsigned lookahead = code << unused_bits; lookahead < (code + 1) << unused_bits; ++lookahead)
+                    table.lookahead[lookahead] = entry;
+            }
             table.codes.append(code++);
+        }
         code <<= 1;
     }
 }
 
+static size_t remaining_huffman_bits(const HuffmanStreamState& hstream)
+{
+    if (hstream.byte_offset >= hstream.stream.size())
+        return 0;
+    return (hstream.stream.size() - hstream.byte_offset) * 8 - hstream.bit_offset;
+}
+
+// Returns the next `count` bits without consuming them, with zeroes past the end of the stream.
+static u32 peek_huffman_bits(const HuffmanStreamState& hstream, u8 count)
+{
+    VERIFY(count <= 16);
+    u32 window = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        size_t offset = hstream.byte_offset + i;
+        window = (window << 8) | (offset < hstream.stream.size() ? hstream.stream[offset] : 0);
+    }
+    return (window >> (24 - hstream.bit_offset - count)) & ((1u << count) - 1); // MSB first.
+}
+
+static void skip_huffman_bits(HuffmanStreamState& hstream, u8 count)
+{
+    size_t bit_offset = hstream.bit_offset + count;
+    hstream.byte_offset += bit_offset / 8;
+    hstream.bit_offset = bit_offset % 8;
+}
+
 static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t count = 1)
 {
     if (count > (8 * sizeof(size_t))) {
@@ -214,25 +258,31 @@ static Optional<size_t> read_huffman_bits(HuffmanStreamState& hstream, size_t co
         return {};
     }
     size_t value = 0;
-    while (count--) {
-        if (hstream.byte_offset >= hstream.stream.size()) {
+    while (count > 0) {
+        u8 chunk = min(count, (size_t)16);
+        if (remaining_huffman_bits(hstream) < chunk) {
             dbgln_if(JPG_DEBUG, "Huffman stream exhausted. This could be an error!");
             return {};
         }
-        u8 current_byte = hstream.stream[hstream.byte_offset];
-        u8 current_bit = 1u & (u32)(current_byte >> (7 - hstream.bit_offset)); // MSB first.
-        hstream.bit_offset++;
-        value = (value << 1) | (size_t)current_bit;
-        if (hstream.bit_offset == 8) {
-            hstream.byte_offset++;
-            hstream.bit_offset = 0;
-        }
+        value = (value << chunk) | peek_huffman_bits(hstream, chunk);
+        skip_huffman_bits(hstream, chunk);
+        count -= chunk;
     }
     return value;
 }
 
 static Optional<u8> get_next_symbol(HuffmanStreamState& hstream, const HuffmanTableSpec& table)
 {
+    auto entry = table.lookahead[peek_huffman_bits(hstream, huffman_lookahead_bits)];
+    if (u8 code_length = entry >> 8; code_length != 0) {
+        if (remaining_huffman_bits(hstream) < code_length) {
+            dbgln_if(JPG_DEBUG, "Huffman stream exhausted. This could be an error!");
+            return {};
+        }
+        skip_huffman_bits(hstream, code_length);
+        return entry & 0xFF;
+    }
+
     unsigned code = 0;
     size_t code_cursor = 0;
     for (int i = 0; i < 16; i++) { // Codes can't be longer than 16 bits.
@@ -861,8 +911,20 @@ static void dequantize(JPGLoadingContext& context, Vector<Macroblock>& macrobloc
     }
 }
 
-static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+static void transpose_block_component(i32* block_component)
 {
+    for (u32 row = 0; row < 8; ++row) {
+        for (u32 column = row + 1; column < 8; ++column)
+            swap(block_component[row * 8 + column], block_component[column * 8 + row]);
+    }
+}
+
+// Runs the AAN inverse DCT down four neighbouring columns at once.
+ALWAYS_INLINE static void inverse_dct_on_four_columns(i32* block_component)
+{
+    using AK::SIMD::f32x4;
+    using AK::SIMD::i32x4;
+
     static const float m0 = 2.0 * cos(1.0 / 16.0 * 2.0 * M_PI);
     static const float m1 = 2.0 * cos(2.0 / 16.0 * 2.0 * M_PI);
     static const float m3 = 2.0 * cos(2.0 / 16.0 * 2.0 * M_PI);
@@ -878,6 +940,85 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
     static const float s6 = cos(6.0 / 16.0 * M_PI) / 2.0;
     static const float s7 = cos(7.0 / 16.0 * M_PI) / 2.0;
 
+    auto load_row = [&](u32 row) {
+        i32x4 values;
+        __builtin_memcpy(&values, &block_component[row * 8], sizeof(values));
+        return __builtin_convertvector(values, f32x4);
+    };
+    auto store_row = [&](u32 row, f32x4 values) {
+        auto truncated_values = __builtin_convertvector(values, i32x4);
+        __builtin_memcpy(&block_component[row * 8], &truncated_values, sizeof(truncated_values));
+    };
+
+    const f32x4 g0 = load_row(0) * s0;
+    const f32x4 g1 = load_row(4) * s4;
+    const f32x4 g2 = load_row(2) * s2;
+    const f32x4 g3 = load_row(6) * s6;
+    const f32x4 g4 = load_row(5) * s5;
+    const f32x4 g5 = load_row(1) * s1;
+    const f32x4 g6 = load_row(7) * s7;
+    const f32x4 g7 = load_row(3) * s3;
+
+    const f32x4 f0 = g0;
+    const f32x4 f1 = g1;
+    const f32x4 f2 = g2;
+    const f32x4 f3 = g3;
+    const f32x4 f4 = g4 - g7;
+    const f32x4 f5 = g5 + g6;
+    const f32x4 f6 = g5 - g6;
+    const f32x4 f7 = g4 + g7;
+
+    const f32x4 e0 = f0;
+    const f32x4 e1 = f1;
+    const f32x4 e2 = f2 - f3;
+    const f32x4 e3 = f2 + f3;
+    const f32x4 e4 = f4;
+    const f32x4 e5 = f5 - f7;
+    const f32x4 e6 = f6;
+    const f32x4 e7 = f5 + f7;
+    const f32x4 e8 = f4 + f6;
+
+    const f32x4 d0 = e0;
+    const f32x4 d1 = e1;
+    const f32x4 d2 = e2 * m1;
+    const f32x4 d3 = e3;
+    const f32x4 d4 = e4 * m2;
+    const f32x4 d5 = e5 * m3;
+    const f32x4 d6 = e6 * m4;
+    const f32x4 d7 = e7;
+    const f32x4 d8 = e8 * m5;
+
+    const f32x4 c0 = d0 + d1;
+    const f32x4 c1 = d0 - d1;
+    const f32x4 c2 = d2 - d3;
+    const f32x4 c3 = d3;
+    const f32x4 c4 = d4 + d8;
+    const f32x4 c5 = d5 + d7;
+    const f32x4 c6 = d6 - d8;
+    const f32x4 c7 = d7;
+    const f32x4 c8 = c5 - c6;
+
+    const f32x4 b0 = c0 + c3;
+    const f32x4 b1 = c1 + c2;
+    const f32x4 b2 = c1 - c2;
+    const f32x4 b3 = c0 - c3;
+    const f32x4 b4 = c4 - c8;
+    const f32x4 b5 = c8;
+    const f32x4 b6 = c6 - c7;
+    const f32x4 b7 = c7;
+
+    store_row(0, b0 + b7);
+    store_row(1, b1 + b6);
+    store_row(2, b2 + b5);
+    store_row(3, b3 + b4);
+    store_row(4, b3 - b4);
+    store_row(5, b2 - b5);
+    store_row(6, b1 - b6);
+    store_row(7, b0 - b7);
+}
+
+static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+{
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             for (auto it = context.components.begin(); it != context.components.end(); ++it) {
@@ -887,140 +1028,14 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
                         u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hfactor_i + hcursor);
                         Macroblock& block = macroblocks[mb_index];
                         i32* block_component = component.serial_id == 0 ? block.y : (component.serial_id == 1 ? block.cb : block.cr);
-                        for (u32 k = 0; k < 8; ++k) {
-                            const float g0 = block_component[0 * 8 + k] * s0;
-                            const float g1 = block_component[4 * 8 + k] * s4;
-                            const float g2 = block_component[2 * 8 + k] * s2;
-                            const float g3 = block_component[6 * 8 + k] * s6;
-                            const float g4 = block_component[5 * 8 + k] * s5;
-                            const float g5 = block_component[1 * 8 + k] * s1;
-                            const float g6 = block_component[7 * 8 + k] * s7;
-                            const float g7 = block_component[3 * 8 + k] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[0 * 8 + k] = b0 + b7;
-                            block_component[1 * 8 + k] = b1 + b6;
-                            block_component[2 * 8 + k] = b2 + b5;
-                            block_component[3 * 8 + k] = b3 + b4;
-                            block_component[4 * 8 + k] = b3 - b4;
-                            block_component[5 * 8 + k] = b2 - b5;
-                            block_component[6 * 8 + k] = b1 - b6;
-                            block_component[7 * 8 + k] = b0 - b7;
-                        }
-                        for (u32 l = 0; l < 8; ++l) {
-                            const float g0 = block_component[l * 8 + 0] * s0;
-                            const float g1 = block_component[l * 8 + 4] * s4;
-                            const float g2 = block_component[l * 8 + 2] * s2;
-                            const float g3 = block_component[l * 8 + 6] * s6;
-                            const float g4 = block_component[l * 8 + 5] * s5;
-                            const float g5 = block_component[l * 8 + 1] * s1;
-                            const float g6 = block_component[l * 8 + 7] * s7;
-                            const float g7 = block_component[l * 8 + 3] * s3;
-
-                            const float f0 = g0;
-                            const float f1 = g1;
-                            const float f2 = g2;
-                            const float f3 = g3;
-                            const float f4 = g4 - g7;
-                            const float f5 = g5 + g6;
-                            const float f6 = g5 - g6;
-                            const float f7 = g4 + g7;
-
-                            const float e0 = f0;
-                            const float e1 = f1;
-                            const float e2 = f2 - f3;
-                            const float e3 = f2 + f3;
-                            const float e4 = f4;
-                            const float e5 = f5 - f7;
-                            const float e6 = f6;
-                            const float e7 = f5 + f7;
-                            const float e8 = f4 + f6;
-
-                            const float d0 = e0;
-                            const float d1 = e1;
-                            const float d2 = e2 * m1;
-                            const float d3 = e3;
-                            const float d4 = e4 * m2;
-                            const float d5 = e5 * m3;
-                            const float d6 = e6 * m4;
-                            const float d7 = e7;
-                            const float d8 = e8 * m5;
-
-                            const float c0 = d0 + d1;
-                            const float c1 = d0 - d1;
-                            const float c2 = d2 - d3;
-                            const float c3 = d3;
-                            const float c4 = d4 + d8;
-                            const float c5 = d5 + d7;
-                            const float c6 = d6 - d8;
-                            const float c7 = d7;
-                            const float c8 = c5 - c6;
-
-                            const float b0 = c0 + c3;
-                            const float b1 = c1 + c2;
-                            const float b2 = c1 - c2;
-                            const float b3 = c0 - c3;
-                            const float b4 = c4 - c8;
-                            const float b5 = c8;
-                            const float b6 = c6 - c7;
-                            const float b7 = c7;
-
-                            block_component[l * 8 + 0] = b0 + b7;
-                            block_component[l * 8 + 1] = b1 + b6;
-                            block_component[l * 8 + 2] = b2 + b5;
-                            block_component[l * 8 + 3] = b3 + b4;
-                            block_component[l * 8 + 4] = b3 - b4;
-                            block_component[l * 8 + 5] = b2 - b5;
-                            block_component[l * 8 + 6] = b1 - b6;
-                            block_component[l * 8 + 7] = b0 - b7;
-                        }
+                        // The rows go through the same transform as the columns, so the block is transposed in between
+                        // to let both passes work on four of them at a time.
+                        inverse_dct_on_four_columns(block_component);
+                        inverse_dct_on_four_columns(block_component + 4);
+                        transpose_block_component(block_component);
+                        inverse_dct_on_four_columns(block_component);
+                        inverse_dct_on_four_columns(block_component + 4);
+                        transpose_block_component(block_component);
                     }
                 }
             }
@@ -1028,55 +1043,71 @@ static void inverse_dct(const JPGLoadingContext& context, Vector<Macroblock>& ma
     }
 }
 
-static void ycbcr_to_rgb(const JPGLoadingContext& context, Vector<Macroblock>& macroblocks)
+// Converts the decoded YCbCr values to RGB while writing them into the bitmap, a whole macroblock row at a time.
+static bool compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
 {
+    context.bitmap = Bitmap::create_purgeable(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
+    if (!context.bitmap)
+        return false;
+
+    auto clamp_to_u8 = [](int value) -> u8 { return value < 0 ? 0 : (value > 255 ? 255 : value); };
+
     for (u32 vcursor = 0; vcursor < context.mblock_meta.vcount; vcursor += context.vsample_factor) {
         for (u32 hcursor = 0; hcursor < context.mblock_meta.hcount; hcursor += context.hsample_factor) {
             const u32 chroma_block_index = vcursor * context.mblock_meta.hpadded_count + hcursor;
             const Macroblock& chroma = macroblocks[chroma_block_index];
-            // Overflows are intentional.
-            for (u8 vfactor_i = context.vsample_factor - 1; vfactor_i < context.vsample_factor; --vfactor_i) {
-                for (u8 hfactor_i = context.hsample_factor - 1; hfactor_i < context.hsample_factor; --hfactor_i) {
-                    u32 mb_index = (vcursor + vfactor_i) * context.mblock_meta.hpadded_count + (hcursor + hfactor_i);
-                    i32* y = macroblocks[mb_index].y;
-                    i32* cb = macroblocks[mb_index].cb;
-                    i32* cr = macroblocks[mb_index].cr;
-                    for (u8 i = 7; i < 8; --i) {
-                        for (u8 j = 7; j < 8; --j) {
-                            const u8 pixel = i * 8 + j;
+            for (u8 vfactor_i = 0; vfactor_i < context.vsample_factor; ++vfactor_i) {
+                for (u8 hfactor_i = 0; hfactor_i < context.hsample_factor; ++hfactor_i) {
+                    u32 block_row = vcursor + vfactor_i;
+                    u32 block_column = hcursor + hfactor_i;
+                    const i32* y = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column].y;
+                    for (u32 i = 0; i < 8 && block_row * 8 + i < context.frame.height; ++i) {
+                        RGBA32* scanline = context.bitmap->scanline(block_row * 8 + i);
+                        for (u32 j = 0; j < 8 && block_column * 8 + j < context.frame.width; ++j) {
+                            const u32 pixel = i * 8 + j;
                             const u32 chroma_pxrow = (i / context.vsample_factor) + 4 * vfactor_i;
                             const u32 chroma_pxcol = (j / context.hsample_factor) + 4 * hfactor_i;
                             const u32 chroma_pixel = chroma_pxrow * 8 + chroma_pxcol;
                             int r = y[pixel] + 1.402f * chroma.cr[chroma_pixel] + 128;
                             int g = y[pixel] - 0.344f * chroma.cb[chroma_pixel] - 0.714f * chroma.cr[chroma_pixel] + 128;
                             int b = y[pixel] + 1.772f * chroma.cb[chroma_pixel] + 128;
-                            y[pixel] = r < 0 ? 0 : (r > 255 ? 255 : r);
-                            cb[pixel] = g < 0 ? 0 : (g > 255 ? 255 : g);
-                            cr[pixel] = b < 0 ? 0 : (b > 255 ? 255 : b);
+                            scanline[block_column * 8 + j] = Color(clamp_to_u8(r), clamp_to_u8(g), clamp_to_u8(b)).value();
                         }
                     }
                 }
             }
         }
     }
+
+    return true;
 }
 
-static bool compose_bitmap(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
+// The DC coefficient of a block is eight times the average of its pixels, so an image at an eighth of the size falls
+// right out of the coefficients, without running the inverse DCT at all.
+static bool compose_bitmap_at_eighth_size(JPGLoadingContext& context, const Vector<Macroblock>& macroblocks)
 {
-    context.bitmap = Bitmap::create_purgeable(BitmapFormat::BGRx8888, { context.frame.width, context.frame.height });
+    int width = (context.frame.width + 7) / 8;
+    int height = (context.frame.height + 7) / 8;
+    context.bitmap = Bitmap::create_purgeable(BitmapFormat::BGRx8888, { width, height });
     if (!context.bitmap)
         return false;
 
-    for (u32 y = context.frame.height - 1; y < context.frame.height; y--) {
-        const u32 block_row = y / 8;
-        const u32 pixel_row = y % 8;
-        for (u32 x = 0; x < context.frame.width; x++) {
-            const u32 block_column = x / 8;
-            auto& block = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
-            const u32 pixel_column = x % 8;
-            const u32 pixel_index = pixel_row * 8 + pixel_column;
-            const Color color { (u8)block.y[pixel_index], (u8)block.cb[pixel_index], (u8)block.cr[pixel_index] };
-            context.bitmap->set_pixel(x, y, color);
+    auto clamp_to_u8 = [](int value) -> u8 { return value < 0 ? 0 : (value > 255 ? 255 : value); };
+
+    for (int block_row = 0; block_row < height; ++block_row) {
+        RGBA32* scanline = context.bitmap->scanline(block_row);
+        u32 chroma_block_row = block_row - block_row % context.vsample_factor;
+        for (int block_column = 0; block_column < width; ++block_column) {
+            u32 chroma_block_column = block_column - block_column % context.hsample_factor;
+            const Macroblock& luma = macroblocks[block_row * context.mblock_meta.hpadded_count + block_column];
+            const Macroblock& chroma = macroblocks[chroma_block_row * context.mblock_meta.hpadded_count + chroma_block_column];
+            float y = luma.y[0] / 8.0f;
+            float cb = chroma.cb[0] / 8.0f;
+            float cr = chroma.cr[0] / 8.0f;
+            int r = y + 1.402f * cr + 128;
+            int g = y - 0.344f * cb - 0.714f * cr + 128;
+            int b = y + 1.772f * cb + 128;
+            scanline[block_column] = Color(clamp_to_u8(r), clamp_to_u8(g), clamp_to_u8(b)).value();
         }
     }
 
@@ -1213,18 +1244,20 @@ static bool decode_jpg(JPGLoadingContext& context)
 
     auto macroblocks = result.release_value();
     dequantize(context, macroblocks);
+    if (!context.minimum_size.is_empty() && context.frame.width / 8 >= context.minimum_size.width() && context.frame.height / 8 >= context.minimum_size.height())
+        return compose_bitmap_at_eighth_size(context, macroblocks);
     inverse_dct(context, macroblocks);
-    ycbcr_to_rgb(context, macroblocks);
     if (!compose_bitmap(context, macroblocks))
         return false;
     return true;
 }
 
-static RefPtr<Gfx::Bitmap> load_jpg_impl(const u8* data, size_t data_size)
+static RefPtr<Gfx::Bitmap> load_jpg_impl(const u8* data, size_t data_size, IntSize minimum_size = {})
 {
     JPGLoadingContext context;
     context.data = data;
     context.data_size = data_size;
+    context.minimum_size = minimum_size;
 
     if (!decode_jpg(context))
         return nullptr;
@@ -1243,6 +1276,17 @@ RefPtr<Gfx::Bitmap> load_jpg(String const& path)
     return bitmap;
 }
 
+RefPtr<Gfx::Bitmap> load_jpg_downscaled(String const& path, IntSize minimum_size)
+{
+    auto file_or_error = MappedFile::map(path);
+    if (file_or_error.is_error())
+        return nullptr;
+    auto bitmap = load_jpg_impl((const u8*)file_or_error.value()->data(), file_or_error.value()->size(), minimum_size);
+    if (bitmap)
+        bitmap->set_mmap_name(String::formatted("Gfx::Bitmap [{}] - Decoded JPG: {}", bitmap->size(), LexicalPath::canonicalized_path(path)));
+    return bitmap;
+}
+
 RefPtr<Gfx::Bitmap> load_jpg_from_memory(const u8* data, size_t length)
 {
     auto bitmap = load_jpg_impl(data, length);
@@ -14,6 +14,9 @@
 namespace Gfx {
 
 RefPtr<Gfx::Bitmap> load_jpg(String const& path);
+// Decodes the image at an eighth of its size if that's still at least the minimum size, which is a lot faster than
+// decoding all of it. Otherwise, this is the same as load_jpg().
+RefPtr<Gfx::Bitmap> load_jpg_downscaled(String const& path, IntSize minimum_size);
 RefPtr<Gfx::Bitmap> load_jpg_from_memory(const u8* data, size_t length);
 
 struct JPGLoadingContext;
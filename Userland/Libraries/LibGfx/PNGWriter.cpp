@@ -6,6 +6,7 @@
  */
 
 #include <AK/String.h>
+#include <LibCompress/Zlib.h>
 #include <LibCrypto/Checksum/CRC32.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/PNGWriter.h>
@@ -22,29 +23,13 @@ public:
     void add_u32_big(u32);
     void add_u16_little(u16);
     void add_u32_little(u32);
+    void add_bytes(ReadonlyBytes);
 
 private:
     Vector<u8> m_data;
     String m_type;
 };
 
-class NonCompressibleBlock {
-public:
-    void finalize(PNGChunk&);
-    void add_byte_to_block(u8 data, PNGChunk&);
-
-    u32 adler_s1() const { return m_adler_s1; }
-    u32 adler_s2() const { return m_adler_s2; }
-
-private:
-    void add_block_to_chunk(PNGChunk&, bool);
-    void update_adler(u8);
-    bool full() { return m_non_compressible_data.size() == 65535; }
-    Vector<u8> m_non_compressible_data;
-    u32 m_adler_s1 { 1 };
-    u32 m_adler_s2 { 0 };
-};
-
 PNGChunk::PNGChunk(String type)
     : m_type(move(type))
 {
@@ -69,6 +54,11 @@ void PNGChunk::add_u32_little(u32 data)
     m_data.append((data >> 24) & 0xff);
 }
 
+void PNGChunk::add_bytes(ReadonlyBytes bytes)
+{
+    m_data.append(bytes.data(), bytes.size());
+}
+
 void PNGChunk::add_u32_big(u32 data)
 {
     m_data.append((data >> 24) & 0xff);
@@ -83,46 +73,6 @@ void PNGChunk::add_u16_big(u16 data)
     m_data.append(data & 0xff);
 }
 
-void NonCompressibleBlock::add_byte_to_block(u8 data, PNGChunk& chunk)
-{
-    m_non_compressible_data.append(data);
-    update_adler(data);
-    if (full()) {
-        add_block_to_chunk(chunk, false);
-        m_non_compressible_data.clear();
-    }
-}
-
-void NonCompressibleBlock::add_block_to_chunk(PNGChunk& png_chunk, bool last)
-{
-    if (last) {
-        png_chunk.add_u8(1);
-    } else {
-        png_chunk.add_u8(0);
-    }
-
-    auto len = m_non_compressible_data.size();
-    auto nlen = ~len;
-
-    png_chunk.add_u16_little(len);
-    png_chunk.add_u16_little(nlen);
-
-    for (auto non_compressed_byte : m_non_compressible_data) {
-        png_chunk.add_u8(non_compressed_byte);
-    }
-}
-
-void NonCompressibleBlock::finalize(PNGChunk& chunk)
-{
-    add_block_to_chunk(chunk, true);
-}
-
-void NonCompressibleBlock::update_adler(u8 data)
-{
-    m_adler_s1 = (m_adler_s1 + data) % 65521;
-    m_adler_s2 = (m_adler_s2 + m_adler_s1) % 65521;
-}
-
 void PNGWriter::add_chunk(PNGChunk const& png_chunk)
 {
     Vector<u8> combined;
@@ -132,7 +82,7 @@ void PNGWriter::add_chunk(PNGChunk const& png_chunk)
     combined.append(png_chunk.data());
 
     auto crc = BigEndian(Crypto::Checksum::CRC32({ (const u8*)combined.data(), combined.size() }).digest());
-    auto data_len = BigEndian(png_chunk.data().size());
+    auto data_len = BigEndian<u32>(png_chunk.data().size());
 
     ByteBuffer buf;
     buf.append(&data_len, sizeof(u32));
@@ -171,26 +121,23 @@ void PNGWriter::add_IDAT_chunk(Gfx::Bitmap const& bitmap)
 {
     PNGChunk png_chunk { "IDAT" };
 
-    u16 CMF_FLG = 0x81d;
-    png_chunk.add_u16_big(CMF_FLG);
-
-    NonCompressibleBlock non_compressible_block;
-
+    auto uncompressed_data = ByteBuffer::create_uninitialized(bitmap.height() * (1 + bitmap.width() * 4));
+    size_t offset = 0;
     for (int y = 0; y < bitmap.height(); ++y) {
-        non_compressible_block.add_byte_to_block(0, png_chunk);
+        uncompressed_data[offset++] = 0; // No filter
 
         for (int x = 0; x < bitmap.width(); ++x) {
             auto pixel = bitmap.get_pixel(x, y);
-            non_compressible_block.add_byte_to_block(pixel.red(), png_chunk);
-            non_compressible_block.add_byte_to_block(pixel.green(), png_chunk);
-            non_compressible_block.add_byte_to_block(pixel.blue(), png_chunk);
-            non_compressible_block.add_byte_to_block(pixel.alpha(), png_chunk);
+            uncompressed_data[offset++] = pixel.red();
+            uncompressed_data[offset++] = pixel.green();
+            uncompressed_data[offset++] = pixel.blue();
+            uncompressed_data[offset++] = pixel.alpha();
         }
     }
-    non_compressible_block.finalize(png_chunk);
 
-    png_chunk.add_u16_big(non_compressible_block.adler_s2());
-    png_chunk.add_u16_big(non_compressible_block.adler_s1());
+    auto compressed_data = Compress::Zlib::compress_all(uncompressed_data);
+    VERIFY(compressed_data.has_value());
+    png_chunk.add_bytes(compressed_data.value());
 
     add_chunk(png_chunk);
 }
@@ -16,6 +16,7 @@
 #include <AK/Memory.h>
 #include <AK/Queue.h>
 #include <AK/QuickSort.h>
+#include <AK/SIMD.h>
 #include <AK/StdLibExtras.h>
 #include <AK/StringBuilder.h>
 #include <AK/Utf32View.h>
@@ -50,6 +51,38 @@ ALWAYS_INLINE Color get_pixel(const Gfx::Bitmap& bitmap, int x, int y)
     return bitmap.get_pixel(x, y);
 }
 
+// Blends the source pixels onto opaque destination pixels, which is what Color::blend() comes down to for every
+// BGRx8888 target. The alpha of each source pixel is looked up in the table by its own alpha, so that callers can fold
+// their opacity into it.
+static void blend_scanline_onto_opaque(RGBA32* dst, const RGBA32* src, int count, const u8* alpha_table)
+{
+    int i = 0;
+#ifdef __SSE2__
+    using AK::SIMD::u16x16;
+    using AK::SIMD::u8x16;
+
+    // With the destination opaque, blending is (d * (255 - a) + s * a) / 255 for every channel, which always fits in
+    // 16 bits. The division is exact for the full range with an add and a couple of shifts.
+    constexpr u8x16 opaque_alpha = { 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255 };
+    for (; i + 4 <= count; i += 4) {
+        u8x16 dst_pixels;
+        u8x16 src_pixels;
+        __builtin_memcpy(&dst_pixels, dst + i, sizeof(dst_pixels));
+        __builtin_memcpy(&src_pixels, src + i, sizeof(src_pixels));
+        u16 a0 = alpha_table[src[i] >> 24];
+        u16 a1 = alpha_table[src[i + 1] >> 24];
+        u16 a2 = alpha_table[src[i + 2] >> 24];
+        u16 a3 = alpha_table[src[i + 3] >> 24];
+        u16x16 alpha = { a0, a0, a0, a0, a1, a1, a1, a1, a2, a2, a2, a2, a3, a3, a3, a3 };
+        u16x16 blended = __builtin_convertvector(dst_pixels, u16x16) * (255 - alpha) + __builtin_convertvector(src_pixels, u16x16) * alpha + 1;
+        u8x16 result = __builtin_convertvector((blended + (blended >> 8)) >> 8, u8x16) | opaque_alpha;
+        __builtin_memcpy(dst + i, &result, sizeof(result));
+    }
+#endif
+    for (; i < count; ++i)
+        dst[i] = Color::from_rgb(dst[i]).blend(Color::from_rgb(src[i]).with_alpha(alpha_table[src[i] >> 24])).value();
+}
+
 Painter::Painter(Gfx::Bitmap& bitmap)
     : m_target(bitmap)
 {
@@ -110,9 +143,26 @@ void Painter::fill_physical_rect(const IntRect& physical_rect, Color color)
     RGBA32* dst = m_target->scanline(physical_rect.top()) + physical_rect.left();
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
+    // Runs of opaque pixels get blended a scanline's worth at a time, everything else goes through Color::blend().
+    u8 alpha_table[256];
+    __builtin_memset(alpha_table, color.alpha(), sizeof(alpha_table));
+    RGBA32 source_scanline[64];
+    fast_u32_fill(source_scanline, color.value(), array_size(source_scanline));
+
     for (int i = physical_rect.height() - 1; i >= 0; --i) {
-        for (int j = 0; j < physical_rect.width(); ++j)
+        int j = 0;
+        while (j < physical_rect.width()) {
+            int run_length = 0;
+            while (j + run_length < physical_rect.width() && run_length < (int)array_size(source_scanline) && (dst[j + run_length] >> 24) == 0xff)
+                ++run_length;
+            if (run_length) {
+                blend_scanline_onto_opaque(dst + j, source_scanline, run_length, alpha_table);
+                j += run_length;
+                continue;
+            }
             dst[j] = Color::from_rgba(dst[j]).blend(color).value();
+            ++j;
+        }
         dst += dst_skip;
     }
 }
@@ -411,22 +461,28 @@ void Painter::draw_bitmap(const IntPoint& p, const GlyphBitmap& bitmap, Color co
     RGBA32* dst = m_target->scanline(clipped_rect.y() * scale) + clipped_rect.x() * scale;
     const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
+    // Every row of a glyph is a bit mask, so we can go straight from one set bit to the next instead of looking at
+    // every pixel. Most of a glyph is empty.
+    int visible_width = last_column - first_column + 1;
+    u32 visible_columns_mask = visible_width >= 32 ? 0xffffffff : (1u << visible_width) - 1;
+
     if (scale == 1) {
         for (int row = first_row; row <= last_row; ++row) {
-            for (int j = 0; j <= (last_column - first_column); ++j) {
-                if (bitmap.bit_at(j + first_column, row))
-                    dst[j] = color.value();
+            u32 bits = (bitmap.row(row) >> first_column) & visible_columns_mask;
+            while (bits) {
+                dst[count_trailing_zeroes_32(bits)] = color.value();
+                bits &= bits - 1;
             }
             dst += dst_skip;
         }
     } else {
         for (int row = first_row; row <= last_row; ++row) {
-            for (int j = 0; j <= (last_column - first_column); ++j) {
-                if (bitmap.bit_at((j + first_column), row)) {
-                    for (int iy = 0; iy < scale; ++iy)
-                        for (int ix = 0; ix < scale; ++ix)
-                            dst[j * scale + ix + iy * dst_skip] = color.value();
-                }
+            u32 bits = (bitmap.row(row) >> first_column) & visible_columns_mask;
+            while (bits) {
+                auto j = count_trailing_zeroes_32(bits);
+                for (int iy = 0; iy < scale; ++iy)
+                    fast_u32_fill(dst + j * scale + iy * dst_skip, color.value(), scale);
+                bits &= bits - 1;
             }
             dst += dst_skip * scale;
         }
@@ -533,6 +589,25 @@ struct BlitState {
 template<BlitState::AlphaState has_alpha>
 static void do_blit_with_opacity(BlitState& state)
 {
+    if constexpr (!(has_alpha & BlitState::DstAlpha)) {
+        // The destination is opaque, so every pixel only needs its alpha scaled by the opacity, the same way as below.
+        u8 alpha_table[256];
+        for (int alpha = 0; alpha < 256; ++alpha) {
+            if constexpr (has_alpha & BlitState::SrcAlpha) {
+                float pixel_opacity = alpha / 255.0;
+                alpha_table[alpha] = 255 * (state.opacity * pixel_opacity);
+            } else {
+                alpha_table[alpha] = state.opacity * 255;
+            }
+        }
+        for (int row = 0; row < state.row_count; ++row) {
+            blend_scanline_onto_opaque(state.dst, state.src, state.column_count, alpha_table);
+            state.dst += state.dst_pitch;
+            state.src += state.src_pitch;
+        }
+        return;
+    }
+
     for (int row = 0; row < state.row_count; ++row) {
         for (int x = 0; x < state.column_count; ++x) {
             Color dest_color = (has_alpha & BlitState::DstAlpha) ? Color::from_rgba(state.dst[x]) : Color::from_rgb(state.dst[x]);
@@ -601,7 +676,8 @@ void Painter::blit_with_opacity(const IntPoint& position, const Gfx::Bitmap& sou
     }
 }
 
-void Painter::blit_filtered(const IntPoint& position, const Gfx::Bitmap& source, const IntRect& src_rect, Function<Color(Color)> filter)
+template<typename Filter>
+ALWAYS_INLINE void Painter::do_blit_filtered(const IntPoint& position, const Gfx::Bitmap& source, const IntRect& src_rect, const Filter& filter)
 {
     VERIFY((source.scale() == 1 || source.scale() == scale()) && "blit_filtered only supports integer upsampling");
 
@@ -666,6 +742,11 @@ void Painter::blit_filtered(const IntPoint& position, const Gfx::Bitmap& source,
     }
 }
 
+void Painter::blit_filtered(const IntPoint& position, const Gfx::Bitmap& source, const IntRect& src_rect, Function<Color(Color)> filter)
+{
+    do_blit_filtered(position, source, src_rect, filter);
+}
+
 void Painter::blit_brightened(const IntPoint& position, const Gfx::Bitmap& source, const IntRect& src_rect)
 {
     return blit_filtered(position, source, src_rect, [](Color src) {
@@ -862,9 +943,9 @@ ALWAYS_INLINE static void do_draw_scaled_bitmap(Gfx::Bitmap& target, const IntRe
 
     for (int y = clipped_rect.top(); y <= clipped_rect.bottom(); ++y) {
         auto* scanline = (Color*)target.scanline(y);
+        auto scaled_y = ((y - dst_rect.y()) * vscale + src_top) >> 16;
         for (int x = clipped_rect.left(); x <= clipped_rect.right(); ++x) {
             auto scaled_x = ((x - dst_rect.x()) * hscale + src_left) >> 16;
-            auto scaled_y = ((y - dst_rect.y()) * vscale + src_top) >> 16;
             auto src_pixel = get_pixel(source, scaled_x, scaled_y);
             if (has_opacity)
                 src_pixel.set_alpha(src_pixel.alpha() * opacity);
@@ -945,7 +1026,8 @@ FLATTEN void Painter::draw_glyph(const IntPoint& point, u32 code_point, const Fo
     if (glyph.is_glyph_bitmap()) {
         draw_bitmap(top_left, glyph.glyph_bitmap(), color);
     } else {
-        blit_filtered(top_left, *glyph.bitmap(), glyph.bitmap()->rect(), [color](Color pixel) -> Color {
+        // Text draws a lot of glyphs, so this doesn't go through a Function call for every one of their pixels.
+        do_blit_filtered(top_left, *glyph.bitmap(), glyph.bitmap_rect(), [color](Color pixel) -> Color {
             return pixel.multiply(color);
         });
     }
@@ -1016,8 +1098,14 @@ struct ElidedText<Utf32View> {
     typedef Vector<u32> Type;
 };
 
+// Glyphs may reach a little past the box they're laid out in, but not by more than this.
+static int glyph_overhang(const Font& font)
+{
+    return font.glyph_height();
+}
+
 template<typename TextType, typename DrawGlyphFunction>
-void draw_text_line(const IntRect& a_rect, const TextType& text, const Font& font, TextAlignment alignment, TextElision elision, DrawGlyphFunction draw_glyph)
+void draw_text_line(const IntRect& a_rect, const TextType& text, const Font& font, TextAlignment alignment, TextElision elision, const Optional<IntRect>& visible_rect, DrawGlyphFunction draw_glyph)
 {
     auto rect = a_rect;
     TextType final_text(text);
@@ -1074,13 +1162,27 @@ void draw_text_line(const IntRect& a_rect, const TextType& text, const Font& fon
     auto point = rect.location();
     int space_width = font.glyph_width(' ') + font.glyph_spacing();
 
+    // Only the glyphs that end up inside the visible part of the line are drawn.
+    int visible_left = NumericLimits<int>::min();
+    int visible_right = NumericLimits<int>::max();
+    if (visible_rect.has_value()) {
+        auto overhang = glyph_overhang(font);
+        if (point.y() + font.glyph_height() + overhang <= visible_rect->top() || point.y() - overhang > visible_rect->bottom())
+            return;
+        visible_left = visible_rect->left() - overhang;
+        visible_right = visible_rect->right() + overhang;
+    }
+
     for (u32 code_point : final_text) {
+        if (point.x() > visible_right)
+            break;
         if (code_point == ' ') {
             point.move_by(space_width, 0);
             continue;
         }
         IntSize glyph_size(font.glyph_or_emoji_width(code_point) + font.glyph_spacing(), font.glyph_height());
-        draw_glyph({ point, glyph_size }, code_point);
+        if (point.x() + glyph_size.width() > visible_left)
+            draw_glyph({ point, glyph_size }, code_point);
         point.move_by(glyph_size.width(), 0);
     }
 }
@@ -1105,8 +1207,9 @@ static inline size_t draw_text_get_length(const Utf32View& text)
     return text.length();
 }
 
+// If there's a |visible_rect|, glyphs outside of it are left out, as drawing them wouldn't change anything.
 template<typename TextType, typename DrawGlyphFunction>
-void do_draw_text(const IntRect& rect, const TextType& text, const Font& font, TextAlignment alignment, TextElision elision, DrawGlyphFunction draw_glyph)
+void do_draw_text(const IntRect& rect, const TextType& text, const Font& font, TextAlignment alignment, TextElision elision, const Optional<IntRect>& visible_rect, DrawGlyphFunction draw_glyph)
 {
     Vector<TextType, 32> lines;
 
@@ -1163,7 +1266,7 @@ void do_draw_text(const IntRect& rect, const TextType& text, const Font& font, T
         auto& line = lines[i];
         IntRect line_rect { bounding_rect.x(), bounding_rect.y() + static_cast<int>(i) * line_height, bounding_rect.width(), line_height };
         line_rect.intersect(rect);
-        draw_text_line(line_rect, line, font, alignment, elision, draw_glyph);
+        draw_text_line(line_rect, line, font, alignment, elision, visible_rect, draw_glyph);
     }
 }
 
@@ -1180,14 +1283,14 @@ void Painter::draw_text(const IntRect& rect, const Utf32View& text, TextAlignmen
 void Painter::draw_text(const IntRect& rect, const StringView& raw_text, const Font& font, TextAlignment alignment, Color color, TextElision elision)
 {
     Utf8View text { raw_text };
-    do_draw_text(rect, Utf8View(text), font, alignment, elision, [&](const IntRect& r, u32 code_point) {
+    do_draw_text(rect, Utf8View(text), font, alignment, elision, clip_rect().translated(-translation()), [&](const IntRect& r, u32 code_point) {
         draw_glyph_or_emoji(r.location(), code_point, font, color);
     });
 }
 
 void Painter::draw_text(const IntRect& rect, const Utf32View& text, const Font& font, TextAlignment alignment, Color color, TextElision elision)
 {
-    do_draw_text(rect, text, font, alignment, elision, [&](const IntRect& r, u32 code_point) {
+    do_draw_text(rect, text, font, alignment, elision, clip_rect().translated(-translation()), [&](const IntRect& r, u32 code_point) {
         draw_glyph_or_emoji(r.location(), code_point, font, color);
     });
 }
@@ -1197,7 +1300,7 @@ void Painter::draw_text(Function<void(const IntRect&, u32)> draw_one_glyph, cons
     VERIFY(scale() == 1); // FIXME: Add scaling support.
 
     Utf8View text { raw_text };
-    do_draw_text(rect, text, font, alignment, elision, [&](const IntRect& r, u32 code_point) {
+    do_draw_text(rect, text, font, alignment, elision, {}, [&](const IntRect& r, u32 code_point) {
         draw_one_glyph(r, code_point);
     });
 }
@@ -1206,7 +1309,7 @@ void Painter::draw_text(Function<void(const IntRect&, u32)> draw_one_glyph, cons
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
 
-    do_draw_text(rect, text, font, alignment, elision, [&](const IntRect& r, u32 code_point) {
+    do_draw_text(rect, text, font, alignment, elision, {}, [&](const IntRect& r, u32 code_point) {
         draw_one_glyph(r, code_point);
     });
 }
@@ -1215,7 +1318,7 @@ void Painter::draw_text(Function<void(const IntRect&, u32)> draw_one_glyph, cons
 {
     VERIFY(scale() == 1); // FIXME: Add scaling support.
 
-    do_draw_text(rect, text, font, alignment, elision, [&](const IntRect& r, u32 code_point) {
+    do_draw_text(rect, text, font, alignment, elision, {}, [&](const IntRect& r, u32 code_point) {
         draw_one_glyph(r, code_point);
     });
 }
@@ -1609,26 +1712,105 @@ void Painter::stroke_path(const Path& path, Color color, int thickness)
     }
 }
 
-[[maybe_unused]] static void approximately_place_on_int_grid(FloatPoint ffrom, FloatPoint fto, IntPoint& from, IntPoint& to, Optional<IntPoint> previous_to)
+// Paths are filled by accumulating signed area, in the style of font-rs: every edge adds the area it covers in each
+// pixel to a buffer, signed by its direction, so that the running sum along a row is the winding number, with
+// fractional values on the pixels that an edge passes through. Rows are rasterized in bands, so the buffer stays small
+// no matter how large the path is, and only the edges that cross a band are drawn into it.
+static constexpr int fill_path_band_height = 16;
+
+struct FillPathEdge {
+    // Relative to the top left of the filled rect, with from.y() < to.y().
+    FloatPoint from;
+    FloatPoint to;
+    float direction { 0 };
+};
+
+static void accumulate_edge(const FillPathEdge& edge, Vector<float>& area, int width, int band_top, int band_height)
+{
+    auto from = edge.from;
+    auto to = edge.to;
+    float dxdy = (to.x() - from.x()) / (to.y() - from.y());
+
+    int first_row = max(band_top, (int)floorf(from.y()));
+    int last_row = min(band_top + band_height, (int)ceilf(to.y()));
+    for (int y = first_row; y < last_row; ++y) {
+        float row_top = max((float)y, from.y());
+        float row_bottom = min((float)(y + 1), to.y());
+        float d = (row_bottom - row_top) * edge.direction;
+
+        // Whatever lies left of the filled rect covers it all, so it's clamped onto its first column.
+        float x0 = clamp(from.x() + (row_top - from.y()) * dxdy, 0.0f, (float)width);
+        float x1 = clamp(from.x() + (row_bottom - from.y()) * dxdy, 0.0f, (float)width);
+        if (x0 > x1)
+            swap(x0, x1);
+
+        float* row = area.data() + (size_t)(y - band_top) * (width + 2);
+        float x0_floor = floorf(x0);
+        float x1_ceil = ceilf(x1);
+        int x0i = (int)x0_floor;
+        int x1i = (int)x1_ceil;
+
+        if (x1i <= x0i + 1) {
+            // Within a single pixel: the area right of the edge in this pixel, and the rest in the next one.
+            float xm = 0.5f * (x0 + x1) - x0_floor;
+            row[x0i] += d - d * xm;
+            row[x0i + 1] += d * xm;
+            continue;
+        }
+
+        float s = 1.0f / (x1 - x0);
+        float x0f = x0 - x0_floor;
+        float a0 = 0.5f * s * (1.0f - x0f) * (1.0f - x0f);
+        float x1f = x1 - x1_ceil + 1.0f;
+        float am = 0.5f * s * x1f * x1f;
+        row[x0i] += d * a0;
+        if (x1i == x0i + 2) {
+            row[x0i + 1] += d * (1.0f - a0 - am);
+        } else {
+            float a1 = s * (1.5f - x0f);
+            row[x0i + 1] += d * (a1 - a0);
+            for (int x = x0i + 2; x < x1i - 1; ++x)
+                row[x] += d * s;
+            float a2 = a1 + (float)(x1i - x0i - 3) * s;
+            row[x1i - 1] += d * (1.0f - a2 - am);
+        }
+        row[x1i] += d * am;
+    }
+}
+
+// Turns a row of accumulated area into winding numbers, in place.
+static void accumulate_row(float* row, int width)
 {
-    auto diffs = fto - ffrom;
-    // Truncate all first (round down).
-    from = ffrom.to_type<int>();
-    to = fto.to_type<int>();
-    // There are 16 possible configurations, by deciding to round each
-    // coord up or down (and there are four coords, from.x from.y to.x to.y)
-    // we will simply choose one which most closely matches the correct slope
-    // with the following heuristic:
-    // - if the x diff is positive or zero (that is, a right-to-left slant), round 'from.x' up and 'to.x' down.
-    // - if the x diff is negative         (that is, a left-to-right slant), round 'from.x' down and 'to.x' up.
-    // Note that we do not need to touch the 'y' attribute, as that is our scanline.
-    if (diffs.x() >= 0) {
-        from.set_x(from.x() + 1);
-    } else {
-        to.set_x(to.x() + 1);
+    using AK::SIMD::f32x4;
+
+    int x = 0;
+    float sum = 0;
+    for (; x + 4 <= width; x += 4) {
+        f32x4 v;
+        __builtin_memcpy(&v, row + x, sizeof(v));
+        // Prefix sum within the vector, then carry over the sum of everything before it.
+        v += f32x4 { 0, v[0], v[1], v[2] };
+        v += f32x4 { 0, 0, v[0], v[1] };
+        v += sum;
+        __builtin_memcpy(row + x, &v, sizeof(v));
+        sum = v[3];
+    }
+    for (; x < width; ++x) {
+        sum += row[x];
+        row[x] = sum;
     }
-    if (previous_to.has_value() && from.x() != previous_to.value().x()) // The points have to line up, since we're using these lines to fill a shape.
-        from.set_x(previous_to.value().x());
+}
+
+ALWAYS_INLINE static float coverage_for_winding(float winding, Painter::WindingRule winding_rule)
+{
+    float coverage = fabsf(winding);
+    if (winding_rule == Painter::WindingRule::EvenOdd) {
+        coverage = fmodf(coverage, 2.0f);
+        if (coverage > 1.0f)
+            coverage = 2.0f - coverage;
+    }
+    // Rounding errors may leave the inside of a shape at a winding number of 0.9999.
+    return coverage >= 0.999f ? 1.0f : coverage;
 }
 
 void Painter::fill_path(Path& path, Color color, WindingRule winding_rule)
@@ -1636,139 +1818,86 @@ void Painter::fill_path(Path& path, Color color, WindingRule winding_rule)
     VERIFY(scale() == 1); // FIXME: Add scaling support.
 
     const auto& segments = path.split_lines();
-
-    if (segments.size() == 0)
+    if (segments.is_empty() || color.alpha() == 0)
         return;
 
-    Vector<Path::SplitLineSegment> active_list;
-    active_list.ensure_capacity(segments.size());
-
-    // first, grab the segments for the very first scanline
-    int first_y = path.bounding_box().bottom_right().y() + 1;
-    int last_y = path.bounding_box().top_left().y() - 1;
-    float scanline = first_y;
-
-    size_t last_active_segment { 0 };
+    auto offset = translation().to_type<float>();
+    auto bounding_box = path.bounding_box().translated(offset);
+    IntRect path_rect { (int)floorf(bounding_box.x()), (int)floorf(bounding_box.y()), 0, 0 };
+    path_rect.set_width((int)ceilf(bounding_box.x() + bounding_box.width()) - path_rect.x());
+    path_rect.set_height((int)ceilf(bounding_box.y() + bounding_box.height()) - path_rect.y());
+    auto rect = path_rect.intersected(clip_rect());
+    if (rect.is_empty())
+        return;
 
+    Vector<FillPathEdge> edges;
+    edges.ensure_capacity(segments.size());
+    FloatPoint origin = offset - rect.location().to_type<float>();
     for (auto& segment : segments) {
-        if (segment.maximum_y != scanline)
-            break;
-        active_list.append(segment);
-        ++last_active_segment;
+        auto from = segment.from + origin;
+        auto to = segment.to + origin;
+        if (from.y() == to.y())
+            continue;
+        if (from.y() < to.y())
+            edges.unchecked_append({ from, to, 1 });
+        else
+            edges.unchecked_append({ to, from, -1 });
     }
+    quick_sort(edges, [](auto& a, auto& b) { return a.from.y() < b.from.y(); });
 
-    auto is_inside_shape = [winding_rule](int winding_number) {
-        if (winding_rule == WindingRule::Nonzero)
-            return winding_number != 0;
+    int width = rect.width();
+    // One extra column for the area right of an edge in the last pixel, and one for an edge on the right border.
+    Vector<float> area;
+    area.resize((size_t)(width + 2) * fill_path_band_height);
 
-        if (winding_rule == WindingRule::EvenOdd)
-            return winding_number % 2 == 0;
+    Vector<const FillPathEdge*> active_edges;
+    size_t next_edge = 0;
+    u8 alpha = color.alpha();
+    bool is_opaque = alpha == 255;
+    const size_t dst_skip = m_target->pitch() / sizeof(RGBA32);
 
-        VERIFY_NOT_REACHED();
-    };
+    for (int band_top = 0; band_top < rect.height(); band_top += fill_path_band_height) {
+        int band_height = min(fill_path_band_height, rect.height() - band_top);
+        int band_bottom = band_top + band_height;
 
-    auto increment_winding = [winding_rule](int& winding_number, const IntPoint& from, const IntPoint& to) {
-        if (winding_rule == WindingRule::EvenOdd) {
-            ++winding_number;
-            return;
+        active_edges.remove_all_matching([&](auto* edge) { return edge->to.y() <= band_top; });
+        for (; next_edge < edges.size() && edges[next_edge].from.y() < band_bottom; ++next_edge) {
+            if (edges[next_edge].to.y() > band_top)
+                active_edges.append(&edges[next_edge]);
         }
+        if (active_edges.is_empty())
+            continue;
 
-        if (winding_rule == WindingRule::Nonzero) {
-            if (from.dy_relative_to(to) < 0)
-                ++winding_number;
-            else
-                --winding_number;
-            return;
-        }
-
-        VERIFY_NOT_REACHED();
-    };
-
-    while (scanline >= last_y) {
-        Optional<IntPoint> previous_to;
-        if (active_list.size()) {
-            // sort the active list by 'x' from right to left
-            quick_sort(active_list, [](const auto& line0, const auto& line1) {
-                return line1.x < line0.x;
-            });
-#if FILL_PATH_DEBUG
-            if ((int)scanline % 10 == 0) {
-                draw_text(IntRect(active_list.last().x - 20, scanline, 20, 10), String::number((int)scanline));
-            }
-#endif
-
-            if (active_list.size() > 1) {
-                auto winding_number { winding_rule == WindingRule::Nonzero ? 1 : 0 };
-                for (size_t i = 1; i < active_list.size(); ++i) {
-                    auto& previous = active_list[i - 1];
-                    auto& current = active_list[i];
-
-                    IntPoint from, to;
-                    IntPoint truncated_from { previous.x, scanline };
-                    IntPoint truncated_to { current.x, scanline };
-                    approximately_place_on_int_grid({ previous.x, scanline }, { current.x, scanline }, from, to, previous_to);
-
-                    if (is_inside_shape(winding_number)) {
-                        // The points between this segment and the previous are
-                        // inside the shape
-
-                        dbgln_if(FILL_PATH_DEBUG, "y={}: {} at {}: {} -- {}", scanline, winding_number, i, from, to);
-                        draw_line(from, to, color, 1);
-                    }
-
-                    auto is_passing_through_maxima = scanline == previous.maximum_y
-                        || scanline == previous.minimum_y
-                        || scanline == current.maximum_y
-                        || scanline == current.minimum_y;
-
-                    auto is_passing_through_vertex = false;
+        __builtin_memset(area.data(), 0, area.size() * sizeof(float));
+        for (auto* edge : active_edges)
+            accumulate_edge(*edge, area, width, band_top, band_height);
 
-                    if (is_passing_through_maxima) {
-                        is_passing_through_vertex = previous.x == current.x;
-                    }
+        RGBA32* dst = m_target->scanline(rect.top() + band_top) + rect.left();
+        for (int y = 0; y < band_height; ++y, dst += dst_skip) {
+            float* row = area.data() + (size_t)y * (width + 2);
+            accumulate_row(row, width);
 
-                    if (!is_passing_through_vertex || previous.inverse_slope * current.inverse_slope < 0)
-                        increment_winding(winding_number, truncated_from, truncated_to);
+            for (int x = 0; x < width;) {
+                float coverage = coverage_for_winding(row[x], winding_rule);
 
-                    // update the x coord
-                    active_list[i - 1].x -= active_list[i - 1].inverse_slope;
+                // Fully covered runs, which is most of the inside of a large path, are filled in one go.
+                if (is_opaque && coverage >= 1.0f) {
+                    int run_start = x;
+                    while (x < width && coverage_for_winding(row[x], winding_rule) >= 1.0f)
+                        ++x;
+                    fast_u32_fill(dst + run_start, color.value(), x - run_start);
+                    continue;
                 }
-                active_list.last().x -= active_list.last().inverse_slope;
-            } else {
-                auto point = IntPoint(active_list[0].x, scanline);
-                draw_line(point, point, color);
 
-                // update the x coord
-                active_list.first().x -= active_list.first().inverse_slope;
+                u8 pixel_alpha = (u8)(alpha * coverage + 0.5f);
+                if (pixel_alpha == 255)
+                    dst[x] = color.value();
+                else if (pixel_alpha)
+                    dst[x] = Color::from_rgba(dst[x]).blend(color.with_alpha(pixel_alpha)).value();
+                ++x;
             }
         }
-
-        --scanline;
-        // remove any edge that goes out of bound from the active list
-        for (size_t i = 0, count = active_list.size(); i < count; ++i) {
-            if (scanline <= active_list[i].minimum_y) {
-                active_list.remove(i);
-                --count;
-                --i;
-            }
-        }
-        for (size_t j = last_active_segment; j < segments.size(); ++j, ++last_active_segment) {
-            auto& segment = segments[j];
-            if (segment.maximum_y < scanline)
-                break;
-            if (segment.minimum_y >= scanline)
-                continue;
-
-            active_list.append(segment);
-        }
     }
-
-#if FILL_PATH_DEBUG
-    size_t i { 0 };
-    for (auto& segment : segments) {
-        draw_line(Point<int>(segment.from), Point<int>(segment.to), Color::from_hsv(i++ * 360.0 / segments.size(), 1.0, 1.0), 1);
-    }
-#endif
 }
 
 void Painter::blit_disabled(const IntPoint& location, const Gfx::Bitmap& bitmap, const IntRect& rect, const Palette& palette)
@@ -136,6 +136,8 @@ protected:
     const State& state() const { return m_state_stack.last(); }
 
     void fill_physical_rect(const IntRect&, Color);
+    template<typename Filter>
+    void do_blit_filtered(const IntPoint&, const Gfx::Bitmap&, const IntRect& src_rect, const Filter&);
 
     IntRect m_clip_origin;
     NonnullRefPtr<Gfx::Bitmap> m_target;
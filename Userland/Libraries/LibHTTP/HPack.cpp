@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2021, The SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Array.h>
+#include <AK/StringBuilder.h>
+#include <LibHTTP/HPack.h>
+
+namespace HTTP::HPack {
+
+struct StaticTableEntry {
+    const char* name;
+    const char* value;
+};
+
+// RFC 7541 Appendix A
+static constexpr StaticTableEntry s_static_table[] = {
+    { ":authority", "" },
+    { ":method", "GET" },
+    { ":method", "POST" },
+    { ":path", "/" },
+    { ":path", "/index.html" },
+    { ":scheme", "http" },
+    { ":scheme", "https" },
+    { ":status", "200" },
+    { ":status", "204" },
+    { ":status", "206" },
+    { ":status", "304" },
+    { ":status", "400" },
+    { ":status", "404" },
+    { ":status", "500" },
+    { "accept-charset", "" },
+    { "accept-encoding", "gzip, deflate" },
+    { "accept-language", "" },
+    { "accept-ranges", "" },
+    { "accept", "" },
+    { "access-control-allow-origin", "" },
+    { "age", "" },
+    { "allow", "" },
+    { "authorization", "" },
+    { "cache-control", "" },
+    { "content-disposition", "" },
+    { "content-encoding", "" },
+    { "content-language", "" },
+    { "content-length", "" },
+    { "content-location", "" },
+    { "content-range", "" },
+    { "content-type", "" },
+    { "cookie", "" },
+    { "date", "" },
+    { "etag", "" },
+    { "expect", "" },
+    { "expires", "" },
+    { "from", "" },
+    { "host", "" },
+    { "if-match", "" },
+    { "if-modified-since", "" },
+    { "if-none-match", "" },
+    { "if-range", "" },
+    { "if-unmodified-since", "" },
+    { "last-modified", "" },
+    { "link", "" },
+    { "location", "" },
+    { "max-forwards", "" },
+    { "proxy-authenticate", "" },
+    { "proxy-authorization", "" },
+    { "range", "" },
+    { "referer", "" },
+    { "refresh", "" },
+    { "retry-after", "" },
+    { "server", "" },
+    { "set-cookie", "" },
+    { "strict-transport-security", "" },
+    { "transfer-encoding", "" },
+    { "user-agent", "" },
+    { "vary", "" },
+    { "via", "" },
+    { "www-authenticate", "" },
+};
+static constexpr size_t s_static_table_size = sizeof(s_static_table) / sizeof(s_static_table[0]);
+
+struct HuffmanCode {
+    u32 code;
+    u8 length;
+};
+
+// RFC 7541 Appendix B, with EOS as the last symbol.
+static constexpr HuffmanCode s_huffman_codes[] = {
+    { 0x1ff8, 13 }, { 0x7fffd8, 23 }, { 0xfffffe2, 28 }, { 0xfffffe3, 28 },
+    { 0xfffffe4, 28 }, { 0xfffffe5, 28 }, { 0xfffffe6, 28 }, { 0xfffffe7, 28 },
+    { 0xfffffe8, 28 }, { 0xffffea, 24 }, { 0x3ffffffc, 30 }, { 0xfffffe9, 28 },
+    { 0xfffffea, 28 }, { 0x3ffffffd, 30 }, { 0xfffffeb, 28 }, { 0xfffffec, 28 },
+    { 0xfffffed, 28 }, { 0xfffffee, 28 }, { 0xfffffef, 28 }, { 0xffffff0, 28 },
+    { 0xffffff1, 28 }, { 0xffffff2, 28 }, { 0x3ffffffe, 30 }, { 0xffffff3, 28 },
+    { 0xffffff4, 28 }, { 0xffffff5, 28 }, { 0xffffff6, 28 }, { 0xffffff7, 28 },
+    { 0xffffff8, 28 }, { 0xffffff9, 28 }, { 0xffffffa, 28 }, { 0xffffffb, 28 },
+    { 0x14, 6 }, { 0x3f8, 10 }, { 0x3f9, 10 }, { 0xffa, 12 },
+    { 0x1ff9, 13 }, { 0x15, 6 }, { 0xf8, 8 }, { 0x7fa, 11 },
+    { 0x3fa, 10 }, { 0x3fb, 10 }, { 0xf9, 8 }, { 0x7fb, 11 },
+    { 0xfa, 8 }, { 0x16, 6 }, { 0x17, 6 }, { 0x18, 6 },
+    { 0x0, 5 }, { 0x1, 5 }, { 0x2, 5 }, { 0x19, 6 },
+    { 0x1a, 6 }, { 0x1b, 6 }, { 0x1c, 6 }, { 0x1d, 6 },
+    { 0x1e, 6 }, { 0x1f, 6 }, { 0x5c, 7 }, { 0xfb, 8 },
+    { 0x7ffc, 15 }, { 0x20, 6 }, { 0xffb, 12 }, { 0x3fc, 10 },
+    { 0x1ffa, 13 }, { 0x21, 6 }, { 0x5d, 7 }, { 0x5e, 7 },
+    { 0x5f, 7 }, { 0x60, 7 }, { 0x61, 7 }, { 0x62, 7 },
+    { 0x63, 7 }, { 0x64, 7 }, { 0x65, 7 }, { 0x66, 7 },
+    { 0x67, 7 }, { 0x68, 7 }, { 0x69, 7 }, { 0x6a, 7 },
+    { 0x6b, 7 }, { 0x6c, 7 }, { 0x6d, 7 }, { 0x6e, 7 },
+    { 0x6f, 7 }, { 0x70, 7 }, { 0x71, 7 }, { 0x72, 7 },
+    { 0xfc, 8 }, { 0x73, 7 }, { 0xfd, 8 }, { 0x1ffb, 13 },
+    { 0x7fff0, 19 }, { 0x1ffc, 13 }, { 0x3ffc, 14 }, { 0x22, 6 },
+    { 0x7ffd, 15 }, { 0x3, 5 }, { 0x23, 6 }, { 0x4, 5 },
+    { 0x24, 6 }, { 0x5, 5 }, { 0x25, 6 }, { 0x26, 6 },
+    { 0x27, 6 }, { 0x6, 5 }, { 0x74, 7 }, { 0x75, 7 },
+    { 0x28, 6 }, { 0x29, 6 }, { 0x2a, 6 }, { 0x7, 5 },
+    { 0x2b, 6 }, { 0x76, 7 }, { 0x2c, 6 }, { 0x8, 5 },
+    { 0x9, 5 }, { 0x2d, 6 }, { 0x77, 7 }, { 0x78, 7 },
+    { 0x79, 7 }, { 0x7a, 7 }, { 0x7b, 7 }, { 0x7ffe, 15 },
+    { 0x7fc, 11 }, { 0x3ffd, 14 }, { 0x1ffd, 13 }, { 0xffffffc, 28 },
+    { 0xfffe6, 20 }, { 0x3fffd2, 22 }, { 0xfffe7, 20 }, { 0xfffe8, 20 },
+    { 0x3fffd3, 22 }, { 0x3fffd4, 22 }, { 0x3fffd5, 22 }, { 0x7fffd9, 23 },
+    { 0x3fffd6, 22 }, { 0x7fffda, 23 }, { 0x7fffdb, 23 }, { 0x7fffdc, 23 },
+    { 0x7fffdd, 23 }, { 0x7fffde, 23 }, { 0xffffeb, 24 }, { 0x7fffdf, 23 },
+    { 0xffffec, 24 }, { 0xffffed, 24 }, { 0x3fffd7, 22 }, { 0x7fffe0, 23 },
+    { 0xffffee, 24 }, { 0x7fffe1, 23 }, { 0x7fffe2, 23 }, { 0x7fffe3, 23 },
+    { 0x7fffe4, 23 }, { 0x1fffdc, 21 }, { 0x3fffd8, 22 }, { 0x7fffe5, 23 },
+    { 0x3fffd9, 22 }, { 0x7fffe6, 23 }, { 0x7fffe7, 23 }, { 0xffffef, 24 },
+    { 0x3fffda, 22 }, { 0x1fffdd, 21 }, { 0xfffe9, 20 }, { 0x3fffdb, 22 },
+    { 0x3fffdc, 22 }, { 0x7fffe8, 23 }, { 0x7fffe9, 23 }, { 0x1fffde, 21 },
+    { 0x7fffea, 23 }, { 0x3fffdd, 22 }, { 0x3fffde, 22 }, { 0xfffff0, 24 },
+    { 0x1fffdf, 21 }, { 0x3fffdf, 22 }, { 0x7fffeb, 23 }, { 0x7fffec, 23 },
+    { 0x1fffe0, 21 }, { 0x1fffe1, 21 }, { 0x3fffe0, 22 }, { 0x1fffe2, 21 },
+    { 0x7fffed, 23 }, { 0x3fffe1, 22 }, { 0x7fffee, 23 }, { 0x7fffef, 23 },
+    { 0xfffea, 20 }, { 0x3fffe2, 22 }, { 0x3fffe3, 22 }, { 0x3fffe4, 22 },
+    { 0x7ffff0, 23 }, { 0x3fffe5, 22 }, { 0x3fffe6, 22 }, { 0x7ffff1, 23 },
+    { 0x3ffffe0, 26 }, { 0x3ffffe1, 26 }, { 0xfffeb, 20 }, { 0x7fff1, 19 },
+    { 0x3fffe7, 22 }, { 0x7ffff2, 23 }, { 0x3fffe8, 22 }, { 0x1ffffec, 25 },
+    { 0x3ffffe2, 26 }, { 0x3ffffe3, 26 }, { 0x3ffffe4, 26 }, { 0x7ffffde, 27 },
+    { 0x7ffffdf, 27 }, { 0x3ffffe5, 26 }, { 0xfffff1, 24 }, { 0x1ffffed, 25 },
+    { 0x7fff2, 19 }, { 0x1fffe3, 21 }, { 0x3ffffe6, 26 }, { 0x7ffffe0, 27 },
+    { 0x7ffffe1, 27 }, { 0x3ffffe7, 26 }, { 0x7ffffe2, 27 }, { 0xfffff2, 24 },
+    { 0x1fffe4, 21 }, { 0x1fffe5, 21 }, { 0x3ffffe8, 26 }, { 0x3ffffe9, 26 },
+    { 0xffffffd, 28 }, { 0x7ffffe3, 27 }, { 0x7ffffe4, 27 }, { 0x7ffffe5, 27 },
+    { 0xfffec, 20 }, { 0xfffff3, 24 }, { 0xfffed, 20 }, { 0x1fffe6, 21 },
+    { 0x3fffe9, 22 }, { 0x1fffe7, 21 }, { 0x1fffe8, 21 }, { 0x7ffff3, 23 },
+    { 0x3fffea, 22 }, { 0x3fffeb, 22 }, { 0x1ffffee, 25 }, { 0x1ffffef, 25 },
+    { 0xfffff4, 24 }, { 0xfffff5, 24 }, { 0x3ffffea, 26 }, { 0x7ffff4, 23 },
+    { 0x3ffffeb, 26 }, { 0x7ffffe6, 27 }, { 0x3ffffec, 26 }, { 0x3ffffed, 26 },
+    { 0x7ffffe7, 27 }, { 0x7ffffe8, 27 }, { 0x7ffffe9, 27 }, { 0x7ffffea, 27 },
+    { 0x7ffffeb, 27 }, { 0xffffffe, 28 }, { 0x7ffffec, 27 }, { 0x7ffffed, 27 },
+    { 0x7ffffee, 27 }, { 0x7ffffef, 27 }, { 0x7fffff0, 27 }, { 0x3ffffee, 26 },
+    { 0x3fffffff, 30 },
+};
+static constexpr u16 s_huffman_eos = 256;
+
+// Every entry takes up the length of its name and value plus 32 bytes of overhead.
+static size_t entry_size(const Header& header)
+{
+    return header.name.length() + header.value.length() + 32;
+}
+
+static Optional<u64> decode_integer(ReadonlyBytes bytes, size_t& offset, u8 prefix_bits)
+{
+    if (offset >= bytes.size())
+        return {};
+    u8 prefix_mask = (1 << prefix_bits) - 1;
+    u64 value = bytes[offset++] & prefix_mask;
+    if (value < prefix_mask)
+        return value;
+
+    for (u8 shift = 0;; shift += 7) {
+        // Nothing legitimate comes anywhere near this, so don't bother going further.
+        if (offset >= bytes.size() || shift > 28)
+            return {};
+        u8 byte = bytes[offset++];
+        value += (u64)(byte & 0x7f) << shift;
+        if (!(byte & 0x80))
+            return value;
+    }
+}
+
+static void encode_integer(Vector<u8>& buffer, u64 value, u8 prefix_bits, u8 first_byte_flags)
+{
+    u8 prefix_mask = (1 << prefix_bits) - 1;
+    if (value < prefix_mask) {
+        buffer.append((u8)(first_byte_flags | value));
+        return;
+    }
+    buffer.append((u8)(first_byte_flags | prefix_mask));
+    value -= prefix_mask;
+    while (value >= 0x80) {
+        buffer.append((u8)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+    buffer.append((u8)value);
+}
+
+static Optional<String> decode_string(ReadonlyBytes bytes, size_t& offset)
+{
+    if (offset >= bytes.size())
+        return {};
+    bool is_huffman_encoded = bytes[offset] & 0x80;
+    auto length = decode_integer(bytes, offset, 7);
+    if (!length.has_value() || length.value() > bytes.size() - offset)
+        return {};
+    auto string_bytes = bytes.slice(offset, length.value());
+    offset += length.value();
+    if (is_huffman_encoded)
+        return decode_huffman(string_bytes);
+    return String { string_bytes };
+}
+
+static void encode_string(Vector<u8>& buffer, const StringView& string)
+{
+    encode_integer(buffer, string.length(), 7, 0);
+    buffer.append((const u8*)string.characters_without_null_termination(), string.length());
+}
+
+struct HuffmanTreeNode {
+    i16 children[2] { -1, -1 };
+    i16 symbol { -1 };
+};
+
+static const Vector<HuffmanTreeNode>& huffman_tree()
+{
+    static Vector<HuffmanTreeNode> tree;
+    if (!tree.is_empty())
+        return tree;
+
+    tree.append(HuffmanTreeNode {});
+    for (u16 symbol = 0; symbol <= s_huffman_eos; ++symbol) {
+        auto& code = s_huffman_codes[symbol];
+        size_t node = 0;
+        for (int bit_index = code.length - 1; bit_index >= 0; --bit_index) {
+            u8 bit = (code.code >> bit_index) & 1;
+            if (tree[node].children[bit] < 0) {
+                tree[node].children[bit] = tree.size();
+                tree.append(HuffmanTreeNode {});
+            }
+            node = tree[node].children[bit];
+        }
+        tree[node].symbol = symbol;
+    }
+    return tree;
+}
+
+Optional<String> decode_huffman(ReadonlyBytes bytes)
+{
+    auto& tree = huffman_tree();
+    StringBuilder builder(bytes.size() * 8 / 5);
+    size_t node = 0;
+    size_t bits_since_last_symbol = 0;
+    bool padding_is_all_ones = true;
+
+    for (auto byte : bytes) {
+        for (int bit_index = 7; bit_index >= 0; --bit_index) {
+            u8 bit = (byte >> bit_index) & 1;
+            auto next_node = tree[node].children[bit];
+            if (next_node < 0)
+                return {};
+            node = next_node;
+            ++bits_since_last_symbol;
+            padding_is_all_ones &= bit;
+            auto symbol = tree[node].symbol;
+            if (symbol < 0)
+                continue;
+            // EOS is only ever meant to pad the last byte, so finding it whole is an error.
+            if (symbol == s_huffman_eos)
+                return {};
+            builder.append((char)symbol);
+            node = 0;
+            bits_since_last_symbol = 0;
+            padding_is_all_ones = true;
+        }
+    }
+
+    // Padding has to be a prefix of EOS (all ones), and shorter than a byte.
+    if (bits_since_last_symbol > 7 || !padding_is_all_ones)
+        return {};
+    return builder.to_string();
+}
+
+Optional<Header> Decoder::header_at(size_t index) const
+{
+    if (index == 0)
+        return {};
+    if (index <= s_static_table_size) {
+        auto& entry = s_static_table[index - 1];
+        return Header { entry.name, entry.value };
+    }
+    index -= s_static_table_size + 1;
+    if (index >= m_dynamic_table.size())
+        return {};
+    return m_dynamic_table[index];
+}
+
+void Decoder::evict_until_size_fits(size_t size)
+{
+    while (!m_dynamic_table.is_empty() && m_dynamic_table_size > size)
+        m_dynamic_table_size -= entry_size(m_dynamic_table.take_last());
+}
+
+void Decoder::add_to_dynamic_table(Header header)
+{
+    auto size = entry_size(header);
+    // An entry that doesn't fit empties the table rather than being an error.
+    if (size > m_max_table_size) {
+        m_dynamic_table.clear();
+        m_dynamic_table_size = 0;
+        return;
+    }
+    evict_until_size_fits(m_max_table_size - size);
+    m_dynamic_table.prepend(move(header));
+    m_dynamic_table_size += size;
+}
+
+Optional<Vector<Header>> Decoder::decode(ReadonlyBytes bytes)
+{
+    Vector<Header> headers;
+    size_t offset = 0;
+    while (offset < bytes.size()) {
+        u8 first_byte = bytes[offset];
+
+        // Indexed header field
+        if (first_byte & 0x80) {
+            auto index = decode_integer(bytes, offset, 7);
+            if (!index.has_value())
+                return {};
+            auto header = header_at(index.value());
+            if (!header.has_value())
+                return {};
+            headers.append(header.release_value());
+            continue;
+        }
+
+        // Dynamic table size update
+        if ((first_byte & 0xe0) == 0x20) {
+            auto size = decode_integer(bytes, offset, 5);
+            if (!size.has_value() || size.value() > m_max_table_size_limit)
+                return {};
+            m_max_table_size = size.value();
+            evict_until_size_fits(m_max_table_size);
+            continue;
+        }
+
+        // Literal header field, with incremental indexing (01), without indexing (0000) or never indexed (0001)
+        bool should_index = (first_byte & 0xc0) == 0x40;
+        auto name_index = decode_integer(bytes, offset, should_index ? 6 : 4);
+        if (!name_index.has_value())
+            return {};
+
+        Header header;
+        if (name_index.value() != 0) {
+            auto indexed_header = header_at(name_index.value());
+            if (!indexed_header.has_value())
+                return {};
+            header.name = indexed_header->name;
+        } else {
+            auto name = decode_string(bytes, offset);
+            if (!name.has_value())
+                return {};
+            header.name = name.release_value();
+        }
+        auto value = decode_string(bytes, offset);
+        if (!value.has_value())
+            return {};
+        header.value = value.release_value();
+
+        if (should_index)
+            add_to_dynamic_table(header);
+        headers.append(move(header));
+    }
+    return headers;
+}
+
+ByteBuffer Encoder::encode(const Vector<Header>& headers) const
+{
+    Vector<u8> buffer;
+    for (auto& header : headers) {
+        Optional<size_t> name_index;
+        bool emitted_indexed_header = false;
+        for (size_t i = 0; i < s_static_table_size; ++i) {
+            auto& entry = s_static_table[i];
+            if (header.name != entry.name)
+                continue;
+            if (header.value == entry.value) {
+                encode_integer(buffer, i + 1, 7, 0x80);
+                emitted_indexed_header = true;
+                break;
+            }
+            if (!name_index.has_value())
+                name_index = i + 1;
+        }
+        if (emitted_indexed_header)
+            continue;
+
+        // Literal header field without indexing
+        if (name_index.has_value()) {
+            encode_integer(buffer, name_index.value(), 4, 0);
+        } else {
+            buffer.append((u8)0);
+            encode_string(buffer, header.name);
+        }
+        encode_string(buffer, header.value);
+    }
+    return ByteBuffer::copy(buffer.data(), buffer.size());
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, The SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+// HPACK header compression for HTTP/2, as described in RFC 7541.
+namespace HTTP::HPack {
+
+struct Header {
+    String name;
+    String value;
+};
+
+class Decoder {
+public:
+    // Header blocks must be decoded in the order they were received, as they update the shared
+    // dynamic table. Returns nothing if the block is malformed, which is a connection error.
+    Optional<Vector<Header>> decode(ReadonlyBytes);
+
+    // The upper bound we advertised in SETTINGS_HEADER_TABLE_SIZE.
+    void set_max_table_size_limit(size_t limit) { m_max_table_size_limit = limit; }
+
+private:
+    Optional<Header> header_at(size_t index) const;
+    void add_to_dynamic_table(Header);
+    void evict_until_size_fits(size_t);
+
+    // Most recently added entries first, as they're numbered that way.
+    Vector<Header> m_dynamic_table;
+    size_t m_dynamic_table_size { 0 };
+    size_t m_max_table_size { 4096 };
+    size_t m_max_table_size_limit { 4096 };
+};
+
+class Encoder {
+public:
+    // Doesn't use the dynamic table, so there's no state to keep in sync with the peer.
+    ByteBuffer encode(const Vector<Header>&) const;
+};
+
+Optional<String> decode_huffman(ReadonlyBytes);
+
+}
@@ -0,0 +1,581 @@
+/*
+ * Copyright (c) 2021, The SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <AK/Endian.h>
+#include <LibHTTP/Http2Connection.h>
+
+namespace HTTP {
+
+static constexpr StringView connection_preface = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n";
+static constexpr size_t frame_header_size = 9;
+static constexpr size_t max_frame_size = 16384;
+static constexpr i64 max_window_size = 0x7fffffff;
+
+// We consume data as soon as it arrives, so it's safe to let the server send plenty ahead.
+static constexpr u32 stream_receive_window_size = 1 * MiB;
+static constexpr u32 connection_receive_window_size = 16 * MiB;
+
+enum SettingsParameter : u16 {
+    HeaderTableSize = 0x1,
+    EnablePush = 0x2,
+    MaxConcurrentStreams = 0x3,
+    InitialWindowSize = 0x4,
+    MaxFrameSize = 0x5,
+    MaxHeaderListSize = 0x6,
+};
+
+enum FrameFlags : u8 {
+    Ack = 0x1,
+    EndStream = 0x1,
+    EndHeaders = 0x4,
+    Padded = 0x8,
+    PriorityFlag = 0x20,
+};
+
+static u32 read_u32(ReadonlyBytes bytes)
+{
+    return ((u32)bytes[0] << 24) | ((u32)bytes[1] << 16) | ((u32)bytes[2] << 8) | bytes[3];
+}
+
+static void append_u16(ByteBuffer& buffer, u16 value)
+{
+    u16 network_value = AK::convert_between_host_and_network_endian(value);
+    buffer.append(&network_value, sizeof(network_value));
+}
+
+static void append_u32(ByteBuffer& buffer, u32 value)
+{
+    u32 network_value = AK::convert_between_host_and_network_endian(value);
+    buffer.append(&network_value, sizeof(network_value));
+}
+
+// Strips the padding from a frame with the PADDED flag set.
+static Optional<ReadonlyBytes> remove_padding(u8 flags, ReadonlyBytes payload)
+{
+    if (!(flags & FrameFlags::Padded))
+        return payload;
+    if (payload.is_empty())
+        return {};
+    u8 padding_length = payload[0];
+    if (padding_length >= payload.size())
+        return {};
+    return payload.slice(1, payload.size() - 1 - padding_length);
+}
+
+void Http2Connection::Stream::cancel()
+{
+    on_headers_received = nullptr;
+    on_data_received = nullptr;
+    on_finish = nullptr;
+    if (!m_connection)
+        return;
+    auto connection = m_connection;
+    m_connection = nullptr;
+    if (connection->m_is_closed)
+        return;
+    connection->send_reset_stream(m_id, ErrorCode::Cancel);
+    connection->remove_stream(m_id);
+}
+
+Http2Connection::Http2Connection(NonnullRefPtr<TLS::TLSv12> socket)
+    : m_socket(move(socket))
+{
+    VERIFY(m_socket->alpn() == "h2");
+
+    m_socket->on_tls_ready_to_read = [this](auto&) {
+        on_ready_to_read();
+    };
+    m_socket->on_tls_ready_to_write = nullptr;
+    m_socket->on_tls_error = [this](auto) {
+        close();
+    };
+    m_socket->on_tls_finished = [this] {
+        close();
+    };
+
+    m_socket->write(connection_preface.bytes());
+
+    ByteBuffer settings;
+    append_u16(settings, SettingsParameter::EnablePush);
+    append_u32(settings, 0);
+    append_u16(settings, SettingsParameter::InitialWindowSize);
+    append_u32(settings, stream_receive_window_size);
+    send_frame(FrameType::Settings, 0, 0, settings);
+    send_window_update(0, connection_receive_window_size - 65535);
+
+    // The server's SETTINGS may have arrived along with the end of the handshake.
+    if (m_socket->can_read()) {
+        deferred_invoke([this](auto&) {
+            on_ready_to_read();
+        });
+    }
+}
+
+Http2Connection::~Http2Connection()
+{
+    close();
+}
+
+bool Http2Connection::can_open_stream() const
+{
+    return !m_is_closed && !m_received_goaway && m_streams.size() < m_peer_max_concurrent_streams && m_next_stream_id < max_window_size;
+}
+
+RefPtr<Http2Connection::Stream> Http2Connection::open_stream(const HttpRequest& request)
+{
+    if (!can_open_stream())
+        return {};
+
+    auto& url = request.url();
+    StringBuilder path_builder;
+    path_builder.append(url.path());
+    if (!url.query().is_empty()) {
+        path_builder.append('?');
+        path_builder.append(url.query());
+    }
+    String authority = url.port() == 443 ? url.host() : String::formatted("{}:{}", url.host(), url.port());
+
+    Vector<HPack::Header> headers;
+    headers.append({ ":method", request.method_name() });
+    headers.append({ ":scheme", "https" });
+    headers.append({ ":authority", authority });
+    headers.append({ ":path", path_builder.to_string() });
+    for (auto& header : request.headers()) {
+        auto name = header.name.to_lowercase();
+        // None of the HTTP/1.1 connection management headers are allowed here.
+        if (name == "connection" || name == "keep-alive" || name == "proxy-connection" || name == "transfer-encoding" || name == "upgrade" || name == "host")
+            continue;
+        headers.append({ move(name), header.value });
+    }
+    if (!request.body().is_empty())
+        headers.append({ "content-length", String::number(request.body().size()) });
+
+    auto stream_id = m_next_stream_id;
+    m_next_stream_id += 2;
+    auto stream = adopt_ref(*new Stream(*this, stream_id, m_peer_initial_window_size));
+    m_streams.set(stream_id, stream);
+
+    auto header_block = m_hpack_encoder.encode(headers);
+    bool has_body = !request.body().is_empty();
+    size_t offset = 0;
+    do {
+        auto fragment_size = min(header_block.size() - offset, m_peer_max_frame_size);
+        bool is_last_fragment = offset + fragment_size == header_block.size();
+        u8 flags = is_last_fragment ? FrameFlags::EndHeaders : 0;
+        if (offset == 0 && !has_body)
+            flags |= FrameFlags::EndStream;
+        send_frame(offset == 0 ? FrameType::Headers : FrameType::Continuation, flags, stream_id, header_block.bytes().slice(offset, fragment_size));
+        offset += fragment_size;
+    } while (offset < header_block.size());
+
+    if (has_body) {
+        stream->m_pending_body = request.body();
+        stream->m_has_pending_body = true;
+        flush_pending_bodies();
+    }
+
+    return stream;
+}
+
+void Http2Connection::on_ready_to_read()
+{
+    NonnullRefPtr protector(*this);
+
+    for (;;) {
+        auto data = m_socket->read();
+        if (!data.has_value() || data->is_empty())
+            break;
+        m_receive_buffer.append(data->data(), data->size());
+    }
+
+    size_t offset = 0;
+    while (!m_is_closed && m_receive_buffer.size() - offset >= frame_header_size) {
+        auto header = m_receive_buffer.bytes().slice(offset, frame_header_size);
+        size_t length = ((size_t)header[0] << 16) | ((size_t)header[1] << 8) | header[2];
+        auto type = (FrameType)header[3];
+        u8 flags = header[4];
+        u32 stream_id = read_u32(header.slice(5)) & 0x7fffffff;
+
+        if (length > max_frame_size) {
+            connection_error(ErrorCode::FrameSizeError);
+            return;
+        }
+        if (m_receive_buffer.size() - offset < frame_header_size + length)
+            break;
+
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Received frame type {} with flags {:#x} on stream {}, {} bytes", (u8)type, flags, stream_id, length);
+        handle_frame(type, flags, stream_id, m_receive_buffer.bytes().slice(offset + frame_header_size, length));
+        offset += frame_header_size + length;
+    }
+
+    if (m_is_closed) {
+        m_receive_buffer.clear();
+        return;
+    }
+    if (offset != 0)
+        m_receive_buffer = m_receive_buffer.slice(offset, m_receive_buffer.size() - offset);
+}
+
+void Http2Connection::handle_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    // Nothing may come between the frames making up a header block.
+    if (m_header_block_stream_id != 0 && (type != FrameType::Continuation || stream_id != m_header_block_stream_id))
+        return connection_error(ErrorCode::ProtocolError);
+
+    switch (type) {
+    case FrameType::Data:
+        return handle_data_frame(flags, stream_id, payload);
+    case FrameType::Headers: {
+        if (stream_id == 0)
+            return connection_error(ErrorCode::ProtocolError);
+        auto block = remove_padding(flags, payload);
+        if (!block.has_value())
+            return connection_error(ErrorCode::ProtocolError);
+        if (flags & FrameFlags::PriorityFlag) {
+            if (block->size() < 5)
+                return connection_error(ErrorCode::ProtocolError);
+            block = block->slice(5);
+        }
+        if (flags & FrameFlags::EndHeaders)
+            return handle_header_block(stream_id, *block, flags & FrameFlags::EndStream);
+        m_header_block = ByteBuffer::copy(*block);
+        m_header_block_stream_id = stream_id;
+        m_header_block_ends_stream = flags & FrameFlags::EndStream;
+        return;
+    }
+    case FrameType::Continuation: {
+        if (m_header_block_stream_id == 0)
+            return connection_error(ErrorCode::ProtocolError);
+        m_header_block.append(payload.data(), payload.size());
+        if (!(flags & FrameFlags::EndHeaders))
+            return;
+        auto block = move(m_header_block);
+        m_header_block_stream_id = 0;
+        return handle_header_block(stream_id, block, m_header_block_ends_stream);
+    }
+    case FrameType::RstStream: {
+        if (stream_id == 0 || payload.size() != 4)
+            return connection_error(ErrorCode::ProtocolError);
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Stream {} was reset with error {}", stream_id, read_u32(payload));
+        if (auto stream = m_streams.get(stream_id); stream.has_value())
+            finish_stream(*stream.value(), false);
+        return;
+    }
+    case FrameType::Settings:
+        return handle_settings_frame(flags, stream_id, payload);
+    case FrameType::PushPromise:
+        // We told the server not to push anything.
+        return connection_error(ErrorCode::ProtocolError);
+    case FrameType::Ping:
+        if (stream_id != 0 || payload.size() != 8)
+            return connection_error(ErrorCode::ProtocolError);
+        if (!(flags & FrameFlags::Ack))
+            send_frame(FrameType::Ping, FrameFlags::Ack, 0, payload);
+        return;
+    case FrameType::GoAway: {
+        if (stream_id != 0 || payload.size() < 8)
+            return connection_error(ErrorCode::ProtocolError);
+        auto last_stream_id = read_u32(payload) & 0x7fffffff;
+        dbgln_if(HTTP2_DEBUG, "Http2Connection: Server is going away with error {}, last stream was {}", read_u32(payload.slice(4)), last_stream_id);
+        m_received_goaway = true;
+        // The server never saw these streams, so they failed without any harm done.
+        Vector<NonnullRefPtr<Stream>> unprocessed_streams;
+        for (auto& it : m_streams) {
+            if (it.key > last_stream_id)
+                unprocessed_streams.append(it.value);
+        }
+        for (auto& stream : unprocessed_streams)
+            finish_stream(stream, false);
+        if (m_streams.is_empty())
+            close();
+        return;
+    }
+    case FrameType::WindowUpdate:
+        return handle_window_update_frame(stream_id, payload);
+    case FrameType::Priority:
+    default:
+        // We don't do prioritization, and unknown frame types have to be ignored.
+        return;
+    }
+}
+
+void Http2Connection::handle_data_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id == 0)
+        return connection_error(ErrorCode::ProtocolError);
+
+    // Padding counts towards flow control too.
+    m_unacknowledged_received_size += payload.size();
+    if (m_unacknowledged_received_size >= connection_receive_window_size / 2) {
+        send_window_update(0, m_unacknowledged_received_size);
+        m_unacknowledged_received_size = 0;
+    }
+
+    auto data = remove_padding(flags, payload);
+    if (!data.has_value())
+        return connection_error(ErrorCode::ProtocolError);
+
+    auto maybe_stream = m_streams.get(stream_id);
+    if (!maybe_stream.has_value())
+        return;
+    NonnullRefPtr<Stream> stream = *maybe_stream.value();
+    if (!stream->m_has_received_headers) {
+        send_reset_stream(stream_id, ErrorCode::ProtocolError);
+        return finish_stream(stream, false);
+    }
+
+    if (!data->is_empty() && stream->on_data_received)
+        stream->on_data_received(*data);
+
+    if (flags & FrameFlags::EndStream)
+        return finish_stream(stream, true);
+
+    stream->m_unacknowledged_received_size += payload.size();
+    if (stream->m_unacknowledged_received_size >= stream_receive_window_size / 2) {
+        send_window_update(stream_id, stream->m_unacknowledged_received_size);
+        stream->m_unacknowledged_received_size = 0;
+    }
+}
+
+void Http2Connection::handle_header_block(u32 stream_id, ReadonlyBytes block, bool ends_stream)
+{
+    // The block has to be decoded even if nobody's interested, to keep the HPACK state in sync.
+    auto headers = m_hpack_decoder.decode(block);
+    if (!headers.has_value())
+        return connection_error(ErrorCode::CompressionError);
+
+    auto maybe_stream = m_streams.get(stream_id);
+    if (!maybe_stream.has_value())
+        return;
+    NonnullRefPtr<Stream> stream = *maybe_stream.value();
+
+    // Header blocks after the response headers are trailers, which we don't have a use for.
+    if (!stream->m_has_received_headers) {
+        Optional<u32> status_code;
+        HashMap<String, String, CaseInsensitiveStringTraits> response_headers;
+        for (auto& header : headers.value()) {
+            if (header.name == ":status") {
+                status_code = header.value.to_uint();
+                continue;
+            }
+            if (header.name.starts_with(':'))
+                continue;
+            if (auto existing_value = response_headers.get(header.name); existing_value.has_value())
+                response_headers.set(header.name, String::formatted("{}, {}", existing_value.value(), header.value));
+            else
+                response_headers.set(header.name, header.value);
+        }
+        if (!status_code.has_value()) {
+            send_reset_stream(stream_id, ErrorCode::ProtocolError);
+            return finish_stream(stream, false);
+        }
+        // Informational responses are followed by the real thing.
+        if (status_code.value() >= 100 && status_code.value() < 200)
+            return;
+
+        stream->m_has_received_headers = true;
+        if (stream->on_headers_received)
+            stream->on_headers_received(status_code.value(), response_headers);
+    }
+
+    if (ends_stream)
+        finish_stream(stream, true);
+}
+
+void Http2Connection::handle_settings_frame(u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    if (stream_id != 0)
+        return connection_error(ErrorCode::ProtocolError);
+    if (flags & FrameFlags::Ack) {
+        if (!payload.is_empty())
+            return connection_error(ErrorCode::FrameSizeError);
+        return;
+    }
+    if (payload.size() % 6 != 0)
+        return connection_error(ErrorCode::FrameSizeError);
+
+    for (size_t offset = 0; offset < payload.size(); offset += 6) {
+        u16 parameter = ((u16)payload[offset] << 8) | payload[offset + 1];
+        u32 value = read_u32(payload.slice(offset + 2));
+        switch (parameter) {
+        case SettingsParameter::MaxConcurrentStreams:
+            m_peer_max_concurrent_streams = value;
+            break;
+        case SettingsParameter::InitialWindowSize: {
+            if (value > max_window_size)
+                return connection_error(ErrorCode::FlowControlError);
+            // This applies retroactively to the windows of all open streams.
+            auto delta = (i64)value - m_peer_initial_window_size;
+            m_peer_initial_window_size = value;
+            for (auto& it : m_streams)
+                it.value->m_send_window += delta;
+            break;
+        }
+        case SettingsParameter::MaxFrameSize:
+            if (value < 16384 || value > 16777215)
+                return connection_error(ErrorCode::ProtocolError);
+            m_peer_max_frame_size = value;
+            break;
+        case SettingsParameter::EnablePush:
+            if (value > 1)
+                return connection_error(ErrorCode::ProtocolError);
+            break;
+        case SettingsParameter::HeaderTableSize:
+            // Our encoder never uses the dynamic table, so any size will do.
+        case SettingsParameter::MaxHeaderListSize:
+        default:
+            break;
+        }
+    }
+
+    send_frame(FrameType::Settings, FrameFlags::Ack, 0, {});
+    flush_pending_bodies();
+}
+
+void Http2Connection::handle_window_update_frame(u32 stream_id, ReadonlyBytes payload)
+{
+    if (payload.size() != 4)
+        return connection_error(ErrorCode::FrameSizeError);
+    auto increment = read_u32(payload) & 0x7fffffff;
+
+    if (stream_id == 0) {
+        if (increment == 0)
+            return connection_error(ErrorCode::ProtocolError);
+        m_send_window += increment;
+        if (m_send_window > max_window_size)
+            return connection_error(ErrorCode::FlowControlError);
+    } else {
+        auto maybe_stream = m_streams.get(stream_id);
+        if (!maybe_stream.has_value())
+            return;
+        NonnullRefPtr<Stream> stream = *maybe_stream.value();
+        stream->m_send_window += increment;
+        if (increment == 0 || stream->m_send_window > max_window_size) {
+            send_reset_stream(stream_id, increment == 0 ? ErrorCode::ProtocolError : ErrorCode::FlowControlError);
+            return finish_stream(stream, false);
+        }
+    }
+
+    flush_pending_bodies();
+}
+
+void Http2Connection::flush_pending_bodies()
+{
+    for (auto& it : m_streams) {
+        auto& stream = *it.value;
+        while (stream.m_has_pending_body && m_send_window > 0 && stream.m_send_window > 0) {
+            auto remaining = stream.m_pending_body.size() - stream.m_pending_body_offset;
+            auto chunk_size = min(min(remaining, m_peer_max_frame_size), (size_t)min(m_send_window, stream.m_send_window));
+            bool is_last_chunk = chunk_size == remaining;
+            send_frame(FrameType::Data, is_last_chunk ? FrameFlags::EndStream : 0, stream.m_id, stream.m_pending_body.bytes().slice(stream.m_pending_body_offset, chunk_size));
+            stream.m_pending_body_offset += chunk_size;
+            m_send_window -= chunk_size;
+            stream.m_send_window -= chunk_size;
+            if (is_last_chunk) {
+                stream.m_pending_body.clear();
+                stream.m_has_pending_body = false;
+            }
+        }
+    }
+}
+
+void Http2Connection::send_frame(FrameType type, u8 flags, u32 stream_id, ReadonlyBytes payload)
+{
+    u8 header[frame_header_size] {
+        (u8)(payload.size() >> 16),
+        (u8)(payload.size() >> 8),
+        (u8)payload.size(),
+        (u8)type,
+        flags,
+        (u8)(stream_id >> 24),
+        (u8)(stream_id >> 16),
+        (u8)(stream_id >> 8),
+        (u8)stream_id,
+    };
+    auto frame = ByteBuffer::create_uninitialized(frame_header_size + payload.size());
+    memcpy(frame.data(), header, frame_header_size);
+    if (!payload.is_empty())
+        memcpy(frame.offset_pointer(frame_header_size), payload.data(), payload.size());
+    m_socket->write(frame);
+}
+
+void Http2Connection::send_window_update(u32 stream_id, u32 increment)
+{
+    ByteBuffer payload;
+    append_u32(payload, increment);
+    send_frame(FrameType::WindowUpdate, 0, stream_id, payload);
+}
+
+void Http2Connection::send_reset_stream(u32 stream_id, ErrorCode error_code)
+{
+    ByteBuffer payload;
+    append_u32(payload, (u32)error_code);
+    send_frame(FrameType::RstStream, 0, stream_id, payload);
+}
+
+void Http2Connection::finish_stream(Stream& stream, bool success)
+{
+    NonnullRefPtr protector(stream);
+    stream.m_connection = nullptr;
+    remove_stream(stream.m_id);
+    auto on_finish = move(stream.on_finish);
+    stream.on_headers_received = nullptr;
+    stream.on_data_received = nullptr;
+    if (on_finish)
+        on_finish(success);
+}
+
+void Http2Connection::remove_stream(u32 stream_id)
+{
+    m_streams.remove(stream_id);
+    if (!m_streams.is_empty() || m_is_closed)
+        return;
+    if (m_received_goaway) {
+        close();
+        return;
+    }
+    if (on_idle)
+        on_idle();
+}
+
+void Http2Connection::connection_error(ErrorCode error_code)
+{
+    dbgln("Http2Connection: Connection error {}", (u32)error_code);
+    if (m_is_closed)
+        return;
+    ByteBuffer payload;
+    // We never accept streams from the server, so there's no last stream to speak of.
+    append_u32(payload, 0);
+    append_u32(payload, (u32)error_code);
+    send_frame(FrameType::GoAway, 0, 0, payload);
+    close();
+}
+
+void Http2Connection::close()
+{
+    if (m_is_closed)
+        return;
+    m_is_closed = true;
+
+    m_socket->on_tls_ready_to_read = nullptr;
+    m_socket->on_tls_error = nullptr;
+    m_socket->on_tls_finished = nullptr;
+    m_socket->close();
+
+    auto streams = move(m_streams);
+    for (auto& it : streams)
+        finish_stream(it.value, false);
+
+    if (on_closed) {
+        deferred_invoke([this](auto&) {
+            if (on_closed)
+                on_closed();
+        });
+    }
+}
+
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2021, The SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/RefCounted.h>
+#include <AK/WeakPtr.h>
+#include <LibCore/Object.h>
+#include <LibHTTP/HPack.h>
+#include <LibHTTP/HttpRequest.h>
+#include <LibTLS/TLSv12.h>
+
+namespace HTTP {
+
+// An HTTP/2 (RFC 7540) connection over TLS, carrying any number of concurrent requests as streams.
+class Http2Connection final : public Core::Object {
+    C_OBJECT(Http2Connection)
+public:
+    class Stream : public RefCounted<Stream> {
+    public:
+        u32 id() const { return m_id; }
+
+        // Sends RST_STREAM, after which none of the callbacks are called anymore.
+        void cancel();
+
+        Function<void(u32 status_code, const HashMap<String, String, CaseInsensitiveStringTraits>& headers)> on_headers_received;
+        Function<void(ReadonlyBytes)> on_data_received;
+        Function<void(bool success)> on_finish;
+
+    private:
+        friend class Http2Connection;
+
+        Stream(Http2Connection& connection, u32 id, i64 send_window)
+            : m_connection(connection)
+            , m_id(id)
+            , m_send_window(send_window)
+        {
+        }
+
+        WeakPtr<Http2Connection> m_connection;
+        u32 m_id { 0 };
+        bool m_has_received_headers { false };
+        i64 m_send_window { 0 };
+        size_t m_unacknowledged_received_size { 0 };
+        ByteBuffer m_pending_body;
+        size_t m_pending_body_offset { 0 };
+        bool m_has_pending_body { false };
+    };
+
+    virtual ~Http2Connection() override;
+
+    // Whether another request can be sent over this connection right now.
+    bool can_open_stream() const;
+    RefPtr<Stream> open_stream(const HttpRequest&);
+
+    size_t stream_count() const { return m_streams.size(); }
+    bool is_closed() const { return m_is_closed; }
+
+    // Called whenever the last open stream has finished.
+    Function<void()> on_idle;
+    Function<void()> on_closed;
+
+private:
+    // The socket must have negotiated "h2" through ALPN.
+    explicit Http2Connection(NonnullRefPtr<TLS::TLSv12>);
+
+    enum class FrameType : u8 {
+        Data = 0x0,
+        Headers = 0x1,
+        Priority = 0x2,
+        RstStream = 0x3,
+        Settings = 0x4,
+        PushPromise = 0x5,
+        Ping = 0x6,
+        GoAway = 0x7,
+        WindowUpdate = 0x8,
+        Continuation = 0x9,
+    };
+
+    enum class ErrorCode : u32 {
+        NoError = 0x0,
+        ProtocolError = 0x1,
+        InternalError = 0x2,
+        FlowControlError = 0x3,
+        SettingsTimeout = 0x4,
+        StreamClosed = 0x5,
+        FrameSizeError = 0x6,
+        RefusedStream = 0x7,
+        Cancel = 0x8,
+        CompressionError = 0x9,
+    };
+
+    void on_ready_to_read();
+    void handle_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_data_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_header_block(u32 stream_id, ReadonlyBytes, bool ends_stream);
+    void handle_settings_frame(u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void handle_window_update_frame(u32 stream_id, ReadonlyBytes payload);
+
+    void send_frame(FrameType, u8 flags, u32 stream_id, ReadonlyBytes payload);
+    void send_window_update(u32 stream_id, u32 increment);
+    void send_reset_stream(u32 stream_id, ErrorCode);
+    void flush_pending_bodies();
+
+    void finish_stream(Stream&, bool success);
+    void remove_stream(u32 stream_id);
+    void connection_error(ErrorCode);
+    void close();
+
+    NonnullRefPtr<TLS::TLSv12> m_socket;
+    HashMap<u32, NonnullRefPtr<Stream>> m_streams;
+    u32 m_next_stream_id { 1 };
+    bool m_is_closed { false };
+    bool m_received_goaway { false };
+
+    ByteBuffer m_receive_buffer;
+
+    // A header block may be split over a HEADERS frame and any number of CONTINUATION frames.
+    ByteBuffer m_header_block;
+    u32 m_header_block_stream_id { 0 };
+    bool m_header_block_ends_stream { false };
+
+    HPack::Decoder m_hpack_decoder;
+    HPack::Encoder m_hpack_encoder;
+
+    // What the peer told us in its SETTINGS.
+    size_t m_peer_max_concurrent_streams { 100 };
+    size_t m_peer_max_frame_size { 16384 };
+    i64 m_peer_initial_window_size { 65535 };
+
+    i64 m_send_window { 65535 };
+    size_t m_unacknowledged_received_size { 0 };
+};
+
+}
@@ -13,15 +13,27 @@
 
 namespace HTTP {
 void HttpJob::start()
+{
+    start(Core::TCPSocket::construct(this));
+}
+
+void HttpJob::start(NonnullRefPtr<Core::Socket> socket)
 {
     VERIFY(!m_socket);
-    m_socket = Core::TCPSocket::construct(this);
+    m_socket = move(socket);
     m_socket->on_connected = [this] {
 #if CHTTPJOB_DEBUG
         dbgln("HttpJob: on_connected callback");
 #endif
         on_socket_connected();
     };
+    if (m_socket->is_connected()) {
+        deferred_invoke([this](auto&) {
+            if (m_socket)
+                on_socket_connected();
+        });
+        return;
+    }
     bool success = m_socket->connect(m_request.url().host(), m_request.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
@@ -36,7 +48,9 @@ void HttpJob::shutdown()
         return;
     m_socket->on_ready_to_read = nullptr;
     m_socket->on_connected = nullptr;
-    remove_child(*m_socket);
+    // A pooled socket outlives the job, so only reap the ones we created.
+    if (m_socket->parent() == this)
+        remove_child(*m_socket);
     m_socket = nullptr;
 }
 
@@ -30,6 +30,11 @@ public:
     virtual void start() override;
     virtual void shutdown() override;
 
+    // Runs the job on a socket that may already be connected, to reuse a persistent connection.
+    void start(NonnullRefPtr<Core::Socket>);
+
+    Core::Socket* socket() { return m_socket.ptr(); }
+
 protected:
     virtual bool should_fail_on_empty_payload() const override { return false; }
     virtual void register_on_ready_to_read(Function<void()>) override;
@@ -51,12 +51,13 @@ ByteBuffer HttpRequest::to_raw_request() const
         builder.append(header.value);
         builder.append("\r\n");
     }
-    builder.append("Connection: close\r\n");
-    if (!m_body.is_empty()) {
-        builder.appendff("Content-Length: {}\r\n\r\n", m_body.size());
-        builder.append((const char*)m_body.data(), m_body.size());
-    }
+    builder.append("Connection: keep-alive\r\n");
+    if (!m_body.is_empty())
+        builder.appendff("Content-Length: {}\r\n", m_body.size());
     builder.append("\r\n");
+    // Nothing may follow the body, as the server will read it as the start of another request.
+    if (!m_body.is_empty())
+        builder.append((const char*)m_body.data(), m_body.size());
     return builder.to_byte_buffer();
 }
 
@@ -161,6 +162,7 @@ Optional<HttpRequest> HttpRequest::from_raw_request(ReadonlyBytes raw_request)
         return {};
 
     request.m_resource = resource;
+    request.m_protocol = protocol;
     request.m_headers = move(headers);
 
     return request;
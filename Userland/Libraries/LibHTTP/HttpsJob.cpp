@@ -15,15 +15,44 @@
 namespace HTTP {
 
 void HttpsJob::start()
+{
+    start(TLS::TLSv12::construct(this));
+}
+
+void HttpsJob::start(NonnullRefPtr<TLS::TLSv12> socket)
 {
     VERIFY(!m_socket);
-    m_socket = TLS::TLSv12::construct(this);
-    m_socket->set_root_certificates(m_override_ca_certificates ? *m_override_ca_certificates : DefaultRootCACertificates::the().certificates());
+    m_socket = move(socket);
+    bool is_reused = m_socket->is_established();
+    if (!is_reused) {
+        m_socket->set_root_certificates(m_override_ca_certificates ? *m_override_ca_certificates : DefaultRootCACertificates::the().certificates());
+        if (on_http2_connection_established) {
+            m_socket->add_alpn("h2");
+            m_socket->add_alpn("http/1.1");
+        }
+    }
     m_socket->on_tls_connected = [this] {
 #if HTTPSJOB_DEBUG
         dbgln("HttpsJob: on_connected callback");
 #endif
-        on_socket_connected();
+        if (!m_socket->has_alpn("h2")) {
+            on_socket_connected();
+            return;
+        }
+        // This only means the TCP connection is up, we won't know what protocol was
+        // negotiated until the handshake is done and the socket becomes writable.
+        m_socket->on_tls_ready_to_write = [this](auto&) {
+            // Don't pull the callbacks out from under the socket while it's still calling them.
+            deferred_invoke([this](auto&) {
+                if (!m_socket || !m_socket->on_tls_ready_to_write)
+                    return;
+                m_socket->on_tls_ready_to_write = nullptr;
+                if (m_socket->alpn() == "h2")
+                    switch_to_http2();
+                else
+                    on_socket_connected();
+            });
+        };
     };
     m_socket->on_tls_error = [&](TLS::AlertDescription error) {
         if (error == TLS::AlertDescription::HandshakeFailure) {
@@ -47,6 +76,13 @@ void HttpsJob::start()
         if (on_certificate_requested)
             on_certificate_requested(*this);
     };
+    if (is_reused) {
+        deferred_invoke([this](auto&) {
+            if (m_socket)
+                on_socket_connected();
+        });
+        return;
+    }
     bool success = ((TLS::TLSv12&)*m_socket).connect(m_request.url().host(), m_request.url().port());
     if (!success) {
         deferred_invoke([this](auto&) {
@@ -55,18 +91,91 @@ void HttpsJob::start()
     }
 }
 
+void HttpsJob::start(NonnullRefPtr<Http2Connection> connection)
+{
+    VERIFY(!m_socket && !m_http2_stream);
+    m_http2_stream = connection->open_stream(m_request);
+    if (!m_http2_stream) {
+        deferred_invoke([this](auto&) {
+            did_fail(Core::NetworkJob::Error::ConnectionFailed);
+        });
+        return;
+    }
+
+    m_http2_stream->on_headers_received = [this](u32 status_code, auto& headers) {
+        m_code = status_code;
+        m_headers = headers;
+        m_state = State::InBody;
+        auto content_length_header = m_headers.get("Content-Length");
+        if (content_length_header.has_value())
+            m_content_length = content_length_header.value().to_uint();
+        // Same as with HTTP/1.1, we can't decode any content-encoding as a stream.
+        if (m_headers.contains("Content-Encoding"))
+            m_can_stream_response = false;
+        if (on_headers_received)
+            on_headers_received(m_headers, status_code);
+    };
+    m_http2_stream->on_data_received = [this](ReadonlyBytes data) {
+        m_received_buffers.append(ByteBuffer::copy(data));
+        m_buffered_size += data.size();
+        m_received_size += data.size();
+        flush_received_buffers();
+        auto content_length = m_content_length;
+        deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
+    };
+    m_http2_stream->on_finish = [this](bool success) {
+        m_http2_stream = nullptr;
+        if (!success || m_state != State::InBody) {
+            deferred_invoke([this](auto&) {
+                did_fail(Core::NetworkJob::Error::TransmissionFailed);
+            });
+            return;
+        }
+        finish_up();
+    };
+}
+
+void HttpsJob::switch_to_http2()
+{
+    dbgln_if(HTTPSJOB_DEBUG, "HttpsJob: Server speaks HTTP/2, switching over");
+    auto socket = m_socket.release_nonnull();
+    socket->on_tls_connected = nullptr;
+    socket->on_tls_certificate_request = nullptr;
+    // The connection takes over the socket's other callbacks, and may well outlive us.
+    if (socket->parent() == this)
+        remove_child(*socket);
+    auto connection = Http2Connection::construct(move(socket));
+    start(connection);
+    on_http2_connection_established(move(connection));
+}
+
 void HttpsJob::shutdown()
 {
+    if (m_http2_stream) {
+        m_http2_stream->cancel();
+        m_http2_stream = nullptr;
+    }
     if (!m_socket)
         return;
     m_socket->on_tls_ready_to_read = nullptr;
+    m_socket->on_tls_ready_to_write = nullptr;
     m_socket->on_tls_connected = nullptr;
-    remove_child(*m_socket);
+    m_socket->on_tls_error = nullptr;
+    m_socket->on_tls_finished = nullptr;
+    m_socket->on_tls_certificate_request = nullptr;
+    // A pooled socket outlives the job, so only reap the ones we created.
+    if (m_socket->parent() == this)
+        remove_child(*m_socket);
     m_socket = nullptr;
 }
 
 void HttpsJob::set_certificate(String certificate, String private_key)
 {
+    // Client certificates are part of the handshake, which an HTTP/2 stream has long since missed.
+    if (!m_socket) {
+        dbgln("LibHTTP: Can't set a client certificate without a socket of our own");
+        return;
+    }
     if (!m_socket->add_client_key(certificate.bytes(), private_key.bytes())) {
         dbgln("LibHTTP: Failed to set a client certificate");
         // FIXME: Do something about this failure
@@ -74,14 +183,6 @@ void HttpsJob::set_certificate(String certificate, String private_key)
     }
 }
 
-void HttpsJob::read_while_data_available(Function<IterationDecision()> read)
-{
-    while (m_socket->can_read()) {
-        if (read() == IterationDecision::Break)
-            break;
-    }
-}
-
 void HttpsJob::register_on_ready_to_read(Function<void()> callback)
 {
     m_socket->on_tls_ready_to_read = [callback = move(callback)](auto&) {
@@ -91,6 +192,11 @@ void HttpsJob::register_on_ready_to_read(Function<void()> callback)
 
 void HttpsJob::register_on_ready_to_write(Function<void()> callback)
 {
+    // An established connection won't tell us it's ready again until we write to it.
+    if (m_socket->is_established()) {
+        callback();
+        return;
+    }
     m_socket->on_tls_ready_to_write = [callback = move(callback)](auto&) {
         callback();
     };
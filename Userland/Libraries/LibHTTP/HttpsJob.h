@@ -8,6 +8,7 @@
 
 #include <AK/HashMap.h>
 #include <LibCore/NetworkJob.h>
+#include <LibHTTP/Http2Connection.h>
 #include <LibHTTP/HttpRequest.h>
 #include <LibHTTP/HttpResponse.h>
 #include <LibHTTP/Job.h>
@@ -30,10 +31,21 @@ public:
 
     virtual void start() override;
     virtual void shutdown() override;
+
+    // Runs the job on a socket that may already be established, to reuse a persistent connection.
+    void start(NonnullRefPtr<TLS::TLSv12>);
+    // Runs the job as a stream on an HTTP/2 connection, alongside whatever else it carries.
+    void start(NonnullRefPtr<Http2Connection>);
+
+    TLS::TLSv12* socket() { return m_socket.ptr(); }
     void set_certificate(String certificate, String key);
 
     Function<void(HttpsJob&)> on_certificate_requested;
 
+    // HTTP/2 is only offered to the server if someone is around to share the resulting
+    // connection with other jobs, as it's wasted on a single request otherwise.
+    Function<void(NonnullRefPtr<Http2Connection>)> on_http2_connection_established;
+
 protected:
     virtual void register_on_ready_to_read(Function<void()>) override;
     virtual void register_on_ready_to_write(Function<void()>) override;
@@ -45,10 +57,12 @@ protected:
     virtual bool write(ReadonlyBytes) override;
     virtual bool is_established() const override { return m_socket->is_established(); }
     virtual bool should_fail_on_empty_payload() const override { return false; }
-    virtual void read_while_data_available(Function<IterationDecision()>) override;
 
 private:
+    void switch_to_http2();
+
     RefPtr<TLS::TLSv12> m_socket;
+    RefPtr<Http2Connection::Stream> m_http2_stream;
     const Vector<Certificate>* m_override_ca_certificates { nullptr };
 };
 
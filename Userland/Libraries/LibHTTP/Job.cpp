@@ -80,6 +80,14 @@ Job::~Job()
 {
 }
 
+bool Job::can_reuse_connection() const
+{
+    if (has_error() || m_state != State::Finished || !m_server_keeps_connection_alive)
+        return false;
+    // Anything left to read now is either unexpected data or the server hanging up.
+    return !eof() && !can_read();
+}
+
 void Job::flush_received_buffers()
 {
     if (!m_can_stream_response || m_buffered_size == 0)
@@ -102,256 +110,272 @@ void Job::flush_received_buffers()
     dbgln_if(JOB_DEBUG, "Job: Flushing received buffers done: have {} bytes in {} buffers", m_buffered_size, m_received_buffers.size());
 }
 
+void Job::fail(Core::NetworkJob::Error error)
+{
+    deferred_invoke([this, error](auto&) { did_fail(error); });
+}
+
 void Job::on_socket_connected()
 {
-    register_on_ready_to_write([&] {
-        if (m_sent_data)
+    // The socket callbacks only wake the job up, it checks for itself whether it can make any progress.
+    register_on_ready_to_write([this] {
+        m_can_write = true;
+        m_ready_to_write.notify();
+    });
+    register_on_ready_to_read([this] {
+        if (is_cancelled() || m_state == State::Finished)
             return;
-        m_sent_data = true;
-        auto raw_request = m_request.to_raw_request();
+        m_ready_to_read.notify();
+    });
+    m_task = send_request_and_receive_response();
+    m_task.start();
+}
 
-        if constexpr (JOB_DEBUG) {
-            dbgln("Job: raw_request:");
-            dbgln("{}", String::copy(raw_request));
-        }
+Core::Task<String> Job::read_line_when_available()
+{
+    while (!can_read_line()) {
+        if (eof() || !is_established())
+            co_return String {};
+        co_await m_ready_to_read.wait();
+    }
+    co_return read_line(PAGE_SIZE);
+}
 
-        bool success = write(raw_request);
-        if (!success)
-            deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-    });
-    register_on_ready_to_read([&] {
-        if (is_cancelled())
-            return;
+Core::Task<bool> Job::wait_until_can_read()
+{
+    while (!can_read()) {
+        if (eof() || !is_established())
+            co_return false;
+        co_await m_ready_to_read.wait();
+    }
+    co_return true;
+}
 
-        if (m_state == State::Finished) {
-            // This is probably just a EOF notification, which means we should receive nothing
-            // and then get eof() == true.
-            [[maybe_unused]] auto payload = receive(64);
-            // These assertions are only correct if "Connection: close".
-            VERIFY(payload.is_empty());
-            VERIFY(eof());
-            return;
+bool Job::add_header(const String& line)
+{
+    auto parts = line.split_view(':');
+    if (parts.is_empty())
+        return false;
+    auto name = parts[0];
+    if (line.length() < name.length() + 2)
+        return false;
+    auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
+    m_headers.set(name, value);
+    if (name.equals_ignoring_case("Content-Encoding")) {
+        // Assume that any content-encoding means that we can't decode it as a stream :(
+        dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
+        m_can_stream_response = false;
+    }
+    dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
+    return true;
+}
+
+Optional<size_t> Job::receive_payload(size_t max_size)
+{
+    auto payload = receive(max_size);
+    if (!payload) {
+        if (eof()) {
+            finish_up();
+            return {};
+        }
+        if (should_fail_on_empty_payload()) {
+            fail(Core::NetworkJob::Error::ProtocolFailed);
+            return {};
         }
+        return 0;
+    }
 
-        if (m_state == State::InStatus) {
-            if (!can_read_line())
-                return;
-            auto line = read_line(PAGE_SIZE);
-            if (line.is_null()) {
-                fprintf(stderr, "Job: Expected HTTP status\n");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-            }
-            auto parts = line.split_view(' ');
-            if (parts.size() < 3) {
-                warnln("Job: Expected 3-part HTTP status, got '{}'", line);
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto code = parts[1].to_uint();
-            if (!code.has_value()) {
-                fprintf(stderr, "Job: Expected numeric HTTP status\n");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            m_code = code.value();
-            m_state = State::InHeaders;
-            return;
+    auto size = payload.size();
+    m_received_buffers.append(move(payload));
+    m_buffered_size += size;
+    m_received_size += size;
+    flush_received_buffers();
+
+    auto content_length = m_content_length;
+    deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
+    return size;
+}
+
+Core::Task<> Job::send_request_and_receive_response()
+{
+    while (!m_can_write)
+        co_await m_ready_to_write.wait();
+
+    auto raw_request = m_request.to_raw_request();
+    if constexpr (JOB_DEBUG) {
+        dbgln("Job: raw_request:");
+        dbgln("{}", String::copy(raw_request));
+    }
+    if (!write(raw_request)) {
+        fail(Core::NetworkJob::Error::TransmissionFailed);
+        co_return;
+    }
+
+    auto status_line = co_await read_line_when_available();
+    if (status_line.is_null()) {
+        fprintf(stderr, "Job: Expected HTTP status\n");
+        fail(Core::NetworkJob::Error::TransmissionFailed);
+        co_return;
+    }
+    auto parts = status_line.split_view(' ');
+    if (parts.size() < 3) {
+        warnln("Job: Expected 3-part HTTP status, got '{}'", status_line);
+        fail(Core::NetworkJob::Error::ProtocolFailed);
+        co_return;
+    }
+    auto code = parts[1].to_uint();
+    if (!code.has_value()) {
+        fprintf(stderr, "Job: Expected numeric HTTP status\n");
+        fail(Core::NetworkJob::Error::ProtocolFailed);
+        co_return;
+    }
+    m_code = code.value();
+    m_server_keeps_connection_alive = parts[0] == "HTTP/1.1";
+
+    m_state = State::InHeaders;
+    for (;;) {
+        auto line = co_await read_line_when_available();
+        if (line.is_null()) {
+            fprintf(stderr, "Job: Expected HTTP header\n");
+            fail(Core::NetworkJob::Error::ProtocolFailed);
+            co_return;
         }
-        if (m_state == State::InHeaders || m_state == State::Trailers) {
-            if (!can_read_line())
-                return;
-            auto line = read_line(PAGE_SIZE);
-            if (line.is_null()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                fprintf(stderr, "Job: Expected HTTP header\n");
-                return did_fail(Core::NetworkJob::Error::ProtocolFailed);
-            }
-            if (line.is_empty()) {
-                if (m_state == State::Trailers) {
-                    return finish_up();
-                } else {
-                    if (on_headers_received)
-                        on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
-                    m_state = State::InBody;
-                }
-                return;
-            }
-            auto parts = line.split_view(':');
-            if (parts.is_empty()) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                fprintf(stderr, "Job: Expected HTTP header with key/value\n");
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto name = parts[0];
-            if (line.length() < name.length() + 2) {
-                if (m_state == State::Trailers) {
-                    // Some servers like to send two ending chunks
-                    // use this fact as an excuse to ignore anything after the last chunk
-                    // that is not a valid trailing header.
-                    return finish_up();
-                }
-                warnln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
-                return deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-            }
-            auto value = line.substring(name.length() + 2, line.length() - name.length() - 2);
-            m_headers.set(name, value);
-            if (name.equals_ignoring_case("Content-Encoding")) {
-                // Assume that any content-encoding means that we can't decode it as a stream :(
-                dbgln_if(JOB_DEBUG, "Content-Encoding {} detected, cannot stream output :(", value);
-                m_can_stream_response = false;
-            }
-            dbgln_if(JOB_DEBUG, "Job: [{}] = '{}'", name, value);
-            return;
+        if (line.is_empty())
+            break;
+        if (!add_header(line)) {
+            warnln("Job: Malformed HTTP header: '{}' ({})", line, line.length());
+            fail(Core::NetworkJob::Error::ProtocolFailed);
+            co_return;
         }
-        VERIFY(m_state == State::InBody);
-        VERIFY(can_read());
-
-        read_while_data_available([&] {
-            auto read_size = 64 * KiB;
-            if (m_current_chunk_remaining_size.has_value()) {
-            read_chunk_size:;
-                auto remaining = m_current_chunk_remaining_size.value();
-                if (remaining == -1) {
-                    // read size
-                    auto size_data = read_line(PAGE_SIZE);
-                    if (m_should_read_chunk_ending_line) {
-                        VERIFY(size_data.is_empty());
-                        m_should_read_chunk_ending_line = false;
-                        return IterationDecision::Continue;
-                    }
-                    auto size_lines = size_data.view().lines();
-                    dbgln_if(JOB_DEBUG, "Job: Received a chunk with size '{}'", size_data);
-                    if (size_lines.size() == 0) {
-                        dbgln("Job: Reached end of stream");
-                        finish_up();
-                        return IterationDecision::Break;
-                    } else {
-                        auto chunk = size_lines[0].split_view(';', true);
-                        String size_string = chunk[0];
-                        char* endptr;
-                        auto size = strtoul(size_string.characters(), &endptr, 16);
-                        if (*endptr) {
-                            // invalid number
-                            deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::TransmissionFailed); });
-                            return IterationDecision::Break;
-                        }
-                        if (size == 0) {
-                            // This is the last chunk
-                            // '0' *[; chunk-ext-name = chunk-ext-value]
-                            // We're going to ignore _all_ chunk extensions
-                            read_size = 0;
-                            m_current_chunk_total_size = 0;
-                            m_current_chunk_remaining_size = 0;
-
-                            dbgln_if(JOB_DEBUG, "Job: Received the last chunk with extensions '{}'", size_string.substring_view(1, size_string.length() - 1));
-                        } else {
-                            m_current_chunk_total_size = size;
-                            m_current_chunk_remaining_size = size;
-                            read_size = size;
-
-                            dbgln_if(JOB_DEBUG, "Job: Chunk of size '{}' started", size);
-                        }
-                    }
-                } else {
-                    read_size = remaining;
-
-                    dbgln_if(JOB_DEBUG, "Job: Resuming chunk with '{}' bytes left over", remaining);
-                }
-            } else {
-                auto transfer_encoding = m_headers.get("Transfer-Encoding");
-                if (transfer_encoding.has_value()) {
-                    // Note: Some servers add extra spaces around 'chunked', see #6302.
-                    auto encoding = transfer_encoding.value().trim_whitespace();
-
-                    dbgln_if(JOB_DEBUG, "Job: This content has transfer encoding '{}'", encoding);
-                    if (encoding.equals_ignoring_case("chunked")) {
-                        m_current_chunk_remaining_size = -1;
-                        goto read_chunk_size;
-                    } else {
-                        dbgln("Job: Unknown transfer encoding '{}', the result will likely be wrong!", encoding);
-                    }
-                }
-            }
+    }
 
-            auto payload = receive(read_size);
-            if (!payload) {
-                if (eof()) {
-                    finish_up();
-                    return IterationDecision::Break;
-                }
-
-                if (should_fail_on_empty_payload()) {
-                    deferred_invoke([this](auto&) { did_fail(Core::NetworkJob::Error::ProtocolFailed); });
-                    return IterationDecision::Break;
-                }
-            }
+    if (on_headers_received)
+        on_headers_received(m_headers, m_code > 0 ? m_code : Optional<u32> {});
+    m_state = State::InBody;
+
+    auto content_length_header = m_headers.get("Content-Length");
+    if (content_length_header.has_value())
+        m_content_length = content_length_header.value().to_uint();
+
+    bool is_chunked = false;
+    auto transfer_encoding = m_headers.get("Transfer-Encoding");
+    if (transfer_encoding.has_value()) {
+        // Note: Some servers add extra spaces around 'chunked', see #6302.
+        auto encoding = transfer_encoding.value().trim_whitespace();
+        dbgln_if(JOB_DEBUG, "Job: This content has transfer encoding '{}'", encoding);
+        is_chunked = encoding.equals_ignoring_case("chunked");
+        if (!is_chunked)
+            dbgln("Job: Unknown transfer encoding '{}', the result will likely be wrong!", encoding);
+    }
 
-            m_received_buffers.append(payload);
-            m_buffered_size += payload.size();
-            m_received_size += payload.size();
-            flush_received_buffers();
-
-            if (m_current_chunk_remaining_size.has_value()) {
-                auto size = m_current_chunk_remaining_size.value() - payload.size();
-
-                dbgln_if(JOB_DEBUG, "Job: We have {} bytes left over in this chunk", size);
-                if (size == 0) {
-                    dbgln_if(JOB_DEBUG, "Job: Finished a chunk of {} bytes", m_current_chunk_total_size.value());
-
-                    if (m_current_chunk_total_size.value() == 0) {
-                        m_state = State::Trailers;
-                        return IterationDecision::Break;
-                    }
-
-                    // we've read everything, now let's get the next chunk
-                    size = -1;
-                    if (can_read_line()) {
-                        auto line = read_line(PAGE_SIZE);
-                        VERIFY(line.is_empty());
-                    } else {
-                        m_should_read_chunk_ending_line = true;
-                    }
-                }
-                m_current_chunk_remaining_size = size;
-            }
+    // Some responses never have a body, and with a persistent connection the server
+    // won't close it to tell us so.
+    bool has_body = m_request.method() != HttpRequest::Method::HEAD && m_code != 204 && m_code != 304;
+    if (!is_chunked && m_content_length.has_value() && m_content_length.value() == 0)
+        has_body = false;
+
+    auto connection = m_headers.get("Connection");
+    if (connection.has_value() && connection.value().equals_ignoring_case("close"))
+        m_server_keeps_connection_alive = false;
+    // Without a length, the body only ends when the connection does.
+    if (has_body && !is_chunked && !m_content_length.has_value())
+        m_server_keeps_connection_alive = false;
+
+    if (!has_body) {
+        finish_up();
+        co_return;
+    }
 
-            auto content_length_header = m_headers.get("Content-Length");
-            Optional<u32> content_length {};
+    if (is_chunked)
+        co_await receive_chunked_body();
+    else
+        co_await receive_body();
+}
 
-            if (content_length_header.has_value()) {
-                auto length = content_length_header.value().to_uint();
-                if (length.has_value())
-                    content_length = length.value();
-            }
+Core::Task<> Job::receive_body()
+{
+    for (;;) {
+        if (!co_await wait_until_can_read()) {
+            dbgln_if(JOB_DEBUG, "Connection appears to have closed, finishing up");
+            finish_up();
+            co_return;
+        }
 
-            deferred_invoke([this, content_length](auto&) { did_progress(content_length, m_received_size); });
+        size_t read_size = 64 * KiB;
+        // Don't read into whatever the server sends after this response.
+        if (m_content_length.has_value() && m_content_length.value() > m_received_size)
+            read_size = min<size_t>(read_size, m_content_length.value() - m_received_size);
+        if (!receive_payload(read_size).has_value())
+            co_return;
 
-            if (content_length.has_value()) {
-                auto length = content_length.value();
-                if (m_received_size >= length) {
-                    m_received_size = length;
-                    finish_up();
-                    return IterationDecision::Break;
-                }
-            }
-            return IterationDecision::Continue;
-        });
+        if (m_content_length.has_value() && m_received_size >= m_content_length.value()) {
+            m_received_size = m_content_length.value();
+            finish_up();
+            co_return;
+        }
+    }
+}
 
-        if (!is_established()) {
-#if JOB_DEBUG
-            dbgln("Connection appears to have closed, finishing up");
-#endif
+Core::Task<> Job::receive_chunked_body()
+{
+    for (;;) {
+        auto size_line = co_await read_line_when_available();
+        auto size_lines = size_line.view().lines();
+        dbgln_if(JOB_DEBUG, "Job: Received a chunk with size '{}'", size_line);
+        if (size_lines.size() == 0) {
+            dbgln("Job: Reached end of stream");
             finish_up();
+            co_return;
         }
-    });
+
+        auto chunk = size_lines[0].split_view(';', true);
+        String size_string = chunk[0];
+        char* endptr;
+        auto size = strtoul(size_string.characters(), &endptr, 16);
+        if (*endptr) {
+            // invalid number
+            fail(Core::NetworkJob::Error::TransmissionFailed);
+            co_return;
+        }
+        if (size == 0) {
+            // This is the last chunk
+            // '0' *[; chunk-ext-name = chunk-ext-value]
+            // We're going to ignore _all_ chunk extensions
+            dbgln_if(JOB_DEBUG, "Job: Received the last chunk with extensions '{}'", size_string.substring_view(1, size_string.length() - 1));
+            break;
+        }
+
+        dbgln_if(JOB_DEBUG, "Job: Chunk of size '{}' started", size);
+        for (size_t remaining = size; remaining > 0;) {
+            if (!co_await wait_until_can_read()) {
+                dbgln_if(JOB_DEBUG, "Connection appears to have closed, finishing up");
+                finish_up();
+                co_return;
+            }
+            auto received = receive_payload(min<size_t>(remaining, 64 * KiB));
+            if (!received.has_value())
+                co_return;
+            remaining -= received.value();
+        }
+        dbgln_if(JOB_DEBUG, "Job: Finished a chunk of {} bytes", size);
+
+        // The chunk data ends with a line break of its own.
+        auto chunk_ending = co_await read_line_when_available();
+        if (!chunk_ending.is_empty()) {
+            fail(Core::NetworkJob::Error::ProtocolFailed);
+            co_return;
+        }
+    }
+
+    // Some servers like to send two ending chunks, so ignore anything after
+    // the last chunk that isn't a valid trailing header.
+    m_state = State::Trailers;
+    for (;;) {
+        auto line = co_await read_line_when_available();
+        if (line.is_empty() || !add_header(line))
+            break;
+    }
+    finish_up();
 }
 
 void Job::finish_up()
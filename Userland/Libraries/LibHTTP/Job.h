@@ -9,6 +9,7 @@
 #include <AK/FileStream.h>
 #include <AK/HashMap.h>
 #include <AK/Optional.h>
+#include <LibCore/Coroutine.h>
 #include <LibCore/NetworkJob.h>
 #include <LibCore/TCPSocket.h>
 #include <LibHTTP/HttpRequest.h>
@@ -27,6 +28,12 @@ public:
     HttpResponse* response() { return static_cast<HttpResponse*>(Core::NetworkJob::response()); }
     const HttpResponse* response() const { return static_cast<const HttpResponse*>(Core::NetworkJob::response()); }
 
+    const URL& url() const { return m_request.url(); }
+
+    // Whether the connection can carry another request once this job has finished.
+    // Only meaningful before the job shuts down.
+    bool can_reuse_connection() const;
+
 protected:
     void finish_up();
     void on_socket_connected();
@@ -41,7 +48,6 @@ protected:
     virtual bool write(ReadonlyBytes) = 0;
     virtual bool is_established() const = 0;
     virtual bool should_fail_on_empty_payload() const { return true; }
-    virtual void read_while_data_available(Function<IterationDecision()> read) { read(); };
 
     enum class State {
         InStatus,
@@ -58,11 +64,25 @@ protected:
     Vector<ByteBuffer, 2> m_received_buffers;
     size_t m_buffered_size { 0 };
     size_t m_received_size { 0 };
-    bool m_sent_data { 0 };
-    Optional<ssize_t> m_current_chunk_remaining_size;
-    Optional<size_t> m_current_chunk_total_size;
     bool m_can_stream_response { true };
-    bool m_should_read_chunk_ending_line { false };
+    Optional<u32> m_content_length;
+    bool m_server_keeps_connection_alive { false };
+
+private:
+    Core::Task<> send_request_and_receive_response();
+    Core::Task<> receive_body();
+    Core::Task<> receive_chunked_body();
+    Core::Task<String> read_line_when_available();
+    Core::Task<bool> wait_until_can_read();
+    bool add_header(const String& line);
+    Optional<size_t> receive_payload(size_t max_size);
+    void fail(Core::NetworkJob::Error);
+
+    Core::AsyncEvent m_ready_to_read;
+    Core::AsyncEvent m_ready_to_write;
+    // Destroying the task destroys a coroutine that may still be waiting on one of the events above, so it has to go first.
+    Core::Task<> m_task;
+    bool m_can_write { false };
 };
 
 }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullOwnPtrVector.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
@@ -14,12 +15,14 @@
 #include <LibCore/Notifier.h>
 #include <LibCore/Timer.h>
 #include <LibIPC/Message.h>
+#include <errno.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace IPC {
@@ -54,9 +57,7 @@ public:
             return;
 
         auto buffer = message.encode();
-        // Prepend the message size.
         uint32_t message_size = buffer.data.size();
-        buffer.data.prepend(reinterpret_cast<const u8*>(&message_size), sizeof(message_size));
 
 #ifdef __serenity__
         for (int fd : buffer.fds) {
@@ -71,29 +72,25 @@ public:
             warnln("fd passing is not supported on this platform, sorry :(");
 #endif
 
-        size_t total_nwritten = 0;
-        while (total_nwritten < buffer.data.size()) {
-            auto nwritten = write(m_socket->fd(), buffer.data.data() + total_nwritten, buffer.data.size() - total_nwritten);
-            if (nwritten < 0) {
-                switch (errno) {
-                case EPIPE:
-                    dbgln("{}::post_message: Disconnected from peer", *this);
-                    shutdown();
-                    return;
-                case EAGAIN:
-                    dbgln("{}::post_message: Peer buffer overflowed", *this);
-                    shutdown();
-                    return;
-                default:
-                    perror("Connection::post_message write");
-                    shutdown();
-                    return;
-                }
-            }
-            total_nwritten += nwritten;
+        if (m_cork_count) {
+            m_corked_bytes.append(reinterpret_cast<const u8*>(&message_size), sizeof(message_size));
+            m_corked_bytes.append(buffer.data.data(), buffer.data.size());
+            return;
         }
 
-        m_responsiveness_timer->start();
+        // Send the message size and the message itself with a single writev(), rather than
+        // copying the whole message around to prepend its size.
+        write_to_peer({ reinterpret_cast<const u8*>(&message_size), sizeof(message_size) }, buffer.data.span());
+    }
+
+    // While the connection is corked, posted messages are held back and then sent with a single write
+    // when it's uncorked, e.g. for the handful of messages that handling one input event can produce.
+    void cork() { ++m_cork_count; }
+    void uncork()
+    {
+        VERIFY(m_cork_count);
+        if (--m_cork_count == 0)
+            flush_corked_messages();
     }
 
     template<typename RequestType, typename... Args>
@@ -112,6 +109,30 @@ public:
         return wait_for_specific_endpoint_message<typename RequestType::ResponseType, PeerEndpoint>();
     }
 
+    // Like send_sync(), but instead of blocking until the response arrives, on_response is called with it
+    // later from the event loop (or with nullptr if the connection goes away first). Several requests can
+    // be in flight at once. The peer answers requests in the order it gets them, so responses are matched
+    // to requests of the same type in that order.
+    template<typename RequestType, typename... Args>
+    void send_async(Function<void(OwnPtr<typename RequestType::ResponseType>)> on_response, Args&&... args)
+    {
+        using ResponseType = typename RequestType::ResponseType;
+        auto request = make<TypedPendingAsyncRequest<ResponseType>>(move(on_response));
+
+        if (!m_socket->is_open()) {
+            m_async_responses.append(AsyncResponse { move(request), {} });
+            schedule_async_responses();
+            return;
+        }
+
+        m_pending_async_requests.ensure(ResponseType::static_message_id()).append(move(request));
+        post_message(RequestType(forward<Args>(args)...));
+    }
+
+    // Lets a connection skip a message when the one right after it makes it redundant, like a mouse move
+    // that is followed by another one, so that a backed-up burst of them is only handled once.
+    virtual bool is_superseded_by([[maybe_unused]] const Message& message, [[maybe_unused]] const Message& next_message) const { return false; }
+
     virtual void may_have_become_unresponsive() { }
     virtual void did_become_responsive() { }
 
@@ -119,6 +140,7 @@ public:
     {
         m_notifier->close();
         m_socket->close();
+        fail_pending_async_requests();
         die();
     }
 
@@ -127,9 +149,85 @@ public:
 protected:
     Core::LocalSocket& socket() { return *m_socket; }
 
+    void schedule_async_responses()
+    {
+        deferred_invoke([this](auto&) {
+            handle_async_responses();
+        });
+    }
+
+    void handle_async_responses()
+    {
+        auto responses = move(m_async_responses);
+        for (auto& response : responses)
+            response.request->did_receive_response(move(response.message));
+    }
+
+    void fail_pending_async_requests()
+    {
+        if (m_pending_async_requests.is_empty())
+            return;
+        for (auto& it : m_pending_async_requests) {
+            for (auto& request : it.value)
+                m_async_responses.append(AsyncResponse { move(request), {} });
+        }
+        m_pending_async_requests.clear();
+        schedule_async_responses();
+    }
+
+    void flush_corked_messages()
+    {
+        if (m_corked_bytes.is_empty())
+            return;
+        if (m_socket->is_open())
+            write_to_peer(m_corked_bytes.span(), {});
+        m_corked_bytes.clear_with_capacity();
+    }
+
+    void write_to_peer(ReadonlyBytes first, ReadonlyBytes second)
+    {
+        size_t total_size = first.size() + second.size();
+        size_t total_nwritten = 0;
+        while (total_nwritten < total_size) {
+            iovec iovs[2];
+            int iov_count = 0;
+            size_t second_offset = 0;
+            if (total_nwritten < first.size())
+                iovs[iov_count++] = { const_cast<u8*>(first.data()) + total_nwritten, first.size() - total_nwritten };
+            else
+                second_offset = total_nwritten - first.size();
+            if (second_offset < second.size())
+                iovs[iov_count++] = { const_cast<u8*>(second.data()) + second_offset, second.size() - second_offset };
+
+            auto nwritten = writev(m_socket->fd(), iovs, iov_count);
+            if (nwritten < 0) {
+                switch (errno) {
+                case EPIPE:
+                    dbgln("{}::post_message: Disconnected from peer", *this);
+                    shutdown();
+                    return;
+                case EAGAIN:
+                    dbgln("{}::post_message: Peer buffer overflowed", *this);
+                    shutdown();
+                    return;
+                default:
+                    perror("Connection::post_message write");
+                    shutdown();
+                    return;
+                }
+            }
+            total_nwritten += nwritten;
+        }
+
+        m_responsiveness_timer->start();
+    }
+
     template<typename MessageType, typename Endpoint>
     OwnPtr<MessageType> wait_for_specific_endpoint_message()
     {
+        // The peer can't answer what it hasn't been sent yet.
+        flush_corked_messages();
+
         for (;;) {
             // Double check we don't already have the event waiting for us.
             // Otherwise we might end up blocked for a while for no reason.
@@ -167,16 +265,13 @@ protected:
 
     bool drain_messages_from_peer()
     {
-        Vector<u8> bytes;
-
-        if (!m_unprocessed_bytes.is_empty()) {
-            bytes.append(m_unprocessed_bytes.data(), m_unprocessed_bytes.size());
-            m_unprocessed_bytes.clear();
-        }
-
+        // Read straight into the receive buffer, which keeps its allocation between calls and
+        // still holds the start of a message we only got part of last time.
+        bool did_receive_anything = false;
         while (m_socket->is_open()) {
-            u8 buffer[4096];
-            ssize_t nread = recv(m_socket->fd(), buffer, sizeof(buffer), MSG_DONTWAIT);
+            if (m_receive_buffer.size() - m_receive_buffer_used < receive_chunk_size)
+                m_receive_buffer.grow(max(m_receive_buffer.size() * 2, m_receive_buffer_used + receive_chunk_size));
+            ssize_t nread = recv(m_socket->fd(), m_receive_buffer.data() + m_receive_buffer_used, m_receive_buffer.size() - m_receive_buffer_used, MSG_DONTWAIT);
             if (nread < 0) {
                 if (errno == EAGAIN)
                     break;
@@ -185,23 +280,26 @@ protected:
                 return false;
             }
             if (nread == 0) {
-                if (bytes.is_empty()) {
+                if (!did_receive_anything && m_receive_buffer_used == 0) {
+                    fail_pending_async_requests();
                     deferred_invoke([this](auto&) { die(); });
                 }
                 return false;
             }
-            bytes.append(buffer, nread);
+            m_receive_buffer_used += nread;
+            did_receive_anything = true;
         }
 
-        if (!bytes.is_empty()) {
+        if (did_receive_anything) {
             m_responsiveness_timer->stop();
             did_become_responsive();
         }
 
+        auto bytes = ReadonlyBytes { m_receive_buffer.data(), m_receive_buffer_used };
         size_t index = 0;
         uint32_t message_size = 0;
         for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
-            message_size = *reinterpret_cast<uint32_t*>(bytes.data() + index);
+            message_size = *reinterpret_cast<const uint32_t*>(bytes.data() + index);
             if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
                 break;
             index += sizeof(message_size);
@@ -209,24 +307,24 @@ protected:
             if (auto message = LocalEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
                 m_unprocessed_messages.append(message.release_nonnull());
             } else if (auto message = PeerEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
+                auto it = m_pending_async_requests.find(message->message_id());
+                if (it != m_pending_async_requests.end() && !it->value.is_empty())
+                    m_async_responses.append(AsyncResponse { it->value.take_first(), move(message) });
+                else
+                    m_unprocessed_messages.append(message.release_nonnull());
             } else {
                 dbgln("Failed to parse a message");
                 break;
             }
         }
 
-        if (index < bytes.size()) {
-            // Sometimes we might receive a partial message. That's okay, just stash away
-            // the unprocessed bytes and we'll prepend them to the next incoming message
-            // in the next run of this function.
-            auto remaining_bytes = ByteBuffer::copy(bytes.data() + index, bytes.size() - index);
-            if (!m_unprocessed_bytes.is_empty()) {
-                dbgln("{}::drain_messages_from_peer: Already have unprocessed bytes", *this);
-                shutdown();
-                return false;
-            }
-            m_unprocessed_bytes = remaining_bytes;
+        // Sometimes we might receive a partial message. That's okay, just move the unprocessed
+        // bytes to the front and the rest of the message will be appended in the next run of this function.
+        if (index > 0 && index < bytes.size()) {
+            memmove(m_receive_buffer.data(), m_receive_buffer.data() + index, bytes.size() - index);
+            m_receive_buffer_used = bytes.size() - index;
+        } else if (index >= bytes.size()) {
+            m_receive_buffer_used = 0;
         }
 
         if (!m_unprocessed_messages.is_empty()) {
@@ -234,16 +332,22 @@ protected:
                 handle_messages();
             });
         }
+        if (!m_async_responses.is_empty())
+            schedule_async_responses();
         return true;
     }
 
     void handle_messages()
     {
         auto messages = move(m_unprocessed_messages);
-        for (auto& message : messages) {
-            if (message.endpoint_magic() == LocalEndpoint::static_magic())
-                if (auto response = m_local_endpoint.handle(message))
-                    post_message(*response);
+        for (size_t i = 0; i < messages.size(); ++i) {
+            auto& message = messages[i];
+            if (message.endpoint_magic() != LocalEndpoint::static_magic())
+                continue;
+            if (i + 1 < messages.size() && is_superseded_by(message, messages[i + 1]))
+                continue;
+            if (auto response = m_local_endpoint.handle(message))
+                post_message(*response);
         }
     }
 
@@ -254,7 +358,41 @@ protected:
 
     RefPtr<Core::Notifier> m_notifier;
     NonnullOwnPtrVector<Message> m_unprocessed_messages;
-    ByteBuffer m_unprocessed_bytes;
+
+    struct PendingAsyncRequest {
+        virtual ~PendingAsyncRequest() = default;
+        virtual void did_receive_response(OwnPtr<Message>) = 0;
+    };
+    template<typename ResponseType>
+    struct TypedPendingAsyncRequest final : public PendingAsyncRequest {
+        explicit TypedPendingAsyncRequest(Function<void(OwnPtr<ResponseType>)> on_response)
+            : on_response(move(on_response))
+        {
+        }
+        virtual void did_receive_response(OwnPtr<Message> response) override
+        {
+            if (!response)
+                on_response({});
+            else
+                on_response(response.template release_nonnull<ResponseType>());
+        }
+        Function<void(OwnPtr<ResponseType>)> on_response;
+    };
+
+    // send_async() requests that haven't been answered yet, by the ID of the response they expect.
+    HashMap<i32, Vector<NonnullOwnPtr<PendingAsyncRequest>>> m_pending_async_requests;
+    struct AsyncResponse {
+        NonnullOwnPtr<PendingAsyncRequest> request;
+        OwnPtr<Message> message;
+    };
+    Vector<AsyncResponse> m_async_responses;
+
+    unsigned m_cork_count { 0 };
+    Vector<u8> m_corked_bytes;
+
+    static constexpr size_t receive_chunk_size = 4096;
+    ByteBuffer m_receive_buffer;
+    size_t m_receive_buffer_used { 0 };
 };
 
 }
@@ -50,15 +50,45 @@ Optional<DecodedImage> Client::decode_image(const ByteBuffer& encoded_data)
     }
 
     DecodedImage image;
+    image.image_id = response->image_id();
     image.is_animated = response->is_animated();
     image.loop_count = response->loop_count();
-    image.frames.resize(response->bitmaps().size());
-    for (size_t i = 0; i < image.frames.size(); ++i) {
-        auto& frame = image.frames[i];
-        frame.bitmap = response->bitmaps()[i].bitmap();
-        frame.duration = response->durations()[i];
+    image.frames.resize(response->frame_count());
+    if (!image.frames.is_empty()) {
+        image.frames[0].bitmap = response->first_frame().bitmap();
+        image.frames[0].duration = response->first_frame_duration();
     }
     return image;
 }
 
+Optional<Frame> Client::decode_frame(i32 image_id, size_t frame_index)
+{
+    auto response = send_sync_but_allow_failure<Messages::ImageDecoderServer::DecodeFrame>(image_id, frame_index);
+
+    if (!response) {
+        dbgln("ImageDecoder died heroically");
+        return {};
+    }
+
+    return Frame { response->bitmap().bitmap(), response->duration() };
+}
+
+void Client::decode_frame_async(i32 image_id, size_t frame_index, Function<void(Optional<Frame>)> on_decoded)
+{
+    send_async<Messages::ImageDecoderServer::DecodeFrame>(
+        [on_decoded = move(on_decoded)](auto response) {
+            if (!response) {
+                on_decoded({});
+                return;
+            }
+            on_decoded(Frame { response->bitmap().bitmap(), response->duration() });
+        },
+        image_id, frame_index);
+}
+
+void Client::forget_image(i32 image_id)
+{
+    post_message(Messages::ImageDecoderServer::ForgetImage(image_id));
+}
+
 }
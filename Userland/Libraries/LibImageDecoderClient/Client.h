@@ -19,6 +19,9 @@ struct Frame {
 };
 
 struct DecodedImage {
+    // Only the first frame is decoded up front. If the image has more frames, the
+    // decoder holds on to it under this ID until forget_image() is called.
+    i32 image_id { 0 };
     bool is_animated { false };
     u32 loop_count { 0 };
     Vector<Frame> frames;
@@ -33,6 +36,9 @@ public:
     virtual void handshake() override;
 
     Optional<DecodedImage> decode_image(const ByteBuffer&);
+    Optional<Frame> decode_frame(i32 image_id, size_t frame_index);
+    void decode_frame_async(i32 image_id, size_t frame_index, Function<void(Optional<Frame>)> on_decoded);
+    void forget_image(i32 image_id);
 
     Function<void()> on_death;
 
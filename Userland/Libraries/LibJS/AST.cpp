@@ -13,6 +13,7 @@
 #include <AK/TemporaryChange.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
@@ -128,7 +129,7 @@ CallExpression::ThisAndCallee CallExpression::compute_this_and_callee(Interprete
     if (is<MemberExpression>(*m_callee)) {
         auto& member_expression = static_cast<const MemberExpression&>(*m_callee);
         Value callee;
-        Object* this_value = nullptr;
+        Value this_value;
 
         if (is<SuperExpression>(member_expression.object())) {
             auto super_base = interpreter.current_environment()->get_super_base();
@@ -143,7 +144,7 @@ CallExpression::ThisAndCallee CallExpression::compute_this_and_callee(Interprete
             callee = reference.get(global_object);
             if (vm.exception())
                 return {};
-            this_value = &vm.this_value(global_object).as_object();
+            this_value = vm.this_value(global_object);
         } else {
             auto reference = member_expression.to_reference(interpreter, global_object);
             if (vm.exception())
@@ -151,9 +152,8 @@ CallExpression::ThisAndCallee CallExpression::compute_this_and_callee(Interprete
             callee = reference.get(global_object);
             if (vm.exception())
                 return {};
-            this_value = reference.base().to_object(global_object);
-            if (vm.exception())
-                return {};
+            // Primitives are passed as they are, and only functions that aren't strict turn them into objects.
+            this_value = reference.base();
         }
 
         return { this_value, callee };
@@ -191,6 +191,22 @@ Value CallExpression::execute(Interpreter& interpreter, GlobalObject& global_obj
 
     auto& function = callee.as_function();
 
+    // Most calls only have a few arguments, which can then stay on the stack (where the garbage collector finds them)
+    // instead of in a MarkedValueList that has to register itself with the heap.
+    if (!is<NewExpression>(*this) && !is<SuperExpression>(*m_callee) && !m_has_spread_arguments && m_arguments.size() <= max_arguments_on_stack) {
+        Value arguments[max_arguments_on_stack];
+        for (size_t i = 0; i < m_arguments.size(); ++i) {
+            arguments[i] = m_arguments[i].value->execute(interpreter, global_object);
+            if (vm.exception())
+                return {};
+        }
+        vm.call_frame().current_node = interpreter.current_node();
+        auto result = vm.call(function, this_value, Span<const Value> { arguments, m_arguments.size() });
+        if (vm.exception())
+            return {};
+        return result;
+    }
+
     MarkedValueList arguments(vm.heap());
     arguments.ensure_capacity(m_arguments.size());
 
@@ -304,6 +320,7 @@ Value WhileStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
             return {};
         if (!test_result.to_boolean())
             break;
+        interpreter.did_run_loop_iteration();
         last_value = interpreter.execute_statement(global_object, *m_body).value_or(last_value);
         if (interpreter.exception())
             return {};
@@ -330,6 +347,7 @@ Value DoWhileStatement::execute(Interpreter& interpreter, GlobalObject& global_o
     for (;;) {
         if (interpreter.exception())
             return {};
+        interpreter.did_run_loop_iteration();
         last_value = interpreter.execute_statement(global_object, *m_body).value_or(last_value);
         if (interpreter.exception())
             return {};
@@ -386,6 +404,7 @@ Value ForStatement::execute(Interpreter& interpreter, GlobalObject& global_objec
                 return {};
             if (!test_result.to_boolean())
                 break;
+            interpreter.did_run_loop_iteration();
             last_value = interpreter.execute_statement(global_object, *m_body).value_or(last_value);
             if (interpreter.exception())
                 return {};
@@ -407,6 +426,7 @@ Value ForStatement::execute(Interpreter& interpreter, GlobalObject& global_objec
         }
     } else {
         while (true) {
+            interpreter.did_run_loop_iteration();
             last_value = interpreter.execute_statement(global_object, *m_body).value_or(last_value);
             if (interpreter.exception())
                 return {};
@@ -479,6 +499,7 @@ Value ForInStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
             interpreter.vm().set_variable(variable_name, value, global_object, has_declaration);
             if (interpreter.exception())
                 return {};
+            interpreter.did_run_loop_iteration();
             last_value = interpreter.execute_statement(global_object, *m_body).value_or(last_value);
             if (interpreter.exception())
                 return {};
@@ -522,6 +543,7 @@ Value ForOfStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
 
     get_iterator_values(global_object, rhs_result, [&](Value value) {
         interpreter.vm().set_variable(variable_name, value, global_object, has_declaration);
+        interpreter.did_run_loop_iteration();
         last_value = interpreter.execute_statement(global_object, *m_body).value_or(last_value);
         if (interpreter.exception())
             return IterationDecision::Break;
@@ -1249,7 +1271,7 @@ Value Identifier::execute(Interpreter& interpreter, GlobalObject& global_object)
 {
     InterpreterNodeScope node_scope { interpreter, *this };
 
-    auto value = interpreter.vm().get_variable(string(), global_object);
+    auto value = interpreter.vm().get_variable(string(), global_object, &m_variable_cache);
     if (value.is_empty()) {
         interpreter.vm().throw_exception<ReferenceError>(global_object, ErrorType::UnknownIdentifier, string());
         return {};
@@ -1381,6 +1403,39 @@ Value AssignmentExpression::execute(Interpreter& interpreter, GlobalObject& glob
     if (interpreter.exception())
         return {};
 
+    if (is<Identifier>(*m_lhs)) {
+        auto& identifier = static_cast<const Identifier&>(*m_lhs);
+        if (m_op == AssignmentOp::Assignment) {
+            rhs_result = m_rhs->execute(interpreter, global_object);
+            if (interpreter.exception())
+                return {};
+        }
+        interpreter.vm().set_variable(identifier.string(), rhs_result, global_object, false, &identifier.variable_cache());
+        if (interpreter.exception())
+            return {};
+        return rhs_result;
+    }
+
+    if (is<MemberExpression>(*m_lhs) && !static_cast<const MemberExpression&>(*m_lhs).is_computed()) {
+        auto& member_expression = static_cast<const MemberExpression&>(*m_lhs);
+        auto& property_name = static_cast<const Identifier&>(member_expression.property()).string();
+        auto base = member_expression.object().execute(interpreter, global_object);
+        if (interpreter.exception())
+            return {};
+        if (m_op == AssignmentOp::Assignment) {
+            rhs_result = m_rhs->execute(interpreter, global_object);
+            if (interpreter.exception())
+                return {};
+        }
+        if (base.is_object())
+            base.as_object().put_with_cache(property_name, rhs_result, m_cache);
+        else
+            Reference(base, property_name).put(global_object, rhs_result);
+        if (interpreter.exception())
+            return {};
+        return rhs_result;
+    }
+
     auto reference = m_lhs->to_reference(interpreter, global_object);
     if (interpreter.exception())
         return {};
@@ -1407,10 +1462,18 @@ Value UpdateExpression::execute(Interpreter& interpreter, GlobalObject& global_o
 {
     InterpreterNodeScope node_scope { interpreter, *this };
 
-    auto reference = m_argument->to_reference(interpreter, global_object);
-    if (interpreter.exception())
-        return {};
-    auto old_value = reference.get(global_object);
+    // Identifiers go through their variable cache rather than a Reference, which would have to look them up by name.
+    auto* identifier = is<Identifier>(*m_argument) ? static_cast<const Identifier*>(m_argument.ptr()) : nullptr;
+    Reference reference;
+    Value old_value;
+    if (identifier) {
+        old_value = identifier->execute(interpreter, global_object);
+    } else {
+        reference = m_argument->to_reference(interpreter, global_object);
+        if (interpreter.exception())
+            return {};
+        old_value = reference.get(global_object);
+    }
     if (interpreter.exception())
         return {};
     old_value = old_value.to_numeric(global_object);
@@ -1435,7 +1498,10 @@ Value UpdateExpression::execute(Interpreter& interpreter, GlobalObject& global_o
         VERIFY_NOT_REACHED();
     }
 
-    reference.put(global_object, new_value);
+    if (identifier)
+        interpreter.vm().set_variable(identifier->string(), new_value, global_object, false, &identifier->variable_cache());
+    else
+        reference.put(global_object, new_value);
     if (interpreter.exception())
         return {};
     return m_prefixed ? new_value : old_value;
@@ -1538,7 +1604,7 @@ Value VariableDeclaration::execute(Interpreter& interpreter, GlobalObject& globa
             auto variable_name = declarator.id().string();
             if (is<ClassExpression>(*init))
                 update_function_name(initalizer_result, variable_name);
-            interpreter.vm().set_variable(variable_name, initalizer_result, global_object, true);
+            interpreter.vm().set_variable(variable_name, initalizer_result, global_object, true, &declarator.id().variable_cache());
         }
     }
     return {};
@@ -1612,10 +1678,38 @@ Value ObjectProperty::execute(Interpreter& interpreter, GlobalObject&) const
     VERIFY_NOT_REACHED();
 }
 
+bool ObjectExpression::has_only_plain_keys() const
+{
+    for (auto& property : m_properties) {
+        if (property.type() != ObjectProperty::Type::KeyValue || !is<StringLiteral>(property.key()))
+            return false;
+    }
+    return true;
+}
+
 Value ObjectExpression::execute(Interpreter& interpreter, GlobalObject& global_object) const
 {
     InterpreterNodeScope node_scope { interpreter, *this };
 
+    if (m_cached_shape && m_cached_shape_root_id == global_object.new_object_shape()->id()) {
+        // The keys are all strings, so evaluating them can't have side effects, and the values go in the same order as
+        // the properties of the shape.
+        auto* object = global_object.heap().allocate<Object>(global_object, *m_cached_shape);
+        for (size_t i = 0; i < m_properties.size(); ++i) {
+            auto& property = m_properties[i];
+            auto value = property.value().execute(interpreter, global_object);
+            if (interpreter.exception())
+                return {};
+            if (value.is_function()) {
+                if (property.is_method())
+                    value.as_function().set_home_object(object);
+                update_function_name(value, static_cast<const StringLiteral&>(property.key()).value());
+            }
+            object->put_direct(i, value);
+        }
+        return object;
+    }
+
     auto* object = Object::create_empty(global_object);
     for (auto& property : m_properties) {
         auto key = property.key().execute(interpreter, global_object);
@@ -1688,6 +1782,14 @@ Value ObjectExpression::execute(Interpreter& interpreter, GlobalObject& global_o
         if (interpreter.exception())
             return {};
     }
+
+    // Keys that are array indices go in the indexed properties, and duplicate keys share a property, so in both cases
+    // the properties of the shape don't line up with the ones of the literal.
+    auto& shape = object->shape();
+    if (!shape.is_unique() && shape.property_count() == m_properties.size() && object->indexed_properties().is_empty() && has_only_plain_keys()) {
+        m_cached_shape = &shape;
+        m_cached_shape_root_id = global_object.new_object_shape()->id();
+    }
     return object;
 }
 
@@ -1727,10 +1829,15 @@ Value MemberExpression::execute(Interpreter& interpreter, GlobalObject& global_o
 {
     InterpreterNodeScope node_scope { interpreter, *this };
 
-    auto reference = to_reference(interpreter, global_object);
+    auto object_value = m_object->execute(interpreter, global_object);
     if (interpreter.exception())
         return {};
-    return reference.get(global_object);
+    if (!is_computed() && object_value.is_object())
+        return object_value.as_object().get_with_cache(static_cast<const Identifier&>(*m_property).string(), m_cache).value_or(js_undefined());
+    auto property_name = computed_property_name(interpreter, global_object);
+    if (!property_name.is_valid())
+        return {};
+    return Reference(object_value, property_name).get(global_object);
 }
 
 void MetaProperty::dump(int indent) const
@@ -1962,9 +2069,8 @@ Value TryStatement::execute(Interpreter& interpreter, GlobalObject& global_objec
         if (m_handler) {
             interpreter.vm().clear_exception();
 
-            HashMap<FlyString, Variable> parameters;
-            parameters.set(m_handler->parameter(), Variable { exception->value(), DeclarationKind::Var });
-            auto* catch_scope = interpreter.heap().allocate<LexicalEnvironment>(global_object, move(parameters), interpreter.vm().call_frame().scope);
+            auto* catch_scope = interpreter.heap().allocate<LexicalEnvironment>(global_object, m_handler->environment_layout(), interpreter.vm().call_frame().scope);
+            catch_scope->variable_at(0).value = exception->value();
             TemporaryChange<ScopeObject*> scope_change(interpreter.vm().call_frame().scope, catch_scope);
             result = interpreter.execute_statement(global_object, m_handler->body());
         }
@@ -2001,6 +2107,15 @@ Value TryStatement::execute(Interpreter& interpreter, GlobalObject& global_objec
     return result.value_or(js_undefined());
 }
 
+NonnullRefPtr<EnvironmentLayout> CatchClause::environment_layout() const
+{
+    if (!m_environment_layout) {
+        m_environment_layout = EnvironmentLayout::create();
+        m_environment_layout->add(m_parameter, DeclarationKind::Var);
+    }
+    return *m_environment_layout;
+}
+
 Value CatchClause::execute(Interpreter& interpreter, GlobalObject&) const
 {
     InterpreterNodeScope node_scope { interpreter, *this };
@@ -2173,9 +2288,33 @@ void ScopeNode::add_variables(NonnullRefPtrVector<VariableDeclaration> variables
     m_variables.append(move(variables));
 }
 
+ScopeNode::~ScopeNode()
+{
+}
+
+ScopeNode::FunctionTierState::FunctionTierState()
+{
+}
+
+ScopeNode::FunctionTierState::~FunctionTierState()
+{
+}
+
 void ScopeNode::add_functions(NonnullRefPtrVector<FunctionDeclaration> functions)
 {
     m_functions.append(move(functions));
 }
 
+NonnullRefPtr<EnvironmentLayout> ScopeNode::block_environment_layout() const
+{
+    if (!m_block_environment_layout) {
+        m_block_environment_layout = EnvironmentLayout::create();
+        for (auto& declaration : m_variables) {
+            for (auto& declarator : declaration.declarations())
+                m_block_environment_layout->add(declarator.id().string(), declaration.declaration_kind());
+        }
+    }
+    return *m_block_environment_layout;
+}
+
 }
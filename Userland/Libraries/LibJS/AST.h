@@ -10,12 +10,18 @@
 #include <AK/FlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibJS/Bytecode/Register.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Runtime/EnvironmentLayout.h>
+#include <LibJS/Runtime/PropertyCache.h>
 #include <LibJS/Runtime/PropertyName.h>
 #include <LibJS/Runtime/Value.h>
+#include <LibJS/Runtime/VariableCache.h>
 #include <LibJS/SourceRange.h>
 
 namespace JS {
@@ -34,6 +40,7 @@ class ASTNode : public RefCounted<ASTNode> {
 public:
     virtual ~ASTNode() { }
     virtual Value execute(Interpreter&, GlobalObject&) const = 0;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const;
     virtual void dump(int indent) const;
 
     const SourceRange& source_range() const { return m_source_range; }
@@ -72,6 +79,7 @@ public:
     {
     }
     Value execute(Interpreter&, GlobalObject&) const override { return {}; }
+    Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override { return {}; }
 };
 
 class ErrorStatement final : public Statement {
@@ -92,6 +100,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     const Expression& expression() const { return m_expression; };
@@ -116,6 +125,7 @@ public:
 
     const NonnullRefPtrVector<Statement>& children() const { return m_children; }
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     void add_variables(NonnullRefPtrVector<VariableDeclaration>);
@@ -123,16 +133,41 @@ public:
     const NonnullRefPtrVector<VariableDeclaration>& variables() const { return m_variables; }
     const NonnullRefPtrVector<FunctionDeclaration>& functions() const { return m_functions; }
 
+    // The layout of the environment for the variables of this block, built on first use and then shared by all of them.
+    NonnullRefPtr<EnvironmentLayout> block_environment_layout() const;
+
+    // The layout of the environment of a function with this body, which also binds the function's parameters.
+    // Only ScriptFunction knows about those, so it builds the layout, and stores it here to share it between closures.
+    RefPtr<EnvironmentLayout> function_environment_layout() const { return m_function_environment_layout; }
+    void set_function_environment_layout(NonnullRefPtr<EnvironmentLayout> layout) const { m_function_environment_layout = move(layout); }
+
+    // A function body that has run often enough is compiled to bytecode, see ScriptFunction::execute_function_body().
+    // Like the environment layout, that happens once for all the closures with this body.
+    struct FunctionTierState {
+        FunctionTierState();
+        ~FunctionTierState();
+
+        u64 hotness { 0 };
+        bool failed_to_compile { false };
+        OwnPtr<Bytecode::Executable> executable;
+    };
+    FunctionTierState& function_tier_state() const { return m_function_tier_state; }
+
 protected:
     ScopeNode(SourceRange source_range)
         : Statement(move(source_range))
     {
     }
 
+    ~ScopeNode();
+
 private:
     NonnullRefPtrVector<Statement> m_children;
     NonnullRefPtrVector<VariableDeclaration> m_variables;
     NonnullRefPtrVector<FunctionDeclaration> m_functions;
+    mutable RefPtr<EnvironmentLayout> m_block_environment_layout;
+    mutable RefPtr<EnvironmentLayout> m_function_environment_layout;
+    mutable FunctionTierState m_function_tier_state;
 };
 
 class Program final : public ScopeNode {
@@ -166,6 +201,7 @@ public:
     {
     }
     virtual Reference to_reference(Interpreter&, GlobalObject&) const;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 };
 
 class Declaration : public Statement {
@@ -243,6 +279,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 };
 
@@ -299,6 +336,7 @@ public:
     const Expression* argument() const { return m_argument; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -320,6 +358,7 @@ public:
     const Statement* alternate() const { return m_alternate; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -341,6 +380,7 @@ public:
     const Statement& body() const { return *m_body; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -361,6 +401,7 @@ public:
     const Statement& body() const { return *m_body; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -405,6 +446,7 @@ public:
     const Statement& body() const { return *m_body; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -496,6 +538,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -521,6 +564,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -549,6 +593,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -567,6 +612,7 @@ public:
 
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
 private:
     NonnullRefPtrVector<Expression> m_expressions;
@@ -589,6 +635,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -604,6 +651,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -635,6 +683,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     StringView value() const { return m_value; }
@@ -653,6 +702,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 };
 
@@ -687,11 +737,15 @@ public:
     const FlyString& string() const { return m_string; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
     virtual Reference to_reference(Interpreter&, GlobalObject&) const override;
 
+    VariableCache& variable_cache() const { return m_variable_cache; }
+
 private:
     FlyString m_string;
+    mutable VariableCache m_variable_cache;
 };
 
 class ClassMethod final : public ASTNode {
@@ -768,6 +822,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -811,9 +866,12 @@ public:
         , m_callee(move(callee))
         , m_arguments(move(arguments))
     {
+        for (auto& argument : m_arguments)
+            m_has_spread_arguments |= argument.is_spread;
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -823,8 +881,11 @@ private:
     };
     ThisAndCallee compute_this_and_callee(Interpreter&, GlobalObject&) const;
 
+    static constexpr size_t max_arguments_on_stack = 8;
+
     NonnullRefPtr<Expression> m_callee;
     const Vector<Argument> m_arguments;
+    bool m_has_spread_arguments { false };
 };
 
 class NewExpression final : public CallExpression {
@@ -865,12 +926,14 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
     AssignmentOp m_op;
     NonnullRefPtr<Expression> m_lhs;
     NonnullRefPtr<Expression> m_rhs;
+    mutable PropertyCache m_cache;
 };
 
 enum class UpdateOp {
@@ -889,6 +952,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
 private:
@@ -941,6 +1005,7 @@ public:
     DeclarationKind declaration_kind() const { return m_declaration_kind; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
 
     const NonnullRefPtrVector<VariableDeclarator>& declarations() const { return m_declarations; }
@@ -1000,7 +1065,15 @@ public:
     virtual void dump(int indent) const override;
 
 private:
+    bool has_only_plain_keys() const;
+
     NonnullRefPtrVector<ObjectProperty> m_properties;
+
+    // A literal with nothing but plain string keys makes objects that go through the same transitions every time, so
+    // the shape the first one ended up with is where the ones after it can start. That shape is kept alive by the
+    // transitions from the empty object shape of its realm, which is how we tell whether it's still the right one.
+    mutable Shape* m_cached_shape { nullptr };
+    mutable u64 m_cached_shape_root_id { 0 };
 };
 
 class ArrayExpression final : public Expression {
@@ -1074,6 +1147,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
     virtual void dump(int indent) const override;
     virtual Reference to_reference(Interpreter&, GlobalObject&) const override;
 
@@ -1089,6 +1163,7 @@ private:
     NonnullRefPtr<Expression> m_object;
     NonnullRefPtr<Expression> m_property;
     bool m_computed { false };
+    mutable PropertyCache m_cache;
 };
 
 class MetaProperty final : public Expression {
@@ -1123,6 +1198,7 @@ public:
 
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
 private:
     NonnullRefPtr<Expression> m_test;
@@ -1142,12 +1218,15 @@ public:
     const FlyString& parameter() const { return m_parameter; }
     const BlockStatement& body() const { return m_body; }
 
+    NonnullRefPtr<EnvironmentLayout> environment_layout() const;
+
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
 
 private:
     FlyString m_parameter;
     NonnullRefPtr<BlockStatement> m_body;
+    mutable RefPtr<EnvironmentLayout> m_environment_layout;
 };
 
 class TryStatement final : public Statement {
@@ -1185,6 +1264,7 @@ public:
 
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
 private:
     NonnullRefPtr<Expression> m_argument;
@@ -1236,6 +1316,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
     const FlyString& target_label() const { return m_target_label; }
 
@@ -1252,6 +1333,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 
     const FlyString& target_label() const { return m_target_label; }
 
@@ -1267,6 +1349,7 @@ public:
     }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual Optional<Bytecode::Register> generate_bytecode(Bytecode::Generator&) const override;
 };
 
 }
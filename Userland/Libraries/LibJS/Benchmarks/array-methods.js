@@ -0,0 +1,18 @@
+// The higher order Array.prototype methods, and sorting.
+const numbers = [];
+for (let i = 0; i < 5000; ++i) numbers.push((i * 7919) % 5003);
+
+function benchmark() {
+    const doubled = numbers.map(x => x * 2);
+    const even = doubled.filter(x => x % 4 === 0);
+    const sum = even.reduce((a, b) => a + b, 0);
+    const found = numbers.findIndex(x => x === 4999);
+    const anyNegative = numbers.some(x => x < 0);
+    const sorted = numbers.slice().sort((a, b) => a - b);
+    let count = 0;
+    numbers.forEach(x => {
+        if (x > 2500) ++count;
+    });
+
+    if (sum <= 0 || found < 0 || anyNegative || sorted[0] > sorted[1] || count === 0) throw new Error("Wrong result");
+}
@@ -0,0 +1,45 @@
+// Encoding and decoding base64 by hand, which is mostly string indexing and bit twiddling.
+const alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const lookup = {};
+for (let i = 0; i < alphabet.length; ++i) lookup[alphabet[i]] = i;
+
+function encode(input) {
+    let output = "";
+    let i = 0;
+    for (; i + 2 < input.length; i += 3) {
+        const n = (input.charCodeAt(i) << 16) | (input.charCodeAt(i + 1) << 8) | input.charCodeAt(i + 2);
+        output += alphabet[(n >> 18) & 63] + alphabet[(n >> 12) & 63] + alphabet[(n >> 6) & 63] + alphabet[n & 63];
+    }
+    if (i < input.length) {
+        const second = i + 1 < input.length ? input.charCodeAt(i + 1) : 0;
+        const n = (input.charCodeAt(i) << 16) | (second << 8);
+        output += alphabet[(n >> 18) & 63] + alphabet[(n >> 12) & 63];
+        output += i + 1 < input.length ? alphabet[(n >> 6) & 63] : "=";
+        output += "=";
+    }
+    return output;
+}
+
+function decode(input) {
+    let output = "";
+    for (let i = 0; i < input.length; i += 4) {
+        const n =
+            (lookup[input[i]] << 18) |
+            (lookup[input[i + 1]] << 12) |
+            ((lookup[input[i + 2]] || 0) << 6) |
+            (lookup[input[i + 3]] || 0);
+        output += String.fromCharCode((n >> 16) & 255);
+        if (input[i + 2] !== "=") output += String.fromCharCode((n >> 8) & 255);
+        if (input[i + 3] !== "=") output += String.fromCharCode(n & 255);
+    }
+    return output;
+}
+
+let text = "";
+for (let i = 0; i < 2000; ++i) text += String.fromCharCode(32 + (i % 95));
+
+function benchmark() {
+    const encoded = encode(text);
+    const decoded = decode(encoded);
+    if (decoded !== text) throw new Error("Round trip failed");
+}
@@ -0,0 +1,29 @@
+// Creating closures, and calling them with variables that live in the scopes they closed over.
+function makeCounter() {
+    let count = 0;
+    return {
+        increment: () => ++count,
+        get: () => count,
+    };
+}
+
+function compose(f, g) {
+    return x => f(g(x));
+}
+
+function benchmark() {
+    let total = 0;
+    for (let i = 0; i < 2000; ++i) {
+        const counter = makeCounter();
+        for (let j = 0; j < 10; ++j) counter.increment();
+        total += counter.get();
+    }
+
+    const addOne = x => x + 1;
+    const double = x => x * 2;
+    let f = addOne;
+    for (let i = 0; i < 20; ++i) f = compose(i % 2 ? addOne : double, f);
+    for (let i = 0; i < 1000; ++i) total += f(i);
+
+    if (total !== 513555000) throw new Error("Wrong total " + total);
+}
@@ -0,0 +1,81 @@
+// The MD5 hash function, which is all 32-bit integer arithmetic.
+function add32(a, b) {
+    return (a + b) | 0;
+}
+
+function rotateLeft(x, n) {
+    return (x << n) | (x >>> (32 - n));
+}
+
+const shifts = [7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21];
+const constants = [];
+for (let i = 0; i < 64; ++i) constants.push((Math.abs(Math.sin(i + 1)) * 4294967296) | 0);
+
+function md5(message) {
+    const bytes = [];
+    for (let i = 0; i < message.length; ++i) bytes.push(message.charCodeAt(i) & 255);
+    const bitLength = bytes.length * 8;
+    bytes.push(0x80);
+    while (bytes.length % 64 !== 56) bytes.push(0);
+    for (let i = 0; i < 8; ++i) bytes.push(i < 4 ? (bitLength >>> (i * 8)) & 255 : 0);
+
+    let a0 = 0x67452301;
+    let b0 = 0xefcdab89 | 0;
+    let c0 = 0x98badcfe | 0;
+    let d0 = 0x10325476;
+    const words = new Array(16);
+    for (let chunk = 0; chunk < bytes.length; chunk += 64) {
+        for (let i = 0; i < 16; ++i) {
+            const j = chunk + i * 4;
+            words[i] = bytes[j] | (bytes[j + 1] << 8) | (bytes[j + 2] << 16) | (bytes[j + 3] << 24);
+        }
+        let a = a0;
+        let b = b0;
+        let c = c0;
+        let d = d0;
+        for (let i = 0; i < 64; ++i) {
+            let f;
+            let g;
+            if (i < 16) {
+                f = (b & c) | (~b & d);
+                g = i;
+            } else if (i < 32) {
+                f = (d & b) | (~d & c);
+                g = (5 * i + 1) % 16;
+            } else if (i < 48) {
+                f = b ^ c ^ d;
+                g = (3 * i + 5) % 16;
+            } else {
+                f = c ^ (b | ~d);
+                g = (7 * i) % 16;
+            }
+            const temp = d;
+            d = c;
+            c = b;
+            b = add32(b, rotateLeft(add32(add32(a, f), add32(constants[i], words[g])), shifts[i]));
+            a = temp;
+        }
+        a0 = add32(a0, a);
+        b0 = add32(b0, b);
+        c0 = add32(c0, c);
+        d0 = add32(d0, d);
+    }
+
+    let hex = "";
+    for (const word of [a0, b0, c0, d0]) {
+        for (let i = 0; i < 4; ++i) {
+            const byte = (word >>> (i * 8)) & 255;
+            hex += (byte < 16 ? "0" : "") + byte.toString(16);
+        }
+    }
+    return hex;
+}
+
+let message = "";
+for (let i = 0; i < 50; ++i) message += "The quick brown fox jumps over the lazy dog";
+
+function benchmark() {
+    if (md5("The quick brown fox jumps over the lazy dog") !== "9e107d9d372bb6826bd81d3542a419d6")
+        throw new Error("Wrong hash");
+    md5(message);
+}
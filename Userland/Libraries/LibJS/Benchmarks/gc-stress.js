@@ -0,0 +1,24 @@
+// Lots of short lived objects, with some that survive, so the collector has work to do in both directions.
+function TreeNode(left, right) {
+    this.left = left;
+    this.right = right;
+}
+
+function makeTree(depth) {
+    if (depth === 0) return new TreeNode(null, null);
+    return new TreeNode(makeTree(depth - 1), makeTree(depth - 1));
+}
+
+function countNodes(node) {
+    if (node.left === null) return 1;
+    return 1 + countNodes(node.left) + countNodes(node.right);
+}
+
+const longLived = makeTree(12);
+
+function benchmark() {
+    let total = 0;
+    for (let i = 0; i < 20; ++i) total += countNodes(makeTree(9));
+    for (let i = 0; i < 20000; ++i) total += [i, { value: i }].length;
+    if (countNodes(longLived) !== 8191 || total !== 20 * 1023 + 40000) throw new Error("Wrong count " + total);
+}
@@ -0,0 +1,22 @@
+// Round trips of a document with nested objects and arrays through JSON.stringify() and JSON.parse().
+const document = { items: [] };
+for (let i = 0; i < 500; ++i) {
+    document.items.push({
+        id: i,
+        name: "Item number " + i,
+        price: i * 1.25,
+        tags: ["a", "b", "c"],
+        available: i % 3 !== 0,
+        dimensions: { width: i, height: i * 2, depth: null },
+    });
+}
+
+function benchmark() {
+    let total = 0;
+    for (let i = 0; i < 5; ++i) {
+        const string = JSON.stringify(document);
+        const parsed = JSON.parse(string);
+        total += parsed.items.length;
+    }
+    if (total !== 2500) throw new Error("Wrong total " + total);
+}
@@ -0,0 +1,88 @@
+// A floating point heavy simulation of the planets, after the one in the Computer Language Benchmarks Game.
+const PI = Math.PI;
+const SOLAR_MASS = 4 * PI * PI;
+const DAYS_PER_YEAR = 365.24;
+
+function Body(x, y, z, vx, vy, vz, mass) {
+    this.x = x;
+    this.y = y;
+    this.z = z;
+    this.vx = vx;
+    this.vy = vy;
+    this.vz = vz;
+    this.mass = mass;
+}
+
+function createBodies() {
+    return [
+        new Body(0, 0, 0, 0, 0, 0, SOLAR_MASS),
+        new Body(4.84143144246472090e00, -1.16032004402742839e00, -1.03622044471123109e-01, 1.66007664274403694e-03 * DAYS_PER_YEAR, 7.69901118419740425e-03 * DAYS_PER_YEAR, -6.90460016972063023e-05 * DAYS_PER_YEAR, 9.54791938424326609e-04 * SOLAR_MASS),
+        new Body(8.34336671824457987e00, 4.12479856412430479e00, -4.03523417114321381e-01, -2.76742510726862411e-03 * DAYS_PER_YEAR, 4.99852801234917238e-03 * DAYS_PER_YEAR, 2.30417297573763929e-05 * DAYS_PER_YEAR, 2.85885980666130812e-04 * SOLAR_MASS),
+        new Body(1.28943695621391310e01, -1.51111514016986312e01, -2.23307578892655734e-01, 2.96460137564761618e-03 * DAYS_PER_YEAR, 2.37847173959480950e-03 * DAYS_PER_YEAR, -2.96589568540237556e-05 * DAYS_PER_YEAR, 4.36624404335156298e-05 * SOLAR_MASS),
+        new Body(1.53796971148509165e01, -2.59193146099879641e01, 1.79258772950371181e-01, 2.68067772490389322e-03 * DAYS_PER_YEAR, 1.62824170038242295e-03 * DAYS_PER_YEAR, -9.51592254519715870e-05 * DAYS_PER_YEAR, 5.15138902046611451e-05 * SOLAR_MASS),
+    ];
+}
+
+function offsetMomentum(bodies) {
+    let px = 0;
+    let py = 0;
+    let pz = 0;
+    for (const body of bodies) {
+        px += body.vx * body.mass;
+        py += body.vy * body.mass;
+        pz += body.vz * body.mass;
+    }
+    bodies[0].vx = -px / SOLAR_MASS;
+    bodies[0].vy = -py / SOLAR_MASS;
+    bodies[0].vz = -pz / SOLAR_MASS;
+}
+
+function advance(bodies, dt) {
+    const count = bodies.length;
+    for (let i = 0; i < count; ++i) {
+        const a = bodies[i];
+        for (let j = i + 1; j < count; ++j) {
+            const b = bodies[j];
+            const dx = a.x - b.x;
+            const dy = a.y - b.y;
+            const dz = a.z - b.z;
+            const distanceSquared = dx * dx + dy * dy + dz * dz;
+            const magnitude = dt / (distanceSquared * Math.sqrt(distanceSquared));
+            a.vx -= dx * b.mass * magnitude;
+            a.vy -= dy * b.mass * magnitude;
+            a.vz -= dz * b.mass * magnitude;
+            b.vx += dx * a.mass * magnitude;
+            b.vy += dy * a.mass * magnitude;
+            b.vz += dz * a.mass * magnitude;
+        }
+    }
+    for (const body of bodies) {
+        body.x += dt * body.vx;
+        body.y += dt * body.vy;
+        body.z += dt * body.vz;
+    }
+}
+
+function energy(bodies) {
+    let e = 0;
+    for (let i = 0; i < bodies.length; ++i) {
+        const a = bodies[i];
+        e += 0.5 * a.mass * (a.vx * a.vx + a.vy * a.vy + a.vz * a.vz);
+        for (let j = i + 1; j < bodies.length; ++j) {
+            const b = bodies[j];
+            const dx = a.x - b.x;
+            const dy = a.y - b.y;
+            const dz = a.z - b.z;
+            e -= (a.mass * b.mass) / Math.sqrt(dx * dx + dy * dy + dz * dz);
+        }
+    }
+    return e;
+}
+
+function benchmark() {
+    const bodies = createBodies();
+    offsetMomentum(bodies);
+    for (let i = 0; i < 1000; ++i) advance(bodies, 0.01);
+    const e = energy(bodies);
+    if (Math.abs(e - -0.169087605) > 1e-6) throw new Error("Wrong energy " + e);
+}
@@ -0,0 +1,30 @@
+// Long chains of promise reactions, many promises settling at once, and thenables that have to be resolved through a job.
+// The jobs only run after benchmark() returns, so every call checks what the previous one ended up with.
+let lastTotal = null;
+
+function benchmark() {
+    if (lastTotal !== null && lastTotal !== 24000) throw new Error("Wrong total " + lastTotal);
+    lastTotal = 0;
+
+    let chain = Promise.resolve(0);
+    for (let i = 0; i < 5000; ++i) chain = chain.then(value => value + 1);
+    chain.then(value => {
+        lastTotal += value;
+    });
+
+    const resolvers = [];
+    for (let i = 0; i < 5000; ++i) {
+        new Promise(resolve => resolvers.push(resolve)).then(value => {
+            lastTotal += value;
+        });
+    }
+    for (let i = 0; i < resolvers.length; ++i) resolvers[i](3);
+
+    for (let i = 0; i < 2000; ++i) {
+        Promise.resolve()
+            .then(() => ({ then: resolve => resolve(2) }))
+            .then(value => {
+                lastTotal += value;
+            });
+    }
+}
@@ -0,0 +1,25 @@
+// Gets and puts on objects that all share the same shape, on arrays, and on a prototype chain.
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+
+Point.prototype.lengthSquared = function () {
+    return this.x * this.x + this.y * this.y;
+};
+
+const points = [];
+for (let i = 0; i < 1000; ++i) points.push(new Point(i, i + 1));
+
+function benchmark() {
+    let sum = 0;
+    for (let round = 0; round < 50; ++round) {
+        for (let i = 0; i < points.length; ++i) {
+            const point = points[i];
+            point.x = point.y;
+            point.y = point.x + 1;
+            sum += point.lengthSquared();
+        }
+    }
+    if (sum <= 0) throw new Error("Wrong sum " + sum);
+}
@@ -0,0 +1,24 @@
+// Searching a text with a few typical patterns, and replacing matches.
+let text = "";
+for (let i = 0; i < 1000; ++i)
+    text += `Line ${i}: user${i}@example.com visited https://serenityos.org/page/${i} on 2021-05-${(i % 28) + 1}.\n`;
+
+function countMatches(regex) {
+    let count = 0;
+    regex.lastIndex = 0;
+    while (regex.exec(text) !== null) ++count;
+    return count;
+}
+
+function benchmark() {
+    const emails = countMatches(/[a-z0-9]+@[a-z]+\.[a-z]+/g);
+    const urls = countMatches(/https?:\/\/[^\s]+/g);
+    const dates = countMatches(/\d{4}-\d{2}-\d{1,2}/g);
+    const lines = countMatches(/Line (\d+):/g);
+    const replaced = text.replace(/user(\d+)/g, (match, number) => "member" + number);
+    const caseInsensitive = /SERENITYOS/i.test(text);
+
+    if (emails !== 1000 || urls !== 1000 || dates !== 1000 || lines !== 1000 || !caseInsensitive)
+        throw new Error("Wrong matches");
+    if (replaced.indexOf("member999") < 0) throw new Error("Wrong replacement");
+}
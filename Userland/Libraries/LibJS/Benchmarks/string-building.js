@@ -0,0 +1,18 @@
+// Building strings piece by piece, with concatenation, template literals and join().
+function benchmark() {
+    let concatenated = "";
+    for (let i = 0; i < 5000; ++i) concatenated += i + ",";
+
+    let templated = "";
+    for (let i = 0; i < 2000; ++i) templated += `<li id="item${i}">${i * 2}</li>`;
+
+    const parts = [];
+    for (let i = 0; i < 5000; ++i) parts.push(String.fromCharCode(97 + (i % 26)));
+    const joined = parts.join("");
+
+    const words = concatenated.split(",");
+    const upper = joined.toUpperCase();
+
+    if (words.length !== 5001 || upper.length !== 5000 || templated.indexOf("item1999") < 0)
+        throw new Error("Wrong strings");
+}
@@ -0,0 +1,649 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Function.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Register.h>
+
+namespace JS {
+
+// Statements don't leave a value in a register, and for expressions that are only evaluated for their side effects
+// we don't care about it.
+static void generate_statement(Bytecode::Generator& generator, const ASTNode& node)
+{
+    [[maybe_unused]] auto result = node.generate_bytecode(generator);
+}
+
+Optional<Bytecode::Register> ASTNode::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.set_unsupported(*this);
+    return {};
+}
+
+Optional<Bytecode::Register> Expression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    return generator.emit_evaluate_ast(*this);
+}
+
+Optional<Bytecode::Register> ScopeNode::generate_bytecode(Bytecode::Generator& generator) const
+{
+    bool is_labelled = !label().is_null();
+    if (is_labelled)
+        generator.begin_breakable_scope(label(), false);
+
+    generator.generate_lexical_scope(*this, [&] {
+        for (auto& child : children()) {
+            generate_statement(generator, child);
+            if (generator.is_unsupported())
+                return;
+        }
+    });
+    if (generator.is_unsupported())
+        return {};
+
+    if (is_labelled)
+        generator.end_breakable_scope({}, generator.make_label());
+    return {};
+}
+
+Optional<Bytecode::Register> ExpressionStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto value = m_expression->generate_bytecode(generator);
+    // Nothing can observe the last value of a statement inside a function.
+    if (!generator.is_generating_function())
+        generator.emit<Bytecode::Op::SetLastValue>(*value);
+    return {};
+}
+
+Optional<Bytecode::Register> ReturnStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    Optional<Bytecode::Register> value;
+    if (m_argument) {
+        value = m_argument->generate_bytecode(generator);
+    } else {
+        value = generator.allocate_register();
+        generator.emit<Bytecode::Op::LoadImmediate>(*value, js_undefined());
+    }
+    generator.emit_return(*this, *value);
+    return {};
+}
+
+Optional<Bytecode::Register> FunctionDeclaration::generate_bytecode(Bytecode::Generator&) const
+{
+    // Function declarations are hoisted when their scope is entered.
+    return {};
+}
+
+Optional<Bytecode::Register> ClassDeclaration::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_evaluate_ast(*this);
+    return {};
+}
+
+Optional<Bytecode::Register> ThrowStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_evaluate_ast(*this);
+    return {};
+}
+
+Optional<Bytecode::Register> DebuggerStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_evaluate_ast(*this);
+    return {};
+}
+
+Optional<Bytecode::Register> VariableDeclaration::generate_bytecode(Bytecode::Generator& generator) const
+{
+    for (auto& declarator : m_declarations) {
+        // The AST interpreter names anonymous classes after the variable they're assigned to.
+        if (declarator.init() && is<ClassExpression>(*declarator.init())) {
+            generator.emit_evaluate_ast(*this);
+            return {};
+        }
+    }
+
+    for (auto& declarator : m_declarations) {
+        auto* init = declarator.init();
+        if (!init)
+            continue;
+        auto value = init->generate_bytecode(generator);
+        auto& name = declarator.id().string();
+        if (auto binding = generator.register_binding(name); binding.has_value())
+            generator.emit<Bytecode::Op::Move>(*binding, *value);
+        else
+            generator.emit<Bytecode::Op::SetVariable>(generator.intern_identifier(name), *value, true);
+    }
+    return {};
+}
+
+Optional<Bytecode::Register> IfStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto predicate = m_predicate->generate_bytecode(generator);
+    auto jump_to_alternate = generator.emit<Bytecode::Op::JumpIfFalse>(*predicate);
+    generate_statement(generator, *m_consequent);
+
+    if (!m_alternate) {
+        generator.link_jump(jump_to_alternate, generator.make_label());
+        return {};
+    }
+
+    auto jump_to_end = generator.emit<Bytecode::Op::Jump>();
+    generator.link_jump(jump_to_alternate, generator.make_label());
+    generate_statement(generator, *m_alternate);
+    generator.link_jump(jump_to_end, generator.make_label());
+    return {};
+}
+
+Optional<Bytecode::Register> WhileStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.begin_breakable_scope(m_label, true);
+    auto test_label = generator.make_label();
+    auto test = m_test->generate_bytecode(generator);
+    auto jump_to_end = generator.emit<Bytecode::Op::JumpIfFalse>(*test);
+    generate_statement(generator, *m_body);
+    generator.emit<Bytecode::Op::Jump>(test_label);
+    auto end_label = generator.make_label();
+    generator.link_jump(jump_to_end, end_label);
+    generator.end_breakable_scope(test_label, end_label);
+    return {};
+}
+
+Optional<Bytecode::Register> DoWhileStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.begin_breakable_scope(m_label, true);
+    auto body_label = generator.make_label();
+    generate_statement(generator, *m_body);
+    auto test_label = generator.make_label();
+    auto test = m_test->generate_bytecode(generator);
+    generator.emit<Bytecode::Op::JumpIfTrue>(*test, body_label);
+    generator.end_breakable_scope(test_label, generator.make_label());
+    return {};
+}
+
+Optional<Bytecode::Register> ForStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto generate_loop = [&] {
+        if (m_init) {
+            generate_statement(generator, *m_init);
+            if (generator.is_unsupported())
+                return;
+        }
+
+        generator.begin_breakable_scope(m_label, true);
+        auto test_label = generator.make_label();
+        Optional<size_t> jump_to_end;
+        if (m_test) {
+            auto test = m_test->generate_bytecode(generator);
+            jump_to_end = generator.emit<Bytecode::Op::JumpIfFalse>(*test);
+        }
+        generate_statement(generator, *m_body);
+        auto update_label = generator.make_label();
+        if (m_update)
+            generate_statement(generator, *m_update);
+        generator.emit<Bytecode::Op::Jump>(test_label);
+        auto end_label = generator.make_label();
+        if (jump_to_end.has_value())
+            generator.link_jump(jump_to_end.value(), end_label);
+        generator.end_breakable_scope(update_label, end_label);
+    };
+
+    if (!m_init || !is<VariableDeclaration>(*m_init) || static_cast<const VariableDeclaration&>(*m_init).declaration_kind() == DeclarationKind::Var) {
+        generate_loop();
+        return {};
+    }
+
+    // Like the AST interpreter, give let and const declarations one scope for the whole loop.
+    auto wrapper = create_ast_node<BlockStatement>(source_range());
+    NonnullRefPtrVector<VariableDeclaration> declarations;
+    declarations.append(*static_cast<const VariableDeclaration*>(m_init.ptr()));
+    wrapper->add_variables(declarations);
+    generator.retain_synthesized_scope(wrapper);
+    generator.generate_lexical_scope(*wrapper, generate_loop);
+    return {};
+}
+
+Optional<Bytecode::Register> BreakStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_break(*this, m_target_label);
+    return {};
+}
+
+Optional<Bytecode::Register> ContinueStatement::generate_bytecode(Bytecode::Generator& generator) const
+{
+    generator.emit_continue(*this, m_target_label);
+    return {};
+}
+
+Optional<Bytecode::Register> BinaryExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto lhs = m_lhs->generate_bytecode(generator);
+    auto rhs = m_rhs->generate_bytecode(generator);
+    auto dst = generator.allocate_register();
+
+    switch (m_op) {
+    case BinaryOp::Addition:
+        generator.emit<Bytecode::Op::Add>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::Subtraction:
+        generator.emit<Bytecode::Op::Sub>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::Multiplication:
+        generator.emit<Bytecode::Op::Mul>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::Division:
+        generator.emit<Bytecode::Op::Div>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::Modulo:
+        generator.emit<Bytecode::Op::Mod>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::Exponentiation:
+        generator.emit<Bytecode::Op::Exp>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::TypedEquals:
+        generator.emit<Bytecode::Op::TypedEquals>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::TypedInequals:
+        generator.emit<Bytecode::Op::TypedInequals>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::AbstractEquals:
+        generator.emit<Bytecode::Op::AbstractEquals>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::AbstractInequals:
+        generator.emit<Bytecode::Op::AbstractInequals>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::GreaterThan:
+        generator.emit<Bytecode::Op::GreaterThan>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::GreaterThanEquals:
+        generator.emit<Bytecode::Op::GreaterThanEquals>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::LessThan:
+        generator.emit<Bytecode::Op::LessThan>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::LessThanEquals:
+        generator.emit<Bytecode::Op::LessThanEquals>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::BitwiseAnd:
+        generator.emit<Bytecode::Op::BitwiseAnd>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::BitwiseOr:
+        generator.emit<Bytecode::Op::BitwiseOr>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::BitwiseXor:
+        generator.emit<Bytecode::Op::BitwiseXor>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::LeftShift:
+        generator.emit<Bytecode::Op::LeftShift>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::RightShift:
+        generator.emit<Bytecode::Op::RightShift>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::UnsignedRightShift:
+        generator.emit<Bytecode::Op::UnsignedRightShift>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::In:
+        generator.emit<Bytecode::Op::In>(dst, *lhs, *rhs);
+        break;
+    case BinaryOp::InstanceOf:
+        generator.emit<Bytecode::Op::InstanceOf>(dst, *lhs, *rhs);
+        break;
+    }
+    return dst;
+}
+
+// Evaluates lhs into dst, and then rhs as well, unless the operator short-circuits.
+static Bytecode::Register generate_short_circuit(Bytecode::Generator& generator, LogicalOp op, Bytecode::Register lhs, const AK::Function<Bytecode::Register()>& generate_rhs)
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::Move>(dst, lhs);
+
+    size_t jump_to_end = 0;
+    switch (op) {
+    case LogicalOp::And:
+        jump_to_end = generator.emit<Bytecode::Op::JumpIfFalse>(dst);
+        break;
+    case LogicalOp::Or:
+        jump_to_end = generator.emit<Bytecode::Op::JumpIfTrue>(dst);
+        break;
+    case LogicalOp::NullishCoalescing:
+        jump_to_end = generator.emit<Bytecode::Op::JumpIfNotNullish>(dst);
+        break;
+    }
+
+    auto rhs = generate_rhs();
+    generator.emit<Bytecode::Op::Move>(dst, rhs);
+    generator.link_jump(jump_to_end, generator.make_label());
+    return dst;
+}
+
+Optional<Bytecode::Register> LogicalExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto lhs = m_lhs->generate_bytecode(generator);
+    return generate_short_circuit(generator, m_op, *lhs, [&] {
+        return *m_rhs->generate_bytecode(generator);
+    });
+}
+
+Optional<Bytecode::Register> UnaryExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    // These need a reference rather than a value, unless it's a variable that lives in a register.
+    if (m_op == UnaryOp::Typeof && is<Identifier>(*m_lhs)) {
+        if (auto binding = generator.register_binding(static_cast<const Identifier&>(*m_lhs).string()); binding.has_value()) {
+            auto dst = generator.allocate_register();
+            generator.emit<Bytecode::Op::Typeof>(dst, *binding);
+            return dst;
+        }
+    }
+    if (m_op == UnaryOp::Delete || (m_op == UnaryOp::Typeof && is<Identifier>(*m_lhs)))
+        return Expression::generate_bytecode(generator);
+
+    auto src = m_lhs->generate_bytecode(generator);
+    auto dst = generator.allocate_register();
+
+    switch (m_op) {
+    case UnaryOp::BitwiseNot:
+        generator.emit<Bytecode::Op::BitwiseNot>(dst, *src);
+        break;
+    case UnaryOp::Not:
+        generator.emit<Bytecode::Op::Not>(dst, *src);
+        break;
+    case UnaryOp::Plus:
+        generator.emit<Bytecode::Op::UnaryPlus>(dst, *src);
+        break;
+    case UnaryOp::Minus:
+        generator.emit<Bytecode::Op::UnaryMinus>(dst, *src);
+        break;
+    case UnaryOp::Typeof:
+        generator.emit<Bytecode::Op::Typeof>(dst, *src);
+        break;
+    case UnaryOp::Void:
+        generator.emit<Bytecode::Op::LoadImmediate>(dst, js_undefined());
+        break;
+    case UnaryOp::Delete:
+        VERIFY_NOT_REACHED();
+    }
+    return dst;
+}
+
+Optional<Bytecode::Register> SequenceExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    Optional<Bytecode::Register> last_value;
+    for (auto& expression : m_expressions)
+        last_value = expression.generate_bytecode(generator);
+    return last_value;
+}
+
+Optional<Bytecode::Register> ConditionalExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    auto test = m_test->generate_bytecode(generator);
+    auto jump_to_alternate = generator.emit<Bytecode::Op::JumpIfFalse>(*test);
+
+    auto consequent = m_consequent->generate_bytecode(generator);
+    generator.emit<Bytecode::Op::Move>(dst, *consequent);
+    auto jump_to_end = generator.emit<Bytecode::Op::Jump>();
+
+    generator.link_jump(jump_to_alternate, generator.make_label());
+    auto alternate = m_alternate->generate_bytecode(generator);
+    generator.emit<Bytecode::Op::Move>(dst, *alternate);
+
+    generator.link_jump(jump_to_end, generator.make_label());
+    return dst;
+}
+
+Optional<Bytecode::Register> BooleanLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::LoadImmediate>(dst, Value(m_value));
+    return dst;
+}
+
+Optional<Bytecode::Register> NumericLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::LoadImmediate>(dst, m_value);
+    return dst;
+}
+
+Optional<Bytecode::Register> NullLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::LoadImmediate>(dst, js_null());
+    return dst;
+}
+
+Optional<Bytecode::Register> StringLiteral::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    generator.emit<Bytecode::Op::NewString>(dst, generator.intern_string(m_value));
+    return dst;
+}
+
+Optional<Bytecode::Register> Identifier::generate_bytecode(Bytecode::Generator& generator) const
+{
+    auto dst = generator.allocate_register();
+    // Copy the variable, since it may well be assigned to before the value is used.
+    if (auto binding = generator.register_binding(m_string); binding.has_value())
+        generator.emit<Bytecode::Op::Move>(dst, *binding);
+    else
+        generator.emit<Bytecode::Op::GetVariable>(dst, generator.intern_identifier(m_string));
+    return dst;
+}
+
+Optional<Bytecode::Register> MemberExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    if (is<SuperExpression>(*m_object))
+        return Expression::generate_bytecode(generator);
+
+    auto base = m_object->generate_bytecode(generator);
+    auto dst = generator.allocate_register();
+    if (is_computed()) {
+        auto property = m_property->generate_bytecode(generator);
+        generator.emit<Bytecode::Op::GetByValue>(dst, *base, *property);
+    } else {
+        generator.emit<Bytecode::Op::GetById>(dst, *base, generator.intern_identifier(static_cast<const Identifier&>(*m_property).string()));
+    }
+    return dst;
+}
+
+// Something that can be both read and assigned to: a variable, or a property of an already evaluated base.
+struct AssignmentTarget {
+    AK::Function<void(Bytecode::Register)> load;
+    AK::Function<void(Bytecode::Register)> store;
+};
+
+static Optional<AssignmentTarget> generate_assignment_target(Bytecode::Generator& generator, const Expression& expression)
+{
+    if (is<Identifier>(expression)) {
+        auto& name = static_cast<const Identifier&>(expression).string();
+        if (auto binding = generator.register_binding(name); binding.has_value()) {
+            auto reg = *binding;
+            // Leave assigning to a constant to the environment, which knows how to complain about it.
+            if (generator.is_const_binding(name))
+                generator.invalidate_register_bindings();
+            return AssignmentTarget {
+                [&generator, reg](auto dst) { generator.emit<Bytecode::Op::Move>(dst, reg); },
+                [&generator, reg](auto src) { generator.emit<Bytecode::Op::Move>(reg, src); },
+            };
+        }
+        auto identifier = generator.intern_identifier(name);
+        return AssignmentTarget {
+            [&generator, identifier](auto dst) { generator.emit<Bytecode::Op::GetVariable>(dst, identifier); },
+            [&generator, identifier](auto src) { generator.emit<Bytecode::Op::SetVariable>(identifier, src); },
+        };
+    }
+
+    if (!is<MemberExpression>(expression))
+        return {};
+    auto& member_expression = static_cast<const MemberExpression&>(expression);
+    if (is<SuperExpression>(member_expression.object()))
+        return {};
+
+    auto base = *member_expression.object().generate_bytecode(generator);
+    if (member_expression.is_computed()) {
+        auto property = *member_expression.property().generate_bytecode(generator);
+        return AssignmentTarget {
+            [&generator, base, property](auto dst) { generator.emit<Bytecode::Op::GetByValue>(dst, base, property); },
+            [&generator, base, property](auto src) { generator.emit<Bytecode::Op::PutByValue>(base, property, src); },
+        };
+    }
+
+    auto property = generator.intern_identifier(static_cast<const Identifier&>(member_expression.property()).string());
+    return AssignmentTarget {
+        [&generator, base, property](auto dst) { generator.emit<Bytecode::Op::GetById>(dst, base, property); },
+        [&generator, base, property](auto src) { generator.emit<Bytecode::Op::PutById>(base, property, src); },
+    };
+}
+
+static bool can_generate_assignment_target(const Expression& expression)
+{
+    if (is<Identifier>(expression))
+        return true;
+    return is<MemberExpression>(expression) && !is<SuperExpression>(static_cast<const MemberExpression&>(expression).object());
+}
+
+Optional<Bytecode::Register> AssignmentExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    if (!can_generate_assignment_target(*m_lhs))
+        return Expression::generate_bytecode(generator);
+
+    auto target = generate_assignment_target(generator, *m_lhs);
+
+    if (m_op == AssignmentOp::Assignment) {
+        auto value = m_rhs->generate_bytecode(generator);
+        target->store(*value);
+        return value;
+    }
+
+    auto lhs = generator.allocate_register();
+    target->load(lhs);
+
+    if (m_op == AssignmentOp::AndAssignment || m_op == AssignmentOp::OrAssignment || m_op == AssignmentOp::NullishAssignment) {
+        auto logical_op = m_op == AssignmentOp::AndAssignment ? LogicalOp::And : (m_op == AssignmentOp::OrAssignment ? LogicalOp::Or : LogicalOp::NullishCoalescing);
+        return generate_short_circuit(generator, logical_op, lhs, [&] {
+            auto rhs = *m_rhs->generate_bytecode(generator);
+            target->store(rhs);
+            return rhs;
+        });
+    }
+
+    auto rhs = m_rhs->generate_bytecode(generator);
+    auto dst = generator.allocate_register();
+
+    switch (m_op) {
+    case AssignmentOp::AdditionAssignment:
+        generator.emit<Bytecode::Op::Add>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::SubtractionAssignment:
+        generator.emit<Bytecode::Op::Sub>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::MultiplicationAssignment:
+        generator.emit<Bytecode::Op::Mul>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::DivisionAssignment:
+        generator.emit<Bytecode::Op::Div>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::ModuloAssignment:
+        generator.emit<Bytecode::Op::Mod>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::ExponentiationAssignment:
+        generator.emit<Bytecode::Op::Exp>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::BitwiseAndAssignment:
+        generator.emit<Bytecode::Op::BitwiseAnd>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::BitwiseOrAssignment:
+        generator.emit<Bytecode::Op::BitwiseOr>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::BitwiseXorAssignment:
+        generator.emit<Bytecode::Op::BitwiseXor>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::LeftShiftAssignment:
+        generator.emit<Bytecode::Op::LeftShift>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::RightShiftAssignment:
+        generator.emit<Bytecode::Op::RightShift>(dst, lhs, *rhs);
+        break;
+    case AssignmentOp::UnsignedRightShiftAssignment:
+        generator.emit<Bytecode::Op::UnsignedRightShift>(dst, lhs, *rhs);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+
+    target->store(dst);
+    return dst;
+}
+
+Optional<Bytecode::Register> UpdateExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    if (!can_generate_assignment_target(*m_argument))
+        return Expression::generate_bytecode(generator);
+
+    auto target = generate_assignment_target(generator, *m_argument);
+    auto old_value = generator.allocate_register();
+    target->load(old_value);
+    generator.emit<Bytecode::Op::ToNumeric>(old_value, old_value);
+
+    auto new_value = generator.allocate_register();
+    if (m_op == UpdateOp::Increment)
+        generator.emit<Bytecode::Op::Increment>(new_value, old_value);
+    else
+        generator.emit<Bytecode::Op::Decrement>(new_value, old_value);
+    target->store(new_value);
+
+    return m_prefixed ? new_value : old_value;
+}
+
+Optional<Bytecode::Register> CallExpression::generate_bytecode(Bytecode::Generator& generator) const
+{
+    if (is<SuperExpression>(*m_callee))
+        return Expression::generate_bytecode(generator);
+    for (auto& argument : m_arguments) {
+        if (argument.is_spread)
+            return Expression::generate_bytecode(generator);
+    }
+
+    bool is_construct = is<NewExpression>(*this);
+    Bytecode::Register callee { 0 };
+    Optional<Bytecode::Register> this_value;
+    if (!is_construct && is<MemberExpression>(*m_callee)) {
+        auto& member_expression = static_cast<const MemberExpression&>(*m_callee);
+        if (is<SuperExpression>(member_expression.object()))
+            return Expression::generate_bytecode(generator);
+        this_value = member_expression.object().generate_bytecode(generator);
+        callee = generator.allocate_register();
+        if (member_expression.is_computed()) {
+            auto property = member_expression.property().generate_bytecode(generator);
+            generator.emit<Bytecode::Op::GetByValue>(callee, *this_value, *property);
+        } else {
+            generator.emit<Bytecode::Op::GetById>(callee, *this_value, generator.intern_identifier(static_cast<const Identifier&>(member_expression.property()).string()));
+        }
+    } else {
+        callee = *m_callee->generate_bytecode(generator);
+    }
+
+    Vector<Bytecode::Register> arguments;
+    arguments.ensure_capacity(m_arguments.size());
+    for (auto& argument : m_arguments)
+        arguments.append(*argument.value->generate_bytecode(generator));
+
+    // Keep the error messages for calling something that isn't a function the same as the AST interpreter's.
+    Optional<u32> expression_string;
+    if (is<Identifier>(*m_callee))
+        expression_string = generator.intern_string(static_cast<const Identifier&>(*m_callee).string());
+    else if (is<MemberExpression>(*m_callee))
+        expression_string = generator.intern_string(static_cast<const MemberExpression&>(*m_callee).to_string_approximation());
+
+    auto dst = generator.allocate_register();
+    auto call_type = is_construct ? Bytecode::Op::Call::CallType::Construct : Bytecode::Op::Call::CallType::Call;
+    generator.emit_with_extra_register_slots<Bytecode::Op::Call>(arguments.size(), call_type, dst, callee, this_value, expression_string, arguments.span());
+    return dst;
+}
+
+}
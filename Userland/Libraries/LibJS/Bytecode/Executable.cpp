@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+
+namespace JS::Bytecode {
+
+Executable::~Executable()
+{
+}
+
+const Program& Executable::program() const
+{
+    VERIFY(is<Program>(m_scope_node));
+    return static_cast<const Program&>(m_scope_node);
+}
+
+void Executable::dump() const
+{
+    outln("Executable: {} bytes, {} registers", m_bytecode.size(), m_register_count);
+    size_t address = 0;
+    while (address < m_bytecode.size()) {
+        auto& instruction = *reinterpret_cast<const Instruction*>(m_bytecode.data() + address);
+        outln("[{:4}] {}", address, instruction.to_string(*this));
+        address += instruction.length();
+    }
+}
+
+}
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// The compiled form of a program or a function body. The bytecode refers directly to nodes of the AST it was
+// generated from, so an Executable must not outlive them.
+class Executable {
+    AK_MAKE_NONCOPYABLE(Executable);
+    AK_MAKE_NONMOVABLE(Executable);
+
+public:
+    Executable(const ScopeNode& scope_node, Vector<u8> bytecode, Vector<String> strings, Vector<FlyString> identifiers, NonnullRefPtrVector<ScopeNode> synthesized_scopes, size_t register_count)
+        : m_scope_node(scope_node)
+        , m_bytecode(move(bytecode))
+        , m_strings(move(strings))
+        , m_identifiers(move(identifiers))
+        , m_synthesized_scopes(move(synthesized_scopes))
+        , m_register_count(register_count)
+    {
+    }
+
+    ~Executable();
+
+    const ScopeNode& scope_node() const { return m_scope_node; }
+    const Program& program() const;
+    ReadonlyBytes bytecode() const { return m_bytecode; }
+    size_t register_count() const { return m_register_count; }
+
+    const String& string(u32 index) const { return m_strings[index]; }
+    const FlyString& identifier(u32 index) const { return m_identifiers[index]; }
+
+    void dump() const;
+
+private:
+    const ScopeNode& m_scope_node;
+    Vector<u8> m_bytecode;
+    Vector<String> m_strings;
+    Vector<FlyString> m_identifiers;
+    // Scopes the generator made up, e.g. for the let declarations in a for statement, so the bytecode can refer to them.
+    NonnullRefPtrVector<ScopeNode> m_synthesized_scopes;
+    size_t m_register_count { 0 };
+};
+
+}
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Debug.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Generator.h>
+
+namespace JS::Bytecode {
+
+Generator::Generator()
+{
+}
+
+OwnPtr<Executable> Generator::generate(const Program& program)
+{
+    Generator generator;
+    [[maybe_unused]] auto result = program.generate_bytecode(generator);
+    if (generator.m_unsupported_node) {
+        dbgln_if(JS_BYTECODE_DEBUG, "Bytecode: Can't compile {} yet, leaving the program to the AST interpreter", generator.m_unsupported_node->class_name());
+        return {};
+    }
+    VERIFY(generator.m_scopes.is_empty());
+    VERIFY(generator.m_lexical_scopes.is_empty());
+    VERIFY(generator.m_breakable_scopes.is_empty());
+    return make<Executable>(program, move(generator.m_bytecode), move(generator.m_strings), move(generator.m_identifiers), move(generator.m_synthesized_scopes), generator.m_next_register);
+}
+
+OwnPtr<Executable> Generator::generate_function(const ScopeNode& body)
+{
+    Generator generator;
+    generator.m_function_body = &body;
+    [[maybe_unused]] auto result = body.generate_bytecode(generator);
+    if (generator.m_unsupported_node) {
+        dbgln_if(JS_BYTECODE_DEBUG, "Bytecode: Can't compile {} yet, leaving the function to the AST interpreter", generator.m_unsupported_node->class_name());
+        return {};
+    }
+    VERIFY(generator.m_scopes.is_empty());
+    VERIFY(generator.m_lexical_scopes.is_empty());
+    VERIFY(generator.m_breakable_scopes.is_empty());
+    return make<Executable>(body, move(generator.m_bytecode), move(generator.m_strings), move(generator.m_identifiers), move(generator.m_synthesized_scopes), generator.m_next_register);
+}
+
+Register Generator::allocate_register()
+{
+    return Register { m_next_register++ };
+}
+
+void Generator::link_jump(size_t jump_address, Label target)
+{
+    auto& instruction = *reinterpret_cast<Instruction*>(m_bytecode.data() + jump_address);
+    VERIFY(instruction.is_jump());
+    static_cast<Op::Jump&>(instruction).set_target(target);
+}
+
+u32 Generator::intern_string(const String& string)
+{
+    if (auto it = m_string_indices.find(string); it != m_string_indices.end())
+        return it->value;
+    u32 index = m_strings.size();
+    m_strings.append(string);
+    m_string_indices.set(string, index);
+    return index;
+}
+
+u32 Generator::intern_identifier(const FlyString& identifier)
+{
+    if (auto it = m_identifier_indices.find(identifier); it != m_identifier_indices.end())
+        return it->value;
+    u32 index = m_identifiers.size();
+    m_identifiers.append(identifier);
+    m_identifier_indices.set(identifier, index);
+    return index;
+}
+
+void Generator::enter_scope(const ScopeNode& scope_node, ScopeType scope_type)
+{
+    emit<Op::EnterScope>(scope_node, scope_type);
+    m_scopes.append(&scope_node);
+}
+
+void Generator::exit_scope()
+{
+    emit<Op::ExitScope>(*m_scopes.take_last());
+}
+
+bool Generator::begin_lexical_scope(const ScopeNode& scope_node)
+{
+    // Functions declared in a scope capture the environment they're created in, which doesn't have the variables that
+    // live in registers. For the same reason, the scope itself then needs an environment.
+    bool has_functions = !scope_node.functions().is_empty();
+    if (has_functions)
+        invalidate_register_bindings();
+
+    LexicalScope scope;
+    scope.scope_node = &scope_node;
+    if (&scope_node == m_function_body) {
+        // The variables of a function body already live in its environment, next to the parameters.
+        for (auto& declaration : scope_node.variables()) {
+            for (auto& declarator : declaration.declarations()) {
+                auto& name = declarator.id().string();
+                if (declaration.declaration_kind() == DeclarationKind::Const)
+                    scope.const_bindings.set(name);
+                scope.bindings.set(name, {});
+            }
+        }
+        enter_scope(scope_node, ScopeType::Function);
+        scope.entered_environment = true;
+        m_lexical_scopes.append(move(scope));
+        return false;
+    }
+
+    scope.uses_register_bindings = !is<Program>(scope_node) && !has_functions && !scope_node.variables().is_empty() && !m_scopes_without_register_bindings.contains(&scope_node);
+    for (auto& declaration : scope_node.variables()) {
+        if (declaration.declaration_kind() == DeclarationKind::Var)
+            scope.uses_register_bindings = false;
+    }
+
+    for (auto& declaration : scope_node.variables()) {
+        for (auto& declarator : declaration.declarations()) {
+            auto& name = declarator.id().string();
+            if (declaration.declaration_kind() == DeclarationKind::Const)
+                scope.const_bindings.set(name);
+            if (!scope.uses_register_bindings) {
+                scope.bindings.set(name, {});
+                continue;
+            }
+            // Like a new environment, start every variable off as undefined whenever the scope is entered.
+            auto reg = allocate_register();
+            emit<Op::LoadImmediate>(reg, js_undefined());
+            scope.bindings.set(name, reg);
+        }
+    }
+
+    if (!scope.uses_register_bindings && (has_functions || !scope_node.variables().is_empty())) {
+        enter_scope(scope_node);
+        scope.entered_environment = true;
+    }
+
+    bool uses_register_bindings = scope.uses_register_bindings;
+    if (uses_register_bindings)
+        ++m_register_binding_scope_count;
+    m_lexical_scopes.append(move(scope));
+    return uses_register_bindings;
+}
+
+void Generator::end_lexical_scope()
+{
+    auto scope = m_lexical_scopes.take_last();
+    if (scope.entered_environment)
+        exit_scope();
+    if (scope.uses_register_bindings)
+        --m_register_binding_scope_count;
+}
+
+bool Generator::should_regenerate_without_register_bindings()
+{
+    // Only the outermost scope with register bindings starts over, which regenerates everything inside it as well.
+    if (!m_register_bindings_invalidated || m_register_binding_scope_count > 0)
+        return false;
+    m_register_bindings_invalidated = false;
+    return true;
+}
+
+Generator::Checkpoint Generator::save_checkpoint() const
+{
+    Checkpoint checkpoint;
+    checkpoint.bytecode_size = m_bytecode.size();
+    checkpoint.scope_count = m_scopes.size();
+    for (auto& breakable_scope : m_breakable_scopes) {
+        checkpoint.break_jump_counts.append(breakable_scope.break_jumps.size());
+        checkpoint.continue_jump_counts.append(breakable_scope.continue_jumps.size());
+    }
+    return checkpoint;
+}
+
+void Generator::restore_checkpoint(const Checkpoint& checkpoint)
+{
+    VERIFY(m_scopes.size() == checkpoint.scope_count);
+    VERIFY(m_breakable_scopes.size() == checkpoint.break_jump_counts.size());
+    m_bytecode.shrink(checkpoint.bytecode_size);
+    for (size_t i = 0; i < m_breakable_scopes.size(); ++i) {
+        m_breakable_scopes[i].break_jumps.shrink(checkpoint.break_jump_counts[i]);
+        m_breakable_scopes[i].continue_jumps.shrink(checkpoint.continue_jump_counts[i]);
+    }
+}
+
+Optional<Register> Generator::register_binding(const FlyString& name) const
+{
+    for (ssize_t i = m_lexical_scopes.size() - 1; i >= 0; --i) {
+        if (auto it = m_lexical_scopes[i].bindings.find(name); it != m_lexical_scopes[i].bindings.end())
+            return it->value;
+    }
+    return {};
+}
+
+bool Generator::is_const_binding(const FlyString& name) const
+{
+    for (ssize_t i = m_lexical_scopes.size() - 1; i >= 0; --i) {
+        if (m_lexical_scopes[i].bindings.contains(name))
+            return m_lexical_scopes[i].const_bindings.contains(name);
+    }
+    return false;
+}
+
+void Generator::invalidate_register_bindings()
+{
+    if (m_register_binding_scope_count > 0)
+        m_register_bindings_invalidated = true;
+}
+
+Register Generator::emit_evaluate_ast(const ASTNode& node)
+{
+    // The AST interpreter can only find variables in the environment.
+    invalidate_register_bindings();
+    auto dst = allocate_register();
+    emit<Op::EvaluateAST>(dst, node);
+    return dst;
+}
+
+void Generator::retain_synthesized_scope(NonnullRefPtr<ScopeNode> scope_node)
+{
+    m_synthesized_scopes.append(move(scope_node));
+}
+
+void Generator::begin_breakable_scope(const FlyString& label, bool is_loop)
+{
+    m_breakable_scopes.append({ label, is_loop, m_scopes.size(), {}, {} });
+}
+
+void Generator::end_breakable_scope(Optional<Label> continue_target, Label break_target)
+{
+    auto scope = m_breakable_scopes.take_last();
+    VERIFY(scope.scope_depth == m_scopes.size());
+    for (auto jump : scope.break_jumps)
+        link_jump(jump, break_target);
+    VERIFY(continue_target.has_value() || scope.continue_jumps.is_empty());
+    for (auto jump : scope.continue_jumps)
+        link_jump(jump, continue_target.value());
+}
+
+Generator::BreakableScope* Generator::find_breakable_scope(const FlyString& target_label, bool for_continue)
+{
+    for (ssize_t i = m_breakable_scopes.size() - 1; i >= 0; --i) {
+        auto& scope = m_breakable_scopes[i];
+        if (target_label.is_null() ? scope.is_loop : scope.label == target_label) {
+            // Only loops can be continued, even if they're labelled.
+            if (for_continue && !scope.is_loop)
+                return nullptr;
+            return &scope;
+        }
+    }
+    return nullptr;
+}
+
+void Generator::exit_scopes_down_to(size_t scope_depth)
+{
+    // Exiting a scope also exits everything that was entered after it, but the scopes stay open for the
+    // code that follows the jump.
+    if (m_scopes.size() > scope_depth)
+        emit<Op::ExitScope>(*m_scopes[scope_depth]);
+}
+
+void Generator::emit_break(const ASTNode& node, const FlyString& target_label)
+{
+    auto* scope = find_breakable_scope(target_label, false);
+    if (!scope) {
+        set_unsupported(node);
+        return;
+    }
+    exit_scopes_down_to(scope->scope_depth);
+    scope->break_jumps.append(emit<Op::Jump>());
+}
+
+void Generator::emit_continue(const ASTNode& node, const FlyString& target_label)
+{
+    auto* scope = find_breakable_scope(target_label, true);
+    if (!scope) {
+        set_unsupported(node);
+        return;
+    }
+    exit_scopes_down_to(scope->scope_depth);
+    scope->continue_jumps.append(emit<Op::Jump>());
+}
+
+void Generator::emit_return(const ASTNode& node, Register value)
+{
+    if (!m_function_body) {
+        set_unsupported(node);
+        return;
+    }
+    exit_scopes_down_to(0);
+    emit<Op::Return>(value);
+}
+
+void Generator::set_unsupported(const ASTNode& node)
+{
+    if (!m_unsupported_node)
+        m_unsupported_node = &node;
+}
+
+}
@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/HashTable.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/OwnPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// Compiles a Program or a function body to bytecode, by letting every node emit its own code with
+// ASTNode::generate_bytecode(). Expressions that don't know how to do that yet are evaluated by the AST interpreter
+// instead, but statements can't be, since break and continue would then have to cross from one interpreter into the
+// other. If the code contains such a statement, it isn't compiled at all and has to be run by the AST interpreter.
+class Generator {
+    AK_MAKE_NONCOPYABLE(Generator);
+    AK_MAKE_NONMOVABLE(Generator);
+
+public:
+    static OwnPtr<Executable> generate(const Program&);
+    // The function's environment must already have been created when the resulting bytecode runs, with the
+    // parameters bound in it, like the AST interpreter expects as well.
+    static OwnPtr<Executable> generate_function(const ScopeNode& body);
+
+    bool is_generating_function() const { return m_function_body; }
+
+    Register allocate_register();
+
+    template<typename OpType, typename... Args>
+    size_t emit(Args&&... args)
+    {
+        return emit_with_extra_register_slots<OpType>(0, forward<Args>(args)...);
+    }
+
+    template<typename OpType, typename... Args>
+    size_t emit_with_extra_register_slots(size_t extra_register_slots, Args&&... args)
+    {
+        auto address = m_bytecode.size();
+        m_bytecode.resize(address + align_up_to(sizeof(OpType) + extra_register_slots * sizeof(Register), instruction_alignment));
+        auto* instruction = new (m_bytecode.data() + address) OpType(forward<Args>(args)...);
+        VERIFY(address + instruction->length() == m_bytecode.size());
+        return address;
+    }
+
+    Label make_label() const { return Label { m_bytecode.size() }; }
+    void link_jump(size_t jump_address, Label target);
+
+    u32 intern_string(const String&);
+    u32 intern_identifier(const FlyString&);
+
+    // Let and const declarations that nothing but the bytecode can see live in registers instead of an environment.
+    // That isn't known until the whole scope has been generated, so if the scope turns out to need an environment
+    // after all (because something is handed to the AST interpreter, which can only look variables up by name),
+    // its code is thrown away and generated again.
+    template<typename Callback>
+    void generate_lexical_scope(const ScopeNode& scope_node, Callback generate_body)
+    {
+        for (;;) {
+            auto checkpoint = save_checkpoint();
+            bool uses_register_bindings = begin_lexical_scope(scope_node);
+            generate_body();
+            if (is_unsupported())
+                return;
+            end_lexical_scope();
+            if (!uses_register_bindings || !should_regenerate_without_register_bindings())
+                return;
+            restore_checkpoint(checkpoint);
+            m_scopes_without_register_bindings.set(&scope_node);
+        }
+    }
+
+    // The register of a variable that lives in one, or nothing if it has to be looked up by name.
+    Optional<Register> register_binding(const FlyString& name) const;
+    bool is_const_binding(const FlyString& name) const;
+    void invalidate_register_bindings();
+
+    Register emit_evaluate_ast(const ASTNode&);
+
+    void retain_synthesized_scope(NonnullRefPtr<ScopeNode>);
+
+    // Loops, and labelled statements, that break or continue can jump out of.
+    void begin_breakable_scope(const FlyString& label, bool is_loop);
+    void end_breakable_scope(Optional<Label> continue_target, Label break_target);
+    void emit_break(const ASTNode&, const FlyString& target_label);
+    void emit_continue(const ASTNode&, const FlyString& target_label);
+    void emit_return(const ASTNode&, Register value);
+
+    void set_unsupported(const ASTNode&);
+    bool is_unsupported() const { return m_unsupported_node; }
+
+private:
+    Generator();
+
+    struct BreakableScope {
+        FlyString label;
+        bool is_loop { false };
+        size_t scope_depth { 0 };
+        Vector<size_t> break_jumps;
+        Vector<size_t> continue_jumps;
+    };
+
+    struct LexicalScope {
+        const ScopeNode* scope_node { nullptr };
+        // Every name the scope declares, and its register if it doesn't live in the environment.
+        HashMap<FlyString, Optional<Register>> bindings;
+        HashTable<FlyString> const_bindings;
+        bool uses_register_bindings { false };
+        bool entered_environment { false };
+    };
+
+    struct Checkpoint {
+        size_t bytecode_size { 0 };
+        size_t scope_count { 0 };
+        Vector<size_t> break_jump_counts;
+        Vector<size_t> continue_jump_counts;
+    };
+
+    bool begin_lexical_scope(const ScopeNode&);
+    void end_lexical_scope();
+    bool should_regenerate_without_register_bindings();
+    Checkpoint save_checkpoint() const;
+    void restore_checkpoint(const Checkpoint&);
+
+    void enter_scope(const ScopeNode&, ScopeType = ScopeType::Block);
+    void exit_scope();
+
+    BreakableScope* find_breakable_scope(const FlyString& target_label, bool for_continue);
+    void exit_scopes_down_to(size_t scope_depth);
+
+    Vector<u8> m_bytecode;
+    Vector<String> m_strings;
+    HashMap<String, u32> m_string_indices;
+    Vector<FlyString> m_identifiers;
+    HashMap<FlyString, u32> m_identifier_indices;
+    NonnullRefPtrVector<ScopeNode> m_synthesized_scopes;
+    // The scopes that have been entered at runtime, i.e. that have an EnterScope without an ExitScope yet.
+    Vector<const ScopeNode*> m_scopes;
+    Vector<LexicalScope> m_lexical_scopes;
+    HashTable<const ScopeNode*> m_scopes_without_register_bindings;
+    size_t m_register_binding_scope_count { 0 };
+    bool m_register_bindings_invalidated { false };
+    Vector<BreakableScope> m_breakable_scopes;
+    u32 m_next_register { 0 };
+    const ScopeNode* m_function_body { nullptr };
+    const ASTNode* m_unsupported_node { nullptr };
+};
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Forward.h>
+#include <AK/Types.h>
+#include <LibJS/Forward.h>
+
+#define ENUMERATE_BYTECODE_OPS(O) \
+    O(LoadImmediate)              \
+    O(NewString)                  \
+    O(Move)                       \
+    O(GetVariable)                \
+    O(SetVariable)                \
+    O(GetById)                    \
+    O(PutById)                    \
+    O(GetByValue)                 \
+    O(PutByValue)                 \
+    O(Add)                        \
+    O(Sub)                        \
+    O(Mul)                        \
+    O(Div)                        \
+    O(Mod)                        \
+    O(Exp)                        \
+    O(GreaterThan)                \
+    O(GreaterThanEquals)          \
+    O(LessThan)                   \
+    O(LessThanEquals)             \
+    O(AbstractEquals)             \
+    O(AbstractInequals)           \
+    O(TypedEquals)                \
+    O(TypedInequals)              \
+    O(BitwiseAnd)                 \
+    O(BitwiseOr)                  \
+    O(BitwiseXor)                 \
+    O(LeftShift)                  \
+    O(RightShift)                 \
+    O(UnsignedRightShift)         \
+    O(In)                         \
+    O(InstanceOf)                 \
+    O(BitwiseNot)                 \
+    O(Not)                        \
+    O(UnaryPlus)                  \
+    O(UnaryMinus)                 \
+    O(Typeof)                     \
+    O(ToNumeric)                  \
+    O(Increment)                  \
+    O(Decrement)                  \
+    O(Call)                       \
+    O(Jump)                       \
+    O(JumpIfTrue)                 \
+    O(JumpIfFalse)                \
+    O(JumpIfNullish)              \
+    O(JumpIfNotNullish)           \
+    O(EnterScope)                 \
+    O(ExitScope)                  \
+    O(SetLastValue)               \
+    O(Return)                     \
+    O(EvaluateAST)
+
+namespace JS::Bytecode {
+
+// Instructions are laid out back to back in an executable's bytecode, each one padded to this alignment.
+static constexpr size_t instruction_alignment = alignof(double);
+
+class Instruction {
+public:
+    enum class Type : u8 {
+#define __BYTECODE_OP(op) op,
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    };
+
+    Type type() const { return m_type; }
+    bool is_jump() const { return m_type >= Type::Jump && m_type <= Type::JumpIfNotNullish; }
+
+    // These dispatch on type() rather than going through a vtable, so the interpreter loop stays a single switch.
+    size_t length() const;
+    String to_string(const Executable&) const;
+    void execute(Bytecode::Interpreter&) const;
+
+protected:
+    explicit Instruction(Type type)
+        : m_type(type)
+    {
+    }
+
+private:
+    Type m_type {};
+};
+
+}
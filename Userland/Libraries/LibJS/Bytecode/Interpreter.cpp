@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+
+namespace JS::Bytecode {
+
+Interpreter::Interpreter(JS::Interpreter& ast_interpreter, GlobalObject& global_object)
+    : m_ast_interpreter(ast_interpreter)
+    , m_global_object(global_object)
+    , m_vm(ast_interpreter.vm())
+    , m_registers(ast_interpreter.heap())
+{
+}
+
+Value Interpreter::run(const Executable& executable)
+{
+    m_executable = &executable;
+    m_pc = 0;
+    m_return_value = js_undefined();
+    m_registers.resize(executable.register_count());
+
+    auto bytecode = executable.bytecode();
+    while (m_pc < bytecode.size()) {
+        auto& instruction = *reinterpret_cast<const Instruction*>(bytecode.offset_pointer(m_pc));
+        // Step over the instruction first, so jumps can simply overwrite m_pc.
+        m_pc += instruction.length();
+        instruction.execute(*this);
+        if (m_vm.exception())
+            break;
+    }
+
+    m_registers.clear();
+    m_executable = nullptr;
+    return m_return_value;
+}
+
+void Interpreter::do_return(Value value)
+{
+    m_return_value = value;
+    m_pc = m_executable->bytecode().size();
+}
+
+void Interpreter::set_last_value(Value value)
+{
+    m_ast_interpreter.set_last_value({}, value);
+}
+
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/MarkedValueList.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode {
+
+// Runs an Executable with a fresh set of registers. Anything the bytecode doesn't handle itself, such as
+// scopes and calls into functions, still goes through the AST interpreter it was created for.
+class Interpreter {
+    AK_MAKE_NONCOPYABLE(Interpreter);
+    AK_MAKE_NONMOVABLE(Interpreter);
+
+public:
+    Interpreter(JS::Interpreter&, GlobalObject&);
+
+    // Returns the value of the Return that ended the executable, or undefined if it ran off the end.
+    Value run(const Executable&);
+
+    JS::Interpreter& ast_interpreter() { return m_ast_interpreter; }
+    GlobalObject& global_object() { return m_global_object; }
+    VM& vm() { return m_vm; }
+    const Executable& executable() const { return *m_executable; }
+
+    ALWAYS_INLINE Value& reg(Register reg) { return m_registers[reg.index()]; }
+
+    void jump(Label label) { m_pc = label.address(); }
+    void do_return(Value);
+    void set_last_value(Value);
+
+private:
+    JS::Interpreter& m_ast_interpreter;
+    GlobalObject& m_global_object;
+    VM& m_vm;
+    const Executable* m_executable { nullptr };
+    MarkedValueList m_registers;
+    size_t m_pc { 0 };
+    Value m_return_value;
+};
+
+}
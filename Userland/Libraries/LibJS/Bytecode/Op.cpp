@@ -0,0 +1,413 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibCrypto/BigInt/SignedBigInteger.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Bytecode/Op.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/BigInt.h>
+#include <LibJS/Runtime/Error.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/NativeFunction.h>
+#include <LibJS/Runtime/Reference.h>
+
+namespace JS::Bytecode {
+
+size_t Instruction::length() const
+{
+    if (type() == Type::Call)
+        return align_up_to(static_cast<const Op::Call&>(*this).length_without_padding(), instruction_alignment);
+
+    switch (type()) {
+#define __BYTECODE_OP(op) \
+    case Type::op:        \
+        return align_up_to(sizeof(Op::op), instruction_alignment);
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    }
+    VERIFY_NOT_REACHED();
+}
+
+String Instruction::to_string(const Executable& executable) const
+{
+    switch (type()) {
+#define __BYTECODE_OP(op) \
+    case Type::op:        \
+        return static_cast<const Op::op&>(*this).to_string(executable);
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void Instruction::execute(Bytecode::Interpreter& interpreter) const
+{
+    switch (type()) {
+#define __BYTECODE_OP(op)                                           \
+    case Type::op:                                                  \
+        static_cast<const Op::op&>(*this).execute(interpreter); \
+        return;
+        ENUMERATE_BYTECODE_OPS(__BYTECODE_OP)
+#undef __BYTECODE_OP
+    }
+    VERIFY_NOT_REACHED();
+}
+
+}
+
+namespace JS::Bytecode::Op {
+
+void LoadImmediate::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = m_value;
+}
+
+String LoadImmediate::to_string(const Executable&) const
+{
+    return String::formatted("LoadImmediate {}, {}", m_dst, m_value.to_string_without_side_effects());
+}
+
+void NewString::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = js_string(interpreter.vm(), interpreter.executable().string(m_string));
+}
+
+String NewString::to_string(const Executable& executable) const
+{
+    return String::formatted("NewString {}, \"{}\"", m_dst, executable.string(m_string));
+}
+
+void Move::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = interpreter.reg(m_src);
+}
+
+String Move::to_string(const Executable&) const
+{
+    return String::formatted("Move {}, {}", m_dst, m_src);
+}
+
+void GetVariable::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& name = interpreter.executable().identifier(m_identifier);
+    auto value = interpreter.vm().get_variable(name, interpreter.global_object(), &m_cache);
+    if (value.is_empty()) {
+        if (!interpreter.vm().exception())
+            interpreter.vm().throw_exception<ReferenceError>(interpreter.global_object(), ErrorType::UnknownIdentifier, name);
+        return;
+    }
+    interpreter.reg(m_dst) = value;
+}
+
+String GetVariable::to_string(const Executable& executable) const
+{
+    return String::formatted("GetVariable {}, {}", m_dst, executable.identifier(m_identifier));
+}
+
+void SetVariable::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.vm().set_variable(interpreter.executable().identifier(m_identifier), interpreter.reg(m_src), interpreter.global_object(), m_is_declaration, &m_cache);
+}
+
+String SetVariable::to_string(const Executable& executable) const
+{
+    return String::formatted("SetVariable {}, {}{}", executable.identifier(m_identifier), m_src, m_is_declaration ? " (declaration)" : "");
+}
+
+void GetById::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto base = interpreter.reg(m_base);
+    auto& property_name = interpreter.executable().identifier(m_property);
+    Value value;
+    if (base.is_object())
+        value = base.as_object().get_with_cache(property_name, m_cache).value_or(js_undefined());
+    else
+        value = Reference(base, property_name).get(interpreter.global_object());
+    if (interpreter.vm().exception())
+        return;
+    interpreter.reg(m_dst) = value;
+}
+
+String GetById::to_string(const Executable& executable) const
+{
+    return String::formatted("GetById {}, {}, {}", m_dst, m_base, executable.identifier(m_property));
+}
+
+void PutById::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto base = interpreter.reg(m_base);
+    auto& property_name = interpreter.executable().identifier(m_property);
+    if (base.is_object())
+        base.as_object().put_with_cache(property_name, interpreter.reg(m_src), m_cache);
+    else
+        Reference(base, property_name).put(interpreter.global_object(), interpreter.reg(m_src));
+}
+
+String PutById::to_string(const Executable& executable) const
+{
+    return String::formatted("PutById {}, {}, {}", m_base, executable.identifier(m_property), m_src);
+}
+
+void GetByValue::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto property_name = PropertyName::from_value(interpreter.global_object(), interpreter.reg(m_property));
+    if (interpreter.vm().exception())
+        return;
+    Reference reference { interpreter.reg(m_base), property_name };
+    auto value = reference.get(interpreter.global_object());
+    if (interpreter.vm().exception())
+        return;
+    interpreter.reg(m_dst) = value;
+}
+
+String GetByValue::to_string(const Executable&) const
+{
+    return String::formatted("GetByValue {}, {}, {}", m_dst, m_base, m_property);
+}
+
+void PutByValue::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto property_name = PropertyName::from_value(interpreter.global_object(), interpreter.reg(m_property));
+    if (interpreter.vm().exception())
+        return;
+    Reference reference { interpreter.reg(m_base), property_name };
+    reference.put(interpreter.global_object(), interpreter.reg(m_src));
+}
+
+String PutByValue::to_string(const Executable&) const
+{
+    return String::formatted("PutByValue {}, {}, {}", m_base, m_property, m_src);
+}
+
+static Value abstract_equals(GlobalObject& global_object, Value lhs, Value rhs)
+{
+    return Value(abstract_eq(global_object, lhs, rhs));
+}
+
+static Value abstract_inequals(GlobalObject& global_object, Value lhs, Value rhs)
+{
+    return Value(!abstract_eq(global_object, lhs, rhs));
+}
+
+static Value typed_equals(GlobalObject&, Value lhs, Value rhs)
+{
+    return Value(strict_eq(lhs, rhs));
+}
+
+static Value typed_inequals(GlobalObject&, Value lhs, Value rhs)
+{
+    return Value(!strict_eq(lhs, rhs));
+}
+
+#define JS_DEFINE_BYTECODE_BINARY_OP(OpTitleCase, op_snake_case)                                                   \
+    void OpTitleCase::execute(Bytecode::Interpreter& interpreter) const                                           \
+    {                                                                                                             \
+        auto result = op_snake_case(interpreter.global_object(), interpreter.reg(m_lhs), interpreter.reg(m_rhs)); \
+        if (interpreter.vm().exception())                                                                         \
+            return;                                                                                               \
+        interpreter.reg(m_dst) = result;                                                                          \
+    }                                                                                                             \
+                                                                                                                  \
+    String OpTitleCase::to_string(const Executable&) const                                                        \
+    {                                                                                                             \
+        return String::formatted(#OpTitleCase " {}, {}, {}", m_dst, m_lhs, m_rhs);                                \
+    }
+
+JS_ENUMERATE_BYTECODE_BINARY_OPS(JS_DEFINE_BYTECODE_BINARY_OP)
+#undef JS_DEFINE_BYTECODE_BINARY_OP
+
+static Value not_(GlobalObject&, Value value)
+{
+    return Value(!value.to_boolean());
+}
+
+static Value typeof_(GlobalObject& global_object, Value value)
+{
+    return js_string(global_object.vm(), value.typeof());
+}
+
+static Value to_numeric(GlobalObject& global_object, Value value)
+{
+    return value.to_numeric(global_object);
+}
+
+// These expect a numeric operand, i.e. the result of ToNumeric.
+static Value increment(GlobalObject& global_object, Value value)
+{
+    if (value.is_number())
+        return Value(value.as_double() + 1);
+    return js_bigint(global_object.heap(), value.as_bigint().big_integer().plus(Crypto::SignedBigInteger { 1 }));
+}
+
+static Value decrement(GlobalObject& global_object, Value value)
+{
+    if (value.is_number())
+        return Value(value.as_double() - 1);
+    return js_bigint(global_object.heap(), value.as_bigint().big_integer().minus(Crypto::SignedBigInteger { 1 }));
+}
+
+#define JS_DEFINE_BYTECODE_UNARY_OP(OpTitleCase, op_snake_case)                             \
+    void OpTitleCase::execute(Bytecode::Interpreter& interpreter) const                    \
+    {                                                                                      \
+        auto result = op_snake_case(interpreter.global_object(), interpreter.reg(m_src)); \
+        if (interpreter.vm().exception())                                                  \
+            return;                                                                        \
+        interpreter.reg(m_dst) = result;                                                   \
+    }                                                                                      \
+                                                                                           \
+    String OpTitleCase::to_string(const Executable&) const                                 \
+    {                                                                                      \
+        return String::formatted(#OpTitleCase " {}, {}", m_dst, m_src);                    \
+    }
+
+JS_ENUMERATE_BYTECODE_UNARY_OPS(JS_DEFINE_BYTECODE_UNARY_OP)
+#undef JS_DEFINE_BYTECODE_UNARY_OP
+
+void Call::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto& vm = interpreter.vm();
+    auto& global_object = interpreter.global_object();
+    auto callee = interpreter.reg(m_callee);
+
+    if (!callee.is_function()
+        || (m_call_type == CallType::Construct && is<NativeFunction>(callee.as_object()) && !static_cast<NativeFunction&>(callee.as_object()).has_constructor())) {
+        auto call_type = m_call_type == CallType::Construct ? "constructor" : "function";
+        if (m_expression_string.has_value())
+            vm.throw_exception<TypeError>(global_object, ErrorType::IsNotAEvaluatedFrom, callee.to_string_without_side_effects(), call_type, interpreter.executable().string(m_expression_string.value()));
+        else
+            vm.throw_exception<TypeError>(global_object, ErrorType::IsNotA, callee.to_string_without_side_effects(), call_type);
+        return;
+    }
+
+    auto& function = callee.as_function();
+
+    Value result;
+    if (m_call_type == CallType::Construct) {
+        MarkedValueList arguments(vm.heap());
+        arguments.ensure_capacity(m_argument_count);
+        for (size_t i = 0; i < m_argument_count; ++i)
+            arguments.unchecked_append(interpreter.reg(m_arguments[i]));
+        result = vm.construct(function, function, move(arguments), global_object);
+    } else {
+        // The registers keep the arguments alive until the call frame has its own copy of them.
+        Vector<Value, 8> arguments;
+        arguments.ensure_capacity(m_argument_count);
+        for (size_t i = 0; i < m_argument_count; ++i)
+            arguments.unchecked_append(interpreter.reg(m_arguments[i]));
+        Value this_value = m_this_value.has_value() ? interpreter.reg(m_this_value.value()) : Value(&global_object);
+        result = vm.call(function, this_value, Span<const Value> { arguments.data(), arguments.size() });
+    }
+    if (vm.exception())
+        return;
+
+    interpreter.reg(m_dst) = result;
+}
+
+String Call::to_string(const Executable&) const
+{
+    StringBuilder builder;
+    builder.appendff("{} {}, {}", m_call_type == CallType::Construct ? "Construct" : "Call", m_dst, m_callee);
+    if (m_this_value.has_value())
+        builder.appendff(", this={}", m_this_value.value());
+    for (size_t i = 0; i < m_argument_count; ++i)
+        builder.appendff(", {}", m_arguments[i]);
+    return builder.to_string();
+}
+
+void Jump::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.jump(m_target.value());
+}
+
+String Jump::to_string(const Executable&) const
+{
+    if (!m_target.has_value())
+        return "Jump <unlinked>";
+    return String::formatted("Jump {}", m_target.value());
+}
+
+static bool jump_if_true(Value value) { return value.to_boolean(); }
+static bool jump_if_false(Value value) { return !value.to_boolean(); }
+static bool jump_if_nullish(Value value) { return value.is_nullish(); }
+static bool jump_if_not_nullish(Value value) { return !value.is_nullish(); }
+
+#define JS_DEFINE_BYTECODE_CONDITIONAL_JUMP(OpTitleCase, condition_snake_case)                \
+    void OpTitleCase::execute(Bytecode::Interpreter& interpreter) const                       \
+    {                                                                                         \
+        if (condition_snake_case(interpreter.reg(m_condition)))                               \
+            interpreter.jump(m_target.value());                                               \
+    }                                                                                         \
+                                                                                              \
+    String OpTitleCase::to_string(const Executable&) const                                    \
+    {                                                                                         \
+        if (!m_target.has_value())                                                            \
+            return String::formatted(#OpTitleCase " {}, <unlinked>", m_condition);            \
+        return String::formatted(#OpTitleCase " {}, {}", m_condition, m_target.value());      \
+    }
+
+JS_DEFINE_BYTECODE_CONDITIONAL_JUMP(JumpIfTrue, jump_if_true)
+JS_DEFINE_BYTECODE_CONDITIONAL_JUMP(JumpIfFalse, jump_if_false)
+JS_DEFINE_BYTECODE_CONDITIONAL_JUMP(JumpIfNullish, jump_if_nullish)
+JS_DEFINE_BYTECODE_CONDITIONAL_JUMP(JumpIfNotNullish, jump_if_not_nullish)
+#undef JS_DEFINE_BYTECODE_CONDITIONAL_JUMP
+
+void EnterScope::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.ast_interpreter().enter_scope(m_scope_node, m_scope_type, interpreter.global_object());
+}
+
+String EnterScope::to_string(const Executable&) const
+{
+    if (m_scope_type == ScopeType::Function)
+        return String::formatted("EnterScope {} (function)", m_scope_node.class_name());
+    return String::formatted("EnterScope {}", m_scope_node.class_name());
+}
+
+void ExitScope::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.ast_interpreter().exit_scope(m_scope_node);
+}
+
+String ExitScope::to_string(const Executable&) const
+{
+    return String::formatted("ExitScope {}", m_scope_node.class_name());
+}
+
+void SetLastValue::execute(Bytecode::Interpreter& interpreter) const
+{
+    auto value = interpreter.reg(m_src);
+    if (!value.is_empty())
+        interpreter.set_last_value(value);
+}
+
+String SetLastValue::to_string(const Executable&) const
+{
+    return String::formatted("SetLastValue {}", m_src);
+}
+
+void Return::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.do_return(interpreter.reg(m_src));
+}
+
+String Return::to_string(const Executable&) const
+{
+    return String::formatted("Return {}", m_src);
+}
+
+void EvaluateAST::execute(Bytecode::Interpreter& interpreter) const
+{
+    interpreter.reg(m_dst) = m_node.execute(interpreter.ast_interpreter(), interpreter.global_object());
+}
+
+String EvaluateAST::to_string(const Executable&) const
+{
+    return String::formatted("EvaluateAST {}, {}", m_dst, m_node.class_name());
+}
+
+}
@@ -0,0 +1,438 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Bytecode/Label.h>
+#include <LibJS/Bytecode/Register.h>
+#include <LibJS/Runtime/PropertyCache.h>
+#include <LibJS/Runtime/VM.h>
+#include <LibJS/Runtime/Value.h>
+#include <LibJS/Runtime/VariableCache.h>
+
+// Every instruction must stay trivially destructible, since the generator places them straight into a byte buffer
+// and nobody ever destroys them. Anything that needs to own memory (strings, identifiers) lives in the Executable's
+// tables, and instructions refer to it by index.
+
+namespace JS::Bytecode::Op {
+
+class LoadImmediate final : public Instruction {
+public:
+    LoadImmediate(Register dst, Value value)
+        : Instruction(Type::LoadImmediate)
+        , m_dst(dst)
+        , m_value(value)
+    {
+        // Since nothing marks the bytecode, it can't hold on to anything the GC would have to know about.
+        VERIFY(!value.is_cell());
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    Value m_value;
+};
+
+class NewString final : public Instruction {
+public:
+    NewString(Register dst, u32 string)
+        : Instruction(Type::NewString)
+        , m_dst(dst)
+        , m_string(string)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    u32 m_string { 0 };
+};
+
+class Move final : public Instruction {
+public:
+    Move(Register dst, Register src)
+        : Instruction(Type::Move)
+        , m_dst(dst)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    Register m_src;
+};
+
+class GetVariable final : public Instruction {
+public:
+    GetVariable(Register dst, u32 identifier)
+        : Instruction(Type::GetVariable)
+        , m_dst(dst)
+        , m_identifier(identifier)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    u32 m_identifier { 0 };
+    mutable VariableCache m_cache;
+};
+
+class SetVariable final : public Instruction {
+public:
+    SetVariable(u32 identifier, Register src, bool is_declaration = false)
+        : Instruction(Type::SetVariable)
+        , m_identifier(identifier)
+        , m_src(src)
+        , m_is_declaration(is_declaration)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    u32 m_identifier { 0 };
+    Register m_src;
+    bool m_is_declaration { false };
+    mutable VariableCache m_cache;
+};
+
+class GetById final : public Instruction {
+public:
+    GetById(Register dst, Register base, u32 property)
+        : Instruction(Type::GetById)
+        , m_dst(dst)
+        , m_base(base)
+        , m_property(property)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    Register m_base;
+    u32 m_property { 0 };
+    mutable PropertyCache m_cache;
+};
+
+class PutById final : public Instruction {
+public:
+    PutById(Register base, u32 property, Register src)
+        : Instruction(Type::PutById)
+        , m_base(base)
+        , m_property(property)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_base;
+    u32 m_property { 0 };
+    Register m_src;
+    mutable PropertyCache m_cache;
+};
+
+class GetByValue final : public Instruction {
+public:
+    GetByValue(Register dst, Register base, Register property)
+        : Instruction(Type::GetByValue)
+        , m_dst(dst)
+        , m_base(base)
+        , m_property(property)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    Register m_base;
+    Register m_property;
+};
+
+class PutByValue final : public Instruction {
+public:
+    PutByValue(Register base, Register property, Register src)
+        : Instruction(Type::PutByValue)
+        , m_base(base)
+        , m_property(property)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_base;
+    Register m_property;
+    Register m_src;
+};
+
+#define JS_ENUMERATE_BYTECODE_BINARY_OPS(O)     \
+    O(Add, add)                                 \
+    O(Sub, sub)                                 \
+    O(Mul, mul)                                 \
+    O(Div, div)                                 \
+    O(Mod, mod)                                 \
+    O(Exp, exp)                                 \
+    O(GreaterThan, greater_than)                \
+    O(GreaterThanEquals, greater_than_equals)   \
+    O(LessThan, less_than)                      \
+    O(LessThanEquals, less_than_equals)         \
+    O(AbstractEquals, abstract_equals)          \
+    O(AbstractInequals, abstract_inequals)      \
+    O(TypedEquals, typed_equals)                \
+    O(TypedInequals, typed_inequals)            \
+    O(BitwiseAnd, bitwise_and)                  \
+    O(BitwiseOr, bitwise_or)                    \
+    O(BitwiseXor, bitwise_xor)                  \
+    O(LeftShift, left_shift)                    \
+    O(RightShift, right_shift)                  \
+    O(UnsignedRightShift, unsigned_right_shift) \
+    O(In, in)                                   \
+    O(InstanceOf, instance_of)
+
+#define JS_DECLARE_BYTECODE_BINARY_OP(OpTitleCase, op_snake_case) \
+    class OpTitleCase final : public Instruction {                \
+    public:                                                       \
+        OpTitleCase(Register dst, Register lhs, Register rhs)     \
+            : Instruction(Type::OpTitleCase)                      \
+            , m_dst(dst)                                          \
+            , m_lhs(lhs)                                          \
+            , m_rhs(rhs)                                          \
+        {                                                         \
+        }                                                         \
+                                                                  \
+        void execute(Bytecode::Interpreter&) const;               \
+        String to_string(const Executable&) const;                \
+                                                                  \
+    private:                                                      \
+        Register m_dst;                                           \
+        Register m_lhs;                                           \
+        Register m_rhs;                                           \
+    };
+
+JS_ENUMERATE_BYTECODE_BINARY_OPS(JS_DECLARE_BYTECODE_BINARY_OP)
+#undef JS_DECLARE_BYTECODE_BINARY_OP
+
+#define JS_ENUMERATE_BYTECODE_UNARY_OPS(O) \
+    O(BitwiseNot, bitwise_not)             \
+    O(Not, not_)                           \
+    O(UnaryPlus, unary_plus)               \
+    O(UnaryMinus, unary_minus)             \
+    O(Typeof, typeof_)                     \
+    O(ToNumeric, to_numeric)               \
+    O(Increment, increment)                \
+    O(Decrement, decrement)
+
+#define JS_DECLARE_BYTECODE_UNARY_OP(OpTitleCase, op_snake_case) \
+    class OpTitleCase final : public Instruction {               \
+    public:                                                      \
+        OpTitleCase(Register dst, Register src)                  \
+            : Instruction(Type::OpTitleCase)                     \
+            , m_dst(dst)                                         \
+            , m_src(src)                                         \
+        {                                                        \
+        }                                                        \
+                                                                 \
+        void execute(Bytecode::Interpreter&) const;              \
+        String to_string(const Executable&) const;               \
+                                                                 \
+    private:                                                     \
+        Register m_dst;                                          \
+        Register m_src;                                          \
+    };
+
+JS_ENUMERATE_BYTECODE_UNARY_OPS(JS_DECLARE_BYTECODE_UNARY_OP)
+#undef JS_DECLARE_BYTECODE_UNARY_OP
+
+// The arguments are stored right after the instruction, which makes this the only variable-length one.
+class Call final : public Instruction {
+public:
+    enum class CallType : u8 {
+        Call,
+        Construct,
+    };
+
+    Call(CallType type, Register dst, Register callee, Optional<Register> this_value, Optional<u32> expression_string, Span<const Register> arguments)
+        : Instruction(Type::Call)
+        , m_dst(dst)
+        , m_callee(callee)
+        , m_this_value(this_value)
+        , m_expression_string(expression_string)
+        , m_call_type(type)
+        , m_argument_count(arguments.size())
+    {
+        for (size_t i = 0; i < m_argument_count; ++i)
+            m_arguments[i] = arguments[i];
+    }
+
+    size_t length_without_padding() const { return sizeof(*this) + sizeof(Register) * m_argument_count; }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    Register m_callee;
+    Optional<Register> m_this_value;
+    Optional<u32> m_expression_string;
+    CallType m_call_type { CallType::Call };
+    u32 m_argument_count { 0 };
+    Register m_arguments[];
+};
+
+class Jump : public Instruction {
+public:
+    explicit Jump(Optional<Label> target = {})
+        : Instruction(Type::Jump)
+        , m_target(target)
+    {
+    }
+
+    void set_target(Label target) { m_target = target; }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+protected:
+    Jump(Type type, Optional<Label> target)
+        : Instruction(type)
+        , m_target(target)
+    {
+    }
+
+    Optional<Label> m_target;
+};
+
+#define JS_ENUMERATE_BYTECODE_CONDITIONAL_JUMPS(O) \
+    O(JumpIfTrue)                                  \
+    O(JumpIfFalse)                                 \
+    O(JumpIfNullish)                               \
+    O(JumpIfNotNullish)
+
+#define JS_DECLARE_BYTECODE_CONDITIONAL_JUMP(OpTitleCase)                     \
+    class OpTitleCase final : public Jump {                                   \
+    public:                                                                   \
+        explicit OpTitleCase(Register condition, Optional<Label> target = {}) \
+            : Jump(Type::OpTitleCase, target)                                 \
+            , m_condition(condition)                                          \
+        {                                                                     \
+        }                                                                     \
+                                                                              \
+        void execute(Bytecode::Interpreter&) const;                           \
+        String to_string(const Executable&) const;                            \
+                                                                              \
+    private:                                                                  \
+        Register m_condition;                                                 \
+    };
+
+JS_ENUMERATE_BYTECODE_CONDITIONAL_JUMPS(JS_DECLARE_BYTECODE_CONDITIONAL_JUMP)
+#undef JS_DECLARE_BYTECODE_CONDITIONAL_JUMP
+
+class EnterScope final : public Instruction {
+public:
+    explicit EnterScope(const ScopeNode& scope_node, ScopeType scope_type = ScopeType::Block)
+        : Instruction(Type::EnterScope)
+        , m_scope_node(scope_node)
+        , m_scope_type(scope_type)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    const ScopeNode& m_scope_node;
+    ScopeType m_scope_type { ScopeType::Block };
+};
+
+class ExitScope final : public Instruction {
+public:
+    explicit ExitScope(const ScopeNode& scope_node)
+        : Instruction(Type::ExitScope)
+        , m_scope_node(scope_node)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    const ScopeNode& m_scope_node;
+};
+
+// Makes the value the result of the program, unless it's empty.
+class SetLastValue final : public Instruction {
+public:
+    explicit SetLastValue(Register src)
+        : Instruction(Type::SetLastValue)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_src;
+};
+
+// Ends a function body, with the value as its result. The scopes it's in must have been exited already.
+class Return final : public Instruction {
+public:
+    explicit Return(Register src)
+        : Instruction(Type::Return)
+        , m_src(src)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_src;
+};
+
+// Hands a node the generator doesn't know how to compile (yet) to the AST interpreter.
+class EvaluateAST final : public Instruction {
+public:
+    EvaluateAST(Register dst, const ASTNode& node)
+        : Instruction(Type::EvaluateAST)
+        , m_dst(dst)
+        , m_node(node)
+    {
+    }
+
+    void execute(Bytecode::Interpreter&) const;
+    String to_string(const Executable&) const;
+
+private:
+    Register m_dst;
+    const ASTNode& m_node;
+};
+
+}
@@ -120,9 +120,9 @@ class MarkedValueList;
 class NativeFunction;
 class NativeProperty;
 class PrimitiveString;
+class Program;
 class PromiseReaction;
-class PromiseReactionJob;
-class PromiseResolveThenableJob;
+class PropertyCache;
 class PropertyName;
 class Reference;
 class ScopeNode;
@@ -137,7 +137,14 @@ class Value;
 enum class DeclarationKind;
 struct AlreadyResolved;
 struct JobCallback;
+struct PromiseJob;
 struct PromiseCapability;
+struct Variable;
+struct VariableCache;
+
+// Some builtins have a second entry point that gets the this value and the arguments directly, and runs without a call
+// frame of its own. It returns an empty value for anything it can't handle, which then goes the regular way.
+using NativeFastPath = Value (*)(Value this_value, Span<const Value> arguments);
 
 // Not included in JS_ENUMERATE_NATIVE_OBJECTS due to missing distinct prototype
 class ProxyObject;
@@ -158,4 +165,12 @@ JS_ENUMERATE_TYPED_ARRAYS
 template<class T>
 class Handle;
 
+namespace Bytecode {
+class Executable;
+class Generator;
+class Instruction;
+class Interpreter;
+class Register;
+}
+
 }
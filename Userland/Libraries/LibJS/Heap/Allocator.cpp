@@ -5,7 +5,9 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/Debug.h>
 #include <LibJS/Heap/Allocator.h>
+#include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/HeapBlock.h>
 
 namespace JS {
@@ -21,12 +23,18 @@ Allocator::~Allocator()
 
 Cell* Allocator::allocate_cell(Heap& heap)
 {
-    if (m_usable_blocks.is_empty()) {
-        auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
-        m_usable_blocks.append(*block.leak_ptr());
+    // Before the heap grows, the blocks that are still waiting to be swept get a chance to make room.
+    while (m_usable_blocks.is_empty() && sweep_pending_block(heap)) {
     }
 
+    if (m_usable_blocks.is_empty())
+        m_usable_blocks.append(HeapBlock::create_with_cell_size(heap, m_cell_size));
+
     auto& block = *m_usable_blocks.last();
+    // A new cell isn't marked, so the block's sweep would free it right away.
+    if (block.needs_sweep())
+        heap.sweep_block({}, block);
+
     auto* cell = block.allocate();
     VERIFY(cell);
     if (block.is_full())
@@ -34,13 +42,43 @@ Cell* Allocator::allocate_cell(Heap& heap)
     return cell;
 }
 
-void Allocator::block_did_become_empty(Badge<Heap>, HeapBlock& block)
+void Allocator::schedule_lazy_sweep(Badge<Heap>)
+{
+    VERIFY(m_blocks_to_sweep.is_empty());
+    for_each_block([&](auto& block) {
+        block.set_needs_sweep(true);
+        m_blocks_to_sweep.append(&block);
+        return IterationDecision::Continue;
+    });
+}
+
+bool Allocator::sweep_pending_block(Heap& heap)
+{
+    while (!m_blocks_to_sweep.is_empty()) {
+        auto* block = m_blocks_to_sweep.take_last();
+        if (!block->needs_sweep())
+            continue;
+        bool block_was_full = block->is_full();
+        auto live_cells = heap.sweep_block({}, *block);
+        if (!live_cells) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
+            block_did_become_empty(*block);
+        } else if (block_was_full && !block->is_full()) {
+            dbgln_if(HEAP_DEBUG, " - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
+            block_did_become_usable(*block);
+        }
+        return true;
+    }
+    return false;
+}
+
+void Allocator::block_did_become_empty(HeapBlock& block)
 {
     block.m_list_node.remove();
-    delete &block;
+    HeapBlock::destroy(block);
 }
 
-void Allocator::block_did_become_usable(Badge<Heap>, HeapBlock& block)
+void Allocator::block_did_become_usable(HeapBlock& block)
 {
     VERIFY(!block.is_full());
     m_usable_blocks.append(block);
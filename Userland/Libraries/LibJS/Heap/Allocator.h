@@ -7,7 +7,6 @@
 #pragma once
 
 #include <AK/IntrusiveList.h>
-#include <AK/NonnullOwnPtr.h>
 #include <AK/Vector.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/HeapBlock.h>
@@ -37,15 +36,27 @@ public:
         return IterationDecision::Continue;
     }
 
-    void block_did_become_empty(Badge<Heap>, HeapBlock&);
-    void block_did_become_usable(Badge<Heap>, HeapBlock&);
+    void block_did_become_empty(Badge<Heap>, HeapBlock& block) { block_did_become_empty(block); }
+    void block_did_become_usable(Badge<Heap>, HeapBlock& block) { block_did_become_usable(block); }
+
+    // Flags every block as needing a sweep, which then happens a block at a time from sweep_pending_block(), or
+    // when the block is needed for an allocation.
+    void schedule_lazy_sweep(Badge<Heap>);
+    bool sweep_pending_block(Heap&);
 
 private:
+    void block_did_become_empty(HeapBlock&);
+    void block_did_become_usable(HeapBlock&);
+
     const size_t m_cell_size;
 
     typedef IntrusiveList<HeapBlock, RawPtr<HeapBlock>, &HeapBlock::m_list_node> BlockList;
     BlockList m_full_blocks;
     BlockList m_usable_blocks;
+
+    // Some of these may have been swept in the meantime to allocate from, so every one still has to be checked with
+    // HeapBlock::needs_sweep().
+    Vector<HeapBlock*> m_blocks_to_sweep;
 };
 
 }
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Assertions.h>
+#include <LibJS/Heap/BlockAllocator.h>
+#include <LibJS/Heap/HeapBlock.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+namespace JS {
+
+BlockAllocator::~BlockAllocator()
+{
+    for (auto* block : m_cached_blocks)
+        release_block(block);
+}
+
+void* BlockAllocator::allocate_block([[maybe_unused]] const char* name)
+{
+    if (!m_cached_blocks.is_empty())
+        return m_cached_blocks.take_last();
+
+#ifdef __serenity__
+    auto* block = serenity_mmap(nullptr, HeapBlock::block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_RANDOMIZED | MAP_PRIVATE, 0, 0, HeapBlock::block_size, name);
+    VERIFY(block != MAP_FAILED);
+#else
+    auto* block = aligned_alloc(HeapBlock::block_size, HeapBlock::block_size);
+    VERIFY(block);
+#endif
+    return block;
+}
+
+void BlockAllocator::deallocate_block(void* block)
+{
+    VERIFY(block);
+    m_cached_blocks.append(block);
+}
+
+void BlockAllocator::release_excess_blocks()
+{
+    while (m_cached_blocks.size() > max_cached_blocks)
+        release_block(m_cached_blocks.take_last());
+}
+
+void BlockAllocator::release_block(void* block)
+{
+#ifdef __serenity__
+    int rc = munmap(block, HeapBlock::block_size);
+    VERIFY(rc == 0);
+#else
+    free(block);
+#endif
+}
+
+}
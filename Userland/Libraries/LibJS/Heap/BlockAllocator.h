@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Vector.h>
+
+namespace JS {
+
+// Hands out the memory for HeapBlocks. Blocks that become empty are kept around for the next allocation of any size
+// class, instead of being unmapped and mapped again one at a time while a collection frees them. Once the sweep is
+// done, whatever doesn't fit in the cache goes back to the OS in one go.
+class BlockAllocator {
+    AK_MAKE_NONCOPYABLE(BlockAllocator);
+    AK_MAKE_NONMOVABLE(BlockAllocator);
+
+public:
+    static constexpr size_t max_cached_blocks = 64;
+
+    BlockAllocator() { }
+    ~BlockAllocator();
+
+    void* allocate_block(const char* name);
+    void deallocate_block(void*);
+
+    // Gives the blocks beyond max_cached_blocks back to the OS.
+    void release_excess_blocks();
+
+private:
+    static void release_block(void*);
+
+    Vector<void*> m_cached_blocks;
+};
+
+}
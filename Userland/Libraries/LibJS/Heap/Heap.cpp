@@ -7,6 +7,7 @@
 #include <AK/Badge.h>
 #include <AK/Debug.h>
 #include <AK/HashTable.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StackInfo.h>
 #include <AK/TemporaryChange.h>
 #include <LibCore/ElapsedTimer.h>
@@ -17,6 +18,7 @@
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Object.h>
 #include <setjmp.h>
+#include <time.h>
 
 namespace JS {
 
@@ -58,6 +60,11 @@ Cell* Heap::allocate_cell(size_t size)
         ++m_allocations_since_last_gc;
     }
 
+    // Rather than sweeping the whole heap at the end of a collection, every allocation sweeps one of the blocks left
+    // over from it, which spreads the work out until the next collection.
+    sweep_pending_blocks(1);
+
+    ++m_statistics.allocated_cells;
     auto& allocator = allocator_for_size(size);
     return allocator.allocate_cell(*this);
 }
@@ -67,16 +74,36 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     VERIFY(!m_collecting_garbage);
     TemporaryChange change(m_collecting_garbage, true);
 
+    if (collection_type == CollectionType::CollectGarbage && m_gc_deferrals) {
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    ScopeGuard update_statistics = [&] {
+        timespec end_time;
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+        u64 elapsed_us = (end_time.tv_sec - start_time.tv_sec) * 1'000'000 + (end_time.tv_nsec - start_time.tv_nsec) / 1000;
+        ++m_statistics.collections;
+        m_statistics.total_collection_time_us += elapsed_us;
+        m_statistics.longest_collection_time_us = max(m_statistics.longest_collection_time_us, elapsed_us);
+    };
+
     Core::ElapsedTimer collection_measurement_timer;
     collection_measurement_timer.start();
     if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
+        // Whatever the previous collection didn't get around to sweeping still has its marks set.
+        finish_sweeping();
         HashTable<Cell*> roots;
         gather_roots(roots);
         mark_live_cells(roots);
+        if (!print_report) {
+            schedule_lazy_sweep();
+            return;
+        }
+    } else {
+        finish_sweeping();
     }
     sweep_dead_cells(print_report, collection_measurement_timer);
 }
@@ -103,6 +130,16 @@ void Heap::gather_roots(HashTable<Cell*>& roots)
     }
 }
 
+// On 64-bit targets, a Value on the stack keeps its cell pointer in the low 48 bits and its tag in the upper ones.
+// Userspace pointers never use those upper bits, so clearing them turns a NaN-boxed cell back into its pointer
+// without changing any plain pointer.
+ALWAYS_INLINE static void add_possible_pointer(HashTable<FlatPtr>& possible_pointers, FlatPtr data)
+{
+    if constexpr (sizeof(FlatPtr) == sizeof(u64))
+        data &= 0x0000FFFFFFFFFFFFULL;
+    possible_pointers.set(data);
+}
+
 __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(HashTable<Cell*>& roots)
 {
     FlatPtr dummy;
@@ -117,14 +154,14 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     const FlatPtr* raw_jmp_buf = reinterpret_cast<const FlatPtr*>(buf);
 
     for (size_t i = 0; i < ((size_t)sizeof(buf)) / sizeof(FlatPtr); i += sizeof(FlatPtr))
-        possible_pointers.set(raw_jmp_buf[i]);
+        add_possible_pointer(possible_pointers, raw_jmp_buf[i]);
 
     FlatPtr stack_reference = reinterpret_cast<FlatPtr>(&dummy);
     auto& stack_info = m_vm.stack_info();
 
     for (FlatPtr stack_address = stack_reference; stack_address < stack_info.top(); stack_address += sizeof(FlatPtr)) {
         auto data = *reinterpret_cast<FlatPtr*>(stack_address);
-        possible_pointers.set(data);
+        add_possible_pointer(possible_pointers, data);
     }
 
     HashTable<HeapBlock*> all_live_heap_blocks;
@@ -151,6 +188,8 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
     }
 }
 
+// Cells are marked as soon as they're found, but their edges are only visited once they come off the work list.
+// Following the edges right away would recurse as deep as the longest chain of cells, e.g. a long linked list.
 class MarkingVisitor final : public Cell::Visitor {
 public:
     MarkingVisitor() { }
@@ -161,8 +200,17 @@ public:
             return;
         dbgln_if(HEAP_DEBUG, "  ! {}", cell);
         cell->set_marked(true);
-        cell->visit_edges(*this);
+        m_work_list.append(cell);
+    }
+
+    void mark_all_reachable_cells()
+    {
+        while (!m_work_list.is_empty())
+            m_work_list.take_last()->visit_edges(*this);
     }
+
+private:
+    Vector<Cell*> m_work_list;
 };
 
 void Heap::mark_live_cells(const HashTable<Cell*>& roots)
@@ -171,6 +219,52 @@ void Heap::mark_live_cells(const HashTable<Cell*>& roots)
     MarkingVisitor visitor;
     for (auto* root : roots)
         visitor.visit(root);
+    visitor.mark_all_reachable_cells();
+}
+
+Heap::SweepResult Heap::sweep_block(HeapBlock& block)
+{
+    SweepResult result;
+    block.set_needs_sweep(false);
+    block.for_each_cell([&](Cell* cell) {
+        if (!cell->is_live())
+            return;
+        if (!cell->is_marked()) {
+            dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
+            block.deallocate(cell);
+            ++result.collected_cells;
+        } else {
+            cell->set_marked(false);
+            ++result.live_cells;
+        }
+    });
+    return result;
+}
+
+void Heap::schedule_lazy_sweep()
+{
+    for (auto& allocator : m_allocators)
+        allocator->schedule_lazy_sweep({});
+    m_has_pending_sweep = true;
+}
+
+void Heap::sweep_pending_blocks(size_t max_block_count)
+{
+    if (!m_has_pending_sweep)
+        return;
+    size_t swept_blocks = 0;
+    for (auto& allocator : m_allocators) {
+        while (swept_blocks < max_block_count) {
+            if (!allocator->sweep_pending_block(*this))
+                break;
+            ++swept_blocks;
+        }
+        if (swept_blocks == max_block_count)
+            return;
+    }
+    // Every block has been swept, so the blocks that were freed along the way can be given back all at once.
+    m_has_pending_sweep = false;
+    m_block_allocator.release_excess_blocks();
 }
 
 void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
@@ -185,24 +279,13 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
     size_t live_cell_bytes = 0;
 
     for_each_block([&](auto& block) {
-        bool block_has_live_cells = false;
         bool block_was_full = block.is_full();
-        block.for_each_cell([&](Cell* cell) {
-            if (cell->is_live()) {
-                if (!cell->is_marked()) {
-                    dbgln_if(HEAP_DEBUG, "  ~ {}", cell);
-                    block.deallocate(cell);
-                    ++collected_cells;
-                    collected_cell_bytes += block.cell_size();
-                } else {
-                    cell->set_marked(false);
-                    block_has_live_cells = true;
-                    ++live_cells;
-                    live_cell_bytes += block.cell_size();
-                }
-            }
-        });
-        if (!block_has_live_cells)
+        auto result = sweep_block(block);
+        collected_cells += result.collected_cells;
+        collected_cell_bytes += result.collected_cells * block.cell_size();
+        live_cells += result.live_cells;
+        live_cell_bytes += result.live_cells * block.cell_size();
+        if (!result.live_cells)
             empty_blocks.append(&block);
         else if (block_was_full != block.is_full())
             full_blocks_that_became_usable.append(&block);
@@ -219,6 +302,8 @@ void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measure
         allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
     }
 
+    m_block_allocator.release_excess_blocks();
+
     if constexpr (HEAP_DEBUG) {
         for_each_block([&](auto& block) {
             dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
@@ -9,11 +9,13 @@
 #include <AK/HashTable.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
 #include <LibJS/Forward.h>
 #include <LibJS/Heap/Allocator.h>
+#include <LibJS/Heap/BlockAllocator.h>
 #include <LibJS/Heap/Handle.h>
 #include <LibJS/Runtime/Cell.h>
 #include <LibJS/Runtime/Object.h>
@@ -72,13 +74,39 @@ public:
     void defer_gc(Badge<DeferGC>);
     void undefer_gc(Badge<DeferGC>);
 
+    BlockAllocator& block_allocator() { return m_block_allocator; }
+
+    // Running totals since the heap was created (or the statistics were last reset), for anyone who wants to know what
+    // a piece of code costs.
+    // The pauses don't include the sweeping, which is spread out over the allocations that follow a collection.
+    struct Statistics {
+        u64 allocated_cells { 0 };
+        u64 collections { 0 };
+        u64 total_collection_time_us { 0 };
+        u64 longest_collection_time_us { 0 };
+    };
+    const Statistics& statistics() const { return m_statistics; }
+    void reset_statistics() { m_statistics = {}; }
+
+    // Returns the number of cells in the block that are still alive.
+    size_t sweep_block(Badge<Allocator>, HeapBlock& block) { return sweep_block(block).live_cells; }
+
 private:
     Cell* allocate_cell(size_t);
 
+    struct SweepResult {
+        size_t live_cells { 0 };
+        size_t collected_cells { 0 };
+    };
+
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
     void mark_live_cells(const HashTable<Cell*>& live_cells);
     void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    SweepResult sweep_block(HeapBlock&);
+    void schedule_lazy_sweep();
+    void sweep_pending_blocks(size_t max_block_count);
+    void finish_sweeping() { sweep_pending_blocks(NumericLimits<size_t>::max()); }
 
     Allocator& allocator_for_size(size_t);
 
@@ -98,15 +126,20 @@ private:
 
     VM& m_vm;
 
+    BlockAllocator m_block_allocator;
     Vector<NonnullOwnPtr<Allocator>> m_allocators;
     HashTable<HandleImpl*> m_handles;
 
     HashTable<MarkedValueList*> m_marked_value_lists;
 
+    bool m_has_pending_sweep { false };
+
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
 
     bool m_collecting_garbage { false };
+
+    Statistics m_statistics;
 };
 
 }
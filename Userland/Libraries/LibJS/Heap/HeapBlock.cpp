@@ -5,35 +5,26 @@
  */
 
 #include <AK/Assertions.h>
-#include <AK/NonnullOwnPtr.h>
+#include <LibJS/Heap/BlockAllocator.h>
+#include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/HeapBlock.h>
 #include <stdio.h>
-#include <sys/mman.h>
 
 namespace JS {
 
-NonnullOwnPtr<HeapBlock> HeapBlock::create_with_cell_size(Heap& heap, size_t cell_size)
+HeapBlock& HeapBlock::create_with_cell_size(Heap& heap, size_t cell_size)
 {
     char name[64];
     snprintf(name, sizeof(name), "LibJS: HeapBlock(%zu)", cell_size);
-#ifdef __serenity__
-    auto* block = (HeapBlock*)serenity_mmap(nullptr, block_size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_RANDOMIZED | MAP_PRIVATE, 0, 0, block_size, name);
-#else
-    auto* block = (HeapBlock*)aligned_alloc(block_size, block_size);
-#endif
-    VERIFY(block != MAP_FAILED);
-    new (block) HeapBlock(heap, cell_size);
-    return NonnullOwnPtr<HeapBlock>(NonnullOwnPtr<HeapBlock>::Adopt, *block);
+    auto* block = heap.block_allocator().allocate_block(name);
+    return *new (block) HeapBlock(heap, cell_size);
 }
 
-void HeapBlock::operator delete(void* ptr)
+void HeapBlock::destroy(HeapBlock& block)
 {
-#ifdef __serenity__
-    int rc = munmap(ptr, block_size);
-    VERIFY(rc == 0);
-#else
-    free(ptr);
-#endif
+    auto& heap = block.heap();
+    block.~HeapBlock();
+    heap.block_allocator().deallocate_block(&block);
 }
 
 HeapBlock::HeapBlock(Heap& heap, size_t cell_size)
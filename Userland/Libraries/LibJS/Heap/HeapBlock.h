@@ -19,14 +19,17 @@ class HeapBlock {
 
 public:
     static constexpr size_t block_size = 16 * KiB;
-    static NonnullOwnPtr<HeapBlock> create_with_cell_size(Heap&, size_t);
-
-    void operator delete(void*);
+    static HeapBlock& create_with_cell_size(Heap&, size_t);
+    static void destroy(HeapBlock&);
 
     size_t cell_size() const { return m_cell_size; }
     size_t cell_count() const { return (block_size - sizeof(HeapBlock)) / m_cell_size; }
     bool is_full() const { return !m_freelist; }
 
+    // Set on every block once marking is done, and cleared when the block has been swept.
+    bool needs_sweep() const { return m_needs_sweep; }
+    void set_needs_sweep(bool needs_sweep) { m_needs_sweep = needs_sweep; }
+
     ALWAYS_INLINE Cell* allocate()
     {
         if (!m_freelist)
@@ -89,6 +92,7 @@ private:
 
     Heap& m_heap;
     size_t m_cell_size { 0 };
+    bool m_needs_sweep { false };
     FreelistEntry* m_freelist { nullptr };
     alignas(Cell) u8 m_storage[];
 };
@@ -6,6 +6,8 @@
 
 #include <AK/StringBuilder.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/LexicalEnvironment.h>
@@ -35,6 +37,21 @@ Interpreter::~Interpreter()
 }
 
 void Interpreter::run(GlobalObject& global_object, const Program& program)
+{
+    run_in_global_call_frame(global_object, program, [&] {
+        program.execute(*this, global_object);
+    });
+}
+
+void Interpreter::run(GlobalObject& global_object, const Bytecode::Executable& executable)
+{
+    run_in_global_call_frame(global_object, executable.program(), [&] {
+        Bytecode::Interpreter bytecode_interpreter(*this, global_object);
+        bytecode_interpreter.run(executable);
+    });
+}
+
+void Interpreter::run_in_global_call_frame(GlobalObject& global_object, const Program& program, AK::Function<void()> callback)
 {
     auto& vm = this->vm();
     VERIFY(!vm.exception());
@@ -53,7 +70,7 @@ void Interpreter::run(GlobalObject& global_object, const Program& program)
     global_call_frame.is_strict_mode = program.is_strict_mode();
     vm.push_call_frame(global_call_frame, global_object);
     VERIFY(!vm.exception());
-    program.execute(*this, global_object);
+    callback();
     vm.pop_call_frame();
 
     // Whatever the promise jobs do should not affect the effective 'last value'.
@@ -84,25 +101,20 @@ void Interpreter::enter_scope(const ScopeNode& scope_node, ScopeType scope_type,
         return;
     }
 
-    HashMap<FlyString, Variable> scope_variables_with_declaration_kind;
-    scope_variables_with_declaration_kind.ensure_capacity(16);
-
-    for (auto& declaration : scope_node.variables()) {
-        for (auto& declarator : declaration.declarations()) {
-            if (is<Program>(scope_node)) {
+    if (is<Program>(scope_node)) {
+        for (auto& declaration : scope_node.variables()) {
+            for (auto& declarator : declaration.declarations()) {
                 global_object.put(declarator.id().string(), js_undefined());
                 if (exception())
                     return;
-            } else {
-                scope_variables_with_declaration_kind.set(declarator.id().string(), { js_undefined(), declaration.declaration_kind() });
             }
         }
     }
 
     bool pushed_lexical_environment = false;
 
-    if (!scope_variables_with_declaration_kind.is_empty()) {
-        auto* block_lexical_environment = heap().allocate<LexicalEnvironment>(global_object, move(scope_variables_with_declaration_kind), current_scope());
+    if (!is<Program>(scope_node) && !scope_node.variables().is_empty()) {
+        auto* block_lexical_environment = heap().allocate<LexicalEnvironment>(global_object, scope_node.block_environment_layout(), current_scope());
         vm().call_frame().scope = block_lexical_environment;
         pushed_lexical_environment = true;
     }
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/FlyString.h>
+#include <AK/Function.h>
 #include <AK/HashMap.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
@@ -47,6 +48,7 @@ public:
     ~Interpreter();
 
     void run(GlobalObject&, const Program&);
+    void run(GlobalObject&, const Bytecode::Executable&);
 
     GlobalObject& global_object();
     const GlobalObject& global_object() const;
@@ -80,13 +82,21 @@ public:
 
     Value execute_statement(GlobalObject&, const Statement&, ScopeType = ScopeType::Block);
 
+    void set_last_value(Badge<Bytecode::Interpreter>, Value value) { vm().set_last_value({}, value); }
+
+    // Counts the iterations of loops run by the AST interpreter, so ScriptFunction can tell how hot a call was.
+    void did_run_loop_iteration() { ++m_loop_iteration_count; }
+    u64 loop_iteration_count() const { return m_loop_iteration_count; }
+
 private:
     explicit Interpreter(VM&);
 
     void push_scope(ScopeFrame frame);
+    void run_in_global_call_frame(GlobalObject&, const Program&, AK::Function<void()>);
 
     Vector<ScopeFrame> m_scope_stack;
     ExecutingASTNodeChain* m_ast_node_chain { nullptr };
+    u64 m_loop_iteration_count { 0 };
 
     NonnullRefPtr<VM> m_vm;
 
@@ -2047,15 +2047,69 @@ void Parser::syntax_error(const String& message, Optional<Position> position)
     m_parser_state.m_errors.append({ message, position });
 }
 
+template<typename T>
+static Vector<size_t> scope_sizes(const Vector<NonnullRefPtrVector<T>>& scopes)
+{
+    Vector<size_t> sizes;
+    sizes.ensure_capacity(scopes.size());
+    for (auto& scope : scopes)
+        sizes.unchecked_append(scope.size());
+    return sizes;
+}
+
+template<typename T>
+static void restore_scope_sizes(Vector<NonnullRefPtrVector<T>>& scopes, const Vector<size_t>& sizes)
+{
+    // Every scope that was pushed after the state was saved has been popped again by now, or is popped here.
+    VERIFY(scopes.size() >= sizes.size());
+    scopes.shrink(sizes.size());
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        VERIFY(scopes[i].size() >= sizes[i]);
+        scopes[i].shrink(sizes[i]);
+    }
+}
+
 void Parser::save_state()
 {
-    m_saved_state.append(m_parser_state);
+    m_saved_state.append({
+        m_parser_state.m_lexer,
+        m_parser_state.m_current_token,
+        m_parser_state.m_errors.size(),
+        scope_sizes(m_parser_state.m_var_scopes),
+        scope_sizes(m_parser_state.m_let_scopes),
+        scope_sizes(m_parser_state.m_function_scopes),
+        m_parser_state.m_labels_in_scope,
+        m_parser_state.m_strict_mode,
+        m_parser_state.m_allow_super_property_lookup,
+        m_parser_state.m_allow_super_constructor_call,
+        m_parser_state.m_in_function_context,
+        m_parser_state.m_in_arrow_function_context,
+        m_parser_state.m_in_break_context,
+        m_parser_state.m_in_continue_context,
+        m_parser_state.m_string_legacy_octal_escape_sequence_in_scope,
+    });
 }
 
 void Parser::load_state()
 {
     VERIFY(!m_saved_state.is_empty());
-    m_parser_state = m_saved_state.take_last();
+    auto saved_state = m_saved_state.take_last();
+    m_parser_state.m_lexer = move(saved_state.lexer);
+    m_parser_state.m_current_token = move(saved_state.current_token);
+    VERIFY(m_parser_state.m_errors.size() >= saved_state.error_count);
+    m_parser_state.m_errors.shrink(saved_state.error_count);
+    restore_scope_sizes(m_parser_state.m_var_scopes, saved_state.var_scope_sizes);
+    restore_scope_sizes(m_parser_state.m_let_scopes, saved_state.let_scope_sizes);
+    restore_scope_sizes(m_parser_state.m_function_scopes, saved_state.function_scope_sizes);
+    m_parser_state.m_labels_in_scope = move(saved_state.labels_in_scope);
+    m_parser_state.m_strict_mode = saved_state.strict_mode;
+    m_parser_state.m_allow_super_property_lookup = saved_state.allow_super_property_lookup;
+    m_parser_state.m_allow_super_constructor_call = saved_state.allow_super_constructor_call;
+    m_parser_state.m_in_function_context = saved_state.in_function_context;
+    m_parser_state.m_in_arrow_function_context = saved_state.in_arrow_function_context;
+    m_parser_state.m_in_break_context = saved_state.in_break_context;
+    m_parser_state.m_in_continue_context = saved_state.in_continue_context;
+    m_parser_state.m_string_legacy_octal_escape_sequence_in_scope = saved_state.string_legacy_octal_escape_sequence_in_scope;
 }
 
 void Parser::discard_saved_state()
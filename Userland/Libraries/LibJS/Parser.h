@@ -207,6 +207,27 @@ private:
         explicit ParserState(Lexer);
     };
 
+    // What save_state() needs to go back to. Copying the whole ParserState would copy every declaration seen so
+    // far, which made speculative parsing quadratic in the size of the program. Since parsing only ever appends
+    // to the scopes that were there when the state was saved, remembering their sizes is enough to roll them back.
+    struct SavedState {
+        Lexer lexer;
+        Token current_token;
+        size_t error_count { 0 };
+        Vector<size_t> var_scope_sizes;
+        Vector<size_t> let_scope_sizes;
+        Vector<size_t> function_scope_sizes;
+        HashTable<StringView> labels_in_scope;
+        bool strict_mode { false };
+        bool allow_super_property_lookup { false };
+        bool allow_super_constructor_call { false };
+        bool in_function_context { false };
+        bool in_arrow_function_context { false };
+        bool in_break_context { false };
+        bool in_continue_context { false };
+        bool string_legacy_octal_escape_sequence_in_scope { false };
+    };
+
     class PositionKeyTraits {
     public:
         static int hash(const Position& position)
@@ -223,7 +244,7 @@ private:
     Vector<Position> m_rule_starts;
     ParserState m_parser_state;
     FlyString m_filename;
-    Vector<ParserState> m_saved_state;
+    Vector<SavedState> m_saved_state;
     HashMap<Position, TokenMemoization, PositionKeyTraits> m_token_memoizations;
 };
 }
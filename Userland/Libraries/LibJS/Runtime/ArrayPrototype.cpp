@@ -88,6 +88,24 @@ static Function* callback_from_args(GlobalObject& global_object, const String& n
     return &callback.as_function();
 }
 
+// A Proxy whose target is an array claims to be one as well, but its elements have to go through the traps.
+static bool is_plain_array(const Object& object)
+{
+    return is<Array>(object);
+}
+
+// The elements of a packed array are plain values that no getter or prototype can get in the way of, so they can be
+// read straight out of its storage. Everything else goes through Object::get().
+ALWAYS_INLINE static Value get_element(Object& object, bool is_array, size_t index)
+{
+    if (is_array) {
+        auto& indexed_properties = object.indexed_properties();
+        if (indexed_properties.is_packed() && index < indexed_properties.array_like_size())
+            return indexed_properties.packed_elements()[index];
+    }
+    return object.get(index);
+}
+
 static void for_each_item(VM& vm, GlobalObject& global_object, const String& name, AK::Function<IterationDecision(size_t index, Value value, Value callback_result)> callback, bool skip_empty = true)
 {
     auto* this_object = vm.this_value(global_object).to_object(global_object);
@@ -97,6 +115,7 @@ static void for_each_item(VM& vm, GlobalObject& global_object, const String& nam
     auto initial_length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return;
+    bool is_array = is_plain_array(*this_object);
 
     auto* callback_function = callback_from_args(global_object, name);
     if (!callback_function)
@@ -105,7 +124,7 @@ static void for_each_item(VM& vm, GlobalObject& global_object, const String& nam
     auto this_value = vm.argument(1);
 
     for (size_t i = 0; i < initial_length; ++i) {
-        auto value = this_object->get(i);
+        auto value = get_element(*this_object, is_array, i);
         if (vm.exception())
             return;
         if (value.is_empty()) {
@@ -276,13 +295,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::to_locale_string)
     auto length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
 
     String separator = ","; // NOTE: This is implementation-specific.
     StringBuilder builder;
     for (size_t i = 0; i < length; ++i) {
         if (i > 0)
             builder.append(separator);
-        auto value = this_object->get(i).value_or(js_undefined());
+        auto value = get_element(*this_object, is_array, i).value_or(js_undefined());
         if (vm.exception())
             return {};
         if (value.is_nullish())
@@ -320,6 +340,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::join)
     auto length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
     String separator = ",";
     if (!vm.argument(0).is_undefined()) {
         separator = vm.argument(0).to_string(global_object);
@@ -330,7 +351,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::join)
     for (size_t i = 0; i < length; ++i) {
         if (i > 0)
             builder.append(separator);
-        auto value = this_object->get(i).value_or(js_undefined());
+        auto value = get_element(*this_object, is_array, i).value_or(js_undefined());
         if (vm.exception())
             return {};
         if (value.is_nullish())
@@ -406,6 +427,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::slice)
             end_slice = array_size;
     }
 
+    if (is_plain_array(*array) && array->indexed_properties().is_packed() && start_slice >= 0 && start_slice < end_slice) {
+        auto elements = array->indexed_properties().packed_elements().slice(start_slice, end_slice - start_slice);
+        Vector<Value> values;
+        values.append(elements.data(), elements.size());
+        new_array->set_indexed_property_elements(move(values));
+        return new_array;
+    }
+
     for (ssize_t i = start_slice; i < end_slice; ++i) {
         new_array->indexed_properties().append(array->get(i));
         if (vm.exception())
@@ -423,6 +452,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
     i32 length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
     if (length == 0)
         return Value(-1);
     i32 from_index = 0;
@@ -437,7 +467,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
     }
     auto search_element = vm.argument(0);
     for (i32 i = from_index; i < length; ++i) {
-        auto element = this_object->get(i);
+        auto element = get_element(*this_object, is_array, i);
         if (vm.exception())
             return {};
         if (strict_eq(element, search_element))
@@ -455,6 +485,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reduce)
     auto initial_length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
 
     auto* callback_function = callback_from_args(global_object, "reduce");
     if (!callback_function)
@@ -468,7 +499,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reduce)
     } else {
         bool start_found = false;
         while (!start_found && start < initial_length) {
-            auto value = this_object->get(start);
+            auto value = get_element(*this_object, is_array, start);
             if (vm.exception())
                 return {};
             start_found = !value.is_empty();
@@ -485,7 +516,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reduce)
     auto this_value = js_undefined();
 
     for (size_t i = start; i < initial_length; ++i) {
-        auto value = this_object->get(i);
+        auto value = get_element(*this_object, is_array, i);
         if (vm.exception())
             return {};
         if (value.is_empty())
@@ -508,6 +539,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reduce_right)
     auto initial_length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
 
     auto* callback_function = callback_from_args(global_object, "reduceRight");
     if (!callback_function)
@@ -521,7 +553,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reduce_right)
     } else {
         bool start_found = false;
         while (!start_found && start >= 0) {
-            auto value = this_object->get(start);
+            auto value = get_element(*this_object, is_array, start);
             if (vm.exception())
                 return {};
             start_found = !value.is_empty();
@@ -538,7 +570,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reduce_right)
     auto this_value = js_undefined();
 
     for (int i = start; i >= 0; --i) {
-        auto value = this_object->get(i);
+        auto value = get_element(*this_object, is_array, i);
         if (vm.exception())
             return {};
         if (value.is_empty())
@@ -561,6 +593,13 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reverse)
     if (array->indexed_properties().is_empty())
         return array;
 
+    if (is_plain_array(*array) && array->indexed_properties().is_packed()) {
+        auto elements = array->indexed_properties().packed_elements();
+        for (size_t i = 0; i < elements.size() / 2; ++i)
+            swap(elements[i], elements[elements.size() - i - 1]);
+        return array;
+    }
+
     MarkedValueList array_reverse(vm.heap());
     auto size = array->indexed_properties().array_like_size();
     array_reverse.ensure_capacity(size);
@@ -576,111 +615,97 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::reverse)
     return array;
 }
 
-static void array_merge_sort(VM& vm, GlobalObject& global_object, Function* compare_func, MarkedValueList& arr_to_sort)
+static double compare_array_elements(VM& vm, GlobalObject& global_object, Function* compare_func, Value x, Value y)
 {
-    // FIXME: it would probably be better to switch to insertion sort for small arrays for
-    // better performance
-    if (arr_to_sort.size() <= 1)
-        return;
+    if (x.is_undefined() && y.is_undefined())
+        return 0;
+    if (x.is_undefined())
+        return 1;
+    if (y.is_undefined())
+        return -1;
+
+    if (compare_func) {
+        auto call_result = vm.call(*compare_func, js_undefined(), x, y);
+        if (vm.exception())
+            return 0;
+        if (call_result.is_nan())
+            return 0;
+        return call_result.to_double(global_object);
+    }
 
-    MarkedValueList left(vm.heap());
-    MarkedValueList right(vm.heap());
+    // FIXME: It would probably be much better to be smarter about this and implement
+    // the Abstract Relational Comparison in line once iterating over code points, rather
+    // than calling it twice after creating two primitive strings.
 
-    left.ensure_capacity(arr_to_sort.size() / 2);
-    right.ensure_capacity(arr_to_sort.size() / 2 + (arr_to_sort.size() & 1));
+    auto x_string = x.to_primitive_string(global_object);
+    if (vm.exception())
+        return 0;
+    auto y_string = y.to_primitive_string(global_object);
+    if (vm.exception())
+        return 0;
+
+    auto x_string_value = Value(x_string);
+    auto y_string_value = Value(y_string);
+
+    // Because they are called with primitive strings, these abstract_relation calls
+    // should never result in a VM exception.
+    auto x_lt_y_relation = abstract_relation(global_object, true, x_string_value, y_string_value);
+    VERIFY(x_lt_y_relation != TriState::Unknown);
+    auto y_lt_x_relation = abstract_relation(global_object, true, y_string_value, x_string_value);
+    VERIFY(y_lt_x_relation != TriState::Unknown);
+
+    if (x_lt_y_relation == TriState::True)
+        return -1;
+    if (y_lt_x_relation == TriState::True)
+        return 1;
+    return 0;
+}
 
-    for (size_t i = 0; i < arr_to_sort.size(); ++i) {
-        if (i < arr_to_sort.size() / 2) {
-            left.append(arr_to_sort[i]);
-        } else {
-            right.append(arr_to_sort[i]);
-        }
-    }
+// Sorts values[begin..end) in place. Both halves are merged into the scratch space, which is as large as the whole
+// list and shared by every level of the recursion, before being copied back.
+static void array_merge_sort(VM& vm, GlobalObject& global_object, Function* compare_func, MarkedValueList& values, MarkedValueList& scratch, size_t begin, size_t end)
+{
+    // FIXME: it would probably be better to switch to insertion sort for small arrays for
+    // better performance
+    if (end - begin <= 1)
+        return;
 
-    array_merge_sort(vm, global_object, compare_func, left);
+    auto middle = begin + (end - begin) / 2;
+    array_merge_sort(vm, global_object, compare_func, values, scratch, begin, middle);
     if (vm.exception())
         return;
-    array_merge_sort(vm, global_object, compare_func, right);
+    array_merge_sort(vm, global_object, compare_func, values, scratch, middle, end);
     if (vm.exception())
         return;
 
-    arr_to_sort.clear();
-
-    size_t left_index = 0, right_index = 0;
-
-    while (left_index < left.size() && right_index < right.size()) {
-        auto x = left[left_index];
-        auto y = right[right_index];
-
-        double comparison_result;
-
-        if (x.is_undefined() && y.is_undefined()) {
-            comparison_result = 0;
-        } else if (x.is_undefined()) {
-            comparison_result = 1;
-        } else if (y.is_undefined()) {
-            comparison_result = -1;
-        } else if (compare_func) {
-            auto call_result = vm.call(*compare_func, js_undefined(), left[left_index], right[right_index]);
-            if (vm.exception())
-                return;
-
-            if (call_result.is_nan()) {
-                comparison_result = 0;
-            } else {
-                comparison_result = call_result.to_double(global_object);
-                if (vm.exception())
-                    return;
-            }
-        } else {
-            // FIXME: It would probably be much better to be smarter about this and implement
-            // the Abstract Relational Comparison in line once iterating over code points, rather
-            // than calling it twice after creating two primitive strings.
+    size_t left_index = begin, right_index = middle, output_index = begin;
 
-            auto x_string = x.to_primitive_string(global_object);
-            if (vm.exception())
-                return;
-            auto y_string = y.to_primitive_string(global_object);
-            if (vm.exception())
-                return;
+    while (left_index < middle && right_index < end) {
+        auto comparison_result = compare_array_elements(vm, global_object, compare_func, values[left_index], values[right_index]);
+        if (vm.exception())
+            return;
 
-            auto x_string_value = Value(x_string);
-            auto y_string_value = Value(y_string);
+        if (comparison_result <= 0)
+            scratch[output_index++] = values[left_index++];
+        else
+            scratch[output_index++] = values[right_index++];
+    }
 
-            // Because they are called with primitive strings, these abstract_relation calls
-            // should never result in a VM exception.
-            auto x_lt_y_relation = abstract_relation(global_object, true, x_string_value, y_string_value);
-            VERIFY(x_lt_y_relation != TriState::Unknown);
-            auto y_lt_x_relation = abstract_relation(global_object, true, y_string_value, x_string_value);
-            VERIFY(y_lt_x_relation != TriState::Unknown);
+    while (left_index < middle)
+        scratch[output_index++] = values[left_index++];
 
-            if (x_lt_y_relation == TriState::True) {
-                comparison_result = -1;
-            } else if (y_lt_x_relation == TriState::True) {
-                comparison_result = 1;
-            } else {
-                comparison_result = 0;
-            }
-        }
+    while (right_index < end)
+        scratch[output_index++] = values[right_index++];
 
-        if (comparison_result <= 0) {
-            arr_to_sort.append(left[left_index]);
-            left_index++;
-        } else {
-            arr_to_sort.append(right[right_index]);
-            right_index++;
-        }
-    }
-
-    while (left_index < left.size()) {
-        arr_to_sort.append(left[left_index]);
-        left_index++;
-    }
+    for (size_t i = begin; i < end; ++i)
+        values[i] = scratch[i];
+}
 
-    while (right_index < right.size()) {
-        arr_to_sort.append(right[right_index]);
-        right_index++;
-    }
+static void array_merge_sort(VM& vm, GlobalObject& global_object, Function* compare_func, MarkedValueList& arr_to_sort)
+{
+    MarkedValueList scratch(vm.heap());
+    scratch.resize(arr_to_sort.size());
+    array_merge_sort(vm, global_object, compare_func, arr_to_sort, scratch, 0, arr_to_sort.size());
 }
 
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
@@ -701,13 +726,20 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
 
     MarkedValueList values_to_sort(vm.heap());
 
-    for (size_t i = 0; i < original_length; ++i) {
-        auto element_val = array->get(i);
-        if (vm.exception())
-            return {};
+    bool is_array = is_plain_array(*array);
+    auto& indexed_properties = array->indexed_properties();
+    if (is_array && indexed_properties.is_packed() && indexed_properties.array_like_size() == original_length) {
+        auto elements = indexed_properties.packed_elements();
+        values_to_sort.append(elements.data(), elements.size());
+    } else {
+        for (size_t i = 0; i < original_length; ++i) {
+            auto element_val = array->get(i);
+            if (vm.exception())
+                return {};
 
-        if (!element_val.is_empty())
-            values_to_sort.append(element_val);
+            if (!element_val.is_empty())
+                values_to_sort.append(element_val);
+        }
     }
 
     // Perform sorting by merge sort. This isn't as efficient compared to quick sort, but
@@ -719,6 +751,14 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     if (vm.exception())
         return {};
 
+    // The compare function may have changed the array in the meantime, so it may no longer be packed.
+    if (is_array && indexed_properties.is_packed() && indexed_properties.array_like_size() == values_to_sort.size()) {
+        auto elements = indexed_properties.packed_elements();
+        for (size_t i = 0; i < values_to_sort.size(); ++i)
+            elements[i] = values_to_sort[i];
+        return array;
+    }
+
     for (size_t i = 0; i < values_to_sort.size(); ++i) {
         array->put(i, values_to_sort[i]);
         if (vm.exception())
@@ -745,6 +785,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::last_index_of)
     i32 length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
     if (length == 0)
         return Value(-1);
     i32 from_index = length - 1;
@@ -759,7 +800,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::last_index_of)
     }
     auto search_element = vm.argument(0);
     for (i32 i = from_index; i >= 0; --i) {
-        auto element = this_object->get(i);
+        auto element = get_element(*this_object, is_array, i);
         if (vm.exception())
             return {};
         if (strict_eq(element, search_element))
@@ -776,6 +817,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
     i32 length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
     if (length == 0)
         return Value(false);
     i32 from_index = 0;
@@ -790,7 +832,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::includes)
     }
     auto value_to_find = vm.argument(0);
     for (i32 i = from_index; i < length; ++i) {
-        auto element = this_object->get(i).value_or(js_undefined());
+        auto element = get_element(*this_object, is_array, i).value_or(js_undefined());
         if (vm.exception())
             return {};
         if (same_value_zero(element, value_to_find))
@@ -864,6 +906,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::splice)
     auto initial_length = length_of_array_like(global_object, *this_object);
     if (vm.exception())
         return {};
+    bool is_array = is_plain_array(*this_object);
 
     auto relative_start = vm.argument(0).to_i32(global_object);
     if (vm.exception())
@@ -899,8 +942,24 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::splice)
 
     auto removed_elements = Array::create(global_object);
 
+    // All the arguments have been converted by now, so no code of the script's can change the array from here on.
+    if (is_array && this_object->is_extensible() && this_object->indexed_properties().is_packed() && this_object->indexed_properties().array_like_size() == initial_length) {
+        auto& indexed_properties = this_object->indexed_properties();
+        auto removed = indexed_properties.packed_elements().slice(actual_start, actual_delete_count);
+        Vector<Value> removed_values;
+        removed_values.append(removed.data(), removed.size());
+        removed_elements->set_indexed_property_elements(move(removed_values));
+
+        Vector<Value> inserted_values;
+        inserted_values.ensure_capacity(insert_count);
+        for (size_t i = 0; i < insert_count; ++i)
+            inserted_values.unchecked_append(vm.argument(i + 2));
+        indexed_properties.splice_packed(actual_start, actual_delete_count, inserted_values.span());
+        return removed_elements;
+    }
+
     for (size_t i = 0; i < actual_delete_count; ++i) {
-        auto value = this_object->get(actual_start + i);
+        auto value = get_element(*this_object, is_array, actual_start + i);
         if (vm.exception())
             return {};
 
@@ -909,7 +968,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::splice)
 
     if (insert_count < actual_delete_count) {
         for (size_t i = actual_start; i < initial_length - actual_delete_count; ++i) {
-            auto from = this_object->get(i + actual_delete_count);
+            auto from = get_element(*this_object, is_array, i + actual_delete_count);
             if (vm.exception())
                 return {};
 
@@ -931,7 +990,7 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::splice)
         }
     } else if (insert_count > actual_delete_count) {
         for (size_t i = initial_length - actual_delete_count; i > actual_start; --i) {
-            auto from = this_object->get(i + actual_delete_count - 1);
+            auto from = get_element(*this_object, is_array, i + actual_delete_count - 1);
             if (vm.exception())
                 return {};
 
@@ -218,6 +218,7 @@ namespace JS {
     P(sticky)                                \
     P(stringify)                             \
     P(substr)                                \
+    P(subarray)                              \
     P(substring)                             \
     P(tan)                                   \
     P(tanh)                                  \
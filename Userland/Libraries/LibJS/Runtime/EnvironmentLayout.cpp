@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibJS/Runtime/EnvironmentLayout.h>
+
+namespace JS {
+
+EnvironmentLayout::EnvironmentLayout()
+{
+    static u64 s_next_id = 1;
+    m_id = s_next_id++;
+}
+
+NonnullRefPtr<EnvironmentLayout> EnvironmentLayout::clone() const
+{
+    auto layout = create();
+    layout->m_indices = m_indices;
+    layout->m_declaration_kinds = m_declaration_kinds;
+    return layout;
+}
+
+size_t EnvironmentLayout::add(const FlyString& name, DeclarationKind declaration_kind)
+{
+    if (auto index = m_indices.get(name); index.has_value()) {
+        m_declaration_kinds[index.value()] = declaration_kind;
+        return index.value();
+    }
+    auto index = m_declaration_kinds.size();
+    m_indices.set(name, index);
+    m_declaration_kinds.append(declaration_kind);
+    return index;
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// The names a LexicalEnvironment binds, and the index of each in its flat list of variables.
+// All environments created for the same scope in the source share one layout, which is also what lets a VariableCache
+// tell whether it applies to the scope chain at hand.
+class EnvironmentLayout : public RefCounted<EnvironmentLayout> {
+public:
+    static NonnullRefPtr<EnvironmentLayout> create() { return adopt_ref(*new EnvironmentLayout); }
+    NonnullRefPtr<EnvironmentLayout> clone() const;
+
+    // Unlike the address, the ID of a layout is never reused, so it's safe to hold on to without keeping the layout alive.
+    u64 id() const { return m_id; }
+
+    size_t size() const { return m_declaration_kinds.size(); }
+    Optional<size_t> index_of(const FlyString& name) const { return m_indices.get(name); }
+    DeclarationKind declaration_kind(size_t index) const { return m_declaration_kinds[index]; }
+
+    // Declaring a name twice keeps its index, but takes on the newer declaration kind.
+    size_t add(const FlyString& name, DeclarationKind);
+
+private:
+    EnvironmentLayout();
+
+    u64 m_id { 0 };
+    HashMap<FlyString, size_t> m_indices;
+    Vector<DeclarationKind> m_declaration_kinds;
+};
+
+}
@@ -8,6 +8,7 @@
 #include <LibJS/Runtime/BoundFunction.h>
 #include <LibJS/Runtime/Function.h>
 #include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/Shape.h>
 
 namespace JS {
 
@@ -16,6 +17,11 @@ Function::Function(Object& prototype)
 {
 }
 
+Function::Function(Shape& shape)
+    : Object(shape)
+{
+}
+
 Function::Function(Object& prototype, Value bound_this, Vector<Value> bound_arguments)
     : Object(prototype)
     , m_bound_this(bound_this)
@@ -66,12 +72,35 @@ BoundFunction* Function::bind(Value bound_this_value, Vector<Value> arguments)
     return heap().allocate<BoundFunction>(global_object(), global_object(), target_function, bound_this_object, move(all_bound_arguments), computed_length, constructor_prototype);
 }
 
+Object* Function::create_instance(GlobalObject& global_object, Object* prototype)
+{
+    auto* default_shape = global_object.new_object_shape();
+    if (!prototype)
+        prototype = default_shape->prototype();
+    if (!m_instance_shape || m_instance_shape->prototype() != prototype || m_instance_shape->global_object() != &global_object) {
+        m_instance_shape = prototype == default_shape->prototype() ? default_shape : default_shape->create_prototype_transition(prototype);
+        m_instance_property_count = 0;
+    }
+    auto* instance = global_object.heap().allocate<Object>(global_object, *m_instance_shape);
+    instance->ensure_storage_capacity(m_instance_property_count);
+    return instance;
+}
+
+void Function::did_construct_instance(const Object& instance)
+{
+    // Objects with a unique shape are used as dictionaries, which says nothing about the next instance.
+    if (instance.shape().is_unique())
+        return;
+    m_instance_property_count = max(m_instance_property_count, instance.shape().property_count());
+}
+
 void Function::visit_edges(Visitor& visitor)
 {
     Object::visit_edges(visitor);
 
     visitor.visit(m_home_object);
     visitor.visit(m_bound_this);
+    visitor.visit(m_instance_shape);
 
     for (auto argument : m_bound_arguments)
         visitor.visit(argument);
@@ -42,10 +42,15 @@ public:
 
     virtual bool is_strict_mode() const { return false; }
 
+    // Creates the object that constructing this function starts out with, and learns from what it looks like afterwards.
+    Object* create_instance(GlobalObject&, Object* prototype);
+    void did_construct_instance(const Object&);
+
 protected:
     virtual void visit_edges(Visitor&) override;
 
     explicit Function(Object& prototype);
+    explicit Function(Shape&);
     Function(Object& prototype, Value bound_this, Vector<Value> bound_arguments);
 
 private:
@@ -54,6 +59,12 @@ private:
     Vector<Value> m_bound_arguments;
     Value m_home_object;
     ConstructorKind m_constructor_kind = ConstructorKind::Base;
+
+    // Every instance starts from the same shape, which already has the prototype, so that they all go through the same
+    // transitions instead of each of them getting shapes of their own. The property count they usually end up with
+    // says how much storage to reserve up front.
+    Shape* m_instance_shape { nullptr };
+    size_t m_instance_property_count { 0 };
 };
 
 }
@@ -33,6 +33,11 @@ public:
     Shape* new_object_shape() { return m_new_object_shape; }
     Shape* new_script_function_prototype_object_shape() { return m_new_script_function_prototype_object_shape; }
 
+    // The shape of the functions made by define_native_function(), which have nothing but a length and a name.
+    static constexpr size_t native_function_length_offset = 0;
+    static constexpr size_t native_function_name_offset = 1;
+    Shape* native_function_shape() { return m_native_function_shape; }
+
     // Not included in JS_ENUMERATE_NATIVE_OBJECTS due to missing distinct prototype
     ProxyConstructor* proxy_constructor() { return m_proxy_constructor; }
 
@@ -74,6 +79,7 @@ private:
     Shape* m_empty_object_shape { nullptr };
     Shape* m_new_object_shape { nullptr };
     Shape* m_new_script_function_prototype_object_shape { nullptr };
+    Shape* m_native_function_shape { nullptr };
 
     // Not included in JS_ENUMERATE_NATIVE_OBJECTS due to missing distinct prototype
     ProxyConstructor* m_proxy_constructor { nullptr };
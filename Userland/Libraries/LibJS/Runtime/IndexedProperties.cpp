@@ -16,6 +16,10 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     : m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto& value : m_packed_elements) {
+        if (value.is_empty())
+            ++m_hole_count;
+    }
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
@@ -43,45 +47,90 @@ void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttribute
     VERIFY(attributes == default_attributes);
 
     if (index >= m_array_size) {
+        // Every index that's skipped over, and the new one, start out as holes.
+        m_hole_count += index - m_array_size + 1;
         m_array_size = index + 1;
         grow_storage_if_needed();
     }
-    m_packed_elements[index] = value;
+    auto& element = m_packed_elements[index];
+    if (element.is_empty() && !value.is_empty())
+        --m_hole_count;
+    else if (!element.is_empty() && value.is_empty())
+        ++m_hole_count;
+    element = value;
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
-    if (index < m_array_size)
-        m_packed_elements[index] = {};
+    if (index >= m_array_size || m_packed_elements[index].is_empty())
+        return;
+    m_packed_elements[index] = {};
+    ++m_hole_count;
 }
 
 void SimpleIndexedPropertyStorage::insert(u32 index, Value value, PropertyAttributes attributes)
 {
     VERIFY(attributes == default_attributes);
     m_array_size++;
+    if (value.is_empty())
+        ++m_hole_count;
     m_packed_elements.insert(index, value);
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
-    return { m_packed_elements.take_first(), default_attributes };
+    auto first_element = m_packed_elements.take_first();
+    if (first_element.is_empty())
+        --m_hole_count;
+    return { first_element, default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
     auto last_element = m_packed_elements[m_array_size];
+    if (last_element.is_empty())
+        --m_hole_count;
     m_packed_elements[m_array_size] = {};
     return { last_element, default_attributes };
 }
 
 void SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
+    if (new_size > m_array_size) {
+        m_hole_count += new_size - m_array_size;
+    } else {
+        for (size_t i = new_size; i < m_array_size; ++i) {
+            if (m_packed_elements[i].is_empty())
+                --m_hole_count;
+        }
+    }
     m_array_size = new_size;
     m_packed_elements.resize(new_size);
 }
 
+void SimpleIndexedPropertyStorage::splice(size_t start, size_t delete_count, Span<const Value> values)
+{
+    VERIFY(start + delete_count <= m_array_size);
+    for (size_t i = start; i < start + delete_count; ++i) {
+        if (m_packed_elements[i].is_empty())
+            --m_hole_count;
+    }
+    for (auto& value : values) {
+        if (value.is_empty())
+            ++m_hole_count;
+    }
+
+    Vector<Value> new_elements;
+    new_elements.ensure_capacity(m_array_size - delete_count + values.size());
+    new_elements.append(m_packed_elements.data(), start);
+    new_elements.append(values.data(), values.size());
+    new_elements.append(m_packed_elements.data() + start + delete_count, m_array_size - start - delete_count);
+    m_array_size = new_elements.size();
+    m_packed_elements = move(new_elements);
+}
+
 GenericIndexedPropertyStorage::GenericIndexedPropertyStorage(SimpleIndexedPropertyStorage&& storage)
 {
     m_array_size = storage.array_like_size();
@@ -214,6 +263,12 @@ ValueAndAttributes IndexedPropertyIterator::value_and_attributes(Object* this_ob
 
 void IndexedPropertyIterator::skip_empty_indices()
 {
+    // Simple storage can tell about any index right away, rather than having to sort every index there is.
+    if (m_indexed_properties.m_storage->is_simple_storage()) {
+        while (m_index < m_indexed_properties.array_like_size() && !m_indexed_properties.has_index(m_index))
+            ++m_index;
+        return;
+    }
     auto indices = m_indexed_properties.indices();
     for (auto i : indices) {
         if (i < m_index)
@@ -242,7 +297,8 @@ Optional<ValueAndAttributes> IndexedProperties::get(Object* this_object, u32 ind
 
 void IndexedProperties::put(Object* this_object, u32 index, Value value, PropertyAttributes attributes, bool evaluate_accessors)
 {
-    if (m_storage->is_simple_storage() && (attributes != default_attributes || index > (array_like_size() + SPARSE_ARRAY_HOLE_THRESHOLD))) {
+    // Simple storage only holds plain values, which is what lets packed arrays be accessed without any checks.
+    if (m_storage->is_simple_storage() && (attributes != default_attributes || index > (array_like_size() + SPARSE_ARRAY_HOLE_THRESHOLD) || value.is_accessor() || value.is_native_property())) {
         switch_to_generic_storage();
     }
 
@@ -347,6 +403,12 @@ Vector<u32> IndexedProperties::indices() const
     return indices;
 }
 
+void IndexedProperties::splice_packed(size_t start, size_t delete_count, Span<const Value> values)
+{
+    VERIFY(is_packed());
+    static_cast<SimpleIndexedPropertyStorage&>(*m_storage).splice(start, delete_count, values);
+}
+
 void IndexedProperties::switch_to_generic_storage()
 {
     auto& storage = static_cast<SimpleIndexedPropertyStorage&>(*m_storage);
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Span.h>
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/Value.h>
 
@@ -62,12 +63,24 @@ public:
     virtual bool is_simple_storage() const override { return true; }
     const Vector<Value>& elements() const { return m_packed_elements; }
 
+    // Packed storage has no holes, so every index below the array-like size holds a plain value.
+    bool is_packed() const { return !m_hole_count; }
+    Span<Value> packed_elements()
+    {
+        VERIFY(is_packed());
+        return m_packed_elements.span().trim(m_array_size);
+    }
+
+    void splice(size_t start, size_t delete_count, Span<const Value> values);
+
 private:
     friend GenericIndexedPropertyStorage;
 
     void grow_storage_if_needed();
 
     size_t m_array_size { 0 };
+    // The number of empty values below m_array_size.
+    size_t m_hole_count { 0 };
     Vector<Value> m_packed_elements;
 };
 
@@ -144,6 +157,14 @@ public:
 
     Vector<u32> indices() const;
 
+    // Whether the elements are stored contiguously and without holes. Arrays can then skip Object::get() and friends,
+    // since no getter, setter or prototype can be involved in accessing an element that's there.
+    bool is_packed() const { return m_storage->is_simple_storage() && static_cast<const SimpleIndexedPropertyStorage&>(*m_storage).is_packed(); }
+    // Values written through this must not be empty, or the storage would lose track of its holes.
+    Span<Value> packed_elements() { return static_cast<SimpleIndexedPropertyStorage&>(*m_storage).packed_elements(); }
+    // Equivalent to removing delete_count elements at start and then inserting the values there, for packed storage.
+    void splice_packed(size_t start, size_t delete_count, Span<const Value> values);
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
@@ -157,6 +178,8 @@ public:
     }
 
 private:
+    friend IndexedPropertyIterator;
+
     void switch_to_generic_storage();
 
     NonnullOwnPtr<IndexedPropertyStorage> m_storage { make<SimpleIndexedPropertyStorage>() };
@@ -5,9 +5,6 @@
  */
 
 #include <AK/Function.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonParser.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigIntObject.h>
@@ -15,9 +12,12 @@
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/JSONObject.h>
+#include <LibJS/Runtime/MarkedValueList.h>
 #include <LibJS/Runtime/NumberObject.h>
 #include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/StringObject.h>
+#include <stdlib.h>
 
 namespace JS {
 
@@ -106,13 +106,9 @@ String JSONObject::stringify_impl(GlobalObject& global_object, Value value, Valu
     wrapper->define_property(String::empty(), value);
     if (vm.exception())
         return {};
-    auto result = serialize_json_property(global_object, state, String::empty(), wrapper);
-    if (vm.exception())
-        return {};
-    if (result.is_null())
+    if (!serialize_json_property(global_object, state, String::empty(), wrapper))
         return {};
-
-    return result;
+    return state.builder.to_string();
 }
 
 JS_DEFINE_NATIVE_FUNCTION(JSONObject::stringify)
@@ -131,27 +127,27 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::stringify)
     return js_string(vm, string);
 }
 
-String JSONObject::serialize_json_property(GlobalObject& global_object, StringifyState& state, const PropertyName& key, Object* holder)
+bool JSONObject::serialize_json_property(GlobalObject& global_object, StringifyState& state, const PropertyName& key, Object* holder)
 {
     auto& vm = global_object.vm();
     auto value = holder->get(key);
     if (vm.exception())
-        return {};
+        return false;
     if (value.is_object()) {
         auto to_json = value.as_object().get(vm.names.toJSON);
         if (vm.exception())
-            return {};
+            return false;
         if (to_json.is_function()) {
             value = vm.call(to_json.as_function(), value, js_string(vm, key.to_string()));
             if (vm.exception())
-                return {};
+                return false;
         }
     }
 
     if (state.replacer_function) {
         value = vm.call(*state.replacer_function, holder, js_string(vm, key.to_string()), value);
         if (vm.exception())
-            return {};
+            return false;
     }
 
     if (value.is_object()) {
@@ -160,53 +156,76 @@ String JSONObject::serialize_json_property(GlobalObject& global_object, Stringif
             value = value_object.value_of();
     }
 
-    if (value.is_null())
-        return "null";
-    if (value.is_boolean())
-        return value.as_bool() ? "true" : "false";
-    if (value.is_string())
-        return quote_json_string(value.as_string().string());
+    auto& builder = state.builder;
+    if (value.is_null()) {
+        builder.append("null");
+        return true;
+    }
+    if (value.is_boolean()) {
+        builder.append(value.as_bool() ? "true" : "false");
+        return true;
+    }
+    if (value.is_string()) {
+        quote_json_string(builder, value.as_string().string());
+        return true;
+    }
     if (value.is_number()) {
-        if (value.is_finite_number())
-            return value.to_string(global_object);
-        return "null";
+        if (value.is_int32())
+            builder.appendff("{}", value.as_i32());
+        else if (value.is_finite_number())
+            builder.append(value.to_string(global_object));
+        else
+            builder.append("null");
+        return true;
     }
     if (value.is_object() && !value.is_function()) {
         if (value.is_array())
-            return serialize_json_array(global_object, state, static_cast<Array&>(value.as_object()));
-        return serialize_json_object(global_object, state, value.as_object());
+            serialize_json_array(global_object, state, static_cast<Array&>(value.as_object()));
+        else
+            serialize_json_object(global_object, state, value.as_object());
+        return !vm.exception();
     }
     if (value.is_bigint())
         vm.throw_exception<TypeError>(global_object, ErrorType::JsonBigInt);
-    return {};
+    return false;
 }
 
-String JSONObject::serialize_json_object(GlobalObject& global_object, StringifyState& state, Object& object)
+void JSONObject::serialize_json_object(GlobalObject& global_object, StringifyState& state, Object& object)
 {
     auto& vm = global_object.vm();
     if (state.seen_objects.contains(&object)) {
         vm.throw_exception<TypeError>(global_object, ErrorType::JsonCircular);
-        return {};
+        return;
     }
 
     state.seen_objects.set(&object);
     String previous_indent = state.indent;
     state.indent = String::formatted("{}{}", state.indent, state.gap);
-    Vector<String> property_strings;
+
+    auto& builder = state.builder;
+    builder.append('{');
+    bool is_empty = true;
 
     auto process_property = [&](const PropertyName& key) {
         if (key.is_symbol())
             return;
-        auto serialized_property_string = serialize_json_property(global_object, state, key, &object);
-        if (vm.exception())
+        // The key is written before we know whether the value serializes to anything at all, so it may have to be taken back.
+        auto length_before_property = builder.length();
+        if (!is_empty)
+            builder.append(',');
+        if (!state.gap.is_empty()) {
+            builder.append('\n');
+            builder.append(state.indent);
+        }
+        quote_json_string(builder, key.to_string());
+        builder.append(':');
+        if (!state.gap.is_empty())
+            builder.append(' ');
+        if (!serialize_json_property(global_object, state, key, &object)) {
+            builder.trim(builder.length() - length_before_property);
             return;
-        if (!serialized_property_string.is_null()) {
-            property_strings.append(String::formatted(
-                "{}:{}{}",
-                quote_json_string(key.to_string()),
-                state.gap.is_empty() ? "" : " ",
-                serialized_property_string));
         }
+        is_empty = false;
     };
 
     if (state.property_list.has_value()) {
@@ -214,7 +233,7 @@ String JSONObject::serialize_json_object(GlobalObject& global_object, StringifyS
         for (auto& property : property_list) {
             process_property(property);
             if (vm.exception())
-                return {};
+                return;
         }
     } else {
         for (auto& entry : object.indexed_properties()) {
@@ -223,121 +242,79 @@ String JSONObject::serialize_json_object(GlobalObject& global_object, StringifyS
                 continue;
             process_property(entry.index());
             if (vm.exception())
-                return {};
+                return;
         }
         for (auto& [key, metadata] : object.shape().property_table_ordered()) {
             if (!metadata.attributes.is_enumerable())
                 continue;
             process_property(key);
             if (vm.exception())
-                return {};
+                return;
         }
     }
-    StringBuilder builder;
-    if (property_strings.is_empty()) {
-        builder.append("{}");
-    } else {
-        bool first = true;
-        builder.append('{');
-        if (state.gap.is_empty()) {
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(',');
-                first = false;
-                builder.append(property_string);
-            }
-        } else {
-            builder.append('\n');
-            builder.append(state.indent);
-            auto separator = String::formatted(",\n{}", state.indent);
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(separator);
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append('\n');
-            builder.append(previous_indent);
-        }
-        builder.append('}');
+
+    if (!is_empty && !state.gap.is_empty()) {
+        builder.append('\n');
+        builder.append(previous_indent);
     }
+    builder.append('}');
 
     state.seen_objects.remove(&object);
     state.indent = previous_indent;
-    return builder.to_string();
 }
 
-String JSONObject::serialize_json_array(GlobalObject& global_object, StringifyState& state, Object& object)
+void JSONObject::serialize_json_array(GlobalObject& global_object, StringifyState& state, Object& object)
 {
     auto& vm = global_object.vm();
     if (state.seen_objects.contains(&object)) {
         vm.throw_exception<TypeError>(global_object, ErrorType::JsonCircular);
-        return {};
+        return;
     }
 
     state.seen_objects.set(&object);
     String previous_indent = state.indent;
     state.indent = String::formatted("{}{}", state.indent, state.gap);
-    Vector<String> property_strings;
 
     auto length = length_of_array_like(global_object, object);
     if (vm.exception())
-        return {};
-    for (size_t i = 0; i < length; ++i) {
-        if (vm.exception())
-            return {};
-        auto serialized_property_string = serialize_json_property(global_object, state, i, &object);
-        if (vm.exception())
-            return {};
-        if (serialized_property_string.is_null()) {
-            property_strings.append("null");
-        } else {
-            property_strings.append(serialized_property_string);
-        }
-    }
+        return;
 
-    StringBuilder builder;
-    if (property_strings.is_empty()) {
-        builder.append("[]");
-    } else {
-        if (state.gap.is_empty()) {
-            builder.append('[');
-            bool first = true;
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(',');
-                first = false;
-                builder.append(property_string);
-            }
-            builder.append(']');
-        } else {
-            builder.append("[\n");
-            builder.append(state.indent);
-            auto separator = String::formatted(",\n{}", state.indent);
-            bool first = true;
-            for (auto& property_string : property_strings) {
-                if (!first)
-                    builder.append(separator);
-                first = false;
-                builder.append(property_string);
-            }
+    auto& builder = state.builder;
+    builder.append('[');
+    for (size_t i = 0; i < length; ++i) {
+        if (i > 0)
+            builder.append(',');
+        if (!state.gap.is_empty()) {
             builder.append('\n');
-            builder.append(previous_indent);
-            builder.append(']');
+            builder.append(state.indent);
+        }
+        if (!serialize_json_property(global_object, state, i, &object)) {
+            if (vm.exception())
+                return;
+            builder.append("null");
         }
     }
+    if (length > 0 && !state.gap.is_empty()) {
+        builder.append('\n');
+        builder.append(previous_indent);
+    }
+    builder.append(']');
 
     state.seen_objects.remove(&object);
     state.indent = previous_indent;
-    return builder.to_string();
 }
 
-String JSONObject::quote_json_string(String string)
+void JSONObject::quote_json_string(StringBuilder& builder, const StringView& string)
 {
     // FIXME: Handle UTF16
-    StringBuilder builder;
     builder.append('"');
-    for (auto& ch : string) {
+    size_t unescaped_start = 0;
+    for (size_t i = 0; i < string.length(); ++i) {
+        u8 ch = string[i];
+        if (ch >= 0x20 && ch != '"' && ch != '\\')
+            continue;
+        builder.append(string.substring_view(unescaped_start, i - unescaped_start));
+        unescaped_start = i + 1;
         switch (ch) {
         case '\b':
             builder.append("\\b");
@@ -361,17 +338,336 @@ String JSONObject::quote_json_string(String string)
             builder.append("\\\\");
             break;
         default:
-            if (ch < 0x20) {
-                builder.appendff("\\u{:04x}", ch);
-            } else {
-                builder.append(ch);
-            }
+            builder.appendff("\\u{:04x}", ch);
         }
     }
+    builder.append(string.substring_view(unescaped_start, string.length() - unescaped_start));
     builder.append('"');
-    return builder.to_string();
 }
 
+// Builds the JS values straight from the text, instead of building an AK::JsonValue first and converting that.
+class JSONParser {
+public:
+    JSONParser(GlobalObject& global_object, const StringView& input)
+        : m_global_object(global_object)
+        , m_input(input)
+    {
+    }
+
+    // Returns an empty value if the input isn't valid JSON.
+    Value parse()
+    {
+        auto value = parse_value();
+        if (value.is_empty())
+            return {};
+        skip_whitespace();
+        if (m_position != m_input.length())
+            return {};
+        return value;
+    }
+
+private:
+    char peek() const { return m_position < m_input.length() ? m_input[m_position] : 0; }
+
+    bool consume_specific(char ch)
+    {
+        if (peek() != ch)
+            return false;
+        ++m_position;
+        return true;
+    }
+
+    bool consume_specific(const StringView& string)
+    {
+        if (!m_input.substring_view(m_position).starts_with(string))
+            return false;
+        m_position += string.length();
+        return true;
+    }
+
+    void skip_whitespace()
+    {
+        while (m_position < m_input.length()) {
+            auto ch = m_input[m_position];
+            if (ch != ' ' && ch != '\t' && ch != '\n' && ch != '\r')
+                break;
+            ++m_position;
+        }
+    }
+
+    Value parse_value()
+    {
+        skip_whitespace();
+        switch (peek()) {
+        case '{':
+            ++m_position;
+            return parse_object();
+        case '[':
+            ++m_position;
+            return parse_array();
+        case '"': {
+            auto string = parse_string();
+            if (!string.has_value())
+                return {};
+            return js_string(m_global_object.heap(), String(string.value()));
+        }
+        case 't':
+            return consume_specific("true") ? Value(true) : Value();
+        case 'f':
+            return consume_specific("false") ? Value(false) : Value();
+        case 'n':
+            return consume_specific("null") ? js_null() : Value();
+        default:
+            return parse_number();
+        }
+    }
+
+    Value parse_object()
+    {
+        Vector<FlyString> keys;
+        skip_whitespace();
+        if (!consume_specific('}')) {
+            for (;;) {
+                skip_whitespace();
+                auto key = parse_string();
+                if (!key.has_value())
+                    return {};
+                keys.append(FlyString(key.value()));
+                skip_whitespace();
+                if (!consume_specific(':'))
+                    return {};
+                auto value = parse_value();
+                if (value.is_empty())
+                    return {};
+                m_pending_values.append(value);
+                skip_whitespace();
+                if (consume_specific(','))
+                    continue;
+                if (consume_specific('}'))
+                    break;
+                return {};
+            }
+        }
+        auto* object = create_object(keys, m_pending_values.span().slice(m_pending_values.size() - keys.size()));
+        m_pending_values.shrink(m_pending_values.size() - keys.size(), true);
+        return object;
+    }
+
+    // Objects with the same keys end up with the same shape, which is found by following put transitions from the empty
+    // object's shape. Once that's done, the values are stored without looking up every key in every intermediate shape.
+    Object* create_object(const Vector<FlyString>& keys, Span<const Value> values)
+    {
+        if (can_follow_shape_transitions(keys)) {
+            auto* shape = m_global_object.new_object_shape();
+            for (auto& key : keys)
+                shape = shape->create_put_transition(key, default_attributes);
+            auto* object = m_global_object.heap().allocate<Object>(m_global_object, *shape);
+            for (size_t i = 0; i < values.size(); ++i)
+                object->put_direct(i, values[i]);
+            return object;
+        }
+
+        auto* object = Object::create_empty(m_global_object);
+        for (size_t i = 0; i < keys.size(); ++i)
+            object->define_property(keys[i], values[i]);
+        return object;
+    }
+
+    // Anything define_property() wouldn't simply add to the shape as a new property has to go through it.
+    static bool can_follow_shape_transitions(const Vector<FlyString>& keys)
+    {
+        // Objects with more properties than this get a unique shape (see Object::put_own_property()).
+        if (keys.size() > 100)
+            return false;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i].to_int().value_or(-1) >= 0)
+                return false;
+            for (size_t j = 0; j < i; ++j) {
+                if (keys[i] == keys[j])
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    Value parse_array()
+    {
+        // The elements go straight into the array, which is kept alive by being on the stack.
+        auto* array = Array::create(m_global_object);
+        skip_whitespace();
+        if (!consume_specific(']')) {
+            for (;;) {
+                auto value = parse_value();
+                if (value.is_empty())
+                    return {};
+                array->indexed_properties().append(value);
+                skip_whitespace();
+                if (consume_specific(','))
+                    continue;
+                if (consume_specific(']'))
+                    break;
+                return {};
+            }
+        }
+        return array;
+    }
+
+    Value parse_number()
+    {
+        auto is_digit = [](char ch) { return ch >= '0' && ch <= '9'; };
+
+        auto start = m_position;
+        bool is_negative = consume_specific('-');
+        if (!is_digit(peek()))
+            return {};
+        if (!consume_specific('0')) {
+            while (is_digit(peek()))
+                ++m_position;
+        }
+        bool is_integer = true;
+        if (consume_specific('.')) {
+            is_integer = false;
+            if (!is_digit(peek()))
+                return {};
+            while (is_digit(peek()))
+                ++m_position;
+        }
+        if (consume_specific('e') || consume_specific('E')) {
+            is_integer = false;
+            if (!consume_specific('+'))
+                consume_specific('-');
+            if (!is_digit(peek()))
+                return {};
+            while (is_digit(peek()))
+                ++m_position;
+        }
+
+        auto text = m_input.substring_view(start, m_position - start);
+        // Nine digits always fit into an i32.
+        if (is_integer && text.length() <= (is_negative ? 10u : 9u)) {
+            i32 value = 0;
+            for (size_t i = is_negative ? 1 : 0; i < text.length(); ++i)
+                value = value * 10 + (text[i] - '0');
+            if (is_negative)
+                return value == 0 ? Value(-0.0) : Value(-value);
+            return Value(value);
+        }
+        // strtod() wants a null-terminated string.
+        return Value(strtod(String(text).characters(), nullptr));
+    }
+
+    Optional<u16> parse_hex4()
+    {
+        if (m_input.length() - m_position < 4)
+            return {};
+        u16 value = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            auto ch = m_input[m_position++];
+            value <<= 4;
+            if (ch >= '0' && ch <= '9')
+                value |= ch - '0';
+            else if (ch >= 'a' && ch <= 'f')
+                value |= ch - 'a' + 10;
+            else if (ch >= 'A' && ch <= 'F')
+                value |= ch - 'A' + 10;
+            else
+                return {};
+        }
+        return value;
+    }
+
+    // Strings without escapes are views into the input, the others are unescaped into a builder that's reused for the next one.
+    Optional<StringView> parse_string()
+    {
+        if (!consume_specific('"'))
+            return {};
+        auto start = m_position;
+        while (m_position < m_input.length()) {
+            auto ch = m_input[m_position];
+            if (ch == '"') {
+                ++m_position;
+                return m_input.substring_view(start, m_position - start - 1);
+            }
+            if (ch == '\\')
+                break;
+            if ((u8)ch < 0x20)
+                return {};
+            ++m_position;
+        }
+
+        m_builder.clear();
+        m_builder.append(m_input.substring_view(start, m_position - start));
+        while (m_position < m_input.length()) {
+            auto ch = m_input[m_position++];
+            if (ch == '"')
+                return m_builder.string_view();
+            if ((u8)ch < 0x20)
+                return {};
+            if (ch != '\\') {
+                m_builder.append(ch);
+                continue;
+            }
+            switch (peek()) {
+            case '"':
+            case '\\':
+            case '/':
+                m_builder.append(m_input[m_position++]);
+                break;
+            case 'b':
+                ++m_position;
+                m_builder.append('\b');
+                break;
+            case 'f':
+                ++m_position;
+                m_builder.append('\f');
+                break;
+            case 'n':
+                ++m_position;
+                m_builder.append('\n');
+                break;
+            case 'r':
+                ++m_position;
+                m_builder.append('\r');
+                break;
+            case 't':
+                ++m_position;
+                m_builder.append('\t');
+                break;
+            case 'u': {
+                ++m_position;
+                auto code_unit = parse_hex4();
+                if (!code_unit.has_value())
+                    return {};
+                u32 code_point = code_unit.value();
+                if (code_point >= 0xd800 && code_point <= 0xdbff && m_input.substring_view(m_position).starts_with("\\u")) {
+                    auto position_before_low_surrogate = m_position;
+                    m_position += 2;
+                    auto low_surrogate = parse_hex4();
+                    if (low_surrogate.has_value() && low_surrogate.value() >= 0xdc00 && low_surrogate.value() <= 0xdfff)
+                        code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low_surrogate.value() - 0xdc00);
+                    else
+                        m_position = position_before_low_surrogate;
+                }
+                m_builder.append_code_point(code_point);
+                break;
+            }
+            default:
+                return {};
+            }
+        }
+        return {};
+    }
+
+    GlobalObject& m_global_object;
+    StringView m_input;
+    size_t m_position { 0 };
+    StringBuilder m_builder;
+
+    // The values of all objects that are still being parsed. Sharing one list keeps them alive without registering
+    // a MarkedValueList with the heap for every single object.
+    MarkedValueList m_pending_values { m_global_object.heap() };
+};
+
 JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
 {
     if (!vm.argument_count())
@@ -381,12 +677,11 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
         return {};
     auto reviver = vm.argument(1);
 
-    auto json = JsonValue::from_string(string);
-    if (!json.has_value()) {
+    auto result = JSONParser(global_object, string).parse();
+    if (result.is_empty()) {
         vm.throw_exception<SyntaxError>(global_object, ErrorType::JsonMalformed);
         return {};
     }
-    Value result = parse_json_value(global_object, json.value());
     if (reviver.is_function()) {
         auto* holder_object = Object::create_empty(global_object);
         holder_object->define_property(String::empty(), result);
@@ -397,44 +692,6 @@ JS_DEFINE_NATIVE_FUNCTION(JSONObject::parse)
     return result;
 }
 
-Value JSONObject::parse_json_value(GlobalObject& global_object, const JsonValue& value)
-{
-    if (value.is_object())
-        return Value(parse_json_object(global_object, value.as_object()));
-    if (value.is_array())
-        return Value(parse_json_array(global_object, value.as_array()));
-    if (value.is_null())
-        return js_null();
-    if (value.is_double())
-        return Value(value.as_double());
-    if (value.is_number())
-        return Value(value.to_i32(0));
-    if (value.is_string())
-        return js_string(global_object.heap(), value.to_string());
-    if (value.is_bool())
-        return Value(static_cast<bool>(value.as_bool()));
-    VERIFY_NOT_REACHED();
-}
-
-Object* JSONObject::parse_json_object(GlobalObject& global_object, const JsonObject& json_object)
-{
-    auto* object = Object::create_empty(global_object);
-    json_object.for_each_member([&](auto& key, auto& value) {
-        object->define_property(key, parse_json_value(global_object, value));
-    });
-    return object;
-}
-
-Array* JSONObject::parse_json_array(GlobalObject& global_object, const JsonArray& json_array)
-{
-    auto* array = Array::create(global_object);
-    size_t index = 0;
-    json_array.for_each([&](auto& value) {
-        array->define_property(index++, parse_json_value(global_object, value));
-    });
-    return array;
-}
-
 Value JSONObject::internalize_json_property(GlobalObject& global_object, Object* holder, const PropertyName& name, Function& reviver)
 {
     auto& vm = global_object.vm();
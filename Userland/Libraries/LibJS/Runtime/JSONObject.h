@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/StringBuilder.h>
 #include <LibJS/Runtime/Object.h>
 
 namespace JS {
@@ -29,18 +30,17 @@ private:
         String indent { String::empty() };
         String gap;
         Optional<Vector<String>> property_list;
+        // Everything is serialized straight into this, instead of into strings for every value that are joined later.
+        StringBuilder builder;
     };
 
-    // Stringify helpers
-    static String serialize_json_property(GlobalObject&, StringifyState&, const PropertyName& key, Object* holder);
-    static String serialize_json_object(GlobalObject&, StringifyState&, Object&);
-    static String serialize_json_array(GlobalObject&, StringifyState&, Object&);
-    static String quote_json_string(String);
+    // Stringify helpers, which return false if there was nothing to serialize (or an exception).
+    static bool serialize_json_property(GlobalObject&, StringifyState&, const PropertyName& key, Object* holder);
+    static void serialize_json_object(GlobalObject&, StringifyState&, Object&);
+    static void serialize_json_array(GlobalObject&, StringifyState&, Object&);
+    static void quote_json_string(StringBuilder&, const StringView&);
 
     // Parse helpers
-    static Object* parse_json_object(GlobalObject&, const JsonObject&);
-    static Array* parse_json_array(GlobalObject&, const JsonArray&);
-    static Value parse_json_value(GlobalObject&, const JsonValue&);
     static Value internalize_json_property(GlobalObject&, Object* holder, const PropertyName& name, Function& reviver);
 
     JS_DECLARE_NATIVE_FUNCTION(stringify);
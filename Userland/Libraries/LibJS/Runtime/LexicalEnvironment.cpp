@@ -24,17 +24,19 @@ LexicalEnvironment::LexicalEnvironment(EnvironmentRecordType environment_record_
 {
 }
 
-LexicalEnvironment::LexicalEnvironment(HashMap<FlyString, Variable> variables, ScopeObject* parent_scope)
-    : ScopeObject(parent_scope)
-    , m_variables(move(variables))
+LexicalEnvironment::LexicalEnvironment(NonnullRefPtr<EnvironmentLayout> layout, ScopeObject* parent_scope)
+    : LexicalEnvironment(move(layout), parent_scope, EnvironmentRecordType::Declarative)
 {
 }
 
-LexicalEnvironment::LexicalEnvironment(HashMap<FlyString, Variable> variables, ScopeObject* parent_scope, EnvironmentRecordType environment_record_type)
+LexicalEnvironment::LexicalEnvironment(NonnullRefPtr<EnvironmentLayout> layout, ScopeObject* parent_scope, EnvironmentRecordType environment_record_type)
     : ScopeObject(parent_scope)
     , m_environment_record_type(environment_record_type)
-    , m_variables(move(variables))
+    , m_layout(move(layout))
 {
+    m_variables.ensure_capacity(m_layout->size());
+    for (size_t i = 0; i < m_layout->size(); ++i)
+        m_variables.unchecked_append({ js_undefined(), m_layout->declaration_kind(i) });
 }
 
 LexicalEnvironment::~LexicalEnvironment()
@@ -48,18 +50,31 @@ void LexicalEnvironment::visit_edges(Visitor& visitor)
     visitor.visit(m_home_object);
     visitor.visit(m_new_target);
     visitor.visit(m_current_function);
-    for (auto& it : m_variables)
-        visitor.visit(it.value.value);
+    for (auto& variable : m_variables)
+        visitor.visit(variable.value);
 }
 
 Optional<Variable> LexicalEnvironment::get_from_scope(const FlyString& name) const
 {
-    return m_variables.get(name);
+    auto index = index_of(name);
+    if (!index.has_value())
+        return {};
+    return m_variables[index.value()];
 }
 
 void LexicalEnvironment::put_to_scope(const FlyString& name, Variable variable)
 {
-    m_variables.set(name, variable);
+    if (auto index = index_of(name); index.has_value()) {
+        m_variables[index.value()] = variable;
+        return;
+    }
+
+    // A binding that wasn't known when the environment was created (e.g. a class declaration) gets a layout of its
+    // own. It may also shadow a variable further up the scope chain, so no cached lookup can be trusted anymore.
+    m_layout = m_layout ? m_layout->clone() : EnvironmentLayout::create();
+    m_layout->add(name, variable.declaration_kind);
+    m_variables.append(variable);
+    vm().invalidate_variable_caches();
 }
 
 bool LexicalEnvironment::has_super_binding() const
@@ -8,6 +8,8 @@
 
 #include <AK/FlyString.h>
 #include <AK/HashMap.h>
+#include <AK/Vector.h>
+#include <LibJS/Runtime/EnvironmentLayout.h>
 #include <LibJS/Runtime/ScopeObject.h>
 #include <LibJS/Runtime/Value.h>
 
@@ -32,8 +34,8 @@ public:
 
     LexicalEnvironment();
     LexicalEnvironment(EnvironmentRecordType);
-    LexicalEnvironment(HashMap<FlyString, Variable> variables, ScopeObject* parent_scope);
-    LexicalEnvironment(HashMap<FlyString, Variable> variables, ScopeObject* parent_scope, EnvironmentRecordType);
+    LexicalEnvironment(NonnullRefPtr<EnvironmentLayout>, ScopeObject* parent_scope);
+    LexicalEnvironment(NonnullRefPtr<EnvironmentLayout>, ScopeObject* parent_scope, EnvironmentRecordType);
     virtual ~LexicalEnvironment() override;
 
     // ^ScopeObject
@@ -42,9 +44,9 @@ public:
     virtual bool has_this_binding() const override;
     virtual Value get_this_binding(GlobalObject&) const override;
 
-    void clear();
-
-    const HashMap<FlyString, Variable>& variables() const { return m_variables; }
+    u64 layout_id() const { return m_layout ? m_layout->id() : 0; }
+    Optional<size_t> index_of(const FlyString& name) const { return m_layout ? m_layout->index_of(name) : Optional<size_t> {}; }
+    Variable& variable_at(size_t index) { return m_variables[index]; }
 
     void set_home_object(Value object) { m_home_object = object; }
     bool has_super_binding() const;
@@ -65,11 +67,13 @@ public:
     EnvironmentRecordType type() const { return m_environment_record_type; }
 
 private:
+    virtual bool is_lexical_environment() const override { return true; }
     virtual void visit_edges(Visitor&) override;
 
     EnvironmentRecordType m_environment_record_type : 8 { EnvironmentRecordType::Declarative };
     ThisBindingStatus m_this_binding_status : 8 { ThisBindingStatus::Uninitialized };
-    HashMap<FlyString, Variable> m_variables;
+    RefPtr<EnvironmentLayout> m_layout;
+    Vector<Variable> m_variables;
     Value m_home_object;
     Value m_this_value;
     Value m_new_target;
@@ -77,4 +81,7 @@ private:
     Function* m_current_function { nullptr };
 };
 
+template<>
+inline bool Object::fast_is<LexicalEnvironment>() const { return is_lexical_environment(); }
+
 }
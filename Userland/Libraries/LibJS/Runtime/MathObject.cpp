@@ -12,6 +12,114 @@
 
 namespace JS {
 
+// The functions that are called the most do the actual work in these, which take arguments that are numbers already.
+// That way the fast paths (which only run when the arguments are numbers) are exactly the same as the real thing.
+
+static Value abs_impl(Value number)
+{
+    if (number.is_nan())
+        return js_nan();
+    return Value(number.as_double() >= 0 ? number.as_double() : -number.as_double());
+}
+
+static Value sqrt_impl(Value number)
+{
+    if (number.is_nan())
+        return js_nan();
+    return Value(::sqrt(number.as_double()));
+}
+
+static Value floor_impl(Value number)
+{
+    if (number.is_int32())
+        return number;
+    if (number.is_nan())
+        return js_nan();
+    return Value(::floor(number.as_double()));
+}
+
+static Value ceil_impl(Value number)
+{
+    if (number.is_int32())
+        return number;
+    if (number.is_nan())
+        return js_nan();
+    auto number_double = number.as_double();
+    if (number_double < 0 && number_double > -1)
+        return Value(-0.f);
+    return Value(::ceil(number.as_double()));
+}
+
+static Value round_impl(Value number)
+{
+    if (number.is_int32())
+        return number;
+    if (number.is_nan())
+        return js_nan();
+    double intpart = 0;
+    double frac = modf(number.as_double(), &intpart);
+    if (intpart >= 0) {
+        if (frac >= 0.5)
+            intpart += 1.0;
+    } else {
+        if (frac < -0.5)
+            intpart -= 1.0;
+    }
+    return Value(intpart);
+}
+
+static Value max_impl(Span<const Value> numbers)
+{
+    if (numbers.is_empty())
+        return js_negative_infinity();
+    auto max = numbers[0];
+    for (size_t i = 1; i < numbers.size(); ++i)
+        max = Value(numbers[i].as_double() > max.as_double() ? numbers[i] : max);
+    return max;
+}
+
+static Value min_impl(Span<const Value> numbers)
+{
+    if (numbers.is_empty())
+        return js_infinity();
+    auto min = numbers[0];
+    for (size_t i = 1; i < numbers.size(); ++i)
+        min = Value(numbers[i].as_double() < min.as_double() ? numbers[i] : min);
+    return min;
+}
+
+template<Value (*impl)(Value)>
+static Value number_fast_path(Value, Span<const Value> arguments)
+{
+    if (arguments.is_empty() || !arguments[0].is_number())
+        return {};
+    return impl(arguments[0]);
+}
+
+template<Value (*impl)(Span<const Value>)>
+static Value numbers_fast_path(Value, Span<const Value> arguments)
+{
+    for (auto& argument : arguments) {
+        if (!argument.is_number())
+            return {};
+    }
+    return impl(arguments);
+}
+
+// The regular way around converts all the arguments to numbers first, in order, which is how the spec does it too.
+static Vector<Value, 8> arguments_to_numbers(VM& vm, GlobalObject& global_object)
+{
+    Vector<Value, 8> numbers;
+    numbers.ensure_capacity(vm.argument_count());
+    for (size_t i = 0; i < vm.argument_count(); ++i) {
+        auto number = vm.argument(i).to_number(global_object);
+        if (vm.exception())
+            return {};
+        numbers.unchecked_append(number);
+    }
+    return numbers;
+}
+
 MathObject::MathObject(GlobalObject& global_object)
     : Object(*global_object.object_prototype())
 {
@@ -22,14 +130,14 @@ void MathObject::initialize(GlobalObject& global_object)
     auto& vm = this->vm();
     Object::initialize(global_object);
     u8 attr = Attribute::Writable | Attribute::Configurable;
-    define_native_function(vm.names.abs, abs, 1, attr);
+    define_native_function(vm.names.abs, abs, 1, attr, number_fast_path<abs_impl>);
     define_native_function(vm.names.random, random, 0, attr);
-    define_native_function(vm.names.sqrt, sqrt, 1, attr);
-    define_native_function(vm.names.floor, floor, 1, attr);
-    define_native_function(vm.names.ceil, ceil, 1, attr);
-    define_native_function(vm.names.round, round, 1, attr);
-    define_native_function(vm.names.max, max, 2, attr);
-    define_native_function(vm.names.min, min, 2, attr);
+    define_native_function(vm.names.sqrt, sqrt, 1, attr, number_fast_path<sqrt_impl>);
+    define_native_function(vm.names.floor, floor, 1, attr, number_fast_path<floor_impl>);
+    define_native_function(vm.names.ceil, ceil, 1, attr, number_fast_path<ceil_impl>);
+    define_native_function(vm.names.round, round, 1, attr, number_fast_path<round_impl>);
+    define_native_function(vm.names.max, max, 2, attr, numbers_fast_path<max_impl>);
+    define_native_function(vm.names.min, min, 2, attr, numbers_fast_path<min_impl>);
     define_native_function(vm.names.trunc, trunc, 1, attr);
     define_native_function(vm.names.sin, sin, 1, attr);
     define_native_function(vm.names.cos, cos, 1, attr);
@@ -78,9 +186,7 @@ JS_DEFINE_NATIVE_FUNCTION(MathObject::abs)
     auto number = vm.argument(0).to_number(global_object);
     if (vm.exception())
         return {};
-    if (number.is_nan())
-        return js_nan();
-    return Value(number.as_double() >= 0 ? number.as_double() : -number.as_double());
+    return abs_impl(number);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::random)
@@ -98,9 +204,7 @@ JS_DEFINE_NATIVE_FUNCTION(MathObject::sqrt)
     auto number = vm.argument(0).to_number(global_object);
     if (vm.exception())
         return {};
-    if (number.is_nan())
-        return js_nan();
-    return Value(::sqrt(number.as_double()));
+    return sqrt_impl(number);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::floor)
@@ -108,9 +212,7 @@ JS_DEFINE_NATIVE_FUNCTION(MathObject::floor)
     auto number = vm.argument(0).to_number(global_object);
     if (vm.exception())
         return {};
-    if (number.is_nan())
-        return js_nan();
-    return Value(::floor(number.as_double()));
+    return floor_impl(number);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::ceil)
@@ -118,12 +220,7 @@ JS_DEFINE_NATIVE_FUNCTION(MathObject::ceil)
     auto number = vm.argument(0).to_number(global_object);
     if (vm.exception())
         return {};
-    if (number.is_nan())
-        return js_nan();
-    auto number_double = number.as_double();
-    if (number_double < 0 && number_double > -1)
-        return Value(-0.f);
-    return Value(::ceil(number.as_double()));
+    return ceil_impl(number);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::round)
@@ -131,52 +228,23 @@ JS_DEFINE_NATIVE_FUNCTION(MathObject::round)
     auto number = vm.argument(0).to_number(global_object);
     if (vm.exception())
         return {};
-    if (number.is_nan())
-        return js_nan();
-    double intpart = 0;
-    double frac = modf(number.as_double(), &intpart);
-    if (intpart >= 0) {
-        if (frac >= 0.5)
-            intpart += 1.0;
-    } else {
-        if (frac < -0.5)
-            intpart -= 1.0;
-    }
-    return Value(intpart);
+    return round_impl(number);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::max)
 {
-    if (!vm.argument_count())
-        return js_negative_infinity();
-
-    auto max = vm.argument(0).to_number(global_object);
+    auto numbers = arguments_to_numbers(vm, global_object);
     if (vm.exception())
         return {};
-    for (size_t i = 1; i < vm.argument_count(); ++i) {
-        auto cur = vm.argument(i).to_number(global_object);
-        if (vm.exception())
-            return {};
-        max = Value(cur.as_double() > max.as_double() ? cur : max);
-    }
-    return max;
+    return max_impl(numbers.span());
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::min)
 {
-    if (!vm.argument_count())
-        return js_infinity();
-
-    auto min = vm.argument(0).to_number(global_object);
+    auto numbers = arguments_to_numbers(vm, global_object);
     if (vm.exception())
         return {};
-    for (size_t i = 1; i < vm.argument_count(); ++i) {
-        auto cur = vm.argument(i).to_number(global_object);
-        if (vm.exception())
-            return {};
-        min = Value(cur.as_double() < min.as_double() ? cur : min);
-    }
-    return min;
+    return min_impl(numbers.span());
 }
 
 JS_DEFINE_NATIVE_FUNCTION(MathObject::trunc)
@@ -16,6 +16,15 @@ NativeFunction* NativeFunction::create(GlobalObject& global_object, const FlyStr
     return global_object.heap().allocate<NativeFunction>(global_object, name, move(function), *global_object.function_prototype());
 }
 
+NativeFunction* NativeFunction::create_with_length(GlobalObject& global_object, const FlyString& name, i32 length, AK::Function<Value(VM&, GlobalObject&)> function)
+{
+    // These all share one shape, instead of going through a prototype transition and two property additions each.
+    auto* native_function = global_object.heap().allocate<NativeFunction>(global_object, name, move(function), *global_object.native_function_shape());
+    native_function->put_direct(GlobalObject::native_function_length_offset, Value(length));
+    native_function->put_direct(GlobalObject::native_function_name_offset, js_string(global_object.heap(), name));
+    return native_function;
+}
+
 NativeFunction::NativeFunction(Object& prototype)
     : Function(prototype)
 {
@@ -28,6 +37,13 @@ NativeFunction::NativeFunction(const FlyString& name, AK::Function<Value(VM&, Gl
 {
 }
 
+NativeFunction::NativeFunction(const FlyString& name, AK::Function<Value(VM&, GlobalObject&)> native_function, Shape& shape)
+    : Function(shape)
+    , m_name(name)
+    , m_native_function(move(native_function))
+{
+}
+
 NativeFunction::NativeFunction(const FlyString& name, Object& prototype)
     : Function(prototype)
     , m_name(name)
@@ -16,8 +16,11 @@ class NativeFunction : public Function {
 
 public:
     static NativeFunction* create(GlobalObject&, const FlyString& name, AK::Function<Value(VM&, GlobalObject&)>);
+    // Creates a function that already has its length and name properties, as every builtin one does.
+    static NativeFunction* create_with_length(GlobalObject&, const FlyString& name, i32 length, AK::Function<Value(VM&, GlobalObject&)>);
 
     explicit NativeFunction(const FlyString& name, AK::Function<Value(VM&, GlobalObject&)>, Object& prototype);
+    NativeFunction(const FlyString& name, AK::Function<Value(VM&, GlobalObject&)>, Shape&);
     virtual void initialize(GlobalObject&) override { }
     virtual ~NativeFunction() override;
 
@@ -29,6 +32,9 @@ public:
 
     virtual bool is_strict_mode() const override;
 
+    NativeFastPath fast_path() const { return m_fast_path; }
+    void set_fast_path(NativeFastPath fast_path) { m_fast_path = fast_path; }
+
 protected:
     NativeFunction(const FlyString& name, Object& prototype);
     explicit NativeFunction(Object& prototype);
@@ -38,6 +44,7 @@ private:
 
     FlyString m_name;
     AK::Function<Value(VM&, GlobalObject&)> m_native_function;
+    NativeFastPath m_fast_path { nullptr };
 };
 
 }
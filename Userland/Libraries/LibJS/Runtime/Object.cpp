@@ -17,6 +17,7 @@
 #include <LibJS/Runtime/NativeFunction.h>
 #include <LibJS/Runtime/NativeProperty.h>
 #include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/PropertyCache.h>
 #include <LibJS/Runtime/Shape.h>
 #include <LibJS/Runtime/StringObject.h>
 #include <LibJS/Runtime/Value.h>
@@ -792,6 +793,53 @@ Value Object::get_without_side_effects(const PropertyName& property_name) const
     return get(property_name, {}, true);
 }
 
+Value Object::get_with_cache(const FlyString& property_name, PropertyCache& cache) const
+{
+    if (auto offset = cache.offset_for(shape()); offset.has_value()) {
+        auto value = m_storage[offset.value()];
+        if (!value.is_accessor() && !value.is_native_property())
+            return value.value_or(js_undefined());
+    }
+
+    auto metadata = shape().lookup(property_name);
+    if (metadata.has_value()) {
+        auto value = m_storage[metadata.value().offset];
+        if (!value.is_accessor() && !value.is_native_property()) {
+            cache.remember(shape(), metadata.value().offset);
+            return value.value_or(js_undefined());
+        }
+    }
+    return get(property_name);
+}
+
+bool Object::put_with_cache(const FlyString& property_name, Value value, PropertyCache& cache)
+{
+    VERIFY(!value.is_empty());
+
+    if (auto offset = cache.offset_for(shape()); offset.has_value()) {
+        auto& value_here = m_storage[offset.value()];
+        if (!value_here.is_accessor() && !value_here.is_native_property()) {
+            value_here = value;
+            return true;
+        }
+    }
+
+    if (!put(property_name, value))
+        return false;
+    if (vm().exception())
+        return false;
+
+    // This may well be a shape we haven't seen yet, if the put added the property. Caching that one means the next
+    // write to this object won't have to look the property up again.
+    auto metadata = shape().lookup(property_name);
+    if (metadata.has_value() && metadata.value().attributes.is_writable()) {
+        auto value_here = m_storage[metadata.value().offset];
+        if (!value_here.is_accessor() && !value_here.is_native_property())
+            cache.remember(shape(), metadata.value().offset);
+    }
+    return true;
+}
+
 bool Object::put_by_index(u32 property_index, Value value)
 {
     VERIFY(!value.is_empty());
@@ -857,6 +905,8 @@ bool Object::put(const PropertyName& property_name, Value value, Value receiver)
                 call_native_property_setter(value_here.as_native_property(), receiver, value);
                 return true;
             }
+            // A data property shadows any setter further up the prototype chain.
+            break;
         }
         object = object->prototype();
         if (vm().exception())
@@ -865,22 +915,16 @@ bool Object::put(const PropertyName& property_name, Value value, Value receiver)
     return put_own_property(string_or_symbol, value, default_attributes, PutOwnPropertyMode::Put);
 }
 
-bool Object::define_native_function(const StringOrSymbol& property_name, AK::Function<Value(VM&, GlobalObject&)> native_function, i32 length, PropertyAttributes attribute)
+bool Object::define_native_function(const StringOrSymbol& property_name, AK::Function<Value(VM&, GlobalObject&)> native_function, i32 length, PropertyAttributes attribute, NativeFastPath fast_path)
 {
-    auto& vm = this->vm();
     String function_name;
     if (property_name.is_string()) {
         function_name = property_name.as_string();
     } else {
         function_name = String::formatted("[{}]", property_name.as_symbol()->description());
     }
-    auto* function = NativeFunction::create(global_object(), function_name, move(native_function));
-    function->define_property_without_transition(vm.names.length, Value(length), Attribute::Configurable);
-    if (vm.exception())
-        return {};
-    function->define_property_without_transition(vm.names.name, js_string(vm.heap(), function_name), Attribute::Configurable);
-    if (vm.exception())
-        return {};
+    auto* function = NativeFunction::create_with_length(global_object(), function_name, length, move(native_function));
+    function->set_fast_path(fast_path);
     return define_property(property_name, function, attribute);
 }
 
@@ -77,6 +77,10 @@ public:
     virtual Value get(const PropertyName&, Value receiver = {}, bool without_side_effects = false) const;
     Value get_without_side_effects(const PropertyName&) const;
 
+    // Like get() and put(), but use (and fill) the inline cache of the property access site.
+    Value get_with_cache(const FlyString& property_name, PropertyCache&) const;
+    bool put_with_cache(const FlyString& property_name, Value, PropertyCache&);
+
     virtual bool has_property(const PropertyName&) const;
     bool has_own_property(const PropertyName&) const;
 
@@ -93,7 +97,7 @@ public:
     bool define_property_without_transition(const PropertyName&, Value value, PropertyAttributes attributes = default_attributes, bool throw_exceptions = true);
     bool define_accessor(const PropertyName&, Function* getter, Function* setter, PropertyAttributes attributes = default_attributes, bool throw_exceptions = true);
 
-    bool define_native_function(const StringOrSymbol& property_name, AK::Function<Value(VM&, GlobalObject&)>, i32 length = 0, PropertyAttributes attributes = default_attributes);
+    bool define_native_function(const StringOrSymbol& property_name, AK::Function<Value(VM&, GlobalObject&)>, i32 length = 0, PropertyAttributes attributes = default_attributes, NativeFastPath = nullptr);
     bool define_native_property(const StringOrSymbol& property_name, AK::Function<Value(VM&, GlobalObject&)> getter, AK::Function<void(VM&, GlobalObject&, Value)> setter, PropertyAttributes attributes = default_attributes);
 
     void define_properties(Value properties);
@@ -105,6 +109,7 @@ public:
     virtual bool is_typed_array() const { return false; }
     virtual bool is_string_object() const { return false; }
     virtual bool is_global_object() const { return false; }
+    virtual bool is_lexical_environment() const { return false; }
 
     virtual const char* class_name() const override { return "Object"; }
     virtual void visit_edges(Cell::Visitor&) override;
@@ -124,6 +129,8 @@ public:
     virtual Value ordinary_to_primitive(Value::PreferredType preferred_type) const;
 
     Value get_direct(size_t index) const { return m_storage[index]; }
+    void put_direct(size_t index, Value value) { m_storage[index] = value; }
+    void ensure_storage_capacity(size_t capacity) { m_storage.ensure_capacity(capacity); }
 
     const IndexedProperties& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
@@ -4,20 +4,76 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/FlyString.h>
+#include <AK/StringBuilder.h>
 #include <LibJS/Runtime/PrimitiveString.h>
 #include <LibJS/Runtime/VM.h>
 
 namespace JS {
 
+// Strings up to this long are likely to end up as property names, or to be compared with them. Interning them means
+// they can be turned into a FlyString without another lookup, and compare equal to one by pointer.
+static constexpr size_t max_interned_string_length = 32;
+
+// Below this length, concatenating right away is cheaper than keeping both halves around as a rope.
+static constexpr size_t min_rope_length = 32;
+
 PrimitiveString::PrimitiveString(String string)
     : m_string(move(string))
 {
 }
 
+PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
+    : m_is_rope(true)
+    , m_lhs(&lhs)
+    , m_rhs(&rhs)
+{
+}
+
 PrimitiveString::~PrimitiveString()
 {
 }
 
+void PrimitiveString::visit_edges(Cell::Visitor& visitor)
+{
+    Cell::visit_edges(visitor);
+    if (m_is_rope) {
+        visitor.visit(m_lhs);
+        visitor.visit(m_rhs);
+    }
+}
+
+void PrimitiveString::resolve_rope() const
+{
+    VERIFY(m_is_rope);
+
+    // A string that's built by appending to it in a loop ends up as a very deep rope, so it gets walked with an
+    // explicit stack rather than recursively.
+    Vector<const PrimitiveString*> pieces;
+    Vector<const PrimitiveString*> stack;
+    stack.append(this);
+    size_t length = 0;
+    while (!stack.is_empty()) {
+        auto* current = stack.take_last();
+        if (current->m_is_rope) {
+            stack.append(current->m_rhs);
+            stack.append(current->m_lhs);
+            continue;
+        }
+        pieces.append(current);
+        length += current->m_string.length();
+    }
+
+    StringBuilder builder(length);
+    for (auto* piece : pieces)
+        builder.append(piece->m_string);
+
+    m_string = builder.to_string();
+    m_is_rope = false;
+    m_lhs = nullptr;
+    m_rhs = nullptr;
+}
+
 PrimitiveString* js_string(Heap& heap, String string)
 {
     if (string.is_empty())
@@ -26,6 +82,9 @@ PrimitiveString* js_string(Heap& heap, String string)
     if (string.length() == 1 && (u8)string.characters()[0] < 0x80)
         return &heap.vm().single_ascii_character_string(string.characters()[0]);
 
+    if (string.length() <= max_interned_string_length)
+        string = FlyString(string);
+
     return heap.allocate_without_global_object<PrimitiveString>(move(string));
 }
 
@@ -34,4 +93,21 @@ PrimitiveString* js_string(VM& vm, String string)
     return js_string(vm.heap(), move(string));
 }
 
+PrimitiveString* js_rope_string(VM& vm, PrimitiveString& lhs, PrimitiveString& rhs)
+{
+    if (!lhs.is_rope() && lhs.string().is_empty())
+        return &rhs;
+    if (!rhs.is_rope() && rhs.string().is_empty())
+        return &lhs;
+
+    if (!lhs.is_rope() && !rhs.is_rope() && lhs.string().length() + rhs.string().length() < min_rope_length) {
+        StringBuilder builder(lhs.string().length() + rhs.string().length());
+        builder.append(lhs.string());
+        builder.append(rhs.string());
+        return js_string(vm, builder.to_string());
+    }
+
+    return vm.heap().allocate_without_global_object<PrimitiveString>(lhs, rhs);
+}
+
 }
@@ -14,17 +14,33 @@ namespace JS {
 class PrimitiveString final : public Cell {
 public:
     explicit PrimitiveString(String);
+    // A rope, i.e. the concatenation of two strings that isn't carried out until someone needs the result.
+    PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs);
     virtual ~PrimitiveString();
 
-    const String& string() const { return m_string; }
+    const String& string() const
+    {
+        if (m_is_rope)
+            resolve_rope();
+        return m_string;
+    }
+
+    bool is_rope() const { return m_is_rope; }
 
 private:
     virtual const char* class_name() const override { return "PrimitiveString"; }
+    virtual void visit_edges(Cell::Visitor&) override;
+
+    void resolve_rope() const;
 
-    String m_string;
+    mutable bool m_is_rope { false };
+    mutable String m_string;
+    mutable PrimitiveString* m_lhs { nullptr };
+    mutable PrimitiveString* m_rhs { nullptr };
 };
 
 PrimitiveString* js_string(Heap&, String);
 PrimitiveString* js_string(VM&, String);
+PrimitiveString* js_rope_string(VM&, PrimitiveString& lhs, PrimitiveString& rhs);
 
 }
@@ -87,10 +87,8 @@ Promise::ResolvingFunctions Promise::create_resolving_functions()
         }
         dbgln_if(PROMISE_DEBUG, "[Promise @ {} / PromiseResolvingFunction]: Creating JobCallback for then action @ {}", &promise, &then_action.as_function());
         auto then_job_callback = make_job_callback(then_action.as_function());
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / PromiseResolvingFunction]: Creating PromiseResolveThenableJob for thenable {}", &promise, resolution);
-        auto* job = PromiseResolveThenableJob::create(global_object, promise, resolution, then_job_callback);
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / PromiseResolvingFunction]: Enqueuing job @ {}", &promise, job);
-        vm.enqueue_promise_job(*job);
+        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / PromiseResolvingFunction]: Enqueuing PromiseResolveThenableJob", &promise);
+        vm.enqueue_promise_job(PromiseJob::create_resolve_thenable_job(global_object, promise, resolution, then_job_callback));
         return js_undefined();
     });
 
@@ -147,10 +145,8 @@ void Promise::trigger_reactions() const
         ? m_fulfill_reactions
         : m_reject_reactions;
     for (auto& reaction : reactions) {
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / trigger_reactions()]: Creating PromiseReactionJob for PromiseReaction @ {} with argument {}", this, &reaction, m_result);
-        auto* job = PromiseReactionJob::create(global_object(), *reaction, m_result);
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / trigger_reactions()]: Enqueuing job @ {}", this, job);
-        vm.enqueue_promise_job(*job);
+        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / trigger_reactions()]: Enqueuing PromiseReactionJob for PromiseReaction @ {} with argument {}", this, &reaction, m_result);
+        vm.enqueue_promise_job(PromiseJob::create_reaction_job(global_object(), *reaction, m_result));
     }
     if constexpr (PROMISE_DEBUG) {
         if (reactions.is_empty())
@@ -186,20 +182,16 @@ Value Promise::perform_then(Value on_fulfilled, Value on_rejected, Optional<Prom
         break;
     case Promise::State::Fulfilled: {
         auto value = m_result;
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: State is State::Fulfilled, creating PromiseReactionJob for PromiseReaction @ {} with argument {}", this, fulfill_reaction, value);
-        auto* fulfill_job = PromiseReactionJob::create(global_object(), *fulfill_reaction, value);
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: Enqueuing job @ {}", this, fulfill_job);
-        vm.enqueue_promise_job(*fulfill_job);
+        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: State is State::Fulfilled, enqueuing PromiseReactionJob for PromiseReaction @ {} with argument {}", this, fulfill_reaction, value);
+        vm.enqueue_promise_job(PromiseJob::create_reaction_job(global_object(), *fulfill_reaction, value));
         break;
     }
     case Promise::State::Rejected: {
         auto reason = m_result;
         if (!m_is_handled)
             vm.promise_rejection_tracker(*this, RejectionOperation::Handle);
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: State is State::Rejected, creating PromiseReactionJob for PromiseReaction @ {} with argument {}", this, reject_reaction, reason);
-        auto* reject_job = PromiseReactionJob::create(global_object(), *reject_reaction, reason);
-        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: Enqueuing job @ {}", this, reject_job);
-        vm.enqueue_promise_job(*reject_job);
+        dbgln_if(PROMISE_DEBUG, "[Promise @ {} / perform_then()]: State is State::Rejected, enqueuing PromiseReactionJob for PromiseReaction @ {} with argument {}", this, reject_reaction, reason);
+        vm.enqueue_promise_job(PromiseJob::create_reaction_job(global_object(), *reject_reaction, reason));
         break;
     }
     default:
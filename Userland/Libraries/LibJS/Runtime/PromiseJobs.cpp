@@ -13,47 +13,75 @@
 
 namespace JS {
 
-PromiseReactionJob* PromiseReactionJob::create(GlobalObject& global_object, PromiseReaction& reaction, Value argument)
+// 27.2.2.1 NewPromiseReactionJob, https://tc39.es/ecma262/#sec-newpromisereactionjob
+PromiseJob PromiseJob::create_reaction_job(GlobalObject& global_object, PromiseReaction& reaction, Value argument)
 {
-    return global_object.heap().allocate<PromiseReactionJob>(global_object, reaction, argument, *global_object.function_prototype());
+    PromiseJob job;
+    job.type = Type::Reaction;
+    job.global_object = &global_object;
+    job.reaction = &reaction;
+    job.argument = argument;
+    return job;
 }
 
-PromiseReactionJob::PromiseReactionJob(PromiseReaction& reaction, Value argument, Object& prototype)
-    : NativeFunction(prototype)
-    , m_reaction(reaction)
-    , m_argument(argument)
+// 27.2.2.2 NewPromiseResolveThenableJob, https://tc39.es/ecma262/#sec-newpromiseresolvethenablejob
+PromiseJob PromiseJob::create_resolve_thenable_job(GlobalObject& global_object, Promise& promise_to_resolve, Value thenable, JobCallback then)
 {
+    // FIXME: A bunch of stuff regarding realms, see step 2-5 in the spec linked above
+    PromiseJob job;
+    job.type = Type::ResolveThenable;
+    job.global_object = &global_object;
+    job.promise_to_resolve = &promise_to_resolve;
+    job.argument = thenable;
+    job.then = then.callback;
+    return job;
 }
 
-// 27.2.2.1 NewPromiseReactionJob, https://tc39.es/ecma262/#sec-newpromisereactionjob
-Value PromiseReactionJob::call()
+void PromiseJob::run(VM& vm) const
 {
-    auto& vm = this->vm();
-    auto& promise_capability = m_reaction.capability();
-    auto type = m_reaction.type();
-    auto handler = m_reaction.handler();
+    switch (type) {
+    case Type::Reaction:
+        run_reaction_job(vm);
+        break;
+    case Type::ResolveThenable:
+        run_resolve_thenable_job(vm);
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+void PromiseJob::run_reaction_job(VM& vm) const
+{
+    auto& promise_capability = reaction->capability();
+    auto type = reaction->type();
+    auto handler = reaction->handler();
     Value handler_result;
     if (!handler.has_value()) {
-        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Handler is empty", this);
+        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Handler is empty", reaction);
         switch (type) {
         case PromiseReaction::Type::Fulfill:
-            dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Reaction type is Type::Fulfill, setting handler result to {}", this, m_argument);
-            handler_result = m_argument;
+            dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Reaction type is Type::Fulfill, setting handler result to {}", reaction, argument);
+            handler_result = argument;
             break;
         case PromiseReaction::Type::Reject:
-            dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Reaction type is Type::Reject, throwing exception with argument {}", this, m_argument);
-            vm.throw_exception(global_object(), m_argument);
+            dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Reaction type is Type::Reject, throwing exception with argument {}", reaction, argument);
+            vm.throw_exception(*global_object, argument);
             // handler_result is set to exception value further below
             break;
         }
     } else {
-        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Calling handler callback {} @ {} with argument {}", this, handler.value().callback->class_name(), handler.value().callback, m_argument);
-        handler_result = call_job_callback(vm, handler.value(), js_undefined(), m_argument);
+        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Calling handler callback {} @ {} with argument {}", reaction, handler.value().callback->class_name(), handler.value().callback, argument);
+        handler_result = call_job_callback(vm, handler.value(), js_undefined(), argument);
     }
 
     if (!promise_capability.has_value()) {
-        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Reaction has no PromiseCapability, returning empty value", this);
-        return {};
+        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Reaction has no PromiseCapability, returning", reaction);
+        if (vm.exception()) {
+            vm.clear_exception();
+            vm.stop_unwind();
+        }
+        return;
     }
 
     if (vm.exception()) {
@@ -61,60 +89,43 @@ Value PromiseReactionJob::call()
         vm.clear_exception();
         vm.stop_unwind();
         auto* reject_function = promise_capability.value().reject;
-        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Calling PromiseCapability's reject function @ {}", this, reject_function);
-        return vm.call(*reject_function, js_undefined(), handler_result);
+        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Calling PromiseCapability's reject function @ {}", reaction, reject_function);
+        [[maybe_unused]] auto result = vm.call(*reject_function, js_undefined(), handler_result);
     } else {
         auto* resolve_function = promise_capability.value().resolve;
-        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Calling PromiseCapability's resolve function @ {}", this, resolve_function);
-        return vm.call(*resolve_function, js_undefined(), handler_result);
+        dbgln_if(PROMISE_DEBUG, "[PromiseReactionJob @ {}]: Calling PromiseCapability's resolve function @ {}", reaction, resolve_function);
+        [[maybe_unused]] auto result = vm.call(*resolve_function, js_undefined(), handler_result);
     }
 }
 
-void PromiseReactionJob::visit_edges(Visitor& visitor)
-{
-    Base::visit_edges(visitor);
-    visitor.visit(&m_reaction);
-    visitor.visit(m_argument);
-}
-
-PromiseResolveThenableJob* PromiseResolveThenableJob::create(GlobalObject& global_object, Promise& promise_to_resolve, Value thenable, JobCallback then)
-{
-    // FIXME: A bunch of stuff regarding realms, see step 2-5 in the spec linked below
-    return global_object.heap().allocate<PromiseResolveThenableJob>(global_object, promise_to_resolve, thenable, then, *global_object.function_prototype());
-}
-
-PromiseResolveThenableJob::PromiseResolveThenableJob(Promise& promise_to_resolve, Value thenable, JobCallback then, Object& prototype)
-    : NativeFunction(prototype)
-    , m_promise_to_resolve(promise_to_resolve)
-    , m_thenable(thenable)
-    , m_then(then)
-{
-}
-
-// 27.2.2.2 NewPromiseResolveThenableJob, https://tc39.es/ecma262/#sec-newpromiseresolvethenablejob
-Value PromiseResolveThenableJob::call()
+void PromiseJob::run_resolve_thenable_job(VM& vm) const
 {
-    auto& vm = this->vm();
-    auto [resolve_function, reject_function] = m_promise_to_resolve.create_resolving_functions();
-    dbgln_if(PROMISE_DEBUG, "[PromiseResolveThenableJob @ {}]: Calling then job callback for thenable {}", this, &m_thenable);
-    auto then_call_result = call_job_callback(vm, m_then, m_thenable, &resolve_function, &reject_function);
+    auto [resolve_function, reject_function] = promise_to_resolve->create_resolving_functions();
+    dbgln_if(PROMISE_DEBUG, "[PromiseResolveThenableJob @ {}]: Calling then job callback for thenable {}", promise_to_resolve, argument);
+    JobCallback then_job_callback { then };
+    [[maybe_unused]] auto then_call_result = call_job_callback(vm, then_job_callback, argument, &resolve_function, &reject_function);
     if (vm.exception()) {
         auto error = vm.exception()->value();
         vm.clear_exception();
         vm.stop_unwind();
-        dbgln_if(PROMISE_DEBUG, "[PromiseResolveThenableJob @ {}]: An exception was thrown, returning error {}", this, error);
-        return error;
+        dbgln_if(PROMISE_DEBUG, "[PromiseResolveThenableJob @ {}]: An exception was thrown, calling the reject function with {}", promise_to_resolve, error);
+        [[maybe_unused]] auto result = vm.call(reject_function, js_undefined(), error);
+        return;
     }
-    dbgln_if(PROMISE_DEBUG, "[PromiseResolveThenableJob @ {}]: Returning then call result {}", this, then_call_result);
-    return then_call_result;
+    dbgln_if(PROMISE_DEBUG, "[PromiseResolveThenableJob @ {}]: Then call returned {}", promise_to_resolve, then_call_result);
 }
 
-void PromiseResolveThenableJob::visit_edges(Visitor& visitor)
+void PromiseJob::gather_roots(HashTable<Cell*>& roots) const
 {
-    Base::visit_edges(visitor);
-    visitor.visit(&m_promise_to_resolve);
-    visitor.visit(m_thenable);
-    visitor.visit(m_then.callback);
+    roots.set(global_object);
+    if (reaction)
+        roots.set(reaction);
+    if (promise_to_resolve)
+        roots.set(promise_to_resolve);
+    if (auto value = argument; value.is_cell())
+        roots.set(value.as_cell());
+    if (then)
+        roots.set(then);
 }
 
 }
@@ -6,48 +6,37 @@
 
 #pragma once
 
-#include <LibJS/Runtime/GlobalObject.h>
-#include <LibJS/Runtime/JobCallback.h>
-#include <LibJS/Runtime/NativeFunction.h>
-#include <LibJS/Runtime/Promise.h>
+#include <AK/HashTable.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/Value.h>
 
 namespace JS {
 
-class PromiseReactionJob final : public NativeFunction {
-    JS_OBJECT(PromiseReactionJob, NativeFunction);
+// The jobs enqueued by HostEnqueuePromiseJob. These are not cells, since there are a lot of them and they only live until
+// the queue is drained. The VM keeps whatever they point to alive while they wait in the queue.
+struct PromiseJob {
+    enum class Type : u8 {
+        Reaction,
+        ResolveThenable,
+    };
 
-public:
-    static PromiseReactionJob* create(GlobalObject&, PromiseReaction&, Value argument);
+    static PromiseJob create_reaction_job(GlobalObject&, PromiseReaction&, Value argument);
+    static PromiseJob create_resolve_thenable_job(GlobalObject&, Promise& promise_to_resolve, Value thenable, JobCallback then);
 
-    explicit PromiseReactionJob(PromiseReaction&, Value argument, Object& prototype);
-    virtual ~PromiseReactionJob() override = default;
+    void run(VM&) const;
+    void gather_roots(HashTable<Cell*>&) const;
 
-    virtual Value call() override;
+    Type type { Type::Reaction };
+    GlobalObject* global_object { nullptr };
+    PromiseReaction* reaction { nullptr };
+    Promise* promise_to_resolve { nullptr };
+    // The argument of a reaction job, or the thenable of a resolve thenable job.
+    Value argument;
+    Function* then { nullptr };
 
 private:
-    virtual void visit_edges(Visitor&) override;
-
-    PromiseReaction& m_reaction;
-    Value m_argument;
-};
-
-class PromiseResolveThenableJob final : public NativeFunction {
-    JS_OBJECT(PromiseReactionJob, NativeFunction);
-
-public:
-    static PromiseResolveThenableJob* create(GlobalObject&, Promise&, Value thenable, JobCallback then);
-
-    explicit PromiseResolveThenableJob(Promise&, Value thenable, JobCallback then, Object& prototype);
-    virtual ~PromiseResolveThenableJob() override = default;
-
-    virtual Value call() override;
-
-private:
-    virtual void visit_edges(Visitor&) override;
-
-    Promise& m_promise_to_resolve;
-    Value m_thenable;
-    JobCallback m_then;
+    void run_reaction_job(VM&) const;
+    void run_resolve_thenable_job(VM&) const;
 };
 
 }
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Types.h>
+#include <LibJS/Runtime/Shape.h>
+
+namespace JS {
+
+// An inline cache for one property access in the source, e.g. `foo.bar` or `foo.bar = baz`.
+// It remembers the storage offset of the property for the last few shapes seen there, so that objects with one of
+// these shapes can skip the property table lookup. Shapes are identified by their ID rather than a pointer, since
+// nothing keeps the cached shapes alive and a new shape could otherwise end up with the address of a dead one.
+class PropertyCache {
+public:
+    static constexpr size_t max_entries = 4;
+
+    ALWAYS_INLINE Optional<size_t> offset_for(const Shape& shape) const
+    {
+        for (size_t i = 0; i < m_entry_count; ++i) {
+            if (m_entries[i].shape_id == shape.id())
+                return m_entries[i].offset;
+        }
+        return {};
+    }
+
+    void remember(const Shape& shape, size_t offset)
+    {
+        // Unique shapes change in place when properties are added or removed, so they can't be cached.
+        if (shape.is_unique())
+            return;
+        if (m_entry_count < max_entries) {
+            m_entries[m_entry_count++] = { shape.id(), offset };
+            return;
+        }
+        // Once a site has seen more shapes than fit, the oldest one makes room.
+        m_entries[m_next_eviction] = { shape.id(), offset };
+        m_next_eviction = (m_next_eviction + 1) % max_entries;
+    }
+
+private:
+    struct Entry {
+        u64 shape_id { 0 };
+        size_t offset { 0 };
+    };
+
+    Entry m_entries[max_entries];
+    u8 m_entry_count { 0 };
+    u8 m_next_eviction { 0 };
+};
+
+}
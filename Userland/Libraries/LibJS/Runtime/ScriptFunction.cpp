@@ -4,8 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Debug.h>
 #include <AK/Function.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/Error.h>
@@ -67,22 +71,30 @@ void ScriptFunction::visit_edges(Visitor& visitor)
     visitor.visit(m_parent_scope);
 }
 
-LexicalEnvironment* ScriptFunction::create_environment()
+NonnullRefPtr<EnvironmentLayout> ScriptFunction::environment_layout()
 {
-    HashMap<FlyString, Variable> variables;
-    for (auto& parameter : m_parameters) {
-        variables.set(parameter.name, { js_undefined(), DeclarationKind::Var });
+    const ScopeNode* body_scope = is<ScopeNode>(body()) ? &static_cast<const ScopeNode&>(body()) : nullptr;
+    if (body_scope) {
+        if (auto layout = body_scope->function_environment_layout())
+            return layout.release_nonnull();
     }
 
-    if (is<ScopeNode>(body())) {
-        for (auto& declaration : static_cast<const ScopeNode&>(body()).variables()) {
-            for (auto& declarator : declaration.declarations()) {
-                variables.set(declarator.id().string(), { js_undefined(), declaration.declaration_kind() });
-            }
+    auto layout = EnvironmentLayout::create();
+    for (auto& parameter : m_parameters)
+        layout->add(parameter.name, DeclarationKind::Var);
+    if (body_scope) {
+        for (auto& declaration : body_scope->variables()) {
+            for (auto& declarator : declaration.declarations())
+                layout->add(declarator.id().string(), declaration.declaration_kind());
         }
+        body_scope->set_function_environment_layout(layout);
     }
+    return layout;
+}
 
-    auto* environment = heap().allocate<LexicalEnvironment>(global_object(), move(variables), m_parent_scope, LexicalEnvironment::EnvironmentRecordType::Function);
+LexicalEnvironment* ScriptFunction::create_environment()
+{
+    auto* environment = heap().allocate<LexicalEnvironment>(global_object(), environment_layout(), m_parent_scope, LexicalEnvironment::EnvironmentRecordType::Function);
     environment->set_home_object(home_object());
     environment->set_current_function(*this);
     if (m_is_arrow_function) {
@@ -127,7 +139,42 @@ Value ScriptFunction::execute_function_body()
         vm.current_scope()->put_to_scope(parameter.name, { argument_value, DeclarationKind::Var });
     }
 
-    return interpreter->execute_statement(global_object(), m_body, ScopeType::Function);
+    if (auto* executable = bytecode_executable()) {
+        Bytecode::Interpreter bytecode_interpreter(*interpreter, global_object());
+        auto result = bytecode_interpreter.run(*executable);
+        if (vm.exception()) {
+            // The bytecode stops right where it threw, so whatever scopes it was in are still entered.
+            interpreter->exit_scope(static_cast<const ScopeNode&>(*m_body));
+            return {};
+        }
+        return result;
+    }
+
+    auto loop_iteration_count_before = interpreter->loop_iteration_count();
+    auto result = interpreter->execute_statement(global_object(), m_body, ScopeType::Function);
+    if (is<ScopeNode>(*m_body))
+        static_cast<const ScopeNode&>(*m_body).function_tier_state().hotness += 1 + interpreter->loop_iteration_count() - loop_iteration_count_before;
+    return result;
+}
+
+// Function bodies start out in the AST interpreter. Most of them only ever run a few times, which isn't worth
+// compiling them for, so a body is only compiled to bytecode once it has been called, or gone around loops, this often.
+static constexpr u64 bytecode_tier_up_threshold = 100;
+
+const Bytecode::Executable* ScriptFunction::bytecode_executable()
+{
+    if (!is<ScopeNode>(*m_body))
+        return nullptr;
+    auto& body = static_cast<const ScopeNode&>(*m_body);
+    auto& tier_state = body.function_tier_state();
+    if (tier_state.executable || tier_state.failed_to_compile || tier_state.hotness < bytecode_tier_up_threshold)
+        return tier_state.executable.ptr();
+
+    tier_state.executable = Bytecode::Generator::generate_function(body);
+    tier_state.failed_to_compile = !tier_state.executable;
+    if (tier_state.executable)
+        dbgln_if(JS_BYTECODE_DEBUG, "Bytecode: Compiled function {} after a hotness of {}", m_name, tier_state.hotness);
+    return tier_state.executable.ptr();
 }
 
 Value ScriptFunction::call()
@@ -32,6 +32,8 @@ public:
 
     void set_is_class_constructor() { m_is_class_constructor = true; };
 
+    bool is_arrow_function() const { return m_is_arrow_function; }
+
 protected:
     virtual bool is_strict_mode() const final { return m_is_strict; }
 
@@ -39,7 +41,9 @@ private:
     virtual LexicalEnvironment* create_environment() override;
     virtual void visit_edges(Visitor&) override;
 
+    NonnullRefPtr<EnvironmentLayout> environment_layout();
     Value execute_function_body();
+    const Bytecode::Executable* bytecode_executable();
 
     JS_DECLARE_NATIVE_GETTER(length_getter);
     JS_DECLARE_NATIVE_GETTER(name_getter);
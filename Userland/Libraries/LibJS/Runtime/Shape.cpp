@@ -10,6 +10,12 @@
 
 namespace JS {
 
+u64 Shape::allocate_id()
+{
+    static u64 s_next_id = 1;
+    return s_next_id++;
+}
+
 Shape* Shape::create_unique_clone() const
 {
     VERIFY(m_global_object);
@@ -138,7 +144,9 @@ void Shape::ensure_property_table() const
 
     u32 next_offset = 0;
 
+    // This is walked backwards below, so the oldest transition (and with it, the lowest offset) comes last.
     Vector<const Shape*, 64> transition_chain;
+    transition_chain.append(this);
     for (auto* shape = m_previous; shape; shape = shape->m_previous) {
         if (shape->m_property_table) {
             *m_property_table = *shape->m_property_table;
@@ -147,7 +155,6 @@ void Shape::ensure_property_table() const
         }
         transition_chain.append(shape);
     }
-    transition_chain.append(this);
 
     for (ssize_t i = transition_chain.size() - 1; i >= 0; --i) {
         auto* shape = transition_chain[i];
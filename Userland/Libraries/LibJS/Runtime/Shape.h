@@ -55,6 +55,9 @@ public:
 
     void add_property_without_transition(const StringOrSymbol&, PropertyAttributes);
 
+    // Unlike the address, the ID of a shape is never reused, so it's safe to hold on to without keeping the shape alive.
+    u64 id() const { return m_id; }
+
     bool is_unique() const { return m_unique; }
     Shape* create_unique_clone() const;
 
@@ -86,6 +89,10 @@ private:
 
     void ensure_property_table() const;
 
+    static u64 allocate_id();
+
+    u64 m_id { allocate_id() };
+
     PropertyAttributes m_attributes { 0 };
     TransitionType m_transition_type : 6 { TransitionType::Invalid };
     bool m_unique : 1 { false };
@@ -34,9 +34,29 @@ static StringObject* typed_this(VM& vm, GlobalObject& global_object)
     return static_cast<StringObject*>(this_object);
 }
 
+static Value char_code_at_impl(const String& string, i32 index)
+{
+    if (index < 0 || index >= static_cast<i32>(string.length()))
+        return js_nan();
+    // FIXME: This should return the i'th UTF-16 code point.
+    return Value((i32)string[index]);
+}
+
+// Calls on a string with an index that's an integer already can't have side effects, so they don't need a call frame.
+static Value char_code_at_fast_path(Value this_value, Span<const Value> arguments)
+{
+    if (!this_value.is_string() || (!arguments.is_empty() && !arguments[0].is_int32()))
+        return {};
+    return char_code_at_impl(this_value.as_string().string(), arguments.is_empty() ? 0 : arguments[0].as_i32());
+}
+
 static String ak_string_from(VM& vm, GlobalObject& global_object)
 {
-    auto* this_object = vm.this_value(global_object).to_object(global_object);
+    // Going through a StringObject would only make us allocate one for every call on a string.
+    auto this_value = vm.this_value(global_object);
+    if (this_value.is_string())
+        return this_value.as_string().string();
+    auto* this_object = this_value.to_object(global_object);
     if (!this_object)
         return {};
     return Value(this_object).to_string(global_object);
@@ -66,7 +86,7 @@ void StringPrototype::initialize(GlobalObject& global_object)
 
     define_native_property(vm.names.length, length_getter, nullptr, 0);
     define_native_function(vm.names.charAt, char_at, 1, attr);
-    define_native_function(vm.names.charCodeAt, char_code_at, 1, attr);
+    define_native_function(vm.names.charCodeAt, char_code_at, 1, attr, char_code_at_fast_path);
     define_native_function(vm.names.repeat, repeat, 1, attr);
     define_native_function(vm.names.startsWith, starts_with, 1, attr);
     define_native_function(vm.names.endsWith, ends_with, 1, attr);
@@ -124,10 +144,7 @@ JS_DEFINE_NATIVE_FUNCTION(StringPrototype::char_code_at)
         if (vm.exception())
             return {};
     }
-    if (index < 0 || index >= static_cast<i32>(string.length()))
-        return js_nan();
-    // FIXME: This should return the i'th UTF-16 code point.
-    return Value((i32)string[index]);
+    return char_code_at_impl(string, index);
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::repeat)
@@ -51,36 +51,47 @@ class TypedArray : public TypedArrayBase {
 public:
     virtual bool put_by_index(u32 property_index, Value value) override
     {
-        property_index += m_byte_offset / sizeof(T);
         if (property_index >= m_array_length)
             return Base::put_by_index(property_index, value);
 
+        auto element = element_from_value(value);
+        if (vm().exception())
+            return {};
+        data()[property_index] = element;
+        return true;
+    }
+
+    virtual Value get_by_index(u32 property_index) const override
+    {
+        if (property_index >= m_array_length)
+            return Base::get_by_index(property_index);
+
+        return value_from_element(data()[property_index]);
+    }
+
+    // Converts a value the same way storing it into the array does, which can throw.
+    T element_from_value(Value value)
+    {
         if constexpr (sizeof(T) < 4) {
             auto number = value.to_i32(global_object());
             if (vm().exception())
                 return {};
-            data()[property_index] = number;
+            return number;
         } else if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
             auto number = value.to_double(global_object());
             if (vm().exception())
                 return {};
-            data()[property_index] = number;
+            return number;
         } else {
-            static_assert(DependentFalse<T>, "TypedArray::put_by_index with unhandled type size");
+            static_assert(DependentFalse<T>, "TypedArray::element_from_value with unhandled type size");
         }
-        return true;
     }
 
-    virtual Value get_by_index(u32 property_index) const override
+    static Value value_from_element(T value)
     {
-        property_index += m_byte_offset / sizeof(T);
-        if (property_index >= m_array_length)
-            return Base::get_by_index(property_index);
-
         if constexpr (sizeof(T) < 4) {
-            return Value((i32)data()[property_index]);
+            return Value((i32)value);
         } else if constexpr (sizeof(T) == 4 || sizeof(T) == 8) {
-            auto value = data()[property_index];
             if constexpr (IsFloatingPoint<T>) {
                 return Value((double)value);
             } else if constexpr (NumericLimits<T>::is_signed()) {
@@ -92,17 +103,18 @@ public:
             }
             return Value((i32)value);
         } else {
-            static_assert(DependentFalse<T>, "TypedArray::get_by_index with unhandled type size");
+            static_assert(DependentFalse<T>, "TypedArray::value_from_element with unhandled type size");
         }
     }
 
+    // The elements of this array, which are a view into the buffer starting at the byte offset.
     Span<const T> data() const
     {
-        return { reinterpret_cast<const T*>(m_viewed_array_buffer->buffer().data()), m_array_length };
+        return { reinterpret_cast<const T*>(m_viewed_array_buffer->buffer().data() + m_byte_offset), m_array_length };
     }
     Span<T> data()
     {
-        return { reinterpret_cast<T*>(m_viewed_array_buffer->buffer().data()), m_array_length };
+        return { reinterpret_cast<T*>(m_viewed_array_buffer->buffer().data() + m_byte_offset), m_array_length };
     }
 
     virtual size_t element_size() const override { return sizeof(T); };
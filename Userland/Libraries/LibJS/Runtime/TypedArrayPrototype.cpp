@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/SIMD.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/TypedArray.h>
 #include <LibJS/Runtime/TypedArrayPrototype.h>
@@ -24,6 +25,11 @@ void TypedArrayPrototype::initialize(GlobalObject& object)
     // FIXME: This should be an accessor property
     define_native_property(vm.names.length, length_getter, nullptr, Attribute::Configurable);
     define_native_function(vm.names.at, at, 1, attr);
+    define_native_function(vm.names.fill, fill, 1, attr);
+    define_native_function(vm.names.indexOf, index_of, 1, attr);
+    define_native_function(vm.names.reverse, reverse, 0, attr);
+    define_native_function(vm.names.set, set, 1, attr);
+    define_native_function(vm.names.subarray, subarray, 2, attr);
 }
 
 TypedArrayPrototype::~TypedArrayPrototype()
@@ -42,6 +48,166 @@ static TypedArrayBase* typed_array_from(VM& vm, GlobalObject& global_object)
     return static_cast<TypedArrayBase*>(this_object);
 }
 
+// Calls the callback with the typed array as its actual type, so it can work on the elements directly.
+template<typename Callback>
+static decltype(auto) visit_typed_array(TypedArrayBase& typed_array, Callback callback)
+{
+#undef __JS_ENUMERATE
+#define __JS_ENUMERATE(ClassName, snake_name, PrototypeName, ConstructorName, ArrayType) \
+    if (is<ClassName>(typed_array))                                                      \
+        return callback(static_cast<ClassName&>(typed_array));
+    JS_ENUMERATE_TYPED_ARRAYS
+#undef __JS_ENUMERATE
+    VERIFY_NOT_REACHED();
+}
+
+// Clamps a relative start or end argument into [0, length], with negative ones counting from the end.
+static Optional<size_t> relative_index_argument(GlobalObject& global_object, Value argument, size_t length, size_t default_index)
+{
+    if (argument.is_undefined())
+        return default_index;
+    auto relative_index = argument.to_integer_or_infinity(global_object);
+    if (global_object.vm().exception())
+        return {};
+    if (relative_index < 0)
+        return (size_t)max((double)length + relative_index, 0.0);
+    return (size_t)min(relative_index, (double)length);
+}
+
+// The bulk operations below work on 16 bytes of elements at a time.
+template<typename T>
+struct SIMDVector;
+template<>
+struct SIMDVector<u8> {
+    using Type = AK::SIMD::u8x16;
+};
+template<>
+struct SIMDVector<u16> {
+    using Type = AK::SIMD::u16x8;
+};
+template<>
+struct SIMDVector<u32> {
+    using Type = AK::SIMD::u32x4;
+};
+template<>
+struct SIMDVector<i8> {
+    using Type = AK::SIMD::i8x16;
+};
+template<>
+struct SIMDVector<i16> {
+    using Type = AK::SIMD::i16x8;
+};
+template<>
+struct SIMDVector<i32> {
+    using Type = AK::SIMD::i32x4;
+};
+template<>
+struct SIMDVector<float> {
+    using Type = AK::SIMD::f32x4;
+};
+template<>
+struct SIMDVector<double> {
+    using Type = AK::SIMD::f64x2;
+};
+
+template<typename T>
+static typename SIMDVector<T>::Type splat(T value)
+{
+    typename SIMDVector<T>::Type vector;
+    for (size_t i = 0; i < sizeof(vector) / sizeof(T); ++i)
+        vector[i] = value;
+    return vector;
+}
+
+template<typename T>
+static void fill_elements(Span<T> elements, T value)
+{
+    auto vector = splat(value);
+    constexpr size_t lanes = sizeof(vector) / sizeof(T);
+    size_t i = 0;
+    for (; i + lanes <= elements.size(); i += lanes)
+        __builtin_memcpy(elements.data() + i, &vector, sizeof(vector));
+    for (; i < elements.size(); ++i)
+        elements[i] = value;
+}
+
+template<typename T>
+static Optional<size_t> find_element(Span<const T> elements, size_t start, T value)
+{
+    auto needle = splat(value);
+    constexpr size_t lanes = sizeof(needle) / sizeof(T);
+    size_t i = start;
+    for (; i + lanes <= elements.size(); i += lanes) {
+        decltype(needle) chunk;
+        __builtin_memcpy(&chunk, elements.data() + i, sizeof(chunk));
+        // Lanes that are equal come out as all ones, which is also how floats compare (so NaN is never found, and 0 is -0).
+        auto matches = chunk == needle;
+        static_assert(sizeof(matches) == 2 * sizeof(u64));
+        u64 halves[2];
+        __builtin_memcpy(halves, &matches, sizeof(halves));
+        if (!(halves[0] | halves[1]))
+            continue;
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            if (matches[lane])
+                return i + lane;
+        }
+    }
+    for (; i < elements.size(); ++i) {
+        if (elements[i] == value)
+            return i;
+    }
+    return {};
+}
+
+// Only numbers that are exactly representable as an element can be strictly equal to one.
+template<typename T>
+static Optional<T> element_equal_to(double number)
+{
+    if constexpr (IsFloatingPoint<T>) {
+        if (__builtin_isnan(number))
+            return {};
+        if constexpr (IsSame<T, float>) {
+            if (!__builtin_isinf(number) && __builtin_fabs(number) > NumericLimits<float>::max())
+                return {};
+        }
+        if ((double)(T)number != number)
+            return {};
+        return (T)number;
+    } else {
+        if (!(number >= NumericLimits<T>::min() && number <= NumericLimits<T>::max()))
+            return {};
+        if ((double)(T)number != number)
+            return {};
+        return (T)number;
+    }
+}
+
+template<typename T>
+static void reverse_elements(Span<T> elements)
+{
+    if (elements.is_empty())
+        return;
+    for (size_t lower = 0, upper = elements.size() - 1; lower < upper; ++lower, --upper)
+        swap(elements[lower], elements[upper]);
+}
+
+// Converting between element types goes through a number just like the spec says, but without making a Value when the result is the same.
+template<typename TargetArray, typename T, typename U>
+static void copy_elements(TargetArray& target_array, Span<T> target, Span<const U> source)
+{
+    VERIFY(target.size() >= source.size());
+    if constexpr (IsSame<T, U>) {
+        __builtin_memmove(target.data(), source.data(), source.size() * sizeof(T));
+    } else {
+        for (size_t i = 0; i < source.size(); ++i) {
+            if constexpr ((IsIntegral<T> && IsIntegral<U>) || IsFloatingPoint<T>)
+                target[i] = static_cast<T>(source[i]);
+            else
+                target[i] = target_array.element_from_value(Value((double)source[i]));
+        }
+    }
+}
+
 JS_DEFINE_NATIVE_GETTER(TypedArrayPrototype::length_getter)
 {
     auto typed_array = typed_array_from(vm, global_object);
@@ -73,4 +239,159 @@ JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::at)
     return typed_array->get(index.value());
 }
 
+JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::fill)
+{
+    auto typed_array = typed_array_from(vm, global_object);
+    if (!typed_array)
+        return {};
+    auto length = typed_array->array_length();
+    auto number = vm.argument(0).to_number(global_object);
+    if (vm.exception())
+        return {};
+    auto start = relative_index_argument(global_object, vm.argument(1), length, 0);
+    if (vm.exception())
+        return {};
+    auto end = relative_index_argument(global_object, vm.argument(2), length, length);
+    if (vm.exception())
+        return {};
+    if (start.value() >= end.value())
+        return typed_array;
+
+    visit_typed_array(*typed_array, [&](auto& array) {
+        // The value is converted once, which can't throw anymore, since it's a number by now.
+        auto element = array.element_from_value(number);
+        fill_elements(array.data().slice(start.value(), end.value() - start.value()), element);
+    });
+    return typed_array;
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::index_of)
+{
+    auto typed_array = typed_array_from(vm, global_object);
+    if (!typed_array)
+        return {};
+    auto length = typed_array->array_length();
+    if (length == 0)
+        return Value(-1);
+    auto start = relative_index_argument(global_object, vm.argument(1), length, 0);
+    if (vm.exception())
+        return {};
+    auto search_element = vm.argument(0);
+    if (!search_element.is_number())
+        return Value(-1);
+
+    auto index = visit_typed_array(*typed_array, [&](auto& array) -> Optional<size_t> {
+        auto elements = array.data();
+        using ElementType = RemoveConst<RemoveReference<decltype(elements[0])>>;
+        auto element = element_equal_to<ElementType>(search_element.as_double());
+        if (!element.has_value())
+            return {};
+        return find_element<ElementType>(elements, start.value(), element.value());
+    });
+    if (!index.has_value())
+        return Value(-1);
+    return Value(index.value());
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::reverse)
+{
+    auto typed_array = typed_array_from(vm, global_object);
+    if (!typed_array)
+        return {};
+    visit_typed_array(*typed_array, [&](auto& array) {
+        reverse_elements(array.data());
+    });
+    return typed_array;
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::set)
+{
+    auto typed_array = typed_array_from(vm, global_object);
+    if (!typed_array)
+        return {};
+    auto relative_offset = vm.argument(1).to_integer_or_infinity(global_object);
+    if (vm.exception())
+        return {};
+    if (relative_offset < 0) {
+        vm.throw_exception<RangeError>(global_object, ErrorType::TypedArrayOutOfRangeSetOffset, typed_array->array_length(), 0, relative_offset);
+        return {};
+    }
+    auto target_length = typed_array->array_length();
+
+    auto source = vm.argument(0);
+    if (source.is_object() && source.as_object().is_typed_array()) {
+        auto& source_array = static_cast<TypedArrayBase&>(source.as_object());
+        auto source_length = source_array.array_length();
+        if (source_length > target_length || relative_offset > target_length - source_length) {
+            vm.throw_exception<RangeError>(global_object, ErrorType::TypedArrayOutOfRangeSetOffset, target_length, source_length, relative_offset);
+            return {};
+        }
+        auto offset = (size_t)relative_offset;
+        bool same_buffer = source_array.viewed_array_buffer() == typed_array->viewed_array_buffer();
+        visit_typed_array(*typed_array, [&](auto& target) {
+            visit_typed_array(source_array, [&](auto& source) {
+                auto source_elements = source.data();
+                auto target_elements = target.data().slice(offset, source_length);
+                using SourceType = RemoveConst<RemoveReference<decltype(source_elements[0])>>;
+                using TargetType = RemoveReference<decltype(target_elements[0])>;
+                // Converting elements in place could overwrite the ones that haven't been read yet, so those are copied first.
+                if (same_buffer && !IsSame<SourceType, TargetType>) {
+                    auto copy = ByteBuffer::copy(source_elements.data(), source_elements.size() * sizeof(SourceType));
+                    copy_elements(target, target_elements, Span<const SourceType> { reinterpret_cast<const SourceType*>(copy.data()), source_length });
+                } else {
+                    copy_elements(target, target_elements, Span<const SourceType> { source_elements });
+                }
+            });
+        });
+        return js_undefined();
+    }
+
+    auto* source_object = source.to_object(global_object);
+    if (!source_object)
+        return {};
+    auto source_length = length_of_array_like(global_object, *source_object);
+    if (vm.exception())
+        return {};
+    if (source_length > target_length || relative_offset > target_length - source_length) {
+        vm.throw_exception<RangeError>(global_object, ErrorType::TypedArrayOutOfRangeSetOffset, target_length, source_length, relative_offset);
+        return {};
+    }
+    auto offset = (size_t)relative_offset;
+    for (size_t i = 0; i < source_length; ++i) {
+        auto value = source_object->get(i).value_or(js_undefined());
+        if (vm.exception())
+            return {};
+        typed_array->put(offset + i, value);
+        if (vm.exception())
+            return {};
+    }
+    return js_undefined();
+}
+
+JS_DEFINE_NATIVE_FUNCTION(TypedArrayPrototype::subarray)
+{
+    auto typed_array = typed_array_from(vm, global_object);
+    if (!typed_array)
+        return {};
+    auto length = typed_array->array_length();
+    auto begin = relative_index_argument(global_object, vm.argument(0), length, 0);
+    if (vm.exception())
+        return {};
+    auto end = relative_index_argument(global_object, vm.argument(1), length, length);
+    if (vm.exception())
+        return {};
+    auto new_length = begin.value() < end.value() ? end.value() - begin.value() : 0;
+
+    // FIXME: This should create the new array through the species constructor.
+    return visit_typed_array(*typed_array, [&](auto& array) -> Value {
+        // The new array is a view into the same buffer, so nothing is copied.
+        auto* subarray = RemoveReference<decltype(array)>::create(global_object, 0);
+        subarray->set_viewed_array_buffer(array.viewed_array_buffer());
+        subarray->set_byte_offset(array.byte_offset() + begin.value() * array.element_size());
+        subarray->set_byte_length(new_length * array.element_size());
+        subarray->set_array_length(new_length);
+        return subarray;
+    });
+}
+
 }
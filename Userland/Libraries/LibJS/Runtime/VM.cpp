@@ -13,11 +13,13 @@
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/LexicalEnvironment.h>
 #include <LibJS/Runtime/NativeFunction.h>
 #include <LibJS/Runtime/PromiseReaction.h>
 #include <LibJS/Runtime/Reference.h>
 #include <LibJS/Runtime/ScriptFunction.h>
 #include <LibJS/Runtime/Symbol.h>
+#include <LibJS/Runtime/VariableCache.h>
 #include <LibJS/Runtime/VM.h>
 
 namespace JS {
@@ -83,11 +85,25 @@ VM::InterpreterExecutionScope::~InterpreterExecutionScope()
     m_interpreter.vm().pop_interpreter(m_interpreter);
 }
 
+PrimitiveString& VM::integer_string(i32 value)
+{
+    auto& entry = m_integer_strings[static_cast<u32>(value) % integer_string_cache_size];
+    if (!entry.string || entry.value != value) {
+        auto* string = js_string(heap(), String::number(value));
+        entry = { value, string };
+    }
+    return *entry.string;
+}
+
 void VM::gather_roots(HashTable<Cell*>& roots)
 {
     roots.set(m_empty_string);
     for (auto* string : m_single_ascii_character_strings)
         roots.set(string);
+    for (auto& entry : m_integer_strings) {
+        if (entry.string)
+            roots.set(entry.string);
+    }
 
     roots.set(m_scope_object_shape);
     roots.set(m_exception);
@@ -114,8 +130,8 @@ void VM::gather_roots(HashTable<Cell*>& roots)
     for (auto& symbol : m_global_symbol_map)
         roots.set(symbol.value);
 
-    for (auto* job : m_promise_jobs)
-        roots.set(job);
+    for (size_t i = m_next_promise_job; i < m_promise_jobs.size(); ++i)
+        m_promise_jobs[i].gather_roots(roots);
 }
 
 Symbol* VM::get_global_symbol(const String& description)
@@ -129,10 +145,54 @@ Symbol* VM::get_global_symbol(const String& description)
     return new_global_symbol;
 }
 
-void VM::set_variable(const FlyString& name, Value value, GlobalObject& global_object, bool first_assignment)
+Variable* VM::find_cached_variable(const VariableCache& cache)
+{
+    if (cache.epoch != m_variable_cache_epoch)
+        return nullptr;
+    auto* scope = current_scope();
+    if (!is<LexicalEnvironment>(*scope) || static_cast<LexicalEnvironment&>(*scope).layout_id() != cache.scope_layout_id)
+        return nullptr;
+    for (u32 i = 0; i < cache.hops && scope; ++i)
+        scope = scope->parent();
+    if (!scope || !is<LexicalEnvironment>(*scope))
+        return nullptr;
+    auto& environment = static_cast<LexicalEnvironment&>(*scope);
+    if (environment.layout_id() != cache.environment_layout_id)
+        return nullptr;
+    return &environment.variable_at(cache.index);
+}
+
+void VM::cache_variable(VariableCache& cache, ScopeObject& found_in, u32 hops, const FlyString& name)
+{
+    auto* scope = current_scope();
+    if (!is<LexicalEnvironment>(*scope) || !is<LexicalEnvironment>(found_in))
+        return;
+    auto& environment = static_cast<LexicalEnvironment&>(found_in);
+    auto index = environment.index_of(name);
+    VERIFY(index.has_value());
+    cache.scope_layout_id = static_cast<LexicalEnvironment&>(*scope).layout_id();
+    cache.environment_layout_id = environment.layout_id();
+    cache.epoch = m_variable_cache_epoch;
+    cache.hops = hops;
+    cache.index = index.value();
+}
+
+void VM::set_variable(const FlyString& name, Value value, GlobalObject& global_object, bool first_assignment, VariableCache* cache)
 {
     if (m_call_stack.size()) {
-        for (auto* scope = current_scope(); scope; scope = scope->parent()) {
+        if (cache) {
+            if (auto* variable = find_cached_variable(*cache)) {
+                if (!first_assignment && variable->declaration_kind == DeclarationKind::Const) {
+                    throw_exception<TypeError>(global_object, ErrorType::InvalidAssignToConst);
+                    return;
+                }
+                variable->value = value;
+                return;
+            }
+        }
+
+        u32 hops = 0;
+        for (auto* scope = current_scope(); scope; scope = scope->parent(), ++hops) {
             auto possible_match = scope->get_from_scope(name);
             if (possible_match.has_value()) {
                 if (!first_assignment && possible_match.value().declaration_kind == DeclarationKind::Const) {
@@ -141,15 +201,20 @@ void VM::set_variable(const FlyString& name, Value value, GlobalObject& global_o
                 }
 
                 scope->put_to_scope(name, { value, possible_match.value().declaration_kind });
+                if (cache)
+                    cache_variable(*cache, *scope, hops, name);
                 return;
             }
+            // Whatever a with statement's object has can change at any time, so a lookup through it can't be cached.
+            if (!is<LexicalEnvironment>(*scope))
+                cache = nullptr;
         }
     }
 
     global_object.put(move(name), move(value));
 }
 
-Value VM::get_variable(const FlyString& name, GlobalObject& global_object)
+Value VM::get_variable(const FlyString& name, GlobalObject& global_object, VariableCache* cache)
 {
     if (!m_call_stack.is_empty()) {
         if (name == names.arguments && !call_frame().callee.is_empty()) {
@@ -171,10 +236,21 @@ Value VM::get_variable(const FlyString& name, GlobalObject& global_object)
             return call_frame().arguments_object;
         }
 
-        for (auto* scope = current_scope(); scope; scope = scope->parent()) {
+        if (cache) {
+            if (auto* variable = find_cached_variable(*cache))
+                return variable->value;
+        }
+
+        u32 hops = 0;
+        for (auto* scope = current_scope(); scope; scope = scope->parent(), ++hops) {
             auto possible_match = scope->get_from_scope(name);
-            if (possible_match.has_value())
+            if (possible_match.has_value()) {
+                if (cache)
+                    cache_variable(*cache, *scope, hops, name);
                 return possible_match.value().value;
+            }
+            if (!is<LexicalEnvironment>(*scope))
+                cache = nullptr;
         }
     }
     auto value = global_object.get(name);
@@ -215,25 +291,20 @@ Value VM::construct(Function& function, Function& new_target, Optional<MarkedVal
     call_frame.function_name = function.name();
     call_frame.arguments = function.bound_arguments();
     if (arguments.has_value())
-        call_frame.arguments.append(arguments.value().values());
+        call_frame.arguments.append(arguments->values().data(), arguments->size());
     auto* environment = function.create_environment();
     call_frame.scope = environment;
     environment->set_new_target(&new_target);
 
     Object* new_object = nullptr;
     if (function.constructor_kind() == Function::ConstructorKind::Base) {
-        new_object = Object::create_empty(global_object);
-        environment->bind_this_value(global_object, new_object);
+        auto prototype = new_target.get(names.prototype);
         if (exception())
             return {};
-        auto prototype = new_target.get(names.prototype);
+        new_object = new_target.create_instance(global_object, prototype.is_object() ? &prototype.as_object() : nullptr);
+        environment->bind_this_value(global_object, new_object);
         if (exception())
             return {};
-        if (prototype.is_object()) {
-            new_object->set_prototype(&prototype.as_object());
-            if (exception())
-                return {};
-        }
     }
 
     // If we are a Derived constructor, |this| has not been constructed before super is called.
@@ -264,6 +335,9 @@ Value VM::construct(Function& function, Function& new_target, Optional<MarkedVal
     if (exception())
         return {};
 
+    if (new_object)
+        new_target.did_construct_instance(*new_object);
+
     if (result.is_object())
         return result;
 
@@ -333,11 +407,19 @@ Value VM::get_new_target() const
     return static_cast<const LexicalEnvironment*>(find_this_scope())->new_target();
 }
 
-Value VM::call_internal(Function& function, Value this_value, Optional<MarkedValueList> arguments)
+Value VM::call_internal(Function& function, Value this_value, Span<const Value> arguments)
 {
     VERIFY(!exception());
     VERIFY(!this_value.is_empty());
 
+    bool is_native_function = is<NativeFunction>(function);
+    if (is_native_function) {
+        if (auto fast_path = static_cast<NativeFunction&>(function).fast_path()) {
+            if (auto result = fast_path(this_value, arguments); !result.is_empty())
+                return result;
+        }
+    }
+
     CallFrame call_frame;
     call_frame.callee = &function;
     if (auto* interpreter = interpreter_if_exists())
@@ -345,16 +427,33 @@ Value VM::call_internal(Function& function, Value this_value, Optional<MarkedVal
     call_frame.is_strict_mode = function.is_strict_mode();
     call_frame.function_name = function.name();
     call_frame.this_value = function.bound_this().value_or(this_value);
-    call_frame.arguments = function.bound_arguments();
-    if (arguments.has_value())
-        call_frame.arguments.append(move(arguments.release_value().values()));
-    auto* environment = function.create_environment();
-    call_frame.scope = environment;
+    if (!function.bound_arguments().is_empty())
+        call_frame.arguments = function.bound_arguments();
+    call_frame.arguments.append(arguments.data(), arguments.size());
+
+    if (is_native_function) {
+        // Builtins get the this value and their arguments from the call frame, so they don't need an environment.
+        // Whatever code they run themselves (like the Function constructor) sees the global scope.
+        call_frame.scope = &function.global_object();
+    } else {
+        // 10.2.1.2 OrdinaryCallBindThis, https://tc39.es/ecma262/#sec-ordinarycallbindthis
+        // Functions that aren't strict get a primitive this value as an object. Callers used to do that for every call.
+        // FIXME: A this value of undefined or null should become the global object.
+        auto& bound_this_value = call_frame.this_value;
+        if (!call_frame.is_strict_mode && !bound_this_value.is_object() && !bound_this_value.is_nullish() && is<ScriptFunction>(function) && !static_cast<ScriptFunction&>(function).is_arrow_function()) {
+            bound_this_value = bound_this_value.to_object(function.global_object());
+            if (exception())
+                return {};
+        }
 
-    VERIFY(environment->this_binding_status() == LexicalEnvironment::ThisBindingStatus::Uninitialized);
-    environment->bind_this_value(function.global_object(), call_frame.this_value);
-    if (exception())
-        return {};
+        auto* environment = function.create_environment();
+        call_frame.scope = environment;
+
+        VERIFY(environment->this_binding_status() == LexicalEnvironment::ThisBindingStatus::Uninitialized);
+        environment->bind_this_value(function.global_object(), call_frame.this_value);
+        if (exception())
+            return {};
+    }
 
     push_call_frame(call_frame, function.global_object());
     if (exception())
@@ -377,19 +476,22 @@ void VM::run_queued_promise_jobs()
     // Temporarily get rid of the exception, if any - job functions must be called
     // either way, and that can't happen if we already have an exception stored.
     TemporaryChange change(m_exception, static_cast<Exception*>(nullptr));
-    while (!m_promise_jobs.is_empty()) {
-        auto* job = m_promise_jobs.take_first();
-        dbgln_if(PROMISE_DEBUG, "Calling promise job function @ {}", job);
-        [[maybe_unused]] auto result = call(*job, js_undefined());
+    while (m_next_promise_job < m_promise_jobs.size()) {
+        // The job has to be copied out, since running it can enqueue more jobs and grow the queue.
+        auto job = m_promise_jobs[m_next_promise_job++];
+        dbgln_if(PROMISE_DEBUG, "Running promise job #{}", m_next_promise_job - 1);
+        job.run(*this);
     }
+    m_promise_jobs.clear_with_capacity();
+    m_next_promise_job = 0;
     // Ensure no job has created a new exception, they must clean up after themselves.
     VERIFY(!m_exception);
 }
 
 // 9.4.4 HostEnqueuePromiseJob, https://tc39.es/ecma262/#sec-hostenqueuepromisejob
-void VM::enqueue_promise_job(NativeFunction& job)
+void VM::enqueue_promise_job(const PromiseJob& job)
 {
-    m_promise_jobs.append(&job);
+    m_promise_jobs.append(job);
 }
 
 // 27.2.1.9 HostPromiseRejectionTracker, https://tc39.es/ecma262/#sec-host-promise-rejection-tracker
@@ -19,6 +19,7 @@
 #include <LibJS/Runtime/Exception.h>
 #include <LibJS/Runtime/MarkedValueList.h>
 #include <LibJS/Runtime/Promise.h>
+#include <LibJS/Runtime/PromiseJobs.h>
 #include <LibJS/Runtime/Value.h>
 
 namespace JS {
@@ -43,7 +44,8 @@ struct CallFrame {
     FlyString function_name;
     Value callee;
     Value this_value;
-    Vector<Value> arguments;
+    // Most calls don't have more than a handful of arguments, which then don't need an allocation of their own.
+    Vector<Value, 8> arguments;
     Array* arguments_object { nullptr };
     ScopeObject* scope { nullptr };
     bool is_strict_mode { false };
@@ -95,6 +97,10 @@ public:
         return *m_single_ascii_character_strings[character];
     }
 
+    // The same integers tend to be turned into strings over and over again, e.g. when building up markup, so the
+    // strings of the most recent ones are kept around.
+    PrimitiveString& integer_string(i32);
+
     void push_call_frame(CallFrame& call_frame, GlobalObject& global_object)
     {
         VERIFY(!exception());
@@ -177,8 +183,12 @@ public:
 
     ScopeType unwind_until() const { return m_unwind_until; }
 
-    Value get_variable(const FlyString& name, GlobalObject&);
-    void set_variable(const FlyString& name, Value, GlobalObject&, bool first_assignment = false);
+    // With a cache, the lookup can usually skip walking the scope chain, and fills the cache when it can't.
+    Value get_variable(const FlyString& name, GlobalObject&, VariableCache* = nullptr);
+    void set_variable(const FlyString& name, Value, GlobalObject&, bool first_assignment = false, VariableCache* = nullptr);
+
+    // Must be called when a binding is added to an existing environment, since it might shadow a cached one.
+    void invalidate_variable_caches() { ++m_variable_cache_epoch; }
 
     Reference get_reference(const FlyString& name);
 
@@ -225,7 +235,7 @@ public:
     Shape& scope_object_shape() { return *m_scope_object_shape; }
 
     void run_queued_promise_jobs();
-    void enqueue_promise_job(NativeFunction&);
+    void enqueue_promise_job(const PromiseJob&);
 
     void promise_rejection_tracker(const Promise&, Promise::RejectionOperation) const;
 
@@ -235,7 +245,10 @@ public:
 private:
     VM();
 
-    [[nodiscard]] Value call_internal(Function&, Value this_value, Optional<MarkedValueList> arguments);
+    [[nodiscard]] Value call_internal(Function&, Value this_value, Span<const Value> arguments);
+
+    Variable* find_cached_variable(const VariableCache&);
+    void cache_variable(VariableCache&, ScopeObject& found_in, u32 hops, const FlyString& name);
 
     Exception* m_exception { nullptr };
 
@@ -252,11 +265,21 @@ private:
 
     HashMap<String, Symbol*> m_global_symbol_map;
 
-    Vector<NativeFunction*> m_promise_jobs;
+    // Jobs are taken from the front by advancing the index, and the queue is only emptied once all of them have run,
+    // so that its storage can be used again by the next batch.
+    Vector<PromiseJob> m_promise_jobs;
+    size_t m_next_promise_job { 0 };
 
     PrimitiveString* m_empty_string { nullptr };
     PrimitiveString* m_single_ascii_character_strings[128] {};
 
+    struct IntegerString {
+        i32 value { 0 };
+        PrimitiveString* string { nullptr };
+    };
+    static constexpr size_t integer_string_cache_size = 1024;
+    IntegerString m_integer_strings[integer_string_cache_size] {};
+
 #define __JS_ENUMERATE(SymbolName, snake_name) \
     Symbol* m_well_known_symbol_##snake_name { nullptr };
     JS_ENUMERATE_WELL_KNOWN_SYMBOLS
@@ -264,18 +287,25 @@ private:
 
     Shape* m_scope_object_shape { nullptr };
 
+    u64 m_variable_cache_epoch { 1 };
+
     bool m_underscore_is_last_value { false };
     bool m_should_log_exceptions { false };
 };
 
 template<>
-[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value, MarkedValueList arguments) { return call_internal(function, this_value, move(arguments)); }
+[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value, MarkedValueList arguments) { return call_internal(function, this_value, arguments.values().span()); }
+
+template<>
+[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value, Optional<MarkedValueList> arguments) { return call_internal(function, this_value, arguments.has_value() ? arguments->values().span() : Span<const Value> {}); }
 
+// The caller has to keep the arguments alive, for example by having them on the stack (where the garbage collector
+// finds them) or in a MarkedValueList. Once the call has started, they're in its call frame.
 template<>
-[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value, Optional<MarkedValueList> arguments) { return call_internal(function, this_value, move(arguments)); }
+[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value, Span<const Value> arguments) { return call_internal(function, this_value, arguments); }
 
 template<>
-[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value) { return call(function, this_value, Optional<MarkedValueList> {}); }
+[[nodiscard]] ALWAYS_INLINE Value VM::call(Function& function, Value this_value) { return call_internal(function, this_value, {}); }
 
 ALWAYS_INLINE Heap& Cell::heap() const
 {
@@ -204,7 +204,7 @@ bool Value::is_array() const
 Array& Value::as_array()
 {
     VERIFY(is_array());
-    return static_cast<Array&>(*m_value.as_object);
+    return static_cast<Array&>(as_object());
 }
 
 bool Value::is_function() const
@@ -246,7 +246,7 @@ bool Value::is_regexp(GlobalObject& global_object) const
 
 String Value::typeof() const
 {
-    switch (m_type) {
+    switch (type()) {
     case Value::Type::Undefined:
         return "undefined";
     case Value::Type::Null:
@@ -273,23 +273,23 @@ String Value::typeof() const
 
 String Value::to_string_without_side_effects() const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
         return "undefined";
     case Type::Null:
         return "null";
     case Type::Boolean:
-        return m_value.as_bool ? "true" : "false";
+        return as_bool() ? "true" : "false";
     case Type::Int32:
-        return String::number(m_value.as_i32);
+        return String::number(int32_payload());
     case Type::Double:
-        return double_to_string(m_value.as_double);
+        return double_to_string(as_double());
     case Type::String:
-        return m_value.as_string->string();
+        return as_string().string();
     case Type::Symbol:
-        return m_value.as_symbol->to_string();
+        return as_symbol().to_string();
     case Type::BigInt:
-        return m_value.as_bigint->to_string();
+        return cell_payload<BigInt>()->to_string();
     case Type::Object:
         return String::formatted("[object {}]", as_object().class_name());
     case Type::Accessor:
@@ -305,6 +305,8 @@ PrimitiveString* Value::to_primitive_string(GlobalObject& global_object)
 {
     if (is_string())
         return &as_string();
+    if (is_int32())
+        return &global_object.vm().integer_string(int32_payload());
     auto string = to_string(global_object);
     if (global_object.vm().exception())
         return nullptr;
@@ -313,24 +315,24 @@ PrimitiveString* Value::to_primitive_string(GlobalObject& global_object)
 
 String Value::to_string(GlobalObject& global_object, bool legacy_null_to_empty_string) const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
         return "undefined";
     case Type::Null:
         return !legacy_null_to_empty_string ? "null" : String::empty();
     case Type::Boolean:
-        return m_value.as_bool ? "true" : "false";
+        return as_bool() ? "true" : "false";
     case Type::Int32:
-        return String::number(m_value.as_i32);
+        return String::number(int32_payload());
     case Type::Double:
-        return double_to_string(m_value.as_double);
+        return double_to_string(as_double());
     case Type::String:
-        return m_value.as_string->string();
+        return as_string().string();
     case Type::Symbol:
         global_object.vm().throw_exception<TypeError>(global_object, ErrorType::Convert, "symbol", "string");
         return {};
     case Type::BigInt:
-        return m_value.as_bigint->big_integer().to_base10();
+        return cell_payload<BigInt>()->big_integer().to_base10();
     case Type::Object: {
         auto primitive_value = to_primitive(global_object, PreferredType::String);
         if (global_object.vm().exception())
@@ -344,24 +346,24 @@ String Value::to_string(GlobalObject& global_object, bool legacy_null_to_empty_s
 
 bool Value::to_boolean() const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
     case Type::Null:
         return false;
     case Type::Boolean:
-        return m_value.as_bool;
+        return as_bool();
     case Type::Int32:
-        return m_value.as_i32 != 0;
+        return int32_payload() != 0;
     case Type::Double:
         if (is_nan())
             return false;
-        return m_value.as_double != 0;
+        return as_double() != 0;
     case Type::String:
-        return !m_value.as_string->string().is_empty();
+        return !as_string().string().is_empty();
     case Type::Symbol:
         return true;
     case Type::BigInt:
-        return m_value.as_bigint->big_integer() != BIGINT_ZERO;
+        return cell_payload<BigInt>()->big_integer() != BIGINT_ZERO;
     case Type::Object:
         return true;
     default:
@@ -407,22 +409,22 @@ Value Value::to_primitive(GlobalObject& global_object, PreferredType preferred_t
 
 Object* Value::to_object(GlobalObject& global_object) const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
     case Type::Null:
         global_object.vm().throw_exception<TypeError>(global_object, ErrorType::ToObjectNullOrUndefined);
         return nullptr;
     case Type::Boolean:
-        return BooleanObject::create(global_object, m_value.as_bool);
+        return BooleanObject::create(global_object, as_bool());
     case Type::Int32:
     case Type::Double:
         return NumberObject::create(global_object, as_double());
     case Type::String:
-        return StringObject::create(global_object, *m_value.as_string);
+        return StringObject::create(global_object, *cell_payload<PrimitiveString>());
     case Type::Symbol:
-        return SymbolObject::create(global_object, *m_value.as_symbol);
+        return SymbolObject::create(global_object, *cell_payload<Symbol>());
     case Type::BigInt:
-        return BigIntObject::create(global_object, *m_value.as_bigint);
+        return BigIntObject::create(global_object, *cell_payload<BigInt>());
     case Type::Object:
         return &const_cast<Object&>(as_object());
     default:
@@ -443,13 +445,13 @@ FLATTEN Value Value::to_numeric(GlobalObject& global_object) const
 
 Value Value::to_number(GlobalObject& global_object) const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
         return js_nan();
     case Type::Null:
         return Value(0);
     case Type::Boolean:
-        return Value(m_value.as_bool ? 1 : 0);
+        return Value(as_bool() ? 1 : 0);
     case Type::Int32:
     case Type::Double:
         return *this;
@@ -524,11 +526,6 @@ BigInt* Value::to_bigint(GlobalObject& global_object) const
 }
 
 // FIXME: These two conversions are wrong for JS, and seem likely to be footguns
-i32 Value::as_i32() const
-{
-    return static_cast<i32>(as_double());
-}
-
 u32 Value::as_u32() const
 {
     VERIFY(as_double() >= 0);
@@ -556,7 +553,10 @@ i32 Value::to_i32_slow_case(GlobalObject& global_object) const
     auto int_val = floor(abs);
     if (signbit(value))
         int_val = -int_val;
+    // fmod() keeps the sign of the dividend, but the spec wants a modulo that's never negative.
     auto int32bit = fmod(int_val, 4294967296.0);
+    if (int32bit < 0)
+        int32bit += 4294967296.0;
     if (int32bit >= 2147483648.0)
         int32bit -= 4294967296.0;
     return static_cast<i32>(int32bit);
@@ -575,6 +575,8 @@ u32 Value::to_u32(GlobalObject& global_object) const
     if (signbit(value))
         int_val = -int_val;
     auto int32bit = fmod(int_val, NumericLimits<u32>::max() + 1.0);
+    if (int32bit < 0)
+        int32bit += NumericLimits<u32>::max() + 1.0;
     return static_cast<u32>(int32bit);
 }
 
@@ -637,6 +639,8 @@ double Value::to_integer_or_infinity(GlobalObject& global_object) const
 
 Value greater_than(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() > rhs.as_i32());
     TriState relation = abstract_relation(global_object, false, lhs, rhs);
     if (relation == TriState::Unknown)
         return Value(false);
@@ -645,6 +649,8 @@ Value greater_than(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value greater_than_equals(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() >= rhs.as_i32());
     TriState relation = abstract_relation(global_object, true, lhs, rhs);
     if (relation == TriState::Unknown || relation == TriState::True)
         return Value(false);
@@ -653,6 +659,8 @@ Value greater_than_equals(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value less_than(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() < rhs.as_i32());
     TriState relation = abstract_relation(global_object, true, lhs, rhs);
     if (relation == TriState::Unknown)
         return Value(false);
@@ -661,6 +669,8 @@ Value less_than(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value less_than_equals(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() <= rhs.as_i32());
     TriState relation = abstract_relation(global_object, false, lhs, rhs);
     if (relation == TriState::Unknown || relation == TriState::True)
         return Value(false);
@@ -669,6 +679,8 @@ Value less_than_equals(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value bitwise_and(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() & rhs.as_i32());
     auto lhs_numeric = lhs.to_numeric(global_object);
     if (global_object.vm().exception())
         return {};
@@ -688,6 +700,8 @@ Value bitwise_and(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value bitwise_or(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() | rhs.as_i32());
     auto lhs_numeric = lhs.to_numeric(global_object);
     if (global_object.vm().exception())
         return {};
@@ -711,6 +725,8 @@ Value bitwise_or(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value bitwise_xor(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32())
+        return Value(lhs.as_i32() ^ rhs.as_i32());
     auto lhs_numeric = lhs.to_numeric(global_object);
     if (global_object.vm().exception())
         return {};
@@ -864,16 +880,13 @@ Value add(GlobalObject& global_object, Value lhs, Value rhs)
         return {};
 
     if (lhs_primitive.is_string() || rhs_primitive.is_string()) {
-        auto lhs_string = lhs_primitive.to_string(global_object);
+        auto* lhs_string = lhs_primitive.to_primitive_string(global_object);
         if (vm.exception())
             return {};
-        auto rhs_string = rhs_primitive.to_string(global_object);
+        auto* rhs_string = rhs_primitive.to_primitive_string(global_object);
         if (vm.exception())
             return {};
-        StringBuilder builder(lhs_string.length() + rhs_string.length());
-        builder.append(lhs_string);
-        builder.append(rhs_string);
-        return js_string(vm.heap(), builder.to_string());
+        return js_rope_string(vm, *lhs_string, *rhs_string);
     }
 
     auto lhs_numeric = lhs_primitive.to_numeric(global_object);
@@ -892,6 +905,12 @@ Value add(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value sub(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32()) {
+        Checked<i32> result = lhs.as_i32();
+        result -= rhs.as_i32();
+        if (!result.has_overflow())
+            return Value(result.value());
+    }
     auto lhs_numeric = lhs.to_numeric(global_object);
     if (global_object.vm().exception())
         return {};
@@ -908,6 +927,13 @@ Value sub(GlobalObject& global_object, Value lhs, Value rhs)
 
 Value mul(GlobalObject& global_object, Value lhs, Value rhs)
 {
+    if (lhs.is_int32() && rhs.is_int32()) {
+        Checked<i32> result = lhs.as_i32();
+        result *= rhs.as_i32();
+        // A zero result with a negative operand has to be -0, which only a double can represent.
+        if (!result.has_overflow() && (result.value() != 0 || (lhs.as_i32() >= 0 && rhs.as_i32() >= 0)))
+            return Value(result.value());
+    }
     auto lhs_numeric = lhs.to_numeric(global_object);
     if (global_object.vm().exception())
         return {};
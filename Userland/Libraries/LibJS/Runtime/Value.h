@@ -45,211 +45,244 @@ public:
         Number,
     };
 
-    bool is_empty() const { return m_type == Type::Empty; }
-    bool is_undefined() const { return m_type == Type::Undefined; }
-    bool is_null() const { return m_type == Type::Null; }
-    bool is_number() const { return m_type == Type::Int32 || m_type == Type::Double; }
-    bool is_string() const { return m_type == Type::String; }
-    bool is_object() const { return m_type == Type::Object; }
-    bool is_boolean() const { return m_type == Type::Boolean; }
-    bool is_symbol() const { return m_type == Type::Symbol; }
-    bool is_accessor() const { return m_type == Type::Accessor; };
-    bool is_bigint() const { return m_type == Type::BigInt; };
-    bool is_native_property() const { return m_type == Type::NativeProperty; }
+    bool is_empty() const { return tag() == EMPTY_TAG; }
+    bool is_undefined() const { return tag() == UNDEFINED_TAG; }
+    bool is_null() const { return tag() == NULL_TAG; }
+    bool is_number() const { return is_int32() || is_double(); }
+    bool is_string() const { return tag() == STRING_TAG; }
+    bool is_object() const { return tag() == OBJECT_TAG; }
+    bool is_boolean() const { return tag() == BOOLEAN_TAG; }
+    bool is_symbol() const { return tag() == SYMBOL_TAG; }
+    bool is_accessor() const { return tag() == ACCESSOR_TAG; };
+    bool is_bigint() const { return tag() == BIGINT_TAG; };
+    bool is_native_property() const { return tag() == NATIVE_PROPERTY_TAG; }
     bool is_nullish() const { return is_null() || is_undefined(); }
-    bool is_cell() const { return is_string() || is_accessor() || is_object() || is_bigint() || is_symbol() || is_native_property(); }
+    bool is_cell() const { return tag() > CELL_TAG_PREFIX; }
     bool is_array() const;
     bool is_function() const;
     bool is_constructor() const;
     bool is_regexp(GlobalObject& global_object) const;
 
-    bool is_nan() const { return is_number() && __builtin_isnan(as_double()); }
-    bool is_infinity() const { return is_number() && __builtin_isinf(as_double()); }
-    bool is_positive_infinity() const { return is_number() && __builtin_isinf_sign(as_double()) > 0; }
-    bool is_negative_infinity() const { return is_number() && __builtin_isinf_sign(as_double()) < 0; }
+    bool is_nan() const { return m_value == CANONICAL_NAN_BITS; }
+    bool is_infinity() const { return is_double() && __builtin_isinf(as_double()); }
+    bool is_positive_infinity() const { return is_double() && __builtin_isinf_sign(as_double()) > 0; }
+    bool is_negative_infinity() const { return is_double() && __builtin_isinf_sign(as_double()) < 0; }
     bool is_positive_zero() const { return is_number() && bit_cast<u64>(as_double()) == 0; }
-    bool is_negative_zero() const { return is_number() && bit_cast<u64>(as_double()) == NEGATIVE_ZERO_BITS; }
+    bool is_negative_zero() const { return m_value == NEGATIVE_ZERO_BITS; }
     bool is_integer() const { return is_finite_number() && (i32)as_double() == as_double(); }
     bool is_finite_number() const
     {
-        if (!is_number())
+        if (is_int32())
+            return true;
+        if (!is_double())
             return false;
         auto number = as_double();
         return !__builtin_isnan(number) && !__builtin_isinf(number);
     }
 
     Value()
-        : m_type(Type::Empty)
+        : m_value(encode(EMPTY_TAG, 0))
     {
     }
 
     explicit Value(bool value)
-        : m_type(Type::Boolean)
+        : m_value(encode(BOOLEAN_TAG, value))
     {
-        m_value.as_bool = value;
     }
 
     explicit Value(double value)
     {
         bool is_negative_zero = bit_cast<u64>(value) == NEGATIVE_ZERO_BITS;
-        if (value >= NumericLimits<i32>::min() && value <= NumericLimits<i32>::max() && trunc(value) == value && !is_negative_zero) {
-            m_type = Type::Int32;
-            m_value.as_i32 = static_cast<i32>(value);
-        } else {
-            m_type = Type::Double;
-            m_value.as_double = value;
-        }
+        if (value >= NumericLimits<i32>::min() && value <= NumericLimits<i32>::max() && trunc(value) == value && !is_negative_zero)
+            m_value = encode_i32(static_cast<i32>(value));
+        else
+            m_value = encode_double(value);
     }
 
     explicit Value(unsigned long value)
     {
-        if (value > NumericLimits<i32>::max()) {
-            m_value.as_double = static_cast<double>(value);
-            m_type = Type::Double;
-        } else {
-            m_value.as_i32 = static_cast<i32>(value);
-            m_type = Type::Int32;
-        }
+        if (value > NumericLimits<i32>::max())
+            m_value = encode_double(static_cast<double>(value));
+        else
+            m_value = encode_i32(static_cast<i32>(value));
     }
 
     explicit Value(unsigned value)
     {
-        if (value > NumericLimits<i32>::max()) {
-            m_value.as_double = static_cast<double>(value);
-            m_type = Type::Double;
-        } else {
-            m_value.as_i32 = static_cast<i32>(value);
-            m_type = Type::Int32;
-        }
+        if (value > NumericLimits<i32>::max())
+            m_value = encode_double(static_cast<double>(value));
+        else
+            m_value = encode_i32(static_cast<i32>(value));
     }
 
     explicit Value(i32 value)
-        : m_type(Type::Int32)
+        : m_value(encode_i32(value))
     {
-        m_value.as_i32 = value;
     }
 
     Value(const Object* object)
-        : m_type(object ? Type::Object : Type::Null)
+        : m_value(object ? encode_cell(OBJECT_TAG, object) : encode(NULL_TAG, 0))
     {
-        m_value.as_object = const_cast<Object*>(object);
     }
 
     Value(const PrimitiveString* string)
-        : m_type(Type::String)
+        : m_value(encode_cell(STRING_TAG, string))
     {
-        m_value.as_string = const_cast<PrimitiveString*>(string);
     }
 
     Value(const Symbol* symbol)
-        : m_type(Type::Symbol)
+        : m_value(encode_cell(SYMBOL_TAG, symbol))
     {
-        m_value.as_symbol = const_cast<Symbol*>(symbol);
     }
 
     Value(const Accessor* accessor)
-        : m_type(Type::Accessor)
+        : m_value(encode_cell(ACCESSOR_TAG, accessor))
     {
-        m_value.as_accessor = const_cast<Accessor*>(accessor);
     }
 
     Value(const BigInt* bigint)
-        : m_type(Type::BigInt)
+        : m_value(encode_cell(BIGINT_TAG, bigint))
     {
-        m_value.as_bigint = const_cast<BigInt*>(bigint);
     }
 
     Value(const NativeProperty* native_property)
-        : m_type(Type::NativeProperty)
+        : m_value(encode_cell(NATIVE_PROPERTY_TAG, native_property))
     {
-        m_value.as_native_property = const_cast<NativeProperty*>(native_property);
     }
 
     explicit Value(Type type)
-        : m_type(type)
     {
+        switch (type) {
+        case Type::Empty:
+            m_value = encode(EMPTY_TAG, 0);
+            break;
+        case Type::Undefined:
+            m_value = encode(UNDEFINED_TAG, 0);
+            break;
+        case Type::Null:
+            m_value = encode(NULL_TAG, 0);
+            break;
+        default:
+            VERIFY_NOT_REACHED();
+        }
+    }
+
+    Type type() const
+    {
+        switch (tag()) {
+        case EMPTY_TAG:
+            return Type::Empty;
+        case UNDEFINED_TAG:
+            return Type::Undefined;
+        case NULL_TAG:
+            return Type::Null;
+        case BOOLEAN_TAG:
+            return Type::Boolean;
+        case INT32_TAG:
+            return Type::Int32;
+        case OBJECT_TAG:
+            return Type::Object;
+        case STRING_TAG:
+            return Type::String;
+        case SYMBOL_TAG:
+            return Type::Symbol;
+        case ACCESSOR_TAG:
+            return Type::Accessor;
+        case BIGINT_TAG:
+            return Type::BigInt;
+        case NATIVE_PROPERTY_TAG:
+            return Type::NativeProperty;
+        default:
+            return Type::Double;
+        }
     }
 
-    Type type() const { return m_type; }
+    bool is_int32() const { return tag() == INT32_TAG; }
+    bool is_double() const { return (tag() & CANONICAL_NAN_TAG) != CANONICAL_NAN_TAG || tag() == CANONICAL_NAN_TAG; }
 
     double as_double() const
     {
         VERIFY(is_number());
-        if (m_type == Type::Int32)
-            return m_value.as_i32;
-        return m_value.as_double;
+        if (is_int32())
+            return int32_payload();
+        return bit_cast<double>(m_value);
     }
 
     bool as_bool() const
     {
-        VERIFY(type() == Type::Boolean);
-        return m_value.as_bool;
+        VERIFY(is_boolean());
+        return m_value & 1;
     }
 
     Object& as_object()
     {
-        VERIFY(type() == Type::Object);
-        return *m_value.as_object;
+        VERIFY(is_object());
+        return *cell_payload<Object>();
     }
 
     const Object& as_object() const
     {
-        VERIFY(type() == Type::Object);
-        return *m_value.as_object;
+        VERIFY(is_object());
+        return *cell_payload<Object>();
     }
 
     PrimitiveString& as_string()
     {
         VERIFY(is_string());
-        return *m_value.as_string;
+        return *cell_payload<PrimitiveString>();
     }
 
     const PrimitiveString& as_string() const
     {
         VERIFY(is_string());
-        return *m_value.as_string;
+        return *cell_payload<PrimitiveString>();
     }
 
     Symbol& as_symbol()
     {
         VERIFY(is_symbol());
-        return *m_value.as_symbol;
+        return *cell_payload<Symbol>();
     }
 
     const Symbol& as_symbol() const
     {
         VERIFY(is_symbol());
-        return *m_value.as_symbol;
+        return *cell_payload<Symbol>();
     }
 
     Cell* as_cell()
     {
         VERIFY(is_cell());
-        return m_value.as_cell;
+        return cell_payload<Cell>();
     }
 
     Accessor& as_accessor()
     {
         VERIFY(is_accessor());
-        return *m_value.as_accessor;
+        return *cell_payload<Accessor>();
     }
 
     BigInt& as_bigint()
     {
         VERIFY(is_bigint());
-        return *m_value.as_bigint;
+        return *cell_payload<BigInt>();
     }
 
     NativeProperty& as_native_property()
     {
         VERIFY(is_native_property());
-        return *m_value.as_native_property;
+        return *cell_payload<NativeProperty>();
     }
 
     Array& as_array();
     Function& as_function();
 
-    i32 as_i32() const;
+    i32 as_i32() const
+    {
+        if (is_int32())
+            return int32_payload();
+        return static_cast<i32>(as_double());
+    }
     u32 as_u32() const;
 
     String to_string(GlobalObject&, bool legacy_null_to_empty_string = false) const;
@@ -262,8 +295,8 @@ public:
     double to_double(GlobalObject&) const;
     i32 to_i32(GlobalObject& global_object) const
     {
-        if (m_type == Type::Int32)
-            return m_value.as_i32;
+        if (is_int32())
+            return int32_payload();
         return to_i32_slow_case(global_object);
     }
     u32 to_u32(GlobalObject&) const;
@@ -284,22 +317,53 @@ public:
     String typeof() const;
 
 private:
-    Type m_type { Type::Empty };
+    // A value is encoded in 64 bits by "NaN-boxing" it. Doubles are stored as they are, except that every NaN turns into
+    // the same one. That frees up the bit patterns of all the other NaNs: in those, the upper 16 bits (the tag) say what
+    // type of value it is, and the lower 48 bits hold its int32, boolean or cell pointer. A double can only have the
+    // exponent all set along with one of the three lowest tag bits if it's a NaN, so no double looks like a tag.
+    static constexpr u64 TAG_SHIFT = 48;
+    static constexpr u64 PAYLOAD_MASK = 0x0000FFFFFFFFFFFFULL;
+    static constexpr u16 CANONICAL_NAN_TAG = 0x7FF8;
+    static constexpr u64 CANONICAL_NAN_BITS = (u64)CANONICAL_NAN_TAG << TAG_SHIFT;
+
+    static constexpr u16 UNDEFINED_TAG = 0x7FF9;
+    static constexpr u16 NULL_TAG = 0x7FFA;
+    static constexpr u16 BOOLEAN_TAG = 0x7FFB;
+    static constexpr u16 INT32_TAG = 0x7FFC;
+    static constexpr u16 EMPTY_TAG = 0x7FFD;
+
+    // Cells all share the prefix of the negative quiet NaN, so that telling whether a value is one takes one compare.
+    static constexpr u16 CELL_TAG_PREFIX = 0xFFF8;
+    static constexpr u16 OBJECT_TAG = 0xFFF9;
+    static constexpr u16 STRING_TAG = 0xFFFA;
+    static constexpr u16 SYMBOL_TAG = 0xFFFB;
+    static constexpr u16 ACCESSOR_TAG = 0xFFFC;
+    static constexpr u16 BIGINT_TAG = 0xFFFD;
+    static constexpr u16 NATIVE_PROPERTY_TAG = 0xFFFE;
+
+    static constexpr u64 encode(u16 tag, u64 payload) { return ((u64)tag << TAG_SHIFT) | payload; }
+    static constexpr u64 encode_i32(i32 value) { return encode(INT32_TAG, (u32)value); }
+    static u64 encode_double(double value)
+    {
+        if (__builtin_isnan(value))
+            return CANONICAL_NAN_BITS;
+        return bit_cast<u64>(value);
+    }
+    static u64 encode_cell(u16 tag, const void* cell)
+    {
+        auto address = reinterpret_cast<FlatPtr>(cell);
+        VERIFY(!((u64)address & ~PAYLOAD_MASK));
+        return encode(tag, address);
+    }
+
+    u16 tag() const { return m_value >> TAG_SHIFT; }
+    i32 int32_payload() const { return (i32)(u32)m_value; }
+    template<typename T>
+    T* cell_payload() const { return reinterpret_cast<T*>((FlatPtr)(m_value & PAYLOAD_MASK)); }
 
     i32 to_i32_slow_case(GlobalObject&) const;
 
-    union {
-        bool as_bool;
-        i32 as_i32;
-        double as_double;
-        PrimitiveString* as_string;
-        Symbol* as_symbol;
-        Object* as_object;
-        Cell* as_cell;
-        Accessor* as_accessor;
-        BigInt* as_bigint;
-        NativeProperty* as_native_property;
-    } m_value;
+    u64 m_value { encode(EMPTY_TAG, 0) };
 };
 
 inline Value js_undefined()
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace JS {
+
+// Remembers where an identifier in the source was found the last time it was looked up: how many environments up the
+// scope chain, and at which index in that environment's variables. Since scoping is lexical, that stays the same for
+// as long as the lookup starts from an environment with the same layout, and nothing added a binding to the scope
+// chain after the fact (see VM::invalidate_variable_caches()). Lookups that have to go through a with statement's
+// object, or end up in the global object, are never cached.
+struct VariableCache {
+    u64 scope_layout_id { 0 };
+    u64 environment_layout_id { 0 };
+    u64 epoch { 0 };
+    u32 hops { 0 };
+    u32 index { 0 };
+};
+
+}
@@ -0,0 +1,52 @@
+describe("holes in arrays that were packed", () => {
+    test("elements of the prototype show through holes", () => {
+        var a = [1, 2, 3];
+        delete a[1];
+        Array.prototype[1] = "foo";
+        try {
+            expect(a.join()).toBe("1,foo,3");
+            expect(a.indexOf("foo")).toBe(1);
+            expect(a.includes("foo")).toBeTrue();
+        } finally {
+            delete Array.prototype[1];
+        }
+    });
+
+    test("holes made by the callback are skipped", () => {
+        var a = [1, 2, 3, 4];
+        var values = [];
+        a.forEach((value, index) => {
+            if (index === 0) delete a[2];
+            values.push(value);
+        });
+        expect(values).toEqual([1, 2, 4]);
+    });
+
+    test("filling every hole makes the array packed again", () => {
+        var a = [];
+        a.length = 3;
+        a[2] = 3;
+        a[0] = 1;
+        expect(a.indexOf(undefined)).toBe(-1);
+        a[1] = 2;
+        expect(a.slice(1)).toEqual([2, 3]);
+        a.reverse();
+        expect(a).toEqual([3, 2, 1]);
+    });
+
+    test("sort with a compare function that shrinks the array", () => {
+        var a = [3, 1, 2];
+        a.sort((x, y) => {
+            a.length = 0;
+            return x - y;
+        });
+        expect(a).toEqual([1, 2, 3]);
+    });
+
+    test("splice of a non-extensible array can't add elements", () => {
+        var a = [1, 2, 3];
+        Object.preventExtensions(a);
+        expect(a.splice(0, 1)).toEqual([1]);
+        expect(a).toEqual([2, 3]);
+    });
+});
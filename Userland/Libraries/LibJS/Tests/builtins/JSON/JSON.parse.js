@@ -35,3 +35,53 @@ test("syntax errors", () => {
         }).toThrow(SyntaxError);
     });
 });
+
+test("numbers", () => {
+    expect(JSON.parse("-0")).toBe(-0);
+    expect(JSON.parse("123456789")).toBe(123456789);
+    expect(JSON.parse("-1234567890")).toBe(-1234567890);
+    expect(JSON.parse("4294967296")).toBe(4294967296);
+    expect(JSON.parse("1.5e3")).toBe(1500);
+    expect(JSON.parse("1E-2")).toBe(0.01);
+    expect(JSON.parse("1e400")).toBe(Infinity);
+
+    ["01", "1.", ".5", "+1", "1e", "-", "0x10"].forEach(test => {
+        expect(() => {
+            JSON.parse(test);
+        }).toThrow(SyntaxError);
+    });
+});
+
+test("strings", () => {
+    expect(JSON.parse('"\\"\\\\\\/\\b\\f\\n\\r\\t"')).toBe('"\\/\b\f\n\r\t');
+    expect(JSON.parse('"\\u0041\\u00e9"')).toBe("Aé");
+    expect(JSON.parse('"\\ud83d\\ude00"')).toBe("😀");
+
+    ['"\t"', '"\\x41"', '"\\u00"', '"unterminated'].forEach(test => {
+        expect(() => {
+            JSON.parse(test);
+        }).toThrow(SyntaxError);
+    });
+});
+
+test("objects with the same keys", () => {
+    const objects = JSON.parse('[{"a":1,"b":[2]},{"a":3,"b":[4]},{"b":5,"a":6}]');
+    expect(objects).toEqual([
+        { a: 1, b: [2] },
+        { a: 3, b: [4] },
+        { b: 5, a: 6 },
+    ]);
+    expect(Object.keys(objects[1])).toEqual(["a", "b"]);
+    expect(Object.keys(objects[2])).toEqual(["b", "a"]);
+
+    objects[1].c = 7;
+    expect(objects[0].c).toBeUndefined();
+    expect(objects[1]).toEqual({ a: 3, b: [4], c: 7 });
+});
+
+test("duplicate and numeric keys", () => {
+    const object = JSON.parse('{"a":1,"1":2,"b":3,"a":4}');
+    expect(Object.keys(object)).toEqual(["1", "a", "b"]);
+    expect(object.a).toBe(4);
+    expect(object[1]).toBe(2);
+});
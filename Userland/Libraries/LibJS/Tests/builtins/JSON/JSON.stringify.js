@@ -44,6 +44,21 @@ describe("correct behavior", () => {
         expect(JSON.stringify(o)).toBe('{"foo":"bar"}');
     });
 
+    test("escapes strings", () => {
+        expect(JSON.stringify('"quotes" and \\backslashes\\')).toBe(
+            '"\\"quotes\\" and \\\\backslashes\\\\"'
+        );
+        expect(JSON.stringify("\b\f\n\r\t\u0001")).toBe('"\\b\\f\\n\\r\\t\\u0001"');
+        expect(JSON.stringify("héllo")).toBe('"héllo"');
+    });
+
+    test("leaves out undefined properties", () => {
+        expect(JSON.stringify({ a: undefined, b: 1, c() {} })).toBe('{"b":1}');
+        expect(JSON.stringify({ a: 1, b: undefined })).toBe('{"a":1}');
+        expect(JSON.stringify({ a: undefined })).toBe("{}");
+        expect(JSON.stringify([undefined, () => {}])).toBe("[null,null]");
+    });
+
     test("ignores symbol properties", () => {
         let o = { foo: "bar" };
         let sym = Symbol("baz");
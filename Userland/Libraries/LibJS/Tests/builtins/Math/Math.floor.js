@@ -11,3 +11,11 @@ test("basic functionality", () => {
     expect(Math.floor()).toBeNaN();
     expect(Math.floor(NaN)).toBeNaN();
 });
+
+test("arguments that aren't numbers", () => {
+    expect(Math.floor("4.5")).toBe(4);
+    expect(Math.floor({ valueOf: () => -2.5 })).toBe(-3);
+    expect(Math.floor(2147483647)).toBe(2147483647);
+    expect(Math.floor(-0)).toBe(-0);
+    expect(Math.floor(1.5, "ignored")).toBe(1);
+});
@@ -8,3 +8,18 @@ test("basic functionality", () => {
     expect(Math.max(NaN)).toBeNaN();
     expect(Math.max("String", 1)).toBeNaN();
 });
+
+test("arguments that aren't numbers are converted in order", () => {
+    const calls = [];
+    const valueOf = value => ({
+        valueOf() {
+            calls.push(value);
+            return value;
+        },
+    });
+    expect(Math.max(1, valueOf(3), 2, valueOf(5))).toBe(5);
+    expect(calls).toEqual([3, 5]);
+    expect(() => Math.max(1, { valueOf: () => { throw new Error("oops"); } })).toThrowWithMessage(Error, "oops");
+    expect(Math.max(-0, 0)).toBe(-0);
+    expect(Math.max(1.5, 2.5, -3)).toBe(2.5);
+});
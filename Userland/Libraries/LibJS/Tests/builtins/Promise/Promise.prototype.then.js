@@ -140,4 +140,43 @@ describe("normal behavior", () => {
         runQueuedPromiseJobs();
         expect(fulfillmentValue).toBe("Some value");
     });
+
+    test("returned Promise is rejected with error if thenable's then() throws error", () => {
+        let rejectionReason = null;
+        const error = new Error();
+        const thenable = {
+            then: () => {
+                throw error;
+            },
+        };
+        Promise.resolve()
+            .then(() => thenable)
+            .catch(reason => {
+                rejectionReason = reason;
+            });
+        runQueuedPromiseJobs();
+        expect(rejectionReason).toBe(error);
+    });
+
+    test("handlers run in the order their reactions were enqueued", () => {
+        const order = [];
+        const first = Promise.resolve();
+        const second = Promise.resolve();
+        first.then(() => order.push("first 1")).then(() => order.push("first 2"));
+        second.then(() => order.push("second 1")).then(() => order.push("second 2"));
+        first.then(() => order.push("first 3"));
+        runQueuedPromiseJobs();
+        expect(order).toEqual(["first 1", "second 1", "first 3", "first 2", "second 2"]);
+    });
+
+    test("long chains of handlers", () => {
+        let promise = Promise.resolve(0);
+        for (let i = 0; i < 10000; ++i) promise = promise.then(value => value + 1);
+        let result = null;
+        promise.then(value => {
+            result = value;
+        });
+        runQueuedPromiseJobs();
+        expect(result).toBe(10000);
+    });
 });
@@ -19,3 +19,17 @@ test("basic functionality", () => {
     expect(s.charCodeAt("foo")).toBe(70);
     expect(s.charCodeAt(undefined)).toBe(70);
 });
+
+test("indices that aren't integers", () => {
+    var s = "Foobar";
+    expect(s.charCodeAt(1.9)).toBe(111);
+    expect(s.charCodeAt("2")).toBe(111);
+    expect(s.charCodeAt({ valueOf: () => 3 })).toBe(98);
+    expect(s.charCodeAt(4294967296)).toBe(70);
+});
+
+test("this value that isn't a string", () => {
+    expect(String.prototype.charCodeAt.call(123, 1)).toBe(50);
+    expect(String.prototype.charCodeAt.call(new String("abc"), 2)).toBe(99);
+    expect(() => String.prototype.charCodeAt.call(undefined, 0)).toThrow(TypeError);
+});
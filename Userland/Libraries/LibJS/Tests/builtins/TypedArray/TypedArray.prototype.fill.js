@@ -0,0 +1,47 @@
+// Update when more typed arrays get added
+const TYPED_ARRAYS = [
+    Uint8Array,
+    Uint16Array,
+    Uint32Array,
+    Int8Array,
+    Int16Array,
+    Int32Array,
+    Float32Array,
+    Float64Array,
+];
+
+test("basic functionality", () => {
+    TYPED_ARRAYS.forEach(T => {
+        expect(T.prototype.fill).toHaveLength(1);
+
+        const typedArray = new T(40);
+        expect(typedArray.fill(3)).toBe(typedArray);
+        for (let i = 0; i < 40; ++i) expect(typedArray[i]).toBe(3);
+
+        typedArray.fill(5, 17, 35);
+        for (let i = 0; i < 40; ++i) expect(typedArray[i]).toBe(i >= 17 && i < 35 ? 5 : 3);
+
+        typedArray.fill(7, -3);
+        expect(typedArray[36]).toBe(3);
+        expect(typedArray[37]).toBe(7);
+        expect(typedArray[39]).toBe(7);
+
+        typedArray.fill(9, 10, 5);
+        expect(typedArray[7]).toBe(3);
+    });
+});
+
+test("values are converted to the element type", () => {
+    expect(new Uint8Array(3).fill(257)[2]).toBe(1);
+    expect(new Int8Array(3).fill(-129)[2]).toBe(127);
+    expect(new Int16Array(3).fill("12")[2]).toBe(12);
+    expect(new Float32Array(3).fill(0.5)[2]).toBe(0.5);
+    expect(new Float64Array(3).fill(NaN)[2]).toBeNaN();
+});
+
+test("only fills the view", () => {
+    const buffer = new ArrayBuffer(32);
+    new Uint8Array(buffer, 8, 16).fill(1);
+    const bytes = new Uint8Array(buffer);
+    for (let i = 0; i < 32; ++i) expect(bytes[i]).toBe(i >= 8 && i < 24 ? 1 : 0);
+});
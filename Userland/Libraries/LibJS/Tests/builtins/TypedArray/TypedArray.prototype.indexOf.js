@@ -0,0 +1,46 @@
+// Update when more typed arrays get added
+const TYPED_ARRAYS = [
+    Uint8Array,
+    Uint16Array,
+    Uint32Array,
+    Int8Array,
+    Int16Array,
+    Int32Array,
+    Float32Array,
+    Float64Array,
+];
+
+test("basic functionality", () => {
+    TYPED_ARRAYS.forEach(T => {
+        expect(T.prototype.indexOf).toHaveLength(1);
+
+        const typedArray = new T(40);
+        typedArray[3] = 1;
+        typedArray[29] = 2;
+        typedArray[33] = 2;
+
+        expect(typedArray.indexOf(1)).toBe(3);
+        expect(typedArray.indexOf(2)).toBe(29);
+        expect(typedArray.indexOf(2, 30)).toBe(33);
+        expect(typedArray.indexOf(2, -7)).toBe(33);
+        expect(typedArray.indexOf(2, 34)).toBe(-1);
+        expect(typedArray.indexOf(0)).toBe(0);
+        expect(typedArray.indexOf(0, 3)).toBe(4);
+        expect(typedArray.indexOf(3)).toBe(-1);
+        expect(typedArray.indexOf(1, Infinity)).toBe(-1);
+        expect(typedArray.indexOf(1, -Infinity)).toBe(3);
+        expect(typedArray.indexOf("1")).toBe(-1);
+        expect(typedArray.indexOf(1.5)).toBe(-1);
+        expect(new T(0).indexOf(0)).toBe(-1);
+    });
+});
+
+test("values that the elements can't hold are never found", () => {
+    expect(new Uint8Array([255]).indexOf(-1)).toBe(-1);
+    expect(new Int8Array([-1]).indexOf(-1)).toBe(0);
+    expect(new Uint32Array([4294967295]).indexOf(4294967295)).toBe(0);
+    expect(new Float32Array([0.1]).indexOf(0.1)).toBe(-1);
+    expect(new Float64Array([0.1]).indexOf(0.1)).toBe(0);
+    expect(new Float64Array([NaN]).indexOf(NaN)).toBe(-1);
+    expect(new Float64Array([-0]).indexOf(0)).toBe(0);
+});
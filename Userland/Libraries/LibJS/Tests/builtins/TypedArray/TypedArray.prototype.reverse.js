@@ -0,0 +1,41 @@
+// Update when more typed arrays get added
+const TYPED_ARRAYS = [
+    Uint8Array,
+    Uint16Array,
+    Uint32Array,
+    Int8Array,
+    Int16Array,
+    Int32Array,
+    Float32Array,
+    Float64Array,
+];
+
+function elementsOf(typedArray) {
+    const elements = [];
+    for (let i = 0; i < typedArray.length; ++i) elements.push(typedArray[i]);
+    return elements;
+}
+
+test("basic functionality", () => {
+    TYPED_ARRAYS.forEach(T => {
+        expect(T.prototype.reverse).toHaveLength(0);
+
+        const typedArray = new T([1, 2, 3, 4, 5]);
+        expect(typedArray.reverse()).toBe(typedArray);
+        expect(elementsOf(typedArray)).toEqual([5, 4, 3, 2, 1]);
+
+        const even = new T([1, 2, 3, 4]);
+        even.reverse();
+        expect(elementsOf(even)).toEqual([4, 3, 2, 1]);
+
+        expect(new T(0).reverse()).toHaveLength(0);
+    });
+});
+
+test("only reverses the view", () => {
+    const buffer = new ArrayBuffer(6);
+    const bytes = new Uint8Array(buffer);
+    bytes.set([1, 2, 3, 4, 5, 6]);
+    new Uint8Array(buffer, 1, 3).reverse();
+    expect(elementsOf(bytes)).toEqual([1, 4, 3, 2, 5, 6]);
+});
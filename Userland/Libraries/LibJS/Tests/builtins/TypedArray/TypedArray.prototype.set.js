@@ -0,0 +1,76 @@
+// Update when more typed arrays get added
+const TYPED_ARRAYS = [
+    Uint8Array,
+    Uint16Array,
+    Uint32Array,
+    Int8Array,
+    Int16Array,
+    Int32Array,
+    Float32Array,
+    Float64Array,
+];
+
+function elementsOf(typedArray) {
+    const elements = [];
+    for (let i = 0; i < typedArray.length; ++i) elements.push(typedArray[i]);
+    return elements;
+}
+
+test("basic functionality", () => {
+    TYPED_ARRAYS.forEach(T => {
+        expect(T.prototype.set).toHaveLength(1);
+
+        const typedArray = new T(5);
+        expect(typedArray.set([1, 2])).toBeUndefined();
+        expect(elementsOf(typedArray)).toEqual([1, 2, 0, 0, 0]);
+
+        typedArray.set(new T([3, 4]), 3);
+        expect(elementsOf(typedArray)).toEqual([1, 2, 0, 3, 4]);
+
+        TYPED_ARRAYS.forEach(U => {
+            typedArray.set(new U([5, 6, 7]), 1);
+            expect(elementsOf(typedArray)).toEqual([1, 5, 6, 7, 4]);
+            typedArray.set([2, 0, 3], 1);
+        });
+    });
+});
+
+test("values are converted to the element type", () => {
+    const bytes = new Uint8Array(3);
+    bytes.set(new Int16Array([-1, 256, 300]));
+    expect(elementsOf(bytes)).toEqual([255, 0, 44]);
+
+    const floats = new Float32Array(2);
+    floats.set(new Float64Array([0.5, 1e40]));
+    expect(floats[0]).toBe(0.5);
+    expect(floats[1]).toBe(Infinity);
+
+    const ints = new Int32Array(2);
+    ints.set(new Float64Array([1.5, -2.5]));
+    expect(elementsOf(ints)).toEqual([1, -2]);
+});
+
+test("overlapping source and target", () => {
+    const bytes = new Uint8Array([1, 2, 3, 4, 5, 6, 7, 8]);
+    bytes.set(bytes.subarray(0, 6), 2);
+    expect(elementsOf(bytes)).toEqual([1, 2, 1, 2, 3, 4, 5, 6]);
+
+    const buffer = new ArrayBuffer(8);
+    const words = new Uint16Array(buffer);
+    words.set([1, 2, 3, 4]);
+    new Uint8Array(buffer).set(words);
+    expect(elementsOf(new Uint8Array(buffer))).toEqual([1, 2, 3, 4, 3, 0, 4, 0]);
+});
+
+test("source doesn't fit", () => {
+    TYPED_ARRAYS.forEach(T => {
+        const typedArray = new T(3);
+        expect(() => typedArray.set([1, 2, 3, 4])).toThrowWithMessage(
+            RangeError,
+            "Typed array of length 3 can't be set from a source of length 4 at offset 0"
+        );
+        expect(() => typedArray.set(new T(2), 2)).toThrow(RangeError);
+        expect(() => typedArray.set([1], -1)).toThrow(RangeError);
+        expect(() => typedArray.set([1], Infinity)).toThrow(RangeError);
+    });
+});
@@ -0,0 +1,48 @@
+// Update when more typed arrays get added
+const TYPED_ARRAYS = [
+    Uint8Array,
+    Uint16Array,
+    Uint32Array,
+    Int8Array,
+    Int16Array,
+    Int32Array,
+    Float32Array,
+    Float64Array,
+];
+
+function elementsOf(typedArray) {
+    const elements = [];
+    for (let i = 0; i < typedArray.length; ++i) elements.push(typedArray[i]);
+    return elements;
+}
+
+test("basic functionality", () => {
+    TYPED_ARRAYS.forEach(T => {
+        expect(T.prototype.subarray).toHaveLength(2);
+
+        const typedArray = new T([1, 2, 3, 4, 5]);
+        const subarray = typedArray.subarray(1, 4);
+        expect(subarray).toBeInstanceOf(T);
+        expect(subarray).toHaveLength(3);
+        expect(elementsOf(subarray)).toEqual([2, 3, 4]);
+
+        expect(elementsOf(typedArray.subarray(-2))).toEqual([4, 5]);
+        expect(elementsOf(typedArray.subarray())).toEqual([1, 2, 3, 4, 5]);
+        expect(typedArray.subarray(4, 2)).toHaveLength(0);
+        expect(typedArray.subarray(-Infinity, Infinity)).toHaveLength(5);
+    });
+});
+
+test("shares the buffer", () => {
+    TYPED_ARRAYS.forEach(T => {
+        const typedArray = new T(4);
+        const subarray = typedArray.subarray(2);
+        subarray[0] = 7;
+        expect(typedArray[2]).toBe(7);
+        typedArray[3] = 8;
+        expect(subarray[1]).toBe(8);
+
+        expect(subarray[2]).toBeUndefined();
+        expect(elementsOf(subarray.subarray(1))).toEqual([8]);
+    });
+});
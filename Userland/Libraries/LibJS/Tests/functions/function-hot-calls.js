@@ -0,0 +1,74 @@
+// Functions that run often enough are compiled to bytecode, so every call here has to behave like the first one.
+function callManyTimes(callback) {
+    const first = callback();
+    for (let i = 0; i < 500; ++i) expect(callback()).toEqual(first);
+    return first;
+}
+
+test("returning from nested scopes", () => {
+    function nestedReturn() {
+        let a = 1;
+        {
+            let b = 2;
+            for (let i = 0; i < 10; ++i) {
+                let c = i;
+                if (a + b + c === 7) return c;
+            }
+        }
+        return -1;
+    }
+    expect(callManyTimes(nestedReturn)).toBe(4);
+
+    function noReturn() {
+        let a = 1;
+        a++;
+    }
+    expect(callManyTimes(noReturn)).toBeUndefined();
+});
+
+test("exceptions thrown from nested scopes", () => {
+    function thrower(value) {
+        {
+            let a = value;
+            throw new Error("boom " + a);
+        }
+    }
+    function catcher() {
+        let x = "outer";
+        try {
+            thrower(x);
+        } catch (e) {
+            return x + ": " + e.message;
+        }
+    }
+    expect(callManyTimes(catcher)).toBe("outer: boom outer");
+});
+
+test("parameters, arguments and this", () => {
+    function withDefaults(a, b = a + 1, ...rest) {
+        return [a, b, rest, arguments.length];
+    }
+    expect(callManyTimes(() => withDefaults(1, undefined, 3, 4))).toEqual([1, 2, [3, 4], 4]);
+
+    function thisValue() {
+        return this.value;
+    }
+    expect(callManyTimes(() => thisValue.call({ value: 42 }))).toBe(42);
+
+    function Constructor(x) {
+        this.x = x;
+    }
+    expect(callManyTimes(() => new Constructor(3).x)).toBe(3);
+});
+
+test("hoisted functions and var declarations", () => {
+    function hoisted() {
+        var sum = 0;
+        for (var i = 0; i < 5; ++i) sum += inner(i);
+        return [sum, i];
+        function inner(x) {
+            return x * 2;
+        }
+    }
+    expect(callManyTimes(hoisted)).toEqual([20, 5]);
+});
@@ -62,3 +62,23 @@ test("no invalid autonaming of anonymous functions", () => {
     f4 ||= function () {};
     expect(f4.name).toBe("");
 });
+
+test("builtin functions have their own name and length", () => {
+    expect(Math.abs.name).toBe("abs");
+    expect(Math.abs).toHaveLength(1);
+    expect(Math.max).toHaveLength(2);
+    expect(Array.prototype.push.name).toBe("push");
+    expect(Object.getOwnPropertyNames(Math.min)).toEqual(["length", "name"]);
+    expect(Object.getPrototypeOf(Math.min)).toBe(Function.prototype);
+
+    Object.defineProperty(Math.sign, "name", { value: "changed" });
+    Math.trunc.extra = 1;
+    delete Math.cbrt.length;
+    expect(Math.sign.name).toBe("changed");
+    expect(Math.trunc.extra).toBe(1);
+    expect(Math.cbrt).toHaveLength(0);
+    expect(Math.cbrt.hasOwnProperty("length")).toBeFalse();
+    expect(Math.exp.name).toBe("exp");
+    expect(Math.exp).toHaveLength(1);
+    expect(Math.exp.extra).toBeUndefined();
+});
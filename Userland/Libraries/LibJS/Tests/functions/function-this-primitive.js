@@ -0,0 +1,41 @@
+test("functions that aren't strict get primitives as objects", () => {
+    String.prototype.sloppyThis = function () {
+        return this;
+    };
+    Number.prototype.sloppyThis = String.prototype.sloppyThis;
+    try {
+        expect(typeof "foo".sloppyThis()).toBe("object");
+        expect("foo".sloppyThis() instanceof String).toBeTrue();
+        expect((42).sloppyThis() instanceof Number).toBeTrue();
+        expect(String.prototype.sloppyThis.call("bar").valueOf()).toBe("bar");
+    } finally {
+        delete String.prototype.sloppyThis;
+        delete Number.prototype.sloppyThis;
+    }
+});
+
+test("strict functions get primitives as they are", () => {
+    String.prototype.strictThis = function () {
+        "use strict";
+        return this;
+    };
+    try {
+        expect("foo".strictThis()).toBe("foo");
+        expect(String.prototype.strictThis.call(42)).toBe(42);
+    } finally {
+        delete String.prototype.strictThis;
+    }
+});
+
+test("arrow functions keep the this value they were created with", () => {
+    String.prototype.makeArrow = function () {
+        return () => this;
+    };
+    try {
+        const arrow = "foo".makeArrow();
+        expect(arrow() instanceof String).toBeTrue();
+        expect(arrow.call(42) instanceof String).toBeTrue();
+    } finally {
+        delete String.prototype.makeArrow;
+    }
+});
@@ -51,3 +51,43 @@ test("new-expressions with function calls", () => {
     foo = new (funcGetter())(1, 5);
     expect(foo.x).toBe(6);
 });
+
+test("instances of the same constructor", () => {
+    function Point(x, y) {
+        this.x = x;
+        if (y !== undefined) this.y = y;
+    }
+
+    const points = [];
+    for (let i = 0; i < 5; ++i) points.push(new Point(i, i % 2 ? undefined : i));
+    points.forEach((point, i) => {
+        expect(Object.getPrototypeOf(point)).toBe(Point.prototype);
+        expect(point.x).toBe(i);
+        expect(Object.keys(point)).toEqual(i % 2 ? ["x"] : ["x", "y"]);
+    });
+
+    const oldPrototype = Point.prototype;
+    Point.prototype = { isNew: true };
+    const point = new Point(1, 2);
+    expect(Object.getPrototypeOf(point)).toBe(Point.prototype);
+    expect(point.isNew).toBeTrue();
+    expect(Object.getPrototypeOf(points[0])).toBe(oldPrototype);
+
+    Point.prototype = 42;
+    expect(Object.getPrototypeOf(new Point(1))).toBe(Object.prototype);
+});
+
+test("prototype getter runs before the constructor", () => {
+    let calls = [];
+    function Foo() {
+        calls.push("constructor");
+    }
+    const BoundFoo = new Proxy(Foo, {
+        get(target, property) {
+            calls.push(property);
+            return target[property];
+        },
+    });
+    new BoundFoo();
+    expect(calls).toEqual(["prototype", "constructor"]);
+});
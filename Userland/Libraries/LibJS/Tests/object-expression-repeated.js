@@ -0,0 +1,83 @@
+// After the first time around, a literal starts out with the shape its first object ended up with.
+function makeMany(callback) {
+    const objects = [];
+    for (let i = 0; i < 5; ++i) objects.push(callback(i));
+    return objects;
+}
+
+test("values, order and attributes", () => {
+    makeMany(i => ({ a: i, b: i * 2, "c d": "e" })).forEach((object, i) => {
+        expect(object.a).toBe(i);
+        expect(object.b).toBe(i * 2);
+        expect(object["c d"]).toBe("e");
+        expect(Object.keys(object)).toEqual(["a", "b", "c d"]);
+        expect(Object.getOwnPropertyDescriptor(object, "b")).toEqual({
+            value: i * 2,
+            writable: true,
+            enumerable: true,
+            configurable: true,
+        });
+    });
+});
+
+test("objects don't share their values", () => {
+    const objects = makeMany(i => ({ value: i }));
+    const first = objects[0];
+    const second = objects[1];
+    first.value = "changed";
+    first.extra = true;
+    delete first.value;
+    expect(second.value).toBe(1);
+    expect(second.extra).toBeUndefined();
+    expect(Object.keys(first)).toEqual(["extra"]);
+});
+
+test("duplicate and numeric keys", () => {
+    makeMany(i => ({ a: 1, b: 2, a: i })).forEach((object, i) => {
+        expect(object.a).toBe(i);
+        expect(Object.keys(object)).toEqual(["a", "b"]);
+    });
+    makeMany(i => ({ x: i, 0: "zero", 1: "one" })).forEach((object, i) => {
+        expect(object.x).toBe(i);
+        expect(object[0]).toBe("zero");
+        expect(Object.keys(object)).toEqual(["0", "1", "x"]);
+    });
+});
+
+test("functions and methods", () => {
+    makeMany(i => ({
+        value: i,
+        anonymous: function () {},
+        arrow: () => {},
+        method() {
+            return this.value;
+        },
+    })).forEach((object, i) => {
+        expect(object.anonymous.name).toBe("anonymous");
+        expect(object.arrow.name).toBe("arrow");
+        expect(object.method()).toBe(i);
+    });
+});
+
+test("exception while evaluating a value", () => {
+    let shouldThrow = false;
+    const make = () => ({
+        a: 1,
+        b: (() => {
+            if (shouldThrow) throw new Error("oops");
+            return 2;
+        })(),
+    });
+    makeMany(make);
+    shouldThrow = true;
+    expect(make).toThrowWithMessage(Error, "oops");
+    shouldThrow = false;
+    expect(make()).toEqual({ a: 1, b: 2 });
+});
+
+test("empty literal", () => {
+    makeMany(() => ({})).forEach(object => {
+        expect(Object.keys(object)).toEqual([]);
+        expect(Object.getPrototypeOf(object)).toBe(Object.prototype);
+    });
+});
@@ -62,3 +62,10 @@ test("or with non-numeric values", () => {
     expect(Infinity | Infinity).toBe(0);
     expect(-Infinity | Infinity).toBe(0);
 });
+
+test("numbers outside of the 32-bit range wrap around", () => {
+    expect(-3000000000 | 0).toBe(1294967296);
+    expect(3000000000 | 0).toBe(-1294967296);
+    expect(-4294967297 | 0).toBe(-1);
+    expect(2 ** 53 | 0).toBe(0);
+});
@@ -64,3 +64,8 @@ test("shifting with non-numeric values", () => {
     expect(Infinity >>> Infinity).toBe(0);
     expect(-Infinity >>> Infinity).toBe(0);
 });
+
+test("negative numbers outside of the 32-bit range wrap around", () => {
+    expect(-3000000000 >>> 0).toBe(1294967296);
+    expect(-4294967297 >>> 0).toBe(4294967295);
+});
@@ -211,6 +211,7 @@ void Editor::add_to_history(const String& line)
         return;
     if ((m_history.size() + 1) > m_history_capacity)
         m_history.take_first();
+    m_last_history_matches.clear();
     struct timeval tv;
     gettimeofday(&tv, nullptr);
     m_history.append({ line, tv.tv_sec });
@@ -229,6 +230,7 @@ bool Editor::load_history(const String& path)
         auto string = str.substring_view(it == 0 ? it : it + 2);
         m_history.append({ string, time });
     }
+    m_last_history_matches.clear();
     return true;
 }
 
@@ -1086,6 +1088,36 @@ void Editor::cleanup_suggestions()
     m_times_tab_pressed = 0; // Safe to say if we get here, the user didn't press TAB
 }
 
+const Vector<size_t>& Editor::find_history_matches(const StringView& phrase, bool from_beginning)
+{
+    auto matches = [&](const String& entry) {
+        return from_beginning ? entry.starts_with(phrase) : entry.contains(phrase);
+    };
+
+    auto& last = m_last_history_matches;
+    bool can_narrow_down = last.has_value()
+        && last->from_beginning == from_beginning
+        && last->history_cursor == m_history_cursor
+        && phrase.starts_with(last->phrase);
+    if (can_narrow_down && phrase == last->phrase)
+        return last->entries;
+
+    Vector<size_t> entries;
+    if (can_narrow_down) {
+        for (auto index : last->entries) {
+            if (matches(m_history[index].entry))
+                entries.append(index);
+        }
+    } else {
+        for (size_t i = m_history_cursor; i > 0; --i) {
+            if (matches(m_history[i - 1].entry))
+                entries.append(i - 1);
+        }
+    }
+    m_last_history_matches = HistoryMatches { phrase, from_beginning, m_history_cursor, move(entries) };
+    return m_last_history_matches->entries;
+}
+
 bool Editor::search(const StringView& phrase, bool allow_empty, bool from_beginning)
 {
 
@@ -1094,18 +1126,10 @@ bool Editor::search(const StringView& phrase, bool allow_empty, bool from_beginn
 
     // Do not search for empty strings.
     if (allow_empty || phrase.length() > 0) {
-        size_t search_offset = m_search_offset;
-        for (size_t i = m_history_cursor; i > 0; --i) {
-            auto& entry = m_history[i - 1];
-            auto contains = from_beginning ? entry.entry.starts_with(phrase) : entry.entry.contains(phrase);
-            if (contains) {
-                last_matching_offset = i - 1;
-                if (search_offset == 0) {
-                    found = true;
-                    break;
-                }
-                --search_offset;
-            }
+        auto& matching_entries = find_history_matches(phrase, from_beginning);
+        if (m_search_offset < matching_entries.size()) {
+            last_matching_offset = matching_entries[m_search_offset];
+            found = true;
         }
 
         if (!found) {
@@ -268,6 +268,7 @@ private:
     Style find_applicable_style(size_t offset) const;
 
     bool search(const StringView&, bool allow_empty = false, bool from_beginning = true);
+    const Vector<size_t>& find_history_matches(const StringView&, bool from_beginning);
     inline void end_search()
     {
         m_is_searching = false;
@@ -281,6 +282,7 @@ private:
         }
         m_reset_buffer_on_search_end = true;
         m_search_editor = nullptr;
+        m_last_history_matches.clear();
     }
 
     void reset()
@@ -443,6 +445,16 @@ private:
     size_t m_history_cursor { 0 };
     size_t m_history_capacity { 1024 };
 
+    // The history entries (newest first) that matched the last search phrase. Every entry that matches a longer
+    // phrase also matches this one, so typing more of the phrase only has to look through these again.
+    struct HistoryMatches {
+        String phrase;
+        bool from_beginning { false };
+        size_t history_cursor { 0 };
+        Vector<size_t> entries;
+    };
+    Optional<HistoryMatches> m_last_history_matches;
+
     enum class InputState {
         Free,
         Verbatim,
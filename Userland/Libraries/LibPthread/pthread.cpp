@@ -8,6 +8,7 @@
 #include <AK/Atomic.h>
 #include <AK/Debug.h>
 #include <AK/Format.h>
+#include <AK/HashMap.h>
 #include <AK/StdLibExtras.h>
 #include <Kernel/API/Syscall.h>
 #include <LibSystem/syscall.h>
@@ -18,6 +19,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/internals.h>
 #include <sys/mman.h>
 #include <syscall.h>
 #include <time.h>
@@ -32,9 +34,76 @@ constexpr size_t required_stack_alignment = 4 * MiB;
 constexpr size_t highest_reasonable_guard_size = 32 * PAGE_SIZE;
 constexpr size_t highest_reasonable_stack_size = 8 * MiB; // That's the default in Ubuntu?
 
+// Stacks of joined threads are kept around for the next pthread_create(), so thread pools that come and go don't
+// have to map (and fault in) a fresh stack every time. Stacks of detached threads are never given back.
+constexpr size_t max_cached_thread_stacks = 4;
+
+struct ThreadStack {
+    void* location { nullptr };
+    size_t size { 0 };
+};
+
+static pthread_mutex_t s_thread_stacks_mutex = __PTHREAD_MUTEX_INITIALIZER;
+static ThreadStack s_cached_thread_stacks[max_cached_thread_stacks];
+static size_t s_cached_thread_stack_count;
+// The stacks we allocated for joinable threads, so we can take them back once they've been joined.
+static HashMap<pthread_t, ThreadStack>* s_joinable_thread_stacks;
+
 #define __RETURN_PTHREAD_ERROR(rc) \
     return ((rc) < 0 ? -(rc) : 0)
 
+static void* allocate_thread_stack(size_t size)
+{
+    __pthread_mutex_lock(&s_thread_stacks_mutex);
+    for (size_t i = 0; i < s_cached_thread_stack_count; ++i) {
+        if (s_cached_thread_stacks[i].size != size)
+            continue;
+        void* location = s_cached_thread_stacks[i].location;
+        s_cached_thread_stacks[i] = s_cached_thread_stacks[--s_cached_thread_stack_count];
+        __pthread_mutex_unlock(&s_thread_stacks_mutex);
+        return location;
+    }
+    __pthread_mutex_unlock(&s_thread_stacks_mutex);
+
+    void* location = mmap_with_name(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, 0, 0, "Thread stack");
+    if (location == MAP_FAILED)
+        return nullptr;
+    return location;
+}
+
+static void release_thread_stack(const ThreadStack& stack)
+{
+    __pthread_mutex_lock(&s_thread_stacks_mutex);
+    if (s_cached_thread_stack_count < max_cached_thread_stacks) {
+        s_cached_thread_stacks[s_cached_thread_stack_count++] = stack;
+        __pthread_mutex_unlock(&s_thread_stacks_mutex);
+        return;
+    }
+    __pthread_mutex_unlock(&s_thread_stacks_mutex);
+    munmap(stack.location, stack.size);
+}
+
+static void track_joinable_thread_stack(pthread_t thread, const ThreadStack& stack)
+{
+    __pthread_mutex_lock(&s_thread_stacks_mutex);
+    if (!s_joinable_thread_stacks)
+        s_joinable_thread_stacks = new HashMap<pthread_t, ThreadStack>;
+    s_joinable_thread_stacks->set(thread, stack);
+    __pthread_mutex_unlock(&s_thread_stacks_mutex);
+}
+
+static Optional<ThreadStack> untrack_joinable_thread_stack(pthread_t thread)
+{
+    __pthread_mutex_lock(&s_thread_stacks_mutex);
+    Optional<ThreadStack> stack;
+    if (s_joinable_thread_stacks) {
+        stack = s_joinable_thread_stacks->get(thread);
+        s_joinable_thread_stacks->remove(thread);
+    }
+    __pthread_mutex_unlock(&s_thread_stacks_mutex);
+    return stack;
+}
+
 extern "C" {
 
 static void* pthread_create_helper(void* (*routine)(void*), void* argument)
@@ -76,6 +145,7 @@ static int create_thread(pthread_t* thread, void* (*entry)(void*), void* argumen
 [[noreturn]] static void exit_thread(void* code)
 {
     __pthread_key_destroy_for_current_thread();
+    __malloc_flush_thread_cache();
     syscall(SC_exit_thread, code);
     VERIFY_NOT_REACHED();
 }
@@ -90,30 +160,38 @@ int pthread_create(pthread_t* thread, pthread_attr_t* attributes, void* (*start_
     if (!thread)
         return -EINVAL;
 
-    PthreadAttrImpl default_attributes {};
+    // The attributes are copied, since the stack location and size are adjusted for this thread only.
     PthreadAttrImpl** arg_attributes = reinterpret_cast<PthreadAttrImpl**>(attributes);
+    PthreadAttrImpl used_attributes = arg_attributes ? **arg_attributes : PthreadAttrImpl {};
 
-    PthreadAttrImpl* used_attributes = arg_attributes ? *arg_attributes : &default_attributes;
-
-    if (!used_attributes->m_stack_location) {
+    Optional<ThreadStack> allocated_stack;
+    if (!used_attributes.m_stack_location) {
         // adjust stack size, user might have called setstacksize, which has no restrictions on size/alignment
-        if (0 != (used_attributes->m_stack_size % required_stack_alignment))
-            used_attributes->m_stack_size += required_stack_alignment - (used_attributes->m_stack_size % required_stack_alignment);
+        if (0 != (used_attributes.m_stack_size % required_stack_alignment))
+            used_attributes.m_stack_size += required_stack_alignment - (used_attributes.m_stack_size % required_stack_alignment);
 
-        used_attributes->m_stack_location = mmap_with_name(nullptr, used_attributes->m_stack_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, 0, 0, "Thread stack");
-        if (!used_attributes->m_stack_location)
+        used_attributes.m_stack_location = allocate_thread_stack(used_attributes.m_stack_size);
+        if (!used_attributes.m_stack_location)
             return -1;
+        allocated_stack = ThreadStack { used_attributes.m_stack_location, (size_t)used_attributes.m_stack_size };
     }
 
     dbgln_if(PTHREAD_DEBUG, "pthread_create: Creating thread with attributes at {}, detach state {}, priority {}, guard page size {}, stack size {}, stack location {}",
-        used_attributes,
-        (PTHREAD_CREATE_JOINABLE == used_attributes->m_detach_state) ? "joinable" : "detached",
-        used_attributes->m_schedule_priority,
-        used_attributes->m_guard_page_size,
-        used_attributes->m_stack_size,
-        used_attributes->m_stack_location);
-
-    return create_thread(thread, start_routine, argument_to_start_routine, used_attributes);
+        &used_attributes,
+        (PTHREAD_CREATE_JOINABLE == used_attributes.m_detach_state) ? "joinable" : "detached",
+        used_attributes.m_schedule_priority,
+        used_attributes.m_guard_page_size,
+        used_attributes.m_stack_size,
+        used_attributes.m_stack_location);
+
+    int rc = create_thread(thread, start_routine, argument_to_start_routine, &used_attributes);
+    if (allocated_stack.has_value()) {
+        if (rc != 0)
+            release_thread_stack(*allocated_stack);
+        else if (used_attributes.m_detach_state == PTHREAD_CREATE_JOINABLE)
+            track_joinable_thread_stack(*thread, *allocated_stack);
+    }
+    return rc;
 }
 
 void pthread_exit(void* value_ptr)
@@ -133,13 +211,23 @@ void pthread_cleanup_pop([[maybe_unused]] int execute)
 
 int pthread_join(pthread_t thread, void** exit_value_ptr)
 {
+    // The stack is looked up before joining, since the thread ID may be handed out again as soon as the join is done.
+    auto stack = untrack_joinable_thread_stack(thread);
     int rc = syscall(SC_join_thread, thread, exit_value_ptr);
+    if (stack.has_value()) {
+        if (rc < 0)
+            track_joinable_thread_stack(thread, *stack);
+        else
+            release_thread_stack(*stack);
+    }
     __RETURN_PTHREAD_ERROR(rc);
 }
 
 int pthread_detach(pthread_t thread)
 {
     int rc = syscall(SC_detach_thread, thread);
+    if (rc >= 0)
+        untrack_joinable_thread_stack(thread);
     __RETURN_PTHREAD_ERROR(rc);
 }
 
@@ -168,6 +256,24 @@ int pthread_mutex_lock(pthread_mutex_t* mutex)
 int pthread_mutex_trylock(pthread_mutex_t* mutex)
 {
     auto& atomic = reinterpret_cast<Atomic<u32>&>(mutex->lock);
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT) {
+        u32 expected = 0;
+        if (!atomic.compare_exchange_strong(expected, pthread_self(), AK::memory_order_acquire)) {
+            if ((expected & FUTEX_TID_MASK) == (u32)pthread_self()) {
+                if (mutex->type != PTHREAD_MUTEX_RECURSIVE)
+                    return EBUSY;
+                mutex->level++;
+                return 0;
+            }
+            // The kernel knows whether the owner is still around.
+            if (futex(&mutex->lock, FUTEX_TRYLOCK_PI, 0, nullptr, nullptr, 0) < 0)
+                return EBUSY;
+        }
+        mutex->owner = pthread_self();
+        mutex->level = 0;
+        return 0;
+    }
+
     u32 expected = false;
     if (!atomic.compare_exchange_strong(expected, true, AK::memory_order_acq_rel)) {
         if (mutex->type == PTHREAD_MUTEX_RECURSIVE && mutex->owner == pthread_self()) {
@@ -189,6 +295,7 @@ int pthread_mutex_unlock(pthread_mutex_t* mutex)
 int pthread_mutexattr_init(pthread_mutexattr_t* attr)
 {
     attr->type = PTHREAD_MUTEX_NORMAL;
+    attr->protocol = PTHREAD_PRIO_NONE;
     return 0;
 }
 
@@ -207,6 +314,24 @@ int pthread_mutexattr_settype(pthread_mutexattr_t* attr, int type)
     return 0;
 }
 
+int pthread_mutexattr_getprotocol(const pthread_mutexattr_t* attr, int* protocol)
+{
+    if (!attr || !protocol)
+        return EINVAL;
+    *protocol = attr->protocol;
+    return 0;
+}
+
+int pthread_mutexattr_setprotocol(pthread_mutexattr_t* attr, int protocol)
+{
+    if (!attr)
+        return EINVAL;
+    if (protocol != PTHREAD_PRIO_NONE && protocol != PTHREAD_PRIO_INHERIT)
+        return ENOTSUP;
+    attr->protocol = protocol;
+    return 0;
+}
+
 int pthread_attr_init(pthread_attr_t* attributes)
 {
     auto* impl = new PthreadAttrImpl {};
@@ -436,10 +561,17 @@ int pthread_setschedparam([[maybe_unused]] pthread_t thread, [[maybe_unused]] in
     return 0;
 }
 
+// The value of a condition variable is a generation count, which goes up by COND_INCREMENT
+// with every signal or broadcast. The low bits tell the signalling side whether anybody might be
+// waiting, so that signalling a condition variable nobody waits on doesn't need a syscall.
+static constexpr u32 COND_NEED_TO_WAKE_ONE = 1;
+static constexpr u32 COND_NEED_TO_WAKE_ALL = 2;
+static constexpr u32 COND_INCREMENT = 4;
+
 int pthread_cond_init(pthread_cond_t* cond, const pthread_condattr_t* attr)
 {
+    cond->mutex = nullptr;
     cond->value = 0;
-    cond->previous = 0;
     cond->clockid = attr ? attr->clockid : CLOCK_MONOTONIC_COARSE;
     return 0;
 }
@@ -449,11 +581,14 @@ int pthread_cond_destroy(pthread_cond_t*)
     return 0;
 }
 
-static int futex_wait(uint32_t& futex_addr, uint32_t value, const struct timespec* abstime)
+static int futex_wait(uint32_t& futex_addr, uint32_t value, const struct timespec* abstime, int clockid)
 {
     int saved_errno = errno;
+    int op = FUTEX_WAIT_BITSET;
+    if (clockid == CLOCK_REALTIME || clockid == CLOCK_REALTIME_COARSE)
+        op |= FUTEX_CLOCK_REALTIME;
     // NOTE: FUTEX_WAIT takes a relative timeout, so use FUTEX_WAIT_BITSET instead!
-    int rc = futex(&futex_addr, FUTEX_WAIT_BITSET, value, abstime, nullptr, FUTEX_BITSET_MATCH_ANY);
+    int rc = futex(&futex_addr, op, value, abstime, nullptr, FUTEX_BITSET_MATCH_ANY);
     if (rc < 0 && errno == EAGAIN) {
         // If we didn't wait, that's not an error
         errno = saved_errno;
@@ -464,11 +599,16 @@ static int futex_wait(uint32_t& futex_addr, uint32_t value, const struct timespe
 
 static int cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abstime)
 {
-    u32 value = cond->value;
-    cond->previous = value;
+    // Remember the mutex, so that pthread_cond_broadcast() can move the waiters over to it.
+    pthread_mutex_t* old_mutex = AK::atomic_exchange(&cond->mutex, mutex, AK::memory_order_relaxed);
+    VERIFY(!old_mutex || old_mutex == mutex);
+
+    // This has to happen while we still hold the mutex, the value may change as soon as we let go of it.
+    u32 value = AK::atomic_fetch_or(&cond->value, COND_NEED_TO_WAKE_ONE | COND_NEED_TO_WAKE_ALL, AK::memory_order_release) | COND_NEED_TO_WAKE_ONE | COND_NEED_TO_WAKE_ALL;
     pthread_mutex_unlock(mutex);
-    int rc = futex_wait(cond->value, value, abstime);
-    pthread_mutex_lock(mutex);
+    int rc = futex_wait(cond->value, value, abstime, cond->clockid);
+    // We might have been requeued onto the mutex while sleeping, and then nobody else knows about us.
+    __pthread_mutex_lock_pessimistic_np(mutex);
     return rc;
 }
 
@@ -503,18 +643,42 @@ int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const s
 
 int pthread_cond_signal(pthread_cond_t* cond)
 {
-    u32 value = cond->previous + 1;
-    cond->value = value;
+    u32 value = AK::atomic_fetch_add(&cond->value, COND_INCREMENT, AK::memory_order_relaxed);
+    if (!(value & COND_NEED_TO_WAKE_ONE))
+        return 0;
+
+    // Only clear the flag if there was nobody left to wake. We can't do that after finding out,
+    // because someone may have started waiting in the meantime, so we clear it first and put it
+    // back if we did wake someone.
+    value = AK::atomic_fetch_and(&cond->value, ~COND_NEED_TO_WAKE_ONE, AK::memory_order_relaxed);
+    if (!(value & COND_NEED_TO_WAKE_ONE))
+        return 0;
     int rc = futex(&cond->value, FUTEX_WAKE, 1, nullptr, nullptr, 0);
     VERIFY(rc >= 0);
+    if (rc > 0)
+        AK::atomic_fetch_or(&cond->value, COND_NEED_TO_WAKE_ONE, AK::memory_order_relaxed);
     return 0;
 }
 
 int pthread_cond_broadcast(pthread_cond_t* cond)
 {
-    u32 value = cond->previous + 1;
-    cond->value = value;
-    int rc = futex(&cond->value, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    u32 value = AK::atomic_fetch_add(&cond->value, COND_INCREMENT, AK::memory_order_relaxed);
+    if (!(value & COND_NEED_TO_WAKE_ALL))
+        return 0;
+    AK::atomic_fetch_and(&cond->value, ~(COND_NEED_TO_WAKE_ONE | COND_NEED_TO_WAKE_ALL), AK::memory_order_acquire);
+
+    pthread_mutex_t* mutex = AK::atomic_load(&cond->mutex, AK::memory_order_relaxed);
+    VERIFY(mutex);
+
+    int rc;
+    if (mutex->protocol == PTHREAD_PRIO_INHERIT) {
+        // The kernel has to know who is waiting for a priority inheritance mutex, so we can't just move them over.
+        rc = futex(&cond->value, FUTEX_WAKE, INT32_MAX, nullptr, nullptr, 0);
+    } else {
+        // Wake up one waiter, and move the rest over to the mutex, so that they get woken up one
+        // by one as it's unlocked, instead of all of them trying to take it at the same time.
+        rc = futex(&cond->value, FUTEX_REQUEUE, 1, reinterpret_cast<const timespec*>(INT32_MAX), &mutex->lock, 0);
+    }
     VERIFY(rc >= 0);
     return 0;
 }
@@ -20,6 +20,7 @@ class OpCode_Exit;
 class OpCode_Jump;
 class OpCode_ForkJump;
 class OpCode_ForkStay;
+class OpCode_ForkReplaceStay;
 class OpCode_CheckBegin;
 class OpCode_CheckEnd;
 class OpCode_SaveLeftCaptureGroup;
@@ -88,60 +88,66 @@ static const char* character_class_name(CharClass ch_class)
     }
 }
 
-HashMap<u32, OwnPtr<OpCode>> ByteCode::s_opcodes {};
+// The opcodes hold on to the state of the match they are being used for, so every thread needs a set of its own.
+// Like the set a single-threaded process would have, they are never freed.
+static __thread HashMap<u32, OwnPtr<OpCode>>* s_opcodes;
 
 ALWAYS_INLINE OpCode* ByteCode::get_opcode_by_id(OpCodeId id) const
 {
-    if (!s_opcodes.size()) {
+    if (!s_opcodes) {
+        s_opcodes = new HashMap<u32, OwnPtr<OpCode>>;
         for (u32 i = (u32)OpCodeId::First; i <= (u32)OpCodeId::Last; ++i) {
             switch ((OpCodeId)i) {
             case OpCodeId::Exit:
-                s_opcodes.set(i, make<OpCode_Exit>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_Exit>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::Jump:
-                s_opcodes.set(i, make<OpCode_Jump>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_Jump>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::Compare:
-                s_opcodes.set(i, make<OpCode_Compare>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_Compare>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::CheckEnd:
-                s_opcodes.set(i, make<OpCode_CheckEnd>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_CheckEnd>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::CheckBoundary:
-                s_opcodes.set(i, make<OpCode_CheckBoundary>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_CheckBoundary>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::ForkJump:
-                s_opcodes.set(i, make<OpCode_ForkJump>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_ForkJump>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::ForkStay:
-                s_opcodes.set(i, make<OpCode_ForkStay>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_ForkStay>(*const_cast<ByteCode*>(this)));
+                break;
+            case OpCodeId::ForkReplaceStay:
+                s_opcodes->set(i, make<OpCode_ForkReplaceStay>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::FailForks:
-                s_opcodes.set(i, make<OpCode_FailForks>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_FailForks>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::Save:
-                s_opcodes.set(i, make<OpCode_Save>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_Save>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::Restore:
-                s_opcodes.set(i, make<OpCode_Restore>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_Restore>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::GoBack:
-                s_opcodes.set(i, make<OpCode_GoBack>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_GoBack>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::CheckBegin:
-                s_opcodes.set(i, make<OpCode_CheckBegin>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_CheckBegin>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::SaveLeftCaptureGroup:
-                s_opcodes.set(i, make<OpCode_SaveLeftCaptureGroup>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_SaveLeftCaptureGroup>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::SaveRightCaptureGroup:
-                s_opcodes.set(i, make<OpCode_SaveRightCaptureGroup>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_SaveRightCaptureGroup>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::SaveLeftNamedCaptureGroup:
-                s_opcodes.set(i, make<OpCode_SaveLeftNamedCaptureGroup>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_SaveLeftNamedCaptureGroup>(*const_cast<ByteCode*>(this)));
                 break;
             case OpCodeId::SaveRightNamedCaptureGroup:
-                s_opcodes.set(i, make<OpCode_SaveRightNamedCaptureGroup>(*const_cast<ByteCode*>(this)));
+                s_opcodes->set(i, make<OpCode_SaveRightNamedCaptureGroup>(*const_cast<ByteCode*>(this)));
                 break;
             }
         }
@@ -150,7 +156,7 @@ ALWAYS_INLINE OpCode* ByteCode::get_opcode_by_id(OpCodeId id) const
     if (id > OpCodeId::Last)
         return nullptr;
 
-    return const_cast<OpCode*>(s_opcodes.get((u32)id).value())->set_bytecode(*const_cast<ByteCode*>(this));
+    return const_cast<OpCode*>(s_opcodes->get((u32)id).value())->set_bytecode(*const_cast<ByteCode*>(this));
 }
 
 OpCode* ByteCode::get_opcode(MatchState& state) const
@@ -168,6 +174,118 @@ OpCode* ByteCode::get_opcode(MatchState& state) const
     return op_code;
 }
 
+bool ByteCode::is_transparent(OpCodeId opcode_id)
+{
+    switch (opcode_id) {
+    case OpCodeId::SaveLeftCaptureGroup:
+    case OpCodeId::SaveRightCaptureGroup:
+    case OpCodeId::SaveLeftNamedCaptureGroup:
+    case OpCodeId::SaveRightNamedCaptureGroup:
+    case OpCodeId::CheckBegin:
+    case OpCodeId::CheckEnd:
+    case OpCodeId::CheckBoundary:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Optional<FirstCharacters> ByteCode::first_characters(size_t instruction_position) const
+{
+    // These are the characters of every compare that can be reached without consuming anything. If the end of the
+    // bytecode can be reached that way too, the match may be empty, and then it could start with anything.
+    FirstCharacters first_characters;
+    auto add_character_range = [&](u32 from, u32 to) {
+        for (u32 ch = 0; ch < 128; ++ch) {
+            if (ch >= from && ch <= to)
+                first_characters.case_sensitive[ch] = true;
+            // This is how the compare itself treats ranges when matching case insensitively.
+            if ((u32)tolower(ch) >= (u32)tolower(from) && (u32)tolower(ch) <= (u32)tolower(to))
+                first_characters.case_insensitive[ch] = true;
+        }
+    };
+    auto add_first_characters = [&](size_t instruction_position, size_t arguments_count) {
+        auto offset = instruction_position + 3;
+        for (size_t i = 0; i < arguments_count; ++i) {
+            switch ((CharacterCompareType)at(offset++)) {
+            case CharacterCompareType::Char: {
+                auto ch = at(offset++);
+                if (ch >= 128)
+                    return false;
+                add_character_range(ch, ch);
+                break;
+            }
+            case CharacterCompareType::CharRange: {
+                CharRange range = at(offset++);
+                if (range.to >= 128)
+                    return false;
+                add_character_range(range.from, range.to);
+                break;
+            }
+            case CharacterCompareType::String: {
+                auto length = at(offset);
+                if (length == 0 || at(offset + 1) >= 128)
+                    return false;
+                add_character_range(at(offset + 1), at(offset + 1));
+                offset += length + 1;
+                break;
+            }
+            default:
+                // Inverted compares, character classes and references can all match characters outside of ASCII.
+                return false;
+            }
+        }
+        return true;
+    };
+
+    Vector<bool> visited;
+    visited.resize(size());
+    for (auto& instruction_visited : visited)
+        instruction_visited = false;
+    Vector<size_t> pending_positions;
+    pending_positions.append(instruction_position);
+    MatchState state;
+    while (!pending_positions.is_empty()) {
+        state.instruction_position = pending_positions.take_last();
+        if (state.instruction_position >= size())
+            return {};
+        if (visited[state.instruction_position])
+            continue;
+        visited[state.instruction_position] = true;
+
+        auto& opcode = *get_opcode(state);
+        auto next_instruction_position = state.instruction_position + opcode.size();
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Jump:
+            pending_positions.append(next_instruction_position + static_cast<const OpCode_Jump&>(opcode).offset());
+            break;
+        case OpCodeId::ForkJump:
+            pending_positions.append(next_instruction_position);
+            pending_positions.append(next_instruction_position + static_cast<const OpCode_ForkJump&>(opcode).offset());
+            break;
+        case OpCodeId::ForkStay:
+            pending_positions.append(next_instruction_position);
+            pending_positions.append(next_instruction_position + static_cast<const OpCode_ForkStay&>(opcode).offset());
+            break;
+        case OpCodeId::ForkReplaceStay:
+            pending_positions.append(next_instruction_position);
+            pending_positions.append(next_instruction_position + static_cast<const OpCode_ForkReplaceStay&>(opcode).offset());
+            break;
+        case OpCodeId::Compare:
+            if (!add_first_characters(state.instruction_position, static_cast<const OpCode_Compare&>(opcode).arguments_count()))
+                return {};
+            break;
+        default:
+            if (!is_transparent(opcode.opcode_id()))
+                return {};
+            pending_positions.append(next_instruction_position);
+            break;
+        }
+    }
+
+    return first_characters;
+}
+
 ALWAYS_INLINE ExecutionResult OpCode_Exit::execute(const MatchInput& input, MatchState& state, MatchOutput&) const
 {
     if (state.string_position > input.view.length() || state.instruction_position >= m_bytecode->size())
@@ -227,6 +345,12 @@ ALWAYS_INLINE ExecutionResult OpCode_ForkStay::execute(const MatchInput&, MatchS
     return ExecutionResult::Fork_PrioLow;
 }
 
+ALWAYS_INLINE ExecutionResult OpCode_ForkReplaceStay::execute(const MatchInput&, MatchState& state, MatchOutput&) const
+{
+    state.fork_at_position = state.instruction_position + size() + offset();
+    return ExecutionResult::Fork_PrioLow;
+}
+
 ALWAYS_INLINE ExecutionResult OpCode_CheckBegin::execute(const MatchInput& input, MatchState& state, MatchOutput&) const
 {
     if (0 == state.string_position && (input.regex_options & AllFlags::MatchNotBeginOfLine))
@@ -427,15 +551,14 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(const MatchInput& input, M
             VERIFY(!current_inversion_state());
 
             const auto& length = m_bytecode->at(offset++);
-            StringBuilder str_builder;
-            for (size_t i = 0; i < length; ++i)
-                str_builder.append(m_bytecode->at(offset++));
+            auto str = m_bytecode->data() + offset;
+            offset += length;
 
             // We want to compare a string that is definitely longer than the available string
             if (input.view.length() - state.string_position < length)
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
-            if (!compare_string(input, state, str_builder.string_view().characters_without_null_termination(), length, had_zero_length_match))
+            if (!compare_string(input, state, str, length, had_zero_length_match))
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
         } else if (compare_type == CharacterCompareType::CharClass) {
@@ -451,6 +574,9 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(const MatchInput& input, M
         } else if (compare_type == CharacterCompareType::CharRange) {
             auto value = (CharRange)m_bytecode->at(offset++);
 
+            if (input.view.length() - state.string_position < 1)
+                return ExecutionResult::Failed_ExecuteLowPrioForks;
+
             auto from = value.from;
             auto to = value.to;
             auto ch = input.view[state.string_position];
@@ -469,7 +595,8 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(const MatchInput& input, M
             if (input.view.length() - state.string_position < str.length())
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
-            if (!compare_string(input, state, str.characters_without_null_termination(), str.length(), had_zero_length_match))
+            // FIXME: The captured string isn't UTF-8 when matching a Utf32View, so this can't compare against it (yet).
+            if (!input.view.is_u8_view() || !compare_string(input, state, str.characters_without_null_termination(), str.length(), had_zero_length_match))
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
         } else if (compare_type == CharacterCompareType::NamedReference) {
@@ -487,7 +614,8 @@ ALWAYS_INLINE ExecutionResult OpCode_Compare::execute(const MatchInput& input, M
             if (input.view.length() - state.string_position < str.length())
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
-            if (!compare_string(input, state, str.characters_without_null_termination(), str.length(), had_zero_length_match))
+            // FIXME: The captured string isn't UTF-8 when matching a Utf32View, so this can't compare against it (yet).
+            if (!input.view.is_u8_view() || !compare_string(input, state, str.characters_without_null_termination(), str.length(), had_zero_length_match))
                 return ExecutionResult::Failed_ExecuteLowPrioForks;
 
         } else {
@@ -523,29 +651,44 @@ ALWAYS_INLINE void OpCode_Compare::compare_char(const MatchInput& input, MatchSt
     }
 }
 
-ALWAYS_INLINE bool OpCode_Compare::compare_string(const MatchInput& input, MatchState& state, const char* str, size_t length, bool& had_zero_length_match)
+template<typename CharType>
+ALWAYS_INLINE bool OpCode_Compare::compare_string(const MatchInput& input, MatchState& state, const CharType* str, size_t length, bool& had_zero_length_match)
 {
-    if (input.view.is_u8_view()) {
-        auto str_view1 = StringView(str, length);
-        auto str_view2 = StringView(&input.view.u8view()[state.string_position], length);
-
-        String str1, str2;
-        if (input.regex_options & AllFlags::Insensitive) {
-            str1 = str_view1.to_string().to_lowercase();
-            str2 = str_view2.to_string().to_lowercase();
-            str_view1 = str1.view();
-            str_view2 = str2.view();
+    bool insensitive = input.regex_options & AllFlags::Insensitive;
+    if (input.view.is_u8_view() && !insensitive) {
+        // No need to go through RegexStringView for every single character here.
+        auto characters = input.view.u8view().characters_without_null_termination() + state.string_position;
+        for (size_t i = 0; i < length; ++i) {
+            if (characters[i] != (char)str[i])
+                return false;
         }
+        state.string_position += length;
+        if (length == 0)
+            had_zero_length_match = true;
+        return true;
+    }
+
+    for (size_t i = 0; i < length; ++i) {
+        u32 ch1 = (u8)str[i];
+        u32 ch2 = input.view[state.string_position + i];
+
+        // A code point can only be the same as a single byte of the string if that's ASCII.
+        if (!input.view.is_u8_view() && ch1 >= 128)
+            return false;
 
-        if (str_view1 == str_view2) {
-            state.string_position += length;
-            if (length == 0)
-                had_zero_length_match = true;
-            return true;
+        if (insensitive) {
+            ch1 = tolower(ch1);
+            ch2 = tolower(ch2);
         }
+
+        if (ch1 != ch2)
+            return false;
     }
 
-    return false;
+    state.string_position += length;
+    if (length == 0)
+        had_zero_length_match = true;
+    return true;
 }
 
 ALWAYS_INLINE void OpCode_Compare::compare_character_class(const MatchInput& input, MatchState& state, CharClass character_class, u32 ch, bool inverse, bool& inverse_matched)
@@ -9,10 +9,12 @@
 #include "RegexMatch.h"
 #include "RegexOptions.h"
 
+#include <AK/Array.h>
 #include <AK/Format.h>
 #include <AK/Forward.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <AK/Traits.h>
 #include <AK/Types.h>
@@ -27,6 +29,7 @@ using ByteCodeValueType = u64;
     __ENUMERATE_OPCODE(Jump)                       \
     __ENUMERATE_OPCODE(ForkJump)                   \
     __ENUMERATE_OPCODE(ForkStay)                   \
+    __ENUMERATE_OPCODE(ForkReplaceStay)            \
     __ENUMERATE_OPCODE(FailForks)                  \
     __ENUMERATE_OPCODE(SaveLeftCaptureGroup)       \
     __ENUMERATE_OPCODE(SaveRightCaptureGroup)      \
@@ -120,6 +123,12 @@ struct CharRange {
     operator ByteCodeValueType() const { return ((u64)from << 32) | to; }
 };
 
+// The ASCII characters a match can start with, as the compares see them when matching case sensitively or insensitively.
+struct FirstCharacters {
+    Array<bool, 128> case_sensitive {};
+    Array<bool, 128> case_insensitive {};
+};
+
 struct CompareTypeAndValuePair {
     CharacterCompareType type;
     ByteCodeValueType value;
@@ -441,6 +450,14 @@ public:
 
     OpCode* get_opcode(MatchState& state) const;
 
+    // Whether the instruction neither consumes anything nor goes anywhere but to the next one, which makes it one that
+    // where a match could start and what it starts with doesn't depend on.
+    static bool is_transparent(OpCodeId);
+
+    // Everything that's matched from the given instruction on starts with one of these characters. There are none if
+    // it could start with a character outside of ASCII, or be empty.
+    Optional<FirstCharacters> first_characters(size_t instruction_position) const;
+
 private:
     void insert_string(const StringView& view)
     {
@@ -450,7 +467,6 @@ private:
     }
 
     ALWAYS_INLINE OpCode* get_opcode_by_id(OpCodeId id) const;
-    static HashMap<u32, OwnPtr<OpCode>> s_opcodes;
 };
 
 #define ENUMERATE_EXECUTION_RESULTS                          \
@@ -639,6 +655,24 @@ public:
     }
 };
 
+// A ForkStay that the optimizer put at the head of a loop which never has to be backtracked into. Each time around the
+// loop, the alternative it leaves replaces the one it left the last time, so only the way out of the last iteration is kept.
+class OpCode_ForkReplaceStay final : public OpCode {
+public:
+    OpCode_ForkReplaceStay(ByteCode& bytecode)
+        : OpCode(bytecode)
+    {
+    }
+    ExecutionResult execute(const MatchInput& input, MatchState& state, MatchOutput& output) const override;
+    ALWAYS_INLINE OpCodeId opcode_id() const override { return OpCodeId::ForkReplaceStay; }
+    ALWAYS_INLINE size_t size() const override { return 2; }
+    ALWAYS_INLINE ssize_t offset() const { return argument(0); }
+    const String arguments_string() const override
+    {
+        return String::formatted("offset={} [&{}], sp: {}", offset(), state().instruction_position + size() + offset(), state().string_position);
+    }
+};
+
 class OpCode_CheckBegin final : public OpCode {
 public:
     OpCode_CheckBegin(ByteCode& bytecode)
@@ -753,7 +787,9 @@ public:
 
 private:
     ALWAYS_INLINE static void compare_char(const MatchInput& input, MatchState& state, u32 ch1, bool inverse, bool& inverse_matched);
-    ALWAYS_INLINE static bool compare_string(const MatchInput& input, MatchState& state, const char* str, size_t length, bool& had_zero_length_match);
+    // The string is either UTF-8, or the bytes of a String compare as they're stored in the bytecode.
+    template<typename CharType>
+    ALWAYS_INLINE static bool compare_string(const MatchInput& input, MatchState& state, const CharType* str, size_t length, bool& had_zero_length_match);
     ALWAYS_INLINE static void compare_character_class(const MatchInput& input, MatchState& state, CharClass character_class, u32 ch, bool inverse, bool& inverse_matched);
     ALWAYS_INLINE static void compare_character_range(const MatchInput& input, MatchState& state, u32 from, u32 to, u32 ch, bool inverse, bool& inverse_matched);
 };
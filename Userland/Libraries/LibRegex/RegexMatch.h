@@ -10,6 +10,7 @@
 
 #include "AK/FlyString.h"
 #include "AK/HashMap.h"
+#include "AK/NumericLimits.h"
 #include "AK/String.h"
 #include "AK/StringBuilder.h"
 #include "AK/StringView.h"
@@ -253,6 +254,10 @@ struct MatchInput {
 
     mutable size_t fail_counter { 0 };
     mutable Vector<size_t> saved_positions;
+
+    // Once the backtracker has run this many operations, it gives up so the NFA can take over.
+    size_t backtracking_budget { NumericLimits<size_t>::max() };
+    mutable bool exceeded_backtracking_budget { false };
 };
 
 struct MatchState {
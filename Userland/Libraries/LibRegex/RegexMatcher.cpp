@@ -8,9 +8,12 @@
 #include "RegexDebug.h"
 #include "RegexParser.h"
 #include <AK/Debug.h>
+#include <AK/MemMem.h>
+#include <AK/NumericLimits.h>
 #include <AK/ScopedValueRollback.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <string.h>
 
 namespace regex {
 
@@ -27,8 +30,10 @@ Regex<Parser>::Regex(StringView pattern, typename ParserTraits<Parser>::OptionsT
     Parser parser(lexer, regex_options);
     parser_result = parser.parse();
 
-    if (parser_result.error == regex::Error::NoError)
+    if (parser_result.error == regex::Error::NoError) {
+        run_optimization_passes();
         matcher = make<Matcher<Parser>>(*this, regex_options);
+    }
 }
 
 template<class Parser>
@@ -138,6 +143,30 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
     if (input.regex_options.has_flag_set(AllFlags::Internal_Stateful))
         continue_search = false;
 
+    // Rather than being restarted at every position, the NFA can look for the leftmost match in a single pass.
+    bool nfa_search = continue_search || input.regex_options.has_flag_set(AllFlags::Internal_Stateful);
+
+    auto engine = m_engine;
+    if (engine == ExecutionEngine::Automatic && !m_can_use_nfa)
+        engine = ExecutionEngine::Backtracking;
+
+    auto execute_with_engine = [&](auto& output, bool search, size_t& match_start) -> Optional<bool> {
+        if (engine == ExecutionEngine::NFA)
+            return execute_nfa(input, state, output, search, match_start);
+
+        auto success = execute(input, state, output, 0);
+        if (success.has_value() || !input.exceeded_backtracking_budget)
+            return success;
+
+        // The backtracker got lost in this pattern, let the NFA find the match (and any other ones) instead.
+        dbgln_if(REGEX_DEBUG, "[match] Backtracker ran out of budget after {} operations, switching to the NFA", output.operations);
+        engine = ExecutionEngine::NFA;
+        input.backtracking_budget = NumericLimits<size_t>::max();
+        state.string_position = match_start;
+        state.instruction_position = 0;
+        return execute_nfa(input, state, output, search, match_start);
+    };
+
     for (auto& view : views) {
         if (lines_to_skip != 0) {
             ++input.line;
@@ -149,6 +178,12 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
 
         auto view_length = view.length();
         size_t view_index = m_pattern.start_offset;
+
+        // The NFA never does more than one step per instruction for every character, and the backtracker
+        // may only take a few times as long as that before it has to give up.
+        if (engine == ExecutionEngine::Automatic)
+            input.backtracking_budget = output.operations + (view_length + 1) * (m_pattern.parser_result.bytecode.size() + 1) * c_backtracking_budget_factor;
+
         state.string_position = view_index;
         bool succeeded = false;
 
@@ -164,7 +199,10 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, temp_output, 0);
+            size_t match_start = view_index;
+            auto success = execute_with_engine(temp_output, false, match_start);
+            if (!success.has_value())
+                return { false, 0, {}, {}, {}, output.operations };
             // This success is acceptable only if it doesn't read anything from the input (input length is 0).
             if (state.string_position <= view_index) {
                 if (success.value()) {
@@ -189,16 +227,35 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
             if (match_length_minimum && match_length_minimum > view_length - view_index)
                 break;
 
+            // There's no need to try the positions at which no match could start.
+            if (continue_search || input.regex_options.has_flag_set(AllFlags::Internal_Stateful)) {
+                auto candidate = find_next_candidate(input, view_index);
+                if (!candidate.has_value() || (match_length_minimum && match_length_minimum > view_length - candidate.value())) {
+                    // Leave the state as if all of those positions had been tried and failed.
+                    state.string_position = 0;
+                    break;
+                }
+                view_index = candidate.value();
+            }
+
             input.column = match_count;
             input.match_index = match_count;
 
             state.string_position = view_index;
             state.instruction_position = 0;
 
-            auto success = execute(input, state, output, 0);
+            size_t match_start = view_index;
+            auto success = execute_with_engine(output, nfa_search, match_start);
             if (!success.has_value())
                 return { false, 0, {}, {}, {}, output.operations };
 
+            if (engine == ExecutionEngine::NFA) {
+                if (success.value())
+                    view_index = match_start;
+                else if (nfa_search)
+                    break;
+            }
+
             if (success.value()) {
                 succeeded = true;
 
@@ -292,8 +349,14 @@ RegexResult Matcher<Parser>::match(const Vector<RegexStringView> views, Optional
 template<class Parser>
 Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& state, MatchOutput& output, size_t recursion_level) const
 {
-    if (recursion_level > c_max_recursion)
+    if (recursion_level > c_max_recursion) {
+        // Rather than missing a match, give the NFA a chance if there's one to fall back to.
+        if (input.backtracking_budget != NumericLimits<size_t>::max()) {
+            input.exceeded_backtracking_budget = true;
+            return {};
+        }
         return false;
+    }
 
     Vector<MatchState> fork_low_prio_states;
     MatchState fork_high_prio_state;
@@ -303,6 +366,10 @@ Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& sta
 
     for (;;) {
         ++output.operations;
+        if (output.operations > input.backtracking_budget) {
+            input.exceeded_backtracking_budget = true;
+            return {};
+        }
         auto* opcode = bytecode.get_opcode(state);
 
         if (!opcode) {
@@ -330,7 +397,12 @@ Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& sta
 
         switch (result) {
         case ExecutionResult::Fork_PrioLow:
-            fork_low_prio_states.prepend(state);
+            // Nothing can have been left since this loop went around the last time, see OpCode_ForkReplaceStay.
+            if (opcode->opcode_id() == OpCodeId::ForkReplaceStay && !fork_low_prio_states.is_empty() && fork_low_prio_states.last().instruction_position == state.instruction_position) {
+                fork_low_prio_states.last() = state;
+                continue;
+            }
+            fork_low_prio_states.append(state);
             continue;
         case ExecutionResult::Fork_PrioHigh:
             fork_high_prio_state = state;
@@ -352,7 +424,7 @@ Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& sta
         case ExecutionResult::Failed:
             return false;
         case ExecutionResult::Failed_ExecuteLowPrioForks:
-            return execute_low_prio_forks(input, state, output, fork_low_prio_states, recursion_level + 1);
+            return execute_low_prio_forks(input, state, output, move(fork_low_prio_states), recursion_level + 1);
         }
     }
 
@@ -362,8 +434,9 @@ Optional<bool> Matcher<Parser>::execute(const MatchInput& input, MatchState& sta
 template<class Parser>
 ALWAYS_INLINE Optional<bool> Matcher<Parser>::execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const
 {
-    for (auto& state : states) {
-
+    // The most recent fork comes last, and is the first one to go back to.
+    for (size_t i = states.size(); i > 0; --i) {
+        auto& state = states[i - 1];
         state.instruction_position = state.fork_at_position;
 #if REGEX_DEBUG
         fprintf(stderr, "Forkstay... ip = %lu, sp = %lu\n", state.instruction_position, state.string_position);
@@ -384,6 +457,374 @@ ALWAYS_INLINE Optional<bool> Matcher<Parser>::execute_low_prio_forks(const Match
     return false;
 }
 
+template<class Parser>
+bool Matcher<Parser>::analyze_nfa_support()
+{
+    auto& bytecode = m_pattern.parser_result.bytecode;
+    size_t highest_capture_group_id = 0;
+    bool has_capture_groups = false;
+
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = *bytecode.get_opcode(state);
+        switch (opcode.opcode_id()) {
+        case OpCodeId::Compare: {
+            auto& compare = static_cast<const OpCode_Compare&>(opcode);
+            size_t offset = state.instruction_position + 3;
+            for (size_t i = 0; i < compare.arguments_count(); ++i) {
+                switch ((CharacterCompareType)bytecode.at(offset++)) {
+                case CharacterCompareType::Inverse:
+                case CharacterCompareType::TemporaryInverse:
+                case CharacterCompareType::AnyChar:
+                    break;
+                case CharacterCompareType::Char:
+                case CharacterCompareType::CharClass:
+                case CharacterCompareType::CharRange:
+                    ++offset;
+                    break;
+                case CharacterCompareType::String:
+                    // The NFA matches strings one character at a time, which only works if they're alone and not empty.
+                    if (compare.arguments_count() != 1 || bytecode.at(offset) == 0)
+                        return false;
+                    offset += bytecode.at(offset) + 1;
+                    break;
+                default:
+                    return false;
+                }
+            }
+            break;
+        }
+        case OpCodeId::SaveLeftCaptureGroup:
+        case OpCodeId::SaveRightCaptureGroup:
+            has_capture_groups = true;
+            highest_capture_group_id = max(highest_capture_group_id, (size_t)bytecode.at(state.instruction_position + 1));
+            break;
+        case OpCodeId::SaveLeftNamedCaptureGroup: {
+            auto name = static_cast<const OpCode_SaveLeftNamedCaptureGroup&>(opcode).name();
+            if (!m_nfa_named_capture_groups.contains_slow(name))
+                m_nfa_named_capture_groups.append(name);
+            break;
+        }
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+            // These are only used for lookaround.
+            return false;
+        default:
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+
+    m_nfa_capture_group_slots = has_capture_groups ? highest_capture_group_id + 1 : 0;
+    return true;
+}
+
+template<class Parser>
+void Matcher<Parser>::analyze_prefilter()
+{
+    auto& bytecode = m_pattern.parser_result.bytecode;
+
+    // The literal prefix is whatever the compares on the straight line from the start of the pattern spell out.
+    StringBuilder prefix;
+    MatchState state;
+    for (size_t steps = 0; state.instruction_position < bytecode.size() && steps < bytecode.size(); ++steps) {
+        auto& opcode = *bytecode.get_opcode(state);
+        if (opcode.opcode_id() == OpCodeId::Jump) {
+            state.instruction_position += opcode.size() + static_cast<const OpCode_Jump&>(opcode).offset();
+            continue;
+        }
+        if (ByteCode::is_transparent(opcode.opcode_id())) {
+            state.instruction_position += opcode.size();
+            continue;
+        }
+        if (opcode.opcode_id() != OpCodeId::Compare || static_cast<const OpCode_Compare&>(opcode).arguments_count() != 1)
+            break;
+
+        auto arguments_position = state.instruction_position + 3;
+        auto compare_type = (CharacterCompareType)bytecode.at(arguments_position);
+        if (compare_type == CharacterCompareType::Char) {
+            auto ch = bytecode.at(arguments_position + 1);
+            if (ch >= 128)
+                break;
+            prefix.append((char)ch);
+        } else if (compare_type == CharacterCompareType::String) {
+            auto length = bytecode.at(arguments_position + 1);
+            size_t i = 0;
+            for (; i < length && bytecode.at(arguments_position + 2 + i) < 128; ++i)
+                prefix.append((char)bytecode.at(arguments_position + 2 + i));
+            if (i < length)
+                break;
+        } else {
+            break;
+        }
+        state.instruction_position += opcode.size();
+    }
+    m_literal_prefix = prefix.to_string();
+
+    m_first_characters = bytecode.first_characters(0);
+}
+
+// Returns the first position from `position` onwards at which a match could start, if there is any.
+template<class Parser>
+Optional<size_t> Matcher<Parser>::find_next_candidate(const MatchInput& input, size_t position) const
+{
+    if (!m_first_characters.has_value())
+        return position;
+
+    auto& view = input.view;
+    auto length = view.length();
+    bool insensitive = input.regex_options.has_flag_set(AllFlags::Insensitive);
+    auto& first_characters = insensitive ? m_first_characters->case_insensitive : m_first_characters->case_sensitive;
+
+    if (!view.is_u8_view()) {
+        auto code_points = view.u32view().code_points();
+        for (; position < length; ++position) {
+            auto code_point = code_points[position];
+            if (code_point < 128 && first_characters[code_point])
+                return position;
+        }
+        return {};
+    }
+
+    auto characters = reinterpret_cast<const u8*>(view.u8view().characters_without_null_termination());
+    if (!insensitive && !m_literal_prefix.is_empty()) {
+        auto prefix = reinterpret_cast<const u8*>(m_literal_prefix.characters());
+        auto prefix_length = m_literal_prefix.length();
+        if (position + prefix_length > length)
+            return {};
+        // This checks the first and last byte of the prefix at many positions at once, which gets through the input much
+        // faster than finding the first byte with memchr() whenever that byte is common.
+        auto found = AK::memmem_optional(characters + position, length - position, prefix, prefix_length);
+        if (!found.has_value())
+            return {};
+        return position + found.value();
+    }
+
+    for (; position < length; ++position) {
+        if (characters[position] < 128 && first_characters[characters[position]])
+            return position;
+    }
+    return {};
+}
+
+namespace {
+
+static constexpr size_t nfa_no_position = NumericLimits<size_t>::max();
+
+struct NFAThread {
+    size_t instruction_position { 0 };
+    size_t string_offset { 0 }; // How much of a String compare this thread has matched already.
+    size_t start_position { 0 };
+    // Three entries per capture group slot: where it was last entered, and where its last complete match starts and ends.
+    Vector<size_t> captures;
+};
+
+}
+
+// This is a Pike VM: all the threads that are still alive advance through the input in lockstep, kept in the order the
+// backtracker would have tried them in. Two threads that reach the same instruction at the same position have the same
+// future, so only the one that got there first survives, which bounds the work per character by the size of the bytecode.
+// The first thread to reach the end of the bytecode has the match the backtracker would have found first.
+template<class Parser>
+bool Matcher<Parser>::execute_nfa(const MatchInput& input, MatchState& state, MatchOutput& output, bool search, size_t& match_start) const
+{
+    auto& bytecode = m_pattern.parser_result.bytecode;
+    auto view_length = input.view.length();
+    auto start_position = state.string_position;
+
+    Vector<NFAThread> current_threads;
+    Vector<NFAThread> next_threads;
+    Vector<NFAThread> pending_threads;
+
+    // Instead of being cleared for every position, this remembers the position at which each instruction was last reached.
+    Vector<size_t> reached_at_position;
+    reached_at_position.resize(bytecode.size());
+    for (auto& reached_at : reached_at_position)
+        reached_at = nfa_no_position;
+
+    Optional<NFAThread> matched_thread;
+    size_t matched_position = 0;
+
+    // Follows the thread through every instruction that doesn't consume input, and adds the threads that end up waiting
+    // for a character to `threads`, in priority order. Returns true if one of them matched, since that means every thread
+    // with a lower priority can be dropped.
+    auto add_thread = [&](NFAThread&& new_thread, size_t string_position, Vector<NFAThread>& threads) {
+        pending_threads.append(move(new_thread));
+        while (!pending_threads.is_empty()) {
+            auto thread = pending_threads.take_last();
+            for (;;) {
+                ++output.operations;
+                auto instruction_position = thread.instruction_position;
+                if (instruction_position >= bytecode.size()) {
+                    matched_thread = move(thread);
+                    matched_position = string_position;
+                    pending_threads.clear_with_capacity();
+                    return true;
+                }
+                if (reached_at_position[instruction_position] == string_position)
+                    break;
+                reached_at_position[instruction_position] = string_position;
+
+                MatchState opcode_state { string_position, instruction_position, 0 };
+                auto& opcode = *bytecode.get_opcode(opcode_state);
+                auto next_instruction_position = instruction_position + opcode.size();
+
+                auto opcode_id = opcode.opcode_id();
+                if (opcode_id == OpCodeId::Compare) {
+                    threads.append(move(thread));
+                    break;
+                }
+
+                if (opcode_id == OpCodeId::ForkJump || opcode_id == OpCodeId::ForkStay || opcode_id == OpCodeId::ForkReplaceStay) {
+                    auto result = opcode.execute(input, opcode_state, output);
+                    auto low_priority_thread = thread;
+                    if (result == ExecutionResult::Fork_PrioHigh) {
+                        thread.instruction_position = opcode_state.fork_at_position;
+                        low_priority_thread.instruction_position = next_instruction_position;
+                    } else {
+                        thread.instruction_position = next_instruction_position;
+                        low_priority_thread.instruction_position = opcode_state.fork_at_position;
+                    }
+                    pending_threads.append(move(low_priority_thread));
+                    continue;
+                }
+
+                if (opcode_id == OpCodeId::SaveLeftCaptureGroup || opcode_id == OpCodeId::SaveLeftNamedCaptureGroup
+                    || opcode_id == OpCodeId::SaveRightCaptureGroup || opcode_id == OpCodeId::SaveRightNamedCaptureGroup) {
+                    size_t slot = 0;
+                    if (opcode_id == OpCodeId::SaveLeftCaptureGroup || opcode_id == OpCodeId::SaveRightCaptureGroup) {
+                        slot = bytecode.at(instruction_position + 1);
+                    } else {
+                        StringView name { reinterpret_cast<const char*>(bytecode.at(instruction_position + 1)), (size_t)bytecode.at(instruction_position + 2) };
+                        while (m_nfa_named_capture_groups[slot] != name)
+                            ++slot;
+                        slot += m_nfa_capture_group_slots;
+                    }
+
+                    if (thread.captures.is_empty()) {
+                        thread.captures.resize((m_nfa_capture_group_slots + m_nfa_named_capture_groups.size()) * 3);
+                        for (auto& position : thread.captures)
+                            position = nfa_no_position;
+                    }
+                    if (opcode_id == OpCodeId::SaveLeftCaptureGroup || opcode_id == OpCodeId::SaveLeftNamedCaptureGroup) {
+                        thread.captures[slot * 3] = string_position;
+                    } else if (thread.captures[slot * 3] != nfa_no_position) {
+                        thread.captures[slot * 3 + 1] = thread.captures[slot * 3];
+                        thread.captures[slot * 3 + 2] = string_position;
+                    }
+                    thread.instruction_position = next_instruction_position;
+                    continue;
+                }
+
+                // Jumps and assertions.
+                auto result = opcode.execute(input, opcode_state, output);
+                if (result != ExecutionResult::Continue)
+                    break;
+                thread.instruction_position = opcode_state.instruction_position + opcode.size();
+            }
+        }
+        return false;
+    };
+
+    for (size_t position = start_position;; ++position) {
+        if (search && current_threads.is_empty() && !matched_thread.has_value()) {
+            auto candidate = find_next_candidate(input, position);
+            if (!candidate.has_value())
+                break;
+            position = candidate.value();
+        }
+
+        // Starting a new thread after all the others is what makes the leftmost match win.
+        if (!matched_thread.has_value() && (position == start_position || (search && position < view_length)))
+            add_thread({ 0, 0, position, {} }, position, current_threads);
+
+        if (position >= view_length || (current_threads.is_empty() && (!search || matched_thread.has_value())))
+            break;
+
+        for (auto& thread : current_threads) {
+            ++output.operations;
+            MatchState opcode_state { position, thread.instruction_position, 0 };
+            auto& compare = static_cast<const OpCode_Compare&>(*bytecode.get_opcode(opcode_state));
+            auto arguments_position = thread.instruction_position + 3;
+
+            if ((CharacterCompareType)bytecode.at(arguments_position) == CharacterCompareType::String) {
+                auto length = bytecode.at(arguments_position + 1);
+                u32 expected = (u8)bytecode.at(arguments_position + 2 + thread.string_offset);
+                u32 actual = input.view[position];
+                // Like the backtracker, this only lets ASCII bytes of the string match code points.
+                if (!input.view.is_u8_view() && expected >= 128)
+                    continue;
+                if (input.regex_options & AllFlags::Insensitive) {
+                    expected = tolower(expected);
+                    actual = tolower(actual);
+                }
+                if (expected != actual)
+                    continue;
+                if (++thread.string_offset < length) {
+                    next_threads.append(move(thread));
+                    continue;
+                }
+                thread.string_offset = 0;
+            } else if (compare.execute(input, opcode_state, output) != ExecutionResult::Continue) {
+                continue;
+            }
+
+            thread.instruction_position += compare.size();
+            if (add_thread(move(thread), position + 1, next_threads))
+                break;
+        }
+
+        swap(current_threads, next_threads);
+        next_threads.clear_with_capacity();
+    }
+
+    if (!matched_thread.has_value()) {
+        state.string_position = 0;
+        return false;
+    }
+
+    state.string_position = matched_position;
+    match_start = matched_thread->start_position;
+
+    auto& captures = matched_thread->captures;
+    auto make_match = [&](size_t start, size_t end) -> Match {
+        auto view = input.view.substring_view(start, end - start);
+        if (input.regex_options & AllFlags::StringCopyMatches)
+            return { view.to_string(), input.line, start, input.global_offset + start }; // create a copy of the original string
+        return { view, input.line, start, input.global_offset + start }; // take view to original string
+    };
+
+    if (m_nfa_capture_group_slots) {
+        if (input.match_index >= output.capture_group_matches.size())
+            output.capture_group_matches.resize(input.match_index + 1);
+        // Unlike the backtracker, the NFA never leaves anything in here for paths that didn't match,
+        // but the backtracker may have before it handed over.
+        auto& groups = output.capture_group_matches.at(input.match_index);
+        groups.clear_with_capacity();
+        groups.resize(m_nfa_capture_group_slots);
+        for (size_t slot = 0; !captures.is_empty() && slot < m_nfa_capture_group_slots; ++slot) {
+            if (captures[slot * 3 + 2] != nfa_no_position)
+                groups.at(slot) = make_match(captures[slot * 3 + 1], captures[slot * 3 + 2]);
+        }
+    }
+
+    if (!m_nfa_named_capture_groups.is_empty()) {
+        if (input.match_index >= output.named_capture_group_matches.size())
+            output.named_capture_group_matches.resize(input.match_index + 1);
+        auto& groups = output.named_capture_group_matches.at(input.match_index);
+        groups.clear();
+        for (size_t i = 0; !captures.is_empty() && i < m_nfa_named_capture_groups.size(); ++i) {
+            auto slot = m_nfa_capture_group_slots + i;
+            if (captures[slot * 3 + 2] != nfa_no_position)
+                groups.set(m_nfa_named_capture_groups[i], make_match(captures[slot * 3 + 1], captures[slot * 3 + 2]));
+        }
+    }
+
+    return true;
+}
+
 template class Matcher<PosixExtendedParser>;
 template class Regex<PosixExtendedParser>;
 
@@ -25,6 +25,7 @@ namespace regex {
 
 static const constexpr size_t c_max_recursion = 5000;
 static const constexpr size_t c_match_preallocation_count = 0;
+static const constexpr size_t c_backtracking_budget_factor = 4;
 
 struct RegexResult final {
     bool success { false };
@@ -40,6 +41,12 @@ struct RegexResult final {
 template<class Parser>
 class Regex;
 
+enum class ExecutionEngine {
+    Automatic,    // The backtracker, which hands over to the NFA if it takes too long (and the pattern allows it).
+    Backtracking, // Handles every pattern, but can take exponential time on some of them.
+    NFA,          // Follows all paths through the pattern at once, which takes linear time, but knows nothing of backreferences or lookaround.
+};
+
 template<class Parser>
 class Matcher final {
 
@@ -48,6 +55,8 @@ public:
         : m_pattern(pattern)
         , m_regex_options(regex_options.value_or({}))
     {
+        m_can_use_nfa = analyze_nfa_support();
+        analyze_prefilter();
     }
     ~Matcher() = default;
 
@@ -59,12 +68,44 @@ public:
         return m_regex_options;
     }
 
+    ExecutionEngine engine() const { return m_engine; }
+    bool can_use_nfa() const { return m_can_use_nfa; }
+
+    // This is only useful to compare the engines, since the automatic choice is the fastest one that works.
+    void set_engine(ExecutionEngine engine)
+    {
+        VERIFY(engine != ExecutionEngine::NFA || m_can_use_nfa);
+        m_engine = engine;
+    }
+
+    // Searches skip to the next position that starts with the literal prefix (or one of the first characters) of the pattern.
+    StringView literal_prefix() const { return m_literal_prefix; }
+    bool can_skip_to_candidates() const { return m_first_characters.has_value(); }
+
 private:
     Optional<bool> execute(const MatchInput& input, MatchState& state, MatchOutput& output, size_t recursion_level) const;
     ALWAYS_INLINE Optional<bool> execute_low_prio_forks(const MatchInput& input, MatchState& original_state, MatchOutput& output, Vector<MatchState> states, size_t recursion_level) const;
 
+    bool analyze_nfa_support();
+    bool execute_nfa(const MatchInput& input, MatchState& state, MatchOutput& output, bool search, size_t& match_start) const;
+
+    void analyze_prefilter();
+    Optional<size_t> find_next_candidate(const MatchInput& input, size_t position) const;
+
     const Regex<Parser>& m_pattern;
     const typename ParserTraits<Parser>::OptionsType m_regex_options;
+
+    ExecutionEngine m_engine { ExecutionEngine::Automatic };
+    bool m_can_use_nfa { false };
+
+    // The NFA keeps the capture groups of every path it follows, in slots that are numbered groups first, and then the named ones.
+    size_t m_nfa_capture_group_slots { 0 };
+    Vector<StringView> m_nfa_named_capture_groups;
+
+    // What every match has to start with. The prefix is only known for case sensitive matches, and the first characters
+    // are only known if none of them lie outside of ASCII.
+    String m_literal_prefix;
+    Optional<FirstCharacters> m_first_characters;
 };
 
 template<class Parser>
@@ -206,6 +247,10 @@ public:
         RegexResult result = matcher->match(views, AllOptions { regex_options.value_or({}) } | AllFlags::SkipSubExprResults);
         return result.success;
     }
+
+private:
+    // Rewrites the bytecode the parser came up with into something that matches the same, only faster.
+    void run_optimization_passes();
 };
 
 // free standing functions for match, search and has_match
@@ -0,0 +1,431 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "RegexMatcher.h"
+#include <AK/QuickSort.h>
+#include <ctype.h>
+
+namespace regex {
+
+namespace {
+
+struct Instruction {
+    size_t position { 0 };
+    size_t size { 0 };
+    OpCodeId id { OpCodeId::Exit };
+};
+
+struct Range {
+    u32 from { 0 };
+    u32 to { 0 };
+    // Where the range came in the compare, since the ones that come first are checked first.
+    size_t order { 0 };
+};
+
+struct Jump {
+    size_t offset_position { 0 };
+    size_t target { 0 };
+};
+
+// Builds new bytecode out of pieces of the old one, and then points the jumps that were carried over at wherever the
+// instructions they went to ended up.
+class Rewriter {
+public:
+    explicit Rewriter(const ByteCode& bytecode)
+        : m_old_bytecode(bytecode)
+    {
+        m_new_positions.resize(bytecode.size() + 1);
+    }
+
+    // This has to be called for every instruction of the old bytecode, even the ones that are left out.
+    void begin(const Instruction& instruction) { m_new_positions[instruction.position] = m_bytecode.size(); }
+
+    void copy(const Instruction& instruction);
+    void jump(OpCodeId id, size_t old_target);
+    void append(ByteCodeValueType value) { m_bytecode.empend(value); }
+    void append(const ByteCode& bytecode, size_t position, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+            m_bytecode.empend(bytecode.at(position + i));
+    }
+
+    ByteCode finish();
+
+private:
+    const ByteCode& m_old_bytecode;
+    ByteCode m_bytecode;
+    Vector<size_t> m_new_positions;
+    Vector<Jump> m_jumps;
+};
+
+static bool is_jump(OpCodeId id)
+{
+    return id == OpCodeId::Jump || id == OpCodeId::ForkJump || id == OpCodeId::ForkStay || id == OpCodeId::ForkReplaceStay;
+}
+
+static size_t jump_target(const ByteCode& bytecode, size_t position)
+{
+    return position + 2 + (ssize_t)bytecode.at(position + 1);
+}
+
+void Rewriter::copy(const Instruction& instruction)
+{
+    if (is_jump(instruction.id)) {
+        jump(instruction.id, jump_target(m_old_bytecode, instruction.position));
+        return;
+    }
+    append(m_old_bytecode, instruction.position, instruction.size);
+}
+
+void Rewriter::jump(OpCodeId id, size_t old_target)
+{
+    m_bytecode.empend((ByteCodeValueType)id);
+    m_jumps.append({ m_bytecode.size(), old_target });
+    m_bytecode.empend((ByteCodeValueType)0);
+}
+
+ByteCode Rewriter::finish()
+{
+    m_new_positions[m_old_bytecode.size()] = m_bytecode.size();
+    for (auto& jump : m_jumps)
+        m_bytecode[jump.offset_position] = (ByteCodeValueType)((ssize_t)m_new_positions[jump.target] - (ssize_t)(jump.offset_position + 1));
+    return move(m_bytecode);
+}
+
+static Vector<Instruction> decode(const ByteCode& bytecode)
+{
+    Vector<Instruction> instructions;
+    MatchState state;
+    while (state.instruction_position < bytecode.size()) {
+        auto& opcode = *bytecode.get_opcode(state);
+        instructions.append({ state.instruction_position, opcode.size(), opcode.opcode_id() });
+        state.instruction_position += opcode.size();
+    }
+    return instructions;
+}
+
+// The positions some instruction can jump to, which have to stay the start of an instruction.
+static Vector<bool> find_jump_targets(const ByteCode& bytecode, const Vector<Instruction>& instructions)
+{
+    Vector<bool> is_jump_target;
+    is_jump_target.resize(bytecode.size() + 1);
+    for (auto& is_target : is_jump_target)
+        is_target = false;
+    for (auto& instruction : instructions) {
+        if (is_jump(instruction.id))
+            is_jump_target[jump_target(bytecode, instruction.position)] = true;
+    }
+    return is_jump_target;
+}
+
+// Lookaround fails its way out of its body by counting forks, so nothing may change how many of them it goes through.
+static bool has_lookaround(const Vector<Instruction>& instructions)
+{
+    for (auto& instruction : instructions) {
+        switch (instruction.id) {
+        case OpCodeId::FailForks:
+        case OpCodeId::Save:
+        case OpCodeId::Restore:
+        case OpCodeId::GoBack:
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+// Jumps to jumps go straight to where the last of them goes, and the ones that go nowhere are left out.
+static void thread_jumps(ByteCode& bytecode)
+{
+    auto instructions = decode(bytecode);
+    Rewriter rewriter(bytecode);
+    for (auto& instruction : instructions) {
+        rewriter.begin(instruction);
+        if (!is_jump(instruction.id)) {
+            rewriter.copy(instruction);
+            continue;
+        }
+
+        auto target = jump_target(bytecode, instruction.position);
+        for (size_t i = 0; i < instructions.size() && target < bytecode.size() && bytecode.at(target) == (ByteCodeValueType)OpCodeId::Jump; ++i)
+            target = jump_target(bytecode, target);
+
+        // Both ways out of a fork that goes to the next instruction lead to the same place.
+        if (target == instruction.position + instruction.size)
+            continue;
+        rewriter.jump(instruction.id, target);
+    }
+    bytecode = rewriter.finish();
+}
+
+// Whether the range compares like the characters in it do on their own, when matching case insensitively as well.
+// That's not the case if it takes in some, but not all, of the upper case letters.
+static bool can_be_merged(Range range)
+{
+    if (range.to >= 128)
+        return false;
+    if (range.from >= 'A' && range.to <= 'Z')
+        return true;
+    return range.to < 'A' || range.from > 'Z';
+}
+
+// Sorts the characters and ranges of a character class, and merges the ones that touch or overlap.
+static void merge_character_ranges(ByteCode& bytecode)
+{
+    auto instructions = decode(bytecode);
+    Rewriter rewriter(bytecode);
+    for (auto& instruction : instructions) {
+        rewriter.begin(instruction);
+        if (instruction.id != OpCodeId::Compare || bytecode.at(instruction.position + 1) < 2) {
+            rewriter.copy(instruction);
+            continue;
+        }
+
+        bool inverse = false;
+        bool can_merge = true;
+        Vector<Range> ranges;
+        Vector<ByteCodeValueType> other_arguments;
+        auto offset = instruction.position + 3;
+        for (size_t i = 0; can_merge && i < bytecode.at(instruction.position + 1); ++i) {
+            auto type = (CharacterCompareType)bytecode.at(offset++);
+            switch (type) {
+            case CharacterCompareType::Inverse:
+                // This only inverts the arguments after it, which are all of them if it comes first.
+                if (i != 0)
+                    can_merge = false;
+                inverse = true;
+                break;
+            case CharacterCompareType::Char:
+            case CharacterCompareType::CharRange: {
+                auto value = bytecode.at(offset++);
+                auto range = type == CharacterCompareType::Char ? Range { (u32)value, (u32)value, i } : Range { CharRange(value).from, CharRange(value).to, i };
+                if (type == CharacterCompareType::Char && value >= 128) {
+                    other_arguments.append((ByteCodeValueType)type);
+                    other_arguments.append(value);
+                } else if (can_be_merged(range)) {
+                    ranges.append(range);
+                } else {
+                    other_arguments.append((ByteCodeValueType)type);
+                    other_arguments.append(value);
+                }
+                break;
+            }
+            case CharacterCompareType::CharClass:
+                other_arguments.append((ByteCodeValueType)type);
+                other_arguments.append(bytecode.at(offset++));
+                break;
+            default:
+                // Temporary inverses only apply to the argument after them, which is the order this would mess up.
+                can_merge = false;
+                break;
+            }
+        }
+        if (!can_merge || ranges.size() < 2) {
+            rewriter.copy(instruction);
+            continue;
+        }
+
+        quick_sort(ranges, [](auto& a, auto& b) { return a.from < b.from; });
+        Vector<Range> merged_ranges;
+        for (auto& range : ranges) {
+            if (!merged_ranges.is_empty() && range.from <= merged_ranges.last().to + 1) {
+                Range merged_range { merged_ranges.last().from, max(merged_ranges.last().to, range.to), min(merged_ranges.last().order, range.order) };
+                if (can_be_merged(merged_range)) {
+                    merged_ranges.take_last();
+                    merged_ranges.append(merged_range);
+                    continue;
+                }
+            }
+            merged_ranges.append(range);
+        }
+        if (merged_ranges.size() == ranges.size()) {
+            rewriter.copy(instruction);
+            continue;
+        }
+
+        // Keep the ranges in the order they were written in, as patterns tend to list the likely characters first.
+        quick_sort(merged_ranges, [](auto& a, auto& b) { return a.order < b.order; });
+
+        ByteCode arguments;
+        if (inverse)
+            arguments.empend((ByteCodeValueType)CharacterCompareType::Inverse);
+        for (auto& range : merged_ranges) {
+            if (range.from == range.to) {
+                arguments.empend((ByteCodeValueType)CharacterCompareType::Char);
+                arguments.empend(range.from);
+            } else {
+                arguments.empend((ByteCodeValueType)CharacterCompareType::CharRange);
+                arguments.empend((ByteCodeValueType)CharRange { range.from, range.to });
+            }
+        }
+        for (auto value : other_arguments)
+            arguments.empend(value);
+
+        rewriter.append((ByteCodeValueType)OpCodeId::Compare);
+        rewriter.append(merged_ranges.size() + other_arguments.size() / 2 + (inverse ? 1 : 0));
+        rewriter.append(arguments.size());
+        rewriter.append(arguments, 0, arguments.size());
+    }
+    bytecode = rewriter.finish();
+}
+
+// The ASCII string a compare matches, if that's all it does.
+static Optional<Vector<ByteCodeValueType>> literal_characters(const ByteCode& bytecode, const Instruction& instruction)
+{
+    if (instruction.id != OpCodeId::Compare || bytecode.at(instruction.position + 1) != 1)
+        return {};
+
+    Vector<ByteCodeValueType> characters;
+    auto arguments_position = instruction.position + 3;
+    switch ((CharacterCompareType)bytecode.at(arguments_position)) {
+    case CharacterCompareType::Char:
+        characters.append(bytecode.at(arguments_position + 1));
+        break;
+    case CharacterCompareType::String:
+        for (size_t i = 0; i < bytecode.at(arguments_position + 1); ++i)
+            characters.append(bytecode.at(arguments_position + 2 + i));
+        break;
+    default:
+        return {};
+    }
+
+    // Outside of ASCII, characters and strings compare differently against code points.
+    for (auto ch : characters) {
+        if (ch >= 128)
+            return {};
+    }
+    if (characters.is_empty())
+        return {};
+    return characters;
+}
+
+// Runs of compares that each match a literal character (or string) become a single string compare.
+static void fuse_literals(ByteCode& bytecode)
+{
+    auto instructions = decode(bytecode);
+    auto is_jump_target = find_jump_targets(bytecode, instructions);
+    Rewriter rewriter(bytecode);
+    for (size_t i = 0; i < instructions.size();) {
+        auto characters = literal_characters(bytecode, instructions[i]);
+        size_t run_end = i + 1;
+        if (characters.has_value()) {
+            for (; run_end < instructions.size() && !is_jump_target[instructions[run_end].position]; ++run_end) {
+                auto more_characters = literal_characters(bytecode, instructions[run_end]);
+                if (!more_characters.has_value())
+                    break;
+                characters->append(more_characters.release_value());
+            }
+        }
+
+        for (size_t j = i; j < run_end; ++j)
+            rewriter.begin(instructions[j]);
+        if (run_end == i + 1) {
+            rewriter.copy(instructions[i]);
+            i = run_end;
+            continue;
+        }
+
+        rewriter.append((ByteCodeValueType)OpCodeId::Compare);
+        rewriter.append((ByteCodeValueType)1);
+        rewriter.append(characters->size() + 2);
+        rewriter.append((ByteCodeValueType)CharacterCompareType::String);
+        rewriter.append(characters->size());
+        for (auto ch : *characters)
+            rewriter.append(ch);
+        i = run_end;
+    }
+    bytecode = rewriter.finish();
+}
+
+// One or more of a single compare (`X; FORKJUMP X`) becomes one of it, followed by zero or more of it (`X; FORKSTAY
+// END; X; JUMP back; END`). That loop goes around without a fork that the backtracker recurses into, and might turn out
+// to be one that never has to be backtracked into.
+static void peel_loops(ByteCode& bytecode)
+{
+    auto instructions = decode(bytecode);
+    auto is_jump_target = find_jump_targets(bytecode, instructions);
+    Rewriter rewriter(bytecode);
+    for (size_t i = 0; i < instructions.size(); ++i) {
+        auto& instruction = instructions[i];
+        rewriter.begin(instruction);
+        if (instruction.id != OpCodeId::Compare || i + 1 == instructions.size()) {
+            rewriter.copy(instruction);
+            continue;
+        }
+        auto& fork = instructions[i + 1];
+        if (fork.id != OpCodeId::ForkJump || jump_target(bytecode, fork.position) != instruction.position || is_jump_target[fork.position]) {
+            rewriter.copy(instruction);
+            continue;
+        }
+
+        rewriter.copy(instruction);
+        rewriter.begin(fork);
+        rewriter.append((ByteCodeValueType)OpCodeId::ForkStay);
+        rewriter.append(instruction.size + 2);
+        rewriter.copy(instruction);
+        rewriter.append((ByteCodeValueType)OpCodeId::Jump);
+        rewriter.append((ByteCodeValueType) - (ssize_t)(instruction.size + 4));
+        ++i;
+    }
+    bytecode = rewriter.finish();
+}
+
+// A greedy loop around a single compare (`FORKSTAY END; X; JUMP back; END`) never has to give back what it matched if
+// nothing can follow it that starts with something the compare matches: Every position it could go back to starts with
+// one of those characters. The loop can then forget the ways out of all but its last iteration.
+static void make_loops_atomic(ByteCode& bytecode)
+{
+    auto instructions = decode(bytecode);
+    auto is_jump_target = find_jump_targets(bytecode, instructions);
+    for (size_t i = 0; i + 2 < instructions.size(); ++i) {
+        auto& fork = instructions[i];
+        auto& compare = instructions[i + 1];
+        auto& jump = instructions[i + 2];
+        if (fork.id != OpCodeId::ForkStay || compare.id != OpCodeId::Compare || jump.id != OpCodeId::Jump)
+            continue;
+        if (jump_target(bytecode, jump.position) != fork.position || jump_target(bytecode, fork.position) != jump.position + jump.size)
+            continue;
+        if (is_jump_target[compare.position] || is_jump_target[jump.position])
+            continue;
+
+        auto loop_characters = bytecode.first_characters(compare.position);
+        auto following_characters = bytecode.first_characters(jump.position + jump.size);
+        if (!loop_characters.has_value() || !following_characters.has_value())
+            continue;
+
+        bool overlaps = false;
+        for (size_t ch = 0; ch < 128; ++ch) {
+            if ((loop_characters->case_sensitive[ch] && following_characters->case_sensitive[ch])
+                || (loop_characters->case_insensitive[ch] && following_characters->case_insensitive[ch]))
+                overlaps = true;
+        }
+        if (!overlaps)
+            bytecode[fork.position] = (ByteCodeValueType)OpCodeId::ForkReplaceStay;
+    }
+}
+
+}
+
+template<class Parser>
+void Regex<Parser>::run_optimization_passes()
+{
+    auto& bytecode = parser_result.bytecode;
+
+    bool can_change_forks = !has_lookaround(decode(bytecode));
+    if (can_change_forks)
+        thread_jumps(bytecode);
+    merge_character_ranges(bytecode);
+    fuse_literals(bytecode);
+    if (can_change_forks) {
+        peel_loops(bytecode);
+        make_loops_atomic(bytecode);
+    }
+}
+
+template void Regex<PosixExtendedParser>::run_optimization_passes();
+template void Regex<ECMA262Parser>::run_optimization_passes();
+}
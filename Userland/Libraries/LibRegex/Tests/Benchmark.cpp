@@ -9,7 +9,7 @@
 #include <LibRegex/Regex.h>
 #include <stdio.h>
 
-#ifndef REGEX_DEBUG
+#if !REGEX_DEBUG
 
 #    define BENCHMARK_LOOP_ITERATIONS 100000
 
@@ -966,6 +966,70 @@ BENCHMARK_CASE(simple_notbol_noteol_benchmark_reference_stdcpp)
 }
 #    endif
 
+#    if defined(REGEX_BENCHMARK_OUR)
+// The subject is short so the backtracker finishes within a reasonable amount of time, these compare the engines on
+// a pattern that is exponential for backtracking.
+static void run_nested_quantifier_benchmark(regex::ExecutionEngine engine, size_t iterations)
+{
+    Regex<ECMA262> re("^(?:a|aa)*c$");
+    re.matcher->set_engine(engine);
+    auto haystack = String::repeated('a', 24);
+    for (size_t i = 0; i < iterations; ++i) {
+        EXPECT_EQ(re.match(haystack).success, false);
+    }
+}
+
+BENCHMARK_CASE(nested_quantifier_backtracking_benchmark)
+{
+    run_nested_quantifier_benchmark(regex::ExecutionEngine::Backtracking, 10);
+}
+
+BENCHMARK_CASE(nested_quantifier_nfa_benchmark)
+{
+    run_nested_quantifier_benchmark(regex::ExecutionEngine::NFA, 10);
+}
+
+BENCHMARK_CASE(nested_quantifier_automatic_benchmark)
+{
+    run_nested_quantifier_benchmark(regex::ExecutionEngine::Automatic, 10);
+}
+
+// And this one compares them on an ordinary pattern, where backtracking is cheap.
+static void run_email_address_engine_benchmark(regex::ExecutionEngine engine)
+{
+    Regex<ECMA262> re("^[A-Z0-9a-z._%+-]{1,64}@(?:[A-Za-z0-9-]{1,63}\\.){1,125}[A-Za-z]{2,63}$");
+    re.matcher->set_engine(engine);
+    for (size_t i = 0; i < BENCHMARK_LOOP_ITERATIONS / 10; ++i) {
+        EXPECT_EQ(re.match("hello.world@domain.tld").success, true);
+    }
+}
+
+BENCHMARK_CASE(email_address_backtracking_benchmark)
+{
+    run_email_address_engine_benchmark(regex::ExecutionEngine::Backtracking);
+}
+
+BENCHMARK_CASE(email_address_nfa_benchmark)
+{
+    run_email_address_engine_benchmark(regex::ExecutionEngine::NFA);
+}
+
+// Searches for a pattern that starts with a literal only have to look at the places where that literal shows up.
+BENCHMARK_CASE(literal_prefix_search_benchmark)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < 1000; ++i)
+        builder.append("the quick brown fox jumps over the lazy dog\n");
+    builder.append("hello friends\n");
+    auto haystack = builder.to_string();
+
+    Regex<PosixExtended> re("hello (friends|world)");
+    for (size_t i = 0; i < BENCHMARK_LOOP_ITERATIONS / 10; ++i) {
+        EXPECT_EQ(re.search(haystack).count, 1u);
+    }
+}
+#    endif
+
 #endif
 
 TEST_MAIN(Regex)
@@ -596,4 +596,200 @@ TEST_CASE(replace)
     }
 }
 
+TEST_CASE(nfa_engine_is_used_when_possible)
+{
+    EXPECT(Regex<ECMA262>("^(a|b)*c?$").matcher->can_use_nfa());
+    EXPECT(Regex<ECMA262>("(?<name>x+)y").matcher->can_use_nfa());
+    EXPECT(Regex<PosixExtended>("hello (friends)?$").matcher->can_use_nfa());
+
+    // Backreferences and lookaround need the backtracker.
+    EXPECT(!Regex<ECMA262>("(a)\\1").matcher->can_use_nfa());
+    EXPECT(!Regex<ECMA262>("(?<x>a)\\k<x>").matcher->can_use_nfa());
+    EXPECT(!Regex<ECMA262>("a(?=b)").matcher->can_use_nfa());
+    EXPECT(!Regex<ECMA262>("(?<!a)b").matcher->can_use_nfa());
+}
+
+TEST_CASE(nfa_engine_matches_like_backtracker)
+{
+    struct _test {
+        const char* pattern;
+        const char* subject;
+        ECMAScriptFlags options {};
+    };
+    // clang-format off
+    constexpr _test tests[] {
+        { "^hello.$", "hello1" },
+        { "(a+)(b*)c", "xxaabbbc" },
+        { "(a+?)(a*)", "aaaa" },
+        { "(?<first>\\w+) (?<second>\\w+)", "hello friends" },
+        { "\\bfoo\\B", "foox foo", ECMAScriptFlags::Global },
+        { "a|ab|abc", "abc" },
+        { "(x|xy)(z|yz)", "xyz" },
+        { "[a-c]{2,3}", "abcabcab", ECMAScriptFlags::Global },
+        { "HELLO", "say hello", ECMAScriptFlags::Insensitive },
+        { "^$", "" },
+    };
+    // clang-format on
+
+    for (auto& test : tests) {
+        Regex<ECMA262> nfa(test.pattern, test.options);
+        Regex<ECMA262> backtracker(test.pattern, test.options);
+        EXPECT_EQ(nfa.parser_result.error, Error::NoError);
+        EXPECT(nfa.matcher->can_use_nfa());
+        nfa.matcher->set_engine(regex::ExecutionEngine::NFA);
+        backtracker.matcher->set_engine(regex::ExecutionEngine::Backtracking);
+
+        auto nfa_result = nfa.search(test.subject);
+        auto backtracker_result = backtracker.search(test.subject);
+        EXPECT_EQ(nfa_result.success, backtracker_result.success);
+        EXPECT_EQ(nfa_result.count, backtracker_result.count);
+        for (size_t i = 0; i < min(nfa_result.count, backtracker_result.count); ++i) {
+            EXPECT_EQ(nfa_result.matches[i].view.to_string(), backtracker_result.matches[i].view.to_string());
+            EXPECT_EQ(nfa_result.matches[i].column, backtracker_result.matches[i].column);
+            EXPECT_EQ(nfa_result.capture_group_matches[i].size(), backtracker_result.capture_group_matches[i].size());
+            for (size_t j = 0; j < min(nfa_result.capture_group_matches[i].size(), backtracker_result.capture_group_matches[i].size()); ++j)
+                EXPECT_EQ(nfa_result.capture_group_matches[i][j].view.to_string(), backtracker_result.capture_group_matches[i][j].view.to_string());
+            EXPECT_EQ(nfa_result.named_capture_group_matches[i].size(), backtracker_result.named_capture_group_matches[i].size());
+        }
+    }
+}
+
+TEST_CASE(nfa_engine_takes_over_from_backtracker)
+{
+    // This takes the backtracker exponential time, and the NFA linear time.
+    Regex<ECMA262> re("^(?:a|aa)*c$");
+    String haystack = String::repeated('a', 100);
+    EXPECT_EQ(re.match(haystack).success, false);
+    EXPECT_EQ(re.match(String::formatted("{}c", haystack)).success, true);
+
+    // On long enough subjects, the backtracker would recurse too deep and miss the match.
+    Regex<ECMA262> lazy_catch_all("^(.*?)$");
+    auto long_haystack = String::repeated('x', 20000);
+    auto result = lazy_catch_all.match(long_haystack);
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.capture_group_matches.at(0).at(0).view.length(), 20000u);
+
+    // Loops that can match nothing do that as well, and used to come back with an empty last iteration.
+    Regex<ECMA262> empty_loop("(b|)+c");
+    result = empty_loop.match("bbc");
+    EXPECT_EQ(result.success, true);
+    EXPECT_EQ(result.capture_group_matches.at(0).at(0).view, "b");
+}
+
+TEST_CASE(search_skips_to_candidates)
+{
+    EXPECT_EQ(Regex<ECMA262>("hello (friends)?").matcher->literal_prefix(), "hello ");
+    EXPECT_EQ(Regex<PosixExtended>("^(ab)c|d").matcher->literal_prefix(), "");
+    EXPECT(Regex<PosixExtended>("^(ab)c|d").matcher->can_skip_to_candidates());
+    EXPECT(Regex<ECMA262>("[a-f]+x").matcher->can_skip_to_candidates());
+
+    // These can start with (or be) anything.
+    EXPECT(!Regex<ECMA262>("a*").matcher->can_skip_to_candidates());
+    EXPECT(!Regex<ECMA262>(".x").matcher->can_skip_to_candidates());
+    EXPECT(!Regex<ECMA262>("[^a]x").matcher->can_skip_to_candidates());
+    EXPECT(!Regex<ECMA262>("\\wx").matcher->can_skip_to_candidates());
+
+    String haystack = "the quick brown fox jumps over the lazy dog";
+
+    Regex<PosixExtended> prefix("o[vwg]", PosixFlags::Global);
+    auto result = prefix.match(haystack);
+    EXPECT_EQ(result.count, 3u);
+    EXPECT_EQ(result.matches.at(0).view, "ow");
+    EXPECT_EQ(result.matches.at(1).column, 26u);
+    EXPECT_EQ(result.matches.at(2).view, "og");
+
+    Regex<ECMA262> alternation("(fox|dog|cat)", ECMAScriptFlags::Global);
+    result = alternation.match(haystack);
+    EXPECT_EQ(result.count, 1u);
+    EXPECT_EQ(result.matches.at(0).column, 16u);
+    result = alternation.match(haystack);
+    EXPECT_EQ(result.count, 1u);
+    EXPECT_EQ(result.matches.at(0).column, 40u);
+    EXPECT_EQ(alternation.match(haystack).success, false);
+
+    Regex<ECMA262> insensitive("DOG|Lazy", ECMAScriptFlags::Insensitive);
+    result = insensitive.search(haystack);
+    EXPECT_EQ(result.count, 2u);
+    EXPECT_EQ(result.matches.at(0).view, "lazy");
+    EXPECT_EQ(result.matches.at(1).view, "dog");
+
+    // Editors search through Utf32Views, which don't get to use the literal prefix.
+    Vector<u32> code_points;
+    for (auto ch : haystack)
+        code_points.append(ch);
+    Utf32View utf32_haystack { code_points.data(), code_points.size() };
+    Regex<ECMA262> utf32_search("th[ae]");
+    result = utf32_search.search(utf32_haystack);
+    EXPECT_EQ(result.count, 2u);
+    EXPECT_EQ(result.matches.at(0).column, 0u);
+    EXPECT_EQ(result.matches.at(1).column, 31u);
+
+    Regex<ECMA262> nfa("z+y|x", ECMAScriptFlags::Global);
+    nfa.matcher->set_engine(regex::ExecutionEngine::NFA);
+    result = nfa.match(haystack);
+    EXPECT_EQ(result.count, 1u);
+    EXPECT_EQ(result.matches.at(0).view, "x");
+}
+
+TEST_CASE(optimizer)
+{
+    // A run of literal characters is compared as a single string.
+    Regex<ECMA262> hello("hello");
+    auto& hello_bytecode = hello.parser_result.bytecode;
+    EXPECT_EQ(hello_bytecode.size(), 10u);
+    EXPECT_EQ((regex::OpCodeId)hello_bytecode.at(0), regex::OpCodeId::Compare);
+    EXPECT_EQ((regex::CharacterCompareType)hello_bytecode.at(3), regex::CharacterCompareType::String);
+
+    // The characters of a class that touch are compared as a range.
+    Regex<ECMA262> letters("[bdac]");
+    EXPECT_EQ(letters.parser_result.bytecode.size(), 5u);
+    EXPECT_EQ((regex::CharacterCompareType)letters.parser_result.bytecode.at(3), regex::CharacterCompareType::CharRange);
+
+    // If what follows a greedy loop can't start with what the loop matches, the loop doesn't have to keep track of how to go back.
+    // The loop comes after the first compare of the `a`.
+    Regex<ECMA262> atomic("a+b");
+    EXPECT_EQ((regex::OpCodeId)atomic.parser_result.bytecode.at(5), regex::OpCodeId::ForkReplaceStay);
+    Regex<ECMA262> not_atomic("a+ab");
+    EXPECT_EQ((regex::OpCodeId)not_atomic.parser_result.bytecode.at(5), regex::OpCodeId::ForkStay);
+}
+
+TEST_CASE(optimizer_keeps_matches_the_same)
+{
+    struct _test {
+        const char* pattern;
+        const char* subject;
+        const char* match;
+        ECMAScriptFlags options {};
+    };
+    // clang-format off
+    constexpr _test tests[] {
+        { "a+ab", "xaaab", "aaab" },
+        { "a+b", "aaac aab", "aab" },
+        { "(a+)b", "aab", "aab" },
+        { "[ab]*b", "abab", "abab" },
+        { "x*y", "XXXY", "XXXY", ECMAScriptFlags::Insensitive },
+        { "x*X", "xxxX", "xxxX", ECMAScriptFlags::Insensitive },
+        { "[Y-Zab]+", "_yzAB", "yzAB", ECMAScriptFlags::Insensitive },
+        { "[Z\\[]+", "z[", "z[", ECMAScriptFlags::Insensitive },
+        { "[^bdac]+", "abcxyzd", "xyz" },
+        { "(?:abc|abd)e", "abde", "abde" },
+        { "hello (?=world)", "hello world", "hello " },
+        { "(?!ab)a+c", "aaac", "aaac" },
+    };
+    // clang-format on
+
+    for (auto& test : tests) {
+        Regex<ECMA262> re(test.pattern, test.options);
+        EXPECT_EQ(re.parser_result.error, Error::NoError);
+        auto result = re.search(test.subject);
+        EXPECT_EQ(result.success, true);
+        EXPECT_EQ(result.matches.first().view.to_string(), test.match);
+    }
+
+    // Strings now compare against code points too.
+    Vector<u32> code_points { 'a', 't', 'h', 'e' };
+    Regex<PosixExtended> posix_string("the");
+    EXPECT_EQ(posix_string.search(Utf32View { code_points.data(), code_points.size() }).count, 1u);
+}
+
 TEST_MAIN(Regex)
@@ -13,6 +13,7 @@
 #include <AK/String.h>
 #include <LibSQL/Forward.h>
 #include <LibSQL/Token.h>
+#include <LibSQL/Value.h>
 
 namespace SQL {
 
@@ -301,9 +302,15 @@ private:
 //==================================================================================================
 
 class Expression : public ASTNode {
+public:
+    // Evaluates the expression against the current row of |context|. Errors are reported through |context|, in
+    // which case the returned value is NULL.
+    virtual Value evaluate(ExecutionContext& context) const = 0;
 };
 
 class ErrorExpression final : public Expression {
+public:
+    virtual Value evaluate(ExecutionContext&) const override;
 };
 
 class NumericLiteral : public Expression {
@@ -315,6 +322,8 @@ public:
 
     double value() const { return m_value; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     double m_value;
 };
@@ -328,6 +337,8 @@ public:
 
     const String& value() const { return m_value; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     String m_value;
 };
@@ -341,11 +352,15 @@ public:
 
     const String& value() const { return m_value; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     String m_value;
 };
 
 class NullLiteral : public Expression {
+public:
+    virtual Value evaluate(ExecutionContext&) const override { return {}; }
 };
 
 class NestedExpression : public Expression {
@@ -422,6 +437,8 @@ public:
     const String& table_name() const { return m_table_name; }
     const String& column_name() const { return m_column_name; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     String m_schema_name;
     String m_table_name;
@@ -445,10 +462,14 @@ public:
 
     UnaryOperator type() const { return m_type; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     UnaryOperator m_type;
 };
 
+Value apply_unary_operator(UnaryOperator, const Value&);
+
 enum class BinaryOperator {
     // Note: These are in order of highest-to-lowest operator precedence.
     Concatenate,
@@ -481,10 +502,15 @@ public:
 
     BinaryOperator type() const { return m_type; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     BinaryOperator m_type;
 };
 
+// Applies any operator but AND and OR, which have to be evaluated lazily.
+Value apply_binary_operator(BinaryOperator, const Value& lhs, const Value& rhs);
+
 class ChainedExpression : public Expression {
 public:
     explicit ChainedExpression(NonnullRefPtrVector<Expression> expressions)
@@ -494,6 +520,8 @@ public:
 
     const NonnullRefPtrVector<Expression>& expressions() const { return m_expressions; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     NonnullRefPtrVector<Expression> m_expressions;
 };
@@ -508,6 +536,8 @@ public:
 
     const NonnullRefPtr<TypeName>& type_name() const { return m_type_name; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     NonnullRefPtr<TypeName> m_type_name;
 };
@@ -531,6 +561,8 @@ public:
     const Vector<WhenThenClause>& when_then_clauses() const { return m_when_then_clauses; }
     const RefPtr<Expression>& else_expression() const { return m_else_expression; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     RefPtr<Expression> m_case_expression;
     Vector<WhenThenClause> m_when_then_clauses;
@@ -547,6 +579,8 @@ public:
 
     const String& collation_name() const { return m_collation_name; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     String m_collation_name;
 };
@@ -570,6 +604,8 @@ public:
     MatchOperator type() const { return m_type; }
     const RefPtr<Expression>& escape() const { return m_escape; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     MatchOperator m_type;
     RefPtr<Expression> m_escape;
@@ -581,6 +617,8 @@ public:
         : InvertibleNestedExpression(move(expression), invert_expression)
     {
     }
+
+    virtual Value evaluate(ExecutionContext&) const override;
 };
 
 class IsExpression : public InvertibleNestedDoubleExpression {
@@ -589,6 +627,8 @@ public:
         : InvertibleNestedDoubleExpression(move(lhs), move(rhs), invert_expression)
     {
     }
+
+    virtual Value evaluate(ExecutionContext&) const override;
 };
 
 class BetweenExpression : public InvertibleNestedDoubleExpression {
@@ -601,6 +641,8 @@ public:
 
     const NonnullRefPtr<Expression>& expression() const { return m_expression; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     NonnullRefPtr<Expression> m_expression;
 };
@@ -615,6 +657,8 @@ public:
 
     const NonnullRefPtr<ChainedExpression>& expression_chain() const { return m_expression_chain; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     NonnullRefPtr<ChainedExpression> m_expression_chain;
 };
@@ -631,6 +675,8 @@ public:
     const String& schema_name() const { return m_schema_name; }
     const String& table_name() const { return m_table_name; }
 
+    virtual Value evaluate(ExecutionContext&) const override;
+
 private:
     String m_schema_name;
     String m_table_name;
@@ -746,4 +792,118 @@ private:
     RefPtr<LimitClause> m_limit_clause;
 };
 
+class Insert : public Statement {
+public:
+    Insert(RefPtr<CommonTableExpressionList> common_table_expression_list, String schema_name, String table_name, String alias, Vector<String> column_names, NonnullRefPtrVector<ChainedExpression> chained_expressions)
+        : m_common_table_expression_list(move(common_table_expression_list))
+        , m_schema_name(move(schema_name))
+        , m_table_name(move(table_name))
+        , m_alias(move(alias))
+        , m_column_names(move(column_names))
+        , m_chained_expressions(move(chained_expressions))
+    {
+    }
+
+    const RefPtr<CommonTableExpressionList>& common_table_expression_list() const { return m_common_table_expression_list; }
+    const String& schema_name() const { return m_schema_name; }
+    const String& table_name() const { return m_table_name; }
+    const String& alias() const { return m_alias; }
+    const Vector<String>& column_names() const { return m_column_names; }
+    const NonnullRefPtrVector<ChainedExpression>& chained_expressions() const { return m_chained_expressions; }
+
+private:
+    RefPtr<CommonTableExpressionList> m_common_table_expression_list;
+    String m_schema_name;
+    String m_table_name;
+    String m_alias;
+    Vector<String> m_column_names;
+    NonnullRefPtrVector<ChainedExpression> m_chained_expressions;
+};
+
+class Update : public Statement {
+public:
+    struct UpdateColumn {
+        String column_name;
+        NonnullRefPtr<Expression> expression;
+    };
+
+    Update(RefPtr<CommonTableExpressionList> common_table_expression_list, NonnullRefPtr<QualifiedTableName> qualified_table_name, Vector<UpdateColumn> update_columns, RefPtr<Expression> where_clause, RefPtr<ReturningClause> returning_clause)
+        : m_common_table_expression_list(move(common_table_expression_list))
+        , m_qualified_table_name(move(qualified_table_name))
+        , m_update_columns(move(update_columns))
+        , m_where_clause(move(where_clause))
+        , m_returning_clause(move(returning_clause))
+    {
+    }
+
+    const RefPtr<CommonTableExpressionList>& common_table_expression_list() const { return m_common_table_expression_list; }
+    const NonnullRefPtr<QualifiedTableName>& qualified_table_name() const { return m_qualified_table_name; }
+    const Vector<UpdateColumn>& update_columns() const { return m_update_columns; }
+    const RefPtr<Expression>& where_clause() const { return m_where_clause; }
+    const RefPtr<ReturningClause>& returning_clause() const { return m_returning_clause; }
+
+private:
+    RefPtr<CommonTableExpressionList> m_common_table_expression_list;
+    NonnullRefPtr<QualifiedTableName> m_qualified_table_name;
+    Vector<UpdateColumn> m_update_columns;
+    RefPtr<Expression> m_where_clause;
+    RefPtr<ReturningClause> m_returning_clause;
+};
+
+class CreateIndex : public Statement {
+public:
+    CreateIndex(String schema_name, String index_name, String table_name, Vector<String> column_names, bool is_unique, bool is_error_if_index_exists)
+        : m_schema_name(move(schema_name))
+        , m_index_name(move(index_name))
+        , m_table_name(move(table_name))
+        , m_column_names(move(column_names))
+        , m_is_unique(is_unique)
+        , m_is_error_if_index_exists(is_error_if_index_exists)
+    {
+    }
+
+    const String& schema_name() const { return m_schema_name; }
+    const String& index_name() const { return m_index_name; }
+    const String& table_name() const { return m_table_name; }
+    const Vector<String>& column_names() const { return m_column_names; }
+    bool is_unique() const { return m_is_unique; }
+    bool is_error_if_index_exists() const { return m_is_error_if_index_exists; }
+
+private:
+    String m_schema_name;
+    String m_index_name;
+    String m_table_name;
+    Vector<String> m_column_names;
+    bool m_is_unique;
+    bool m_is_error_if_index_exists;
+};
+
+class DropIndex : public Statement {
+public:
+    DropIndex(String schema_name, String index_name, bool is_error_if_index_does_not_exist)
+        : m_schema_name(move(schema_name))
+        , m_index_name(move(index_name))
+        , m_is_error_if_index_does_not_exist(is_error_if_index_does_not_exist)
+    {
+    }
+
+    const String& schema_name() const { return m_schema_name; }
+    const String& index_name() const { return m_index_name; }
+    bool is_error_if_index_does_not_exist() const { return m_is_error_if_index_does_not_exist; }
+
+private:
+    String m_schema_name;
+    String m_index_name;
+    bool m_is_error_if_index_does_not_exist;
+};
+
+class BeginTransaction : public Statement {
+};
+
+class CommitTransaction : public Statement {
+};
+
+class RollbackTransaction : public Statement {
+};
+
 }
@@ -0,0 +1,536 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/BTree.h>
+#include <string.h>
+
+namespace SQL {
+
+// The node header: the node type, the number of cells, where the cells start, and the next leaf (for leaves) or the
+// last child (for internal nodes). The cell offsets come right after it.
+static constexpr size_t node_type_offset = 0;
+static constexpr size_t cell_count_offset = 2;
+static constexpr size_t content_start_offset = 4;
+static constexpr size_t next_offset = 8;
+static constexpr size_t node_header_size = 12;
+
+// Any four cells fit into a node, so splitting a node always leaves enough room on both sides.
+static constexpr size_t max_cell_size = (BufferPool::page_size - node_header_size) / 4 - sizeof(u16);
+// The key size and the value size come first in a leaf cell. In an internal cell, it's the child and the key size.
+static constexpr size_t cell_header_size = 6;
+static constexpr size_t overflow_header_size = sizeof(u32);
+static constexpr size_t overflow_data_size = BufferPool::page_size - overflow_header_size;
+
+static_assert(BTree::max_key_size + cell_header_size + 64 <= max_cell_size);
+
+enum class NodeType : u8 {
+    Leaf = 1,
+    Internal = 2,
+};
+
+static u16 read_u16(const u8* data)
+{
+    u16 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static u32 read_u32(const u8* data)
+{
+    u32 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static void write_u16(u8* data, u16 value)
+{
+    memcpy(data, &value, sizeof(value));
+}
+
+static void write_u32(u8* data, u32 value)
+{
+    memcpy(data, &value, sizeof(value));
+}
+
+static bool is_leaf(const u8* node) { return node[node_type_offset] == (u8)NodeType::Leaf; }
+static size_t cell_count(const u8* node) { return read_u16(node + cell_count_offset); }
+static size_t content_start(const u8* node) { return read_u16(node + content_start_offset); }
+static PageNumber next_page(const u8* node) { return read_u32(node + next_offset); }
+static size_t cell_offset(const u8* node, size_t index) { return read_u16(node + node_header_size + index * sizeof(u16)); }
+static const u8* cell_at(const u8* node, size_t index) { return node + cell_offset(node, index); }
+
+// How much of a value is kept in the leaf cell itself, including the number of the first overflow page, if any.
+static size_t max_local_value_size(size_t key_size) { return max_cell_size - cell_header_size - key_size; }
+
+static ReadonlyBytes cell_key(const u8* node, const u8* cell)
+{
+    if (is_leaf(node))
+        return { cell + cell_header_size, read_u16(cell) };
+    return { cell + cell_header_size, read_u16(cell + 4) };
+}
+
+static PageNumber cell_child(const u8* cell) { return read_u32(cell); }
+
+static size_t cell_size(const u8* node, const u8* cell)
+{
+    if (!is_leaf(node))
+        return cell_header_size + read_u16(cell + 4);
+    size_t key_size = read_u16(cell);
+    size_t value_size = read_u32(cell + 2);
+    return cell_header_size + key_size + min(value_size, max_local_value_size(key_size));
+}
+
+static int compare_keys(ReadonlyBytes a, ReadonlyBytes b)
+{
+    if (auto common_size = min(a.size(), b.size()); common_size > 0) {
+        if (auto result = memcmp(a.data(), b.data(), common_size); result != 0)
+            return result;
+    }
+    return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+}
+
+// The index of the first cell whose key isn't less than (or with |upper|, is greater than) |key|.
+static size_t search(const u8* node, ReadonlyBytes key, bool upper)
+{
+    size_t low = 0;
+    size_t high = cell_count(node);
+    while (low < high) {
+        auto middle = low + (high - low) / 2;
+        auto result = compare_keys(cell_key(node, cell_at(node, middle)), key);
+        if (result < 0 || (upper && result == 0))
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+static PageNumber child_for_index(const u8* node, size_t index)
+{
+    return index < cell_count(node) ? cell_child(cell_at(node, index)) : next_page(node);
+}
+
+static void initialize_node(u8* node, NodeType type, PageNumber next)
+{
+    memset(node, 0, node_header_size);
+    node[node_type_offset] = (u8)type;
+    write_u16(node + content_start_offset, BufferPool::page_size);
+    write_u32(node + next_offset, next);
+}
+
+static Vector<ByteBuffer> read_cells(const u8* node)
+{
+    Vector<ByteBuffer> cells;
+    cells.ensure_capacity(cell_count(node));
+    for (size_t i = 0; i < cell_count(node); ++i) {
+        auto* cell = cell_at(node, i);
+        cells.unchecked_append(ByteBuffer::copy(cell, cell_size(node, cell)));
+    }
+    return cells;
+}
+
+static void write_cells(u8* node, NodeType type, Span<const ByteBuffer> cells, PageNumber next)
+{
+    initialize_node(node, type, next);
+    size_t start = BufferPool::page_size;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        start -= cells[i].size();
+        VERIFY(start >= node_header_size + cells.size() * sizeof(u16));
+        memcpy(node + start, cells[i].data(), cells[i].size());
+        write_u16(node + node_header_size + i * sizeof(u16), start);
+    }
+    write_u16(node + cell_count_offset, cells.size());
+    write_u16(node + content_start_offset, start);
+}
+
+static bool try_insert_cell(u8* node, size_t index, ReadonlyBytes cell)
+{
+    auto count = cell_count(node);
+    auto slots_end = node_header_size + (count + 1) * sizeof(u16);
+    if (content_start(node) < slots_end + cell.size()) {
+        // Deleting cells leaves holes in the cell content area, so see whether there's room once those are gone.
+        size_t used_size = 0;
+        for (size_t i = 0; i < count; ++i)
+            used_size += cell_size(node, cell_at(node, i));
+        if (BufferPool::page_size - used_size < slots_end + cell.size())
+            return false;
+        auto cells = read_cells(node);
+        write_cells(node, is_leaf(node) ? NodeType::Leaf : NodeType::Internal, cells, next_page(node));
+    }
+
+    auto start = content_start(node) - cell.size();
+    memcpy(node + start, cell.data(), cell.size());
+    auto* slots = node + node_header_size;
+    memmove(slots + (index + 1) * sizeof(u16), slots + index * sizeof(u16), (count - index) * sizeof(u16));
+    write_u16(slots + index * sizeof(u16), start);
+    write_u16(node + cell_count_offset, count + 1);
+    write_u16(node + content_start_offset, start);
+    return true;
+}
+
+static void remove_cell(u8* node, size_t index)
+{
+    auto count = cell_count(node);
+    auto* slots = node + node_header_size;
+    memmove(slots + index * sizeof(u16), slots + (index + 1) * sizeof(u16), (count - index - 1) * sizeof(u16));
+    write_u16(node + cell_count_offset, count - 1);
+}
+
+Result<PageNumber, String> BTree::create(BufferPool& pool)
+{
+    auto page_or_error = pool.allocate();
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto& page = page_or_error.value();
+    initialize_node(page.writable_data(), NodeType::Leaf, 0);
+    return page.number();
+}
+
+Result<ByteBuffer, String> BTree::make_leaf_cell(ReadonlyBytes key, ReadonlyBytes value)
+{
+    auto max_local_size = max_local_value_size(key.size());
+    auto local_size = value.size() <= max_local_size ? value.size() : max_local_size - overflow_header_size;
+    auto cell = ByteBuffer::create_uninitialized(cell_header_size + key.size() + min(value.size(), max_local_size));
+    write_u16(cell.data(), key.size());
+    write_u32(cell.data() + 2, value.size());
+    memcpy(cell.data() + cell_header_size, key.data(), key.size());
+    memcpy(cell.data() + cell_header_size + key.size(), value.data(), local_size);
+    if (local_size == value.size())
+        return cell;
+
+    // The rest of the value goes into a chain of overflow pages, each of which starts with the number of the next.
+    auto remaining = value.slice(local_size);
+    auto page_or_error = m_pool.allocate();
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto page = page_or_error.release_value();
+    write_u32(cell.data() + cell_header_size + key.size() + local_size, page.number());
+    for (;;) {
+        auto* data = page.writable_data();
+        auto chunk_size = min(remaining.size(), overflow_data_size);
+        memcpy(data + overflow_header_size, remaining.data(), chunk_size);
+        remaining = remaining.slice(chunk_size);
+        if (remaining.is_empty())
+            break;
+        auto next_page_or_error = m_pool.allocate();
+        if (next_page_or_error.is_error())
+            return next_page_or_error.release_error();
+        write_u32(data, next_page_or_error.value().number());
+        page = next_page_or_error.release_value();
+    }
+    return cell;
+}
+
+Result<ByteBuffer, String> BTree::read_value(const u8* cell)
+{
+    size_t key_size = read_u16(cell);
+    size_t value_size = read_u32(cell + 2);
+    auto* local_value = cell + cell_header_size + key_size;
+    auto max_local_size = max_local_value_size(key_size);
+    if (value_size <= max_local_size)
+        return ByteBuffer::copy(local_value, value_size);
+
+    auto value = ByteBuffer::create_uninitialized(value_size);
+    auto local_size = max_local_size - overflow_header_size;
+    memcpy(value.data(), local_value, local_size);
+    size_t offset = local_size;
+    auto page_number = read_u32(local_value + local_size);
+    while (offset < value_size) {
+        auto page_or_error = m_pool.get(page_number);
+        if (page_or_error.is_error())
+            return page_or_error.release_error();
+        auto* data = page_or_error.value().data();
+        auto chunk_size = min(value_size - offset, overflow_data_size);
+        memcpy(value.data() + offset, data + overflow_header_size, chunk_size);
+        offset += chunk_size;
+        page_number = read_u32(data);
+    }
+    return value;
+}
+
+Result<void, String> BTree::free_overflow_pages(const u8* cell)
+{
+    size_t key_size = read_u16(cell);
+    size_t value_size = read_u32(cell + 2);
+    auto max_local_size = max_local_value_size(key_size);
+    if (value_size <= max_local_size)
+        return {};
+
+    auto page_number = read_u32(cell + cell_header_size + key_size + max_local_size - overflow_header_size);
+    for (size_t offset = max_local_size - overflow_header_size; offset < value_size; offset += overflow_data_size) {
+        PageNumber next;
+        {
+            auto page_or_error = m_pool.get(page_number);
+            if (page_or_error.is_error())
+                return page_or_error.release_error();
+            next = read_u32(page_or_error.value().data());
+        }
+        if (auto result = m_pool.free(page_number); result.is_error())
+            return result;
+        page_number = next;
+    }
+    return {};
+}
+
+Result<void, String> BTree::insert(ReadonlyBytes key, ReadonlyBytes value)
+{
+    if (key.size() > max_key_size)
+        return String::formatted("Key is too large ({} bytes, the limit is {})", key.size(), max_key_size);
+
+    auto split_or_error = insert_into(m_root, key, value);
+    if (split_or_error.is_error())
+        return split_or_error.release_error();
+    auto& split = split_or_error.value();
+    if (!split.has_value())
+        return {};
+
+    // The root has to stay where it is, so what's in it moves to a new page, which becomes its first child.
+    auto root_or_error = m_pool.get(m_root);
+    if (root_or_error.is_error())
+        return root_or_error.release_error();
+    auto left_or_error = m_pool.allocate();
+    if (left_or_error.is_error())
+        return left_or_error.release_error();
+    auto* root = root_or_error.value().writable_data();
+    memcpy(left_or_error.value().writable_data(), root, BufferPool::page_size);
+
+    auto cell = ByteBuffer::create_uninitialized(cell_header_size + split->separator.size());
+    write_u32(cell.data(), left_or_error.value().number());
+    write_u16(cell.data() + 4, split->separator.size());
+    memcpy(cell.data() + cell_header_size, split->separator.data(), split->separator.size());
+    write_cells(root, NodeType::Internal, { &cell, 1 }, split->right);
+    return {};
+}
+
+Result<Optional<BTree::Split>, String> BTree::insert_into(PageNumber page_number, ReadonlyBytes key, ReadonlyBytes value)
+{
+    auto page_or_error = m_pool.get(page_number);
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto& page = page_or_error.value();
+    if (is_leaf(page.data()))
+        return insert_into_leaf(page, key, value);
+
+    auto child_index = search(page.data(), key, true);
+    auto child_split_or_error = insert_into(child_for_index(page.data(), child_index), key, value);
+    if (child_split_or_error.is_error() || !child_split_or_error.value().has_value())
+        return child_split_or_error;
+    return insert_into_internal(page, child_index, child_split_or_error.value().release_value());
+}
+
+Result<Optional<BTree::Split>, String> BTree::insert_into_leaf(Page& page, ReadonlyBytes key, ReadonlyBytes value)
+{
+    auto index = search(page.data(), key, false);
+    if (index < cell_count(page.data())) {
+        auto* cell = cell_at(page.data(), index);
+        if (compare_keys(cell_key(page.data(), cell), key) == 0) {
+            if (auto result = free_overflow_pages(cell); result.is_error())
+                return result.release_error();
+            remove_cell(page.writable_data(), index);
+        }
+    }
+
+    auto cell_or_error = make_leaf_cell(key, value);
+    if (cell_or_error.is_error())
+        return cell_or_error.release_error();
+    if (try_insert_cell(page.writable_data(), index, cell_or_error.value()))
+        return Optional<Split> {};
+
+    auto cells = read_cells(page.data());
+    cells.insert(index, cell_or_error.release_value());
+    return split(page, move(cells), true, next_page(page.data()));
+}
+
+Result<Optional<BTree::Split>, String> BTree::insert_into_internal(Page& page, size_t child_index, Split child_split)
+{
+    // The child keeps the keys before the separator, and the new page gets the rest. So the new page takes the
+    // child's place, and the child gets a new cell with the separator in front of it.
+    auto* node = page.writable_data();
+    auto child = child_for_index(node, child_index);
+    if (child_index < cell_count(node))
+        write_u32(node + cell_offset(node, child_index), child_split.right);
+    else
+        write_u32(node + next_offset, child_split.right);
+
+    auto cell = ByteBuffer::create_uninitialized(cell_header_size + child_split.separator.size());
+    write_u32(cell.data(), child);
+    write_u16(cell.data() + 4, child_split.separator.size());
+    memcpy(cell.data() + cell_header_size, child_split.separator.data(), child_split.separator.size());
+    if (try_insert_cell(node, child_index, cell))
+        return Optional<Split> {};
+
+    auto cells = read_cells(node);
+    cells.insert(child_index, move(cell));
+    return split(page, move(cells), false, next_page(node));
+}
+
+Result<Optional<BTree::Split>, String> BTree::split(Page& page, Vector<ByteBuffer> cells, bool is_leaf, PageNumber next)
+{
+    VERIFY(cells.size() >= 2);
+    size_t total_size = 0;
+    for (auto& cell : cells)
+        total_size += cell.size();
+    size_t middle = 0;
+    for (size_t left_size = 0; middle < cells.size() - 1 && left_size < total_size / 2; ++middle)
+        left_size += cells[middle].size();
+    middle = max(middle, (size_t)1);
+
+    auto right_or_error = m_pool.allocate();
+    if (right_or_error.is_error())
+        return right_or_error.release_error();
+    auto& right = right_or_error.value();
+    auto cell_span = cells.span();
+
+    if (is_leaf) {
+        // The leaves are chained, so the new one goes right after this one.
+        auto separator = ByteBuffer::copy(cells[middle].data() + cell_header_size, read_u16(cells[middle].data()));
+        write_cells(right.writable_data(), NodeType::Leaf, cell_span.slice(middle), next);
+        write_cells(page.writable_data(), NodeType::Leaf, cell_span.slice(0, middle), right.number());
+        return Optional<Split> { Split { move(separator), right.number() } };
+    }
+
+    // The middle cell moves up: its key separates the two nodes, and its child becomes the last one on the left.
+    auto& middle_cell = cells[middle];
+    auto separator = ByteBuffer::copy(middle_cell.data() + cell_header_size, read_u16(middle_cell.data() + 4));
+    write_cells(right.writable_data(), NodeType::Internal, cell_span.slice(middle + 1), next);
+    write_cells(page.writable_data(), NodeType::Internal, cell_span.slice(0, middle), cell_child(middle_cell.data()));
+    return Optional<Split> { Split { move(separator), right.number() } };
+}
+
+Result<PageNumber, String> BTree::find_leaf(ReadonlyBytes key)
+{
+    auto page_number = m_root;
+    for (;;) {
+        auto page_or_error = m_pool.get(page_number);
+        if (page_or_error.is_error())
+            return page_or_error.release_error();
+        auto* node = page_or_error.value().data();
+        if (is_leaf(node))
+            return page_number;
+        page_number = child_for_index(node, search(node, key, true));
+    }
+}
+
+Result<bool, String> BTree::remove(ReadonlyBytes key)
+{
+    auto leaf_or_error = find_leaf(key);
+    if (leaf_or_error.is_error())
+        return leaf_or_error.release_error();
+    auto page_or_error = m_pool.get(leaf_or_error.value());
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto& page = page_or_error.value();
+
+    auto index = search(page.data(), key, false);
+    if (index == cell_count(page.data()) || compare_keys(cell_key(page.data(), cell_at(page.data(), index)), key) != 0)
+        return false;
+    if (auto result = free_overflow_pages(cell_at(page.data(), index)); result.is_error())
+        return result.release_error();
+    remove_cell(page.writable_data(), index);
+    return true;
+}
+
+Result<Optional<ByteBuffer>, String> BTree::find(ReadonlyBytes key)
+{
+    auto leaf_or_error = find_leaf(key);
+    if (leaf_or_error.is_error())
+        return leaf_or_error.release_error();
+    auto page_or_error = m_pool.get(leaf_or_error.value());
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto* node = page_or_error.value().data();
+
+    auto index = search(node, key, false);
+    if (index == cell_count(node) || compare_keys(cell_key(node, cell_at(node, index)), key) != 0)
+        return Optional<ByteBuffer> {};
+    auto value_or_error = read_value(cell_at(node, index));
+    if (value_or_error.is_error())
+        return value_or_error.release_error();
+    return Optional<ByteBuffer> { value_or_error.release_value() };
+}
+
+Result<void, String> BTree::destroy()
+{
+    return destroy(m_root);
+}
+
+Result<void, String> BTree::destroy(PageNumber page_number)
+{
+    {
+        auto page_or_error = m_pool.get(page_number);
+        if (page_or_error.is_error())
+            return page_or_error.release_error();
+        auto* node = page_or_error.value().data();
+        for (size_t i = 0; i < cell_count(node); ++i) {
+            auto result = is_leaf(node) ? free_overflow_pages(cell_at(node, i)) : destroy(cell_child(cell_at(node, i)));
+            if (result.is_error())
+                return result;
+        }
+        if (!is_leaf(node)) {
+            if (auto result = destroy(next_page(node)); result.is_error())
+                return result;
+        }
+    }
+    return m_pool.free(page_number);
+}
+
+Result<BTree::Cursor, String> BTree::seek(ReadonlyBytes key)
+{
+    auto leaf_or_error = find_leaf(key);
+    if (leaf_or_error.is_error())
+        return leaf_or_error.release_error();
+
+    Cursor cursor(*this);
+    cursor.m_leaf = leaf_or_error.value();
+    {
+        auto page_or_error = m_pool.get(cursor.m_leaf);
+        if (page_or_error.is_error())
+            return page_or_error.release_error();
+        cursor.m_slot = search(page_or_error.value().data(), key, false);
+    }
+    if (auto result = cursor.load_entry(); result.is_error())
+        return result.release_error();
+    return cursor;
+}
+
+Result<void, String> BTree::Cursor::load_entry()
+{
+    for (;;) {
+        auto page_or_error = m_tree->m_pool.get(m_leaf);
+        if (page_or_error.is_error())
+            return page_or_error.release_error();
+        auto* node = page_or_error.value().data();
+        if (m_slot < cell_count(node)) {
+            m_key = ByteBuffer::copy(cell_key(node, cell_at(node, m_slot)));
+            return {};
+        }
+        // Leaves can be empty after deletions, so keep going until there's an entry.
+        m_leaf = next_page(node);
+        m_slot = 0;
+        if (m_leaf == 0) {
+            m_is_end = true;
+            return {};
+        }
+    }
+}
+
+Result<void, String> BTree::Cursor::next()
+{
+    VERIFY(!m_is_end);
+    ++m_slot;
+    return load_entry();
+}
+
+Result<ByteBuffer, String> BTree::Cursor::value()
+{
+    VERIFY(!m_is_end);
+    auto page_or_error = m_tree->m_pool.get(m_leaf);
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    return m_tree->read_value(cell_at(page_or_error.value().data(), m_slot));
+}
+
+}
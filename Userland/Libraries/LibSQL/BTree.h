@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/Optional.h>
+#include <AK/Result.h>
+#include <AK/Span.h>
+#include <LibSQL/BufferPool.h>
+
+namespace SQL {
+
+// A B+tree of byte string keys, ordered by memcmp(), each of which maps to a byte string value. Only the leaves
+// hold values, and they're chained together from left to right, so a range of keys can be read leaf by leaf.
+//
+// Every node is a page that has the cells it holds at the end and an array of their offsets, sorted by key, at the
+// start. A leaf cell is a key with its value, but values that don't fit into a quarter of a page start in the leaf,
+// and continue in a chain of overflow pages. An internal cell is a key with the child that holds the keys before it;
+// the last child, which holds the keys from the last one on, is kept in the page header instead.
+//
+// Deleting entries never merges nodes, so a tree only shrinks when it's destroyed.
+class BTree {
+public:
+    static constexpr size_t max_key_size = 512;
+
+    // Creates an empty tree, and returns its root page, which stays the same from then on.
+    static Result<PageNumber, String> create(BufferPool&);
+
+    BTree(BufferPool& pool, PageNumber root)
+        : m_pool(pool)
+        , m_root(root)
+    {
+    }
+
+    PageNumber root() const { return m_root; }
+
+    // Inserts |key|, or gives it a new value if it's already there.
+    Result<void, String> insert(ReadonlyBytes key, ReadonlyBytes value);
+    // Returns whether |key| was there.
+    Result<bool, String> remove(ReadonlyBytes key);
+    Result<Optional<ByteBuffer>, String> find(ReadonlyBytes key);
+    // Frees all pages of the tree, including its root.
+    Result<void, String> destroy();
+
+    // Walks the entries in order. Changing the tree while a cursor is walking it invalidates the cursor.
+    class Cursor {
+    public:
+        bool is_end() const { return m_is_end; }
+        const ByteBuffer& key() const { return m_key; }
+        Result<ByteBuffer, String> value();
+        Result<void, String> next();
+
+    private:
+        friend class BTree;
+        explicit Cursor(BTree& tree)
+            : m_tree(&tree)
+        {
+        }
+
+        // Moves on to the first entry at or after m_slot of m_leaf.
+        Result<void, String> load_entry();
+
+        BTree* m_tree { nullptr };
+        PageNumber m_leaf { 0 };
+        size_t m_slot { 0 };
+        ByteBuffer m_key;
+        bool m_is_end { false };
+    };
+
+    // Returns a cursor at the first entry whose key isn't less than |key|.
+    Result<Cursor, String> seek(ReadonlyBytes key);
+
+private:
+    struct Split {
+        ByteBuffer separator;
+        PageNumber right;
+    };
+
+    Result<Optional<Split>, String> insert_into(PageNumber, ReadonlyBytes key, ReadonlyBytes value);
+    Result<Optional<Split>, String> insert_into_leaf(Page&, ReadonlyBytes key, ReadonlyBytes value);
+    Result<Optional<Split>, String> insert_into_internal(Page&, size_t child_index, Split child_split);
+    Result<Optional<Split>, String> split(Page&, Vector<ByteBuffer> cells, bool is_leaf, PageNumber next);
+    Result<PageNumber, String> find_leaf(ReadonlyBytes key);
+
+    Result<ByteBuffer, String> make_leaf_cell(ReadonlyBytes key, ReadonlyBytes value);
+    Result<ByteBuffer, String> read_value(const u8* cell);
+    Result<void, String> free_overflow_pages(const u8* cell);
+    Result<void, String> destroy(PageNumber);
+
+    BufferPool& m_pool;
+    PageNumber m_root { 0 };
+};
+
+}
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/Batch.h>
+
+namespace SQL {
+
+const i64* ColumnVector::integers() const
+{
+    VERIFY(m_kind == Kind::Integer);
+    return m_integers.data();
+}
+
+const double* ColumnVector::floats() const
+{
+    VERIFY(m_kind == Kind::Float);
+    return m_floats.data();
+}
+
+const Value* ColumnVector::values() const
+{
+    VERIFY(m_kind == Kind::Mixed);
+    return m_values.data();
+}
+
+i64* ColumnVector::writable_integers()
+{
+    VERIFY(m_kind == Kind::Integer);
+    return m_integers.data();
+}
+
+double* ColumnVector::writable_floats()
+{
+    VERIFY(m_kind == Kind::Float);
+    return m_floats.data();
+}
+
+Value* ColumnVector::writable_values()
+{
+    VERIFY(m_kind == Kind::Mixed);
+    return m_values.data();
+}
+
+Value ColumnVector::value_at(size_t row) const
+{
+    if (m_nulls[row])
+        return {};
+    switch (m_kind) {
+    case Kind::Integer:
+        return Value(m_integers[row]);
+    case Kind::Float:
+        return Value(m_floats[row]);
+    case Kind::Mixed:
+        return m_values[row];
+    }
+    VERIFY_NOT_REACHED();
+}
+
+void ColumnVector::clear()
+{
+    // Batches are refilled over and over, so they keep their memory.
+    m_kind = Kind::Integer;
+    m_has_non_null_value = false;
+    m_nulls.clear_with_capacity();
+    m_integers.clear_with_capacity();
+    m_floats.clear_with_capacity();
+    m_values.clear_with_capacity();
+}
+
+void ColumnVector::resize(Kind kind, size_t size)
+{
+    clear();
+    m_kind = kind;
+    m_has_non_null_value = true;
+    m_nulls.resize_and_keep_capacity(size);
+    switch (kind) {
+    case Kind::Integer:
+        m_integers.resize_and_keep_capacity(size);
+        break;
+    case Kind::Float:
+        m_floats.resize_and_keep_capacity(size);
+        break;
+    case Kind::Mixed:
+        m_values.resize_and_keep_capacity(size);
+        break;
+    }
+}
+
+void ColumnVector::convert_to_mixed()
+{
+    VERIFY(m_values.is_empty());
+    for (size_t row = 0; row < size(); ++row)
+        m_values.append(value_at(row));
+    m_integers.clear_with_capacity();
+    m_floats.clear_with_capacity();
+    m_kind = Kind::Mixed;
+}
+
+void ColumnVector::append(const Value& value)
+{
+    if (value.is_null()) {
+        m_nulls.append(1);
+        if (m_kind == Kind::Integer)
+            m_integers.append(0);
+        else if (m_kind == Kind::Float)
+            m_floats.append(0);
+        else
+            m_values.append(Value {});
+        return;
+    }
+
+    if (!m_has_non_null_value && value.type() == ValueType::Float && m_kind == Kind::Integer) {
+        m_floats.resize(m_integers.size());
+        m_integers.clear_with_capacity();
+        m_kind = Kind::Float;
+    }
+    m_has_non_null_value = true;
+
+    if (m_kind == Kind::Integer && value.type() != ValueType::Integer)
+        convert_to_mixed();
+    else if (m_kind == Kind::Float && value.type() != ValueType::Float)
+        convert_to_mixed();
+
+    m_nulls.append(0);
+    switch (m_kind) {
+    case Kind::Integer:
+        m_integers.append(value.as_integer());
+        break;
+    case Kind::Float:
+        m_floats.append(value.as_float());
+        break;
+    case Kind::Mixed:
+        m_values.append(value);
+        break;
+    }
+}
+
+template<typename T>
+static void select_rows(Vector<T>& values, const u32* rows, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+        values[i] = move(values[rows[i]]);
+    values.shrink(count, true);
+}
+
+void ColumnVector::select(const u32* rows, size_t count)
+{
+    select_rows(m_nulls, rows, count);
+    switch (m_kind) {
+    case Kind::Integer:
+        select_rows(m_integers, rows, count);
+        break;
+    case Kind::Float:
+        select_rows(m_floats, rows, count);
+        break;
+    case Kind::Mixed:
+        select_rows(m_values, rows, count);
+        break;
+    }
+}
+
+void Batch::reset(size_t column_count)
+{
+    m_columns.resize(column_count);
+    for (auto& column : m_columns)
+        column.clear();
+    m_row_count = 0;
+}
+
+void Batch::append_row(const Tuple& row)
+{
+    VERIFY(row.size() == m_columns.size());
+    for (size_t i = 0; i < row.size(); ++i)
+        m_columns[i].append(row[i]);
+    ++m_row_count;
+}
+
+Tuple Batch::row(size_t index) const
+{
+    Tuple row;
+    row.ensure_capacity(m_columns.size());
+    for (auto& column : m_columns)
+        row.unchecked_append(column.value_at(index));
+    return row;
+}
+
+void Batch::select(const Vector<u32>& rows)
+{
+    for (auto& column : m_columns)
+        column.select(rows.data(), rows.size());
+    m_row_count = rows.size();
+}
+
+}
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Vector.h>
+#include <LibSQL/Value.h>
+
+namespace SQL {
+
+// How many rows operators hand to one another at a time, at most.
+static constexpr size_t batch_size = 1024;
+
+// The values of one column for each row of a batch. As long as all of them that aren't NULL are integers, or all are
+// floats, they're kept in a plain array of that type, which kernels can run tight loops over. Once the types are
+// mixed, the column falls back to keeping Values.
+class ColumnVector {
+public:
+    enum class Kind : u8 {
+        Integer,
+        Float,
+        Mixed,
+    };
+
+    Kind kind() const { return m_kind; }
+    size_t size() const { return m_nulls.size(); }
+
+    // Each of these is 1 for a NULL and 0 otherwise. The integer or float in place of a NULL is 0.
+    const u8* nulls() const { return m_nulls.data(); }
+    bool is_null(size_t row) const { return m_nulls[row]; }
+    const i64* integers() const;
+    const double* floats() const;
+    const Value* values() const;
+    Value value_at(size_t row) const;
+
+    void clear();
+    void append(const Value&);
+    // Makes this a column of |size| values of the given kind, which the caller then fills in, NULLs included.
+    void resize(Kind, size_t size);
+    i64* writable_integers();
+    double* writable_floats();
+    Value* writable_values();
+    u8* writable_nulls() { return m_nulls.data(); }
+
+    // Keeps only the rows at |rows|, which have to be in ascending order.
+    void select(const u32* rows, size_t count);
+
+private:
+    void convert_to_mixed();
+
+    Kind m_kind { Kind::Integer };
+    // While all values are NULL, the column can still become a column of floats.
+    bool m_has_non_null_value { false };
+    Vector<u8> m_nulls;
+    Vector<i64> m_integers;
+    Vector<double> m_floats;
+    Vector<Value> m_values;
+};
+
+// Up to batch_size rows, stored column by column.
+class Batch {
+public:
+    size_t row_count() const { return m_row_count; }
+    size_t column_count() const { return m_columns.size(); }
+    bool is_empty() const { return m_row_count == 0; }
+
+    const ColumnVector& column(size_t index) const { return m_columns[index]; }
+    ColumnVector& column(size_t index) { return m_columns[index]; }
+
+    // Empties the batch, and makes it have |column_count| columns.
+    void reset(size_t column_count);
+    void append_row(const Tuple&);
+    // For operators that fill in the columns themselves, once they are done.
+    void set_row_count(size_t row_count) { m_row_count = row_count; }
+    Tuple row(size_t index) const;
+
+    // Keeps only the rows at |rows|, which have to be in ascending order.
+    void select(const Vector<u32>& rows);
+
+private:
+    Vector<ColumnVector> m_columns;
+    size_t m_row_count { 0 };
+};
+
+}
@@ -0,0 +1,552 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TypeCasts.h>
+#include <LibSQL/BatchExpression.h>
+#include <string.h>
+
+namespace SQL {
+
+using Kind = ColumnVector::Kind;
+
+// Most kernels below are written to be free of branches within their loops, computing results for NULLs as well and
+// masking them out afterwards, so that the compiler can vectorize them.
+
+static void combine_nulls(const ColumnVector& lhs, const ColumnVector& rhs, ColumnVector& result)
+{
+    auto* lhs_nulls = lhs.nulls();
+    auto* rhs_nulls = rhs.nulls();
+    auto* nulls = result.writable_nulls();
+    for (size_t i = 0; i < result.size(); ++i)
+        nulls[i] = lhs_nulls[i] | rhs_nulls[i];
+}
+
+// Fills |is_true| with whether each value is true, and |is_null| with whether it's NULL, which is neither.
+static void truth_values(const ColumnVector& column, Vector<u8>& is_true, Vector<u8>& is_null)
+{
+    auto size = column.size();
+    is_true.resize_and_keep_capacity(size);
+    is_null.resize_and_keep_capacity(size);
+    auto* nulls = column.nulls();
+    switch (column.kind()) {
+    case Kind::Integer: {
+        auto* integers = column.integers();
+        for (size_t i = 0; i < size; ++i) {
+            is_true[i] = (integers[i] != 0) & !nulls[i];
+            is_null[i] = nulls[i];
+        }
+        break;
+    }
+    case Kind::Float: {
+        auto* floats = column.floats();
+        for (size_t i = 0; i < size; ++i) {
+            is_true[i] = (floats[i] != 0) & !nulls[i];
+            is_null[i] = nulls[i];
+        }
+        break;
+    }
+    case Kind::Mixed: {
+        auto* values = column.values();
+        for (size_t i = 0; i < size; ++i) {
+            auto value = values[i].to_bool();
+            is_true[i] = value.value_or(false);
+            is_null[i] = !value.has_value();
+        }
+        break;
+    }
+    }
+}
+
+void select_true_rows(const ColumnVector& condition, Vector<u32>& rows)
+{
+    // Every row is written, but only the ones that are true move the end of the selection forward.
+    auto size = condition.size();
+    auto* nulls = condition.nulls();
+    rows.resize_and_keep_capacity(size);
+    size_t count = 0;
+    switch (condition.kind()) {
+    case Kind::Integer: {
+        auto* integers = condition.integers();
+        for (size_t i = 0; i < size; ++i) {
+            rows[count] = i;
+            count += (integers[i] != 0) & !nulls[i];
+        }
+        break;
+    }
+    case Kind::Float: {
+        auto* floats = condition.floats();
+        for (size_t i = 0; i < size; ++i) {
+            rows[count] = i;
+            count += (floats[i] != 0) & !nulls[i];
+        }
+        break;
+    }
+    case Kind::Mixed: {
+        auto* values = condition.values();
+        for (size_t i = 0; i < size; ++i) {
+            rows[count] = i;
+            count += values[i].to_bool().value_or(false);
+        }
+        break;
+    }
+    }
+    rows.shrink(count, true);
+}
+
+static void fill(ColumnVector& column, const Value& value, size_t size)
+{
+    switch (value.type()) {
+    case ValueType::Null:
+        column.resize(Kind::Integer, size);
+        for (size_t i = 0; i < size; ++i) {
+            column.writable_integers()[i] = 0;
+            column.writable_nulls()[i] = 1;
+        }
+        return;
+    case ValueType::Integer:
+        column.resize(Kind::Integer, size);
+        for (size_t i = 0; i < size; ++i)
+            column.writable_integers()[i] = value.as_integer();
+        break;
+    case ValueType::Float:
+        column.resize(Kind::Float, size);
+        for (size_t i = 0; i < size; ++i)
+            column.writable_floats()[i] = value.as_float();
+        break;
+    case ValueType::Text:
+        column.resize(Kind::Mixed, size);
+        for (size_t i = 0; i < size; ++i)
+            column.writable_values()[i] = value;
+        break;
+    }
+    for (size_t i = 0; i < size; ++i)
+        column.writable_nulls()[i] = 0;
+}
+
+class ColumnReference final : public BatchExpression {
+public:
+    explicit ColumnReference(size_t index)
+        : m_index(index)
+    {
+    }
+
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext&) override
+    {
+        return batch.column(m_index);
+    }
+
+private:
+    size_t m_index { 0 };
+};
+
+class Constant final : public BatchExpression {
+public:
+    explicit Constant(Value value)
+        : m_value(move(value))
+    {
+    }
+
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext&) override
+    {
+        // Most batches are full, so the result rarely has to be filled in again.
+        if (!m_is_filled || m_result.size() != batch.row_count()) {
+            fill(m_result, m_value, batch.row_count());
+            m_is_filled = true;
+        }
+        return m_result;
+    }
+
+private:
+    Value m_value;
+    ColumnVector m_result;
+    bool m_is_filled { false };
+};
+
+// Evaluates an expression the slow way, by walking its AST for every row.
+class RowByRow final : public BatchExpression {
+public:
+    explicit RowByRow(const Expression& expression)
+        : m_expression(expression)
+    {
+    }
+
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext& context) override
+    {
+        m_result.resize(Kind::Mixed, batch.row_count());
+        for (size_t i = 0; i < batch.row_count(); ++i) {
+            m_row = batch.row(i);
+            context.set_row(m_row);
+            auto value = m_expression.evaluate(context);
+            m_result.writable_nulls()[i] = value.is_null();
+            m_result.writable_values()[i] = move(value);
+        }
+        return m_result;
+    }
+
+private:
+    const Expression& m_expression;
+    Tuple m_row;
+    ColumnVector m_result;
+};
+
+class UnaryOperation final : public BatchExpression {
+public:
+    UnaryOperation(UnaryOperator type, NonnullOwnPtr<BatchExpression> operand)
+        : m_type(type)
+        , m_operand(move(operand))
+    {
+    }
+
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext& context) override
+    {
+        auto& operand = m_operand->evaluate(batch, context);
+        auto size = operand.size();
+
+        if (m_type == UnaryOperator::Not) {
+            truth_values(operand, m_is_true, m_is_null);
+            m_result.resize(Kind::Integer, size);
+            auto* integers = m_result.writable_integers();
+            auto* nulls = m_result.writable_nulls();
+            for (size_t i = 0; i < size; ++i) {
+                integers[i] = !m_is_true[i] & !m_is_null[i];
+                nulls[i] = m_is_null[i];
+            }
+            return m_result;
+        }
+
+        if (m_type == UnaryOperator::Minus && operand.kind() == Kind::Integer) {
+            // Negating the smallest integer overflows, so that one needs a float.
+            auto* operand_integers = operand.integers();
+            bool overflowed = false;
+            m_result.resize(Kind::Integer, size);
+            auto* integers = m_result.writable_integers();
+            for (size_t i = 0; i < size; ++i) {
+                overflowed |= operand_integers[i] == NumericLimits<i64>::min();
+                integers[i] = -static_cast<u64>(operand_integers[i]);
+            }
+            if (!overflowed) {
+                memcpy(m_result.writable_nulls(), operand.nulls(), size);
+                return m_result;
+            }
+        } else if (m_type == UnaryOperator::Minus && operand.kind() == Kind::Float) {
+            auto* operand_floats = operand.floats();
+            m_result.resize(Kind::Float, size);
+            auto* floats = m_result.writable_floats();
+            for (size_t i = 0; i < size; ++i)
+                floats[i] = -operand_floats[i];
+            memcpy(m_result.writable_nulls(), operand.nulls(), size);
+            return m_result;
+        }
+
+        m_result.resize(Kind::Mixed, size);
+        for (size_t i = 0; i < size; ++i) {
+            auto value = apply_unary_operator(m_type, operand.value_at(i));
+            m_result.writable_nulls()[i] = value.is_null();
+            m_result.writable_values()[i] = move(value);
+        }
+        return m_result;
+    }
+
+private:
+    UnaryOperator m_type;
+    NonnullOwnPtr<BatchExpression> m_operand;
+    Vector<u8> m_is_true;
+    Vector<u8> m_is_null;
+    ColumnVector m_result;
+};
+
+template<typename Lhs, typename Rhs>
+static void compare_numbers(BinaryOperator type, const Lhs* lhs, const Rhs* rhs, size_t size, i64* result)
+{
+    // Integers and floats are compared as floats, like Value::compare() does.
+    using Common = Conditional<IsSame<Lhs, Rhs>, Lhs, double>;
+    auto run = [&](auto compare) {
+        for (size_t i = 0; i < size; ++i)
+            result[i] = compare(static_cast<Common>(lhs[i]), static_cast<Common>(rhs[i]));
+    };
+    switch (type) {
+    case BinaryOperator::LessThan:
+        run([](auto a, auto b) { return a < b; });
+        break;
+    case BinaryOperator::LessThanEquals:
+        run([](auto a, auto b) { return a <= b; });
+        break;
+    case BinaryOperator::GreaterThan:
+        run([](auto a, auto b) { return a > b; });
+        break;
+    case BinaryOperator::GreaterThanEquals:
+        run([](auto a, auto b) { return a >= b; });
+        break;
+    case BinaryOperator::Equals:
+        run([](auto a, auto b) { return a == b; });
+        break;
+    case BinaryOperator::NotEquals:
+        run([](auto a, auto b) { return a != b; });
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+template<typename Lhs, typename Rhs>
+static void compute_floats(BinaryOperator type, const Lhs* lhs, const Rhs* rhs, size_t size, double* result)
+{
+    auto run = [&](auto compute) {
+        for (size_t i = 0; i < size; ++i)
+            result[i] = compute(static_cast<double>(lhs[i]), static_cast<double>(rhs[i]));
+    };
+    switch (type) {
+    case BinaryOperator::Plus:
+        run([](double a, double b) { return a + b; });
+        break;
+    case BinaryOperator::Minus:
+        run([](double a, double b) { return a - b; });
+        break;
+    case BinaryOperator::Multiplication:
+        run([](double a, double b) { return a * b; });
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+// Returns whether any of the results overflowed, in which case none of them can be used.
+static bool compute_integers(BinaryOperator type, const i64* lhs, const i64* rhs, const u8* rhs_nulls, size_t size, i64* result)
+{
+    bool overflowed = false;
+    switch (type) {
+    case BinaryOperator::Plus:
+        for (size_t i = 0; i < size; ++i)
+            overflowed |= __builtin_add_overflow(lhs[i], rhs[i], &result[i]);
+        break;
+    case BinaryOperator::Minus:
+        for (size_t i = 0; i < size; ++i)
+            overflowed |= __builtin_sub_overflow(lhs[i], rhs[i], &result[i]);
+        break;
+    case BinaryOperator::Multiplication:
+        for (size_t i = 0; i < size; ++i)
+            overflowed |= __builtin_mul_overflow(lhs[i], rhs[i], &result[i]);
+        break;
+    case BinaryOperator::Division:
+    case BinaryOperator::Modulo:
+        // Dividing by zero gives NULL, and the smallest integer divided by -1 overflows, so batches that have either
+        // are left to the slow path. NULLs are divided by 1 instead of the 0 they hold.
+        for (size_t i = 0; i < size; ++i)
+            overflowed |= ((rhs[i] == 0) & !rhs_nulls[i]) | ((lhs[i] == NumericLimits<i64>::min()) & (rhs[i] == -1));
+        if (overflowed)
+            break;
+        for (size_t i = 0; i < size; ++i) {
+            auto divisor = rhs[i] | rhs_nulls[i];
+            result[i] = type == BinaryOperator::Division ? lhs[i] / divisor : lhs[i] % divisor;
+        }
+        break;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+    return overflowed;
+}
+
+class BinaryOperation final : public BatchExpression {
+public:
+    BinaryOperation(BinaryOperator type, NonnullOwnPtr<BatchExpression> lhs, NonnullOwnPtr<BatchExpression> rhs)
+        : m_type(type)
+        , m_lhs(move(lhs))
+        , m_rhs(move(rhs))
+    {
+    }
+
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext& context) override
+    {
+        auto& lhs = m_lhs->evaluate(batch, context);
+        auto& rhs = m_rhs->evaluate(batch, context);
+
+        if (m_type == BinaryOperator::And || m_type == BinaryOperator::Or)
+            evaluate_logic(lhs, rhs);
+        else if (!try_evaluate_numbers(lhs, rhs))
+            evaluate_row_by_row(lhs, rhs);
+        return m_result;
+    }
+
+private:
+    void evaluate_logic(const ColumnVector& lhs, const ColumnVector& rhs)
+    {
+        truth_values(lhs, m_lhs_is_true, m_lhs_is_null);
+        truth_values(rhs, m_rhs_is_true, m_rhs_is_null);
+
+        auto size = lhs.size();
+        m_result.resize(Kind::Integer, size);
+        auto* integers = m_result.writable_integers();
+        auto* nulls = m_result.writable_nulls();
+        if (m_type == BinaryOperator::And) {
+            // False if either side is false, otherwise NULL if either side is NULL.
+            for (size_t i = 0; i < size; ++i) {
+                u8 is_false = (!m_lhs_is_true[i] & !m_lhs_is_null[i]) | (!m_rhs_is_true[i] & !m_rhs_is_null[i]);
+                nulls[i] = (!is_false) & (m_lhs_is_null[i] | m_rhs_is_null[i]);
+                integers[i] = (!is_false) & (!nulls[i]);
+            }
+        } else {
+            // True if either side is true, otherwise NULL if either side is NULL.
+            for (size_t i = 0; i < size; ++i) {
+                u8 is_true = m_lhs_is_true[i] | m_rhs_is_true[i];
+                nulls[i] = (!is_true) & (m_lhs_is_null[i] | m_rhs_is_null[i]);
+                integers[i] = is_true;
+            }
+        }
+    }
+
+    bool try_evaluate_numbers(const ColumnVector& lhs, const ColumnVector& rhs)
+    {
+        if (lhs.kind() == Kind::Mixed || rhs.kind() == Kind::Mixed)
+            return false;
+
+        auto size = lhs.size();
+        bool both_integers = lhs.kind() == Kind::Integer && rhs.kind() == Kind::Integer;
+        switch (m_type) {
+        case BinaryOperator::LessThan:
+        case BinaryOperator::LessThanEquals:
+        case BinaryOperator::GreaterThan:
+        case BinaryOperator::GreaterThanEquals:
+        case BinaryOperator::Equals:
+        case BinaryOperator::NotEquals: {
+            m_result.resize(Kind::Integer, size);
+            auto* result = m_result.writable_integers();
+            if (both_integers)
+                compare_numbers(m_type, lhs.integers(), rhs.integers(), size, result);
+            else if (lhs.kind() == Kind::Integer)
+                compare_numbers(m_type, lhs.integers(), rhs.floats(), size, result);
+            else if (rhs.kind() == Kind::Integer)
+                compare_numbers(m_type, lhs.floats(), rhs.integers(), size, result);
+            else
+                compare_numbers(m_type, lhs.floats(), rhs.floats(), size, result);
+            break;
+        }
+        case BinaryOperator::Division:
+        case BinaryOperator::Modulo:
+            // Their float versions have special cases of their own.
+            if (!both_integers)
+                return false;
+            [[fallthrough]];
+        case BinaryOperator::Plus:
+        case BinaryOperator::Minus:
+        case BinaryOperator::Multiplication: {
+            if (both_integers) {
+                m_result.resize(Kind::Integer, size);
+                if (compute_integers(m_type, lhs.integers(), rhs.integers(), rhs.nulls(), size, m_result.writable_integers()))
+                    return false;
+                break;
+            }
+            m_result.resize(Kind::Float, size);
+            auto* result = m_result.writable_floats();
+            if (lhs.kind() == Kind::Integer)
+                compute_floats(m_type, lhs.integers(), rhs.floats(), size, result);
+            else if (rhs.kind() == Kind::Integer)
+                compute_floats(m_type, lhs.floats(), rhs.integers(), size, result);
+            else
+                compute_floats(m_type, lhs.floats(), rhs.floats(), size, result);
+            break;
+        }
+        default:
+            return false;
+        }
+
+        combine_nulls(lhs, rhs, m_result);
+        return true;
+    }
+
+    void evaluate_row_by_row(const ColumnVector& lhs, const ColumnVector& rhs)
+    {
+        auto size = lhs.size();
+        m_result.resize(Kind::Mixed, size);
+        for (size_t i = 0; i < size; ++i) {
+            auto value = apply_binary_operator(m_type, lhs.value_at(i), rhs.value_at(i));
+            m_result.writable_nulls()[i] = value.is_null();
+            m_result.writable_values()[i] = move(value);
+        }
+    }
+
+    BinaryOperator m_type;
+    NonnullOwnPtr<BatchExpression> m_lhs;
+    NonnullOwnPtr<BatchExpression> m_rhs;
+    Vector<u8> m_lhs_is_true;
+    Vector<u8> m_lhs_is_null;
+    Vector<u8> m_rhs_is_true;
+    Vector<u8> m_rhs_is_null;
+    ColumnVector m_result;
+};
+
+class IsNull final : public BatchExpression {
+public:
+    IsNull(NonnullOwnPtr<BatchExpression> operand, bool invert)
+        : m_operand(move(operand))
+        , m_invert(invert)
+    {
+    }
+
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext& context) override
+    {
+        auto& operand = m_operand->evaluate(batch, context);
+        auto size = operand.size();
+        m_result.resize(Kind::Integer, size);
+        auto* integers = m_result.writable_integers();
+        auto* operand_nulls = operand.nulls();
+        for (size_t i = 0; i < size; ++i)
+            integers[i] = operand_nulls[i] ^ m_invert;
+        memset(m_result.writable_nulls(), 0, size);
+        return m_result;
+    }
+
+private:
+    NonnullOwnPtr<BatchExpression> m_operand;
+    bool m_invert { false };
+    ColumnVector m_result;
+};
+
+NonnullOwnPtr<BatchExpression> BatchExpression::compile(const Expression& expression, ExecutionContext& context)
+{
+    if (is<ColumnNameExpression>(expression)) {
+        auto index = context.find_column(static_cast<const ColumnNameExpression&>(expression));
+        if (!index.has_value())
+            return make<Constant>(Value {});
+        return make<ColumnReference>(index.value());
+    }
+
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression) || is<NullLiteral>(expression)) {
+        ExecutionContext literal_context;
+        return make<Constant>(expression.evaluate(literal_context));
+    }
+
+    if (is<UnaryOperatorExpression>(expression)) {
+        auto& unary = static_cast<const UnaryOperatorExpression&>(expression);
+        auto operand = compile(*unary.expression(), context);
+        if (unary.type() == UnaryOperator::Plus)
+            return operand;
+        return make<UnaryOperation>(unary.type(), move(operand));
+    }
+
+    if (is<BinaryOperatorExpression>(expression)) {
+        auto& binary = static_cast<const BinaryOperatorExpression&>(expression);
+        return make<BinaryOperation>(binary.type(), compile(*binary.lhs(), context), compile(*binary.rhs(), context));
+    }
+
+    if (is<NullExpression>(expression)) {
+        auto& null_expression = static_cast<const NullExpression&>(expression);
+        return make<IsNull>(compile(*null_expression.expression(), context), null_expression.invert_expression());
+    }
+
+    if (is<ChainedExpression>(expression)) {
+        auto& expressions = static_cast<const ChainedExpression&>(expression).expressions();
+        if (expressions.size() == 1)
+            return compile(expressions[0], context);
+    }
+
+    // FIXME: Collations don't change anything yet.
+    if (is<CollateExpression>(expression))
+        return compile(*static_cast<const CollateExpression&>(expression).expression(), context);
+
+    return make<RowByRow>(expression);
+}
+
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST.h>
+#include <LibSQL/Batch.h>
+#include <LibSQL/ExecutionContext.h>
+
+namespace SQL {
+
+// An expression compiled into kernels that each evaluate one operation for a whole batch at once, instead of walking
+// the AST for every row. Column names are resolved once, when compiling. Operations that have no kernel, and kernels
+// that run into values they can't handle, like mixed types or an integer overflow, fall back to evaluating the
+// expression row by row.
+class BatchExpression {
+public:
+    // Compiles |expression|, whose column names refer to the columns of |context|. Columns that can't be found are
+    // reported through |context| right away.
+    static NonnullOwnPtr<BatchExpression> compile(const Expression&, ExecutionContext& context);
+
+    virtual ~BatchExpression() = default;
+
+    // Returns the value of the expression for each row of |batch|, which has the columns of |context|. The result
+    // stays valid until the next call, or until |batch| changes.
+    virtual const ColumnVector& evaluate(const Batch& batch, ExecutionContext& context) = 0;
+};
+
+// Puts the index of each row that |condition| is true for into |rows|.
+void select_true_rows(const ColumnVector& condition, Vector<u32>& rows);
+
+}
@@ -0,0 +1,340 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/BufferPool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace SQL {
+
+static constexpr char database_magic[16] = "SerenitySQL DB";
+static constexpr u32 database_version = 1;
+
+Page::Page(BufferPool& pool, size_t frame_index)
+    : m_pool(&pool)
+    , m_frame_index(frame_index)
+{
+    ++m_pool->m_frames[m_frame_index].pin_count;
+}
+
+Page::Page(Page&& other)
+    : m_pool(exchange(other.m_pool, nullptr))
+    , m_frame_index(other.m_frame_index)
+{
+}
+
+Page& Page::operator=(Page&& other)
+{
+    if (this != &other) {
+        if (m_pool)
+            --m_pool->m_frames[m_frame_index].pin_count;
+        m_pool = exchange(other.m_pool, nullptr);
+        m_frame_index = other.m_frame_index;
+    }
+    return *this;
+}
+
+Page::~Page()
+{
+    if (m_pool)
+        --m_pool->m_frames[m_frame_index].pin_count;
+}
+
+PageNumber Page::number() const
+{
+    return m_pool->m_frames[m_frame_index].page_number;
+}
+
+const u8* Page::data() const
+{
+    return m_pool->m_frames[m_frame_index].data;
+}
+
+u8* Page::writable_data()
+{
+    m_pool->make_part_of_transaction(m_frame_index);
+    return m_pool->m_frames[m_frame_index].data;
+}
+
+static bool read_page(int fd, PageNumber page_number, u8* data)
+{
+    size_t nread = 0;
+    while (nread < BufferPool::page_size) {
+        auto rc = pread(fd, data + nread, BufferPool::page_size - nread, (off_t)page_number * BufferPool::page_size + nread);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc < 0)
+            return false;
+        if (rc == 0) {
+            // A page that has never been written back yet is all zeroes.
+            memset(data + nread, 0, BufferPool::page_size - nread);
+            break;
+        }
+        nread += rc;
+    }
+    return true;
+}
+
+Result<NonnullOwnPtr<BufferPool>, String> BufferPool::open(const String& path, size_t frame_count)
+{
+    auto log_or_error = WriteAheadLog::open(String::formatted("{}-wal", path), page_size);
+    if (log_or_error.is_error())
+        return log_or_error.release_error();
+
+    int fd = ::open(path.characters(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return String::formatted("Could not open {}: {}", path, strerror(errno));
+
+    auto pool = adopt_own(*new BufferPool(fd, log_or_error.release_value()));
+    if (auto result = pool->m_log->recover(fd); result.is_error())
+        return result.release_error();
+    if (auto result = pool->add_frames(max(frame_count, (size_t)16)); result.is_error())
+        return result.release_error();
+    if (auto result = pool->initialize_header(); result.is_error())
+        return result.release_error();
+    return pool;
+}
+
+BufferPool::BufferPool(int fd, NonnullOwnPtr<WriteAheadLog> log)
+    : m_fd(fd)
+    , m_log(move(log))
+{
+}
+
+BufferPool::~BufferPool()
+{
+    if (in_transaction())
+        rollback();
+    if (auto result = checkpoint(); result.is_error())
+        warnln("SQL::BufferPool: {}", result.error());
+    for (auto& arena : m_arenas)
+        munmap(arena.data, arena.size);
+    close(m_fd);
+}
+
+Result<void, String> BufferPool::initialize_header()
+{
+    auto page_or_error = get(0);
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto& page = page_or_error.value();
+
+    auto& header = *reinterpret_cast<const DatabaseHeader*>(page.data());
+    if (!memcmp(header.magic, database_magic, sizeof(header.magic))) {
+        if (header.version != database_version || header.page_size != page_size)
+            return String { "Database file has an unsupported format" };
+        return {};
+    }
+
+    for (size_t i = 0; i < page_size; ++i) {
+        if (page.data()[i] != 0)
+            return String { "File is not a database" };
+    }
+
+    auto& new_header = *reinterpret_cast<DatabaseHeader*>(page.writable_data());
+    memcpy(new_header.magic, database_magic, sizeof(new_header.magic));
+    new_header.version = database_version;
+    new_header.page_size = page_size;
+    new_header.page_count = 1;
+    return commit();
+}
+
+Result<void, String> BufferPool::add_frames(size_t count)
+{
+    auto size = count * page_size;
+    auto* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    if (data == MAP_FAILED)
+        return String::formatted("Could not allocate page frames: {}", strerror(errno));
+    m_arenas.append({ data, size });
+    m_frames.ensure_capacity(m_frames.size() + count);
+    for (size_t i = 0; i < count; ++i)
+        m_frames.unchecked_append({ .data = static_cast<u8*>(data) + i * page_size });
+    return {};
+}
+
+Result<void, String> BufferPool::write_back(Frame& frame)
+{
+    VERIFY(!frame.is_in_transaction);
+    if (!frame.is_dirty)
+        return {};
+
+    size_t nwritten = 0;
+    while (nwritten < page_size) {
+        auto rc = pwrite(m_fd, frame.data + nwritten, page_size - nwritten, (off_t)frame.page_number * page_size + nwritten);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0)
+            return String::formatted("Could not write page {}: {}", frame.page_number, strerror(errno));
+        nwritten += rc;
+    }
+    frame.is_dirty = false;
+    return {};
+}
+
+Result<size_t, String> BufferPool::find_frame_to_use()
+{
+    // Two rounds clear all reference bits, so if there's still nothing after that, everything is pinned.
+    for (size_t step = 0; step < m_frames.size() * 2; ++step) {
+        auto index = m_clock_hand;
+        m_clock_hand = (m_clock_hand + 1) % m_frames.size();
+        auto& frame = m_frames[index];
+
+        if (!frame.is_used)
+            return index;
+        if (frame.pin_count > 0 || frame.is_in_transaction)
+            continue;
+        if (frame.is_referenced) {
+            frame.is_referenced = false;
+            continue;
+        }
+
+        if (auto result = write_back(frame); result.is_error())
+            return result.release_error();
+        m_page_table.remove(frame.page_number);
+        frame.is_used = false;
+        return index;
+    }
+
+    // The running transaction has changed more pages than there are frames, so make room for more.
+    auto first_new_frame = m_frames.size();
+    if (auto result = add_frames(m_frames.size()); result.is_error())
+        return result.release_error();
+    return first_new_frame;
+}
+
+Result<Page, String> BufferPool::get(PageNumber page_number)
+{
+    if (auto index = m_page_table.get(page_number); index.has_value()) {
+        m_frames[index.value()].is_referenced = true;
+        return Page(*this, index.value());
+    }
+
+    auto index_or_error = find_frame_to_use();
+    if (index_or_error.is_error())
+        return index_or_error.release_error();
+    auto index = index_or_error.value();
+
+    auto& frame = m_frames[index];
+    if (!read_page(m_fd, page_number, frame.data))
+        return String::formatted("Could not read page {}: {}", page_number, strerror(errno));
+    frame.page_number = page_number;
+    frame.is_used = true;
+    frame.is_referenced = true;
+    frame.is_dirty = false;
+    m_page_table.set(page_number, index);
+    return Page(*this, index);
+}
+
+void BufferPool::make_part_of_transaction(size_t frame_index)
+{
+    auto& frame = m_frames[frame_index];
+    if (frame.is_in_transaction)
+        return;
+    m_before_images.set(frame.page_number, { ByteBuffer::copy(frame.data, page_size), frame.is_dirty });
+    frame.is_in_transaction = true;
+    frame.is_dirty = true;
+}
+
+Result<Page, String> BufferPool::allocate()
+{
+    auto header_page_or_error = get(0);
+    if (header_page_or_error.is_error())
+        return header_page_or_error.release_error();
+    auto& header_page = header_page_or_error.value();
+    auto& header = *reinterpret_cast<DatabaseHeader*>(header_page.writable_data());
+
+    PageNumber page_number;
+    if (header.free_list != 0) {
+        // A free page starts with the number of the next one.
+        page_number = header.free_list;
+        auto free_page_or_error = get(page_number);
+        if (free_page_or_error.is_error())
+            return free_page_or_error.release_error();
+        memcpy(&header.free_list, free_page_or_error.value().data(), sizeof(header.free_list));
+    } else {
+        page_number = header.page_count++;
+    }
+
+    auto page_or_error = get(page_number);
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    memset(page_or_error.value().writable_data(), 0, page_size);
+    return page_or_error.release_value();
+}
+
+Result<void, String> BufferPool::free(PageNumber page_number)
+{
+    VERIFY(page_number != 0);
+    auto header_page_or_error = get(0);
+    if (header_page_or_error.is_error())
+        return header_page_or_error.release_error();
+    auto& header = *reinterpret_cast<DatabaseHeader*>(header_page_or_error.value().writable_data());
+
+    auto page_or_error = get(page_number);
+    if (page_or_error.is_error())
+        return page_or_error.release_error();
+    auto* data = page_or_error.value().writable_data();
+    memset(data, 0, page_size);
+    memcpy(data, &header.free_list, sizeof(header.free_list));
+    header.free_list = page_number;
+    return {};
+}
+
+Result<void, String> BufferPool::commit()
+{
+    if (!in_transaction())
+        return {};
+
+    Vector<WriteAheadLog::PageImage> pages;
+    for (auto& it : m_before_images) {
+        auto& frame = m_frames[m_page_table.get(it.key).value()];
+        pages.append({ frame.page_number, { frame.data, page_size } });
+    }
+    if (auto result = m_log->append_transaction(pages); result.is_error())
+        return result.release_error();
+
+    // The pages stay dirty, but now that they're in the log, they may be written back.
+    for (auto& it : m_before_images)
+        m_frames[m_page_table.get(it.key).value()].is_in_transaction = false;
+    m_before_images.clear();
+
+    if (m_log->size() >= checkpoint_log_size)
+        return checkpoint();
+    return {};
+}
+
+void BufferPool::rollback()
+{
+    for (auto& it : m_before_images) {
+        auto& frame = m_frames[m_page_table.get(it.key).value()];
+        memcpy(frame.data, it.value.data.data(), page_size);
+        frame.is_dirty = it.value.was_dirty;
+        frame.is_in_transaction = false;
+    }
+    m_before_images.clear();
+}
+
+Result<void, String> BufferPool::checkpoint()
+{
+    VERIFY(!in_transaction());
+    if (m_log->size() == 0)
+        return {};
+
+    for (auto& frame : m_frames) {
+        if (!frame.is_used)
+            continue;
+        if (auto result = write_back(frame); result.is_error())
+            return result.release_error();
+    }
+    if (fsync(m_fd) < 0)
+        return String::formatted("Could not sync the database: {}", strerror(errno));
+    return m_log->reset();
+}
+
+}
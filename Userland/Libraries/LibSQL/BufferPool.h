@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/HashMap.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/WriteAheadLog.h>
+
+namespace SQL {
+
+using PageNumber = u32;
+
+class BufferPool;
+
+// A page that's pinned in the buffer pool for as long as this is around.
+class Page {
+    AK_MAKE_NONCOPYABLE(Page);
+
+public:
+    Page(Page&&);
+    Page& operator=(Page&&);
+    ~Page();
+
+    PageNumber number() const;
+    const u8* data() const;
+    // Makes the page part of the running transaction. This has to be called before the page is changed.
+    u8* writable_data();
+
+private:
+    friend class BufferPool;
+    Page(BufferPool&, size_t frame_index);
+
+    BufferPool* m_pool { nullptr };
+    size_t m_frame_index { 0 };
+};
+
+// Page 0 of the database file starts with this.
+struct [[gnu::packed]] DatabaseHeader {
+    char magic[16];
+    u32 version;
+    u32 page_size;
+    u32 page_count;
+    u32 free_list;
+    u32 catalog_root;
+};
+
+// Keeps recently used pages of the database file in memory, in frames that are handed out by a clock sweep: every
+// frame has a reference bit that's set whenever its page is used, and the clock hand clears those bits as it goes
+// round, evicting the first unpinned page it finds whose bit was already clear.
+//
+// Changes are made in transactions. The pages that the running transaction changes are kept in memory until it
+// commits, at which point they go to the write-ahead log, and only after that back to the database file, whenever
+// they're evicted or the log is checkpointed. This way the database file only ever contains committed data, and
+// rolling back is just a matter of restoring the pages from the copies that were made before they were changed.
+class BufferPool {
+    AK_MAKE_NONCOPYABLE(BufferPool);
+    AK_MAKE_NONMOVABLE(BufferPool);
+
+public:
+    static constexpr size_t page_size = 4096;
+    static constexpr size_t default_frame_count = 1024;
+    // Once the log has grown this large, committing a transaction also checkpoints it.
+    static constexpr size_t checkpoint_log_size = 4 * MiB;
+
+    // Replays whatever is left in the log of a previous run first, and initializes the file if it's new.
+    static Result<NonnullOwnPtr<BufferPool>, String> open(const String& path, size_t frame_count = default_frame_count);
+    ~BufferPool();
+
+    Result<Page, String> get(PageNumber);
+    // Hands out a zeroed page, reusing freed ones first.
+    Result<Page, String> allocate();
+    Result<void, String> free(PageNumber);
+
+    bool in_transaction() const { return !m_before_images.is_empty(); }
+    Result<void, String> commit();
+    void rollback();
+
+    // Writes all committed pages back to the database file, and empties the log.
+    Result<void, String> checkpoint();
+
+private:
+    friend class Page;
+
+    struct Frame {
+        u8* data { nullptr };
+        PageNumber page_number { 0 };
+        u32 pin_count { 0 };
+        bool is_used { false };
+        bool is_referenced { false };
+        bool is_dirty { false };
+        bool is_in_transaction { false };
+    };
+
+    struct BeforeImage {
+        ByteBuffer data;
+        bool was_dirty { false };
+    };
+
+    BufferPool(int fd, NonnullOwnPtr<WriteAheadLog>);
+
+    Result<void, String> add_frames(size_t count);
+    Result<size_t, String> find_frame_to_use();
+    Result<void, String> write_back(Frame&);
+    void make_part_of_transaction(size_t frame_index);
+    Result<void, String> initialize_header();
+
+    int m_fd { -1 };
+    NonnullOwnPtr<WriteAheadLog> m_log;
+
+    // The frames live in anonymous mappings, which are only added to when the running transaction has pinned
+    // all the ones that are already there.
+    struct Arena {
+        void* data;
+        size_t size;
+    };
+    Vector<Arena> m_arenas;
+    Vector<Frame> m_frames;
+    size_t m_clock_hand { 0 };
+    HashMap<PageNumber, size_t> m_page_table;
+
+    // The pages that the running transaction changed, as they were before it did.
+    HashMap<PageNumber, BeforeImage> m_before_images;
+};
+
+}
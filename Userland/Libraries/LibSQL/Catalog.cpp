@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/Catalog.h>
+#include <string.h>
+
+namespace SQL {
+
+Optional<size_t> TableInfo::column_index(const StringView& column_name) const
+{
+    for (size_t i = 0; i < columns.size(); ++i) {
+        if (columns[i].name.equals_ignoring_case(column_name))
+            return i;
+    }
+    return {};
+}
+
+Vector<u8> encode_row_key(i64 rowid)
+{
+    Vector<u8> key;
+    Value(rowid).encode_key(key);
+    return key;
+}
+
+Vector<u8> encode_index_key_prefix(const IndexInfo& index, const Tuple& row)
+{
+    Vector<u8> key;
+    for (auto column_index : index.column_indices)
+        row[column_index].encode_key(key);
+    return key;
+}
+
+Vector<u8> encode_index_key(const IndexInfo& index, const Tuple& row, i64 rowid)
+{
+    auto key = encode_index_key_prefix(index, row);
+    Value(rowid).encode_key(key);
+    return key;
+}
+
+int compare_key_prefix(ReadonlyBytes key, ReadonlyBytes prefix)
+{
+    if (auto common_size = min(key.size(), prefix.size()); common_size > 0) {
+        if (auto result = memcmp(key.data(), prefix.data(), common_size); result != 0)
+            return result;
+    }
+    return key.size() < prefix.size() ? -1 : 0;
+}
+
+// A table is stored as a tuple of its name, root, next rowid, row count and columns, followed by its indexes.
+static Vector<u8> serialize_table(const TableInfo& table)
+{
+    Tuple tuple;
+    tuple.append(Value(table.name));
+    tuple.append(Value(static_cast<i64>(table.root)));
+    tuple.append(Value(table.next_rowid));
+    tuple.append(Value(table.row_count));
+    tuple.append(Value(static_cast<i64>(table.columns.size())));
+    for (auto& column : table.columns) {
+        tuple.append(Value(column.name));
+        tuple.append(Value(column.type_name));
+    }
+    tuple.append(Value(static_cast<i64>(table.indexes.size())));
+    for (auto& index : table.indexes) {
+        tuple.append(Value(index.name));
+        tuple.append(Value(static_cast<i64>(index.is_unique)));
+        tuple.append(Value(static_cast<i64>(index.root)));
+        tuple.append(Value(index.rows_per_key));
+        tuple.append(Value(static_cast<i64>(index.column_indices.size())));
+        for (auto column_index : index.column_indices)
+            tuple.append(Value(static_cast<i64>(column_index)));
+    }
+
+    Vector<u8> bytes;
+    serialize_tuple(tuple, bytes);
+    return bytes;
+}
+
+static Optional<TableInfo> deserialize_table(ReadonlyBytes bytes)
+{
+    auto tuple = deserialize_tuple(bytes);
+    if (!tuple.has_value())
+        return {};
+
+    size_t next_value = 0;
+    auto text = [&]() -> Optional<String> {
+        if (next_value == tuple->size() || tuple->at(next_value).type() != ValueType::Text)
+            return {};
+        return tuple->at(next_value++).as_text();
+    };
+    auto integer = [&]() -> Optional<i64> {
+        if (next_value == tuple->size() || tuple->at(next_value).type() != ValueType::Integer)
+            return {};
+        return tuple->at(next_value++).as_integer();
+    };
+
+    TableInfo table;
+    auto name = text();
+    auto root = integer();
+    auto next_rowid = integer();
+    auto row_count = integer();
+    auto column_count = integer();
+    if (!name.has_value() || !root.has_value() || !next_rowid.has_value() || !row_count.has_value() || !column_count.has_value())
+        return {};
+    table.name = name.release_value();
+    table.root = root.value();
+    table.next_rowid = next_rowid.value();
+    table.row_count = row_count.value();
+
+    for (i64 i = 0; i < column_count.value(); ++i) {
+        auto column_name = text();
+        auto type_name = text();
+        if (!column_name.has_value() || !type_name.has_value())
+            return {};
+        auto affinity = affinity_for_type_name(type_name.value());
+        table.columns.append({ column_name.release_value(), type_name.release_value(), affinity });
+    }
+
+    auto index_count = integer();
+    if (!index_count.has_value())
+        return {};
+    for (i64 i = 0; i < index_count.value(); ++i) {
+        IndexInfo index;
+        auto index_name = text();
+        auto is_unique = integer();
+        auto index_root = integer();
+        auto rows_per_key = integer();
+        auto index_column_count = integer();
+        if (!index_name.has_value() || !is_unique.has_value() || !index_root.has_value() || !rows_per_key.has_value() || !index_column_count.has_value())
+            return {};
+        index.name = index_name.release_value();
+        index.is_unique = is_unique.value();
+        index.root = index_root.value();
+        index.rows_per_key = rows_per_key.value();
+        for (i64 j = 0; j < index_column_count.value(); ++j) {
+            auto column_index = integer();
+            if (!column_index.has_value() || column_index.value() < 0 || column_index.value() >= column_count.value())
+                return {};
+            index.column_indices.append(column_index.value());
+        }
+        table.indexes.append(move(index));
+    }
+    return table;
+}
+
+Result<Catalog, String> Catalog::open(BufferPool& pool)
+{
+    auto header_page_or_error = pool.get(0);
+    if (header_page_or_error.is_error())
+        return header_page_or_error.release_error();
+    auto& header_page = header_page_or_error.value();
+    auto root = reinterpret_cast<const DatabaseHeader*>(header_page.data())->catalog_root;
+    if (root != 0)
+        return Catalog(pool, root);
+
+    auto root_or_error = BTree::create(pool);
+    if (root_or_error.is_error()) {
+        pool.rollback();
+        return root_or_error.release_error();
+    }
+    reinterpret_cast<DatabaseHeader*>(header_page.writable_data())->catalog_root = root_or_error.value();
+    if (auto result = pool.commit(); result.is_error()) {
+        pool.rollback();
+        return result.release_error();
+    }
+    return Catalog(pool, root_or_error.value());
+}
+
+Result<Optional<TableInfo>, String> Catalog::find_table(const StringView& name)
+{
+    auto key = name.to_string().to_lowercase();
+    auto value_or_error = m_tree.find(key.bytes());
+    if (value_or_error.is_error())
+        return value_or_error.release_error();
+    if (!value_or_error.value().has_value())
+        return Optional<TableInfo> {};
+
+    auto table = deserialize_table(value_or_error.value().value());
+    if (!table.has_value())
+        return String::formatted("The catalog entry of table {} is corrupt", name);
+    return table;
+}
+
+Result<Vector<TableInfo>, String> Catalog::tables()
+{
+    auto cursor_or_error = m_tree.seek({});
+    if (cursor_or_error.is_error())
+        return cursor_or_error.release_error();
+    auto& cursor = cursor_or_error.value();
+
+    Vector<TableInfo> tables;
+    while (!cursor.is_end()) {
+        auto value_or_error = cursor.value();
+        if (value_or_error.is_error())
+            return value_or_error.release_error();
+        auto table = deserialize_table(value_or_error.value());
+        if (!table.has_value())
+            return String { "The catalog is corrupt" };
+        tables.append(table.release_value());
+        if (auto result = cursor.next(); result.is_error())
+            return result.release_error();
+    }
+    return tables;
+}
+
+Result<void, String> Catalog::store_table(const TableInfo& table)
+{
+    auto bytes = serialize_table(table);
+    auto key = table.name.to_lowercase();
+    return m_tree.insert(key.bytes(), bytes.span());
+}
+
+Result<void, String> Catalog::remove_table(const StringView& name)
+{
+    auto key = name.to_string().to_lowercase();
+    auto removed_or_error = m_tree.remove(key.bytes());
+    if (removed_or_error.is_error())
+        return removed_or_error.release_error();
+    return {};
+}
+
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/Value.h>
+
+namespace SQL {
+
+struct ColumnInfo {
+    String name;
+    String type_name;
+    Affinity affinity { Affinity::None };
+};
+
+struct IndexInfo {
+    String name;
+    Vector<size_t> column_indices;
+    bool is_unique { false };
+    PageNumber root { 0 };
+    // How many rows share a value of the first indexed column on average, as of when the index was created.
+    i64 rows_per_key { 1 };
+};
+
+// A table is a B+tree that maps the rowid of every row to its values, followed by the rowid. Each of its indexes is a
+// B+tree that maps the indexed values of every row, followed by the rowid, to that rowid.
+struct TableInfo {
+    String name;
+    Vector<ColumnInfo> columns;
+    PageNumber root { 0 };
+    i64 next_rowid { 1 };
+    i64 row_count { 0 };
+    Vector<IndexInfo> indexes;
+
+    Optional<size_t> column_index(const StringView& column_name) const;
+};
+
+Vector<u8> encode_row_key(i64 rowid);
+Vector<u8> encode_index_key_prefix(const IndexInfo&, const Tuple& row);
+// Appending the rowid makes the keys of rows with the same values unique.
+Vector<u8> encode_index_key(const IndexInfo&, const Tuple& row, i64 rowid);
+// Compares the start of |key| to |prefix|. Encoded values are never a prefix of one another, so if the start of
+// |key| is equal to |prefix|, the values it starts with are equal to those in |prefix|.
+int compare_key_prefix(ReadonlyBytes key, ReadonlyBytes prefix);
+
+// Keeps the schema of every table in a B+tree of its own, whose root is in the database header. Table names are
+// case-insensitive, just like all other names.
+class Catalog {
+public:
+    // Creates the catalog if the database doesn't have one yet.
+    static Result<Catalog, String> open(BufferPool&);
+
+    Result<Optional<TableInfo>, String> find_table(const StringView& name);
+    Result<Vector<TableInfo>, String> tables();
+    // Adds the table, or replaces it if there already is one with the same name.
+    Result<void, String> store_table(const TableInfo&);
+    Result<void, String> remove_table(const StringView& name);
+
+private:
+    Catalog(BufferPool& pool, PageNumber root)
+        : m_tree(pool, root)
+    {
+    }
+
+    BTree m_tree;
+};
+
+}
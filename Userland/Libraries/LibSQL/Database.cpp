@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TypeCasts.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Parser.h>
+
+namespace SQL {
+
+Result<NonnullOwnPtr<Database>, String> Database::open(const String& path)
+{
+    auto pool_or_error = BufferPool::open(path);
+    if (pool_or_error.is_error())
+        return pool_or_error.release_error();
+    auto pool = pool_or_error.release_value();
+
+    auto catalog_or_error = Catalog::open(*pool);
+    if (catalog_or_error.is_error())
+        return catalog_or_error.release_error();
+    return adopt_own(*new Database(move(pool), catalog_or_error.release_value()));
+}
+
+Result<ResultSet, String> Database::execute(const StringView& sql)
+{
+    Parser parser { Lexer(sql) };
+    auto statement = parser.next_statement();
+    if (parser.has_errors())
+        return parser.errors()[0].to_string();
+    return execute(statement);
+}
+
+Result<ResultSet, String> Database::execute(const Statement& statement)
+{
+    if (is<BeginTransaction>(statement)) {
+        if (m_in_explicit_transaction)
+            return String { "Cannot start a transaction within a transaction" };
+        m_in_explicit_transaction = true;
+        return ResultSet {};
+    }
+    if (is<CommitTransaction>(statement)) {
+        if (!m_in_explicit_transaction)
+            return String { "Cannot commit - no transaction is active" };
+        m_in_explicit_transaction = false;
+        if (auto result = m_pool->commit(); result.is_error()) {
+            m_pool->rollback();
+            return result.release_error();
+        }
+        return ResultSet {};
+    }
+    if (is<RollbackTransaction>(statement)) {
+        if (!m_in_explicit_transaction)
+            return String { "Cannot roll back - no transaction is active" };
+        m_in_explicit_transaction = false;
+        m_pool->rollback();
+        return ResultSet {};
+    }
+
+    Executor executor(*m_pool, m_catalog);
+    auto result_or_error = executor.execute(statement);
+
+    // A statement that fails halfway through may have changed some pages already. Since there are no savepoints,
+    // the only way to undo that is to roll back the whole transaction.
+    if (result_or_error.is_error()) {
+        m_pool->rollback();
+        if (!m_in_explicit_transaction)
+            return result_or_error.release_error();
+        m_in_explicit_transaction = false;
+        return String::formatted("{} (the transaction has been rolled back)", result_or_error.error());
+    }
+
+    if (!m_in_explicit_transaction) {
+        if (auto result = m_pool->commit(); result.is_error()) {
+            m_pool->rollback();
+            return result.release_error();
+        }
+    }
+    return result_or_error.release_value();
+}
+
+}
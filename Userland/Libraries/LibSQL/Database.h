@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/StringView.h>
+#include <LibSQL/BufferPool.h>
+#include <LibSQL/Catalog.h>
+#include <LibSQL/Executor.h>
+
+namespace SQL {
+
+// A database file, along with its write-ahead log next to it. Every statement runs in a transaction of its own,
+// unless it's between BEGIN and COMMIT or ROLLBACK.
+class Database {
+    AK_MAKE_NONCOPYABLE(Database);
+    AK_MAKE_NONMOVABLE(Database);
+
+public:
+    // Creates the database if there's no file at |path| yet.
+    static Result<NonnullOwnPtr<Database>, String> open(const String& path);
+
+    // Runs the first statement in |sql|.
+    Result<ResultSet, String> execute(const StringView& sql);
+    Result<ResultSet, String> execute(const Statement&);
+
+    bool in_explicit_transaction() const { return m_in_explicit_transaction; }
+
+private:
+    Database(NonnullOwnPtr<BufferPool> pool, Catalog catalog)
+        : m_pool(move(pool))
+        , m_catalog(move(catalog))
+    {
+    }
+
+    NonnullOwnPtr<BufferPool> m_pool;
+    Catalog m_catalog;
+    bool m_in_explicit_transaction { false };
+};
+
+}
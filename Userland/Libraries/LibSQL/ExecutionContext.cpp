@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibSQL/AST.h>
+#include <LibSQL/ExecutionContext.h>
+
+namespace SQL {
+
+static String qualified_column_name(const ColumnNameExpression& expression)
+{
+    if (expression.table_name().is_empty())
+        return expression.column_name();
+    return String::formatted("{}.{}", expression.table_name(), expression.column_name());
+}
+
+Optional<size_t> ExecutionContext::find_column(const ColumnNameExpression& expression)
+{
+    // A table may well have a column that's called like one of the hidden ones, in which case that's the one.
+    Optional<size_t> found_column;
+    Optional<size_t> found_hidden_column;
+    size_t match_count = 0;
+    size_t hidden_match_count = 0;
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+        auto& column = m_columns[i];
+        if (!column.column_name.equals_ignoring_case(expression.column_name()))
+            continue;
+        if (!expression.table_name().is_empty() && !column.table_name.equals_ignoring_case(expression.table_name()))
+            continue;
+        if (column.is_hidden) {
+            found_hidden_column = i;
+            ++hidden_match_count;
+        } else {
+            found_column = i;
+            ++match_count;
+        }
+    }
+
+    if (match_count > 1 || (match_count == 0 && hidden_match_count > 1)) {
+        set_error(String::formatted("Ambiguous column name: {}", qualified_column_name(expression)));
+        return {};
+    }
+    if (found_column.has_value())
+        return found_column;
+    if (found_hidden_column.has_value())
+        return found_hidden_column;
+    set_error(String::formatted("No such column: {}", qualified_column_name(expression)));
+    return {};
+}
+
+Value ExecutionContext::column_value(const ColumnNameExpression& expression)
+{
+    auto index = m_resolved_columns.get(&expression);
+    if (!index.has_value()) {
+        index = find_column(expression);
+        if (!index.has_value())
+            return {};
+        m_resolved_columns.set(&expression, index.value());
+    }
+    VERIFY(m_row);
+    return (*m_row)[index.value()];
+}
+
+void ExecutionContext::set_error(String error)
+{
+    if (m_error.is_null())
+        m_error = move(error);
+}
+
+}
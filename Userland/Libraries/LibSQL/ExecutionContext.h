@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/Forward.h>
+#include <LibSQL/Value.h>
+
+namespace SQL {
+
+// A column of the rows that expressions are evaluated against.
+struct ColumnBinding {
+    // The alias of the table the column comes from, or its name if it has none.
+    String table_name;
+    String column_name;
+    // Hidden columns, like the rowid of a table, are left out of "SELECT *", but can still be named.
+    bool is_hidden { false };
+};
+
+// What expressions are evaluated against: the current row, and what its columns are called.
+class ExecutionContext {
+public:
+    ExecutionContext() = default;
+
+    explicit ExecutionContext(Vector<ColumnBinding> columns)
+        : m_columns(move(columns))
+    {
+    }
+
+    const Vector<ColumnBinding>& columns() const { return m_columns; }
+    void set_row(const Tuple& row) { m_row = &row; }
+
+    // Returns the index of the column that |expression| names, or reports an error if there isn't exactly one.
+    Optional<size_t> find_column(const ColumnNameExpression& expression);
+    Value column_value(const ColumnNameExpression& expression);
+
+    bool has_error() const { return !m_error.is_null(); }
+    const String& error() const { return m_error; }
+    // Only the first error is kept, since any that follow are most likely caused by it.
+    void set_error(String error);
+
+private:
+    Vector<ColumnBinding> m_columns;
+    const Tuple* m_row { nullptr };
+    HashMap<const ColumnNameExpression*, size_t> m_resolved_columns;
+    String m_error;
+};
+
+}
@@ -0,0 +1,519 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashTable.h>
+#include <AK/TypeCasts.h>
+#include <LibSQL/Executor.h>
+#include <LibSQL/Planner.h>
+
+namespace SQL {
+
+Result<ResultSet, String> Executor::execute(const Statement& statement)
+{
+    if (is<CreateTable>(statement))
+        return execute_create_table(static_cast<const CreateTable&>(statement));
+    if (is<DropTable>(statement))
+        return execute_drop_table(static_cast<const DropTable&>(statement));
+    if (is<CreateIndex>(statement))
+        return execute_create_index(static_cast<const CreateIndex&>(statement));
+    if (is<DropIndex>(statement))
+        return execute_drop_index(static_cast<const DropIndex&>(statement));
+    if (is<Insert>(statement))
+        return execute_insert(static_cast<const Insert&>(statement));
+    if (is<Update>(statement))
+        return execute_update(static_cast<const Update&>(statement));
+    if (is<Delete>(statement))
+        return execute_delete(static_cast<const Delete&>(statement));
+    if (is<Select>(statement))
+        return execute_select(static_cast<const Select&>(statement));
+    return String { "Statement is not supported" };
+}
+
+Result<TableInfo, String> Executor::find_table(const String& name)
+{
+    auto table_or_error = m_catalog.find_table(name);
+    if (table_or_error.is_error())
+        return table_or_error.release_error();
+    if (!table_or_error.value().has_value())
+        return String::formatted("No such table: {}", name);
+    return table_or_error.value().release_value();
+}
+
+static Result<Vector<Tuple>, String> read_all_rows(Operator& plan)
+{
+    Vector<Tuple> rows;
+    Batch batch;
+    for (;;) {
+        auto has_batch_or_error = plan.next_batch(batch);
+        if (has_batch_or_error.is_error())
+            return has_batch_or_error.release_error();
+        if (!has_batch_or_error.value())
+            return rows;
+        for (size_t i = 0; i < batch.row_count(); ++i)
+            rows.append(batch.row(i));
+    }
+}
+
+Result<Vector<Tuple>, String> Executor::collect_rows(const TableInfo& table, const String& alias, const RefPtr<Expression>& where_clause)
+{
+    Planner planner(m_pool);
+    auto plan_or_error = planner.plan({ TableReference { table, alias } }, where_clause);
+    if (plan_or_error.is_error())
+        return plan_or_error.release_error();
+    return read_all_rows(*plan_or_error.value());
+}
+
+Result<void, String> Executor::insert_index_entry(const TableInfo& table, const IndexInfo& index, const Tuple& row, i64 rowid)
+{
+    BTree tree(m_pool, index.root);
+
+    // NULLs are never equal to one another, so rows with a NULL in any indexed column can't violate uniqueness.
+    bool has_null = false;
+    for (auto column_index : index.column_indices)
+        has_null |= row[column_index].is_null();
+
+    if (index.is_unique && !has_null) {
+        auto prefix = encode_index_key_prefix(index, row);
+        auto cursor_or_error = tree.seek(prefix);
+        if (cursor_or_error.is_error())
+            return cursor_or_error.release_error();
+        auto& cursor = cursor_or_error.value();
+        if (!cursor.is_end() && compare_key_prefix(cursor.key(), prefix) == 0) {
+            StringBuilder builder;
+            builder.append("UNIQUE constraint failed: ");
+            for (size_t i = 0; i < index.column_indices.size(); ++i) {
+                if (i > 0)
+                    builder.append(", ");
+                builder.appendff("{}.{}", table.name, table.columns[index.column_indices[i]].name);
+            }
+            return builder.to_string();
+        }
+    }
+
+    auto key = encode_index_key(index, row, rowid);
+    return tree.insert(key, { reinterpret_cast<const u8*>(&rowid), sizeof(rowid) });
+}
+
+Result<void, String> Executor::remove_index_entries(const TableInfo& table, const Tuple& row, i64 rowid)
+{
+    for (auto& index : table.indexes) {
+        BTree tree(m_pool, index.root);
+        auto key = encode_index_key(index, row, rowid);
+        if (auto result = tree.remove(key); result.is_error())
+            return result.release_error();
+    }
+    return {};
+}
+
+Result<void, String> Executor::insert_row(const TableInfo& table, const Tuple& row, i64 rowid)
+{
+    // The indexes go first, so that a row that violates a unique index is never stored.
+    for (auto& index : table.indexes) {
+        if (auto result = insert_index_entry(table, index, row, rowid); result.is_error())
+            return result.release_error();
+    }
+
+    Tuple stored_row = row;
+    stored_row.append(Value(rowid));
+    Vector<u8> bytes;
+    serialize_tuple(stored_row, bytes);
+    BTree tree(m_pool, table.root);
+    return tree.insert(encode_row_key(rowid), bytes);
+}
+
+Result<ResultSet, String> Executor::execute_create_table(const CreateTable& statement)
+{
+    if (statement.is_temporary())
+        return String { "Temporary tables are not supported" };
+
+    auto existing_table_or_error = m_catalog.find_table(statement.table_name());
+    if (existing_table_or_error.is_error())
+        return existing_table_or_error.release_error();
+    if (existing_table_or_error.value().has_value()) {
+        if (!statement.is_error_if_table_exists())
+            return ResultSet {};
+        return String::formatted("Table {} already exists", statement.table_name());
+    }
+
+    TableInfo table;
+    table.name = statement.table_name();
+    for (auto& column : statement.columns()) {
+        if (table.column_index(column.name()).has_value())
+            return String::formatted("Duplicate column name: {}", column.name());
+        auto& type_name = column.type_name()->name();
+        table.columns.append({ column.name(), type_name, affinity_for_type_name(type_name) });
+    }
+
+    auto root_or_error = BTree::create(m_pool);
+    if (root_or_error.is_error())
+        return root_or_error.release_error();
+    table.root = root_or_error.value();
+    if (auto result = m_catalog.store_table(table); result.is_error())
+        return result.release_error();
+    return ResultSet {};
+}
+
+Result<ResultSet, String> Executor::execute_drop_table(const DropTable& statement)
+{
+    auto table_or_error = m_catalog.find_table(statement.table_name());
+    if (table_or_error.is_error())
+        return table_or_error.release_error();
+    if (!table_or_error.value().has_value()) {
+        if (!statement.is_error_if_table_does_not_exist())
+            return ResultSet {};
+        return String::formatted("No such table: {}", statement.table_name());
+    }
+    auto& table = table_or_error.value().value();
+
+    for (auto& index : table.indexes) {
+        BTree tree(m_pool, index.root);
+        if (auto result = tree.destroy(); result.is_error())
+            return result.release_error();
+    }
+    BTree tree(m_pool, table.root);
+    if (auto result = tree.destroy(); result.is_error())
+        return result.release_error();
+    if (auto result = m_catalog.remove_table(table.name); result.is_error())
+        return result.release_error();
+    return ResultSet {};
+}
+
+Result<ResultSet, String> Executor::execute_create_index(const CreateIndex& statement)
+{
+    auto tables_or_error = m_catalog.tables();
+    if (tables_or_error.is_error())
+        return tables_or_error.release_error();
+    for (auto& table : tables_or_error.value()) {
+        for (auto& index : table.indexes) {
+            if (!index.name.equals_ignoring_case(statement.index_name()))
+                continue;
+            if (!statement.is_error_if_index_exists())
+                return ResultSet {};
+            return String::formatted("Index {} already exists", statement.index_name());
+        }
+    }
+
+    auto table_or_error = find_table(statement.table_name());
+    if (table_or_error.is_error())
+        return table_or_error.release_error();
+    auto table = table_or_error.release_value();
+
+    IndexInfo index;
+    index.name = statement.index_name();
+    index.is_unique = statement.is_unique();
+    for (auto& column_name : statement.column_names()) {
+        auto column_index = table.column_index(column_name);
+        if (!column_index.has_value())
+            return String::formatted("No such column: {}", column_name);
+        index.column_indices.append(column_index.value());
+    }
+
+    auto root_or_error = BTree::create(m_pool);
+    if (root_or_error.is_error())
+        return root_or_error.release_error();
+    index.root = root_or_error.value();
+
+    // Index the rows that are already there, counting the values of the first column on the way, for the planner.
+    auto rows_or_error = collect_rows(table, {}, {});
+    if (rows_or_error.is_error())
+        return rows_or_error.release_error();
+    HashTable<String> distinct_values;
+    for (auto& row : rows_or_error.value()) {
+        auto rowid = row.last().as_integer();
+        if (auto result = insert_index_entry(table, index, row, rowid); result.is_error())
+            return result.release_error();
+        Vector<u8> key;
+        row[index.column_indices.first()].encode_key(key);
+        distinct_values.set(String(reinterpret_cast<const char*>(key.data()), key.size()));
+    }
+    if (!distinct_values.is_empty())
+        index.rows_per_key = max<i64>(1, rows_or_error.value().size() / distinct_values.size());
+
+    table.indexes.append(move(index));
+    if (auto result = m_catalog.store_table(table); result.is_error())
+        return result.release_error();
+    return ResultSet {};
+}
+
+Result<ResultSet, String> Executor::execute_drop_index(const DropIndex& statement)
+{
+    auto tables_or_error = m_catalog.tables();
+    if (tables_or_error.is_error())
+        return tables_or_error.release_error();
+    for (auto& table : tables_or_error.value()) {
+        for (size_t i = 0; i < table.indexes.size(); ++i) {
+            if (!table.indexes[i].name.equals_ignoring_case(statement.index_name()))
+                continue;
+            BTree tree(m_pool, table.indexes[i].root);
+            if (auto result = tree.destroy(); result.is_error())
+                return result.release_error();
+            table.indexes.remove(i);
+            if (auto result = m_catalog.store_table(table); result.is_error())
+                return result.release_error();
+            return ResultSet {};
+        }
+    }
+    if (!statement.is_error_if_index_does_not_exist())
+        return ResultSet {};
+    return String::formatted("No such index: {}", statement.index_name());
+}
+
+Result<ResultSet, String> Executor::execute_insert(const Insert& statement)
+{
+    if (!statement.common_table_expression_list().is_null())
+        return String { "WITH is not supported" };
+
+    auto table_or_error = find_table(statement.table_name());
+    if (table_or_error.is_error())
+        return table_or_error.release_error();
+    auto table = table_or_error.release_value();
+
+    // Columns that aren't listed are NULL.
+    Vector<size_t> column_indices;
+    if (statement.column_names().is_empty()) {
+        for (size_t i = 0; i < table.columns.size(); ++i)
+            column_indices.append(i);
+    } else {
+        for (auto& column_name : statement.column_names()) {
+            auto column_index = table.column_index(column_name);
+            if (!column_index.has_value())
+                return String::formatted("Table {} has no column named {}", table.name, column_name);
+            column_indices.append(column_index.value());
+        }
+    }
+
+    ResultSet result_set;
+    ExecutionContext context;
+    for (auto& chained_expression : statement.chained_expressions()) {
+        auto& expressions = chained_expression.expressions();
+        if (expressions.size() != column_indices.size())
+            return String::formatted("{} values for {} columns", expressions.size(), column_indices.size());
+
+        Tuple row;
+        row.resize(table.columns.size());
+        for (size_t i = 0; i < expressions.size(); ++i) {
+            auto column_index = column_indices[i];
+            row[column_index] = expressions[i].evaluate(context).with_affinity(table.columns[column_index].affinity);
+        }
+        if (context.has_error())
+            return context.error();
+
+        if (auto result = insert_row(table, row, table.next_rowid++); result.is_error())
+            return result.release_error();
+        ++result_set.rows_affected;
+    }
+    table.row_count += result_set.rows_affected;
+
+    if (auto result = m_catalog.store_table(table); result.is_error())
+        return result.release_error();
+    return result_set;
+}
+
+Result<ResultSet, String> Executor::execute_update(const Update& statement)
+{
+    if (!statement.common_table_expression_list().is_null())
+        return String { "WITH is not supported" };
+    if (!statement.returning_clause().is_null())
+        return String { "RETURNING is not supported" };
+
+    auto& qualified_table_name = *statement.qualified_table_name();
+    auto table_or_error = find_table(qualified_table_name.table_name());
+    if (table_or_error.is_error())
+        return table_or_error.release_error();
+    auto& table = table_or_error.value();
+
+    Vector<size_t> column_indices;
+    for (auto& update_column : statement.update_columns()) {
+        auto column_index = table.column_index(update_column.column_name);
+        if (!column_index.has_value())
+            return String::formatted("No such column: {}", update_column.column_name);
+        column_indices.append(column_index.value());
+    }
+
+    // The rows are all read before changing any, since a cursor can't walk a tree that changes.
+    auto rows_or_error = collect_rows(table, qualified_table_name.alias(), statement.where_clause());
+    if (rows_or_error.is_error())
+        return rows_or_error.release_error();
+
+    ResultSet result_set;
+    ExecutionContext context(bindings_for_table(table, qualified_table_name.alias()));
+    for (auto& row : rows_or_error.value()) {
+        context.set_row(row);
+        Tuple new_row = row;
+        auto rowid = new_row.take_last().as_integer();
+        for (size_t i = 0; i < column_indices.size(); ++i) {
+            auto column_index = column_indices[i];
+            new_row[column_index] = statement.update_columns()[i].expression->evaluate(context).with_affinity(table.columns[column_index].affinity);
+        }
+        if (context.has_error())
+            return context.error();
+
+        row.take_last();
+        if (auto result = remove_index_entries(table, row, rowid); result.is_error())
+            return result.release_error();
+        if (auto result = insert_row(table, new_row, rowid); result.is_error())
+            return result.release_error();
+        ++result_set.rows_affected;
+    }
+    return result_set;
+}
+
+Result<ResultSet, String> Executor::execute_delete(const Delete& statement)
+{
+    if (!statement.common_table_expression_list().is_null())
+        return String { "WITH is not supported" };
+    if (!statement.returning_clause().is_null())
+        return String { "RETURNING is not supported" };
+
+    auto& qualified_table_name = *statement.qualified_table_name();
+    auto table_or_error = find_table(qualified_table_name.table_name());
+    if (table_or_error.is_error())
+        return table_or_error.release_error();
+    auto& table = table_or_error.value();
+
+    auto rows_or_error = collect_rows(table, qualified_table_name.alias(), statement.where_clause());
+    if (rows_or_error.is_error())
+        return rows_or_error.release_error();
+
+    ResultSet result_set;
+    BTree tree(m_pool, table.root);
+    for (auto& row : rows_or_error.value()) {
+        auto rowid = row.take_last().as_integer();
+        if (auto result = remove_index_entries(table, row, rowid); result.is_error())
+            return result.release_error();
+        if (auto result = tree.remove(encode_row_key(rowid)); result.is_error())
+            return result.release_error();
+        ++result_set.rows_affected;
+    }
+
+    table.row_count -= result_set.rows_affected;
+    if (auto result = m_catalog.store_table(table); result.is_error())
+        return result.release_error();
+    return result_set;
+}
+
+// Evaluates a LIMIT or OFFSET expression, which has to be a non-negative integer.
+static Result<i64, String> evaluate_count(const Expression& expression, const char* clause)
+{
+    ExecutionContext context;
+    auto value = expression.evaluate(context);
+    if (context.has_error())
+        return context.error();
+    auto count = value.to_integer();
+    if (!count.has_value() || count.value() < 0)
+        return String::formatted("{} must be a non-negative integer", clause);
+    return count.value();
+}
+
+Result<ResultSet, String> Executor::execute_select(const Select& statement)
+{
+    if (!statement.common_table_expression_list().is_null())
+        return String { "WITH is not supported" };
+    if (!statement.group_by_clause().is_null())
+        return String { "GROUP BY is not supported" };
+
+    Vector<TableReference> tables;
+    for (auto& table_or_subquery : statement.table_or_subquery_list()) {
+        if (!table_or_subquery.is_table())
+            return String { "Subqueries are not supported" };
+        auto table_or_error = find_table(table_or_subquery.table_name());
+        if (table_or_error.is_error())
+            return table_or_error.release_error();
+        tables.append({ table_or_error.release_value(), table_or_subquery.table_alias() });
+    }
+
+    Planner planner(m_pool);
+    auto plan_or_error = planner.plan(tables, statement.where_clause());
+    if (plan_or_error.is_error())
+        return plan_or_error.release_error();
+    auto plan = plan_or_error.release_value();
+
+    // Expand * and table.* into the visible columns they stand for, in the order the tables are listed in, which
+    // isn't necessarily the order the plan joins them in.
+    NonnullRefPtrVector<Expression> expressions;
+    Vector<String> names;
+    for (auto& result_column : statement.result_column_list()) {
+        if (result_column.type() == ResultType::Expression) {
+            expressions.append(*result_column.expression());
+            if (!result_column.column_alias().is_empty())
+                names.append(result_column.column_alias());
+            else if (is<ColumnNameExpression>(*result_column.expression()))
+                names.append(static_cast<const ColumnNameExpression&>(*result_column.expression()).column_name());
+            else
+                names.append(String::formatted("column{}", names.size() + 1));
+            continue;
+        }
+
+        bool found_table = false;
+        for (auto& table : tables) {
+            if (result_column.type() == ResultType::Table && !table.name().equals_ignoring_case(result_column.table_name()))
+                continue;
+            found_table = true;
+            for (auto& column : table.table.columns) {
+                expressions.append(create_ast_node<ColumnNameExpression>(String {}, table.name(), column.name));
+                names.append(column.name);
+            }
+        }
+        if (result_column.type() == ResultType::Table && !found_table)
+            return String::formatted("No such table: {}", result_column.table_name());
+    }
+
+    // ORDER BY sorts the rows before they are projected, so that it can refer to any column, but it can also refer
+    // to a result column by its alias or position.
+    if (!statement.ordering_term_list().is_empty()) {
+        Vector<SortKey> keys;
+        for (auto& term : statement.ordering_term_list()) {
+            NonnullRefPtr<Expression> expression = term.expression();
+            if (is<NumericLiteral>(*expression)) {
+                auto position = static_cast<const NumericLiteral&>(*expression).value();
+                if (position < 1 || position > expressions.size() || position != static_cast<size_t>(position))
+                    return String::formatted("ORDER BY term out of range: {}", position);
+                expression = expressions[static_cast<size_t>(position) - 1];
+            } else if (is<ColumnNameExpression>(*expression)) {
+                auto& column_name = static_cast<const ColumnNameExpression&>(*expression);
+                if (column_name.table_name().is_empty()) {
+                    for (auto& result_column : statement.result_column_list()) {
+                        if (result_column.type() == ResultType::Expression && result_column.column_alias().equals_ignoring_case(column_name.column_name())) {
+                            expression = *result_column.expression();
+                            break;
+                        }
+                    }
+                }
+            }
+            keys.append({ move(expression), term.order(), term.nulls() });
+        }
+        plan = make<Sort>(move(plan), move(keys));
+    }
+
+    plan = make<Project>(move(plan), expressions, names);
+    if (!statement.select_all())
+        plan = make<Distinct>(move(plan));
+
+    if (!statement.limit_clause().is_null()) {
+        auto& limit_clause = *statement.limit_clause();
+        auto limit_or_error = evaluate_count(limit_clause.limit_expression(), "LIMIT");
+        if (limit_or_error.is_error())
+            return limit_or_error.release_error();
+        i64 offset = 0;
+        if (!limit_clause.offset_expression().is_null()) {
+            auto offset_or_error = evaluate_count(*limit_clause.offset_expression(), "OFFSET");
+            if (offset_or_error.is_error())
+                return offset_or_error.release_error();
+            offset = offset_or_error.value();
+        }
+        plan = make<Limit>(move(plan), offset, limit_or_error.value());
+    }
+
+    auto rows_or_error = read_all_rows(*plan);
+    if (rows_or_error.is_error())
+        return rows_or_error.release_error();
+    ResultSet result_set;
+    result_set.column_names = move(names);
+    result_set.rows = rows_or_error.release_value();
+    return result_set;
+}
+
+}
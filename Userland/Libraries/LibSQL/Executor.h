@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST.h>
+#include <LibSQL/Catalog.h>
+#include <LibSQL/ExecutionContext.h>
+
+namespace SQL {
+
+struct ResultSet {
+    Vector<String> column_names;
+    Vector<Tuple> rows;
+    // How many rows an INSERT, UPDATE or DELETE changed.
+    size_t rows_affected { 0 };
+};
+
+// Runs a statement against the tables in the catalog, as part of the buffer pool's running transaction. Committing
+// or rolling back that transaction is left to the caller.
+class Executor {
+public:
+    Executor(BufferPool& pool, Catalog& catalog)
+        : m_pool(pool)
+        , m_catalog(catalog)
+    {
+    }
+
+    Result<ResultSet, String> execute(const Statement&);
+
+private:
+    Result<ResultSet, String> execute_create_table(const CreateTable&);
+    Result<ResultSet, String> execute_drop_table(const DropTable&);
+    Result<ResultSet, String> execute_create_index(const CreateIndex&);
+    Result<ResultSet, String> execute_drop_index(const DropIndex&);
+    Result<ResultSet, String> execute_insert(const Insert&);
+    Result<ResultSet, String> execute_update(const Update&);
+    Result<ResultSet, String> execute_delete(const Delete&);
+    Result<ResultSet, String> execute_select(const Select&);
+
+    Result<TableInfo, String> find_table(const String& name);
+    // Reads all rows of the table that |where_clause| holds for, each followed by its rowid.
+    Result<Vector<Tuple>, String> collect_rows(const TableInfo&, const String& alias, const RefPtr<Expression>& where_clause);
+
+    Result<void, String> insert_row(const TableInfo&, const Tuple& row, i64 rowid);
+    Result<void, String> remove_index_entries(const TableInfo&, const Tuple& row, i64 rowid);
+    Result<void, String> insert_index_entry(const TableInfo&, const IndexInfo&, const Tuple& row, i64 rowid);
+
+    BufferPool& m_pool;
+    Catalog& m_catalog;
+};
+
+}
@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringBuilder.h>
+#include <LibSQL/AST.h>
+#include <LibSQL/ExecutionContext.h>
+#include <ctype.h>
+#include <math.h>
+
+namespace SQL {
+
+// https://sqlite.org/lang_expr.html describes how all of these behave. Most of them are NULL if any of their
+// operands is NULL, and the logical ones follow three-valued logic, in which NULL means "unknown".
+
+static Value boolean_value(Optional<bool> value)
+{
+    if (!value.has_value())
+        return {};
+    return Value(static_cast<i64>(value.value()));
+}
+
+static Optional<bool> logical_not(Optional<bool> value)
+{
+    if (!value.has_value())
+        return {};
+    return !value.value();
+}
+
+// Arithmetic treats text as the number it looks like, and as 0 if it doesn't look like one.
+static Value numeric_value(const Value& value)
+{
+    if (value.is_number())
+        return value;
+    auto number = value.with_affinity(Affinity::Integer);
+    if (number.is_number())
+        return number;
+    return Value(static_cast<i64>(0));
+}
+
+static i64 integer_value(const Value& value)
+{
+    return numeric_value(value).to_integer().value_or(0);
+}
+
+Value ErrorExpression::evaluate(ExecutionContext& context) const
+{
+    context.set_error("Cannot evaluate an invalid expression");
+    return {};
+}
+
+Value NumericLiteral::evaluate(ExecutionContext&) const
+{
+    // Literals without a fractional part are integers, so that arithmetic on them stays exact.
+    if (trunc(m_value) == m_value && fabs(m_value) < 9007199254740992.0)
+        return Value(static_cast<i64>(m_value));
+    return Value(m_value);
+}
+
+Value StringLiteral::evaluate(ExecutionContext&) const
+{
+    // The literal still has its quotes, and quotes within it are doubled.
+    VERIFY(m_value.length() >= 2);
+    auto value = m_value.substring(1, m_value.length() - 2);
+    value.replace("''", "'", true);
+    return Value(move(value));
+}
+
+Value BlobLiteral::evaluate(ExecutionContext& context) const
+{
+    // FIXME: Values can't be blobs yet, so this is the text that the bytes of the blob make up.
+    VERIFY(m_value.length() >= 3);
+    auto hex_digits = m_value.substring_view(2, m_value.length() - 3);
+    if (hex_digits.length() % 2 != 0) {
+        context.set_error("Blob literal has an odd number of hex digits");
+        return {};
+    }
+
+    StringBuilder builder;
+    for (size_t i = 0; i < hex_digits.length(); i += 2) {
+        auto digit = [](char ch) { return isdigit(ch) ? ch - '0' : tolower(ch) - 'a' + 10; };
+        if (!isxdigit(hex_digits[i]) || !isxdigit(hex_digits[i + 1])) {
+            context.set_error("Blob literal has a character that isn't a hex digit");
+            return {};
+        }
+        builder.append(static_cast<char>(digit(hex_digits[i]) * 16 + digit(hex_digits[i + 1])));
+    }
+    return Value(builder.to_string());
+}
+
+Value ColumnNameExpression::evaluate(ExecutionContext& context) const
+{
+    return context.column_value(*this);
+}
+
+Value apply_unary_operator(UnaryOperator type, const Value& value)
+{
+    if (value.is_null())
+        return {};
+
+    switch (type) {
+    case UnaryOperator::Minus: {
+        auto number = numeric_value(value);
+        if (number.type() == ValueType::Integer && number.as_integer() != NumericLimits<i64>::min())
+            return Value(-number.as_integer());
+        return Value(-number.to_double().value());
+    }
+    case UnaryOperator::Plus:
+        return value;
+    case UnaryOperator::BitwiseNot:
+        return Value(~integer_value(value));
+    case UnaryOperator::Not:
+        return boolean_value(logical_not(value.to_bool()));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Value UnaryOperatorExpression::evaluate(ExecutionContext& context) const
+{
+    return apply_unary_operator(m_type, expression()->evaluate(context));
+}
+
+static Value evaluate_arithmetic(BinaryOperator type, const Value& lhs_value, const Value& rhs_value)
+{
+    auto lhs = numeric_value(lhs_value);
+    auto rhs = numeric_value(rhs_value);
+
+    if (lhs.type() == ValueType::Integer && rhs.type() == ValueType::Integer) {
+        auto a = lhs.as_integer();
+        auto b = rhs.as_integer();
+        i64 result;
+        switch (type) {
+        case BinaryOperator::Multiplication:
+            if (!__builtin_mul_overflow(a, b, &result))
+                return Value(result);
+            break;
+        case BinaryOperator::Plus:
+            if (!__builtin_add_overflow(a, b, &result))
+                return Value(result);
+            break;
+        case BinaryOperator::Minus:
+            if (!__builtin_sub_overflow(a, b, &result))
+                return Value(result);
+            break;
+        case BinaryOperator::Division:
+        case BinaryOperator::Modulo:
+            if (b == 0)
+                return {};
+            if (a == NumericLimits<i64>::min() && b == -1)
+                break;
+            return Value(type == BinaryOperator::Division ? a / b : a % b);
+        default:
+            VERIFY_NOT_REACHED();
+        }
+        // The result doesn't fit into an integer, so it's a float instead.
+    }
+
+    auto a = lhs.to_double().value();
+    auto b = rhs.to_double().value();
+    switch (type) {
+    case BinaryOperator::Multiplication:
+        return Value(a * b);
+    case BinaryOperator::Plus:
+        return Value(a + b);
+    case BinaryOperator::Minus:
+        return Value(a - b);
+    case BinaryOperator::Division:
+        if (b == 0)
+            return {};
+        return Value(a / b);
+    case BinaryOperator::Modulo:
+        if (trunc(b) == 0)
+            return {};
+        return Value(fmod(trunc(a), trunc(b)));
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+static Value evaluate_bitwise(BinaryOperator type, const Value& lhs, const Value& rhs)
+{
+    auto a = integer_value(lhs);
+    auto b = integer_value(rhs);
+
+    switch (type) {
+    case BinaryOperator::BitwiseAnd:
+        return Value(a & b);
+    case BinaryOperator::BitwiseOr:
+        return Value(a | b);
+    case BinaryOperator::ShiftLeft:
+    case BinaryOperator::ShiftRight: {
+        // Shifting by a negative amount shifts the other way.
+        bool shift_left = (type == BinaryOperator::ShiftLeft) == (b >= 0);
+        auto amount = b >= 0 ? static_cast<u64>(b) : -static_cast<u64>(b);
+        if (amount >= 64)
+            return Value(static_cast<i64>(shift_left || a >= 0 ? 0 : -1));
+        if (shift_left)
+            return Value(static_cast<i64>(static_cast<u64>(a) << amount));
+        return Value(a >> amount);
+    }
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+Value BinaryOperatorExpression::evaluate(ExecutionContext& context) const
+{
+    // AND and OR only look at their right-hand side when the left-hand side doesn't decide the result already.
+    if (m_type == BinaryOperator::And || m_type == BinaryOperator::Or) {
+        auto lhs_value = lhs()->evaluate(context).to_bool();
+        bool is_and = m_type == BinaryOperator::And;
+        if (lhs_value.has_value() && lhs_value.value() != is_and)
+            return boolean_value(!is_and);
+        auto rhs_value = rhs()->evaluate(context).to_bool();
+        if (rhs_value.has_value() && rhs_value.value() != is_and)
+            return boolean_value(!is_and);
+        if (!lhs_value.has_value() || !rhs_value.has_value())
+            return {};
+        return boolean_value(is_and);
+    }
+
+    return apply_binary_operator(m_type, lhs()->evaluate(context), rhs()->evaluate(context));
+}
+
+Value apply_binary_operator(BinaryOperator type, const Value& lhs_value, const Value& rhs_value)
+{
+    if (lhs_value.is_null() || rhs_value.is_null())
+        return {};
+
+    switch (type) {
+    case BinaryOperator::Concatenate:
+        return Value(String::formatted("{}{}", lhs_value.to_string(), rhs_value.to_string()));
+    case BinaryOperator::Multiplication:
+    case BinaryOperator::Division:
+    case BinaryOperator::Modulo:
+    case BinaryOperator::Plus:
+    case BinaryOperator::Minus:
+        return evaluate_arithmetic(type, lhs_value, rhs_value);
+    case BinaryOperator::ShiftLeft:
+    case BinaryOperator::ShiftRight:
+    case BinaryOperator::BitwiseAnd:
+    case BinaryOperator::BitwiseOr:
+        return evaluate_bitwise(type, lhs_value, rhs_value);
+    case BinaryOperator::LessThan:
+        return boolean_value(lhs_value.compare(rhs_value) < 0);
+    case BinaryOperator::LessThanEquals:
+        return boolean_value(lhs_value.compare(rhs_value) <= 0);
+    case BinaryOperator::GreaterThan:
+        return boolean_value(lhs_value.compare(rhs_value) > 0);
+    case BinaryOperator::GreaterThanEquals:
+        return boolean_value(lhs_value.compare(rhs_value) >= 0);
+    case BinaryOperator::Equals:
+        return boolean_value(lhs_value.compare(rhs_value) == 0);
+    case BinaryOperator::NotEquals:
+        return boolean_value(lhs_value.compare(rhs_value) != 0);
+    case BinaryOperator::And:
+    case BinaryOperator::Or:
+        // These look at the truth values of their operands, and are evaluated lazily.
+        break;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Value ChainedExpression::evaluate(ExecutionContext& context) const
+{
+    // FIXME: Support row values.
+    if (m_expressions.size() != 1) {
+        context.set_error("Row values are not supported");
+        return {};
+    }
+    return m_expressions[0].evaluate(context);
+}
+
+Value CastExpression::evaluate(ExecutionContext& context) const
+{
+    auto value = expression()->evaluate(context);
+    if (value.is_null())
+        return {};
+
+    switch (affinity_for_type_name(m_type_name->name())) {
+    case Affinity::Integer:
+        return Value(integer_value(value));
+    case Affinity::Real:
+        return Value(numeric_value(value).to_double().value());
+    case Affinity::Text:
+        return Value(value.to_string());
+    case Affinity::None:
+        return value;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Value CaseExpression::evaluate(ExecutionContext& context) const
+{
+    if (m_case_expression) {
+        auto value = m_case_expression->evaluate(context);
+        for (auto& clause : m_when_then_clauses) {
+            auto when = clause.when->evaluate(context);
+            if (!value.is_null() && !when.is_null() && value == when)
+                return clause.then->evaluate(context);
+        }
+    } else {
+        for (auto& clause : m_when_then_clauses) {
+            if (clause.when->evaluate(context).to_bool().value_or(false))
+                return clause.then->evaluate(context);
+        }
+    }
+
+    if (m_else_expression)
+        return m_else_expression->evaluate(context);
+    return {};
+}
+
+Value CollateExpression::evaluate(ExecutionContext& context) const
+{
+    // FIXME: Text is always compared byte by byte, so collations don't change anything yet.
+    return expression()->evaluate(context);
+}
+
+// Matches |text| against a LIKE or GLOB |pattern|, in which |any| stands for any run of characters and |one| for
+// any single character. This backtracks to the last |any| whenever something doesn't match.
+static bool matches_pattern(StringView text, StringView pattern, char any, char one, Optional<char> escape, bool case_sensitive)
+{
+    auto equals = [&](char a, char b) {
+        return case_sensitive ? a == b : tolower(a) == tolower(b);
+    };
+
+    size_t text_index = 0;
+    size_t pattern_index = 0;
+    Optional<size_t> any_pattern_index;
+    size_t any_text_index = 0;
+
+    while (text_index < text.length()) {
+        if (pattern_index < pattern.length()) {
+            auto ch = pattern[pattern_index];
+            bool is_escaped = escape.has_value() && ch == escape.value() && pattern_index + 1 < pattern.length();
+            if (!is_escaped && ch == any) {
+                any_pattern_index = pattern_index++;
+                any_text_index = text_index;
+                continue;
+            }
+            if (is_escaped)
+                ch = pattern[pattern_index + 1];
+            if ((!is_escaped && ch == one) || equals(ch, text[text_index])) {
+                pattern_index += is_escaped ? 2 : 1;
+                ++text_index;
+                continue;
+            }
+        }
+        if (!any_pattern_index.has_value())
+            return false;
+        pattern_index = any_pattern_index.value() + 1;
+        text_index = ++any_text_index;
+    }
+
+    while (pattern_index < pattern.length() && pattern[pattern_index] == any)
+        ++pattern_index;
+    return pattern_index == pattern.length();
+}
+
+Value MatchExpression::evaluate(ExecutionContext& context) const
+{
+    if (m_type == MatchOperator::Match || m_type == MatchOperator::Regexp) {
+        // SQLite doesn't implement these either, and leaves it to applications to define them.
+        context.set_error(String::formatted("{} is not supported", m_type == MatchOperator::Match ? "MATCH" : "REGEXP"));
+        return {};
+    }
+
+    auto text = lhs()->evaluate(context);
+    auto pattern = rhs()->evaluate(context);
+    if (text.is_null() || pattern.is_null())
+        return {};
+
+    Optional<char> escape;
+    if (m_escape) {
+        auto escape_value = m_escape->evaluate(context);
+        if (escape_value.is_null())
+            return {};
+        auto escape_string = escape_value.to_string();
+        if (escape_string.length() != 1) {
+            context.set_error("ESCAPE expression must be a single character");
+            return {};
+        }
+        escape = escape_string[0];
+    }
+
+    bool matches = m_type == MatchOperator::Like
+        ? matches_pattern(text.to_string(), pattern.to_string(), '%', '_', escape, false)
+        : matches_pattern(text.to_string(), pattern.to_string(), '*', '?', escape, true);
+    return boolean_value(matches != invert_expression());
+}
+
+Value NullExpression::evaluate(ExecutionContext& context) const
+{
+    return boolean_value(expression()->evaluate(context).is_null() != invert_expression());
+}
+
+Value IsExpression::evaluate(ExecutionContext& context) const
+{
+    // Unlike =, IS treats NULL like any other value.
+    auto lhs_value = lhs()->evaluate(context);
+    auto rhs_value = rhs()->evaluate(context);
+    bool is_equal = lhs_value.is_null() || rhs_value.is_null()
+        ? lhs_value.is_null() && rhs_value.is_null()
+        : lhs_value == rhs_value;
+    return boolean_value(is_equal != invert_expression());
+}
+
+Value BetweenExpression::evaluate(ExecutionContext& context) const
+{
+    auto value = m_expression->evaluate(context);
+    auto lower = lhs()->evaluate(context);
+    auto upper = rhs()->evaluate(context);
+
+    auto compare = [&](const Value& bound, auto predicate) -> Optional<bool> {
+        if (value.is_null() || bound.is_null())
+            return {};
+        return predicate(value.compare(bound));
+    };
+    auto above_lower = compare(lower, [](int result) { return result >= 0; });
+    auto below_upper = compare(upper, [](int result) { return result <= 0; });
+
+    Optional<bool> result;
+    if ((above_lower.has_value() && !above_lower.value()) || (below_upper.has_value() && !below_upper.value()))
+        result = false;
+    else if (above_lower.has_value() && below_upper.has_value())
+        result = true;
+    return boolean_value(invert_expression() ? logical_not(result) : result);
+}
+
+Value InChainedExpression::evaluate(ExecutionContext& context) const
+{
+    auto& expressions = m_expression_chain->expressions();
+    if (expressions.is_empty())
+        return boolean_value(invert_expression());
+
+    auto value = expression()->evaluate(context);
+    if (value.is_null())
+        return {};
+
+    // If nothing is equal, but something is NULL, that might have been equal.
+    Optional<bool> result = false;
+    for (auto& element : expressions) {
+        auto element_value = element.evaluate(context);
+        if (element_value.is_null()) {
+            result.clear();
+        } else if (value == element_value) {
+            result = true;
+            break;
+        }
+    }
+    return boolean_value(invert_expression() ? logical_not(result) : result);
+}
+
+Value InTableExpression::evaluate(ExecutionContext& context) const
+{
+    // FIXME: Support IN on tables.
+    context.set_error("IN on a table is not supported");
+    return {};
+}
+
+}
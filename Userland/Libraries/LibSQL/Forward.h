@@ -8,6 +8,7 @@
 
 namespace SQL {
 class ASTNode;
+class BeginTransaction;
 class BetweenExpression;
 class BinaryOperatorExpression;
 class BlobLiteral;
@@ -17,17 +18,22 @@ class ChainedExpression;
 class CollateExpression;
 class ColumnDefinition;
 class ColumnNameExpression;
+class CommitTransaction;
 class CommonTableExpression;
 class CommonTableExpressionList;
+class CreateIndex;
 class CreateTable;
 class Delete;
+class DropIndex;
 class DropTable;
 class ErrorExpression;
 class ErrorStatement;
+class ExecutionContext;
 class Expression;
 class GroupByClause;
 class InChainedExpression;
 class InTableExpression;
+class Insert;
 class InvertibleNestedDoubleExpression;
 class InvertibleNestedExpression;
 class IsExpression;
@@ -44,6 +50,7 @@ class Parser;
 class QualifiedTableName;
 class ResultColumn;
 class ReturningClause;
+class RollbackTransaction;
 class Select;
 class SignedNumber;
 class Statement;
@@ -52,4 +59,5 @@ class TableOrSubquery;
 class Token;
 class TypeName;
 class UnaryOperatorExpression;
+class Update;
 }
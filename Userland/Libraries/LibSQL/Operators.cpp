@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibSQL/Operators.h>
+#include <string.h>
+
+namespace SQL {
+
+Result<bool, String> Operator::next_batch(Batch& batch)
+{
+    batch.reset(columns().size());
+    Tuple row;
+    while (batch.row_count() < batch_size) {
+        auto has_row_or_error = next(row);
+        if (has_row_or_error.is_error())
+            return has_row_or_error.release_error();
+        if (!has_row_or_error.value())
+            break;
+        batch.append_row(row);
+    }
+    return !batch.is_empty();
+}
+
+Result<bool, String> BatchOperator::next(Tuple& row)
+{
+    while (m_next_buffered_row == m_buffered_batch.row_count()) {
+        m_next_buffered_row = 0;
+        auto has_batch_or_error = next_batch(m_buffered_batch);
+        if (has_batch_or_error.is_error() || !has_batch_or_error.value())
+            return has_batch_or_error;
+    }
+    row = m_buffered_batch.row(m_next_buffered_row++);
+    return true;
+}
+
+Vector<ColumnBinding> bindings_for_table(const TableInfo& table, const String& alias)
+{
+    auto& table_name = alias.is_empty() ? table.name : alias;
+    Vector<ColumnBinding> bindings;
+    for (auto& column : table.columns)
+        bindings.append({ table_name, column.name });
+    bindings.append({ table_name, "rowid", true });
+    return bindings;
+}
+
+static String corrupt_row_error(const TableInfo& table)
+{
+    return String::formatted("A row of table {} is corrupt", table.name);
+}
+
+static Result<Tuple, String> deserialize_row(ReadonlyBytes bytes, const TableInfo& table)
+{
+    auto row = deserialize_tuple(bytes);
+    if (!row.has_value() || row->size() != table.columns.size() + 1)
+        return corrupt_row_error(table);
+    return row.release_value();
+}
+
+static String describe_table(const TableInfo& table, const String& alias)
+{
+    if (alias.is_empty())
+        return table.name;
+    return String::formatted("{} AS {}", table.name, alias);
+}
+
+TableScan::TableScan(BufferPool& pool, const TableInfo& table, const String& alias)
+    : Operator(bindings_for_table(table, alias))
+    , m_table(table)
+    , m_alias(alias)
+    , m_tree(pool, table.root)
+{
+}
+
+Result<bool, String> TableScan::advance()
+{
+    if (!m_cursor.has_value()) {
+        auto cursor_or_error = m_tree.seek({});
+        if (cursor_or_error.is_error())
+            return cursor_or_error.release_error();
+        m_cursor = cursor_or_error.release_value();
+    } else if (m_cursor->is_end()) {
+        return false;
+    } else if (auto result = m_cursor->next(); result.is_error()) {
+        return result.release_error();
+    }
+    return !m_cursor->is_end();
+}
+
+Result<bool, String> TableScan::next(Tuple& row)
+{
+    auto has_row_or_error = advance();
+    if (has_row_or_error.is_error() || !has_row_or_error.value())
+        return has_row_or_error;
+
+    auto value_or_error = m_cursor->value();
+    if (value_or_error.is_error())
+        return value_or_error.release_error();
+    auto row_or_error = deserialize_row(value_or_error.value(), m_table);
+    if (row_or_error.is_error())
+        return row_or_error.release_error();
+    row = row_or_error.release_value();
+    return true;
+}
+
+Result<bool, String> TableScan::next_batch(Batch& batch)
+{
+    batch.reset(columns().size());
+    while (batch.row_count() < batch_size) {
+        auto has_row_or_error = advance();
+        if (has_row_or_error.is_error())
+            return has_row_or_error.release_error();
+        if (!has_row_or_error.value())
+            break;
+
+        auto value_or_error = m_cursor->value();
+        if (value_or_error.is_error())
+            return value_or_error.release_error();
+
+        // The values go straight into their columns, without making a tuple out of them first.
+        ReadonlyBytes bytes = value_or_error.value();
+        if (bytes.size() < 2 || static_cast<size_t>(bytes[0] | bytes[1] << 8) != columns().size())
+            return corrupt_row_error(m_table);
+        bytes = bytes.slice(2);
+        for (size_t i = 0; i < columns().size(); ++i) {
+            auto value = Value::deserialize(bytes);
+            if (!value.has_value())
+                return corrupt_row_error(m_table);
+            batch.column(i).append(value.value());
+        }
+        batch.set_row_count(batch.row_count() + 1);
+    }
+    return !batch.is_empty();
+}
+
+String TableScan::to_string() const
+{
+    return String::formatted("TableScan({})", describe_table(m_table, m_alias));
+}
+
+IndexScan::IndexScan(BufferPool& pool, const TableInfo& table, const String& alias, const IndexInfo& index, Vector<u8> lower_bound, Optional<Vector<u8>> upper_bound)
+    : Operator(bindings_for_table(table, alias))
+    , m_table(table)
+    , m_alias(alias)
+    , m_index_name(index.name)
+    , m_table_tree(pool, table.root)
+    , m_index_tree(pool, index.root)
+    , m_lower_bound(move(lower_bound))
+    , m_upper_bound(move(upper_bound))
+{
+}
+
+Result<bool, String> IndexScan::next(Tuple& row)
+{
+    if (!m_cursor.has_value()) {
+        auto cursor_or_error = m_index_tree.seek(m_lower_bound);
+        if (cursor_or_error.is_error())
+            return cursor_or_error.release_error();
+        m_cursor = cursor_or_error.release_value();
+    } else if (m_cursor->is_end()) {
+        return false;
+    } else if (auto result = m_cursor->next(); result.is_error()) {
+        return result.release_error();
+    }
+    if (m_cursor->is_end())
+        return false;
+    if (m_upper_bound.has_value() && compare_key_prefix(m_cursor->key(), m_upper_bound.value()) > 0)
+        return false;
+
+    auto rowid_or_error = m_cursor->value();
+    if (rowid_or_error.is_error())
+        return rowid_or_error.release_error();
+    i64 rowid;
+    if (rowid_or_error.value().size() != sizeof(rowid))
+        return String::formatted("An index entry of table {} is corrupt", m_table.name);
+    memcpy(&rowid, rowid_or_error.value().data(), sizeof(rowid));
+
+    auto value_or_error = m_table_tree.find(encode_row_key(rowid));
+    if (value_or_error.is_error())
+        return value_or_error.release_error();
+    if (!value_or_error.value().has_value())
+        return String::formatted("An index entry of table {} refers to a missing row", m_table.name);
+    auto row_or_error = deserialize_row(value_or_error.value().value(), m_table);
+    if (row_or_error.is_error())
+        return row_or_error.release_error();
+    row = row_or_error.release_value();
+    return true;
+}
+
+String IndexScan::to_string() const
+{
+    return String::formatted("IndexScan({}, {})", describe_table(m_table, m_alias), m_index_name);
+}
+
+Result<bool, String> SingleRow::next(Tuple& row)
+{
+    if (m_is_done)
+        return false;
+    m_is_done = true;
+    row.clear();
+    return true;
+}
+
+Filter::Filter(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<Expression> conditions)
+    : BatchOperator(input->columns())
+    , m_input(move(input))
+    , m_context(columns())
+{
+    for (auto& condition : conditions)
+        m_conditions.append(BatchExpression::compile(condition, m_context));
+}
+
+Result<bool, String> Filter::next_batch(Batch& batch)
+{
+    // Names that didn't resolve when compiling the conditions are reported before reading anything.
+    if (m_context.has_error())
+        return m_context.error();
+
+    for (;;) {
+        auto has_batch_or_error = m_input->next_batch(batch);
+        if (has_batch_or_error.is_error() || !has_batch_or_error.value())
+            return has_batch_or_error;
+
+        for (auto& condition : m_conditions) {
+            auto& result = condition.evaluate(batch, m_context);
+            if (m_context.has_error())
+                return m_context.error();
+            select_true_rows(result, m_selected_rows);
+            if (m_selected_rows.size() != batch.row_count())
+                batch.select(m_selected_rows);
+            if (batch.is_empty())
+                break;
+        }
+        if (!batch.is_empty())
+            return true;
+    }
+}
+
+String Filter::to_string() const
+{
+    return String::formatted("Filter({})", m_input->to_string());
+}
+
+static Vector<ColumnBinding> concatenated_columns(const Operator& left, const Operator& right)
+{
+    auto columns = left.columns();
+    columns.append(right.columns());
+    return columns;
+}
+
+NestedLoopJoin::NestedLoopJoin(NonnullOwnPtr<Operator> left, NonnullOwnPtr<Operator> right)
+    : Operator(concatenated_columns(*left, *right))
+    , m_left(move(left))
+    , m_right(move(right))
+{
+}
+
+Result<bool, String> NestedLoopJoin::next(Tuple& row)
+{
+    if (!m_has_read_right_rows) {
+        Tuple right_row;
+        for (;;) {
+            auto has_row_or_error = m_right->next(right_row);
+            if (has_row_or_error.is_error())
+                return has_row_or_error;
+            if (!has_row_or_error.value())
+                break;
+            m_right_rows.append(right_row);
+        }
+        m_has_read_right_rows = true;
+        m_next_right_row = m_right_rows.size();
+    }
+    if (m_right_rows.is_empty())
+        return false;
+
+    if (m_next_right_row == m_right_rows.size()) {
+        auto has_row_or_error = m_left->next(m_left_row);
+        if (has_row_or_error.is_error() || !has_row_or_error.value())
+            return has_row_or_error;
+        m_next_right_row = 0;
+    }
+    row = m_left_row;
+    row.append(m_right_rows[m_next_right_row++]);
+    return true;
+}
+
+String NestedLoopJoin::to_string() const
+{
+    return String::formatted("NestedLoopJoin({}, {})", m_left->to_string(), m_right->to_string());
+}
+
+Sort::Sort(NonnullOwnPtr<Operator> input, Vector<SortKey> keys)
+    : Operator(input->columns())
+    , m_input(move(input))
+    , m_keys(move(keys))
+    , m_context(columns())
+{
+}
+
+Result<bool, String> Sort::next(Tuple& row)
+{
+    if (!m_is_sorted) {
+        if (auto result = read_and_sort(); result.is_error())
+            return result.release_error();
+        m_is_sorted = true;
+    }
+    if (m_next_row == m_rows.size())
+        return false;
+    row = move(m_rows[m_next_row++].row);
+    return true;
+}
+
+Result<void, String> Sort::read_and_sort()
+{
+    Tuple row;
+    for (;;) {
+        auto has_row_or_error = m_input->next(row);
+        if (has_row_or_error.is_error())
+            return has_row_or_error.release_error();
+        if (!has_row_or_error.value())
+            break;
+        m_context.set_row(row);
+        Tuple key;
+        for (auto& sort_key : m_keys)
+            key.append(sort_key.expression->evaluate(m_context));
+        if (m_context.has_error())
+            return m_context.error();
+        m_rows.append({ move(key), move(row) });
+    }
+
+    quick_sort(m_rows, [&](const SortRow& a, const SortRow& b) {
+        for (size_t i = 0; i < m_keys.size(); ++i) {
+            auto& a_value = a.key[i];
+            auto& b_value = b.key[i];
+            if (a_value.is_null() != b_value.is_null())
+                return a_value.is_null() == (m_keys[i].nulls == Nulls::First);
+            auto result = a_value.compare(b_value);
+            if (result != 0)
+                return (result < 0) == (m_keys[i].order == Order::Ascending);
+        }
+        return false;
+    });
+    return {};
+}
+
+String Sort::to_string() const
+{
+    return String::formatted("Sort({})", m_input->to_string());
+}
+
+static Vector<ColumnBinding> output_columns(const Vector<String>& names)
+{
+    Vector<ColumnBinding> columns;
+    for (auto& name : names)
+        columns.append({ {}, name });
+    return columns;
+}
+
+Project::Project(NonnullOwnPtr<Operator> input, const NonnullRefPtrVector<Expression>& expressions, const Vector<String>& names)
+    : BatchOperator(output_columns(names))
+    , m_input(move(input))
+    , m_context(m_input->columns())
+{
+    for (auto& expression : expressions)
+        m_expressions.append(BatchExpression::compile(expression, m_context));
+}
+
+Result<bool, String> Project::next_batch(Batch& batch)
+{
+    if (m_context.has_error())
+        return m_context.error();
+
+    auto has_batch_or_error = m_input->next_batch(m_input_batch);
+    if (has_batch_or_error.is_error() || !has_batch_or_error.value())
+        return has_batch_or_error;
+
+    batch.reset(m_expressions.size());
+    for (size_t i = 0; i < m_expressions.size(); ++i)
+        batch.column(i) = m_expressions[i].evaluate(m_input_batch, m_context);
+    if (m_context.has_error())
+        return m_context.error();
+    batch.set_row_count(m_input_batch.row_count());
+    return true;
+}
+
+String Project::to_string() const
+{
+    return String::formatted("Project({})", m_input->to_string());
+}
+
+Distinct::Distinct(NonnullOwnPtr<Operator> input)
+    : Operator(input->columns())
+    , m_input(move(input))
+{
+}
+
+Result<bool, String> Distinct::next(Tuple& row)
+{
+    for (;;) {
+        auto has_row_or_error = m_input->next(row);
+        if (has_row_or_error.is_error() || !has_row_or_error.value())
+            return has_row_or_error;
+
+        // Rows are equal exactly when their keys are.
+        Vector<u8> key;
+        for (auto& value : row)
+            value.encode_key(key);
+        if (m_seen_rows.set(String(reinterpret_cast<const char*>(key.data()), key.size())) == AK::HashSetResult::InsertedNewEntry)
+            return true;
+    }
+}
+
+String Distinct::to_string() const
+{
+    return String::formatted("Distinct({})", m_input->to_string());
+}
+
+Limit::Limit(NonnullOwnPtr<Operator> input, size_t offset, Optional<size_t> limit)
+    : Operator(input->columns())
+    , m_input(move(input))
+    , m_offset(offset)
+    , m_limit(limit)
+{
+}
+
+Result<bool, String> Limit::next(Tuple& row)
+{
+    for (; m_offset > 0; --m_offset) {
+        auto has_row_or_error = m_input->next(row);
+        if (has_row_or_error.is_error() || !has_row_or_error.value())
+            return has_row_or_error;
+    }
+    if (m_limit.has_value()) {
+        if (m_limit.value() == 0)
+            return false;
+        --m_limit.value();
+    }
+    return m_input->next(row);
+}
+
+String Limit::to_string() const
+{
+    return String::formatted("Limit({})", m_input->to_string());
+}
+
+}
@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashTable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST.h>
+#include <LibSQL/Batch.h>
+#include <LibSQL/BatchExpression.h>
+#include <LibSQL/Catalog.h>
+#include <LibSQL/ExecutionContext.h>
+
+namespace SQL {
+
+// A node of a query plan, which hands out its rows when asked for them, pulling as many rows as it needs out of the
+// operators below it. Rows can be pulled one at a time, or a batch at a time, which is much cheaper for operators
+// that work on batches, like scans, filters and projections.
+class Operator {
+public:
+    virtual ~Operator() = default;
+
+    const Vector<ColumnBinding>& columns() const { return m_columns; }
+
+    // Puts the next row into |row|, or returns false once there are no more, and from then on.
+    virtual Result<bool, String> next(Tuple& row) = 0;
+    // Puts the next rows into |batch|, or returns false once there are no more, and from then on. By default, this
+    // pulls the rows one at a time.
+    virtual Result<bool, String> next_batch(Batch& batch);
+
+    // Describes the plan from this operator down, for tests and debugging.
+    virtual String to_string() const = 0;
+
+protected:
+    explicit Operator(Vector<ColumnBinding> columns)
+        : m_columns(move(columns))
+    {
+    }
+
+private:
+    Vector<ColumnBinding> m_columns;
+};
+
+// An operator that works on batches, and hands out single rows from the batches it makes.
+class BatchOperator : public Operator {
+public:
+    virtual Result<bool, String> next(Tuple& row) override final;
+
+protected:
+    explicit BatchOperator(Vector<ColumnBinding> columns)
+        : Operator(move(columns))
+    {
+    }
+
+private:
+    Batch m_buffered_batch;
+    size_t m_next_buffered_row { 0 };
+};
+
+Vector<ColumnBinding> bindings_for_table(const TableInfo&, const String& alias);
+
+class TableScan final : public Operator {
+public:
+    TableScan(BufferPool&, const TableInfo&, const String& alias);
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual Result<bool, String> next_batch(Batch&) override;
+    virtual String to_string() const override;
+
+private:
+    // Moves the cursor to the next row, or to the first one if there's no cursor yet.
+    Result<bool, String> advance();
+
+    TableInfo m_table;
+    String m_alias;
+    BTree m_tree;
+    Optional<BTree::Cursor> m_cursor;
+};
+
+// Reads the rows whose index entries start with values between |lower_bound| and |upper_bound|, which are encoded
+// like keys, in the order of the index.
+class IndexScan final : public Operator {
+public:
+    IndexScan(BufferPool&, const TableInfo&, const String& alias, const IndexInfo&, Vector<u8> lower_bound, Optional<Vector<u8>> upper_bound);
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual String to_string() const override;
+
+private:
+    TableInfo m_table;
+    String m_alias;
+    String m_index_name;
+    BTree m_table_tree;
+    BTree m_index_tree;
+    Vector<u8> m_lower_bound;
+    Optional<Vector<u8>> m_upper_bound;
+    Optional<BTree::Cursor> m_cursor;
+};
+
+// Produces a single row without any columns, which is what a SELECT without FROM selects from.
+class SingleRow final : public Operator {
+public:
+    SingleRow()
+        : Operator({})
+    {
+    }
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual String to_string() const override { return "SingleRow"; }
+
+private:
+    bool m_is_done { false };
+};
+
+// Keeps the rows that all of its conditions hold for. Each condition only runs on the rows that made it through
+// the ones before it.
+class Filter final : public BatchOperator {
+public:
+    Filter(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<Expression> conditions);
+
+    virtual Result<bool, String> next_batch(Batch&) override;
+    virtual String to_string() const override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    ExecutionContext m_context;
+    NonnullOwnPtrVector<BatchExpression> m_conditions;
+    Vector<u32> m_selected_rows;
+};
+
+// Pairs every row on the left with every row on the right, which are read only once, and kept in memory.
+class NestedLoopJoin final : public Operator {
+public:
+    NestedLoopJoin(NonnullOwnPtr<Operator> left, NonnullOwnPtr<Operator> right);
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual String to_string() const override;
+
+private:
+    NonnullOwnPtr<Operator> m_left;
+    NonnullOwnPtr<Operator> m_right;
+    Tuple m_left_row;
+    Vector<Tuple> m_right_rows;
+    size_t m_next_right_row { 0 };
+    bool m_has_read_right_rows { false };
+};
+
+struct SortKey {
+    NonnullRefPtr<Expression> expression;
+    Order order;
+    Nulls nulls;
+};
+
+// Reads all rows before handing out the first one.
+class Sort final : public Operator {
+public:
+    Sort(NonnullOwnPtr<Operator> input, Vector<SortKey> keys);
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual String to_string() const override;
+
+private:
+    struct SortRow {
+        Tuple key;
+        Tuple row;
+    };
+
+    Result<void, String> read_and_sort();
+
+    NonnullOwnPtr<Operator> m_input;
+    Vector<SortKey> m_keys;
+    ExecutionContext m_context;
+    Vector<SortRow> m_rows;
+    size_t m_next_row { 0 };
+    bool m_is_sorted { false };
+};
+
+class Project final : public BatchOperator {
+public:
+    Project(NonnullOwnPtr<Operator> input, const NonnullRefPtrVector<Expression>& expressions, const Vector<String>& names);
+
+    virtual Result<bool, String> next_batch(Batch&) override;
+    virtual String to_string() const override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    ExecutionContext m_context;
+    NonnullOwnPtrVector<BatchExpression> m_expressions;
+    Batch m_input_batch;
+};
+
+class Distinct final : public Operator {
+public:
+    explicit Distinct(NonnullOwnPtr<Operator> input);
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual String to_string() const override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    HashTable<String> m_seen_rows;
+};
+
+class Limit final : public Operator {
+public:
+    Limit(NonnullOwnPtr<Operator> input, size_t offset, Optional<size_t> limit);
+
+    virtual Result<bool, String> next(Tuple& row) override;
+    virtual String to_string() const override;
+
+private:
+    NonnullOwnPtr<Operator> m_input;
+    size_t m_offset { 0 };
+    Optional<size_t> m_limit;
+};
+
+}
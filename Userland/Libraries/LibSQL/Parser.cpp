@@ -28,15 +28,26 @@ NonnullRefPtr<Statement> Parser::parse_statement()
 {
     switch (m_parser_state.m_token.type()) {
     case TokenType::Create:
-        return parse_create_table_statement();
+        return parse_create_statement();
     case TokenType::Drop:
-        return parse_drop_table_statement();
+        return parse_drop_statement();
+    case TokenType::Insert:
+        return parse_insert_statement({});
+    case TokenType::Update:
+        return parse_update_statement({});
     case TokenType::Delete:
         return parse_delete_statement({});
     case TokenType::Select:
         return parse_select_statement({});
+    case TokenType::Begin:
+        return parse_begin_transaction_statement();
+    case TokenType::Commit:
+    case TokenType::End:
+        return parse_commit_transaction_statement();
+    case TokenType::Rollback:
+        return parse_rollback_transaction_statement();
     default:
-        expected("CREATE, DROP, DELETE, or SELECT");
+        expected("CREATE, DROP, INSERT, UPDATE, DELETE, SELECT, BEGIN, COMMIT, or ROLLBACK");
         return create_ast_node<ErrorStatement>();
     }
 }
@@ -44,21 +55,32 @@ NonnullRefPtr<Statement> Parser::parse_statement()
 NonnullRefPtr<Statement> Parser::parse_statement_with_expression_list(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     switch (m_parser_state.m_token.type()) {
+    case TokenType::Insert:
+        return parse_insert_statement(move(common_table_expression_list));
+    case TokenType::Update:
+        return parse_update_statement(move(common_table_expression_list));
     case TokenType::Delete:
         return parse_delete_statement(move(common_table_expression_list));
     case TokenType::Select:
         return parse_select_statement(move(common_table_expression_list));
     default:
-        expected("DELETE or SELECT");
+        expected("INSERT, UPDATE, DELETE, or SELECT");
         return create_ast_node<ErrorStatement>();
     }
 }
 
-NonnullRefPtr<CreateTable> Parser::parse_create_table_statement()
+NonnullRefPtr<Statement> Parser::parse_create_statement()
 {
-    // https://sqlite.org/lang_createtable.html
     consume(TokenType::Create);
 
+    if (match(TokenType::Unique) || match(TokenType::Index))
+        return parse_create_index_statement();
+    return parse_create_table_statement();
+}
+
+NonnullRefPtr<CreateTable> Parser::parse_create_table_statement()
+{
+    // https://sqlite.org/lang_createtable.html
     bool is_temporary = false;
     if (consume_if(TokenType::Temp) || consume_if(TokenType::Temporary))
         is_temporary = true;
@@ -104,10 +126,65 @@ NonnullRefPtr<CreateTable> Parser::parse_create_table_statement()
     return create_ast_node<CreateTable>(move(schema_name), move(table_name), move(column_definitions), is_temporary, is_error_if_table_exists);
 }
 
+NonnullRefPtr<CreateIndex> Parser::parse_create_index_statement()
+{
+    // https://sqlite.org/lang_createindex.html
+    bool is_unique = consume_if(TokenType::Unique);
+    consume(TokenType::Index);
+
+    bool is_error_if_index_exists = true;
+    if (consume_if(TokenType::If)) {
+        consume(TokenType::Not);
+        consume(TokenType::Exists);
+        is_error_if_index_exists = false;
+    }
+
+    String schema_or_index_name = consume(TokenType::Identifier).value();
+    String schema_name;
+    String index_name;
+
+    if (consume_if(TokenType::Period)) {
+        schema_name = move(schema_or_index_name);
+        index_name = consume(TokenType::Identifier).value();
+    } else {
+        index_name = move(schema_or_index_name);
+    }
+
+    consume(TokenType::On);
+    String table_name = consume(TokenType::Identifier).value();
+
+    // FIXME: Parse expressions, collations and sort orders in "indexed-column".
+    Vector<String> column_names;
+    consume(TokenType::ParenOpen);
+    do {
+        column_names.append(consume(TokenType::Identifier).value());
+
+        if (match(TokenType::ParenClose))
+            break;
+
+        consume(TokenType::Comma);
+    } while (!match(TokenType::Eof));
+    consume(TokenType::ParenClose);
+
+    // FIXME: Parse "WHERE expr" for partial indexes.
+
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<CreateIndex>(move(schema_name), move(index_name), move(table_name), move(column_names), is_unique, is_error_if_index_exists);
+}
+
+NonnullRefPtr<Statement> Parser::parse_drop_statement()
+{
+    consume(TokenType::Drop);
+
+    if (match(TokenType::Index))
+        return parse_drop_index_statement();
+    return parse_drop_table_statement();
+}
+
 NonnullRefPtr<DropTable> Parser::parse_drop_table_statement()
 {
     // https://sqlite.org/lang_droptable.html
-    consume(TokenType::Drop);
     consume(TokenType::Table);
 
     bool is_error_if_table_does_not_exist = true;
@@ -132,6 +209,122 @@ NonnullRefPtr<DropTable> Parser::parse_drop_table_statement()
     return create_ast_node<DropTable>(move(schema_name), move(table_name), is_error_if_table_does_not_exist);
 }
 
+NonnullRefPtr<DropIndex> Parser::parse_drop_index_statement()
+{
+    // https://sqlite.org/lang_dropindex.html
+    consume(TokenType::Index);
+
+    bool is_error_if_index_does_not_exist = true;
+    if (consume_if(TokenType::If)) {
+        consume(TokenType::Exists);
+        is_error_if_index_does_not_exist = false;
+    }
+
+    String schema_or_index_name = consume(TokenType::Identifier).value();
+    String schema_name;
+    String index_name;
+
+    if (consume_if(TokenType::Period)) {
+        schema_name = move(schema_or_index_name);
+        index_name = consume(TokenType::Identifier).value();
+    } else {
+        index_name = move(schema_or_index_name);
+    }
+
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<DropIndex>(move(schema_name), move(index_name), is_error_if_index_does_not_exist);
+}
+
+NonnullRefPtr<Insert> Parser::parse_insert_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
+{
+    // https://sqlite.org/lang_insert.html
+    consume(TokenType::Insert);
+    // FIXME: Parse "OR conflict-resolution" and "REPLACE".
+    consume(TokenType::Into);
+
+    String schema_or_table_name = consume(TokenType::Identifier).value();
+    String schema_name;
+    String table_name;
+
+    if (consume_if(TokenType::Period)) {
+        schema_name = move(schema_or_table_name);
+        table_name = consume(TokenType::Identifier).value();
+    } else {
+        table_name = move(schema_or_table_name);
+    }
+
+    String alias;
+    if (consume_if(TokenType::As))
+        alias = consume(TokenType::Identifier).value();
+
+    Vector<String> column_names;
+    if (consume_if(TokenType::ParenOpen)) {
+        do {
+            column_names.append(consume(TokenType::Identifier).value());
+
+            if (match(TokenType::ParenClose))
+                break;
+
+            consume(TokenType::Comma);
+        } while (!match(TokenType::Eof));
+        consume(TokenType::ParenClose);
+    }
+
+    // FIXME: Parse "select-stmt" and "DEFAULT VALUES", as well as the "upsert-clause".
+    NonnullRefPtrVector<ChainedExpression> chained_expressions;
+    consume(TokenType::Values);
+    do {
+        if (auto chain = parse_chained_expression(); chain.has_value())
+            chained_expressions.append(static_cast<ChainedExpression&>(*chain.value()));
+        else
+            expected("Chained expression");
+
+        if (!match(TokenType::Comma))
+            break;
+
+        consume(TokenType::Comma);
+    } while (!match(TokenType::Eof));
+
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<Insert>(move(common_table_expression_list), move(schema_name), move(table_name), move(alias), move(column_names), move(chained_expressions));
+}
+
+NonnullRefPtr<Update> Parser::parse_update_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
+{
+    // https://sqlite.org/lang_update.html
+    consume(TokenType::Update);
+    // FIXME: Parse "OR conflict-resolution".
+    auto qualified_table_name = parse_qualified_table_name();
+
+    // FIXME: Parse "( column-name-list ) = expr", and the FROM clause.
+    Vector<Update::UpdateColumn> update_columns;
+    consume(TokenType::Set);
+    do {
+        auto column_name = consume(TokenType::Identifier).value();
+        consume(TokenType::Equals);
+        update_columns.append({ move(column_name), parse_expression() });
+
+        if (!match(TokenType::Comma))
+            break;
+
+        consume(TokenType::Comma);
+    } while (!match(TokenType::Eof));
+
+    RefPtr<Expression> where_clause;
+    if (consume_if(TokenType::Where))
+        where_clause = parse_expression();
+
+    RefPtr<ReturningClause> returning_clause;
+    if (match(TokenType::Returning))
+        returning_clause = parse_returning_clause();
+
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<Update>(move(common_table_expression_list), move(qualified_table_name), move(update_columns), move(where_clause), move(returning_clause));
+}
+
 NonnullRefPtr<Delete> Parser::parse_delete_statement(RefPtr<CommonTableExpressionList> common_table_expression_list)
 {
     // https://sqlite.org/lang_delete.html
@@ -240,6 +433,41 @@ NonnullRefPtr<Select> Parser::parse_select_statement(RefPtr<CommonTableExpressio
     return create_ast_node<Select>(move(common_table_expression_list), select_all, move(result_column_list), move(table_or_subquery_list), move(where_clause), move(group_by_clause), move(ordering_term_list), move(limit_clause));
 }
 
+NonnullRefPtr<BeginTransaction> Parser::parse_begin_transaction_statement()
+{
+    // https://sqlite.org/lang_transaction.html
+    consume(TokenType::Begin);
+    // All transactions are exclusive, so the kind of transaction doesn't matter.
+    if (!consume_if(TokenType::Deferred) && !consume_if(TokenType::Immediate))
+        consume_if(TokenType::Exclusive);
+    consume_if(TokenType::Transaction);
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<BeginTransaction>();
+}
+
+NonnullRefPtr<CommitTransaction> Parser::parse_commit_transaction_statement()
+{
+    // https://sqlite.org/lang_transaction.html
+    if (!consume_if(TokenType::End))
+        consume(TokenType::Commit);
+    consume_if(TokenType::Transaction);
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<CommitTransaction>();
+}
+
+NonnullRefPtr<RollbackTransaction> Parser::parse_rollback_transaction_statement()
+{
+    // https://sqlite.org/lang_transaction.html
+    consume(TokenType::Rollback);
+    consume_if(TokenType::Transaction);
+    // FIXME: Parse "TO SAVEPOINT savepoint-name".
+    consume(TokenType::SemiColon);
+
+    return create_ast_node<RollbackTransaction>();
+}
+
 NonnullRefPtr<CommonTableExpressionList> Parser::parse_common_table_expression_list()
 {
     consume(TokenType::With);
@@ -258,12 +486,26 @@ NonnullRefPtr<CommonTableExpressionList> Parser::parse_common_table_expression_l
 }
 
 NonnullRefPtr<Expression> Parser::parse_expression()
+{
+    return parse_expression(0);
+}
+
+NonnullRefPtr<Expression> Parser::parse_expression(size_t minimum_precedence)
 {
     // https://sqlite.org/lang_expr.html
-    auto expression = parse_primary_expression();
+    return parse_expression(minimum_precedence, parse_primary_expression());
+}
 
-    if (match_secondary_expression())
-        expression = parse_secondary_expression(move(expression));
+NonnullRefPtr<Expression> Parser::parse_expression(size_t minimum_precedence, NonnullRefPtr<Expression> expression)
+{
+    // Operators that bind less tightly than |minimum_precedence| are left for the caller, which has an operand on
+    // the left that binds more tightly than they do.
+    while (match_secondary_expression()) {
+        auto precedence = secondary_expression_precedence();
+        if (precedence < minimum_precedence)
+            break;
+        expression = parse_secondary_expression(move(expression), precedence);
+    }
 
     // FIXME: Parse 'bind-parameter'.
     // FIXME: Parse 'function-name'.
@@ -299,28 +541,28 @@ NonnullRefPtr<Expression> Parser::parse_primary_expression()
     return create_ast_node<ErrorExpression>();
 }
 
-NonnullRefPtr<Expression> Parser::parse_secondary_expression(NonnullRefPtr<Expression> primary)
+NonnullRefPtr<Expression> Parser::parse_secondary_expression(NonnullRefPtr<Expression> primary, size_t precedence)
 {
-    if (auto expression = parse_binary_operator_expression(primary); expression.has_value())
+    if (auto expression = parse_binary_operator_expression(primary, precedence); expression.has_value())
         return move(expression.value());
 
     if (auto expression = parse_collate_expression(primary); expression.has_value())
         return move(expression.value());
 
-    if (auto expression = parse_is_expression(primary); expression.has_value())
+    if (auto expression = parse_is_expression(primary, precedence); expression.has_value())
         return move(expression.value());
 
     bool invert_expression = false;
     if (consume_if(TokenType::Not))
         invert_expression = true;
 
-    if (auto expression = parse_match_expression(primary, invert_expression); expression.has_value())
+    if (auto expression = parse_match_expression(primary, invert_expression, precedence); expression.has_value())
         return move(expression.value());
 
     if (auto expression = parse_null_expression(primary, invert_expression); expression.has_value())
         return move(expression.value());
 
-    if (auto expression = parse_between_expression(primary, invert_expression); expression.has_value())
+    if (auto expression = parse_between_expression(primary, invert_expression, precedence); expression.has_value())
         return move(expression.value());
 
     if (auto expression = parse_in_expression(primary, invert_expression); expression.has_value())
@@ -367,6 +609,41 @@ bool Parser::match_secondary_expression() const
         || match(TokenType::In);
 }
 
+size_t Parser::secondary_expression_precedence() const
+{
+    // https://sqlite.org/lang_expr.html#operators
+    switch (m_parser_state.m_token.type()) {
+    case TokenType::Collate:
+        return collate_precedence;
+    case TokenType::DoublePipe:
+        return 9;
+    case TokenType::Asterisk:
+    case TokenType::Divide:
+    case TokenType::Modulus:
+        return 8;
+    case TokenType::Plus:
+    case TokenType::Minus:
+        return 7;
+    case TokenType::ShiftLeft:
+    case TokenType::ShiftRight:
+    case TokenType::Ampersand:
+    case TokenType::Pipe:
+        return 6;
+    case TokenType::LessThan:
+    case TokenType::LessThanEquals:
+    case TokenType::GreaterThan:
+    case TokenType::GreaterThanEquals:
+        return 5;
+    case TokenType::And:
+        return 2;
+    case TokenType::Or:
+        return 1;
+    default:
+        // The equality operators, and everything else that compares or matches, including NOT LIKE and the like.
+        return 4;
+    }
+}
+
 Optional<NonnullRefPtr<Expression>> Parser::parse_literal_value_expression()
 {
     if (match(TokenType::NumericLiteral)) {
@@ -424,76 +701,79 @@ Optional<NonnullRefPtr<Expression>> Parser::parse_column_name_expression(String
 
 Optional<NonnullRefPtr<Expression>> Parser::parse_unary_operator_expression()
 {
+    // All unary operators bind more tightly than any binary operator, except for NOT, which only binds more tightly
+    // than AND and OR.
     if (consume_if(TokenType::Minus))
-        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::Minus, parse_expression());
+        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::Minus, parse_expression(collate_precedence));
 
     if (consume_if(TokenType::Plus))
-        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::Plus, parse_expression());
+        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::Plus, parse_expression(collate_precedence));
 
     if (consume_if(TokenType::Tilde))
-        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::BitwiseNot, parse_expression());
+        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::BitwiseNot, parse_expression(collate_precedence));
 
     if (consume_if(TokenType::Not))
-        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::Not, parse_expression());
+        return create_ast_node<UnaryOperatorExpression>(UnaryOperator::Not, parse_expression(not_precedence));
 
     return {};
 }
 
-Optional<NonnullRefPtr<Expression>> Parser::parse_binary_operator_expression(NonnullRefPtr<Expression> lhs)
+Optional<NonnullRefPtr<Expression>> Parser::parse_binary_operator_expression(NonnullRefPtr<Expression> lhs, size_t precedence)
 {
+    // All binary operators are left-associative, so the right-hand side has to bind more tightly than this one.
     if (consume_if(TokenType::DoublePipe))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Concatenate, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Concatenate, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Asterisk))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Multiplication, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Multiplication, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Divide))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Division, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Division, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Modulus))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Modulo, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Modulo, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Plus))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Plus, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Plus, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Minus))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Minus, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Minus, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::ShiftLeft))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::ShiftLeft, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::ShiftLeft, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::ShiftRight))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::ShiftRight, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::ShiftRight, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Ampersand))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::BitwiseAnd, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::BitwiseAnd, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Pipe))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::BitwiseOr, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::BitwiseOr, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::LessThan))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::LessThan, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::LessThan, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::LessThanEquals))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::LessThanEquals, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::LessThanEquals, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::GreaterThan))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::GreaterThan, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::GreaterThan, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::GreaterThanEquals))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::GreaterThanEquals, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::GreaterThanEquals, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Equals) || consume_if(TokenType::EqualsEquals))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Equals, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Equals, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::NotEquals1) || consume_if(TokenType::NotEquals2))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::NotEquals, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::NotEquals, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::And))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::And, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::And, move(lhs), parse_expression(precedence + 1));
 
     if (consume_if(TokenType::Or))
-        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Or, move(lhs), parse_expression());
+        return create_ast_node<BinaryOperatorExpression>(BinaryOperator::Or, move(lhs), parse_expression(precedence + 1));
 
     return {};
 }
@@ -579,7 +859,7 @@ Optional<NonnullRefPtr<Expression>> Parser::parse_collate_expression(NonnullRefP
     return create_ast_node<CollateExpression>(move(expression), move(collation_name));
 }
 
-Optional<NonnullRefPtr<Expression>> Parser::parse_is_expression(NonnullRefPtr<Expression> expression)
+Optional<NonnullRefPtr<Expression>> Parser::parse_is_expression(NonnullRefPtr<Expression> expression, size_t precedence)
 {
     if (!match(TokenType::Is))
         return {};
@@ -592,30 +872,30 @@ Optional<NonnullRefPtr<Expression>> Parser::parse_is_expression(NonnullRefPtr<Ex
         invert_expression = true;
     }
 
-    auto rhs = parse_expression();
+    auto rhs = parse_expression(precedence + 1);
     return create_ast_node<IsExpression>(move(expression), move(rhs), invert_expression);
 }
 
-Optional<NonnullRefPtr<Expression>> Parser::parse_match_expression(NonnullRefPtr<Expression> lhs, bool invert_expression)
+Optional<NonnullRefPtr<Expression>> Parser::parse_match_expression(NonnullRefPtr<Expression> lhs, bool invert_expression, size_t precedence)
 {
-    auto parse_escape = [this]() {
+    auto parse_escape = [this, precedence]() {
         RefPtr<Expression> escape;
         if (consume_if(TokenType::Escape))
-            escape = parse_expression();
+            escape = parse_expression(precedence + 1);
         return escape;
     };
 
     if (consume_if(TokenType::Like))
-        return create_ast_node<MatchExpression>(MatchOperator::Like, move(lhs), parse_expression(), parse_escape(), invert_expression);
+        return create_ast_node<MatchExpression>(MatchOperator::Like, move(lhs), parse_expression(precedence + 1), parse_escape(), invert_expression);
 
     if (consume_if(TokenType::Glob))
-        return create_ast_node<MatchExpression>(MatchOperator::Glob, move(lhs), parse_expression(), parse_escape(), invert_expression);
+        return create_ast_node<MatchExpression>(MatchOperator::Glob, move(lhs), parse_expression(precedence + 1), parse_escape(), invert_expression);
 
     if (consume_if(TokenType::Match))
-        return create_ast_node<MatchExpression>(MatchOperator::Match, move(lhs), parse_expression(), parse_escape(), invert_expression);
+        return create_ast_node<MatchExpression>(MatchOperator::Match, move(lhs), parse_expression(precedence + 1), parse_escape(), invert_expression);
 
     if (consume_if(TokenType::Regexp))
-        return create_ast_node<MatchExpression>(MatchOperator::Regexp, move(lhs), parse_expression(), parse_escape(), invert_expression);
+        return create_ast_node<MatchExpression>(MatchOperator::Regexp, move(lhs), parse_expression(precedence + 1), parse_escape(), invert_expression);
 
     return {};
 }
@@ -631,26 +911,19 @@ Optional<NonnullRefPtr<Expression>> Parser::parse_null_expression(NonnullRefPtr<
     return create_ast_node<NullExpression>(move(expression), invert_expression);
 }
 
-Optional<NonnullRefPtr<Expression>> Parser::parse_between_expression(NonnullRefPtr<Expression> expression, bool invert_expression)
+Optional<NonnullRefPtr<Expression>> Parser::parse_between_expression(NonnullRefPtr<Expression> expression, bool invert_expression, size_t precedence)
 {
     if (!match(TokenType::Between))
         return {};
 
     consume();
 
-    auto nested = parse_expression();
-    if (!is<BinaryOperatorExpression>(*nested)) {
-        expected("Binary Expression");
-        return create_ast_node<ErrorExpression>();
-    }
-
-    const auto& binary_expression = static_cast<const BinaryOperatorExpression&>(*nested);
-    if (binary_expression.type() != BinaryOperator::And) {
-        expected("AND Expression");
-        return create_ast_node<ErrorExpression>();
-    }
+    // Both bounds bind more tightly than AND, so this AND separates them rather than being a binary operator.
+    auto lhs = parse_expression(precedence + 1);
+    consume(TokenType::And);
+    auto rhs = parse_expression(precedence + 1);
 
-    return create_ast_node<BetweenExpression>(move(expression), binary_expression.lhs(), binary_expression.rhs(), invert_expression);
+    return create_ast_node<BetweenExpression>(move(expression), move(lhs), move(rhs), invert_expression);
 }
 
 Optional<NonnullRefPtr<Expression>> Parser::parse_in_expression(NonnullRefPtr<Expression> expression, bool invert_expression)
@@ -859,7 +1132,7 @@ NonnullRefPtr<ResultColumn> Parser::parse_result_column()
 
     auto expression = table_name.is_null()
         ? parse_expression()
-        : static_cast<NonnullRefPtr<Expression>>(*parse_column_name_expression(move(table_name), parsed_period));
+        : parse_expression(0, *parse_column_name_expression(move(table_name), parsed_period));
     consume_if(TokenType::As); // 'AS' is optional.
 
     String column_alias;
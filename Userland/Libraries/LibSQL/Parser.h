@@ -52,27 +52,44 @@ private:
 
     NonnullRefPtr<Statement> parse_statement();
     NonnullRefPtr<Statement> parse_statement_with_expression_list(RefPtr<CommonTableExpressionList>);
+    NonnullRefPtr<Statement> parse_create_statement();
     NonnullRefPtr<CreateTable> parse_create_table_statement();
+    NonnullRefPtr<CreateIndex> parse_create_index_statement();
+    NonnullRefPtr<Statement> parse_drop_statement();
     NonnullRefPtr<DropTable> parse_drop_table_statement();
+    NonnullRefPtr<DropIndex> parse_drop_index_statement();
+    NonnullRefPtr<Insert> parse_insert_statement(RefPtr<CommonTableExpressionList>);
+    NonnullRefPtr<Update> parse_update_statement(RefPtr<CommonTableExpressionList>);
     NonnullRefPtr<Delete> parse_delete_statement(RefPtr<CommonTableExpressionList>);
     NonnullRefPtr<Select> parse_select_statement(RefPtr<CommonTableExpressionList>);
+    NonnullRefPtr<BeginTransaction> parse_begin_transaction_statement();
+    NonnullRefPtr<CommitTransaction> parse_commit_transaction_statement();
+    NonnullRefPtr<RollbackTransaction> parse_rollback_transaction_statement();
     NonnullRefPtr<CommonTableExpressionList> parse_common_table_expression_list();
 
+    // How tightly operators bind, where those that bind more tightly have a higher precedence.
+    static constexpr size_t not_precedence = 3;
+    static constexpr size_t collate_precedence = 10;
+
+    NonnullRefPtr<Expression> parse_expression(size_t minimum_precedence);
+    // Continues parsing an expression that starts with |primary|.
+    NonnullRefPtr<Expression> parse_expression(size_t minimum_precedence, NonnullRefPtr<Expression> primary);
     NonnullRefPtr<Expression> parse_primary_expression();
-    NonnullRefPtr<Expression> parse_secondary_expression(NonnullRefPtr<Expression> primary);
+    NonnullRefPtr<Expression> parse_secondary_expression(NonnullRefPtr<Expression> primary, size_t precedence);
     bool match_secondary_expression() const;
+    size_t secondary_expression_precedence() const;
     Optional<NonnullRefPtr<Expression>> parse_literal_value_expression();
     Optional<NonnullRefPtr<Expression>> parse_column_name_expression(String with_parsed_identifier = {}, bool with_parsed_period = false);
     Optional<NonnullRefPtr<Expression>> parse_unary_operator_expression();
-    Optional<NonnullRefPtr<Expression>> parse_binary_operator_expression(NonnullRefPtr<Expression> lhs);
+    Optional<NonnullRefPtr<Expression>> parse_binary_operator_expression(NonnullRefPtr<Expression> lhs, size_t precedence);
     Optional<NonnullRefPtr<Expression>> parse_chained_expression();
     Optional<NonnullRefPtr<Expression>> parse_cast_expression();
     Optional<NonnullRefPtr<Expression>> parse_case_expression();
     Optional<NonnullRefPtr<Expression>> parse_collate_expression(NonnullRefPtr<Expression> expression);
-    Optional<NonnullRefPtr<Expression>> parse_is_expression(NonnullRefPtr<Expression> expression);
-    Optional<NonnullRefPtr<Expression>> parse_match_expression(NonnullRefPtr<Expression> lhs, bool invert_expression);
+    Optional<NonnullRefPtr<Expression>> parse_is_expression(NonnullRefPtr<Expression> expression, size_t precedence);
+    Optional<NonnullRefPtr<Expression>> parse_match_expression(NonnullRefPtr<Expression> lhs, bool invert_expression, size_t precedence);
     Optional<NonnullRefPtr<Expression>> parse_null_expression(NonnullRefPtr<Expression> expression, bool invert_expression);
-    Optional<NonnullRefPtr<Expression>> parse_between_expression(NonnullRefPtr<Expression> expression, bool invert_expression);
+    Optional<NonnullRefPtr<Expression>> parse_between_expression(NonnullRefPtr<Expression> expression, bool invert_expression, size_t precedence);
     Optional<NonnullRefPtr<Expression>> parse_in_expression(NonnullRefPtr<Expression> expression, bool invert_expression);
 
     NonnullRefPtr<ColumnDefinition> parse_column_definition();
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TypeCasts.h>
+#include <LibSQL/Planner.h>
+#include <math.h>
+
+namespace SQL {
+
+// Guesses of how many of the rows a term lets through, for when the statistics have nothing better to offer.
+static constexpr double equality_selectivity = 0.1;
+static constexpr double range_selectivity = 0.25;
+static constexpr double other_selectivity = 0.5;
+// Reading a row through an index means looking it up in the table after reading its index entry, which is a lot
+// more work than moving a scan on to the next row.
+static constexpr double index_lookup_cost = 3;
+
+struct Term {
+    NonnullRefPtr<Expression> expression;
+    // The tables the term refers to, one bit each.
+    u64 tables { 0 };
+    bool is_placed { false };
+};
+
+// A comparison between a column and a constant, turned around if need be so that the column is on the left.
+struct ColumnComparison {
+    const ColumnNameExpression* column;
+    BinaryOperator type;
+    const Expression* constant;
+};
+
+struct Bounds {
+    Optional<Value> lower;
+    Optional<Value> upper;
+    bool is_equality { false };
+};
+
+// Splits |expression| into the terms that are combined with AND.
+static void collect_conjuncts(const NonnullRefPtr<Expression>& expression, NonnullRefPtrVector<Expression>& conjuncts)
+{
+    if (is<BinaryOperatorExpression>(*expression)) {
+        auto& binary = static_cast<const BinaryOperatorExpression&>(*expression);
+        if (binary.type() == BinaryOperator::And) {
+            collect_conjuncts(binary.lhs(), conjuncts);
+            collect_conjuncts(binary.rhs(), conjuncts);
+            return;
+        }
+    }
+    if (is<ChainedExpression>(*expression)) {
+        auto& chain = static_cast<const ChainedExpression&>(*expression).expressions();
+        if (chain.size() == 1) {
+            collect_conjuncts(chain.ptr_at(0), conjuncts);
+            return;
+        }
+    }
+    conjuncts.append(expression);
+}
+
+static void collect_column_names(const Expression& expression, Vector<const ColumnNameExpression*>& column_names)
+{
+    if (is<ColumnNameExpression>(expression)) {
+        column_names.append(static_cast<const ColumnNameExpression*>(&expression));
+        return;
+    }
+    if (is<NestedExpression>(expression))
+        collect_column_names(*static_cast<const NestedExpression&>(expression).expression(), column_names);
+    if (is<NestedDoubleExpression>(expression)) {
+        auto& nested = static_cast<const NestedDoubleExpression&>(expression);
+        collect_column_names(*nested.lhs(), column_names);
+        collect_column_names(*nested.rhs(), column_names);
+    }
+    if (is<BetweenExpression>(expression))
+        collect_column_names(*static_cast<const BetweenExpression&>(expression).expression(), column_names);
+    if (is<MatchExpression>(expression)) {
+        if (auto& escape = static_cast<const MatchExpression&>(expression).escape(); !escape.is_null())
+            collect_column_names(*escape, column_names);
+    }
+    if (is<InChainedExpression>(expression))
+        collect_column_names(*static_cast<const InChainedExpression&>(expression).expression_chain(), column_names);
+    if (is<ChainedExpression>(expression)) {
+        for (auto& element : static_cast<const ChainedExpression&>(expression).expressions())
+            collect_column_names(element, column_names);
+    }
+    if (is<CaseExpression>(expression)) {
+        auto& case_expression = static_cast<const CaseExpression&>(expression);
+        if (!case_expression.case_expression().is_null())
+            collect_column_names(*case_expression.case_expression(), column_names);
+        for (auto& clause : case_expression.when_then_clauses()) {
+            collect_column_names(*clause.when, column_names);
+            collect_column_names(*clause.then, column_names);
+        }
+        if (!case_expression.else_expression().is_null())
+            collect_column_names(*case_expression.else_expression(), column_names);
+    }
+}
+
+// Finds the tables that |expression| refers to, or nothing if it refers to a column that doesn't exist, or that
+// more than one table has.
+static Optional<u64> referenced_tables(const Expression& expression, const Vector<TableReference>& tables)
+{
+    Vector<const ColumnNameExpression*> column_names;
+    collect_column_names(expression, column_names);
+
+    u64 referenced = 0;
+    for (auto* column_name : column_names) {
+        Optional<size_t> found;
+        for (size_t i = 0; i < tables.size(); ++i) {
+            if (!column_name->table_name().is_empty() && !column_name->table_name().equals_ignoring_case(tables[i].name()))
+                continue;
+            if (!tables[i].table.column_index(column_name->column_name()).has_value() && !column_name->column_name().equals_ignoring_case("rowid"))
+                continue;
+            if (found.has_value())
+                return {};
+            found = i;
+        }
+        if (!found.has_value())
+            return {};
+        referenced |= 1ull << found.value();
+    }
+    return referenced;
+}
+
+static bool is_constant(const Expression& expression)
+{
+    if (is<NumericLiteral>(expression) || is<StringLiteral>(expression))
+        return true;
+    if (is<UnaryOperatorExpression>(expression)) {
+        auto& unary = static_cast<const UnaryOperatorExpression&>(expression);
+        return (unary.type() == UnaryOperator::Minus || unary.type() == UnaryOperator::Plus) && is<NumericLiteral>(*unary.expression());
+    }
+    return false;
+}
+
+static Optional<ColumnComparison> as_column_comparison(const Expression& expression)
+{
+    if (!is<BinaryOperatorExpression>(expression))
+        return {};
+    auto& comparison = static_cast<const BinaryOperatorExpression&>(expression);
+    auto type = comparison.type();
+    const Expression* column = comparison.lhs().ptr();
+    const Expression* constant = comparison.rhs().ptr();
+    if (!is<ColumnNameExpression>(*column)) {
+        swap(column, constant);
+        if (type == BinaryOperator::LessThan)
+            type = BinaryOperator::GreaterThan;
+        else if (type == BinaryOperator::LessThanEquals)
+            type = BinaryOperator::GreaterThanEquals;
+        else if (type == BinaryOperator::GreaterThan)
+            type = BinaryOperator::LessThan;
+        else if (type == BinaryOperator::GreaterThanEquals)
+            type = BinaryOperator::LessThanEquals;
+    }
+    if (!is<ColumnNameExpression>(*column) || !is_constant(*constant))
+        return {};
+    return ColumnComparison { static_cast<const ColumnNameExpression*>(column), type, constant };
+}
+
+// Only comparisons between a column and a constant narrow down an index scan, and the rows it finds are still
+// filtered by all terms afterwards. So this only has to find a range that has all matching rows.
+static Bounds find_bounds(const TableInfo& table, size_t column_index, const Vector<Term*>& terms)
+{
+    Bounds bounds;
+    for (auto* term : terms) {
+        auto comparison = as_column_comparison(*term->expression);
+        if (!comparison.has_value() || !comparison->column->column_name().equals_ignoring_case(table.columns[column_index].name))
+            continue;
+
+        ExecutionContext context;
+        auto value = comparison->constant->evaluate(context);
+        switch (comparison->type) {
+        case BinaryOperator::Equals:
+            return { value, value, true };
+        case BinaryOperator::GreaterThan:
+        case BinaryOperator::GreaterThanEquals:
+            bounds.lower = value;
+            break;
+        case BinaryOperator::LessThan:
+        case BinaryOperator::LessThanEquals:
+            bounds.upper = value;
+            break;
+        default:
+            break;
+        }
+    }
+    return bounds;
+}
+
+static const IndexInfo* index_on_column(const TableInfo& table, const StringView& column_name)
+{
+    auto column_index = table.column_index(column_name);
+    if (!column_index.has_value())
+        return nullptr;
+    for (auto& index : table.indexes) {
+        if (index.column_indices.first() == column_index.value())
+            return &index;
+    }
+    return nullptr;
+}
+
+static double estimate_distinct_values(const TableInfo& table, const StringView& column_name)
+{
+    auto rows = static_cast<double>(table.row_count);
+    if (auto* index = index_on_column(table, column_name))
+        rows /= static_cast<double>(max<i64>(index->rows_per_key, 1));
+    return max(rows, 1.0);
+}
+
+// Guesses the share of the rows of |table| that a term, which only refers to that table, holds for.
+static double estimate_selectivity(const Term& term, const TableInfo& table)
+{
+    if (is<NullExpression>(*term.expression))
+        return static_cast<const NullExpression&>(*term.expression).invert_expression() ? 1 - equality_selectivity : equality_selectivity;
+
+    auto comparison = as_column_comparison(*term.expression);
+    if (!comparison.has_value())
+        return other_selectivity;
+    switch (comparison->type) {
+    case BinaryOperator::Equals:
+        if (index_on_column(table, comparison->column->column_name()))
+            return 1 / estimate_distinct_values(table, comparison->column->column_name());
+        return equality_selectivity;
+    case BinaryOperator::LessThan:
+    case BinaryOperator::LessThanEquals:
+    case BinaryOperator::GreaterThan:
+    case BinaryOperator::GreaterThanEquals:
+        return range_selectivity;
+    default:
+        return other_selectivity;
+    }
+}
+
+// Guesses the share of the pairs of rows of two tables that a term that refers to both holds for. An equality
+// between their columns matches each row to about one row for every time its value is repeated.
+static double estimate_join_selectivity(const Term& term, const Vector<TableReference>& tables)
+{
+    if (!is<BinaryOperatorExpression>(*term.expression))
+        return other_selectivity;
+    auto& comparison = static_cast<const BinaryOperatorExpression&>(*term.expression);
+    if (comparison.type() != BinaryOperator::Equals || !is<ColumnNameExpression>(*comparison.lhs()) || !is<ColumnNameExpression>(*comparison.rhs()))
+        return other_selectivity;
+
+    double distinct_values = 1;
+    for (auto* side : { comparison.lhs().ptr(), comparison.rhs().ptr() }) {
+        auto side_tables = referenced_tables(*side, tables);
+        if (!side_tables.has_value() || side_tables.value() == 0)
+            return other_selectivity;
+        size_t table_index = 0;
+        while (!(side_tables.value() & (1ull << table_index)))
+            ++table_index;
+        auto& table = tables[table_index].table;
+        distinct_values = max(distinct_values, estimate_distinct_values(table, static_cast<const ColumnNameExpression&>(*side).column_name()));
+    }
+    return 1 / distinct_values;
+}
+
+struct AccessPath {
+    OwnPtr<Operator> scan;
+    // How many rows the scan and the terms that only refer to its table are expected to let through.
+    double estimated_rows { 0 };
+};
+
+static AccessPath plan_access_path(BufferPool& pool, const TableReference& reference, const Vector<Term*>& terms)
+{
+    auto& table = reference.table;
+    auto rows = static_cast<double>(table.row_count);
+
+    // A scan reads every row once, whereas an index scan looks each row up in the table, after finding its place in
+    // the index. The rows either finds are then filtered by all terms.
+    double best_cost = rows;
+    const IndexInfo* best_index = nullptr;
+    Bounds best_bounds;
+    for (auto& index : table.indexes) {
+        auto bounds = find_bounds(table, index.column_indices.first(), terms);
+        double matching_rows;
+        if (bounds.is_equality)
+            matching_rows = min(static_cast<double>(index.rows_per_key), rows);
+        else if (bounds.lower.has_value() || bounds.upper.has_value())
+            matching_rows = rows * (bounds.lower.has_value() ? range_selectivity : 1) * (bounds.upper.has_value() ? range_selectivity : 1);
+        else
+            continue;
+        auto cost = log2(rows + 1) + matching_rows * index_lookup_cost;
+        if (cost < best_cost) {
+            best_cost = cost;
+            best_index = &index;
+            best_bounds = move(bounds);
+        }
+    }
+
+    AccessPath path;
+    if (best_index) {
+        // Without a lower bound, the scan starts at the first entry. NULLs sort first, but never match a comparison.
+        Vector<u8> lower_bound;
+        if (best_bounds.lower.has_value())
+            best_bounds.lower->encode_key(lower_bound);
+        else
+            lower_bound.append(2);
+        Optional<Vector<u8>> upper_bound;
+        if (best_bounds.upper.has_value()) {
+            upper_bound = Vector<u8> {};
+            best_bounds.upper->encode_key(upper_bound.value());
+        }
+        path.scan = make<IndexScan>(pool, table, reference.alias, *best_index, move(lower_bound), move(upper_bound));
+    } else {
+        path.scan = make<TableScan>(pool, table, reference.alias);
+    }
+
+    path.estimated_rows = rows;
+    for (auto* term : terms)
+        path.estimated_rows *= estimate_selectivity(*term, table);
+    return path;
+}
+
+static NonnullOwnPtr<Operator> filtered(NonnullOwnPtr<Operator> input, NonnullRefPtrVector<Expression> conditions)
+{
+    if (conditions.is_empty())
+        return input;
+    return make<Filter>(move(input), move(conditions));
+}
+
+Result<NonnullOwnPtr<Operator>, String> Planner::plan(const Vector<TableReference>& tables, const RefPtr<Expression>& where_clause)
+{
+    if (tables.size() > 64)
+        return String { "Too many tables in a join" };
+
+    // Terms whose columns can't be told apart are left to a filter at the top of the plan, which reports the error.
+    Vector<Term> terms;
+    NonnullRefPtrVector<Expression> unresolved_terms;
+    if (!where_clause.is_null()) {
+        NonnullRefPtrVector<Expression> conjuncts;
+        collect_conjuncts(*where_clause, conjuncts);
+        for (auto& conjunct : conjuncts) {
+            auto referenced = referenced_tables(conjunct, tables);
+            if (referenced.has_value())
+                terms.append({ conjunct, referenced.value() });
+            else
+                unresolved_terms.append(conjunct);
+        }
+    }
+
+    if (tables.is_empty()) {
+        NonnullRefPtrVector<Expression> conditions;
+        for (auto& term : terms)
+            conditions.append(term.expression);
+        conditions.append(move(unresolved_terms));
+        return filtered(make<SingleRow>(), move(conditions));
+    }
+
+    // Pick how to read each table, with the terms that only refer to it. Terms that don't refer to any table at all
+    // go with the first one.
+    Vector<AccessPath> paths;
+    Vector<NonnullRefPtrVector<Expression>> local_conditions;
+    for (size_t i = 0; i < tables.size(); ++i) {
+        Vector<Term*> local_terms;
+        NonnullRefPtrVector<Expression> conditions;
+        for (auto& term : terms) {
+            if (term.tables != (1ull << i) && !(term.tables == 0 && i == 0))
+                continue;
+            local_terms.append(&term);
+            conditions.append(term.expression);
+            term.is_placed = true;
+        }
+        paths.append(plan_access_path(m_pool, tables[i], local_terms));
+        local_conditions.append(move(conditions));
+    }
+
+    // Join the tables greedily, starting with the one with the fewest rows, and then adding the one that keeps the
+    // joined rows fewest, applying each term that refers to several tables as soon as they have all been joined.
+    size_t first = 0;
+    for (size_t i = 1; i < tables.size(); ++i) {
+        if (paths[i].estimated_rows < paths[first].estimated_rows)
+            first = i;
+    }
+    NonnullOwnPtr<Operator> plan = filtered(paths[first].scan.release_nonnull(), move(local_conditions[first]));
+    double joined_rows = paths[first].estimated_rows;
+    u64 joined_tables = 1ull << first;
+
+    for (size_t step = 1; step < tables.size(); ++step) {
+        Optional<size_t> best;
+        double best_rows = 0;
+        for (size_t i = 0; i < tables.size(); ++i) {
+            if (joined_tables & (1ull << i))
+                continue;
+            auto tables_after_join = joined_tables | (1ull << i);
+            double rows = joined_rows * paths[i].estimated_rows;
+            for (auto& term : terms) {
+                if (!term.is_placed && (term.tables & ~tables_after_join) == 0)
+                    rows *= estimate_join_selectivity(term, tables);
+            }
+            if (!best.has_value() || rows < best_rows) {
+                best = i;
+                best_rows = rows;
+            }
+        }
+
+        auto next = best.value();
+        auto right = filtered(paths[next].scan.release_nonnull(), move(local_conditions[next]));
+        plan = make<NestedLoopJoin>(move(plan), move(right));
+        joined_rows = best_rows;
+        joined_tables |= 1ull << next;
+
+        NonnullRefPtrVector<Expression> join_conditions;
+        for (auto& term : terms) {
+            if (term.is_placed || (term.tables & ~joined_tables) != 0)
+                continue;
+            join_conditions.append(term.expression);
+            term.is_placed = true;
+        }
+        plan = filtered(move(plan), move(join_conditions));
+    }
+
+    return filtered(move(plan), move(unresolved_terms));
+}
+
+}
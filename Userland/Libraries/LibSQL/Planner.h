@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Result.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/AST.h>
+#include <LibSQL/Catalog.h>
+#include <LibSQL/Operators.h>
+
+namespace SQL {
+
+struct TableReference {
+    TableInfo table;
+    String alias;
+
+    const String& name() const { return alias.is_empty() ? table.name : alias; }
+};
+
+// Decides how to read the rows a statement needs: whether to scan each table or to search one of its indexes, and
+// in which order to join the tables. The choices are based on how many rows each table has, how many rows share a
+// key in each index, and guesses of how many rows each term of the WHERE clause lets through.
+class Planner {
+public:
+    explicit Planner(BufferPool& pool)
+        : m_pool(pool)
+    {
+    }
+
+    // Plans reading the rows of the joined |tables| that |where_clause| holds for. The columns of the tables may come
+    // in any order, each followed by the hidden rowid of its table.
+    Result<NonnullOwnPtr<Operator>, String> plan(const Vector<TableReference>& tables, const RefPtr<Expression>& where_clause);
+
+private:
+    BufferPool& m_pool;
+};
+
+}
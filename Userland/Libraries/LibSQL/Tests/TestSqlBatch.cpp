@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/NumericLimits.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/Batch.h>
+#include <LibSQL/BatchExpression.h>
+#include <LibSQL/Lexer.h>
+#include <LibSQL/Parser.h>
+
+namespace {
+
+class ExpressionParser : public SQL::Parser {
+public:
+    explicit ExpressionParser(SQL::Lexer lexer)
+        : SQL::Parser(move(lexer))
+    {
+    }
+
+    NonnullRefPtr<SQL::Expression> parse()
+    {
+        return SQL::Parser::parse_expression();
+    }
+};
+
+NonnullRefPtr<SQL::Expression> parse(StringView sql)
+{
+    auto parser = ExpressionParser(SQL::Lexer(sql));
+    auto expression = parser.parse();
+    EXPECT(!parser.has_errors());
+    return expression;
+}
+
+String describe(const SQL::Value& value)
+{
+    if (value.is_null())
+        return "NULL";
+    return String::formatted("{}:{}", static_cast<int>(value.type()), value.to_string());
+}
+
+// Evaluates |sql| on the batch of |rows|, and once for each row, and expects the same results from both.
+void expect_same_results_as_rows(StringView sql, const Vector<SQL::Tuple>& rows)
+{
+    Vector<SQL::ColumnBinding> columns { { "t", "a" }, { "t", "b" } };
+    auto expression = parse(sql);
+
+    SQL::Batch batch;
+    batch.reset(columns.size());
+    for (auto& row : rows)
+        batch.append_row(row);
+
+    SQL::ExecutionContext batch_context(columns);
+    auto compiled = SQL::BatchExpression::compile(*expression, batch_context);
+    auto& results = compiled->evaluate(batch, batch_context);
+    EXPECT(!batch_context.has_error());
+    EXPECT_EQ(results.size(), rows.size());
+
+    SQL::ExecutionContext row_context(columns);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        row_context.set_row(rows[i]);
+        auto expected = expression->evaluate(row_context);
+        EXPECT(!row_context.has_error());
+        auto actual = results.value_at(i);
+        if (describe(actual) != describe(expected))
+            warnln("{} on row {}: {} instead of {}", sql, i, describe(actual), describe(expected));
+        EXPECT_EQ(describe(actual), describe(expected));
+    }
+}
+
+}
+
+TEST_CASE(column_vectors_change_kind_as_needed)
+{
+    SQL::ColumnVector column;
+    column.append(SQL::Value {});
+    column.append(SQL::Value(1.5));
+    EXPECT_EQ(column.kind(), SQL::ColumnVector::Kind::Float);
+    EXPECT(column.is_null(0));
+    EXPECT_EQ(column.floats()[1], 1.5);
+
+    column.append(SQL::Value(String("text")));
+    EXPECT_EQ(column.kind(), SQL::ColumnVector::Kind::Mixed);
+    EXPECT(column.value_at(0).is_null());
+    EXPECT_EQ(column.value_at(1).to_string(), "1.5");
+    EXPECT_EQ(column.value_at(2).to_string(), "text");
+
+    u32 rows[] = { 0, 2 };
+    column.select(rows, 2);
+    EXPECT_EQ(column.size(), 2u);
+    EXPECT_EQ(column.value_at(1).to_string(), "text");
+}
+
+TEST_CASE(kernels_match_row_by_row_evaluation)
+{
+    auto max_integer = NumericLimits<i64>::max();
+    Vector<SQL::Tuple> integers;
+    for (i64 a = -3; a <= 3; ++a) {
+        for (i64 b = -3; b <= 3; ++b)
+            integers.append({ SQL::Value(a), SQL::Value(b) });
+        integers.append({ SQL::Value(a), SQL::Value {} });
+    }
+    integers.append({ SQL::Value(max_integer), SQL::Value(static_cast<i64>(2)) });
+    integers.append({ SQL::Value {}, SQL::Value {} });
+
+    Vector<SQL::Tuple> mixed;
+    mixed.append({ SQL::Value(static_cast<i64>(2)), SQL::Value(0.5) });
+    mixed.append({ SQL::Value(-1.25), SQL::Value(static_cast<i64>(-1)) });
+    mixed.append({ SQL::Value(String("10")), SQL::Value(static_cast<i64>(3)) });
+    mixed.append({ SQL::Value {}, SQL::Value(1.0) });
+
+    for (auto sql : { "a + b", "a - b", "a * b", "a / b", "a % b", "-a", "a < b", "a <= b", "a = b", "a <> b",
+             "a >= b", "a > b", "a > 0 AND b > 0", "a > 0 OR b > 0", "NOT a", "a IS NULL", "b NOTNULL", "a || b", "a * 2 + 1" }) {
+        expect_same_results_as_rows(sql, integers);
+        expect_same_results_as_rows(sql, mixed);
+    }
+}
+
+TEST_CASE(select_true_rows)
+{
+    SQL::ColumnVector column;
+    for (auto value : { SQL::Value(static_cast<i64>(1)), SQL::Value {}, SQL::Value(static_cast<i64>(0)), SQL::Value(static_cast<i64>(-2)) })
+        column.append(value);
+    Vector<u32> rows;
+    SQL::select_true_rows(column, rows);
+    EXPECT_EQ(rows, (Vector<u32> { 0, 3 }));
+}
+
+TEST_MAIN(SqlBatch)
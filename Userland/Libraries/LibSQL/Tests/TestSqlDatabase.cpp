@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibSQL/BTree.h>
+#include <LibSQL/BufferPool.h>
+#include <LibSQL/Catalog.h>
+#include <LibSQL/Database.h>
+#include <LibSQL/Lexer.h>
+#include <LibSQL/Parser.h>
+#include <LibSQL/Planner.h>
+#include <LibSQL/Value.h>
+#include <string.h>
+#include <unistd.h>
+
+namespace {
+
+// Removes the database file and its log, both before and after a test.
+class TemporaryDatabasePath {
+public:
+    explicit TemporaryDatabasePath(const char* name)
+        : m_path(String::formatted("/tmp/{}-{}.db", name, getpid()))
+    {
+        remove_files();
+    }
+
+    ~TemporaryDatabasePath() { remove_files(); }
+
+    const String& path() const { return m_path; }
+
+private:
+    void remove_files()
+    {
+        unlink(m_path.characters());
+        unlink(String::formatted("{}-wal", m_path).characters());
+    }
+
+    String m_path;
+};
+
+Vector<u8> encode(const SQL::Value& value)
+{
+    Vector<u8> key;
+    value.encode_key(key);
+    return key;
+}
+
+int compare_keys(const Vector<u8>& a, const Vector<u8>& b)
+{
+    if (auto result = memcmp(a.data(), b.data(), min(a.size(), b.size())); result != 0)
+        return result;
+    return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+}
+
+String key_for(size_t i)
+{
+    return String::formatted("key{:08}", i);
+}
+
+SQL::ResultSet execute(SQL::Database& database, StringView sql)
+{
+    auto result = database.execute(sql);
+    if (result.is_error())
+        warnln("{}: {}", sql, result.error());
+    EXPECT(!result.is_error());
+    return result.is_error() ? SQL::ResultSet {} : result.release_value();
+}
+
+// Describes the plan for the FROM and WHERE clauses of |select|, on the database at |path|, which mustn't be open.
+String plan_for(const String& path, StringView select)
+{
+    auto pool = SQL::BufferPool::open(path).release_value();
+    auto catalog = SQL::Catalog::open(*pool).release_value();
+    auto statement = SQL::Parser(SQL::Lexer(select)).next_statement();
+    auto& select_statement = static_cast<const SQL::Select&>(*statement);
+
+    Vector<SQL::TableReference> tables;
+    for (auto& table : select_statement.table_or_subquery_list())
+        tables.append({ catalog.find_table(table.table_name()).release_value().release_value(), table.table_alias() });
+    SQL::Planner planner(*pool);
+    return planner.plan(tables, select_statement.where_clause()).release_value()->to_string();
+}
+
+Vector<i64> integers_in_first_column(const SQL::ResultSet& result_set)
+{
+    Vector<i64> integers;
+    for (auto& row : result_set.rows)
+        integers.append(row[0].to_integer().value_or(-1));
+    return integers;
+}
+
+}
+
+TEST_CASE(value_keys_sort_like_values)
+{
+    Vector<SQL::Value> values {
+        SQL::Value(),
+        SQL::Value(-1e30),
+        SQL::Value(static_cast<i64>(-5)),
+        SQL::Value(-0.5),
+        SQL::Value(static_cast<i64>(0)),
+        SQL::Value(0.25),
+        SQL::Value(static_cast<i64>(3)),
+        SQL::Value(static_cast<i64>(1000000)),
+        SQL::Value(String("")),
+        SQL::Value(String("a")),
+        SQL::Value(String("ab")),
+        SQL::Value(String("b")),
+    };
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t j = 0; j < values.size(); ++j) {
+            auto key_comparison = compare_keys(encode(values[i]), encode(values[j]));
+            EXPECT_EQ(key_comparison < 0, i < j);
+            EXPECT_EQ(key_comparison == 0, i == j);
+        }
+    }
+
+    EXPECT_EQ(compare_keys(encode(SQL::Value(static_cast<i64>(2))), encode(SQL::Value(2.0))), 0);
+}
+
+TEST_CASE(tuples_round_trip)
+{
+    SQL::Tuple tuple { SQL::Value(), SQL::Value(static_cast<i64>(-42)), SQL::Value(1.5), SQL::Value(String("text")) };
+    Vector<u8> bytes;
+    SQL::serialize_tuple(tuple, bytes);
+
+    auto result = SQL::deserialize_tuple(bytes);
+    EXPECT(result.has_value());
+    EXPECT_EQ(result->size(), tuple.size());
+    for (size_t i = 0; i < tuple.size(); ++i)
+        EXPECT_EQ(result->at(i).compare(tuple[i]), 0);
+    EXPECT(result->at(0).is_null());
+}
+
+TEST_CASE(btree_insert_find_and_remove)
+{
+    TemporaryDatabasePath path("TestSqlDatabase-btree");
+    auto pool = SQL::BufferPool::open(path.path(), 64).release_value();
+    auto root = SQL::BTree::create(*pool).release_value();
+    SQL::BTree tree(*pool, root);
+
+    // Insert in a shuffled order, enough keys to split the root a few times, with every tenth value overflowing.
+    constexpr size_t key_count = 5000;
+    for (size_t n = 0; n < key_count; ++n) {
+        auto i = (n * 7919) % key_count;
+        auto key = key_for(i);
+        auto value = i % 10 == 0 ? String::repeated('v', 3000 + i) : String::number(i);
+        EXPECT(!tree.insert(key.bytes(), value.bytes()).is_error());
+    }
+    EXPECT(!pool->commit().is_error());
+
+    for (size_t i = 0; i < key_count; i += 97) {
+        auto value = tree.find(key_for(i).bytes()).release_value();
+        EXPECT(value.has_value());
+        auto expected = i % 10 == 0 ? String::repeated('v', 3000 + i) : String::number(i);
+        EXPECT_EQ(StringView(value->bytes()), expected);
+    }
+    EXPECT(!tree.find(String("missing").bytes()).release_value().has_value());
+
+    // The cursor walks every key in order.
+    auto cursor = tree.seek({}).release_value();
+    size_t count = 0;
+    while (!cursor.is_end()) {
+        EXPECT_EQ(StringView(cursor.key().bytes()), key_for(count));
+        ++count;
+        EXPECT(!cursor.next().is_error());
+    }
+    EXPECT_EQ(count, key_count);
+
+    for (size_t i = 0; i < key_count; i += 2)
+        EXPECT(tree.remove(key_for(i).bytes()).release_value());
+    EXPECT(!tree.remove(key_for(0).bytes()).release_value());
+    EXPECT(!pool->commit().is_error());
+
+    auto seek_cursor = tree.seek(key_for(1000).bytes()).release_value();
+    EXPECT(!seek_cursor.is_end());
+    EXPECT_EQ(StringView(seek_cursor.key().bytes()), key_for(1001));
+
+    EXPECT(!tree.destroy().is_error());
+    EXPECT(!pool->commit().is_error());
+}
+
+TEST_CASE(buffer_pool_rollback_and_recovery)
+{
+    TemporaryDatabasePath path("TestSqlDatabase-pool");
+    SQL::PageNumber page_number;
+    {
+        auto pool = SQL::BufferPool::open(path.path(), 16).release_value();
+        {
+            auto page = pool->allocate().release_value();
+            page_number = page.number();
+            memset(page.writable_data(), 'a', SQL::BufferPool::page_size);
+        }
+        EXPECT(!pool->commit().is_error());
+
+        {
+            auto page = pool->get(page_number).release_value();
+            memset(page.writable_data(), 'b', SQL::BufferPool::page_size);
+        }
+        pool->rollback();
+        EXPECT_EQ(pool->get(page_number).release_value().data()[0], 'a');
+
+        {
+            auto page = pool->get(page_number).release_value();
+            page.writable_data()[0] = 'c';
+        }
+        EXPECT(!pool->commit().is_error());
+
+        // Pretend to crash: the committed page is only in the log, which is replayed when opening the file again.
+        (void)pool.leak_ptr();
+    }
+
+    auto pool = SQL::BufferPool::open(path.path(), 16).release_value();
+    auto page = pool->get(page_number).release_value();
+    EXPECT_EQ(page.data()[0], 'c');
+    EXPECT_EQ(page.data()[1], 'a');
+}
+
+TEST_CASE(database_statements)
+{
+    TemporaryDatabasePath path("TestSqlDatabase-statements");
+    {
+        auto database = SQL::Database::open(path.path()).release_value();
+        execute(*database, "CREATE TABLE people (id INTEGER, name TEXT, age INTEGER);");
+        EXPECT(database->execute("CREATE TABLE people (id INTEGER);").is_error());
+        execute(*database, "CREATE TABLE IF NOT EXISTS people (id INTEGER);");
+
+        auto insert = execute(*database, "INSERT INTO people VALUES (1, 'Ann', 31), (2, 'Bob', 25), (3, 'Cid', NULL);");
+        EXPECT_EQ(insert.rows_affected, 3u);
+        execute(*database, "INSERT INTO people (name, id) VALUES ('Dee', 4);");
+
+        auto all = execute(*database, "SELECT * FROM people;");
+        EXPECT_EQ(all.column_names.size(), 3u);
+        EXPECT_EQ(integers_in_first_column(all), (Vector<i64> { 1, 2, 3, 4 }));
+
+        auto filtered = execute(*database, "SELECT id, name FROM people WHERE age > 24 AND name <> 'Ann';");
+        EXPECT_EQ(integers_in_first_column(filtered), (Vector<i64> { 2 }));
+        EXPECT_EQ(filtered.rows[0][1].to_string(), "Bob");
+
+        auto ordered = execute(*database, "SELECT id, age * 2 AS double_age FROM people ORDER BY double_age DESC LIMIT 2;");
+        EXPECT_EQ(integers_in_first_column(ordered), (Vector<i64> { 1, 2 }));
+        EXPECT_EQ(ordered.rows[0][1].to_integer().value(), 62);
+
+        auto updated = execute(*database, "UPDATE people SET age = age + 1 WHERE id <= 2;");
+        EXPECT_EQ(updated.rows_affected, 2u);
+        auto deleted = execute(*database, "DELETE FROM people WHERE age IS NULL;");
+        EXPECT_EQ(deleted.rows_affected, 2u);
+        EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT age FROM people;")), (Vector<i64> { 32, 26 }));
+
+        // A failing statement in an explicit transaction rolls back everything since BEGIN.
+        execute(*database, "BEGIN;");
+        execute(*database, "INSERT INTO people VALUES (5, 'Eve', 40);");
+        EXPECT(database->execute("SELECT * FROM nowhere;").is_error());
+        EXPECT(!database->in_explicit_transaction());
+        EXPECT_EQ(execute(*database, "SELECT * FROM people;").rows.size(), 2u);
+
+        execute(*database, "BEGIN;");
+        execute(*database, "INSERT INTO people VALUES (6, 'Fay', 50);");
+        execute(*database, "ROLLBACK;");
+        execute(*database, "BEGIN;");
+        execute(*database, "INSERT INTO people VALUES (7, 'Gus', 60);");
+        execute(*database, "COMMIT;");
+    }
+
+    auto database = SQL::Database::open(path.path()).release_value();
+    EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT id FROM people;")), (Vector<i64> { 1, 2, 7 }));
+    execute(*database, "DROP TABLE people;");
+    EXPECT(database->execute("SELECT * FROM people;").is_error());
+}
+
+TEST_CASE(database_indexes)
+{
+    TemporaryDatabasePath path("TestSqlDatabase-indexes");
+    auto database = SQL::Database::open(path.path()).release_value();
+    execute(*database, "CREATE TABLE numbers (n INTEGER, square INTEGER, label TEXT);");
+
+    execute(*database, "BEGIN;");
+    for (i64 i = 0; i < 2000; ++i)
+        execute(*database, String::formatted("INSERT INTO numbers VALUES ({}, {}, 'number {}');", i, i * i, i));
+    execute(*database, "COMMIT;");
+
+    execute(*database, "CREATE UNIQUE INDEX numbers_n ON numbers (n);");
+    execute(*database, "CREATE INDEX numbers_square ON numbers (square);");
+    EXPECT(database->execute("CREATE INDEX numbers_n ON numbers (square);").is_error());
+
+    EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT n FROM numbers WHERE n = 1234;")), (Vector<i64> { 1234 }));
+    EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT n FROM numbers WHERE 1995 < n;")), (Vector<i64> { 1996, 1997, 1998, 1999 }));
+    EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT n FROM numbers WHERE square >= 100 AND square <= 144 AND n <> 11;")), (Vector<i64> { 10, 12 }));
+
+    auto duplicate = database->execute("INSERT INTO numbers VALUES (5, 0, 'again');");
+    EXPECT(duplicate.is_error());
+    EXPECT(duplicate.error().starts_with("UNIQUE constraint failed"));
+    execute(*database, "INSERT INTO numbers VALUES (NULL, 0, 'no number');");
+    execute(*database, "INSERT INTO numbers VALUES (NULL, 0, 'no number either');");
+
+    // Index entries follow the rows they point to.
+    execute(*database, "UPDATE numbers SET n = n + 10000 WHERE n < 10;");
+    EXPECT(execute(*database, "SELECT n FROM numbers WHERE n = 5;").rows.is_empty());
+    EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT n FROM numbers WHERE n = 10005;")), (Vector<i64> { 10005 }));
+    execute(*database, "DELETE FROM numbers WHERE square = 0;");
+    EXPECT(execute(*database, "SELECT n FROM numbers WHERE n = 10000;").rows.is_empty());
+    EXPECT_EQ(execute(*database, "SELECT * FROM numbers;").rows.size(), 1999u);
+
+    execute(*database, "DROP INDEX numbers_n;");
+    EXPECT(database->execute("DROP INDEX numbers_n;").is_error());
+    execute(*database, "DROP INDEX IF EXISTS numbers_n;");
+    EXPECT_EQ(integers_in_first_column(execute(*database, "SELECT n FROM numbers WHERE n = 1234;")), (Vector<i64> { 1234 }));
+}
+
+TEST_CASE(database_joins_and_distinct)
+{
+    TemporaryDatabasePath path("TestSqlDatabase-joins");
+    auto database = SQL::Database::open(path.path()).release_value();
+    execute(*database, "CREATE TABLE a (x INTEGER);");
+    execute(*database, "CREATE TABLE b (x INTEGER, y TEXT);");
+    execute(*database, "INSERT INTO a VALUES (1), (2), (2), (3);");
+    execute(*database, "INSERT INTO b VALUES (2, 'two'), (3, 'three'), (4, 'four');");
+
+    auto joined = execute(*database, "SELECT a.x, b.y FROM a, b WHERE a.x = b.x ORDER BY 1;");
+    EXPECT_EQ(integers_in_first_column(joined), (Vector<i64> { 2, 2, 3 }));
+    EXPECT(database->execute("SELECT x FROM a, b;").is_error());
+
+    auto distinct = execute(*database, "SELECT DISTINCT x FROM a ORDER BY x DESC;");
+    EXPECT_EQ(integers_in_first_column(distinct), (Vector<i64> { 3, 2, 1 }));
+
+    auto constant = execute(*database, "SELECT 1 + 2, 'a' || 'b';");
+    EXPECT_EQ(constant.rows.size(), 1u);
+    EXPECT_EQ(constant.rows[0][0].to_integer().value(), 3);
+    EXPECT_EQ(constant.rows[0][1].to_string(), "ab");
+}
+
+TEST_CASE(planner_picks_cheapest_access_paths)
+{
+    TemporaryDatabasePath path("TestSqlDatabase-planner");
+    {
+        auto database = SQL::Database::open(path.path()).release_value();
+        execute(*database, "CREATE TABLE big (id INTEGER, parity INTEGER, decade INTEGER);");
+        execute(*database, "CREATE TABLE small (k INTEGER, name TEXT);");
+        execute(*database, "BEGIN;");
+        for (i64 i = 0; i < 1000; ++i)
+            execute(*database, String::formatted("INSERT INTO big VALUES ({}, {}, {});", i, i % 2, i / 10));
+        for (i64 i = 0; i < 5; ++i)
+            execute(*database, String::formatted("INSERT INTO small VALUES ({}, 'name {}');", i, i));
+        execute(*database, "COMMIT;");
+        execute(*database, "CREATE UNIQUE INDEX big_id ON big (id);");
+        execute(*database, "CREATE INDEX big_parity ON big (parity);");
+        execute(*database, "CREATE INDEX big_decade ON big (decade);");
+        execute(*database, "CREATE INDEX small_k ON small (k);");
+        execute(*database, "DELETE FROM big WHERE id >= 990;");
+
+        auto joined = execute(*database, "SELECT big.id, small.name FROM big, small WHERE big.id = small.k AND small.k < 3 ORDER BY 1;");
+        EXPECT_EQ(integers_in_first_column(joined), (Vector<i64> { 0, 1, 2 }));
+        auto decade = execute(*database, "SELECT id FROM big WHERE decade = 42 AND parity = 1;");
+        EXPECT_EQ(integers_in_first_column(decade), (Vector<i64> { 421, 423, 425, 427, 429 }));
+    }
+
+    // A selective equality uses an index, but one that matches half of the rows, or a tiny table, is scanned.
+    EXPECT_EQ(plan_for(path.path(), "SELECT * FROM big WHERE id = 5;"), "Filter(IndexScan(big, big_id))");
+    EXPECT_EQ(plan_for(path.path(), "SELECT * FROM big WHERE parity = 1 AND decade = 42;"), "Filter(IndexScan(big, big_decade))");
+    EXPECT_EQ(plan_for(path.path(), "SELECT * FROM big WHERE parity = 1;"), "Filter(TableScan(big))");
+    EXPECT_EQ(plan_for(path.path(), "SELECT * FROM small WHERE k = 1;"), "Filter(TableScan(small))");
+
+    // The filtered small table goes first, whatever the order of the FROM clause.
+    EXPECT_EQ(plan_for(path.path(), "SELECT * FROM big, small s WHERE big.id = s.k AND s.k < 3;"),
+        "Filter(NestedLoopJoin(Filter(TableScan(small AS s)), TableScan(big)))");
+}
+
+TEST_MAIN(SqlDatabase)
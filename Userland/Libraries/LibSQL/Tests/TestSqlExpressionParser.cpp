@@ -7,6 +7,7 @@
 #include <AK/TestSuite.h>
 
 #include <AK/HashMap.h>
+#include <AK/Optional.h>
 #include <AK/Result.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
@@ -236,6 +237,37 @@ TEST_CASE(binary_operator)
     }
 }
 
+TEST_CASE(operator_precedence)
+{
+    // Checks the operator at the root, and the operators on its left and right, if they are binary operators.
+    auto validate = [](StringView sql, SQL::BinaryOperator expected_operator, Optional<SQL::BinaryOperator> expected_lhs_operator, Optional<SQL::BinaryOperator> expected_rhs_operator) {
+        auto result = parse(sql);
+        EXPECT(!result.is_error());
+
+        auto expression = result.release_value();
+        EXPECT(is<SQL::BinaryOperatorExpression>(*expression));
+
+        const auto& binary = static_cast<const SQL::BinaryOperatorExpression&>(*expression);
+        EXPECT_EQ(binary.type(), expected_operator);
+
+        auto validate_side = [](const SQL::Expression& side, Optional<SQL::BinaryOperator> expected_side_operator) {
+            EXPECT_EQ(is<SQL::BinaryOperatorExpression>(side), expected_side_operator.has_value());
+            if (expected_side_operator.has_value())
+                EXPECT_EQ(static_cast<const SQL::BinaryOperatorExpression&>(side).type(), expected_side_operator.value());
+        };
+        validate_side(*binary.lhs(), expected_lhs_operator);
+        validate_side(*binary.rhs(), expected_rhs_operator);
+    };
+
+    validate("1 + 2 * 3", SQL::BinaryOperator::Plus, {}, SQL::BinaryOperator::Multiplication);
+    validate("1 * 2 + 3", SQL::BinaryOperator::Plus, SQL::BinaryOperator::Multiplication, {});
+    validate("1 - 2 - 3", SQL::BinaryOperator::Minus, SQL::BinaryOperator::Minus, {});
+    validate("a = 1 AND b = 2", SQL::BinaryOperator::And, SQL::BinaryOperator::Equals, SQL::BinaryOperator::Equals);
+    validate("a OR b AND c", SQL::BinaryOperator::Or, {}, SQL::BinaryOperator::And);
+    validate("a < 1 = b > 2", SQL::BinaryOperator::Equals, SQL::BinaryOperator::LessThan, SQL::BinaryOperator::GreaterThan);
+    validate("a || b + c", SQL::BinaryOperator::Plus, SQL::BinaryOperator::Concatenate, {});
+}
+
 TEST_CASE(chained_expression)
 {
     EXPECT(parse("()").is_error());
@@ -398,4 +398,129 @@ TEST_CASE(select)
     validate("SELECT * FROM table LIMIT 15 OFFSET 16;", all, from, false, 0, false, {}, true, true);
 }
 
+TEST_CASE(insert)
+{
+    EXPECT(parse("INSERT").is_error());
+    EXPECT(parse("INSERT INTO").is_error());
+    EXPECT(parse("INSERT INTO table").is_error());
+    EXPECT(parse("INSERT INTO table VALUES").is_error());
+    EXPECT(parse("INSERT INTO table VALUES (1)").is_error());
+    EXPECT(parse("INSERT INTO table (column VALUES (1);").is_error());
+    EXPECT(parse("INSERT INTO table VALUES 1;").is_error());
+
+    auto validate = [](StringView sql, StringView expected_schema, StringView expected_table, Vector<StringView> expected_column_names, Vector<size_t> expected_value_counts) {
+        auto result = parse(sql);
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::Insert>(*statement));
+
+        const auto& insert = static_cast<const SQL::Insert&>(*statement);
+        EXPECT_EQ(insert.schema_name(), expected_schema);
+        EXPECT_EQ(insert.table_name(), expected_table);
+
+        EXPECT_EQ(insert.column_names().size(), expected_column_names.size());
+        for (size_t i = 0; i < insert.column_names().size(); ++i)
+            EXPECT_EQ(insert.column_names()[i], expected_column_names[i]);
+
+        EXPECT_EQ(insert.chained_expressions().size(), expected_value_counts.size());
+        for (size_t i = 0; i < insert.chained_expressions().size(); ++i)
+            EXPECT_EQ(insert.chained_expressions()[i].expressions().size(), expected_value_counts[i]);
+    };
+
+    validate("INSERT INTO table VALUES (1);", {}, "table", {}, { 1 });
+    validate("INSERT INTO schema.table VALUES (1, 2);", "schema", "table", {}, { 2 });
+    validate("INSERT INTO table (column1, column2) VALUES (1, 2), (3, 4), (5, 6);", {}, "table", { "column1", "column2" }, { 2, 2, 2 });
+}
+
+TEST_CASE(update)
+{
+    EXPECT(parse("UPDATE").is_error());
+    EXPECT(parse("UPDATE table").is_error());
+    EXPECT(parse("UPDATE table SET").is_error());
+    EXPECT(parse("UPDATE table SET column").is_error());
+    EXPECT(parse("UPDATE table SET column = 1").is_error());
+    EXPECT(parse("UPDATE table SET column = 1 WHERE;").is_error());
+
+    auto validate = [](StringView sql, StringView expected_table, StringView expected_alias, Vector<StringView> expected_column_names, bool expect_where_clause) {
+        auto result = parse(sql);
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::Update>(*statement));
+
+        const auto& update = static_cast<const SQL::Update&>(*statement);
+        EXPECT_EQ(update.qualified_table_name()->table_name(), expected_table);
+        EXPECT_EQ(update.qualified_table_name()->alias(), expected_alias);
+
+        EXPECT_EQ(update.update_columns().size(), expected_column_names.size());
+        for (size_t i = 0; i < update.update_columns().size(); ++i)
+            EXPECT_EQ(update.update_columns()[i].column_name, expected_column_names[i]);
+
+        EXPECT_EQ(update.where_clause().is_null(), !expect_where_clause);
+    };
+
+    validate("UPDATE table SET column = 1;", "table", {}, { "column" }, false);
+    validate("UPDATE table AS alias SET column1 = 1, column2 = column1 + 1;", "table", "alias", { "column1", "column2" }, false);
+    validate("UPDATE table SET column = 1 WHERE column > 2 AND column < 5;", "table", {}, { "column" }, true);
+}
+
+TEST_CASE(create_index)
+{
+    EXPECT(parse("CREATE INDEX").is_error());
+    EXPECT(parse("CREATE INDEX index").is_error());
+    EXPECT(parse("CREATE INDEX index ON").is_error());
+    EXPECT(parse("CREATE INDEX index ON table").is_error());
+    EXPECT(parse("CREATE INDEX index ON table ()").is_error());
+    EXPECT(parse("CREATE INDEX index ON table (column)").is_error());
+
+    auto validate = [](StringView sql, StringView expected_index, StringView expected_table, Vector<StringView> expected_column_names, bool expected_is_unique, bool expected_is_error_if_index_exists) {
+        auto result = parse(sql);
+        EXPECT(!result.is_error());
+
+        auto statement = result.release_value();
+        EXPECT(is<SQL::CreateIndex>(*statement));
+
+        const auto& index = static_cast<const SQL::CreateIndex&>(*statement);
+        EXPECT_EQ(index.index_name(), expected_index);
+        EXPECT_EQ(index.table_name(), expected_table);
+        EXPECT_EQ(index.is_unique(), expected_is_unique);
+        EXPECT_EQ(index.is_error_if_index_exists(), expected_is_error_if_index_exists);
+
+        EXPECT_EQ(index.column_names().size(), expected_column_names.size());
+        for (size_t i = 0; i < index.column_names().size(); ++i)
+            EXPECT_EQ(index.column_names()[i], expected_column_names[i]);
+    };
+
+    validate("CREATE INDEX index ON table (column);", "index", "table", { "column" }, false, true);
+    validate("CREATE UNIQUE INDEX index ON table (column1, column2);", "index", "table", { "column1", "column2" }, true, true);
+    validate("CREATE INDEX IF NOT EXISTS index ON table (column);", "index", "table", { "column" }, false, false);
+}
+
+TEST_CASE(drop_index)
+{
+    EXPECT(parse("DROP INDEX").is_error());
+    EXPECT(parse("DROP INDEX index").is_error());
+
+    auto result = parse("DROP INDEX IF EXISTS index;");
+    EXPECT(!result.is_error());
+    auto statement = result.release_value();
+    EXPECT(is<SQL::DropIndex>(*statement));
+    EXPECT_EQ(static_cast<const SQL::DropIndex&>(*statement).index_name(), "index");
+    EXPECT(!static_cast<const SQL::DropIndex&>(*statement).is_error_if_index_does_not_exist());
+}
+
+TEST_CASE(transaction)
+{
+    EXPECT(parse("BEGIN").is_error());
+    EXPECT(parse("COMMIT").is_error());
+    EXPECT(parse("ROLLBACK").is_error());
+
+    EXPECT(is<SQL::BeginTransaction>(*parse("BEGIN;").release_value()));
+    EXPECT(is<SQL::BeginTransaction>(*parse("BEGIN IMMEDIATE TRANSACTION;").release_value()));
+    EXPECT(is<SQL::CommitTransaction>(*parse("COMMIT;").release_value()));
+    EXPECT(is<SQL::CommitTransaction>(*parse("END TRANSACTION;").release_value()));
+    EXPECT(is<SQL::RollbackTransaction>(*parse("ROLLBACK TRANSACTION;").release_value()));
+}
+
 TEST_MAIN(SqlStatementParser)
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BitCast.h>
+#include <AK/NumericLimits.h>
+#include <LibSQL/Value.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace SQL {
+
+Affinity affinity_for_type_name(const StringView& type_name)
+{
+    auto upper_type_name = type_name.to_string().to_uppercase();
+    if (upper_type_name.contains("INT"))
+        return Affinity::Integer;
+    if (upper_type_name.contains("CHAR") || upper_type_name.contains("CLOB") || upper_type_name.contains("TEXT"))
+        return Affinity::Text;
+    if (upper_type_name.contains("REAL") || upper_type_name.contains("FLOA") || upper_type_name.contains("DOUB"))
+        return Affinity::Real;
+    return Affinity::None;
+}
+
+static Optional<double> parse_number(const String& text)
+{
+    auto trimmed = text.trim_whitespace();
+    if (trimmed.is_empty())
+        return {};
+    char* end = nullptr;
+    auto value = strtod(trimmed.characters(), &end);
+    if (end != trimmed.characters() + trimmed.length())
+        return {};
+    return value;
+}
+
+static Optional<i64> double_to_integer(double value)
+{
+    if (!isfinite(value) || value < -9223372036854775808.0 || value >= 9223372036854775808.0)
+        return {};
+    return static_cast<i64>(value);
+}
+
+Optional<double> Value::to_double() const
+{
+    switch (m_type) {
+    case ValueType::Integer:
+        return static_cast<double>(m_integer);
+    case ValueType::Float:
+        return m_float;
+    case ValueType::Text:
+        return parse_number(m_text);
+    case ValueType::Null:
+        return {};
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<i64> Value::to_integer() const
+{
+    switch (m_type) {
+    case ValueType::Integer:
+        return m_integer;
+    case ValueType::Float:
+        return double_to_integer(m_float);
+    case ValueType::Text:
+        if (auto integer = m_text.trim_whitespace().to_int<i64>(); integer.has_value())
+            return integer;
+        if (auto number = parse_number(m_text); number.has_value())
+            return double_to_integer(number.value());
+        return {};
+    case ValueType::Null:
+        return {};
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<bool> Value::to_bool() const
+{
+    switch (m_type) {
+    case ValueType::Integer:
+        return m_integer != 0;
+    case ValueType::Float:
+        return m_float != 0;
+    case ValueType::Text:
+        // Just like in SQLite, text that isn't a number is false.
+        return parse_number(m_text).value_or(0) != 0;
+    case ValueType::Null:
+        return {};
+    }
+    VERIFY_NOT_REACHED();
+}
+
+String Value::to_string() const
+{
+    switch (m_type) {
+    case ValueType::Integer:
+        return String::number(m_integer);
+    case ValueType::Float:
+        return String::formatted("{}", m_float);
+    case ValueType::Text:
+        return m_text;
+    case ValueType::Null:
+        return "NULL";
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Value Value::with_affinity(Affinity affinity) const
+{
+    if (is_null())
+        return *this;
+
+    switch (affinity) {
+    case Affinity::Integer:
+        if (m_type == ValueType::Integer)
+            return *this;
+        if (auto number = to_double(); number.has_value()) {
+            auto integer = double_to_integer(number.value());
+            if (integer.has_value() && static_cast<double>(integer.value()) == number.value())
+                return Value(integer.value());
+            if (m_type == ValueType::Text)
+                return Value(number.value());
+        }
+        return *this;
+    case Affinity::Real:
+        if (auto number = to_double(); number.has_value())
+            return Value(number.value());
+        return *this;
+    case Affinity::Text:
+        if (m_type == ValueType::Text)
+            return *this;
+        return Value(to_string());
+    case Affinity::None:
+        return *this;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static int type_order(ValueType type)
+{
+    switch (type) {
+    case ValueType::Null:
+        return 0;
+    case ValueType::Integer:
+    case ValueType::Float:
+        return 1;
+    case ValueType::Text:
+        return 2;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+int Value::compare(const Value& other) const
+{
+    auto order = type_order(m_type);
+    auto other_order = type_order(other.m_type);
+    if (order != other_order)
+        return order < other_order ? -1 : 1;
+
+    switch (m_type) {
+    case ValueType::Null:
+        return 0;
+    case ValueType::Integer:
+    case ValueType::Float: {
+        if (m_type == ValueType::Integer && other.m_type == ValueType::Integer)
+            return m_integer == other.m_integer ? 0 : (m_integer < other.m_integer ? -1 : 1);
+        auto value = to_double().value();
+        auto other_value = other.to_double().value();
+        return value == other_value ? 0 : (value < other_value ? -1 : 1);
+    }
+    case ValueType::Text: {
+        auto length = min(m_text.length(), other.m_text.length());
+        if (auto result = memcmp(m_text.characters(), other.m_text.characters(), length); result != 0)
+            return result < 0 ? -1 : 1;
+        return m_text.length() == other.m_text.length() ? 0 : (m_text.length() < other.m_text.length() ? -1 : 1);
+    }
+    }
+    VERIFY_NOT_REACHED();
+}
+
+static void append_u64_little_endian(Vector<u8>& bytes, u64 value)
+{
+    for (size_t i = 0; i < 8; ++i)
+        bytes.append(static_cast<u8>(value >> (i * 8)));
+}
+
+static u64 read_u64_little_endian(ReadonlyBytes bytes)
+{
+    u64 value = 0;
+    for (size_t i = 0; i < 8; ++i)
+        value |= static_cast<u64>(bytes[i]) << (i * 8);
+    return value;
+}
+
+void Value::serialize(Vector<u8>& bytes) const
+{
+    bytes.append(static_cast<u8>(m_type));
+    switch (m_type) {
+    case ValueType::Null:
+        break;
+    case ValueType::Integer:
+        append_u64_little_endian(bytes, static_cast<u64>(m_integer));
+        break;
+    case ValueType::Float:
+        append_u64_little_endian(bytes, bit_cast<u64>(m_float));
+        break;
+    case ValueType::Text: {
+        u32 length = m_text.length();
+        for (size_t i = 0; i < 4; ++i)
+            bytes.append(static_cast<u8>(length >> (i * 8)));
+        bytes.append(reinterpret_cast<const u8*>(m_text.characters()), length);
+        break;
+    }
+    }
+}
+
+Optional<Value> Value::deserialize(ReadonlyBytes& bytes)
+{
+    if (bytes.is_empty())
+        return {};
+    auto type = bytes[0];
+    bytes = bytes.slice(1);
+
+    switch (static_cast<ValueType>(type)) {
+    case ValueType::Null:
+        return Value();
+    case ValueType::Integer:
+    case ValueType::Float: {
+        if (bytes.size() < 8)
+            return {};
+        auto bits = read_u64_little_endian(bytes);
+        bytes = bytes.slice(8);
+        if (static_cast<ValueType>(type) == ValueType::Integer)
+            return Value(static_cast<i64>(bits));
+        return Value(bit_cast<double>(bits));
+    }
+    case ValueType::Text: {
+        if (bytes.size() < 4)
+            return {};
+        u32 length = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<u32>(bytes[3]) << 24);
+        bytes = bytes.slice(4);
+        if (bytes.size() < length)
+            return {};
+        auto text = String(reinterpret_cast<const char*>(bytes.data()), length);
+        bytes = bytes.slice(length);
+        return Value(move(text));
+    }
+    }
+    return {};
+}
+
+void Value::encode_key(Vector<u8>& bytes) const
+{
+    switch (m_type) {
+    case ValueType::Null:
+        bytes.append(1);
+        break;
+    case ValueType::Integer:
+    case ValueType::Float: {
+        bytes.append(2);
+        auto value = to_double().value();
+        if (value == 0)
+            value = 0; // -0 and 0 are the same key.
+        // Flipping the sign bit of positive numbers, and all bits of negative ones, makes the bits sort like the numbers.
+        auto bits = bit_cast<u64>(value);
+        bits = (bits & (1ull << 63)) ? ~bits : bits | (1ull << 63);
+        for (size_t i = 8; i > 0; --i)
+            bytes.append(static_cast<u8>(bits >> ((i - 1) * 8)));
+        break;
+    }
+    case ValueType::Text:
+        // A 0 byte is escaped as 0 255, so that 0 0 can end the text, and shorter text still sorts first.
+        bytes.append(3);
+        for (auto ch : m_text) {
+            bytes.append(static_cast<u8>(ch));
+            if (ch == 0)
+                bytes.append(255);
+        }
+        bytes.append(0);
+        bytes.append(0);
+        break;
+    }
+}
+
+void serialize_tuple(const Tuple& tuple, Vector<u8>& bytes)
+{
+    VERIFY(tuple.size() <= NumericLimits<u16>::max());
+    bytes.append(static_cast<u8>(tuple.size()));
+    bytes.append(static_cast<u8>(tuple.size() >> 8));
+    for (auto& value : tuple)
+        value.serialize(bytes);
+}
+
+Optional<Tuple> deserialize_tuple(ReadonlyBytes bytes)
+{
+    if (bytes.size() < 2)
+        return {};
+    size_t count = bytes[0] | (bytes[1] << 8);
+    bytes = bytes.slice(2);
+
+    Tuple tuple;
+    tuple.ensure_capacity(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto value = Value::deserialize(bytes);
+        if (!value.has_value())
+            return {};
+        tuple.unchecked_append(value.release_value());
+    }
+    return tuple;
+}
+
+}
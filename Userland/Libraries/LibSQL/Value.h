@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Optional.h>
+#include <AK/Span.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+namespace SQL {
+
+enum class ValueType : u8 {
+    Null,
+    Integer,
+    Float,
+    Text,
+};
+
+// The type a column prefers its values to have, derived from its declared type name the way SQLite does it:
+// https://sqlite.org/datatype3.html#determination_of_column_affinity
+enum class Affinity : u8 {
+    None,
+    Integer,
+    Real,
+    Text,
+};
+
+Affinity affinity_for_type_name(const StringView& type_name);
+
+class Value {
+public:
+    Value() = default;
+
+    explicit Value(i64 value)
+        : m_type(ValueType::Integer)
+        , m_integer(value)
+    {
+    }
+
+    explicit Value(double value)
+        : m_type(ValueType::Float)
+        , m_float(value)
+    {
+    }
+
+    explicit Value(String value)
+        : m_type(ValueType::Text)
+        , m_text(move(value))
+    {
+    }
+
+    ValueType type() const { return m_type; }
+    bool is_null() const { return m_type == ValueType::Null; }
+    bool is_number() const { return m_type == ValueType::Integer || m_type == ValueType::Float; }
+
+    i64 as_integer() const
+    {
+        VERIFY(m_type == ValueType::Integer);
+        return m_integer;
+    }
+
+    double as_float() const
+    {
+        VERIFY(m_type == ValueType::Float);
+        return m_float;
+    }
+
+    const String& as_text() const
+    {
+        VERIFY(m_type == ValueType::Text);
+        return m_text;
+    }
+
+    // Numeric conversions, which fail for text that doesn't look like a number, and for NULL.
+    Optional<double> to_double() const;
+    Optional<i64> to_integer() const;
+    // NULL is neither true nor false.
+    Optional<bool> to_bool() const;
+    String to_string() const;
+
+    Value with_affinity(Affinity) const;
+
+    // NULL sorts before numbers, which sort before text. Integers and floats are compared by their value.
+    int compare(const Value&) const;
+    bool operator==(const Value& other) const { return compare(other) == 0; }
+    bool operator!=(const Value& other) const { return compare(other) != 0; }
+
+    void serialize(Vector<u8>&) const;
+    // Reads a value off the front of |bytes|, or fails if |bytes| doesn't start with a valid one.
+    static Optional<Value> deserialize(ReadonlyBytes& bytes);
+
+    // Appends an encoding of this value that compares with memcmp() the way compare() compares the values, except
+    // that integers beyond 2^53 lose their lowest bits. The encodings of several values can simply be concatenated.
+    void encode_key(Vector<u8>&) const;
+
+private:
+    ValueType m_type { ValueType::Null };
+    i64 m_integer { 0 };
+    double m_float { 0 };
+    String m_text;
+};
+
+using Tuple = Vector<Value>;
+
+void serialize_tuple(const Tuple&, Vector<u8>&);
+Optional<Tuple> deserialize_tuple(ReadonlyBytes);
+
+}
+
+template<>
+struct AK::Formatter<SQL::Value> : Formatter<String> {
+    void format(FormatBuilder& builder, const SQL::Value& value)
+    {
+        Formatter<String>::format(builder, value.to_string());
+    }
+};
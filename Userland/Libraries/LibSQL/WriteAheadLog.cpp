@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteBuffer.h>
+#include <LibSQL/WriteAheadLog.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace SQL {
+
+static constexpr u32 page_record_tag = 0x45474150;   // "PAGE"
+static constexpr u32 commit_record_tag = 0x54494d43; // "CMIT"
+static constexpr size_t record_header_size = 8;
+static constexpr size_t commit_record_size = 16;
+
+// FNV-1a over 64-bit words. It only has to catch a torn write at the end of the log, not an adversary.
+class Checksum {
+public:
+    void update(u32 value) { mix(value); }
+
+    void update(ReadonlyBytes bytes)
+    {
+        VERIFY(bytes.size() % sizeof(u64) == 0);
+        for (size_t offset = 0; offset < bytes.size(); offset += sizeof(u64)) {
+            u64 word;
+            memcpy(&word, bytes.data() + offset, sizeof(word));
+            mix(word);
+        }
+    }
+
+    u64 value() const { return m_value; }
+
+private:
+    void mix(u64 word)
+    {
+        m_value ^= word;
+        m_value *= 0x100000001b3ull;
+    }
+
+    u64 m_value { 0xcbf29ce484222325ull };
+};
+
+static void append_u32(Vector<u8>& buffer, u32 value)
+{
+    buffer.append(reinterpret_cast<const u8*>(&value), sizeof(value));
+}
+
+static u32 read_u32(const u8* data)
+{
+    u32 value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static bool write_fully(int fd, ReadonlyBytes bytes, off_t offset)
+{
+    while (!bytes.is_empty()) {
+        auto nwritten = pwrite(fd, bytes.data(), bytes.size(), offset);
+        if (nwritten < 0 && errno == EINTR)
+            continue;
+        if (nwritten <= 0)
+            return false;
+        bytes = bytes.slice(nwritten);
+        offset += nwritten;
+    }
+    return true;
+}
+
+static bool read_fully(int fd, Bytes bytes, off_t offset)
+{
+    while (!bytes.is_empty()) {
+        auto nread = pread(fd, bytes.data(), bytes.size(), offset);
+        if (nread < 0 && errno == EINTR)
+            continue;
+        if (nread <= 0)
+            return false;
+        bytes = bytes.slice(nread);
+        offset += nread;
+    }
+    return true;
+}
+
+Result<NonnullOwnPtr<WriteAheadLog>, String> WriteAheadLog::open(const String& path, size_t page_size)
+{
+    int fd = ::open(path.characters(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return String::formatted("Could not open {}: {}", path, strerror(errno));
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        auto error = String::formatted("Could not stat {}: {}", path, strerror(errno));
+        close(fd);
+        return error;
+    }
+    return adopt_own(*new WriteAheadLog(fd, page_size, st.st_size));
+}
+
+WriteAheadLog::WriteAheadLog(int fd, size_t page_size, size_t size)
+    : m_fd(fd)
+    , m_page_size(page_size)
+    , m_size(size)
+{
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    close(m_fd);
+}
+
+Result<void, String> WriteAheadLog::append_transaction(const Vector<PageImage>& pages)
+{
+    Vector<u8> buffer;
+    buffer.ensure_capacity(pages.size() * (record_header_size + m_page_size) + commit_record_size);
+
+    Checksum checksum;
+    for (auto& page : pages) {
+        VERIFY(page.data.size() == m_page_size);
+        append_u32(buffer, page_record_tag);
+        append_u32(buffer, page.page_number);
+        buffer.append(page.data.data(), page.data.size());
+        checksum.update(page.page_number);
+        checksum.update(page.data);
+    }
+    append_u32(buffer, commit_record_tag);
+    append_u32(buffer, pages.size());
+    auto checksum_value = checksum.value();
+    buffer.append(reinterpret_cast<const u8*>(&checksum_value), sizeof(checksum_value));
+
+    if (!write_fully(m_fd, buffer.span(), m_size) || fsync(m_fd) < 0)
+        return String::formatted("Could not write to the log: {}", strerror(errno));
+    m_size += buffer.size();
+    return {};
+}
+
+Result<void, String> WriteAheadLog::recover(int database_fd)
+{
+    struct PageRecord {
+        u32 page_number;
+        off_t offset;
+    };
+    Vector<PageRecord> transaction_pages;
+    Checksum checksum;
+    auto page = ByteBuffer::create_uninitialized(m_page_size);
+    bool has_recovered_pages = false;
+
+    off_t offset = 0;
+    u8 header[commit_record_size];
+    while (offset + record_header_size <= m_size && read_fully(m_fd, { header, record_header_size }, offset)) {
+        auto tag = read_u32(header);
+        if (tag == page_record_tag) {
+            auto page_number = read_u32(header + 4);
+            if (offset + record_header_size + m_page_size > m_size || !read_fully(m_fd, page, offset + record_header_size))
+                break;
+            checksum.update(page_number);
+            checksum.update(page.bytes());
+            transaction_pages.append({ page_number, offset + (off_t)record_header_size });
+            offset += record_header_size + m_page_size;
+            continue;
+        }
+
+        if (tag != commit_record_tag || offset + commit_record_size > m_size || !read_fully(m_fd, { header, commit_record_size }, offset))
+            break;
+        u64 stored_checksum;
+        memcpy(&stored_checksum, header + 8, sizeof(stored_checksum));
+        if (read_u32(header + 4) != transaction_pages.size() || stored_checksum != checksum.value())
+            break;
+
+        // This transaction is complete, so its pages can go where they belong.
+        for (auto& record : transaction_pages) {
+            if (!read_fully(m_fd, page, record.offset) || !write_fully(database_fd, page, (off_t)record.page_number * m_page_size))
+                return String::formatted("Could not recover from the log: {}", strerror(errno));
+        }
+        has_recovered_pages |= !transaction_pages.is_empty();
+        transaction_pages.clear();
+        checksum = {};
+        offset += commit_record_size;
+    }
+
+    if (has_recovered_pages && fsync(database_fd) < 0)
+        return String::formatted("Could not recover from the log: {}", strerror(errno));
+    return reset();
+}
+
+Result<void, String> WriteAheadLog::reset()
+{
+    if (m_size == 0)
+        return {};
+    if (ftruncate(m_fd, 0) < 0 || fsync(m_fd) < 0)
+        return String::formatted("Could not empty the log: {}", strerror(errno));
+    m_size = 0;
+    return {};
+}
+
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Result.h>
+#include <AK/Span.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+namespace SQL {
+
+// A redo log of whole pages. Committing a transaction appends the new contents of every page it changed, followed
+// by a commit record with a checksum over all of them, and syncs the log. Only then may the pages themselves be
+// written to the database file, so if we crash at any point, replaying the complete transactions in the log brings
+// the database file up to date again. A transaction whose commit record didn't make it to the disk is ignored.
+class WriteAheadLog {
+    AK_MAKE_NONCOPYABLE(WriteAheadLog);
+    AK_MAKE_NONMOVABLE(WriteAheadLog);
+
+public:
+    struct PageImage {
+        u32 page_number;
+        ReadonlyBytes data;
+    };
+
+    static Result<NonnullOwnPtr<WriteAheadLog>, String> open(const String& path, size_t page_size);
+    ~WriteAheadLog();
+
+    // Returns once the transaction is on the disk.
+    Result<void, String> append_transaction(const Vector<PageImage>&);
+
+    // Writes the pages of every complete transaction in the log to |database_fd|, syncs it, and empties the log.
+    Result<void, String> recover(int database_fd);
+
+    // Empties the log, once all the pages in it have made it into the database file.
+    Result<void, String> reset();
+
+    size_t size() const { return m_size; }
+
+private:
+    WriteAheadLog(int fd, size_t page_size, size_t size);
+
+    int m_fd { -1 };
+    size_t m_page_size { 0 };
+    size_t m_size { 0 };
+};
+
+}
@@ -42,6 +42,32 @@ Optional<Symbol> Client::symbolicate(const String& path, FlatPtr address)
     };
 }
 
+Vector<Optional<Symbol>> Client::symbolicate(const Vector<String>& paths, const Vector<FlatPtr>& addresses)
+{
+    VERIFY(paths.size() == addresses.size());
+    Vector<u32> addresses_to_send;
+    addresses_to_send.ensure_capacity(addresses.size());
+    for (auto address : addresses)
+        addresses_to_send.unchecked_append(address);
+
+    auto response = send_sync<Messages::SymbolServer::SymbolicateBatch>(paths, addresses_to_send);
+    Vector<Optional<Symbol>> symbols;
+    symbols.ensure_capacity(addresses.size());
+    for (size_t i = 0; i < addresses.size(); ++i) {
+        if (!response->successes()[i]) {
+            symbols.unchecked_append({});
+            continue;
+        }
+        symbols.unchecked_append(Symbol {
+            .address = addresses[i],
+            .name = response->names()[i],
+            .offset = response->offsets()[i],
+            .filename = response->filenames()[i],
+            .line_number = response->lines()[i] });
+    }
+    return symbols;
+}
+
 Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid)
 {
     struct RegionWithSymbols {
@@ -121,9 +147,11 @@ Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid)
         }
     }
 
-    auto client = SymbolClient::Client::construct();
-
     Vector<Symbol> symbols;
+    // Frames that fall inside a region with symbols, and the addresses to look up for them.
+    Vector<size_t> frames_to_symbolicate;
+    Vector<String> paths;
+    Vector<FlatPtr> adjusted_addresses;
 
     for (auto address : stack) {
         const RegionWithSymbols* found_region = nullptr;
@@ -145,15 +173,23 @@ Vector<Symbol> symbolicate_thread(pid_t pid, pid_t tid)
         else
             adjusted_address = address;
 
-        auto result = client->symbolicate(found_region->path, adjusted_address);
-        if (!result.has_value()) {
-            symbols.append(Symbol {
-                .address = address,
-            });
-            continue;
-        }
+        frames_to_symbolicate.append(symbols.size());
+        paths.append(found_region->path);
+        adjusted_addresses.append(adjusted_address);
+        symbols.append(Symbol {
+            .address = address,
+        });
+    }
 
-        symbols.append(result.value());
+    if (frames_to_symbolicate.is_empty())
+        return symbols;
+
+    auto client = SymbolClient::Client::construct();
+    auto results = client->symbolicate(paths, adjusted_addresses);
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].has_value())
+            continue;
+        symbols[frames_to_symbolicate[i]] = results[i].release_value();
     }
     return symbols;
 }
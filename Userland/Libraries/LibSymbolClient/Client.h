@@ -31,6 +31,8 @@ public:
     virtual void handshake() override;
 
     Optional<Symbol> symbolicate(const String& path, FlatPtr address);
+    // Symbolicates every address in the file at the same index of |paths|, all in one round trip.
+    Vector<Optional<Symbol>> symbolicate(const Vector<String>& paths, const Vector<FlatPtr>& addresses);
 
 private:
     Client();
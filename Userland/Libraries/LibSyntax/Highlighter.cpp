@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/StringBuilder.h>
 #include <LibGUI/TextEditor.h>
 #include <LibGfx/Color.h>
 #include <LibSyntax/Highlighter.h>
@@ -109,6 +110,8 @@ void Highlighter::attach(HighlighterClient& client)
 {
     VERIFY(!m_client);
     m_client = &client;
+    m_highlighted_line_generations.clear();
+    m_span_is_restart_point.clear();
 }
 
 void Highlighter::detach()
@@ -116,18 +119,159 @@ void Highlighter::detach()
     m_client = nullptr;
 }
 
-void Highlighter::cursor_did_change()
+void Highlighter::clear_brace_buddies()
 {
+    if (!m_has_brace_buddies)
+        return;
     auto& document = m_client->get_document();
+    if (m_brace_buddies[0].index >= 0 && m_brace_buddies[0].index < static_cast<int>(document.spans().size()))
+        document.set_span_at_index(m_brace_buddies[0].index, m_brace_buddies[0].span_backup);
+    if (m_brace_buddies[1].index >= 0 && m_brace_buddies[1].index < static_cast<int>(document.spans().size()))
+        document.set_span_at_index(m_brace_buddies[1].index, m_brace_buddies[1].span_backup);
+    m_has_brace_buddies = false;
+}
+
+void Highlighter::cursor_did_change()
+{
     if (m_has_brace_buddies) {
-        if (m_brace_buddies[0].index >= 0 && m_brace_buddies[0].index < static_cast<int>(document.spans().size()))
-            document.set_span_at_index(m_brace_buddies[0].index, m_brace_buddies[0].span_backup);
-        if (m_brace_buddies[1].index >= 0 && m_brace_buddies[1].index < static_cast<int>(document.spans().size()))
-            document.set_span_at_index(m_brace_buddies[1].index, m_brace_buddies[1].span_backup);
-        m_has_brace_buddies = false;
+        clear_brace_buddies();
         m_client->do_update();
     }
     highlight_matching_token_pair();
 }
 
+void Highlighter::rehighlight_from_scratch(const Palette& palette)
+{
+    m_highlighted_line_generations.clear();
+    m_span_is_restart_point.clear();
+    rehighlight(palette);
+}
+
+void Highlighter::relex_changed_lines(const Palette& palette)
+{
+    auto& document = m_client->get_document();
+    clear_brace_buddies();
+    auto& old_spans = document.spans();
+
+    size_t line_count = document.line_count();
+    size_t old_line_count = m_highlighted_line_generations.size();
+    bool has_old_spans = old_line_count > 0 && old_spans.size() == m_span_is_restart_point.size();
+    size_t old_span_count = has_old_spans ? old_spans.size() : 0;
+
+    // A line that has the same generation as last time hasn't changed since. Find the lines that have, from
+    // |first_changed_line| up to the |unchanged_line_count| lines at the end.
+    size_t first_changed_line = 0;
+    size_t unchanged_line_count = 0;
+    if (has_old_spans) {
+        size_t common_line_count = min(line_count, old_line_count);
+        while (first_changed_line < common_line_count && m_highlighted_line_generations[first_changed_line] == document.line(first_changed_line).generation())
+            ++first_changed_line;
+        if (first_changed_line == line_count && line_count == old_line_count)
+            return;
+        while (unchanged_line_count < common_line_count - first_changed_line
+            && m_highlighted_line_generations[old_line_count - 1 - unchanged_line_count] == document.line(line_count - 1 - unchanged_line_count).generation())
+            ++unchanged_line_count;
+    }
+    size_t end_of_changed_lines = line_count - unchanged_line_count;
+    size_t old_end_of_changed_lines = old_line_count - unchanged_line_count;
+
+    // Start over at the last restart point before the changed lines. The spans before it stay as they are.
+    size_t kept_span_count = 0;
+    {
+        size_t low = 0;
+        size_t high = old_span_count;
+        while (low < high) {
+            auto middle = low + (high - low) / 2;
+            if (old_spans[middle].range.start().line() < first_changed_line)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+        while (low > 0 && !m_span_is_restart_point[low - 1])
+            --low;
+        kept_span_count = low > 0 ? low - 1 : 0;
+    }
+    GUI::TextPosition restart_position { 0, 0 };
+    if (kept_span_count < old_span_count && m_span_is_restart_point[kept_span_count] && old_spans[kept_span_count].range.start().line() < first_changed_line)
+        restart_position = old_spans[kept_span_count].range.start();
+    else
+        kept_span_count = 0;
+
+    // Lex a chunk of lines at a time, as the end of the chunk cuts off the tokens there. Once the lexer emits a restart
+    // point past the changed lines, where the last spans had one as well, the rest of the spans would be the same too.
+    Vector<GUI::TextDocumentSpan> relexed_spans;
+    Vector<bool> relexed_span_is_restart_point;
+    Optional<size_t> first_reused_span;
+    size_t chunk_line_count = end_of_changed_lines - restart_position.line() + 256;
+    for (;;) {
+        size_t end_of_chunk = min(line_count, restart_position.line() + chunk_line_count);
+        bool chunk_reaches_end = end_of_chunk == line_count;
+        StringBuilder builder;
+        for (size_t line_index = restart_position.line(); line_index < end_of_chunk; ++line_index) {
+            builder.append(document.line(line_index).view());
+            if (line_index + 1 < line_count)
+                builder.append('\n');
+        }
+
+        relexed_spans.clear_with_capacity();
+        relexed_span_is_restart_point.clear_with_capacity();
+        size_t old_span_index = kept_span_count;
+        auto text = builder.string_view().substring_view(restart_position.column());
+        lex_for_highlighting(text, palette, [&](auto span, bool is_restart_point) {
+            auto to_document_position = [&](const GUI::TextPosition& position) -> GUI::TextPosition {
+                if (position.line() == 0)
+                    return { restart_position.line(), restart_position.column() + position.column() };
+                return { restart_position.line() + position.line(), position.column() };
+            };
+            span.range.set_start(to_document_position(span.range.start()));
+            span.range.set_end(to_document_position(span.range.end()));
+
+            // A token that reaches the last line of the chunk might go on past it.
+            auto start = span.range.start();
+            if (!chunk_reaches_end && span.range.end().line() + 1 >= end_of_chunk)
+                return IterationDecision::Break;
+            if (is_restart_point && start.line() >= end_of_changed_lines) {
+                GUI::TextPosition old_start { start.line() - end_of_changed_lines + old_end_of_changed_lines, start.column() };
+                while (old_span_index < old_span_count && old_spans[old_span_index].range.start() < old_start)
+                    ++old_span_index;
+                if (old_span_index < old_span_count && old_spans[old_span_index].range.start() == old_start && m_span_is_restart_point[old_span_index]) {
+                    first_reused_span = old_span_index;
+                    return IterationDecision::Break;
+                }
+            }
+            relexed_spans.append(move(span));
+            relexed_span_is_restart_point.append(is_restart_point);
+            return IterationDecision::Continue;
+        });
+
+        if (first_reused_span.has_value() || chunk_reaches_end)
+            break;
+        chunk_line_count *= 2;
+    }
+
+    size_t reused_span_count = first_reused_span.has_value() ? old_span_count - first_reused_span.value() : 0;
+    Vector<GUI::TextDocumentSpan> spans;
+    Vector<bool> span_is_restart_point;
+    spans.ensure_capacity(kept_span_count + relexed_spans.size() + reused_span_count);
+    span_is_restart_point.ensure_capacity(spans.capacity());
+    spans.append(old_spans.data(), kept_span_count);
+    span_is_restart_point.append(m_span_is_restart_point.data(), kept_span_count);
+    spans.append(move(relexed_spans));
+    span_is_restart_point.append(move(relexed_span_is_restart_point));
+    for (size_t i = old_span_count - reused_span_count; i < old_span_count; ++i) {
+        auto span = old_spans[i];
+        span.range.set_start({ span.range.start().line() - old_end_of_changed_lines + end_of_changed_lines, span.range.start().column() });
+        span.range.set_end({ span.range.end().line() - old_end_of_changed_lines + end_of_changed_lines, span.range.end().column() });
+        spans.append(move(span));
+        span_is_restart_point.append(m_span_is_restart_point[i]);
+    }
+
+    m_span_is_restart_point = move(span_is_restart_point);
+    m_highlighted_line_generations.clear_with_capacity();
+    m_highlighted_line_generations.ensure_capacity(line_count);
+    for (size_t line_index = 0; line_index < line_count; ++line_index)
+        m_highlighted_line_generations.append(document.line(line_index).generation());
+    m_client->do_set_spans(move(spans));
+}
+
 }
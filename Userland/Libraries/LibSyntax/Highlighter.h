@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <AK/Function.h>
+#include <AK/IterationDecision.h>
 #include <AK/Noncopyable.h>
 #include <AK/WeakPtr.h>
 #include <LibGUI/TextDocument.h>
@@ -37,6 +39,9 @@ public:
 
     virtual Language language() const = 0;
     virtual void rehighlight(const Palette&) = 0;
+    // Highlights all of the text again, rather than just what changed since the last time. This is needed when
+    // something besides the text changes what the spans look like, such as the palette.
+    void rehighlight_from_scratch(const Palette&);
     virtual void highlight_matching_token_pair();
 
     virtual bool is_identifier(void*) const { return false; };
@@ -60,6 +65,16 @@ protected:
     virtual Vector<MatchingTokenPair> matching_token_pairs() const = 0;
     virtual bool token_types_equal(void*, void*) const = 0;
 
+    // Highlighters whose lexer can start over at some of the tokens it emits can implement lex_for_highlighting(),
+    // and call relex_changed_lines() from rehighlight(). That sets the spans like lexing all of the text would, but
+    // only lexes from the last restart point before the lines that changed since the last time, until the tokens
+    // are back in step with the ones from the last time.
+    // lex_for_highlighting() should call back with a span for each token of |text|, and whether it is a restart
+    // point, until the callback returns IterationDecision::Break.
+    using SpanCallback = Function<IterationDecision(GUI::TextDocumentSpan, bool is_restart_point)>;
+    virtual void lex_for_highlighting([[maybe_unused]] const StringView& text, const Palette&, SpanCallback) { VERIFY_NOT_REACHED(); }
+    void relex_changed_lines(const Palette&);
+
     struct BuddySpan {
         int index { -1 };
         GUI::TextDocumentSpan span_backup;
@@ -67,6 +82,13 @@ protected:
 
     bool m_has_brace_buddies { false };
     BuddySpan m_brace_buddies[2];
+
+private:
+    void clear_brace_buddies();
+
+    // What relex_changed_lines() last left behind: the generation of each line, and which spans are restart points.
+    Vector<u64> m_highlighted_line_generations;
+    Vector<bool> m_span_is_restart_point;
 };
 
 }
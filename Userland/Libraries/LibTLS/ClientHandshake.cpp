@@ -94,6 +94,15 @@ ssize_t TLSv12::handle_hello(ReadonlyBytes buffer, WritePacketStage& write_packe
     m_context.cipher = cipher;
     dbgln_if(TLS_DEBUG, "Cipher: {}", (u16)cipher);
 
+    // The server agrees to resume a session by echoing its ID back to us.
+    if (m_context.session_to_resume.has_value()) {
+        auto& session = m_context.session_to_resume.value();
+        m_context.is_resumed_session = session.id.size() == session_length
+            && session.id.bytes() == ReadonlyBytes { m_context.session_id, m_context.session_id_size }
+            && session.cipher == cipher;
+        dbgln_if(TLS_DEBUG, "Server {} to resume our session", m_context.is_resumed_session ? "agreed" : "declined");
+    }
+
     // The handshake hash function is _always_ SHA256
     m_context.handshake_hash.initialize(Crypto::Hash::HashKind::SHA256);
 
@@ -164,15 +173,17 @@ ssize_t TLSv12::handle_hello(ReadonlyBytes buffer, WritePacketStage& write_packe
                     size_t alpn_position = 0;
                     while (alpn_position < alpn_length) {
                         u8 alpn_size = alpn[alpn_position++];
-                        if (alpn_size + alpn_position >= extension_length)
+                        if (alpn_size + alpn_position > alpn_length)
                             break;
-                        String alpn_str { (const char*)alpn + alpn_position, alpn_length };
-                        if (alpn_size && m_context.alpn.contains_slow(alpn_str)) {
-                            m_context.negotiated_alpn = alpn_str;
+                        StringView alpn_str { alpn + alpn_position, alpn_size };
+                        // Keep a view of our own copy, as the buffer goes away after this.
+                        auto it = m_context.alpn.find_if([&](auto& supported_alpn) { return supported_alpn == alpn_str; });
+                        if (alpn_size && !it.is_end()) {
+                            m_context.negotiated_alpn = *it;
                             dbgln("negotiated alpn: {}", alpn_str);
                             break;
                         }
-                        alpn_position += alpn_length;
+                        alpn_position += alpn_size;
                         if (!m_context.is_server) // server hello must contain one ALPN
                             break;
                     }
@@ -190,6 +201,14 @@ ssize_t TLSv12::handle_hello(ReadonlyBytes buffer, WritePacketStage& write_packe
         }
     }
 
+    if (m_context.is_resumed_session) {
+        m_context.master_key = ByteBuffer::copy(m_context.session_to_resume->master_key.bytes());
+        if (!expand_key())
+            return (i8)Error::NotUnderstood;
+        // There's no key exchange, the server goes straight to ChangeCipherSpec and Finished.
+        m_context.connection_status = ConnectionStatus::KeyExchange;
+    }
+
     return res;
 }
 
@@ -231,6 +250,13 @@ ssize_t TLSv12::handle_finished(ReadonlyBytes buffer, WritePacketStage& write_pa
         m_handshake_timeout_timer = nullptr;
     }
 
+    // In an abbreviated handshake the server finishes first, and we can't let the client
+    // write anything before our own Finished has gone out.
+    if (m_context.is_resumed_session) {
+        write_packets = WritePacketStage::Finished;
+        return index + size;
+    }
+
     if (on_tls_ready_to_write)
         on_tls_ready_to_write(*this);
 
@@ -611,6 +637,8 @@ ssize_t TLSv12::handle_payload(ReadonlyBytes vbuffer)
                 write_packet(packet);
             }
             m_context.connection_status = ConnectionStatus::Established;
+            if (on_tls_ready_to_write)
+                on_tls_ready_to_write(*this);
             break;
         }
         payload_size++;
@@ -87,8 +87,21 @@ ByteBuffer TLSv12::build_hello()
     }
 
     if (alpn_length) {
-        // TODO
-        VERIFY_NOT_REACHED();
+        // ALPN extension
+        builder.append((u16)HandshakeExtension::ApplicationLayerProtocolNegotiation);
+        // extension length
+        builder.append((u16)(alpn_length + 2));
+        // protocol name list length
+        builder.append((u16)alpn_length);
+        if (alpn_negotiated_length) {
+            builder.append((u8)alpn_negotiated_length);
+            builder.append((const u8*)m_context.negotiated_alpn.characters_without_null_termination(), alpn_negotiated_length);
+        } else {
+            for (auto& alpn : m_context.alpn) {
+                builder.append((u8)alpn.length());
+                builder.append((const u8*)alpn.characters(), alpn.length());
+            }
+        }
     }
 
     // set the "length" field of the packet
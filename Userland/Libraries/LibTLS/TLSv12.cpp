@@ -764,6 +764,40 @@ void TLSv12::try_disambiguate_error() const
     }
 }
 
+void TLSv12::add_alpn(const StringView& alpn)
+{
+    m_context.alpn.append(alpn);
+}
+
+bool TLSv12::has_alpn(const StringView& alpn) const
+{
+    return m_context.alpn.contains_slow(alpn);
+}
+
+void TLSv12::set_session_to_resume(Session session)
+{
+    if (m_context.is_server || m_context.critical_error || m_context.connection_status != ConnectionStatus::Disconnected) {
+        dbgln("invalid state for set_session_to_resume");
+        return;
+    }
+    if (session.id.is_empty() || session.id.size() > sizeof(m_context.session_id) || session.master_key.is_empty())
+        return;
+    memcpy(m_context.session_id, session.id.data(), session.id.size());
+    m_context.session_id_size = session.id.size();
+    m_context.session_to_resume = move(session);
+}
+
+Optional<Session> TLSv12::session() const
+{
+    if (!is_established() || m_context.session_id_size == 0 || m_context.master_key.is_empty())
+        return {};
+    return Session {
+        ByteBuffer::copy(m_context.session_id, m_context.session_id_size),
+        m_context.cipher,
+        ByteBuffer::copy(m_context.master_key.bytes()),
+    };
+}
+
 void TLSv12::set_root_certificates(Vector<Certificate> certificates)
 {
     if (!m_context.root_ceritificates.is_empty())
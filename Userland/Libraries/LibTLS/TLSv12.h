@@ -200,6 +200,14 @@ struct Options {
 #undef OPTION_WITH_DEFAULTS
 };
 
+// What it takes to resume a session through an abbreviated handshake (RFC 5246 section 7.3),
+// which skips both the key exchange and the certificate checks.
+struct Session {
+    ByteBuffer id;
+    CipherSuite cipher { CipherSuite::Invalid };
+    ByteBuffer master_key;
+};
+
 struct Context {
     String to_string() const;
     bool verify() const;
@@ -213,6 +221,8 @@ struct Context {
     u8 local_random[32];
     u8 session_id[32];
     u8 session_id_size { 0 };
+    Optional<Session> session_to_resume;
+    bool is_resumed_session { false };
     CipherSuite cipher;
     bool is_server { false };
     Vector<Certificate> certificates;
@@ -304,6 +314,12 @@ public:
 
     ByteBuffer finish_build();
 
+    // Must be called before connecting. The server is free to ignore it and do a full handshake.
+    void set_session_to_resume(Session);
+    // The session a later connection to the same server can resume, if the server is up for that.
+    Optional<Session> session() const;
+    bool is_resumed_session() const { return m_context.is_resumed_session; }
+
     const StringView& alpn() const { return m_context.negotiated_alpn; }
     void add_alpn(const StringView& alpn);
     bool has_alpn(const StringView& alpn) const;
@@ -6,6 +6,7 @@
 
 #include "AK/ByteBuffer.h"
 #include <AK/Checked.h>
+#include <AK/Memory.h>
 #include <AK/Utf32View.h>
 #include <AK/Utf8View.h>
 #include <LibCore/File.h>
@@ -532,23 +533,101 @@ int ScaledFont::width(const Utf32View& utf32) const
     return width;
 }
 
-RefPtr<Gfx::Bitmap> ScaledFont::raster_glyph(u32 glyph_id) const
+// Big enough for a few hundred glyphs at text sizes.
+static constexpr int atlas_page_size = 256;
+static constexpr size_t max_atlas_page_count = 4;
+
+Optional<size_t> ScaledFont::place_in_atlas(const Gfx::IntSize& size, Gfx::IntPoint& position) const
 {
-    auto glyph_iterator = m_cached_glyph_bitmaps.find(glyph_id);
-    if (glyph_iterator != m_cached_glyph_bitmaps.end())
-        return glyph_iterator->value;
+    if (size.width() > atlas_page_size || size.height() > atlas_page_size)
+        return {};
+
+    auto try_place_in_page = [&](AtlasPage& page) {
+        if (page.next_position.x() + size.width() > atlas_page_size) {
+            page.next_position = { 0, page.next_position.y() + page.row_height };
+            page.row_height = 0;
+        }
+        if (page.next_position.y() + size.height() > atlas_page_size)
+            return false;
+        position = page.next_position;
+        page.next_position.move_by(size.width(), 0);
+        page.row_height = max(page.row_height, size.height());
+        return true;
+    };
+
+    if (!m_atlas_pages.is_empty() && try_place_in_page(m_atlas_pages[m_open_atlas_page_index]))
+        return m_open_atlas_page_index;
+
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, { atlas_page_size, atlas_page_size });
+    if (!bitmap)
+        return {};
+
+    if (m_atlas_pages.size() < max_atlas_page_count) {
+        m_atlas_pages.append({ bitmap.release_nonnull(), {}, 0, 0 });
+        m_open_atlas_page_index = m_atlas_pages.size() - 1;
+    } else {
+        size_t least_recently_used_index = 0;
+        for (size_t i = 1; i < m_atlas_pages.size(); ++i) {
+            if (m_atlas_pages[i].last_use < m_atlas_pages[least_recently_used_index].last_use)
+                least_recently_used_index = i;
+        }
+
+        Vector<u32> evicted_glyph_ids;
+        for (auto& it : m_cached_glyphs) {
+            if (it.value.atlas_page_index.has_value() && it.value.atlas_page_index.value() == least_recently_used_index)
+                evicted_glyph_ids.append(it.key);
+        }
+        for (auto glyph_id : evicted_glyph_ids)
+            m_cached_glyphs.remove(glyph_id);
 
-    auto glyph_bitmap = m_font->raster_glyph(glyph_id, m_x_scale, m_y_scale);
-    m_cached_glyph_bitmaps.set(glyph_id, glyph_bitmap);
-    return glyph_bitmap;
+        // Glyphs that are still being painted hold on to the old bitmap, so the page gets a new one instead of reusing it.
+        m_atlas_pages[least_recently_used_index] = { bitmap.release_nonnull(), {}, 0, 0 };
+        m_open_atlas_page_index = least_recently_used_index;
+    }
+
+    bool placed = try_place_in_page(m_atlas_pages[m_open_atlas_page_index]);
+    VERIFY(placed);
+    return m_open_atlas_page_index;
+}
+
+const ScaledFont::CachedGlyph& ScaledFont::cached_glyph(u32 glyph_id) const
+{
+    ++m_glyph_use_count;
+    auto it = m_cached_glyphs.find(glyph_id);
+    if (it != m_cached_glyphs.end()) {
+        if (it->value.atlas_page_index.has_value())
+            m_atlas_pages[it->value.atlas_page_index.value()].last_use = m_glyph_use_count;
+        return it->value;
+    }
+
+    CachedGlyph cached_glyph { glyph_metrics(glyph_id), m_font->raster_glyph(glyph_id, m_x_scale, m_y_scale), {}, {} };
+    if (cached_glyph.bitmap) {
+        auto& glyph_bitmap = *cached_glyph.bitmap;
+        cached_glyph.bitmap_rect = glyph_bitmap.rect();
+
+        Gfx::IntPoint position;
+        if (auto page_index = place_in_atlas(glyph_bitmap.size(), position); page_index.has_value()) {
+            auto& page = m_atlas_pages[page_index.value()];
+            for (int y = 0; y < glyph_bitmap.height(); ++y)
+                fast_u32_copy(page.bitmap->scanline(position.y() + y) + position.x(), glyph_bitmap.scanline(y), glyph_bitmap.width());
+            page.last_use = m_glyph_use_count;
+            cached_glyph.bitmap_rect = { position, glyph_bitmap.size() };
+            cached_glyph.bitmap = page.bitmap;
+            cached_glyph.atlas_page_index = page_index;
+        }
+    }
+
+    m_cached_glyphs.set(glyph_id, move(cached_glyph));
+    return m_cached_glyphs.find(glyph_id)->value;
 }
 
 Gfx::Glyph ScaledFont::glyph(u32 code_point) const
 {
     auto id = glyph_id_for_codepoint(code_point);
-    auto bitmap = raster_glyph(id);
-    auto metrics = glyph_metrics(id);
-    return Gfx::Glyph(bitmap, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
+    LOCKER(m_glyph_cache_lock);
+    auto& cached_glyph = this->cached_glyph(id);
+    auto& metrics = cached_glyph.metrics;
+    return Gfx::Glyph(cached_glyph.bitmap, cached_glyph.bitmap_rect, metrics.left_side_bearing, metrics.advance_width, metrics.ascender);
 }
 
 u8 ScaledFont::glyph_width(size_t code_point) const
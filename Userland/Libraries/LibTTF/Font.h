@@ -9,11 +9,14 @@
 #include <AK/ByteBuffer.h>
 #include <AK/HashMap.h>
 #include <AK/Noncopyable.h>
+#include <AK/Optional.h>
 #include <AK/RefCounted.h>
 #include <AK/StringView.h>
+#include <AK/Vector.h>
 #include <LibGfx/Bitmap.h>
 #include <LibGfx/Font.h>
 #include <LibGfx/Size.h>
+#include <LibThread/Lock.h>
 #include <LibTTF/Cmap.h>
 #include <LibTTF/Glyf.h>
 #include <LibTTF/Tables.h>
@@ -113,7 +116,6 @@ public:
     u32 glyph_id_for_codepoint(u32 codepoint) const { return m_font->glyph_id_for_codepoint(codepoint); }
     ScaledFontMetrics metrics() const { return m_font->metrics(m_x_scale, m_y_scale); }
     ScaledGlyphMetrics glyph_metrics(u32 glyph_id) const { return m_font->glyph_metrics(glyph_id, m_x_scale, m_y_scale); }
-    RefPtr<Gfx::Bitmap> raster_glyph(u32 glyph_id) const;
 
     // Gfx::Font implementation
     virtual NonnullRefPtr<Font> clone() const override { return *this; } // FIXME: clone() should not need to be implemented
@@ -148,7 +150,33 @@ private:
     float m_y_scale { 0.0f };
     float m_point_width { 0.0f };
     float m_point_height { 0.0f };
-    mutable HashMap<u32, RefPtr<Gfx::Bitmap>> m_cached_glyph_bitmaps;
+
+    // Rasterized glyphs are packed into a few large bitmaps, in rows as tall as their tallest glyph, instead of getting
+    // a bitmap each. Once all of them are full, the one used least recently gets thrown out.
+    struct AtlasPage {
+        NonnullRefPtr<Gfx::Bitmap> bitmap;
+        Gfx::IntPoint next_position;
+        int row_height { 0 };
+        u64 last_use { 0 };
+    };
+
+    struct CachedGlyph {
+        ScaledGlyphMetrics metrics;
+        RefPtr<Gfx::Bitmap> bitmap;
+        Gfx::IntRect bitmap_rect;
+        // Glyphs too large for the atlas get a bitmap of their own, and stay cached for as long as the font.
+        Optional<size_t> atlas_page_index;
+    };
+
+    const CachedGlyph& cached_glyph(u32 glyph_id) const;
+    Optional<size_t> place_in_atlas(const Gfx::IntSize&, Gfx::IntPoint& position) const;
+
+    // Web content gets painted from more than one thread at a time, so the cache is guarded.
+    mutable LibThread::Lock m_glyph_cache_lock;
+    mutable HashMap<u32, CachedGlyph> m_cached_glyphs;
+    mutable Vector<AtlasPage> m_atlas_pages;
+    mutable size_t m_open_atlas_page_index { 0 };
+    mutable u64 m_glyph_use_count { 0 };
 };
 
 }
@@ -9,69 +9,61 @@
 #include <AK/Function.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/Optional.h>
-#include <AK/Queue.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
-#include <LibThread/Lock.h>
-#include <LibThread/Thread.h>
+#include <LibThread/ThreadPool.h>
 
 namespace LibThread {
 
+// Runs |action| on the shared ThreadPool, then hands its result to |on_complete| on the main event loop (or whichever
+// loop is nested in it at that point). The action keeps itself alive until it has completed.
 template<typename Result>
-class BackgroundAction;
-
-class BackgroundActionBase {
-    template<typename Result>
-    friend class BackgroundAction;
-
-private:
-    BackgroundActionBase() { }
-
-    static Lockable<Queue<Function<void()>>>& all_actions();
-    static Thread& background_thread();
-};
-
-template<typename Result>
-class BackgroundAction final : public Core::Object
-    , private BackgroundActionBase {
+class BackgroundAction final : public Core::Object {
     C_OBJECT(BackgroundAction);
 
 public:
     static NonnullRefPtr<BackgroundAction<Result>> create(
         Function<Result()> action,
-        Function<void(Result)> on_complete = nullptr)
+        Function<void(Result)> on_complete = nullptr,
+        ThreadPool::Priority priority = ThreadPool::Priority::Normal)
     {
-        return adopt_ref(*new BackgroundAction(move(action), move(on_complete)));
+        return adopt_ref(*new BackgroundAction(move(action), move(on_complete), priority));
     }
 
     virtual ~BackgroundAction() { }
 
+    // If the action hasn't started yet, it never will; either way, on_complete won't be called.
+    void cancel() { m_cancellation_token->cancel(); }
+    bool is_cancelled() const { return m_cancellation_token->is_cancelled(); }
+
 private:
-    BackgroundAction(Function<Result()> action, Function<void(Result)> on_complete)
-        : Core::Object(&background_thread())
-        , m_action(move(action))
+    BackgroundAction(Function<Result()> action, Function<void(Result)> on_complete, ThreadPool::Priority priority)
+        : m_action(move(action))
         , m_on_complete(move(on_complete))
+        , m_cancellation_token(CancellationToken::create())
     {
-        LOCKER(all_actions().lock());
-
-        all_actions().resource().enqueue([this] {
-            m_result = m_action();
-            if (m_on_complete) {
-                Core::EventLoop::current().post_event(*this, make<Core::DeferredInvocationEvent>([this](auto&) {
+        // Keep ourselves alive until on_complete has run; the reference is given back on the main event loop,
+        // so the action is never destroyed on a pool thread. The loop that created the action may be a nested one
+        // (like a dialog's) that is long gone by the time the action completes, so it can't be used here.
+        ref();
+        ThreadPool::the().submit([this] {
+            if (!is_cancelled())
+                m_result = m_action();
+            Core::EventLoop::main().post_event(*this, make<Core::DeferredInvocationEvent>([this](auto&) {
+                auto protector = adopt_ref(*this);
+                if (m_on_complete && !is_cancelled())
                     m_on_complete(m_result.release_value());
-                    this->remove_from_parent();
-                }));
-                Core::EventLoop::wake();
-            } else {
-                this->remove_from_parent();
-            }
-        });
+            }));
+            Core::EventLoop::wake();
+        },
+            priority);
     }
 
     Function<Result()> m_action;
     Function<void(Result)> m_on_complete;
     Optional<Result> m_result;
+    NonnullRefPtr<CancellationToken> m_cancellation_token;
 };
 
 }
@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/RefCounted.h>
+#include <AK/StringBuilder.h>
+#include <LibThread/DirectoryWalker.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+struct DirectoryWalker::ReadOptions {
+    bool should_stat_entries { true };
+    bool should_follow_symlinks { false };
+    bool should_skip_hidden_files { false };
+    bool should_sort_by_name { false };
+};
+
+// One directory, and everything that was read from it.
+class DirectoryWalker::Listing : public RefCounted<Listing> {
+public:
+    enum class Status {
+        Queued,
+        Reading,
+        Done,
+    };
+
+    Listing(String path, size_t depth)
+        : path(move(path))
+        , depth(depth)
+    {
+    }
+
+    void read(const ReadOptions&);
+
+    String path;
+    size_t depth { 0 };
+    Vector<Entry> entries;
+    // Only used by the depth-first walk: the listings for the entries that are directories, in the same order.
+    Vector<RefPtr<Listing>> subdirectories;
+    int error { 0 };
+    // Guarded by the mutex of the State.
+    Status status { Status::Queued };
+};
+
+// What the walker shares with the tasks it submits to the pool, which may outlive the walk.
+class DirectoryWalker::State : public RefCounted<State> {
+public:
+    explicit State(bool should_collect_finished_listings)
+        : should_collect_finished_listings(should_collect_finished_listings)
+    {
+        pthread_mutex_init(&mutex, nullptr);
+        pthread_cond_init(&listing_finished, nullptr);
+    }
+
+    ~State()
+    {
+        pthread_cond_destroy(&listing_finished);
+        pthread_mutex_destroy(&mutex);
+    }
+
+    // Makes sure that only one thread reads any given listing.
+    bool try_claim(Listing& listing)
+    {
+        pthread_mutex_lock(&mutex);
+        bool claimed = listing.status == Listing::Status::Queued;
+        if (claimed)
+            listing.status = Listing::Status::Reading;
+        pthread_mutex_unlock(&mutex);
+        return claimed;
+    }
+
+    void did_finish_in_background(NonnullRefPtr<Listing> listing)
+    {
+        pthread_mutex_lock(&mutex);
+        listing->status = Listing::Status::Done;
+        if (should_collect_finished_listings)
+            finished_listings.append(move(listing));
+        pthread_cond_broadcast(&listing_finished);
+        pthread_mutex_unlock(&mutex);
+    }
+
+    pthread_mutex_t mutex;
+    pthread_cond_t listing_finished;
+    const bool should_collect_finished_listings { false };
+    // Listings read in the background, in the order they were finished. Only collected for the unordered walk.
+    Vector<NonnullRefPtr<Listing>> finished_listings;
+    NonnullRefPtr<CancellationToken> cancellation_token { CancellationToken::create() };
+};
+
+void DirectoryWalker::Listing::read(const ReadOptions& options)
+{
+    // The directory is only looked up by its path once; its entries are stat()ed relative to it.
+    int fd = open(path.characters(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        error = errno;
+        return;
+    }
+    auto* dir = fdopendir(fd);
+    if (!dir) {
+        error = errno;
+        close(fd);
+        return;
+    }
+
+    bool path_has_trailing_slash = path.ends_with('/');
+    for (;;) {
+        errno = 0;
+        auto* dirent = readdir(dir);
+        if (!dirent) {
+            error = errno;
+            break;
+        }
+        StringView name = dirent->d_name;
+        if (name == "." || name == "..")
+            continue;
+        if (options.should_skip_hidden_files && name.starts_with('.'))
+            continue;
+
+        Entry entry;
+        StringBuilder builder(path.length() + name.length() + 1);
+        builder.append(path);
+        if (!path_has_trailing_slash)
+            builder.append('/');
+        entry.name_start = builder.length();
+        builder.append(name);
+        entry.path = builder.to_string();
+        entry.depth = depth + 1;
+        entry.type = dirent->d_type;
+
+        bool should_stat = options.should_stat_entries
+            || entry.type == DT_UNKNOWN
+            || (options.should_follow_symlinks && entry.type == DT_LNK);
+        if (should_stat) {
+            struct stat st;
+            if (fstatat(fd, dirent->d_name, &st, options.should_follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) < 0) {
+                entry.error = errno;
+            } else {
+                entry.stat = st;
+                entry.type = IFTODT(st.st_mode);
+            }
+        }
+        entries.append(move(entry));
+    }
+    closedir(dir);
+
+    if (options.should_sort_by_name)
+        quick_sort(entries, [](auto& a, auto& b) { return a.name() < b.name(); });
+    if (!entries.is_empty())
+        entries.last().is_last_in_directory = true;
+}
+
+DirectoryWalker::DirectoryWalker(ThreadPool& pool)
+    : m_pool(pool)
+{
+}
+
+DirectoryWalker::~DirectoryWalker()
+{
+}
+
+DirectoryWalker::ReadOptions DirectoryWalker::read_options() const
+{
+    return { m_should_stat_entries, m_should_follow_symlinks, m_should_skip_hidden_files, m_should_sort_by_name };
+}
+
+IterationDecision DirectoryWalker::walk(const String& root_path, Function<IterationDecision(const Entry&)> callback)
+{
+    Entry root;
+    root.path = root_path;
+    auto last_slash = root_path.view().find_last_of('/');
+    if (last_slash.has_value() && last_slash.value() + 1 < root_path.length())
+        root.name_start = last_slash.value() + 1;
+
+    struct stat st;
+    if ((m_should_follow_symlinks ? ::stat : ::lstat)(root_path.characters(), &st) < 0) {
+        root.error = errno;
+    } else {
+        root.stat = st;
+        root.type = IFTODT(st.st_mode);
+    }
+
+    if (callback(root) == IterationDecision::Break)
+        return IterationDecision::Break;
+    if (root.error != 0) {
+        if (on_error)
+            on_error(root_path, root.error);
+        return IterationDecision::Continue;
+    }
+    if (!root.is_directory() || m_max_depth == 0)
+        return IterationDecision::Continue;
+
+    m_state = adopt_ref(*new State(m_order == Order::Unordered));
+    m_max_submitted_listings = m_pool.thread_count() * 4;
+
+    auto root_listing = adopt_ref(*new Listing(root_path, 0));
+    IterationDecision decision;
+    if (m_order == Order::DepthFirst)
+        decision = walk_depth_first(*root_listing, callback);
+    else
+        decision = walk_unordered(root_listing, callback);
+
+    // If the callback stopped early, there's no need to read the rest. Tasks that are already reading something
+    // still finish, but they only hold on to the State and their own listing.
+    m_state->cancellation_token->cancel();
+    m_state = nullptr;
+    m_queued_listings.clear();
+    m_submitted_listings.clear();
+    return decision;
+}
+
+IterationDecision DirectoryWalker::walk_depth_first(Listing& listing, const Function<IterationDecision(const Entry&)>& callback)
+{
+    wait_for(listing);
+    did_take(listing);
+    if (listing.error != 0 && on_error)
+        on_error(listing.path, listing.error);
+
+    queue_subdirectories(listing);
+    submit_queued_listings();
+
+    size_t subdirectory_index = 0;
+    for (auto& entry : listing.entries) {
+        if (callback(entry) == IterationDecision::Break)
+            return IterationDecision::Break;
+        if (!entry.is_directory() || entry.depth >= m_max_depth)
+            continue;
+        auto subdirectory = move(listing.subdirectories[subdirectory_index++]);
+        if (walk_depth_first(*subdirectory, callback) == IterationDecision::Break)
+            return IterationDecision::Break;
+    }
+    return IterationDecision::Continue;
+}
+
+IterationDecision DirectoryWalker::walk_unordered(NonnullRefPtr<Listing> root_listing, const Function<IterationDecision(const Entry&)>& callback)
+{
+    m_queued_listings.append(move(root_listing));
+    for (;;) {
+        submit_queued_listings();
+        if (m_submitted_listings.is_empty())
+            return IterationDecision::Continue;
+
+        auto listing = take_finished_listing();
+        did_take(*listing);
+        if (listing->error != 0 && on_error)
+            on_error(listing->path, listing->error);
+
+        queue_subdirectories(*listing);
+        for (auto& entry : listing->entries) {
+            if (callback(entry) == IterationDecision::Break)
+                return IterationDecision::Break;
+        }
+    }
+}
+
+void DirectoryWalker::queue_subdirectories(Listing& listing)
+{
+    Vector<NonnullRefPtr<Listing>> subdirectories;
+    for (auto& entry : listing.entries) {
+        if (entry.is_directory() && entry.depth < m_max_depth)
+            subdirectories.append(adopt_ref(*new Listing(entry.path, entry.depth)));
+    }
+    // The first subdirectory is the one we need first, so it goes on top.
+    for (size_t i = subdirectories.size(); i > 0; --i)
+        m_queued_listings.append(subdirectories[i - 1]);
+    if (m_order == Order::DepthFirst) {
+        for (auto& subdirectory : subdirectories)
+            listing.subdirectories.append(move(subdirectory));
+    }
+}
+
+void DirectoryWalker::submit_queued_listings()
+{
+    auto options = read_options();
+    while (!m_queued_listings.is_empty() && m_submitted_listings.size() < m_max_submitted_listings) {
+        auto listing = m_queued_listings.take_last();
+        m_submitted_listings.append(listing);
+        m_pool.submit([listing = listing.ptr(), listing_protector = listing, state = m_state.ptr(), state_protector = m_state, options] {
+            if (!state->try_claim(*listing))
+                return;
+            listing->read(options);
+            state->did_finish_in_background(*listing);
+        },
+            ThreadPool::Priority::Normal, m_state->cancellation_token);
+    }
+}
+
+void DirectoryWalker::wait_for(Listing& listing)
+{
+    if (m_state->try_claim(listing)) {
+        listing.read(read_options());
+        pthread_mutex_lock(&m_state->mutex);
+        listing.status = Listing::Status::Done;
+        pthread_mutex_unlock(&m_state->mutex);
+        return;
+    }
+    pthread_mutex_lock(&m_state->mutex);
+    while (listing.status != Listing::Status::Done)
+        pthread_cond_wait(&m_state->listing_finished, &m_state->mutex);
+    pthread_mutex_unlock(&m_state->mutex);
+}
+
+NonnullRefPtr<DirectoryWalker::Listing> DirectoryWalker::take_finished_listing()
+{
+    auto& state = *m_state;
+    pthread_mutex_lock(&state.mutex);
+    for (;;) {
+        if (!state.finished_listings.is_empty()) {
+            auto listing = state.finished_listings.take_first();
+            pthread_mutex_unlock(&state.mutex);
+            return listing;
+        }
+        // Rather than wait for a thread that is busy with something else (or that may even be this one, if we're
+        // running on the pool ourselves), read a listing that nobody has started on yet right here.
+        for (auto& listing : m_submitted_listings) {
+            if (listing->status != Listing::Status::Queued)
+                continue;
+            listing->status = Listing::Status::Reading;
+            pthread_mutex_unlock(&state.mutex);
+            listing->read(read_options());
+            pthread_mutex_lock(&state.mutex);
+            listing->status = Listing::Status::Done;
+            pthread_mutex_unlock(&state.mutex);
+            return listing;
+        }
+        pthread_cond_wait(&state.listing_finished, &state.mutex);
+    }
+}
+
+void DirectoryWalker::did_take(Listing& listing)
+{
+    // A listing that we read ourselves may not have been handed to the pool yet.
+    if (!m_submitted_listings.remove_first_matching([&](auto& other) { return other.ptr() == &listing; }))
+        m_queued_listings.remove_first_matching([&](auto& other) { return other.ptr() == &listing; });
+}
+
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/IterationDecision.h>
+#include <AK/Noncopyable.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/String.h>
+#include <LibThread/ThreadPool.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+namespace LibThread {
+
+// Walks a directory tree. The directories are read, and their entries stat()ed, on the threads of a ThreadPool,
+// while walk() hands the results to its callback on the calling thread. Only a limited number of directories are
+// read ahead of the callback, so a slow callback doesn't make the walker pile up the whole tree in memory.
+//
+// With Order::DepthFirst, entries come in the same order as with a plain recursive walk: every directory right
+// before its contents. With Order::Unordered, every directory's entries come as soon as they have been read,
+// which keeps more threads busy when the order doesn't matter.
+class DirectoryWalker {
+    AK_MAKE_NONCOPYABLE(DirectoryWalker);
+    AK_MAKE_NONMOVABLE(DirectoryWalker);
+
+public:
+    enum class Order {
+        DepthFirst,
+        Unordered,
+    };
+
+    struct Entry {
+        String path;
+        // The root of the walk is at depth 0, the entries in it at depth 1, and so on.
+        size_t depth { 0 };
+        // One of the DT_* constants. This comes from the directory itself unless the entry had to be stat()ed.
+        unsigned char type { DT_UNKNOWN };
+        Optional<struct stat> stat;
+        // The errno from stat()ing this entry, if that failed.
+        int error { 0 };
+        bool is_last_in_directory { false };
+
+        StringView name() const { return path.substring_view(name_start, path.length() - name_start); }
+        bool is_directory() const { return type == DT_DIR; }
+
+        size_t name_start { 0 };
+    };
+
+    explicit DirectoryWalker(ThreadPool& = ThreadPool::the());
+    ~DirectoryWalker();
+
+    void set_order(Order order) { m_order = order; }
+    // Without this, entries are only stat()ed when the directory doesn't tell us what type they are,
+    // or when they are symlinks that we need to follow.
+    void set_should_stat_entries(bool should_stat) { m_should_stat_entries = should_stat; }
+    void set_should_follow_symlinks(bool should_follow) { m_should_follow_symlinks = should_follow; }
+    void set_should_skip_hidden_files(bool should_skip) { m_should_skip_hidden_files = should_skip; }
+    void set_should_sort_by_name(bool should_sort) { m_should_sort_by_name = should_sort; }
+    // Directories at this depth are still passed to the callback, but not read.
+    void set_max_depth(size_t max_depth) { m_max_depth = max_depth; }
+
+    // Called on the calling thread when a directory can't be read.
+    Function<void(const String& path, int error)> on_error;
+
+    // Calls |callback| for |root_path| itself, and then for everything under it. Returns IterationDecision::Break
+    // if the callback stopped the walk early.
+    IterationDecision walk(const String& root_path, Function<IterationDecision(const Entry&)> callback);
+
+private:
+    class Listing;
+    class State;
+    struct ReadOptions;
+
+    IterationDecision walk_depth_first(Listing&, const Function<IterationDecision(const Entry&)>&);
+    IterationDecision walk_unordered(NonnullRefPtr<Listing>, const Function<IterationDecision(const Entry&)>&);
+
+    // Queues the subdirectories of a listing to be read, in the order they'll be needed.
+    void queue_subdirectories(Listing&);
+    void submit_queued_listings();
+    // Reads the listing right here if no thread has started on it yet, and waits for it otherwise.
+    void wait_for(Listing&);
+    NonnullRefPtr<Listing> take_finished_listing();
+    void did_take(Listing&);
+    ReadOptions read_options() const;
+
+    ThreadPool& m_pool;
+    Order m_order { Order::DepthFirst };
+    bool m_should_stat_entries { true };
+    bool m_should_follow_symlinks { false };
+    bool m_should_skip_hidden_files { false };
+    bool m_should_sort_by_name { false };
+    size_t m_max_depth { NumericLimits<size_t>::max() };
+
+    RefPtr<State> m_state;
+    // Listings to hand to the pool once there is room. The one that's needed next is last.
+    Vector<NonnullRefPtr<Listing>> m_queued_listings;
+    // Listings handed to the pool that the callback hasn't gotten to yet.
+    Vector<NonnullRefPtr<Listing>> m_submitted_listings;
+    size_t m_max_submitted_listings { 0 };
+};
+
+}
@@ -21,6 +21,7 @@ public:
     ~Lock() { }
 
     void lock();
+    bool try_lock();
     void unlock();
 
 private:
@@ -60,6 +61,21 @@ ALWAYS_INLINE void Lock::lock()
     }
 }
 
+ALWAYS_INLINE bool Lock::try_lock()
+{
+    pid_t tid = gettid();
+    if (m_holder == tid) {
+        ++m_level;
+        return true;
+    }
+    int expected = 0;
+    if (m_holder.compare_exchange_strong(expected, tid, AK::memory_order_acq_rel)) {
+        m_level = 1;
+        return true;
+    }
+    return false;
+}
+
 inline void Lock::unlock()
 {
     VERIFY(m_holder == gettid());
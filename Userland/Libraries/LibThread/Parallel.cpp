@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/RefCounted.h>
+#include <LibThread/Parallel.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+namespace {
+
+// Shared between the caller of run_chunks() and its helper tasks. Helpers can start after the caller has
+// already returned; by then there are no chunks left for them to claim, so they never touch |function|.
+class ChunkRun : public RefCounted<ChunkRun> {
+public:
+    ChunkRun(size_t chunk_count, const Function<void(size_t)>& function)
+        : m_chunk_count(chunk_count)
+        , m_function(function)
+    {
+        pthread_mutex_init(&m_mutex, nullptr);
+        pthread_cond_init(&m_all_done, nullptr);
+    }
+
+    ~ChunkRun()
+    {
+        pthread_cond_destroy(&m_all_done);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    // Runs the next unclaimed chunk, if there is one.
+    bool run_next_chunk()
+    {
+        auto chunk = m_next_chunk.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        if (chunk >= m_chunk_count)
+            return false;
+        m_function(chunk);
+        if (m_completed_chunk_count.fetch_add(1, AK::MemoryOrder::memory_order_acq_rel) + 1 == m_chunk_count) {
+            pthread_mutex_lock(&m_mutex);
+            pthread_cond_signal(&m_all_done);
+            pthread_mutex_unlock(&m_mutex);
+        }
+        return true;
+    }
+
+    void wait_until_done()
+    {
+        pthread_mutex_lock(&m_mutex);
+        while (m_completed_chunk_count.load(AK::MemoryOrder::memory_order_acquire) != m_chunk_count)
+            pthread_cond_wait(&m_all_done, &m_mutex);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+private:
+    const size_t m_chunk_count;
+    const Function<void(size_t)>& m_function;
+    Atomic<size_t> m_next_chunk { 0 };
+    Atomic<size_t> m_completed_chunk_count { 0 };
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_all_done;
+};
+
+}
+
+void run_chunks(ThreadPool& pool, size_t chunk_count, const Function<void(size_t chunk)>& function)
+{
+    if (chunk_count == 0)
+        return;
+
+    auto run = adopt_ref(*new ChunkRun(chunk_count, function));
+    auto helper_count = min(chunk_count, pool.thread_count()) - 1;
+    for (size_t i = 0; i < helper_count; ++i) {
+        // AK::Function only calls its callable as const, so keep a plain pointer around for the calls.
+        pool.submit([run = run.ptr(), protector = run] {
+            while (run->run_next_chunk())
+                ;
+        });
+    }
+
+    while (run->run_next_chunk())
+        ;
+    run->wait_until_done();
+}
+
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+#include <LibThread/ThreadPool.h>
+
+namespace LibThread {
+
+// Runs |function| once for every chunk in [0, chunk_count), spread over the calling thread and the threads
+// of |pool|, and returns once all chunks are done. Since the calling thread works through chunks too, this
+// may be called from a task that is itself running on |pool|.
+void run_chunks(ThreadPool&, size_t chunk_count, const Function<void(size_t chunk)>&);
+
+// Enough chunks that threads which finish early can pick up the slack of those that don't.
+inline size_t default_grain_size(const ThreadPool& pool, size_t count)
+{
+    return max(count / (pool.thread_count() * 4), (size_t)1);
+}
+
+// Calls |callback| with every index in [begin, end). Indices are handed out to threads |grain_size| at a
+// time; a grain_size of 0 picks one for you. |callback| is called from several threads at once.
+template<typename Callback>
+void parallel_for(ThreadPool& pool, size_t begin, size_t end, size_t grain_size, Callback callback)
+{
+    if (begin >= end)
+        return;
+    auto count = end - begin;
+    if (grain_size == 0)
+        grain_size = default_grain_size(pool, count);
+    auto chunk_count = (count + grain_size - 1) / grain_size;
+    if (chunk_count == 1) {
+        for (auto i = begin; i < end; ++i)
+            callback(i);
+        return;
+    }
+    run_chunks(pool, chunk_count, [&](size_t chunk) {
+        auto chunk_begin = begin + chunk * grain_size;
+        auto chunk_end = min(chunk_begin + grain_size, end);
+        for (auto i = chunk_begin; i < chunk_end; ++i)
+            callback(i);
+    });
+}
+
+template<typename Callback>
+void parallel_for(size_t begin, size_t end, size_t grain_size, Callback callback)
+{
+    parallel_for(ThreadPool::the(), begin, end, grain_size, move(callback));
+}
+
+// Splits [begin, end) into chunks of |grain_size| indices, turns every chunk into a value with
+// map_chunk(chunk_begin, chunk_end), and folds those values into |initial| with combine(T, T), from the
+// first chunk to the last. |combine| has to be associative, but needn't be commutative.
+template<typename T, typename MapChunk, typename Combine>
+T parallel_reduce(ThreadPool& pool, size_t begin, size_t end, size_t grain_size, T initial, MapChunk map_chunk, Combine combine)
+{
+    if (begin >= end)
+        return initial;
+    auto count = end - begin;
+    if (grain_size == 0)
+        grain_size = default_grain_size(pool, count);
+    auto chunk_count = (count + grain_size - 1) / grain_size;
+
+    Vector<Optional<T>> partial_results;
+    partial_results.resize(chunk_count);
+    run_chunks(pool, chunk_count, [&](size_t chunk) {
+        auto chunk_begin = begin + chunk * grain_size;
+        auto chunk_end = min(chunk_begin + grain_size, end);
+        partial_results[chunk] = map_chunk(chunk_begin, chunk_end);
+    });
+
+    for (auto& partial_result : partial_results)
+        initial = combine(move(initial), partial_result.release_value());
+    return initial;
+}
+
+template<typename T, typename MapChunk, typename Combine>
+T parallel_reduce(size_t begin, size_t end, size_t grain_size, T initial, MapChunk map_chunk, Combine combine)
+{
+    return parallel_reduce(ThreadPool::the(), begin, end, grain_size, move(initial), move(map_chunk), move(combine));
+}
+
+}
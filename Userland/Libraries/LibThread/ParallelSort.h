@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/QuickSort.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+#include <LibThread/Parallel.h>
+
+namespace LibThread {
+
+// Sorts |data| using the threads of |pool|: every thread sorts a slice of it with quick_sort(),
+// and the sorted slices are then merged pairwise, with the merges of each round also running in parallel.
+// Inputs too small to be worth the threads are sorted in place right away. Like quick_sort(), this is not stable.
+template<typename T, typename LessThan>
+void parallel_sort(ThreadPool& pool, Span<T> data, LessThan less_than)
+{
+    static constexpr size_t minimum_slice_size = 16384;
+
+    size_t slice_count = 1;
+    while (slice_count * 2 <= pool.thread_count() && slice_count * 2 * minimum_slice_size <= data.size())
+        slice_count *= 2;
+
+    if (slice_count == 1) {
+        quick_sort(data, move(less_than));
+        return;
+    }
+
+    Vector<size_t> boundaries;
+    for (size_t i = 0; i <= slice_count; ++i)
+        boundaries.append(data.size() * i / slice_count);
+
+    run_chunks(pool, slice_count, [&](size_t slice) {
+        AK::pattern_defeating_quick_sort(data, boundaries[slice], boundaries[slice + 1], less_than);
+    });
+
+    for (size_t width = 1; width < slice_count; width *= 2) {
+        run_chunks(pool, slice_count / (width * 2), [&](size_t pair) {
+            auto start = boundaries[pair * width * 2];
+            auto middle = boundaries[pair * width * 2 + width];
+            auto end = boundaries[pair * width * 2 + width * 2];
+            auto* buffer = static_cast<T*>(kmalloc(sizeof(T) * min(middle - start, end - middle)));
+            VERIFY(buffer);
+            AK::Detail::merge_adjacent(data, start, middle, end, buffer, less_than);
+            kfree(buffer);
+        });
+    }
+}
+
+template<typename T, typename LessThan>
+void parallel_sort(Span<T> data, LessThan less_than)
+{
+    parallel_sort(ThreadPool::the(), data, move(less_than));
+}
+
+}
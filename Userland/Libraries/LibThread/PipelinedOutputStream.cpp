@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThread/PipelinedOutputStream.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+PipelinedOutputStream::PipelinedOutputStream(int fd, size_t chunk_size, size_t chunk_count)
+    : m_fd(fd)
+    , m_chunk_size(chunk_size)
+    , m_chunk_count(chunk_count)
+{
+    VERIFY(chunk_size > 0);
+    VERIFY(chunk_count >= 2);
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_chunk_filled, nullptr);
+    pthread_cond_init(&m_chunk_written, nullptr);
+}
+
+PipelinedOutputStream::~PipelinedOutputStream()
+{
+    flush();
+    if (m_thread) {
+        pthread_mutex_lock(&m_mutex);
+        m_should_stop = true;
+        pthread_cond_signal(&m_chunk_filled);
+        pthread_mutex_unlock(&m_mutex);
+        (void)m_thread->join();
+    }
+    for (auto* buffer : m_buffers)
+        free(buffer);
+    pthread_cond_destroy(&m_chunk_written);
+    pthread_cond_destroy(&m_chunk_filled);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void PipelinedOutputStream::start()
+{
+    m_sizes.resize(m_chunk_count);
+    for (size_t i = 0; i < m_chunk_count; ++i) {
+        auto* buffer = static_cast<u8*>(malloc(m_chunk_size));
+        if (!buffer) {
+            m_error = ENOMEM;
+            return;
+        }
+        m_buffers.append(buffer);
+    }
+    m_thread = Thread::construct([this] { return write_chunks(); }, "PipelinedOutputStream");
+    m_thread->start();
+}
+
+int PipelinedOutputStream::write_chunks()
+{
+    pthread_mutex_lock(&m_mutex);
+    for (;;) {
+        while (!m_should_stop && m_written_count == m_filled_count)
+            pthread_cond_wait(&m_chunk_filled, &m_mutex);
+        if (m_written_count == m_filled_count)
+            break;
+        auto index = m_written_count % m_buffers.size();
+        auto size = m_sizes[index];
+        bool has_error = m_error != 0;
+        pthread_mutex_unlock(&m_mutex);
+
+        int error = 0;
+        for (size_t nwritten = 0; !has_error && nwritten < size;) {
+            auto rc = ::write(m_fd, m_buffers[index] + nwritten, size - nwritten);
+            if (rc < 0 && errno == EINTR)
+                continue;
+            if (rc <= 0) {
+                error = rc < 0 ? errno : EIO;
+                break;
+            }
+            nwritten += rc;
+        }
+
+        pthread_mutex_lock(&m_mutex);
+        if (error != 0 && m_error == 0)
+            m_error = error;
+        ++m_written_count;
+        pthread_cond_signal(&m_chunk_written);
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return 0;
+}
+
+void PipelinedOutputStream::hand_over_chunk()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_sizes[m_filled_count % m_buffers.size()] = m_fill_size;
+    ++m_filled_count;
+    pthread_cond_signal(&m_chunk_filled);
+    pthread_mutex_unlock(&m_mutex);
+    m_fill_size = 0;
+}
+
+size_t PipelinedOutputStream::write(ReadonlyBytes bytes)
+{
+    if (!m_thread && m_error == 0)
+        start();
+    if (has_any_error() || error() != 0) {
+        set_fatal_error();
+        return 0;
+    }
+
+    size_t nwritten = 0;
+    while (nwritten < bytes.size()) {
+        if (m_fill_size == 0) {
+            // Wait for the writer to be done with the chunk we're about to fill.
+            pthread_mutex_lock(&m_mutex);
+            while (m_filled_count - m_written_count == m_buffers.size())
+                pthread_cond_wait(&m_chunk_written, &m_mutex);
+            pthread_mutex_unlock(&m_mutex);
+        }
+        auto* buffer = m_buffers[m_filled_count % m_buffers.size()];
+        auto ncopied = bytes.slice(nwritten).copy_trimmed_to({ buffer + m_fill_size, m_chunk_size - m_fill_size });
+        m_fill_size += ncopied;
+        nwritten += ncopied;
+        if (m_fill_size == m_chunk_size)
+            hand_over_chunk();
+    }
+    return nwritten;
+}
+
+bool PipelinedOutputStream::write_or_error(ReadonlyBytes bytes)
+{
+    if (write(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool PipelinedOutputStream::flush()
+{
+    if (!m_thread)
+        return m_error == 0;
+    if (m_fill_size > 0)
+        hand_over_chunk();
+
+    pthread_mutex_lock(&m_mutex);
+    while (m_written_count != m_filled_count)
+        pthread_cond_wait(&m_chunk_written, &m_mutex);
+    bool success = m_error == 0;
+    pthread_mutex_unlock(&m_mutex);
+    return success;
+}
+
+int PipelinedOutputStream::error()
+{
+    pthread_mutex_lock(&m_mutex);
+    int error = m_error;
+    pthread_mutex_unlock(&m_mutex);
+    return error;
+}
+
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+#include <LibThread/Thread.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// An OutputStream that writes to a file descriptor behind the caller's back: written data is collected into
+// chunks, and every full chunk is handed to a thread of its own, which writes it out while the caller goes on
+// producing the next one. The counterpart of PipelinedInputStream.
+class PipelinedOutputStream final : public OutputStream {
+    AK_MAKE_NONCOPYABLE(PipelinedOutputStream);
+    AK_MAKE_NONMOVABLE(PipelinedOutputStream);
+
+public:
+    PipelinedOutputStream(int fd, size_t chunk_size, size_t chunk_count = 2);
+    // Flushes whatever is left. The file descriptor isn't closed.
+    ~PipelinedOutputStream();
+
+    size_t write(ReadonlyBytes) override;
+    bool write_or_error(ReadonlyBytes) override;
+
+    // Writes the partially filled chunk as well, and waits until everything has been written.
+    bool flush();
+
+    // If writing failed, the errno. Whatever was written after that is dropped.
+    int error();
+
+private:
+    void start();
+    void hand_over_chunk();
+    int write_chunks();
+
+    int m_fd { -1 };
+    size_t m_chunk_size { 0 };
+    size_t m_chunk_count { 0 };
+    RefPtr<Thread> m_thread;
+    // How much of the chunk that's being filled (chunk number m_filled_count) has been written to.
+    size_t m_fill_size { 0 };
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_chunk_filled;
+    pthread_cond_t m_chunk_written;
+    // Everything below is guarded by the mutex. Chunk i is kept in m_buffers[i % m_buffers.size()].
+    Vector<u8*> m_buffers;
+    Vector<size_t> m_sizes;
+    size_t m_filled_count { 0 };
+    size_t m_written_count { 0 };
+    bool m_should_stop { false };
+    int m_error { 0 };
+};
+
+}
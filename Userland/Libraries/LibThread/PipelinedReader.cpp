@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThread/PipelinedReader.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+PipelinedReader::PipelinedReader(int fd, size_t chunk_size, size_t chunk_count)
+    : m_fd(fd)
+    , m_chunk_size(chunk_size)
+{
+    VERIFY(chunk_size > 0);
+    VERIFY(chunk_count >= 2);
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_chunk_read, nullptr);
+    pthread_cond_init(&m_chunk_released, nullptr);
+    m_sizes.resize(chunk_count);
+}
+
+PipelinedReader::~PipelinedReader()
+{
+    if (m_thread) {
+        pthread_mutex_lock(&m_mutex);
+        m_should_stop = true;
+        pthread_cond_signal(&m_chunk_released);
+        pthread_mutex_unlock(&m_mutex);
+        (void)m_thread->join();
+    }
+    for (auto* buffer : m_buffers)
+        free(buffer);
+    pthread_cond_destroy(&m_chunk_released);
+    pthread_cond_destroy(&m_chunk_read);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void PipelinedReader::start()
+{
+    for (size_t i = 0; i < m_sizes.size(); ++i) {
+        auto* buffer = static_cast<u8*>(malloc(m_chunk_size));
+        if (!buffer) {
+            m_error = ENOMEM;
+            m_finished_reading = true;
+            return;
+        }
+        m_buffers.append(buffer);
+    }
+    m_thread = Thread::construct([this] { return read_chunks(); }, "PipelinedReader");
+    m_thread->start();
+}
+
+int PipelinedReader::read_chunks()
+{
+    pthread_mutex_lock(&m_mutex);
+    for (;;) {
+        // The chunk that the caller is holding on to is only released by its next call to next_chunk().
+        while (!m_should_stop && m_read_chunk_count - m_released_chunk_count == m_buffers.size())
+            pthread_cond_wait(&m_chunk_released, &m_mutex);
+        if (m_should_stop || m_read_chunk_count == m_max_chunk_count)
+            break;
+        auto index = m_read_chunk_count % m_buffers.size();
+        pthread_mutex_unlock(&m_mutex);
+
+        ssize_t nread;
+        do {
+            nread = read(m_fd, m_buffers[index], m_chunk_size);
+        } while (nread < 0 && errno == EINTR);
+        int error = nread < 0 ? errno : 0;
+
+        pthread_mutex_lock(&m_mutex);
+        if (nread <= 0) {
+            m_error = error;
+            break;
+        }
+        m_sizes[index] = nread;
+        ++m_read_chunk_count;
+        pthread_cond_signal(&m_chunk_read);
+    }
+    m_finished_reading = true;
+    pthread_cond_signal(&m_chunk_read);
+    pthread_mutex_unlock(&m_mutex);
+    return 0;
+}
+
+ReadonlyBytes PipelinedReader::next_chunk()
+{
+    if (!m_thread && !m_finished_reading)
+        start();
+
+    pthread_mutex_lock(&m_mutex);
+    if (m_has_chunk) {
+        ++m_released_chunk_count;
+        m_has_chunk = false;
+        pthread_cond_signal(&m_chunk_released);
+    }
+    while (!m_finished_reading && m_read_chunk_count == m_released_chunk_count)
+        pthread_cond_wait(&m_chunk_read, &m_mutex);
+
+    ReadonlyBytes chunk;
+    if (m_read_chunk_count > m_released_chunk_count) {
+        auto index = m_released_chunk_count % m_buffers.size();
+        chunk = { m_buffers[index], m_sizes[index] };
+        m_has_chunk = true;
+    }
+    pthread_mutex_unlock(&m_mutex);
+    return chunk;
+}
+
+bool PipelinedInputStream::fill_chunk()
+{
+    if (!m_chunk.is_empty())
+        return true;
+    if (m_eof || has_any_error())
+        return false;
+    m_chunk = m_reader.next_chunk();
+    if (!m_chunk.is_empty())
+        return true;
+    m_eof = true;
+    if (m_reader.error() != 0)
+        set_fatal_error();
+    return false;
+}
+
+size_t PipelinedInputStream::read(Bytes bytes)
+{
+    size_t nread = 0;
+    while (nread < bytes.size() && fill_chunk()) {
+        auto ncopied = m_chunk.copy_trimmed_to(bytes.slice(nread));
+        m_chunk = m_chunk.slice(ncopied);
+        nread += ncopied;
+    }
+    return nread;
+}
+
+bool PipelinedInputStream::read_or_error(Bytes bytes)
+{
+    if (read(bytes) < bytes.size()) {
+        set_fatal_error();
+        return false;
+    }
+
+    return true;
+}
+
+bool PipelinedInputStream::discard_or_error(size_t count)
+{
+    while (count > 0) {
+        if (!fill_chunk()) {
+            set_fatal_error();
+            return false;
+        }
+        auto ndiscarded = min(count, m_chunk.size());
+        m_chunk = m_chunk.slice(ndiscarded);
+        count -= ndiscarded;
+    }
+    return true;
+}
+
+}
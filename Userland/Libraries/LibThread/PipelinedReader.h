@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Noncopyable.h>
+#include <AK/NumericLimits.h>
+#include <AK/Span.h>
+#include <AK/Stream.h>
+#include <AK/Vector.h>
+#include <LibThread/Thread.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// Reads a file descriptor ahead of whoever consumes the data: while the caller works on one chunk, the next
+// ones are already being read on a thread of their own. Every chunk is the result of a single read() of at
+// most chunk_size bytes, so short reads from pipes and devices come through just as they would without it.
+class PipelinedReader {
+    AK_MAKE_NONCOPYABLE(PipelinedReader);
+    AK_MAKE_NONMOVABLE(PipelinedReader);
+
+public:
+    // With the default of two chunks, one is being read while the caller has the other.
+    PipelinedReader(int fd, size_t chunk_size, size_t chunk_count = 2);
+    // Waits for the read that's in progress, if any. The file descriptor isn't closed.
+    ~PipelinedReader();
+
+    // Stops reading ahead after this many chunks, so that nothing past them is taken out of a pipe.
+    // Has to be called before the first call to next_chunk().
+    void set_max_chunk_count(size_t max_chunk_count) { m_max_chunk_count = max_chunk_count; }
+
+    // Returns the next chunk, which stays valid until the next call. An empty chunk means that the end of the
+    // file has been reached, or that reading failed, in which case error() returns the errno.
+    ReadonlyBytes next_chunk();
+    int error() const { return m_error; }
+
+private:
+    void start();
+    int read_chunks();
+
+    int m_fd { -1 };
+    size_t m_chunk_size { 0 };
+    size_t m_max_chunk_count { NumericLimits<size_t>::max() };
+    RefPtr<Thread> m_thread;
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_chunk_read;
+    pthread_cond_t m_chunk_released;
+    // Everything below is guarded by the mutex. Chunk i is kept in m_buffers[i % m_buffers.size()].
+    Vector<u8*> m_buffers;
+    Vector<size_t> m_sizes;
+    size_t m_read_chunk_count { 0 };
+    size_t m_released_chunk_count { 0 };
+    bool m_has_chunk { false };
+    bool m_finished_reading { false };
+    bool m_should_stop { false };
+    int m_error { 0 };
+};
+
+// An InputStream that reads ahead with a PipelinedReader.
+class PipelinedInputStream final : public InputStream {
+public:
+    PipelinedInputStream(int fd, size_t chunk_size, size_t chunk_count = 2)
+        : m_reader(fd, chunk_size, chunk_count)
+    {
+    }
+
+    size_t read(Bytes) override;
+    bool read_or_error(Bytes) override;
+    bool discard_or_error(size_t count) override;
+    bool unreliable_eof() const override { return m_eof && m_chunk.is_empty(); }
+
+    int error() const { return m_reader.error(); }
+
+private:
+    // Makes sure that there's something in m_chunk, unless we're at the end.
+    bool fill_chunk();
+
+    PipelinedReader m_reader;
+    ReadonlyBytes m_chunk;
+    bool m_eof { false };
+};
+
+}
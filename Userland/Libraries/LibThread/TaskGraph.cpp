@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/RefCounted.h>
+#include <LibThread/TaskGraph.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// Shared between TaskGraph::run() and the runner tasks it puts on the pool, which may start after run() has
+// already returned. By then there is nothing left in the ready list, so they leave right away.
+class TaskGraph::State : public RefCounted<TaskGraph::State> {
+public:
+    State()
+    {
+        pthread_mutex_init(&m_mutex, nullptr);
+        pthread_cond_init(&m_changed, nullptr);
+    }
+
+    ~State()
+    {
+        pthread_cond_destroy(&m_changed);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    TaskID add_task(Function<void()> function, const Vector<TaskID>& dependencies)
+    {
+        TaskID id = m_tasks.size();
+        for (auto dependency : dependencies) {
+            VERIFY(dependency < id);
+            m_tasks[dependency].dependents.append(id);
+        }
+        m_tasks.append({ move(function), {}, dependencies.size() });
+        return id;
+    }
+
+    size_t task_count() const { return m_tasks.size(); }
+
+    void run(ThreadPool& pool)
+    {
+        m_pool = &pool;
+
+        pthread_mutex_lock(&m_mutex);
+        for (TaskID id = 0; id < m_tasks.size(); ++id) {
+            if (m_tasks[id].remaining_dependency_count == 0)
+                m_ready.append(id);
+        }
+        auto runner_count = min(m_ready.size(), pool.thread_count()) - 1;
+        pthread_mutex_unlock(&m_mutex);
+        start_runners(runner_count);
+
+        for (;;) {
+            if (run_next_task())
+                continue;
+            pthread_mutex_lock(&m_mutex);
+            while (m_ready.is_empty() && m_completed_task_count != m_tasks.size())
+                pthread_cond_wait(&m_changed, &m_mutex);
+            bool done = m_completed_task_count == m_tasks.size();
+            pthread_mutex_unlock(&m_mutex);
+            if (done)
+                return;
+        }
+    }
+
+private:
+    struct Task {
+        Function<void()> function;
+        Vector<TaskID> dependents;
+        // Guarded by the mutex while the graph is running.
+        size_t remaining_dependency_count { 0 };
+    };
+
+    void start_runners(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            m_pool->submit([this, protector = NonnullRefPtr(*this)] {
+                while (run_next_task())
+                    ;
+            });
+        }
+    }
+
+    // Runs a task whose dependencies are all done, if there is one.
+    bool run_next_task()
+    {
+        pthread_mutex_lock(&m_mutex);
+        if (m_ready.is_empty()) {
+            pthread_mutex_unlock(&m_mutex);
+            return false;
+        }
+        auto id = m_ready.take_last();
+        pthread_mutex_unlock(&m_mutex);
+
+        m_tasks[id].function();
+
+        size_t newly_ready_count = 0;
+        pthread_mutex_lock(&m_mutex);
+        for (auto dependent : m_tasks[id].dependents) {
+            if (--m_tasks[dependent].remaining_dependency_count == 0) {
+                m_ready.append(dependent);
+                ++newly_ready_count;
+            }
+        }
+        ++m_completed_task_count;
+        if (newly_ready_count || m_completed_task_count == m_tasks.size())
+            pthread_cond_broadcast(&m_changed);
+        pthread_mutex_unlock(&m_mutex);
+
+        // We'll pick up one of the newly ready tasks ourselves.
+        if (newly_ready_count > 1)
+            start_runners(newly_ready_count - 1);
+        return true;
+    }
+
+    Vector<Task> m_tasks;
+    ThreadPool* m_pool { nullptr };
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_changed;
+    Vector<TaskID> m_ready;
+    size_t m_completed_task_count { 0 };
+};
+
+TaskGraph::TaskGraph()
+    : m_state(adopt_ref(*new State))
+{
+}
+
+TaskGraph::~TaskGraph()
+{
+}
+
+TaskGraph::TaskID TaskGraph::add_task(Function<void()> function, const Vector<TaskID>& dependencies)
+{
+    VERIFY(!m_has_run);
+    return m_state->add_task(move(function), dependencies);
+}
+
+size_t TaskGraph::task_count() const
+{
+    return m_state->task_count();
+}
+
+void TaskGraph::run(ThreadPool& pool)
+{
+    VERIFY(!m_has_run);
+    m_has_run = true;
+    if (m_state->task_count() == 0)
+        return;
+    m_state->run(pool);
+}
+
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/Vector.h>
+#include <LibThread/ThreadPool.h>
+
+namespace LibThread {
+
+// A set of tasks where some have to wait for others to finish first. run() starts every task as soon as
+// all of its dependencies are done, on the calling thread and the threads of a ThreadPool, and returns
+// once all tasks have run. A task can only depend on tasks that were added before it, so there are no cycles.
+class TaskGraph {
+    AK_MAKE_NONCOPYABLE(TaskGraph);
+    AK_MAKE_NONMOVABLE(TaskGraph);
+
+public:
+    using TaskID = size_t;
+
+    TaskGraph();
+    ~TaskGraph();
+
+    TaskID add_task(Function<void()>, const Vector<TaskID>& dependencies = {});
+
+    size_t task_count() const;
+
+    // A graph can only be run once.
+    void run(ThreadPool& = ThreadPool::the());
+
+private:
+    class State;
+
+    NonnullRefPtr<State> m_state;
+    bool m_has_run { false };
+};
+
+}
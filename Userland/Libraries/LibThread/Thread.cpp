@@ -34,7 +34,6 @@ void LibThread::Thread::start()
         [](void* arg) -> void* {
             Thread* self = static_cast<Thread*>(arg);
             int exit_code = self->m_action();
-            self->m_tid = 0;
             return (void*)exit_code;
         },
         static_cast<void*>(this));
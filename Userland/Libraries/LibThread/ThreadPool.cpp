@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThread/ThreadPool.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+// The worker the current thread is, if it belongs to a pool, so that tasks can queue up follow-up work locally.
+static __thread ThreadPool* s_current_pool;
+static __thread size_t s_current_worker_index;
+
+ThreadPool::ThreadPool(const String& thread_name, size_t thread_count)
+{
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_work_available, nullptr);
+
+    if (thread_count == 0)
+        thread_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1l);
+
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto worker = make<Worker>();
+        pthread_mutex_init(&worker->mutex, nullptr);
+        m_workers.append(move(worker));
+    }
+
+    // Only start the threads once all the workers exist, since they steal from each other.
+    for (size_t i = 0; i < thread_count; ++i) {
+        auto thread = Thread::construct([this, i] {
+            run_worker(i);
+            return 0;
+        },
+            thread_name);
+        thread->start();
+        m_workers[i].thread = move(thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_exiting = true;
+    pthread_cond_broadcast(&m_work_available);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (auto& worker : m_workers)
+        [[maybe_unused]] auto result = worker.thread->join();
+
+    for (auto& worker : m_workers)
+        pthread_mutex_destroy(&worker.mutex);
+    pthread_cond_destroy(&m_work_available);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+ThreadPool& ThreadPool::the()
+{
+    // Never destroyed, as threads may still be running tasks while the process exits.
+    static ThreadPool* s_the;
+    if (!s_the)
+        s_the = new ThreadPool("Background thread");
+    return *s_the;
+}
+
+void ThreadPool::submit(Function<void()> task, Priority priority, RefPtr<CancellationToken> cancellation_token)
+{
+    size_t worker_index;
+    if (s_current_pool == this)
+        worker_index = s_current_worker_index;
+    else
+        worker_index = m_next_worker.fetch_add(1, AK::MemoryOrder::memory_order_relaxed) % m_workers.size();
+
+    auto& worker = m_workers[worker_index];
+    pthread_mutex_lock(&worker.mutex);
+    worker.queues[static_cast<size_t>(priority)].append({ move(task), move(cancellation_token) });
+    pthread_mutex_unlock(&worker.mutex);
+
+    pthread_mutex_lock(&m_mutex);
+    m_queued_task_count.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    pthread_cond_signal(&m_work_available);
+    pthread_mutex_unlock(&m_mutex);
+}
+
+bool ThreadPool::take_task(size_t worker_index, Task& task)
+{
+    for (size_t priority = priority_count; priority-- > 0;) {
+        // Our own newest task first, as whatever it works on is most likely still in the cache.
+        auto& own_worker = m_workers[worker_index];
+        pthread_mutex_lock(&own_worker.mutex);
+        if (!own_worker.queues[priority].is_empty()) {
+            task = own_worker.queues[priority].take_last();
+            pthread_mutex_unlock(&own_worker.mutex);
+            return true;
+        }
+        pthread_mutex_unlock(&own_worker.mutex);
+
+        // Otherwise the oldest task of another worker, which has been waiting the longest.
+        for (size_t offset = 1; offset < m_workers.size(); ++offset) {
+            auto& victim = m_workers[(worker_index + offset) % m_workers.size()];
+            pthread_mutex_lock(&victim.mutex);
+            if (!victim.queues[priority].is_empty()) {
+                task = victim.queues[priority].take_first();
+                pthread_mutex_unlock(&victim.mutex);
+                return true;
+            }
+            pthread_mutex_unlock(&victim.mutex);
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run_worker(size_t index)
+{
+    s_current_pool = this;
+    s_current_worker_index = index;
+
+    for (;;) {
+        Task task;
+        if (take_task(index, task)) {
+            m_queued_task_count.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+            if (!task.cancellation_token || !task.cancellation_token->is_cancelled())
+                task.function();
+            continue;
+        }
+
+        pthread_mutex_lock(&m_mutex);
+        while (!m_exiting && m_queued_task_count.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+            pthread_cond_wait(&m_work_available, &m_mutex);
+        bool exiting = m_exiting;
+        pthread_mutex_unlock(&m_mutex);
+        if (exiting)
+            return;
+    }
+}
+
+}
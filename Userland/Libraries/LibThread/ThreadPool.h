@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibThread/Thread.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// Lets whoever submitted a task call it off. A task that hasn't started yet when its token is cancelled
+// is dropped; one that is already running can check is_cancelled() and stop early.
+class CancellationToken : public RefCounted<CancellationToken> {
+public:
+    static NonnullRefPtr<CancellationToken> create() { return adopt_ref(*new CancellationToken); }
+
+    void cancel() { m_cancelled.store(true, AK::MemoryOrder::memory_order_relaxed); }
+    bool is_cancelled() const { return m_cancelled.load(AK::MemoryOrder::memory_order_relaxed); }
+
+private:
+    CancellationToken() = default;
+
+    Atomic<bool> m_cancelled { false };
+};
+
+// A fixed set of threads that run independent tasks in the background. Every thread has its own queue of
+// tasks for each priority; tasks submitted from outside the pool are handed out round-robin, and tasks
+// submitted by a task go to the queue of the thread running it. A thread that runs out of work takes
+// the oldest task from another thread's queue, so no thread sits idle while there is work left.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    enum class Priority : u8 {
+        Low,
+        Normal,
+        High,
+    };
+
+    // A thread_count of 0 means one thread per processor.
+    explicit ThreadPool(const String& thread_name, size_t thread_count = 0);
+    // Waits for the tasks that are running to finish. Tasks that haven't started yet are dropped.
+    ~ThreadPool();
+
+    // The pool shared by everyone in the process, e.g. for BackgroundAction.
+    static ThreadPool& the();
+
+    size_t thread_count() const { return m_workers.size(); }
+
+    void submit(Function<void()> task, Priority = Priority::Normal, RefPtr<CancellationToken> = nullptr);
+
+private:
+    static constexpr size_t priority_count = 3;
+
+    struct Task {
+        Function<void()> function;
+        RefPtr<CancellationToken> cancellation_token;
+    };
+
+    struct Worker {
+        pthread_mutex_t mutex;
+        // Guarded by the mutex, indexed by priority.
+        Vector<Task> queues[priority_count];
+        RefPtr<Thread> thread;
+    };
+
+    void run_worker(size_t index);
+    bool take_task(size_t worker_index, Task&);
+
+    NonnullOwnPtrVector<Worker> m_workers;
+    Atomic<size_t> m_next_worker { 0 };
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_work_available;
+    // The number of queued tasks. Only ever increased with the mutex held, so a worker that checks it
+    // with the mutex held before going to sleep won't miss a submission.
+    Atomic<size_t> m_queued_task_count { 0 };
+    bool m_exiting { false };
+};
+
+}
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibThread/WorkerPool.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+// Painting doesn't get much faster beyond this, and every thread keeps a stack around.
+static constexpr long max_thread_count = 3;
+
+WorkerPool::WorkerPool(const String& thread_name)
+{
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_work_available, nullptr);
+    pthread_cond_init(&m_work_done, nullptr);
+
+    // The main thread paints too, so it takes one of the processors.
+    auto thread_count = clamp(sysconf(_SC_NPROCESSORS_ONLN) - 1, 0l, max_thread_count);
+    for (long i = 0; i < thread_count; ++i) {
+        m_threads.append(Thread::construct([this] {
+            for (;;) {
+                pthread_mutex_lock(&m_mutex);
+                while (!m_exiting && !(m_job && m_next_index < m_job_count))
+                    pthread_cond_wait(&m_work_available, &m_mutex);
+                bool exiting = m_exiting;
+                pthread_mutex_unlock(&m_mutex);
+                if (exiting)
+                    return 0;
+                work_on_current_job();
+            }
+        },
+            thread_name));
+        m_threads.last().start();
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_exiting = true;
+    pthread_cond_broadcast(&m_work_available);
+    pthread_mutex_unlock(&m_mutex);
+    for (auto& thread : m_threads)
+        [[maybe_unused]] auto result = thread.join();
+
+    pthread_cond_destroy(&m_work_done);
+    pthread_cond_destroy(&m_work_available);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void WorkerPool::run(size_t count, Function<void(size_t)> job)
+{
+    if (m_threads.is_empty() || count < 2) {
+        for (size_t i = 0; i < count; ++i)
+            job(i);
+        return;
+    }
+
+    pthread_mutex_lock(&m_mutex);
+    m_job = &job;
+    m_job_count = count;
+    m_next_index = 0;
+    pthread_cond_broadcast(&m_work_available);
+    pthread_mutex_unlock(&m_mutex);
+
+    work_on_current_job();
+
+    // None of the threads can pick up a call after this, since there are none left, so the job can go away.
+    pthread_mutex_lock(&m_mutex);
+    while (m_calls_in_progress > 0)
+        pthread_cond_wait(&m_work_done, &m_mutex);
+    m_job = nullptr;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+void WorkerPool::work_on_current_job()
+{
+    pthread_mutex_lock(&m_mutex);
+    while (m_job && m_next_index < m_job_count) {
+        auto& job = *m_job;
+        auto index = m_next_index++;
+        ++m_calls_in_progress;
+        pthread_mutex_unlock(&m_mutex);
+
+        job(index);
+
+        pthread_mutex_lock(&m_mutex);
+        if (--m_calls_in_progress == 0 && m_next_index >= m_job_count)
+            pthread_cond_signal(&m_work_done);
+    }
+    pthread_mutex_unlock(&m_mutex);
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/String.h>
+#include <LibThread/Thread.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// A few threads that work on a job along with the calling thread, which waits for all of them to be done. That way the
+// job can use whatever the calling thread owns, as long as none of its calls touch the same things.
+class WorkerPool {
+    AK_MAKE_NONCOPYABLE(WorkerPool);
+    AK_MAKE_NONMOVABLE(WorkerPool);
+
+public:
+    explicit WorkerPool(const String& thread_name);
+    ~WorkerPool();
+
+    // The number of threads on top of the calling one, 0 if there is only one processor.
+    size_t thread_count() const { return m_threads.size(); }
+
+    // Calls the job for every index up to the count, from any of the threads, and returns once all of the calls have.
+    void run(size_t count, Function<void(size_t)> job);
+
+private:
+    void work_on_current_job();
+
+    NonnullRefPtrVector<Thread> m_threads;
+
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_work_available;
+    pthread_cond_t m_work_done;
+
+    // All of these are guarded by the mutex.
+    Function<void(size_t)>* m_job { nullptr };
+    size_t m_job_count { 0 };
+    size_t m_next_index { 0 };
+    size_t m_calls_in_progress { 0 };
+    bool m_exiting { false };
+};
+
+}
@@ -4,12 +4,14 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/NumericLimits.h>
 #include <LibVT/Line.h>
 
 namespace VT {
 
 Line::Line(size_t length)
 {
+    m_attributes.append(Attribute {});
     set_length(length);
 }
 
@@ -22,21 +24,34 @@ void Line::set_length(size_t new_length)
     size_t old_length = length();
     if (old_length == new_length)
         return;
-    m_cells.resize(new_length);
+    m_code_points.resize(new_length);
+    m_attribute_indices.resize(new_length);
+    if (new_length > old_length) {
+        auto default_attribute_index = index_of_attribute({});
+        for (size_t i = old_length; i < new_length; ++i) {
+            m_code_points[i] = ' ';
+            m_attribute_indices[i] = default_attribute_index;
+        }
+    }
 }
 
 void Line::clear(const Attribute& attribute)
 {
-    if (m_dirty) {
-        for (auto& cell : m_cells) {
-            cell = Cell { .code_point = ' ', .attribute = attribute };
+    if (!m_dirty) {
+        for (size_t i = 0; i < length(); ++i) {
+            if (m_code_points[i] != ' ' || attribute_at(i) != attribute) {
+                m_dirty = true;
+                break;
+            }
         }
-        return;
     }
-    for (auto& cell : m_cells) {
-        if (!m_dirty)
-            m_dirty = cell.code_point != ' ' || cell.attribute != attribute;
-        cell = Cell { .code_point = ' ', .attribute = attribute };
+
+    m_attributes.clear_with_capacity();
+    m_attributes.append(attribute);
+    m_last_attribute_index = 0;
+    for (size_t i = 0; i < length(); ++i) {
+        m_code_points[i] = ' ';
+        m_attribute_indices[i] = 0;
     }
 }
 
@@ -53,4 +68,59 @@ bool Line::has_only_one_background_color() const
     return true;
 }
 
+static bool is_same_attribute(const Attribute& stored, const Attribute& attribute, u8 additional_flags)
+{
+    return stored.foreground_color == attribute.foreground_color
+        && stored.background_color == attribute.background_color
+        && stored.flags == (attribute.flags | additional_flags)
+        && stored.href_id == attribute.href_id
+        && stored.href == attribute.href;
+}
+
+u16 Line::index_of_attribute(const Attribute& attribute, u8 additional_flags)
+{
+    if (is_same_attribute(m_attributes[m_last_attribute_index], attribute, additional_flags))
+        return m_last_attribute_index;
+
+    for (size_t i = 0; i < m_attributes.size(); ++i) {
+        if (is_same_attribute(m_attributes[i], attribute, additional_flags)) {
+            m_last_attribute_index = i;
+            return i;
+        }
+    }
+
+    // Attributes that have been overwritten everywhere are still around, so make room before the line runs out of
+    // indices, or collects attributes it hasn't used in a long time.
+    if (m_attributes.size() >= max(length(), (size_t)16))
+        remove_unused_attributes();
+    VERIFY(m_attributes.size() < NumericLimits<u16>::max());
+
+    m_attributes.append(attribute);
+    m_attributes.last().flags |= additional_flags;
+    m_last_attribute_index = m_attributes.size() - 1;
+    return m_last_attribute_index;
+}
+
+void Line::remove_unused_attributes()
+{
+    Vector<u16> new_indices;
+    new_indices.resize(m_attributes.size());
+    for (auto& index : new_indices)
+        index = NumericLimits<u16>::max();
+
+    Vector<Attribute, 1> used_attributes;
+    for (auto& index : m_attribute_indices) {
+        if (new_indices[index] == NumericLimits<u16>::max()) {
+            new_indices[index] = used_attributes.size();
+            used_attributes.append(m_attributes[index]);
+        }
+        index = new_indices[index];
+    }
+    if (used_attributes.is_empty())
+        used_attributes.append(Attribute {});
+
+    m_attributes = move(used_attributes);
+    m_last_attribute_index = 0;
+}
+
 }
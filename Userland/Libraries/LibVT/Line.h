@@ -68,38 +68,42 @@ public:
     explicit Line(size_t length);
     ~Line();
 
-    struct Cell {
-        u32 code_point { ' ' };
-        Attribute attribute;
-    };
-
-    const Attribute& attribute_at(size_t index) const { return m_cells[index].attribute; }
-    Attribute& attribute_at(size_t index) { return m_cells[index].attribute; }
-
-    Cell& cell_at(size_t index) { return m_cells[index]; }
-    const Cell& cell_at(size_t index) const { return m_cells[index]; }
+    // A line only holds the few different attributes its cells use, and each cell refers to one of them, since a cell
+    // with its own copy of an attribute would be several times the size of its code point.
+    const Attribute& attribute_at(size_t index) const { return m_attributes[m_attribute_indices[index]]; }
+    void set_attribute(size_t index, const Attribute& attribute, u8 additional_flags = Attribute::NoAttributes)
+    {
+        m_attribute_indices[index] = index_of_attribute(attribute, additional_flags);
+    }
 
     void clear(const Attribute&);
     bool has_only_one_background_color() const;
 
-    size_t length() const { return m_cells.size(); }
+    size_t length() const { return m_code_points.size(); }
     void set_length(size_t);
 
     u32 code_point(size_t index) const
     {
-        return m_cells[index].code_point;
+        return m_code_points[index];
     }
 
     void set_code_point(size_t index, u32 code_point)
     {
-        m_cells[index].code_point = code_point;
+        m_code_points[index] = code_point;
     }
 
     bool is_dirty() const { return m_dirty; }
     void set_dirty(bool b) { m_dirty = b; }
 
 private:
-    Vector<Cell> m_cells;
+    u16 index_of_attribute(const Attribute&, u8 additional_flags = Attribute::NoAttributes);
+    void remove_unused_attributes();
+
+    Vector<u32> m_code_points;
+    Vector<u16> m_attribute_indices;
+    Vector<Attribute, 1> m_attributes;
+    // Writes usually come in runs with the same attribute.
+    u16 m_last_attribute_index { 0 };
     bool m_dirty { false };
 };
 
@@ -698,13 +698,22 @@ void Terminal::scroll_up()
 {
     // NOTE: We have to invalidate the cursor first.
     invalidate_cursor();
+    OwnPtr<Line> unused_line;
+    auto line = m_lines.take(m_scroll_region_top);
     if (m_scroll_region_top == 0) {
-        auto line = move(m_lines.ptr_at(m_scroll_region_top));
-        add_line_to_history(move(line));
+        unused_line = add_line_to_history(move(line));
         m_client.terminal_history_changed();
+    } else {
+        unused_line = move(line);
+    }
+    // Fast output scrolls by a lot of lines, so the line that's no longer needed becomes the new one.
+    if (unused_line && unused_line->length() == m_columns) {
+        unused_line->clear({});
+        unused_line->set_dirty(false);
+        m_lines.insert(m_scroll_region_bottom, unused_line.release_nonnull());
+    } else {
+        m_lines.insert(m_scroll_region_bottom, make<Line>(m_columns));
     }
-    m_lines.remove(m_scroll_region_top);
-    m_lines.insert(m_scroll_region_bottom, make<Line>(m_columns));
     m_need_full_flush = true;
 }
 
@@ -738,8 +747,7 @@ void Terminal::put_character_at(unsigned row, unsigned column, u32 code_point)
     VERIFY(column < columns());
     auto& line = m_lines[row];
     line.set_code_point(column, code_point);
-    line.attribute_at(column) = m_current_attribute;
-    line.attribute_at(column).flags |= Attribute::Touched;
+    line.set_attribute(column, m_current_attribute, Attribute::Touched);
     line.set_dirty(true);
 
     m_last_code_point = code_point;
@@ -984,10 +992,54 @@ void Terminal::on_code_point(u32 code_point)
     }
 }
 
+static bool is_printable_ascii(u8 ch)
+{
+    return ch >= 0x20 && ch < 0x7f;
+}
+
+void Terminal::on_input(ReadonlyBytes bytes)
+{
+    for (size_t i = 0; i < bytes.size();) {
+        // Runs of plain text are most of the output, and need none of the parser's states.
+        if (m_parser_state == Normal && is_printable_ascii(bytes[i])) {
+            size_t run_length = 1;
+            while (i + run_length < bytes.size() && is_printable_ascii(bytes[i + run_length]))
+                ++run_length;
+            put_printable_ascii(bytes.slice(i, run_length));
+            i += run_length;
+            continue;
+        }
+        on_input(bytes[i++]);
+    }
+}
+
+// Does what on_code_point() would for each character, but only moves the cursor once for all the ones that fit on the
+// cursor's line.
+void Terminal::put_printable_ascii(ReadonlyBytes characters)
+{
+    for (size_t i = 0; i < characters.size();) {
+        if (m_cursor_column + 1u >= columns()) {
+            on_code_point(characters[i++]);
+            continue;
+        }
+
+        auto& line = m_lines[m_cursor_row];
+        auto column = m_cursor_column;
+        while (i < characters.size() && column + 1u < columns()) {
+            line.set_code_point(column, characters[i]);
+            line.set_attribute(column, m_current_attribute, Attribute::Touched);
+            ++column;
+            ++i;
+        }
+        line.set_dirty(true);
+        m_last_code_point = characters[i - 1];
+        set_cursor(m_cursor_row, column);
+    }
+}
+
 void Terminal::inject_string(const StringView& str)
 {
-    for (size_t i = 0; i < str.length(); ++i)
-        on_input(str[i]);
+    on_input(str.bytes());
 }
 
 void Terminal::emit_string(const StringView& string)
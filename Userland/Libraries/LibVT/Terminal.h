@@ -8,6 +8,7 @@
 
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtrVector.h>
+#include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <Kernel/API/KeyCode.h>
@@ -37,6 +38,7 @@ public:
 
     void invalidate_cursor();
     void on_input(u8);
+    void on_input(ReadonlyBytes);
 
     void clear();
     void clear_including_history();
@@ -109,6 +111,7 @@ private:
     typedef Vector<unsigned, 4> ParamVector;
 
     void on_code_point(u32);
+    void put_printable_ascii(ReadonlyBytes);
 
     void scroll_up();
     void scroll_down();
@@ -218,18 +221,21 @@ private:
 
     size_t m_history_start = 0;
     NonnullOwnPtrVector<Line> m_history;
-    void add_line_to_history(NonnullOwnPtr<Line>&& line)
+    // Returns the line that no longer fits in the history, if any.
+    OwnPtr<Line> add_line_to_history(NonnullOwnPtr<Line>&& line)
     {
         if (max_history_size() == 0)
-            return;
+            return move(line);
 
         if (m_history.size() < max_history_size()) {
             VERIFY(m_history_start == 0);
             m_history.append(move(line));
-            return;
+            return {};
         }
+        OwnPtr<Line> evicted_line = move(m_history.ptr_at(m_history_start));
         m_history.ptr_at(m_history_start) = move(line);
         m_history_start = (m_history_start + 1) % m_history.size();
+        return evicted_line;
     }
 
     NonnullOwnPtrVector<Line> m_lines;
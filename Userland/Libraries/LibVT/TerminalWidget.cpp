@@ -49,7 +49,7 @@ void TerminalWidget::set_pty_master_fd(int fd)
     }
     m_notifier = Core::Notifier::construct(m_ptm_fd, Core::Notifier::Read);
     m_notifier->on_ready_to_read = [this] {
-        u8 buffer[BUFSIZ];
+        u8 buffer[16 * KiB];
         ssize_t nread = read(m_ptm_fd, buffer, sizeof(buffer));
         if (nread < 0) {
             dbgln("Terminal read error: {}", strerror(errno));
@@ -68,9 +68,14 @@ void TerminalWidget::set_pty_master_fd(int fd)
             set_pty_master_fd(-1);
             return;
         }
-        for (ssize_t i = 0; i < nread; ++i)
-            m_terminal.on_input(buffer[i]);
-        flush_dirty_lines();
+        m_terminal.on_input({ buffer, (size_t)nread });
+        // Fast output would otherwise be repainted after every read, so repaints are held back to one per frame.
+        if (m_flush_dirty_lines_timer->is_active()) {
+            m_has_dirty_lines_to_flush = true;
+        } else {
+            flush_dirty_lines();
+            m_flush_dirty_lines_timer->start();
+        }
     };
 }
 
@@ -86,6 +91,13 @@ TerminalWidget::TerminalWidget(int ptm_fd, bool automatic_size_policy, RefPtr<Co
     m_cursor_blink_timer = add<Core::Timer>();
     m_visual_beep_timer = add<Core::Timer>();
     m_auto_scroll_timer = add<Core::Timer>();
+    m_flush_dirty_lines_timer = add<Core::Timer>();
+    m_flush_dirty_lines_timer->set_single_shot(true);
+    m_flush_dirty_lines_timer->set_interval(16);
+    m_flush_dirty_lines_timer->on_timeout = [this] {
+        if (m_has_dirty_lines_to_flush)
+            flush_dirty_lines();
+    };
 
     m_scrollbar = add<GUI::Scrollbar>(Orientation::Vertical);
     m_scrollbar->set_relative_rect(0, 0, 16, 0);
@@ -330,7 +342,7 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
                 && visual_row == row_with_cursor
                 && column == m_terminal.cursor_column();
             should_reverse_fill_for_cursor_or_selection |= selection_contains({ first_row_from_history + visual_row, (int)column });
-            auto attribute = line.attribute_at(column);
+            auto& attribute = line.attribute_at(column);
             auto character_rect = glyph_rect(visual_row, column);
             auto cell_rect = character_rect.inflated(0, m_line_spacing);
             auto text_color = color_from_rgb(should_reverse_fill_for_cursor_or_selection ? attribute.effective_background_color() : attribute.effective_foreground_color());
@@ -387,7 +399,7 @@ void TerminalWidget::paint_event(GUI::PaintEvent& event)
             continue;
         auto& line = m_terminal.line(first_row_from_history + visual_row);
         for (size_t column = 0; column < line.length(); ++column) {
-            auto attribute = line.attribute_at(column);
+            auto& attribute = line.attribute_at(column);
             bool should_reverse_fill_for_cursor_or_selection = m_cursor_blink_state
                 && m_has_logical_focus
                 && visual_row == row_with_cursor
@@ -449,6 +461,7 @@ void TerminalWidget::invalidate_cursor()
 
 void TerminalWidget::flush_dirty_lines()
 {
+    m_has_dirty_lines_to_flush = false;
     // FIXME: Update smarter when scrolled
     if (m_terminal.m_need_full_flush || m_scrollbar->value() != m_scrollbar->max()) {
         update();
@@ -188,6 +188,8 @@ private:
     RefPtr<Core::Timer> m_cursor_blink_timer;
     RefPtr<Core::Timer> m_visual_beep_timer;
     RefPtr<Core::Timer> m_auto_scroll_timer;
+    RefPtr<Core::Timer> m_flush_dirty_lines_timer;
+    bool m_has_dirty_lines_to_flush { false };
     RefPtr<Core::ConfigFile> m_config;
 
     RefPtr<GUI::Scrollbar> m_scrollbar;
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/NumericLimits.h>
+#include <LibWeb/CSS/AncestorFilter.h>
+#include <LibWeb/CSS/Selector.h>
+#include <LibWeb/DOM/Element.h>
+#include <LibWeb/HTML/AttributeNames.h>
+
+namespace Web::CSS {
+
+u32 AncestorFilter::hash_for(KeyType type, const FlyString& value)
+{
+    return pair_int_hash(value.hash(), static_cast<u32>(type));
+}
+
+void AncestorFilter::push_element(const DOM::Element& element)
+{
+    size_t hash_count_before = m_hashes.size();
+    auto add = [&](KeyType type, const FlyString& value) {
+        auto hash = hash_for(type, value);
+        m_hashes.append(hash);
+        add_hash(hash);
+    };
+
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_null())
+        add(KeyType::Id, id);
+    for (auto& class_name : element.class_names())
+        add(KeyType::Class, class_name);
+    add(KeyType::TagName, element.local_name());
+
+    m_elements.append(&element);
+    m_hash_count_of_element.append(m_hashes.size() - hash_count_before);
+}
+
+void AncestorFilter::pop_element()
+{
+    m_elements.take_last();
+    auto hash_count = m_hash_count_of_element.take_last();
+    for (size_t i = 0; i < hash_count; ++i)
+        remove_hash(m_hashes.take_last());
+}
+
+bool AncestorFilter::is_for_parent_of(const DOM::Element& element) const
+{
+    return !m_elements.is_empty() && m_elements.last() == element.parent_element();
+}
+
+// Every hash sets two of the counters, one picked by the lower bits and one by the bits above them.
+void AncestorFilter::add_hash(u32 hash)
+{
+    for (auto key : { hash & key_mask, (hash >> key_bits) & key_mask }) {
+        if (m_counters[key] != NumericLimits<u8>::max())
+            ++m_counters[key];
+    }
+}
+
+void AncestorFilter::remove_hash(u32 hash)
+{
+    for (auto key : { hash & key_mask, (hash >> key_bits) & key_mask }) {
+        if (m_counters[key] != NumericLimits<u8>::max())
+            --m_counters[key];
+    }
+}
+
+bool AncestorFilter::may_contain(u32 hash) const
+{
+    return m_counters[hash & key_mask] && m_counters[(hash >> key_bits) & key_mask];
+}
+
+bool AncestorFilter::rejects(const Selector& selector) const
+{
+    for (auto hash : selector.ancestor_hashes()) {
+        if (!may_contain(hash))
+            return true;
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/Vector.h>
+#include <LibWeb/Forward.h>
+
+namespace Web::CSS {
+
+// A counting Bloom filter of the IDs, classes and tag names of the ancestors of an element. It lets selectors that need
+// an ancestor with one of these be rejected without walking up the tree. It can claim that there might be such an
+// ancestor when there isn't, but never the other way around.
+class AncestorFilter {
+public:
+    enum class KeyType : u8 {
+        Id,
+        Class,
+        TagName,
+    };
+    static u32 hash_for(KeyType, const FlyString&);
+
+    void push_element(const DOM::Element&);
+    void pop_element();
+
+    bool is_empty() const { return m_elements.is_empty(); }
+
+    // The filter can only be asked about an element if it holds exactly the ancestors of that element.
+    bool is_for_parent_of(const DOM::Element&) const;
+
+    bool may_contain(u32 hash) const;
+    bool rejects(const Selector&) const;
+
+private:
+    static constexpr size_t key_bits = 12;
+    static constexpr u32 key_mask = (1 << key_bits) - 1;
+
+    void add_hash(u32);
+    void remove_hash(u32);
+
+    // A counter that reaches the maximum stays there, since it can't know how many of the elements it stands for are gone.
+    u8 m_counters[1 << key_bits] {};
+
+    Vector<const DOM::Element*> m_elements;
+    Vector<u32> m_hashes;
+    Vector<size_t> m_hash_count_of_element;
+};
+
+}
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/AnyOf.h>
 #include <AK/HashMap.h>
 #include <LibWeb/CSS/CSSImportRule.h>
 #include <LibWeb/CSS/CSSRule.h>
@@ -210,6 +211,18 @@ static CSS::Length parse_length(const CSS::ParsingContext& context, const String
     return CSS::Length(value.value(), type);
 }
 
+// Style values never change once they're parsed, so the common keyword values can be shared by every declaration that uses them.
+static NonnullRefPtr<CSS::IdentifierStyleValue> shared_identifier_style_value(CSS::ValueID id)
+{
+    static Vector<RefPtr<CSS::IdentifierStyleValue>> s_values;
+    auto index = static_cast<size_t>(id);
+    if (index >= s_values.size())
+        s_values.resize(index + 1);
+    if (!s_values[index])
+        s_values[index] = CSS::IdentifierStyleValue::create(id);
+    return *s_values[index];
+}
+
 static bool takes_integer_value(CSS::PropertyID property_id)
 {
     return property_id == CSS::PropertyID::ZIndex || property_id == CSS::PropertyID::FontWeight;
@@ -231,16 +244,22 @@ RefPtr<CSS::StyleValue> parse_css_value(const CSS::ParsingContext& context, cons
     if (!length.is_undefined())
         return CSS::LengthStyleValue::create(length);
 
-    if (string.equals_ignoring_case("inherit"))
-        return CSS::InheritStyleValue::create();
-    if (string.equals_ignoring_case("initial"))
-        return CSS::InitialStyleValue::create();
-    if (string.equals_ignoring_case("auto"))
-        return CSS::LengthStyleValue::create(CSS::Length::make_auto());
+    if (string.equals_ignoring_case("inherit")) {
+        static auto& s_inherit = CSS::InheritStyleValue::create().leak_ref();
+        return s_inherit;
+    }
+    if (string.equals_ignoring_case("initial")) {
+        static auto& s_initial = CSS::InitialStyleValue::create().leak_ref();
+        return s_initial;
+    }
+    if (string.equals_ignoring_case("auto")) {
+        static auto& s_auto = CSS::LengthStyleValue::create(CSS::Length::make_auto()).leak_ref();
+        return s_auto;
+    }
 
     auto value_id = CSS::value_id_from_string(string);
     if (value_id != CSS::ValueID::Invalid)
-        return CSS::IdentifierStyleValue::create(value_id);
+        return shared_identifier_style_value(value_id);
 
     auto color = parse_css_color(context, string);
     if (color.has_value())
@@ -416,29 +435,30 @@ public:
             type = CSS::Selector::SimpleSelector::Type::Universal;
         }
 
+        auto value_start = index;
         if (type != CSS::Selector::SimpleSelector::Type::Universal) {
             while (is_valid_selector_char(peek()))
-                buffer.append(consume_one());
-            PARSE_VERIFY(!buffer.is_null());
+                consume_one();
         }
 
-        auto value = String::copy(buffer);
-
-        if (type == CSS::Selector::SimpleSelector::Type::TagName) {
+        auto value_view = css.substring_view(value_start, index - value_start);
+        FlyString value;
+        if (type == CSS::Selector::SimpleSelector::Type::TagName && any_of(value_view.begin(), value_view.end(), [](char ch) { return isupper(ch); })) {
             // Some stylesheets use uppercase tag names, so here's a hack to just lowercase them internally.
-            value = value.to_lowercase();
+            value = String(value_view).to_lowercase();
+        } else {
+            value = value_view;
         }
 
         CSS::Selector::SimpleSelector simple_selector {
             type,
             CSS::Selector::SimpleSelector::PseudoClass::None,
             CSS::Selector::SimpleSelector::PseudoElement::None,
-            value,
+            move(value),
             CSS::Selector::SimpleSelector::AttributeMatchType::None,
             String(),
             String()
         };
-        buffer.clear();
 
         if (peek() == '[') {
             CSS::Selector::SimpleSelector::AttributeMatchType attribute_match_type = CSS::Selector::SimpleSelector::AttributeMatchType::HasAttribute;
@@ -499,25 +519,23 @@ public:
                 is_pseudo_element = true;
                 consume_one();
             }
+            auto pseudo_name_start = index;
             if (next_is("not")) {
-                buffer.append(consume_one());
-                buffer.append(consume_one());
-                buffer.append(consume_one());
+                consume_one();
+                consume_one();
+                consume_one();
                 if (!consume_specific('('))
                     return {};
-                buffer.append('(');
                 while (peek() != ')')
-                    buffer.append(consume_one());
+                    consume_one();
                 if (!consume_specific(')'))
                     return {};
-                buffer.append(')');
             } else {
                 while (is_valid_selector_char(peek()))
-                    buffer.append(consume_one());
+                    consume_one();
             }
 
-            auto pseudo_name = String::copy(buffer);
-            buffer.clear();
+            auto pseudo_name = css.substring_view(pseudo_name_start, index - pseudo_name_start);
 
             // Ignore for now, otherwise we produce a "false positive" selector
             // and apply styles to the element itself, not its pseudo element
@@ -671,7 +689,8 @@ public:
     }
 
     struct ValueAndImportant {
-        String value;
+        // Points into the source if we can, and into our buffer otherwise, so it's only good until the next value.
+        StringView value;
         bool important { false };
     };
 
@@ -679,6 +698,30 @@ public:
     {
         buffer.clear();
 
+        // Most values are a contiguous run of the source, so we only copy characters into the buffer once
+        // an escape, a comment or !important gets in between.
+        size_t slice_start = index;
+        size_t slice_end = index;
+        bool is_slice = true;
+        auto consume_into_value = [&] {
+            auto position = index;
+            char ch = consume_one();
+            if (is_slice) {
+                if (slice_start == slice_end) {
+                    slice_start = position;
+                    slice_end = position + 1;
+                    return;
+                }
+                if (position == slice_end) {
+                    ++slice_end;
+                    return;
+                }
+                buffer.append(css.characters_without_null_termination() + slice_start, slice_end - slice_start);
+                is_slice = false;
+            }
+            buffer.append(ch);
+        };
+
         int paren_nesting_level = 0;
         bool important = false;
 
@@ -686,17 +729,17 @@ public:
             char ch = peek();
             if (ch == '(') {
                 ++paren_nesting_level;
-                buffer.append(consume_one());
+                consume_into_value();
                 continue;
             }
             if (ch == ')') {
                 PARSE_VERIFY(paren_nesting_level > 0);
                 --paren_nesting_level;
-                buffer.append(consume_one());
+                consume_into_value();
                 continue;
             }
             if (paren_nesting_level > 0) {
-                buffer.append(consume_one());
+                consume_into_value();
                 continue;
             }
             if (next_is("!important")) {
@@ -721,24 +764,25 @@ public:
                 break;
             if (ch == '\\') {
                 consume_one();
-                buffer.append(consume_one());
+                consume_into_value();
                 continue;
             }
             if (ch == '}')
                 break;
             if (ch == ';')
                 break;
-            buffer.append(consume_one());
+            consume_into_value();
         }
 
         // Remove trailing whitespace.
+        if (is_slice) {
+            while (slice_end > slice_start && isspace(css[slice_end - 1]))
+                --slice_end;
+            return { css.substring_view(slice_start, slice_end - slice_start), important };
+        }
         while (!buffer.is_empty() && isspace(buffer.last()))
             buffer.take_last();
-
-        auto string = String::copy(buffer);
-        buffer.clear();
-
-        return { string, important };
+        return { StringView(buffer.data(), buffer.size()), important };
     }
 
     Optional<CSS::StyleProperty> parse_property()
@@ -750,11 +794,10 @@ public:
         }
         if (peek() == '}')
             return {};
-        buffer.clear();
+        auto property_name_start = index;
         while (is_valid_property_name_char(peek()))
-            buffer.append(consume_one());
-        auto property_name = String::copy(buffer);
-        buffer.clear();
+            consume_one();
+        auto property_name = css.substring_view(property_name_start, index - property_name_start);
         consume_whitespace_or_comments();
         if (!consume_specific(':'))
             return {};
@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/Selector.h>
 
 namespace Web::CSS {
@@ -11,6 +12,8 @@ namespace Web::CSS {
 Selector::Selector(Vector<ComplexSelector>&& component_lists)
     : m_complex_selectors(move(component_lists))
 {
+    collect_ancestor_hashes();
+    find_out_what_can_tell_elements_apart();
 }
 
 Selector::~Selector()
@@ -44,4 +47,64 @@ u32 Selector::specificity() const
     return ids * 0x10000 + classes * 0x100 + tag_names;
 }
 
+void Selector::collect_ancestor_hashes()
+{
+    // Going left from the rightmost compound selector, every one that is reached through descendant and child
+    // combinators alone has to match an ancestor. Sibling combinators could be followed too, but they aren't common
+    // enough to bother.
+    for (ssize_t i = m_complex_selectors.size() - 1; i > 0; --i) {
+        auto relation = m_complex_selectors[i].relation;
+        if (relation != ComplexSelector::Relation::Descendant && relation != ComplexSelector::Relation::ImmediateChild)
+            break;
+        for (auto& simple_selector : m_complex_selectors[i - 1].compound_selector) {
+            switch (simple_selector.type) {
+            case SimpleSelector::Type::Id:
+                m_ancestor_hashes.append(AncestorFilter::hash_for(AncestorFilter::KeyType::Id, simple_selector.value));
+                break;
+            case SimpleSelector::Type::Class:
+                m_ancestor_hashes.append(AncestorFilter::hash_for(AncestorFilter::KeyType::Class, simple_selector.value));
+                break;
+            case SimpleSelector::Type::TagName:
+                m_ancestor_hashes.append(AncestorFilter::hash_for(AncestorFilter::KeyType::TagName, simple_selector.value));
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
+
+void Selector::find_out_what_can_tell_elements_apart()
+{
+    auto has_pseudo_class = [](const ComplexSelector& complex_selector) {
+        for (auto& simple_selector : complex_selector.compound_selector) {
+            if (simple_selector.pseudo_class != SimpleSelector::PseudoClass::None)
+                return true;
+        }
+        return false;
+    };
+    auto is_sibling_relation = [](ComplexSelector::Relation relation) {
+        return relation == ComplexSelector::Relation::AdjacentSibling || relation == ComplexSelector::Relation::GeneralSibling;
+    };
+
+    // Siblings share all of their ancestors, so only the rightmost compound selector and the ones that are reached
+    // from it through sibling combinators can tell them apart.
+    for (ssize_t i = m_complex_selectors.size() - 1; i >= 0; --i) {
+        auto& complex_selector = m_complex_selectors[i];
+        if (has_pseudo_class(complex_selector) || is_sibling_relation(complex_selector.relation)) {
+            m_can_tell_siblings_apart = true;
+            break;
+        }
+        if (complex_selector.relation != ComplexSelector::Relation::None)
+            break;
+    }
+
+    for (auto& complex_selector : m_complex_selectors) {
+        if (has_pseudo_class(complex_selector) || is_sibling_relation(complex_selector.relation)) {
+            m_can_tell_cousins_apart = true;
+            break;
+        }
+    }
+}
+
 }
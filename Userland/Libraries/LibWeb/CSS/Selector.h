@@ -81,8 +81,24 @@ public:
 
     u32 specificity() const;
 
+    // Hashes of the IDs, classes and tag names that some ancestor of a matching element is sure to have, in the form
+    // that an AncestorFilter uses.
+    const Vector<u32>& ancestor_hashes() const { return m_ancestor_hashes; }
+
+    // Whether the selector could match one but not the other of two elements with the same tag name and attributes,
+    // if they are siblings, or if their parents are siblings with the same tag name and attributes. That's what
+    // pseudo-classes and sibling combinators can do.
+    bool can_tell_siblings_apart() const { return m_can_tell_siblings_apart; }
+    bool can_tell_cousins_apart() const { return m_can_tell_cousins_apart; }
+
 private:
+    void collect_ancestor_hashes();
+    void find_out_what_can_tell_elements_apart();
+
     Vector<ComplexSelector> m_complex_selectors;
+    Vector<u32> m_ancestor_hashes;
+    bool m_can_tell_siblings_apart { false };
+    bool m_can_tell_cousins_apart { false };
 };
 
 }
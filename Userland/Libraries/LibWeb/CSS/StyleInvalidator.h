@@ -13,13 +13,20 @@
 
 namespace Web::CSS {
 
+// Finds out which elements match different rules after a change to the attributes of an element, and marks them as
+// needing a style update. Selectors can only look at an element from its descendants, and from its following siblings
+// and their descendants, so those are the elements it looks at.
 class StyleInvalidator {
 public:
-    explicit StyleInvalidator(DOM::Document&);
+    explicit StyleInvalidator(DOM::Element&);
     ~StyleInvalidator();
 
 private:
+    template<typename Callback>
+    void for_each_affected_element(Callback);
+
     DOM::Document& m_document;
+    DOM::Element& m_element;
     HashMap<DOM::Element*, Vector<MatchingRule>> m_elements_and_matching_rules_before;
 };
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/FlatMap.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtr.h>
 #include <LibGfx/Font.h>
@@ -72,7 +73,7 @@ public:
     Optional<int> z_index() const;
 
 private:
-    HashMap<unsigned, NonnullRefPtr<StyleValue>> m_property_values;
+    FlatMap<unsigned, NonnullRefPtr<StyleValue>> m_property_values;
     Optional<CSS::Overflow> overflow(CSS::PropertyID) const;
 
     void load_font() const;
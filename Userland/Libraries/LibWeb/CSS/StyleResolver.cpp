@@ -14,6 +14,7 @@
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
 #include <LibWeb/Dump.h>
+#include <LibWeb/HTML/AttributeNames.h>
 #include <ctype.h>
 #include <stdio.h>
 
@@ -61,9 +62,22 @@ void StyleResolver::for_each_stylesheet(Callback callback) const
     }
 }
 
-Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+void StyleResolver::invalidate_rule_cache()
 {
-    Vector<MatchingRule> matching_rules;
+    m_rule_cache = nullptr;
+    m_style_sharing_candidates.clear();
+}
+
+void StyleResolver::ensure_rule_cache() const
+{
+    if (!m_rule_cache || m_rule_cache->built_in_quirks_mode != document().in_quirks_mode())
+        build_rule_cache();
+}
+
+void StyleResolver::build_rule_cache() const
+{
+    m_rule_cache = make<RuleCache>();
+    m_rule_cache->built_in_quirks_mode = document().in_quirks_mode();
 
     size_t style_sheet_index = 0;
     for_each_stylesheet([&](auto& sheet) {
@@ -73,18 +87,104 @@ Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& e
         static_cast<const CSSStyleSheet&>(sheet).for_each_effective_style_rule([&](auto& rule) {
             size_t selector_index = 0;
             for (auto& selector : rule.selectors()) {
-                if (SelectorEngine::matches(selector, element)) {
-                    matching_rules.append({ rule, style_sheet_index, rule_index, selector_index });
-                    break;
-                }
+                MatchingRule matching_rule { rule, style_sheet_index, rule_index, selector_index };
                 ++selector_index;
+
+                const Selector::SimpleSelector* id_selector = nullptr;
+                const Selector::SimpleSelector* class_selector = nullptr;
+                const Selector::SimpleSelector* tag_name_selector = nullptr;
+                if (!selector.complex_selectors().is_empty()) {
+                    for (auto& simple_selector : selector.complex_selectors().last().compound_selector) {
+                        if (simple_selector.type == Selector::SimpleSelector::Type::Id && !id_selector)
+                            id_selector = &simple_selector;
+                        else if (simple_selector.type == Selector::SimpleSelector::Type::Class && !class_selector)
+                            class_selector = &simple_selector;
+                        else if (simple_selector.type == Selector::SimpleSelector::Type::TagName && !tag_name_selector)
+                            tag_name_selector = &simple_selector;
+                    }
+                }
+
+                auto style_sharing = StyleSharing::WithSiblingsAndCousins;
+                if (selector.can_tell_siblings_apart())
+                    style_sharing = StyleSharing::None;
+                else if (selector.can_tell_cousins_apart())
+                    style_sharing = StyleSharing::WithSiblings;
+                auto restrict_style_sharing = [&](HashMap<FlyString, StyleSharing>& style_sharing_by_key, const FlyString& key) {
+                    if (style_sharing == StyleSharing::WithSiblingsAndCousins)
+                        return;
+                    auto it = style_sharing_by_key.find(key);
+                    if (it == style_sharing_by_key.end())
+                        style_sharing_by_key.set(key, style_sharing);
+                    else
+                        it->value = min(it->value, style_sharing);
+                };
+
+                // Elements with an ID don't share their style, so those rules don't restrict sharing.
+                if (id_selector) {
+                    m_rule_cache->rules_by_id.ensure(id_selector->value).append(move(matching_rule));
+                } else if (class_selector) {
+                    restrict_style_sharing(m_rule_cache->style_sharing_by_class, class_selector->value);
+                    m_rule_cache->rules_by_class.ensure(class_selector->value).append(move(matching_rule));
+                } else if (tag_name_selector) {
+                    restrict_style_sharing(m_rule_cache->style_sharing_by_tag_name, tag_name_selector->value);
+                    m_rule_cache->rules_by_tag_name.ensure(tag_name_selector->value).append(move(matching_rule));
+                } else {
+                    m_rule_cache->style_sharing_of_other_rules = min(m_rule_cache->style_sharing_of_other_rules, style_sharing);
+                    m_rule_cache->other_rules.append(move(matching_rule));
+                }
             }
             ++rule_index;
         });
         ++style_sheet_index;
     });
+}
+
+Vector<MatchingRule> StyleResolver::collect_matching_rules(const DOM::Element& element) const
+{
+    ensure_rule_cache();
+
+    // Resolving the style of an element can also happen outside of the tree walk, e.g. when a new layout tree gets built.
+    bool can_use_ancestor_filter = m_ancestor_filter.is_for_parent_of(element);
 
-    return matching_rules;
+    Vector<MatchingRule> matching_rules;
+    auto add_matching_rules = [&](const Vector<MatchingRule>& rules) {
+        for (auto& rule : rules) {
+            auto& selector = rule.rule->selectors()[rule.selector_index];
+            if (can_use_ancestor_filter && m_ancestor_filter.rejects(selector))
+                continue;
+            if (SelectorEngine::matches(selector, element))
+                matching_rules.append(rule);
+        }
+    };
+    auto add_matching_rules_from_bucket = [&](const HashMap<FlyString, Vector<MatchingRule>>& buckets, const FlyString& key) {
+        if (auto it = buckets.find(key); it != buckets.end())
+            add_matching_rules(it->value);
+    };
+
+    if (auto id = element.attribute(HTML::AttributeNames::id); !id.is_null())
+        add_matching_rules_from_bucket(m_rule_cache->rules_by_id, id);
+    for (auto& class_name : element.class_names())
+        add_matching_rules_from_bucket(m_rule_cache->rules_by_class, class_name);
+    add_matching_rules_from_bucket(m_rule_cache->rules_by_tag_name, element.local_name());
+    add_matching_rules(m_rule_cache->other_rules);
+
+    // The selectors of a rule can end up in different buckets (and an element can have the same class more than once),
+    // but a rule only matches once, with the first of its selectors that does.
+    quick_sort(matching_rules, [](auto& a, auto& b) {
+        if (a.style_sheet_index != b.style_sheet_index)
+            return a.style_sheet_index < b.style_sheet_index;
+        if (a.rule_index != b.rule_index)
+            return a.rule_index < b.rule_index;
+        return a.selector_index < b.selector_index;
+    });
+    Vector<MatchingRule> unique_matching_rules;
+    unique_matching_rules.ensure_capacity(matching_rules.size());
+    for (auto& rule : matching_rules) {
+        if (!unique_matching_rules.is_empty() && unique_matching_rules.last().style_sheet_index == rule.style_sheet_index && unique_matching_rules.last().rule_index == rule.rule_index)
+            continue;
+        unique_matching_rules.unchecked_append(move(rule));
+    }
+    return unique_matching_rules;
 }
 
 void StyleResolver::sort_matching_rules(Vector<MatchingRule>& matching_rules) const
@@ -671,8 +771,87 @@ static void set_property_expanding_shorthands(StyleProperties& style, CSS::Prope
     style.set_property(property_id, value);
 }
 
+StyleResolver::StyleSharingScope::StyleSharingScope(StyleResolver& style_resolver)
+    : m_style_resolver(style_resolver)
+{
+    ++m_style_resolver.m_style_sharing_scope_depth;
+}
+
+StyleResolver::StyleSharingScope::~StyleSharingScope()
+{
+    if (--m_style_resolver.m_style_sharing_scope_depth == 0)
+        m_style_resolver.m_style_sharing_candidates.clear();
+}
+
+// This many of the most recently resolved elements are kept around. That's plenty for runs of siblings, and for the
+// cells of a table row to find the ones in the same column of the row before.
+static constexpr size_t max_style_sharing_candidates = 16;
+
+static bool have_same_tag_name_and_attributes(const DOM::Element& a, const DOM::Element& b)
+{
+    return a.local_name() == b.local_name() && a.namespace_() == b.namespace_() && a.has_same_attributes_as(b);
+}
+
+StyleResolver::StyleSharing StyleResolver::style_sharing_for(const DOM::Element& element) const
+{
+    if (!m_style_sharing_scope_depth)
+        return StyleSharing::None;
+    // Only the parent is compared with that of the other element, so the document element would have to be alike.
+    auto* parent = element.parent_element();
+    if (!parent || !parent->specified_css_values())
+        return StyleSharing::None;
+    if (element.inline_style() || element.has_attribute(HTML::AttributeNames::id))
+        return StyleSharing::None;
+
+    ensure_rule_cache();
+    auto style_sharing = m_rule_cache->style_sharing_of_other_rules;
+    for (auto& class_name : element.class_names()) {
+        if (auto it = m_rule_cache->style_sharing_by_class.find(class_name); it != m_rule_cache->style_sharing_by_class.end())
+            style_sharing = min(style_sharing, it->value);
+    }
+    if (auto it = m_rule_cache->style_sharing_by_tag_name.find(element.local_name()); it != m_rule_cache->style_sharing_by_tag_name.end())
+        style_sharing = min(style_sharing, it->value);
+    return style_sharing;
+}
+
+RefPtr<StyleProperties> StyleResolver::find_shared_style(const DOM::Element& element, StyleSharing style_sharing) const
+{
+    auto& parent = *element.parent_element();
+    for (ssize_t i = m_style_sharing_candidates.size() - 1; i >= 0; --i) {
+        auto& candidate = m_style_sharing_candidates[i];
+        // This also makes sure that both inherit the same values, even if the parent was resolved since.
+        if (candidate.parent_style.ptr() != parent.specified_css_values())
+            continue;
+        if (!have_same_tag_name_and_attributes(*candidate.element, element))
+            continue;
+        auto& candidate_parent = *candidate.element->parent_element();
+        if (&candidate_parent != &parent) {
+            if (style_sharing != StyleSharing::WithSiblingsAndCousins)
+                continue;
+            if (candidate_parent.parent_element() != parent.parent_element() || !have_same_tag_name_and_attributes(candidate_parent, parent))
+                continue;
+        }
+        return candidate.style;
+    }
+    return nullptr;
+}
+
+void StyleResolver::add_style_sharing_candidate(const DOM::Element& element, NonnullRefPtr<StyleProperties> style) const
+{
+    if (m_style_sharing_candidates.size() == max_style_sharing_candidates)
+        m_style_sharing_candidates.take_first();
+    auto& parent_style = const_cast<StyleProperties&>(*element.parent_element()->specified_css_values());
+    m_style_sharing_candidates.append({ const_cast<DOM::Element&>(element), parent_style, move(style) });
+}
+
 NonnullRefPtr<StyleProperties> StyleResolver::resolve_style(const DOM::Element& element) const
 {
+    auto style_sharing = style_sharing_for(element);
+    if (style_sharing != StyleSharing::None) {
+        if (auto shared_style = find_shared_style(element, style_sharing))
+            return shared_style.release_nonnull();
+    }
+
     auto style = StyleProperties::create();
 
     if (auto* parent_style = element.parent_element() ? element.parent_element()->specified_css_values() : nullptr) {
@@ -699,6 +878,8 @@ NonnullRefPtr<StyleProperties> StyleResolver::resolve_style(const DOM::Element&
         }
     }
 
+    if (style_sharing != StyleSharing::None)
+        add_style_sharing_candidate(element, style);
     return style;
 }
 
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
 #include <AK/OwnPtr.h>
+#include <LibWeb/CSS/AncestorFilter.h>
 #include <LibWeb/CSS/StyleProperties.h>
 #include <LibWeb/Forward.h>
 
@@ -35,11 +38,72 @@ public:
 
     static bool is_inherited_property(CSS::PropertyID);
 
+    // Has to be called whenever the rules in any of the style sheets of the document may have changed.
+    void invalidate_rule_cache();
+
+    // Holds the ancestors of the element whose style is resolved next, while Document::update_style() walks the tree.
+    AncestorFilter& ancestor_filter() { return m_ancestor_filter; }
+
+    // While one of these exists, elements can get the very same style as an element resolved before them that has the
+    // same tag name and attributes, and the same parent (or parents that are alike in the same way). Nothing that could
+    // change the style of an element may happen in the meantime, e.g. running scripts or loading style sheets.
+    class StyleSharingScope {
+    public:
+        explicit StyleSharingScope(StyleResolver&);
+        ~StyleSharingScope();
+
+    private:
+        StyleResolver& m_style_resolver;
+    };
+
 private:
     template<typename Callback>
     void for_each_stylesheet(Callback) const;
 
+    // Ordered from the most restrictive to the least.
+    enum class StyleSharing {
+        None,
+        WithSiblings,
+        WithSiblingsAndCousins,
+    };
+
+    // Every selector of every rule, sorted by what the rightmost part of the selector requires of an element: its ID if
+    // there is one, or else one of its classes, or else its tag name. Elements only need to be matched against the
+    // selectors in the buckets they could possibly be in, and against the ones that require none of these.
+    struct RuleCache {
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_id;
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_class;
+        HashMap<FlyString, Vector<MatchingRule>> rules_by_tag_name;
+        Vector<MatchingRule> other_rules;
+        bool built_in_quirks_mode { false };
+
+        // Which elements an element can share its style with, as far as the selectors in each bucket are concerned.
+        // Elements with an ID never share theirs, so that bucket needs none of this.
+        HashMap<FlyString, StyleSharing> style_sharing_by_class;
+        HashMap<FlyString, StyleSharing> style_sharing_by_tag_name;
+        StyleSharing style_sharing_of_other_rules { StyleSharing::WithSiblingsAndCousins };
+    };
+
+    void build_rule_cache() const;
+    void ensure_rule_cache() const;
+
+    struct StyleSharingCandidate {
+        NonnullRefPtr<DOM::Element> element;
+        NonnullRefPtr<StyleProperties> parent_style;
+        NonnullRefPtr<StyleProperties> style;
+    };
+
+    StyleSharing style_sharing_for(const DOM::Element&) const;
+    RefPtr<StyleProperties> find_shared_style(const DOM::Element&, StyleSharing) const;
+    void add_style_sharing_candidate(const DOM::Element&, NonnullRefPtr<StyleProperties>) const;
+
     DOM::Document& m_document;
+    mutable OwnPtr<RuleCache> m_rule_cache;
+    AncestorFilter m_ancestor_filter;
+
+    size_t m_style_sharing_scope_depth { 0 };
+    // The elements resolved most recently in the current StyleSharingScope, oldest first.
+    mutable Vector<StyleSharingCandidate> m_style_sharing_candidates;
 };
 
 }
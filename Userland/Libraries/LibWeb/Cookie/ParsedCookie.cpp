@@ -23,7 +23,6 @@ static void on_domain_attribute(ParsedCookie& parsed_cookie, StringView attribut
 static void on_path_attribute(ParsedCookie& parsed_cookie, StringView attribute_value);
 static void on_secure_attribute(ParsedCookie& parsed_cookie);
 static void on_http_only_attribute(ParsedCookie& parsed_cookie);
-static Optional<Core::DateTime> parse_date_time(StringView date_string);
 
 Optional<ParsedCookie> parse_cookie(const String& cookie_string)
 {
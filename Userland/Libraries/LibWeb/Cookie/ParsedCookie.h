@@ -26,6 +26,9 @@ struct ParsedCookie {
 
 Optional<ParsedCookie> parse_cookie(const String& cookie_string);
 
+// This is the date format of cookies, which also takes the dates that HTTP headers (like Expires) have.
+Optional<Core::DateTime> parse_date_time(StringView date_string);
+
 }
 
 namespace IPC {
@@ -6,6 +6,8 @@
 
 #include <LibWeb/DOM/CharacterData.h>
 #include <LibWeb/DOM/Document.h>
+#include <LibWeb/DOM/Text.h>
+#include <LibWeb/Layout/Node.h>
 
 namespace Web::DOM {
 
@@ -24,6 +26,14 @@ void CharacterData::set_data(String data)
     if (m_data == data)
         return;
     m_data = move(data);
+    if (!is<Text>(*this))
+        return;
+    // Text nodes that are laid out already read their data again in the next layout.
+    if (auto* layout_node = this->layout_node()) {
+        layout_node->set_needs_layout();
+        document().schedule_layout_update();
+        return;
+    }
     // FIXME: This is definitely too aggressive.
     document().schedule_forced_layout();
 }
@@ -67,6 +67,10 @@ Document::Document(const URL& url)
     m_forced_layout_timer = Core::Timer::create_single_shot(0, [this] {
         force_layout();
     });
+
+    m_layout_update_timer = Core::Timer::create_single_shot(0, [this] {
+        update_layout();
+    });
 }
 
 Document::~Document()
@@ -152,6 +156,13 @@ void Document::schedule_forced_layout()
     m_forced_layout_timer->start();
 }
 
+void Document::schedule_layout_update()
+{
+    if (m_layout_update_timer->is_active())
+        return;
+    m_layout_update_timer->start();
+}
+
 bool Document::is_child_allowed(const Node& node) const
 {
     switch (node.type()) {
@@ -394,12 +405,18 @@ void Document::update_layout()
         return;
 
     if (!m_layout_root) {
+        CSS::StyleResolver::StyleSharingScope style_sharing_scope(style_resolver());
         Layout::TreeBuilder tree_builder;
         m_layout_root = static_ptr_cast<Layout::InitialContainingBlockBox>(tree_builder.build(*this));
     }
 
+    m_layout_update_timer->stop();
+    if (!m_layout_root->needs_layout() && !m_layout_root->child_needs_layout())
+        return;
+
     Layout::BlockFormattingContext root_formatting_context(*m_layout_root, nullptr);
     root_formatting_context.run(*m_layout_root, Layout::LayoutMode::Default);
+    m_layout_root->clear_needs_layout();
 
     m_layout_root->set_needs_display();
 
@@ -409,7 +426,7 @@ void Document::update_layout()
     }
 }
 
-static void update_style_recursively(DOM::Node& node)
+static void update_style_recursively(DOM::Node& node, CSS::AncestorFilter& ancestor_filter)
 {
     node.for_each_child([&](auto& child) {
         if (child.needs_style_update()) {
@@ -418,7 +435,12 @@ static void update_style_recursively(DOM::Node& node)
             child.set_needs_style_update(false);
         }
         if (child.child_needs_style_update()) {
-            update_style_recursively(child);
+            bool is_element = is<Element>(child);
+            if (is_element)
+                ancestor_filter.push_element(downcast<Element>(child));
+            update_style_recursively(child, ancestor_filter);
+            if (is_element)
+                ancestor_filter.pop_element();
             child.set_child_needs_style_update(false);
         }
         return IterationDecision::Continue;
@@ -427,7 +449,12 @@ static void update_style_recursively(DOM::Node& node)
 
 void Document::update_style()
 {
-    update_style_recursively(*this);
+    auto& ancestor_filter = style_resolver().ancestor_filter();
+    VERIFY(ancestor_filter.is_empty());
+    CSS::StyleResolver::StyleSharingScope style_sharing_scope(style_resolver());
+    update_style_recursively(*this, ancestor_filter);
+    // Restyling an element can make its children need it too, but they have been taken care of by now.
+    m_style_update_timer->stop();
     update_layout();
 }
 
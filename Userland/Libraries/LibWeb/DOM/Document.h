@@ -135,6 +135,8 @@ public:
 
     void schedule_style_update();
     void schedule_forced_layout();
+    // Unlike a forced layout, this keeps the layout tree, and only lays out the parts of it that need it.
+    void schedule_layout_update();
 
     NonnullRefPtr<HTMLCollection> get_elements_by_name(String const&);
     NonnullRefPtr<HTMLCollection> get_elements_by_tag_name(FlyString const&);
@@ -286,6 +288,7 @@ private:
 
     RefPtr<Core::Timer> m_style_update_timer;
     RefPtr<Core::Timer> m_forced_layout_timer;
+    RefPtr<Core::Timer> m_layout_update_timer;
 
     String m_source;
 
@@ -71,7 +71,7 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
     if (name.is_empty())
         return InvalidCharacterError::create("Attribute name must not be empty");
 
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this);
 
     if (auto* attribute = find_attribute(name))
         attribute->set_value(value);
@@ -84,11 +84,22 @@ ExceptionOr<void> Element::set_attribute(const FlyString& name, const String& va
 
 void Element::remove_attribute(const FlyString& name)
 {
-    CSS::StyleInvalidator style_invalidator(document());
+    CSS::StyleInvalidator style_invalidator(*this);
 
     m_attributes.remove_first_matching([&](auto& attribute) { return attribute.name() == name; });
 }
 
+bool Element::has_same_attributes_as(const Element& other) const
+{
+    if (m_attributes.size() != other.m_attributes.size())
+        return false;
+    for (size_t i = 0; i < m_attributes.size(); ++i) {
+        if (m_attributes[i].name() != other.m_attributes[i].name() || m_attributes[i].value() != other.m_attributes[i].value())
+            return false;
+    }
+    return true;
+}
+
 bool Element::has_class(const FlyString& class_name, CaseSensitivity case_sensitivity) const
 {
     return any_of(m_classes.begin(), m_classes.end(), [&](auto& it) {
@@ -163,33 +174,47 @@ void Element::parse_attribute(const FlyString& name, const String& value)
     }
 }
 
-enum class StyleDifference {
-    None,
-    NeedsRepaint,
-    NeedsRelayout,
+struct StyleDifference {
+    bool needs_repaint { false };
+    bool needs_relayout { false };
+    // The kind of layout node that an element gets, and where it goes in the layout tree, depend on these.
+    bool needs_new_layout_tree { false };
+    bool affects_children { false };
 };
 
-static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style, const Document& document)
+static StyleDifference compute_style_difference(const CSS::StyleProperties& old_style, const CSS::StyleProperties& new_style)
 {
-    if (old_style == new_style)
-        return StyleDifference::None;
-
-    bool needs_repaint = false;
-    bool needs_relayout = false;
-
-    if (new_style.display() != old_style.display())
-        needs_relayout = true;
-
-    if (new_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::Color, document, Color::Black))
-        needs_repaint = true;
-    else if (new_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black) != old_style.color_or_fallback(CSS::PropertyID::BackgroundColor, document, Color::Black))
-        needs_repaint = true;
+    StyleDifference difference;
+    auto compare = [&](CSS::PropertyID property_id, const CSS::StyleValue* old_value, const CSS::StyleValue* new_value) {
+        if (old_value && new_value && old_value->type() == new_value->type() && *old_value == *new_value)
+            return;
+        if (CSS::StyleResolver::is_inherited_property(property_id))
+            difference.affects_children = true;
+        switch (property_id) {
+        case CSS::PropertyID::Display:
+        case CSS::PropertyID::Float:
+        case CSS::PropertyID::Position:
+            difference.needs_new_layout_tree = true;
+            break;
+        case CSS::PropertyID::Color:
+        case CSS::PropertyID::BackgroundColor:
+            difference.needs_repaint = true;
+            break;
+        default:
+            difference.needs_relayout = true;
+            break;
+        }
+    };
 
-    if (needs_relayout)
-        return StyleDifference::NeedsRelayout;
-    if (needs_repaint)
-        return StyleDifference::NeedsRepaint;
-    return StyleDifference::None;
+    old_style.for_each_property([&](auto property_id, auto& old_value) {
+        auto new_value = new_style.property(property_id);
+        compare(property_id, &old_value, new_value.has_value() ? new_value.value().ptr() : nullptr);
+    });
+    new_style.for_each_property([&](auto property_id, auto& new_value) {
+        if (!old_style.property(property_id).has_value())
+            compare(property_id, nullptr, &new_value);
+    });
+    return difference;
 }
 
 void Element::recompute_style()
@@ -199,6 +224,21 @@ void Element::recompute_style()
     auto old_specified_css_values = m_specified_css_values;
     auto new_specified_css_values = document().style_resolver().resolve_style(*this);
     m_specified_css_values = new_specified_css_values;
+    if (old_specified_css_values == new_specified_css_values)
+        return;
+
+    // Nothing else restyles the children, and they could inherit what changed.
+    StyleDifference difference;
+    if (old_specified_css_values)
+        difference = compute_style_difference(*old_specified_css_values, *new_specified_css_values);
+    else
+        difference.needs_new_layout_tree = difference.affects_children = true;
+    if (difference.affects_children) {
+        for_each_child_of_type<Element>([](auto& child) {
+            child.set_needs_style_update(true);
+        });
+    }
+
     if (!layout_node()) {
         if (new_specified_css_values->display() == CSS::Display::None)
             return;
@@ -208,19 +248,19 @@ void Element::recompute_style()
         return;
     }
 
-    auto diff = StyleDifference::NeedsRelayout;
-    if (old_specified_css_values)
-        diff = compute_style_difference(*old_specified_css_values, *new_specified_css_values, document());
-    if (diff == StyleDifference::None)
-        return;
-    layout_node()->apply_style(*new_specified_css_values);
-    if (diff == StyleDifference::NeedsRelayout) {
+    if (difference.needs_new_layout_tree) {
         document().schedule_forced_layout();
         return;
     }
-    if (diff == StyleDifference::NeedsRepaint) {
-        layout_node()->set_needs_display();
+    if (!difference.needs_relayout && !difference.needs_repaint)
+        return;
+    layout_node()->apply_style(*new_specified_css_values);
+    if (difference.needs_relayout) {
+        layout_node()->set_needs_layout();
+        document().schedule_layout_update();
+        return;
     }
+    layout_node()->set_needs_display();
 }
 
 NonnullRefPtr<CSS::StyleProperties> Element::computed_style()
@@ -55,6 +55,9 @@ public:
             callback(attribute.name(), attribute.value());
     }
 
+    // In the same order, too.
+    bool has_same_attributes_as(const Element&) const;
+
     bool has_class(const FlyString&, CaseSensitivity = CaseSensitivity::CaseSensitive) const;
     const Vector<FlyString>& class_names() const { return m_classes; }
 
@@ -40,8 +40,11 @@ Node::Node(Document& document, NodeType type)
 Node::~Node()
 {
     VERIFY(m_deletion_has_begun);
-    if (layout_node() && layout_node()->parent())
-        layout_node()->parent()->remove_child(*layout_node());
+    if (layout_node() && layout_node()->parent()) {
+        auto& layout_parent = *layout_node()->parent();
+        layout_parent.remove_child(*layout_node());
+        layout_parent.set_needs_layout();
+    }
 
     if (!is_document())
         m_document->unref_from_node({});
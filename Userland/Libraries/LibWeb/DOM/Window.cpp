@@ -116,14 +116,12 @@ void Window::clear_interval(i32 timer_id)
 
 i32 Window::request_animation_frame(JS::Function& callback)
 {
-    // FIXME: This is extremely fake!
-    static double fake_timestamp = 0;
-
-    i32 link_id = GUI::DisplayLink::register_callback([handle = make_handle(&callback)](i32 link_id) {
+    // The callback gets the time of the frame on the same timeline as performance.now().
+    i32 link_id = GUI::DisplayLink::register_callback([handle = make_handle(&callback), time_origin = performance().time_origin()](i32 link_id, i64 frame_time_in_microseconds) {
         auto& function = const_cast<JS::Function&>(static_cast<const JS::Function&>(*handle.cell()));
         auto& vm = function.vm();
-        fake_timestamp += 10;
-        [[maybe_unused]] auto rc = vm.call(function, JS::js_undefined(), JS::Value(fake_timestamp));
+        double timestamp = frame_time_in_microseconds / 1000.0 - time_origin;
+        [[maybe_unused]] auto rc = vm.call(function, JS::js_undefined(), JS::Value(timestamp));
         if (vm.exception())
             vm.clear_exception();
         vm.run_queued_promise_jobs();
@@ -14,6 +14,7 @@ enum class Source;
 }
 
 namespace Web::CSS {
+class AncestorFilter;
 class CSSRule;
 class CSSImportRule;
 class CSSStyleDeclaration;
@@ -110,6 +111,7 @@ class HTMLParagraphElement;
 class HTMLParamElement;
 class HTMLPictureElement;
 class HTMLPreElement;
+class HTMLPreloadScanner;
 class HTMLProgressElement;
 class HTMLQuoteElement;
 class HTMLScriptElement;
@@ -6,6 +6,8 @@
 
 #include <AK/Debug.h>
 #include <AK/Utf32View.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/Timer.h>
 #include <LibTextCodec/Decoder.h>
 #include <LibWeb/DOM/Comment.h>
 #include <LibWeb/DOM/Document.h>
@@ -21,6 +23,7 @@
 #include <LibWeb/HTML/HTMLTableElement.h>
 #include <LibWeb/HTML/HTMLTemplateElement.h>
 #include <LibWeb/HTML/Parser/HTMLDocumentParser.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
 #include <LibWeb/HTML/Parser/HTMLToken.h>
 #include <LibWeb/Namespace.h>
 #include <LibWeb/SVG/TagNames.h>
@@ -93,8 +96,8 @@ static Vector<FlyString> s_quirks_public_ids = {
 RefPtr<DOM::Document> parse_html_document(const StringView& data, const URL& url, const String& encoding)
 {
     auto document = DOM::Document::create(url);
-    HTMLDocumentParser parser(document, data, encoding);
-    parser.run(url);
+    auto parser = HTMLDocumentParser::create(document, data, encoding);
+    parser->run(url);
     return document;
 }
 
@@ -111,12 +114,57 @@ HTMLDocumentParser::~HTMLDocumentParser()
     m_document->set_should_invalidate_styles_on_attribute_changes(true);
 }
 
-void HTMLDocumentParser::run(const URL& url)
+// About one frame's worth, so that the page stays responsive while it's being parsed.
+static constexpr int parsing_slice_duration_ms = 16;
+
+void HTMLDocumentParser::start(const URL& url)
 {
     m_document->set_url(url);
     m_document->set_source(m_tokenizer.source());
+}
+
+void HTMLDocumentParser::run(const URL& url)
+{
+    start(url);
+    process_tokens();
+    flush_character_insertions();
+    the_end();
+}
 
-    for (;;) {
+void HTMLDocumentParser::run_incrementally(const URL& url, Function<void()> on_finish)
+{
+    start(url);
+    m_on_finish = move(on_finish);
+    m_next_slice_timer = Core::Timer::create_single_shot(0, [this] {
+        parse_next_slice();
+    });
+    parse_next_slice();
+}
+
+void HTMLDocumentParser::parse_next_slice()
+{
+    // The scripts that run while parsing may navigate away from the document, which lets go of the parser.
+    NonnullRefPtr protect = *this;
+
+    bool is_done = process_tokens(parsing_slice_duration_ms);
+    flush_character_insertions();
+    if (!is_done) {
+        m_next_slice_timer->start();
+        return;
+    }
+
+    the_end();
+    if (auto on_finish = move(m_on_finish))
+        on_finish();
+}
+
+bool HTMLDocumentParser::process_tokens(Optional<int> time_budget_ms)
+{
+    Core::ElapsedTimer elapsed_timer;
+    if (time_budget_ms.has_value())
+        elapsed_timer.start();
+
+    for (size_t token_count = 1;; ++token_count) {
         auto optional_token = m_tokenizer.next_token();
         if (!optional_token.has_value())
             break;
@@ -141,11 +189,17 @@ void HTMLDocumentParser::run(const URL& url)
             dbgln_if(PARSER_DEBUG, "Stop parsing{}! :^)", m_parsing_fragment ? " fragment" : "");
             break;
         }
-    }
 
-    flush_character_insertions();
+        // Looking at the clock for every token would cost too much, so it only gets checked every so often.
+        if (time_budget_ms.has_value() && token_count % 256 == 0 && elapsed_timer.elapsed() >= time_budget_ms.value())
+            return false;
+    }
+    return true;
+}
 
-    // "The end"
+void HTMLDocumentParser::the_end()
+{
+    m_document->set_should_invalidate_styles_on_attribute_changes(true);
 
     m_document->set_ready_state("interactive");
 
@@ -1887,6 +1941,12 @@ void HTMLDocumentParser::handle_text(HTMLToken& token)
         m_stack_of_open_elements.pop();
         m_insertion_mode = m_original_insertion_mode;
         // FIXME: Handle tokenizer insertion point stuff here.
+        // The parser is about to wait for the script to load, so it's time to start loading what comes after it too.
+        if (!m_has_scanned_for_preloads && !m_parsing_fragment && script->has_attribute(HTML::AttributeNames::src)) {
+            m_has_scanned_for_preloads = true;
+            HTMLPreloadScanner(document(), m_tokenizer.source()).scan();
+        }
+
         increment_script_nesting_level();
         script->prepare_script({});
         decrement_script_nesting_level();
@@ -2989,44 +3049,44 @@ DOM::Document& HTMLDocumentParser::document()
 NonnullRefPtrVector<DOM::Node> HTMLDocumentParser::parse_html_fragment(DOM::Element& context_element, const StringView& markup)
 {
     auto temp_document = DOM::Document::create();
-    HTMLDocumentParser parser(*temp_document, markup, "utf-8");
-    parser.m_context_element = context_element;
-    parser.m_parsing_fragment = true;
-    parser.document().set_quirks_mode(context_element.document().mode());
+    auto parser = HTMLDocumentParser::create(*temp_document, markup, "utf-8");
+    parser->m_context_element = context_element;
+    parser->m_parsing_fragment = true;
+    parser->document().set_quirks_mode(context_element.document().mode());
 
     if (context_element.local_name().is_one_of(HTML::TagNames::title, HTML::TagNames::textarea)) {
-        parser.m_tokenizer.switch_to({}, HTMLTokenizer::State::RCDATA);
+        parser->m_tokenizer.switch_to({}, HTMLTokenizer::State::RCDATA);
     } else if (context_element.local_name().is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes)) {
-        parser.m_tokenizer.switch_to({}, HTMLTokenizer::State::RAWTEXT);
+        parser->m_tokenizer.switch_to({}, HTMLTokenizer::State::RAWTEXT);
     } else if (context_element.local_name().is_one_of(HTML::TagNames::script)) {
-        parser.m_tokenizer.switch_to({}, HTMLTokenizer::State::ScriptData);
+        parser->m_tokenizer.switch_to({}, HTMLTokenizer::State::ScriptData);
     } else if (context_element.local_name().is_one_of(HTML::TagNames::noscript)) {
         if (context_element.document().is_scripting_enabled())
-            parser.m_tokenizer.switch_to({}, HTMLTokenizer::State::RAWTEXT);
+            parser->m_tokenizer.switch_to({}, HTMLTokenizer::State::RAWTEXT);
     } else if (context_element.local_name().is_one_of(HTML::TagNames::plaintext)) {
-        parser.m_tokenizer.switch_to({}, HTMLTokenizer::State::PLAINTEXT);
+        parser->m_tokenizer.switch_to({}, HTMLTokenizer::State::PLAINTEXT);
     }
 
     auto root = create_element(context_element.document(), HTML::TagNames::html, Namespace::HTML);
-    parser.document().append_child(root);
-    parser.m_stack_of_open_elements.push(root);
+    parser->document().append_child(root);
+    parser->m_stack_of_open_elements.push(root);
 
     if (context_element.local_name() == HTML::TagNames::template_) {
-        parser.m_stack_of_template_insertion_modes.append(InsertionMode::InTemplate);
+        parser->m_stack_of_template_insertion_modes.append(InsertionMode::InTemplate);
     }
 
     // FIXME: Create a start tag token whose name is the local name of context and whose attributes are the attributes of context.
 
-    parser.reset_the_insertion_mode_appropriately();
+    parser->reset_the_insertion_mode_appropriately();
 
     for (auto* form_candidate = &context_element; form_candidate; form_candidate = form_candidate->parent_element()) {
         if (is<HTMLFormElement>(*form_candidate)) {
-            parser.m_form_element = downcast<HTMLFormElement>(*form_candidate);
+            parser->m_form_element = downcast<HTMLFormElement>(*form_candidate);
             break;
         }
     }
 
-    parser.run(context_element.document().url());
+    parser->run(context_element.document().url());
 
     NonnullRefPtrVector<DOM::Node> children;
     while (RefPtr<DOM::Node> child = root->first_child()) {
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <AK/Function.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/RefCounted.h>
+#include <LibCore/Forward.h>
 #include <LibWeb/DOM/Node.h>
 #include <LibWeb/HTML/Parser/HTMLTokenizer.h>
 #include <LibWeb/HTML/Parser/ListOfActiveFormattingElements.h>
@@ -41,13 +44,21 @@ namespace Web::HTML {
 
 RefPtr<DOM::Document> parse_html_document(const StringView&, const URL&, const String& encoding);
 
-class HTMLDocumentParser {
+class HTMLDocumentParser : public RefCounted<HTMLDocumentParser> {
 public:
-    HTMLDocumentParser(DOM::Document&, const StringView& input, const String& encoding);
+    static NonnullRefPtr<HTMLDocumentParser> create(DOM::Document& document, const StringView& input, const String& encoding)
+    {
+        return adopt_ref(*new HTMLDocumentParser(document, input, encoding));
+    }
+
     ~HTMLDocumentParser();
 
     void run(const URL&);
 
+    // Parses a slice of the input at a time, and goes back to the event loop in between, so that the document can be
+    // laid out and painted while it's still being parsed. This calls on_finish once the parsing is done.
+    void run_incrementally(const URL&, Function<void()> on_finish);
+
     DOM::Document& document();
 
     static NonnullRefPtrVector<DOM::Node> parse_html_fragment(DOM::Element& context_element, const StringView&);
@@ -63,6 +74,14 @@ public:
     static bool is_special_tag(const FlyString& tag_name, const FlyString& namespace_);
 
 private:
+    HTMLDocumentParser(DOM::Document&, const StringView& input, const String& encoding);
+
+    void start(const URL&);
+    // Returns false if the time ran out before all of the tokens were processed.
+    bool process_tokens(Optional<int> time_budget_ms = {});
+    void parse_next_slice();
+    void the_end();
+
     const char* insertion_mode_name() const;
 
     DOM::QuirksMode which_quirks_mode(const HTMLToken&) const;
@@ -157,6 +176,10 @@ private:
     bool m_aborted { false };
     bool m_parser_pause_flag { false };
     bool m_stop_parsing { false };
+    bool m_has_scanned_for_preloads { false };
+
+    RefPtr<Core::Timer> m_next_slice_timer;
+    Function<void()> m_on_finish;
     size_t m_script_nesting_level { 0 };
 
     NonnullRefPtr<DOM::Document> m_document;
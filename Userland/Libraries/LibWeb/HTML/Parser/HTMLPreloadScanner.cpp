@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibWeb/DOM/Document.h>
+#include <LibWeb/HTML/AttributeNames.h>
+#include <LibWeb/HTML/Parser/HTMLPreloadScanner.h>
+#include <LibWeb/HTML/TagNames.h>
+#include <LibWeb/Loader/ResourceLoader.h>
+
+namespace Web::HTML {
+
+HTMLPreloadScanner::HTMLPreloadScanner(DOM::Document& document, const StringView& input)
+    : m_document(document)
+    , m_tokenizer(input, "utf-8")
+{
+}
+
+void HTMLPreloadScanner::scan()
+{
+    for (;;) {
+        auto optional_token = m_tokenizer.next_token();
+        if (!optional_token.has_value())
+            return;
+        auto& token = optional_token.value();
+        if (!token.is_start_tag())
+            continue;
+
+        auto tag_name = token.tag_name();
+        if (tag_name == HTML::TagNames::link) {
+            bool is_style_sheet = false;
+            bool is_alternate = false;
+            for (auto& part : token.attribute(HTML::AttributeNames::rel).split_view(' ')) {
+                if (part == "stylesheet")
+                    is_style_sheet = true;
+                else if (part == "alternate")
+                    is_alternate = true;
+            }
+            if (is_style_sheet && !is_alternate)
+                preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::href));
+        } else if (tag_name == HTML::TagNames::script) {
+            preload(Resource::Type::Generic, token.attribute(HTML::AttributeNames::src));
+        } else if (tag_name == HTML::TagNames::img) {
+            preload(Resource::Type::Image, token.attribute(HTML::AttributeNames::src));
+        }
+
+        // The contents of these aren't markup, which the tokenizer has to be told about, the same way the parser does.
+        if (tag_name == HTML::TagNames::script) {
+            m_tokenizer.m_state = HTMLTokenizer::State::ScriptData;
+        } else if (tag_name.is_one_of(HTML::TagNames::style, HTML::TagNames::xmp, HTML::TagNames::iframe, HTML::TagNames::noembed, HTML::TagNames::noframes)
+            || (tag_name == HTML::TagNames::noscript && m_document.is_scripting_enabled())) {
+            m_tokenizer.m_state = HTMLTokenizer::State::RAWTEXT;
+        } else if (tag_name.is_one_of(HTML::TagNames::title, HTML::TagNames::textarea)) {
+            m_tokenizer.m_state = HTMLTokenizer::State::RCDATA;
+        } else if (tag_name == HTML::TagNames::plaintext) {
+            return;
+        }
+    }
+}
+
+void HTMLPreloadScanner::preload(Resource::Type type, const StringView& url_string)
+{
+    if (url_string.is_empty())
+        return;
+    auto url = m_document.complete_url(url_string);
+    // Local files aren't worth fetching early, and they don't go into the resource cache, so they'd get loaded twice.
+    if (!url.is_valid() || url.protocol() == "file" || url.protocol() == "data")
+        return;
+
+    (void)ResourceLoader::the().load_resource(type, LoadRequest::create_for_url_on_page(url, m_document.page()));
+}
+
+}
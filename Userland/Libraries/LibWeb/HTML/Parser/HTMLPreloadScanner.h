@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <LibWeb/Forward.h>
+#include <LibWeb/HTML/Parser/HTMLTokenizer.h>
+#include <LibWeb/Loader/Resource.h>
+
+namespace Web::HTML {
+
+// Looks through the markup for the style sheets, scripts and images that the parser is going to want, and starts
+// fetching them, so that they don't have to wait for the (blocking) scripts in front of them to load and run.
+class HTMLPreloadScanner {
+public:
+    HTMLPreloadScanner(DOM::Document&, const StringView& input);
+
+    void scan();
+
+private:
+    void preload(Resource::Type, const StringView& url);
+
+    DOM::Document& m_document;
+    HTMLTokenizer m_tokenizer;
+};
+
+}
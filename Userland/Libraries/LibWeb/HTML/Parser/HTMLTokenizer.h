@@ -141,6 +141,9 @@ private:
 
     bool consumed_as_part_of_an_attribute() const;
 
+    // It switches the tokenizer into the states the parser would, without a parser.
+    friend class HTMLPreloadScanner;
+
     State m_state { State::Data };
     State m_return_state { State::Data };
 
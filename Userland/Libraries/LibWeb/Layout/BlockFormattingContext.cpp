@@ -386,7 +386,7 @@ void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode la
         }
 
         compute_width(child_box);
-        layout_inside(child_box, layout_mode);
+        layout_block_level_child_inside(child_box, box, layout_mode);
         compute_height(child_box);
 
         if (child_box.computed_values().position() == CSS::Position::Relative)
@@ -413,6 +413,28 @@ void BlockFormattingContext::layout_block_level_children(Box& box, LayoutMode la
     }
 }
 
+void BlockFormattingContext::layout_block_level_child_inside(Box& child_box, Box& containing_block, LayoutMode layout_mode)
+{
+    // The inside of a block doesn't depend on anything but its width and the height of its containing block, unless
+    // some floats stick into it, or it had floats of its own that stick out into the rest of this context.
+    auto has_floating_boxes = [&] { return !m_left_floating_boxes.is_empty() || !m_right_floating_boxes.is_empty(); };
+    Box::LayoutConstraints constraints { child_box.width(), containing_block.height() };
+    auto& constraints_of_last_layout = child_box.constraints_of_last_layout();
+
+    if (layout_mode == LayoutMode::Default && !has_floating_boxes() && !containing_block.needs_layout()
+        && !child_box.needs_layout() && !child_box.child_needs_layout()
+        && constraints_of_last_layout.has_value() && constraints_of_last_layout.value() == constraints) {
+        return;
+    }
+
+    bool had_floating_boxes = has_floating_boxes();
+    layout_inside(child_box, layout_mode);
+    if (layout_mode == LayoutMode::Default && !had_floating_boxes && !has_floating_boxes())
+        child_box.set_constraints_of_last_layout(constraints);
+    else
+        child_box.set_constraints_of_last_layout({});
+}
+
 void BlockFormattingContext::place_block_level_replaced_element_in_normal_flow(Box& child_box, Box& containing_block)
 {
     VERIFY(!containing_block.is_absolutely_positioned());
@@ -39,6 +39,7 @@ private:
     void layout_initial_containing_block(LayoutMode);
 
     void layout_block_level_children(Box&, LayoutMode);
+    void layout_block_level_child_inside(Box& child, Box& containing_block, LayoutMode);
     void layout_inline_children(Box&, LayoutMode);
 
     void place_block_level_replaced_element_in_normal_flow(Box& child, Box& container);
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/OwnPtr.h>
 #include <LibGfx/Rect.h>
 #include <LibWeb/Layout/LineBox.h>
@@ -120,6 +121,17 @@ public:
 
     virtual float width_of_logical_containing_block() const;
 
+    // What the last layout of the inside of the box depended on, if it was done in LayoutMode::Default and depended on
+    // nothing else. It doesn't have to be done again under the same constraints, unless something in the box changed.
+    struct LayoutConstraints {
+        float width { 0 };
+        float containing_block_height { 0 };
+
+        bool operator==(const LayoutConstraints& other) const { return width == other.width && containing_block_height == other.containing_block_height; }
+    };
+    const Optional<LayoutConstraints>& constraints_of_last_layout() const { return m_constraints_of_last_layout; }
+    void set_constraints_of_last_layout(Optional<LayoutConstraints> constraints) { m_constraints_of_last_layout = constraints; }
+
 protected:
     Box(DOM::Document& document, DOM::Node* node, NonnullRefPtr<CSS::StyleProperties> style)
         : NodeWithStyleAndBoxModelMetrics(document, node, move(style))
@@ -147,6 +159,8 @@ private:
     WeakPtr<LineBoxFragment> m_containing_line_box_fragment;
 
     OwnPtr<StackingContext> m_stacking_context;
+
+    Optional<LayoutConstraints> m_constraints_of_last_layout;
 };
 
 template<>
@@ -67,6 +67,10 @@ bool FormattingContext::creates_block_formatting_context(const Box& box)
 
 void FormattingContext::layout_inside(Box& box, LayoutMode layout_mode)
 {
+    // Measuring the box leaves it laid out for the measurement, so it has to be laid out for real again afterwards.
+    if (layout_mode != LayoutMode::Default)
+        box.set_constraints_of_last_layout({});
+
     if (creates_block_formatting_context(box)) {
         BlockFormattingContext context(box, this);
         context.run(box, layout_mode);
@@ -34,6 +34,15 @@ void FrameBox::prepare_for_replaced_layout()
     set_intrinsic_height(dom_node().attribute(HTML::AttributeNames::height).to_int().value_or(150));
 }
 
+void FrameBox::prepare_for_painting()
+{
+    auto* hosted_document = dom_node().content_document();
+    if (!hosted_document)
+        return;
+    if (auto* hosted_layout_tree = hosted_document->layout_node())
+        const_cast<Layout::InitialContainingBlockBox*>(hosted_layout_tree)->prepare_for_painting();
+}
+
 void FrameBox::paint(PaintContext& context, PaintPhase phase)
 {
     ReplacedBox::paint(context, phase);
@@ -75,6 +75,14 @@ void ImageBox::prepare_for_replaced_layout()
     }
 }
 
+void ImageBox::prepare_for_painting()
+{
+    if (renders_as_alt_text())
+        (void)Gfx::FontDatabase::default_font();
+    else
+        (void)m_image_loader.bitmap(m_image_loader.current_frame_index());
+}
+
 void ImageBox::paint(PaintContext& context, PaintPhase phase)
 {
     if (!is_visible())
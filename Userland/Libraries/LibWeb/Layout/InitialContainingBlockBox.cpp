@@ -65,6 +65,15 @@ void InitialContainingBlockBox::paint_all_phases(PaintContext& context)
     paint(context, PaintPhase::Overlay);
 }
 
+void InitialContainingBlockBox::prepare_for_painting()
+{
+    for_each_in_inclusive_subtree([&](auto& node) {
+        if (&node != this)
+            node.prepare_for_painting();
+        return IterationDecision::Continue;
+    });
+}
+
 void InitialContainingBlockBox::paint(PaintContext& context, PaintPhase phase)
 {
     stacking_context()->paint(context, phase);
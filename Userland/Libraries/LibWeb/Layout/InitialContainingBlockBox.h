@@ -23,6 +23,9 @@ public:
 
     void paint_document_background(PaintContext&);
 
+    // Prepares every node in the tree (and in the trees of the documents in its frames) for painting.
+    virtual void prepare_for_painting() override;
+
     virtual HitTestResult hit_test(const Gfx::IntPoint&, HitTestType) const override;
 
     const LayoutRange& selection() const { return m_selection; }
@@ -96,6 +96,10 @@ public:
     virtual void paint_fragment(PaintContext&, const LineBoxFragment&, PaintPhase) const { }
     virtual void after_children_paint(PaintContext&, PaintPhase) {};
 
+    // Does whatever painting would otherwise set up lazily (like decoding an image), so that the tree can then be
+    // painted from more than one thread at a time.
+    virtual void prepare_for_painting() { }
+
     // These are used to optimize hot is<T> variants for some classes where dynamic_cast is too slow.
     virtual bool is_box() const { return false; }
     virtual bool is_block_box() const { return false; }
@@ -131,6 +135,13 @@ public:
 
     virtual void set_needs_display();
 
+    // Whether the node has changed in a way that affects layout since the last one, and whether any of its
+    // descendants has. Layout can skip the subtrees of boxes that are clean, as long as nothing around them changed.
+    bool needs_layout() const { return m_needs_layout; }
+    bool child_needs_layout() const { return m_child_needs_layout; }
+    void set_needs_layout();
+    void clear_needs_layout();
+
     bool children_are_inline() const { return m_children_are_inline; }
     void set_children_are_inline(bool value) { m_children_are_inline = value; }
 
@@ -179,6 +190,8 @@ private:
     bool m_has_style { false };
     bool m_visible { true };
     bool m_children_are_inline { false };
+    bool m_needs_layout { true };
+    bool m_child_needs_layout { false };
     SelectionState m_selection_state { SelectionState::None };
 };
 
@@ -27,6 +27,11 @@ void SVGPathBox::prepare_for_replaced_layout()
     set_offset(bounding_box.top_left());
 }
 
+void SVGPathBox::prepare_for_painting()
+{
+    (void)dom_node().get_path();
+}
+
 void SVGPathBox::paint(PaintContext& context, PaintPhase phase)
 {
     if (!is_visible())
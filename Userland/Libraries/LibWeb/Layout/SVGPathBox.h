@@ -19,6 +19,7 @@ public:
     SVG::SVGPathElement& dom_node() { return downcast<SVG::SVGPathElement>(SVGGraphicsBox::dom_node()); }
 
     virtual void prepare_for_replaced_layout() override;
+    virtual void prepare_for_painting() override;
     virtual void paint(PaintContext& context, PaintPhase phase) override;
 };
 
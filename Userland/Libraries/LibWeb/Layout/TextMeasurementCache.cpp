@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <LibWeb/Layout/TextMeasurementCache.h>
+
+namespace Web::Layout {
+
+// Enough for the distinct words of a long document in a handful of fonts.
+static constexpr size_t max_entry_count = 8192;
+
+// Longer runs are usually whole lines of preformatted text, which don't repeat much and would only push words out.
+static constexpr size_t max_cached_length = 128;
+
+TextMeasurementCache& TextMeasurementCache::the()
+{
+    static TextMeasurementCache* cache;
+    if (!cache)
+        cache = new TextMeasurementCache;
+    return *cache;
+}
+
+int TextMeasurementCache::width(const Gfx::Font& font, const Utf8View& view)
+{
+    auto text = view.as_string();
+    if (text.length() > max_cached_length)
+        return font.width(view);
+
+    auto hash = pair_int_hash(ptr_hash(&font), text.hash());
+    auto it = m_entries.find(hash, [&](auto& entry) { return entry.key.font == &font && entry.key.text == text; });
+    if (it != m_entries.end()) {
+        auto& entry = *it->value;
+        m_lru_list.remove(entry);
+        m_lru_list.append(entry);
+        return entry.width;
+    }
+
+    if (m_entries.size() >= max_entry_count) {
+        auto* oldest = m_lru_list.take_first();
+        m_entries.remove(oldest->key);
+    }
+
+    auto entry = make<Entry>(Key { &font, text }, font.width(view), font);
+    auto width = entry->width;
+    m_lru_list.append(*entry);
+    auto key = entry->key;
+    m_entries.set(move(key), move(entry));
+    return width;
+}
+
+}
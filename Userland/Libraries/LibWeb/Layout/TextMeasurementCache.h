@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/String.h>
+#include <AK/Utf8View.h>
+#include <LibGfx/Font.h>
+
+namespace Web::Layout {
+
+// Remembers how wide the words of a text are in a font, so that laying the same text out again (e.g when the window
+// is resized) doesn't have to add up the widths of all of its glyphs again. Only layout uses it, on the main thread.
+class TextMeasurementCache {
+    AK_MAKE_NONCOPYABLE(TextMeasurementCache);
+    AK_MAKE_NONMOVABLE(TextMeasurementCache);
+
+public:
+    static TextMeasurementCache& the();
+
+    int width(const Gfx::Font&, const Utf8View&);
+
+private:
+    TextMeasurementCache() = default;
+
+    struct Key {
+        const Gfx::Font* font { nullptr };
+        String text;
+
+        unsigned hash() const { return pair_int_hash(ptr_hash(font), text.hash()); }
+        bool operator==(const Key& other) const { return font == other.font && text == other.text; }
+    };
+
+    struct KeyTraits : public GenericTraits<Key> {
+        static unsigned hash(const Key& key) { return key.hash(); }
+    };
+
+    struct Entry {
+        Entry(Key key, int width, const Gfx::Font& font)
+            : key(move(key))
+            , width(width)
+            , font(const_cast<Gfx::Font&>(font))
+        {
+        }
+
+        Key key;
+        int width { 0 };
+        // Keeps the font from going away, so that no other font can end up at the same address while this is cached.
+        NonnullRefPtr<Gfx::Font> font;
+        IntrusiveListNode<Entry> list_node;
+    };
+
+    HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> m_entries;
+    // From the least to the most recently used.
+    IntrusiveList<Entry, RawPtr<Entry>, &Entry::list_node> m_lru_list;
+};
+
+}
@@ -11,6 +11,7 @@
 #include <LibWeb/Layout/BlockBox.h>
 #include <LibWeb/Layout/InlineFormattingContext.h>
 #include <LibWeb/Layout/Label.h>
+#include <LibWeb/Layout/TextMeasurementCache.h>
 #include <LibWeb/Layout/TextNode.h>
 #include <LibWeb/Page/Frame.h>
 #include <ctype.h>
@@ -160,6 +161,7 @@ void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, Layou
     auto& containing_block = context.containing_block();
 
     auto& font = this->font();
+    auto& measurement_cache = TextMeasurementCache::the();
 
     auto& line_boxes = containing_block.line_boxes();
     containing_block.ensure_last_line_box();
@@ -228,7 +230,7 @@ void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, Layou
                 chunk.view = chunk.view.substring_view(1, chunk.view.byte_length() - 1);
             }
 
-            chunk_width = font.width(chunk.view) + font.glyph_spacing();
+            chunk_width = measurement_cache.width(font, chunk.view) + font.glyph_spacing();
 
             if (line_boxes.last().width() > 0 && chunk_width > available_width) {
                 containing_block.add_line_box();
@@ -238,7 +240,7 @@ void TextNode::split_into_lines_by_rules(InlineFormattingContext& context, Layou
                     continue;
             }
         } else {
-            chunk_width = font.width(chunk.view);
+            chunk_width = measurement_cache.width(font, chunk.view);
         }
 
         line_boxes.last().add_fragment(*this, chunk.start, chunk.length, chunk_width, font.glyph_height());
@@ -88,6 +88,7 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node)
             auto& insertion_point = insertion_parent_for_inline_node(*m_parent_stack.last());
             insertion_point.append_child(*layout_node);
             insertion_point.set_children_are_inline(true);
+            insertion_point.set_needs_layout();
         } else {
             // Non-inlines can't be inserted into an inline parent, so find the nearest non-inline ancestor.
             auto& nearest_non_inline_ancestor = [&]() -> Layout::Node& {
@@ -100,6 +101,7 @@ void TreeBuilder::create_layout_tree(DOM::Node& dom_node)
             auto& insertion_point = insertion_parent_for_block_node(nearest_non_inline_ancestor, *layout_node);
             insertion_point.append_child(*layout_node);
             insertion_point.set_children_are_inline(false);
+            insertion_point.set_needs_layout();
         }
     }
 
@@ -179,8 +181,11 @@ void TreeBuilder::remove_irrelevant_boxes(NodeWithStyle& root)
     // - they are the first and/or last child of a tabular container
     // - whose immediate sibling, if any, is a table-non-root box
 
-    for (auto& box : to_remove)
-        box.parent()->remove_child(box);
+    for (auto& box : to_remove) {
+        auto& parent = *box.parent();
+        parent.remove_child(box);
+        parent.set_needs_layout();
+    }
 }
 
 static bool is_table_track(CSS::Display display)
@@ -256,6 +261,7 @@ static void wrap_in_anonymous(NonnullRefPtrVector<Node>& sequence, Node* nearest
         parent.insert_before(move(wrapper), *nearest_sibling);
     else
         parent.append_child(move(wrapper));
+    parent.set_needs_layout();
 }
 
 void TreeBuilder::generate_missing_child_wrappers(NodeWithStyle& root)
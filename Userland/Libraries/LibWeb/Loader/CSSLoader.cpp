@@ -8,6 +8,7 @@
 #include <AK/URL.h>
 #include <LibWeb/CSS/CSSImportRule.h>
 #include <LibWeb/CSS/Parser/DeprecatedCSSParser.h>
+#include <LibWeb/CSS/StyleResolver.h>
 #include <LibWeb/CSS/StyleSheet.h>
 #include <LibWeb/DOM/Document.h>
 #include <LibWeb/DOM/Element.h>
@@ -16,6 +17,45 @@
 
 namespace Web {
 
+// Sites tend to use the same stylesheets in all of their documents, and in all of their iframes. Parsed rules never
+// change, so documents can share them, as long as the source and the way it was parsed are the same.
+// Sheets with @import rules aren't shared, since those rules get the imported sheet attached to them.
+struct ParsedStyleSheet {
+    String source;
+    bool in_quirks_mode { false };
+    NonnullRefPtrVector<CSS::CSSRule> rules;
+};
+static Vector<ParsedStyleSheet> s_parsed_style_sheet_cache;
+static constexpr size_t s_parsed_style_sheet_cache_limit = 16;
+
+static RefPtr<CSS::CSSStyleSheet> parse_css_with_cache(const DOM::Document& document, const StringView& source)
+{
+    bool in_quirks_mode = document.in_quirks_mode();
+    for (size_t i = 0; i < s_parsed_style_sheet_cache.size(); ++i) {
+        auto& entry = s_parsed_style_sheet_cache[i];
+        if (entry.in_quirks_mode != in_quirks_mode || entry.source != source)
+            continue;
+        auto sheet = CSS::CSSStyleSheet::create(entry.rules);
+        // Keep the most recently used sheets at the end.
+        s_parsed_style_sheet_cache.append(s_parsed_style_sheet_cache.take(i));
+        return sheet;
+    }
+
+    auto sheet = parse_css(CSS::ParsingContext(document), source);
+    if (!sheet)
+        return nullptr;
+
+    for (auto& rule : sheet->rules()) {
+        if (rule.type() == CSS::CSSRule::Type::Import)
+            return sheet;
+    }
+
+    if (s_parsed_style_sheet_cache.size() >= s_parsed_style_sheet_cache_limit)
+        s_parsed_style_sheet_cache.take_first();
+    s_parsed_style_sheet_cache.append({ source, in_quirks_mode, sheet->rules() });
+    return sheet;
+}
+
 CSSLoader::CSSLoader(DOM::Element& owner_element)
     : m_owner_element(owner_element)
 {
@@ -23,7 +63,7 @@ CSSLoader::CSSLoader(DOM::Element& owner_element)
 
 void CSSLoader::load_from_text(const String& text)
 {
-    m_style_sheet = parse_css(CSS::ParsingContext(m_owner_element.document()), text);
+    m_style_sheet = parse_css_with_cache(m_owner_element.document(), text);
     if (!m_style_sheet) {
         m_style_sheet = CSS::CSSStyleSheet::create({});
         m_style_sheet->set_owner_node(&m_owner_element);
@@ -51,7 +91,7 @@ void CSSLoader::resource_did_load()
         dbgln_if(CSS_LOADER_DEBUG, "CSSLoader: Resource did load, has encoded data. URL: {}", resource()->url());
     }
 
-    auto sheet = parse_css(CSS::ParsingContext(m_owner_element.document()), resource()->encoded_data());
+    auto sheet = parse_css_with_cache(m_owner_element.document(), resource()->encoded_data());
     if (!sheet) {
         dbgln_if(CSS_LOADER_DEBUG, "CSSLoader: Failed to parse stylesheet: {}", resource()->url());
         return;
@@ -66,6 +106,8 @@ void CSSLoader::resource_did_load()
         m_style_sheet->rules() = sheet->rules();
     }
 
+    m_owner_element.document().style_resolver().invalidate_rule_cache();
+
     if (on_load)
         on_load();
 
@@ -38,8 +38,8 @@ static bool build_markdown_document(DOM::Document& document, const ByteBuffer& d
     if (!markdown_document)
         return false;
 
-    HTML::HTMLDocumentParser parser(document, markdown_document->render_to_html(), "utf-8");
-    parser.run(document.url());
+    auto parser = HTML::HTMLDocumentParser::create(document, markdown_document->render_to_html(), "utf-8");
+    parser->run(document.url());
     return true;
 }
 
@@ -106,19 +106,14 @@ static bool build_gemini_document(DOM::Document& document, const ByteBuffer& dat
     dbgln("Converted to HTML:\n\"\"\"{}\"\"\"", html_data);
 #endif
 
-    HTML::HTMLDocumentParser parser(document, html_data, "utf-8");
-    parser.run(document.url());
+    auto parser = HTML::HTMLDocumentParser::create(document, html_data, "utf-8");
+    parser->run(document.url());
     return true;
 }
 
 bool FrameLoader::parse_document(DOM::Document& document, const ByteBuffer& data)
 {
     auto& mime_type = document.content_type();
-    if (mime_type == "text/html" || mime_type == "image/svg+xml") {
-        HTML::HTMLDocumentParser parser(document, data, document.encoding());
-        parser.run(document.url());
-        return true;
-    }
     if (mime_type.starts_with("image/"))
         return build_image_document(document, data);
     if (mime_type == "text/plain" || mime_type == "application/json")
@@ -140,6 +135,8 @@ bool FrameLoader::load(const LoadRequest& request, Type type)
 
     auto& url = request.url();
 
+    // Whatever was still being parsed is going away.
+    m_parser = nullptr;
     set_resource(ResourceLoader::the().load_resource(Resource::Type::Generic, request));
 
     if (type == Type::Navigation) {
@@ -191,10 +188,11 @@ bool FrameLoader::load(const URL& url, Type type)
 
 void FrameLoader::load_html(const StringView& html, const URL& url)
 {
+    m_parser = nullptr;
     auto document = DOM::Document::create(url);
-    HTML::HTMLDocumentParser parser(document, html, "utf-8");
-    parser.run(url);
-    frame().set_document(&parser.document());
+    auto parser = HTML::HTMLDocumentParser::create(document, html, "utf-8");
+    parser->run(url);
+    frame().set_document(&parser->document());
 }
 
 // FIXME: Use an actual templating engine (our own one when it's built, preferably
@@ -247,10 +245,29 @@ void FrameLoader::resource_did_load()
 
     frame().set_document(document);
 
+    auto& mime_type = document->content_type();
+    if (mime_type == "text/html" || mime_type == "image/svg+xml") {
+        // The document gets parsed a slice at a time, so it can show up before all of it has been parsed.
+        m_parser = HTML::HTMLDocumentParser::create(*document, resource()->encoded_data(), document->encoding());
+        m_parser->run_incrementally(url, [this, url, parser = m_parser.ptr()] {
+            // The scripts on the page may have started loading something else.
+            if (m_parser.ptr() == parser)
+                did_parse_document(url);
+        });
+        return;
+    }
+
     if (!parse_document(*document, resource()->encoded_data())) {
         load_error_page(url, "Failed to parse content.");
         return;
     }
+    did_parse_document(url);
+}
+
+void FrameLoader::did_parse_document(const URL& url)
+{
+    auto* document = frame().document();
+    VERIFY(document);
 
     // FIXME: Support multiple instances of the Set-Cookie response header.
     auto set_cookie = resource()->response_headers().get("Set-Cookie");
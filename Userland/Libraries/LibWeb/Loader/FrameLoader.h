@@ -39,8 +39,10 @@ private:
 
     void load_error_page(const URL& failed_url, const String& error_message);
     bool parse_document(DOM::Document&, const ByteBuffer& data);
+    void did_parse_document(const URL&);
 
     Frame& m_frame;
+    RefPtr<HTML::HTMLDocumentParser> m_parser;
 };
 
 }
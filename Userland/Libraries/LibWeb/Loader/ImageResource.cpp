@@ -18,11 +18,13 @@ ImageResource::ImageResource(const LoadRequest& request)
 
 ImageResource::~ImageResource()
 {
+    forget_decoded_image();
 }
 
 int ImageResource::frame_duration(size_t frame_index) const
 {
     decode_if_needed();
+    decode_frame_if_needed(frame_index);
     if (frame_index >= m_decoded_frames.size())
         return 0;
     return m_decoded_frames[frame_index].duration;
@@ -58,19 +60,82 @@ void ImageResource::decode_if_needed() const
         m_loop_count = image.value().loop_count;
         m_animated = image.value().is_animated;
         m_decoded_frames.resize(image.value().frames.size());
-        for (size_t i = 0; i < m_decoded_frames.size(); ++i) {
-            auto& frame = m_decoded_frames[i];
-            frame.bitmap = image.value().frames[i].bitmap;
-            frame.duration = image.value().frames[i].duration;
+        if (!m_decoded_frames.is_empty()) {
+            auto& first_frame = m_decoded_frames.first();
+            first_frame.bitmap = image.value().frames.first().bitmap;
+            first_frame.duration = image.value().frames.first().duration;
+            first_frame.has_attempted_decode = true;
+        }
+        if (image.value().image_id) {
+            m_image_decoder = move(decoder);
+            m_image_id = image.value().image_id;
         }
     }
 
     m_has_attempted_decode = true;
 }
 
+void ImageResource::decode_frame_if_needed(size_t frame_index) const
+{
+    if (frame_index >= m_decoded_frames.size())
+        return;
+
+    // Animations mostly go from one frame to the next, so have the decoder work on the next one
+    // while this one is on screen.
+    prefetch_frame((frame_index + 1) % m_decoded_frames.size());
+
+    auto& frame = m_decoded_frames[frame_index];
+    if (frame.has_attempted_decode)
+        return;
+    frame.has_attempted_decode = true;
+
+    if (!m_image_decoder)
+        return;
+
+    auto decoded_frame = m_image_decoder->decode_frame(m_image_id, frame_index);
+    if (!decoded_frame.has_value())
+        return;
+
+    frame.bitmap = decoded_frame.value().bitmap;
+    frame.duration = decoded_frame.value().duration;
+}
+
+void ImageResource::prefetch_frame(size_t frame_index) const
+{
+    auto& frame = m_decoded_frames[frame_index];
+    if (frame.has_attempted_decode || frame.is_being_prefetched || !m_image_decoder)
+        return;
+    frame.is_being_prefetched = true;
+
+    NonnullRefPtr protect = *this;
+    m_image_decoder->decode_frame_async(m_image_id, frame_index, [this, protect, image_id = m_image_id, frame_index](auto decoded_frame) {
+        // The decoded image may have been thrown away while the frame was being decoded.
+        if (image_id != m_image_id || frame_index >= m_decoded_frames.size())
+            return;
+
+        auto& frame = m_decoded_frames[frame_index];
+        frame.is_being_prefetched = false;
+        if (frame.has_attempted_decode || !decoded_frame.has_value())
+            return;
+        frame.has_attempted_decode = true;
+        frame.bitmap = decoded_frame.value().bitmap;
+        frame.duration = decoded_frame.value().duration;
+    });
+}
+
+void ImageResource::forget_decoded_image() const
+{
+    if (!m_image_decoder)
+        return;
+    m_image_decoder->forget_image(m_image_id);
+    m_image_decoder = nullptr;
+    m_image_id = 0;
+}
+
 const Gfx::Bitmap* ImageResource::bitmap(size_t frame_index) const
 {
     decode_if_needed();
+    decode_frame_if_needed(frame_index);
     if (frame_index >= m_decoded_frames.size())
         return nullptr;
     return m_decoded_frames[frame_index].bitmap;
@@ -94,6 +159,9 @@ void ImageResource::update_volatility()
 
     bool still_has_decoded_image = true;
     for (auto& frame : m_decoded_frames) {
+        // Frames we haven't gotten around to decoding yet are not missing.
+        if (!frame.has_attempted_decode)
+            continue;
         if (!frame.bitmap) {
             still_has_decoded_image = false;
         } else {
@@ -107,6 +175,18 @@ void ImageResource::update_volatility()
 
     m_decoded_frames.clear();
     m_has_attempted_decode = false;
+    forget_decoded_image();
+}
+
+size_t ImageResource::memory_usage() const
+{
+    // Volatile frames can be purged at any time, so they don't count.
+    size_t size = Resource::memory_usage();
+    for (auto& frame : m_decoded_frames) {
+        if (frame.bitmap && !frame.bitmap->is_volatile())
+            size += frame.bitmap->size_in_bytes();
+    }
+    return size;
 }
 
 ImageResourceClient::~ImageResourceClient()
@@ -8,6 +8,10 @@
 
 #include <LibWeb/Loader/Resource.h>
 
+namespace ImageDecoderClient {
+class Client;
+}
+
 namespace Web {
 
 class ImageResource final : public Resource {
@@ -19,6 +23,8 @@ public:
     struct Frame {
         RefPtr<Gfx::Bitmap> bitmap;
         size_t duration { 0 };
+        bool has_attempted_decode { false };
+        bool is_being_prefetched { false };
     };
 
     const Gfx::Bitmap* bitmap(size_t frame_index = 0) const;
@@ -41,15 +47,24 @@ public:
 
     void update_volatility();
 
+    virtual size_t memory_usage() const override;
+
 private:
     explicit ImageResource(const LoadRequest&);
 
     void decode_if_needed() const;
+    void decode_frame_if_needed(size_t frame_index) const;
+    void prefetch_frame(size_t frame_index) const;
+    void forget_decoded_image() const;
 
     mutable bool m_animated { false };
     mutable int m_loop_count { 0 };
     mutable Vector<Frame> m_decoded_frames;
     mutable bool m_has_attempted_decode { false };
+
+    // Frames after the first one are decoded on demand, using the image kept by this decoder.
+    mutable RefPtr<ImageDecoderClient::Client> m_image_decoder;
+    mutable i32 m_image_id { 0 };
 };
 
 class ImageResourceClient : public ResourceClient {
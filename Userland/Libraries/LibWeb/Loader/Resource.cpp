@@ -7,6 +7,7 @@
 #include <AK/Debug.h>
 #include <AK/Function.h>
 #include <LibCore/MimeData.h>
+#include <LibWeb/Cookie/ParsedCookie.h>
 #include <LibWeb/HTML/HTMLImageElement.h>
 #include <LibWeb/Loader/Resource.h>
 
@@ -71,6 +72,7 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap
     m_encoded_data = ByteBuffer::copy(data);
     m_response_headers = headers;
     m_status_code = move(status_code);
+    m_response_time = time(nullptr);
     m_loaded = true;
 
     auto content_type = headers.get("Content-Type");
@@ -97,6 +99,95 @@ void Resource::did_load(Badge<ResourceLoader>, ReadonlyBytes data, const HashMap
     });
 }
 
+// Returns the directives of the Cache-Control header by their (lowercased) names, along with their values if they have any.
+static HashMap<String, String> cache_control_directives(const HashMap<String, String, CaseInsensitiveStringTraits>& headers)
+{
+    HashMap<String, String> directives;
+    auto header = headers.get("Cache-Control");
+    if (!header.has_value())
+        return directives;
+
+    for (auto& part : header.value().split_view(',')) {
+        auto directive = part.trim_whitespace();
+        auto equals_sign = directive.find_first_of('=');
+        if (!equals_sign.has_value()) {
+            directives.set(directive.to_string().to_lowercase(), {});
+            continue;
+        }
+        auto value = directive.substring_view(equals_sign.value() + 1).trim_whitespace();
+        if (value.length() >= 2 && value.starts_with('"') && value.ends_with('"'))
+            value = value.substring_view(1, value.length() - 2);
+        directives.set(directive.substring_view(0, equals_sign.value()).trim_whitespace().to_string().to_lowercase(), value);
+    }
+    return directives;
+}
+
+static Optional<time_t> header_as_time(const HashMap<String, String, CaseInsensitiveStringTraits>& headers, const String& name)
+{
+    auto header = headers.get(name);
+    if (!header.has_value())
+        return {};
+    auto date_time = Cookie::parse_date_time(header.value());
+    if (!date_time.has_value())
+        return {};
+    return date_time->timestamp();
+}
+
+bool Resource::may_be_stored() const
+{
+    // https://tools.ietf.org/html/rfc7234#section-3
+    if (m_failed)
+        return false;
+    return !cache_control_directives(m_response_headers).contains("no-store");
+}
+
+bool Resource::is_fresh() const
+{
+    // Only what comes over HTTP can change, everything else stays the way it was.
+    if (url().protocol() != "http" && url().protocol() != "https")
+        return true;
+
+    // https://tools.ietf.org/html/rfc7234#section-4.2.1
+    auto directives = cache_control_directives(m_response_headers);
+    if (directives.contains("no-cache"))
+        return false;
+
+    auto date = header_as_time(m_response_headers, "Date").value_or(m_response_time);
+    time_t freshness_lifetime = 0;
+    if (auto max_age = directives.get("max-age"); max_age.has_value() && max_age.value().to_uint().has_value()) {
+        freshness_lifetime = max_age.value().to_uint().value();
+    } else if (m_response_headers.contains("Expires")) {
+        // An Expires header that can't be parsed means that the response has already expired.
+        freshness_lifetime = header_as_time(m_response_headers, "Expires").value_or(date) - date;
+    } else if (auto last_modified = header_as_time(m_response_headers, "Last-Modified"); last_modified.has_value()) {
+        // https://tools.ietf.org/html/rfc7234#section-4.2.2
+        freshness_lifetime = (date - last_modified.value()) / 10;
+    }
+
+    // https://tools.ietf.org/html/rfc7234#section-4.2.3, without correcting for the time that the response took to get here.
+    time_t age = max(time(nullptr) - m_response_time, static_cast<time_t>(0));
+    if (auto age_header = m_response_headers.get("Age"); age_header.has_value())
+        age += age_header.value().to_uint().value_or(0);
+
+    return age < freshness_lifetime;
+}
+
+bool Resource::has_validators() const
+{
+    return m_response_headers.contains("ETag") || m_response_headers.contains("Last-Modified");
+}
+
+LoadRequest Resource::create_validation_request() const
+{
+    // https://tools.ietf.org/html/rfc7234#section-4.3.1
+    auto request = m_request;
+    if (auto etag = m_response_headers.get("ETag"); etag.has_value())
+        request.set_header("If-None-Match", etag.value());
+    if (auto last_modified = m_response_headers.get("Last-Modified"); last_modified.has_value())
+        request.set_header("If-Modified-Since", last_modified.value());
+    return request;
+}
+
 void Resource::did_fail(Badge<ResourceLoader>, const String& error, Optional<u32> status_code)
 {
     m_error = error;
@@ -118,6 +209,10 @@ void Resource::unregister_client(Badge<ResourceClient>, ResourceClient& client)
 {
     VERIFY(m_clients.contains(&client));
     m_clients.remove(&client);
+
+    // Nobody is looking at the image anymore, so the kernel may take its decoded frames back if it needs the memory.
+    if (m_clients.is_empty() && m_type == Type::Image)
+        static_cast<ImageResource&>(*this).update_volatility();
 }
 
 void ResourceClient::set_resource(Resource* resource)
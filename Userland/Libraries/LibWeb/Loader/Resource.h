@@ -42,8 +42,18 @@ public:
     bool is_failed() const { return m_failed; }
     const String& error() const { return m_error; }
 
+    Optional<u32> status_code() const { return m_status_code; }
+
     bool has_encoded_data() const { return !m_encoded_data.is_null(); }
 
+    // These say whether (and for how long) the resource cache may hand out the resource again, according to the
+    // caching rules of HTTP (https://tools.ietf.org/html/rfc7234).
+    bool may_be_stored() const;
+    bool is_fresh() const;
+    bool has_validators() const;
+    // Asks the server whether the resource has changed, to which the answer is 304 Not Modified if it hasn't.
+    LoadRequest create_validation_request() const;
+
     const URL& url() const { return m_request.url(); }
     const ByteBuffer& encoded_data() const { return m_encoded_data; }
 
@@ -51,6 +61,10 @@ public:
 
     void register_client(Badge<ResourceClient>, ResourceClient&);
     void unregister_client(Badge<ResourceClient>, ResourceClient&);
+    bool has_clients() const { return !m_clients.is_empty(); }
+
+    // How much memory the resource cache would get back by letting go of this resource.
+    virtual size_t memory_usage() const { return m_encoded_data.size(); }
 
     const String& encoding() const { return m_encoding; }
     const String& mime_type() const { return m_mime_type; }
@@ -74,6 +88,7 @@ private:
     String m_mime_type;
     HashMap<String, String, CaseInsensitiveStringTraits> m_response_headers;
     Optional<u32> m_status_code;
+    time_t m_response_time { 0 };
     HashTable<ResourceClient*> m_clients;
 };
 
@@ -7,6 +7,7 @@
 #include <AK/Base64.h>
 #include <AK/Debug.h>
 #include <AK/JsonObject.h>
+#include <AK/QuickSort.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibProtocol/Client.h>
@@ -51,23 +52,77 @@ void ResourceLoader::load_sync(const LoadRequest& request, Function<void(Readonl
     loop.exec();
 }
 
-static HashMap<LoadRequest, NonnullRefPtr<Resource>> s_resource_cache;
+struct CachedResource {
+    NonnullRefPtr<Resource> resource;
+    u64 last_use { 0 };
+};
+
+static HashMap<LoadRequest, CachedResource> s_resource_cache;
+static u64 s_resource_cache_use_counter;
+
+// Resources that no page is using anymore are kept around until they add up to this much memory,
+// after which the least recently used ones are let go.
+static constexpr size_t s_unused_resource_cache_limit = 32 * MiB;
+
+static void evict_unused_resources_if_needed()
+{
+    struct UnusedResource {
+        LoadRequest request;
+        u64 last_use { 0 };
+        size_t size { 0 };
+    };
+    Vector<UnusedResource> unused_resources;
+    size_t unused_size = 0;
+    for (auto& it : s_resource_cache) {
+        auto& resource = *it.value.resource;
+        if (resource.has_clients() || (!resource.is_loaded() && !resource.is_failed()))
+            continue;
+        unused_resources.append({ it.key, it.value.last_use, resource.memory_usage() });
+        unused_size += unused_resources.last().size;
+    }
+
+    if (unused_size <= s_unused_resource_cache_limit)
+        return;
+
+    quick_sort(unused_resources, [](auto& a, auto& b) { return a.last_use < b.last_use; });
+
+    size_t evicted_count = 0;
+    for (auto& unused_resource : unused_resources) {
+        if (unused_size <= s_unused_resource_cache_limit)
+            break;
+        unused_size -= unused_resource.size;
+        s_resource_cache.remove(unused_resource.request);
+        ++evicted_count;
+    }
+
+    dbgln_if(CACHE_DEBUG, "Evicted {} unused resources from ResourceLoader cache", evicted_count);
+}
 
 RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRequest& request)
 {
     if (!request.is_valid())
         return nullptr;
 
-    bool use_cache = request.url().protocol() != "file";
+    bool use_cache = request.url().protocol() != "file" && request.method().equals_ignoring_case("GET");
 
+    // A stale resource can still be used if the server says that it hasn't changed.
+    RefPtr<Resource> stale_resource;
     if (use_cache) {
         auto it = s_resource_cache.find(request);
         if (it != s_resource_cache.end()) {
-            if (it->value->type() != type) {
+            it->value.last_use = ++s_resource_cache_use_counter;
+            auto& cached_resource = *it->value.resource;
+            if (cached_resource.type() != type) {
                 dbgln("FIXME: Not using cached resource for {} since there's a type mismatch.", request.url());
-            } else {
+            } else if (!cached_resource.is_loaded() && !cached_resource.is_failed()) {
+                dbgln_if(CACHE_DEBUG, "Reusing resource that is still loading for: {}", request.url());
+                return cached_resource;
+            } else if (cached_resource.is_loaded() && cached_resource.is_fresh()) {
                 dbgln_if(CACHE_DEBUG, "Reusing cached resource for: {}", request.url());
-                return it->value;
+                return cached_resource;
+            } else if (cached_resource.is_loaded() && cached_resource.has_validators()) {
+                dbgln_if(CACHE_DEBUG, "Revalidating cached resource for: {}", request.url());
+                stale_resource = cached_resource;
             }
         }
     }
@@ -75,26 +130,58 @@ RefPtr<Resource> ResourceLoader::load_resource(Resource::Type type, const LoadRe
     auto resource = Resource::create({}, type, request);
 
     if (use_cache)
-        s_resource_cache.set(request, resource);
+        s_resource_cache.set(request, { resource, ++s_resource_cache_use_counter });
+
+    // The cache only keeps what HTTP allows it to, and never a failure, so that the next load tries again.
+    auto forget_unless_storable = [request, resource_ptr = resource.ptr()] {
+        auto it = s_resource_cache.find(request);
+        if (it != s_resource_cache.end() && it->value.resource.ptr() == resource_ptr && !it->value.resource->may_be_stored())
+            s_resource_cache.remove(it);
+        evict_unused_resources_if_needed();
+    };
 
     load(
-        request,
+        stale_resource ? stale_resource->create_validation_request() : request,
         [=](auto data, auto& headers, auto status_code) {
-            const_cast<Resource&>(*resource).did_load({}, data, headers, status_code);
+            if (stale_resource && status_code.has_value() && status_code.value() == 304) {
+                // The response says what changed about the headers (like for how long it stays fresh), but the data is the same.
+                auto merged_headers = stale_resource->response_headers();
+                for (auto& it : headers)
+                    merged_headers.set(it.key, it.value);
+                const_cast<Resource&>(*resource).did_load({}, stale_resource->encoded_data(), merged_headers, stale_resource->status_code());
+            } else {
+                const_cast<Resource&>(*resource).did_load({}, data, headers, status_code);
+            }
+            if (use_cache)
+                forget_unless_storable();
         },
         [=](auto& error, auto status_code) {
             const_cast<Resource&>(*resource).did_fail({}, error, status_code);
+            if (use_cache)
+                forget_unless_storable();
         });
 
     return resource;
 }
 
+RefPtr<Resource> ResourceLoader::load_resource_sync(Resource::Type type, const LoadRequest& request)
+{
+    auto resource = load_resource(type, request);
+    if (!resource)
+        return nullptr;
+    while (!resource->is_loaded() && !resource->is_failed())
+        Core::EventLoop::current().pump();
+    return resource;
+}
+
 void ResourceLoader::load(const LoadRequest& request, Function<void(ReadonlyBytes, const HashMap<String, String, CaseInsensitiveStringTraits>& response_headers, Optional<u32> status_code)> success_callback, Function<void(const String&, Optional<u32> status_code)> error_callback)
 {
     auto& url = request.url();
 
     if (is_port_blocked(url.port())) {
         dbgln("ResourceLoader::load: Error: blocked port {} from URL {}", url.port(), url);
+        if (error_callback)
+            error_callback("Port blocked", {});
         return;
     }
 
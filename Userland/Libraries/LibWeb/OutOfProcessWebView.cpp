@@ -22,6 +22,18 @@ REGISTER_WIDGET(Web, OutOfProcessWebView)
 
 namespace Web {
 
+// Backing stores come in sizes rounded up to this, so that most resizes can keep using the ones they have.
+static constexpr int backing_store_size_granularity = 256;
+static constexpr size_t max_spare_backing_stores = 2;
+
+static Gfx::IntSize backing_store_size_for(const Gfx::IntSize& size)
+{
+    auto round_up = [](int value) {
+        return (value + backing_store_size_granularity - 1) / backing_store_size_granularity * backing_store_size_granularity;
+    };
+    return { round_up(size.width()), round_up(size.height()) };
+}
+
 OutOfProcessWebView::OutOfProcessWebView()
 {
     set_should_hide_unnecessary_scrollbars(true);
@@ -101,10 +113,15 @@ void OutOfProcessWebView::paint_event(GUI::PaintEvent& event)
     GUI::Painter painter(*this);
     painter.add_clip_rect(event.rect());
 
-    if (auto* bitmap = m_client_state.has_usable_bitmap ? m_client_state.front_bitmap.ptr() : m_backup_bitmap.ptr()) {
+    auto* bitmap = m_client_state.has_usable_bitmap ? m_client_state.front_bitmap.ptr() : m_backup_bitmap.ptr();
+    if (bitmap) {
+        auto painted_size = m_client_state.has_usable_bitmap ? m_client_state.front_content_rect.size() : m_backup_content_size;
+        Gfx::IntRect painted_rect { {}, painted_size };
         painter.add_clip_rect(frame_inner_rect());
         painter.translate(frame_thickness(), frame_thickness());
-        painter.blit({ 0, 0 }, *bitmap, bitmap->rect());
+        painter.blit({ 0, 0 }, *bitmap, painted_rect);
+        for (auto& rect : Gfx::IntRect({}, available_size()).shatter(painted_rect))
+            painter.fill_rect(rect, palette().base());
         return;
     }
 
@@ -121,41 +138,63 @@ void OutOfProcessWebView::handle_resize()
 {
     client().post_message(Messages::WebContentServer::SetViewportRect(Gfx::IntRect({ horizontal_scrollbar().value(), vertical_scrollbar().value() }, available_size())));
 
+    auto backing_store_size = backing_store_size_for(available_size());
+    if (!available_size().is_empty() && m_client_state.front_bitmap && m_client_state.back_bitmap && m_client_state.front_bitmap->size() == backing_store_size) {
+        // The backing stores we have are still the right size, they just need to be painted again.
+        request_repaint();
+        return;
+    }
+
     if (m_client_state.has_usable_bitmap) {
         // NOTE: We keep the outgoing front bitmap as a backup so we have something to paint until we get a new one.
         m_backup_bitmap = m_client_state.front_bitmap;
+        m_backup_content_size = m_client_state.front_content_rect.size();
     }
 
-    if (m_client_state.front_bitmap) {
-        m_client_state.front_bitmap = nullptr;
-        client().post_message(Messages::WebContentServer::RemoveBackingStore(m_client_state.front_bitmap_id));
-    }
-
-    if (m_client_state.back_bitmap) {
-        m_client_state.back_bitmap = nullptr;
-        client().post_message(Messages::WebContentServer::RemoveBackingStore(m_client_state.back_bitmap_id));
-    }
-
-    m_client_state.front_bitmap_id = -1;
-    m_client_state.back_bitmap_id = -1;
+    retire_backing_store(m_client_state.front_bitmap, m_client_state.front_bitmap_id);
+    retire_backing_store(m_client_state.back_bitmap, m_client_state.back_bitmap_id);
     m_client_state.has_usable_bitmap = false;
+    m_client_state.front_content_rect = {};
 
     if (available_size().is_empty())
         return;
 
-    if (auto new_bitmap = Gfx::Bitmap::create_shareable(Gfx::BitmapFormat::BGRx8888, available_size())) {
-        m_client_state.front_bitmap = move(new_bitmap);
-        m_client_state.front_bitmap_id = m_client_state.next_bitmap_id++;
-        client().post_message(Messages::WebContentServer::AddBackingStore(m_client_state.front_bitmap_id, m_client_state.front_bitmap->to_shareable_bitmap()));
+    acquire_backing_store(backing_store_size, m_client_state.front_bitmap, m_client_state.front_bitmap_id);
+    acquire_backing_store(backing_store_size, m_client_state.back_bitmap, m_client_state.back_bitmap_id);
+
+    request_repaint();
+}
+
+void OutOfProcessWebView::acquire_backing_store(const Gfx::IntSize& size, RefPtr<Gfx::Bitmap>& bitmap, i32& bitmap_id)
+{
+    auto& spares = m_client_state.spare_backing_stores;
+    for (size_t i = 0; i < spares.size(); ++i) {
+        if (spares[i].bitmap->size() != size)
+            continue;
+        bitmap = spares[i].bitmap;
+        bitmap_id = spares[i].bitmap_id;
+        spares.remove(i);
+        return;
     }
 
-    if (auto new_bitmap = Gfx::Bitmap::create_shareable(Gfx::BitmapFormat::BGRx8888, available_size())) {
-        m_client_state.back_bitmap = move(new_bitmap);
-        m_client_state.back_bitmap_id = m_client_state.next_bitmap_id++;
-        client().post_message(Messages::WebContentServer::AddBackingStore(m_client_state.back_bitmap_id, m_client_state.back_bitmap->to_shareable_bitmap()));
+    if (auto new_bitmap = Gfx::Bitmap::create_shareable(Gfx::BitmapFormat::BGRx8888, size)) {
+        bitmap = move(new_bitmap);
+        bitmap_id = m_client_state.next_bitmap_id++;
+        client().post_message(Messages::WebContentServer::AddBackingStore(bitmap_id, bitmap->to_shareable_bitmap()));
     }
+}
 
-    request_repaint();
+void OutOfProcessWebView::retire_backing_store(RefPtr<Gfx::Bitmap>& bitmap, i32& bitmap_id)
+{
+    if (bitmap) {
+        auto& spares = m_client_state.spare_backing_stores;
+        spares.append({ bitmap.release_nonnull(), bitmap_id });
+        if (spares.size() > max_spare_backing_stores) {
+            client().post_message(Messages::WebContentServer::RemoveBackingStore(spares.first().bitmap_id));
+            spares.take_first();
+        }
+    }
+    bitmap_id = -1;
 }
 
 void OutOfProcessWebView::keydown_event(GUI::KeyEvent& event)
@@ -197,19 +236,33 @@ void OutOfProcessWebView::screen_rect_change_event(GUI::ScreenRectChangeEvent& e
 
 void OutOfProcessWebView::notify_server_did_paint(Badge<WebContentClient>, i32 bitmap_id)
 {
+    if (bitmap_id == m_client_state.paint_in_flight_bitmap_id)
+        m_client_state.paint_in_flight_bitmap_id = -1;
+
     if (m_client_state.back_bitmap_id == bitmap_id) {
+        auto content_rect = m_client_state.paint_in_flight_content_rect;
+        // If the viewport didn't change, the new front bitmap only differs from the old one where it was damaged.
+        bool only_damage_changed = m_client_state.has_usable_bitmap && m_client_state.front_content_rect == content_rect;
+
         m_client_state.has_usable_bitmap = true;
         swap(m_client_state.back_bitmap, m_client_state.front_bitmap);
         swap(m_client_state.back_bitmap_id, m_client_state.front_bitmap_id);
+        m_client_state.front_content_rect = content_rect;
         // We don't need the backup bitmap anymore, so drop it.
         m_backup_bitmap = nullptr;
-        update();
+
+        if (only_damage_changed)
+            update(to_widget_rect(m_client_state.paint_in_flight_damaged_content_rect.intersected(content_rect)));
+        else
+            update();
     }
+
+    send_pending_paint_request();
 }
 
-void OutOfProcessWebView::notify_server_did_invalidate_content_rect(Badge<WebContentClient>, [[maybe_unused]] const Gfx::IntRect& content_rect)
+void OutOfProcessWebView::notify_server_did_invalidate_content_rect(Badge<WebContentClient>, const Gfx::IntRect& content_rect)
 {
-    request_repaint();
+    request_repaint(content_rect);
 }
 
 void OutOfProcessWebView::notify_server_did_change_selection(Badge<WebContentClient>)
@@ -365,12 +418,32 @@ void OutOfProcessWebView::did_scroll()
 }
 
 void OutOfProcessWebView::request_repaint()
+{
+    request_repaint({ { horizontal_scrollbar().value(), vertical_scrollbar().value() }, available_size() });
+}
+
+void OutOfProcessWebView::request_repaint(const Gfx::IntRect& damaged_content_rect)
 {
     // If this widget was instantiated but not yet added to a window,
     // it won't have a back bitmap yet, so we can just skip repaint requests.
     if (!m_client_state.back_bitmap)
         return;
-    client().post_message(Messages::WebContentServer::Paint(m_client_state.back_bitmap->rect().translated(horizontal_scrollbar().value(), vertical_scrollbar().value()), m_client_state.back_bitmap_id));
+    m_client_state.pending_damaged_content_rect = m_client_state.pending_damaged_content_rect.united(damaged_content_rect);
+    send_pending_paint_request();
+}
+
+void OutOfProcessWebView::send_pending_paint_request()
+{
+    if (m_client_state.paint_in_flight_bitmap_id != -1 || !m_client_state.back_bitmap)
+        return;
+    if (m_client_state.pending_damaged_content_rect.is_empty())
+        return;
+
+    Gfx::IntRect content_rect { { horizontal_scrollbar().value(), vertical_scrollbar().value() }, available_size() };
+    m_client_state.paint_in_flight_bitmap_id = m_client_state.back_bitmap_id;
+    m_client_state.paint_in_flight_content_rect = content_rect;
+    m_client_state.paint_in_flight_damaged_content_rect = exchange(m_client_state.pending_damaged_content_rect, Gfx::IntRect {});
+    client().post_message(Messages::WebContentServer::Paint(content_rect, m_client_state.paint_in_flight_damaged_content_rect, m_client_state.back_bitmap_id));
 }
 
 WebContentClient& OutOfProcessWebView::client()
@@ -80,8 +80,13 @@ private:
     virtual void did_scroll() override;
 
     void request_repaint();
+    void request_repaint(const Gfx::IntRect& damaged_content_rect);
+    void send_pending_paint_request();
     void handle_resize();
 
+    void acquire_backing_store(const Gfx::IntSize&, RefPtr<Gfx::Bitmap>&, i32& bitmap_id);
+    void retire_backing_store(RefPtr<Gfx::Bitmap>&, i32& bitmap_id);
+
     void create_client();
     WebContentClient& client();
 
@@ -97,9 +102,26 @@ private:
         i32 back_bitmap_id { -1 };
         i32 next_bitmap_id { 0 };
         bool has_usable_bitmap { false };
+        // The front bitmap is only painted as far as the content rect it was painted with.
+        Gfx::IntRect front_content_rect;
+
+        // Only one paint request is in flight at a time, anything that gets damaged meanwhile is sent along with the next one.
+        i32 paint_in_flight_bitmap_id { -1 };
+        Gfx::IntRect paint_in_flight_content_rect;
+        Gfx::IntRect paint_in_flight_damaged_content_rect;
+        Gfx::IntRect pending_damaged_content_rect;
+
+        // Backing stores that went out of use in a resize, and are still shared with the WebContent process.
+        // Resizing back and forth picks them up again instead of allocating and sharing new ones each time.
+        struct SpareBackingStore {
+            NonnullRefPtr<Gfx::Bitmap> bitmap;
+            i32 bitmap_id { -1 };
+        };
+        Vector<SpareBackingStore> spare_backing_stores;
     } m_client_state;
 
     RefPtr<Gfx::Bitmap> m_backup_bitmap;
+    Gfx::IntSize m_backup_content_size;
 };
 
 }
@@ -99,6 +99,8 @@ void Frame::set_viewport_rect(const Gfx::IntRect& rect)
         m_size = rect.size();
         if (m_document) {
             m_document->window().dispatch_event(DOM::Event::create(UIEvents::EventNames::resize));
+            if (auto* layout_root = m_document->layout_node())
+                layout_root->set_needs_layout();
             m_document->update_layout();
         }
         did_change = true;
@@ -122,6 +124,8 @@ void Frame::set_size(const Gfx::IntSize& size)
     m_size = size;
     if (m_document) {
         m_document->window().dispatch_event(DOM::Event::create(UIEvents::EventNames::resize));
+        if (auto* layout_root = m_document->layout_node())
+            layout_root->set_needs_layout();
         m_document->update_layout();
     }
 
@@ -141,15 +145,16 @@ void Frame::set_viewport_scroll_offset(const Gfx::IntPoint& offset)
 
 void Frame::set_needs_display(const Gfx::IntRect& rect)
 {
-    if (!viewport_rect().intersects(rect))
-        return;
-
+    // The client hears about changes outside of the viewport too, as it may keep what it painted there.
     if (is_main_frame()) {
         if (m_page)
             m_page->client().page_did_invalidate(to_main_frame_rect(rect));
         return;
     }
 
+    if (!viewport_rect().intersects(rect))
+        return;
+
     if (host_element() && host_element()->layout_node())
         host_element()->layout_node()->set_needs_display();
 }
@@ -43,7 +43,6 @@ void WebContentClient::handle(const Messages::WebContentClient::DidInvalidateCon
 {
     dbgln_if(SPAM_DEBUG, "handle: WebContentClient::DidInvalidateContentRect! content_rect={}", message.content_rect());
 
-    // FIXME: Figure out a way to coalesce these messages to reduce unnecessary painting
     m_view.notify_server_did_invalidate_content_rect({}, message.content_rect());
 }
 
@@ -189,4 +188,18 @@ void WebContentClient::handle(const Messages::WebContentClient::DidSetCookie& me
     m_view.notify_server_did_set_cookie({}, message.url(), message.cookie(), static_cast<Cookie::Source>(message.source()));
 }
 
+bool WebContentClient::is_superseded_by(const IPC::Message& message, const IPC::Message& next_message) const
+{
+    if (message.endpoint_magic() != WebContentClientEndpoint::static_magic() || next_message.endpoint_magic() != WebContentClientEndpoint::static_magic())
+        return false;
+
+    // An invalidation storm only needs to make us repaint once, but we do have to repaint everything that was invalidated.
+    if (message.message_id() != Messages::WebContentClient::DidInvalidateContentRect::static_message_id()
+        || next_message.message_id() != Messages::WebContentClient::DidInvalidateContentRect::static_message_id())
+        return false;
+    auto& invalidation = static_cast<const Messages::WebContentClient::DidInvalidateContentRect&>(message);
+    auto& next_invalidation = static_cast<const Messages::WebContentClient::DidInvalidateContentRect&>(next_message);
+    return next_invalidation.content_rect().contains(invalidation.content_rect());
+}
+
 }
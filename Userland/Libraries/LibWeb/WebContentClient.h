@@ -59,6 +59,8 @@ private:
     virtual OwnPtr<Messages::WebContentClient::DidRequestCookieResponse> handle(const Messages::WebContentClient::DidRequestCookie&) override;
     virtual void handle(const Messages::WebContentClient::DidSetCookie&) override;
 
+    virtual bool is_superseded_by(const IPC::Message&, const IPC::Message& next_message) const override;
+
     OutOfProcessWebView& m_view;
 };
 
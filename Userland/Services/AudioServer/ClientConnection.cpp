@@ -41,6 +41,8 @@ ClientConnection::~ClientConnection()
 
 void ClientConnection::die()
 {
+    if (m_queue)
+        m_queue->detach();
     s_connections.remove(client_id());
 }
 
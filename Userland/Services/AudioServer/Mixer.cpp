@@ -4,13 +4,15 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/Array.h>
-#include <AK/MemoryStream.h>
 #include <AK/NumericLimits.h>
 #include <AudioServer/ClientConnection.h>
 #include <AudioServer/Mixer.h>
+#include <LibCore/ConfigFile.h>
+#include <LibCore/EventLoop.h>
 #include <pthread.h>
-#include <strings.h>
+#include <sched.h>
+#include <serenity.h>
+#include <stdio.h>
 
 namespace AudioServer {
 
@@ -28,12 +30,20 @@ Mixer::Mixer()
         return;
     }
 
+    auto config = Core::ConfigFile::get_for_system("Audio");
+    auto period_frames = config->read_num_entry("Mixer", "PeriodFrames", default_period_frames);
+    // Whole pairs of frames are mixed and converted at a time.
+    m_period_frames = clamp((size_t)period_frames, min_period_frames, max_period_frames) & ~1;
+
     pthread_mutex_init(&m_pending_mutex, nullptr);
     pthread_cond_init(&m_pending_cond, nullptr);
 
-    m_zero_filled_buffer = (u8*)malloc(4096);
-    bzero(m_zero_filled_buffer, 4096);
     m_sound_thread->start();
+
+    // A period that's mixed late is heard as a glitch, so the mixer gets to run before anything else.
+    sched_param param { .sched_priority = THREAD_PRIORITY_MAX };
+    if (sched_setparam(m_sound_thread->tid(), &param) < 0)
+        perror("sched_setparam");
 }
 
 Mixer::~Mixer()
@@ -54,62 +64,68 @@ NonnullRefPtr<BufferQueue> Mixer::create_queue(ClientConnection& client)
 void Mixer::mix()
 {
     decltype(m_pending_mixing) active_mix_queues;
+    // Interleaved left and right samples, allocated once so that mixing a period doesn't allocate.
+    Vector<float> mixed_samples;
+    mixed_samples.resize(m_period_frames * 2);
+    Vector<i16> output_samples;
+    output_samples.resize(m_period_frames * 2);
 
     for (;;) {
         if (active_mix_queues.is_empty() || m_added_queue) {
             pthread_mutex_lock(&m_pending_mutex);
-            pthread_cond_wait(&m_pending_cond, &m_pending_mutex);
+            while (active_mix_queues.is_empty() && m_pending_mixing.is_empty())
+                pthread_cond_wait(&m_pending_cond, &m_pending_mutex);
             active_mix_queues.append(move(m_pending_mixing));
-            pthread_mutex_unlock(&m_pending_mutex);
             m_added_queue = false;
+            pthread_mutex_unlock(&m_pending_mutex);
         }
 
-        active_mix_queues.remove_all_matching([&](auto& entry) { return !entry->client(); });
+        active_mix_queues.remove_all_matching([&](auto& entry) { return entry->is_detached(); });
 
-        Audio::Frame mixed_buffer[1024];
-        auto mixed_buffer_length = (int)(sizeof(mixed_buffer) / sizeof(Audio::Frame));
+        mixed_samples.span().fill(0);
 
         // Mix the buffers together into the output
         for (auto& queue : active_mix_queues) {
-            if (!queue->client()) {
-                queue->clear();
-                continue;
-            }
-
-            for (int i = 0; i < mixed_buffer_length; ++i) {
-                auto& mixed_sample = mixed_buffer[i];
-                Audio::Frame sample;
-                if (!queue->get_next_sample(sample))
-                    break;
-                mixed_sample += sample;
-            }
+            queue->mix_into(mixed_samples.data(), m_period_frames, [&](int buffer_id) {
+                // Messages to the client can only be sent from the main thread.
+                Core::EventLoop::main().post_event(*this, make<Core::DeferredInvocationEvent>([queue = NonnullRefPtr(queue), buffer_id](auto&) {
+                    queue->did_finish_playing_buffer(buffer_id);
+                }));
+                Core::EventLoop::wake();
+            });
         }
 
-        if (m_muted) {
-            m_device->write(m_zero_filled_buffer, 4096);
-        } else {
-            Array<u8, 4096> buffer;
-            OutputMemoryStream stream { buffer };
-
-            for (int i = 0; i < mixed_buffer_length; ++i) {
-                auto& mixed_sample = mixed_buffer[i];
-
-                mixed_sample.scale(m_main_volume);
-                mixed_sample.clip();
-
-                LittleEndian<i16> out_sample;
-                out_sample = mixed_sample.left * NumericLimits<i16>::max();
-                stream << out_sample;
-
-                out_sample = mixed_sample.right * NumericLimits<i16>::max();
-                stream << out_sample;
-            }
+        write_period(mixed_samples, output_samples);
+    }
+}
 
-            VERIFY(stream.is_end());
-            VERIFY(!stream.has_any_error());
-            m_device->write(stream.data(), stream.size());
+void Mixer::write_period(Span<const float> samples, Span<i16> output)
+{
+    VERIFY(samples.size() == output.size() && samples.size() % 4 == 0);
+
+    if (!m_muted) {
+        float volume = (float)m_main_volume / 100;
+        AK::SIMD::f32x4 scale = { volume, volume, volume, volume };
+        AK::SIMD::f32x4 max_sample = { 1, 1, 1, 1 };
+        AK::SIMD::f32x4 min_sample = { -1, -1, -1, -1 };
+        AK::SIMD::f32x4 i16_range = { NumericLimits<i16>::max(), NumericLimits<i16>::max(), NumericLimits<i16>::max(), NumericLimits<i16>::max() };
+
+        // Two frames at a time: scale by the main volume, clip, and convert to the device's 16-bit samples.
+        for (size_t i = 0; i < samples.size(); i += 4) {
+            AK::SIMD::f32x4 sample;
+            __builtin_memcpy(&sample, &samples[i], sizeof(sample));
+            sample *= scale;
+            sample = sample > max_sample ? max_sample : sample;
+            sample = sample < min_sample ? min_sample : sample;
+            auto converted = __builtin_convertvector(__builtin_convertvector(sample * i16_range, AK::SIMD::i32x4), AK::SIMD::i16x4);
+            __builtin_memcpy(&output[i], &converted, sizeof(converted));
         }
+    } else {
+        output.fill(0);
     }
+
+    // The device takes little-endian samples, which is what they already are in memory.
+    m_device->write((const u8*)output.data(), output.size() * sizeof(i16));
 }
 
 void Mixer::set_main_volume(int volume)
@@ -140,7 +156,57 @@ BufferQueue::BufferQueue(ClientConnection& client)
 
 void BufferQueue::enqueue(NonnullRefPtr<Audio::Buffer>&& buffer)
 {
-    m_remaining_samples += buffer->sample_count();
-    m_queue.enqueue(move(buffer));
+    VERIFY(!is_full());
+    m_remaining_samples.fetch_add(buffer->sample_count(), AK::memory_order_relaxed);
+    auto write_index = m_write_index.load(AK::memory_order_relaxed);
+    m_ring[write_index % capacity] = move(buffer);
+    m_write_index.store(write_index + 1, AK::memory_order_release);
+}
+
+void BufferQueue::clear(bool paused)
+{
+    m_discard_until_index.store(m_write_index.load(AK::memory_order_relaxed), AK::memory_order_relaxed);
+    m_clear_count.fetch_add(1, AK::memory_order_release);
+    m_played_samples.store(0, AK::memory_order_relaxed);
+    m_paused.store(paused, AK::memory_order_relaxed);
+}
+
+void BufferQueue::did_finish_playing_buffer(int buffer_id) const
+{
+    if (auto* client = m_client.ptr())
+        client->did_finish_playing_buffer({}, buffer_id);
+}
+
+RefPtr<Audio::Buffer> BufferQueue::dequeue()
+{
+    auto read_index = m_read_index.load(AK::memory_order_relaxed);
+    if (read_index == m_write_index.load(AK::memory_order_acquire))
+        return nullptr;
+    auto buffer = move(m_ring[read_index % capacity]);
+    m_read_index.store(read_index + 1, AK::memory_order_release);
+    return buffer;
+}
+
+void BufferQueue::discard_cleared_buffers()
+{
+    auto clear_count = m_clear_count.load(AK::memory_order_acquire);
+    if (clear_count == m_seen_clear_count)
+        return;
+    m_seen_clear_count = clear_count;
+
+    auto discard_until_index = m_discard_until_index.load(AK::memory_order_relaxed);
+    int discarded_samples = 0;
+    if (m_current && m_current_index < discard_until_index) {
+        discarded_samples += m_current->sample_count() - m_position;
+        m_current = nullptr;
+        m_position = 0;
+    }
+    while (m_read_index.load(AK::memory_order_relaxed) < discard_until_index) {
+        auto buffer = dequeue();
+        discarded_samples += buffer->sample_count();
+    }
+    m_remaining_samples.fetch_sub(discarded_samples, AK::memory_order_relaxed);
+    if (!m_current)
+        m_playing_buffer_id.store(-1, AK::memory_order_relaxed);
 }
 }
@@ -7,12 +7,13 @@
 #pragma once
 
 #include "ClientConnection.h"
+#include <AK/Array.h>
 #include <AK/Atomic.h>
 #include <AK/Badge.h>
 #include <AK/ByteBuffer.h>
 #include <AK/NonnullRefPtrVector.h>
-#include <AK/Queue.h>
 #include <AK/RefCounted.h>
+#include <AK/SIMD.h>
 #include <AK/WeakPtr.h>
 #include <LibAudio/Buffer.h>
 #include <LibCore/File.h>
@@ -23,72 +24,111 @@ namespace AudioServer {
 
 class ClientConnection;
 
+// The buffers a client has enqueued, waiting to be mixed. The client's connection is the only producer, and the mixer
+// thread the only consumer, so each of them only ever moves its own end of the ring, and neither takes a lock.
 class BufferQueue : public RefCounted<BufferQueue> {
 public:
+    static constexpr size_t capacity = 3;
+
     explicit BufferQueue(ClientConnection&);
     ~BufferQueue() { }
 
-    bool is_full() const { return m_queue.size() >= 3; }
+    // These are for the client's connection, on the main thread.
+    bool is_full() const { return m_write_index.load(AK::memory_order_relaxed) - m_read_index.load(AK::memory_order_acquire) >= capacity; }
     void enqueue(NonnullRefPtr<Audio::Buffer>&&);
+    void clear(bool paused = false);
+    void set_paused(bool paused) { m_paused.store(paused, AK::memory_order_relaxed); }
+    void detach() { m_detached.store(true, AK::memory_order_release); }
+    void did_finish_playing_buffer(int buffer_id) const;
+
+    int get_remaining_samples() const { return max(0, m_remaining_samples.load(AK::memory_order_relaxed)); }
+    int get_played_samples() const { return m_played_samples.load(AK::memory_order_relaxed); }
+    int get_playing_buffer() const { return m_playing_buffer_id.load(AK::memory_order_relaxed); }
+
+    // These are for the mixer thread.
+    bool is_detached() const { return m_detached.load(AK::memory_order_acquire); }
+    // Adds up to |frame_count| of the next frames onto the interleaved left and right samples, and calls
+    // |on_finished_buffer| with the ID of each buffer that played to the end. Returns how many frames were added.
+    template<typename Callback>
+    size_t mix_into(float* samples, size_t frame_count, Callback on_finished_buffer);
 
-    bool get_next_sample(Audio::Frame& sample)
-    {
-        if (m_paused)
-            return false;
+private:
+    // Takes the next buffer out of the ring, if there is one.
+    RefPtr<Audio::Buffer> dequeue();
+    void discard_cleared_buffers();
 
-        while (!m_current && !m_queue.is_empty())
-            m_current = m_queue.dequeue();
+    WeakPtr<ClientConnection> m_client;
 
-        if (!m_current)
-            return false;
+    Array<RefPtr<Audio::Buffer>, capacity> m_ring;
+    Atomic<size_t> m_write_index { 0 };
+    Atomic<size_t> m_read_index { 0 };
+    // clear() asks the mixer thread to drop everything enqueued before this write index, and the buffer it's playing.
+    Atomic<size_t> m_discard_until_index { 0 };
+    Atomic<u32> m_clear_count { 0 };
 
-        sample = m_current->samples()[m_position++];
-        --m_remaining_samples;
-        ++m_played_samples;
+    Atomic<bool> m_paused { false };
+    Atomic<bool> m_detached { false };
+    Atomic<int> m_remaining_samples { 0 };
+    Atomic<int> m_played_samples { 0 };
+    Atomic<int> m_playing_buffer_id { -1 };
 
-        if (m_position >= m_current->sample_count()) {
-            m_client->did_finish_playing_buffer({}, m_current->id());
-            m_current = nullptr;
+    // Only the mixer thread touches these.
+    RefPtr<Audio::Buffer> m_current;
+    size_t m_current_index { 0 };
+    int m_position { 0 };
+    u32 m_seen_clear_count { 0 };
+};
+
+template<typename Callback>
+size_t BufferQueue::mix_into(float* samples, size_t frame_count, Callback on_finished_buffer)
+{
+    discard_cleared_buffers();
+    if (m_paused.load(AK::memory_order_relaxed))
+        return 0;
+
+    size_t mixed_frames = 0;
+    while (mixed_frames < frame_count) {
+        if (!m_current) {
+            m_current_index = m_read_index.load(AK::memory_order_relaxed);
+            m_current = dequeue();
             m_position = 0;
+            if (!m_current)
+                break;
         }
-        return true;
-    }
 
-    ClientConnection* client() { return m_client.ptr(); }
-
-    void clear(bool paused = false)
-    {
-        m_queue.clear();
-        m_position = 0;
-        m_remaining_samples = 0;
-        m_played_samples = 0;
-        m_current = nullptr;
-        m_paused = paused;
-    }
+        auto* frames = m_current->samples() + m_position;
+        auto frames_to_mix = min(frame_count - mixed_frames, (size_t)(m_current->sample_count() - m_position));
+        auto* destination = samples + mixed_frames * 2;
+        size_t i = 0;
+        // Frames are interleaved left and right samples already, so they're added two frames at a time.
+        for (; i + 2 <= frames_to_mix; i += 2) {
+            AK::SIMD::f32x4 source;
+            AK::SIMD::f32x4 accumulated;
+            __builtin_memcpy(&source, &frames[i], sizeof(source));
+            __builtin_memcpy(&accumulated, &destination[i * 2], sizeof(accumulated));
+            accumulated += source;
+            __builtin_memcpy(&destination[i * 2], &accumulated, sizeof(accumulated));
+        }
+        for (; i < frames_to_mix; ++i) {
+            destination[i * 2] += frames[i].left;
+            destination[i * 2 + 1] += frames[i].right;
+        }
 
-    void set_paused(bool paused)
-    {
-        m_paused = paused;
-    }
+        mixed_frames += frames_to_mix;
+        m_position += frames_to_mix;
+        m_playing_buffer_id.store(m_current->id(), AK::memory_order_relaxed);
 
-    int get_remaining_samples() const { return m_remaining_samples; }
-    int get_played_samples() const { return m_played_samples; }
-    int get_playing_buffer() const
-    {
-        if (m_current)
-            return m_current->id();
-        return -1;
+        if (m_position >= m_current->sample_count()) {
+            on_finished_buffer(m_current->id());
+            m_current = nullptr;
+            m_playing_buffer_id.store(-1, AK::memory_order_relaxed);
+        }
     }
 
-private:
-    RefPtr<Audio::Buffer> m_current;
-    Queue<NonnullRefPtr<Audio::Buffer>> m_queue;
-    int m_position { 0 };
-    int m_remaining_samples { 0 };
-    int m_played_samples { 0 };
-    bool m_paused { false };
-    WeakPtr<ClientConnection> m_client;
-};
+    m_remaining_samples.fetch_sub(mixed_frames, AK::memory_order_relaxed);
+    m_played_samples.fetch_add(mixed_frames, AK::memory_order_relaxed);
+    return mixed_frames;
+}
 
 class Mixer : public Core::Object {
     C_OBJECT(Mixer)
@@ -105,6 +145,12 @@ public:
     void set_muted(bool);
 
 private:
+    // How many frames are mixed and written to the device at a time, unless /etc/Audio.ini says otherwise.
+    // Fewer frames mean less latency, but a larger share of time spent waking up to mix.
+    static constexpr size_t default_period_frames = 512;
+    static constexpr size_t min_period_frames = 64;
+    static constexpr size_t max_period_frames = 4096;
+
     Vector<NonnullRefPtr<BufferQueue>> m_pending_mixing;
     Atomic<bool> m_added_queue { false };
     pthread_mutex_t m_pending_mutex;
@@ -114,11 +160,12 @@ private:
 
     NonnullRefPtr<LibThread::Thread> m_sound_thread;
 
-    bool m_muted { false };
-    int m_main_volume { 100 };
+    Atomic<bool> m_muted { false };
+    Atomic<int> m_main_volume { 100 };
 
-    u8* m_zero_filled_buffer { nullptr };
+    size_t m_period_frames { default_period_frames };
 
     void mix();
+    void write_period(Span<const float> samples, Span<i16> output);
 };
 }
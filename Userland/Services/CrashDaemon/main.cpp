@@ -8,9 +8,11 @@
 #include <AK/MappedFile.h>
 #include <LibCompress/Gzip.h>
 #include <LibCore/File.h>
+#include <LibCore/FileStream.h>
 #include <LibCore/FileWatcher.h>
 #include <LibCoreDump/Backtrace.h>
 #include <LibCoreDump/Reader.h>
+#include <LibThread/Parallel.h>
 #include <serenity.h>
 #include <spawn.h>
 #include <sys/stat.h>
@@ -40,19 +42,26 @@ static bool compress_coredump(const String& coredump_path)
         return false;
     }
     auto coredump_file = file_or_error.value();
-    auto compressed_coredump = Compress::GzipCompressor::compress_all(coredump_file->bytes());
-    if (!compressed_coredump.has_value()) {
-        dbgln("Could not compress coredump '{}'", coredump_path);
-        return false;
-    }
     auto output_path = String::formatted("{}.gz", coredump_path);
     auto output_file_or_error = Core::File::open(output_path, Core::File::WriteOnly);
     if (output_file_or_error.is_error()) {
         dbgln("Could not open '{}' for writing: {}", output_path, output_file_or_error.error());
         return false;
     }
-    auto output_file = output_file_or_error.value();
-    if (!output_file->write(compressed_coredump.value().data(), compressed_coredump.value().size())) {
+
+    // The dump is compressed a part at a time straight into the output file, on all processors, so neither the
+    // whole compressed dump nor its compression hold things up.
+    Buffered<Core::OutputFileStream> output_stream { output_file_or_error.release_value() };
+    auto thread_count = LibThread::ThreadPool::the().thread_count();
+    Compress::ParallelGzipCompressor gzip_stream(output_stream, thread_count * 2, [](size_t count, auto& task) {
+        LibThread::run_chunks(LibThread::ThreadPool::the(), count, task);
+    });
+    gzip_stream.write_or_error(coredump_file->bytes());
+    gzip_stream.final_flush();
+    auto failed = gzip_stream.handle_any_error();
+    output_stream.flush();
+    failed |= output_stream.handle_any_error();
+    if (failed) {
         dbgln("Could not write compressed coredump '{}'", output_path);
         return false;
     }
@@ -94,7 +103,7 @@ static void launch_crash_reporter(const String& coredump_path, bool unlink_after
 
 int main()
 {
-    if (pledge("stdio rpath wpath cpath proc exec", nullptr) < 0) {
+    if (pledge("stdio rpath wpath cpath proc exec thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -110,8 +119,8 @@ int main()
             continue; // stops compress_coredump from accidentally triggering us
         dbgln("New coredump file: {}", coredump_path);
         wait_until_coredump_is_ready(coredump_path);
-        auto compressed = compress_coredump(coredump_path);
         print_backtrace(coredump_path);
+        auto compressed = compress_coredump(coredump_path);
         launch_crash_reporter(coredump_path, compressed);
     }
 }
@@ -47,28 +47,56 @@ OwnPtr<Messages::ImageDecoderServer::DecodeImageResponse> ClientConnection::hand
 
     if (!decoder->frame_count()) {
         dbgln_if(IMAGE_DECODER_DEBUG, "Could not decode image from encoded data");
-        return make<Messages::ImageDecoderServer::DecodeImageResponse>(false, 0, Vector<Gfx::ShareableBitmap> {}, Vector<u32> {});
+        return make<Messages::ImageDecoderServer::DecodeImageResponse>(0, false, 0, 0, Gfx::ShareableBitmap {}, 0);
     }
 
-    Vector<Gfx::ShareableBitmap> bitmaps;
-    Vector<u32> durations;
-    for (size_t i = 0; i < decoder->frame_count(); ++i) {
-        // FIXME: All image decoder plugins should be rewritten to return frame() instead of bitmap().
-        //        Non-animated images can simply return 1 frame.
-        Gfx::ImageFrameDescriptor frame;
-        if (decoder->is_animated()) {
-            frame = decoder->frame(i);
-        } else {
-            frame.image = decoder->bitmap();
-        }
-        if (frame.image)
-            bitmaps.append(frame.image->to_shareable_bitmap());
-        else
-            bitmaps.append(Gfx::ShareableBitmap {});
-        durations.append(frame.duration);
+    // FIXME: All image decoder plugins should be rewritten to return frame() instead of bitmap().
+    //        Non-animated images can simply return 1 frame.
+    Gfx::ImageFrameDescriptor first_frame;
+    if (decoder->is_animated()) {
+        first_frame = decoder->frame(0);
+    } else {
+        first_frame.image = decoder->bitmap();
     }
 
-    return make<Messages::ImageDecoderServer::DecodeImageResponse>(decoder->is_animated(), decoder->loop_count(), bitmaps, durations);
+    i32 image_id = 0;
+    if (decoder->is_animated() && decoder->frame_count() > 1) {
+        image_id = m_next_image_id++;
+        m_animated_images.set(image_id, { encoded_buffer, decoder });
+    }
+
+    return make<Messages::ImageDecoderServer::DecodeImageResponse>(
+        image_id,
+        decoder->is_animated(),
+        decoder->loop_count(),
+        decoder->frame_count(),
+        first_frame.image ? first_frame.image->to_shareable_bitmap() : Gfx::ShareableBitmap {},
+        first_frame.duration);
+}
+
+OwnPtr<Messages::ImageDecoderServer::DecodeFrameResponse> ClientConnection::handle(const Messages::ImageDecoderServer::DecodeFrame& message)
+{
+    auto it = m_animated_images.find(message.image_id());
+    if (it == m_animated_images.end()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "DecodeFrame: Bad image ID: {}", message.image_id());
+        return make<Messages::ImageDecoderServer::DecodeFrameResponse>(Gfx::ShareableBitmap {}, 0);
+    }
+
+    auto& decoder = it->value.decoder;
+    if (message.frame_index() >= decoder->frame_count()) {
+        dbgln_if(IMAGE_DECODER_DEBUG, "DecodeFrame: Bad frame index {} for image {}", message.frame_index(), message.image_id());
+        return make<Messages::ImageDecoderServer::DecodeFrameResponse>(Gfx::ShareableBitmap {}, 0);
+    }
+
+    auto frame = decoder->frame(message.frame_index());
+    return make<Messages::ImageDecoderServer::DecodeFrameResponse>(
+        frame.image ? frame.image->to_shareable_bitmap() : Gfx::ShareableBitmap {},
+        frame.duration);
+}
+
+void ClientConnection::handle(const Messages::ImageDecoderServer::ForgetImage& message)
+{
+    m_animated_images.remove(message.image_id());
 }
 
 }
@@ -10,6 +10,8 @@
 #include <ImageDecoder/Forward.h>
 #include <ImageDecoder/ImageDecoderClientEndpoint.h>
 #include <ImageDecoder/ImageDecoderServerEndpoint.h>
+#include <LibCore/AnonymousBuffer.h>
+#include <LibGfx/ImageDecoder.h>
 #include <LibIPC/ClientConnection.h>
 #include <LibWeb/Forward.h>
 
@@ -29,6 +31,17 @@ public:
 private:
     virtual OwnPtr<Messages::ImageDecoderServer::GreetResponse> handle(const Messages::ImageDecoderServer::Greet&) override;
     virtual OwnPtr<Messages::ImageDecoderServer::DecodeImageResponse> handle(const Messages::ImageDecoderServer::DecodeImage&) override;
+    virtual OwnPtr<Messages::ImageDecoderServer::DecodeFrameResponse> handle(const Messages::ImageDecoderServer::DecodeFrame&) override;
+    virtual void handle(const Messages::ImageDecoderServer::ForgetImage&) override;
+
+    // Animated images are kept around after their first frame has been decoded,
+    // so the client can ask for the rest of the frames as it needs them.
+    struct AnimatedImage {
+        Core::AnonymousBuffer encoded_buffer;
+        NonnullRefPtr<Gfx::ImageDecoder> decoder;
+    };
+    HashMap<i32, AnimatedImage> m_animated_images;
+    i32 m_next_image_id { 1 };
 };
 
 }
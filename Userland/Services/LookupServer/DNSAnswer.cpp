@@ -27,4 +27,12 @@ bool DNSAnswer::has_expired() const
     return time(nullptr) >= m_expiration_time;
 }
 
+u32 DNSAnswer::remaining_ttl() const
+{
+    auto now = time(nullptr);
+    if (now >= m_expiration_time)
+        return 0;
+    return min<time_t>(m_expiration_time - now, m_ttl);
+}
+
 }
@@ -20,6 +20,7 @@ public:
     u16 type() const { return m_type; }
     u16 class_code() const { return m_class_code; }
     u32 ttl() const { return m_ttl; }
+    u32 remaining_ttl() const;
     const String& record_data() const { return m_record_data; }
 
     bool has_expired() const;
@@ -116,10 +116,6 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
     packet.m_query_or_response = header.is_response();
     packet.m_code = header.response_code();
 
-    // FIXME: Should we parse further in this case?
-    if (packet.code() != Code::NOERROR)
-        return packet;
-
     size_t offset = sizeof(DNSPacketHeader);
 
     for (u16 i = 0; i < header.question_count(); i++) {
@@ -135,6 +131,10 @@ Optional<DNSPacket> DNSPacket::from_raw_packet(const u8* raw_data, size_t raw_si
         dbgln_if(LOOKUPSERVER_DEBUG, "Question #{}: name=_{}_, type={}, class={}", i, question.name(), question.record_type(), question.class_code());
     }
 
+    // FIXME: Should we parse further in this case?
+    if (packet.code() != Code::NOERROR)
+        return packet;
+
     for (u16 i = 0; i < header.answer_count(); ++i) {
         auto name = DNSName::parse(raw_data, offset, raw_size);
 
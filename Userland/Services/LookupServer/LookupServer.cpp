@@ -13,12 +13,15 @@
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 #include <LibCore/ConfigFile.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/File.h>
 #include <LibCore/LocalServer.h>
 #include <LibCore/LocalSocket.h>
 #include <LibCore/UDPSocket.h>
+#include <errno.h>
+#include <poll.h>
 #include <stdio.h>
-#include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
 namespace LookupServer {
@@ -111,6 +114,15 @@ void LookupServer::load_etc_hosts()
     }
 }
 
+// How many names we keep in the lookup cache before evicting the least recently used one.
+static constexpr size_t max_cached_names = 256;
+
+// We don't parse the SOA record in the authority section yet, so "no such name" answers are remembered for a fixed time.
+static constexpr time_t negative_ttl = 60;
+
+// A cached answer that has been asked for this many times gets refreshed in the background when it's about to expire.
+static constexpr u32 prefetch_hit_threshold = 2;
+
 Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, unsigned short record_type)
 {
 #if LOOKUPSERVER_DEBUG
@@ -118,12 +130,12 @@ Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, unsigned short recor
 #endif
 
     Vector<DNSAnswer> answers;
-    auto add_answer = [&](const DNSAnswer& answer) {
+    auto add_answer = [&](const DNSAnswer& answer, u32 ttl) {
         DNSAnswer answer_with_original_case {
             name,
             answer.type(),
             answer.class_code(),
-            answer.ttl(),
+            ttl,
             answer.record_data()
         };
         answers.append(answer_with_original_case);
@@ -133,60 +145,62 @@ Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, unsigned short recor
     if (auto local_answers = m_etc_hosts.get(name); local_answers.has_value()) {
         for (auto& answer : local_answers.value()) {
             if (answer.type() == record_type)
-                add_answer(answer);
+                add_answer(answer, answer.ttl());
         }
         if (!answers.is_empty())
             return answers;
     }
 
     // Second, try our cache.
-    if (auto cached_answers = m_lookup_cache.get(name); cached_answers.has_value()) {
-        for (auto& answer : cached_answers.value()) {
-            // TODO: Actually remove expired answers from the cache.
-            if (answer.type() == record_type && !answer.has_expired()) {
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end()) {
+        auto& cached_name = it->value;
+        cached_name.last_used = ++m_cache_use_counter;
+        cached_name.answers.remove_all_matching([](auto& answer) { return answer.has_expired(); });
+
+        bool is_about_to_expire = false;
+        for (auto& answer : cached_name.answers) {
+            if (answer.type() != record_type)
+                continue;
 #if LOOKUPSERVER_DEBUG
-                dbgln("Cache hit: {} -> {}", name.as_string(), answer.record_data());
+            dbgln("Cache hit: {} -> {}", name.as_string(), answer.record_data());
 #endif
-                add_answer(answer);
-            }
+            auto remaining_ttl = answer.remaining_ttl();
+            if (remaining_ttl <= answer.ttl() / 10)
+                is_about_to_expire = true;
+            add_answer(answer, remaining_ttl);
         }
-        if (!answers.is_empty())
+        if (!answers.is_empty()) {
+            if (++cached_name.hit_count >= prefetch_hit_threshold && is_about_to_expire && !cached_name.prefetch_scheduled) {
+                cached_name.prefetch_scheduled = true;
+                schedule_prefetch(name, record_type);
+            }
             return answers;
-    }
+        }
 
-    // Third, ask the upstream nameservers.
-    for (auto& nameserver : m_nameservers) {
+        if (auto negative_expiration_time = cached_name.negative_expiration_times.get(record_type); negative_expiration_time.has_value()) {
+            if (time(nullptr) < negative_expiration_time.value()) {
 #if LOOKUPSERVER_DEBUG
-        dbgln("Doing lookup using nameserver '{}'", nameserver);
+                dbgln("Negative cache hit: {}", name.as_string());
 #endif
-        bool did_get_response = false;
-        int retries = 3;
-        Vector<DNSAnswer> upstream_answers;
-        do {
-            upstream_answers = lookup(name, nameserver, did_get_response, record_type);
-            if (did_get_response)
-                break;
-        } while (--retries);
-        if (!upstream_answers.is_empty()) {
-            for (auto& answer : upstream_answers)
-                add_answer(answer);
-            break;
-        } else {
-            if (!did_get_response)
-                dbgln("Never got a response from '{}', trying next nameserver", nameserver);
-            else
-                dbgln("Received response from '{}' but no result(s), trying next nameserver", nameserver);
+                return {};
+            }
+            cached_name.negative_expiration_times.remove(record_type);
         }
     }
-    if (answers.is_empty()) {
+
+    // Third, ask the upstream nameservers.
+    auto upstream_answers = lookup_upstream(name, record_type);
+    if (!upstream_answers.has_value()) {
         dbgln("Tried all nameservers but never got a response :(");
         return {};
     }
 
+    for (auto& answer : upstream_answers.value())
+        add_answer(answer, answer.ttl());
     return answers;
 }
 
-Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, const String& nameserver, bool& did_get_response, unsigned short record_type, ShouldRandomizeCase should_randomize_case)
+static DNSPacket make_request(const DNSName& name, unsigned short record_type, ShouldRandomizeCase should_randomize_case)
 {
     DNSPacket request;
     request.set_is_query();
@@ -195,57 +209,30 @@ Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, const String& namese
     if (should_randomize_case == ShouldRandomizeCase::Yes)
         name_in_question.randomize_case();
     request.add_question({ name_in_question, record_type, C_IN });
+    return request;
+}
 
-    auto buffer = request.to_byte_buffer();
-
-    auto udp_socket = Core::UDPSocket::construct();
-    udp_socket->set_blocking(true);
-
-    struct timeval timeout {
-        1, 0
-    };
-
-    int rc = setsockopt(udp_socket->fd(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
-    if (rc < 0) {
-        perror("setsockopt(SOL_SOCKET, SO_RCVTIMEO)");
-        return {};
-    }
-
-    if (!udp_socket->connect(nameserver, 53))
-        return {};
-
-    if (!udp_socket->write(buffer))
-        return {};
-
-    u8 response_buffer[4096];
-    int nrecv = udp_socket->read(response_buffer, sizeof(response_buffer));
-    if (nrecv == 0)
-        return {};
-
-    did_get_response = true;
-
-    auto o_response = DNSPacket::from_raw_packet(response_buffer, nrecv);
-    if (!o_response.has_value())
-        return {};
-
-    auto& response = o_response.value();
+enum class ResponseKind {
+    Invalid,
+    Refused,
+    Failure,
+    Negative,
+    Answers,
+};
 
+static ResponseKind classify_response(const DNSPacket& request, const DNSPacket& response)
+{
     if (response.id() != request.id()) {
         dbgln("LookupServer: ID mismatch ({} vs {}) :(", response.id(), request.id());
-        return {};
+        return ResponseKind::Invalid;
     }
 
-    if (response.code() == DNSPacket::Code::REFUSED) {
-        if (should_randomize_case == ShouldRandomizeCase::Yes) {
-            // Retry with 0x20 case randomization turned off.
-            return lookup(name, nameserver, did_get_response, record_type, ShouldRandomizeCase::No);
-        }
-        return {};
-    }
+    if (response.code() == DNSPacket::Code::REFUSED)
+        return ResponseKind::Refused;
 
     if (response.question_count() != request.question_count()) {
         dbgln("LookupServer: Question count ({} vs {}) :(", response.question_count(), request.question_count());
-        return {};
+        return ResponseKind::Invalid;
     }
 
     // Verify the questions in our request and in their response match exactly, including case.
@@ -259,24 +246,202 @@ Vector<DNSAnswer> LookupServer::lookup(const DNSName& name, const String& namese
             dbgln("Request and response questions do not match");
             dbgln("   Request: name=_{}_, type={}, class={}", request_question.name().as_string(), response_question.record_type(), response_question.class_code());
             dbgln("  Response: name=_{}_, type={}, class={}", response_question.name().as_string(), response_question.record_type(), response_question.class_code());
-            return {};
+            return ResponseKind::Invalid;
         }
     }
 
-    if (response.answer_count() < 1) {
-        dbgln("LookupServer: No answers :(");
-        return {};
-    }
+    if (response.code() == DNSPacket::Code::NXDOMAIN)
+        return ResponseKind::Negative;
+    if (response.code() != DNSPacket::Code::NOERROR)
+        return ResponseKind::Failure;
 
-    Vector<DNSAnswer, 8> answers;
+    auto record_type = request.questions()[0].record_type();
     for (auto& answer : response.answers()) {
-        put_in_cache(answer);
-        if (answer.type() != record_type)
+        if (answer.type() == record_type)
+            return ResponseKind::Answers;
+    }
+
+    dbgln("LookupServer: No answers :(");
+    return ResponseKind::Negative;
+}
+
+Optional<Vector<DNSAnswer>> LookupServer::lookup_upstream(const DNSName& name, unsigned short record_type)
+{
+    // Every nameserver is asked at the same time, and the first one to come back with answers wins.
+    // Nameservers that haven't responded within a second are asked again, up to three times in total.
+    static constexpr int attempts = 3;
+    static constexpr int attempt_timeout_ms = 1000;
+
+    struct PendingQuery {
+        String nameserver;
+        NonnullRefPtr<Core::UDPSocket> socket;
+        DNSPacket request;
+        ShouldRandomizeCase should_randomize_case { ShouldRandomizeCase::Yes };
+        bool did_get_response { false };
+        bool is_done { false };
+    };
+
+    Vector<PendingQuery> queries;
+    for (auto& nameserver : m_nameservers) {
+        auto udp_socket = Core::UDPSocket::construct();
+        if (!udp_socket->connect(nameserver, 53))
             continue;
-        answers.append(answer);
+        queries.append({ nameserver, move(udp_socket), {} });
     }
 
-    return answers;
+    auto send_query = [&](PendingQuery& query) {
+#if LOOKUPSERVER_DEBUG
+        dbgln("Doing lookup using nameserver '{}'", query.nameserver);
+#endif
+        query.request = make_request(name, record_type, query.should_randomize_case);
+        if (!query.socket->write(query.request.to_byte_buffer()))
+            query.is_done = true;
+    };
+
+    bool got_negative_response = false;
+    for (int attempt = 0; attempt < attempts; ++attempt) {
+        for (auto& query : queries) {
+            if (!query.is_done)
+                send_query(query);
+        }
+
+        Core::ElapsedTimer timer;
+        timer.start();
+        for (;;) {
+            Vector<pollfd> poll_fds;
+            Vector<PendingQuery*> polled_queries;
+            for (auto& query : queries) {
+                if (query.is_done)
+                    continue;
+                poll_fds.append({ query.socket->fd(), POLLIN, 0 });
+                polled_queries.append(&query);
+            }
+            if (poll_fds.is_empty())
+                break;
+
+            int timeout_ms = attempt_timeout_ms - timer.elapsed();
+            if (timeout_ms <= 0)
+                break;
+            int rc = poll(poll_fds.data(), poll_fds.size(), timeout_ms);
+            if (rc < 0) {
+                if (errno == EINTR)
+                    continue;
+                perror("poll");
+                return {};
+            }
+            if (rc == 0)
+                break;
+
+            for (size_t i = 0; i < poll_fds.size(); ++i) {
+                if (!(poll_fds[i].revents & POLLIN))
+                    continue;
+                auto& query = *polled_queries[i];
+
+                u8 response_buffer[4096];
+                int nrecv = query.socket->read(response_buffer, sizeof(response_buffer));
+                if (nrecv <= 0)
+                    continue;
+                query.did_get_response = true;
+
+                auto o_response = DNSPacket::from_raw_packet(response_buffer, nrecv);
+                if (!o_response.has_value())
+                    continue;
+                auto& response = o_response.value();
+
+                switch (classify_response(query.request, response)) {
+                case ResponseKind::Invalid:
+                    // Keep waiting, the real response may still be on its way.
+                    break;
+                case ResponseKind::Refused:
+                    if (query.should_randomize_case == ShouldRandomizeCase::Yes) {
+                        // Retry with 0x20 case randomization turned off.
+                        query.should_randomize_case = ShouldRandomizeCase::No;
+                        send_query(query);
+                    } else {
+                        query.is_done = true;
+                    }
+                    break;
+                case ResponseKind::Failure:
+                    query.is_done = true;
+                    break;
+                case ResponseKind::Negative:
+                    dbgln("Received response from '{}' but no result(s)", query.nameserver);
+                    got_negative_response = true;
+                    query.is_done = true;
+                    break;
+                case ResponseKind::Answers: {
+                    Vector<DNSAnswer> answers;
+                    for (auto& answer : response.answers()) {
+                        put_in_cache(answer);
+                        if (answer.type() == record_type)
+                            answers.append(answer);
+                    }
+                    return answers;
+                }
+                }
+            }
+        }
+
+        // Once a nameserver has told us the name doesn't exist, don't keep waiting on the slow ones.
+        if (got_negative_response)
+            break;
+    }
+
+    for (auto& query : queries) {
+        if (!query.did_get_response)
+            dbgln("Never got a response from '{}'", query.nameserver);
+    }
+
+    if (!got_negative_response)
+        return {};
+
+    put_negative_in_cache(name, record_type);
+    return Vector<DNSAnswer> {};
+}
+
+LookupServer::CachedName& LookupServer::ensure_cache_entry(const DNSName& name)
+{
+    if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end())
+        return it->value;
+
+    // Prevent the cache from growing too big, by first dropping whatever has expired and then the least recently used name.
+    if (m_lookup_cache.size() >= max_cached_names)
+        purge_expired_cache_entries();
+    if (m_lookup_cache.size() >= max_cached_names) {
+        auto least_recently_used = m_lookup_cache.begin();
+        for (auto it = m_lookup_cache.begin(); it != m_lookup_cache.end(); ++it) {
+            if (it->value.last_used < least_recently_used->value.last_used)
+                least_recently_used = it;
+        }
+        m_lookup_cache.remove(least_recently_used);
+    }
+
+    auto& cached_name = m_lookup_cache.ensure(name);
+    cached_name.last_used = ++m_cache_use_counter;
+    return cached_name;
+}
+
+void LookupServer::purge_expired_cache_entries()
+{
+    auto now = time(nullptr);
+    Vector<DNSName> names_to_remove;
+    for (auto& it : m_lookup_cache) {
+        auto& cached_name = it.value;
+        cached_name.answers.remove_all_matching([](auto& answer) { return answer.has_expired(); });
+
+        Vector<u16> expired_record_types;
+        for (auto& negative : cached_name.negative_expiration_times) {
+            if (now >= negative.value)
+                expired_record_types.append(negative.key);
+        }
+        for (auto record_type : expired_record_types)
+            cached_name.negative_expiration_times.remove(record_type);
+
+        if (cached_name.answers.is_empty() && cached_name.negative_expiration_times.is_empty())
+            names_to_remove.append(it.key);
+    }
+    for (auto& name : names_to_remove)
+        m_lookup_cache.remove(name);
 }
 
 void LookupServer::put_in_cache(const DNSAnswer& answer)
@@ -284,16 +449,33 @@ void LookupServer::put_in_cache(const DNSAnswer& answer)
     if (answer.has_expired())
         return;
 
-    // Prevent the cache from growing too big.
-    // TODO: Evict least used entries.
-    if (m_lookup_cache.size() >= 256)
-        m_lookup_cache.remove(m_lookup_cache.begin());
+    auto& cached_name = ensure_cache_entry(answer.name());
+    cached_name.answers.remove_all_matching([&](auto& cached_answer) {
+        return cached_answer.type() == answer.type() && cached_answer.record_data() == answer.record_data();
+    });
+    cached_name.answers.append(answer);
+    cached_name.negative_expiration_times.remove(answer.type());
+}
 
-    auto it = m_lookup_cache.find(answer.name());
-    if (it == m_lookup_cache.end())
-        m_lookup_cache.set(answer.name(), { answer });
-    else
-        it->value.append(answer);
+void LookupServer::put_negative_in_cache(const DNSName& name, unsigned short record_type)
+{
+    auto& cached_name = ensure_cache_entry(name);
+    cached_name.negative_expiration_times.set(record_type, time(nullptr) + negative_ttl);
+}
+
+void LookupServer::schedule_prefetch(const DNSName& name, unsigned short record_type)
+{
+    // Refresh the answer once the current request has been answered, so a hot name never has to wait on a cache miss.
+    deferred_invoke([this, name, record_type](auto&) {
+#if LOOKUPSERVER_DEBUG
+        dbgln("Prefetching '{}'", name.as_string());
+#endif
+        lookup_upstream(name, record_type);
+        if (auto it = m_lookup_cache.find(name); it != m_lookup_cache.end()) {
+            it->value.prefetch_scheduled = false;
+            it->value.hit_count = 0;
+        }
+    });
 }
 
 }
@@ -25,16 +25,31 @@ public:
 private:
     LookupServer();
 
+    struct CachedName {
+        Vector<DNSAnswer> answers;
+        // Record types that the upstream nameservers said don't exist for this name, and when we stop believing them.
+        HashMap<u16, time_t> negative_expiration_times;
+        u64 last_used { 0 };
+        u32 hit_count { 0 };
+        bool prefetch_scheduled { false };
+    };
+
     void load_etc_hosts();
     void put_in_cache(const DNSAnswer&);
+    void put_negative_in_cache(const DNSName&, unsigned short record_type);
+    CachedName& ensure_cache_entry(const DNSName&);
+    void purge_expired_cache_entries();
+    void schedule_prefetch(const DNSName&, unsigned short record_type);
 
-    Vector<DNSAnswer> lookup(const DNSName& hostname, const String& nameserver, bool& did_get_response, unsigned short record_type, ShouldRandomizeCase = ShouldRandomizeCase::Yes);
+    // Returns an empty vector if the nameservers say there is no such record, and nothing if none of them answered.
+    Optional<Vector<DNSAnswer>> lookup_upstream(const DNSName& hostname, unsigned short record_type);
 
     RefPtr<Core::LocalServer> m_local_server;
     RefPtr<DNSServer> m_dns_server;
     Vector<String> m_nameservers;
     HashMap<DNSName, Vector<DNSAnswer>, DNSName::Traits> m_etc_hosts;
-    HashMap<DNSName, Vector<DNSAnswer>, DNSName::Traits> m_lookup_cache;
+    HashMap<DNSName, CachedName, DNSName::Traits> m_lookup_cache;
+    u64 m_cache_use_counter { 0 };
 };
 
 }
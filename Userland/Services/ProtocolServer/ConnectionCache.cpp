@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, The SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <ProtocolServer/ConnectionCache.h>
+
+namespace ProtocolServer::ConnectionCache {
+
+CacheType<Core::TCPSocket> g_tcp_connection_cache;
+CacheType<TLS::TLSv12> g_tls_connection_cache;
+HashMap<ConnectionKey, NonnullOwnPtrVector<MultiplexedConnection>> g_http2_connection_cache;
+HashMap<ConnectionKey, TLS::Session> g_tls_session_cache;
+
+void remember_tls_session(const ConnectionKey& key, const TLS::TLSv12& socket)
+{
+    // A resumed session is the one we already know about.
+    if (socket.is_resumed_session())
+        return;
+    if (auto session = socket.session(); session.has_value())
+        g_tls_session_cache.set(key, session.release_value());
+}
+
+static void remove_multiplexed_connection_later_if_unused(const ConnectionKey& key, HTTP::Http2Connection& connection)
+{
+    // We usually get here from one of the connection's own callbacks, so don't destroy it just yet.
+    connection.deferred_invoke([key, connection = &connection](auto&) {
+        if (!connection->is_closed() && connection->stream_count() != 0)
+            return;
+        auto it = g_http2_connection_cache.find(key);
+        if (it == g_http2_connection_cache.end())
+            return;
+        auto& connections = it->value;
+        connections.remove_first_matching([&](auto& entry) { return entry->connection.ptr() == connection; });
+        if (connections.is_empty())
+            g_http2_connection_cache.remove(it);
+    });
+}
+
+bool start_job_on_multiplexed_connection(const ConnectionKey& key, HTTP::HttpsJob& job)
+{
+    auto it = g_http2_connection_cache.find(key);
+    if (it == g_http2_connection_cache.end())
+        return false;
+    for (auto& entry : it->value) {
+        if (!entry.connection->can_open_stream())
+            continue;
+        if (entry.removal_timer)
+            entry.removal_timer->stop();
+        job.start(entry.connection);
+        return true;
+    }
+    return false;
+}
+
+void did_establish_multiplexed_connection(const ConnectionKey& key, HTTP::HttpsJob& job, NonnullRefPtr<HTTP::Http2Connection> connection)
+{
+    auto& entries = g_http2_connection_cache.ensure(key);
+    entries.append(make<MultiplexedConnection>(connection));
+    auto& entry = entries.last();
+
+    connection->on_idle = [key, entry = &entry] {
+        if (!entry->removal_timer) {
+            entry->removal_timer = Core::Timer::create_single_shot(idle_connection_timeout_ms, [key, connection = entry->connection.ptr()] {
+                remove_multiplexed_connection_later_if_unused(key, *connection);
+            });
+        }
+        entry->removal_timer->restart();
+    };
+    connection->on_closed = [key, connection = connection.ptr()] {
+        remove_multiplexed_connection_later_if_unused(key, *connection);
+    };
+
+    // The TLS connection the job came in on now belongs to the HTTP/2 one, and whatever was
+    // queued up behind the job can come along.
+    Vector<Connection<TLS::TLSv12>::JobData> queue;
+    if (auto it = g_tls_connection_cache.find(key); it != g_tls_connection_cache.end()) {
+        for (auto& tls_connection : it->value) {
+            if (tls_connection.current_job.ptr() != &job)
+                continue;
+            queue = move(tls_connection.request_queue);
+            remember_tls_session(key, *tls_connection.socket);
+            remove_connection(g_tls_connection_cache, key, *tls_connection.socket);
+            break;
+        }
+    }
+    for (auto& job_data : queue)
+        enqueue_job(g_tls_connection_cache, key, move(job_data));
+}
+
+}
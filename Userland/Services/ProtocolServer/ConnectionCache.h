@@ -0,0 +1,297 @@
+/*
+ * Copyright (c) 2021, The SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/String.h>
+#include <AK/Traits.h>
+#include <AK/URL.h>
+#include <AK/Vector.h>
+#include <LibCore/NetworkJob.h>
+#include <LibCore/TCPSocket.h>
+#include <LibCore/Timer.h>
+#include <LibHTTP/Http2Connection.h>
+#include <LibHTTP/HttpsJob.h>
+#include <LibTLS/TLSv12.h>
+
+namespace ProtocolServer::ConnectionCache {
+
+// HTTP/1.1 connections are kept open between downloads, so that a page pulling in lots of
+// resources from one host doesn't pay for a TCP (and possibly TLS) handshake every time.
+// Each connection runs one request at a time; there's no pipelining, as too many servers
+// and proxies get it wrong.
+// HTTPS connections offer HTTP/2 as well, and once a server takes us up on it, every download
+// to that host becomes a stream on that one connection instead.
+
+struct ConnectionKey {
+    String hostname;
+    u16 port { 0 };
+
+    bool operator==(const ConnectionKey& other) const { return hostname == other.hostname && port == other.port; }
+};
+
+}
+
+template<>
+struct AK::Traits<ProtocolServer::ConnectionCache::ConnectionKey> : public AK::GenericTraits<ProtocolServer::ConnectionCache::ConnectionKey> {
+    static u32 hash(const ProtocolServer::ConnectionCache::ConnectionKey& key) { return pair_int_hash(key.hostname.hash(), key.port); }
+};
+
+namespace ProtocolServer::ConnectionCache {
+
+constexpr size_t max_connections_per_host = 6;
+constexpr int idle_connection_timeout_ms = 10'000;
+
+template<typename SocketType>
+struct Connection {
+    struct JobData {
+        NonnullRefPtr<Core::NetworkJob> job;
+        Function<void(NonnullRefPtr<SocketType>)> start;
+    };
+
+    explicit Connection(NonnullRefPtr<SocketType> socket)
+        : socket(move(socket))
+    {
+    }
+
+    NonnullRefPtr<SocketType> socket;
+    RefPtr<Core::NetworkJob> current_job;
+    // Also set while we wait to hand the connection over to the next job.
+    bool is_busy { false };
+    Vector<JobData> request_queue;
+    RefPtr<Core::Timer> removal_timer;
+};
+
+template<typename SocketType>
+using CacheType = HashMap<ConnectionKey, NonnullOwnPtrVector<Connection<SocketType>>>;
+
+extern CacheType<Core::TCPSocket> g_tcp_connection_cache;
+extern CacheType<TLS::TLSv12> g_tls_connection_cache;
+
+struct MultiplexedConnection {
+    explicit MultiplexedConnection(NonnullRefPtr<HTTP::Http2Connection> connection)
+        : connection(move(connection))
+    {
+    }
+
+    NonnullRefPtr<HTTP::Http2Connection> connection;
+    RefPtr<Core::Timer> removal_timer;
+};
+
+extern HashMap<ConnectionKey, NonnullOwnPtrVector<MultiplexedConnection>> g_http2_connection_cache;
+
+// TLS sessions outlive their connections, so that the next connection to the same host can
+// resume one instead of going through the whole key exchange and certificate checks again.
+extern HashMap<ConnectionKey, TLS::Session> g_tls_session_cache;
+
+void remember_tls_session(const ConnectionKey&, const TLS::TLSv12&);
+
+// Returns false if there's no HTTP/2 connection to the host with room for another stream.
+bool start_job_on_multiplexed_connection(const ConnectionKey&, HTTP::HttpsJob&);
+void did_establish_multiplexed_connection(const ConnectionKey&, HTTP::HttpsJob&, NonnullRefPtr<HTTP::Http2Connection>);
+
+template<typename Callback>
+void watch_idle_connection(Core::TCPSocket& socket, Callback on_closed)
+{
+    socket.on_ready_to_read = move(on_closed);
+}
+
+template<typename Callback>
+void watch_idle_connection(TLS::TLSv12& socket, Callback on_closed)
+{
+    socket.on_tls_ready_to_read = [on_closed](auto&) { on_closed(); };
+    socket.on_tls_error = [on_closed](auto) { on_closed(); };
+    socket.on_tls_finished = move(on_closed);
+}
+
+inline void stop_watching_idle_connection(Core::TCPSocket& socket)
+{
+    socket.on_ready_to_read = nullptr;
+}
+
+inline void stop_watching_idle_connection(TLS::TLSv12& socket)
+{
+    socket.on_tls_ready_to_read = nullptr;
+    socket.on_tls_error = nullptr;
+    socket.on_tls_finished = nullptr;
+}
+
+template<typename SocketType>
+Connection<SocketType>* find_connection(CacheType<SocketType>& cache, const ConnectionKey& key, const SocketType& socket)
+{
+    auto it = cache.find(key);
+    if (it == cache.end())
+        return nullptr;
+    for (auto& connection : it->value) {
+        if (connection.socket.ptr() == &socket)
+            return &connection;
+    }
+    return nullptr;
+}
+
+template<typename SocketType>
+void remove_connection(CacheType<SocketType>& cache, const ConnectionKey& key, const SocketType& socket)
+{
+    auto it = cache.find(key);
+    if (it == cache.end())
+        return;
+    auto& connections = it->value;
+    connections.remove_first_matching([&](auto& connection) { return connection->socket.ptr() == &socket; });
+    if (connections.is_empty())
+        cache.remove(it);
+}
+
+template<typename SocketType>
+void remove_connection_later_if_idle(CacheType<SocketType>& cache, const ConnectionKey& key, SocketType& socket)
+{
+    // We usually get here from one of the socket's own callbacks, so don't destroy it just yet.
+    socket.deferred_invoke([&cache, key, socket = &socket](auto&) {
+        auto* connection = find_connection(cache, key, *socket);
+        if (connection && !connection->is_busy)
+            remove_connection(cache, key, *socket);
+    });
+}
+
+template<typename SocketType>
+void enqueue_job(CacheType<SocketType>&, const ConnectionKey&, typename Connection<SocketType>::JobData);
+
+template<typename SocketType>
+void run_next_job(CacheType<SocketType>& cache, const ConnectionKey& key, Connection<SocketType>& connection)
+{
+    while (!connection.request_queue.is_empty() && connection.request_queue.first().job->is_cancelled())
+        connection.request_queue.take_first();
+
+    if (connection.request_queue.is_empty()) {
+        connection.is_busy = false;
+        watch_idle_connection(*connection.socket, [&cache, key, socket = connection.socket.ptr()] {
+            remove_connection_later_if_idle(cache, key, *socket);
+        });
+        if (!connection.removal_timer) {
+            connection.removal_timer = Core::Timer::create_single_shot(idle_connection_timeout_ms, [&cache, key, socket = connection.socket.ptr()] {
+                remove_connection_later_if_idle(cache, key, *socket);
+            });
+        }
+        connection.removal_timer->restart();
+        return;
+    }
+
+    auto job_data = connection.request_queue.take_first();
+    if (connection.removal_timer)
+        connection.removal_timer->stop();
+    stop_watching_idle_connection(*connection.socket);
+
+    // The server may have hung up on us while we weren't looking.
+    if (connection.socket->is_connected() && (connection.socket->eof() || connection.socket->can_read())) {
+        auto queue = move(connection.request_queue);
+        remove_connection(cache, key, *connection.socket);
+        enqueue_job(cache, key, move(job_data));
+        for (auto& queued_job_data : queue)
+            enqueue_job(cache, key, move(queued_job_data));
+        return;
+    }
+
+    connection.is_busy = true;
+    connection.current_job = job_data.job;
+    job_data.start(connection.socket);
+}
+
+template<typename SocketType>
+void enqueue_job(CacheType<SocketType>& cache, const ConnectionKey& key, typename Connection<SocketType>::JobData job_data)
+{
+    if constexpr (IsSame<SocketType, TLS::TLSv12>) {
+        if (!job_data.job->is_cancelled() && start_job_on_multiplexed_connection(key, static_cast<HTTP::HttpsJob&>(*job_data.job)))
+            return;
+    }
+
+    auto& connections = cache.ensure(key);
+
+    for (auto& connection : connections) {
+        if (!connection.is_busy) {
+            connection.request_queue.append(move(job_data));
+            run_next_job(cache, key, connection);
+            return;
+        }
+    }
+
+    if (connections.size() < max_connections_per_host) {
+        auto socket = SocketType::construct(nullptr);
+        if constexpr (IsSame<SocketType, TLS::TLSv12>) {
+            if (auto session = g_tls_session_cache.get(key); session.has_value())
+                socket->set_session_to_resume(session.release_value());
+        }
+        connections.append(make<Connection<SocketType>>(move(socket)));
+        auto& connection = connections.last();
+        connection.request_queue.append(move(job_data));
+        run_next_job(cache, key, connection);
+        return;
+    }
+
+    auto* least_loaded_connection = &connections.first();
+    for (auto& connection : connections) {
+        if (connection.request_queue.size() < least_loaded_connection->request_queue.size())
+            least_loaded_connection = &connection;
+    }
+    least_loaded_connection->request_queue.append(move(job_data));
+}
+
+template<typename SocketType, typename JobType>
+void start_job(CacheType<SocketType>& cache, JobType& job)
+{
+    ConnectionKey key { job.url().host(), job.url().port() };
+    if constexpr (requires { job.on_http2_connection_established; }) {
+        job.on_http2_connection_established = [key, job = &job](auto connection) {
+            did_establish_multiplexed_connection(key, *job, move(connection));
+        };
+    }
+    enqueue_job(cache, key, { NonnullRefPtr<Core::NetworkJob>(job), [job = &job](NonnullRefPtr<SocketType> socket) { job->start(move(socket)); } });
+}
+
+// Must be called before the job shuts down, as that's when it lets go of its socket.
+template<typename SocketType, typename JobType>
+void request_did_finish(CacheType<SocketType>& cache, JobType& job, bool can_reuse_connection)
+{
+    ConnectionKey key { job.url().host(), job.url().port() };
+    auto it = cache.find(key);
+    if (it == cache.end())
+        return;
+
+    Connection<SocketType>* connection = nullptr;
+    for (auto& candidate : it->value) {
+        if (candidate.current_job.ptr() == &job) {
+            connection = &candidate;
+            break;
+        }
+    }
+    if (!connection)
+        return;
+    connection->current_job = nullptr;
+
+    if constexpr (IsSame<SocketType, TLS::TLSv12>) {
+        // Don't try the same session again if it got us nowhere.
+        if (job.has_error() && !connection->socket->is_established())
+            g_tls_session_cache.remove(key);
+        else
+            remember_tls_session(key, *connection->socket);
+    }
+
+    if (!can_reuse_connection) {
+        auto queue = move(connection->request_queue);
+        remove_connection(cache, key, *connection->socket);
+        for (auto& job_data : queue)
+            enqueue_job(cache, key, move(job_data));
+        return;
+    }
+
+    // The job still has hold of the socket's callbacks until it shuts down right after this.
+    connection->socket->deferred_invoke([&cache, key, socket = connection->socket.ptr()](auto&) {
+        if (auto* connection = find_connection(cache, key, *socket))
+            run_next_job(cache, key, *connection);
+    });
+}
+
+}
@@ -13,12 +13,25 @@
 #include <AK/OwnPtr.h>
 #include <AK/String.h>
 #include <AK/Types.h>
+#include <AK/StdLibExtras.h>
+#include <LibHTTP/HttpJob.h>
 #include <LibHTTP/HttpRequest.h>
+#include <LibHTTP/HttpsJob.h>
 #include <ProtocolServer/ClientConnection.h>
+#include <ProtocolServer/ConnectionCache.h>
 #include <ProtocolServer/Download.h>
 
 namespace ProtocolServer::Detail {
 
+template<typename TJob>
+auto& connection_cache_for_job()
+{
+    if constexpr (IsSame<TJob, HTTP::HttpsJob>)
+        return ConnectionCache::g_tls_connection_cache;
+    else
+        return ConnectionCache::g_tcp_connection_cache;
+}
+
 template<typename TSelf, typename TJob>
 void init(TSelf* self, TJob job)
 {
@@ -29,6 +42,9 @@ void init(TSelf* self, TJob job)
     };
 
     job->on_finish = [self](bool success) {
+        auto& job = self->job();
+        ConnectionCache::request_did_finish(connection_cache_for_job<RemoveReference<decltype(job)>>(), job, success && job.can_reuse_connection());
+
         if (auto* response = self->job().response()) {
             self->set_status_code(response->code());
             self->set_response_headers(response->headers());
@@ -76,7 +92,7 @@ OwnPtr<Download> start_download(TBadgedProtocol&& protocol, ClientConnection& cl
     auto job = TJob::construct(request, *output_stream);
     auto download = TDownload::create_with_job(forward<TBadgedProtocol>(protocol), client, (TJob&)*job, move(output_stream));
     download->set_download_fd(pipe_result.value().read_fd);
-    job->start();
+    ConnectionCache::start_job(connection_cache_for_job<TJob>(), *job);
     return download;
 }
 
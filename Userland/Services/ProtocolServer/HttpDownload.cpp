@@ -5,6 +5,7 @@
  */
 
 #include <LibHTTP/HttpJob.h>
+#include <ProtocolServer/ConnectionCache.h>
 #include <ProtocolServer/HttpCommon.h>
 #include <ProtocolServer/HttpDownload.h>
 #include <ProtocolServer/HttpProtocol.h>
@@ -22,7 +23,9 @@ HttpDownload::~HttpDownload()
 {
     m_job->on_finish = nullptr;
     m_job->on_progress = nullptr;
-    m_job->shutdown();
+    ConnectionCache::request_did_finish(ConnectionCache::g_tcp_connection_cache, *m_job, false);
+    // Also keeps the job from starting if it's still waiting for a connection.
+    m_job->cancel();
 }
 
 NonnullOwnPtr<HttpDownload> HttpDownload::create_with_job(Badge<HttpProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
@@ -5,6 +5,7 @@
  */
 
 #include <LibHTTP/HttpsJob.h>
+#include <ProtocolServer/ConnectionCache.h>
 #include <ProtocolServer/HttpCommon.h>
 #include <ProtocolServer/HttpsDownload.h>
 #include <ProtocolServer/HttpsProtocol.h>
@@ -27,7 +28,9 @@ HttpsDownload::~HttpsDownload()
 {
     m_job->on_finish = nullptr;
     m_job->on_progress = nullptr;
-    m_job->shutdown();
+    ConnectionCache::request_did_finish(ConnectionCache::g_tls_connection_cache, *m_job, false);
+    // Also keeps the job from starting if it's still waiting for a connection.
+    m_job->cancel();
 }
 
 NonnullOwnPtr<HttpsDownload> HttpsDownload::create_with_job(Badge<HttpsProtocol>&&, ClientConnection& client, NonnullRefPtr<HTTP::HttpsJob> job, NonnullOwnPtr<OutputFileStream>&& output_stream)
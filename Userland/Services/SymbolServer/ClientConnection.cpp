@@ -5,8 +5,10 @@
  */
 
 #include <AK/MappedFile.h>
+#include <AK/QuickSort.h>
 #include <LibDebug/DebugInfo.h>
 #include <LibELF/Image.h>
+#include <LibThread/Parallel.h>
 #include <SymbolServer/ClientConnection.h>
 #include <SymbolServer/SymbolClientEndpoint.h>
 
@@ -15,9 +17,16 @@ namespace SymbolServer {
 struct CachedELF {
     NonnullRefPtr<MappedFile> mapped_file;
     Debug::DebugInfo debug_info;
+    u64 last_use { 0 };
 };
 
+// Files that couldn't be loaded are remembered as null, so we don't keep trying.
 static HashMap<String, OwnPtr<CachedELF>> s_cache;
+static u64 s_cache_use_counter;
+
+// The files we keep mapped may add up to this much, after which the least recently used ones are let go.
+static constexpr size_t s_cache_limit = 256 * MiB;
+
 static HashMap<int, RefPtr<ClientConnection>> s_connections;
 
 ClientConnection::ClientConnection(NonnullRefPtr<Core::LocalSocket> socket, int client_id)
@@ -40,31 +49,65 @@ OwnPtr<Messages::SymbolServer::GreetResponse> ClientConnection::handle(const Mes
     return make<Messages::SymbolServer::GreetResponse>();
 }
 
-OwnPtr<Messages::SymbolServer::SymbolicateResponse> ClientConnection::handle(const Messages::SymbolServer::Symbolicate& message)
+static CachedELF* cached_elf_for(const String& path)
 {
-    auto path = message.path();
-    if (!s_cache.contains(path)) {
-        auto mapped_file = MappedFile::map(path);
-        if (mapped_file.is_error()) {
-            dbgln("Failed to map {}: {}", path, mapped_file.error().string());
-            s_cache.set(path, {});
-            return make<Messages::SymbolServer::SymbolicateResponse>(false, String {}, 0, String {}, 0);
-        }
-        auto elf = make<ELF::Image>(mapped_file.value()->bytes());
-        if (!elf->is_valid()) {
-            dbgln("ELF not valid: {}", path);
-            s_cache.set(path, {});
-            return make<Messages::SymbolServer::SymbolicateResponse>(false, String {}, 0, String {}, 0);
-        }
-        Debug::DebugInfo debug_info(move(elf));
-        auto cached_elf = make<CachedELF>(mapped_file.release_value(), move(debug_info));
-        s_cache.set(path, move(cached_elf));
+    if (auto it = s_cache.find(path); it != s_cache.end()) {
+        if (it->value)
+            it->value->last_use = ++s_cache_use_counter;
+        return it->value.ptr();
+    }
+
+    auto mapped_file = MappedFile::map(path);
+    if (mapped_file.is_error()) {
+        dbgln("Failed to map {}: {}", path, mapped_file.error().string());
+        s_cache.set(path, {});
+        return nullptr;
+    }
+    auto elf = make<ELF::Image>(mapped_file.value()->bytes());
+    if (!elf->is_valid()) {
+        dbgln("ELF not valid: {}", path);
+        s_cache.set(path, {});
+        return nullptr;
+    }
+    Debug::DebugInfo debug_info(move(elf));
+    auto cached_elf = make<CachedELF>(mapped_file.release_value(), move(debug_info), ++s_cache_use_counter);
+    auto* cached_elf_ptr = cached_elf.ptr();
+    s_cache.set(path, move(cached_elf));
+    return cached_elf_ptr;
+}
+
+// Called once a request is done with the files it used, so none of them go away while it's being handled.
+static void evict_cached_elfs_if_needed()
+{
+    struct Entry {
+        String path;
+        u64 last_use { 0 };
+        size_t size { 0 };
+    };
+    Vector<Entry> entries;
+    size_t total_size = 0;
+    for (auto& it : s_cache) {
+        if (!it.value)
+            continue;
+        entries.append({ it.key, it.value->last_use, it.value->mapped_file->size() });
+        total_size += entries.last().size;
     }
 
-    auto it = s_cache.find(path);
-    VERIFY(it != s_cache.end());
-    auto& cached_elf = it->value;
+    if (total_size <= s_cache_limit)
+        return;
+
+    quick_sort(entries, [](auto& a, auto& b) { return a.last_use < b.last_use; });
+
+    // The most recently used file stays, however big it is.
+    for (size_t i = 0; i + 1 < entries.size() && total_size > s_cache_limit; ++i) {
+        total_size -= entries[i].size;
+        s_cache.remove(entries[i].path);
+    }
+}
 
+OwnPtr<Messages::SymbolServer::SymbolicateResponse> ClientConnection::handle(const Messages::SymbolServer::Symbolicate& message)
+{
+    auto* cached_elf = cached_elf_for(message.path());
     if (!cached_elf)
         return make<Messages::SymbolServer::SymbolicateResponse>(false, String {}, 0, String {}, 0);
 
@@ -78,7 +121,71 @@ OwnPtr<Messages::SymbolServer::SymbolicateResponse> ClientConnection::handle(con
         line_number = source_position.value().line_number;
     }
 
+    evict_cached_elfs_if_needed();
     return make<Messages::SymbolServer::SymbolicateResponse>(true, symbol, offset, filename, line_number);
 }
 
+OwnPtr<Messages::SymbolServer::SymbolicateBatchResponse> ClientConnection::handle(const Messages::SymbolServer::SymbolicateBatch& message)
+{
+    auto& paths = message.paths();
+    auto& addresses = message.addresses();
+    if (paths.size() != addresses.size()) {
+        did_misbehave("SymbolicateBatch: Mismatching numbers of paths and addresses");
+        return {};
+    }
+
+    auto count = addresses.size();
+    Vector<bool> successes;
+    Vector<String> names;
+    Vector<u32> offsets;
+    Vector<String> filenames;
+    Vector<u32> lines;
+    successes.resize(count);
+    names.resize(count);
+    offsets.resize(count);
+    filenames.resize(count);
+    lines.resize(count);
+
+    // Group the addresses by file, so that every file is only looked at by one thread.
+    struct AddressesInELF {
+        CachedELF* cached_elf { nullptr };
+        Vector<size_t> indices;
+    };
+    Vector<AddressesInELF> groups;
+    HashMap<CachedELF*, size_t> group_indices;
+    for (size_t i = 0; i < count; ++i) {
+        auto* cached_elf = cached_elf_for(paths[i]);
+        if (!cached_elf)
+            continue;
+        successes[i] = true;
+        auto group_index = group_indices.get(cached_elf);
+        if (!group_index.has_value()) {
+            group_index = groups.size();
+            group_indices.set(cached_elf, group_index.value());
+            groups.append({ cached_elf, {} });
+        }
+        groups[group_index.value()].indices.append(i);
+    }
+
+    LibThread::parallel_for(0, groups.size(), 1, [&](size_t group_index) {
+        auto& group = groups[group_index];
+        for (auto i : group.indices)
+            names[i] = group.cached_elf->debug_info.elf().symbolicate(addresses[i], &offsets[i]);
+    });
+
+    // Looking up source positions interns file names as FlyStrings, which can only be done from one thread.
+    for (auto& group : groups) {
+        for (auto i : group.indices) {
+            auto source_position = group.cached_elf->debug_info.get_source_position(addresses[i]);
+            if (!source_position.has_value())
+                continue;
+            filenames[i] = source_position.value().file_path;
+            lines[i] = source_position.value().line_number;
+        }
+    }
+
+    evict_cached_elfs_if_needed();
+    return make<Messages::SymbolServer::SymbolicateBatchResponse>(move(successes), move(names), move(offsets), move(filenames), move(lines));
+}
+
 }
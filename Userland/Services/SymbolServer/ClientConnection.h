@@ -29,6 +29,7 @@ public:
 private:
     virtual OwnPtr<Messages::SymbolServer::GreetResponse> handle(const Messages::SymbolServer::Greet&) override;
     virtual OwnPtr<Messages::SymbolServer::SymbolicateResponse> handle(const Messages::SymbolServer::Symbolicate&) override;
+    virtual OwnPtr<Messages::SymbolServer::SymbolicateBatchResponse> handle(const Messages::SymbolServer::SymbolicateBatch&) override;
 };
 
 }
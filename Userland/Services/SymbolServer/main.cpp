@@ -14,7 +14,7 @@ int main(int, char**)
     Core::EventLoop event_loop;
     auto server = Core::LocalServer::construct();
 
-    if (pledge("stdio rpath accept", nullptr) < 0) {
+    if (pledge("stdio rpath accept thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -20,9 +20,27 @@
 #include <sched.h>
 #include <stdio.h>
 #include <sys/ioctl.h>
+#include <time.h>
 #include <unistd.h>
 
 static HashMap<pid_t, Service*> s_service_map;
+static Vector<Service*> s_services;
+
+static i64 milliseconds_since_boot()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (i64)now.tv_sec * 1000 + now.tv_nsec / 1'000'000;
+}
+
+static Service* find_by_name(const String& name)
+{
+    for (auto* service : s_services) {
+        if (service->name() == name)
+            return service;
+    }
+    return nullptr;
+}
 
 Service* Service::find_by_pid(pid_t pid)
 {
@@ -122,17 +140,143 @@ void Service::handle_socket_connection()
     }
 }
 
+void Service::prespawn_instance()
+{
+    VERIFY(m_accept_socket_connections);
+
+    // The instance writes a byte into this pipe once it has accepted a connection,
+    // and we spawn another one in its place.
+    int notify_fds[2];
+    if (pipe2(notify_fds, O_CLOEXEC) < 0) {
+        perror("pipe2");
+        setup_notifier();
+        return;
+    }
+
+    bool spawned = spawn(m_sockets[0].fd, notify_fds[1]);
+    close(notify_fds[1]);
+    if (!spawned) {
+        close(notify_fds[0]);
+        if (!m_socket_notifier)
+            setup_notifier();
+        return;
+    }
+
+    auto notifier = Core::Notifier::construct(notify_fds[0], Core::Notifier::Event::Read, this);
+    notifier->on_ready_to_read = [this, notifier = notifier.ptr()] {
+        handle_prespawned_instance_notification(*notifier);
+    };
+}
+
+void Service::handle_prespawned_instance_notification(Core::Notifier& notifier)
+{
+    int notify_fd = notifier.fd();
+    char accepted = 0;
+    bool did_accept = read(notify_fd, &accepted, sizeof(accepted)) == sizeof(accepted);
+    remove_child(notifier);
+    close(notify_fd);
+
+    if (did_accept) {
+        dbgln_if(SERVICE_DEBUG, "Pre-spawned instance of {} accepted a connection", name());
+        m_prespawn_failures = 0;
+        prespawn_instance();
+        return;
+    }
+
+    // The instance went away without accepting anything, most likely because it crashed
+    // while starting up. Don't keep respawning it if that happens over and over again.
+    if (++m_prespawn_failures < 3) {
+        prespawn_instance();
+        return;
+    }
+    if (!m_socket_notifier) {
+        dbgln("Pre-spawned instances of {} keep exiting, spawning them on demand instead", name());
+        setup_notifier();
+    }
+}
+
 void Service::activate()
 {
     VERIFY(m_pid < 0);
 
-    if (m_lazy)
+    if (m_activated_at_ms < 0)
+        m_activated_at_ms = milliseconds_since_boot();
+
+    if (m_prespawned_instances > 0) {
+        for (int i = 0; i < m_prespawned_instances; ++i)
+            prespawn_instance();
+    } else if (m_lazy) {
         setup_notifier();
-    else
+    } else {
         spawn();
+        // If it couldn't even be spawned, the services that require it shouldn't be started either.
+        if (m_spawned_at_ms < 0) {
+            m_activation_state = ActivationState::Failed;
+            return;
+        }
+    }
+    m_activation_state = ActivationState::Activated;
 }
 
-void Service::spawn(int socket_fd)
+Service::DependencyState Service::dependency_state() const
+{
+    bool is_waiting = false;
+    for (auto& dependency_name : m_requires) {
+        auto* dependency = find_by_name(dependency_name);
+        if (!dependency || dependency->m_activation_state == ActivationState::Failed)
+            return DependencyState::Failed;
+        if (dependency->m_activation_state == ActivationState::Waiting)
+            is_waiting = true;
+    }
+    for (auto& dependency_name : m_after) {
+        auto* dependency = find_by_name(dependency_name);
+        if (dependency && dependency->m_activation_state == ActivationState::Waiting)
+            is_waiting = true;
+    }
+    return is_waiting ? DependencyState::Waiting : DependencyState::Satisfied;
+}
+
+void Service::activate_waiting_services()
+{
+    for (bool made_progress = true; made_progress;) {
+        made_progress = false;
+        for (auto* service : s_services) {
+            if (service->m_activation_state != ActivationState::Waiting)
+                continue;
+            switch (service->dependency_state()) {
+            case DependencyState::Waiting:
+                continue;
+            case DependencyState::Failed:
+                dbgln("Not starting {}, a service it requires couldn't be started", service->name());
+                service->m_activation_state = ActivationState::Failed;
+                break;
+            case DependencyState::Satisfied:
+                service->activate();
+                break;
+            }
+            made_progress = true;
+        }
+    }
+}
+
+void Service::activate_all(NonnullRefPtrVector<Service>& services)
+{
+    for (auto& service : services)
+        s_services.append(&service);
+
+    for (;;) {
+        activate_waiting_services();
+
+        // Whatever is still waiting now is waiting for itself, one way or another.
+        auto it = s_services.find_if([](auto* service) { return service->m_activation_state == ActivationState::Waiting; });
+        if (it.is_end())
+            break;
+        dbgln("{} is part of a dependency cycle, starting it anyway", (*it)->name());
+        (*it)->activate();
+    }
+}
+
+bool Service::spawn(int socket_fd, int prespawn_notify_fd)
 {
     dbgln_if(SERVICE_DEBUG, "Spawning {}", name());
 
@@ -142,6 +286,7 @@ void Service::spawn(int socket_fd)
     if (pid < 0) {
         perror("fork");
         dbgln("Failed to spawn {}. Sucks, dude :(", name());
+        return false;
     } else if (pid == 0) {
         // We are the child.
 
@@ -215,6 +360,13 @@ void Service::spawn(int socket_fd)
             setenv("SOCKET_TAKEOVER", builder.to_string().characters(), true);
         }
 
+        if (prespawn_notify_fd >= 0) {
+            // We were spawned ahead of time and have been passed the listening socket;
+            // accept a connection on it and let SystemServer know through this pipe.
+            int fd = dup(prespawn_notify_fd);
+            setenv("SOCKET_TAKEOVER_PRESPAWNED", String::number(fd).characters(), true);
+        }
+
         if (m_account.has_value()) {
             auto& account = m_account.value();
             if (setgid(account.gid()) < 0 || setgroups(account.extra_gids().size(), account.extra_gids().data()) < 0 || setuid(account.uid()) < 0) {
@@ -236,11 +388,18 @@ void Service::spawn(int socket_fd)
         rc = execv(argv[0], argv);
         perror("exec");
         VERIFY_NOT_REACHED();
-    } else if (!m_multi_instance) {
+    } else {
         // We are the parent.
-        m_pid = pid;
-        s_service_map.set(pid, this);
+        if (m_spawned_at_ms < 0) {
+            m_spawned_at_ms = milliseconds_since_boot();
+            dbgln("Spawned {} at {} ms since boot (activated at {} ms)", name(), m_spawned_at_ms, m_activated_at_ms);
+        }
+        if (!m_multi_instance) {
+            m_pid = pid;
+            s_service_map.set(pid, this);
+        }
     }
+    return true;
 }
 
 void Service::did_exit(int exit_code)
@@ -299,6 +458,7 @@ Service::Service(const Core::ConfigFile& config, const StringView& name)
 
     m_keep_alive = config.read_bool_entry(name, "KeepAlive");
     m_lazy = config.read_bool_entry(name, "Lazy");
+    m_prespawned_instances = config.read_num_entry(name, "PrespawnedInstances", 0);
 
     m_user = config.read_entry(name, "User");
     if (!m_user.is_null()) {
@@ -314,6 +474,8 @@ Service::Service(const Core::ConfigFile& config, const StringView& name)
     m_boot_modes = config.read_entry(name, "BootModes", "graphical").split(',');
     m_multi_instance = config.read_bool_entry(name, "MultiInstance");
     m_accept_socket_connections = config.read_bool_entry(name, "AcceptSocketConnections");
+    m_after = config.read_entry(name, "After").split(',');
+    m_requires = config.read_entry(name, "Requires").split(',');
 
     String socket_entry = config.read_entry(name, "Socket");
     String socket_permissions_entry = config.read_entry(name, "SocketPermissions", "0600");
@@ -343,6 +505,8 @@ Service::Service(const Core::ConfigFile& config, const StringView& name)
     VERIFY(!m_lazy || m_sockets.size() == 1);
     // AcceptSocketConnections always requires Socket (single), Lazy, and MultiInstance.
     VERIFY(!m_accept_socket_connections || (m_sockets.size() == 1 && m_lazy && m_multi_instance));
+    // PrespawnedInstances requires AcceptSocketConnections.
+    VERIFY(m_prespawned_instances <= 0 || m_accept_socket_connections);
     // MultiInstance doesn't work with KeepAlive.
     VERIFY(!m_multi_instance || !m_keep_alive);
 
@@ -390,6 +554,7 @@ void Service::save_to(JsonObject& json)
     json.set("user", m_user);
     json.set("multi_instance", m_multi_instance);
     json.set("accept_socket_connections", m_accept_socket_connections);
+    json.set("prespawned_instances", m_prespawned_instances);
 
     if (m_pid > 0)
         json.set("pid", m_pid);
@@ -397,6 +562,8 @@ void Service::save_to(JsonObject& json)
         json.set("pid", nullptr);
 
     json.set("restart_attempts", m_restart_attempts);
+    json.set("activated_at_ms", m_activated_at_ms);
+    json.set("spawned_at_ms", m_spawned_at_ms);
     json.set("working_directory", m_working_directory);
 }
 
@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/NonnullRefPtrVector.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <LibCore/Account.h>
@@ -23,13 +24,31 @@ public:
 
     static Service* find_by_pid(pid_t);
 
+    // Activates every service as soon as the services it depends on have started, which
+    // for most of them is right away.
+    static void activate_all(NonnullRefPtrVector<Service>&);
+
     // FIXME: Port to Core::Property
     void save_to(JsonObject&);
 
 private:
     Service(const Core::ConfigFile&, const StringView& name);
 
-    void spawn(int socket_fd = -1);
+    bool spawn(int socket_fd = -1, int prespawn_notify_fd = -1);
+
+    enum class ActivationState {
+        Waiting,
+        Activated,
+        Failed,
+    };
+
+    enum class DependencyState {
+        Waiting,
+        Satisfied,
+        Failed,
+    };
+    DependencyState dependency_state() const;
+    static void activate_waiting_services();
 
     /// SocketDescriptor describes the details of a single socket that was
     /// requested by a service.
@@ -57,6 +76,9 @@ private:
     bool m_accept_socket_connections { false };
     // Whether we should only spawn this service once somebody connects to the socket.
     bool m_lazy;
+    // How many instances we should keep spawned ahead of time, waiting to accept a
+    // connection themselves. This requires accepting socket connections.
+    int m_prespawned_instances { 0 };
     // The name of the user we should run this service as.
     String m_user;
     // The working directory in which to spawn the service.
@@ -69,10 +91,20 @@ private:
     Vector<String> m_environment;
     // Socket descriptors for this service.
     Vector<SocketDescriptor> m_sockets;
+    // Services that have to be started before this one. A service counts as started once its sockets
+    // are listening (clients can already connect then), or if it has none, once it has been spawned.
+    Vector<String> m_after;
+    // Like m_after, but this service won't be started at all if any of these can't be.
+    Vector<String> m_requires;
 
     // The resolved user account to run this service as.
     Optional<Core::Account> m_account;
 
+    ActivationState m_activation_state { ActivationState::Waiting };
+    // When the service was first activated and spawned, in milliseconds since boot. -1 if it hasn't been yet.
+    i64 m_activated_at_ms { -1 };
+    i64 m_spawned_at_ms { -1 };
+
     // For single-instance services, PID of the running instance of this service.
     pid_t m_pid { -1 };
     RefPtr<Core::Notifier> m_socket_notifier;
@@ -82,9 +114,13 @@ private:
     // How many times we have tried to restart this service, only counting those
     // times where it has exited unsuccessfully and too quickly.
     int m_restart_attempts { 0 };
+    // How many pre-spawned instances in a row have exited without accepting a connection.
+    int m_prespawn_failures { 0 };
 
     void setup_socket(SocketDescriptor&);
     void setup_sockets();
     void setup_notifier();
     void handle_socket_connection();
+    void prespawn_instance();
+    void handle_prespawned_instance_notification(Core::Notifier&);
 };
@@ -209,8 +209,7 @@ int main(int, char**)
 
     // After we've set them all up, activate them!
     dbgln("Activating {} services...", services.size());
-    for (auto& service : services)
-        service.activate();
+    Service::activate_all(services);
 
     return event_loop.exec();
 }
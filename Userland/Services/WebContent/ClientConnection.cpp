@@ -104,7 +104,7 @@ void ClientConnection::handle(const Messages::WebContentServer::SetViewportRect&
 
 void ClientConnection::handle(const Messages::WebContentServer::AddBackingStore& message)
 {
-    m_backing_stores.set(message.backing_store_id(), *message.bitmap().bitmap());
+    m_backing_stores.set(message.backing_store_id(), { *message.bitmap().bitmap(), {}, {} });
 }
 
 void ClientConnection::handle(const Messages::WebContentServer::RemoveBackingStore& message)
@@ -114,6 +114,10 @@ void ClientConnection::handle(const Messages::WebContentServer::RemoveBackingSto
 
 void ClientConnection::handle(const Messages::WebContentServer::Paint& message)
 {
+    // Whatever changed is out of date in every backing store, not just the one we're about to paint.
+    for (auto& it : m_backing_stores)
+        it.value.damaged_content_rect = it.value.damaged_content_rect.united(message.damaged_content_rect());
+
     for (auto& pending_paint : m_pending_paint_requests) {
         if (pending_paint.bitmap_id == message.backing_store_id()) {
             pending_paint.content_rect = message.content_rect();
@@ -127,7 +131,7 @@ void ClientConnection::handle(const Messages::WebContentServer::Paint& message)
         return;
     }
 
-    auto& bitmap = *it->value;
+    auto& bitmap = *it->value.bitmap;
     m_pending_paint_requests.append({ message.content_rect(), bitmap, message.backing_store_id() });
     m_paint_flush_timer->start();
 }
@@ -135,7 +139,18 @@ void ClientConnection::handle(const Messages::WebContentServer::Paint& message)
 void ClientConnection::flush_pending_paint_requests()
 {
     for (auto& pending_paint : m_pending_paint_requests) {
-        m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap);
+        auto dirty_content_rect = pending_paint.content_rect;
+        // The client may have removed the backing store since, but still wants to hear back about it.
+        auto it = m_backing_stores.find(pending_paint.bitmap_id);
+        if (it != m_backing_stores.end()) {
+            auto& backing_store = it->value;
+            if (backing_store.painted_content_rect == pending_paint.content_rect)
+                dirty_content_rect = backing_store.damaged_content_rect.intersected(pending_paint.content_rect);
+            backing_store.painted_content_rect = pending_paint.content_rect;
+            backing_store.damaged_content_rect = {};
+        }
+        if (!dirty_content_rect.is_empty())
+            m_page_host->paint(pending_paint.content_rect, *pending_paint.bitmap, dirty_content_rect);
         post_message(Messages::WebContentClient::DidPaint(pending_paint.content_rect, pending_paint.bitmap_id));
     }
     m_pending_paint_requests.clear();
@@ -151,6 +166,21 @@ void ClientConnection::handle(const Messages::WebContentServer::MouseMove& messa
     page().handle_mousemove(message.position(), message.buttons(), message.modifiers());
 }
 
+bool ClientConnection::is_superseded_by(const IPC::Message& message, const IPC::Message& next_message) const
+{
+    if (message.endpoint_magic() != WebContentServerEndpoint::static_magic() || next_message.endpoint_magic() != WebContentServerEndpoint::static_magic())
+        return false;
+
+    // Every mouse move means a hit test and maybe a relayout, so skip the ones we've fallen behind on.
+    if (message.message_id() == Messages::WebContentServer::MouseMove::static_message_id() && next_message.message_id() == Messages::WebContentServer::MouseMove::static_message_id()) {
+        auto& mouse_move = static_cast<const Messages::WebContentServer::MouseMove&>(message);
+        auto& next_mouse_move = static_cast<const Messages::WebContentServer::MouseMove&>(next_message);
+        return mouse_move.buttons() == next_mouse_move.buttons() && mouse_move.modifiers() == next_mouse_move.modifiers();
+    }
+
+    return false;
+}
+
 void ClientConnection::handle(const Messages::WebContentServer::MouseUp& message)
 {
     page().handle_mouseup(message.position(), message.button(), message.modifiers());
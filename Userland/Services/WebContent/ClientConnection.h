@@ -52,6 +52,8 @@ private:
     virtual void handle(const Messages::WebContentServer::JSConsoleInitialize&) override;
     virtual void handle(const Messages::WebContentServer::JSConsoleInput&) override;
 
+    virtual bool is_superseded_by(const IPC::Message&, const IPC::Message& next_message) const override;
+
     void flush_pending_paint_requests();
 
     NonnullOwnPtr<PageHost> m_page_host;
@@ -63,7 +65,14 @@ private:
     Vector<PaintRequest> m_pending_paint_requests;
     RefPtr<Core::Timer> m_paint_flush_timer;
 
-    HashMap<i32, NonnullRefPtr<Gfx::Bitmap>> m_backing_stores;
+    struct BackingStore {
+        NonnullRefPtr<Gfx::Bitmap> bitmap;
+        // What the bitmap was last painted with, and what has changed in there since.
+        // Only the changed part has to be painted again, as long as the viewport stays the same.
+        Gfx::IntRect painted_content_rect;
+        Gfx::IntRect damaged_content_rect;
+    };
+    HashMap<i32, BackingStore> m_backing_stores;
 
     WeakPtr<JS::Interpreter> m_interpreter;
     OwnPtr<WebContentConsoleClient> m_console_client;
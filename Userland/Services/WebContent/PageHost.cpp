@@ -15,6 +15,8 @@
 
 namespace WebContent {
 
+static constexpr int tile_size = 256;
+
 PageHost::PageHost(ClientConnection& client)
     : m_client(client)
     , m_page(make<Web::Page>(*this))
@@ -44,6 +46,13 @@ Gfx::Palette PageHost::palette() const
 void PageHost::set_palette_impl(const Gfx::PaletteImpl& impl)
 {
     m_palette_impl = impl;
+    m_tiles.clear();
+}
+
+void PageHost::set_should_show_line_box_borders(bool should_show_line_box_borders)
+{
+    m_should_show_line_box_borders = should_show_line_box_borders;
+    m_tiles.clear();
 }
 
 Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
@@ -54,10 +63,15 @@ Web::Layout::InitialContainingBlockBox* PageHost::layout_root()
     return document->layout_node();
 }
 
-void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
+void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target, const Gfx::IntRect& a_dirty_content_rect)
 {
+    auto dirty_content_rect = a_dirty_content_rect.intersected(content_rect);
+    if (dirty_content_rect.is_empty())
+        return;
+
     Gfx::Painter painter(target);
     Gfx::IntRect bitmap_rect { {}, content_rect.size() };
+    painter.add_clip_rect(dirty_content_rect.translated(-content_rect.location()));
 
     auto* layout_root = this->layout_root();
     if (!layout_root) {
@@ -65,10 +79,100 @@ void PageHost::paint(const Gfx::IntRect& content_rect, Gfx::Bitmap& target)
         return;
     }
 
+    if (m_has_fixed_position_boxes) {
+        paint_content(*layout_root, painter, content_rect);
+        return;
+    }
+
+    // The tiles that haven't been painted yet all get painted at once, so that they can be painted in parallel.
+    Vector<Gfx::IntPoint> missing_tile_positions;
+    for (int tile_y = dirty_content_rect.top() / tile_size; tile_y <= dirty_content_rect.bottom() / tile_size; ++tile_y) {
+        for (int tile_x = dirty_content_rect.left() / tile_size; tile_x <= dirty_content_rect.right() / tile_size; ++tile_x) {
+            if (!find_tile({ tile_x, tile_y }, target.format()))
+                missing_tile_positions.append({ tile_x, tile_y });
+        }
+    }
+    paint_tiles(*layout_root, missing_tile_positions, target.format());
+
+    for (int tile_y = dirty_content_rect.top() / tile_size; tile_y <= dirty_content_rect.bottom() / tile_size; ++tile_y) {
+        for (int tile_x = dirty_content_rect.left() / tile_size; tile_x <= dirty_content_rect.right() / tile_size; ++tile_x) {
+            auto& tile = *find_tile({ tile_x, tile_y }, target.format());
+            Gfx::IntRect tile_rect { tile_x * tile_size, tile_y * tile_size, tile_size, tile_size };
+            auto visible_rect = tile_rect.intersected(dirty_content_rect);
+            painter.blit(visible_rect.location() - content_rect.location(), tile, visible_rect.translated(-tile_rect.location()));
+        }
+    }
+    discard_tiles_far_away_from(content_rect);
+}
+
+void PageHost::paint_content(Web::Layout::InitialContainingBlockBox& layout_root, Gfx::Painter& painter, const Gfx::IntRect& content_rect)
+{
     Web::PaintContext context(painter, palette(), content_rect.top_left());
     context.set_should_show_line_box_borders(m_should_show_line_box_borders);
     context.set_viewport_rect(content_rect);
-    layout_root->paint_all_phases(context);
+    layout_root.paint_all_phases(context);
+}
+
+static u64 tile_key(const Gfx::IntPoint& tile_position)
+{
+    return (static_cast<u64>(static_cast<u32>(tile_position.x())) << 32) | static_cast<u32>(tile_position.y());
+}
+
+Gfx::Bitmap* PageHost::find_tile(const Gfx::IntPoint& tile_position, Gfx::BitmapFormat format)
+{
+    auto it = m_tiles.find(tile_key(tile_position));
+    if (it == m_tiles.end() || it->value->format() != format)
+        return nullptr;
+    return it->value.ptr();
+}
+
+void PageHost::paint_tiles(Web::Layout::InitialContainingBlockBox& layout_root, const Vector<Gfx::IntPoint>& tile_positions, Gfx::BitmapFormat format)
+{
+    if (tile_positions.is_empty())
+        return;
+
+    // The tiles get painted by more than one thread, which must not set anything up in the tree while they do.
+    if (tile_positions.size() > 1)
+        layout_root.prepare_for_painting();
+
+    Vector<RefPtr<Gfx::Bitmap>> tiles;
+    tiles.resize(tile_positions.size());
+    m_tile_rasterizer.run(tile_positions.size(), [&](size_t index) {
+        auto& tile_position = tile_positions[index];
+        auto tile = Gfx::Bitmap::create(format, { tile_size, tile_size });
+        VERIFY(tile);
+        Gfx::Painter painter(*tile);
+        paint_content(layout_root, painter, { tile_position.x() * tile_size, tile_position.y() * tile_size, tile_size, tile_size });
+        tiles[index] = move(tile);
+    });
+
+    for (size_t i = 0; i < tile_positions.size(); ++i)
+        m_tiles.set(tile_key(tile_positions[i]), tiles[i].release_nonnull());
+}
+
+void PageHost::invalidate_tiles(const Gfx::IntRect& content_rect)
+{
+    if (content_rect.is_empty())
+        return;
+    for (int tile_y = max(content_rect.top(), 0) / tile_size; tile_y <= max(content_rect.bottom(), 0) / tile_size; ++tile_y) {
+        for (int tile_x = max(content_rect.left(), 0) / tile_size; tile_x <= max(content_rect.right(), 0) / tile_size; ++tile_x)
+            m_tiles.remove(tile_key({ tile_x, tile_y }));
+    }
+}
+
+void PageHost::discard_tiles_far_away_from(const Gfx::IntRect& content_rect)
+{
+    // The tiles up to a viewport away in any direction are kept, so that scrolling back and forth reuses them.
+    auto kept_rect = content_rect.inflated(content_rect.width() * 2, content_rect.height() * 2);
+    Vector<u64> keys_to_discard;
+    for (auto& it : m_tiles) {
+        Gfx::IntPoint tile_position { static_cast<i32>(it.key >> 32), static_cast<i32>(it.key & 0xffffffff) };
+        Gfx::IntRect tile_rect { tile_position.x() * tile_size, tile_position.y() * tile_size, tile_size, tile_size };
+        if (!tile_rect.intersects(kept_rect))
+            keys_to_discard.append(it.key);
+    }
+    for (auto key : keys_to_discard)
+        m_tiles.remove(key);
 }
 
 void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
@@ -78,7 +182,10 @@ void PageHost::set_viewport_rect(const Gfx::IntRect& rect)
 
 void PageHost::page_did_invalidate(const Gfx::IntRect& content_rect)
 {
-    m_client.post_message(Messages::WebContentClient::DidInvalidateContentRect(content_rect));
+    // Tiles outside of the viewport are damaged too, but the client only has to know about the part that it shows.
+    invalidate_tiles(content_rect);
+    if (page().main_frame().viewport_rect().intersects(content_rect))
+        m_client.post_message(Messages::WebContentClient::DidInvalidateContentRect(content_rect));
 }
 
 void PageHost::page_did_change_selection()
@@ -95,6 +202,17 @@ void PageHost::page_did_layout()
 {
     auto* layout_root = this->layout_root();
     VERIFY(layout_root);
+
+    // Anything could have moved, so none of the tiles can be reused.
+    m_tiles.clear();
+    m_has_fixed_position_boxes = false;
+    layout_root->for_each_in_inclusive_subtree_of_type<Web::Layout::Box>([&](auto& box) {
+        if (!box.is_fixed_position())
+            return IterationDecision::Continue;
+        m_has_fixed_position_boxes = true;
+        return IterationDecision::Break;
+    });
+
     auto content_size = enclosing_int_rect(layout_root->absolute_rect()).size();
     m_client.post_message(Messages::WebContentClient::DidLayout(content_size));
 }
@@ -6,7 +6,10 @@
 
 #pragma once
 
+#include <AK/HashMap.h>
+#include <LibGfx/Bitmap.h>
 #include <LibGfx/Rect.h>
+#include <LibThread/WorkerPool.h>
 #include <LibWeb/Page/Page.h>
 
 namespace WebContent {
@@ -24,13 +27,14 @@ public:
     Web::Page& page() { return *m_page; }
     const Web::Page& page() const { return *m_page; }
 
-    void paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&);
+    // Paints content_rect into the bitmap, but only the part of it that's within dirty_content_rect.
+    void paint(const Gfx::IntRect& content_rect, Gfx::Bitmap&, const Gfx::IntRect& dirty_content_rect);
 
     void set_palette_impl(const Gfx::PaletteImpl&);
     void set_viewport_rect(const Gfx::IntRect&);
     void set_screen_rect(const Gfx::IntRect& rect) { m_screen_rect = rect; };
 
-    void set_should_show_line_box_borders(bool b) { m_should_show_line_box_borders = b; }
+    void set_should_show_line_box_borders(bool);
 
 private:
     // ^PageClient
@@ -67,11 +71,25 @@ private:
     Web::Layout::InitialContainingBlockBox* layout_root();
     void setup_palette();
 
+    void paint_content(Web::Layout::InitialContainingBlockBox&, Gfx::Painter&, const Gfx::IntRect& content_rect);
+    Gfx::Bitmap* find_tile(const Gfx::IntPoint& tile_position, Gfx::BitmapFormat);
+    void paint_tiles(Web::Layout::InitialContainingBlockBox&, const Vector<Gfx::IntPoint>& tile_positions, Gfx::BitmapFormat);
+    void invalidate_tiles(const Gfx::IntRect& content_rect);
+    void discard_tiles_far_away_from(const Gfx::IntRect& content_rect);
+
     ClientConnection& m_client;
     NonnullOwnPtr<Web::Page> m_page;
     RefPtr<Gfx::PaletteImpl> m_palette_impl;
     Gfx::IntRect m_screen_rect;
     bool m_should_show_line_box_borders { false };
+
+    // The page gets painted in tiles, which are kept until something in them changes, so that scrolling (or a change
+    // in a small part of the page) only has to paint the tiles that haven't been painted yet. They are keyed by their
+    // position in units of tiles.
+    HashMap<u64, NonnullRefPtr<Gfx::Bitmap>> m_tiles;
+    // Those boxes stay put in the viewport as the page scrolls, so they can't be painted into tiles.
+    bool m_has_fixed_position_boxes { false };
+    LibThread::WorkerPool m_tile_rasterizer { "Rasterizer" };
 };
 
 }
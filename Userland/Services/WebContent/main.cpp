@@ -6,13 +6,15 @@
 
 #include <LibCore/EventLoop.h>
 #include <LibCore/LocalServer.h>
+#include <LibGfx/FontDatabase.h>
 #include <LibIPC/ClientConnection.h>
+#include <LibWeb/Bindings/MainThreadVM.h>
 #include <WebContent/ClientConnection.h>
 
 int main(int, char**)
 {
     Core::EventLoop event_loop;
-    if (pledge("stdio recvfd sendfd accept unix rpath", nullptr) < 0) {
+    if (pledge("stdio thread recvfd sendfd accept unix rpath", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -33,6 +35,12 @@ int main(int, char**)
         return 1;
     }
 
+    // Get the work every page needs out of the way before waiting for a client.
+    // If SystemServer spawned us ahead of time, nobody is waiting on us yet.
+    Gfx::FontDatabase::default_font();
+    Gfx::FontDatabase::default_fixed_width_font();
+    Web::Bindings::main_thread_vm();
+
     auto socket = Core::LocalSocket::take_over_accepted_socket_from_system_server();
     VERIFY(socket);
     IPC::new_client_connection<WebContent::ClientConnection>(socket.release_nonnull(), 1);
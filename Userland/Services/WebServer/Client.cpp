@@ -6,24 +6,27 @@
 
 #include "Client.h"
 #include <AK/Base64.h>
+#include <AK/Debug.h>
 #include <AK/LexicalPath.h>
 #include <AK/MappedFile.h>
-#include <AK/MemoryStream.h>
 #include <AK/StringBuilder.h>
 #include <AK/URLParser.h>
 #include <LibCore/DateTime.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
-#include <LibCore/FileStream.h>
 #include <LibCore/MimeData.h>
 #include <LibHTTP/HttpRequest.h>
 #include <stdio.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
 #include <time.h>
 #include <unistd.h>
 
 namespace WebServer {
 
+static constexpr int idle_timeout_ms = 10000;
+static constexpr size_t max_request_size = 64 * KiB;
+
 Client::Client(NonnullRefPtr<Core::TCPSocket> socket, const String& root, Core::Object* parent)
     : Core::Object(parent)
     , m_socket(socket)
@@ -38,18 +41,71 @@ void Client::die()
 
 void Client::start()
 {
+    m_idle_timer = Core::Timer::create_single_shot(idle_timeout_ms, [this] { die(); }, this);
+    m_idle_timer->start();
+
     m_socket->on_ready_to_read = [this] {
-        auto raw_request = m_socket->read_all();
-        if (raw_request.is_null()) {
+        auto data = m_socket->read(64 * KiB);
+        if (data.is_null()) {
             die();
             return;
         }
 
-        dbgln("Got raw request: '{}'", String::copy(raw_request));
+        m_idle_timer->restart();
+        m_pending_data.append(data.data(), data.size());
+        handle_pending_requests();
+    };
+}
+
+void Client::handle_pending_requests()
+{
+    size_t offset = 0;
+    for (;;) {
+        auto pending = m_pending_data.bytes().slice(offset);
+        auto end_of_headers = StringView { pending }.find("\r\n\r\n");
+        if (!end_of_headers.has_value())
+            break;
+
+        auto raw_request = pending.trim(end_of_headers.value() + 4);
+        offset += raw_request.size();
 
-        handle_request(raw_request.bytes());
+        m_keep_alive = false;
+        handle_request(raw_request);
+        if (!m_keep_alive) {
+            die();
+            return;
+        }
+    }
+
+    if (offset > 0)
+        m_pending_data = ByteBuffer::copy(m_pending_data.bytes().slice(offset));
+
+    if (m_pending_data.size() > max_request_size) {
+        dbgln("Request is too large, closing the connection");
         die();
-    };
+    }
+}
+
+static Optional<String> header_value(const HTTP::HttpRequest& request, const StringView& name)
+{
+    for (auto& header : request.headers()) {
+        if (header.name.equals_ignoring_case(name))
+            return header.value;
+    }
+    return {};
+}
+
+static bool wants_keep_alive(const HTTP::HttpRequest& request)
+{
+    auto connection = header_value(request, "Connection");
+    if (connection.has_value()) {
+        if (connection->equals_ignoring_case("close"))
+            return false;
+        if (connection->equals_ignoring_case("keep-alive"))
+            return true;
+    }
+    // HTTP/1.1 connections are persistent unless the client says otherwise, while HTTP/1.0 ones have to ask.
+    return request.protocol() == "HTTP/1.1";
 }
 
 void Client::handle_request(ReadonlyBytes raw_request)
@@ -59,18 +115,23 @@ void Client::handle_request(ReadonlyBytes raw_request)
         return;
     auto& request = request_or_error.value();
 
-    dbgln("Got HTTP request: {} {}", request.method_name(), request.resource());
-    for (auto& header : request.headers()) {
-        dbgln("    {} => {}", header.name, header.value);
+    dbgln_if(WEBSERVER_DEBUG, "Got HTTP request: {} {}", request.method_name(), request.resource());
+    if constexpr (WEBSERVER_DEBUG) {
+        for (auto& header : request.headers())
+            dbgln("    {} => {}", header.name, header.value);
     }
 
+    m_keep_alive = wants_keep_alive(request);
+
     if (request.method() != HTTP::HttpRequest::Method::GET) {
+        // There may be a body we don't know how to skip, so this connection can't be used again.
+        m_keep_alive = false;
         send_error_response(403, "Forbidden!", request);
         return;
     }
 
     auto requested_path = LexicalPath::canonicalized_path(request.resource());
-    dbgln("Canonical requested path: '{}'", requested_path);
+    dbgln_if(WEBSERVER_DEBUG, "Canonical requested path: '{}'", requested_path);
 
     StringBuilder path_builder;
     path_builder.append(m_root_path);
@@ -101,49 +162,108 @@ void Client::handle_request(ReadonlyBytes raw_request)
         real_path = index_html_path;
     }
 
-    auto file = Core::File::construct(real_path);
-    if (!file->open(Core::File::ReadOnly)) {
+    auto file = FileCache::the().get(real_path);
+    if (!file) {
         send_error_response(404, "Not found!", request);
         return;
     }
 
-    Core::InputFileStream stream { file };
+    auto if_none_match = header_value(request, "If-None-Match");
+    if (if_none_match.has_value() && if_none_match.value() == file->etag) {
+        send_not_modified(*file, request);
+        return;
+    }
+
+    send_file_response(*file, real_path, request);
+}
 
-    send_response(stream, request, Core::guess_mime_type_based_on_filename(real_path));
+void Client::append_connection_header(StringBuilder& builder) const
+{
+    builder.append(m_keep_alive ? "Connection: keep-alive\r\n" : "Connection: close\r\n");
 }
 
-void Client::send_response(InputStream& response, const HTTP::HttpRequest& request, const String& content_type)
+void Client::send_response(ReadonlyBytes body, const HTTP::HttpRequest& request, const String& content_type)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 200 OK\r\n");
+    builder.append("HTTP/1.1 200 OK\r\n");
     builder.append("Server: WebServer (SerenityOS)\r\n");
     builder.append("X-Frame-Options: SAMEORIGIN\r\n");
     builder.append("X-Content-Type-Options: nosniff\r\n");
-    builder.append("Content-Type: ");
-    builder.append(content_type);
+    builder.appendff("Content-Type: {}\r\n", content_type);
+    builder.appendff("Content-Length: {}\r\n", body.size());
+    append_connection_header(builder);
     builder.append("\r\n");
+    builder.append(StringView { body });
+
+    m_socket->write(builder.string_view());
+    log_response(200, request);
+}
+
+void Client::send_file_response(const FileCache::File& file, const String& real_path, const HTTP::HttpRequest& request)
+{
+    StringBuilder builder;
+    builder.append(file.headers);
+    append_connection_header(builder);
     builder.append("\r\n");
 
-    m_socket->write(builder.to_string());
+    if (file.contents || file.size == 0) {
+        // Cached files go out with their headers in a single write.
+        if (file.contents)
+            builder.append(StringView { file.contents->bytes() });
+        m_socket->write(builder.string_view());
+        log_response(200, request);
+        return;
+    }
+
+    auto disk_file = Core::File::construct(real_path);
+    if (!disk_file->open(Core::File::ReadOnly)) {
+        send_error_response(404, "Not found!", request);
+        return;
+    }
+
+    m_socket->write(builder.string_view());
     log_response(200, request);
 
-    char buffer[PAGE_SIZE];
-    do {
-        auto size = response.read({ buffer, sizeof(buffer) });
-        if (response.unreliable_eof() && size == 0)
+    // Let the kernel move the file contents into the socket without bouncing them through our memory.
+    off_t remaining = file.size;
+    while (remaining > 0) {
+        auto nsent = sendfile(m_socket->fd(), disk_file->fd(), nullptr, min(remaining, (off_t)(64 * KiB)));
+        if (nsent < 0) {
+            perror("sendfile");
+            m_keep_alive = false;
+            return;
+        }
+        if (nsent == 0)
             break;
+        remaining -= nsent;
+    }
+    // If the file shrank since we sent its length, the client can't tell where this response ends.
+    if (remaining > 0)
+        m_keep_alive = false;
+}
+
+void Client::send_not_modified(const FileCache::File& file, const HTTP::HttpRequest& request)
+{
+    StringBuilder builder;
+    builder.append("HTTP/1.1 304 Not Modified\r\n");
+    builder.append("Server: WebServer (SerenityOS)\r\n");
+    builder.appendff("ETag: {}\r\n", file.etag);
+    append_connection_header(builder);
+    builder.append("\r\n");
 
-        m_socket->write({ buffer, size });
-    } while (true);
+    m_socket->write(builder.string_view());
+    log_response(304, request);
 }
 
 void Client::send_redirect(StringView redirect_path, const HTTP::HttpRequest& request)
 {
     StringBuilder builder;
-    builder.append("HTTP/1.0 301 Moved Permanently\r\n");
+    builder.append("HTTP/1.1 301 Moved Permanently\r\n");
     builder.append("Location: ");
     builder.append(redirect_path);
     builder.append("\r\n");
+    builder.append("Content-Length: 0\r\n");
+    append_connection_header(builder);
     builder.append("\r\n");
 
     m_socket->write(builder.to_string());
@@ -234,21 +354,21 @@ void Client::handle_directory_listing(const String& requested_path, const String
     builder.append("</html>\n");
 
     auto response = builder.to_string();
-    InputMemoryStream stream { response.bytes() };
-    send_response(stream, request, "text/html");
+    send_response(response.bytes(), request, "text/html");
 }
 
 void Client::send_error_response(unsigned code, const StringView& message, const HTTP::HttpRequest& request)
 {
+    auto body = String::formatted("<!DOCTYPE html><html><body><h1>{} {}</h1></body></html>", code, message);
+
     StringBuilder builder;
-    builder.appendf("HTTP/1.0 %u ", code);
-    builder.append(message);
-    builder.append("\r\n\r\n");
-    builder.append("<!DOCTYPE html><html><body><h1>");
-    builder.appendf("%u ", code);
-    builder.append(message);
-    builder.append("</h1></body></html>");
-    m_socket->write(builder.to_string());
+    builder.appendff("HTTP/1.1 {} {}\r\n", code, message);
+    builder.append("Content-Type: text/html\r\n");
+    builder.appendff("Content-Length: {}\r\n", body.length());
+    append_connection_header(builder);
+    builder.append("\r\n");
+    builder.append(body);
+    m_socket->write(builder.string_view());
 
     log_response(code, request);
 }
@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include "FileCache.h"
+#include <AK/ByteBuffer.h>
 #include <LibCore/Object.h>
 #include <LibCore/TCPSocket.h>
+#include <LibCore/Timer.h>
 #include <LibHTTP/Forward.h>
 
 namespace WebServer {
@@ -21,16 +24,26 @@ public:
 private:
     Client(NonnullRefPtr<Core::TCPSocket>, const String&, Core::Object* parent);
 
+    void handle_pending_requests();
     void handle_request(ReadonlyBytes);
-    void send_response(InputStream&, const HTTP::HttpRequest&, const String& content_type);
+    void send_response(ReadonlyBytes, const HTTP::HttpRequest&, const String& content_type);
+    void send_file_response(const FileCache::File&, const String& real_path, const HTTP::HttpRequest&);
+    void send_not_modified(const FileCache::File&, const HTTP::HttpRequest&);
     void send_redirect(StringView redirect, const HTTP::HttpRequest& request);
     void send_error_response(unsigned code, const StringView& message, const HTTP::HttpRequest&);
+    void append_connection_header(StringBuilder&) const;
     void die();
     void log_response(unsigned code, const HTTP::HttpRequest&);
     void handle_directory_listing(const String& requested_path, const String& real_path, const HTTP::HttpRequest&);
 
     NonnullRefPtr<Core::TCPSocket> m_socket;
     String m_root_path;
+
+    // Requests may arrive in pieces, or several at a time, so they are collected here until they are complete.
+    ByteBuffer m_pending_data;
+    // Whether the connection stays open after the response to the current request.
+    bool m_keep_alive { false };
+    RefPtr<Core::Timer> m_idle_timer;
 };
 
 }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include "FileCache.h"
+#include <AK/StringBuilder.h>
+#include <LibCore/MimeData.h>
+#include <sys/stat.h>
+
+namespace WebServer {
+
+static constexpr off_t max_cached_file_size = 1 * MiB;
+static constexpr size_t max_cached_bytes = 64 * MiB;
+
+FileCache& FileCache::the()
+{
+    static FileCache cache;
+    return cache;
+}
+
+RefPtr<FileCache::File> FileCache::get(const String& path)
+{
+    struct stat st;
+    if (stat(path.characters(), &st) < 0 || !S_ISREG(st.st_mode))
+        return nullptr;
+
+    if (auto it = m_files.find(path); it != m_files.end()) {
+        auto& file = it->value;
+        if (file->inode == st.st_ino && file->size == st.st_size && file->mtime == st.st_mtime) {
+            file->last_use = ++m_use_counter;
+            return file;
+        }
+        m_cached_bytes -= file->size;
+        m_files.remove(it);
+    }
+
+    auto file = adopt_ref(*new File);
+    file->size = st.st_size;
+    file->inode = st.st_ino;
+    file->mtime = st.st_mtime;
+    file->last_use = ++m_use_counter;
+    file->etag = String::formatted("\"{:x}-{:x}-{:x}\"", st.st_ino, st.st_size, st.st_mtime);
+
+    bool should_cache = st.st_size <= max_cached_file_size;
+    if (should_cache && st.st_size > 0) {
+        auto mapped_file_or_error = MappedFile::map(path);
+        if (mapped_file_or_error.is_error())
+            return nullptr;
+        file->contents = mapped_file_or_error.release_value();
+        // The file may have changed between stat() and mapping it; whatever got mapped is what gets sent.
+        file->size = file->contents->size();
+    }
+
+    StringBuilder builder;
+    builder.append("HTTP/1.1 200 OK\r\n");
+    builder.append("Server: WebServer (SerenityOS)\r\n");
+    builder.append("X-Frame-Options: SAMEORIGIN\r\n");
+    builder.append("X-Content-Type-Options: nosniff\r\n");
+    builder.appendff("Content-Type: {}\r\n", Core::guess_mime_type_based_on_filename(path));
+    builder.appendff("Content-Length: {}\r\n", file->size);
+    builder.appendff("ETag: {}\r\n", file->etag);
+    file->headers = builder.to_string();
+
+    if (should_cache) {
+        m_files.set(path, file);
+        m_cached_bytes += file->size;
+        evict_files_if_needed();
+    }
+    return file;
+}
+
+void FileCache::evict_files_if_needed()
+{
+    while (m_cached_bytes > max_cached_bytes) {
+        auto least_recently_used = m_files.begin();
+        for (auto it = m_files.begin(); it != m_files.end(); ++it) {
+            if (it->value->last_use < least_recently_used->value->last_use)
+                least_recently_used = it;
+        }
+        m_cached_bytes -= least_recently_used->value->size;
+        m_files.remove(least_recently_used);
+    }
+}
+
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/HashMap.h>
+#include <AK/MappedFile.h>
+#include <AK/RefCounted.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+#include <sys/types.h>
+
+namespace WebServer {
+
+// Keeps recently served files mapped into memory, along with their response headers, so that serving a popular file
+// doesn't mean opening and reading it again. Every worker process has a cache of its own.
+class FileCache {
+public:
+    static FileCache& the();
+
+    struct File : public RefCounted<File> {
+        String etag;
+        // The status line and headers, except for Connection, which depends on the request.
+        String headers;
+        // Files too large to keep in memory have no contents here, and are sent straight from disk.
+        RefPtr<MappedFile> contents;
+        off_t size { 0 };
+
+        // Used to notice that the file has changed on disk since it was cached.
+        ino_t inode { 0 };
+        time_t mtime { 0 };
+        u64 last_use { 0 };
+    };
+
+    // Returns nothing if the path isn't a regular file that can be read.
+    RefPtr<File> get(const String& path);
+
+private:
+    FileCache() = default;
+
+    void evict_files_if_needed();
+
+    HashMap<String, NonnullRefPtr<File>> m_files;
+    size_t m_cached_bytes { 0 };
+    u64 m_use_counter { 0 };
+};
+
+}
@@ -5,7 +5,7 @@
  */
 
 #include "Client.h"
-#include <AK/MappedFile.h>
+#include <AK/OwnPtr.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
@@ -19,9 +19,11 @@ int main(int argc, char** argv)
     const char* root_path = "/www";
 
     int port = default_port;
+    int worker_count = max(1, (int)sysconf(_SC_NPROCESSORS_ONLN));
 
     Core::ArgsParser args_parser;
     args_parser.add_option(port, "Port to listen on", "port", 'p', "port");
+    args_parser.add_option(worker_count, "Number of processes to serve requests with (default: one per CPU)", "workers", 'w', "count");
     args_parser.add_positional_argument(root_path, "Path to serve the contents of", "path", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -37,7 +39,12 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    if (pledge("stdio accept rpath inet unix cpath fattr", nullptr) < 0) {
+    if (worker_count < 1) {
+        warnln("Need at least one worker");
+        return 1;
+    }
+
+    if (pledge("stdio accept rpath inet unix cpath fattr proc", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -48,7 +55,8 @@ int main(int argc, char** argv)
 
     server->on_ready_to_accept = [&] {
         auto client_socket = server->accept();
-        VERIFY(client_socket);
+        if (!client_socket)
+            return;
         auto client = WebServer::Client::construct(client_socket.release_nonnull(), real_root_path, server);
         client->start();
     };
@@ -58,7 +66,24 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    outln("Listening on 0.0.0.0:{}", port);
+    outln("Listening on 0.0.0.0:{} with {} worker(s)", port, worker_count);
+
+    // The workers are forked off after the socket is bound, so they all accept connections from it, and whichever is
+    // idle picks up the next one. Each worker gets an event loop of its own.
+    OwnPtr<Core::EventLoop> worker_loop;
+    for (int i = 1; i < worker_count; ++i) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            perror("fork");
+            break;
+        }
+        if (pid == 0) {
+            Core::EventLoop::notify_forked(Core::EventLoop::ForkEvent::Child);
+            worker_loop = make<Core::EventLoop>();
+            server->resume_listening_after_fork();
+            break;
+        }
+    }
 
     if (unveil("/res/icons", "r") < 0) {
         perror("unveil");
@@ -77,5 +102,7 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (worker_loop)
+        return worker_loop->exec();
     return loop.exec();
 }
@@ -788,12 +788,12 @@ void ClientConnection::handle(const Messages::WindowServer::DisableDisplayLink&)
     Compositor::the().decrement_display_link_count({});
 }
 
-void ClientConnection::notify_display_link(Badge<Compositor>)
+void ClientConnection::notify_display_link(Badge<Compositor>, i64 frame_time_in_microseconds)
 {
     if (!m_has_display_link)
         return;
 
-    post_message(Messages::WindowClient::DisplayLinkNotification());
+    post_message(Messages::WindowClient::DisplayLinkNotification(frame_time_in_microseconds));
 }
 
 void ClientConnection::handle(const Messages::WindowServer::SetWindowProgress& message)
@@ -74,7 +74,7 @@ public:
         }
     }
 
-    void notify_display_link(Badge<Compositor>);
+    void notify_display_link(Badge<Compositor>, i64 frame_time_in_microseconds);
 
 private:
     explicit ClientConnection(NonnullRefPtr<Core::LocalSocket>, int client_id);
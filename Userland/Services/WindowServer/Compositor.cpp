@@ -22,6 +22,19 @@
 
 namespace WindowServer {
 
+// About a 256x256 area, below which composing on one thread is quicker than handing the work out.
+static constexpr int min_pixel_count_to_compose_in_bands = 65536;
+
+// There is no way to wait for the vertical blank, so display links run on a 60 Hz clock of their own.
+static constexpr Time display_link_frame_interval = Time::from_microseconds(1'000'000 / 60);
+
+static Time monotonic_now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return Time::from_timespec(now);
+}
+
 Compositor& Compositor::the()
 {
     static Compositor s_the;
@@ -43,11 +56,12 @@ static WallpaperMode mode_to_enum(const String& name)
 
 Compositor::Compositor()
 {
-    m_display_link_notify_timer = add<Core::Timer>(
-        1000 / 60, [this] {
+    m_display_link_notify_timer = Core::Timer::create_single_shot(
+        display_link_frame_interval.to_milliseconds(),
+        [this] {
             notify_display_links();
-        });
-    m_display_link_notify_timer->stop();
+        },
+        this);
 
     m_compose_timer = Core::Timer::create_single_shot(
         1000 / 60,
@@ -85,6 +99,7 @@ void Compositor::init_bitmaps()
     m_temp_painter = make<Gfx::Painter>(*m_temp_bitmap);
 
     m_buffers_are_flipped = false;
+    m_stale_back_bitmap_rects.clear();
 
     invalidate_screen();
 }
@@ -172,6 +187,14 @@ void Compositor::compose()
         return IterationDecision::Continue;
     });
 
+    auto cursor_rect = current_cursor_rect();
+
+    if (auto* fullscreen_window = wm.active_fullscreen_window(); fullscreen_window && m_invalidated_window) {
+        if (compose_fullscreen_window_directly(*fullscreen_window, cursor_rect))
+            return;
+    }
+    update_stale_back_bitmap_rects();
+
     Color background_color = wm.palette().desktop_background();
     if (m_custom_background_color.has_value())
         background_color = m_custom_background_color.value();
@@ -185,12 +208,8 @@ void Compositor::compose()
     Gfx::DisjointRectSet flush_rects;
     Gfx::DisjointRectSet flush_transparent_rects;
     Gfx::DisjointRectSet flush_special_rects;
-    auto cursor_rect = current_cursor_rect();
     bool need_to_draw_cursor = false;
 
-    auto back_painter = *m_back_painter;
-    auto temp_painter = *m_temp_painter;
-
     auto check_restore_cursor_back = [&](const Gfx::IntRect& rect) {
         if (!need_to_draw_cursor && rect.intersects(cursor_rect)) {
             // Restore what's behind the cursor if anything touches the area of the cursor
@@ -222,6 +241,78 @@ void Compositor::compose()
     if (!m_cursor_back_bitmap || m_invalidated_cursor)
         check_restore_cursor_back(cursor_rect);
 
+    auto for_each_window_to_compose = [&](auto callback) {
+        if (auto* fullscreen_window = wm.active_fullscreen_window()) {
+            callback(*fullscreen_window);
+            return;
+        }
+        wm.for_each_visible_window_from_back_to_front([&](Window& window) {
+            callback(window);
+            return IterationDecision::Continue;
+        });
+    };
+
+    // Work out everything that needs to be painted first, so that the painting itself can be split up between threads.
+    // Nothing below may change any state until all of it is done.
+    m_opaque_wallpaper_rects.for_each_intersected(dirty_screen_rects, [&](const Gfx::IntRect& render_rect) {
+        dbgln_if(COMPOSE_DEBUG, "  render wallpaper opaque: {}", render_rect);
+        prepare_rect(render_rect);
+        return IterationDecision::Continue;
+    });
+
+    if (m_invalidated_window) {
+        for_each_window_to_compose([&](Window& window) {
+            auto frame_rect = window.frame().render_rect();
+            if (!frame_rect.intersects(ws.rect()))
+                return;
+
+            dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), frame_rect);
+
+            if (!window.is_fullscreen())
+                window.frame().render_to_cache();
+
+            auto& dirty_rects = window.dirty_rects();
+
+            if constexpr (COMPOSE_DEBUG) {
+                for (auto& dirty_rect : dirty_rects.rects())
+                    dbgln("    dirty: {}", dirty_rect);
+                for (auto& r : window.opaque_rects().rects())
+                    dbgln("    opaque: {}", r);
+                for (auto& r : window.transparency_rects().rects())
+                    dbgln("    transparent: {}", r);
+            }
+
+            window.opaque_rects().for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
+                dbgln_if(COMPOSE_DEBUG, "    render opaque: {}", render_rect);
+                prepare_rect(render_rect);
+                return IterationDecision::Continue;
+            });
+            window.transparency_wallpaper_rects().for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
+                dbgln_if(COMPOSE_DEBUG, "    render wallpaper: {}", render_rect);
+                prepare_transparency_rect(render_rect);
+                return IterationDecision::Continue;
+            });
+            window.transparency_rects().for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
+                dbgln_if(COMPOSE_DEBUG, "    render transparent: {}", render_rect);
+                prepare_transparency_rect(render_rect);
+                return IterationDecision::Continue;
+            });
+        });
+
+        // Check that there are no overlapping transparent and opaque flush rectangles
+        VERIFY(![&]() {
+            for (auto& rect_transparent : flush_transparent_rects.rects()) {
+                for (auto& rect_opaque : flush_rects.rects()) {
+                    if (rect_opaque.intersects(rect_transparent)) {
+                        dbgln("Transparent rect {} overlaps opaque rect: {}: {}", rect_transparent, rect_opaque, rect_opaque.intersected(rect_transparent));
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }());
+    }
+
     auto paint_wallpaper = [&](Gfx::Painter& painter, const Gfx::IntRect& rect) {
         // FIXME: If the wallpaper is opaque and covers the whole rect, no need to fill with color!
         painter.fill_rect(rect, background_color);
@@ -246,22 +337,15 @@ void Compositor::compose()
         }
     };
 
-    m_opaque_wallpaper_rects.for_each_intersected(dirty_screen_rects, [&](const Gfx::IntRect& render_rect) {
-        dbgln_if(COMPOSE_DEBUG, "  render wallpaper opaque: {}", render_rect);
-        prepare_rect(render_rect);
-        paint_wallpaper(back_painter, render_rect);
-        return IterationDecision::Continue;
-    });
-
-    auto compose_window = [&](Window& window) -> IterationDecision {
+    // The painters are clipped to a band of the screen, and only ever paint within it. Rects are still painted whole
+    // (as far as the clip lets them), so that scaled bitmaps come out the same no matter where the bands are.
+    auto compose_window = [&](Window& window, Gfx::Painter& back_painter, Gfx::Painter& temp_painter, const Gfx::IntRect& band) {
         auto frame_rect = window.frame().render_rect();
-        if (!frame_rect.intersects(ws.rect()))
-            return IterationDecision::Continue;
+        if (!frame_rect.intersects(ws.rect()) || !frame_rect.intersects(band))
+            return;
         auto window_rect = window.rect();
         auto frame_rects = frame_rect.shatter(window_rect);
 
-        dbgln_if(COMPOSE_DEBUG, "  window {} frame rect: {}", window.title(), frame_rect);
-
         RefPtr<Gfx::Bitmap> backing_store = window.backing_store();
         auto compose_window_rect = [&](Gfx::Painter& painter, const Gfx::IntRect& rect) {
             if (!window.is_fullscreen()) {
@@ -350,85 +434,87 @@ void Compositor::compose()
 
         auto& dirty_rects = window.dirty_rects();
 
-        if constexpr (COMPOSE_DEBUG) {
-            for (auto& dirty_rect : dirty_rects.rects())
-                dbgln("    dirty: {}", dirty_rect);
-            for (auto& r : window.opaque_rects().rects())
-                dbgln("    opaque: {}", r);
-            for (auto& r : window.transparency_rects().rects())
-                dbgln("    transparent: {}", r);
-        }
-
         // Render opaque portions directly to the back buffer
-        auto& opaque_rects = window.opaque_rects();
-        if (!opaque_rects.is_empty()) {
-            opaque_rects.for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
-                dbgln_if(COMPOSE_DEBUG, "    render opaque: {}", render_rect);
-
-                prepare_rect(render_rect);
-                Gfx::PainterStateSaver saver(back_painter);
-                back_painter.add_clip_rect(render_rect);
-                compose_window_rect(back_painter, render_rect);
+        window.opaque_rects().for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
+            if (!render_rect.intersects(band))
                 return IterationDecision::Continue;
-            });
-        }
+            Gfx::PainterStateSaver saver(back_painter);
+            back_painter.add_clip_rect(render_rect);
+            compose_window_rect(back_painter, render_rect);
+            return IterationDecision::Continue;
+        });
 
         // Render the wallpaper for any transparency directly covering
         // the wallpaper
-        auto& transparency_wallpaper_rects = window.transparency_wallpaper_rects();
-        if (!transparency_wallpaper_rects.is_empty()) {
-            transparency_wallpaper_rects.for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
-                dbgln_if(COMPOSE_DEBUG, "    render wallpaper: {}", render_rect);
-
-                prepare_transparency_rect(render_rect);
+        window.transparency_wallpaper_rects().for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
+            if (render_rect.intersects(band))
                 paint_wallpaper(temp_painter, render_rect);
-                return IterationDecision::Continue;
-            });
-        }
-        auto& transparency_rects = window.transparency_rects();
-        if (!transparency_rects.is_empty()) {
-            transparency_rects.for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
-                dbgln_if(COMPOSE_DEBUG, "    render transparent: {}", render_rect);
+            return IterationDecision::Continue;
+        });
 
-                prepare_transparency_rect(render_rect);
-                Gfx::PainterStateSaver saver(temp_painter);
-                temp_painter.add_clip_rect(render_rect);
-                compose_window_rect(temp_painter, render_rect);
+        window.transparency_rects().for_each_intersected(dirty_rects, [&](const Gfx::IntRect& render_rect) {
+            if (!render_rect.intersects(band))
                 return IterationDecision::Continue;
-            });
-        }
-        return IterationDecision::Continue;
+            Gfx::PainterStateSaver saver(temp_painter);
+            temp_painter.add_clip_rect(render_rect);
+            compose_window_rect(temp_painter, render_rect);
+            return IterationDecision::Continue;
+        });
     };
 
-    // Paint the window stack.
-    if (m_invalidated_window) {
-        if (auto* fullscreen_window = wm.active_fullscreen_window()) {
-            compose_window(*fullscreen_window);
-            fullscreen_window->clear_dirty_rects();
-        } else {
-            wm.for_each_visible_window_from_back_to_front([&](Window& window) {
-                compose_window(window);
-                window.clear_dirty_rects();
-                return IterationDecision::Continue;
-            });
-        }
+    auto compose_band = [&](const Gfx::IntRect& band) {
+        auto back_painter = *m_back_painter;
+        auto temp_painter = *m_temp_painter;
+        back_painter.add_clip_rect(band);
+        temp_painter.add_clip_rect(band);
 
-        // Check that there are no overlapping transparent and opaque flush rectangles
-        VERIFY(![&]() {
-            for (auto& rect_transparent : flush_transparent_rects.rects()) {
-                for (auto& rect_opaque : flush_rects.rects()) {
-                    if (rect_opaque.intersects(rect_transparent)) {
-                        dbgln("Transparent rect {} overlaps opaque rect: {}: {}", rect_transparent, rect_opaque, rect_opaque.intersected(rect_transparent));
-                        return true;
-                    }
-                }
-            }
-            return false;
-        }());
+        m_opaque_wallpaper_rects.for_each_intersected(dirty_screen_rects, [&](const Gfx::IntRect& render_rect) {
+            if (render_rect.intersects(band))
+                paint_wallpaper(back_painter, render_rect);
+            return IterationDecision::Continue;
+        });
+
+        if (!m_invalidated_window)
+            return;
+
+        // Paint the window stack.
+        for_each_window_to_compose([&](Window& window) {
+            compose_window(window, back_painter, temp_painter, band);
+        });
 
         // Copy anything rendered to the temporary buffer to the back buffer
-        for (auto& rect : flush_transparent_rects.rects())
-            back_painter.blit(rect.location(), *m_temp_bitmap, rect);
+        for (auto& rect : flush_transparent_rects.rects()) {
+            if (rect.intersects(band))
+                back_painter.blit(rect.location(), *m_temp_bitmap, rect);
+        }
+    };
+
+    // Split what is to be painted into bands of whole rows, so that none of them touch the same pixels. Small updates
+    // aren't worth waking up the other threads for.
+    Gfx::IntRect compose_rect;
+    for (auto& rect : flush_rects.rects())
+        compose_rect = compose_rect.united(rect);
+    for (auto& rect : flush_transparent_rects.rects())
+        compose_rect = compose_rect.united(rect);
+
+    size_t band_count = 1;
+    if (compose_rect.width() * compose_rect.height() >= min_pixel_count_to_compose_in_bands)
+        band_count = min((m_compose_workers.thread_count() + 1) * 2, (size_t)compose_rect.height());
+
+    if (band_count <= 1) {
+        compose_band(ws.rect());
+    } else {
+        m_compose_workers.run(band_count, [&](size_t index) {
+            int top = compose_rect.top() + compose_rect.height() * index / band_count;
+            int bottom = compose_rect.top() + compose_rect.height() * (index + 1) / band_count;
+            compose_band({ compose_rect.left(), top, compose_rect.width(), bottom - top });
+        });
+    }
+
+    if (m_invalidated_window) {
+        for_each_window_to_compose([&](Window& window) {
+            window.clear_dirty_rects();
+        });
 
         Gfx::IntRect geometry_label_damage_rect;
         if (draw_geometry_label(geometry_label_damage_rect))
@@ -439,6 +525,8 @@ void Compositor::compose()
     m_invalidated_window = false;
     m_invalidated_cursor = false;
 
+    auto back_painter = *m_back_painter;
+
     if (wm.dnd_client()) {
         auto dnd_rect = wm.dnd_rect();
 
@@ -502,6 +590,83 @@ void Compositor::compose()
         flush(rect);
 }
 
+bool Compositor::compose_fullscreen_window_directly(Window& window, const Gfx::IntRect& cursor_rect)
+{
+    // Without buffer flipping, everything composed into the back bitmap gets copied to the screen. A fullscreen window
+    // that covers every pixel of it can skip that and be copied to the screen straight from its backing store. That
+    // only works as long as nothing else has to be drawn on top of it.
+    if (m_screen_can_set_buffer || m_flash_flush || m_invalidated_cursor || !m_cursor_back_bitmap)
+        return false;
+
+    auto& wm = WindowManager::the();
+    auto& ws = Screen::the();
+    if (ws.scale_factor() != 1 || wm.dnd_client() || !m_last_dnd_rect.is_empty() || !m_last_geometry_label_damage_rect.is_empty())
+        return false;
+    if (wm.m_move_window || wm.m_resize_window)
+        return false;
+
+    auto* backing_store = window.backing_store();
+    if (!backing_store || backing_store->has_alpha_channel() || !window.is_opaque())
+        return false;
+    if (window.rect() != ws.rect() || backing_store->size() != ws.size())
+        return false;
+    if (window.client() && window.client()->is_unresponsive())
+        return false;
+
+    bool any_window_is_animating = false;
+    wm.for_each_window([&](Window& other_window) {
+        if (!other_window.in_minimize_animation())
+            return IterationDecision::Continue;
+        any_window_is_animating = true;
+        return IterationDecision::Break;
+    });
+    if (any_window_is_animating)
+        return false;
+
+    auto& dirty_rects = window.dirty_rects();
+    if (dirty_rects.intersects(cursor_rect))
+        return false;
+
+    dbgln_if(COMPOSE_DEBUG, "COMPOSE: copying fullscreen window {} to the screen directly", window.title());
+
+    size_t pitch = m_front_bitmap->pitch();
+    for (auto& dirty_rect : dirty_rects.rects()) {
+        auto rect = dirty_rect.intersected(ws.rect());
+        if (rect.is_empty())
+            continue;
+        const Gfx::RGBA32* from_ptr = backing_store->scanline(rect.y()) + rect.x();
+        Gfx::RGBA32* to_ptr = m_front_bitmap->scanline(rect.y()) + rect.x();
+        for (int y = 0; y < rect.height(); ++y) {
+            fast_u32_copy(to_ptr, from_ptr, rect.width());
+            from_ptr = (const Gfx::RGBA32*)((const u8*)from_ptr + backing_store->pitch());
+            to_ptr = (Gfx::RGBA32*)((u8*)to_ptr + pitch);
+        }
+        m_stale_back_bitmap_rects.add(rect);
+    }
+
+    window.clear_dirty_rects();
+    m_invalidated_any = false;
+    m_invalidated_window = false;
+    return true;
+}
+
+void Compositor::update_stale_back_bitmap_rects()
+{
+    // Bring the back bitmap up to date with what was copied to the screen directly, before anything gets composed into
+    // it (and flushed to the screen) again.
+    size_t pitch = m_back_bitmap->pitch();
+    for (auto& rect : m_stale_back_bitmap_rects.rects()) {
+        const Gfx::RGBA32* from_ptr = m_front_bitmap->scanline(rect.y()) + rect.x();
+        Gfx::RGBA32* to_ptr = m_back_bitmap->scanline(rect.y()) + rect.x();
+        for (int y = 0; y < rect.height(); ++y) {
+            fast_u32_copy(to_ptr, from_ptr, rect.width());
+            from_ptr = (const Gfx::RGBA32*)((const u8*)from_ptr + pitch);
+            to_ptr = (Gfx::RGBA32*)((u8*)to_ptr + pitch);
+        }
+    }
+    m_stale_back_bitmap_rects.clear();
+}
+
 void Compositor::flush(const Gfx::IntRect& a_rect)
 {
     auto rect = Gfx::IntRect::intersection(a_rect, Screen::the().rect());
@@ -804,16 +969,32 @@ void Compositor::restore_cursor_back()
 
 void Compositor::notify_display_links()
 {
-    ClientConnection::for_each_client([](auto& client) {
-        client.notify_display_link({});
+    // Frames fall on a fixed grid, so they don't drift by however late the timer fires. If we fell behind by more than
+    // a frame, start over from now instead of handing out a burst of stale ones.
+    auto now = monotonic_now();
+    if (m_next_display_link_frame_time + display_link_frame_interval <= now)
+        m_next_display_link_frame_time = now;
+    auto frame_time = m_next_display_link_frame_time;
+    m_next_display_link_frame_time = frame_time + display_link_frame_interval;
+
+    // Present whatever clients drew for the previous frame before asking them for the next one.
+    if (m_invalidated_any)
+        compose();
+
+    ClientConnection::for_each_client([&](auto& client) {
+        client.notify_display_link({}, frame_time.to_microseconds());
     });
+
+    m_display_link_notify_timer->start(max((m_next_display_link_frame_time - monotonic_now()).to_milliseconds(), (i64)0));
 }
 
 void Compositor::increment_display_link_count(Badge<ClientConnection>)
 {
     ++m_display_link_count;
-    if (m_display_link_count == 1)
-        m_display_link_notify_timer->start();
+    if (m_display_link_count == 1) {
+        m_next_display_link_frame_time = monotonic_now() + display_link_frame_interval;
+        m_display_link_notify_timer->start(display_link_frame_interval.to_milliseconds());
+    }
 }
 
 void Compositor::decrement_display_link_count(Badge<ClientConnection>)
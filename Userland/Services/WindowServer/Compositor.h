@@ -8,9 +8,11 @@
 
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
+#include <AK/Time.h>
 #include <LibCore/Object.h>
 #include <LibGfx/Color.h>
 #include <LibGfx/DisjointRectSet.h>
+#include <LibThread/WorkerPool.h>
 
 namespace WindowServer {
 
@@ -63,6 +65,8 @@ private:
     void init_bitmaps();
     void flip_buffers();
     void flush(const Gfx::IntRect&);
+    bool compose_fullscreen_window_directly(Window&, const Gfx::IntRect& cursor_rect);
+    void update_stale_back_bitmap_rects();
     void run_animations(Gfx::DisjointRectSet&);
     void notify_display_links();
     void start_compose_async_timer();
@@ -92,6 +96,10 @@ private:
 
     Gfx::DisjointRectSet m_dirty_screen_rects;
     Gfx::DisjointRectSet m_opaque_wallpaper_rects;
+    // Rects that a fullscreen window was copied to the front bitmap in directly, which are out of date in the back bitmap.
+    Gfx::DisjointRectSet m_stale_back_bitmap_rects;
+
+    LibThread::WorkerPool m_compose_workers { "Compositor" };
 
     RefPtr<Gfx::Bitmap> m_cursor_back_bitmap;
     OwnPtr<Gfx::Painter> m_cursor_back_painter;
@@ -109,6 +117,7 @@ private:
 
     RefPtr<Core::Timer> m_display_link_notify_timer;
     size_t m_display_link_count { 0 };
+    Time m_next_display_link_frame_time;
 
     Optional<Gfx::Color> m_custom_background_color;
 };
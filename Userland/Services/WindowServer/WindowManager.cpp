@@ -13,6 +13,7 @@
 #include "Screen.h"
 #include "Window.h"
 #include <AK/Debug.h>
+#include <AK/ScopeGuard.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Vector.h>
 #include <LibGUI/WindowManagerServerConnection.h>
@@ -1172,6 +1173,16 @@ Gfx::IntRect WindowManager::arena_rect_for_type(WindowType type) const
 
 void WindowManager::event(Core::Event& event)
 {
+    // One input event often turns into several messages for the same client (say WindowLeft, WindowEntered
+    // and MouseMove), so send each client everything it gets from this event at once.
+    bool is_input_event = static_cast<Event&>(event).is_mouse_event() || static_cast<Event&>(event).is_key_event();
+    if (is_input_event)
+        ClientConnection::for_each_client([](auto& client) { client.cork(); });
+    ScopeGuard uncork_clients = [&] {
+        if (is_input_event)
+            ClientConnection::for_each_client([](auto& client) { client.uncork(); });
+    };
+
     if (static_cast<Event&>(event).is_mouse_event()) {
         if (event.type() != Event::MouseMove)
             m_previous_event_was_super_keydown = false;
@@ -708,6 +708,17 @@ int Shell::builtin_pwd(int, const char**)
     return 0;
 }
 
+int Shell::builtin_rehash(int argc, const char** argv)
+{
+    Core::ArgsParser parser;
+    if (!parser.parse(argc, const_cast<char**>(argv), false))
+        return 1;
+
+    m_command_path_cache.clear();
+    cache_path();
+    return 0;
+}
+
 int Shell::builtin_setopt(int argc, const char** argv)
 {
     if (argc == 1) {
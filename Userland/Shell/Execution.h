@@ -22,6 +22,7 @@ public:
 
     void collect();
     void add(int fd);
+    bool is_empty() const { return m_fds.is_empty(); }
 
 private:
     Vector<int, 32> m_fds;
@@ -25,6 +25,7 @@
 #include <inttypes.h>
 #include <pwd.h>
 #include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -720,6 +721,32 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
 
     argv.append(nullptr);
 
+    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
+    bool should_set_pgid = !m_is_subshell || command.pipeline;
+
+    // A plain external command doesn't need a copy of the Shell to set it up, so it can be spawned directly.
+    // A foreground command that is handed the terminal is the exception, as it must not start before that happens.
+    auto can_be_spawned = !command.should_immediately_execute_next
+        && !command.argv.is_empty()
+        && rewirings.is_empty()
+        && fds.is_empty()
+        && (m_is_subshell || !isatty(STDIN_FILENO))
+        && !has_builtin(command.argv.first())
+        && !has_function(command.argv.first());
+
+    if (can_be_spawned) {
+        auto program_path = find_spawnable_command(command.argv.first());
+        if (!program_path.is_null()) {
+            Optional<pid_t> pgid;
+            if (should_set_pgid)
+                pgid = is_first ? 0 : command.pipeline->pgid;
+            if (auto child = spawn_process(program_path, argv, pgid); child >= 0)
+                return add_job_for_child(command, child, is_first ? child : command.pipeline->pgid);
+            // The program may have moved since it was looked up, so forget it and let execute_process() deal with it.
+            m_command_path_cache.remove(command.argv.first());
+        }
+    }
+
     int sync_pipe[2];
     if (pipe(sync_pipe) < 0) {
         perror("pipe");
@@ -788,16 +815,8 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[0]);
 
-    bool is_first = !command.pipeline || (command.pipeline && command.pipeline->pgid == -1);
-
-    if (command.pipeline) {
-        if (is_first) {
-            command.pipeline->pgid = child;
-        }
-    }
-
     pid_t pgid = is_first ? child : (command.pipeline ? command.pipeline->pgid : child);
-    if (!m_is_subshell || command.pipeline) {
+    if (should_set_pgid) {
         if (setpgid(child, pgid) < 0 && m_is_interactive)
             perror("setpgid");
 
@@ -821,6 +840,16 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
 
     close(sync_pipe[1]);
 
+    auto job = add_job_for_child(command, child, pgid);
+    fds.collect();
+    return job;
+}
+
+NonnullRefPtr<Job> Shell::add_job_for_child(const AST::Command& command, pid_t child, pid_t pgid)
+{
+    if (command.pipeline && command.pipeline->pgid == -1)
+        command.pipeline->pgid = child;
+
     StringBuilder cmd;
     cmd.join(" ", command.argv);
 
@@ -847,9 +876,69 @@ RefPtr<Job> Shell::run_command(const AST::Command& command)
         run_tail(job);
     };
 
-    fds.collect();
+    return job;
+}
 
-    return *job;
+String Shell::find_spawnable_command(const String& name)
+{
+    String path = getenv("PATH");
+    if (path != m_command_path_cache_path) {
+        m_command_path_cache.clear();
+        m_command_path_cache_path = path;
+    }
+
+    if (auto cached_program_path = m_command_path_cache.get(name); cached_program_path.has_value())
+        return cached_program_path.value();
+
+    // This has to find the same program that execvp() would, or nothing at all.
+    String program_path;
+    if (!name.contains("/")) {
+        for (auto& directory : (path.is_empty() ? String("/bin:/usr/bin") : path).split(':')) {
+            // Programs in relative directories depend on the current directory, so they can't be remembered.
+            if (!directory.starts_with('/'))
+                break;
+            auto candidate = String::formatted("{}/{}", directory, name);
+            struct stat st;
+            if (stat(candidate.characters(), &st) < 0) {
+                if (errno == ENOENT)
+                    continue;
+                break;
+            }
+            if (S_ISREG(st.st_mode) && access(candidate.characters(), X_OK) == 0)
+                program_path = move(candidate);
+            break;
+        }
+    }
+
+    // Scripts are left to execute_process(), which knows how to find interpreters that aren't given by absolute path.
+    if (!program_path.is_null()) {
+        char magic[4] {};
+        int fd = open(program_path.characters(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0 || read(fd, magic, sizeof(magic)) != sizeof(magic) || memcmp(magic, "\x7f" "ELF", sizeof(magic)) != 0)
+            program_path = {};
+        if (fd >= 0)
+            close(fd);
+    }
+
+    m_command_path_cache.set(name, program_path);
+    return program_path;
+}
+
+pid_t Shell::spawn_process(const String& program_path, const Vector<const char*>& argv, Optional<pid_t> pgid)
+{
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    if (pgid.has_value()) {
+        posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attributes, pgid.value());
+    }
+
+    pid_t child;
+    int rc = posix_spawn(&child, program_path.characters(), nullptr, &attributes, const_cast<char* const*>(argv.data()), environ);
+    posix_spawnattr_destroy(&attributes);
+    if (rc != 0)
+        return -1;
+    return child;
 }
 
 void Shell::execute_process(Vector<const char*>&& argv)
@@ -1327,30 +1416,85 @@ Vector<Line::CompletionSuggestion> Shell::complete_path(const String& base,
     if (m_editor)
         m_editor->suggest(token_length, last_slash + 1);
 
-    // only suggest dot-files if path starts with a dot
-    Core::DirIterator files(path,
-        token.starts_with('.') ? Core::DirIterator::SkipParentAndBaseDir : Core::DirIterator::SkipDots);
-
     Vector<Line::CompletionSuggestion> suggestions;
 
+    for (auto& entry : completion_entries_in(path)) {
+        // only suggest dot-files if path starts with a dot
+        if (entry.name.starts_with('.') && !token.starts_with('.'))
+            continue;
+        if (!entry.name.starts_with(token))
+            continue;
+        // Changing the mode of a file doesn't change its directory, so this can't be cached.
+        if (executable_only == ExecutableOnly::Yes && access(String::formatted("{}/{}", path, entry.name).characters(), X_OK) != 0)
+            continue;
+        suggestions.append({ escape_token(entry.name), entry.is_directory ? "/" : " " });
+        suggestions.last().input_offset = token_length;
+    }
+
+    return suggestions;
+}
+
+const Vector<Shell::CompletionDirectoryEntry>& Shell::completion_entries_in(const String& directory)
+{
+    auto path = LexicalPath::canonicalized_path(directory);
+    if (auto it = m_completion_directory_cache.find(path); it != m_completion_directory_cache.end())
+        return it->value;
+
+    // The watch has to be in place before the directory is read, so that no change can slip in between.
+    bool can_cache = watch_completion_directory(path);
+
+    Vector<CompletionDirectoryEntry> entries;
+    Core::DirIterator files(path, Core::DirIterator::SkipParentAndBaseDir);
     while (files.has_next()) {
         auto file = files.next_path();
-        if (file.starts_with(token)) {
-            struct stat program_status;
-            auto file_path = String::formatted("{}/{}", path, file);
-            int stat_error = stat(file_path.characters(), &program_status);
-            if (!stat_error && (executable_only == ExecutableOnly::No || access(file_path.characters(), X_OK) == 0)) {
-                if (S_ISDIR(program_status.st_mode)) {
-                    suggestions.append({ escape_token(file), "/" });
-                } else {
-                    suggestions.append({ escape_token(file), " " });
-                }
-                suggestions.last().input_offset = token_length;
-            }
-        }
+        struct stat file_status;
+        if (stat(String::formatted("{}/{}", path, file).characters(), &file_status) < 0)
+            continue;
+        entries.append({ move(file), S_ISDIR(file_status.st_mode) });
     }
 
-    return suggestions;
+    if (!can_cache) {
+        m_uncached_completion_entries = move(entries);
+        return m_uncached_completion_entries;
+    }
+    m_completion_directory_cache.set(path, move(entries));
+    return m_completion_directory_cache.find(path)->value;
+}
+
+bool Shell::watch_completion_directory([[maybe_unused]] const String& path)
+{
+#ifdef __serenity__
+    // Only a handful of directories are kept around, since most completions happen in the same few places.
+    static constexpr size_t max_cached_directories = 16;
+    if (m_completion_directory_cache.size() >= max_cached_directories)
+        forget_completion_directories();
+
+    if (m_completion_directory_watcher)
+        return !m_completion_directory_watcher->add_watch(path).is_error();
+
+    auto watcher = Core::FileWatcher::watch(path);
+    if (watcher.is_error())
+        return false;
+    m_completion_directory_watcher = watcher.release_value();
+    m_completion_directory_watcher->on_change = [this](const Core::FileWatcherEvent& event) {
+        m_completion_directory_cache.remove(event.path);
+        m_completion_directory_watcher->remove_watch(event.path);
+    };
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Shell::forget_completion_directories()
+{
+#ifdef __serenity__
+    if (m_completion_directory_watcher) {
+        for (auto& it : m_completion_directory_cache)
+            m_completion_directory_watcher->remove_watch(it.key);
+    }
+#endif
+    m_completion_directory_cache.clear();
 }
 
 Vector<Line::CompletionSuggestion> Shell::complete_program_name(const String& name, size_t offset)
@@ -15,6 +15,7 @@
 #include <AK/StringBuilder.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
+#include <LibCore/FileWatcher.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/Object.h>
 #include <LibLine/Editor.h>
@@ -25,6 +26,7 @@
     __ENUMERATE_SHELL_BUILTIN(cd)      \
     __ENUMERATE_SHELL_BUILTIN(cdh)     \
     __ENUMERATE_SHELL_BUILTIN(pwd)     \
+    __ENUMERATE_SHELL_BUILTIN(rehash)  \
     __ENUMERATE_SHELL_BUILTIN(type)    \
     __ENUMERATE_SHELL_BUILTIN(exec)    \
     __ENUMERATE_SHELL_BUILTIN(exit)    \
@@ -273,6 +275,15 @@ private:
 
     void cache_path();
     void add_entry_to_cache(const String&);
+
+    struct CompletionDirectoryEntry {
+        String name;
+        bool is_directory { false };
+    };
+    const Vector<CompletionDirectoryEntry>& completion_entries_in(const String& directory);
+    bool watch_completion_directory(const String& directory);
+    void forget_completion_directories();
+
     void stop_all_jobs();
     const Job* m_current_job { nullptr };
     LocalFrame* find_frame_containing_local_variable(const String& name);
@@ -281,6 +292,12 @@ private:
     void run_tail(const AST::Command&, const AST::NodeWithAction&, int head_exit_code);
 
     [[noreturn]] void execute_process(Vector<const char*>&& argv);
+    NonnullRefPtr<Job> add_job_for_child(const AST::Command&, pid_t child, pid_t pgid);
+
+    // Returns the program in PATH that can be spawned for |name| without going through execute_process(),
+    // or a null String if there's none.
+    String find_spawnable_command(const String& name);
+    pid_t spawn_process(const String& program_path, const Vector<const char*>& argv, Optional<pid_t> pgid);
 
     virtual void custom_event(Core::CustomEvent&) override;
 
@@ -322,6 +339,18 @@ private:
     NonnullRefPtrVector<AST::Redirection> m_global_redirections;
 
     HashMap<String, String> m_aliases;
+
+    // Which program each command name resolved to, for as long as PATH stays the same (or until `rehash`).
+    HashMap<String, String> m_command_path_cache;
+    String m_command_path_cache_path;
+
+    // The entries of the directories that paths were recently completed in, for as long as they stay the same.
+    HashMap<String, Vector<CompletionDirectoryEntry>> m_completion_directory_cache;
+    Vector<CompletionDirectoryEntry> m_uncached_completion_entries;
+#ifdef __serenity__
+    RefPtr<Core::FileWatcher> m_completion_directory_watcher;
+#endif
+
     bool m_is_interactive { true };
     bool m_is_subshell { false };
     bool m_should_reinstall_signal_handlers { true };
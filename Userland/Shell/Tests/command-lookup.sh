@@ -0,0 +1,39 @@
+#!/bin/sh
+
+source $(dirname "$0")/test-commons.inc
+
+rm -rf shell-test
+mkdir -p shell-test/bin shell-test/other-bin
+cd shell-test
+
+    export PATH="$PWD/bin:$PATH"
+
+    # Commands that show up in PATH are found, even if they weren't there before.
+    my-command 2> /dev/null
+    if test $? -ne 127 { fail "ran a command that doesn't exist" }
+    cp /bin/false bin/my-command
+    my-command
+    if test $? -ne 1 { fail "did not run a command that was added to PATH" }
+
+    # Changes to PATH are noticed.
+    cp /bin/true other-bin/my-command
+    export PATH="$PWD/other-bin:$PATH"
+    my-command
+    if test $? -ne 0 { fail "did not notice a change to PATH" }
+
+    # So is a command that went away, after `rehash`.
+    rm other-bin/my-command
+    rehash
+    my-command
+    if test $? -ne 1 { fail "ran a command that was removed from PATH" }
+
+    # Scripts are run too.
+    printf '#!/bin/sh\nexit 42\n' > other-bin/my-script
+    chmod +x other-bin/my-script
+    my-script
+    if test $? -ne 42 { fail "did not run a script" }
+
+cd ..
+rm -rf shell-test
+
+echo PASS
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Types.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+static int epfd;
+
+static bool add(int op, int fd, u32 data)
+{
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u32 = data;
+    if (epoll_ctl(epfd, op, fd, &event) < 0) {
+        perror("epoll_ctl");
+        return false;
+    }
+    return true;
+}
+
+static bool expect_event(u32 data)
+{
+    epoll_event events[4];
+    int rc = epoll_wait(epfd, events, 4, 1000);
+    if (rc < 0) {
+        perror("epoll_wait");
+        return false;
+    }
+    for (int i = 0; i < rc; ++i) {
+        if (events[i].data.u32 == data)
+            return true;
+    }
+    fprintf(stderr, "FAIL: no event for %u (got %d events)\n", data, rc);
+    return false;
+}
+
+// Close an fd while its description stays alive through a dup, then reuse the fd number.
+static bool test_reused_fd(int op)
+{
+    int old_pipe[2];
+    int new_pipe[2];
+    if (pipe(old_pipe) < 0) {
+        perror("pipe");
+        return false;
+    }
+    if (!add(EPOLL_CTL_ADD, old_pipe[0], 1))
+        return false;
+
+    int old_read_dup = dup(old_pipe[0]);
+    close(old_pipe[0]);
+    if (pipe(new_pipe) < 0) {
+        perror("pipe");
+        return false;
+    }
+    if (new_pipe[0] != old_pipe[0]) {
+        fprintf(stderr, "FAIL: fd %d was not reused\n", old_pipe[0]);
+        return false;
+    }
+
+    if (!add(op, new_pipe[0], 2))
+        return false;
+    write(new_pipe[1], "x", 1);
+    if (!expect_event(2))
+        return false;
+
+    close(old_read_dup);
+    close(old_pipe[1]);
+    close(new_pipe[0]);
+    close(new_pipe[1]);
+    return true;
+}
+
+static bool test_delete_closed_fd()
+{
+    int fds[2];
+    if (pipe(fds) < 0) {
+        perror("pipe");
+        return false;
+    }
+    if (!add(EPOLL_CTL_ADD, fds[0], 3))
+        return false;
+    close(fds[0]);
+    close(fds[1]);
+
+    // The entry went away with the description, but the fd being gone must not be an error either way.
+    if (epoll_ctl(epfd, EPOLL_CTL_DEL, fds[0], nullptr) < 0 && errno != ENOENT) {
+        fprintf(stderr, "FAIL: EPOLL_CTL_DEL on a closed fd: %s\n", strerror(errno));
+        return false;
+    }
+
+    // A fresh add under the same fd number must not run into the old entry.
+    if (pipe(fds) < 0) {
+        perror("pipe");
+        return false;
+    }
+    if (!add(EPOLL_CTL_ADD, fds[0], 4))
+        return false;
+    write(fds[1], "x", 1);
+    if (!expect_event(4))
+        return false;
+    close(fds[0]);
+    close(fds[1]);
+    return true;
+}
+
+int main(int, char**)
+{
+    epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        perror("epoll_create1");
+        return 1;
+    }
+
+    if (!test_reused_fd(EPOLL_CTL_ADD) || !test_reused_fd(EPOLL_CTL_MOD) || !test_delete_closed_fd())
+        return 1;
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <LibCore/ElapsedTimer.h>
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static constexpr size_t line_count = 200000;
+
+// Lines of all kinds of lengths, some longer than the buffer stdio starts out with.
+static size_t length_of_line(size_t index)
+{
+    return index % 1500;
+}
+
+static size_t write_test_file(const char* path)
+{
+    auto* file = fopen(path, "w");
+    assert(file);
+    size_t total_size = 0;
+    for (size_t i = 0; i < line_count; ++i) {
+        auto length = length_of_line(i);
+        for (size_t j = 0; j < length; ++j)
+            fputc('a' + (i + j) % 26, file);
+        fputc('\n', file);
+        total_size += length + 1;
+    }
+    // The last line has no newline.
+    fputs("the end", file);
+    total_size += 7;
+    assert(fclose(file) == 0);
+    return total_size;
+}
+
+static void report(const char* name, size_t size, const Core::ElapsedTimer& timer)
+{
+    auto elapsed_ms = max(timer.elapsed(), 1);
+    printf("%-10s %6d ms, %8.1f MiB/s\n", name, elapsed_ms, (double)size / MiB / (elapsed_ms / 1000.0));
+}
+
+static void test_getline(const char* path, size_t total_size)
+{
+    auto* file = fopen(path, "r");
+    assert(file);
+    char* line = nullptr;
+    size_t line_size = 0;
+    size_t index = 0;
+    size_t size = 0;
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    ssize_t nread;
+    while ((nread = getline(&line, &line_size, file)) > 0) {
+        if (index < line_count) {
+            assert((size_t)nread == length_of_line(index) + 1);
+            assert(line[nread - 1] == '\n');
+        } else {
+            assert(!strcmp(line, "the end"));
+        }
+        assert(strlen(line) == (size_t)nread);
+        size += nread;
+        ++index;
+    }
+    report("getline", size, timer);
+
+    assert(index == line_count + 1);
+    assert(size == total_size);
+    assert(feof(file));
+    free(line);
+    fclose(file);
+}
+
+static void test_fgets(const char* path, size_t total_size)
+{
+    auto* file = fopen(path, "r");
+    assert(file);
+    char line[4096];
+    size_t size = 0;
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    while (fgets(line, sizeof(line), file))
+        size += strlen(line);
+    report("fgets", size, timer);
+
+    assert(size == total_size);
+    fclose(file);
+}
+
+static void test_fgetc(const char* path, size_t total_size)
+{
+    auto* file = fopen(path, "r");
+    assert(file);
+    size_t size = 0;
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    while (fgetc(file) != EOF)
+        ++size;
+    report("fgetc", size, timer);
+
+    assert(size == total_size);
+    fclose(file);
+}
+
+static void test_fread(const char* path, size_t total_size)
+{
+    auto* file = fopen(path, "r");
+    assert(file);
+    char buffer[1000];
+    size_t size = 0;
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    size_t nread;
+    while ((nread = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        size += nread;
+    report("fread", size, timer);
+
+    assert(size == total_size);
+    fclose(file);
+}
+
+static void test_position_after_reading(const char* path)
+{
+    // However much stdio has buffered behind the scenes, the position has to be where the caller left off.
+    auto* file = fopen(path, "r");
+    assert(file);
+    char* line = nullptr;
+    size_t line_size = 0;
+    long expected_position = 0;
+    for (size_t i = 0; i < 1000; ++i)
+        expected_position += getline(&line, &line_size, file);
+    assert(ftell(file) == expected_position);
+
+    assert(ungetc('x', file) == 'x');
+    assert(getline(&line, &line_size, file) == (ssize_t)length_of_line(1000) + 2);
+    assert(line[0] == 'x');
+    free(line);
+    fclose(file);
+}
+
+static void test_user_buffer(const char* path)
+{
+    // A buffer given to us with setvbuf() must be used as-is, no matter how much is read.
+    auto* file = fopen(path, "r");
+    assert(file);
+    char buffer[100];
+    assert(setvbuf(file, buffer, _IOFBF, sizeof(buffer)) == 0);
+    char* line = nullptr;
+    size_t line_size = 0;
+    size_t count = 0;
+    while (getline(&line, &line_size, file) > 0)
+        ++count;
+    assert(count == line_count + 1);
+    free(line);
+    fclose(file);
+}
+
+int main(int, char**)
+{
+    char path[] = "/tmp/stdio-throughput.XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+
+    auto total_size = write_test_file(path);
+    test_getline(path, total_size);
+    test_fgets(path, total_size);
+    test_fgetc(path, total_size);
+    test_fread(path, total_size);
+    test_position_after_reading(path);
+    test_user_buffer(path);
+
+    unlink(path);
+    printf("PASS\n");
+    return 0;
+}
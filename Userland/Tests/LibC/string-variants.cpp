@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/Vector.h>
+#include <bits/string_variants.h>
+#include <string.h>
+
+#ifdef __i386__
+
+static bool has_sse2()
+{
+    u32 eax, ebx, ecx, edx;
+    asm volatile("cpuid"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(1), "c"(0));
+    return edx & (1 << 26);
+}
+
+static Vector<u8> make_buffer(size_t size)
+{
+    Vector<u8> buffer;
+    buffer.resize(size);
+    for (size_t i = 0; i < size; ++i)
+        buffer[i] = (u8)(i * 7 + 1);
+    return buffer;
+}
+
+TEST_CASE(memcpy_variants_agree)
+{
+    if (!has_sse2())
+        return;
+    auto source = make_buffer(300);
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t size = 0; size < 280; size += 3) {
+            u8 expected[300] {};
+            u8 actual[300] {};
+            __memcpy_rep_movsb(expected + offset, source.data() + 15 - offset, size);
+            __memcpy_sse2(actual + offset, source.data() + 15 - offset, size);
+            EXPECT(!memcmp(expected, actual, sizeof(expected)));
+        }
+    }
+}
+
+TEST_CASE(memset_variants_agree)
+{
+    if (!has_sse2())
+        return;
+    for (size_t offset = 0; offset < 16; ++offset) {
+        for (size_t size = 0; size < 280; size += 3) {
+            u8 expected[300] {};
+            u8 actual[300] {};
+            __memset_rep_stos(expected + offset, 0xa5, size);
+            __memset_sse2(actual + offset, 0xa5, size);
+            EXPECT(!memcmp(expected, actual, sizeof(expected)));
+        }
+    }
+}
+
+TEST_CASE(strlen_variants_agree)
+{
+    if (!has_sse2())
+        return;
+    alignas(16) char buffer[128];
+    memset(buffer, 'x', sizeof(buffer));
+    for (size_t start = 0; start < 16; ++start) {
+        for (size_t end = start; end < sizeof(buffer); ++end) {
+            buffer[end] = 0;
+            EXPECT_EQ(__strlen_sse2(buffer + start), end - start);
+            EXPECT_EQ(__strlen_generic(buffer + start), end - start);
+            buffer[end] = 'x';
+        }
+    }
+}
+
+TEST_CASE(memchr_variants_agree)
+{
+    if (!has_sse2())
+        return;
+    alignas(16) char buffer[128];
+    memset(buffer, 'x', sizeof(buffer));
+    for (size_t start = 0; start < 16; ++start) {
+        for (size_t size = 0; size < sizeof(buffer) - start; ++size) {
+            for (size_t needle : { (size_t)0, size / 2, size, size + 1 }) {
+                if (start + needle < sizeof(buffer))
+                    buffer[start + needle] = 'y';
+                EXPECT_EQ(__memchr_sse2(buffer + start, 'y', size), __memchr_generic(buffer + start, 'y', size));
+                if (start + needle < sizeof(buffer))
+                    buffer[start + needle] = 'x';
+            }
+        }
+    }
+}
+
+static constexpr size_t small_size = 48;
+static constexpr size_t large_size = 1 * MiB;
+
+template<typename Callback>
+static void copy_benchmark(size_t size, size_t run_count, Callback callback)
+{
+    auto source = make_buffer(size);
+    auto destination = make_buffer(size);
+    for (size_t run = 0; run < run_count; ++run)
+        callback(destination.data(), source.data(), size);
+}
+
+BENCHMARK_CASE(memcpy_small_rep_movsb)
+{
+    copy_benchmark(small_size, 5'000'000, __memcpy_rep_movsb);
+}
+
+BENCHMARK_CASE(memcpy_small_sse2)
+{
+    if (has_sse2())
+        copy_benchmark(small_size, 5'000'000, __memcpy_sse2);
+}
+
+BENCHMARK_CASE(memcpy_large_rep_movsb)
+{
+    copy_benchmark(large_size, 500, __memcpy_rep_movsb);
+}
+
+BENCHMARK_CASE(memcpy_large_sse2)
+{
+    if (has_sse2())
+        copy_benchmark(large_size, 500, __memcpy_sse2);
+}
+
+template<typename Callback>
+static void fill_benchmark(size_t size, size_t run_count, Callback callback)
+{
+    auto destination = make_buffer(size);
+    for (size_t run = 0; run < run_count; ++run)
+        callback(destination.data(), (int)run, size);
+}
+
+BENCHMARK_CASE(memset_large_rep_stos)
+{
+    fill_benchmark(large_size, 500, __memset_rep_stos);
+}
+
+BENCHMARK_CASE(memset_large_sse2)
+{
+    if (has_sse2())
+        fill_benchmark(large_size, 500, __memset_sse2);
+}
+
+template<typename Callback>
+static void scan_benchmark(size_t run_count, Callback callback)
+{
+    auto buffer = make_buffer(large_size);
+    for (auto& byte : buffer) {
+        if (byte == 0 || byte == '!')
+            byte = 1;
+    }
+    buffer.last() = 0;
+    for (size_t run = 0; run < run_count; ++run)
+        callback((const char*)buffer.data(), buffer.size() - 1);
+}
+
+BENCHMARK_CASE(strlen_generic)
+{
+    scan_benchmark(200, [](const char* string, size_t length) {
+        EXPECT_EQ(__strlen_generic(string), length);
+    });
+}
+
+BENCHMARK_CASE(strlen_sse2)
+{
+    if (!has_sse2())
+        return;
+    scan_benchmark(200, [](const char* string, size_t length) {
+        EXPECT_EQ(__strlen_sse2(string), length);
+    });
+}
+
+BENCHMARK_CASE(memchr_generic)
+{
+    scan_benchmark(200, [](const char* data, size_t size) {
+        EXPECT(!__memchr_generic(data, '!', size));
+    });
+}
+
+BENCHMARK_CASE(memchr_sse2)
+{
+    if (!has_sse2())
+        return;
+    scan_benchmark(200, [](const char* data, size_t size) {
+        EXPECT(!__memchr_sse2(data, '!', size));
+    });
+}
+
+#endif
+
+TEST_MAIN(StringVariants)
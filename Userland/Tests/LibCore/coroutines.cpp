@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/StringView.h>
+#include <LibCore/Coroutine.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/File.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static Core::Task<int> wait_for_value(Core::AsyncEvent& event)
+{
+    co_await event.wait();
+    co_return 21;
+}
+
+static Core::Task<int> double_value(Core::AsyncEvent& event)
+{
+    auto value = co_await wait_for_value(event);
+    co_return value * 2;
+}
+
+static Core::Task<> store_value(Core::AsyncEvent& event, int& result)
+{
+    result = co_await double_value(event);
+}
+
+static void test_task_chain_resumes_on_notify()
+{
+    Core::AsyncEvent event;
+    int result = 0;
+    auto task = store_value(event, result);
+    assert(!task.is_done());
+
+    task.start();
+    assert(event.has_waiter());
+    assert(result == 0);
+
+    event.notify();
+    assert(result == 42);
+    assert(task.is_done());
+
+    // Nobody is waiting anymore, so this does nothing.
+    event.notify();
+}
+
+static void test_destroying_suspended_task()
+{
+    Core::AsyncEvent event;
+    int result = 0;
+    {
+        auto task = store_value(event, result);
+        task.start();
+        assert(event.has_waiter());
+    }
+    assert(!event.has_waiter());
+    event.notify();
+    assert(result == 0);
+}
+
+static Core::Task<> echo_once(Core::IODevice& input, Core::IODevice& output, Core::EventLoop& loop)
+{
+    auto data = co_await Core::async_read(input, 64);
+    auto success = co_await Core::async_write(output, data);
+    assert(success);
+    loop.quit(0);
+}
+
+static void test_async_read_and_write(Core::EventLoop& loop)
+{
+    int input_fds[2];
+    int output_fds[2];
+    assert(pipe(input_fds) == 0);
+    assert(pipe(output_fds) == 0);
+    fcntl(output_fds[1], F_SETFL, O_NONBLOCK);
+
+    auto input = Core::File::construct();
+    input->open(input_fds[0], Core::IODevice::ReadOnly, Core::File::ShouldCloseFileDescriptor::Yes);
+    auto output = Core::File::construct();
+    output->open(output_fds[1], Core::IODevice::WriteOnly, Core::File::ShouldCloseFileDescriptor::Yes);
+
+    auto task = echo_once(*input, *output, loop);
+    task.start();
+    // The pipe is still empty, so the task has to be waiting for it.
+    assert(!task.is_done());
+
+    auto message = "Well hello friends!"sv;
+    assert(write(input_fds[1], message.characters_without_null_termination(), message.length()) == (ssize_t)message.length());
+    loop.exec();
+    assert(task.is_done());
+
+    char buffer[64] {};
+    assert(read(output_fds[0], buffer, sizeof(buffer)) == (ssize_t)message.length());
+    assert(message == buffer);
+
+    close(input_fds[1]);
+    close(output_fds[0]);
+}
+
+int main(int, char**)
+{
+    Core::EventLoop loop;
+    test_task_chain_resumes_on_notify();
+    test_destroying_suspended_task();
+    test_async_read_and_write(loop);
+
+    printf("PASS\n");
+    return 0;
+}
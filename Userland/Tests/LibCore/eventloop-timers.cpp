@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NonnullRefPtrVector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Object.h>
+#include <assert.h>
+#include <stdio.h>
+
+class TimerObject final : public Core::Object {
+    C_OBJECT(TimerObject);
+
+public:
+    size_t fire_count() const { return m_fire_count; }
+
+private:
+    TimerObject() = default;
+
+    virtual void timer_event(Core::TimerEvent&) override { ++m_fire_count; }
+
+    size_t m_fire_count { 0 };
+};
+
+// Fires a single short timer while |idle_timer_count| long timers sit around waiting, and reports what one
+// pass through the event loop costs. That cost should barely grow with the number of idle timers.
+static void benchmark_timer_count(Core::EventLoop& loop, size_t idle_timer_count)
+{
+    constexpr size_t iterations = 20000;
+
+    NonnullRefPtrVector<TimerObject> idle_objects;
+    for (size_t i = 0; i < idle_timer_count; ++i) {
+        auto object = TimerObject::construct();
+        object->start_timer(3'600'000 + i);
+        idle_objects.append(move(object));
+    }
+
+    auto busy_object = TimerObject::construct();
+    busy_object->start_timer(0);
+
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    for (size_t i = 0; i < iterations; ++i)
+        loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    auto elapsed_ms = timer.elapsed();
+
+    assert(busy_object->fire_count() > 0);
+    for (auto& object : idle_objects)
+        assert(object.fire_count() == 0);
+
+    printf("%6zu idle timers: %8.3f us per event loop iteration\n", idle_timer_count, elapsed_ms * 1000.0 / iterations);
+}
+
+static void test_timers_fire_in_order(Core::EventLoop& loop)
+{
+    auto first = TimerObject::construct();
+    auto second = TimerObject::construct();
+    second->start_timer(20);
+    first->start_timer(0);
+
+    loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    assert(first->fire_count() == 1);
+    assert(second->fire_count() == 0);
+
+    second->stop_timer();
+    first->stop_timer();
+    second->start_timer(0);
+    loop.pump(Core::EventLoop::WaitMode::PollForEvents);
+    assert(first->fire_count() == 1);
+    assert(second->fire_count() == 1);
+}
+
+int main(int, char**)
+{
+    Core::EventLoop loop;
+    test_timers_fire_in_order(loop);
+
+    for (size_t count : { 0, 10, 100, 1000, 10000, 100000 })
+        benchmark_timer_count(loop, count);
+
+    printf("PASS\n");
+    return 0;
+}
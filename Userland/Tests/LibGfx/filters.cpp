@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/TestSuite.h>
+
+#include <LibGfx/Bitmap.h>
+#include <LibGfx/Filters/GenericConvolutionFilter.h>
+#include <stdlib.h>
+
+template<size_t N>
+static Gfx::Matrix<N, float> box_kernel()
+{
+    Gfx::Matrix<N, float> kernel;
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = 0; j < N; ++j)
+            kernel.elements()[i][j] = 1;
+    }
+    Gfx::normalize(kernel);
+    return kernel;
+}
+
+template<size_t N>
+static Gfx::Matrix<N, float> gaussian_kernel()
+{
+    Gfx::Matrix<N, float> kernel;
+    constexpr int offset = N / 2;
+    for (int x = -offset; x <= offset; ++x) {
+        for (int y = -offset; y <= offset; ++y)
+            kernel.elements()[x + offset][y + offset] = expf(-(x * x + y * y) / 2.0f);
+    }
+    Gfx::normalize(kernel);
+    return kernel;
+}
+
+static RefPtr<Gfx::Bitmap> create_noise_bitmap(const Gfx::IntSize& size)
+{
+    auto bitmap = Gfx::Bitmap::create(Gfx::BitmapFormat::BGRA8888, size);
+    srand(0);
+    for (int y = 0; y < size.height(); ++y) {
+        for (int x = 0; x < size.width(); ++x)
+            bitmap->scanline(y)[x] = rand();
+    }
+    return bitmap;
+}
+
+// Applies the kernel the slow and obvious way, one get_pixel() at a time.
+template<size_t N>
+static RefPtr<Gfx::Bitmap> convolve_naively(const Gfx::Bitmap& source, const Gfx::Matrix<N, float>& kernel, bool should_wrap)
+{
+    auto result = Gfx::Bitmap::create(source.format(), source.size());
+    constexpr int offset = N / 2;
+    auto width = source.width();
+    auto height = source.height();
+    auto to_u8 = [](float value) { return (u8)clamp(value, 0.0f, 255.0f); };
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            float red = 0, green = 0, blue = 0;
+            for (int k = 0; k < (int)N; ++k) {
+                for (int l = 0; l < (int)N; ++l) {
+                    int sample_x = x + k - offset;
+                    int sample_y = y + l - offset;
+                    if (sample_x < 0 || sample_x >= width || sample_y < 0 || sample_y >= height) {
+                        if (!should_wrap)
+                            continue;
+                        sample_x = (sample_x + width) % width;
+                        sample_y = (sample_y + height) % height;
+                    }
+                    auto pixel = source.get_pixel(sample_x, sample_y);
+                    auto weight = kernel.elements()[k][l];
+                    red += pixel.red() * weight;
+                    green += pixel.green() * weight;
+                    blue += pixel.blue() * weight;
+                }
+            }
+            result->set_pixel(x, y, Color(to_u8(red), to_u8(green), to_u8(blue), source.get_pixel(x, y).alpha()));
+        }
+    }
+    return result;
+}
+
+template<size_t N>
+static void expect_same_as_naive_convolution(const Gfx::Matrix<N, float>& kernel, bool should_wrap)
+{
+    // Tall enough to be split into several bands.
+    auto bitmap = create_noise_bitmap({ 37, 150 });
+    auto expected = convolve_naively<N>(*bitmap, kernel, should_wrap);
+
+    Gfx::GenericConvolutionFilter<N> filter;
+    typename Gfx::GenericConvolutionFilter<N>::ApplyCache apply_cache;
+    filter.apply(*bitmap, bitmap->rect(), *bitmap, bitmap->rect(), typename Gfx::GenericConvolutionFilter<N>::Parameters(kernel, should_wrap), apply_cache);
+
+    // The fast paths add things up in a different order, so they can be off by one here and there.
+    int max_difference = 0;
+    for (int y = 0; y < bitmap->height(); ++y) {
+        for (int x = 0; x < bitmap->width(); ++x) {
+            auto actual_pixel = bitmap->get_pixel(x, y);
+            auto expected_pixel = expected->get_pixel(x, y);
+            max_difference = max(max_difference, abs(actual_pixel.red() - expected_pixel.red()));
+            max_difference = max(max_difference, abs(actual_pixel.green() - expected_pixel.green()));
+            max_difference = max(max_difference, abs(actual_pixel.blue() - expected_pixel.blue()));
+            max_difference = max(max_difference, abs(actual_pixel.alpha() - expected_pixel.alpha()));
+        }
+    }
+    EXPECT(max_difference <= 1);
+}
+
+TEST_CASE(box_blur)
+{
+    expect_same_as_naive_convolution(box_kernel<5>(), false);
+    expect_same_as_naive_convolution(box_kernel<5>(), true);
+}
+
+TEST_CASE(gaussian_blur)
+{
+    expect_same_as_naive_convolution(gaussian_kernel<5>(), false);
+    expect_same_as_naive_convolution(gaussian_kernel<5>(), true);
+}
+
+TEST_CASE(sharpen)
+{
+    Gfx::Matrix<3, float> kernel { 0, -1, 0, -1, 5, -1, 0, -1, 0 };
+    expect_same_as_naive_convolution(kernel, false);
+    expect_same_as_naive_convolution(kernel, true);
+}
+
+TEST_CASE(laplacian)
+{
+    Gfx::Matrix<3, float> kernel { 1, 1, 1, 1, -8, 1, 1, 1, 1 };
+    expect_same_as_naive_convolution(kernel, false);
+    expect_same_as_naive_convolution(kernel, true);
+}
+
+template<size_t N>
+static void run_filter_benchmark(const Gfx::Matrix<N, float>& kernel)
+{
+    const int run_count = 10;
+    const int bitmap_size = 2000;
+
+    auto bitmap = create_noise_bitmap({ bitmap_size, bitmap_size });
+    Gfx::GenericConvolutionFilter<N> filter;
+    typename Gfx::GenericConvolutionFilter<N>::ApplyCache apply_cache;
+    typename Gfx::GenericConvolutionFilter<N>::Parameters parameters(kernel);
+
+    for (int run = 0; run < run_count; run++)
+        filter.apply(*bitmap, bitmap->rect(), *bitmap, bitmap->rect(), parameters, apply_cache);
+}
+
+BENCHMARK_CASE(box_blur_9x9)
+{
+    run_filter_benchmark(box_kernel<9>());
+}
+
+BENCHMARK_CASE(gaussian_blur_5x5)
+{
+    run_filter_benchmark(gaussian_kernel<5>());
+}
+
+BENCHMARK_CASE(sharpen_3x3)
+{
+    run_filter_benchmark(Gfx::Matrix<3, float> { 0, -1, 0, -1, 5, -1, 0, -1, 0 });
+}
+
+TEST_MAIN(Filters)
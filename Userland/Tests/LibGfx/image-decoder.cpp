@@ -77,6 +77,41 @@ static void test_jpg()
     assert(frame.duration == 0);
 }
 
+static void test_jpg_downscaled()
+{
+    auto image = Gfx::load_jpg("/res/html/misc/bmpsuite_files/rgb24.jpg");
+    auto downscaled_image = Gfx::load_jpg_downscaled("/res/html/misc/bmpsuite_files/rgb24.jpg", { 8, 8 });
+    assert(image);
+    assert(downscaled_image);
+    assert(downscaled_image->size() == Gfx::IntSize(16, 8));
+
+    // Each pixel stands for the average of an 8x8 block, so both images should average out to the same color.
+    // Only whole 16x16 areas are compared, since the colors may be subsampled.
+    auto average_color = [](const Gfx::Bitmap& bitmap, int width, int height) {
+        int red = 0, green = 0, blue = 0;
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                auto color = bitmap.get_pixel(x, y);
+                red += color.red();
+                green += color.green();
+                blue += color.blue();
+            }
+        }
+        int count = width * height;
+        return Gfx::Color(red / count, green / count, blue / count);
+    };
+    auto color = average_color(*image, 112, 64);
+    auto downscaled_color = average_color(*downscaled_image, 14, 8);
+    assert(abs(color.red() - downscaled_color.red()) <= 8);
+    assert(abs(color.green() - downscaled_color.green()) <= 8);
+    assert(abs(color.blue() - downscaled_color.blue()) <= 8);
+
+    // Too small to be decoded at an eighth of the size.
+    auto full_size_image = Gfx::load_jpg_downscaled("/res/html/misc/bmpsuite_files/rgb24.jpg", { 32, 32 });
+    assert(full_size_image);
+    assert(full_size_image->size() == image->size());
+}
+
 static void test_pbm()
 {
     auto image = Gfx::load_pbm("/res/html/misc/pbmsuite_files/buggie-raw.pbm");
@@ -145,6 +180,7 @@ int main(int, char**)
     RUNTEST(test_gif);
     RUNTEST(test_ico);
     RUNTEST(test_jpg);
+    RUNTEST(test_jpg_downscaled);
     RUNTEST(test_pbm);
     RUNTEST(test_pgm);
     RUNTEST(test_png);
@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/OwnPtr.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Timer.h>
+#include <LibThread/BackgroundAction.h>
+#include <assert.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static void test_completes_after_the_creating_loop_is_gone(Core::EventLoop& main_loop)
+{
+    // Like a dialog starting work from its own nested loop, and being closed before the work is done.
+    int result = 0;
+    {
+        auto nested_loop = make<Core::EventLoop>();
+        auto start = Core::Timer::create_single_shot(0, [&] {
+            LibThread::BackgroundAction<int>::create(
+                [] {
+                    usleep(50'000);
+                    return 42;
+                },
+                [&](int value) {
+                    result = value;
+                    main_loop.quit(0);
+                });
+            nested_loop->quit(0);
+        });
+        start->start();
+        nested_loop->exec();
+    }
+    // Scribble over the memory the nested loop was in, so a completion posted there would show.
+    auto other_loop = make<Core::EventLoop>();
+
+    auto timeout = Core::Timer::create_single_shot(5000, [&] { main_loop.quit(1); });
+    timeout->start();
+    assert(main_loop.exec() == 0);
+    assert(result == 42);
+}
+
+static void test_completes_while_a_nested_loop_runs()
+{
+    int result = 0;
+    Core::EventLoop nested_loop;
+    LibThread::BackgroundAction<int>::create(
+        [] { return 7; },
+        [&](int value) {
+            result = value;
+            nested_loop.quit(0);
+        });
+
+    auto timeout = Core::Timer::create_single_shot(5000, [&] { nested_loop.quit(1); });
+    timeout->start();
+    assert(nested_loop.exec() == 0);
+    assert(result == 7);
+}
+
+int main()
+{
+    Core::EventLoop main_loop;
+    test_completes_after_the_creating_loop_is_gone(main_loop);
+    test_completes_while_a_nested_loop_runs();
+    puts("PASS");
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/QuickSort.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibThread/DirectoryWalker.h>
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static constexpr size_t directory_count = 20;
+static constexpr size_t files_per_directory = 30;
+
+static void create_file(const String& path)
+{
+    int fd = open(path.characters(), O_CREAT | O_WRONLY, 0644);
+    assert(fd >= 0);
+    assert(write(fd, "hello", 5) == 5);
+    close(fd);
+}
+
+// root/dN/fM, root/dN/sub/fM and root/dN/sub/.hidden for every N and M.
+static Vector<String> create_tree(const String& root)
+{
+    Vector<String> paths;
+    paths.append(root);
+    for (size_t i = 0; i < directory_count; ++i) {
+        auto directory = String::formatted("{}/d{}", root, i);
+        auto subdirectory = String::formatted("{}/sub", directory);
+        assert(mkdir(directory.characters(), 0755) == 0);
+        assert(mkdir(subdirectory.characters(), 0755) == 0);
+        paths.append(directory);
+        paths.append(subdirectory);
+        for (size_t j = 0; j < files_per_directory; ++j) {
+            paths.append(String::formatted("{}/f{}", directory, j));
+            paths.append(String::formatted("{}/f{}", subdirectory, j));
+        }
+        paths.append(String::formatted("{}/.hidden", subdirectory));
+    }
+    for (auto& path : paths) {
+        struct stat st;
+        if (stat(path.characters(), &st) < 0)
+            create_file(path);
+    }
+    quick_sort(paths);
+    return paths;
+}
+
+static void test_depth_first(const String& root, const Vector<String>& expected_paths)
+{
+    LibThread::DirectoryWalker walker;
+    walker.set_should_stat_entries(false);
+    walker.set_should_sort_by_name(true);
+    Vector<String> paths;
+    Vector<size_t> directory_depths;
+    walker.walk(root, [&](auto& entry) {
+        // Every entry has to come right after its directory, or after everything else in that directory.
+        while (!directory_depths.is_empty() && directory_depths.last() >= entry.depth)
+            directory_depths.take_last();
+        assert(directory_depths.size() == entry.depth);
+        if (entry.is_directory())
+            directory_depths.append(entry.depth);
+        // With sorted directories, a depth-first walk visits the paths in sorted order.
+        assert(paths.is_empty() || paths.last() < entry.path);
+        paths.append(entry.path);
+        return IterationDecision::Continue;
+    });
+    assert(paths == expected_paths);
+}
+
+static void test_unordered(const String& root, const Vector<String>& expected_paths)
+{
+    LibThread::DirectoryWalker walker;
+    walker.set_order(LibThread::DirectoryWalker::Order::Unordered);
+    Vector<String> paths;
+    size_t total_size = 0;
+    walker.walk(root, [&](auto& entry) {
+        assert(entry.stat.has_value());
+        if (!entry.is_directory())
+            total_size += entry.stat.value().st_size;
+        paths.append(entry.path);
+        return IterationDecision::Continue;
+    });
+    quick_sort(paths);
+    assert(paths == expected_paths);
+    assert(total_size == (expected_paths.size() - 2 * directory_count - 1) * 5);
+}
+
+static void test_options(const String& root)
+{
+    LibThread::DirectoryWalker walker;
+    walker.set_max_depth(2);
+    size_t count = 0;
+    walker.walk(root, [&](auto& entry) {
+        assert(entry.depth <= 2);
+        ++count;
+        return IterationDecision::Continue;
+    });
+    assert(count == 1 + directory_count * (files_per_directory + 2));
+
+    walker.set_max_depth(NumericLimits<size_t>::max());
+    walker.set_should_skip_hidden_files(true);
+    count = 0;
+    walker.walk(root, [&](auto& entry) {
+        assert(!entry.name().starts_with('.'));
+        ++count;
+        return IterationDecision::Continue;
+    });
+    assert(count == 1 + directory_count * (2 * files_per_directory + 2));
+
+    count = 0;
+    auto decision = walker.walk(root, [&](auto&) {
+        return ++count == 10 ? IterationDecision::Break : IterationDecision::Continue;
+    });
+    assert(decision == IterationDecision::Break);
+    assert(count == 10);
+}
+
+static void test_errors()
+{
+    LibThread::DirectoryWalker walker;
+    String error_path;
+    walker.on_error = [&](auto& path, int) { error_path = path; };
+    size_t count = 0;
+    walker.walk("/tmp/directory-walker-does-not-exist", [&](auto& entry) {
+        assert(entry.error != 0);
+        ++count;
+        return IterationDecision::Continue;
+    });
+    assert(count == 1);
+    assert(error_path == "/tmp/directory-walker-does-not-exist");
+}
+
+int main(int, char**)
+{
+    char root_template[] = "/tmp/directory-walker.XXXXXX";
+    assert(mkdtemp(root_template));
+    String root = root_template;
+    auto expected_paths = create_tree(root);
+
+    test_depth_first(root, expected_paths);
+    test_unordered(root, expected_paths);
+    test_options(root);
+    test_errors();
+
+    auto command = String::formatted("rm -rf {}", root);
+    system(command.characters());
+    printf("PASS\n");
+    return 0;
+}
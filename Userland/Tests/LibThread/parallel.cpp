@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
+#include <AK/Vector.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibThread/Parallel.h>
+#include <LibThread/TaskGraph.h>
+#include <assert.h>
+#include <stdio.h>
+#include <unistd.h>
+
+static void test_parallel_for_visits_every_index_once(LibThread::ThreadPool& pool)
+{
+    for (size_t grain_size : { 0, 1, 7, 1000, 5000 }) {
+        Vector<Atomic<int>> visits;
+        visits.resize(4321);
+        LibThread::parallel_for(pool, 0, visits.size(), grain_size, [&](size_t i) {
+            visits[i].fetch_add(1);
+        });
+        for (auto& count : visits)
+            assert(count.load() == 1);
+    }
+
+    size_t call_count = 0;
+    LibThread::parallel_for(pool, 10, 10, 0, [&](size_t) { ++call_count; });
+    assert(call_count == 0);
+}
+
+static void test_parallel_reduce_keeps_order(LibThread::ThreadPool& pool)
+{
+    // String concatenation is associative but not commutative, so this only works if chunks are combined in order.
+    auto result = LibThread::parallel_reduce(
+        pool, 0, 26, 3, String::empty(),
+        [](size_t begin, size_t end) {
+            StringBuilder builder;
+            for (auto i = begin; i < end; ++i)
+                builder.append('a' + i);
+            return builder.to_string();
+        },
+        [](String left, String right) { return String::formatted("{}{}", left, right); });
+    assert(result == "abcdefghijklmnopqrstuvwxyz");
+
+    auto sum = LibThread::parallel_reduce(
+        pool, 1, 100001, 0, (u64)0,
+        [](size_t begin, size_t end) {
+            u64 sum = 0;
+            for (auto i = begin; i < end; ++i)
+                sum += i;
+            return sum;
+        },
+        [](u64 left, u64 right) { return left + right; });
+    assert(sum == 5000050000);
+}
+
+static void test_task_graph_respects_dependencies(LibThread::ThreadPool& pool)
+{
+    // A diamond: a -> (b, c) -> d, repeated a few times in a chain.
+    LibThread::TaskGraph graph;
+    Atomic<int> step { 0 };
+    Vector<int> finished_at;
+    finished_at.resize(4 * 50);
+    Optional<LibThread::TaskGraph::TaskID> previous;
+    for (int round = 0; round < 50; ++round) {
+        auto base = round * 4;
+        Vector<LibThread::TaskGraph::TaskID> first_dependencies;
+        if (previous.has_value())
+            first_dependencies.append(previous.value());
+        auto a = graph.add_task([&, base] { finished_at[base] = step.fetch_add(1); }, first_dependencies);
+        auto b = graph.add_task([&, base] { finished_at[base + 1] = step.fetch_add(1); }, { a });
+        auto c = graph.add_task([&, base] { finished_at[base + 2] = step.fetch_add(1); }, { a });
+        previous = graph.add_task([&, base] { finished_at[base + 3] = step.fetch_add(1); }, { b, c });
+    }
+    graph.run(pool);
+
+    assert(step.load() == 200);
+    for (int round = 0; round < 50; ++round) {
+        auto base = round * 4;
+        assert(finished_at[base] < finished_at[base + 1]);
+        assert(finished_at[base] < finished_at[base + 2]);
+        assert(finished_at[base + 1] < finished_at[base + 3]);
+        assert(finished_at[base + 2] < finished_at[base + 3]);
+        if (round > 0)
+            assert(finished_at[base - 1] < finished_at[base]);
+    }
+}
+
+static void test_nested_parallel_for(LibThread::ThreadPool& pool)
+{
+    // Running a parallel_for from inside one must not deadlock, even when every pool thread is busy.
+    Atomic<size_t> count { 0 };
+    LibThread::parallel_for(pool, 0, 64, 1, [&](size_t) {
+        LibThread::parallel_for(pool, 0, 64, 1, [&](size_t) { count.fetch_add(1); });
+    });
+    assert(count.load() == 64 * 64);
+}
+
+// Does the same amount of busy work with pools of growing size, to see how well parallel_for scales.
+static void benchmark_scaling()
+{
+    constexpr size_t item_count = 1 << 12;
+    constexpr size_t work_per_item = 1 << 14;
+
+    auto processor_count = max(sysconf(_SC_NPROCESSORS_ONLN), 1l);
+    double single_thread_ms = 0;
+    for (size_t thread_count = 1; thread_count <= (size_t)processor_count; thread_count *= 2) {
+        LibThread::ThreadPool pool("Benchmark", thread_count);
+        Vector<u32> results;
+        results.resize(item_count);
+
+        Core::ElapsedTimer timer(true);
+        timer.start();
+        LibThread::parallel_for(pool, 0, item_count, 0, [&](size_t i) {
+            u32 value = i;
+            for (size_t j = 0; j < work_per_item; ++j)
+                value = value * 1664525 + 1013904223;
+            results[i] = value;
+        });
+        auto elapsed_ms = timer.elapsed();
+        if (thread_count == 1)
+            single_thread_ms = elapsed_ms;
+
+        printf("%2zu threads: %6d ms, %.2fx\n", thread_count, elapsed_ms, elapsed_ms ? single_thread_ms / elapsed_ms : 0.0);
+    }
+}
+
+int main(int, char**)
+{
+    for (size_t thread_count : { 1, 2, 4 }) {
+        LibThread::ThreadPool pool("Test", thread_count);
+        test_parallel_for_visits_every_index_once(pool);
+        test_parallel_reduce_keeps_order(pool);
+        test_task_graph_respects_dependencies(pool);
+        test_nested_parallel_for(pool);
+    }
+
+    benchmark_scaling();
+
+    printf("PASS\n");
+    return 0;
+}
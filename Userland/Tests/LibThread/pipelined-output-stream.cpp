@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibThread/PipelinedOutputStream.h>
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static void test_file()
+{
+    char path[] = "/tmp/pipelined-output-stream.XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    unlink(path);
+
+    Vector<u8> data;
+    for (size_t i = 0; i < 100000; ++i)
+        data.append(i * 7);
+
+    {
+        LibThread::PipelinedOutputStream stream(fd, 4096, 3);
+        // Writes that straddle chunks, as well as ones that are larger than a chunk.
+        size_t offset = 0;
+        for (size_t size = 1; offset < data.size(); size = size * 3 + 1) {
+            auto bytes = data.span().slice(offset, min(size, data.size() - offset));
+            assert(stream.write_or_error(bytes));
+            offset += bytes.size();
+        }
+        assert(stream.flush());
+        assert(lseek(fd, 0, SEEK_END) == (off_t)data.size());
+
+        // Whatever is written after a flush comes out when the stream goes away.
+        assert(stream.write_or_error(data.span().slice(0, 10)));
+    }
+    assert(lseek(fd, 0, SEEK_END) == (off_t)data.size() + 10);
+
+    Vector<u8> written_data;
+    written_data.resize(data.size());
+    assert(pread(fd, written_data.data(), written_data.size(), 0) == (ssize_t)data.size());
+    assert(written_data == data);
+    close(fd);
+}
+
+static void test_error()
+{
+    LibThread::PipelinedOutputStream stream(-1, 16);
+    u8 bytes[100] {};
+    stream.write({ bytes, sizeof(bytes) });
+    assert(!stream.flush());
+    assert(stream.error() == EBADF);
+    assert(!stream.write_or_error({ bytes, sizeof(bytes) }));
+    assert(stream.handle_any_error());
+}
+
+int main(int, char**)
+{
+    test_file();
+    test_error();
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Vector.h>
+#include <LibThread/PipelinedReader.h>
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void test_file()
+{
+    char path[] = "/tmp/pipelined-reader.XXXXXX";
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    unlink(path);
+
+    Vector<u8> data;
+    for (size_t i = 0; i < 100000; ++i)
+        data.append(i * 7);
+    assert(write(fd, data.data(), data.size()) == (ssize_t)data.size());
+    assert(lseek(fd, 0, SEEK_SET) == 0);
+
+    for (size_t chunk_count = 2; chunk_count <= 4; ++chunk_count) {
+        assert(lseek(fd, 0, SEEK_SET) == 0);
+        LibThread::PipelinedReader reader(fd, 4096, chunk_count);
+        Vector<u8> read_data;
+        for (;;) {
+            auto chunk = reader.next_chunk();
+            if (chunk.is_empty())
+                break;
+            assert(chunk.size() == 4096 || read_data.size() + chunk.size() == data.size());
+            read_data.append(chunk.data(), chunk.size());
+        }
+        assert(reader.error() == 0);
+        assert(read_data == data);
+    }
+    close(fd);
+}
+
+static void test_pipe()
+{
+    int fds[2];
+    assert(pipe(fds) == 0);
+    assert(write(fds[1], "abc", 3) == 3);
+
+    LibThread::PipelinedReader reader(fds[0], 4096);
+    reader.set_max_chunk_count(2);
+
+    // A short read comes through as a chunk of its own.
+    auto chunk = reader.next_chunk();
+    assert(chunk.size() == 3 && !memcmp(chunk.data(), "abc", 3));
+
+    assert(write(fds[1], "defgh", 5) == 5);
+    chunk = reader.next_chunk();
+    assert(chunk.size() == 5 && !memcmp(chunk.data(), "defgh", 5));
+
+    // Nothing is read past the last chunk we asked for.
+    assert(write(fds[1], "ijk", 3) == 3);
+    chunk = reader.next_chunk();
+    assert(chunk.is_empty());
+    assert(reader.error() == 0);
+
+    char rest[3];
+    assert(read(fds[0], rest, sizeof(rest)) == 3);
+    assert(!memcmp(rest, "ijk", 3));
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void test_error()
+{
+    LibThread::PipelinedReader reader(-1, 4096);
+    auto chunk = reader.next_chunk();
+    assert(chunk.is_empty());
+    assert(reader.error() == EBADF);
+}
+
+int main(int, char**)
+{
+    test_file();
+    test_pipe();
+    test_error();
+    printf("PASS\n");
+    return 0;
+}
@@ -4,14 +4,157 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
+#include <LibThread/DirectoryWalker.h>
+#include <LibThread/Parallel.h>
+#include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+// How many files are handed to the thread pool at once while the directory tree is still being walked.
+static constexpr size_t files_per_batch = 64;
+
+struct FileToCopy {
+    String source;
+    String destination;
+};
+
+// These return an errno, or 0 if everything was copied.
+static int copy_one_file(const FileToCopy& file, mode_t umask)
+{
+    int source_fd = open(file.source.characters(), O_RDONLY | O_CLOEXEC);
+    if (source_fd < 0)
+        return errno;
+    ScopeGuard close_source_guard([source_fd] { close(source_fd); });
+
+    struct stat source_stat;
+    if (fstat(source_fd, &source_stat) < 0)
+        return errno;
+
+    int destination_fd = open(file.destination.characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (destination_fd < 0)
+        return errno;
+    ScopeGuard close_destination_guard([destination_fd] { close(destination_fd); });
+
+    auto result = Core::File::copy_file_contents(destination_fd, source_fd, source_stat);
+    if (result.is_error())
+        return result.error().error();
+
+    // NOTE: We don't copy the set-uid and set-gid bits.
+    if (fchmod(destination_fd, (source_stat.st_mode & ~umask) & ~06000) < 0)
+        return errno;
+    return 0;
+}
+
+// Copies all of |files| on the threads of the pool. If some of them couldn't be copied, the error for the
+// first of those is returned.
+static int copy_files(const Vector<FileToCopy>& files, mode_t umask)
+{
+    Vector<int> errors;
+    errors.resize(files.size());
+    Atomic<size_t> next_file { 0 };
+    auto& pool = LibThread::ThreadPool::the();
+    LibThread::run_chunks(pool, min(files.size(), pool.thread_count() + 1), [&](size_t) {
+        for (;;) {
+            auto index = next_file.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            if (index >= files.size())
+                break;
+            errors[index] = copy_one_file(files[index], umask);
+        }
+    });
+    for (auto error : errors) {
+        if (error != 0)
+            return error;
+    }
+    return 0;
+}
+
+// The directories are created on this thread while it walks the tree, since they have to exist before anything
+// can be copied into them. The files are copied in parallel, a batch at a time, as they are found.
+static int copy_directory_in_parallel(const String& source, const String& destination)
+{
+    auto my_umask = umask(0);
+    umask(my_umask);
+
+    struct DirectoryToFinish {
+        String path;
+        mode_t mode;
+    };
+    Vector<DirectoryToFinish> directories;
+    Vector<FileToCopy> files;
+    int error = 0;
+
+    // Everything below the source is copied to the same place below the destination.
+    size_t source_prefix_length = source.ends_with('/') ? source.length() : source.length() + 1;
+
+    LibThread::DirectoryWalker walker;
+    walker.set_should_follow_symlinks(true);
+    walker.on_error = [&](auto&, int code) {
+        if (error == 0)
+            error = code;
+    };
+    walker.walk(source, [&](auto& entry) {
+        if (error != 0)
+            return IterationDecision::Break;
+        if (entry.error != 0) {
+            error = entry.error;
+            return IterationDecision::Break;
+        }
+
+        String entry_destination = destination;
+        if (entry.depth > 0)
+            entry_destination = String::formatted("{}/{}", destination, entry.path.substring_view(source_prefix_length));
+
+        if (!entry.is_directory()) {
+            files.append({ entry.path, move(entry_destination) });
+            if (files.size() == files_per_batch) {
+                error = copy_files(files, my_umask);
+                files.clear();
+            }
+            return error == 0 ? IterationDecision::Continue : IterationDecision::Break;
+        }
+
+        if (mkdir(entry_destination.characters(), 0755) < 0) {
+            error = errno;
+            return IterationDecision::Break;
+        }
+        if (entry.depth == 0) {
+            // Don't copy a directory into itself.
+            auto real_source = String::formatted("{}/", Core::File::real_path_for(source));
+            auto real_destination = String::formatted("{}/", Core::File::real_path_for(destination));
+            if (real_destination.starts_with(real_source)) {
+                error = EINVAL;
+                return IterationDecision::Break;
+            }
+        }
+        directories.append({ move(entry_destination), entry.stat.value().st_mode });
+        return IterationDecision::Continue;
+    });
+
+    if (error == 0 && !files.is_empty())
+        error = copy_files(files, my_umask);
+    if (error != 0)
+        return error;
+
+    // Only now that everything has been copied into them can the directories become read-only.
+    for (size_t i = directories.size(); i > 0; --i) {
+        auto& directory = directories[i - 1];
+        if (chmod(directory.path.characters(), directory.mode & ~my_umask) < 0)
+            return errno;
+    }
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
-    if (pledge("stdio rpath wpath cpath fattr", nullptr) < 0) {
+    if (pledge("stdio rpath wpath cpath fattr thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -32,6 +175,17 @@ int main(int argc, char** argv)
     args_parser.parse(argc, argv);
 
     for (auto& source : sources) {
+        if (recursion_allowed && !link && Core::File::is_directory(source)) {
+            int error = copy_directory_in_parallel(source, destination);
+            if (error != 0) {
+                warnln("cp: unable to copy '{}': {}", source, strerror(error));
+                return 1;
+            }
+            if (verbose)
+                printf("'%s' -> '%s'\n", source, destination);
+            continue;
+        }
+
         auto result = Core::File::copy_file_or_directory(
             destination, source,
             recursion_allowed ? Core::File::RecursionMode::Allowed : Core::File::RecursionMode::Disallowed,
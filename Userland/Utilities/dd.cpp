@@ -7,6 +7,7 @@
 #include <AK/Optional.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
+#include <LibThread/PipelinedReader.h>
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -126,8 +127,7 @@ int main(int argc, char** argv)
     size_t total_bytes_copied = 0;
     size_t total_blocks_in = 0, partial_blocks_in = 0;
     size_t total_blocks_out = 0, partial_blocks_out = 0;
-    uint8_t* buffer = nullptr;
-    ssize_t nread = 0, nwritten = 0;
+    ssize_t nwritten = 0;
 
     for (int a = 1; a < argc; a++) {
         if (!strcmp(argv[a], "--help")) {
@@ -167,11 +167,6 @@ int main(int argc, char** argv)
         }
     }
 
-    if ((buffer = (uint8_t*)malloc(block_size)) == nullptr) {
-        fprintf(stderr, "Unable to allocate %lu bytes for the buffer.\n", block_size);
-        return -1;
-    }
-
     if (seek > 0) {
         if (lseek(output_fd, seek * block_size, SEEK_SET) < 0) {
             fprintf(stderr, "Unable to seek %lu bytes.\n", seek * block_size);
@@ -179,15 +174,20 @@ int main(int argc, char** argv)
         }
     }
 
+    // The next block is read while the current one is being written out. With a count, we mustn't read
+    // past the blocks that we're going to write, since whatever comes after them isn't ours to take.
+    LibThread::PipelinedReader reader(input_fd, block_size);
+    if (count > 0)
+        reader.set_max_chunk_count(skip + count);
+
     while (1) {
-        nread = read(input_fd, buffer, block_size);
-        if (nread < 0) {
-            fprintf(stderr, "Cannot read from the input.\n");
-            break;
-        } else if (nread == 0) {
+        auto block = reader.next_chunk();
+        if (block.is_empty()) {
+            if (reader.error() != 0)
+                fprintf(stderr, "Cannot read from the input.\n");
             break;
         } else {
-            if ((size_t)nread != block_size) {
+            if (block.size() != block_size) {
                 partial_blocks_in++;
             } else {
                 total_blocks_in++;
@@ -197,7 +197,7 @@ int main(int argc, char** argv)
                 continue;
             }
 
-            nwritten = write(output_fd, buffer, nread);
+            nwritten = write(output_fd, block.data(), block.size());
             if (nwritten < 0) {
                 fprintf(stderr, "Cannot write to the output.\n");
                 break;
@@ -225,8 +225,6 @@ int main(int argc, char** argv)
         fprintf(stderr, "%lu bytes copied.\n", total_bytes_copied);
     }
 
-    free(buffer);
-
     if (input_fd != 0) {
         close(input_fd);
     }
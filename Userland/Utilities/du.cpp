@@ -10,9 +10,9 @@
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DateTime.h>
-#include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibCore/Object.h>
+#include <LibThread/DirectoryWalker.h>
 #include <limits.h>
 #include <math.h>
 #include <stdio.h>
@@ -122,33 +122,18 @@ int parse_args(int argc, char** argv, Vector<String>& files, DuOption& du_option
     return 0;
 }
 
-int print_space_usage(const String& path, const DuOption& du_option, int max_depth)
+static void print_entry(const LibThread::DirectoryWalker::Entry& entry, const DuOption& du_option)
 {
-    struct stat path_stat;
-    if (lstat(path.characters(), &path_stat) < 0) {
-        perror("lstat");
-        return 1;
+    auto& path_stat = entry.stat.value();
+    String root_basename;
+    StringView basename = entry.name();
+    if (entry.depth == 0) {
+        root_basename = LexicalPath(entry.path).basename();
+        basename = root_basename;
     }
-
-    if (--max_depth >= 0 && S_ISDIR(path_stat.st_mode)) {
-        auto di = Core::DirIterator(path, Core::DirIterator::SkipParentAndBaseDir);
-        if (di.has_error()) {
-            fprintf(stderr, "DirIterator: %s\n", di.error_string());
-            return 1;
-        }
-        while (di.has_next()) {
-            const auto child_path = di.next_full_path();
-            if (du_option.all || Core::File::is_directory(child_path)) {
-                if (print_space_usage(child_path, du_option, max_depth))
-                    return 1;
-            }
-        }
-    }
-
-    const auto basename = LexicalPath(path).basename();
     for (const auto& pattern : du_option.excluded_patterns) {
         if (basename.matches(pattern, CaseSensitivity::CaseSensitive))
-            return 0;
+            return;
     }
 
     long long size = path_stat.st_size;
@@ -158,13 +143,13 @@ int print_space_usage(const String& path, const DuOption& du_option, int max_dep
     }
 
     if ((du_option.threshold > 0 && size < du_option.threshold) || (du_option.threshold < 0 && size > -du_option.threshold))
-        return 0;
+        return;
 
     const long long block_size = 1024;
     size = size / block_size + (size % block_size != 0);
 
     if (du_option.time_type == DuOption::TimeType::NotUsed)
-        printf("%lld\t%s\n", size, path.characters());
+        printf("%lld\t%s\n", size, entry.path.characters());
     else {
         auto time = path_stat.st_mtime;
         switch (du_option.time_type) {
@@ -178,8 +163,43 @@ int print_space_usage(const String& path, const DuOption& du_option, int max_dep
         }
 
         const auto formatted_time = Core::DateTime::from_timestamp(time).to_string();
-        printf("%lld\t%s\t%s\n", size, formatted_time.characters(), path.characters());
+        printf("%lld\t%s\t%s\n", size, formatted_time.characters(), entry.path.characters());
     }
+}
 
-    return 0;
+int print_space_usage(const String& path, const DuOption& du_option, int max_depth)
+{
+    bool there_was_an_error = false;
+    LibThread::DirectoryWalker walker;
+    walker.set_max_depth(max(max_depth, 0));
+    walker.on_error = [&](auto& error_path, int error) {
+        fprintf(stderr, "du: %s: %s\n", error_path.characters(), strerror(error));
+        there_was_an_error = true;
+    };
+
+    // The walker hands us every directory before its contents, but a directory is only printed after
+    // everything in it, so directories wait here until we've moved past them.
+    Vector<LibThread::DirectoryWalker::Entry> unfinished_directories;
+    walker.walk(path, [&](auto& entry) {
+        while (!unfinished_directories.is_empty() && unfinished_directories.last().depth >= entry.depth)
+            print_entry(unfinished_directories.take_last(), du_option);
+
+        if (!entry.stat.has_value()) {
+            // The walker reports it if the root itself can't be stat()ed.
+            if (entry.depth != 0) {
+                fprintf(stderr, "du: %s: %s\n", entry.path.characters(), strerror(entry.error));
+                there_was_an_error = true;
+            }
+            return IterationDecision::Continue;
+        }
+        if (entry.is_directory())
+            unfinished_directories.append(entry);
+        else if (du_option.all || entry.depth == 0)
+            print_entry(entry, du_option);
+        return IterationDecision::Continue;
+    });
+    while (!unfinished_directories.is_empty())
+        print_entry(unfinished_directories.take_last(), du_option);
+
+    return there_was_an_error ? 1 : 0;
 }
@@ -4,25 +4,90 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <assert.h>
+#include <AK/MemMem.h>
+#include <AK/StringView.h>
+#include <AK/Types.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+static constexpr size_t read_size = 256 * KiB;
+
+// Prints every complete line in |text| that contains |needle|. Rather than look at one line at a time,
+// this finds the occurrences of |needle| in all of |text|, and only then looks for the lines around them.
+// Returns how much of |text| was looked at, which is everything up to the last newline.
+static size_t print_matching_lines(ReadonlyBytes text, StringView needle, bool text_is_complete)
+{
+    auto* data = text.data();
+    size_t end = text.size();
+    if (!text_is_complete) {
+        // Leave the incomplete line at the end for next time.
+        while (end > 0 && data[end - 1] != '\n')
+            --end;
+    }
+
+    size_t position = 0;
+    while (position < end) {
+        auto found = AK::memmem_optional(data + position, end - position, needle.characters_without_null_termination(), needle.length());
+        if (!found.has_value())
+            break;
+        size_t line_start = position + found.value();
+        while (line_start > position && data[line_start - 1] != '\n')
+            --line_start;
+        auto line_length = AK::find_byte(text.slice(line_start, end - line_start), '\n');
+        size_t line_end = line_length.has_value() ? line_start + line_length.value() + 1 : end;
+        fwrite(data + line_start, 1, line_end - line_start, stdout);
+        position = line_end;
+    }
+    return end;
+}
+
 int main(int argc, char** argv)
 {
     if (argc < 2) {
         printf("usage: fgrep <str>\n");
         return 0;
     }
-    for (;;) {
-        char buf[4096];
-        auto* str = fgets(buf, sizeof(buf), stdin);
-        if (str && strstr(str, argv[1]))
-            write(1, buf, strlen(buf));
-        if (feof(stdin))
+    StringView needle = argv[1];
+
+    // A regular file can be searched in one go.
+    struct stat st;
+    if (fstat(STDIN_FILENO, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+        auto* data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, STDIN_FILENO, 0);
+        if (data != MAP_FAILED) {
+            print_matching_lines({ data, static_cast<size_t>(st.st_size) }, needle, true);
+            munmap(data, st.st_size);
             return 0;
-        VERIFY(str);
+        }
+    }
+
+    // Otherwise, read as much as we can get at a time, and carry over the incomplete line at the end.
+    size_t buffer_size = read_size;
+    auto* buffer = static_cast<u8*>(malloc(buffer_size));
+    size_t buffered = 0;
+    for (;;) {
+        if (buffer_size - buffered < read_size) {
+            buffer_size *= 2;
+            buffer = static_cast<u8*>(realloc(buffer, buffer_size));
+            VERIFY(buffer);
+        }
+        auto nread = read(STDIN_FILENO, buffer + buffered, buffer_size - buffered);
+        if (nread < 0) {
+            perror("read");
+            return 1;
+        }
+        buffered += nread;
+        auto consumed = print_matching_lines({ buffer, buffered }, needle, nread == 0);
+        memmove(buffer, buffer + consumed, buffered - consumed);
+        buffered -= consumed;
+        if (nread == 0)
+            break;
+        // Lines that are only printed once the next read() comes back shouldn't be held up.
+        fflush(stdout);
     }
+    free(buffer);
     return 0;
 }
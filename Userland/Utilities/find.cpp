@@ -8,11 +8,13 @@
 #include <AK/NonnullOwnPtr.h>
 #include <AK/OwnPtr.h>
 #include <AK/Vector.h>
-#include <LibCore/DirIterator.h>
+#include <LibThread/DirectoryWalker.h>
+#include <errno.h>
 #include <getopt.h>
 #include <grp.h>
 #include <pwd.h>
 #include <stdio.h>
+#include <string.h>
 #include <sys/stat.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -34,10 +36,49 @@ bool g_have_seen_action_command = false;
     exit(1);
 }
 
+// A file we came across, along with whatever the directory walker already found out about it.
+class FileData {
+public:
+    explicit FileData(const LibThread::DirectoryWalker::Entry& entry)
+        : m_entry(entry)
+    {
+        if (entry.depth == 0)
+            m_root_basename = LexicalPath(entry.path).basename();
+    }
+
+    const char* path() const { return m_entry.path.characters(); }
+    StringView basename() const { return m_entry.depth == 0 ? m_root_basename.view() : m_entry.name(); }
+
+    // The walker only stat()s files when it has to, so the first command that needs to know more does it.
+    const struct stat* stat() const
+    {
+        if (m_entry.stat.has_value())
+            return &m_entry.stat.value();
+        if (!m_stat.has_value()) {
+            struct stat stat;
+            int error = m_entry.error;
+            if (error == 0 && (g_follow_symlinks ? ::stat : ::lstat)(path(), &stat) < 0)
+                error = errno;
+            if (error != 0) {
+                fprintf(stderr, "%s: %s\n", path(), strerror(error));
+                g_there_was_an_error = true;
+                return nullptr;
+            }
+            m_stat = stat;
+        }
+        return &m_stat.value();
+    }
+
+private:
+    const LibThread::DirectoryWalker::Entry& m_entry;
+    String m_root_basename;
+    mutable Optional<struct stat> m_stat;
+};
+
 class Command {
 public:
     virtual ~Command() { }
-    virtual bool evaluate(const char* file_path) const = 0;
+    virtual bool evaluate(const FileData&) const = 0;
 };
 
 class StatCommand : public Command {
@@ -45,17 +86,12 @@ public:
     virtual bool evaluate(const struct stat&) const = 0;
 
 private:
-    virtual bool evaluate(const char* file_path) const override
+    virtual bool evaluate(const FileData& file) const override
     {
-        struct stat stat;
-        auto stat_func = g_follow_symlinks ? ::stat : ::lstat;
-        int rc = stat_func(file_path, &stat);
-        if (rc < 0) {
-            perror(file_path);
-            g_there_was_an_error = true;
+        auto* stat = file.stat();
+        if (!stat)
             return false;
-        }
-        return evaluate(stat);
+        return evaluate(*stat);
     }
 };
 
@@ -202,10 +238,9 @@ public:
     }
 
 private:
-    virtual bool evaluate(const char* file_path) const override
+    virtual bool evaluate(const FileData& file) const override
     {
-        LexicalPath path { file_path };
-        return path.basename().matches(m_pattern, m_case_sensitivity);
+        return file.basename().matches(m_pattern, m_case_sensitivity);
     }
 
     StringView m_pattern;
@@ -220,9 +255,9 @@ public:
     }
 
 private:
-    virtual bool evaluate(const char* file_path) const override
+    virtual bool evaluate(const FileData& file) const override
     {
-        printf("%s%c", file_path, m_terminator);
+        printf("%s%c", file.path(), m_terminator);
         return true;
     }
 
@@ -237,7 +272,7 @@ public:
     }
 
 private:
-    virtual bool evaluate(const char* file_path) const override
+    virtual bool evaluate(const FileData& file) const override
     {
         pid_t pid = fork();
 
@@ -252,7 +287,7 @@ private:
             auto argv = const_cast<Vector<char*>&>(m_argv);
             for (auto& arg : argv) {
                 if (StringView(arg) == "{}")
-                    arg = const_cast<char*>(file_path);
+                    arg = const_cast<char*>(file.path());
             }
             argv.append(nullptr);
             execvp(m_argv[0], argv.data());
@@ -282,9 +317,9 @@ public:
     }
 
 private:
-    virtual bool evaluate(const char* file_path) const override
+    virtual bool evaluate(const FileData& file) const override
     {
-        return m_lhs->evaluate(file_path) && m_rhs->evaluate(file_path);
+        return m_lhs->evaluate(file) && m_rhs->evaluate(file);
     }
 
     NonnullOwnPtr<Command> m_lhs;
@@ -300,9 +335,9 @@ public:
     }
 
 private:
-    virtual bool evaluate(const char* file_path) const override
+    virtual bool evaluate(const FileData& file) const override
     {
-        return m_lhs->evaluate(file_path) || m_rhs->evaluate(file_path);
+        return m_lhs->evaluate(file) || m_rhs->evaluate(file);
     }
 
     NonnullOwnPtr<Command> m_lhs;
@@ -448,19 +483,19 @@ static const char* parse_options(int argc, char* argv[])
 
 static void walk_tree(const char* root_path, Command& command)
 {
-    command.evaluate(root_path);
-
-    Core::DirIterator dir_iterator(root_path, Core::DirIterator::SkipParentAndBaseDir);
-    if (dir_iterator.has_error() && dir_iterator.error() == ENOTDIR)
-        return;
-
-    while (dir_iterator.has_next())
-        walk_tree(dir_iterator.next_full_path().characters(), command);
-
-    if (dir_iterator.has_error()) {
-        fprintf(stderr, "%s: %s\n", root_path, dir_iterator.error_string());
+    // Directories are read in the background, but files are still evaluated in the same order as they
+    // would be by a plain recursive walk.
+    LibThread::DirectoryWalker walker;
+    walker.set_should_stat_entries(false);
+    walker.set_should_follow_symlinks(g_follow_symlinks);
+    walker.on_error = [](auto& path, int error) {
+        fprintf(stderr, "%s: %s\n", path.characters(), strerror(error));
         g_there_was_an_error = true;
-    }
+    };
+    walker.walk(root_path, [&](auto& entry) {
+        command.evaluate(FileData { entry });
+        return IterationDecision::Continue;
+    });
 }
 
 int main(int argc, char* argv[])
@@ -4,15 +4,20 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/ByteBuffer.h>
+#include <AK/MappedFile.h>
+#include <AK/MemMem.h>
+#include <AK/OwnPtr.h>
 #include <AK/ScopeGuard.h>
 #include <AK/String.h>
-#include <AK/Utf8View.h>
+#include <AK/StringBuilder.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/DirIterator.h>
 #include <LibCore/File.h>
 #include <LibRegex/Regex.h>
+#include <LibThread/DirectoryWalker.h>
+#include <LibThread/Parallel.h>
 #include <stdio.h>
 #include <unistd.h>
 
@@ -31,9 +36,212 @@ void fail(StringView format, Ts... args)
     abort();
 }
 
+// How many files are searched at once by a recursive grep before their output is printed.
+static constexpr size_t files_per_batch = 256;
+// When a single file is searched on its own, its output is written out whenever this much has piled up.
+static constexpr size_t output_flush_threshold = 64 * KiB;
+
+static const char* g_pattern = nullptr;
+static BinaryFileMode g_binary_mode { BinaryFileMode::Binary };
+static bool g_case_insensitive = false;
+static bool g_invert_match = false;
+// Set when the pattern doesn't use any regex syntax, in which case we look for it with memmem() instead of the regex engine.
+static bool g_is_fixed_string = false;
+
+static bool is_fixed_string(StringView pattern)
+{
+    for (auto ch : pattern) {
+        if (StringView(".[]()*+?{}|^$\\").contains(ch))
+            return false;
+    }
+    return !pattern.is_empty();
+}
+
+static void write_output(StringBuilder& output)
+{
+    auto view = output.string_view();
+    fwrite(view.characters_without_null_termination(), 1, view.length(), stdout);
+    output.clear();
+}
+
+// Looks for the pattern in whole buffers at a time. Regexes can't be shared between threads, so every thread
+// that searches files needs a Searcher of its own.
+class Searcher {
+public:
+    Searcher()
+    {
+        if (g_is_fixed_string) {
+            m_literal = g_pattern;
+            return;
+        }
+        PosixOptions options {};
+        if (g_case_insensitive)
+            options |= PosixFlags::Insensitive;
+        m_regex = make<Regex<PosixExtended>>(g_pattern, options);
+        // Every match starts with the literal prefix of the pattern, so lines without it can be skipped
+        // without ever running the regex on them.
+        if (!g_case_insensitive && m_regex->matcher)
+            m_literal = m_regex->matcher->literal_prefix();
+    }
+
+    bool is_valid() const { return !m_regex || m_regex->parser_result.error == Error::NoError; }
+
+    // Whether output is written out as it is produced, rather than left in the StringBuilder for the caller.
+    void set_should_flush_output(bool should_flush) { m_should_flush_output = should_flush; }
+
+    // Appends the lines of |text| that should be printed to |output|, and returns whether there were any.
+    bool search(StringView text, StringView filename, bool print_filename, bool is_binary, StringBuilder& output)
+    {
+        auto* characters = text.characters_without_null_termination();
+        bool did_match = false;
+        size_t position = 0;
+        while (position < text.length()) {
+            // Rather than go through the text line by line, skip straight to the next occurrence of the literal,
+            // and only then look for the line around it. This can't work when we're after the lines that don't match.
+            size_t line_start = position;
+            if (!m_literal.is_empty() && !g_invert_match) {
+                auto found = AK::memmem_optional(characters + position, text.length() - position, m_literal.characters_without_null_termination(), m_literal.length());
+                if (!found.has_value())
+                    break;
+                line_start = position + found.value();
+                while (line_start > position && characters[line_start - 1] != '\n')
+                    --line_start;
+            }
+            auto line_length = AK::find_byte(text.bytes().slice(line_start), '\n');
+            size_t line_end = line_length.has_value() ? line_start + line_length.value() : text.length();
+
+            if (search_line(text.substring_view(line_start, line_end - line_start), filename, print_filename, is_binary, output)) {
+                did_match = true;
+                if (is_binary && g_binary_mode == BinaryFileMode::Binary)
+                    break;
+            }
+            position = line_end + 1;
+        }
+        return did_match;
+    }
+
+    bool search_line(StringView line, StringView filename, bool print_filename, bool is_binary, StringBuilder& output)
+    {
+        if (is_binary && g_binary_mode == BinaryFileMode::Skip)
+            return false;
+
+        m_matches.clear_with_capacity();
+        if (m_regex) {
+            auto result = m_regex->match(line, PosixFlags::Global);
+            for (auto& match : result.matches)
+                m_matches.append({ match.global_offset, match.view.length() });
+        } else {
+            for (size_t position = 0;;) {
+                auto found = AK::memmem_optional(line.characters_without_null_termination() + position, line.length() - position, m_literal.characters_without_null_termination(), m_literal.length());
+                if (!found.has_value())
+                    break;
+                m_matches.append({ position + found.value(), m_literal.length() });
+                position += found.value() + m_literal.length();
+            }
+        }
+
+        if (m_matches.is_empty() != g_invert_match)
+            return false;
+
+        if (is_binary && g_binary_mode == BinaryFileMode::Binary) {
+            output.appendff("binary file \x1B[34m{}\x1B[0m matches\n", filename);
+        } else {
+            if (print_filename)
+                output.appendff("\x1B[34m{}:\x1B[0m", filename);
+            size_t last_printed_char_pos = 0;
+            for (auto& match : m_matches) {
+                output.appendff("{}\x1B[32m{}\x1B[0m",
+                    line.substring_view(last_printed_char_pos, match.offset - last_printed_char_pos),
+                    line.substring_view(match.offset, match.length));
+                last_printed_char_pos = match.offset + match.length;
+            }
+            output.append(line.substring_view(last_printed_char_pos, line.length() - last_printed_char_pos));
+            output.append('\n');
+        }
+
+        if (m_should_flush_output && output.length() >= output_flush_threshold)
+            write_output(output);
+        return true;
+    }
+
+private:
+    struct MatchSpan {
+        size_t offset { 0 };
+        size_t length { 0 };
+    };
+
+    OwnPtr<Regex<PosixExtended>> m_regex;
+    // What every matching line contains, as far as we know.
+    StringView m_literal;
+    Vector<MatchSpan> m_matches;
+    bool m_should_flush_output { false };
+};
+
+struct FileResult {
+    StringBuilder output;
+    bool did_match { false };
+    String error;
+};
+
+static void search_file(Searcher& searcher, const String& path, bool print_filename, FileResult& result)
+{
+    // Map the file if we can, and otherwise read all of it (it may be a device, or empty).
+    RefPtr<MappedFile> mapped_file;
+    ByteBuffer contents;
+    ReadonlyBytes bytes;
+    if (auto file_or_error = MappedFile::map(path); !file_or_error.is_error()) {
+        mapped_file = file_or_error.release_value();
+        bytes = mapped_file->bytes();
+    } else {
+        auto file = Core::File::construct(path);
+        if (!file->open(Core::IODevice::ReadOnly)) {
+            result.error = String::formatted("Failed to open {}: {}", path, file->error_string());
+            return;
+        }
+        contents = file->read_all();
+        bytes = contents.bytes();
+    }
+
+    bool is_binary = AK::find_byte(bytes, 0).has_value();
+    if (is_binary && g_binary_mode == BinaryFileMode::Skip)
+        return;
+    result.did_match = searcher.search({ bytes.data(), bytes.size() }, path, print_filename, is_binary, result.output);
+}
+
+// Searches the files on the ThreadPool, and prints what was found in the same order as the files were given.
+// Returns false if any file couldn't be read.
+static bool search_files(const Vector<String>& paths, bool print_filename, bool& did_match_something)
+{
+    Vector<FileResult> results;
+    results.resize(paths.size());
+    Atomic<size_t> next_file { 0 };
+    auto& pool = LibThread::ThreadPool::the();
+    LibThread::run_chunks(pool, min(paths.size(), pool.thread_count() + 1), [&](size_t) {
+        Searcher searcher;
+        for (;;) {
+            auto index = next_file.fetch_add(1);
+            if (index >= paths.size())
+                break;
+            search_file(searcher, paths[index], print_filename, results[index]);
+        }
+    });
+
+    bool success = true;
+    for (auto& result : results) {
+        write_output(result.output);
+        if (!result.error.is_null()) {
+            fflush(stdout);
+            warnln("{}", result.error);
+            success = false;
+        }
+        did_match_something = did_match_something || result.did_match;
+    }
+    return success;
+}
+
 int main(int argc, char** argv)
 {
-    if (pledge("stdio rpath", nullptr) < 0) {
+    if (pledge("stdio rpath thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -42,28 +250,24 @@ int main(int argc, char** argv)
 
     bool recursive { false };
     bool use_ere { true };
-    const char* pattern = nullptr;
-    BinaryFileMode binary_mode { BinaryFileMode::Binary };
-    bool case_insensitive = false;
-    bool invert_match = false;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(recursive, "Recursively scan files starting in working directory", "recursive", 'r');
     args_parser.add_option(use_ere, "Extended regular expressions (default)", "extended-regexp", 'E');
-    args_parser.add_option(pattern, "Pattern", "regexp", 'e', "Pattern");
-    args_parser.add_option(case_insensitive, "Make matches case-insensitive", nullptr, 'i');
-    args_parser.add_option(invert_match, "Select non-matching lines", "invert-match", 'v');
+    args_parser.add_option(g_pattern, "Pattern", "regexp", 'e', "Pattern");
+    args_parser.add_option(g_case_insensitive, "Make matches case-insensitive", nullptr, 'i');
+    args_parser.add_option(g_invert_match, "Select non-matching lines", "invert-match", 'v');
     args_parser.add_option(Core::ArgsParser::Option {
         .requires_argument = true,
         .help_string = "Action to take for binary files ([binary], text, skip)",
         .long_name = "binary-mode",
         .accept_value = [&](auto* str) {
             if (StringView { "text" } == str)
-                binary_mode = BinaryFileMode::Text;
+                g_binary_mode = BinaryFileMode::Text;
             else if (StringView { "binary" } == str)
-                binary_mode = BinaryFileMode::Binary;
+                g_binary_mode = BinaryFileMode::Binary;
             else if (StringView { "skip" } == str)
-                binary_mode = BinaryFileMode::Skip;
+                g_binary_mode = BinaryFileMode::Skip;
             else
                 return false;
             return true;
@@ -75,7 +279,7 @@ int main(int argc, char** argv)
         .long_name = "text",
         .short_name = 'a',
         .accept_value = [&](auto) {
-            binary_mode = BinaryFileMode::Text;
+            g_binary_mode = BinaryFileMode::Text;
             return true;
         },
     });
@@ -85,7 +289,7 @@ int main(int argc, char** argv)
         .long_name = nullptr,
         .short_name = 'I',
         .accept_value = [&](auto) {
-            binary_mode = BinaryFileMode::Skip;
+            g_binary_mode = BinaryFileMode::Skip;
             return true;
         },
     });
@@ -96,108 +300,71 @@ int main(int argc, char** argv)
         return 0;
 
     // mock grep behaviour: if -e is omitted, use first positional argument as pattern
-    if (pattern == nullptr && files.size())
-        pattern = files.take_first();
+    if (g_pattern == nullptr && files.size())
+        g_pattern = files.take_first();
 
-    PosixOptions options {};
-    if (case_insensitive)
-        options |= PosixFlags::Insensitive;
+    g_is_fixed_string = !g_case_insensitive && is_fixed_string(g_pattern);
 
-    Regex<PosixExtended> re(pattern, options);
-    if (re.parser_result.error != Error::NoError) {
+    Searcher searcher;
+    if (!searcher.is_valid())
         return 1;
-    }
-
-    auto matches = [&](StringView str, StringView filename = "", bool print_filename = false, bool is_binary = false) {
-        size_t last_printed_char_pos { 0 };
-        if (is_binary && binary_mode == BinaryFileMode::Skip)
-            return false;
-
-        auto result = re.match(str, PosixFlags::Global);
-        if (result.success ^ invert_match) {
-            if (is_binary && binary_mode == BinaryFileMode::Binary) {
-                outln("binary file \x1B[34m{}\x1B[0m matches", filename);
-            } else {
-                if ((result.matches.size() || invert_match) && print_filename) {
-                    out("\x1B[34m{}:\x1B[0m", filename);
-                }
-
-                for (auto& match : result.matches) {
-
-                    out("{}\x1B[32m{}\x1B[0m",
-                        StringView(&str[last_printed_char_pos], match.global_offset - last_printed_char_pos),
-                        match.view.to_string());
-                    last_printed_char_pos = match.global_offset + match.view.length();
-                }
-                outln("{}", StringView(&str[last_printed_char_pos], str.length() - last_printed_char_pos));
-            }
-
-            return true;
-        }
-
-        return false;
-    };
-
-    auto handle_file = [&matches, binary_mode](StringView filename, bool print_filename) -> bool {
-        auto file = Core::File::construct(filename);
-        if (!file->open(Core::IODevice::ReadOnly)) {
-            warnln("Failed to open {}: {}", filename, file->error_string());
-            return false;
-        }
-
-        while (file->can_read_line()) {
-            auto line = file->read_line();
-            auto is_binary = memchr(line.characters(), 0, line.length()) != nullptr;
-
-            if (matches(line, filename, print_filename, is_binary) && is_binary && binary_mode == BinaryFileMode::Binary)
-                return true;
-        }
-        return true;
-    };
-
-    auto add_directory = [&handle_file](String base, Optional<String> recursive, auto handle_directory) -> void {
-        Core::DirIterator it(recursive.value_or(base), Core::DirIterator::Flags::SkipDots);
-        while (it.has_next()) {
-            auto path = it.next_full_path();
-            if (!Core::File::is_directory(path)) {
-                auto key = path.substring_view(base.length() + 1, path.length() - base.length() - 1);
-                handle_file(key, true);
-            } else {
-                handle_directory(base, path, handle_directory);
-            }
-        }
-    };
 
     bool did_match_something = false;
     if (!files.size() && !recursive) {
+        // Standard input may well be a pipe that is still being written to, so it is searched a line at a time.
+        searcher.set_should_flush_output(true);
+        StringBuilder output;
         char* line = nullptr;
         size_t line_len = 0;
         ssize_t nread = 0;
         ScopeGuard free_line = [line] { free(line); };
         while ((nread = getline(&line, &line_len, stdin)) != -1) {
             VERIFY(nread > 0);
-            StringView line_view(line, nread - 1);
+            StringView line_view(line, line[nread - 1] == '\n' ? nread - 1 : nread);
             bool is_binary = line_view.contains(0);
 
-            if (is_binary && binary_mode == BinaryFileMode::Skip)
+            if (is_binary && g_binary_mode == BinaryFileMode::Skip)
                 return 1;
 
-            auto matched = matches(line_view, "stdin", false, is_binary);
+            auto matched = searcher.search_line(line_view, "stdin", false, is_binary, output);
+            write_output(output);
             did_match_something = did_match_something || matched;
-            if (matched && is_binary && binary_mode == BinaryFileMode::Binary)
+            if (matched && is_binary && g_binary_mode == BinaryFileMode::Binary)
                 return 0;
         }
-    } else {
-        if (recursive) {
-            add_directory(".", {}, add_directory);
-
-        } else {
-            bool print_filename { files.size() > 1 };
-            for (auto& filename : files) {
-                if (!handle_file(filename, print_filename))
-                    return 1;
+    } else if (recursive) {
+        // The directory tree is read in the background too, and files are searched in batches as they come in.
+        LibThread::DirectoryWalker walker;
+        walker.set_should_stat_entries(false);
+        Vector<String> paths;
+        walker.walk(".", [&](auto& entry) {
+            if (entry.depth == 0 || entry.is_directory() || entry.type == DT_LNK)
+                return IterationDecision::Continue;
+            // Leave out the "./" at the start.
+            paths.append(entry.path.substring(2));
+            if (paths.size() == files_per_batch) {
+                search_files(paths, true, did_match_something);
+                paths.clear();
             }
+            return IterationDecision::Continue;
+        });
+        search_files(paths, true, did_match_something);
+    } else if (files.size() == 1) {
+        searcher.set_should_flush_output(true);
+        FileResult result;
+        search_file(searcher, files.first(), false, result);
+        write_output(result.output);
+        if (!result.error.is_null()) {
+            warnln("{}", result.error);
+            return 1;
         }
+        did_match_something = result.did_match;
+    } else {
+        Vector<String> paths;
+        for (auto* file : files)
+            paths.append(file);
+        if (!search_files(paths, true, did_match_something))
+            return 1;
     }
 
     return did_match_something ? 0 : 1;
@@ -6,21 +6,36 @@
 
 #include <LibCompress/Gzip.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/FileStream.h>
+#include <LibThread/PipelinedOutputStream.h>
+#include <LibThread/PipelinedReader.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
 #include <unistd.h>
 
-static bool decompress_file(Buffered<Core::InputFileStream>& input_stream, Buffered<Core::OutputFileStream>& output_stream)
+static constexpr size_t chunk_size = 256 * KiB;
+
+// The input is read ahead and the output is written behind on threads of their own, so that this thread can
+// spend all of its time decompressing.
+static bool decompress_file(int input_fd, int output_fd)
 {
+    LibThread::PipelinedInputStream input_stream(input_fd, chunk_size);
+    LibThread::PipelinedOutputStream output_stream(output_fd, chunk_size);
     auto gzip_stream = Compress::GzipDecompressor { input_stream };
 
-    u8 buffer[4096];
+    auto buffer = ByteBuffer::create_uninitialized(64 * KiB);
 
     while (!gzip_stream.has_any_error() && !gzip_stream.unreliable_eof()) {
-        const auto nread = gzip_stream.read({ buffer, sizeof(buffer) });
-        output_stream.write_or_error({ buffer, nread });
+        const auto nread = gzip_stream.read(buffer.bytes());
+        if (!output_stream.write_or_error({ buffer.data(), nread }))
+            break;
     }
 
-    return !gzip_stream.handle_any_error();
+    auto failed = gzip_stream.handle_any_error();
+    failed |= !output_stream.flush();
+    failed |= output_stream.handle_any_error();
+    failed |= input_stream.handle_any_error();
+    return !failed;
 }
 
 int main(int argc, char** argv)
@@ -45,25 +60,25 @@ int main(int argc, char** argv)
         const auto input_filename = filename;
         const auto output_filename = filename.substring_view(0, filename.length() - 3);
 
-        auto input_stream_result = Core::InputFileStream::open_buffered(input_filename);
-
-        if (input_stream_result.is_error()) {
-            warnln("Failed opening input file for reading: {}", input_stream_result.error());
+        int input_fd = open(input_filename.characters(), O_RDONLY | O_CLOEXEC);
+        if (input_fd < 0) {
+            warnln("Failed opening input file for reading: {}", strerror(errno));
             return 1;
         }
 
         auto success = false;
         if (write_to_stdout) {
-            auto stdout = Core::OutputFileStream::stdout_buffered();
-            success = decompress_file(input_stream_result.value(), stdout);
+            success = decompress_file(input_fd, STDOUT_FILENO);
         } else {
-            auto output_stream_result = Core::OutputFileStream::open_buffered(output_filename);
-            if (output_stream_result.is_error()) {
-                warnln("Failed opening output file for writing: {}", output_stream_result.error());
+            int output_fd = open(String(output_filename).characters(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+            if (output_fd < 0) {
+                warnln("Failed opening output file for writing: {}", strerror(errno));
                 return 1;
             }
-            success = decompress_file(input_stream_result.value(), output_stream_result.value());
+            success = decompress_file(input_fd, output_fd);
+            close(output_fd);
         }
+        close(input_fd);
         if (!success) {
             warnln("Failed gzip decompressing input file");
             return 1;
@@ -8,23 +8,62 @@
 #include <LibCompress/Gzip.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/FileStream.h>
+#include <LibThread/Parallel.h>
 #include <unistd.h>
 
+// Compresses |bytes| into a single gzip member, on |thread_count| threads.
+static bool compress_file(ReadonlyBytes bytes, OutputStream& output_stream, Compress::DeflateCompressor::CompressionLevel compression_level, int thread_count)
+{
+    if (thread_count <= 1) {
+        auto compressed_file = Compress::GzipCompressor::compress_all(bytes, compression_level);
+        if (compressed_file.has_value())
+            output_stream.write_or_error(compressed_file.value());
+        return !output_stream.handle_any_error() && compressed_file.has_value();
+    }
+
+    // Enough parts per batch that threads which finish early have something else to do.
+    Compress::ParallelGzipCompressor gzip_stream(
+        output_stream, thread_count * 2, [](size_t count, auto& task) {
+            LibThread::run_chunks(LibThread::ThreadPool::the(), count, task);
+        },
+        compression_level);
+    gzip_stream.write_or_error(bytes);
+    gzip_stream.final_flush();
+    auto failed = gzip_stream.handle_any_error();
+    failed |= output_stream.handle_any_error();
+    return !failed;
+}
+
 int main(int argc, char** argv)
 {
     Vector<const char*> filenames;
     bool keep_input_files { false };
     bool write_to_stdout { false };
+    bool compress_fast { false };
+    bool compress_best { false };
+    int thread_count { 0 };
 
     Core::ArgsParser args_parser;
     args_parser.add_option(keep_input_files, "Keep (don't delete) input files", "keep", 'k');
     args_parser.add_option(write_to_stdout, "Write to stdout, keep original files unchanged", "stdout", 'c');
+    args_parser.add_option(compress_fast, "Compress faster, at the cost of a larger output", "fast", '1');
+    args_parser.add_option(compress_best, "Compress better, at the cost of taking longer", "best", '9');
+    args_parser.add_option(thread_count, "Compress on this many threads, 0 for one per processor (the default)", "threads", 'p', "N");
     args_parser.add_positional_argument(filenames, "File to compress", "FILE");
     args_parser.parse(argc, argv);
 
     if (write_to_stdout)
         keep_input_files = true;
 
+    auto compression_level = Compress::DeflateCompressor::CompressionLevel::GOOD;
+    if (compress_fast)
+        compression_level = Compress::DeflateCompressor::CompressionLevel::FAST;
+    else if (compress_best)
+        compression_level = Compress::DeflateCompressor::CompressionLevel::GREAT;
+
+    if (thread_count <= 0)
+        thread_count = LibThread::ThreadPool::the().thread_count();
+
     for (const String& input_filename : filenames) {
         auto output_filename = String::formatted("{}.gz", input_filename);
 
@@ -37,26 +76,20 @@ int main(int argc, char** argv)
         }
         auto file = file_or_error.value();
 
-        auto compressed_file = Compress::GzipCompressor::compress_all(file->bytes());
-        if (!compressed_file.has_value()) {
-            warnln("Failed gzip compressing input file");
-            return 1;
-        }
-
         auto success = false;
         if (write_to_stdout) {
             auto stdout = Core::OutputFileStream { Core::File::standard_output() };
-            success = stdout.write_or_error(compressed_file.value());
+            success = compress_file(file->bytes(), stdout, compression_level, thread_count);
         } else {
             auto output_stream_result = Core::OutputFileStream::open(output_filename);
             if (output_stream_result.is_error()) {
                 warnln("Failed opening output file for writing: {}", output_stream_result.error());
                 return 1;
             }
-            success = output_stream_result.value().write_or_error(compressed_file.value());
+            success = compress_file(file->bytes(), output_stream_result.value(), compression_level, thread_count);
         }
         if (!success) {
-            warnln("Failed writing compressed file to output");
+            warnln("Failed gzip compressing input file");
             return 1;
         }
 
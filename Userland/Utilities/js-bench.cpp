@@ -0,0 +1,320 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Function.h>
+#include <AK/HashMap.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/LexicalPath.h>
+#include <AK/QuickSort.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/DirIterator.h>
+#include <LibCore/File.h>
+#include <LibJS/Heap/Heap.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/Function.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Every benchmark is a file that defines a function called benchmark(). The file itself runs once (so it can set up
+// whatever input it needs), and then benchmark() is called a few times to warm up, and then once per measured iteration.
+
+struct BenchmarkResult {
+    String name;
+    String error;
+    size_t iterations { 0 };
+    double min_ms { 0 };
+    double median_ms { 0 };
+    double max_ms { 0 };
+    // These are per iteration, averaged over all of them.
+    double allocated_cells { 0 };
+    double collections { 0 };
+    double gc_pause_ms { 0 };
+    // This one is the longest pause in any of the iterations.
+    double longest_gc_pause_ms { 0 };
+};
+
+static double get_time_in_ms()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<double>(now.tv_sec) * 1000.0 + static_cast<double>(now.tv_nsec) / 1'000'000.0;
+}
+
+static String describe_exception(JS::VM& vm)
+{
+    auto value = vm.exception()->value();
+    vm.clear_exception();
+    if (value.is_object()) {
+        auto& object = value.as_object();
+        auto name = object.get_without_side_effects(vm.names.name);
+        auto message = object.get_without_side_effects(vm.names.message);
+        if (name.is_string() && message.is_string())
+            return String::formatted("{}: {}", name.to_string_without_side_effects(), message.to_string_without_side_effects());
+    }
+    return value.to_string_without_side_effects();
+}
+
+// Calls run_iteration() for the warmups, and then for every measured iteration. That returns false (after setting the
+// error of the result) if something went wrong, which ends the measurement.
+static void measure(BenchmarkResult& result, JS::Heap& heap, int warmup_iterations, int iterations, Function<bool()> run_iteration)
+{
+    for (int i = 0; i < warmup_iterations; ++i) {
+        if (!run_iteration())
+            return;
+    }
+
+    Vector<double> times;
+    for (int i = 0; i < iterations; ++i) {
+        // Start every iteration from the same place, so that it doesn't pay for the garbage of the previous one.
+        heap.collect_garbage();
+        heap.reset_statistics();
+
+        auto start_time = get_time_in_ms();
+        auto succeeded = run_iteration();
+        times.append(get_time_in_ms() - start_time);
+        if (!succeeded)
+            return;
+
+        auto& statistics = heap.statistics();
+        result.allocated_cells += statistics.allocated_cells;
+        result.collections += statistics.collections;
+        result.gc_pause_ms += statistics.total_collection_time_us / 1000.0;
+        result.longest_gc_pause_ms = max(result.longest_gc_pause_ms, statistics.longest_collection_time_us / 1000.0);
+    }
+    result.allocated_cells /= iterations;
+    result.collections /= iterations;
+    result.gc_pause_ms /= iterations;
+
+    quick_sort(times);
+    result.iterations = iterations;
+    result.min_ms = times.first();
+    result.max_ms = times.last();
+    result.median_ms = times.size() % 2 ? times[times.size() / 2] : (times[times.size() / 2 - 1] + times[times.size() / 2]) / 2;
+}
+
+static BenchmarkResult run_benchmark(const String& path, int warmup_iterations, int iterations)
+{
+    BenchmarkResult result;
+    result.name = LexicalPath(path).title();
+
+    auto file = Core::File::construct(path);
+    if (!file->open(Core::IODevice::ReadOnly)) {
+        result.error = String::formatted("Failed to open {}", path);
+        return result;
+    }
+    auto contents = file->read_all();
+    String source(reinterpret_cast<const char*>(contents.data()), contents.size());
+
+    auto parser = JS::Parser(JS::Lexer(source));
+    auto program = parser.parse_program();
+    if (parser.has_errors()) {
+        result.error = parser.errors()[0].to_string();
+        return result;
+    }
+
+    auto vm = JS::VM::create();
+    auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+    auto& global_object = interpreter->global_object();
+
+    interpreter->run(global_object, *program);
+    if (vm->exception()) {
+        result.error = describe_exception(*vm);
+        return result;
+    }
+
+    auto benchmark = vm->get_variable("benchmark", global_object);
+    if (!benchmark.is_function()) {
+        result.error = "The file does not define a benchmark() function";
+        return result;
+    }
+    auto& function = benchmark.as_function();
+
+    measure(result, vm->heap(), warmup_iterations, iterations, [&] {
+        (void)vm->call(function, JS::js_undefined());
+        // The promise jobs are part of the benchmark, as they would be if it ran as a script.
+        if (!vm->exception())
+            vm->run_queued_promise_jobs();
+        if (vm->exception()) {
+            result.error = describe_exception(*vm);
+            return false;
+        }
+        return true;
+    });
+    return result;
+}
+
+// This one measures how long it takes to create a global object with all of the builtins, which every new realm pays for.
+static constexpr auto realm_startup_benchmark_name = "realm-startup";
+static constexpr int realms_per_iteration = 10;
+
+static BenchmarkResult run_realm_startup_benchmark(int warmup_iterations, int iterations)
+{
+    BenchmarkResult result;
+    result.name = realm_startup_benchmark_name;
+
+    auto vm = JS::VM::create();
+    measure(result, vm->heap(), warmup_iterations, iterations, [&] {
+        for (int i = 0; i < realms_per_iteration; ++i)
+            (void)JS::Interpreter::create<JS::GlobalObject>(*vm);
+        return true;
+    });
+    return result;
+}
+
+static JsonObject result_to_json(const BenchmarkResult& result)
+{
+    JsonObject object;
+    object.set("name", result.name);
+    if (!result.error.is_null()) {
+        object.set("error", result.error);
+        return object;
+    }
+    object.set("iterations", result.iterations);
+    object.set("min_ms", result.min_ms);
+    object.set("median_ms", result.median_ms);
+    object.set("max_ms", result.max_ms);
+    object.set("allocated_cells", result.allocated_cells);
+    object.set("collections", result.collections);
+    object.set("gc_pause_ms", result.gc_pause_ms);
+    object.set("longest_gc_pause_ms", result.longest_gc_pause_ms);
+    return object;
+}
+
+static Optional<HashMap<String, double>> load_baseline(const String& path)
+{
+    auto file = Core::File::construct(path);
+    if (!file->open(Core::IODevice::ReadOnly)) {
+        warnln("Failed to open the baseline {}", path);
+        return {};
+    }
+    auto json = JsonValue::from_string(file->read_all());
+    if (!json.has_value() || !json->is_object() || !json->as_object().get("benchmarks").is_array()) {
+        warnln("The baseline {} is not the output of js-bench --json", path);
+        return {};
+    }
+
+    HashMap<String, double> median_times;
+    json->as_object().get("benchmarks").as_array().for_each([&](auto& value) {
+        if (!value.is_object())
+            return;
+        auto& benchmark = value.as_object();
+        auto median = benchmark.get("median_ms");
+        if (median.is_number())
+            median_times.set(benchmark.get("name").to_string(), median.template to_number<double>());
+    });
+    return median_times;
+}
+
+int main(int argc, char** argv)
+{
+    int iterations = 10;
+    int warmup_iterations = 2;
+    bool print_json = false;
+    const char* baseline_path = nullptr;
+    double threshold = 10;
+    const char* filter = nullptr;
+    const char* specified_root = nullptr;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Run the LibJS benchmarks, and optionally compare them against an earlier run.");
+    args_parser.add_option(iterations, "Number of measured iterations (default: 10)", "iterations", 'i', "count");
+    args_parser.add_option(warmup_iterations, "Number of iterations before measuring (default: 2)", "warmup", 'w', "count");
+    args_parser.add_option(filter, "Only run the benchmarks whose name contains this", "filter", 'f', "text");
+    args_parser.add_option(print_json, "Print the results as JSON", "json", 'j');
+    args_parser.add_option(baseline_path, "Fail if a benchmark got slower than in this output of --json", "baseline", 'b', "file");
+    args_parser.add_option(threshold, "How many percent slower than the baseline a benchmark may get (default: 10)", "threshold", 't', "percent");
+    args_parser.add_positional_argument(specified_root, "A benchmark, or a directory of them", "path", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    if (iterations < 1 || warmup_iterations < 0) {
+        warnln("There has to be at least one iteration, and no less than zero warmups");
+        return 1;
+    }
+
+    String root;
+    if (specified_root) {
+        root = specified_root;
+    } else {
+#ifdef __serenity__
+        root = "/home/anon/js-benchmarks";
+#else
+        char* serenity_source_dir = getenv("SERENITY_SOURCE_DIR");
+        if (!serenity_source_dir) {
+            warnln("No path given, js-bench requires the SERENITY_SOURCE_DIR environment variable to be set");
+            return 1;
+        }
+        root = String::formatted("{}/Userland/Libraries/LibJS/Benchmarks", serenity_source_dir);
+#endif
+    }
+
+    Vector<String> paths;
+    if (Core::File::is_directory(root)) {
+        Core::DirIterator iterator(root, Core::DirIterator::SkipDots);
+        while (iterator.has_next()) {
+            auto path = iterator.next_full_path();
+            if (path.ends_with(".js"))
+                paths.append(move(path));
+        }
+        quick_sort(paths);
+    } else {
+        paths.append(root);
+    }
+    if (filter)
+        paths.remove_all_matching([&](auto& path) { return !LexicalPath(path).title().contains(filter); });
+
+    Optional<HashMap<String, double>> baseline;
+    if (baseline_path) {
+        baseline = load_baseline(baseline_path);
+        if (!baseline.has_value())
+            return 1;
+    }
+
+    // The realm startup benchmark runs along with the files, unless a single one of them was asked for.
+    Vector<Optional<String>> benchmarks;
+    if (!specified_root || Core::File::is_directory(root)) {
+        if (!filter || StringView(realm_startup_benchmark_name).contains(filter))
+            benchmarks.append(Optional<String> {});
+    }
+    for (auto& path : paths)
+        benchmarks.append(path);
+
+    bool any_failed = false;
+    JsonArray json_results;
+    for (auto& benchmark : benchmarks) {
+        auto result = benchmark.has_value() ? run_benchmark(benchmark.value(), warmup_iterations, iterations) : run_realm_startup_benchmark(warmup_iterations, iterations);
+        if (!result.error.is_null()) {
+            any_failed = true;
+            warnln("{}: {}", result.name, result.error);
+        } else if (!print_json) {
+            outln("{:20} {:>10.2} ms median {:>10.2} ms min {:>10} cells {:>6.1} GCs {:>8.2} ms GC pause",
+                result.name, result.median_ms, result.min_ms, static_cast<u64>(result.allocated_cells), result.collections, result.gc_pause_ms);
+        }
+
+        if (result.error.is_null() && baseline.has_value()) {
+            if (auto baseline_time = baseline->get(result.name); baseline_time.has_value() && baseline_time.value() > 0) {
+                auto change = (result.median_ms / baseline_time.value() - 1) * 100;
+                if (change > threshold) {
+                    any_failed = true;
+                    warnln("{}: {:.2f} ms is {:.1f}% slower than the baseline ({:.2f} ms)", result.name, result.median_ms, change, baseline_time.value());
+                }
+            }
+        }
+        json_results.append(result_to_json(result));
+    }
+
+    if (print_json) {
+        JsonObject json;
+        json.set("benchmarks", move(json_results));
+        outln("{}", json.to_string());
+    }
+
+    return any_failed ? 1 : 0;
+}
@@ -13,6 +13,8 @@
 #include <LibCore/File.h>
 #include <LibCore/StandardPaths.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Console.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Parser.h>
@@ -60,6 +62,8 @@ private:
 };
 
 static bool s_dump_ast = false;
+static bool s_run_bytecode = false;
+static bool s_dump_bytecode = false;
 static bool s_print_last_result = false;
 static RefPtr<Line::Editor> s_editor;
 static String s_history_path = String::formatted("{}/.js-history", Core::StandardPaths::home_directory());
@@ -481,7 +485,16 @@ static bool parse_and_run(JS::Interpreter& interpreter, const StringView& source
             outln("{}", hint);
         vm->throw_exception<JS::SyntaxError>(interpreter.global_object(), error.to_string());
     } else {
-        interpreter.run(interpreter.global_object(), *program);
+        // If the program can't be compiled yet, it's run by the AST interpreter even with -b.
+        OwnPtr<JS::Bytecode::Executable> executable;
+        if (s_run_bytecode || s_dump_bytecode)
+            executable = JS::Bytecode::Generator::generate(*program);
+        if (executable && s_dump_bytecode)
+            executable->dump();
+        if (executable && s_run_bytecode)
+            interpreter.run(interpreter.global_object(), *executable);
+        else
+            interpreter.run(interpreter.global_object(), *program);
     }
 
     auto handle_exception = [&] {
@@ -716,6 +729,8 @@ int main(int argc, char** argv)
     Core::ArgsParser args_parser;
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
+    args_parser.add_option(s_dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
+    args_parser.add_option(s_run_bytecode, "Run the bytecode", "run-bytecode", 'b');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
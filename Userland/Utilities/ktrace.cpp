@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2021, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashMap.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/QuickSort.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/File.h>
+#include <serenity.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Unlike strace, this doesn't stop the traced process at all: the kernel records the events into a buffer while it
+// runs, and they're printed once tracing is over.
+
+static Optional<u32> parse_categories(const StringView& list)
+{
+    u32 categories = 0;
+    for (auto& name : list.split_view(',')) {
+        if (name == "syscalls")
+            categories |= KTRACE_SYSCALLS;
+        else if (name == "context-switches")
+            categories |= KTRACE_CONTEXT_SWITCHES;
+        else if (name == "page-faults")
+            categories |= KTRACE_PAGE_FAULTS;
+        else if (name == "block-io")
+            categories |= KTRACE_BLOCK_IO;
+        else if (name == "all")
+            categories |= KTRACE_ALL;
+        else
+            return {};
+    }
+    return categories;
+}
+
+struct PendingSyscall {
+    String prefix;
+    String function;
+    u64 timestamp_ns { 0 };
+    String arguments;
+};
+
+struct SyscallSummary {
+    size_t calls { 0 };
+    size_t errors { 0 };
+    u64 total_ns { 0 };
+};
+
+class EventPrinter {
+public:
+    EventPrinter(HashTable<String> syscall_filter, Optional<pid_t> tid_filter, bool summary_only)
+        : m_syscall_filter(move(syscall_filter))
+        , m_tid_filter(tid_filter)
+        , m_summary_only(summary_only)
+    {
+    }
+
+    void print(const JsonObject& event)
+    {
+        auto tid = event.get("tid").to_i32();
+        if (m_tid_filter.has_value() && tid != m_tid_filter.value())
+            return;
+        auto timestamp_ns = event.get("timestamp_ns").to_number<u64>();
+        if (!m_first_timestamp_ns.has_value())
+            m_first_timestamp_ns = timestamp_ns;
+        auto relative_us = (timestamp_ns - m_first_timestamp_ns.value()) / 1000;
+        auto prefix = String::formatted("{:>5}.{:06} {:>5}:{:<5}", relative_us / 1'000'000, relative_us % 1'000'000, event.get("pid").to_i32(), tid);
+
+        auto type = event.get("type").as_string_or({});
+        if (type == "syscall_enter") {
+            auto function = event.get("function").to_string();
+            if (!is_shown(function))
+                return;
+            StringBuilder arguments;
+            event.get("arguments").as_array().for_each([&](auto& argument) {
+                if (!arguments.is_empty())
+                    arguments.append(", ");
+                arguments.appendff("{:#x}", argument.template to_number<u32>());
+            });
+            m_pending_syscalls.set(tid, { prefix, function, timestamp_ns, arguments.to_string() });
+        } else if (type == "syscall_exit") {
+            auto function = event.get("function").to_string();
+            if (!is_shown(function))
+                return;
+            auto result = event.get("result").to_i32();
+            auto pending = m_pending_syscalls.get(tid);
+            m_pending_syscalls.remove(tid);
+            // The syscall may have started before tracing did.
+            if (!pending.has_value() || pending->function != function) {
+                if (!m_summary_only)
+                    outln("{} {}(...) = {}", prefix, function, result);
+                return;
+            }
+            auto duration_ns = timestamp_ns - pending->timestamp_ns;
+            auto& summary = m_summaries.ensure(function);
+            ++summary.calls;
+            if (result < 0)
+                ++summary.errors;
+            summary.total_ns += duration_ns;
+            if (!m_summary_only)
+                outln("{} {}({}) = {} <{} us>", prefix, function, pending->arguments, result, duration_ns / 1000);
+        } else if (m_summary_only) {
+            return;
+        } else if (type == "context_switch") {
+            outln("{} switch ({}) to {}:{}", prefix, event.get("previous_state").to_string(), event.get("next_pid").to_i32(), event.get("next_tid").to_i32());
+        } else if (type == "page_fault") {
+            outln("{} page fault at {:p} ({}, {}, {} mode) ip {:p}", prefix,
+                event.get("address").to_number<u32>(),
+                event.get("write").to_bool() ? "write" : "read",
+                event.get("not_present").to_bool() ? "not present" : "protection violation",
+                event.get("user").to_bool() ? "user" : "kernel",
+                event.get("ip").to_number<u32>());
+        } else if (type == "block_io") {
+            outln("{} block {} on {},{} of {} block(s) at {}{}: {} us", prefix,
+                event.get("write").to_bool() ? "write" : "read",
+                event.get("major").to_u32(), event.get("minor").to_u32(),
+                event.get("count").to_u32(), event.get("block").to_number<u64>(),
+                event.get("succeeded").to_bool() ? "" : " failed",
+                event.get("latency_us").to_u32());
+        }
+    }
+
+    void finish()
+    {
+        if (!m_summary_only) {
+            for (auto& it : m_pending_syscalls)
+                outln("{} {}({}) <unfinished>", it.value.prefix, it.value.function, it.value.arguments);
+            return;
+        }
+
+        Vector<String> functions;
+        for (auto& it : m_summaries)
+            functions.append(it.key);
+        quick_sort(functions, [&](auto& a, auto& b) { return m_summaries.get(a)->total_ns > m_summaries.get(b)->total_ns; });
+        outln("{:>12} {:>8} {:>8} {:>12}  syscall", "total us", "calls", "errors", "us/call");
+        for (auto& function : functions) {
+            auto& summary = *m_summaries.get(function);
+            outln("{:>12} {:>8} {:>8} {:>12}  {}", summary.total_ns / 1000, summary.calls, summary.errors, summary.total_ns / 1000 / summary.calls, function);
+        }
+    }
+
+private:
+    bool is_shown(const String& function) const { return m_syscall_filter.is_empty() || m_syscall_filter.contains(function); }
+
+    HashTable<String> m_syscall_filter;
+    Optional<pid_t> m_tid_filter;
+    bool m_summary_only { false };
+    Optional<u64> m_first_timestamp_ns;
+    HashMap<pid_t, PendingSyscall> m_pending_syscalls;
+    HashMap<String, SyscallSummary> m_summaries;
+};
+
+// Starts the command stopped on a pipe, so that tracing can be enabled for its pid before it gets to exec.
+static pid_t spawn_waiting_for_go(Vector<const char*>& command, int& go_fd)
+{
+    int fds[2];
+    if (pipe(fds) < 0) {
+        perror("pipe");
+        return -1;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        perror("fork");
+        return -1;
+    }
+    if (pid == 0) {
+        close(fds[1]);
+        char go;
+        if (read(fds[0], &go, 1) != 1)
+            _exit(1);
+        close(fds[0]);
+        command.append(nullptr);
+        execvp(command.first(), const_cast<char**>(command.data()));
+        perror("execvp");
+        _exit(1);
+    }
+    close(fds[0]);
+    go_fd = fds[1];
+    return pid;
+}
+
+int main(int argc, char** argv)
+{
+    pid_t pid = -1;
+    bool all_processes = false;
+    const char* categories_argument = "syscalls";
+    const char* syscalls_argument = nullptr;
+    pid_t tid = -1;
+    int duration = 0;
+    bool summary_only = false;
+    Vector<const char*> command;
+
+    Core::ArgsParser args_parser;
+    args_parser.set_general_help("Trace what processes do in the kernel, without slowing them down much.");
+    args_parser.add_option(pid, "Trace the given process", "pid", 'p', "pid");
+    args_parser.add_option(all_processes, "Trace all processes", "all", 'a');
+    args_parser.add_option(categories_argument, "What to trace, any of syscalls (default), context-switches, page-faults, block-io or all", "events", 'e', "list");
+    args_parser.add_option(syscalls_argument, "Only show these syscalls", "syscalls", 's', "list");
+    args_parser.add_option(tid, "Only show the events of this thread", "tid", 't', "tid");
+    args_parser.add_option(duration, "Trace for this long instead of until Enter is pressed (with -p or -a)", "duration", 'd', "seconds");
+    args_parser.add_option(summary_only, "Only print how often each syscall was made, and how long they took", "summary", 'c');
+    args_parser.add_positional_argument(command, "Command to run and trace", "command", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    auto categories = parse_categories(categories_argument);
+    if (!categories.has_value() || categories.value() == 0) {
+        warnln("Unknown events '{}'", categories_argument);
+        return 1;
+    }
+    if ((pid != -1) + all_processes + !command.is_empty() != 1) {
+        warnln("ktrace: Expected exactly one of a pid, -a or a command");
+        return 1;
+    }
+
+    HashTable<String> syscall_filter;
+    if (syscalls_argument) {
+        for (auto& name : StringView(syscalls_argument).split_view(','))
+            syscall_filter.set(name);
+    }
+
+    if (!command.is_empty()) {
+        int go_fd = -1;
+        pid = spawn_waiting_for_go(command, go_fd);
+        if (pid < 0)
+            return 1;
+        if (ktrace_enable(pid, categories.value()) < 0) {
+            perror("ktrace_enable");
+            kill(pid, SIGKILL);
+            return 1;
+        }
+        char go = 1;
+        if (write(go_fd, &go, 1) != 1)
+            perror("write");
+        close(go_fd);
+        if (waitpid(pid, nullptr, 0) < 0)
+            perror("waitpid");
+    } else {
+        if (ktrace_enable(pid, categories.value()) < 0) {
+            perror("ktrace_enable");
+            return 1;
+        }
+        if (duration > 0) {
+            sleep(duration);
+        } else {
+            warnln("Tracing, press Enter to stop...");
+            (void)getchar();
+        }
+    }
+
+    if (ktrace_disable() < 0) {
+        perror("ktrace_disable");
+        return 1;
+    }
+
+    auto file = Core::File::open("/proc/ktrace", Core::IODevice::ReadOnly);
+    if (file.is_error()) {
+        warnln("Failed to open /proc/ktrace: {}", file.error());
+        return 1;
+    }
+    auto json = JsonValue::from_string(file.value()->read_all());
+    if (!json.has_value() || !json->is_object() || !json->as_object().get("events").is_array()) {
+        warnln("Failed to parse /proc/ktrace");
+        return 1;
+    }
+
+    EventPrinter printer(move(syscall_filter), tid != -1 ? tid : Optional<pid_t> {}, summary_only);
+    json->as_object().get("events").as_array().for_each([&](auto& event) {
+        if (event.is_object())
+            printer.print(event.as_object());
+    });
+    printer.finish();
+    return 0;
+}
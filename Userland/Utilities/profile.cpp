@@ -10,12 +10,29 @@
 #include <stdlib.h>
 #include <string.h>
 
+static Optional<int> parse_counter(const StringView& name)
+{
+    if (name == "timer")
+        return PERF_COUNTER_TIMER;
+    if (name == "cycles")
+        return PERF_COUNTER_CYCLES;
+    if (name == "instructions")
+        return PERF_COUNTER_INSTRUCTIONS;
+    if (name == "cache-misses")
+        return PERF_COUNTER_CACHE_MISSES;
+    if (name == "branch-misses")
+        return PERF_COUNTER_BRANCH_MISSES;
+    return {};
+}
+
 int main(int argc, char** argv)
 {
     Core::ArgsParser args_parser;
 
     const char* pid_argument = nullptr;
     const char* cmd_argument = nullptr;
+    const char* counter_argument = "timer";
+    int sample_period = 0;
     bool wait = false;
     bool free = false;
     bool enable = false;
@@ -29,9 +46,17 @@ int main(int argc, char** argv)
     args_parser.add_option(free, "Free the profiling buffer for the associated process(es).", nullptr, 'f');
     args_parser.add_option(wait, "Enable profiling and wait for user input to disable.", nullptr, 'w');
     args_parser.add_option(cmd_argument, "Command", nullptr, 'c', "command");
+    args_parser.add_option(counter_argument, "What to sample on: timer (default), cycles, instructions, cache-misses or branch-misses", "counter", 'C', "counter");
+    args_parser.add_option(sample_period, "Take a sample every N counted events (hardware counters only)", "period", 'P', "N");
 
     args_parser.parse(argc, argv);
 
+    auto counter = parse_counter(counter_argument);
+    if (!counter.has_value()) {
+        warnln("Unknown counter '{}'", counter_argument);
+        return 1;
+    }
+
     if (!pid_argument && !cmd_argument && !all_processes) {
         args_parser.print_usage(stdout, argv[0]);
         return 0;
@@ -46,7 +71,7 @@ int main(int argc, char** argv)
         pid_t pid = all_processes ? -1 : atoi(pid_argument);
 
         if (wait || enable) {
-            if (profiling_enable(pid) < 0) {
+            if (profiling_enable_counter(pid, counter.value(), sample_period) < 0) {
                 perror("profiling_enable");
                 return 1;
             }
@@ -85,7 +110,10 @@ int main(int argc, char** argv)
     cmd_argv.append(nullptr);
 
     dbgln("Enabling profiling for PID {}", getpid());
-    profiling_enable(getpid());
+    if (profiling_enable_counter(getpid(), counter.value(), sample_period) < 0) {
+        perror("profiling_enable");
+        return 1;
+    }
     if (execvp(cmd_argv[0], const_cast<char**>(cmd_argv.data())) < 0) {
         perror("execv");
         return 1;
@@ -4,47 +4,335 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
-#include <AK/QuickSort.h>
+#include <AK/BinaryHeap.h>
+#include <AK/Optional.h>
 #include <AK/String.h>
+#include <AK/StringView.h>
 #include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibThread/ParallelSort.h>
+#include <ctype.h>
 #include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
-int main([[maybe_unused]] int argc, [[maybe_unused]] char** argv)
+// How many sorted runs are merged at once. Any more than that get merged in several passes,
+// which keeps the number of open files (and the size of the heap) in check.
+static constexpr size_t max_merge_width = 64;
+
+static bool g_numeric = false;
+static Optional<char> g_field_separator;
+// Fields are numbered from 1, a key_start_field of 0 means that the key is the whole line.
+static size_t g_key_start_field = 0;
+static Optional<size_t> g_key_end_field;
+static size_t g_memory_limit = 64 * MiB;
+
+struct Line {
+    String text;
+    // The part of |text| that we sort by.
+    StringView key;
+    double numeric_key { 0 };
+};
+
+static size_t find_field_start(const StringView& line, size_t field)
 {
-    if (pledge("stdio", nullptr) > 0) {
-        perror("pledge");
-        return 1;
+    size_t i = 0;
+    if (!g_field_separator.has_value()) {
+        while (i < line.length() && isblank(line[i]))
+            ++i;
+    }
+    for (size_t current_field = 1; current_field < field; ++current_field) {
+        if (g_field_separator.has_value()) {
+            while (i < line.length() && line[i] != g_field_separator.value())
+                ++i;
+            // There aren't that many fields.
+            if (i == line.length())
+                return i;
+            ++i;
+        } else {
+            while (i < line.length() && !isblank(line[i]))
+                ++i;
+            while (i < line.length() && isblank(line[i]))
+                ++i;
+        }
+    }
+    return i;
+}
+
+static size_t find_field_end(const StringView& line, size_t field_start)
+{
+    auto i = field_start;
+    while (i < line.length() && (g_field_separator.has_value() ? line[i] != g_field_separator.value() : !isblank(line[i])))
+        ++i;
+    return i;
+}
+
+// Keys are only looked for once per line, comparisons then just look at the key and numeric_key.
+static Line make_line(String text)
+{
+    Line line { move(text), {}, 0 };
+    auto view = line.text.view();
+    if (g_key_start_field == 0) {
+        line.key = view;
+    } else {
+        auto start = find_field_start(view, g_key_start_field);
+        auto end = view.length();
+        if (g_key_end_field.has_value())
+            end = max(start, find_field_end(view, find_field_start(view, g_key_end_field.value())));
+        line.key = view.substring_view(start, end - start);
     }
+    // The key always sits inside a null-terminated String, and strtod() stops at the first character
+    // that can't be part of a number, which is the end of the key at the latest for any sensible input.
+    if (g_numeric)
+        line.numeric_key = strtod(line.key.characters_without_null_termination(), nullptr);
+    return line;
+}
 
-    Vector<String> lines;
+static int compare_views(const StringView& a, const StringView& b)
+{
+    if (auto result = memcmp(a.characters_without_null_termination(), b.characters_without_null_termination(), min(a.length(), b.length())))
+        return result;
+    if (a.length() == b.length())
+        return 0;
+    return a.length() < b.length() ? -1 : 1;
+}
 
-    for (;;) {
-        char* buffer = nullptr;
-        ssize_t buflen = 0;
-        size_t n;
-        errno = 0;
-        buflen = getline(&buffer, &n, stdin);
-        if (buflen == -1 && errno != 0) {
+static int compare_lines(const Line& a, const Line& b)
+{
+    if (g_numeric) {
+        if (a.numeric_key != b.numeric_key)
+            return a.numeric_key < b.numeric_key ? -1 : 1;
+    } else if (g_key_start_field != 0) {
+        if (auto result = compare_views(a.key, b.key))
+            return result;
+    }
+    // Lines with equal keys are ordered by their entire contents, so that the output doesn't depend on
+    // how the input got split into runs.
+    return compare_views(a.text.view(), b.text.view());
+}
+
+static bool read_line(FILE* file, char*& buffer, size_t& buffer_size, Line& line)
+{
+    errno = 0;
+    auto length = getline(&buffer, &buffer_size, file);
+    if (length == -1) {
+        if (errno != 0) {
             perror("getline");
             exit(1);
         }
-        if (buflen == -1)
-            break;
-        lines.append({ buffer, AK::ShouldChomp::Chomp });
+        return false;
+    }
+    line = make_line({ buffer, static_cast<size_t>(length), Chomp });
+    return true;
+}
+
+static void write_lines(FILE* file, const Vector<Line>& lines)
+{
+    for (auto& line : lines) {
+        fwrite(line.text.characters(), 1, line.text.length(), file);
+        fputc('\n', file);
+    }
+}
+
+// Sorted runs go to temporary files that are unlinked right away, so they're cleaned up
+// however we exit, and are only read back through the FILE we keep around.
+static FILE* create_run_file()
+{
+    char path[] = "/tmp/sort.XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) {
+        perror("mkstemp");
+        exit(1);
+    }
+    unlink(path);
+    auto* file = fdopen(fd, "w+");
+    if (!file) {
+        perror("fdopen");
+        exit(1);
+    }
+    return file;
+}
+
+static void finish_run_file(FILE* file)
+{
+    if (fflush(file) != 0 || ferror(file)) {
+        perror("write");
+        exit(1);
+    }
+    rewind(file);
+}
+
+struct MergeKey {
+    const Line* line { nullptr };
+    size_t run { 0 };
+
+    bool operator<(const MergeKey& other) const
+    {
+        if (auto result = compare_lines(*line, *other.line))
+            return result < 0;
+        return run < other.run;
+    }
+    bool operator<=(const MergeKey& other) const { return !(other < *this); }
+    bool operator>=(const MergeKey& other) const { return !(*this < other); }
+};
+
+// Merges up to max_merge_width sorted runs into |output|, and closes them.
+static void merge_runs(Span<FILE*> runs, FILE* output)
+{
+    VERIFY(runs.size() <= max_merge_width);
+
+    struct Run {
+        FILE* file { nullptr };
+        char* buffer { nullptr };
+        size_t buffer_size { 0 };
+        Line line;
+    };
+    Vector<Run> states;
+    states.resize(runs.size());
+
+    BinaryHeap<MergeKey, size_t, max_merge_width> heap;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        auto& state = states[i];
+        state.file = runs[i];
+        if (read_line(state.file, state.buffer, state.buffer_size, state.line))
+            heap.insert({ &state.line, i }, i);
+    }
+
+    while (!heap.is_empty()) {
+        auto index = heap.pop_min();
+        auto& state = states[index];
+        fwrite(state.line.text.characters(), 1, state.line.text.length(), output);
+        fputc('\n', output);
+        if (read_line(state.file, state.buffer, state.buffer_size, state.line))
+            heap.insert({ &state.line, index }, index);
+    }
+
+    for (auto& state : states) {
+        free(state.buffer);
+        fclose(state.file);
     }
+}
 
-    quick_sort(lines, [](auto& a, auto& b) {
-        return strcmp(a.characters(), b.characters()) < 0;
+static void sort_lines(Vector<Line>& lines)
+{
+    LibThread::parallel_sort(lines.span(), [](auto& a, auto& b) {
+        return compare_lines(a, b) < 0;
     });
+}
 
-    for (auto& line : lines) {
-        fputs(line.characters(), stdout);
-        fputc('\n', stdout);
+static bool parse_key(const String& key)
+{
+    auto parts = key.split(',');
+    if (parts.is_empty() || parts.size() > 2)
+        return false;
+    auto start = parts[0].to_uint();
+    if (!start.has_value() || start.value() == 0)
+        return false;
+    g_key_start_field = start.value();
+    if (parts.size() == 2) {
+        auto end = parts[1].to_uint();
+        if (!end.has_value() || end.value() < start.value())
+            return false;
+        g_key_end_field = end.value();
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    if (pledge("stdio rpath wpath cpath thread", nullptr) > 0) {
+        perror("pledge");
+        return 1;
+    }
+
+    String key;
+    String field_separator;
+    int memory_limit_in_mib = 0;
+    Vector<const char*> paths;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(key, "Sort by fields start through end (or the end of the line), counting from 1", "key", 'k', "start[,end]");
+    args_parser.add_option(field_separator, "Split fields at this character instead of at blanks", "field-separator", 't', "char");
+    args_parser.add_option(g_numeric, "Compare keys as numbers", "numeric-sort", 'n');
+    args_parser.add_option(memory_limit_in_mib, "Sort this many MiB of input at a time in memory", "buffer-size", 'S', "size");
+    args_parser.add_positional_argument(paths, "Files to sort", "file", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    if (!key.is_null() && !parse_key(key)) {
+        warnln("sort: Invalid key '{}'", key);
+        return 1;
+    }
+    if (!field_separator.is_null()) {
+        if (field_separator.length() != 1) {
+            warnln("sort: The field separator must be a single character");
+            return 1;
+        }
+        g_field_separator = field_separator[0];
+    }
+    if (memory_limit_in_mib > 0)
+        g_memory_limit = memory_limit_in_mib * MiB;
+    if (paths.is_empty())
+        paths.append("-");
+
+    // Read the input in chunks of about g_memory_limit bytes. If it all fits in one, we sort it in memory,
+    // otherwise every chunk is sorted and written out to its own run, and the runs get merged at the end.
+    Vector<Line> lines;
+    size_t lines_size = 0;
+    Vector<FILE*> runs;
+    char* buffer = nullptr;
+    size_t buffer_size = 0;
+    for (auto* path : paths) {
+        auto* file = StringView(path) == "-" ? stdin : fopen(path, "r");
+        if (!file) {
+            perror(path);
+            return 1;
+        }
+        Line line;
+        while (read_line(file, buffer, buffer_size, line)) {
+            lines_size += line.text.length() + sizeof(Line);
+            lines.append(move(line));
+            if (lines_size >= g_memory_limit) {
+                sort_lines(lines);
+                auto* run = create_run_file();
+                write_lines(run, lines);
+                finish_run_file(run);
+                runs.append(run);
+                lines.clear();
+                lines_size = 0;
+            }
+        }
+        if (file != stdin)
+            fclose(file);
+    }
+    free(buffer);
+
+    sort_lines(lines);
+    if (runs.is_empty()) {
+        write_lines(stdout, lines);
+        return 0;
+    }
+
+    if (!lines.is_empty()) {
+        auto* run = create_run_file();
+        write_lines(run, lines);
+        finish_run_file(run);
+        runs.append(run);
+    }
+    lines.clear();
+
+    while (runs.size() > max_merge_width) {
+        Vector<FILE*> merged_runs;
+        for (size_t i = 0; i < runs.size(); i += max_merge_width) {
+            auto* merged_run = create_run_file();
+            merge_runs(runs.span().slice(i, min(max_merge_width, runs.size() - i)), merged_run);
+            finish_run_file(merged_run);
+            merged_runs.append(merged_run);
+        }
+        runs = move(merged_runs);
     }
+    merge_runs(runs.span(), stdout);
 
     return 0;
 }
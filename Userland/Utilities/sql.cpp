@@ -7,8 +7,10 @@
 #include <AK/Format.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <LibCore/ArgsParser.h>
 #include <LibCore/StandardPaths.h>
 #include <LibLine/Editor.h>
+#include <LibSQL/Database.h>
 #include <LibSQL/Lexer.h>
 #include <LibSQL/Parser.h>
 #include <LibSQL/Token.h>
@@ -17,6 +19,7 @@ namespace {
 
 String s_history_path = String::formatted("{}/.sql-history", Core::StandardPaths::home_directory());
 RefPtr<Line::Editor> s_editor;
+OwnPtr<SQL::Database> s_database;
 int s_repl_line_level = 0;
 bool s_keep_running = true;
 
@@ -97,11 +100,36 @@ void handle_command(StringView command)
 void handle_statement(StringView statement_string)
 {
     auto parser = SQL::Parser(SQL::Lexer(statement_string));
-    [[maybe_unused]] auto statement = parser.next_statement();
+    auto statement = parser.next_statement();
 
     if (parser.has_errors()) {
         auto error = parser.errors()[0];
         outln("\033[33;1mInvalid statement:\033[0m {}", error.to_string());
+        return;
+    }
+
+    auto result = s_database->execute(statement);
+    if (result.is_error()) {
+        outln("\033[31;1mError:\033[0m {}", result.error());
+        return;
+    }
+
+    auto& result_set = result.value();
+    if (result_set.column_names.is_empty()) {
+        if (result_set.rows_affected > 0)
+            outln("{} row(s) affected", result_set.rows_affected);
+        return;
+    }
+
+    outln("\033[1m{}\033[0m", String::join(" | ", result_set.column_names));
+    for (auto& row : result_set.rows) {
+        StringBuilder builder;
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (i > 0)
+                builder.append(" | ");
+            builder.append(row[i].is_null() ? "NULL" : row[i].to_string());
+        }
+        outln("{}", builder.string_view());
     }
 }
 
@@ -121,8 +149,21 @@ void repl()
 
 }
 
-int main()
+int main(int argc, char** argv)
 {
+    String database_path = String::formatted("{}/.sql.db", Core::StandardPaths::home_directory());
+
+    Core::ArgsParser args_parser;
+    args_parser.add_positional_argument(database_path, "Path to the database file", "database", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    auto database_or_error = SQL::Database::open(database_path);
+    if (database_or_error.is_error()) {
+        warnln("Failed to open {}: {}", database_path, database_or_error.error());
+        return 1;
+    }
+    s_database = database_or_error.release_value();
+
     s_editor = Line::Editor::construct();
     s_editor->load_history(s_history_path);
 
@@ -4,7 +4,9 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Buffered.h>
 #include <AK/LexicalPath.h>
+#include <AK/MappedFile.h>
 #include <AK/Span.h>
 #include <AK/Vector.h>
 #include <LibArchive/TarStream.h>
@@ -12,12 +14,15 @@
 #include <LibCore/ArgsParser.h>
 #include <LibCore/DirIterator.h>
 #include <LibCore/FileStream.h>
+#include <LibThread/Parallel.h>
+#include <LibThread/PipelinedReader.h>
 #include <fcntl.h>
 #include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
-constexpr size_t buffer_size = 4096;
+constexpr size_t buffer_size = 256 * KiB;
+constexpr size_t read_ahead_chunk_size = 1 * MiB;
 
 int main(int argc, char** argv)
 {
@@ -26,6 +31,7 @@ int main(int argc, char** argv)
     bool list = false;
     bool verbose = false;
     bool gzip = false;
+    int gzip_thread_count = 1;
     const char* archive_file = nullptr;
     Vector<const char*> paths;
 
@@ -35,6 +41,7 @@ int main(int argc, char** argv)
     args_parser.add_option(list, "List contents", "list", 't');
     args_parser.add_option(verbose, "Print paths", "verbose", 'v');
     args_parser.add_option(gzip, "compress or uncompress file using gzip", "gzip", 'z');
+    args_parser.add_option(gzip_thread_count, "Compress on this many threads, 0 for one per processor", "threads", 0, "N");
     args_parser.add_option(archive_file, "Archive file", "file", 'f', "FILE");
     args_parser.add_positional_argument(paths, "Paths", "PATHS", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
@@ -56,7 +63,8 @@ int main(int argc, char** argv)
             file = maybe_file.value();
         }
 
-        Core::InputFileStream file_stream(file);
+        // Read the archive ahead of us in large chunks, so the disk is kept busy while we unpack.
+        LibThread::PipelinedInputStream file_stream(file->fd(), read_ahead_chunk_size);
         Compress::GzipDecompressor gzip_stream(file_stream);
 
         InputStream& file_input_stream = file_stream;
@@ -83,9 +91,9 @@ int main(int argc, char** argv)
                         return 1;
                     }
 
-                    Array<u8, buffer_size> buffer;
+                    auto buffer = ByteBuffer::create_uninitialized(buffer_size);
                     size_t nread;
-                    while ((nread = file_stream.read(buffer)) > 0) {
+                    while ((nread = file_stream.read(buffer.bytes())) > 0) {
                         if (write(fd, buffer.data(), nread) < 0) {
                             perror("write");
                             return 1;
@@ -107,7 +115,6 @@ int main(int argc, char** argv)
                 }
             }
         }
-        file_stream.close();
         return 0;
     }
 
@@ -128,26 +135,48 @@ int main(int argc, char** argv)
             file = maybe_file.value();
         }
 
-        Core::OutputFileStream file_stream(file);
-        Compress::GzipCompressor gzip_stream(file_stream);
-
-        OutputStream& file_output_stream = file_stream;
-        OutputStream& gzip_output_stream = gzip_stream;
-        Archive::TarOutputStream tar_stream((gzip) ? gzip_output_stream : file_output_stream);
+        if (gzip_thread_count <= 0)
+            gzip_thread_count = LibThread::ThreadPool::the().thread_count();
+
+        auto file_stream = make<Buffered<Core::OutputFileStream, buffer_size>>(file);
+        OwnPtr<Compress::GzipCompressor> gzip_stream;
+        OwnPtr<Compress::ParallelGzipCompressor> parallel_gzip_stream;
+        OutputStream* output_stream = file_stream.ptr();
+        if (gzip && gzip_thread_count > 1) {
+            parallel_gzip_stream = make<Compress::ParallelGzipCompressor>(*file_stream, gzip_thread_count * 2, [](size_t count, auto& task) {
+                LibThread::run_chunks(LibThread::ThreadPool::the(), count, task);
+            });
+            output_stream = parallel_gzip_stream.ptr();
+        } else if (gzip) {
+            gzip_stream = make<Compress::GzipCompressor>(*file_stream);
+            output_stream = gzip_stream.ptr();
+        }
+        Archive::TarOutputStream tar_stream(*output_stream);
 
         auto add_file = [&](String path) {
-            auto file = Core::File::construct(path);
-            if (!file->open(Core::IODevice::ReadOnly)) {
-                warnln("Failed to open {}: {}", path, file->error_string());
-                return;
-            }
-
             struct stat statbuf;
             if (lstat(path.characters(), &statbuf) < 0) {
                 warnln("Failed stating {}", path);
                 return;
             }
             auto canonicalized_path = LexicalPath::canonicalized_path(path);
+
+            // Mapping the file saves us from copying all of it into a buffer of our own first.
+            if (statbuf.st_size > 0) {
+                auto mapped_file_or_error = MappedFile::map(path);
+                if (!mapped_file_or_error.is_error()) {
+                    tar_stream.add_file(canonicalized_path, statbuf.st_mode, mapped_file_or_error.value()->bytes());
+                    if (verbose)
+                        outln("{}", canonicalized_path);
+                    return;
+                }
+            }
+
+            auto file = Core::File::construct(path);
+            if (!file->open(Core::IODevice::ReadOnly)) {
+                warnln("Failed to open {}: {}", path, file->error_string());
+                return;
+            }
             tar_stream.add_file(canonicalized_path, statbuf.st_mode, file->read_all());
             if (verbose)
                 outln("{}", canonicalized_path);
@@ -184,7 +213,16 @@ int main(int argc, char** argv)
         }
 
         tar_stream.finish();
-
+        if (gzip_stream)
+            gzip_stream->final_flush();
+        if (parallel_gzip_stream)
+            parallel_gzip_stream->final_flush();
+        file_stream->flush();
+
+        if (output_stream->handle_any_error() || file_stream->handle_any_error()) {
+            warnln("failed to write the archive");
+            return 1;
+        }
         return 0;
     }
 
@@ -7,6 +7,7 @@
 #include <AK/Random.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/ConfigFile.h>
+#include <LibCore/ElapsedTimer.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/File.h>
 #include <LibCrypto/ASN1/ASN1.h>
@@ -87,6 +88,9 @@ static int crc32_tests();
 
 // stop listing tests
 
+// Benchmarks
+static int benchmarks();
+
 static void print_buffer(ReadonlyBytes buffer, int split)
 {
     for (size_t i = 0; i < buffer.size(); ++i) {
@@ -320,6 +324,7 @@ auto main(int argc, char** argv) -> int
         puts("\ttest -- Run every test suite");
         puts("\tbigint -- Run big integer test suite");
         puts("\tpk -- Run Public-key system tests");
+        puts("\tbench -- Measure the throughput of the ciphers and hashes (optionally only the suite given by -n)");
         return 0;
     }
 
@@ -406,6 +411,9 @@ auto main(int argc, char** argv) -> int
     if (mode_sv == "bigint") {
         return bigint_tests();
     }
+    if (mode_sv == "bench") {
+        return benchmarks();
+    }
     if (mode_sv == "tls") {
         if (!Core::File::exists(ca_certs_file)) {
             warnln("Nonexistent CA certs file '{}'", ca_certs_file);
@@ -2770,3 +2778,75 @@ static void bigint_signed_bitwise()
         }
     }
 }
+
+static void benchmark(const char* name, size_t bytes_per_iteration, Function<void()> iteration)
+{
+    if (suite && StringView(suite) != name)
+        return;
+    printf("Benchmarking %s... ", name);
+    fflush(stdout);
+    Core::ElapsedTimer timer;
+    timer.start();
+    size_t iterations = 0;
+    do {
+        iteration();
+        ++iterations;
+    } while (timer.elapsed() < 1000);
+    auto seconds = timer.elapsed() / 1000.0;
+    printf("%.1f MiB/s\n", iterations * bytes_per_iteration / (double)MiB / seconds);
+}
+
+static int benchmarks()
+{
+    if (!Crypto::Cipher::AESCipher::KeyType::is_valid_key_size(key_bits)) {
+        printf("Invalid key size for AES: %d\n", key_bits);
+        return 1;
+    }
+
+    constexpr size_t buffer_size = 64 * KiB;
+    auto input = ByteBuffer::create_zeroed(buffer_size);
+    auto output = ByteBuffer::create_uninitialized(buffer_size + Crypto::Cipher::AESCipher::block_size());
+    auto key = ByteBuffer::create_zeroed(key_bits / 8);
+    auto iv = ByteBuffer::create_zeroed(Crypto::Cipher::AESCipher::block_size());
+    auto tag = ByteBuffer::create_uninitialized(Crypto::Cipher::AESCipher::block_size());
+
+    Crypto::Cipher::AESCipher::CBCMode cbc(key, key_bits, Crypto::Cipher::Intent::Encryption);
+    benchmark("AES_CBC", buffer_size, [&] {
+        auto out = output.bytes();
+        cbc.encrypt(input, out, iv);
+    });
+
+    Crypto::Cipher::AESCipher::CTRMode ctr(key, key_bits, Crypto::Cipher::Intent::Encryption);
+    benchmark("AES_CTR", buffer_size, [&] {
+        auto out = output.bytes().slice(0, buffer_size);
+        ctr.encrypt(input, out, iv);
+    });
+
+    Crypto::Cipher::AESCipher::GCMMode gcm(key, key_bits, Crypto::Cipher::Intent::Encryption);
+    benchmark("AES_GCM", buffer_size, [&] {
+        gcm.encrypt(input, output.bytes().slice(0, buffer_size), iv, {}, tag);
+    });
+
+    Crypto::Authentication::GHash ghash(iv);
+    benchmark("GHash", buffer_size, [&] {
+        ghash.process({}, input);
+    });
+
+    benchmark("SHA1", buffer_size, [&] {
+        Crypto::Hash::SHA1::hash(input);
+    });
+
+    benchmark("SHA256", buffer_size, [&] {
+        Crypto::Hash::SHA256::hash(input);
+    });
+
+    benchmark("SHA512", buffer_size, [&] {
+        Crypto::Hash::SHA512::hash(input);
+    });
+
+    benchmark("CRC32", buffer_size, [&] {
+        (void)Crypto::Checksum::CRC32(input).digest();
+    });
+
+    return 0;
+}
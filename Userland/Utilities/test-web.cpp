@@ -195,8 +195,8 @@ void TestRunner::run()
         Web::ResourceLoader::the().load_sync(
             request,
             [&](auto data, auto&, auto) {
-                Web::HTML::HTMLDocumentParser parser(*m_page_view->document(), data, "utf-8");
-                parser.run(page_to_load);
+                auto parser = Web::HTML::HTMLDocumentParser::create(*m_page_view->document(), data, "utf-8");
+                parser->run(page_to_load);
             },
             [page_to_load](auto& error, auto) {
                 printf("Failed to load test page: %s (%s)", page_to_load.to_string().characters(), error.characters());
@@ -306,8 +306,8 @@ JSFileResult TestRunner::run_file_test(const String& test_path)
         [&](auto data, auto&, auto) {
             // Create a new parser and immediately get its document to replace the old interpreter.
             auto document = Web::DOM::Document::create();
-            Web::HTML::HTMLDocumentParser parser(document, data, "utf-8");
-            auto& new_interpreter = parser.document().interpreter();
+            NonnullRefPtr<Web::HTML::HTMLDocumentParser> parser = Web::HTML::HTMLDocumentParser::create(document, data, "utf-8");
+            auto& new_interpreter = parser->document().interpreter();
 
             // FIXME: This is a hack while we're refactoring Interpreter/VM stuff.
             JS::VM::InterpreterExecutionScope scope(new_interpreter);
@@ -327,8 +327,8 @@ JSFileResult TestRunner::run_file_test(const String& test_path)
                 new_interpreter.vm().clear_exception();
 
             // Now parse the HTML page.
-            parser.run(page_to_load);
-            m_page_view->set_document(&parser.document());
+            parser->run(page_to_load);
+            m_page_view->set_document(&parser->document());
 
             // Finally run the test by calling "__AfterInitialPageLoad__"
             auto& after_initial_page_load = new_interpreter.vm().get_variable("__AfterInitialPageLoad__", new_interpreter.global_object()).as_function();
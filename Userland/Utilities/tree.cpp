@@ -5,15 +5,14 @@
  */
 
 #include <AK/LexicalPath.h>
-#include <AK/QuickSort.h>
 #include <AK/String.h>
-#include <AK/StringBuilder.h>
 #include <AK/Vector.h>
 #include <LibCore/ArgsParser.h>
-#include <LibCore/DirIterator.h>
+#include <LibThread/DirectoryWalker.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdio.h>
-#include <sys/stat.h>
+#include <string.h>
 #include <unistd.h>
 
 static bool flag_show_hidden_files = false;
@@ -23,84 +22,46 @@ static int max_depth = INT_MAX;
 static int g_directories_seen = 0;
 static int g_files_seen = 0;
 
-static void print_directory_tree(const String& root_path, int depth, const String& indent_string)
+static void print_directory_tree(const String& root_path)
 {
-    if (depth > 0) {
-        String root_indent_string;
-        if (depth > 1) {
-            root_indent_string = indent_string.substring(0, (depth - 1) * 4);
-        } else {
-            root_indent_string = "";
+    LibThread::DirectoryWalker walker;
+    walker.set_should_stat_entries(false);
+    walker.set_should_skip_hidden_files(!flag_show_hidden_files);
+    walker.set_should_sort_by_name(true);
+    walker.set_max_depth(max_depth);
+    walker.on_error = [](auto& path, int error) {
+        warnln("{}: {}", path, strerror(error));
+    };
+
+    // What goes in front of the entries in a directory at each depth, depending on whether the directories
+    // above them still have more entries after them.
+    Vector<String> indent_strings;
+    walker.walk(root_path, [&](auto& entry) {
+        if (entry.depth == 0) {
+            out("\033[34;1m{}\033[0m\n", LexicalPath(root_path).basename());
+            if (entry.error == 0 && !entry.is_directory())
+                warnln("{}: {}", root_path, strerror(ENOTDIR));
+            indent_strings.append("");
+            return IterationDecision::Continue;
         }
-        out("{}|-- ", root_indent_string);
-    }
-
-    String root_dir_name = LexicalPath(root_path).basename();
-    out("\033[34;1m{}\033[0m\n", root_dir_name);
-
-    if (depth >= max_depth) {
-        return;
-    }
-
-    Core::DirIterator di(root_path, flag_show_hidden_files ? Core::DirIterator::SkipParentAndBaseDir : Core::DirIterator::SkipDots);
-    if (di.has_error()) {
-        warnln("{}: {}", root_path, di.error_string());
-        return;
-    }
-
-    Vector<String> names;
-    while (di.has_next()) {
-        String name = di.next_path();
-        if (di.has_error()) {
-            warnln("{}: {}", root_path, di.error_string());
-            continue;
-        }
-        names.append(name);
-    }
-
-    quick_sort(names);
 
-    for (size_t i = 0; i < names.size(); i++) {
-        String name = names[i];
-
-        StringBuilder builder;
-        builder.append(root_path);
-        if (!root_path.ends_with('/')) {
-            builder.append('/');
-        }
-        builder.append(name);
-        String full_path = builder.to_string();
-
-        struct stat st;
-        int rc = lstat(full_path.characters(), &st);
-        if (rc == -1) {
-            warnln("lstat({}) failed: {}", full_path, strerror(errno));
-            continue;
-        }
-
-        if (S_ISDIR(st.st_mode)) {
+        indent_strings.shrink(entry.depth);
+        auto& indent_string = indent_strings[entry.depth - 1];
+        if (entry.is_directory()) {
             g_directories_seen++;
-
-            bool at_last_entry = i == names.size() - 1;
-            String new_indent_string;
-            if (at_last_entry) {
-                new_indent_string = String::formatted("{}    ", indent_string);
-            } else {
-                new_indent_string = String::formatted("{}|   ", indent_string);
-            }
-
-            print_directory_tree(full_path.characters(), depth + 1, new_indent_string);
+            out("{}|-- \033[34;1m{}\033[0m\n", indent_string, entry.name());
+            indent_strings.append(String::formatted("{}{}", indent_string, entry.is_last_in_directory ? "    " : "|   "));
         } else if (!flag_show_only_directories) {
             g_files_seen++;
-
-            outln("{}|-- {}", indent_string, name);
+            outln("{}|-- {}", indent_string, entry.name());
         }
-    }
+        return IterationDecision::Continue;
+    });
 }
 
 int main(int argc, char** argv)
 {
-    if (pledge("stdio rpath tty", nullptr) < 0) {
+    if (pledge("stdio rpath tty thread", nullptr) < 0) {
         perror("pledge");
         return 1;
     }
@@ -120,11 +81,11 @@ int main(int argc, char** argv)
     }
 
     if (directories.is_empty()) {
-        print_directory_tree(".", 0, "");
+        print_directory_tree(".");
         puts("");
     } else {
         for (const char* directory : directories) {
-            print_directory_tree(directory, 0, "");
+            print_directory_tree(directory);
             puts("");
         }
     }
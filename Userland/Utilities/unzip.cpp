@@ -10,71 +10,53 @@
 #include <LibCompress/Deflate.h>
 #include <LibCore/ArgsParser.h>
 #include <LibCore/File.h>
+#include <LibThread/Parallel.h>
 #include <sys/stat.h>
 
-static bool unpack_zip_member(Archive::ZipMember zip_member)
+// Returns why the member couldn't be written out, if it couldn't.
+static Optional<String> unpack_zip_file_member(const Archive::ZipMember& zip_member)
 {
-    if (zip_member.is_directory) {
-        if (mkdir(zip_member.name.characters(), 0755) < 0) {
-            perror("mkdir");
-            return false;
-        }
-        outln(" extracting: {}", zip_member.name);
-        return true;
-    }
     auto new_file = Core::File::construct(zip_member.name);
-    if (!new_file->open(Core::IODevice::WriteOnly)) {
-        warnln("Can't write file {}: {}", zip_member.name, new_file->error_string());
-        return false;
-    }
-
-    outln(" extracting: {}", zip_member.name);
+    if (!new_file->open(Core::IODevice::WriteOnly))
+        return String::formatted("Can't write file {}: {}", zip_member.name, new_file->error_string());
 
     // TODO: verify CRC32s match!
     switch (zip_member.compression_method) {
     case Archive::ZipCompressionMethod::Store: {
-        if (!new_file->write(zip_member.compressed_data.data(), zip_member.compressed_data.size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
+        if (!new_file->write(zip_member.compressed_data.data(), zip_member.compressed_data.size()))
+            return String::formatted("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
         break;
     }
     case Archive::ZipCompressionMethod::Deflate: {
         auto decompressed_data = Compress::DeflateDecompressor::decompress_all(zip_member.compressed_data);
-        if (!decompressed_data.has_value()) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (decompressed_data.value().size() != zip_member.uncompressed_size) {
-            warnln("Failed decompressing file {}", zip_member.name);
-            return false;
-        }
-        if (!new_file->write(decompressed_data.value().data(), decompressed_data.value().size())) {
-            warnln("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
-            return false;
-        }
+        if (!decompressed_data.has_value())
+            return String::formatted("Failed decompressing file {}", zip_member.name);
+        if (decompressed_data.value().size() != zip_member.uncompressed_size)
+            return String::formatted("Failed decompressing file {}", zip_member.name);
+        if (!new_file->write(decompressed_data.value().data(), decompressed_data.value().size()))
+            return String::formatted("Can't write file contents in {}: {}", zip_member.name, new_file->error_string());
         break;
     }
     default:
         VERIFY_NOT_REACHED();
     }
 
-    if (!new_file->close()) {
-        warnln("Can't close file {}: {}", zip_member.name, new_file->error_string());
-        return false;
-    }
+    if (!new_file->close())
+        return String::formatted("Can't close file {}: {}", zip_member.name, new_file->error_string());
 
-    return true;
+    return {};
 }
 
 int main(int argc, char** argv)
 {
     const char* path;
+    Vector<const char*> member_names;
     int map_size_limit = 32 * MiB;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(map_size_limit, "Maximum chunk size to map", "map-size-limit", 0, "size");
     args_parser.add_positional_argument(path, "File to unzip", "path", Core::ArgsParser::Required::Yes);
+    args_parser.add_positional_argument(member_names, "Files in the archive to extract, all of them if none are given", "files", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
     String zip_file_path { path };
@@ -111,9 +93,52 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    auto success = zip_file->for_each_member([&](auto zip_member) {
-        return unpack_zip_member(zip_member) ? IterationDecision::Continue : IterationDecision::Break;
+    Vector<Archive::ZipMember> members;
+    if (member_names.is_empty()) {
+        members.ensure_capacity(zip_file->member_count());
+        for (size_t i = 0; i < zip_file->member_count(); ++i)
+            members.unchecked_append(zip_file->member_at(i));
+    } else {
+        for (auto& member_name : member_names) {
+            auto member = zip_file->find_member(member_name);
+            if (!member.has_value()) {
+                warnln("unzip: {} not found in {}", member_name, zip_file_path);
+                return 1;
+            }
+            members.append(member.release_value());
+        }
+    }
+
+    // Directories come first, so that the files can go into them.
+    Vector<const Archive::ZipMember*> files;
+    for (auto& member : members) {
+        if (!member.is_directory) {
+            files.append(&member);
+            continue;
+        }
+        if (mkdir(member.name.characters(), 0755) < 0) {
+            perror("mkdir");
+            return 1;
+        }
+        outln(" extracting: {}", member.name);
+    }
+
+    // Every file is decompressed and written on its own, so several of them can be at once.
+    Vector<Optional<String>> errors;
+    errors.resize(files.size());
+    LibThread::parallel_for(0, files.size(), 1, [&](size_t i) {
+        errors[i] = unpack_zip_file_member(*files[i]);
     });
 
+    bool success = true;
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (errors[i].has_value()) {
+            warnln("{}", errors[i].value());
+            success = false;
+            continue;
+        }
+        outln(" extracting: {}", files[i]->name);
+    }
+
     return success ? 0 : 1;
 }